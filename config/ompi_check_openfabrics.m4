@@ -156,6 +156,13 @@ AC_DEFUN([OMPI_CHECK_OPENFABRICS],[
                           [#include <infiniband/verbs.h>])
            AC_CHECK_FUNCS([ibv_get_device_list ibv_resize_cq])
 
+           # On-demand paging and the implicit (whole address space)
+           # memory region; ibv_query_device_ex is an inline, check for
+           # its declaration
+           AC_CHECK_DECLS([IBV_ACCESS_ON_DEMAND, IBV_ODP_SUPPORT_IMPLICIT,
+                           ibv_query_device_ex], [], [],
+                          [#include <infiniband/verbs.h>])
+
            # struct ibv_device.transport_type was added in OFED v1.2
            AC_CHECK_MEMBERS([struct ibv_device.transport_type], [], [],
                             [#include <infiniband/verbs.h>])
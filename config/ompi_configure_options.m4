@@ -55,9 +55,9 @@ AC_DEFINE_UNQUOTED([OMPI_WANT_MPI_INTERFACE_WARNING], [$OMPI_WANT_MPI_INTERFACE_
 
 AC_MSG_CHECKING([if want sparse process groups])
 AC_ARG_ENABLE(sparse-groups,
-    AC_HELP_STRING([--enable-sparse-groups],
-                   [enable sparse process groups (default: not enabled)]))
-if test "$enable_sparse_groups" = "yes"; then
+    AC_HELP_STRING([--disable-sparse-groups],
+                   [disable sparse process groups (default: enabled)]))
+if test "$enable_sparse_groups" != "no"; then
     AC_MSG_RESULT([yes])
     GROUP_SPARSE=1
 else
@@ -88,6 +88,24 @@ AC_DEFINE_UNQUOTED([OMPI_WANT_PERUSE],
                    [if the peruse interface should be enabled])
 AM_CONDITIONAL(WANT_PERUSE, test "$WANT_PERUSE" = "1")
 
+#
+# MPI_T counters of the communication paths
+#
+
+AC_MSG_CHECKING([if want MPI_T performance counters])
+AC_ARG_ENABLE(pvar-counters,
+    AC_HELP_STRING([--disable-pvar-counters],
+                   [disable the MPI_T performance variables counting the traffic of the pml, btl, coll and rcache frameworks (default: enabled)]))
+if test "$enable_pvar_counters" != "no"; then
+    AC_MSG_RESULT([yes])
+    ENABLE_PVAR_COUNTERS=1
+else
+    AC_MSG_RESULT([no])
+    ENABLE_PVAR_COUNTERS=0
+fi
+AC_DEFINE_UNQUOTED([OMPI_ENABLE_PVAR_COUNTERS], [$ENABLE_PVAR_COUNTERS],
+                   [Whether the MPI_T performance counters are compiled in])
+
 #
 # Fortran MPI bindings
 #
@@ -30,6 +30,33 @@ AC_DEFUN([OPAL_CHECK_SYNC_BUILTINS], [
 ])
 
 
+dnl #################################################################
+dnl
+dnl OPAL_CHECK_GCC_BUILTINS
+dnl
+dnl Check for the __atomic builtins (explicit memory orderings), on
+dnl 32 and 64 bit integers.  Linking is required, as some compilers
+dnl emit library calls for the operations they can not inline.
+dnl
+dnl #################################################################
+AC_DEFUN([OPAL_CHECK_GCC_BUILTINS], [
+  AC_MSG_CHECKING([for __atomic builtin atomics])
+
+  AC_TRY_LINK([#include <stdint.h>
+int32_t x32; int64_t x64;],
+    [int32_t o32 = 0; int64_t o64 = 0;
+     __atomic_thread_fence(__ATOMIC_SEQ_CST);
+     __atomic_compare_exchange_n(&x32, &o32, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+     __atomic_compare_exchange_n(&x64, &o64, 1, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+     __atomic_store_n(&x64, __atomic_load_n(&x64, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+     __atomic_add_fetch(&x64, 1, __ATOMIC_SEQ_CST);],
+    [AC_MSG_RESULT([yes])
+     $1],
+    [AC_MSG_RESULT([no])
+     $2])
+])
+
+
 dnl #################################################################
 dnl
 dnl OMPI_CHECK_ASM_TEXT
@@ -759,11 +786,12 @@ AC_DEFUN([OPAL_CONFIG_ASM],[
 
     AC_ARG_ENABLE([builtin-atomics],
       [AC_HELP_STRING([--enable-builtin-atomics],
-         [Enable use of __sync builtin atomics (default: disabled)])])
+         [Enable use of the compiler's builtin atomics: __atomic if available, __sync otherwise (default: disabled)])])
 
     if test "$enable_builtin_atomics" = "yes" ; then
-       OPAL_CHECK_SYNC_BUILTINS([ompi_cv_asm_arch="SYNC_BUILTIN"],
-         [AC_MSG_ERROR([__sync builtin atomics requested but not found.])])
+       OPAL_CHECK_GCC_BUILTINS([ompi_cv_asm_arch="GCC_BUILTIN"],
+         [OPAL_CHECK_SYNC_BUILTINS([ompi_cv_asm_arch="SYNC_BUILTIN"],
+           [AC_MSG_ERROR([builtin atomics requested but not found.])])])
        AC_DEFINE([OPAL_C_GCC_INLINE_ASSEMBLY], [1],
          [Whether C compiler supports GCC style inline assembly])
     else
@@ -893,12 +921,13 @@ AC_MSG_ERROR([Can not continue.])
             ;;
 
         *)
-            OPAL_CHECK_SYNC_BUILTINS([ompi_cv_asm_arch="SYNC_BUILTIN"],
-              [AC_MSG_ERROR([No atomic primitives available for $host])])
+            OPAL_CHECK_GCC_BUILTINS([ompi_cv_asm_arch="GCC_BUILTIN"],
+              [OPAL_CHECK_SYNC_BUILTINS([ompi_cv_asm_arch="SYNC_BUILTIN"],
+                [AC_MSG_ERROR([No atomic primitives available for $host])])])
             ;;
         esac
 
-      if test "$ompi_cv_asm_arch" = "SYNC_BUILTIN" ; then
+      if test "$ompi_cv_asm_arch" = "SYNC_BUILTIN" -o "$ompi_cv_asm_arch" = "GCC_BUILTIN" ; then
         AC_DEFINE([OPAL_C_GCC_INLINE_ASSEMBLY], [1],
           [Whether C compiler supports GCC style inline assembly])
       else
@@ -949,7 +978,7 @@ AC_MSG_ERROR([Can not continue.])
         AC_DEFINE_UNQUOTED([OPAL_ASSEMBLY_FORMAT], ["$OPAL_ASSEMBLY_FORMAT"],
                            [Format of assembly file])
         AC_SUBST([OPAL_ASSEMBLY_FORMAT])
-      fi # if ompi_cv_asm_arch = SYNC_BUILTIN
+      fi # if ompi_cv_asm_arch = SYNC_BUILTIN or GCC_BUILTIN
     fi # if cv_c_compiler_vendor = microsoft
 
     result="OMPI_$ompi_cv_asm_arch"
@@ -978,7 +1007,7 @@ AC_DEFUN([OMPI_ASM_FIND_FILE], [
     AC_REQUIRE([AC_PROG_GREP])
     AC_REQUIRE([AC_PROG_FGREP])
 
-if test "$ompi_cv_asm_arch" != "WINDOWS" -a "$ompi_cv_asm_arch" != "SYNC_BUILTIN" ; then
+if test "$ompi_cv_asm_arch" != "WINDOWS" -a "$ompi_cv_asm_arch" != "SYNC_BUILTIN" -a "$ompi_cv_asm_arch" != "GCC_BUILTIN" ; then
     AC_CHECK_PROG([PERL], [perl], [perl])
 
     # see if we have a pre-built one already
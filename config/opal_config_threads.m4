@@ -214,5 +214,30 @@ AC_DEFINE_UNQUOTED([OPAL_ENABLE_MULTI_THREADS], [$OPAL_ENABLE_MULTI_THREADS],
 AC_MSG_RESULT([$enable_opal_multi_threads])
 
 
+#
+# Default kind of the OPAL mutexes
+#
+AC_MSG_CHECKING([which kind of OPAL mutex to use by default])
+AC_ARG_WITH([opal-mutex],
+    AC_HELP_STRING([--with-opal-mutex=KIND],
+        [Default kind of the OPAL mutexes: "pthread" (plain pthread mutexes) or "adaptive" (ticket locks that spin for a learned budget, then sleep on a futex).  The opal_mutex_adaptive MCA parameter overrides it at run time (default: pthread)]))
+case "$with_opal_mutex" in
+    adaptive)
+        OPAL_MUTEX_DEFAULT_ADAPTIVE=1
+        ;;
+    ""|yes|no|pthread)
+        with_opal_mutex=pthread
+        OPAL_MUTEX_DEFAULT_ADAPTIVE=0
+        ;;
+    *)
+        AC_MSG_RESULT([$with_opal_mutex])
+        AC_MSG_ERROR([Unknown OPAL mutex kind: $with_opal_mutex])
+        ;;
+esac
+AC_MSG_RESULT([$with_opal_mutex])
+AC_DEFINE_UNQUOTED([OPAL_MUTEX_DEFAULT_ADAPTIVE], [$OPAL_MUTEX_DEFAULT_ADAPTIVE],
+                   [Whether the OPAL mutexes are adaptive ticket locks by default])
+AC_CHECK_HEADERS([linux/futex.h sys/syscall.h])
+
 ])dnl
 
@@ -0,0 +1,63 @@
+#!/bin/sh
+#
+# Copyright (c) 2013      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+# Write the index of the dynamic components installed in a directory,
+# which spares MPI_INIT a scan of the directory and the probing of
+# every file:
+#
+#   opal_mca_component_index.sh <pkglibdir> <version>
+#
+# The index (mca-component-index) has one line per component:
+#
+#   <framework> <component> <version> <file> [<framework>:<component> ...]
+#
+# the last fields being the dependencies of the .ompi_info companion
+# file, if any.  It is ignored at run time when its version is not the
+# one of the library, or when the directory changed after it.
+
+dir="$1"
+version="$2"
+index="mca-component-index"
+
+if test -z "$dir" || test -z "$version"; then
+    echo "usage: $0 <pkglibdir> <version>" >&2
+    exit 1
+fi
+test -d "$dir" || exit 0
+
+tmp="$dir/.$index.$$"
+trap 'rm -f "$tmp"' 0 1 2 15
+
+{
+    echo "# Open MPI component index -- generated at install time, do not edit"
+    echo "version $version"
+    for file in "$dir"/mca_*; do
+        base=`basename "$file"`
+        case "$base" in
+            *.so|*.dylib|*.dll) ;;
+            *) continue ;;
+        esac
+        stem=`echo "$base" | sed -e 's/\.[^.]*$//'`
+        framework=`echo "$stem" | sed -e 's/^mca_\([^_]*\)_.*$/\1/'`
+        component=`echo "$stem" | sed -e 's/^mca_[^_]*_//'`
+        test -n "$framework" && test -n "$component" || continue
+        deps=
+        if test -f "$dir/$stem.ompi_info"; then
+            deps=`sed -n -e 's/^[ 	]*[dD][eE][pP][eE][nN][dD][eE][nN][cC][yY]=\([^ 	]*\).*$/\1/p' \
+                "$dir/$stem.ompi_info" | tr '\n' ' '`
+        fi
+        echo "$framework $component $version $base $deps"
+    done
+} > "$tmp" || exit 1
+
+mv -f "$tmp" "$dir/$index" || exit 1
+# not older than the directory, which the rename just modified
+touch "$dir/$index"
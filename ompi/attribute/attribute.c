@@ -392,11 +392,26 @@ static OBJ_CLASS_INSTANCE(ompi_attribute_keyval_t,
                           ompi_attribute_keyval_destruct);
 
 
+/*
+ * ompi_attribute_hash_t class
+ */
+static void ompi_attribute_hash_construct(ompi_attribute_hash_t *hash)
+{
+    memset(hash->direct, 0, sizeof(hash->direct));
+}
+
+OBJ_CLASS_INSTANCE(ompi_attribute_hash_t,
+                   opal_hash_table_t,
+                   ompi_attribute_hash_construct,
+                   NULL);
+
+
 /* 
  * Static variables 
  */
 
 static opal_hash_table_t *keyval_hash;
+static ompi_attribute_keyval_t *keyval_direct[OMPI_ATTR_DIRECT_MAX];
 static opal_bitmap_t *key_bitmap;
 static int attr_sequence;
 static unsigned int int_pos = 12345;
@@ -412,6 +427,44 @@ static unsigned int int_pos = 12345;
 static opal_mutex_t attribute_lock;
 
 
+/*
+ * The keyval of a key, NULL if there is none
+ */
+static inline ompi_attribute_keyval_t *lookup_keyval(int key)
+{
+    ompi_attribute_keyval_t *keyval;
+
+    if (0 <= key && key < OMPI_ATTR_DIRECT_MAX) {
+        return keyval_direct[key];
+    }
+    if (OMPI_SUCCESS != opal_hash_table_get_value_uint32(keyval_hash, key,
+                                                         (void **) &keyval)) {
+        return NULL;
+    }
+    return keyval;
+}
+
+
+/*
+ * The attribute of an object for a key, NULL if there is none
+ */
+static inline attribute_value_t *lookup_attr(opal_hash_table_t *attr_hash, int key)
+{
+    void *attr;
+
+    if (NULL == attr_hash) {
+        return NULL;
+    }
+    if (0 <= key && key < OMPI_ATTR_DIRECT_MAX) {
+        return (attribute_value_t *) ((ompi_attribute_hash_t *) attr_hash)->direct[key];
+    }
+    if (OMPI_SUCCESS != opal_hash_table_get_value_uint32(attr_hash, key, &attr)) {
+        return NULL;
+    }
+    return (attribute_value_t *) attr;
+}
+
+
 /*
  * attribute_value_t constructor function
  */
@@ -457,6 +510,9 @@ ompi_attribute_keyval_destruct(ompi_attribute_keyval_t *keyval)
         }
 
         opal_hash_table_remove_value_uint32(keyval_hash, keyval->key);
+        if (keyval->key < OMPI_ATTR_DIRECT_MAX) {
+            keyval_direct[keyval->key] = NULL;
+        }
         FREE_KEY(keyval->key);
     }
 }
@@ -493,6 +549,7 @@ int ompi_attr_init(void)
     }
 
     OBJ_CONSTRUCT(&attribute_lock, opal_mutex_t);
+    memset(keyval_direct, 0, sizeof(keyval_direct));
 
     if (OMPI_SUCCESS != (ret = opal_hash_table_init(keyval_hash,
                                                     ATTR_TABLE_SIZE))) {
@@ -555,6 +612,9 @@ static int ompi_attr_create_keyval_impl(ompi_attribute_type_t type,
     if (OMPI_SUCCESS == ret) {
         keyval->key = *key;
         ret = opal_hash_table_set_value_uint32(keyval_hash, *key, keyval);
+        if (OMPI_SUCCESS == ret && 0 <= *key && *key < OMPI_ATTR_DIRECT_MAX) {
+            keyval_direct[*key] = keyval;
+        }
     }
 
     if (OMPI_SUCCESS != ret) {
@@ -943,10 +1003,9 @@ static int ompi_attr_delete_impl(ompi_attribute_type_t type, void *object,
     attribute_value_t *attr;
 
     /* Check if the key is valid in the master keyval hash */
-    ret = opal_hash_table_get_value_uint32(keyval_hash, key, 
-                                           (void **) &keyval);
+    keyval = lookup_keyval(key);
 
-    if ((OMPI_SUCCESS != ret) || (NULL == keyval) ||
+    if ((NULL == keyval) ||
         (keyval->attr_type!= type) ||
         ((!predefined) && (keyval->attr_flag & OMPI_KEYVAL_PREDEFINED))) {
         ret = OMPI_ERR_BAD_PARAM;
@@ -962,8 +1021,9 @@ static int ompi_attr_delete_impl(ompi_attribute_type_t type, void *object,
     /* Check if the key is valid for the communicator/window/dtype. If
        yes, then delete the attribute and key entry from the object's
        hash */
-    ret = opal_hash_table_get_value_uint32(attr_hash, key, (void**) &attr);
-    if (OMPI_SUCCESS == ret) {
+    attr = lookup_attr(attr_hash, key);
+    ret = (NULL == attr) ? OMPI_ERR_NOT_FOUND : OMPI_SUCCESS;
+    if (NULL != attr) {
         switch (type) {
         case COMM_ATTR:
             DELETE_ATTR_CALLBACKS(communicator, attr, keyval, object, ret);
@@ -989,6 +1049,9 @@ static int ompi_attr_delete_impl(ompi_attribute_type_t type, void *object,
         /* Ignore the return value at this point; it can't help any
            more */
         (void) opal_hash_table_remove_value_uint32(attr_hash, key);
+        if (0 <= key && key < OMPI_ATTR_DIRECT_MAX) {
+            ((ompi_attribute_hash_t *) attr_hash)->direct[key] = NULL;
+        }
         OBJ_RELEASE(attr);
     }
 
@@ -1104,11 +1167,10 @@ static int set_value(ompi_attribute_type_t type, void *object,
     /* Note that this function can be invoked by ompi_attr_copy_all()
        to set attributes on the new object (in addition to the
        top-level MPI_* functions that set attributes). */
-    ret = opal_hash_table_get_value_uint32(keyval_hash, key, 
-                                           (void **) &keyval);
+    keyval = lookup_keyval(key);
 
     /* If key not found */
-    if ((OMPI_SUCCESS != ret ) || (NULL == keyval) || 
+    if ((NULL == keyval) || 
         (keyval->attr_type != type) ||
         ((!predefined) && (keyval->attr_flag & OMPI_KEYVAL_PREDEFINED))) {
         return OMPI_ERR_BAD_PARAM;
@@ -1121,8 +1183,8 @@ static int set_value(ompi_attribute_type_t type, void *object,
 
     /* Now see if an attribute is already present in the object's hash
        on the old keyval. If so, delete the old attribute value. */
-    ret = opal_hash_table_get_value_uint32(*attr_hash, key, (void**) &old_attr);
-    if (OMPI_SUCCESS == ret)  {
+    old_attr = lookup_attr(*attr_hash, key);
+    if (NULL != old_attr)  {
         switch (type) {
         case COMM_ATTR:
             DELETE_ATTR_CALLBACKS(communicator, old_attr, keyval, object, ret);
@@ -1147,9 +1209,8 @@ static int set_value(ompi_attribute_type_t type, void *object,
         had_old = true;
     }
 
-    ret = opal_hash_table_get_value_uint32(keyval_hash, key,
-                                           (void **) &keyval);
-    if ((OMPI_SUCCESS != ret ) || (NULL == keyval)) {
+    keyval = lookup_keyval(key);
+    if (NULL == keyval) {
         /* Keyval has disappeared underneath us -- this shouldn't
            happen! */
         assert(0);
@@ -1160,6 +1221,9 @@ static int set_value(ompi_attribute_type_t type, void *object,
     new_attr->av_sequence = attr_sequence++;
 
     ret = opal_hash_table_set_value_uint32(*attr_hash, key, new_attr);
+    if (OMPI_SUCCESS == ret && 0 <= key && key < OMPI_ATTR_DIRECT_MAX) {
+        ((ompi_attribute_hash_t *) *attr_hash)->direct[key] = new_attr;
+    }
 
     /* Increase the reference count of the object, only if there was no
        old atribute/no old entry in the object's key hash */
@@ -1183,9 +1247,7 @@ static int set_value(ompi_attribute_type_t type, void *object,
 static int get_value(opal_hash_table_t *attr_hash, int key, 
                      attribute_value_t **attribute, int *flag)
 {
-    int ret;
-    void *attr;
-    ompi_attribute_keyval_t *keyval;
+    attribute_value_t *attr;
 
     /* According to MPI specs, the call is invalid if the keyval does
        not exist (i.e., the key is not present in the main keyval
@@ -1193,21 +1255,15 @@ static int get_value(opal_hash_table_t *attr_hash, int key,
        with the key, then the call is valid and returns FALSE in the
        flag argument */
     *flag = 0;
-    ret = opal_hash_table_get_value_uint32(keyval_hash, key, 
-                                           (void**) &keyval);
-    if (OMPI_ERR_NOT_FOUND == ret) {
+    if (NULL == lookup_keyval(key)) {
         return MPI_KEYVAL_INVALID;
     }
 
     /* If we have a null attr_hash table, that means that nothing has
        been cached on this object yet.  So just return *flag = 0. */
-    if (NULL == attr_hash) {
-        return OMPI_SUCCESS;
-    }
-
-    ret = opal_hash_table_get_value_uint32(attr_hash, key, &attr);
-    if (OMPI_SUCCESS == ret) {
-        *attribute = (attribute_value_t*)attr;
+    attr = lookup_attr(attr_hash, key);
+    if (NULL != attr) {
+        *attribute = attr;
         *flag = 1;
     }
 
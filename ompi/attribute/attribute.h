@@ -36,6 +36,12 @@
 
 #define ATTR_HASH_SIZE 10
 
+/*
+ * Keyvals below this are also looked up in plain arrays, the global one
+ * of the keyvals and the one of every object with attributes
+ */
+#define OMPI_ATTR_DIRECT_MAX 32
+
 /* 
  * Flags for keyvals 
  */
@@ -173,6 +179,19 @@ struct ompi_attribute_keyval_t {
 };
 
 typedef struct ompi_attribute_keyval_t ompi_attribute_keyval_t;
+
+/**
+ * The attributes of an MPI object.  The hash is the reference, the
+ * attributes of the low keyvals are also indexed by key.
+ */
+struct ompi_attribute_hash_t {
+    opal_hash_table_t super;
+    void *direct[OMPI_ATTR_DIRECT_MAX];
+};
+
+typedef struct ompi_attribute_hash_t ompi_attribute_hash_t;
+
+OMPI_DECLSPEC OBJ_CLASS_DECLARATION(ompi_attribute_hash_t);
   
 
 /* Functions */
@@ -186,7 +205,7 @@ typedef struct ompi_attribute_keyval_t ompi_attribute_keyval_t;
 static inline
 int ompi_attr_hash_init(opal_hash_table_t **hash)
 {
-    *hash = OBJ_NEW(opal_hash_table_t);
+    *hash = (opal_hash_table_t *) OBJ_NEW(ompi_attribute_hash_t);
     if (NULL == *hash) {
         fprintf(stderr, "Error while creating the local attribute list\n");
         return MPI_ERR_SYSRESOURCE;
@@ -47,7 +47,8 @@
  *
  * MPI_IO is set to MPI_ANY_SOURCE.  We may need to revist this.
  *
- * MPI_WTIME_IS_GLOBAL is set to 0 (a conservative answer).
+ * MPI_WTIME_IS_GLOBAL is set to 0 (a conservative answer), unless
+ * mpi_wtime_global makes MPI_Wtime follow the clock of rank 0.
  *
  * MPI_APPNUM is set as the result of a GPR subscription.
  *
@@ -92,6 +93,7 @@
 #include "ompi/errhandler/errcode.h"
 #include "ompi/communicator/communicator.h"
 #include "ompi/mca/pml/pml.h"
+#include "ompi/runtime/params.h"
 
 /*
  * Private functions
@@ -143,7 +145,7 @@ int ompi_attr_create_predefined(void)
     if (OMPI_SUCCESS != (ret = set_f(MPI_TAG_UB, mca_pml.pml_max_tag)) ||
         OMPI_SUCCESS != (ret = set_f(MPI_HOST, MPI_PROC_NULL)) ||
         OMPI_SUCCESS != (ret = set_f(MPI_IO, MPI_ANY_SOURCE)) ||
-        OMPI_SUCCESS != (ret = set_f(MPI_WTIME_IS_GLOBAL, 0)) ||
+        OMPI_SUCCESS != (ret = set_f(MPI_WTIME_IS_GLOBAL, ompi_mpi_wtime_global ? 1 : 0)) ||
         OMPI_SUCCESS != (ret = set_f(MPI_LASTUSEDCODE,
                                      ompi_mpi_errcode_lastused)) ||
 #if 0
@@ -27,6 +27,7 @@
 #include "ompi/class/ompi_free_list.h"
 #include "opal/align.h"
 #include "opal/util/output.h"
+#include "opal/mca/hwloc/base/base.h"
 #include "ompi/mca/mpool/mpool.h"
 
 static void ompi_free_list_construct(ompi_free_list_t* fl);
@@ -56,6 +57,7 @@ static void ompi_free_list_construct(ompi_free_list_t* fl)
     fl->fl_frag_class = OBJ_CLASS(ompi_free_list_item_t);
     fl->fl_mpool = 0;
     fl->ctx = NULL;
+    fl->fl_numa_node = -1;
     OBJ_CONSTRUCT(&(fl->fl_allocations), opal_list_t);
 }
 
@@ -228,6 +230,18 @@ int ompi_free_list_grow(ompi_free_list_t* flist, size_t num_elements)
             free(alloc_ptr);
             return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
         }
+
+#if OPAL_HAVE_HWLOC
+        /* place the payloads before they are touched.  A failure is
+           reported by the hwloc base and only costs performance */
+        if (flist->fl_numa_node >= 0 && opal_hwloc_base_mem_bind_buffers) {
+            opal_hwloc_base_memory_segment_t seg;
+
+            seg.mbs_start_addr = payload_ptr;
+            seg.mbs_len = num_elements * elem_size;
+            (void) opal_hwloc_base_membind(&seg, 1, flist->fl_numa_node);
+        }
+#endif
     }
 
     /* make the alloc_ptr a list item, save the chunk in the allocations list,
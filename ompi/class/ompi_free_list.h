@@ -54,6 +54,7 @@ struct ompi_free_list_t
     opal_list_t fl_allocations;
     ompi_free_list_item_init_fn_t item_init;
     void* ctx;
+    int fl_numa_node;                   /* NUMA node of the payload buffers, -1 for none */
 };
 typedef struct ompi_free_list_t ompi_free_list_t;
 OMPI_DECLSPEC OBJ_CLASS_DECLARATION(ompi_free_list_t);
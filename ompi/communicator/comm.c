@@ -42,14 +42,21 @@
 #include "ompi/mca/dpm/dpm.h"
 
 #include "ompi/attribute/attribute.h"
+#include "ompi/info/info.h"
 #include "ompi/communicator/communicator.h"
 #include "ompi/mca/pml/pml.h"
 #include "ompi/request/request.h"
+#include "ompi/runtime/params.h"
 
 /*
 ** sort-function for MPI_Comm_split 
 */
 static int rankkeycompare(const void *, const void *);
+static bool split_type_peer(int split_type, ompi_proc_t *proc);
+static int colorkeyrankcompare(const void *, const void *);
+
+static int ompi_comm_split_sparse (ompi_communicator_t *comm, int color, int key,
+                                   int *my_size, int **lranks);
 
 /**
  * to fill the rest of the stuff for the communicator
@@ -349,6 +356,198 @@ int ompi_comm_create ( ompi_communicator_t *comm, ompi_group_t *group,
 /**********************************************************************/
 /**********************************************************************/
 /**********************************************************************/
+/*
+** Scalable part of MPI_Comm_split for large intra-communicators: instead
+** of handing the color and key of all processes to everybody, each
+** process only learns the members of its own new group.
+**
+** 1. Every process with a color sends (color, key) to the rendezvous
+**    process color % size with a synchronous send, and accepts whatever
+**    arrives for the colors it is rendezvous of.  Once its own send has
+**    been matched it enters an ibarrier; when the barrier completes, all
+**    sends have been matched, so the rendezvous processes have complete
+**    groups (this is the usual non-blocking consensus).
+** 2. The rendezvous sorts its entries by color, key and rank and sends
+**    the sorted rank list of each group to the first member.
+** 3. The list is forwarded along a binomial tree over the positions in
+**    the group, so that no process sends it more than log(n) times.
+**
+** Processes passing MPI_UNDEFINED get a group made of themselves only,
+** which the caller frees right away.  With one color the rendezvous
+** still receives size messages, but neither memory nor traffic is
+** proportional to the size of the communicator anywhere else.
+*/
+static int ompi_comm_split_sparse (ompi_communicator_t *comm, int color, int key,
+                                   int *my_size, int **lranks)
+{
+    int size = ompi_comm_size (comm);
+    int rank = ompi_comm_rank (comm);
+    int myinfo[2], info[2];
+    int *entries = NULL, nentries = 0, maxentries = 0;
+    int *sorted = NULL, *list = NULL;
+    int i, b, e, n, pos, mask, nfwd = 0, nsends = 0;
+    int flag, done = 0, rc = OMPI_SUCCESS;
+    bool barrier_active = false;
+    ompi_request_t *sendreq = MPI_REQUEST_NULL, *barrier = MPI_REQUEST_NULL;
+    ompi_request_t **sends = NULL, *fwd[8 * sizeof(int)];
+    ompi_status_public_t status;
+
+    /* Step 1: hand (color, key) to the rendezvous of the color */
+    if ( MPI_UNDEFINED != color ) {
+        myinfo[0] = color;
+        myinfo[1] = key;
+        rc = MCA_PML_CALL(isend (myinfo, 2, MPI_INT, (int)((unsigned int) color % size),
+                                 OMPI_COMM_SPLIT_TAG, MCA_PML_BASE_SEND_SYNCHRONOUS,
+                                 comm, &sendreq));
+        if ( OMPI_SUCCESS != rc ) {
+            goto exit;
+        }
+    }
+
+    while ( !done ) {
+        rc = MCA_PML_CALL(iprobe (MPI_ANY_SOURCE, OMPI_COMM_SPLIT_TAG, comm,
+                                  &flag, &status));
+        if ( OMPI_SUCCESS != rc ) {
+            goto exit;
+        }
+        if ( flag ) {
+            if ( nentries == maxentries ) {
+                int *tmp;
+
+                maxentries = (0 == maxentries) ? 16 : 2 * maxentries;
+                tmp = (int *) realloc (entries, 3 * maxentries * sizeof(int));
+                if ( NULL == tmp ) {
+                    rc = OMPI_ERR_OUT_OF_RESOURCE;
+                    goto exit;
+                }
+                entries = tmp;
+            }
+            rc = MCA_PML_CALL(recv (info, 2, MPI_INT, status.MPI_SOURCE,
+                                    OMPI_COMM_SPLIT_TAG, comm, MPI_STATUS_IGNORE));
+            if ( OMPI_SUCCESS != rc ) {
+                goto exit;
+            }
+            entries[(3*nentries)+0] = info[0];            /* color */
+            entries[(3*nentries)+1] = info[1];            /* key */
+            entries[(3*nentries)+2] = status.MPI_SOURCE;  /* org rank */
+            nentries++;
+            continue;
+        }
+
+        if ( barrier_active ) {
+            rc = ompi_request_test (&barrier, &done, MPI_STATUS_IGNORE);
+        } else {
+            rc = ompi_request_test (&sendreq, &flag, MPI_STATUS_IGNORE);
+            if ( OMPI_SUCCESS == rc && flag ) {
+                rc = comm->c_coll.coll_ibarrier (comm, &barrier,
+                                                 comm->c_coll.coll_ibarrier_module);
+                barrier_active = true;
+            }
+        }
+        if ( OMPI_SUCCESS != rc ) {
+            goto exit;
+        }
+    }
+
+    /* Step 2: sort the groups we are rendezvous of and send them out */
+    if ( 0 < nentries ) {
+        if ( 1 < nentries ) {
+            qsort (entries, nentries, 3 * sizeof(int), colorkeyrankcompare);
+        }
+        sorted = (int *) malloc (nentries * sizeof(int));
+        sends  = (ompi_request_t **) malloc (nentries * sizeof(ompi_request_t *));
+        if ( NULL == sorted || NULL == sends ) {
+            rc = OMPI_ERR_OUT_OF_RESOURCE;
+            goto exit;
+        }
+        for ( i = 0; i < nentries; i++ ) {
+            sorted[i] = entries[(3*i)+2];
+        }
+        for ( b = 0; b < nentries; b = e ) {
+            for ( e = b + 1; e < nentries && entries[3*e] == entries[3*b]; e++ );
+            rc = MCA_PML_CALL(isend (sorted + b, e - b, MPI_INT, sorted[b],
+                                     OMPI_COMM_SPLIT_LIST_TAG,
+                                     MCA_PML_BASE_SEND_STANDARD, comm,
+                                     &sends[nsends]));
+            if ( OMPI_SUCCESS != rc ) {
+                goto exit;
+            }
+            nsends++;
+        }
+    }
+
+    /* Step 3: receive the list of our group and pass it on */
+    if ( MPI_UNDEFINED != color ) {
+        /* we belong to exactly one group, hence get exactly one list */
+        rc = MCA_PML_CALL(probe (MPI_ANY_SOURCE, OMPI_COMM_SPLIT_LIST_TAG, comm,
+                                 &status));
+        if ( OMPI_SUCCESS != rc ) {
+            goto exit;
+        }
+        n = (int) (status._ucount / sizeof(int));
+        list = (int *) malloc (n * sizeof(int));
+        if ( NULL == list ) {
+            rc = OMPI_ERR_OUT_OF_RESOURCE;
+            goto exit;
+        }
+        rc = MCA_PML_CALL(recv (list, n, MPI_INT, status.MPI_SOURCE,
+                                OMPI_COMM_SPLIT_LIST_TAG, comm, MPI_STATUS_IGNORE));
+        if ( OMPI_SUCCESS != rc ) {
+            goto exit;
+        }
+
+        for ( pos = 0; pos < n && list[pos] != rank; pos++ );
+        for ( mask = 1; mask < n && 0 == (pos & mask); mask <<= 1 ) {
+            if ( pos + mask < n ) {
+                rc = MCA_PML_CALL(isend (list, n, MPI_INT, list[pos+mask],
+                                         OMPI_COMM_SPLIT_LIST_TAG,
+                                         MCA_PML_BASE_SEND_STANDARD, comm,
+                                         &fwd[nfwd]));
+                if ( OMPI_SUCCESS != rc ) {
+                    goto exit;
+                }
+                nfwd++;
+            }
+        }
+        rc = ompi_request_wait_all (nfwd, fwd, MPI_STATUSES_IGNORE);
+        if ( OMPI_SUCCESS != rc ) {
+            goto exit;
+        }
+    } else {
+        n = 1;
+        list = (int *) malloc (sizeof(int));
+        if ( NULL == list ) {
+            rc = OMPI_ERR_OUT_OF_RESOURCE;
+            goto exit;
+        }
+        list[0] = rank;
+    }
+
+    rc = ompi_request_wait_all (nsends, sends, MPI_STATUSES_IGNORE);
+    if ( OMPI_SUCCESS != rc ) {
+        goto exit;
+    }
+
+    *my_size = n;
+    *lranks  = list;
+    list     = NULL;
+
+ exit:
+    if ( NULL != entries ) {
+        free ( entries );
+    }
+    if ( NULL != sorted ) {
+        free ( sorted );
+    }
+    if ( NULL != sends ) {
+        free ( sends );
+    }
+    if ( NULL != list ) {
+        free ( list );
+    }
+    return rc;
+}
+
 /*
 ** Counterpart to MPI_Comm_split. To be used within OMPI (e.g. MPI_Cart_sub).
 */
@@ -385,6 +584,18 @@ int ompi_comm_split( ompi_communicator_t* comm, int color, int key,
         allgatherfct = (ompi_comm_allgatherfct *)comm->c_coll.coll_allgather;
     }
 
+    if ( !inter && 0 < ompi_mpi_comm_split_threshold &&
+         size >= ompi_mpi_comm_split_threshold ) {
+        rc = ompi_comm_split_sparse ( comm, color, key, &my_size, &lranks );
+        if ( OMPI_SUCCESS != rc ) {
+            goto exit;
+        }
+        my_rsize = 0;
+        rranks   = NULL;
+        mode     = OMPI_COMM_CID_INTRA;
+        goto create;
+    }
+
     results  = (int*) malloc ( 2 * size * sizeof(int));
     if ( NULL == results ) {
         return OMPI_ERR_OUT_OF_RESOURCE;
@@ -499,7 +710,7 @@ int ompi_comm_split( ompi_communicator_t* comm, int color, int key,
     /* Step 3: set up the communicator                           */
     /* --------------------------------------------------------- */
     /* Create the communicator finally */
-
+ create:
     rc = ompi_comm_set ( &newcomp,           /* new comm */
                          comm,               /* old comm */
                          my_size,            /* local_size */
@@ -603,7 +814,7 @@ ompi_comm_split_type(ompi_communicator_t *comm,
     int my_rsize;
     int mode;
     int rsize;
-    int i, loc;
+    int i;
     int inter;
     int *results=NULL, *sorted=NULL; 
     int *rresults=NULL, *rsorted=NULL; 
@@ -616,8 +827,10 @@ ompi_comm_split_type(ompi_communicator_t *comm,
     /* Step 1: determine all the information for the local group */
     /* --------------------------------------------------------- */
 
-    /* sort according to participation and rank. Gather information from everyone */
-    myinfo[0] = (split_type == MPI_COMM_TYPE_SHARED) ? 1 : 0;
+    /* sort according to participation and rank. Gather information from
+     * everyone - the split type doubles as the participation flag, so
+     * procs asking for different types never end up together */
+    myinfo[0] = split_type;
     myinfo[1] = key;
 
     size     = ompi_comm_size ( comm );
@@ -638,29 +851,21 @@ ompi_comm_split_type(ompi_communicator_t *comm,
         goto exit;
     }
         
-    /* how many are participating and on my node? */
-    for ( my_size = 0, i=0; i < size; i++) {
-        if ( results[(2*i)+0] == 1) {
-            if (OPAL_PROC_ON_LOCAL_NODE(ompi_group_peer_lookup(comm->c_local_group, i)->proc_flags)) {
-                my_size++;
-            }
-        }
-    }
-
-    sorted = (int *) malloc ( sizeof( int ) * my_size * 2);
+    sorted = (int *) malloc ( sizeof( int ) * size * 2);
     if ( NULL == sorted) {
         rc =  OMPI_ERR_OUT_OF_RESOURCE;
         goto exit;
     }
     
-    /* ok we can now fill this info */
-    for( loc = 0, i = 0; i < size; i++ ) {
-        if ( results[(2*i)+0] == 1) {
-            if (OPAL_PROC_ON_LOCAL_NODE(ompi_group_peer_lookup(comm->c_local_group, i)->proc_flags)) {
-                sorted[(2*loc)+0] = i;                 /* copy org rank */
-                sorted[(2*loc)+1] = results[(2*i)+1];  /* copy key */
-                loc++;
-            }
+    /* who is participating and shares the requested resource with me?
+     * The locality of every peer is already known, so a single pass
+     * over the group is all it takes */
+    for( my_size = 0, i = 0; i < size; i++ ) {
+        if ( MPI_UNDEFINED != split_type && results[(2*i)+0] == split_type &&
+             split_type_peer(split_type, ompi_group_peer_lookup(comm->c_local_group, i))) {
+            sorted[(2*my_size)+0] = i;                 /* copy org rank */
+            sorted[(2*my_size)+1] = results[(2*i)+1];  /* copy key */
+            my_size++;
         }
     }
     
@@ -698,28 +903,19 @@ ompi_comm_split_type(ompi_communicator_t *comm,
             goto exit;
         }
 
-        /* how many are participating and on my node? */
-        for ( my_rsize = 0, i=0; i < rsize; i++) {
-            if ( rresults[(2*i)+0] == 1) {
-                if (OPAL_PROC_ON_LOCAL_NODE(ompi_group_peer_lookup(comm->c_remote_group, i)->proc_flags)) {
-                    my_rsize++;
-                }
-            }
-        }
-        rsorted = (int *) malloc ( sizeof( int ) * my_rsize * 2);
+        rsorted = (int *) malloc ( sizeof( int ) * rsize * 2);
         if ( NULL == rsorted) {
             rc = OMPI_ERR_OUT_OF_RESOURCE;
             goto exit;
         }
         
-        /* ok we can now fill this info */
-        for( loc = 0, i = 0; i < rsize; i++ ) {
-            if ( rresults[(2*i)+0] == 1) {
-                if (OPAL_PROC_ON_LOCAL_NODE(ompi_group_peer_lookup(comm->c_remote_group, i)->proc_flags)) {
-                    rsorted[(2*loc)+0] = i;                  /* org rank */
-                    rsorted[(2*loc)+1] = rresults[(2*i)+1];  /* key */
-                    loc++;
-                }
+        /* who is participating and shares the requested resource with me? */
+        for( my_rsize = 0, i = 0; i < rsize; i++ ) {
+            if ( MPI_UNDEFINED != split_type && rresults[(2*i)+0] == split_type &&
+                 split_type_peer(split_type, ompi_group_peer_lookup(comm->c_remote_group, i))) {
+                rsorted[(2*my_rsize)+0] = i;                  /* org rank */
+                rsorted[(2*my_rsize)+1] = rresults[(2*i)+1];  /* key */
+                my_rsize++;
             }
         }
         
@@ -844,6 +1040,45 @@ ompi_comm_split_type(ompi_communicator_t *comm,
 /**********************************************************************/
 /**********************************************************************/
 int ompi_comm_dup ( ompi_communicator_t * comm, ompi_communicator_t **newcomm )
+{
+    return ompi_comm_dup_with_info (comm, NULL, newcomm);
+}
+
+/*
+ * Translate the assertions of an info object into communicator flags.
+ */
+static void ompi_comm_assert_from_info (ompi_communicator_t *comm, ompi_info_t *info)
+{
+    static const struct {
+        char *key;
+        uint32_t flag;
+    } asserts[] = {
+        { "mpi_assert_no_any_source",    OMPI_COMM_ASSERT_NO_ANY_SOURCE },
+        { "mpi_assert_no_any_tag",       OMPI_COMM_ASSERT_NO_ANY_TAG },
+        { "mpi_assert_allow_overtaking", OMPI_COMM_ASSERT_ALLOW_OVERTAKING },
+    };
+    size_t i;
+
+    if (NULL == info || MPI_INFO_NULL == info) {
+        return;
+    }
+
+    for (i = 0 ; i < sizeof(asserts) / sizeof(asserts[0]) ; ++i) {
+        bool value = false;
+        int flag = 0;
+
+        if (OMPI_SUCCESS == ompi_info_get_bool (info, asserts[i].key, &value, &flag) &&
+            flag && value) {
+            comm->c_flags |= asserts[i].flag;
+        }
+    }
+}
+
+/**********************************************************************/
+/**********************************************************************/
+/**********************************************************************/
+int ompi_comm_dup_with_info ( ompi_communicator_t * comm, ompi_info_t *info,
+                              ompi_communicator_t **newcomm )
 {
     ompi_communicator_t *newcomp = NULL;
     int rsize = 0, mode = OMPI_COMM_CID_INTRA, rc = OMPI_SUCCESS;
@@ -890,6 +1125,10 @@ int ompi_comm_dup ( ompi_communicator_t * comm, ompi_communicator_t **newcomm )
     snprintf(newcomp->c_name, MPI_MAX_OBJECT_NAME, "MPI COMMUNICATOR %d DUP FROM %d", 
              newcomp->c_contextid, comm->c_contextid );
 
+    /* the assertions have to be in place before the PML adds the
+       communicator, as they change how it matches */
+    ompi_comm_assert_from_info (newcomp, info);
+
     /* activate communicator and init coll-module */
     rc = ompi_comm_activate( &newcomp, /* new communicator */ 
                              comm,
@@ -1462,6 +1701,42 @@ int ompi_comm_dump ( ompi_communicator_t *comm )
 ** rankkeygidcompare() compares a tuple of (rank,key,gid) producing 
 ** sorted lists that match the rules needed for a MPI_Comm_split 
 */
+/*
+ * Does proc share the resource named by split_type with us?  This is
+ * answered from the locality computed at startup, with no communication
+ */
+static bool split_type_peer (int split_type, ompi_proc_t *proc)
+{
+    opal_hwloc_locality_t flags = proc->proc_flags;
+
+    switch (split_type) {
+    case OMPI_COMM_TYPE_HWTHREAD:
+        return OPAL_PROC_ON_LOCAL_HWTHREAD(flags);
+    case OMPI_COMM_TYPE_CORE:
+        return OPAL_PROC_ON_LOCAL_CORE(flags);
+    case OMPI_COMM_TYPE_L1CACHE:
+        return OPAL_PROC_ON_LOCAL_L1CACHE(flags);
+    case OMPI_COMM_TYPE_L2CACHE:
+        return OPAL_PROC_ON_LOCAL_L2CACHE(flags);
+    case OMPI_COMM_TYPE_L3CACHE:
+        return OPAL_PROC_ON_LOCAL_L3CACHE(flags);
+    case OMPI_COMM_TYPE_SOCKET:
+        return OPAL_PROC_ON_LOCAL_SOCKET(flags);
+    case OMPI_COMM_TYPE_NUMA:
+        return OPAL_PROC_ON_LOCAL_NUMA(flags);
+    case OMPI_COMM_TYPE_BOARD:
+        return OPAL_PROC_ON_LOCAL_BOARD(flags);
+    case MPI_COMM_TYPE_SHARED:
+        return OPAL_PROC_ON_LOCAL_NODE(flags);
+    case OMPI_COMM_TYPE_CU:
+        return OPAL_PROC_ON_LOCAL_CU(flags);
+    case OMPI_COMM_TYPE_CLUSTER:
+        return OPAL_PROC_ON_LOCAL_CLUSTER(flags);
+    default:
+        return false;
+    }
+}
+
 static int rankkeycompare (const void *p, const void *q)
 {
     int *a, *b;
@@ -1494,6 +1769,24 @@ static int rankkeycompare (const void *p, const void *q)
     return ( 0 );
 }
 
+/* entries of ompi_comm_split_sparse: color at [0], key at [1], rank at [2] */
+static int colorkeyrankcompare (const void *p, const void *q)
+{
+    const int *a = (const int *) p;
+    const int *b = (const int *) q;
+
+    if (a[0] != b[0]) {
+        return (a[0] < b[0]) ? -1 : 1;
+    }
+    if (a[1] != b[1]) {
+        return (a[1] < b[1]) ? -1 : 1;
+    }
+    if (a[2] != b[2]) {
+        return (a[2] < b[2]) ? -1 : 1;
+    }
+    return 0;
+}
+
 
 /***********************************************************************
  * Counterpart of MPI_Cart/Graph_create. This will be called from the
@@ -26,6 +26,8 @@
 
 #include "ompi_config.h"
 
+#include <string.h>
+
 #include "opal/dss/dss.h"
 #include "ompi/proc/proc.h" 
 #include "ompi/communicator/communicator.h"
@@ -39,6 +41,7 @@
 #include "ompi/request/request.h"
 #include "ompi/runtime/ompi_module_exchange.h" 
 #include "ompi/runtime/mpiruntime.h"
+#include "ompi/runtime/params.h"
 
 BEGIN_C_DECLS
 
@@ -89,6 +92,9 @@ static int ompi_comm_allreduce_intra_oob (int *inbuf, int* outbuf,
                                           void* remote_leader, 
                                           int send_first );
 
+static int ompi_comm_nextcid_window (ompi_communicator_t *comm, int *start,
+                                     int *nextcid);
+
 static int      ompi_comm_register_cid (uint32_t contextid);
 static int      ompi_comm_unregister_cid (uint32_t contextid);
 static uint32_t ompi_comm_lowest_cid ( void );
@@ -222,6 +228,18 @@ int ompi_comm_nextcid ( ompi_communicator_t* newcomm,
         }
         OPAL_THREAD_UNLOCK(&ompi_cid_lock);
 
+        if (OMPI_COMM_CID_INTRA == mode && 0 < ompi_mpi_cid_window) {
+            ret = ompi_comm_nextcid_window (comm, &start, &nextcid);
+            if (OMPI_SUCCESS == ret) {
+                done = 1;
+                break;
+            }
+            if (OMPI_ERR_NOT_FOUND == ret) {
+                continue;   /* all processes moved to the same new window */
+            }
+            goto release_and_return;
+        }
+
         for (i=start; i < mca_pml.pml_max_contextid ; i++) {
             flag = opal_pointer_array_test_and_set_item(&ompi_mpi_communicators, 
                                                         i, comm);
@@ -287,6 +305,77 @@ int ompi_comm_nextcid ( ompi_communicator_t* newcomm,
     return ret;
 }
 
+/*
+ * One round of the windowed CID allocation for intra-communicators.
+ * Every process describes the window of ompi_mpi_cid_window context IDs
+ * starting at *start by a bitmap of its free entries, preceded by *start
+ * and its complement, and a single MPI_BAND allreduce combines them:
+ *
+ * - if all processes used the same start, the two header words are
+ *   complements of each other again and the lowest bit set in the
+ *   bitmap is a CID free everywhere, which we take;
+ * - if they did not, the first header word has lost some bits and the
+ *   complement of the second one is the OR of all starts, which is at
+ *   least as large as any of them.  Everybody retries from there.
+ *
+ * The usual case, a communicator created from a parent on which all
+ * processes have allocated the same CIDs, therefore costs one
+ * collective instead of the two (or more) of the iterative algorithm.
+ * Returns OMPI_ERR_NOT_FOUND when *start was moved for another round.
+ */
+static int ompi_comm_nextcid_window (ompi_communicator_t *comm, int *start,
+                                     int *nextcid)
+{
+    unsigned int inbuf[2 + 1024 / (8 * sizeof(unsigned int))];
+    unsigned int outbuf[2 + 1024 / (8 * sizeof(unsigned int))];
+    const int bits = 8 * sizeof(unsigned int);
+    int count = 2 + (ompi_mpi_cid_window + bits - 1) / bits;
+    int i, cid, ret;
+
+    memset (inbuf, 0, count * sizeof(unsigned int));
+    inbuf[0] = (unsigned int) *start;
+    inbuf[1] = ~((unsigned int) *start);
+    for (i = 0; i < ompi_mpi_cid_window; i++) {
+        cid = *start + i;
+        if (cid >= (int) mca_pml.pml_max_contextid) {
+            break;
+        }
+        if (NULL == opal_pointer_array_get_item (&ompi_mpi_communicators, cid)) {
+            inbuf[2 + i / bits] |= 1u << (i % bits);
+        }
+    }
+
+    ret = ompi_comm_allreduce_intra ((int *) inbuf, (int *) outbuf, count,
+                                     MPI_BAND, comm, NULL, NULL, NULL, 0);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    if (~0u != (outbuf[0] | outbuf[1])) {
+        *start = (int) ~outbuf[1];
+        return OMPI_ERR_NOT_FOUND;
+    }
+
+    for (i = 0; i < ompi_mpi_cid_window; i++) {
+        if (outbuf[2 + i / bits] & (1u << (i % bits))) {
+            /* free on every process, and nobody else can take it in between
+             * since only the lowest registered communicator gets here */
+            if (!opal_pointer_array_test_and_set_item (&ompi_mpi_communicators,
+                                                       *start + i, comm)) {
+                return OMPI_ERROR;
+            }
+            *nextcid = *start + i;
+            return OMPI_SUCCESS;
+        }
+    }
+
+    *start += ompi_mpi_cid_window;
+    if (*start >= (int) mca_pml.pml_max_contextid) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    return OMPI_ERR_NOT_FOUND;
+}
+
 /**************************************************************************/
 /**************************************************************************/
 /**************************************************************************/
@@ -50,6 +50,9 @@ OMPI_DECLSPEC OBJ_CLASS_DECLARATION(ompi_communicator_t);
 #define OMPI_COMM_DIST_GRAPH   0x00000400
 #define OMPI_COMM_PML_ADDED    0x00001000
 #define OMPI_COMM_EXTRA_RETAIN 0x00004000
+#define OMPI_COMM_ASSERT_NO_ANY_SOURCE   0x00008000
+#define OMPI_COMM_ASSERT_NO_ANY_TAG      0x00010000
+#define OMPI_COMM_ASSERT_ALLOW_OVERTAKING 0x00020000
 
 /* some utility #defines */
 #define OMPI_COMM_IS_INTER(comm) ((comm)->c_flags & OMPI_COMM_INTER)
@@ -64,6 +67,12 @@ OMPI_DECLSPEC OBJ_CLASS_DECLARATION(ompi_communicator_t);
 #define OMPI_COMM_IS_PML_ADDED(comm) ((comm)->c_flags & OMPI_COMM_PML_ADDED)
 #define OMPI_COMM_IS_EXTRA_RETAIN(comm) ((comm)->c_flags & OMPI_COMM_EXTRA_RETAIN)
 
+/* assertions given through the info of MPI_Comm_dup_with_info.  They
+   are fixed when the communicator is created, before the PML sees it. */
+#define OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE(comm) ((comm)->c_flags & OMPI_COMM_ASSERT_NO_ANY_SOURCE)
+#define OMPI_COMM_CHECK_ASSERT_NO_ANY_TAG(comm) ((comm)->c_flags & OMPI_COMM_ASSERT_NO_ANY_TAG)
+#define OMPI_COMM_CHECK_ASSERT_ALLOW_OVERTAKING(comm) ((comm)->c_flags & OMPI_COMM_ASSERT_ALLOW_OVERTAKING)
+
 
 #define OMPI_COMM_SET_DYNAMIC(comm) ((comm)->c_flags |= OMPI_COMM_DYNAMIC)
 #define OMPI_COMM_SET_INVALID(comm) ((comm)->c_flags |= OMPI_COMM_INVALID)
@@ -77,6 +86,8 @@ OMPI_DECLSPEC OBJ_CLASS_DECLARATION(ompi_communicator_t);
 #define OMPI_COMM_ALLGATHER_TAG -31078
 #define OMPI_COMM_BARRIER_TAG   -31079
 #define OMPI_COMM_ALLREDUCE_TAG -31080
+#define OMPI_COMM_SPLIT_TAG     -31081
+#define OMPI_COMM_SPLIT_LIST_TAG -31082
 
 /**
  * Modes required for acquiring the new comm-id.
@@ -414,6 +425,18 @@ OMPI_DECLSPEC int ompi_comm_split_type(ompi_communicator_t *comm,
  * @param newcomm:   the new communicator or MPI_COMM_NULL if any error is detected.
  */
 OMPI_DECLSPEC int ompi_comm_dup (ompi_communicator_t *comm, ompi_communicator_t **newcomm);
+
+/**
+ * dup a communicator, setting the assertions found in info
+ * (mpi_assert_no_any_source, mpi_assert_no_any_tag and
+ * mpi_assert_allow_overtaking) on the new communicator.
+ *
+ * @param comm:      input communicator
+ * @param info:      info object, may be NULL
+ * @param newcomm:   the new communicator or MPI_COMM_NULL if any error is detected.
+ */
+OMPI_DECLSPEC int ompi_comm_dup_with_info (ompi_communicator_t *comm, struct ompi_info_t *info,
+                                           ompi_communicator_t **newcomm);
 /**
  * compare two communicators.
  *
@@ -59,7 +59,7 @@ BEGIN_C_DECLS
 #define OMPI_DATATYPE_FLAG_DATA_FORTRAN  0xC000
 #define OMPI_DATATYPE_FLAG_DATA_LANGUAGE 0xC000
 
-#define OMPI_DATATYPE_MAX_PREDEFINED 47
+#define OMPI_DATATYPE_MAX_PREDEFINED 49
 
 #if OMPI_DATATYPE_MAX_PREDEFINED > OPAL_DATATYPE_MAX_SUPPORTED
 #error Need to increase the number of supported dataypes by OPAL (value OPAL_DATATYPE_MAX_SUPPORTED).
@@ -118,6 +118,8 @@ extern struct opal_pointer_array_t ompi_datatype_f_to_c_table;
 
 OMPI_DECLSPEC int32_t ompi_datatype_init( void );
 OMPI_DECLSPEC int32_t ompi_datatype_finalize( void );
+int32_t ompi_datatype_cache_init( void );
+int32_t ompi_datatype_cache_finalize( void );
 
 OMPI_DECLSPEC int32_t ompi_datatype_default_convertors_init( void );
 OMPI_DECLSPEC int32_t ompi_datatype_default_convertors_fini( void );
@@ -155,11 +157,12 @@ ompi_datatype_is_contiguous_memory_layout( const ompi_datatype_t* type, int32_t
     return opal_datatype_is_contiguous_memory_layout(&type->super, count);
 }
 
-static inline int32_t
-ompi_datatype_commit( ompi_datatype_t ** type )
-{
-    return opal_datatype_commit ( (opal_datatype_t*)*type );
-}
+/**
+ * Commit a datatype. The optimized descriptions of the datatypes created
+ * by the MPI constructors are cached, so that committing another datatype
+ * with the same structure does not run the optimizer again.
+ */
+OMPI_DECLSPEC int32_t ompi_datatype_commit( ompi_datatype_t ** type );
 
 
 OMPI_DECLSPEC int32_t ompi_datatype_destroy( ompi_datatype_t** type);
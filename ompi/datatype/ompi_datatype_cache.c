@@ -0,0 +1,203 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/class/opal_list.h"
+#include "opal/class/opal_hash_table.h"
+#include "opal/mca/base/mca_base_var.h"
+#include "opal/threads/mutex.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+
+/*
+ * Applications creating, committing and freeing the same datatypes over
+ * and over (in a time step loop for example) pay for the optimization of
+ * the description each time. The committed descriptions are kept in a
+ * process-wide cache, keyed by the packed description of the datatype.
+ * The packed description is built from the arguments of the constructors
+ * and only holds the ids of the predefined datatypes, so it identifies
+ * the structure of the datatype and not the handles used to build it.
+ *
+ * Each entry holds a committed opal_datatype_t, a copy of the first
+ * datatype committed with this structure. Later commits get their
+ * optimized description from the model with opal_datatype_commit_from.
+ * The oldest entries are evicted once the cache is full.
+ */
+
+struct ompi_datatype_cache_entry_t {
+    opal_list_item_t  super;
+    opal_datatype_t*  model;     /**< committed datatype with the cached description */
+    void*             key;       /**< packed description of the datatype */
+    size_t            key_length;
+};
+typedef struct ompi_datatype_cache_entry_t ompi_datatype_cache_entry_t;
+
+static void ompi_datatype_cache_entry_construct( ompi_datatype_cache_entry_t* entry )
+{
+    entry->model      = NULL;
+    entry->key        = NULL;
+    entry->key_length = 0;
+}
+
+static void ompi_datatype_cache_entry_destruct( ompi_datatype_cache_entry_t* entry )
+{
+    if( NULL != entry->model ) {
+        OBJ_RELEASE( entry->model );
+    }
+    if( NULL != entry->key ) {
+        free( entry->key );
+    }
+}
+
+static OBJ_CLASS_INSTANCE( ompi_datatype_cache_entry_t, opal_list_item_t,
+                           ompi_datatype_cache_entry_construct,
+                           ompi_datatype_cache_entry_destruct );
+
+static int ompi_datatype_cache_size = 64;
+static opal_hash_table_t ompi_datatype_cache_table;
+static opal_list_t ompi_datatype_cache_lru;   /* oldest first */
+static opal_mutex_t ompi_datatype_cache_lock;
+static bool ompi_datatype_cache_initialized = false;
+
+int32_t ompi_datatype_cache_init( void )
+{
+    ompi_datatype_cache_size = 64;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "datatype_cache_size",
+                                 "Number of committed datatype descriptions kept to speed up "
+                                 "the commit of datatypes with the same structure (0 disables the cache)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_6,
+                                 MCA_BASE_VAR_SCOPE_LOCAL,
+                                 &ompi_datatype_cache_size);
+
+    OBJ_CONSTRUCT( &ompi_datatype_cache_table, opal_hash_table_t );
+    OBJ_CONSTRUCT( &ompi_datatype_cache_lru, opal_list_t );
+    OBJ_CONSTRUCT( &ompi_datatype_cache_lock, opal_mutex_t );
+    if( 0 < ompi_datatype_cache_size ) {
+        if( OPAL_SUCCESS != opal_hash_table_init( &ompi_datatype_cache_table, ompi_datatype_cache_size ) ) {
+            ompi_datatype_cache_size = 0;
+        }
+    }
+    ompi_datatype_cache_initialized = true;
+    return OMPI_SUCCESS;
+}
+
+int32_t ompi_datatype_cache_finalize( void )
+{
+    opal_list_item_t* item;
+
+    if( !ompi_datatype_cache_initialized ) return OMPI_SUCCESS;
+    ompi_datatype_cache_initialized = false;
+
+    while( NULL != (item = opal_list_remove_first(&ompi_datatype_cache_lru)) ) {
+        OBJ_RELEASE( item );
+    }
+    OBJ_DESTRUCT( &ompi_datatype_cache_lru );
+    OBJ_DESTRUCT( &ompi_datatype_cache_table );
+    OBJ_DESTRUCT( &ompi_datatype_cache_lock );
+    return OMPI_SUCCESS;
+}
+
+/* Keep a copy of the freshly committed datatype. Called without the lock. */
+static void ompi_datatype_cache_insert( const ompi_datatype_t* type,
+                                        const void* key, size_t key_length )
+{
+    ompi_datatype_cache_entry_t *entry, *oldest;
+    void* value;
+
+    entry = OBJ_NEW(ompi_datatype_cache_entry_t);
+    entry->model = opal_datatype_create( type->super.desc.used );
+    entry->key   = malloc( key_length );
+    if( (NULL == entry->model) || (NULL == entry->key) ) {
+        OBJ_RELEASE( entry );
+        return;
+    }
+    opal_datatype_clone( &type->super, entry->model );
+    memcpy( entry->key, key, key_length );
+    entry->key_length = key_length;
+
+    OPAL_THREAD_LOCK( &ompi_datatype_cache_lock );
+    if( OPAL_SUCCESS == opal_hash_table_get_value_ptr( &ompi_datatype_cache_table, key,
+                                                       key_length, &value ) ) {
+        /* another thread was faster */
+        OPAL_THREAD_UNLOCK( &ompi_datatype_cache_lock );
+        OBJ_RELEASE( entry );
+        return;
+    }
+    if( opal_list_get_size(&ompi_datatype_cache_lru) >= (size_t)ompi_datatype_cache_size ) {
+        oldest = (ompi_datatype_cache_entry_t*)opal_list_remove_first( &ompi_datatype_cache_lru );
+        opal_hash_table_remove_value_ptr( &ompi_datatype_cache_table, oldest->key, oldest->key_length );
+        OBJ_RELEASE( oldest );
+    }
+    if( OPAL_SUCCESS != opal_hash_table_set_value_ptr( &ompi_datatype_cache_table, key,
+                                                       key_length, entry ) ) {
+        OPAL_THREAD_UNLOCK( &ompi_datatype_cache_lock );
+        OBJ_RELEASE( entry );
+        return;
+    }
+    opal_list_append( &ompi_datatype_cache_lru, &entry->super );
+    OPAL_THREAD_UNLOCK( &ompi_datatype_cache_lock );
+}
+
+int32_t ompi_datatype_commit( ompi_datatype_t ** type )
+{
+    ompi_datatype_t* pData = *type;
+    ompi_datatype_cache_entry_t* entry;
+    opal_datatype_t* model = NULL;
+    const void* key;
+    size_t key_length;
+    void* value;
+    int32_t rc;
+
+    if( ompi_datatype_is_committed(pData) ) return OMPI_SUCCESS;
+
+    /* only the datatypes built by the MPI constructors have a signature */
+    if( !ompi_datatype_cache_initialized || (0 >= ompi_datatype_cache_size) ||
+        ompi_datatype_is_predefined(pData) || (NULL == pData->args) ||
+        (0 == pData->super.desc.used) ) {
+        return opal_datatype_commit( &pData->super );
+    }
+    if( OMPI_SUCCESS != ompi_datatype_get_pack_description( pData, &key ) ) {
+        return opal_datatype_commit( &pData->super );
+    }
+    key_length = ompi_datatype_pack_description_length( pData );
+
+    OPAL_THREAD_LOCK( &ompi_datatype_cache_lock );
+    if( OPAL_SUCCESS == opal_hash_table_get_value_ptr( &ompi_datatype_cache_table, key,
+                                                       key_length, &value ) ) {
+        entry = (ompi_datatype_cache_entry_t*)value;
+        /* most recently used go last */
+        opal_list_remove_item( &ompi_datatype_cache_lru, &entry->super );
+        opal_list_append( &ompi_datatype_cache_lru, &entry->super );
+        /* the entry might be evicted while we copy from it */
+        model = entry->model;
+        OBJ_RETAIN( model );
+    }
+    OPAL_THREAD_UNLOCK( &ompi_datatype_cache_lock );
+
+    if( NULL != model ) {
+        rc = opal_datatype_commit_from( &pData->super, model );
+        OBJ_RELEASE( model );
+        return rc;
+    }
+
+    rc = opal_datatype_commit( &pData->super );
+    if( OPAL_SUCCESS == rc ) {
+        ompi_datatype_cache_insert( pData, key, key_length );
+    }
+    return rc;
+}
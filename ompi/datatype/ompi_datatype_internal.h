@@ -95,8 +95,15 @@
  */
 #define OMPI_DATATYPE_MPI_COUNT                   0x2E
 
+/*
+ * Open MPI extensions: 16 bit floating point (MPIX_FLOAT16 and
+ * MPIX_BFLOAT16), moved as 16 bit unsigned integers
+ */
+#define OMPI_DATATYPE_MPI_FLOAT16                 0x2F
+#define OMPI_DATATYPE_MPI_BFLOAT16                0x30
+
 /* This should __ALWAYS__ stay last  */
-#define OMPI_DATATYPE_MPI_UNAVAILABLE             0x2F
+#define OMPI_DATATYPE_MPI_UNAVAILABLE             0x31
 
 
 #define OMPI_DATATYPE_MPI_MAX_PREDEFINED          (OMPI_DATATYPE_MPI_UNAVAILABLE+1)
@@ -285,6 +285,14 @@ ompi_predefined_datatype_t ompi_mpi_count = OMPI_DATATYPE_INIT_PREDEFINED_BASIC_
 ompi_predefined_datatype_t ompi_mpi_count = OMPI_DATATYPE_INIT_UNAVAILABLE_BASIC_TYPE(INT64_T, COUNT, OMPI_DATATYPE_FLAG_DATA_C | OMPI_DATATYPE_FLAG_DATA_INT);
 #endif
 
+/*
+ * Open MPI extensions: 16 bit floating point.  There is no C type for
+ * them, the data is moved (and converted between architectures) as
+ * uint16_t; only the reductions know the format.
+ */
+ompi_predefined_datatype_t ompi_mpi_float16 = OMPI_DATATYPE_INIT_PREDEFINED_BASIC_TYPE(UINT16_T, FLOAT16, OMPI_DATATYPE_FLAG_DATA_C | OMPI_DATATYPE_FLAG_DATA_FLOAT);
+ompi_predefined_datatype_t ompi_mpi_bfloat16 = OMPI_DATATYPE_INIT_PREDEFINED_BASIC_TYPE(UINT16_T, BFLOAT16, OMPI_DATATYPE_FLAG_DATA_C | OMPI_DATATYPE_FLAG_DATA_FLOAT);
+
 
 /*
  * NOTE: The order of this array *MUST* match what is listed in
@@ -351,7 +359,11 @@ const ompi_datatype_t* ompi_datatype_basicDatatypes[OMPI_DATATYPE_MPI_MAX_PREDEF
     /* MPI 3.0 types */
     &ompi_mpi_count.dt,                      /* 0x2E */
 
-    &ompi_mpi_unavailable.dt,                /* 0x2F */
+    /* Open MPI extensions */
+    &ompi_mpi_float16.dt,                    /* 0x2F */
+    &ompi_mpi_bfloat16.dt,                   /* 0x30 */
+
+    &ompi_mpi_unavailable.dt,                /* 0x31 */
 };
 
 opal_pointer_array_t ompi_datatype_f_to_c_table;
@@ -446,6 +458,7 @@ int32_t ompi_datatype_init( void )
                                                 0, OMPI_FORTRAN_HANDLE_MAX, 64)) {
         return OMPI_ERROR;
     }
+    ompi_datatype_cache_init();
     /* All temporary datatypes created on the following statement will get registered
      * on the f2c table. But as they get destroyed they will (hopefully) get unregistered
      * so later when we start registering the real datatypes they will get the index
@@ -535,6 +548,10 @@ int32_t ompi_datatype_init( void )
     ompi_mpi_cxx_ldblcplex.dt.super.flags |= OMPI_DATATYPE_FLAG_DATA_CPP | OMPI_DATATYPE_FLAG_DATA_COMPLEX;
 #endif  /* HAVE_LONG_DOUBLE */
 
+    /* The extensions are named MPIX_, not MPI_ */
+    strncpy( ompi_mpi_float16.dt.name, "MPIX_FLOAT16", MPI_MAX_OBJECT_NAME );
+    strncpy( ompi_mpi_bfloat16.dt.name, "MPIX_BFLOAT16", MPI_MAX_OBJECT_NAME );
+
 
     /* Start to populate the f2c index translation table */
 
@@ -641,6 +658,10 @@ int32_t ompi_datatype_init( void )
     /* MPI 3.0 types */
     MOOG(count, 68);
 
+    /* Open MPI extensions, C only: no name in mpif.h */
+    MOOG(float16, 69);
+    MOOG(bfloat16, 70);
+
     /**
      * Now make sure all non-contiguous types are marked as such.
      */
@@ -688,6 +709,9 @@ int32_t ompi_datatype_finalize( void )
     /* release the local convertors (external32 and local) */
     ompi_datatype_default_convertors_fini();
 
+    /* release the cached descriptions */
+    ompi_datatype_cache_finalize();
+
     opal_datatype_finalize();
 
     return OMPI_SUCCESS;
@@ -212,6 +212,13 @@ int ompi_group_incl(ompi_group_t* group, int n, int *ranks, ompi_group_t **new_g
         
         /* determin minimum length */
         method = ompi_group_minloc ( len, 4 );
+    } else if (ompi_use_strided_group_storage) {
+        int len [2];
+
+        /* only the format that keeps peer lookups constant-time */
+        len[0] = ompi_group_calc_plist    ( n ,ranks );
+        len[1] = ompi_group_calc_strided  ( n ,ranks );
+        method = ompi_group_minloc ( len, 2 );
     }
 #endif
     
@@ -335,6 +335,9 @@ static inline struct ompi_proc_t* ompi_group_peer_lookup(ompi_group_t *group, in
     }
 #endif
 #if OMPI_GROUP_SPARSE
+    if (OPAL_LIKELY(OMPI_GROUP_IS_DENSE(group))) {
+        return group->grp_proc_pointers[peer_id];
+    }
     return ompi_group_get_proc_ptr (group, peer_id);
 #else
     return group->grp_proc_pointers[peer_id];
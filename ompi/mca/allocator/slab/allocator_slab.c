@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/util/bit_ops.h"
+#include "ompi/constants.h"
+#include "ompi/mca/allocator/allocator.h"
+#include "ompi/mca/allocator/slab/allocator_slab.h"
+#include "ompi/mca/mpool/mpool.h"
+
+size_t mca_allocator_slab_segment_size;
+size_t mca_allocator_slab_max_object_size;
+int mca_allocator_slab_magazine_size;
+
+/* smallest object and its log2 */
+#define SLAB_MIN_SIZE   64
+#define SLAB_MIN_SHIFT  6
+/* the objects are at least that aligned */
+#define SLAB_ALIGN      16
+/* bound of max_object_size */
+#define SLAB_MAX_SHIFT  26
+/* class of the objects that got a segment of their own */
+#define SLAB_LARGE      ((uint32_t) -1)
+
+/**
+ * Header in front of every pointer handed out.
+ */
+typedef struct {
+    union {
+        mca_allocator_slab_slab_t *slab;   /**< owner of a small object */
+        size_t length;                     /**< segment length of a large one */
+    } u;
+    uint32_t cls;                          /**< size class or SLAB_LARGE */
+    uint32_t offset;                       /**< from the object to the pointer */
+} mca_allocator_slab_header_t;
+
+#define SLAB_HEADER_SIZE  ((sizeof(mca_allocator_slab_header_t) + SLAB_ALIGN - 1) & ~((size_t) SLAB_ALIGN - 1))
+
+/* a free object keeps the free list link in its first word and its slab
+ * in the second one, in the slab as in a magazine */
+#define SLAB_OF(obj)  (((mca_allocator_slab_slab_t **) (obj))[1])
+
+OBJ_CLASS_INSTANCE(mca_allocator_slab_slab_t, opal_list_item_t, NULL, NULL);
+
+/* four classes per power of two: 64, 80, 96, 112, 128, 160, ... */
+static inline int slab_class_of(size_t size)
+{
+    int shift;
+
+    if (size <= SLAB_MIN_SIZE) {
+        return 0;
+    }
+    shift = opal_hibit((int) (size - 1), SLAB_MAX_SHIFT);
+    return (shift - SLAB_MIN_SHIFT) * 4 + (int) (((size - 1) >> (shift - 2)) & 3) + 1;
+}
+
+static inline size_t slab_class_size(int cls)
+{
+    if (0 == cls) {
+        return SLAB_MIN_SIZE;
+    }
+    return (size_t) (5 + (cls - 1) % 4) << ((cls - 1) / 4 + SLAB_MIN_SHIFT - 2);
+}
+
+static inline mca_allocator_slab_header_t *slab_header(void *addr)
+{
+    return (mca_allocator_slab_header_t *) ((unsigned char *) addr - SLAB_HEADER_SIZE);
+}
+
+/* pointer to the user, with its header filled */
+static inline void *slab_hand_out(unsigned char *obj, size_t align, mca_allocator_slab_header_t hdr)
+{
+    uintptr_t addr = (uintptr_t) obj + SLAB_HEADER_SIZE;
+
+    addr = (addr + align - 1) & ~((uintptr_t) align - 1);
+    hdr.offset = (uint32_t) (addr - (uintptr_t) obj);
+    *slab_header((void *) addr) = hdr;
+    return (void *) addr;
+}
+
+/* take an object from the class, the lock is held */
+static void *slab_class_get(mca_allocator_slab_t *allocator, mca_allocator_slab_class_t *cls)
+{
+    mca_allocator_slab_slab_t *slab;
+    void *obj;
+
+    if (opal_list_is_empty(&cls->partial)) {
+        size_t size = allocator->segment_size;
+        mca_mpool_base_registration_t *reg = NULL;
+        unsigned char *base;
+
+        base = (unsigned char *) allocator->seg_alloc(allocator->super.alc_mpool, &size, &reg);
+        if (NULL == base) {
+            return NULL;
+        }
+        slab = OBJ_NEW(mca_allocator_slab_slab_t);
+        if (NULL == slab) {
+            allocator->seg_free(allocator->super.alc_mpool, base);
+            return NULL;
+        }
+        slab->base = slab->unused = base;
+        slab->free = NULL;
+        slab->registration = reg;
+        slab->n_used = 0;
+        slab->n_objects = (int) (size / cls->size);
+        opal_list_append(&cls->partial, &slab->super);
+    }
+
+    slab = (mca_allocator_slab_slab_t *) opal_list_get_first(&cls->partial);
+    if (NULL != slab->free) {
+        obj = slab->free;
+        slab->free = *(void **) obj;
+    } else {
+        obj = slab->unused;
+        slab->unused += cls->size;
+    }
+    if (++slab->n_used == slab->n_objects) {
+        opal_list_remove_item(&cls->partial, &slab->super);
+        opal_list_append(&cls->full, &slab->super);
+    }
+    SLAB_OF(obj) = slab;
+    return obj;
+}
+
+/* give an object back to its slab, the lock is held */
+static void slab_class_put(mca_allocator_slab_class_t *cls, void *obj)
+{
+    mca_allocator_slab_slab_t *slab = SLAB_OF(obj);
+
+    *(void **) obj = slab->free;
+    slab->free = obj;
+    /* a slab that just left the full state is hot, use it first */
+    if (slab->n_used-- == slab->n_objects) {
+        opal_list_remove_item(&cls->full, &slab->super);
+        opal_list_prepend(&cls->partial, &slab->super);
+    }
+}
+
+static void slab_magazine_drain(mca_allocator_slab_magazine_t *mag, int cls, int n)
+{
+    mca_allocator_slab_t *allocator = mag->allocator;
+    mca_allocator_slab_class_t *class = &allocator->classes[cls];
+    void **slots = mag->objects + (size_t) cls * allocator->magazine_size;
+    int i;
+
+    OPAL_THREAD_LOCK(&class->lock);
+    for (i = 0 ; i < n ; ++i) {
+        slab_class_put(class, slots[i]);
+    }
+    OPAL_THREAD_UNLOCK(&class->lock);
+    mag->count[cls] -= n;
+    memmove(slots, slots + n, mag->count[cls] * sizeof(void *));
+}
+
+static void slab_magazine_release(void *value)
+{
+    mca_allocator_slab_magazine_t *mag = (mca_allocator_slab_magazine_t *) value;
+    mca_allocator_slab_t *allocator = mag->allocator;
+    int cls;
+
+    for (cls = 0 ; cls < allocator->n_classes ; ++cls) {
+        slab_magazine_drain(mag, cls, mag->count[cls]);
+    }
+    OPAL_THREAD_LOCK(&allocator->magazine_lock);
+    opal_list_remove_item(&allocator->magazines, &mag->super);
+    OPAL_THREAD_UNLOCK(&allocator->magazine_lock);
+    OBJ_DESTRUCT(&mag->super);
+    free(mag);
+}
+
+static mca_allocator_slab_magazine_t *slab_magazine(mca_allocator_slab_t *allocator)
+{
+    mca_allocator_slab_magazine_t *mag = NULL;
+
+    if (!allocator->use_magazines) {
+        return NULL;
+    }
+    if (OPAL_SUCCESS == opal_tsd_getspecific(allocator->magazine_key, (void **) &mag) &&
+        NULL != mag) {
+        return mag;
+    }
+
+    mag = (mca_allocator_slab_magazine_t *)
+        calloc(1, sizeof(*mag) + allocator->n_classes *
+               (sizeof(int) + allocator->magazine_size * sizeof(void *)));
+    if (NULL == mag) {
+        return NULL;
+    }
+    OBJ_CONSTRUCT(&mag->super, opal_list_item_t);
+    mag->allocator = allocator;
+    mag->objects = (void **) (mag + 1);
+    mag->count = (int *) (mag->objects + (size_t) allocator->n_classes * allocator->magazine_size);
+    if (OPAL_SUCCESS != opal_tsd_setspecific(allocator->magazine_key, mag)) {
+        OBJ_DESTRUCT(&mag->super);
+        free(mag);
+        return NULL;
+    }
+    OPAL_THREAD_LOCK(&allocator->magazine_lock);
+    opal_list_append(&allocator->magazines, &mag->super);
+    OPAL_THREAD_UNLOCK(&allocator->magazine_lock);
+    return mag;
+}
+
+static void *slab_obj_get(mca_allocator_slab_t *allocator, int cls)
+{
+    mca_allocator_slab_class_t *class = &allocator->classes[cls];
+    mca_allocator_slab_magazine_t *mag = slab_magazine(allocator);
+    void *obj = NULL;
+
+    if (NULL != mag) {
+        void **slots = mag->objects + (size_t) cls * allocator->magazine_size;
+        int *count = &mag->count[cls];
+
+        if (0 == *count) {
+            int want = (allocator->magazine_size + 1) / 2;
+
+            OPAL_THREAD_LOCK(&class->lock);
+            while (*count < want && NULL != (obj = slab_class_get(allocator, class))) {
+                slots[(*count)++] = obj;
+            }
+            OPAL_THREAD_UNLOCK(&class->lock);
+        }
+        return (0 == *count) ? NULL : slots[--(*count)];
+    }
+
+    OPAL_THREAD_LOCK(&class->lock);
+    obj = slab_class_get(allocator, class);
+    OPAL_THREAD_UNLOCK(&class->lock);
+    return obj;
+}
+
+static void slab_obj_put(mca_allocator_slab_t *allocator, int cls, void *obj)
+{
+    mca_allocator_slab_class_t *class = &allocator->classes[cls];
+    mca_allocator_slab_magazine_t *mag = slab_magazine(allocator);
+
+    if (NULL != mag) {
+        void **slots = mag->objects + (size_t) cls * allocator->magazine_size;
+
+        if (mag->count[cls] == allocator->magazine_size) {
+            slab_magazine_drain(mag, cls, (allocator->magazine_size + 1) / 2);
+        }
+        slots[mag->count[cls]++] = obj;
+        return;
+    }
+
+    OPAL_THREAD_LOCK(&class->lock);
+    slab_class_put(class, obj);
+    OPAL_THREAD_UNLOCK(&class->lock);
+}
+
+static void *mca_allocator_slab_alloc(mca_allocator_base_module_t *base, size_t size,
+                                      size_t align, mca_mpool_base_registration_t **registration)
+{
+    mca_allocator_slab_t *allocator = (mca_allocator_slab_t *) base;
+    mca_allocator_slab_header_t hdr;
+    mca_mpool_base_registration_t *reg = NULL;
+    unsigned char *obj;
+    size_t need;
+    int cls;
+
+    if (align < SLAB_ALIGN) {
+        align = SLAB_ALIGN;
+    }
+    if (0 != (align & (align - 1))) {
+        return NULL;
+    }
+    need = size + SLAB_HEADER_SIZE + (align - SLAB_ALIGN);
+
+    if (need <= allocator->classes[allocator->n_classes - 1].size) {
+        cls = slab_class_of(need);
+        obj = (unsigned char *) slab_obj_get(allocator, cls);
+        if (NULL == obj) {
+            return NULL;
+        }
+        hdr.u.slab = SLAB_OF(obj);
+        hdr.cls = (uint32_t) cls;
+        reg = hdr.u.slab->registration;
+    } else {
+        obj = (unsigned char *) allocator->seg_alloc(allocator->super.alc_mpool, &need, &reg);
+        if (NULL == obj) {
+            return NULL;
+        }
+        hdr.u.length = need;
+        hdr.cls = SLAB_LARGE;
+    }
+
+    if (NULL != registration) {
+        *registration = reg;
+    }
+    return slab_hand_out(obj, align, hdr);
+}
+
+static void mca_allocator_slab_free(mca_allocator_base_module_t *base, void *addr)
+{
+    mca_allocator_slab_t *allocator = (mca_allocator_slab_t *) base;
+    mca_allocator_slab_header_t hdr = *slab_header(addr);
+    unsigned char *obj = (unsigned char *) addr - hdr.offset;
+
+    if (SLAB_LARGE == hdr.cls) {
+        allocator->seg_free(allocator->super.alc_mpool, obj);
+        return;
+    }
+    /* the header may overlap the first words of the object */
+    SLAB_OF(obj) = hdr.u.slab;
+    slab_obj_put(allocator, (int) hdr.cls, obj);
+}
+
+static void *mca_allocator_slab_realloc(mca_allocator_base_module_t *base, void *addr,
+                                        size_t size, mca_mpool_base_registration_t **registration)
+{
+    mca_allocator_slab_t *allocator = (mca_allocator_slab_t *) base;
+    mca_allocator_slab_header_t *hdr;
+    size_t capacity;
+    void *new_addr;
+
+    if (NULL == addr) {
+        return mca_allocator_slab_alloc(base, size, 0, registration);
+    }
+
+    hdr = slab_header(addr);
+    if (SLAB_LARGE == hdr->cls) {
+        capacity = hdr->u.length - hdr->offset;
+    } else {
+        capacity = allocator->classes[hdr->cls].size - hdr->offset;
+    }
+    if (size <= capacity) {
+        if (NULL != registration) {
+            *registration = (SLAB_LARGE == hdr->cls) ? NULL : hdr->u.slab->registration;
+        }
+        return addr;
+    }
+
+    new_addr = mca_allocator_slab_alloc(base, size, 0, registration);
+    if (NULL == new_addr) {
+        return NULL;
+    }
+    memcpy(new_addr, addr, capacity);
+    mca_allocator_slab_free(base, addr);
+    return new_addr;
+}
+
+/* drain the magazine of the caller and give the empty slabs back */
+static int mca_allocator_slab_compact(mca_allocator_base_module_t *base)
+{
+    mca_allocator_slab_t *allocator = (mca_allocator_slab_t *) base;
+    mca_allocator_slab_magazine_t *mag = slab_magazine(allocator);
+    opal_list_item_t *item, *next;
+    int cls;
+
+    for (cls = 0 ; cls < allocator->n_classes ; ++cls) {
+        mca_allocator_slab_class_t *class = &allocator->classes[cls];
+
+        if (NULL != mag) {
+            slab_magazine_drain(mag, cls, mag->count[cls]);
+        }
+
+        OPAL_THREAD_LOCK(&class->lock);
+        for (item = opal_list_get_first(&class->partial) ;
+             item != opal_list_get_end(&class->partial) ; item = next) {
+            mca_allocator_slab_slab_t *slab = (mca_allocator_slab_slab_t *) item;
+
+            next = opal_list_get_next(item);
+            if (0 == slab->n_used) {
+                opal_list_remove_item(&class->partial, item);
+                allocator->seg_free(allocator->super.alc_mpool, slab->base);
+                OBJ_RELEASE(slab);
+            }
+        }
+        OPAL_THREAD_UNLOCK(&class->lock);
+    }
+    return OMPI_SUCCESS;
+}
+
+static int mca_allocator_slab_finalize(mca_allocator_base_module_t *base)
+{
+    mca_allocator_slab_t *allocator = (mca_allocator_slab_t *) base;
+    opal_list_item_t *item;
+    int cls;
+
+    if (allocator->use_magazines) {
+        opal_tsd_key_delete(allocator->magazine_key);
+        while (NULL != (item = opal_list_remove_first(&allocator->magazines))) {
+            OBJ_DESTRUCT(item);
+            free(item);
+        }
+    }
+    OBJ_DESTRUCT(&allocator->magazines);
+    OBJ_DESTRUCT(&allocator->magazine_lock);
+
+    /* whatever is still handed out goes away with its slab */
+    for (cls = 0 ; cls < allocator->n_classes ; ++cls) {
+        mca_allocator_slab_class_t *class = &allocator->classes[cls];
+
+        while (NULL != (item = opal_list_remove_first(&class->partial)) ||
+               NULL != (item = opal_list_remove_first(&class->full))) {
+            allocator->seg_free(allocator->super.alc_mpool,
+                                ((mca_allocator_slab_slab_t *) item)->base);
+            OBJ_RELEASE(item);
+        }
+        OBJ_DESTRUCT(&class->partial);
+        OBJ_DESTRUCT(&class->full);
+        OBJ_DESTRUCT(&class->lock);
+    }
+    free(allocator->classes);
+    free(allocator);
+    return OMPI_SUCCESS;
+}
+
+static mca_allocator_base_module_t *mca_allocator_slab_module_init(
+    bool enable_mpi_threads,
+    mca_allocator_base_component_segment_alloc_fn_t segment_alloc,
+    mca_allocator_base_component_segment_free_fn_t segment_free,
+    struct mca_mpool_base_module_t *mpool)
+{
+    mca_allocator_slab_t *allocator;
+    int cls;
+
+    allocator = (mca_allocator_slab_t *) calloc(1, sizeof(*allocator));
+    if (NULL == allocator) {
+        return NULL;
+    }
+
+    if (mca_allocator_slab_max_object_size > ((size_t) 1 << SLAB_MAX_SHIFT)) {
+        mca_allocator_slab_max_object_size = (size_t) 1 << SLAB_MAX_SHIFT;
+    }
+    allocator->n_classes = slab_class_of(mca_allocator_slab_max_object_size) + 1;
+    allocator->classes = (mca_allocator_slab_class_t *)
+        calloc(allocator->n_classes, sizeof(mca_allocator_slab_class_t));
+    if (NULL == allocator->classes) {
+        free(allocator);
+        return NULL;
+    }
+    for (cls = 0 ; cls < allocator->n_classes ; ++cls) {
+        OBJ_CONSTRUCT(&allocator->classes[cls].lock, opal_mutex_t);
+        OBJ_CONSTRUCT(&allocator->classes[cls].partial, opal_list_t);
+        OBJ_CONSTRUCT(&allocator->classes[cls].full, opal_list_t);
+        allocator->classes[cls].size = slab_class_size(cls);
+    }
+
+    /* at least eight objects of the largest class in a slab */
+    allocator->segment_size = mca_allocator_slab_segment_size;
+    if (allocator->segment_size < 8 * slab_class_size(allocator->n_classes - 1)) {
+        allocator->segment_size = 8 * slab_class_size(allocator->n_classes - 1);
+    }
+
+    OBJ_CONSTRUCT(&allocator->magazine_lock, opal_mutex_t);
+    OBJ_CONSTRUCT(&allocator->magazines, opal_list_t);
+    allocator->magazine_size = mca_allocator_slab_magazine_size;
+    allocator->use_magazines = enable_mpi_threads && 0 < allocator->magazine_size &&
+        OPAL_SUCCESS == opal_tsd_key_create(&allocator->magazine_key, slab_magazine_release);
+
+    allocator->seg_alloc = segment_alloc;
+    allocator->seg_free = segment_free;
+    allocator->super.alc_alloc = mca_allocator_slab_alloc;
+    allocator->super.alc_realloc = mca_allocator_slab_realloc;
+    allocator->super.alc_free = mca_allocator_slab_free;
+    allocator->super.alc_compact = mca_allocator_slab_compact;
+    allocator->super.alc_finalize = mca_allocator_slab_finalize;
+    allocator->super.alc_mpool = mpool;
+    return (mca_allocator_base_module_t *) allocator;
+}
+
+static int mca_allocator_slab_register(void)
+{
+    mca_allocator_slab_segment_size = 2 * 1024 * 1024;
+    (void) mca_base_component_var_register(&mca_allocator_slab_component.allocator_version,
+                                           "segment_size", "Size of the segments cut in objects "
+                                           "of one size class (2MB, one huge page, by default)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_allocator_slab_segment_size);
+
+    mca_allocator_slab_max_object_size = 256 * 1024;
+    (void) mca_base_component_var_register(&mca_allocator_slab_component.allocator_version,
+                                           "max_object_size", "Largest allocation served from a "
+                                           "size class, the larger ones get a segment of their own",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_allocator_slab_max_object_size);
+
+    mca_allocator_slab_magazine_size = 32;
+    (void) mca_base_component_var_register(&mca_allocator_slab_component.allocator_version,
+                                           "magazine_size", "Free objects of each size class "
+                                           "cached by every thread when the MPI threads are "
+                                           "enabled (0 to always take the class lock)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_allocator_slab_magazine_size);
+    return OMPI_SUCCESS;
+}
+
+mca_allocator_base_component_t mca_allocator_slab_component = {
+
+  /* First, the mca_base_module_t struct containing meta information
+     about the module itself */
+
+  {
+    MCA_ALLOCATOR_BASE_VERSION_2_0_0,
+
+    "slab", /* MCA module name */
+    OMPI_MAJOR_VERSION,
+    OMPI_MINOR_VERSION,
+    OMPI_RELEASE_VERSION,
+    NULL, /* module open */
+    NULL, /* module close */
+    NULL,
+    mca_allocator_slab_register
+  },
+  {
+      /* The component is checkpoint ready */
+      MCA_BASE_METADATA_PARAM_CHECKPOINT
+  },
+  mca_allocator_slab_module_init
+};
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *  A size-class slab allocator.
+ *
+ *  The segments obtained from the owner are cut in objects of a single
+ *  size, four size classes per power of two from 64 bytes up to
+ *  max_object_size.  Every object starts with a small header naming its
+ *  slab, so a free needs neither a search nor the size.  Larger
+ *  requests get a segment of their own.  When the MPI threads are
+ *  enabled every thread keeps a magazine of free objects per class and
+ *  only takes the class lock to refill or drain it by half.  Empty
+ *  slabs are kept until alc_compact hands them back to the owner.
+ **/
+
+#ifndef ALLOCATOR_SLAB_H
+#define ALLOCATOR_SLAB_H
+
+#include "ompi_config.h"
+
+#include "opal/class/opal_list.h"
+#include "opal/threads/mutex.h"
+#include "opal/threads/tsd.h"
+#include "ompi/mca/allocator/allocator.h"
+
+BEGIN_C_DECLS
+
+/**
+ * One segment cut in objects of the same size class.
+ */
+struct mca_allocator_slab_slab_t {
+    opal_list_item_t super;
+    unsigned char *base;          /**< first object */
+    unsigned char *unused;        /**< objects from here on were never handed out */
+    void *free;                   /**< freed objects, linked through their first word */
+    mca_mpool_base_registration_t *registration;
+    int n_used;                   /**< objects handed out, magazines included */
+    int n_objects;
+};
+typedef struct mca_allocator_slab_slab_t mca_allocator_slab_slab_t;
+
+OBJ_CLASS_DECLARATION(mca_allocator_slab_slab_t);
+
+/**
+ * A size class.
+ */
+struct mca_allocator_slab_class_t {
+    opal_mutex_t lock;
+    opal_list_t partial;          /**< slabs with free objects, the empty ones too */
+    opal_list_t full;
+    size_t size;                  /**< object size */
+};
+typedef struct mca_allocator_slab_class_t mca_allocator_slab_class_t;
+
+/**
+ * The per-thread cache of free objects.
+ */
+struct mca_allocator_slab_magazine_t {
+    opal_list_item_t super;
+    struct mca_allocator_slab_t *allocator;
+    int *count;                   /**< objects cached, per class */
+    void **objects;               /**< magazine_size slots per class */
+};
+typedef struct mca_allocator_slab_magazine_t mca_allocator_slab_magazine_t;
+
+struct mca_allocator_slab_t {
+    mca_allocator_base_module_t super;
+    mca_allocator_base_component_segment_alloc_fn_t seg_alloc;
+    mca_allocator_base_component_segment_free_fn_t seg_free;
+    size_t segment_size;
+    int n_classes;
+    mca_allocator_slab_class_t *classes;
+    /* magazines, only with the MPI threads */
+    int magazine_size;
+    bool use_magazines;
+    opal_tsd_key_t magazine_key;
+    opal_mutex_t magazine_lock;
+    opal_list_t magazines;
+};
+typedef struct mca_allocator_slab_t mca_allocator_slab_t;
+
+/*
+ * Parameters of the component
+ */
+extern size_t mca_allocator_slab_segment_size;
+extern size_t mca_allocator_slab_max_object_size;
+extern int mca_allocator_slab_magazine_size;
+
+OMPI_DECLSPEC extern mca_allocator_base_component_t mca_allocator_slab_component;
+
+END_C_DECLS
+
+#endif /* ALLOCATOR_SLAB_H */
@@ -235,9 +235,10 @@ static int basesmuma_open(void)
     cs->scratch_offset_from_base_ctl_file=0;
 
     /*
-     * register the progess function
+     * register the progess function, which only recycles the memory
+     * banks: low priority
      */
-    ret=opal_progress_register(bcol_basesmuma_progress);
+    ret=opal_progress_register_lp(bcol_basesmuma_progress);
     if (MPI_SUCCESS != ret) {
         opal_output(0, "failed to register the progress function\n");
     }
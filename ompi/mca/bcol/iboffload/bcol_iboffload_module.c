@@ -249,6 +249,7 @@ static int prepare_mpool(mca_bcol_iboffload_device_t *device)
 
     resources.register_mem = mca_bcol_iboffload_register_mr;
     resources.deregister_mem = mca_bcol_iboffload_deregister_mr;
+    resources.implicit_reg = false;
 
     device->mpool =
         mca_mpool_base_module_create(mca_bcol_iboffload_component.mpool_name,
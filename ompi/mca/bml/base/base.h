@@ -25,6 +25,7 @@
 #include "opal/mca/mca.h"
 #include "opal/mca/base/mca_base_framework.h"
 #include "ompi/mca/bml/bml.h"
+#include "ompi/proc/proc.h"
 
 
 /*
@@ -61,5 +62,18 @@ OMPI_DECLSPEC extern mca_bml_base_component_t mca_bml_component;
 OMPI_DECLSPEC extern mca_bml_base_module_t mca_bml; 
 OMPI_DECLSPEC extern mca_base_framework_t ompi_bml_base_framework;
 
+/**
+ * Returns the BML endpoint of a proc, setting up the BTLs for it
+ * first if the BML deferred that until the first use of the proc.
+ * Returns NULL if the proc cannot be reached.
+ */
+static inline mca_bml_base_endpoint_t* mca_bml_base_get_endpoint(struct ompi_proc_t* proc)
+{
+    if( OPAL_UNLIKELY(NULL == proc->proc_bml) ) {
+        (void) mca_bml.bml_add_proc(proc);
+    }
+    return (mca_bml_base_endpoint_t*) proc->proc_bml;
+}
+
 END_C_DECLS
 #endif /* MCA_BML_BASE_H */
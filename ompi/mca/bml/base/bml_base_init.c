@@ -26,6 +26,7 @@
 mca_bml_base_module_t mca_bml = {
     NULL,                    /* bml_component */
     NULL,                    /* bml_add_procs */ 
+    NULL,                    /* bml_add_proc */
     NULL,                    /* bml_del_procs */
     NULL,                    /* bml_add_btl */
     NULL,                    /* bml_del_btl */
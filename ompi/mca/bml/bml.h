@@ -37,6 +37,7 @@
 #include "ompi/mca/btl/btl.h"
 
 #include "ompi/mca/bml/base/bml_base_btl.h"
+#include "ompi/mca/bml/bml_fastpath.h"
 #include "ompi/types.h"
 
 #include "ompi/constants.h"
@@ -271,11 +272,20 @@ static inline int mca_bml_base_send( mca_bml_base_btl_t* bml_btl,
 {
     int rc;
     mca_btl_base_module_t* btl = bml_btl->btl;
+#if OMPI_ENABLE_PVAR_COUNTERS
+    /* the descriptor may be gone once the send returns */
+    size_t size = mca_btl_base_segments_size(des->des_src, des->des_src_cnt);
+#endif
 
     des->des_context = (void*) bml_btl;
-    rc = btl->btl_send(btl, bml_btl->btl_endpoint, des, tag);
+    rc = MCA_BML_BTL_SEND(btl, (btl, bml_btl->btl_endpoint, des, tag));
     if (rc == OMPI_ERR_RESOURCE_BUSY)
         rc = OMPI_SUCCESS;
+#if OMPI_ENABLE_PVAR_COUNTERS
+    if (OPAL_LIKELY(rc >= 0)) {
+        mca_btl_base_pvar_count(btl, MCA_BTL_BASE_PVAR_FRAGS_SENT, size);
+    }
+#endif
 
     return rc;
 }
@@ -287,9 +297,19 @@ static inline int mca_bml_base_send_status( mca_bml_base_btl_t* bml_btl,
                                             mca_btl_base_tag_t tag )
 {
     mca_btl_base_module_t* btl = bml_btl->btl;
+    int rc;
+#if OMPI_ENABLE_PVAR_COUNTERS
+    size_t size = mca_btl_base_segments_size(des->des_src, des->des_src_cnt);
+#endif
 
     des->des_context = (void*) bml_btl;
-    return btl->btl_send(btl, bml_btl->btl_endpoint, des, tag);
+    rc = MCA_BML_BTL_SEND(btl, (btl, bml_btl->btl_endpoint, des, tag));
+#if OMPI_ENABLE_PVAR_COUNTERS
+    if (OPAL_LIKELY(rc >= 0)) {
+        mca_btl_base_pvar_count(btl, MCA_BTL_BASE_PVAR_FRAGS_SENT, size);
+    }
+#endif
+    return rc;
 }
 
 static inline int  mca_bml_base_sendi( mca_bml_base_btl_t* bml_btl,
@@ -303,27 +323,54 @@ static inline int  mca_bml_base_sendi( mca_bml_base_btl_t* bml_btl,
                                        mca_btl_base_descriptor_t** descriptor )
 {
     mca_btl_base_module_t* btl = bml_btl->btl;
-    return btl->btl_sendi(btl, bml_btl->btl_endpoint, 
-                          convertor, header, header_size,
-                          payload_size, order, flags, tag, descriptor);
+    int rc;
+
+    rc = MCA_BML_BTL_SENDI(btl, (btl, bml_btl->btl_endpoint,
+                                 convertor, header, header_size,
+                                 payload_size, order, flags, tag, descriptor));
+    if (OMPI_SUCCESS == rc) {
+        mca_btl_base_pvar_count(btl, MCA_BTL_BASE_PVAR_FRAGS_SENT,
+                                header_size + payload_size);
+    }
+    return rc;
 }
 
 static inline int mca_bml_base_put( mca_bml_base_btl_t* bml_btl,
                                     mca_btl_base_descriptor_t* des)
 {
     mca_btl_base_module_t* btl = bml_btl->btl;
+    int rc;
+#if OMPI_ENABLE_PVAR_COUNTERS
+    size_t size = mca_btl_base_segments_size(des->des_src, des->des_src_cnt);
+#endif
 
     des->des_context = (void*) bml_btl; 
-    return btl->btl_put( btl, bml_btl->btl_endpoint, des );
+    rc = btl->btl_put( btl, bml_btl->btl_endpoint, des );
+#if OMPI_ENABLE_PVAR_COUNTERS
+    if (OPAL_LIKELY(OMPI_SUCCESS == rc)) {
+        mca_btl_base_pvar_count(btl, MCA_BTL_BASE_PVAR_FRAGS_RDMA, size);
+    }
+#endif
+    return rc;
 }
 
 static inline int mca_bml_base_get( mca_bml_base_btl_t* bml_btl,
                                     mca_btl_base_descriptor_t* des)
 {
     mca_btl_base_module_t* btl = bml_btl->btl;
+    int rc;
+#if OMPI_ENABLE_PVAR_COUNTERS
+    size_t size = mca_btl_base_segments_size(des->des_dst, des->des_dst_cnt);
+#endif
 
     des->des_context = (void*) bml_btl; 
-    return btl->btl_get( btl, bml_btl->btl_endpoint, des );
+    rc = btl->btl_get( btl, bml_btl->btl_endpoint, des );
+#if OMPI_ENABLE_PVAR_COUNTERS
+    if (OPAL_LIKELY(OMPI_SUCCESS == rc)) {
+        mca_btl_base_pvar_count(btl, MCA_BTL_BASE_PVAR_FRAGS_RDMA, size);
+    }
+#endif
+    return rc;
 }
 
 
@@ -464,6 +511,21 @@ typedef int (*mca_bml_base_module_add_procs_fn_t)(
                                                   struct opal_bitmap_t* reachable
                                                   );
 
+/**
+ * PML->BML request to set up the BTLs for a single process.
+ *
+ * @param proc (IN)           Process
+ * @return                    OMPI_SUCCESS or error status on failure.
+ *
+ * When the BML was asked to set up its peers on demand, the procs
+ * given to mca_bml_base_module_add_procs_fn_t() may be left without
+ * a BML endpoint (proc->proc_bml == NULL) until the first message to
+ * or from them. This function creates the endpoint for such a proc;
+ * it does nothing if the proc already has one. Use
+ * mca_bml_base_get_endpoint() rather than calling it directly.
+ */
+typedef int (*mca_bml_base_module_add_proc_fn_t)( struct ompi_proc_t* proc );
+
 /**
  * Notification of change to the process list.
  *
@@ -559,6 +621,7 @@ struct mca_bml_base_module_t {
 
     /* BML function table */
     mca_bml_base_module_add_procs_fn_t     bml_add_procs;
+    mca_bml_base_module_add_proc_fn_t      bml_add_proc;
     mca_bml_base_module_del_procs_fn_t     bml_del_procs;
     mca_bml_base_module_add_btl_fn_t       bml_add_btl;
     mca_bml_base_module_del_btl_fn_t       bml_del_btl;
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Compile-time dispatch of the BTL send paths.
+ *
+ * BTLs selected with --enable-btl-fastpath are linked into the
+ * library, so the BML can test the module's function pointer against
+ * the known entry point and call it directly.  The compiler sees a
+ * direct call it can predict and, with link-time optimization,
+ * inline; any other BTL still goes through the function table.
+ */
+
+#ifndef MCA_BML_FASTPATH_H
+#define MCA_BML_FASTPATH_H
+
+#include "ompi_config.h"
+
+#include "ompi/mca/btl/btl.h"
+
+BEGIN_C_DECLS
+
+/* the entry points are declared here rather than by including the
+ * component headers, which drag in the network libraries' headers */
+#define MCA_BML_FASTPATH_DECLARE_SEND(name)                             \
+    int mca_btl_ ## name ## _send(struct mca_btl_base_module_t* btl,    \
+                                  struct mca_btl_base_endpoint_t* endpoint, \
+                                  struct mca_btl_base_descriptor_t* descriptor, \
+                                  mca_btl_base_tag_t tag)
+#define MCA_BML_FASTPATH_DECLARE_SENDI(name)                            \
+    int mca_btl_ ## name ## _sendi(struct mca_btl_base_module_t* btl,   \
+                                   struct mca_btl_base_endpoint_t* endpoint, \
+                                   struct opal_convertor_t* convertor,  \
+                                   void* header, size_t header_size,    \
+                                   size_t payload_size, uint8_t order,  \
+                                   uint32_t flags, mca_btl_base_tag_t tag, \
+                                   mca_btl_base_descriptor_t** descriptor)
+
+#define MCA_BML_FASTPATH_TRY(fn, direct, args, next)                    \
+    ((fn) == (direct) ? (direct) args : (next))
+
+#if OMPI_BTL_FASTPATH_SELF
+MCA_BML_FASTPATH_DECLARE_SEND(self);
+#define MCA_BML_FASTPATH_SELF_SEND(btl, args, next)                     \
+    MCA_BML_FASTPATH_TRY((btl)->btl_send, mca_btl_self_send, args, next)
+#else
+#define MCA_BML_FASTPATH_SELF_SEND(btl, args, next) (next)
+#endif
+/* self has no send immediate */
+#define MCA_BML_FASTPATH_SELF_SENDI(btl, args, next) (next)
+
+#if OMPI_BTL_FASTPATH_SM
+MCA_BML_FASTPATH_DECLARE_SEND(sm);
+MCA_BML_FASTPATH_DECLARE_SENDI(sm);
+#define MCA_BML_FASTPATH_SM_SEND(btl, args, next)                       \
+    MCA_BML_FASTPATH_TRY((btl)->btl_send, mca_btl_sm_send, args, next)
+#define MCA_BML_FASTPATH_SM_SENDI(btl, args, next)                      \
+    MCA_BML_FASTPATH_TRY((btl)->btl_sendi, mca_btl_sm_sendi, args, next)
+#else
+#define MCA_BML_FASTPATH_SM_SEND(btl, args, next) (next)
+#define MCA_BML_FASTPATH_SM_SENDI(btl, args, next) (next)
+#endif
+
+#if OMPI_BTL_FASTPATH_VADER
+MCA_BML_FASTPATH_DECLARE_SEND(vader);
+MCA_BML_FASTPATH_DECLARE_SENDI(vader);
+#define MCA_BML_FASTPATH_VADER_SEND(btl, args, next)                    \
+    MCA_BML_FASTPATH_TRY((btl)->btl_send, mca_btl_vader_send, args, next)
+#define MCA_BML_FASTPATH_VADER_SENDI(btl, args, next)                   \
+    MCA_BML_FASTPATH_TRY((btl)->btl_sendi, mca_btl_vader_sendi, args, next)
+#else
+#define MCA_BML_FASTPATH_VADER_SEND(btl, args, next) (next)
+#define MCA_BML_FASTPATH_VADER_SENDI(btl, args, next) (next)
+#endif
+
+#if OMPI_BTL_FASTPATH_OPENIB
+MCA_BML_FASTPATH_DECLARE_SEND(openib);
+MCA_BML_FASTPATH_DECLARE_SENDI(openib);
+#define MCA_BML_FASTPATH_OPENIB_SEND(btl, args, next)                   \
+    MCA_BML_FASTPATH_TRY((btl)->btl_send, mca_btl_openib_send, args, next)
+#define MCA_BML_FASTPATH_OPENIB_SENDI(btl, args, next)                  \
+    MCA_BML_FASTPATH_TRY((btl)->btl_sendi, mca_btl_openib_sendi, args, next)
+#else
+#define MCA_BML_FASTPATH_OPENIB_SEND(btl, args, next) (next)
+#define MCA_BML_FASTPATH_OPENIB_SENDI(btl, args, next) (next)
+#endif
+
+#if OMPI_BTL_FASTPATH_TCP
+MCA_BML_FASTPATH_DECLARE_SEND(tcp);
+MCA_BML_FASTPATH_DECLARE_SENDI(tcp);
+#define MCA_BML_FASTPATH_TCP_SEND(btl, args, next)                      \
+    MCA_BML_FASTPATH_TRY((btl)->btl_send, mca_btl_tcp_send, args, next)
+#define MCA_BML_FASTPATH_TCP_SENDI(btl, args, next)                     \
+    MCA_BML_FASTPATH_TRY((btl)->btl_sendi, mca_btl_tcp_sendi, args, next)
+#else
+#define MCA_BML_FASTPATH_TCP_SEND(btl, args, next) (next)
+#define MCA_BML_FASTPATH_TCP_SENDI(btl, args, next) (next)
+#endif
+
+/**
+ * Call the send (resp. send immediate) function of btl with the
+ * parenthesized argument list args, directly when it is one of the
+ * fast path BTLs.  Shared memory is tested first as it carries the
+ * latency-critical traffic.
+ */
+#define MCA_BML_BTL_SEND(btl, args)                                     \
+    MCA_BML_FASTPATH_VADER_SEND(btl, args,                              \
+    MCA_BML_FASTPATH_SM_SEND(btl, args,                                 \
+    MCA_BML_FASTPATH_OPENIB_SEND(btl, args,                             \
+    MCA_BML_FASTPATH_TCP_SEND(btl, args,                                \
+    MCA_BML_FASTPATH_SELF_SEND(btl, args,                               \
+    (btl)->btl_send args)))))
+
+#define MCA_BML_BTL_SENDI(btl, args)                                    \
+    MCA_BML_FASTPATH_VADER_SENDI(btl, args,                             \
+    MCA_BML_FASTPATH_SM_SENDI(btl, args,                                \
+    MCA_BML_FASTPATH_OPENIB_SENDI(btl, args,                            \
+    MCA_BML_FASTPATH_TCP_SENDI(btl, args,                               \
+    MCA_BML_FASTPATH_SELF_SENDI(btl, args,                              \
+    (btl)->btl_sendi args)))))
+
+END_C_DECLS
+
+#endif /* MCA_BML_FASTPATH_H */
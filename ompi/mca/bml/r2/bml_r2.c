@@ -96,6 +96,16 @@ static int mca_bml_r2_add_btls( void )
         selected_btl =  (mca_btl_base_selected_module_t*)opal_list_get_next(selected_btl)) {
         mca_btl_base_module_t *btl = selected_btl->btl_module;
         mca_bml_r2.btl_modules[mca_bml_r2.num_btl_modules++] = btl;
+        /* peers can only be added on demand if every btl copes with
+           traffic from a peer it has not been told about yet */
+        if (mca_bml_r2.add_procs_on_demand &&
+            0 == (btl->btl_flags & MCA_BTL_FLAGS_ADD_PROCS_ON_DEMAND)) {
+            opal_output_verbose(1, ompi_bml_base_framework.framework_output,
+                                "bml:r2: the %s btl does not support adding peers on demand, "
+                                "setting up all the peers at once",
+                                btl->btl_component->btl_version.mca_component_name);
+            mca_bml_r2.add_procs_on_demand = false;
+        }
         for (i = 0; NULL != btl_names_argv && NULL != btl_names_argv[i]; ++i) {
             if (0 == 
                 strcmp(btl_names_argv[i],
@@ -133,62 +143,24 @@ static int btl_bandwidth_compare(const void *v1, const void *v2)
 }
 
 /*
- *   For each proc setup a datastructure that indicates the BTLs
- *   that can be used to reach the destination.
- *
+ *   For each of the new procs (procs that do not have a BML endpoint
+ *   yet) setup a datastructure that indicates the BTLs that can be
+ *   used to reach the destination.
  */
 
-static int mca_bml_r2_add_procs( size_t nprocs, 
-                                 struct ompi_proc_t** procs, 
-                                 struct opal_bitmap_t* reachable )
+static int mca_bml_r2_add_new_procs( size_t n_new_procs,
+                                     struct ompi_proc_t** new_procs,
+                                     struct opal_bitmap_t* reachable )
 {
-    size_t p, p_index, n_new_procs = 0;
+    size_t p, p_index;
     struct mca_btl_base_endpoint_t ** btl_endpoints = NULL;  
-    struct ompi_proc_t** new_procs = NULL; 
     struct ompi_proc_t *unreach_proc = NULL;
     int rc, ret = OMPI_SUCCESS;
 
-    if(0 == nprocs) {
-        return OMPI_SUCCESS;
-    }
-    
-    if(OMPI_SUCCESS != (rc = mca_bml_r2_add_btls()) ) {
-        return rc;
-    }
-    
-    /* Select only the procs that don't yet have the BML proc struct. This prevent
-     * us from calling btl->add_procs several this on the same destination proc.
-     */
-    for(p_index = 0; p_index < nprocs; p_index++) { 
-        struct ompi_proc_t* proc = procs[p_index]; 
-
-        OBJ_RETAIN(proc); 
-        if(NULL !=  proc->proc_bml) { 
-            continue;  /* go to the next proc */
-        }
-        /* Allocate the new_procs on demand */
-        if( NULL == new_procs ) {
-            new_procs = (struct ompi_proc_t **)malloc(nprocs * sizeof(struct ompi_proc_t *));
-            if( NULL == new_procs ) {
-                return OMPI_ERR_OUT_OF_RESOURCE;
-            }
-        }
-        new_procs[n_new_procs++] = proc; 
-    }
-
-    if ( 0 == n_new_procs ) {
-        return OMPI_SUCCESS;
-    }
-
-    /* Starting from here we only work on the unregistered procs */
-    procs = new_procs; 
-    nprocs = n_new_procs; 
-    
     /* attempt to add all procs to each r2 */
     btl_endpoints = (struct mca_btl_base_endpoint_t **) 
-        malloc(nprocs * sizeof(struct mca_btl_base_endpoint_t*)); 
+        malloc(n_new_procs * sizeof(struct mca_btl_base_endpoint_t*)); 
     if (NULL == btl_endpoints) {
-        free(new_procs);
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
 
@@ -202,7 +174,7 @@ static int mca_bml_r2_add_procs( size_t nprocs,
          * that is passed back to the r2 on data transfer calls
          */
         opal_bitmap_clear_all_bits(reachable);
-        memset(btl_endpoints, 0, nprocs *sizeof(struct mca_btl_base_endpoint_t*)); 
+        memset(btl_endpoints, 0, n_new_procs *sizeof(struct mca_btl_base_endpoint_t*)); 
 
         rc = btl->btl_add_procs(btl, n_new_procs, new_procs, btl_endpoints, reachable);
         if(OMPI_SUCCESS != rc) {
@@ -226,7 +198,6 @@ static int mca_bml_r2_add_procs( size_t nprocs,
                     if (NULL == bml_endpoint) {
                         opal_output(0, "mca_bml_r2_add_procs: unable to allocate resources");
                         free(btl_endpoints);
-                        free(new_procs);
                         return OMPI_ERR_OUT_OF_RESOURCE;
                     }
                     
@@ -416,11 +387,100 @@ static int mca_bml_r2_add_procs( size_t nprocs,
                        btl_names);
     }
 
-    free(new_procs); 
-
     return ret;
 }
 
+/*
+ *   Called by the PML with the procs it wants to talk to. Unless the
+ *   peers are to be set up on demand, the BTLs are set up right away
+ *   for every proc that does not have a BML endpoint yet. On demand,
+ *   only the procs on the local node are set up here (the shared
+ *   memory BTLs need to see all their peers at once), the others
+ *   are set up by mca_bml_r2_add_proc the first time they are used.
+ */
+
+static int mca_bml_r2_add_procs( size_t nprocs, 
+                                 struct ompi_proc_t** procs, 
+                                 struct opal_bitmap_t* reachable )
+{
+    size_t p_index, n_new_procs = 0;
+    struct ompi_proc_t** new_procs = NULL; 
+    int rc;
+
+    if(0 == nprocs) {
+        return OMPI_SUCCESS;
+    }
+    
+    if(OMPI_SUCCESS != (rc = mca_bml_r2_add_btls()) ) {
+        return rc;
+    }
+    
+    /* Select only the procs that don't yet have the BML proc struct. This prevent
+     * us from calling btl->add_procs several this on the same destination proc.
+     */
+    OPAL_THREAD_LOCK(&mca_bml_r2.lock);
+    for(p_index = 0; p_index < nprocs; p_index++) { 
+        struct ompi_proc_t* proc = procs[p_index]; 
+
+        OBJ_RETAIN(proc); 
+        if(NULL !=  proc->proc_bml) { 
+            continue;  /* go to the next proc */
+        }
+        if(mca_bml_r2.add_procs_on_demand && proc != ompi_proc_local_proc &&
+           !OPAL_PROC_ON_LOCAL_NODE(proc->proc_flags)) {
+            continue;  /* will be added on first use */
+        }
+        /* Allocate the new_procs on demand */
+        if( NULL == new_procs ) {
+            new_procs = (struct ompi_proc_t **)malloc(nprocs * sizeof(struct ompi_proc_t *));
+            if( NULL == new_procs ) {
+                OPAL_THREAD_UNLOCK(&mca_bml_r2.lock);
+                return OMPI_ERR_OUT_OF_RESOURCE;
+            }
+        }
+        new_procs[n_new_procs++] = proc; 
+    }
+
+    if ( 0 == n_new_procs ) {
+        OPAL_THREAD_UNLOCK(&mca_bml_r2.lock);
+        return OMPI_SUCCESS;
+    }
+
+    rc = mca_bml_r2_add_new_procs(n_new_procs, new_procs, reachable);
+    OPAL_THREAD_UNLOCK(&mca_bml_r2.lock);
+
+    free(new_procs);
+    return rc;
+}
+
+/*
+ *   Set up the BTLs for a proc that was deferred by
+ *   mca_bml_r2_add_procs.
+ */
+
+static int mca_bml_r2_add_proc( struct ompi_proc_t* proc )
+{
+    opal_bitmap_t reachable;
+    int rc;
+
+    OPAL_THREAD_LOCK(&mca_bml_r2.lock);
+    if(NULL != proc->proc_bml) {
+        /* somebody else beat us to it */
+        OPAL_THREAD_UNLOCK(&mca_bml_r2.lock);
+        return OMPI_SUCCESS;
+    }
+
+    OBJ_CONSTRUCT(&reachable, opal_bitmap_t);
+    rc = opal_bitmap_init(&reachable, 1);
+    if(OMPI_SUCCESS == rc) {
+        rc = mca_bml_r2_add_new_procs(1, &proc, &reachable);
+    }
+    OBJ_DESTRUCT(&reachable);
+    OPAL_THREAD_UNLOCK(&mca_bml_r2.lock);
+
+    return rc;
+}
+
 /*
  * iterate through each proc and notify any BTLs associated
  * with the proc that it is/has gone away
@@ -452,6 +512,12 @@ static int mca_bml_r2_del_procs(size_t nprocs,
         size_t f_index, f_size;
         size_t n_index, n_size;
  
+        if(NULL == bml_endpoint) {
+            /* never used (or unreachable): no btl knows about it */
+            OBJ_RELEASE(proc);
+            continue;
+        }
+
         /* notify each btl that the proc is going away */
         f_size = mca_bml_base_btl_array_get_size(&bml_endpoint->btl_eager);
         for(f_index = 0; f_index < f_size; f_index++) {
@@ -803,6 +869,7 @@ mca_bml_r2_module_t mca_bml_r2 = {
     {
         &mca_bml_r2_component, 
         mca_bml_r2_add_procs,
+        mca_bml_r2_add_proc,
         mca_bml_r2_del_procs,
         mca_bml_r2_add_btl,
         mca_bml_r2_del_btl,
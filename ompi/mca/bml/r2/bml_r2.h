@@ -29,6 +29,7 @@
 #ifndef MCA_BML_R2_H
 #define MCA_BML_R2_H
 
+#include "opal/threads/mutex.h"
 #include "ompi/types.h"
 #include "ompi/mca/bml/bml.h"
 
@@ -45,6 +46,8 @@ struct mca_bml_r2_module_t {
     mca_btl_base_component_progress_fn_t * btl_progress; 
     bool btls_added;
     bool show_unreach_errors;
+    bool add_procs_on_demand;   /**< set up the off-node peers on first use */
+    opal_mutex_t lock;          /**< protects the set up of the peers */
 };
 
 typedef struct mca_bml_r2_module_t mca_bml_r2_module_t;
@@ -61,11 +61,26 @@ static int mca_bml_r2_component_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_bml_r2.show_unreach_errors);
 
+    mca_bml_r2.add_procs_on_demand = false;
+    (void) mca_base_component_var_register(&mca_bml_r2_component.bml_version,
+                                           "add_procs_on_demand",
+                                           "Only set up the BTLs for a peer that is not on the local node "
+                                           "when the first message is sent to or received from it, so that "
+                                           "the memory used by the BTLs grows with the number of peers actually "
+                                           "used rather than with the size of the job. Ignored if any of the "
+                                           "selected BTLs cannot accept connections from peers it was not told "
+                                           "about (default: false)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_bml_r2.add_procs_on_demand);
+
     return OMPI_SUCCESS;
 }
 
 int mca_bml_r2_component_open(void)
 {
+    OBJ_CONSTRUCT(&mca_bml_r2.lock, opal_mutex_t);
     return OMPI_SUCCESS; 
 }
 
@@ -73,7 +88,7 @@ int mca_bml_r2_component_open(void)
 int mca_bml_r2_component_close(void)
 {
         
-    /* OBJ_DESTRUCT(&mca_bml_r2.lock); */
+    OBJ_DESTRUCT(&mca_bml_r2.lock);
 
     return OMPI_SUCCESS;
 }
@@ -63,6 +63,15 @@ OMPI_DECLSPEC  int mca_btl_base_param_register(mca_base_component_t *version,
         mca_btl_base_module_t *module);
 OMPI_DECLSPEC  int mca_btl_base_param_verify(mca_btl_base_module_t *module);
 
+/**
+ * Test every selected module for local quiescence.  Modules without a
+ * btl_quiesce function are not waited for.
+ *
+ * @return OMPI_SUCCESS once all of them are quiescent,
+ *         OMPI_ERR_RESOURCE_BUSY otherwise
+ */
+OMPI_DECLSPEC  int mca_btl_base_quiesce(void);
+
 /*
  * Globals
  */
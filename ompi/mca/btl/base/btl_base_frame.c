@@ -21,10 +21,13 @@
 
 #include "ompi_config.h"
 #include <stdio.h>
+#include <string.h>
 
 #include "opal/mca/mca.h"
 #include "opal/util/output.h"
 #include "opal/mca/base/base.h"
+#include "opal/mca/base/mca_base_pvar.h"
+#include "mpi.h"
 
 
 #include "ompi/mca/btl/btl.h"
@@ -76,6 +79,54 @@ int mca_btl_base_warn_component_unused = 1;
 opal_list_t mca_btl_base_modules_initialized;
 bool mca_btl_base_thread_multiple_override = false;
 
+#if OMPI_ENABLE_PVAR_COUNTERS
+/* the module list only exists between open and close */
+static bool mca_btl_base_pvars_valid = false;
+
+/* modules may still be added once a handle is bound: fixed array size */
+#define MCA_BTL_BASE_PVAR_MODULES 32
+
+static const struct {
+    const char *name;
+    const char *description;
+} mca_btl_base_pvars[MCA_BTL_BASE_PVAR_MAX] = {
+    {"frags_sent", "Number of fragments sent by each BTL module"},
+    {"bytes_sent", "Number of bytes sent by each BTL module"},
+    {"frags_received", "Number of fragments received by the PML from each BTL module"},
+    {"bytes_received", "Number of bytes received by the PML from each BTL module"},
+    {"rdma_operations", "Number of put and get operations started on each BTL module"},
+    {"rdma_bytes", "Number of bytes transferred by put and get on each BTL module"}
+};
+
+static int mca_btl_base_pvar_notify(struct mca_base_pvar_t *pvar, mca_base_pvar_event_t event,
+                                    void *obj, int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        *count = MCA_BTL_BASE_PVAR_MODULES;
+    }
+    return OMPI_SUCCESS;
+}
+
+/* one value per module, in the order of mca_btl_base_modules_initialized */
+static int mca_btl_base_pvar_get(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    int counter = (int) (intptr_t) pvar->ctx, i = 0;
+    ompi_pvar_counter_t *values = (ompi_pvar_counter_t *) value;
+    mca_btl_base_selected_module_t *sm;
+
+    memset(values, 0, MCA_BTL_BASE_PVAR_MODULES * sizeof(*values));
+    if (mca_btl_base_pvars_valid) {
+        OPAL_LIST_FOREACH(sm, &mca_btl_base_modules_initialized, mca_btl_base_selected_module_t) {
+            if (MCA_BTL_BASE_PVAR_MODULES == i) {
+                break;
+            }
+            values[i++] = sm->btl_module->btl_pvar_counters[counter];
+        }
+    }
+    return OMPI_SUCCESS;
+}
+#endif  /* OMPI_ENABLE_PVAR_COUNTERS */
+
 static int mca_btl_base_register(mca_base_register_flag_t flags)
 {
     /* Override the per-BTL "don't run if THREAD_MULTIPLE selected"
@@ -130,6 +181,25 @@ static int mca_btl_base_open(mca_base_open_flag_t flags)
 
   OBJ_CONSTRUCT(&mca_btl_base_modules_initialized, opal_list_t);
 
+#if OMPI_ENABLE_PVAR_COUNTERS
+  {
+      int i;
+
+      mca_btl_base_pvars_valid = true;
+      for (i = 0 ; i < MCA_BTL_BASE_PVAR_MAX ; ++i) {
+          (void) mca_base_pvar_register("ompi", "btl", "base", mca_btl_base_pvars[i].name,
+                                        mca_btl_base_pvars[i].description, OPAL_INFO_LVL_4,
+                                        MCA_BASE_PVAR_CLASS_COUNTER,
+                                        (sizeof(ompi_pvar_counter_t) == sizeof(unsigned long)) ?
+                                        MCA_BASE_VAR_TYPE_UNSIGNED_LONG : MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG,
+                                        NULL, MPI_T_BIND_NO_OBJECT,
+                                        MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                        mca_btl_base_pvar_get, NULL, mca_btl_base_pvar_notify,
+                                        (void *) (intptr_t) i);
+      }
+  }
+#endif
+
   /* get the verbosity so that BTL_VERBOSE will work */
   mca_btl_base_verbose = opal_output_get_verbosity(ompi_btl_base_framework.framework_output);
 
@@ -162,6 +232,9 @@ static int mca_btl_base_close(void)
 
     (void) mca_base_framework_components_close(&ompi_btl_base_framework, NULL);
 
+#if OMPI_ENABLE_PVAR_COUNTERS
+    mca_btl_base_pvars_valid = false;
+#endif
     OBJ_DESTRUCT(&mca_btl_base_modules_initialized);
 
 #if 0
@@ -172,6 +245,28 @@ static int mca_btl_base_close(void)
     return OMPI_SUCCESS;
 }
 
+int mca_btl_base_quiesce(void)
+{
+    mca_btl_base_selected_module_t *sm;
+    int rc;
+
+    /* only the BTL-based PMLs open the framework */
+    if (0 >= ompi_btl_base_framework.framework_refcnt) {
+        return OMPI_SUCCESS;
+    }
+
+    OPAL_LIST_FOREACH(sm, &mca_btl_base_modules_initialized, mca_btl_base_selected_module_t) {
+        if (NULL == sm->btl_module->btl_quiesce) {
+            continue;
+        }
+        rc = sm->btl_module->btl_quiesce(sm->btl_module);
+        if (OMPI_SUCCESS != rc) {
+            return rc;
+        }
+    }
+    return OMPI_SUCCESS;
+}
+
 MCA_BASE_FRAMEWORK_DECLARE(ompi, btl, "Byte Transport Layer", mca_btl_base_register,
                            mca_btl_base_open, mca_btl_base_close, mca_btl_base_static_components,
                            0);
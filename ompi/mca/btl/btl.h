@@ -119,6 +119,7 @@
 #include "opal/prefetch.h" /* For OPAL_LIKELY */
 #include "ompi/mca/mpool/mpool.h"
 #include "ompi/types.h"
+#include "ompi/runtime/ompi_pvar_counters.h"
 #include "opal/types.h"
 
 #include "opal/mca/crs/crs.h"
@@ -210,6 +211,13 @@ typedef uint8_t mca_btl_base_tag_t;
  */
 #define MCA_BTL_FLAGS_SIGNALED        0x4000
 
+/* btl does not need add_procs to have been called for a peer before
+ * that peer starts talking to it (it either only reaches the local
+ * node or it sets up its side of the connection when the peer
+ * connects). This allows the BML to set up the peers on demand.
+ */
+#define MCA_BTL_FLAGS_ADD_PROCS_ON_DEMAND 0x8000
+
 /* Default exclusivity levels */
 #define MCA_BTL_EXCLUSIVITY_HIGH     (64*1024) /* internal loopback */
 #define MCA_BTL_EXCLUSIVITY_DEFAULT  1024      /* GM/IB/etc. */
@@ -450,6 +458,21 @@ typedef struct mca_btl_base_component_2_0_0_t mca_btl_base_component_1_0_0_t;
 
 
 
+/**
+ * Counters kept by every module (see ompi_pvar_counters.h). Sends and
+ * RDMA operations are counted by the bml, receives by the PML
+ * callbacks.
+ */
+enum {
+    MCA_BTL_BASE_PVAR_FRAGS_SENT,
+    MCA_BTL_BASE_PVAR_BYTES_SENT,
+    MCA_BTL_BASE_PVAR_FRAGS_RECV,
+    MCA_BTL_BASE_PVAR_BYTES_RECV,
+    MCA_BTL_BASE_PVAR_FRAGS_RDMA,
+    MCA_BTL_BASE_PVAR_BYTES_RDMA,
+    MCA_BTL_BASE_PVAR_MAX
+};
+
 /*
  * BTL module interface functions and datatype.
  */
@@ -800,6 +823,19 @@ typedef void (*mca_btl_base_module_dump_fn_t)(
  */
 typedef int (*mca_btl_base_module_ft_event_fn_t)(int state);
 
+/**
+ * Local quiescence test, used by MPI_FINALIZE in place of the job-wide
+ * barrier (mpi_finalize_quiesce).
+ *
+ * @param btl (IN)         BTL module
+ * @return OMPI_SUCCESS when the module has no send in flight and no
+ *         fragment waiting for a completion or an acknowledgement,
+ *         OMPI_ERR_RESOURCE_BUSY otherwise
+ *
+ * Optional: a module that leaves it NULL is only progressed.
+ */
+typedef int (*mca_btl_base_module_quiesce_fn_t)(struct mca_btl_base_module_t* btl);
+
 /**
  * BTL module interface functions and attributes.
  */
@@ -841,9 +877,37 @@ struct mca_btl_base_module_t {
     mca_btl_base_module_register_error_fn_t btl_register_error;
     /** fault tolerant even notification */
     mca_btl_base_module_ft_event_fn_t btl_ft_event;
+    /** local quiescence test (optional) */
+    mca_btl_base_module_quiesce_fn_t btl_quiesce;
+
+    /** traffic of the module, exported by the btl base as MPI_T counters */
+    ompi_pvar_counter_t btl_pvar_counters[MCA_BTL_BASE_PVAR_MAX];
 };
 typedef struct mca_btl_base_module_t mca_btl_base_module_t;
 
+/**
+ * Count a fragment of size bytes in counter (one of the _FRAGS_ kinds,
+ * the bytes going to the next one).
+ */
+static inline void mca_btl_base_pvar_count(mca_btl_base_module_t *btl, int counter,
+                                           size_t size)
+{
+    OMPI_PVAR_COUNTER_ADD(btl->btl_pvar_counters[counter], 1);
+    OMPI_PVAR_COUNTER_ADD(btl->btl_pvar_counters[counter + 1], size);
+}
+
+/** Number of bytes described by a list of segments */
+static inline size_t mca_btl_base_segments_size(const mca_btl_base_segment_t *segments,
+                                                size_t count)
+{
+    size_t size = 0;
+
+    while (count-- > 0) {
+        size += segments[count].seg_len;
+    }
+    return size;
+}
+
 /*
  * Macro for use in modules that are of type btl v2.0.1
  */
@@ -0,0 +1,75 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2013      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+# 
+# Additional copyrights may follow
+# 
+# $HEADER$
+#
+
+AC_DEFUN([MCA_ompi_btl_CONFIG],[
+    # configure all the components
+    MCA_CONFIGURE_FRAMEWORK($1, $2, 1)
+
+    # BTLs whose send paths the BML calls directly
+    OMPI_BTL_SETUP_FASTPATH
+])
+
+
+# OMPI_BTL_SETUP_FASTPATH
+# -----------------------
+# Process --enable-btl-fastpath=LIST.  Each listed BTL must be built
+# into the library (static), as the BML references its send entry
+# points by name.  Defines OMPI_BTL_FASTPATH_<NAME> to 1 for the
+# listed BTLs and to 0 for all others.
+AC_DEFUN([OMPI_BTL_SETUP_FASTPATH],[
+    AC_ARG_ENABLE([btl-fastpath],
+        [AC_HELP_STRING([--enable-btl-fastpath=LIST],
+                        [Comma-separated list of BTLs (self, sm, vader,
+                         openib, tcp) whose send and send immediate
+                         functions are called directly from the BML
+                         instead of through the module function table.
+                         The BTLs must be built statically.  Combine with
+                         --enable-mca-direct=pml-ob1 to also direct-call
+                         the PML.])])
+
+    AC_MSG_CHECKING([which BTLs use the direct call fast path])
+    ompi_btl_fastpath_list=
+    AS_IF([test "$enable_btl_fastpath" = "yes"],
+          [AC_MSG_RESULT([yes])
+           AC_MSG_ERROR([*** --enable-btl-fastpath requires an explicit list of BTLs.
+*** For example, --enable-btl-fastpath=self,vader,openib])],
+          [test -n "$enable_btl_fastpath" -a "$enable_btl_fastpath" != "no"],
+          [ompi_btl_fastpath_list="`echo $enable_btl_fastpath | sed -e 's/,/ /g'`"])
+
+    for ompi_btl_fastpath_item in $ompi_btl_fastpath_list ; do
+        case "$ompi_btl_fastpath_item" in
+        self|sm|vader|openib|tcp)
+            ;;
+        *)
+            AC_MSG_RESULT([$ompi_btl_fastpath_list])
+            AC_MSG_ERROR([*** BTL $ompi_btl_fastpath_item does not support the direct call fast path])
+            ;;
+        esac
+        AS_IF([echo " $MCA_ompi_btl_STATIC_COMPONENTS " | $GREP " $ompi_btl_fastpath_item " > /dev/null],
+              [],
+              [AC_MSG_RESULT([$ompi_btl_fastpath_list])
+               AC_MSG_ERROR([*** BTL $ompi_btl_fastpath_item must be built statically to use the fast path.
+*** Add btl-$ompi_btl_fastpath_item to --enable-mca-static])])
+    done
+    AS_IF([test -z "$ompi_btl_fastpath_list"],
+          [AC_MSG_RESULT([none])],
+          [AC_MSG_RESULT([$ompi_btl_fastpath_list])])
+
+    m4_foreach([ompi_btl_fp], [self, sm, vader, openib, tcp], [
+        ompi_btl_fastpath_value=0
+        AS_IF([echo " $ompi_btl_fastpath_list " | $GREP " ompi_btl_fp " > /dev/null],
+              [ompi_btl_fastpath_value=1])
+        AC_DEFINE_UNQUOTED([OMPI_BTL_FASTPATH_]m4_toupper(ompi_btl_fp),
+                           [$ompi_btl_fastpath_value],
+                           [Whether the BML calls the ]ompi_btl_fp[ BTL send functions directly])
+    ])
+])
@@ -187,13 +187,10 @@ static int adjust_cq(mca_btl_openib_device_t *device, const int cq)
         cq_size = device->ib_dev_attr.max_cqe;
 
     if(NULL == device->ib_cq[cq]) {
+        /* the channel only exists with the progress threads or the
+           hybrid waits */
         device->ib_cq[cq] = create_cq_compat(device->ib_dev_context, cq_size,
-#if OMPI_ENABLE_PROGRESS_THREADS == 1
-                device, device->ib_channel,
-#else
-                NULL, NULL,
-#endif
-                0);
+                device, device->ib_channel, 0);
 
         if (NULL == device->ib_cq[cq]) {
             mca_btl_openib_show_init_error(__FILE__, __LINE__, "ibv_create_cq",
@@ -378,13 +375,17 @@ static int create_srq(mca_btl_openib_module_t *openib_btl)
 
                 openib_btl->qps[qp].u.srq_qp.rd_low_local = rd_curr_num - (rd_curr_num >> 2);
                 openib_btl->qps[qp].u.srq_qp.srq_limit_event_flag = true;
+                openib_btl->qps[qp].u.srq_qp.srq_shrink =
+                    (0 != mca_btl_openib_component.srq_shrink_interval);
             } else {
                 openib_btl->qps[qp].u.srq_qp.rd_curr_num = rd_num;
                 openib_btl->qps[qp].u.srq_qp.rd_low_local = mca_btl_openib_component.qp_infos[qp].rd_low;
                 /* Not used in this case, but we don't need a garbage */
                 mca_btl_openib_component.qp_infos[qp].u.srq_qp.srq_limit = 0;
                 openib_btl->qps[qp].u.srq_qp.srq_limit_event_flag = false;
+                openib_btl->qps[qp].u.srq_qp.srq_shrink = false;
             }
+            openib_btl->qps[qp].u.srq_qp.rd_quiet = 0;
         }
     }
 
@@ -1295,7 +1296,8 @@ mca_btl_base_descriptor_t* mca_btl_openib_prepare_src(
     /* If the convertor is copying the data asynchronously, then record an event
      * that will trigger the callback when it completes.  Mark descriptor as async.*/
     if (convertor->flags & CONVERTOR_CUDA_ASYNC) {
-        mca_common_cuda_record_dtoh_event("btl_openib", (mca_btl_base_descriptor_t *)frag);
+        mca_common_cuda_record_dtoh_event("btl_openib", (mca_btl_base_descriptor_t *)frag,
+                                          convertor->stream);
         to_base_frag(frag)->base.des_flags = flags | MCA_BTL_DES_FLAGS_CUDA_COPY_ASYNC;
     }
 #endif /* OMPI_CUDA_SUPPORT */
@@ -1753,7 +1755,6 @@ int mca_btl_openib_put( mca_btl_base_module_t* btl,
 {
     mca_btl_openib_segment_t *src_seg = (mca_btl_openib_segment_t *) descriptor->des_src;
     mca_btl_openib_segment_t *dst_seg = (mca_btl_openib_segment_t *) descriptor->des_dst;
-    struct ibv_send_wr* bad_wr;
     mca_btl_openib_out_frag_t* frag = to_out_frag(descriptor);
     int qp = descriptor->order;
     uint64_t rem_addr = dst_seg->base.seg_addr.lval;
@@ -1814,7 +1815,7 @@ int mca_btl_openib_put( mca_btl_base_module_t* btl,
     qp_inflight_wqe_to_frag(ep, qp, to_com_frag(frag));
     qp_reset_signal_count(ep, qp);
 
-    if(ibv_post_send(ep->qps[qp].qp->lcl_qp, &frag->sr_desc, &bad_wr))
+    if(qp_post_wr(ep, qp, &frag->sr_desc))
         return OMPI_ERROR;
 
     return OMPI_SUCCESS;
@@ -1830,7 +1831,6 @@ int mca_btl_openib_get(mca_btl_base_module_t* btl,
 {
     mca_btl_openib_segment_t *src_seg = (mca_btl_openib_segment_t *) descriptor->des_src;
     mca_btl_openib_segment_t *dst_seg = (mca_btl_openib_segment_t *) descriptor->des_dst;
-    struct ibv_send_wr* bad_wr;
     mca_btl_openib_get_frag_t* frag = to_get_frag(descriptor);
     int qp = descriptor->order;
     uint64_t rem_addr = src_seg->base.seg_addr.lval;
@@ -1896,7 +1896,7 @@ int mca_btl_openib_get(mca_btl_base_module_t* btl,
     qp_inflight_wqe_to_frag(ep, qp, to_com_frag(frag));
     qp_reset_signal_count(ep, qp);
 
-    if(ibv_post_send(ep->qps[qp].qp->lcl_qp, &frag->sr_desc, &bad_wr))
+    if(qp_post_wr(ep, qp, &frag->sr_desc))
         return OMPI_ERROR;
 
     return OMPI_SUCCESS;
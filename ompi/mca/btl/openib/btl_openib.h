@@ -53,6 +53,9 @@ BEGIN_C_DECLS
 
 #define HAVE_XRC (1 == OMPI_HAVE_CONNECTX_XRC)
 #define ENABLE_DYNAMIC_SL (1 == OMPI_ENABLE_DYNAMIC_SL)
+#define HAVE_IMPLICIT_ODP (HAVE_DECL_IBV_ACCESS_ON_DEMAND && \
+                           HAVE_DECL_IBV_ODP_SUPPORT_IMPLICIT && \
+                           HAVE_DECL_IBV_QUERY_DEVICE_EX)
 
 #define MCA_BTL_IB_LEAVE_PINNED 1
 #define IB_DEFAULT_GID_PREFIX 0xfe80000000000000ll
@@ -217,6 +220,8 @@ struct mca_btl_openib_component_t {
     unsigned int ib_rnr_retry;
     unsigned int ib_max_rdma_dst_ops;
     unsigned int ib_service_level;
+    /** Service levels taken in turn by the BTLs of a port */
+    char *ib_service_levels;
 #if (ENABLE_DYNAMIC_SL)
     unsigned int ib_path_record_service_level;
 #endif
@@ -224,6 +229,8 @@ struct mca_btl_openib_component_t {
     int     eager_rdma_threshold; /**< After this number of msg, use RDMA for short messages, always */
     int     eager_rdma_num;
     int32_t max_eager_rdma;
+    int     eager_rdma_window; /**< Eager receives per rate window, 0 = count forever */
+    int     eager_rdma_idle_windows; /**< Windows without traffic before a channel is revoked */
     unsigned int btls_per_lid;
     unsigned int max_lmc;
     int     apm_lmc;
@@ -274,6 +281,9 @@ struct mca_btl_openib_component_t {
     /** Whether we want to abort if there's not enough registered
         memory available */
     bool abort_not_enough_reg_mem;
+    /** Whether to register the whole address space once per device
+        with on-demand paging instead of pinning the buffers */
+    bool use_odp;
 
     /** Dummy argv-style list; a copy of names from the
         if_[in|ex]clude list that we use for error checking (to ensure
@@ -284,6 +294,10 @@ struct mca_btl_openib_component_t {
     unsigned int cq_poll_progress;
     unsigned int cq_poll_batch;
     unsigned int eager_rdma_poll_ratio;
+    /** Let a single thread at a time poll a device */
+    bool exclusive_poll;
+    /** Send WRs chained per QP before ringing the doorbell */
+    int post_batch;
 #ifdef HAVE_IBV_FORK_INIT
     /** Whether we want fork support or not */
     int want_fork_support;
@@ -299,10 +313,19 @@ struct mca_btl_openib_component_t {
     ompi_free_list_t send_free_coalesced;
     /** Default receive queues */
     char* default_recv_qps;
+    /** Default receive queues when they can all be XRC */
+    char* default_xrc_recv_qps;
+    /** Whether to use the XRC default receive queues when possible */
+    bool xrc_by_default;
+    /** Whether all the devices found so far support XRC */
+    bool devices_xrc_capable;
     /** GID index to use */
     int gid_index;
     /** Whether we want a dynamically resizing srq, enabled by default */
     bool enable_srq_resize;
+    /** Number of SRQ refills without a limit event after which a grown
+        SRQ is halved again (0 = never shrink) */
+    unsigned int srq_shrink_interval;
 #if BTL_OPENIB_FAILOVER_ENABLED
     int verbose_failover;
 #endif
@@ -364,10 +387,12 @@ struct mca_btl_base_endpoint_t;
 typedef struct mca_btl_openib_device_t {
     opal_object_t super;
     struct ibv_device *ib_dev;  /* the ib device */
-#if OMPI_ENABLE_PROGRESS_THREADS == 1
     struct ibv_comp_channel *ib_channel; /* Channel event for the device */
+#if OMPI_ENABLE_PROGRESS_THREADS == 1
     opal_thread_t thread;                /* Progress thread */
     volatile bool progress;              /* Progress status */
+#else
+    opal_event_t ib_channel_event;       /* wakes the hybrid waits */
 #endif
     opal_mutex_t device_lock;          /* device level lock */
     struct ibv_context *ib_dev_context;
@@ -386,6 +411,8 @@ typedef struct mca_btl_openib_device_t {
     uint16_t hp_cq_polls;
     uint16_t eager_rdma_polls;
     bool pollme;
+    /* Set while a thread polls the device, see btl_openib_exclusive_poll */
+    volatile int32_t polling;
 #if OPAL_HAVE_THREADS
     volatile bool got_fatal_event;
     volatile bool got_port_event;
@@ -405,6 +432,14 @@ typedef struct mca_btl_openib_device_t {
     uint32_t max_inline_data;
     /* Registration limit and current count */
     uint64_t mem_reg_max, mem_reg_active;
+    /* Eager receives over the send/recv path, the clock of the eager
+       RDMA rate windows */
+    uint32_t eager_recv_clock;
+    /* Implicit on-demand paging MR covering the whole address space,
+       handed out for every registration when btl_openib_odp is set */
+    struct ibv_mr *implicit_mr;
+    /* QPs holding chained send WRs, posted at the end of progress */
+    struct mca_btl_openib_qp_t *post_pending;
 } mca_btl_openib_device_t;
 OBJ_CLASS_DECLARATION(mca_btl_openib_device_t);
 
@@ -437,6 +472,11 @@ struct mca_btl_openib_module_srq_qp_t {
          the srq_limit_event_flag in asynchronous thread, because in this way we post receive buffers
          in the main thread only and only after posting we set (if srq_limit_event_flag is true)
          the limit for IBV_EVENT_SRQ_LIMIT_REACHED event. */
+    /** Whether rd_curr_num may be lowered back towards rd_init once a burst is over */
+    bool srq_shrink;
+    /** Number of refills since the last IBV_EVENT_SRQ_LIMIT_REACHED event,
+        reset by the asynchronous thread */
+    int32_t rd_quiet;
 }; typedef struct mca_btl_openib_module_srq_qp_t mca_btl_openib_module_srq_qp_t;
 
 struct mca_btl_openib_module_qp_t {
@@ -471,6 +511,7 @@ struct mca_btl_openib_module_t {
     uint16_t lid;                      /**< lid that is actually used (for LMC) */
     int apm_port;                      /**< Alternative port that may be used for APM */
     uint8_t src_path_bits;             /**< offset from base lid (for LMC) */
+    uint8_t service_level;             /**< SL of the connections of this BTL */
 
     int32_t num_peers;
 
@@ -21,6 +21,7 @@
 #include <errno.h>
 
 #include "opal/util/show_help.h"
+#include "opal/mca/hwloc/base/base.h"
 #include "ompi/mca/btl/base/base.h"
 #include "btl_openib.h"
 #include "btl_openib_mca.h"
@@ -292,6 +293,9 @@ static int btl_openib_async_srq_limit_event(struct ibv_srq* srq)
         goto srq_limit_event_exit;
     }
 
+    /* a burst is going on, so restart the countdown to shrinking */
+    openib_btl->qps[qp].u.srq_qp.rd_quiet = 0;
+
     /* dynamically re-size the SRQ to be larger */
     openib_btl->qps[qp].u.srq_qp.rd_curr_num <<= 1;
 
@@ -466,6 +470,10 @@ void* btl_openib_async_thread(void * async)
 
     OBJ_CONSTRUCT(&ignore_qp_err_list, opal_list_t);
 
+#if OPAL_HAVE_HWLOC
+    (void) opal_hwloc_base_bind_helper_thread("openib async");
+#endif
+
     if (OMPI_SUCCESS != btl_openib_async_poll_init(&devices_poll)) {
         BTL_ERROR(("Fatal error, stoping asynch event thread"));
         pthread_exit(&return_status);
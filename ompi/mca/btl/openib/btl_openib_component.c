@@ -35,6 +35,9 @@
 #endif
 #include <sys/types.h>
 #include <sys/stat.h>
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
 #include <stdlib.h>
 #include <stddef.h>
 #if BTL_OPENIB_MALLOC_HOOKS_ENABLED
@@ -54,6 +57,7 @@
 #endif
 
 #include "opal/mca/event/event.h"
+#include "opal/runtime/opal_progress.h"
 #include "opal/align.h"
 #include "opal/util/output.h"
 #include "opal/util/argv.h"
@@ -112,6 +116,13 @@ static int btl_openib_component_open(void);
 static int btl_openib_component_close(void);
 static mca_btl_base_module_t **btl_openib_component_init(int*, bool, bool);
 static int btl_openib_component_progress(void);
+#if !OMPI_ENABLE_PROGRESS_THREADS
+static int btl_openib_component_arm(void);
+static void btl_openib_channel_event(int fd, short flags, void *arg);
+/* devices with a completion channel for the hybrid waits */
+static int btl_openib_channels = 0;
+static bool btl_openib_arm_registered = false;
+#endif
 #if OMPI_CUDA_SUPPORT /* CUDA_ASYNC_RECV */
 static void btl_openib_handle_incoming_completion(mca_btl_base_module_t* btl,
                                                   mca_btl_openib_endpoint_t *ep,
@@ -224,6 +235,8 @@ static int btl_openib_component_open(void)
     mca_btl_openib_component.devices_count = 0;
     mca_btl_openib_component.cpc_explicitly_defined = false;
     mca_btl_openib_component.default_recv_qps = NULL;
+    mca_btl_openib_component.default_xrc_recv_qps = NULL;
+    mca_btl_openib_component.devices_xrc_capable = true;
 
     /* initialize objects */
     OBJ_CONSTRUCT(&mca_btl_openib_component.ib_procs, opal_list_t);
@@ -266,6 +279,13 @@ static int btl_openib_component_close(void)
     OBJ_DESTRUCT(&mca_btl_openib_component.srq_manager.srq_addr_table);
 #endif
 
+#if !OMPI_ENABLE_PROGRESS_THREADS
+    if (btl_openib_arm_registered) {
+        opal_progress_unregister_arm(btl_openib_component_arm);
+        btl_openib_arm_registered = false;
+    }
+#endif
+
     ompi_btl_openib_connect_base_finalize();
     ompi_btl_openib_fd_finalize();
     ompi_btl_openib_ini_finalize();
@@ -273,6 +293,9 @@ static int btl_openib_component_close(void)
     if (NULL != mca_btl_openib_component.default_recv_qps) {
         free(mca_btl_openib_component.default_recv_qps);
     }
+    if (NULL != mca_btl_openib_component.default_xrc_recv_qps) {
+        free(mca_btl_openib_component.default_xrc_recv_qps);
+    }
     
 #if BTL_OPENIB_MALLOC_HOOKS_ENABLED
     /* Must check to see whether the malloc hook was set before
@@ -462,6 +485,7 @@ static void btl_openib_control(mca_btl_base_module_t* btl,
     mca_btl_openib_control_header_t *ctl_hdr =
         (mca_btl_openib_control_header_t *) to_base_frag(des)->segment.base.seg_addr.pval;
     mca_btl_openib_eager_rdma_header_t *rdma_hdr;
+    mca_btl_openib_eager_rdma_revoke_header_t *revoke_hdr;
     mca_btl_openib_header_coalesced_t *clsc_hdr =
         (mca_btl_openib_header_coalesced_t*)(ctl_hdr + 1);
     mca_btl_active_message_callback_t* reg;
@@ -500,6 +524,16 @@ static void btl_openib_control(mca_btl_base_module_t* btl,
        ep->eager_rdma_remote.base.lval = rdma_hdr->rdma_start.lval;
        ep->eager_rdma_remote.tokens=mca_btl_openib_component.eager_rdma_num - 1;
        break;
+    case MCA_BTL_OPENIB_CONTROL_RDMA_REVOKE:
+        mca_btl_openib_endpoint_eager_rdma_revoked(ep);
+        break;
+    case MCA_BTL_OPENIB_CONTROL_RDMA_REVOKE_ACK:
+        revoke_hdr = (mca_btl_openib_eager_rdma_revoke_header_t*)ctl_hdr;
+        if(ep->nbo) {
+            BTL_OPENIB_EAGER_RDMA_REVOKE_HEADER_NTOH(*revoke_hdr);
+        }
+        mca_btl_openib_endpoint_eager_rdma_revoke_acked(ep, revoke_hdr->count);
+        break;
     case MCA_BTL_OPENIB_CONTROL_COALESCED:
         {
             size_t pad = 0;
@@ -577,6 +611,12 @@ static int openib_reg_mr(void *reg_data, void *base, size_t size,
     enum ibv_access_flags access_flag = (enum ibv_access_flags) (IBV_ACCESS_LOCAL_WRITE |
         IBV_ACCESS_REMOTE_WRITE | IBV_ACCESS_REMOTE_READ);
 
+    /* the implicit MR already covers the buffer and pins nothing */
+    if (NULL != device->implicit_mr) {
+        openib_reg->mr = device->implicit_mr;
+        return OMPI_SUCCESS;
+    }
+
     if (device->mem_reg_max &&
         device->mem_reg_max < (device->mem_reg_active + size)) {
         return OMPI_ERR_OUT_OF_RESOURCE;
@@ -611,6 +651,11 @@ static int openib_dereg_mr(void *reg_data, mca_mpool_base_registration_t *reg)
     mca_btl_openib_device_t *device = (mca_btl_openib_device_t*)reg_data;
     mca_btl_openib_reg_t *openib_reg = (mca_btl_openib_reg_t*)reg;
 
+    if (NULL != device->implicit_mr) {
+        openib_reg->mr = NULL;
+        return OMPI_SUCCESS;
+    }
+
     if(openib_reg->mr != NULL) {
         if(ibv_dereg_mr(openib_reg->mr)) {
             BTL_ERROR(("%s: error unpinning openib memory errno says %s",
@@ -682,6 +727,8 @@ static int init_one_port(opal_list_t *btl_list, mca_btl_openib_device_t *device,
     mca_btl_base_selected_module_t *ib_selected;
     union ibv_gid gid;
     uint64_t subnet_id;
+    char **sls = NULL;
+    int num_sls = 0, path = 0, rc = OMPI_SUCCESS;
 
     /* Ensure that the requested GID index (via the
        btl_openib_gid_index MCA param) is within the GID table
@@ -783,6 +830,15 @@ static int init_one_port(opal_list_t *btl_list, mca_btl_openib_device_t *device,
     }
 #endif
 
+    /* The PML stripes large messages over the BTLs of the port.  Each
+       LID is a distinct DLID for the peer, which static fat-tree
+       routing maps to a distinct uplink; giving each BTL its own
+       service level in addition spreads them over virtual lanes. */
+    if (NULL != mca_btl_openib_component.ib_service_levels) {
+        sls = opal_argv_split(mca_btl_openib_component.ib_service_levels, ',');
+        num_sls = opal_argv_count(sls);
+    }
+
     for(lid = ib_port_attr->lid;
             lid < ib_port_attr->lid + lmc; lid += lmc_step){
         for(i = 0; i < mca_btl_openib_component.btls_per_lid; i++){
@@ -791,7 +847,8 @@ static int init_one_port(opal_list_t *btl_list, mca_btl_openib_device_t *device,
             openib_btl = (mca_btl_openib_module_t *) calloc(1, sizeof(mca_btl_openib_module_t));
             if(NULL == openib_btl) {
                 BTL_ERROR(("Failed malloc: %s:%d", __FILE__, __LINE__));
-                return OMPI_ERR_OUT_OF_RESOURCE;
+                rc = OMPI_ERR_OUT_OF_RESOURCE;
+                goto out;
             }
             memcpy(openib_btl, &mca_btl_openib_module,
                     sizeof(mca_btl_openib_module));
@@ -805,6 +862,18 @@ static int init_one_port(opal_list_t *btl_list, mca_btl_openib_device_t *device,
             openib_btl->lid = lid;
             openib_btl->apm_port = 0;
             openib_btl->src_path_bits = lid - ib_port_attr->lid;
+            openib_btl->service_level = mca_btl_openib_component.ib_service_level;
+            if (num_sls > 0) {
+                unsigned long sl = strtoul(sls[path % num_sls], NULL, 10);
+                if (sl > 15) {
+                    opal_show_help("help-mpi-btl-openib.txt", "invalid mca param value",
+                                   true, "btl_openib_ib_service_levels entry > 15",
+                                   "btl_openib_ib_service_level used instead");
+                } else {
+                    openib_btl->service_level = (uint8_t) sl;
+                }
+            }
+            path++;
 
             openib_btl->port_info.subnet_id = subnet_id;
             openib_btl->port_info.mtu = device->mtu;
@@ -857,7 +926,8 @@ static int init_one_port(opal_list_t *btl_list, mca_btl_openib_device_t *device,
                        ERR_VALUE_OF_OUT_OF_BOUNDS; that is reserved
                        for when we exceed the number of allowable
                        BTLs). */
-                    return OMPI_ERR_UNREACH;
+                    rc = OMPI_ERR_UNREACH;
+                    goto out;
                 }
             }
 
@@ -868,12 +938,17 @@ static int init_one_port(opal_list_t *btl_list, mca_btl_openib_device_t *device,
             if (-1 != mca_btl_openib_component.ib_max_btls &&
                 mca_btl_openib_component.ib_num_btls >=
                 mca_btl_openib_component.ib_max_btls) {
-                return OMPI_ERR_VALUE_OUT_OF_BOUNDS;
+                rc = OMPI_ERR_VALUE_OUT_OF_BOUNDS;
+                goto out;
             }
         }
     }
 
-    return OMPI_SUCCESS;
+out:
+    if (NULL != sls) {
+        opal_argv_free(sls);
+    }
+    return rc;
 }
 
 static void device_construct(mca_btl_openib_device_t *device)
@@ -882,9 +957,9 @@ static void device_construct(mca_btl_openib_device_t *device)
     device->ib_dev_context = NULL;
     device->ib_pd = NULL;
     device->mpool = NULL;
-#if OMPI_ENABLE_PROGRESS_THREADS
+    device->implicit_mr = NULL;
+    device->post_pending = NULL;
     device->ib_channel = NULL;
-#endif
     device->btls = 0;
     device->endpoints = NULL;
     device->device_btls = NULL;
@@ -896,6 +971,7 @@ static void device_construct(mca_btl_openib_device_t *device)
     device->hp_cq_polls = mca_btl_openib_component.cq_poll_ratio;
     device->eager_rdma_polls = mca_btl_openib_component.eager_rdma_poll_ratio;
     device->pollme = true;
+    device->polling = 0;
     device->eager_rdma_buffers_count = 0;
     device->eager_rdma_buffers = NULL;
 #if HAVE_XRC
@@ -983,11 +1059,26 @@ static void device_destruct(mca_btl_openib_device_t *device)
         }
     }
 
+#if !OMPI_ENABLE_PROGRESS_THREADS
+    if (NULL != device->ib_channel) {
+        opal_event_del(&device->ib_channel_event);
+        if (ibv_destroy_comp_channel(device->ib_channel)) {
+            BTL_VERBOSE(("Failed to close comp_channel"));
+            goto device_error;
+        }
+    }
+#endif
+
     if (OMPI_SUCCESS != mca_mpool_base_module_destroy(device->mpool)) {
         BTL_VERBOSE(("Failed to release mpool"));
         goto device_error;
     }
 
+    if (NULL != device->implicit_mr && ibv_dereg_mr(device->implicit_mr)) {
+        BTL_VERBOSE(("Warning! Failed to release the implicit MR"));
+        goto device_error;
+    }
+
 #if HAVE_XRC
     if (MCA_BTL_XRC_ENABLED) {
         if (OMPI_SUCCESS != mca_btl_openib_close_xrc_domain(device)) {
@@ -1653,6 +1744,11 @@ static int init_one_device(opal_list_t *btl_list, struct ibv_device* ib_dev)
                     ibv_get_device_name(device->ib_dev), strerror(errno)));
         goto error;
     }
+#if HAVE_XRC
+    if (!(device->ib_dev_attr.device_cap_flags & IBV_DEVICE_XRC)) {
+        mca_btl_openib_component.devices_xrc_capable = false;
+    }
+#endif
     /* If mca_btl_if_include/exclude were specified, get usable ports */
     allowed_ports = (int*)malloc(device->ib_dev_attr.phys_port_cnt * sizeof(int));
     port_cnt = get_port_list(device, allowed_ports);
@@ -1744,6 +1840,38 @@ static int init_one_device(opal_list_t *btl_list, struct ibv_device* ib_dev)
         goto error;
     }
 
+#if HAVE_IMPLICIT_ODP
+    /* Register the whole address space at once: the HCA faults the
+       pages in on access, so the registrations handed out later cost
+       nothing and never go stale */
+    if (mca_btl_openib_component.use_odp) {
+        struct ibv_device_attr_ex attr_ex;
+        uint32_t rc_caps = IBV_ODP_SUPPORT_SEND | IBV_ODP_SUPPORT_RECV |
+            IBV_ODP_SUPPORT_WRITE | IBV_ODP_SUPPORT_READ;
+
+        memset(&attr_ex, 0, sizeof(attr_ex));
+        if (0 != ibv_query_device_ex(device->ib_dev_context, NULL, &attr_ex) ||
+            !(attr_ex.odp_caps.general_caps & IBV_ODP_SUPPORT_IMPLICIT) ||
+            rc_caps != (attr_ex.odp_caps.per_transport_caps.rc_odp_caps & rc_caps)) {
+            opal_show_help("help-mpi-btl-openib.txt", "no implicit odp", true,
+                           ompi_process_info.nodename,
+                           ibv_get_device_name(device->ib_dev));
+            goto error;
+        }
+
+        device->implicit_mr = ibv_reg_mr(device->ib_pd, NULL, SIZE_MAX,
+                                         IBV_ACCESS_ON_DEMAND |
+                                         IBV_ACCESS_LOCAL_WRITE |
+                                         IBV_ACCESS_REMOTE_WRITE |
+                                         IBV_ACCESS_REMOTE_READ);
+        if (NULL == device->implicit_mr) {
+            BTL_ERROR(("error registering the implicit MR for %s errno says %s",
+                       ibv_get_device_name(device->ib_dev), strerror(errno)));
+            goto error;
+        }
+    }
+#endif
+
     /* Figure out what the max_inline_data value should be for all
        ports and QPs on this device */
     need_search = false;
@@ -1807,6 +1935,7 @@ static int init_one_device(opal_list_t *btl_list, struct ibv_device* ib_dev)
     mpool_resources.sizeof_reg = sizeof(mca_btl_openib_reg_t);
     mpool_resources.register_mem = openib_reg_mr;
     mpool_resources.deregister_mem = openib_dereg_mr;
+    mpool_resources.implicit_reg = (NULL != device->implicit_mr);
     device->mpool =
         mca_mpool_base_module_create(mca_btl_openib_component.ib_mpool_name,
                 device, &mpool_resources);
@@ -1824,6 +1953,23 @@ static int init_one_device(opal_list_t *btl_list, struct ibv_device* ib_dev)
                     strerror(errno)));
         goto error;
     }
+#else
+    /* a channel for the hybrid waits to block on */
+    if (opal_progress_wait_block) {
+        device->ib_channel = ibv_create_comp_channel(device->ib_dev_context);
+        if (NULL == device->ib_channel) {
+            BTL_VERBOSE(("no completion channel for %s (%s), the blocking waits only poll it",
+                         ibv_get_device_name(device->ib_dev), strerror(errno)));
+        } else {
+            int flags = fcntl(device->ib_channel->fd, F_GETFL);
+            fcntl(device->ib_channel->fd, F_SETFL, flags | O_NONBLOCK);
+            opal_event_set(opal_event_base, &device->ib_channel_event,
+                           device->ib_channel->fd, OPAL_EV_READ | OPAL_EV_PERSIST,
+                           btl_openib_channel_event, device);
+            opal_event_add(&device->ib_channel_event, 0);
+            btl_openib_channels++;
+        }
+    }
 #endif
 
     ret = OMPI_SUCCESS;
@@ -2192,15 +2338,21 @@ static int init_one_device(opal_list_t *btl_list, struct ibv_device* ib_dev)
     }
 
 error:
-#if OMPI_ENABLE_PROGRESS_THREADS
     if (device->ib_channel) {
+#if !OMPI_ENABLE_PROGRESS_THREADS
+        opal_event_del(&device->ib_channel_event);
+        btl_openib_channels--;
+#endif
         ibv_destroy_comp_channel(device->ib_channel);
     }
-#endif
     if (device->mpool) {
         mca_mpool_base_module_destroy(device->mpool);
     }
 
+    if (device->implicit_mr) {
+        ibv_dereg_mr(device->implicit_mr);
+    }
+
     if (device->ib_pd) {
         ibv_dealloc_pd(device->ib_pd);
     }
@@ -2487,6 +2639,11 @@ btl_openib_component_init(int *num_btl_modules,
         goto no_btls;
     }
 
+    /* The send WRs chained on a QP are not protected by its lock */
+    if (enable_mpi_threads || enable_progress_threads) {
+        mca_btl_openib_component.post_batch = 1;
+    }
+
     /* Per https://svn.open-mpi.org/trac/ompi/ticket/1305, check to
        see if $sysfsdir/class/infiniband exists.  If it does not,
        assume that the RDMA hardware drivers are not loaded, and
@@ -2549,6 +2706,21 @@ btl_openib_component_init(int *num_btl_modules,
         ompi_mpi_leave_pinned_pipeline = 0;
     }
 
+    /* With on-demand paging registering is free and a freed buffer
+       cannot leave a stale registration behind: always use the user
+       buffers directly, without the memory hooks */
+    if (mca_btl_openib_component.use_odp) {
+#if HAVE_IMPLICIT_ODP
+        ompi_mpi_leave_pinned = 1;
+        ompi_mpi_leave_pinned_pipeline = 0;
+        mca_mpool_base_implicit_reg = true;
+#else
+        opal_show_help("help-mpi-btl-openib.txt", "odp not built", true,
+                       ompi_process_info.nodename);
+        mca_btl_openib_component.use_odp = false;
+#endif
+    }
+
     index = mca_base_var_find("ompi", "btl", "openib", "max_inline_data");
     if (index >= 0) {
         if (OPAL_SUCCESS == mca_base_var_get_value(index, NULL, &source, NULL)) {
@@ -2773,6 +2945,28 @@ btl_openib_component_init(int *num_btl_modules,
         goto no_btls;
     }
 
+#if HAVE_XRC
+    /* One XRC receive QP per remote node instead of one RC QP per
+       remote process: when nobody chose the receive queues and every
+       device can do it, make the default queues XRC.  The peers compute
+       the same default on the same hardware. */
+    if (mca_btl_openib_component.xrc_by_default &&
+        mca_btl_openib_component.devices_xrc_capable &&
+        BTL_OPENIB_RQ_SOURCE_DEFAULT ==
+        mca_btl_openib_component.receive_queues_source &&
+        1 == mca_btl_openib_component.btls_per_lid &&
+        NULL != mca_btl_openib_component.default_xrc_recv_qps) {
+        BTL_VERBOSE(("using the XRC default receive queues %s",
+                     mca_btl_openib_component.default_xrc_recv_qps));
+        free(mca_btl_openib_component.receive_queues);
+        mca_btl_openib_component.receive_queues =
+            strdup(mca_btl_openib_component.default_xrc_recv_qps);
+        free(mca_btl_openib_component.default_recv_qps);
+        mca_btl_openib_component.default_recv_qps =
+            strdup(mca_btl_openib_component.default_xrc_recv_qps);
+    }
+#endif
+
     /* Setup the BSRQ QP's based on the final value of
        mca_btl_openib_component.receive_queues. */
     if (OMPI_SUCCESS != setup_qps()) {
@@ -2913,6 +3107,12 @@ btl_openib_component_init(int *num_btl_modules,
      * to memory corruption issues when fork is called
      */
     ompi_warn_fork();
+#if !OMPI_ENABLE_PROGRESS_THREADS
+    if (0 < btl_openib_channels &&
+        OPAL_SUCCESS == opal_progress_register_arm(btl_openib_component_arm)) {
+        btl_openib_arm_registered = true;
+    }
+#endif
     return btls;
 
  no_btls:
@@ -3044,6 +3244,56 @@ void mca_btl_openib_frag_progress_pending_put_get(mca_btl_base_endpoint_t *ep,
     }
 }
 
+/*
+ * Adaptive eager RDMA: a peer gets a channel once it sends
+ * eager_rdma_threshold messages within a window of eager_rdma_window
+ * eager receives on the device.  When all the channels are taken, the
+ * one idle for the longest time (at least eager_rdma_idle_windows
+ * windows) is revoked so that the next window can hand it out again.
+ */
+static void eager_rdma_adapt(mca_btl_openib_module_t *openib_btl,
+                             mca_btl_openib_endpoint_t *endpoint)
+{
+    mca_btl_openib_device_t *device = openib_btl->device;
+    uint32_t now = ++device->eager_recv_clock;
+    uint32_t window = (uint32_t) mca_btl_openib_component.eager_rdma_window;
+    uint32_t idle = window * (uint32_t) mca_btl_openib_component.eager_rdma_idle_windows;
+    mca_btl_openib_endpoint_t *ep, *victim = NULL;
+    int i;
+
+    if(now - endpoint->eager_recv_window >= window) {
+        endpoint->eager_recv_window = now;
+        endpoint->eager_recv_count = 0;
+    }
+
+    if(OPAL_THREAD_ADD32(&endpoint->eager_recv_count, 1) !=
+            mca_btl_openib_component.eager_rdma_threshold) {
+        return;
+    }
+
+    if(openib_btl->eager_rdma_channels < mca_btl_openib_component.max_eager_rdma) {
+        mca_btl_openib_endpoint_connect_eager_rdma(endpoint);
+        return;
+    }
+
+    for(i = 0; i < device->eager_rdma_buffers_count; i++) {
+        ep = device->eager_rdma_buffers[i];
+        if(NULL == ep || ep->endpoint_btl != openib_btl ||
+           MCA_BTL_OPENIB_EAGER_RDMA_ACTIVE != ep->eager_rdma_local.revoke_state ||
+           now - ep->eager_rdma_local.last_used < idle) {
+            continue;
+        }
+        if(NULL == victim ||
+           now - ep->eager_rdma_local.last_used > now - victim->eager_rdma_local.last_used) {
+            victim = ep;
+        }
+    }
+
+    if(NULL != victim) {
+        mca_btl_openib_endpoint_revoke_eager_rdma(victim);
+    }
+}
+
 static int btl_openib_handle_incoming(mca_btl_openib_module_t *openib_btl,
                                          mca_btl_openib_endpoint_t *ep,
                                          mca_btl_openib_recv_frag_t *frag,
@@ -3481,12 +3731,17 @@ static void handle_wc(mca_btl_openib_device_t* device, const uint32_t cq,
 
             /* decide if it is time to setup an eager rdma channel */
             if(!endpoint->eager_rdma_local.base.pval && endpoint->use_eager_rdma &&
-                    wc->byte_len < mca_btl_openib_component.eager_limit &&
-                    openib_btl->eager_rdma_channels <
-                    mca_btl_openib_component.max_eager_rdma &&
-                    OPAL_THREAD_ADD32(&endpoint->eager_recv_count, 1) ==
-                    mca_btl_openib_component.eager_rdma_threshold) {
-                mca_btl_openib_endpoint_connect_eager_rdma(endpoint);
+                    wc->byte_len < mca_btl_openib_component.eager_limit) {
+                if(0 == mca_btl_openib_component.eager_rdma_window) {
+                    if(openib_btl->eager_rdma_channels <
+                            mca_btl_openib_component.max_eager_rdma &&
+                            OPAL_THREAD_ADD32(&endpoint->eager_recv_count, 1) ==
+                            mca_btl_openib_component.eager_rdma_threshold) {
+                        mca_btl_openib_endpoint_connect_eager_rdma(endpoint);
+                    }
+                } else {
+                    eager_rdma_adapt(openib_btl, endpoint);
+                }
             }
             break;
         default:
@@ -3644,7 +3899,7 @@ void* mca_btl_openib_progress_thread(opal_object_t* arg)
 }
 #endif
 
-static int progress_one_device(mca_btl_openib_device_t *device)
+static int poll_one_device(mca_btl_openib_device_t *device)
 {
     int i, c, count = 0, ret;
     mca_btl_openib_recv_frag_t* frag;
@@ -3661,6 +3916,11 @@ static int progress_one_device(mca_btl_openib_device_t *device)
             continue;
 
         OPAL_THREAD_LOCK(&endpoint->eager_rdma_local.lock);
+        if(OPAL_UNLIKELY(NULL == endpoint->eager_rdma_local.frags)) {
+            /* released under our feet */
+            OPAL_THREAD_UNLOCK(&endpoint->eager_rdma_local.lock);
+            continue;
+        }
         frag = MCA_BTL_OPENIB_GET_LOCAL_RDMA_FRAG(endpoint,
                 endpoint->eager_rdma_local.head);
 
@@ -3696,6 +3956,13 @@ static int progress_one_device(mca_btl_openib_device_t *device)
                 return 0;
             }
 
+            endpoint->eager_rdma_local.last_used = device->eager_recv_clock;
+            OPAL_THREAD_ADD32(&endpoint->eager_rdma_local.received, 1);
+            if(OPAL_UNLIKELY(MCA_BTL_OPENIB_EAGER_RDMA_ACTIVE !=
+                             endpoint->eager_rdma_local.revoke_state)) {
+                mca_btl_openib_endpoint_eager_rdma_release(endpoint);
+            }
+
             count++;
         } else
             OPAL_THREAD_UNLOCK(&endpoint->eager_rdma_local.lock);
@@ -3711,9 +3978,76 @@ static int progress_one_device(mca_btl_openib_device_t *device)
     return count;
 }
 
+static int progress_one_device(mca_btl_openib_device_t *device)
+{
+    int count;
+
+#if OPAL_HAVE_THREADS
+    /* Under MPI_THREAD_MULTIPLE all the threads waiting on a request
+       drive the progress engine at once. They would only queue on the
+       CQ and eager RDMA locks to find the completions taken by the
+       thread ahead of them, so the device is polled by one thread at a
+       time and the others go back to test their requests, which the
+       poller completes for them. */
+    if (opal_using_threads() && mca_btl_openib_component.exclusive_poll) {
+        if (!opal_atomic_cmpset_32(&device->polling, 0, 1)) {
+            return 0;
+        }
+        count = poll_one_device(device);
+        opal_atomic_wmb();
+        device->polling = 0;
+        return count;
+    }
+#endif
+
+    return poll_one_device(device);
+}
+
 /*
  *  IB component progress.
  */
+#if !OMPI_ENABLE_PROGRESS_THREADS
+/*
+ * The hybrid waits of opal_progress_wait() are about to block: ask for
+ * an event on the next completion of every CQ, then poll for what
+ * completed before the request.  The eager RDMA fast path writes
+ * without a completion, so its peers are only seen when the bounded
+ * block times out.
+ */
+static int btl_openib_component_arm(void)
+{
+    int i, cq;
+
+    for(i = 0; i < mca_btl_openib_component.devices_count; i++) {
+        mca_btl_openib_device_t *device =
+            (mca_btl_openib_device_t *) opal_pointer_array_get_item(&mca_btl_openib_component.devices, i);
+
+        if (NULL == device || NULL == device->ib_channel) {
+            continue;
+        }
+        for (cq = BTL_OPENIB_HP_CQ; cq <= BTL_OPENIB_LP_CQ; cq++) {
+            if (NULL != device->ib_cq[cq] && ibv_req_notify_cq(device->ib_cq[cq], 0)) {
+                /* no event coming, better not block */
+                return 1;
+            }
+        }
+    }
+    return btl_openib_component_progress();
+}
+
+/* the channel woke us up: acknowledge the events, the polling follows */
+static void btl_openib_channel_event(int fd, short flags, void *arg)
+{
+    mca_btl_openib_device_t *device = (mca_btl_openib_device_t *) arg;
+    struct ibv_cq *ev_cq;
+    void *ev_ctx;
+
+    while (0 == ibv_get_cq_event(device->ib_channel, &ev_cq, &ev_ctx)) {
+        ibv_ack_cq_events(ev_cq, 1);
+    }
+}
+#endif
+
 static int btl_openib_component_progress(void)
 {
     int i;
@@ -3730,6 +4064,9 @@ static int btl_openib_component_progress(void)
         mca_btl_openib_device_t *device =
             (mca_btl_openib_device_t *) opal_pointer_array_get_item(&mca_btl_openib_component.devices, i);
         count += progress_one_device(device);
+        if (NULL != device->post_pending) {
+            mca_btl_openib_device_post_flush(device);
+        }
     }
 
 #if OMPI_CUDA_SUPPORT /* CUDA_ASYNC_SEND */
@@ -3779,23 +4116,63 @@ error:
 #endif
 }
 
+/*
+ * The reverse of btl_openib_async_srq_limit_event(): when the SRQ has been
+ * refilled srq_shrink_interval times without the device reporting that it
+ * ran low, the burst that made it grow is over and we go back to posting
+ * half as many buffers.  Buffers already posted are simply consumed; the
+ * limit event is re-armed so that the SRQ can grow again.  Called with the
+ * ib_lock held.
+ */
+static inline void btl_openib_shrink_srq(mca_btl_openib_module_t* openib_btl,
+                                         const int qp)
+{
+    mca_btl_openib_module_srq_qp_t *srq_qp = &openib_btl->qps[qp].u.srq_qp;
+    int32_t rd_init = mca_btl_openib_component.qp_infos[qp].u.srq_qp.rd_init;
+    int32_t rd_curr_num;
+
+    if (srq_qp->rd_curr_num <= rd_init ||
+        ++srq_qp->rd_quiet < (int32_t) mca_btl_openib_component.srq_shrink_interval) {
+        return;
+    }
+
+    rd_curr_num = srq_qp->rd_curr_num >> 1;
+    if (rd_curr_num < rd_init) {
+        rd_curr_num = rd_init;
+    }
+    if (0 == rd_curr_num) {
+        rd_curr_num = 1;
+    }
+    BTL_VERBOSE(("shrinking srq %d on %s from %d to %d receive buffers", qp,
+                 ibv_get_device_name(openib_btl->device->ib_dev),
+                 srq_qp->rd_curr_num, rd_curr_num));
+
+    srq_qp->rd_curr_num = rd_curr_num;
+    srq_qp->rd_low_local = rd_curr_num - (rd_curr_num >> 2);
+    srq_qp->rd_quiet = 0;
+    srq_qp->srq_limit_event_flag = true;
+}
+
 int mca_btl_openib_post_srr(mca_btl_openib_module_t* openib_btl, const int qp)
 {
-    int rd_low_local = openib_btl->qps[qp].u.srq_qp.rd_low_local;
-    int rd_curr_num = openib_btl->qps[qp].u.srq_qp.rd_curr_num;
-    int num_post, i, rc;
+    int rd_low_local, rd_curr_num, num_post, i, rc;
     struct ibv_recv_wr *bad_wr, *wr_list = NULL, *wr = NULL;
 
     assert(!BTL_OPENIB_QP_TYPE_PP(qp));
 
     OPAL_THREAD_LOCK(&openib_btl->ib_lock);
+    rd_low_local = openib_btl->qps[qp].u.srq_qp.rd_low_local;
     if(openib_btl->qps[qp].u.srq_qp.rd_posted > rd_low_local) {
         OPAL_THREAD_UNLOCK(&openib_btl->ib_lock);
         return OMPI_SUCCESS;
     }
+    if (openib_btl->qps[qp].u.srq_qp.srq_shrink) {
+        btl_openib_shrink_srq(openib_btl, qp);
+    }
+    rd_curr_num = openib_btl->qps[qp].u.srq_qp.rd_curr_num;
     num_post = rd_curr_num - openib_btl->qps[qp].u.srq_qp.rd_posted;
 
-    if (0 == num_post) {
+    if (num_post <= 0) {
         OPAL_THREAD_UNLOCK(&openib_btl->ib_lock);
         return OMPI_SUCCESS;
     }
@@ -28,6 +28,10 @@ struct mca_btl_openib_eager_rdma_local_t {
 #endif
     opal_mutex_t lock; /**< guard access to RDMA buffer */
     int32_t rd_low;
+    uint32_t last_used; /**< eager receive clock when last used */
+    volatile int32_t received; /**< fragments handled so far */
+    volatile int32_t revoke_state; /**< MCA_BTL_OPENIB_EAGER_RDMA_* */
+    int32_t revoke_count; /**< fragments the peer wrote before it stopped */
 };
 typedef struct mca_btl_openib_eager_rdma_local_t mca_btl_openib_eager_rdma_local_t;
 
@@ -39,9 +43,24 @@ struct mca_btl_openib_eager_rdma_remote_t {
 #if OPAL_ENABLE_DEBUG
     uint32_t seq;
 #endif
+    volatile int32_t sent; /**< fragments written | MCA_BTL_OPENIB_EAGER_RDMA_REVOKED */
 };
 typedef struct mca_btl_openib_eager_rdma_remote_t mca_btl_openib_eager_rdma_remote_t;
 
+/* States of a local buffer being taken back from an idle peer: the peer
+ * is asked to stop writing, answers with the number of fragments it
+ * wrote, and the buffer is released once they have all been handled. */
+#define MCA_BTL_OPENIB_EAGER_RDMA_ACTIVE   0
+#define MCA_BTL_OPENIB_EAGER_RDMA_REVOKING 1
+#define MCA_BTL_OPENIB_EAGER_RDMA_ACKED    2
+#define MCA_BTL_OPENIB_EAGER_RDMA_RELEASED 3
+
+/* Set in the sent counter of the remote buffer once the peer took it
+ * back, so that counting a write and noticing the revocation is a
+ * single atomic operation. */
+#define MCA_BTL_OPENIB_EAGER_RDMA_REVOKED  0x40000000
+#define MCA_BTL_OPENIB_EAGER_RDMA_COUNT(C) ((C) & (MCA_BTL_OPENIB_EAGER_RDMA_REVOKED - 1))
+
 #define MCA_BTL_OPENIB_RDMA_FRAG(F) \
     (openib_frag_type(F) == MCA_BTL_OPENIB_FRAG_EAGER_RDMA)
 
@@ -207,6 +207,66 @@ static mca_btl_openib_qp_t *endpoint_alloc_qp(void)
     return qp;
 }
 
+/*
+ * Post the send WRs chained on a QP with a single doorbell.  The WRs
+ * are unlinked whatever the outcome: the fragments are reused, and
+ * any other path posting them expects a lone WR.
+ */
+int mca_btl_openib_qp_post_flush(mca_btl_openib_qp_t *qp)
+{
+    struct ibv_send_wr *wr, *next, *bad_wr;
+    int rc;
+
+    if(0 == qp->post_count)
+        return 0;
+
+    rc = ibv_post_send(qp->lcl_qp, qp->post_head, &bad_wr);
+
+    for(wr = qp->post_head; wr != NULL; wr = next) {
+        next = wr->next;
+        wr->next = NULL;
+    }
+    qp->post_head = qp->post_tail = NULL;
+    qp->post_count = 0;
+
+    return rc;
+}
+
+/*
+ * Post what is chained on every QP of the device.  The WRs belong to
+ * sends that were already reported as started, a failure here is
+ * fatal.
+ */
+int mca_btl_openib_device_post_flush(mca_btl_openib_device_t *device)
+{
+    mca_btl_openib_qp_t *qp;
+    int i, ret, rc = OMPI_SUCCESS;
+
+    while(NULL != (qp = device->post_pending)) {
+        device->post_pending = qp->post_next;
+        qp->post_next = NULL;
+        qp->post_linked = false;
+
+        if(0 != (ret = mca_btl_openib_qp_post_flush(qp))) {
+            BTL_ERROR(("error posting chained send WRs: %s", strerror(ret)));
+            rc = OMPI_ERROR;
+        }
+    }
+
+    if(OMPI_SUCCESS != rc) {
+        for(i = 0; i < mca_btl_openib_component.ib_num_btls; i++) {
+            mca_btl_openib_module_t *openib_btl =
+                mca_btl_openib_component.openib_btls[i];
+            if(openib_btl->device == device && NULL != openib_btl->error_cb) {
+                openib_btl->error_cb(&openib_btl->super,
+                                     MCA_BTL_ERROR_FLAGS_FATAL, NULL, NULL);
+            }
+        }
+    }
+
+    return rc;
+}
+
 static void
 endpoint_init_qp_pp(mca_btl_openib_endpoint_qp_t *ep_qp, const int qp)
 {
@@ -443,6 +503,10 @@ static void mca_btl_openib_endpoint_destruct(mca_btl_base_endpoint_t* endpoint)
         if(--endpoint->qps[qp].qp->users != 0)
             continue;
 
+        /* take the QP off the device list of chained WRs */
+        if(endpoint->qps[qp].qp->post_linked)
+            mca_btl_openib_device_post_flush(endpoint->endpoint_btl->device);
+
         if(endpoint->qps[qp].qp->lcl_qp != NULL)
             if(ibv_destroy_qp(endpoint->qps[qp].qp->lcl_qp))
                 BTL_ERROR(("Failed to destroy QP:%d\n", qp));
@@ -1001,11 +1065,21 @@ void mca_btl_openib_endpoint_connect_eager_rdma(
         mca_btl_openib_endpoint_t **p;
         OBJ_RETAIN(endpoint);
         assert(((opal_object_t*)endpoint)->obj_reference_count == 2);
+        endpoint->eager_rdma_local.last_used = device->eager_recv_clock;
+        OPAL_THREAD_ADD32(&openib_btl->eager_rdma_channels, 1);
+
+        /* reuse the slot of a revoked channel if there is one */
+        for(i = 0; i < device->eager_rdma_buffers_count; i++) {
+            if(NULL == device->eager_rdma_buffers[i] &&
+               opal_atomic_cmpset_ptr(&device->eager_rdma_buffers[i], NULL, endpoint)) {
+                return;
+            }
+        }
+
         do {
             p = &device->eager_rdma_buffers[device->eager_rdma_buffers_count];
         } while(!opal_atomic_cmpset_ptr(p, NULL, endpoint));
 
-        OPAL_THREAD_ADD32(&openib_btl->eager_rdma_channels, 1);
         /* from this point progress function starts to poll new buffer */
         OPAL_THREAD_ADD32(&device->eager_rdma_buffers_count, 1);
         return;
@@ -1022,6 +1096,154 @@ unlock_rdma_local:
     endpoint->eager_rdma_local.frags = NULL;
 }
 
+/* local callback function for completion of eager rdma revoke messages */
+static void mca_btl_openib_endpoint_eager_rdma_revoke_cb(
+    mca_btl_base_module_t* btl,
+    struct mca_btl_base_endpoint_t* endpoint,
+    struct mca_btl_base_descriptor_t* descriptor,
+    int status)
+{
+    MCA_BTL_IB_FRAG_RETURN(descriptor);
+}
+
+/* send an eager rdma revoke (or its ack) to the remote endpoint */
+static int mca_btl_openib_endpoint_send_eager_rdma_revoke(
+    mca_btl_base_endpoint_t* endpoint, uint8_t type, int32_t count)
+{
+    mca_btl_openib_module_t* openib_btl = endpoint->endpoint_btl;
+    mca_btl_openib_eager_rdma_revoke_header_t *revoke_hdr;
+    mca_btl_openib_send_control_frag_t* frag;
+    int rc;
+
+    frag = alloc_control_frag(openib_btl);
+    if(NULL == frag) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    to_base_frag(frag)->base.des_cbfunc =
+        mca_btl_openib_endpoint_eager_rdma_revoke_cb;
+    to_base_frag(frag)->base.des_cbdata = NULL;
+    to_base_frag(frag)->base.des_flags |= MCA_BTL_DES_FLAGS_PRIORITY|MCA_BTL_DES_SEND_ALWAYS_CALLBACK;
+    to_base_frag(frag)->base.order = mca_btl_openib_component.credits_qp;
+    to_base_frag(frag)->segment.base.seg_len =
+        sizeof(mca_btl_openib_eager_rdma_revoke_header_t);
+    to_com_frag(frag)->endpoint = endpoint;
+
+    frag->hdr->tag = MCA_BTL_TAG_BTL;
+    revoke_hdr = (mca_btl_openib_eager_rdma_revoke_header_t*)to_base_frag(frag)->segment.base.seg_addr.pval;
+    revoke_hdr->control.type = type;
+    revoke_hdr->count = count;
+    if(endpoint->nbo) {
+        BTL_OPENIB_EAGER_RDMA_REVOKE_HEADER_HTON((*revoke_hdr));
+    }
+
+    rc = mca_btl_openib_endpoint_send(endpoint, frag);
+    if (OMPI_SUCCESS == rc || OMPI_ERR_RESOURCE_BUSY == rc)
+        return OMPI_SUCCESS;
+
+    MCA_BTL_IB_FRAG_RETURN(frag);
+    BTL_ERROR(("Error sending eager RDMA revoke: %s", strerror(errno)));
+    return rc;
+}
+
+/* Take the local eager rdma buffer back from an idle peer.  It keeps
+ * being polled until the peer has stopped writing to it and every
+ * fragment it wrote has been handled. */
+void mca_btl_openib_endpoint_revoke_eager_rdma(
+        mca_btl_openib_endpoint_t* endpoint)
+{
+    if(!opal_atomic_cmpset_32(&endpoint->eager_rdma_local.revoke_state,
+                              MCA_BTL_OPENIB_EAGER_RDMA_ACTIVE,
+                              MCA_BTL_OPENIB_EAGER_RDMA_REVOKING))
+        return;
+
+    /* never set it up again: credits returned for the old buffer may
+       still be on their way */
+    endpoint->use_eager_rdma = false;
+
+    BTL_VERBOSE(("revoking the eager RDMA buffer of an idle peer"));
+    if(OMPI_SUCCESS != mca_btl_openib_endpoint_send_eager_rdma_revoke(endpoint,
+                MCA_BTL_OPENIB_CONTROL_RDMA_REVOKE, 0)) {
+        endpoint->eager_rdma_local.revoke_state = MCA_BTL_OPENIB_EAGER_RDMA_ACTIVE;
+    }
+}
+
+/* The peer took its buffer back: stop writing to it and tell the peer
+ * how many fragments were written */
+void mca_btl_openib_endpoint_eager_rdma_revoked(
+        mca_btl_openib_endpoint_t* endpoint)
+{
+    int32_t sent;
+
+    do {
+        sent = endpoint->eager_rdma_remote.sent;
+    } while(!opal_atomic_cmpset_32(&endpoint->eager_rdma_remote.sent, sent,
+                                   sent | MCA_BTL_OPENIB_EAGER_RDMA_REVOKED));
+
+    (void) mca_btl_openib_endpoint_send_eager_rdma_revoke(endpoint,
+            MCA_BTL_OPENIB_CONTROL_RDMA_REVOKE_ACK,
+            MCA_BTL_OPENIB_EAGER_RDMA_COUNT(sent));
+}
+
+void mca_btl_openib_endpoint_eager_rdma_revoke_acked(
+        mca_btl_openib_endpoint_t* endpoint, int32_t count)
+{
+    endpoint->eager_rdma_local.revoke_count = count;
+    if(!opal_atomic_cmpset_32(&endpoint->eager_rdma_local.revoke_state,
+                              MCA_BTL_OPENIB_EAGER_RDMA_REVOKING,
+                              MCA_BTL_OPENIB_EAGER_RDMA_ACKED))
+        return;
+
+    mca_btl_openib_endpoint_eager_rdma_release(endpoint);
+}
+
+/* Release a revoked local buffer once the fragments the peer wrote have
+ * all been handled.  Called when the ack arrives and after each
+ * fragment handled while the buffer is being revoked. */
+void mca_btl_openib_endpoint_eager_rdma_release(
+        mca_btl_openib_endpoint_t* endpoint)
+{
+    mca_btl_openib_module_t* openib_btl = endpoint->endpoint_btl;
+    mca_btl_openib_device_t *device = openib_btl->device;
+    mca_btl_openib_recv_frag_t *headers_buf;
+    void *buf;
+    int i;
+
+    if(MCA_BTL_OPENIB_EAGER_RDMA_ACKED != endpoint->eager_rdma_local.revoke_state ||
+       MCA_BTL_OPENIB_EAGER_RDMA_COUNT(endpoint->eager_rdma_local.received) !=
+       endpoint->eager_rdma_local.revoke_count ||
+       !opal_atomic_cmpset_32(&endpoint->eager_rdma_local.revoke_state,
+                              MCA_BTL_OPENIB_EAGER_RDMA_ACKED,
+                              MCA_BTL_OPENIB_EAGER_RDMA_RELEASED))
+        return;
+
+    for(i = 0; i < device->eager_rdma_buffers_count; i++) {
+        if(device->eager_rdma_buffers[i] == endpoint) {
+            device->eager_rdma_buffers[i] = NULL;
+            break;
+        }
+    }
+
+    /* the progress function may have picked the endpoint up already,
+       it checks the frags under the lock */
+    OPAL_THREAD_LOCK(&endpoint->eager_rdma_local.lock);
+    headers_buf = endpoint->eager_rdma_local.frags;
+    buf = endpoint->eager_rdma_local.base.pval;
+    endpoint->eager_rdma_local.frags = NULL;
+    endpoint->eager_rdma_local.base.pval = NULL;
+    endpoint->eager_rdma_local.credits = 0;
+    OPAL_THREAD_UNLOCK(&endpoint->eager_rdma_local.lock);
+
+    openib_btl->super.btl_mpool->mpool_free(openib_btl->super.btl_mpool,
+           buf, (mca_mpool_base_registration_t*)endpoint->eager_rdma_local.reg);
+    endpoint->eager_rdma_local.reg = NULL;
+    free(headers_buf);
+
+    OPAL_THREAD_ADD32(&openib_btl->eager_rdma_channels, -1);
+    OPAL_THREAD_ADD32(&device->non_eager_rdma_endpoints, 1);
+    OBJ_RELEASE(endpoint);
+}
+
 /*
  * Invoke an error on the btl associated with an endpoint.  If we
  * don't have an endpoint, then just use the first one on the
@@ -139,6 +139,12 @@ typedef struct mca_btl_openib_qp_t {
     int wqe_count;
     int users;
     opal_mutex_t lock;
+    /** send WRs chained for a single doorbell, not posted yet */
+    struct ibv_send_wr *post_head, *post_tail;
+    int post_count;
+    /** on the list of the device QPs with chained WRs */
+    bool post_linked;
+    struct mca_btl_openib_qp_t *post_next;
 } mca_btl_openib_qp_t;
 
 typedef struct mca_btl_openib_endpoint_qp_t {
@@ -223,8 +229,10 @@ struct mca_btl_base_endpoint_t {
         info */
     struct ib_address_t *ib_addr;
 
-    /** number of eager received */
+    /** number of eager received (in the current window) */
     int32_t eager_recv_count;
+    /** device eager receive clock when the window started */
+    uint32_t eager_recv_window;
     /** info about remote RDMA buffer */
     mca_btl_openib_eager_rdma_remote_t eager_rdma_remote;
     /** info about local RDMA buffer */
@@ -329,6 +337,11 @@ int mca_btl_openib_endpoint_post_send(mca_btl_openib_endpoint_t*,
         mca_btl_openib_send_frag_t*);
 void mca_btl_openib_endpoint_send_credits(mca_btl_base_endpoint_t*, const int);
 void mca_btl_openib_endpoint_connect_eager_rdma(mca_btl_openib_endpoint_t*);
+void mca_btl_openib_endpoint_revoke_eager_rdma(mca_btl_openib_endpoint_t*);
+void mca_btl_openib_endpoint_eager_rdma_revoked(mca_btl_openib_endpoint_t*);
+void mca_btl_openib_endpoint_eager_rdma_revoke_acked(mca_btl_openib_endpoint_t*,
+                                                     int32_t count);
+void mca_btl_openib_endpoint_eager_rdma_release(mca_btl_openib_endpoint_t*);
 int mca_btl_openib_endpoint_post_recvs(mca_btl_openib_endpoint_t*);
 void mca_btl_openib_endpoint_send_cts(mca_btl_openib_endpoint_t *endpoint);
 void mca_btl_openib_endpoint_cpc_complete(mca_btl_openib_endpoint_t*);
@@ -522,14 +535,75 @@ ib_send_flags(uint32_t size, mca_btl_openib_endpoint_qp_t *qp, int do_signal)
 static inline int
 acquire_eager_rdma_send_credit(mca_btl_openib_endpoint_t *endpoint)
 {
+    int32_t sent;
+
     if(OPAL_THREAD_ADD32(&endpoint->eager_rdma_remote.tokens, -1) < 0) {
         OPAL_THREAD_ADD32(&endpoint->eager_rdma_remote.tokens, 1);
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
 
+    /* count the write, unless the peer has taken its buffer back */
+    do {
+        sent = endpoint->eager_rdma_remote.sent;
+        if(OPAL_UNLIKELY(sent & MCA_BTL_OPENIB_EAGER_RDMA_REVOKED)) {
+            OPAL_THREAD_ADD32(&endpoint->eager_rdma_remote.tokens, 1);
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        if(!opal_using_threads()) {
+            endpoint->eager_rdma_remote.sent = MCA_BTL_OPENIB_EAGER_RDMA_COUNT(sent + 1);
+            break;
+        }
+    } while(!opal_atomic_cmpset_32(&endpoint->eager_rdma_remote.sent, sent,
+                                   MCA_BTL_OPENIB_EAGER_RDMA_COUNT(sent + 1)));
+
     return OMPI_SUCCESS;
 }
 
+int mca_btl_openib_qp_post_flush(mca_btl_openib_qp_t *qp);
+int mca_btl_openib_device_post_flush(mca_btl_openib_device_t *device);
+
+/*
+ * Doorbell batching: with post_batch > 1 the send WRs of a QP are
+ * chained and handed to a single ibv_post_send, one doorbell, once
+ * post_batch of them are queued or at the end of the progress
+ * iteration. Only a WR whose fragment stays with the BTL until its
+ * completion (signaled) may wait in the chain; any other is posted
+ * right away along with the chain ahead of it, which keeps the order
+ * of the QP.
+ */
+static inline int qp_post_wr(mca_btl_openib_endpoint_t *ep, const int qp,
+                             struct ibv_send_wr *sr_desc)
+{
+    mca_btl_openib_qp_t *ib_qp = ep->qps[qp].qp;
+    mca_btl_openib_device_t *device;
+    struct ibv_send_wr *bad_wr;
+
+    if (mca_btl_openib_component.post_batch <= 1) {
+        return ibv_post_send(ib_qp->lcl_qp, sr_desc, &bad_wr);
+    }
+
+    sr_desc->next = NULL;
+    if (0 == ib_qp->post_count) {
+        ib_qp->post_head = sr_desc;
+    } else {
+        ib_qp->post_tail->next = sr_desc;
+    }
+    ib_qp->post_tail = sr_desc;
+    ib_qp->post_count++;
+
+    if ((sr_desc->send_flags & IBV_SEND_SIGNALED) &&
+        ib_qp->post_count < mca_btl_openib_component.post_batch) {
+        if (!ib_qp->post_linked) {
+            device = ep->endpoint_btl->device;
+            ib_qp->post_next = device->post_pending;
+            device->post_pending = ib_qp;
+            ib_qp->post_linked = true;
+        }
+        return 0;
+    }
+    return mca_btl_openib_qp_post_flush(ib_qp);
+}
+
 static inline int post_send(mca_btl_openib_endpoint_t *ep,
         mca_btl_openib_send_frag_t *frag, const bool rdma, int do_signal)
 {
@@ -537,7 +611,6 @@ static inline int post_send(mca_btl_openib_endpoint_t *ep,
     mca_btl_openib_segment_t *seg = &to_base_frag(frag)->segment;
     struct ibv_sge *sg = &to_com_frag(frag)->sg_entry;
     struct ibv_send_wr *sr_desc = &to_out_frag(frag)->sr_desc;
-    struct ibv_send_wr *bad_wr;
     int qp = to_base_frag(frag)->base.order;
 
     sg->length = seg->base.seg_len + sizeof(mca_btl_openib_header_t) +
@@ -607,7 +680,7 @@ static inline int post_send(mca_btl_openib_endpoint_t *ep,
         qp_inc_inflight_wqe(ep, qp, to_com_frag(frag));
     }
 
-    return ibv_post_send(ep->qps[qp].qp->lcl_qp, sr_desc, &bad_wr);
+    return qp_post_wr(ep, qp, sr_desc);
 }
 
 END_C_DECLS
@@ -37,6 +37,7 @@
 #include "opal/mca/event/event.h"
 #include "opal/util/output.h"
 #include "opal/util/fd.h"
+#include "opal/mca/hwloc/base/base.h"
 
 #include "ompi/constants.h"
 
@@ -364,6 +365,10 @@ static void *service_thread_start(void *context)
     opal_list_item_t *item;
     registered_item_t *ri;
 
+#if OPAL_HAVE_HWLOC
+    (void) opal_hwloc_base_bind_helper_thread("openib fd service");
+#endif
+
     /* Make an fd set that we can select() on */
     FD_ZERO(&write_fds);
     FD_ZERO(&read_fds);
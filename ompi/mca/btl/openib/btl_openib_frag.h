@@ -193,6 +193,8 @@ typedef struct mca_btl_openib_footer_t mca_btl_openib_footer_t;
 #define MCA_BTL_OPENIB_CONTROL_EP_BROKEN    4
 #define MCA_BTL_OPENIB_CONTROL_EP_EAGER_RDMA_ERROR 5
 #endif
+#define MCA_BTL_OPENIB_CONTROL_RDMA_REVOKE     6
+#define MCA_BTL_OPENIB_CONTROL_RDMA_REVOKE_ACK 7
 
 struct mca_btl_openib_control_header_t {
     uint8_t  type;
@@ -222,6 +224,22 @@ typedef struct mca_btl_openib_eager_rdma_header_t mca_btl_openib_eager_rdma_head
     } while (0)
 
 
+struct mca_btl_openib_eager_rdma_revoke_header_t {
+    mca_btl_openib_control_header_t control;
+    int32_t count; /**< ack only: eager RDMA fragments written */
+};
+typedef struct mca_btl_openib_eager_rdma_revoke_header_t mca_btl_openib_eager_rdma_revoke_header_t;
+
+#define BTL_OPENIB_EAGER_RDMA_REVOKE_HEADER_HTON(h)   \
+    do {                                              \
+        (h).count = htonl((h).count);                 \
+    } while (0)
+
+#define BTL_OPENIB_EAGER_RDMA_REVOKE_HEADER_NTOH(h)   \
+    do {                                              \
+        (h).count = ntohl((h).count);                 \
+    } while (0)
+
 struct mca_btl_openib_rdma_credits_header_t {
     mca_btl_openib_control_header_t control;
 #if OMPI_OPENIB_PAD_HDR
@@ -30,7 +30,11 @@
 #include "opal/mca/installdirs/installdirs.h"
 #include "opal/util/output.h"
 #include "opal/util/show_help.h"
+#include "opal/mca/base/mca_base_pvar.h"
+#include "ompi/mca/rte/rte.h"
 #include "btl_openib.h"
+#include "btl_openib_endpoint.h"
+#include "btl_openib_proc.h"
 #include "btl_openib_mca.h"
 #include "btl_openib_ini.h"
 #include "connect/base.h"
@@ -211,6 +215,53 @@ static int reg_bool(const char* param_name,
     return OMPI_SUCCESS;
 }
 
+/*
+ * eager_rdma_memory pvar: bytes of local eager RDMA buffers held for
+ * each peer, indexed by its rank in the job
+ */
+static int eager_rdma_memory_notify(mca_base_pvar_t *pvar, mca_base_pvar_event_t event,
+                                    void *obj, int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        *count = (int) ompi_process_info.num_procs;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int eager_rdma_memory_get(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    unsigned long *values = (unsigned long *) value;
+    mca_btl_openib_device_t *device;
+    mca_btl_openib_endpoint_t *ep;
+    ompi_process_name_t *name;
+    int i, j;
+
+    memset(values, 0, ompi_process_info.num_procs * sizeof(unsigned long));
+
+    for (i = 0 ; i < mca_btl_openib_component.devices_count ; ++i) {
+        device = (mca_btl_openib_device_t *)
+            opal_pointer_array_get_item(&mca_btl_openib_component.devices, i);
+        if (NULL == device || NULL == device->eager_rdma_buffers) {
+            continue;
+        }
+        for (j = 0 ; j < device->eager_rdma_buffers_count ; ++j) {
+            ep = device->eager_rdma_buffers[j];
+            if (NULL == ep) {
+                continue;
+            }
+            name = &ep->endpoint_proc->proc_ompi->proc_name;
+            if (name->jobid == OMPI_PROC_MY_NAME->jobid &&
+                name->vpid < ompi_process_info.num_procs) {
+                values[name->vpid] += (unsigned long) ep->endpoint_btl->eager_rdma_frag_size *
+                    mca_btl_openib_component.eager_rdma_num;
+            }
+        }
+    }
+
+    return OMPI_SUCCESS;
+}
+
 /*
  * Register and check all MCA parameters
  */
@@ -257,6 +308,11 @@ int btl_openib_register_mca_params(void)
                   "(0 = warn, but do not abort; any other value = warn and abort)",
                   false, &mca_btl_openib_component.abort_not_enough_reg_mem));
 
+    CHECK(reg_bool("odp", NULL,
+                  "Register the whole address space once per device with implicit on-demand paging (the HCA faults the pages in) instead of pinning each buffer.  Memory registration becomes free and the free/munmap hooks are not needed.  Devices without implicit on-demand paging support are not used "
+                  "(0 = pin the buffers; any other value = use on-demand paging)",
+                  false, &mca_btl_openib_component.use_odp));
+
     CHECK(reg_uint("poll_cq_batch", NULL,
                    "Retrieve up to poll_cq_batch completions from CQ",
                    MCA_BTL_OPENIB_CQ_POLL_BATCH_DEFAULT, &mca_btl_openib_component.cq_poll_batch,
@@ -412,6 +468,14 @@ int btl_openib_register_mca_params(void)
                    "(must be >= 0 and <= 15)",
                    0, &mca_btl_openib_component.ib_service_level, 0));
 
+    CHECK(reg_string("ib_service_levels", NULL,
+                     "Comma-separated list of InfiniBand service levels that the BTLs "
+                     "of a port (one per LID, see btl_openib_max_lmc, times "
+                     "btl_openib_btls_per_lid) use in turn, so that the large "
+                     "messages striped across them by the PML take distinct paths "
+                     "(empty = all use btl_openib_ib_service_level)",
+                     NULL, &mca_btl_openib_component.ib_service_levels, 0));
+
 #if (ENABLE_DYNAMIC_SL)
     CHECK(reg_uint("ib_path_record_service_level", NULL,
                    "Enable getting InfiniBand service level from PathRecord "
@@ -438,6 +502,31 @@ int btl_openib_register_mca_params(void)
                   "(must be >= 0)",
                   16, &mca_btl_openib_component.max_eager_rdma, REGINT_GE_ZERO));
 
+    CHECK(reg_int("eager_rdma_window", NULL, "Number of eager receives on a "
+                  "device forming one window: a peer gets RDMA for short "
+                  "messages once it sends btl_openib_eager_rdma_threshold "
+                  "messages within a window, and the channels of idle peers "
+                  "are revoked for busier ones "
+                  "(0 = count the messages forever and never revoke, "
+                  "must be >= 0)",
+                  0, &mca_btl_openib_component.eager_rdma_window, REGINT_GE_ZERO));
+
+    CHECK(reg_int("eager_rdma_idle_windows", NULL, "Number of windows "
+                  "(btl_openib_eager_rdma_window) without a short message "
+                  "before the RDMA channel of a peer may be revoked "
+                  "(must be >= 1)",
+                  2, &mca_btl_openib_component.eager_rdma_idle_windows, REGINT_GE_ONE));
+
+    (void) mca_base_component_pvar_register(&mca_btl_openib_component.super.btl_version,
+                                            "eager_rdma_memory", "Bytes of eager RDMA "
+                                            "buffers held for each peer, indexed by rank",
+                                            OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE,
+                                            MCA_BASE_VAR_TYPE_UNSIGNED_LONG, NULL,
+                                            MPI_T_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            eager_rdma_memory_get, NULL,
+                                            eager_rdma_memory_notify, NULL);
+
     CHECK(reg_int("eager_rdma_num", NULL, "Number of RDMA buffers to allocate "
                   "for small messages "
                   "(must be >= 1)",
@@ -494,8 +583,16 @@ int btl_openib_register_mca_params(void)
                    "Enable/Disable on demand SRQ resize. "
                    "(0 = without resizing, nonzero = with resizing)", 1,
                    &mca_btl_openib_component.enable_srq_resize));
+
+    CHECK(reg_uint("srq_shrink_interval", NULL,
+                   "With enable_srq_resize, number of refills of a grown SRQ "
+                   "without a limit event after which the number of posted receive "
+                   "buffers is halved again, down to the initial value "
+                   "(0 = never shrink)",
+                   1024, &mca_btl_openib_component.srq_shrink_interval, 0));
 #else
     mca_btl_openib_component.enable_srq_resize = false;
+    mca_btl_openib_component.srq_shrink_interval = 0;
 #endif
 
     CHECK(reg_uint("buffer_alignment", NULL,
@@ -513,6 +610,16 @@ int btl_openib_register_mca_params(void)
     CHECK(reg_uint("eager_rdma_poll_ratio", NULL,
                    "How often to poll eager RDMA channel versus CQ",
                    100, &mca_btl_openib_component.eager_rdma_poll_ratio, REGINT_GE_ONE));
+    CHECK(reg_bool("exclusive_poll", NULL,
+                   "When MPI threads are used, whether a single thread at a time polls a device, "
+                   "the others returning from the progress engine instead of waiting on the "
+                   "completion queue locks (0 = no, 1 = yes)",
+                   true, &mca_btl_openib_component.exclusive_poll));
+    CHECK(reg_int("post_batch", NULL,
+                  "Number of send work requests chained on a QP and posted with a single "
+                  "doorbell; the chain is also posted at the end of every progress call. "
+                  "Ignored when MPI threads are used (1 = post every request at once)",
+                  1, &mca_btl_openib_component.post_batch, REGINT_GE_ONE));
     CHECK(reg_uint("hp_cq_poll_per_progress", NULL,
                   "Max number of completion events to process for each call "
                   "of BTL progress engine",
@@ -592,6 +699,23 @@ int btl_openib_register_mca_params(void)
         return OMPI_ERROR;
     }
 
+#if HAVE_XRC
+    /* same queues, shared between the processes of a node */
+    asprintf(&mca_btl_openib_component.default_xrc_recv_qps,
+             "X,128,256,192,128:X,%u,1024,1008,64:X,%u,1024,1008,64:X,%u,1024,1008,64",
+             mid_qp_size,
+             (uint32_t)mca_btl_openib_module.super.btl_eager_limit,
+             (uint32_t)mca_btl_openib_module.super.btl_max_send_size);
+
+    CHECK(reg_bool("xrc_by_default", NULL,
+                   "Use XRC receive queues (one receive QP per remote node rather than one QP per remote process) "
+                   "when btl_openib_receive_queues is not set, no INI file sets it, and every device supports XRC "
+                   "(0 = use the per-peer default queues; any other value = use XRC when possible)",
+                   true, &mca_btl_openib_component.xrc_by_default));
+#else
+    mca_btl_openib_component.xrc_by_default = false;
+#endif
+
     CHECK(reg_string("receive_queues", NULL,
                      "Colon-delimited, comma-delimited list of receive queues: P,4096,8,6,4:P,32768,8,6,4",
                      default_qps, &mca_btl_openib_component.receive_queues,
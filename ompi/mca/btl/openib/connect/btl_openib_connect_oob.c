@@ -316,7 +316,7 @@ static int qp_connect_all(mca_btl_openib_endpoint_t *endpoint)
         attr.ah_attr.dlid          = endpoint->rem_info.rem_lid;
         attr.ah_attr.src_path_bits = openib_btl->src_path_bits;
         attr.ah_attr.port_num      = openib_btl->port_num;
-        attr.ah_attr.sl            = mca_btl_openib_component.ib_service_level;
+        attr.ah_attr.sl            = openib_btl->service_level;
 
 #if (ENABLE_DYNAMIC_SL)
         /* if user enabled dynamic SL, get it from PathRecord */
@@ -1045,7 +1045,7 @@ static inline int udcm_rc_qp_to_rtr (mca_btl_base_endpoint_t *lcl_ep,
     attr.ah_attr.dlid          = lcl_ep->rem_info.rem_lid;
     attr.ah_attr.src_path_bits = btl->src_path_bits;
     attr.ah_attr.port_num      = btl->port_num;
-    attr.ah_attr.sl            = mca_btl_openib_component.ib_service_level;
+    attr.ah_attr.sl            = btl->service_level;
     attr.ah_attr.static_rate   = 0;
 
 #if (ENABLE_DYNAMIC_SL)
@@ -481,7 +481,7 @@ static int xoob_send_qp_connect(mca_btl_openib_endpoint_t *endpoint, mca_btl_ope
     attr.ah_attr.src_path_bits = openib_btl->src_path_bits;
     attr.ah_attr.port_num      = openib_btl->port_num;
     attr.ah_attr.static_rate   = 0;
-    attr.ah_attr.sl            = mca_btl_openib_component.ib_service_level;
+    attr.ah_attr.sl            = openib_btl->service_level;
 
 #if (ENABLE_DYNAMIC_SL)
     /* if user enabled dynamic SL, get it from PathRecord */
@@ -596,7 +596,7 @@ static int xoob_recv_qp_create(mca_btl_openib_endpoint_t *endpoint, mca_btl_open
     attr.ah_attr.src_path_bits = openib_btl->src_path_bits;
     attr.ah_attr.port_num      = openib_btl->port_num;
     attr.ah_attr.static_rate   = 0;
-    attr.ah_attr.sl            = mca_btl_openib_component.ib_service_level;
+    attr.ah_attr.sl            = openib_btl->service_level;
 
 #if (ENABLE_DYNAMIC_SL)
     /* if user enabled dynamic SL, get it from PathRecord */
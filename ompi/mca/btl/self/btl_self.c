@@ -62,7 +62,8 @@ mca_btl_base_module_t mca_btl_self = {
     mca_btl_base_dump,
     NULL, /* mpool */
     NULL, /* register error cb */
-    mca_btl_self_ft_event
+    mca_btl_self_ft_event,
+    mca_btl_self_quiesce
 };
 
 
@@ -136,9 +137,9 @@ mca_btl_base_descriptor_t* mca_btl_self_alloc(
         return NULL; 
     }
     
-    frag->segment.seg_len = size;
+    frag->segments[0].seg_len = size;
     frag->base.des_flags   = flags;
-    frag->base.des_src     = &(frag->segment);
+    frag->base.des_src     = frag->segments;
     frag->base.des_src_cnt = 1;
     return (mca_btl_base_descriptor_t*)frag;
 }
@@ -191,6 +192,35 @@ mca_btl_self_prepare_src( struct mca_btl_base_module_t* btl,
     size_t max_data = *size;
     int rc;
 
+    if( !opal_convertor_need_buffers(convertor) && reserve != 0 ) {
+        /* contiguous data after a header: the receiver unpacks straight
+           from the user buffer, which is valid until send returns */
+        MCA_BTL_SELF_FRAG_ALLOC_EAGER(frag);
+        if(OPAL_UNLIKELY(NULL == frag)) {
+            return NULL;
+        }
+        if(reserve + max_data > mca_btl_self.btl_max_send_size) {
+            max_data = mca_btl_self.btl_max_send_size - reserve;
+        }
+        iov.iov_len = max_data;
+        iov.iov_base = NULL;
+
+        rc = opal_convertor_pack(convertor, &iov, &iov_count, &max_data );
+        if(rc < 0) {
+            MCA_BTL_SELF_FRAG_RETURN_EAGER(frag);
+            return NULL;
+        }
+        frag->segments[0].seg_addr.pval = frag+1;
+        frag->segments[0].seg_len = reserve;
+        frag->segments[1].seg_addr.pval = iov.iov_base;
+        frag->segments[1].seg_len = max_data;
+        frag->base.des_flags = flags;
+        frag->base.des_src = frag->segments;
+        frag->base.des_src_cnt = (0 == max_data) ? 1 : 2;
+        *size = max_data;
+        return &frag->base;
+    }
+
     /* non-contigous data */
     if( opal_convertor_need_buffers(convertor) ||
         max_data < mca_btl_self.btl_max_send_size ||
@@ -212,8 +242,8 @@ mca_btl_self_prepare_src( struct mca_btl_base_module_t* btl,
             MCA_BTL_SELF_FRAG_RETURN_SEND(frag);
             return NULL;
         }
-        frag->segment.seg_addr.pval = frag+1;
-        frag->segment.seg_len = reserve + max_data;
+        frag->segments[0].seg_addr.pval = frag+1;
+        frag->segments[0].seg_len = reserve + max_data;
         *size = max_data;
     } else {
         MCA_BTL_SELF_FRAG_ALLOC_RDMA(frag);
@@ -229,12 +259,12 @@ mca_btl_self_prepare_src( struct mca_btl_base_module_t* btl,
             MCA_BTL_SELF_FRAG_RETURN_RDMA(frag);
             return NULL;
         }
-        frag->segment.seg_addr.lval = (uint64_t)(uintptr_t) iov.iov_base;
-        frag->segment.seg_len = max_data;
+        frag->segments[0].seg_addr.lval = (uint64_t)(uintptr_t) iov.iov_base;
+        frag->segments[0].seg_len = max_data;
         *size = max_data;
     }
     frag->base.des_flags = flags;
-    frag->base.des_src          = &frag->segment;
+    frag->base.des_src          = frag->segments;
     frag->base.des_src_cnt      = 1;
 
     return &frag->base;
@@ -264,10 +294,10 @@ mca_btl_self_prepare_dst( struct mca_btl_base_module_t* btl,
 
     /* setup descriptor to point directly to user buffer */
     opal_convertor_get_current_pointer( convertor, &ptr );
-    frag->segment.seg_addr.lval = (uint64_t)(uintptr_t) ptr;
+    frag->segments[0].seg_addr.lval = (uint64_t)(uintptr_t) ptr;
 
-    frag->segment.seg_len = reserve + max_data;
-    frag->base.des_dst = &frag->segment;
+    frag->segments[0].seg_len = reserve + max_data;
+    frag->base.des_dst = frag->segments;
     frag->base.des_dst_cnt = 1;
     frag->base.des_flags = flags;
     return &frag->base;
@@ -391,6 +421,14 @@ int mca_btl_self_rdma( struct mca_btl_base_module_t* btl,
     return OMPI_SUCCESS;
 }
 
+/**
+ * Loopback sends complete before mca_btl_self_send() returns.
+ */
+int mca_btl_self_quiesce(struct mca_btl_base_module_t* btl)
+{
+    return OMPI_SUCCESS;
+}
+
 int mca_btl_self_ft_event(int state) {
     if(OPAL_CRS_CHECKPOINT == state) {
         ;
@@ -223,6 +223,13 @@ int mca_btl_self_rdma(
  */
 int mca_btl_self_ft_event(int state);
 
+/**
+ * Local quiescence test
+ * @param btl (IN)   BTL module
+ * @return OMPI_SUCCESS, nothing is ever in flight
+ */
+int mca_btl_self_quiesce(struct mca_btl_base_module_t* btl);
+
 END_C_DECLS
 
 #endif
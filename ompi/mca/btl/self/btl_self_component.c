@@ -105,7 +105,8 @@ static int mca_btl_self_component_register(void)
     mca_btl_self.btl_rdma_pipeline_send_length = INT_MAX;
     mca_btl_self.btl_rdma_pipeline_frag_size = INT_MAX;
     mca_btl_self.btl_min_rdma_pipeline_size = 0;
-    mca_btl_self.btl_flags = MCA_BTL_FLAGS_PUT | MCA_BTL_FLAGS_SEND_INPLACE;
+    mca_btl_self.btl_flags = MCA_BTL_FLAGS_PUT | MCA_BTL_FLAGS_SEND_INPLACE |
+                             MCA_BTL_FLAGS_ADD_PROCS_ON_DEMAND;
     mca_btl_self.btl_seg_size = sizeof (mca_btl_base_segment_t);
     mca_btl_self.btl_bandwidth = 100;
     mca_btl_self.btl_latency = 0;
@@ -21,11 +21,11 @@
 
 static inline void mca_btl_self_frag_constructor(mca_btl_self_frag_t* frag)
 {
-    frag->segment.seg_addr.pval = frag+1;
-    frag->segment.seg_len       = (uint32_t)frag->size;
-    frag->base.des_src          = &frag->segment;
+    frag->segments[0].seg_addr.pval = frag+1;
+    frag->segments[0].seg_len       = (uint32_t)frag->size;
+    frag->base.des_src          = frag->segments;
     frag->base.des_src_cnt      = 1;
-    frag->base.des_dst          = &frag->segment;
+    frag->base.des_dst          = frag->segments;
     frag->base.des_dst_cnt      = 1;
     frag->base.des_flags        = 0;
 }
@@ -45,8 +45,8 @@ static void mca_btl_self_frag_send_constructor(mca_btl_self_frag_t* frag)
 static void mca_btl_self_frag_rdma_constructor(mca_btl_self_frag_t* frag)
 {
     frag->size = 0;
-    frag->segment.seg_addr.pval = frag+1;
-    frag->segment.seg_len = (uint32_t)frag->size;
+    frag->segments[0].seg_addr.pval = frag+1;
+    frag->segments[0].seg_len = (uint32_t)frag->size;
     frag->base.des_src = NULL;
     frag->base.des_src_cnt = 0;
     frag->base.des_dst = NULL;
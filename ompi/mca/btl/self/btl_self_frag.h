@@ -31,7 +31,8 @@
  */
 struct mca_btl_self_frag_t {
     mca_btl_base_descriptor_t base;
-    mca_btl_base_segment_t segment;
+    /* the second segment points to the user data of an in place send */
+    mca_btl_base_segment_t segments[2];
     struct mca_btl_base_endpoint_t *endpoint;
     size_t size;
 };
@@ -55,7 +56,7 @@ OBJ_CLASS_DECLARATION(mca_btl_self_frag_rdma_t);
 {                                                                            \
     OMPI_FREE_LIST_RETURN_MT(&mca_btl_self_component.self_frags_eager,          \
                           (ompi_free_list_item_t*)(frag));                   \
-    frag->segment.seg_addr.pval = frag+1;                                    \
+    frag->segments[0].seg_addr.pval = frag+1;                                    \
 }
 
 #define MCA_BTL_SELF_FRAG_ALLOC_SEND(frag)                              \
@@ -69,7 +70,7 @@ OBJ_CLASS_DECLARATION(mca_btl_self_frag_rdma_t);
 {                                                                            \
     OMPI_FREE_LIST_RETURN_MT( &mca_btl_self_component.self_frags_send,          \
                            (ompi_free_list_item_t*)(frag));                  \
-    frag->segment.seg_addr.pval = frag+1;                                    \
+    frag->segments[0].seg_addr.pval = frag+1;                                    \
 }
 
 #define MCA_BTL_SELF_FRAG_ALLOC_RDMA(frag)                              \
@@ -83,7 +84,7 @@ OBJ_CLASS_DECLARATION(mca_btl_self_frag_rdma_t);
 {                                                                            \
     OMPI_FREE_LIST_RETURN_MT(&mca_btl_self_component.self_frags_rdma,           \
                           (ompi_free_list_item_t*)(frag));                   \
-    frag->segment.seg_addr.pval = frag+1;                                    \
+    frag->segments[0].seg_addr.pval = frag+1;                                    \
 }
 
 #endif
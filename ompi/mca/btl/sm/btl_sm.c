@@ -51,6 +51,7 @@
 #include "ompi/class/ompi_free_list.h"
 #include "ompi/runtime/ompi_module_exchange.h"
 #include "ompi/mca/btl/btl.h"
+#include "ompi/mca/btl/base/base.h"
 #include "ompi/mca/mpool/base/base.h"
 #include "ompi/mca/mpool/sm/mpool_sm.h"
 
@@ -100,7 +101,8 @@ mca_btl_sm_t mca_btl_sm = {
         mca_btl_sm_dump,
         NULL, /* mpool */
         mca_btl_sm_register_error_cb, /* register error */
-        mca_btl_sm_ft_event
+        mca_btl_sm_ft_event,
+        mca_btl_sm_quiesce
     }
 };
 
@@ -130,6 +132,21 @@ static void *mpool_calloc(size_t nmemb, size_t size)
     return buf;
 }
 
+/* bind memory of this process to its NUMA node, when it has a single one */
+static void sm_membind_local(void *addr, size_t len)
+{
+#if OPAL_HAVE_HWLOC
+    opal_hwloc_base_memory_segment_t seg;
+
+    if (mca_btl_sm_component.membind_node < 0) {
+        return;
+    }
+    seg.mbs_start_addr = addr;
+    seg.mbs_len = len;
+    (void) opal_hwloc_base_membind(&seg, 1, mca_btl_sm_component.membind_node);
+#endif
+}
+
 static int
 setup_mpool_base_resources(mca_btl_sm_component_t *comp_ptr,
                            mca_mpool_base_resources_t *out_res)
@@ -233,6 +250,7 @@ sm_btl_first_time_init(mca_btl_sm_t *sm_btl,
     /* Assume we don't have hwloc support and fill in dummy info */
     mca_btl_sm_component.mem_node = my_mem_node = 0;
     mca_btl_sm_component.num_mem_nodes = num_mem_nodes = 1;
+    mca_btl_sm_component.membind_node = -1;
 
 #if OPAL_HAVE_HWLOC
     /* If we have hwloc support, then get accurate information */
@@ -278,6 +296,10 @@ sm_btl_first_time_init(mca_btl_sm_t *sm_btl,
                  */
                 if (1 == n_bound) {
                     mca_btl_sm_component.mem_node = my_mem_node = numa;
+                    /* nothing to gain from binding on a single node */
+                    if (num_mem_nodes > 1 && opal_hwloc_base_mem_bind_buffers) {
+                        mca_btl_sm_component.membind_node = numa;
+                    }
                 } else {
                     mca_btl_sm_component.mem_node = my_mem_node = -1;
                 }
@@ -295,9 +317,9 @@ sm_btl_first_time_init(mca_btl_sm_t *sm_btl,
         (mca_mpool_base_module_t **)calloc(num_mem_nodes,
                                            sizeof(mca_mpool_base_module_t *));
 
-    /* Disable memory binding, because each MPI process will claim pages in the
-     * mpool for their local NUMA node */
-    res->mem_node = -1;
+    /* each process claims its own arenas of the mpool, bound to its
+     * NUMA node when it is bound to a single one */
+    res->mem_node = mca_btl_sm_component.membind_node;
 
     if (OMPI_SUCCESS != (rc = setup_mpool_base_resources(m, res))) {
         free(res);
@@ -358,6 +380,7 @@ sm_btl_first_time_init(mca_btl_sm_t *sm_btl,
     /* initialize the array of fifo's "owned" by this process */
     if(NULL == (my_fifos = (sm_fifo_t*)mpool_calloc(FIFO_MAP_NUM(n), sizeof(sm_fifo_t))))
         return OMPI_ERR_OUT_OF_RESOURCE;
+    sm_membind_local(my_fifos, FIFO_MAP_NUM(n) * sizeof(sm_fifo_t));
 
     mca_btl_sm_component.shm_fifo[mca_btl_sm_component.my_smp_rank] = my_fifos;
 
@@ -374,7 +397,16 @@ sm_btl_first_time_init(mca_btl_sm_t *sm_btl,
     if(NULL == mca_btl_sm_component.mem_nodes)
         return OMPI_ERR_OUT_OF_RESOURCE;
 
-    /* initialize fragment descriptor free lists */
+    /* room for a lane from every peer */
+    mca_btl_sm_component.lanes = (sm_fifo_t **) calloc(n, sizeof(sm_fifo_t *));
+    if(NULL == mca_btl_sm_component.lanes)
+        return OMPI_ERR_OUT_OF_RESOURCE;
+
+    /* initialize fragment descriptor free lists.  The sender fills the
+     * payloads, they live on its NUMA node */
+    mca_btl_sm_component.sm_frags_eager.fl_numa_node = mca_btl_sm_component.membind_node;
+    mca_btl_sm_component.sm_frags_max.fl_numa_node = mca_btl_sm_component.membind_node;
+    mca_btl_sm_component.sm_frags_user.fl_numa_node = mca_btl_sm_component.membind_node;
 
     /* allocation will be for the fragment descriptor and payload buffer */
     length = sizeof(mca_btl_sm_frag1_t);
@@ -447,6 +479,8 @@ create_sm_endpoint(int local_proc, struct ompi_proc_t *proc)
 
     OBJ_CONSTRUCT(&ep->pending_sends, opal_list_t);
     OBJ_CONSTRUCT(&ep->endpoint_lock, opal_mutex_t);
+    ep->lane = NULL;
+    ep->lane_countdown = mca_btl_sm_component.lane_threshold;
 #if OMPI_ENABLE_PROGRESS_THREADS == 1
     sprintf(path, "%s"OPAL_PATH_SEP"sm_fifo.%lu",
             ompi_process_info.job_session_dir,
@@ -566,6 +600,18 @@ int mca_btl_sm_add_procs(
                                     mca_btl_sm_component.fifo_lazy_free);
         if(return_code != OMPI_SUCCESS)
             goto CLEANUP;
+        sm_membind_local((void *) mca_btl_sm_component.fifo[my_smp_rank][j].queue_recv,
+                         sizeof(void *) * (mca_btl_sm_component.fifo[my_smp_rank][j].mask + 1));
+    }
+
+    if (mca_btl_sm_component.membind_node >= 0) {
+        opal_output_verbose(10, ompi_btl_base_framework.framework_output,
+                            "btl:sm: local rank %d bound its fragments and receive queues "
+                            "to NUMA node %d", my_smp_rank, mca_btl_sm_component.membind_node);
+    } else {
+        opal_output_verbose(10, ompi_btl_base_framework.framework_output,
+                            "btl:sm: local rank %d leaves its buffers to the first touch",
+                            my_smp_rank);
     }
 
     opal_atomic_wmb();
@@ -1245,6 +1291,20 @@ void mca_btl_sm_dump(struct mca_btl_base_module_t* btl,
     }
 }
 
+/*
+ * A fragment goes back to the free list only once the receiver has
+ * returned it through our FIFO, so the outstanding count covers both
+ * the sends and their acknowledgements.
+ */
+int mca_btl_sm_quiesce(struct mca_btl_base_module_t* btl)
+{
+    if (0 != mca_btl_sm_component.num_outstanding_frags ||
+        0 != mca_btl_sm_component.num_pending_sends) {
+        return OMPI_ERR_RESOURCE_BUSY;
+    }
+    return OMPI_SUCCESS;
+}
+
 #if OPAL_ENABLE_FT_CR    == 0
 int mca_btl_sm_ft_event(int state) {
     return OMPI_SUCCESS;
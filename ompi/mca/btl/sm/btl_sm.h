@@ -152,6 +152,12 @@ struct mca_btl_sm_component_t {
     unsigned int fifo_size;            /**< number of FIFO queue entries */
     unsigned int fifo_lazy_free;       /**< number of reads before lazy fifo free is triggered */
     int nfifos;                        /**< number of FIFOs per receiver */
+    int lane_threshold;                /**< writes to a peer before it gets a lane, 0 for never */
+    unsigned int lane_size;            /**< number of lane queue entries */
+    int max_lanes;                     /**< maximum number of lanes a sender opens */
+    int num_lanes_out;                 /**< lanes I opened to peers */
+    volatile int num_lanes_in;         /**< lanes peers opened to me */
+    sm_fifo_t **lanes;                 /**< the lanes peers opened to me, in my address space */
     int32_t num_smp_procs;             /**< current number of smp procs on this host */
     int32_t my_smp_rank;               /**< My SMP process rank.  Used for accessing
                                         *   SMP specfic data structures. */
@@ -168,6 +174,7 @@ struct mca_btl_sm_component_t {
     int num_pending_sends;             /**< total number on all of my pending-send queues */
     int mem_node;
     int num_mem_nodes;
+    int membind_node;                  /**< NUMA node my buffers are bound to, -1 for none */
     
 #if OMPI_ENABLE_PROGRESS_THREADS == 1
     char sm_fifo_path[PATH_MAX];   /**< path to fifo used to signal this process */
@@ -542,6 +549,14 @@ extern void mca_btl_sm_dump(struct mca_btl_base_module_t* btl,
  */
 int mca_btl_sm_ft_event(int state);
 
+/**
+ * Local quiescence test
+ * @param btl (IN)   BTL module
+ * @return OMPI_SUCCESS when no fragment is pending or waiting for the
+ *         peer to return it, OMPI_ERR_RESOURCE_BUSY otherwise
+ */
+int mca_btl_sm_quiesce(struct mca_btl_base_module_t* btl);
+
 #if OMPI_ENABLE_PROGRESS_THREADS == 1
 void mca_btl_sm_component_event_thread(opal_object_t*);
 #endif
@@ -44,6 +44,7 @@
 
 #include "opal/mca/shmem/base/base.h"
 #include "opal/mca/shmem/shmem.h"
+#include "opal/mca/hwloc/base/base.h"
 #include "opal/util/bit_ops.h"
 #include "opal/util/output.h"
 #include "opal/util/show_help.h"
@@ -219,6 +220,11 @@ static int sm_register(void)
 
     mca_btl_sm_param_register_uint("fifo_lazy_free", 120, OPAL_INFO_LVL_5, &mca_btl_sm_component.fifo_lazy_free);
 
+    /* lanes: FIFOs of a single sender, opened to the peers it writes to the most */
+    mca_btl_sm_param_register_int("lane_threshold", 64, OPAL_INFO_LVL_5, &mca_btl_sm_component.lane_threshold);
+    mca_btl_sm_param_register_uint("lane_size", 1024, OPAL_INFO_LVL_5, &mca_btl_sm_component.lane_size);
+    mca_btl_sm_param_register_int("max_lanes", 16, OPAL_INFO_LVL_5, &mca_btl_sm_component.max_lanes);
+
     /* default number of extra procs to allow for future growth */
     mca_btl_sm_param_register_int("sm_extra_procs", 0, OPAL_INFO_LVL_9, &mca_btl_sm_component.sm_extra_procs);
 
@@ -229,7 +235,7 @@ static int sm_register(void)
     mca_btl_sm.super.btl_rdma_pipeline_send_length = 64*1024;
     mca_btl_sm.super.btl_rdma_pipeline_frag_size = 64*1024;
     mca_btl_sm.super.btl_min_rdma_pipeline_size = 64*1024;
-    mca_btl_sm.super.btl_flags = MCA_BTL_FLAGS_SEND;
+    mca_btl_sm.super.btl_flags = MCA_BTL_FLAGS_SEND | MCA_BTL_FLAGS_ADD_PROCS_ON_DEMAND;
     mca_btl_sm.super.btl_seg_size = sizeof (mca_btl_sm_segment_t);
     mca_btl_sm.super.btl_bandwidth = 9000;  /* Mbs */
     mca_btl_sm.super.btl_latency   = 1;     /* Microsecs */
@@ -263,6 +269,18 @@ static int mca_btl_sm_component_open(void)
     if (mca_btl_sm_component.fifo_lazy_free <= 0)
         mca_btl_sm_component.fifo_lazy_free  = 1;
 
+    /* the lanes are FIFOs too, only smaller */
+    mca_btl_sm_component.lane_size = opal_next_poweroftwo_inclusive (mca_btl_sm_component.lane_size);
+    if (mca_btl_sm_component.lane_size < 2 * mca_btl_sm_component.fifo_lazy_free)
+        mca_btl_sm_component.lane_size = opal_next_poweroftwo_inclusive (2 * mca_btl_sm_component.fifo_lazy_free);
+    if (mca_btl_sm_component.lane_threshold <= 0 || mca_btl_sm_component.max_lanes <= 0) {
+        mca_btl_sm_component.lane_threshold = 0;
+        mca_btl_sm_component.max_lanes = 0;
+    }
+    mca_btl_sm_component.num_lanes_out = 0;
+    mca_btl_sm_component.num_lanes_in = 0;
+    mca_btl_sm_component.lanes = NULL;
+
     mca_btl_sm_component.max_frag_size = mca_btl_sm.super.btl_max_send_size;
     mca_btl_sm_component.eager_limit = mca_btl_sm.super.btl_eager_limit;
 
@@ -457,6 +475,7 @@ get_mpool_res_size(int32_t max_procs,
      *   . many pointers (fifo_size of them per FIFO)
      * - eager fragments (2*n of them, allocated in sm_free_list_inc chunks)
      * - max fragments (sm_free_list_num of them)
+     * - the lanes the process may open (max_lanes of them)
      *
      * On top of all that, we sprinkle in some number of
      * "opal_cache_line_size" additions to account for some
@@ -468,7 +487,10 @@ get_mpool_res_size(int32_t max_procs,
            (2 * max_procs + mca_btl_sm_component.sm_free_list_inc) *
            (mca_btl_sm_component.eager_limit + 2 * opal_cache_line_size) +
            mca_btl_sm_component.sm_free_list_num *
-           (mca_btl_sm_component.max_frag_size + 2 * opal_cache_line_size);
+           (mca_btl_sm_component.max_frag_size + 2 * opal_cache_line_size) +
+           mca_btl_sm_component.max_lanes *
+           (sizeof(sm_fifo_t) + sizeof(void *) *
+            mca_btl_sm_component.lane_size + 4 * opal_cache_line_size);
 
     /* add something for the control structure */
     size += sizeof(mca_common_sm_module_t);
@@ -927,6 +949,10 @@ mca_btl_sm_component_init(int *num_btls,
 #if OMPI_ENABLE_PROGRESS_THREADS == 1
 void mca_btl_sm_component_event_thread(opal_object_t* thread)
 {
+#if OPAL_HAVE_HWLOC
+    (void) opal_hwloc_base_bind_helper_thread("sm fifo");
+#endif
+
     while(1) {
         unsigned char cmd;
         if(read(mca_btl_sm_component.sm_fifo_fd, &cmd, sizeof(cmd)) != sizeof(cmd)) {
@@ -970,6 +996,75 @@ void btl_sm_process_pending_sends(struct mca_btl_base_endpoint_t *ep)
     }
 } 
 
+/*
+ * Open a lane to the peer: allocate a FIFO in the shared segment and
+ * announce it in the FIFO I share with the other senders.  Nothing is
+ * lost if this fails, the shared FIFO is still there.
+ */
+void btl_sm_lane_open(struct mca_btl_base_endpoint_t *ep)
+{
+    mca_mpool_base_module_t *mpool = mca_btl_sm_component.sm_mpool;
+    sm_fifo_t *lane, *fifo;
+    int rc;
+
+    OPAL_THREAD_LOCK(&ep->endpoint_lock);
+    if (NULL != ep->lane ||
+        mca_btl_sm_component.num_lanes_out >= mca_btl_sm_component.max_lanes) {
+        OPAL_THREAD_UNLOCK(&ep->endpoint_lock);
+        return;
+    }
+
+    lane = (sm_fifo_t *) mpool->mpool_alloc(mpool, sizeof(sm_fifo_t),
+                                            opal_cache_line_size, 0, NULL);
+    if (NULL == lane) {
+        OPAL_THREAD_UNLOCK(&ep->endpoint_lock);
+        return;
+    }
+    memset(lane, 0, sizeof(sm_fifo_t));
+    if (OMPI_SUCCESS != sm_fifo_init(mca_btl_sm_component.lane_size, mpool, lane,
+                                     mca_btl_sm_component.fifo_lazy_free)) {
+        mpool->mpool_free(mpool, lane, NULL);
+        OPAL_THREAD_UNLOCK(&ep->endpoint_lock);
+        return;
+    }
+    opal_atomic_wmb();
+
+    fifo = &(mca_btl_sm_component.fifo[ep->peer_smp_rank][FIFO_MAP(ep->my_smp_rank)]);
+    opal_atomic_lock(&(fifo->head_lock));
+    rc = sm_fifo_write((void *) (VIRTUAL2RELATIVE(lane) | MCA_BTL_SM_FRAG_LANE), fifo);
+    opal_atomic_unlock(&(fifo->head_lock));
+    if (OMPI_SUCCESS != rc) {
+        /* the peer is busy, try again later */
+        mpool->mpool_free(mpool, (void *) lane->queue_recv, NULL);
+        mpool->mpool_free(mpool, lane, NULL);
+        ep->lane_countdown = mca_btl_sm_component.lane_threshold;
+        OPAL_THREAD_UNLOCK(&ep->endpoint_lock);
+        return;
+    }
+    MCA_BTL_SM_SIGNAL_PEER(ep);
+
+    ep->lane = lane;
+    OPAL_THREAD_ADD32(&mca_btl_sm_component.num_lanes_out, 1);
+    OPAL_THREAD_UNLOCK(&ep->endpoint_lock);
+}
+
+/* start reading a lane a peer announced */
+static void btl_sm_lane_accept(sm_fifo_t *lane)
+{
+    OPAL_THREAD_LOCK(&mca_btl_sm_component.sm_lock);
+    if (mca_btl_sm_component.num_lanes_in < mca_btl_sm_component.sm_max_procs) {
+        /* the sender set up the queue in its address space */
+        lane->queue_recv = (volatile void **) RELATIVE2VIRTUAL(lane->queue);
+        mca_btl_sm_component.lanes[mca_btl_sm_component.num_lanes_in] = lane;
+        opal_atomic_wmb();
+        mca_btl_sm_component.num_lanes_in++;
+    } else {
+        opal_output(0, "mca_btl_sm_component_progress: rank %d got more lanes than peers\n",
+                    mca_btl_sm_component.my_smp_rank);
+    }
+    OPAL_THREAD_UNLOCK(&mca_btl_sm_component.sm_lock);
+}
+
 int mca_btl_sm_component_progress(void)
 {
     /* local variables */
@@ -979,7 +1074,7 @@ int mca_btl_sm_component_progress(void)
     sm_fifo_t *fifo = NULL;
     mca_btl_sm_hdr_t *hdr;
     int my_smp_rank = mca_btl_sm_component.my_smp_rank;
-    int peer_smp_rank, j, rc = 0, nevents = 0;
+    int peer_smp_rank, j, nshared, rc = 0, nevents = 0;
 
     /* first, deal with any pending sends */
     /* This check should be fast since we only need to check one variable. */
@@ -997,9 +1092,11 @@ int mca_btl_sm_component_progress(void)
         }
     }
 
-    /* poll each fifo */
-    for(j = 0; j < FIFO_MAP_NUM(mca_btl_sm_component.num_smp_procs); j++) {
-        fifo = &(mca_btl_sm_component.fifo[my_smp_rank][j]);
+    /* poll each fifo, then the lanes peers opened to me */
+    nshared = FIFO_MAP_NUM(mca_btl_sm_component.num_smp_procs);
+    for(j = 0; j < nshared + mca_btl_sm_component.num_lanes_in; j++) {
+        fifo = (j < nshared) ? &(mca_btl_sm_component.fifo[my_smp_rank][j]) :
+            mca_btl_sm_component.lanes[j - nshared];
       recheck_peer:
         /* aquire thread lock */
         if(opal_using_threads()) {
@@ -1023,12 +1120,18 @@ int mca_btl_sm_component_progress(void)
             case MCA_BTL_SM_FRAG_SEND:
             {
                 mca_btl_active_message_callback_t* reg;
+                if ( MCA_BTL_SM_FRAG_LANE ==
+                     ((uintptr_t)hdr & (MCA_BTL_SM_FRAG_TYPE_MASK | MCA_BTL_SM_FRAG_STATUS_MASK)) ) {
+                    btl_sm_lane_accept((sm_fifo_t *) RELATIVE2VIRTUAL((uintptr_t)hdr &
+                                                                      ~MCA_BTL_SM_FRAG_LANE));
+                    goto recheck_peer;
+                }
                 /* change the address from address relative to the shared
                  * memory address, to a true virtual address */
                 hdr = (mca_btl_sm_hdr_t *) RELATIVE2VIRTUAL(hdr);
                 peer_smp_rank = hdr->my_smp_rank;
 #if OPAL_ENABLE_DEBUG
-                if ( FIFO_MAP(peer_smp_rank) != j ) {
+                if ( j < nshared && FIFO_MAP(peer_smp_rank) != j ) {
                     opal_output(0, "mca_btl_sm_component_progress: "
                                 "rank %d got %d on FIFO %d, but this sender should send to FIFO %d\n",
                                 my_smp_rank, peer_smp_rank, j, FIFO_MAP(peer_smp_rank));
@@ -38,10 +38,16 @@ struct mca_btl_base_endpoint_t {
 #endif
     opal_list_t pending_sends; /**< pending data to send */
 
+    struct sm_fifo_t *lane;    /**< FIFO of my own on the peer, NULL while
+                                *   I share the peer's FIFO with other senders */
+    int lane_countdown;        /**< writes left before a lane is opened, <= 0
+                                *   once no lane will be opened */
+
     /** lock for concurrent access to endpoint state */
     opal_mutex_t endpoint_lock;
 
 };
 
 void btl_sm_process_pending_sends(struct mca_btl_base_endpoint_t *ep);
+void btl_sm_lane_open(struct mca_btl_base_endpoint_t *ep);
 #endif
@@ -60,11 +60,20 @@ add_pending(struct mca_btl_base_endpoint_t *ep, void *data, bool resend)
 #define FIFO_MAP(x)     ((x) & (mca_btl_sm_component.nfifos - 1))
 #define FIFO_MAP_NUM(n) ( (mca_btl_sm_component.nfifos) < (n) ? (mca_btl_sm_component.nfifos) : (n) )
 
-
+/*
+ * On top of the FIFOs above, a sender opens a lane to a peer it writes
+ * to often (lane_threshold writes): a FIFO that no other process
+ * writes to, so the sender fills it without the head lock.  Threads of
+ * the sender still take the lock among themselves.  The lane is
+ * announced through the shared FIFO, and from then on used for
+ * everything sent to that peer: the receiver only reads the lane after
+ * the announcement, so the order of the messages is kept.
+ */
 #define MCA_BTL_SM_FIFO_WRITE(endpoint_peer, my_smp_rank,               \
                               peer_smp_rank, hdr, resend, retry_pending_sends, rc)        \
 do {                                                                    \
-    sm_fifo_t* fifo = &(mca_btl_sm_component.fifo[peer_smp_rank][FIFO_MAP(my_smp_rank)]); \
+    sm_fifo_t* fifo;                                                    \
+    bool shared;                                                        \
                                                                         \
     if ( retry_pending_sends ) {                                        \
         if ( 0 < opal_list_get_size(&endpoint_peer->pending_sends) ) {  \
@@ -72,7 +81,20 @@ do {                                                                    \
         }                                                               \
     }                                                                   \
                                                                         \
-    opal_atomic_lock(&(fifo->head_lock));                               \
+    if ( OPAL_UNLIKELY(NULL == endpoint_peer->lane) &&                  \
+         0 < endpoint_peer->lane_countdown &&                           \
+         0 == --endpoint_peer->lane_countdown ) {                       \
+        btl_sm_lane_open(endpoint_peer);                                \
+    }                                                                   \
+    fifo = endpoint_peer->lane;                                         \
+    shared = (NULL == fifo);                                            \
+    if ( shared ) {                                                     \
+        fifo = &(mca_btl_sm_component.fifo[peer_smp_rank][FIFO_MAP(my_smp_rank)]); \
+    }                                                                   \
+                                                                        \
+    if ( shared || opal_using_threads() ) {                             \
+        opal_atomic_lock(&(fifo->head_lock));                           \
+    }                                                                   \
     /* post fragment */                                                 \
     if(sm_fifo_write(hdr, fifo) != OMPI_SUCCESS) {                      \
         add_pending(endpoint_peer, hdr, resend);                        \
@@ -81,7 +103,9 @@ do {                                                                    \
         MCA_BTL_SM_SIGNAL_PEER(endpoint_peer);                          \
         rc = OMPI_SUCCESS;                                              \
     }                                                                   \
-    opal_atomic_unlock(&(fifo->head_lock));                             \
+    if ( shared || opal_using_threads() ) {                             \
+        opal_atomic_unlock(&(fifo->head_lock));                         \
+    }                                                                   \
 } while(0)
 
 #endif
@@ -35,6 +35,10 @@
 
 #define MCA_BTL_SM_FRAG_STATUS_MASK ((uintptr_t)0x4)
 
+/* a SEND carrying the status bit announces a lane: the relative
+ * address of a FIFO the sender opened to me */
+#define MCA_BTL_SM_FRAG_LANE (MCA_BTL_SM_FRAG_SEND | MCA_BTL_SM_FRAG_STATUS_MASK)
+
 struct mca_btl_sm_frag_t;
 
 struct mca_btl_sm_hdr_t {
@@ -43,6 +43,7 @@
 
 #include "opal/mca/shmem/base/base.h"
 #include "opal/mca/shmem/shmem.h"
+#include "opal/mca/hwloc/base/base.h"
 #include "opal/util/bit_ops.h"
 #include "opal/util/output.h"
 #include "opal/util/show_help.h"
@@ -179,7 +180,7 @@ static int smcuda_register(void)
     mca_btl_smcuda.super.btl_rdma_pipeline_send_length = 64*1024;
     mca_btl_smcuda.super.btl_rdma_pipeline_frag_size = 64*1024;
     mca_btl_smcuda.super.btl_min_rdma_pipeline_size = 64*1024;
-    mca_btl_smcuda.super.btl_flags = MCA_BTL_FLAGS_SEND;
+    mca_btl_smcuda.super.btl_flags = MCA_BTL_FLAGS_SEND | MCA_BTL_FLAGS_ADD_PROCS_ON_DEMAND;
 #if OMPI_CUDA_SUPPORT
     mca_btl_smcuda.super.btl_flags |= MCA_BTL_FLAGS_CUDA_GET;
 #endif /* OMPI_CUDA_SUPPORT */
@@ -737,6 +738,10 @@ mca_btl_smcuda_component_init(int *num_btls,
 #if OMPI_ENABLE_PROGRESS_THREADS == 1
 void mca_btl_smcuda_component_event_thread(opal_object_t* thread)
 {
+#if OPAL_HAVE_HWLOC
+    (void) opal_hwloc_base_bind_helper_thread("smcuda fifo");
+#endif
+
     while(1) {
         unsigned char cmd;
         if(read(mca_btl_smcuda_component.sm_fifo_fd, &cmd, sizeof(cmd)) != sizeof(cmd)) {
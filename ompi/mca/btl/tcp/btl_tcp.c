@@ -56,13 +56,14 @@ mca_btl_tcp_module_t mca_btl_tcp_module = {
         mca_btl_tcp_prepare_src,
         mca_btl_tcp_prepare_dst,
         mca_btl_tcp_send,
-        NULL, /* send immediate */
+        mca_btl_tcp_sendi,
         mca_btl_tcp_put,
         NULL, /* get */ 
         mca_btl_base_dump,
         NULL, /* mpool */
         NULL, /* register error */
-        mca_btl_tcp_ft_event
+        mca_btl_tcp_ft_event,
+        mca_btl_tcp_quiesce
     }
 };
 
@@ -78,6 +79,7 @@ int mca_btl_tcp_add_procs( struct mca_btl_base_module_t* btl,
 {
     mca_btl_tcp_module_t* tcp_btl = (mca_btl_tcp_module_t*)btl;
     ompi_proc_t* my_proc; /* pointer to caller's proc structure */
+    size_t j;
     int i, rc;
 
     /* get pointer to my proc structure */
@@ -108,6 +110,22 @@ int mca_btl_tcp_add_procs( struct mca_btl_base_module_t* btl,
 
         OPAL_THREAD_LOCK(&tcp_proc->proc_lock);
 
+        /* If the peer connected to us before we were asked to reach
+         * it (see mca_btl_tcp_component_add_peer), the endpoint for
+         * this BTL instance already exists: hand it back.
+         */
+        for(j = 0; j < tcp_proc->proc_endpoint_count; j++) {
+            if(tcp_proc->proc_endpoints[j]->endpoint_btl == tcp_btl) {
+                break;
+            }
+        }
+        if(j < tcp_proc->proc_endpoint_count) {
+            opal_bitmap_set_bit(reachable, i);
+            peers[i] = tcp_proc->proc_endpoints[j];
+            OPAL_THREAD_UNLOCK(&tcp_proc->proc_lock);
+            continue;
+        }
+
         /* The btl_proc datastructure is shared by all TCP BTL
          * instances that are trying to reach this destination. 
          * Cache the peer instance on the btl_proc.
@@ -232,16 +250,27 @@ mca_btl_base_descriptor_t* mca_btl_tcp_prepare_src(
     struct iovec iov;
     uint32_t iov_count = 1;
     size_t max_data = *size;
+    bool gather = false;
     int rc;
 
     if( OPAL_UNLIKELY(max_data > UINT32_MAX) ) {  /* limit the size to what we support */
         max_data = (size_t)UINT32_MAX;
     }
+    /*
+     * non-contiguous data made of large enough blocks is not packed, the
+     * fragment references the blocks and writev gathers them.
+     */
+    if( opal_convertor_need_buffers(convertor) &&
+        (0 < mca_btl_tcp_component.tcp_gather_min_block) &&
+        (NULL != convertor->pDesc->strided) &&
+        (convertor->pDesc->strided->blen >= (size_t)mca_btl_tcp_component.tcp_gather_min_block) ) {
+        gather = true;
+    }
     /*
      * if we aren't pinning the data and the requested size is less
      * than the eager limit pack into a fragment from the eager pool
      */
-    if (max_data+reserve <= btl->btl_eager_limit) {
+    if (gather || max_data+reserve <= btl->btl_eager_limit) {
         MCA_BTL_TCP_FRAG_ALLOC_EAGER(frag);
     } else {
         /* 
@@ -258,7 +287,29 @@ mca_btl_base_descriptor_t* mca_btl_tcp_prepare_src(
     frag->segments[0].seg_len = reserve;
 
     frag->base.des_src_cnt = 1;
-    if(opal_convertor_need_buffers(convertor)) {
+    if (gather) {
+        struct iovec gather_iov[MCA_BTL_TCP_FRAG_GATHER_MAX];
+        uint32_t i;
+
+        /* the receiver still needs a fragment large enough */
+        if (max_data + reserve > btl->btl_max_send_size) {
+            max_data = btl->btl_max_send_size - reserve;
+        }
+        iov_count = MCA_BTL_TCP_FRAG_GATHER_MAX;
+        rc = opal_convertor_gather(convertor, gather_iov, &iov_count, &max_data);
+        if( OPAL_LIKELY(rc >= 0) ) {
+            for (i = 0; i < iov_count; i++) {
+                frag->segments[i + 1].seg_addr.pval = gather_iov[i].iov_base;
+                frag->segments[i + 1].seg_len = gather_iov[i].iov_len;
+            }
+            frag->base.des_src_cnt = iov_count + 1;
+        } else {
+            /* the convertor cannot describe the data, pack it */
+            gather = false;
+            iov_count = 1;
+        }
+    }
+    if (!gather && opal_convertor_need_buffers(convertor)) {
 
         if (max_data + reserve > frag->size) {
             max_data = frag->size - reserve;
@@ -274,7 +325,7 @@ mca_btl_base_descriptor_t* mca_btl_tcp_prepare_src(
         
         frag->segments[0].seg_len += max_data;
 
-    } else {
+    } else if (!gather) {
 
         iov.iov_len = max_data;
         iov.iov_base = NULL;
@@ -388,6 +439,77 @@ int mca_btl_tcp_send( struct mca_btl_base_module_t* btl,
 }
 
 
+/**
+ * Initiate an immediate send.
+ *
+ * The payload is written straight from the user buffer, so only
+ * contiguous data qualifies, and whatever the socket does not take must
+ * fit an eager fragment.  Otherwise, or while the endpoint is not
+ * connected or has sends queued, hand a descriptor back to the caller.
+ */
+
+int mca_btl_tcp_sendi( struct mca_btl_base_module_t* btl,
+                       struct mca_btl_base_endpoint_t* endpoint,
+                       struct opal_convertor_t* convertor,
+                       void* header,
+                       size_t header_size,
+                       size_t payload_size,
+                       uint8_t order,
+                       uint32_t flags,
+                       mca_btl_base_tag_t tag,
+                       mca_btl_base_descriptor_t** descriptor )
+{
+    size_t length = header_size + payload_size;
+    mca_btl_tcp_hdr_t hdr;
+    struct iovec iov[3];
+    int iov_cnt = 2, rc;
+
+    if( OPAL_UNLIKELY((length + sizeof(hdr) > btl->btl_eager_limit) ||
+                      (0 != payload_size && opal_convertor_need_buffers(convertor))) ) {
+        goto use_descriptor;
+    }
+
+    OPAL_THREAD_LOCK(&endpoint->endpoint_send_lock);
+    mca_btl_tcp_endpoint_used(endpoint);
+    if( MCA_BTL_TCP_CONNECTED != endpoint->endpoint_state ||
+        NULL != endpoint->endpoint_send_frag ) {
+        OPAL_THREAD_UNLOCK(&endpoint->endpoint_send_lock);
+        goto use_descriptor;
+    }
+
+    hdr.base.tag = tag;
+    hdr.type = MCA_BTL_TCP_HDR_TYPE_SEND;
+    hdr.count = 0;
+    hdr.size = (uint32_t)length;
+    if (endpoint->endpoint_nbo) MCA_BTL_TCP_HDR_HTON(hdr);
+    iov[0].iov_base = (IOVBASE_TYPE*)&hdr;
+    iov[0].iov_len = sizeof(hdr);
+    iov[1].iov_base = (IOVBASE_TYPE*)header;
+    iov[1].iov_len = header_size;
+    if( 0 != payload_size ) {
+        uint32_t iov_count = 1;
+        size_t max_data = payload_size;
+
+        /* no copy: the convertor points us to the user buffer */
+        iov[2].iov_base = NULL;
+        iov[2].iov_len = payload_size;
+        (void)opal_convertor_pack(convertor, &iov[2], &iov_count, &max_data);
+        iov_cnt = 3;
+    }
+    rc = mca_btl_tcp_frag_sendi((mca_btl_tcp_module_t*)btl, endpoint, iov, iov_cnt,
+                                length + sizeof(hdr));
+    OPAL_THREAD_UNLOCK(&endpoint->endpoint_send_lock);
+    if( OPAL_UNLIKELY(OMPI_SUCCESS != rc) ) {
+        *descriptor = NULL;
+    }
+    return rc;
+
+ use_descriptor:
+    *descriptor = mca_btl_tcp_alloc(btl, endpoint, order, length, flags);
+    return OMPI_ERR_RESOURCE_BUSY;
+}
+
+
 /**
  * Initiate an asynchronous put.
  *
@@ -466,6 +588,31 @@ int mca_btl_tcp_get(
 }
 
 
+/*
+ * Quiescent once every endpoint has written out its last fragment,
+ * TCP itself takes care of the delivery.
+ */
+
+int mca_btl_tcp_quiesce(struct mca_btl_base_module_t* btl)
+{
+    mca_btl_tcp_module_t* tcp_btl = (mca_btl_tcp_module_t*) btl;
+    mca_btl_tcp_endpoint_t* tcp_endpoint;
+    int rc = OMPI_SUCCESS;
+
+    OPAL_LIST_FOREACH(tcp_endpoint, &tcp_btl->tcp_endpoints, mca_btl_tcp_endpoint_t) {
+        OPAL_THREAD_LOCK(&tcp_endpoint->endpoint_send_lock);
+        if(NULL != tcp_endpoint->endpoint_send_frag ||
+           !opal_list_is_empty(&tcp_endpoint->endpoint_frags)) {
+            rc = OMPI_ERR_RESOURCE_BUSY;
+        }
+        OPAL_THREAD_UNLOCK(&tcp_endpoint->endpoint_send_lock);
+        if(OMPI_SUCCESS != rc) {
+            break;
+        }
+    }
+    return rc;
+}
+
 /*
  * Cleanup/release module resources.
  */
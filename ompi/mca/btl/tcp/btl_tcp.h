@@ -93,6 +93,22 @@ struct mca_btl_tcp_component_t {
     /* Do we want to use TCP_NODELAY? */
     int    tcp_not_use_nodelay;
 
+    int    tcp_send_batch;                  /**< max number of queued fragments gathered in a single writev */
+    int    tcp_busy_poll;                   /**< SO_BUSY_POLL timeout (usec) on the sockets, 0 to disable */
+    int    tcp_gather_min_block;            /**< smallest block of non-contiguous data sent in place, 0 to always pack */
+    int    tcp_zerocopy_limit;              /**< smallest write sent with MSG_ZEROCOPY, 0 to disable */
+    int    tcp_max_connections;             /**< open connections beyond which idle ones are closed, 0 for no limit */
+    volatile int32_t tcp_num_connections;   /**< open connections */
+    uint64_t tcp_use_clock;                 /**< ticks at every use of an endpoint, for the LRU */
+
+    /* Progress threads: the endpoints are spread over them and each one
+       drives the sockets of its endpoints from its own event base */
+    int    tcp_num_progress_threads;        /**< number of progress threads (0: use the main event base) */
+#if OPAL_ENABLE_MULTI_THREADS
+    struct mca_btl_tcp_progress_thread_t *tcp_progress_threads; /**< array of running progress threads */
+    unsigned int tcp_progress_next;         /**< next progress thread an endpoint is assigned to */
+#endif
+
     /* If btl_tcp_if_seq was specified, this is the one interface
        (name) that we're supposed to use. */
     char *tcp_if_seq;
@@ -143,6 +159,13 @@ extern mca_btl_base_module_t** mca_btl_tcp_component_init(
  */
 extern int mca_btl_tcp_component_progress(void);
 
+/**
+ * Event base an endpoint should register its socket events with:
+ * one of the progress threads (round-robin) if any are running,
+ * the main opal_event_base otherwise.
+ */
+extern opal_event_base_t* mca_btl_tcp_component_event_base(void);
+
 
 
 /**
@@ -213,6 +236,25 @@ extern int mca_btl_tcp_send(
 );
 
 
+/**
+ * Initiate an immediate send: header and payload go out with a single
+ * writev when the endpoint is connected and has nothing queued.
+ */
+
+extern int mca_btl_tcp_sendi(
+    struct mca_btl_base_module_t* btl,
+    struct mca_btl_base_endpoint_t* btl_peer,
+    struct opal_convertor_t* convertor,
+    void* header,
+    size_t header_size,
+    size_t payload_size,
+    uint8_t order,
+    uint32_t flags,
+    mca_btl_base_tag_t tag,
+    mca_btl_base_descriptor_t** descriptor
+);
+
+
 /**
  * Initiate an asynchronous put.
  *
@@ -314,5 +356,13 @@ extern mca_btl_base_descriptor_t* mca_btl_tcp_prepare_dst(
   */
 int mca_btl_tcp_ft_event(int state);
 
+/**
+ * Local quiescence test
+ * @param btl (IN)   BTL module
+ * @return OMPI_SUCCESS when no endpoint of the module has a fragment
+ *         left to write, OMPI_ERR_RESOURCE_BUSY otherwise
+ */
+int mca_btl_tcp_quiesce(struct mca_btl_base_module_t* btl);
+
 END_C_DECLS
 #endif
@@ -51,11 +51,13 @@
 #include <limits.h>
 
 #include "opal/mca/event/event.h"
+#include "opal/mca/hwloc/base/base.h"
 #include "opal/util/if.h"
 #include "opal/util/output.h"
 #include "opal/util/argv.h"
 #include "opal/util/net.h"
 #include "opal/util/show_help.h"
+#include "opal/threads/threads.h"
 
 #include "ompi/constants.h"
 #include "ompi/mca/btl/btl.h"
@@ -187,6 +189,141 @@ OBJ_CLASS_INSTANCE(
     mca_btl_tcp_event_destruct);
 
 
+#if OPAL_ENABLE_MULTI_THREADS
+/*
+ * Progress threads. Each one loops on its own event base, where the
+ * endpoints assigned to it register their socket events. The pipe keeps
+ * the base from running out of events (the loop would then spin) and is
+ * used to wake the thread up when it has to stop.
+ */
+
+struct mca_btl_tcp_progress_thread_t {
+    opal_event_base_t* event_base;
+    opal_event_t wakeup_event;
+    int wakeup_pipe[2];
+    volatile bool active;
+    opal_thread_t thread;
+};
+typedef struct mca_btl_tcp_progress_thread_t mca_btl_tcp_progress_thread_t;
+
+static void mca_btl_tcp_progress_wakeup(int fd, short flags, void* unused)
+{
+    char c;
+    (void)read(fd, &c, 1);
+}
+
+static void* mca_btl_tcp_progress_engine(opal_object_t* obj)
+{
+    mca_btl_tcp_progress_thread_t* pt = (mca_btl_tcp_progress_thread_t*)
+        ((opal_thread_t*)obj)->t_arg;
+
+#if OPAL_HAVE_HWLOC
+    (void) opal_hwloc_base_bind_helper_thread("tcp progress");
+#endif
+
+    while(pt->active) {
+        opal_event_loop(pt->event_base, OPAL_EVLOOP_ONCE);
+    }
+    return OPAL_THREAD_CANCELLED;
+}
+
+static void mca_btl_tcp_progress_threads_stop(int count)
+{
+    int i;
+    char c = 0;
+
+    for( i = 0; i < count; i++ ) {
+        mca_btl_tcp_progress_thread_t* pt = &mca_btl_tcp_component.tcp_progress_threads[i];
+
+        pt->active = false;
+        opal_atomic_wmb();
+        if(write(pt->wakeup_pipe[1], &c, 1) < 0) {
+            BTL_ERROR(("unable to wake up the progress thread: %s (%d)",
+                       strerror(errno), errno));
+        }
+        opal_thread_join(&pt->thread, NULL);
+        OBJ_DESTRUCT(&pt->thread);
+
+        opal_event_del(&pt->wakeup_event);
+        opal_event_base_free(pt->event_base);
+        close(pt->wakeup_pipe[0]);
+        close(pt->wakeup_pipe[1]);
+    }
+    free(mca_btl_tcp_component.tcp_progress_threads);
+    mca_btl_tcp_component.tcp_progress_threads = NULL;
+}
+
+static int mca_btl_tcp_progress_threads_start(void)
+{
+    int i, rc = OMPI_SUCCESS;
+
+    mca_btl_tcp_component.tcp_progress_threads = (mca_btl_tcp_progress_thread_t*)
+        calloc(mca_btl_tcp_component.tcp_num_progress_threads,
+               sizeof(mca_btl_tcp_progress_thread_t));
+    if(NULL == mca_btl_tcp_component.tcp_progress_threads) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    mca_btl_tcp_component.tcp_progress_next = 0;
+
+    /* the endpoint callbacks now run concurrently with the PML */
+    opal_set_using_threads(true);
+
+    for( i = 0; i < mca_btl_tcp_component.tcp_num_progress_threads; i++ ) {
+        mca_btl_tcp_progress_thread_t* pt = &mca_btl_tcp_component.tcp_progress_threads[i];
+
+        if(pipe(pt->wakeup_pipe) < 0) {
+            rc = OMPI_ERR_IN_ERRNO;
+            break;
+        }
+        if(NULL == (pt->event_base = opal_event_base_create())) {
+            close(pt->wakeup_pipe[0]);
+            close(pt->wakeup_pipe[1]);
+            rc = OMPI_ERR_OUT_OF_RESOURCE;
+            break;
+        }
+        opal_event_set(pt->event_base, &pt->wakeup_event, pt->wakeup_pipe[0],
+                       OPAL_EV_READ|OPAL_EV_PERSIST, mca_btl_tcp_progress_wakeup, NULL);
+        opal_event_add(&pt->wakeup_event, 0);
+
+        OBJ_CONSTRUCT(&pt->thread, opal_thread_t);
+        pt->thread.t_run = mca_btl_tcp_progress_engine;
+        pt->thread.t_arg = pt;
+        pt->active = true;
+        opal_atomic_wmb();
+        if(OPAL_SUCCESS != (rc = opal_thread_start(&pt->thread))) {
+            OBJ_DESTRUCT(&pt->thread);
+            opal_event_del(&pt->wakeup_event);
+            opal_event_base_free(pt->event_base);
+            close(pt->wakeup_pipe[0]);
+            close(pt->wakeup_pipe[1]);
+            break;
+        }
+    }
+
+    if(OMPI_SUCCESS != rc) {
+        mca_btl_tcp_progress_threads_stop(i);
+        mca_btl_tcp_component.tcp_num_progress_threads = 0;
+        return rc;
+    }
+    BTL_VERBOSE(("started %d TCP progress threads",
+                 mca_btl_tcp_component.tcp_num_progress_threads));
+    return OMPI_SUCCESS;
+}
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+
+opal_event_base_t* mca_btl_tcp_component_event_base(void)
+{
+#if OPAL_ENABLE_MULTI_THREADS
+    if(NULL != mca_btl_tcp_component.tcp_progress_threads) {
+        unsigned int i = mca_btl_tcp_component.tcp_progress_next++ %
+            (unsigned int)mca_btl_tcp_component.tcp_num_progress_threads;
+        return mca_btl_tcp_component.tcp_progress_threads[i].event_base;
+    }
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+    return opal_event_base;
+}
+
+
 /*
  * functions for receiving event callbacks
  */
@@ -223,7 +360,15 @@ static int mca_btl_tcp_component_register(void)
     char* message;
 
     /* register TCP component parameters */
-    mca_btl_tcp_param_register_uint("links", NULL, 1, OPAL_INFO_LVL_4, &mca_btl_tcp_component.tcp_num_links);
+    mca_btl_tcp_param_register_uint("links",
+        "Number of TCP connections opened to every peer on each interface, each"
+        " one a btl module of its own: large messages are striped over them,"
+        " each connection taking its own path through the fabric and, with"
+        " btl_tcp_progress_threads, its own core",
+                                    1, OPAL_INFO_LVL_4, &mca_btl_tcp_component.tcp_num_links);
+    if( 0 == mca_btl_tcp_component.tcp_num_links ) {
+        mca_btl_tcp_component.tcp_num_links = 1;
+    }
     mca_btl_tcp_param_register_string("if_include", "Comma-delimited list of devices and/or CIDR notation of networks to use for MPI communication (e.g., \"eth0,192.168.0.0/16\").  Mutually exclusive with btl_tcp_if_exclude.", "", OPAL_INFO_LVL_1, &mca_btl_tcp_component.tcp_if_include);
     mca_btl_tcp_param_register_string("if_exclude", "Comma-delimited list of devices and/or CIDR notation of networks to NOT use for MPI communication -- all devices not matching these specifications will be used (e.g., \"eth0,192.168.0.0/16\").  If set to a non-default value, it is mutually exclusive with btl_tcp_if_include.", 
                                       "127.0.0.1/8,sppp",
@@ -239,6 +384,35 @@ static int mca_btl_tcp_component_register(void)
         " used to reduce the number of syscalls, by replacing them with memcpy."
         " Every read will read the expected data plus the amount of the"
                                     " endpoint_cache", 30*1024, OPAL_INFO_LVL_4, &mca_btl_tcp_component.tcp_endpoint_cache);
+    mca_btl_tcp_param_register_int ("send_batch",
+        "Maximum number of queued fragments pushed to the socket by a single"
+        " writev (1 to write the fragments one by one)",
+                                    8, OPAL_INFO_LVL_5, &mca_btl_tcp_component.tcp_send_batch);
+    mca_btl_tcp_param_register_int ("busy_poll",
+        "Time (in microseconds) the kernel busy polls the device queue on a"
+        " blocking receive or poll of the TCP sockets (SO_BUSY_POLL, 0 to disable)",
+                                    0, OPAL_INFO_LVL_5, &mca_btl_tcp_component.tcp_busy_poll);
+    mca_btl_tcp_param_register_int ("gather_min_block",
+        "Non-contiguous data made of blocks of at least this many bytes is"
+        " handed to writev directly from the user buffer instead of being"
+        " packed (0 to always pack)",
+                                    8*1024, OPAL_INFO_LVL_5, &mca_btl_tcp_component.tcp_gather_min_block);
+    mca_btl_tcp_param_register_int ("zerocopy_limit",
+        "Writes of at least this many bytes are sent with MSG_ZEROCOPY, the kernel"
+        " reading the user buffer in place; the fragment completes when the kernel"
+        " notifies it is done with the pages (Linux only, 0 to disable)",
+                                    0, OPAL_INFO_LVL_5, &mca_btl_tcp_component.tcp_zerocopy_limit);
+    mca_btl_tcp_param_register_int ("max_connections",
+        "Number of open TCP connections beyond which the least recently used"
+        " idle ones are closed, to be opened again on the next message (0 for"
+        " no limit)",
+                                    0, OPAL_INFO_LVL_5, &mca_btl_tcp_component.tcp_max_connections);
+    mca_btl_tcp_component.tcp_num_connections = 0;
+    mca_btl_tcp_component.tcp_use_clock = 0;
+    mca_btl_tcp_param_register_int ("progress_threads",
+        "Number of threads progressing the TCP connections, the endpoints being"
+        " spread over them (0 to progress them from the main event loop)",
+                                    0, OPAL_INFO_LVL_5, &mca_btl_tcp_component.tcp_num_progress_threads);
     mca_btl_tcp_param_register_int ("use_nagle", "Whether to use Nagle's algorithm or not (using Nagle's algorithm may increase short message latency)", 0, OPAL_INFO_LVL_4, &mca_btl_tcp_component.tcp_not_use_nodelay);
     mca_btl_tcp_param_register_int( "port_min_v4", 
                                     "The minimum port where the TCP BTL will try to bind (default 1024)",
@@ -279,7 +453,8 @@ static int mca_btl_tcp_component_register(void)
                                        MCA_BTL_FLAGS_SEND_INPLACE |
                                        MCA_BTL_FLAGS_NEED_CSUM |
                                        MCA_BTL_FLAGS_NEED_ACK |
-                                       MCA_BTL_FLAGS_HETEROGENEOUS_RDMA;
+                                       MCA_BTL_FLAGS_HETEROGENEOUS_RDMA |
+                                       MCA_BTL_FLAGS_ADD_PROCS_ON_DEMAND;
     mca_btl_tcp_module.super.btl_seg_size = sizeof (mca_btl_base_segment_t);
     mca_btl_tcp_module.super.btl_bandwidth = 100;
     mca_btl_tcp_module.super.btl_latency = 100;
@@ -356,6 +531,9 @@ static int mca_btl_tcp_component_open(void)
     mca_btl_tcp_component.tcp_num_btls=0;
     mca_btl_tcp_component.tcp_addr_count = 0;
     mca_btl_tcp_component.tcp_btls=NULL;
+#if OPAL_ENABLE_MULTI_THREADS
+    mca_btl_tcp_component.tcp_progress_threads = NULL;
+#endif
     
     /* initialize objects */ 
     OBJ_CONSTRUCT(&mca_btl_tcp_component.tcp_lock, opal_mutex_t);
@@ -397,6 +575,12 @@ static int mca_btl_tcp_component_close(void)
         free(mca_btl_tcp_component.tcp_if_seq);
     }
 
+#if OPAL_ENABLE_MULTI_THREADS
+    if (NULL != mca_btl_tcp_component.tcp_progress_threads) {
+        mca_btl_tcp_progress_threads_stop(mca_btl_tcp_component.tcp_num_progress_threads);
+    }
+#endif
+
     if (NULL != mca_btl_tcp_component.tcp_btls)
         free(mca_btl_tcp_component.tcp_btls);
   
@@ -470,8 +654,11 @@ static int mca_btl_tcp_create(int if_kindex, const char* if_name)
         /* allow user to override/specify latency ranking */
         sprintf(param, "latency_%s", if_name);
         mca_btl_tcp_param_register_uint(param, NULL, btl->super.btl_latency, OPAL_INFO_LVL_5,  &btl->super.btl_latency);
+        /* the links share the interface evenly, so that the pml stripes
+           large messages evenly. The extra ones look slower to keep the
+           eager traffic on the first one */
+        btl->super.btl_bandwidth /= mca_btl_tcp_component.tcp_num_links;
         if( i > 0 ) {
-            btl->super.btl_bandwidth >>= 1;
             btl->super.btl_latency   <<= 1;
         }
 
@@ -1074,6 +1261,20 @@ mca_btl_base_module_t** mca_btl_tcp_component_init(int *num_btl_modules,
         return 0;
     }
 
+    /* start the progress threads before any endpoint gets created */
+    if(mca_btl_tcp_component.tcp_num_progress_threads > 0) {
+#if OPAL_ENABLE_MULTI_THREADS
+        if(OMPI_SUCCESS != (ret = mca_btl_tcp_progress_threads_start())) {
+            BTL_ERROR(("unable to start the progress threads (%d), "
+                       "progressing from the main event loop", ret));
+        }
+#else
+        opal_output(0, "btl_tcp_progress_threads was requested, but this "
+                    "build has no thread support; ignored");
+        mca_btl_tcp_component.tcp_num_progress_threads = 0;
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+    }
+
     btls = (mca_btl_base_module_t **)malloc(mca_btl_tcp_component.tcp_num_btls * 
                   sizeof(mca_btl_base_module_t*));
     if(NULL == btls) {
@@ -1124,6 +1325,36 @@ static void mca_btl_tcp_component_accept_handler( int incoming_sd,
 }
 
 
+/**
+ * A peer we have not been told about is connecting to us (the BML
+ * sets up its off-node peers on demand, so the peer may well know
+ * about us before we know about it). Set up our side for each TCP
+ * module; the BML is handed the same endpoints by
+ * mca_btl_tcp_add_procs when it eventually adds the peer.
+ */
+static mca_btl_tcp_proc_t* mca_btl_tcp_component_add_peer(const ompi_process_name_t* name)
+{
+    ompi_proc_t* ompi_proc = ompi_proc_find(name);
+    opal_bitmap_t reachable;
+    uint32_t i;
+
+    if(NULL == ompi_proc) {
+        return NULL;
+    }
+
+    OBJ_CONSTRUCT(&reachable, opal_bitmap_t);
+    if(OMPI_SUCCESS == opal_bitmap_init(&reachable, 1)) {
+        for(i = 0; i < mca_btl_tcp_component.tcp_num_btls; i++) {
+            mca_btl_base_endpoint_t* endpoint = NULL;
+            (void) mca_btl_tcp_add_procs(&mca_btl_tcp_component.tcp_btls[i]->super,
+                                         1, &ompi_proc, &endpoint, &reachable);
+        }
+    }
+    OBJ_DESTRUCT(&reachable);
+
+    return mca_btl_tcp_proc_lookup(name);
+}
+
 /**
  * Event callback when there is data available on the registered 
  * socket to recv. This callback is triggered only once per lifetime
@@ -1163,6 +1394,9 @@ static void mca_btl_tcp_component_recv_handler(int sd, short flags, void* user)
    
     /* lookup the corresponding process */
     btl_proc = mca_btl_tcp_proc_lookup(&guid);
+    if(NULL == btl_proc) {
+        btl_proc = mca_btl_tcp_component_add_peer(&guid);
+    }
     if(NULL == btl_proc) {
         CLOSE_THE_SOCKET(sd);
         return;
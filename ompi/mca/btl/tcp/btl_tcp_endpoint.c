@@ -79,12 +79,21 @@ static void mca_btl_tcp_endpoint_construct(mca_btl_tcp_endpoint_t* endpoint)
     endpoint->endpoint_state = MCA_BTL_TCP_CLOSED;
     endpoint->endpoint_retries = 0;
     endpoint->endpoint_nbo = false;
+    endpoint->endpoint_zerocopy = false;
+    endpoint->endpoint_zc_sent = 0;
+    endpoint->endpoint_zc_done = 0;
+    endpoint->endpoint_last_use = 0;
+    endpoint->endpoint_counted = false;
+    endpoint->endpoint_fin_ack_owed = false;
+    endpoint->endpoint_fin_ack_after = 0;
+    endpoint->endpoint_evbase = mca_btl_tcp_component_event_base();
 #if MCA_BTL_TCP_ENDPOINT_CACHE
     endpoint->endpoint_cache        = NULL;
     endpoint->endpoint_cache_pos    = NULL;
     endpoint->endpoint_cache_length = 0;
 #endif  /* MCA_BTL_TCP_ENDPOINT_CACHE */
     OBJ_CONSTRUCT(&endpoint->endpoint_frags, opal_list_t);
+    OBJ_CONSTRUCT(&endpoint->endpoint_zc_frags, opal_list_t);
     OBJ_CONSTRUCT(&endpoint->endpoint_send_lock, opal_mutex_t);
     OBJ_CONSTRUCT(&endpoint->endpoint_recv_lock, opal_mutex_t);
 }
@@ -98,6 +107,7 @@ static void mca_btl_tcp_endpoint_destruct(mca_btl_tcp_endpoint_t* endpoint)
     mca_btl_tcp_proc_remove(endpoint->endpoint_proc, endpoint);
     mca_btl_tcp_endpoint_close(endpoint);
     OBJ_DESTRUCT(&endpoint->endpoint_frags);
+    OBJ_DESTRUCT(&endpoint->endpoint_zc_frags);
     OBJ_DESTRUCT(&endpoint->endpoint_send_lock);
     OBJ_DESTRUCT(&endpoint->endpoint_recv_lock);
 }
@@ -116,6 +126,96 @@ static void mca_btl_tcp_endpoint_connected(mca_btl_base_endpoint_t*);
 static void mca_btl_tcp_endpoint_recv_handler(int sd, short flags, void* user);
 static void mca_btl_tcp_endpoint_send_handler(int sd, short flags, void* user);
 
+/*
+ * Complete a fragment that went out completely: one sent with
+ * MSG_ZEROCOPY waits for the kernel to be done with its pages.  Must be
+ * called with the send lock held, returns false if the fragment was
+ * deferred.
+ */
+static inline bool mca_btl_tcp_endpoint_frag_sent(mca_btl_base_endpoint_t* btl_endpoint,
+                                                  mca_btl_tcp_frag_t* frag)
+{
+#if MCA_BTL_TCP_HAVE_ZEROCOPY
+    if(frag->zc_pending) {
+        opal_list_append(&btl_endpoint->endpoint_zc_frags, (opal_list_item_t*)frag);
+        return false;
+    }
+#endif  /* MCA_BTL_TCP_HAVE_ZEROCOPY */
+    return true;
+}
+
+#if MCA_BTL_TCP_HAVE_ZEROCOPY
+/*
+ * Read the zerocopy notifications from the error queue of the socket
+ * and complete the fragments the kernel is done with.  TCP reports them
+ * as ranges of sends, in order, as the peer acks the data.
+ */
+static void mca_btl_tcp_endpoint_zerocopy_progress(mca_btl_base_endpoint_t* btl_endpoint)
+{
+    char control[CMSG_SPACE(sizeof(struct sock_extended_err)) * 4];
+    mca_btl_tcp_frag_t* frag;
+    opal_list_t done;
+
+    if(opal_list_is_empty(&btl_endpoint->endpoint_zc_frags)) {
+        return;
+    }
+    OBJ_CONSTRUCT(&done, opal_list_t);
+
+    OPAL_THREAD_LOCK(&btl_endpoint->endpoint_send_lock);
+    while(btl_endpoint->endpoint_sd >= 0) {
+        struct msghdr msg;
+        struct cmsghdr* cm;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if(recvmsg(btl_endpoint->endpoint_sd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            break;
+        }
+        for(cm = CMSG_FIRSTHDR(&msg); NULL != cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            struct sock_extended_err* serr = (struct sock_extended_err*)CMSG_DATA(cm);
+
+            if(!((IPPROTO_IP == cm->cmsg_level && IP_RECVERR == cm->cmsg_type)
+#if defined(IPV6_RECVERR)
+                 || (IPPROTO_IPV6 == cm->cmsg_level && IPV6_RECVERR == cm->cmsg_type)
+#endif
+                 ) || SO_EE_ORIGIN_ZEROCOPY != serr->ee_origin || 0 != serr->ee_errno) {
+                continue;
+            }
+            /* sends ee_info to ee_data are done */
+            if((int32_t)(serr->ee_data + 1 - btl_endpoint->endpoint_zc_done) > 0) {
+                btl_endpoint->endpoint_zc_done = serr->ee_data + 1;
+            }
+#if defined(SO_EE_CODE_ZEROCOPY_COPIED)
+            /* the kernel copied anyway (loopback, no scatter-gather on the
+               device): waiting for the acks is all we would get */
+            if(serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                btl_endpoint->endpoint_zerocopy = false;
+            }
+#endif
+        }
+    }
+    while(NULL != (frag = (mca_btl_tcp_frag_t*)opal_list_get_first(&btl_endpoint->endpoint_zc_frags)) &&
+          (opal_list_item_t*)frag != opal_list_get_end(&btl_endpoint->endpoint_zc_frags) &&
+          (int32_t)(frag->zc_seq - btl_endpoint->endpoint_zc_done) < 0) {
+        opal_list_remove_first(&btl_endpoint->endpoint_zc_frags);
+        opal_list_append(&done, (opal_list_item_t*)frag);
+    }
+    OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_send_lock);
+
+    while(NULL != (frag = (mca_btl_tcp_frag_t*)opal_list_remove_first(&done))) {
+        int btl_ownership = (frag->base.des_flags & MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
+
+        frag->zc_pending = false;
+        frag->base.des_cbfunc(&frag->btl->super, frag->endpoint, &frag->base, frag->rc);
+        if( btl_ownership ) {
+            MCA_BTL_TCP_FRAG_RETURN(frag);
+        }
+    }
+    OBJ_DESTRUCT(&done);
+}
+#endif  /* MCA_BTL_TCP_HAVE_ZEROCOPY */
+
 /*
  * Diagnostics: change this to "1" to enable the function
  * mca_btl_tcp_endpoint_dump(), below
@@ -213,7 +313,7 @@ static inline void mca_btl_tcp_endpoint_event_init(mca_btl_base_endpoint_t* btl_
     btl_endpoint->endpoint_cache_pos = btl_endpoint->endpoint_cache;
 #endif  /* MCA_BTL_TCP_ENDPOINT_CACHE */
 
-    opal_event_set(opal_event_base, &btl_endpoint->endpoint_recv_event, 
+    opal_event_set(btl_endpoint->endpoint_evbase, &btl_endpoint->endpoint_recv_event, 
                     btl_endpoint->endpoint_sd, 
                     OPAL_EV_READ|OPAL_EV_PERSIST, 
                     mca_btl_tcp_endpoint_recv_handler,
@@ -224,7 +324,7 @@ static inline void mca_btl_tcp_endpoint_event_init(mca_btl_base_endpoint_t* btl_
      * will be fired only once, and when the endpoint is marked as 
      * CONNECTED the event should be recreated with the correct flags.
      */
-    opal_event_set(opal_event_base, &btl_endpoint->endpoint_send_event, 
+    opal_event_set(btl_endpoint->endpoint_evbase, &btl_endpoint->endpoint_send_event, 
                     btl_endpoint->endpoint_sd, 
                     OPAL_EV_WRITE, 
                     mca_btl_tcp_endpoint_send_handler,
@@ -242,9 +342,12 @@ int mca_btl_tcp_endpoint_send(mca_btl_base_endpoint_t* btl_endpoint, mca_btl_tcp
     int rc = OMPI_SUCCESS;
 
     OPAL_THREAD_LOCK(&btl_endpoint->endpoint_send_lock);
+    mca_btl_tcp_endpoint_used(btl_endpoint);
     switch(btl_endpoint->endpoint_state) {
     case MCA_BTL_TCP_CONNECTING:
     case MCA_BTL_TCP_CONNECT_ACK:
+    case MCA_BTL_TCP_CLOSING:
+    case MCA_BTL_TCP_CLOSE_WAIT:
     case MCA_BTL_TCP_CLOSED:
         opal_list_append(&btl_endpoint->endpoint_frags, (opal_list_item_t*)frag);
         frag->base.des_flags |= MCA_BTL_DES_SEND_ALWAYS_CALLBACK;
@@ -260,6 +363,11 @@ int mca_btl_tcp_endpoint_send(mca_btl_base_endpoint_t* btl_endpoint, mca_btl_tcp
                mca_btl_tcp_frag_send(frag, btl_endpoint->endpoint_sd)) {
                 int btl_ownership = (frag->base.des_flags & MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
 
+                if(!mca_btl_tcp_endpoint_frag_sent(btl_endpoint, frag)) {
+                    frag->base.des_flags |= MCA_BTL_DES_SEND_ALWAYS_CALLBACK;
+                    OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_send_lock);
+                    return OMPI_SUCCESS;
+                }
                 OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_send_lock);
                 if( frag->base.des_flags & MCA_BTL_DES_SEND_ALWAYS_CALLBACK ) {
                     frag->base.des_cbfunc(&frag->btl->super, frag->endpoint, &frag->base, frag->rc);
@@ -310,6 +418,136 @@ static int mca_btl_tcp_endpoint_send_blocking(mca_btl_base_endpoint_t* btl_endpo
 }
 
 
+/*
+ * Closing idle connections beyond btl_tcp_max_connections.  The side
+ * closing sends a FIN once nothing is queued and holds any new send.
+ * The peer answers with a FIN_ACK after what it had queued, holds its
+ * new sends too, and closes its socket when it reads the end of the
+ * connection, so that neither side closes with data to be read.  Both
+ * reopen the connection for what was held.  When both FIN cross, the
+ * FIN of the lowest name wins.
+ */
+
+static int mca_btl_tcp_endpoint_send_ctl(mca_btl_base_endpoint_t* btl_endpoint, uint8_t type)
+{
+    mca_btl_tcp_hdr_t hdr;
+
+    hdr.base.tag = MCA_BTL_TAG_BTL;
+    hdr.type = type;
+    hdr.count = 0;
+    hdr.size = 0;
+    if(mca_btl_tcp_endpoint_send_blocking(btl_endpoint, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+        return OMPI_ERR_UNREACH;
+    }
+    return OMPI_SUCCESS;
+}
+
+/* the FIN_ACK is the last thing sent on the connection. Called with the send lock held. */
+static void mca_btl_tcp_endpoint_send_fin_ack(mca_btl_base_endpoint_t* btl_endpoint)
+{
+    btl_endpoint->endpoint_fin_ack_owed = false;
+    if(OMPI_SUCCESS == mca_btl_tcp_endpoint_send_ctl(btl_endpoint, MCA_BTL_TCP_HDR_TYPE_FIN_ACK)) {
+        btl_endpoint->endpoint_state = MCA_BTL_TCP_CLOSE_WAIT;
+        opal_event_del(&btl_endpoint->endpoint_send_event);
+    }
+}
+
+/* open the connection again if sends were held. Called with the send lock held. */
+static void mca_btl_tcp_endpoint_reopen(mca_btl_base_endpoint_t* btl_endpoint)
+{
+    if(MCA_BTL_TCP_CLOSED == btl_endpoint->endpoint_state &&
+       !opal_list_is_empty(&btl_endpoint->endpoint_frags)) {
+        (void)mca_btl_tcp_endpoint_start_connect(btl_endpoint);
+    }
+}
+
+/*
+ * A FIN or a FIN_ACK was read. Returns true if the socket is closed.
+ * Called with the recv lock held.
+ */
+static bool mca_btl_tcp_endpoint_recv_fin(mca_btl_base_endpoint_t* btl_endpoint, uint8_t type)
+{
+    bool closed = false;
+
+    OPAL_THREAD_LOCK(&btl_endpoint->endpoint_send_lock);
+    switch(btl_endpoint->endpoint_state) {
+    case MCA_BTL_TCP_CONNECTED:
+        if(MCA_BTL_TCP_HDR_TYPE_FIN != type) {
+            break;
+        }
+        if(NULL == btl_endpoint->endpoint_send_frag) {
+            mca_btl_tcp_endpoint_send_fin_ack(btl_endpoint);
+        } else {
+            /* after the frags already queued, the send handler counts them */
+            btl_endpoint->endpoint_fin_ack_owed = true;
+            btl_endpoint->endpoint_fin_ack_after =
+                1 + opal_list_get_size(&btl_endpoint->endpoint_frags);
+        }
+        break;
+    case MCA_BTL_TCP_CLOSING:
+        if(MCA_BTL_TCP_HDR_TYPE_FIN == type) {
+            /* both closing: the lowest name waits for the FIN_ACK */
+            if(ompi_rte_compare_name_fields(OMPI_RTE_CMP_ALL,
+                                            &mca_btl_tcp_proc_local()->proc_ompi->proc_name,
+                                            &btl_endpoint->endpoint_proc->proc_ompi->proc_name) > 0) {
+                mca_btl_tcp_endpoint_send_fin_ack(btl_endpoint);
+            }
+            break;
+        }
+        mca_btl_tcp_endpoint_close(btl_endpoint);
+        mca_btl_tcp_endpoint_reopen(btl_endpoint);
+        closed = true;
+        break;
+    default:
+        break;
+    }
+    OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_send_lock);
+    return closed;
+}
+
+/*
+ * Ask the peer of the least recently used idle connection to close it,
+ * when more than btl_tcp_max_connections are open.  The send lock of
+ * except is held by the caller, the others are only tried.
+ */
+static void mca_btl_tcp_endpoint_trim(mca_btl_base_endpoint_t* except)
+{
+    mca_btl_base_endpoint_t* victim = NULL;
+    opal_list_item_t* item;
+    unsigned int i;
+
+    for(i = 0; i < mca_btl_tcp_component.tcp_num_btls; i++) {
+        opal_list_t* endpoints = &mca_btl_tcp_component.tcp_btls[i]->tcp_endpoints;
+
+        for(item =  opal_list_get_first(endpoints);
+            item != opal_list_get_end(endpoints);
+            item = opal_list_get_next(item)) {
+            mca_btl_base_endpoint_t* endpoint = (mca_btl_base_endpoint_t*)item;
+
+            if(endpoint == except || MCA_BTL_TCP_CONNECTED != endpoint->endpoint_state ||
+               NULL != endpoint->endpoint_send_frag) {
+                continue;
+            }
+            if(NULL == victim || endpoint->endpoint_last_use < victim->endpoint_last_use) {
+                victim = endpoint;
+            }
+        }
+    }
+    if(NULL == victim || 0 != OPAL_THREAD_TRYLOCK(&victim->endpoint_send_lock)) {
+        return;
+    }
+    if(MCA_BTL_TCP_CONNECTED == victim->endpoint_state &&
+       NULL == victim->endpoint_send_frag && !victim->endpoint_fin_ack_owed &&
+       opal_list_is_empty(&victim->endpoint_frags) &&
+       opal_list_is_empty(&victim->endpoint_zc_frags)) {
+        if(OMPI_SUCCESS == mca_btl_tcp_endpoint_send_ctl(victim, MCA_BTL_TCP_HDR_TYPE_FIN)) {
+            victim->endpoint_state = MCA_BTL_TCP_CLOSING;
+        }
+    }
+    OPAL_THREAD_UNLOCK(&victim->endpoint_send_lock);
+}
+
+
 /*
  * Send the globally unique identifier for this process to a endpoint on 
  * a newly connected socket.
@@ -357,8 +595,12 @@ bool mca_btl_tcp_endpoint_accept(mca_btl_base_endpoint_t* btl_endpoint,
     cmpval = ompi_rte_compare_name_fields(OMPI_RTE_CMP_ALL, 
                                     &endpoint_proc->proc_ompi->proc_name,
                                     &this_proc->proc_ompi->proc_name);
+    /* waiting for the peer to close, there is nothing left to read on the
+       old connection. While closing, the peer has not answered yet */
     if((btl_endpoint->endpoint_sd < 0) ||
+       (btl_endpoint->endpoint_state == MCA_BTL_TCP_CLOSE_WAIT) ||
        (btl_endpoint->endpoint_state != MCA_BTL_TCP_CONNECTED &&
+        btl_endpoint->endpoint_state != MCA_BTL_TCP_CLOSING &&
         cmpval < 0)) {
         mca_btl_tcp_endpoint_close(btl_endpoint);
         btl_endpoint->endpoint_sd = sd;
@@ -395,6 +637,11 @@ void mca_btl_tcp_endpoint_close(mca_btl_base_endpoint_t* btl_endpoint)
     if(btl_endpoint->endpoint_sd < 0)
         return;
     btl_endpoint->endpoint_retries++;
+    btl_endpoint->endpoint_fin_ack_owed = false;
+    if(btl_endpoint->endpoint_counted) {
+        btl_endpoint->endpoint_counted = false;
+        OPAL_THREAD_ADD32(&mca_btl_tcp_component.tcp_num_connections, -1);
+    }
     opal_event_del(&btl_endpoint->endpoint_recv_event);
     opal_event_del(&btl_endpoint->endpoint_send_event);
     CLOSE_THE_SOCKET(btl_endpoint->endpoint_sd);
@@ -422,7 +669,23 @@ void mca_btl_tcp_endpoint_close(mca_btl_base_endpoint_t* btl_endpoint)
     } else {
         btl_endpoint->endpoint_state = MCA_BTL_TCP_CLOSED;
     }
+#if MCA_BTL_TCP_HAVE_ZEROCOPY
+    /* the socket is gone, and so are the references to the pages */
+    {
+        mca_btl_tcp_frag_t* frag;
+        int rc = (MCA_BTL_TCP_FAILED == btl_endpoint->endpoint_state) ? OMPI_ERR_UNREACH : OMPI_SUCCESS;
+
+        while(NULL != (frag = (mca_btl_tcp_frag_t*)opal_list_remove_first(&btl_endpoint->endpoint_zc_frags))) {
+            int btl_ownership = (frag->base.des_flags & MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
 
+            frag->zc_pending = false;
+            frag->base.des_cbfunc(&frag->btl->super, frag->endpoint, &frag->base, rc);
+            if( btl_ownership ) {
+                MCA_BTL_TCP_FRAG_RETURN(frag);
+            }
+        }
+    }
+#endif  /* MCA_BTL_TCP_HAVE_ZEROCOPY */
 }
 
 /*
@@ -436,9 +699,30 @@ static void mca_btl_tcp_endpoint_connected(mca_btl_base_endpoint_t* btl_endpoint
     /* setup socket options */
     btl_endpoint->endpoint_state = MCA_BTL_TCP_CONNECTED;
     btl_endpoint->endpoint_retries = 0;
+    mca_btl_tcp_endpoint_used(btl_endpoint);
+    if(!btl_endpoint->endpoint_counted) {
+        btl_endpoint->endpoint_counted = true;
+        if(OPAL_THREAD_ADD32(&mca_btl_tcp_component.tcp_num_connections, 1) >
+           mca_btl_tcp_component.tcp_max_connections &&
+           0 < mca_btl_tcp_component.tcp_max_connections) {
+            mca_btl_tcp_endpoint_trim(btl_endpoint);
+        }
+    }
+#if MCA_BTL_TCP_HAVE_ZEROCOPY
+    /* the notifications are counted from 0 on every socket */
+    btl_endpoint->endpoint_zc_sent = 0;
+    btl_endpoint->endpoint_zc_done = 0;
+    btl_endpoint->endpoint_zerocopy = false;
+    if(mca_btl_tcp_component.tcp_zerocopy_limit > 0) {
+        int optval = 1;
+        btl_endpoint->endpoint_zerocopy =
+            (0 == setsockopt(btl_endpoint->endpoint_sd, SOL_SOCKET, SO_ZEROCOPY,
+                             (char *)&optval, sizeof(optval)));
+    }
+#endif  /* MCA_BTL_TCP_HAVE_ZEROCOPY */
 
     /* Create the send event in a persistent manner. */
-    opal_event_set(opal_event_base, &btl_endpoint->endpoint_send_event, 
+    opal_event_set(btl_endpoint->endpoint_evbase, &btl_endpoint->endpoint_send_event, 
                     btl_endpoint->endpoint_sd, 
                     OPAL_EV_WRITE | OPAL_EV_PERSIST,
                     mca_btl_tcp_endpoint_send_handler,
@@ -553,6 +837,13 @@ void mca_btl_tcp_set_socket_options(int sd)
                    strerror(opal_socket_errno), opal_socket_errno));
     }
 #endif
+#if defined(SO_BUSY_POLL)
+    if(mca_btl_tcp_component.tcp_busy_poll > 0 &&
+       setsockopt(sd, SOL_SOCKET, SO_BUSY_POLL, (char *)&mca_btl_tcp_component.tcp_busy_poll, sizeof(int)) < 0) {
+        BTL_ERROR(("setsockopt(SO_BUSY_POLL) failed: %s (%d)", 
+                   strerror(opal_socket_errno), opal_socket_errno));
+    }
+#endif
 }
 
 
@@ -705,6 +996,10 @@ static void mca_btl_tcp_endpoint_recv_handler(int sd, short flags, void* user)
     if( sd != btl_endpoint->endpoint_sd )
         return;
 
+#if MCA_BTL_TCP_HAVE_ZEROCOPY
+    /* the error queue wakes up the socket as readable */
+    mca_btl_tcp_endpoint_zerocopy_progress(btl_endpoint);
+#endif  /* MCA_BTL_TCP_HAVE_ZEROCOPY */
     OPAL_THREAD_LOCK(&btl_endpoint->endpoint_recv_lock);
     switch(btl_endpoint->endpoint_state) {
     case MCA_BTL_TCP_CONNECT_ACK:
@@ -724,9 +1019,12 @@ static void mca_btl_tcp_endpoint_recv_handler(int sd, short flags, void* user)
             return;
         }
     case MCA_BTL_TCP_CONNECTED:
+    case MCA_BTL_TCP_CLOSING:
+    case MCA_BTL_TCP_CLOSE_WAIT:
         {
             mca_btl_tcp_frag_t* frag;
 
+            mca_btl_tcp_endpoint_used(btl_endpoint);
             frag = btl_endpoint->endpoint_recv_frag;
             if(NULL == frag) {
                 if(mca_btl_tcp_module.super.btl_max_send_size > 
@@ -750,12 +1048,27 @@ static void mca_btl_tcp_endpoint_recv_handler(int sd, short flags, void* user)
             /* check for completion of non-blocking recv on the current fragment */
             if(mca_btl_tcp_frag_recv(frag, btl_endpoint->endpoint_sd) == false) {
                 btl_endpoint->endpoint_recv_frag = frag;
+                if(MCA_BTL_TCP_CLOSED == btl_endpoint->endpoint_state) {
+                    /* the peer closed after our FIN_ACK */
+                    btl_endpoint->endpoint_recv_frag = NULL;
+                    MCA_BTL_TCP_FRAG_RETURN(frag);
+                    OPAL_THREAD_LOCK(&btl_endpoint->endpoint_send_lock);
+                    mca_btl_tcp_endpoint_reopen(btl_endpoint);
+                    OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_send_lock);
+                }
             } else {
                 btl_endpoint->endpoint_recv_frag = NULL;
                 if( MCA_BTL_TCP_HDR_TYPE_SEND == frag->hdr.type ) {
                     mca_btl_active_message_callback_t* reg;
                     reg = mca_btl_base_active_message_trigger + frag->hdr.base.tag;
                     reg->cbfunc(&frag->btl->super, frag->hdr.base.tag, &frag->base, reg->cbdata);
+                } else if( (MCA_BTL_TCP_HDR_TYPE_FIN == frag->hdr.type ||
+                            MCA_BTL_TCP_HDR_TYPE_FIN_ACK == frag->hdr.type) &&
+                           mca_btl_tcp_endpoint_recv_fin(btl_endpoint, frag->hdr.type) ) {
+                    /* the connection is gone, with its cache */
+                    MCA_BTL_TCP_FRAG_RETURN(frag);
+                    OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_recv_lock);
+                    return;
                 }
 #if MCA_BTL_TCP_ENDPOINT_CACHE
                 if( 0 != btl_endpoint->endpoint_cache_length ) {
@@ -801,6 +1114,9 @@ static void mca_btl_tcp_endpoint_recv_handler(int sd, short flags, void* user)
 static void mca_btl_tcp_endpoint_send_handler(int sd, short flags, void* user)
 {
     mca_btl_tcp_endpoint_t* btl_endpoint = (mca_btl_tcp_endpoint_t *)user;
+#if MCA_BTL_TCP_HAVE_ZEROCOPY
+    mca_btl_tcp_endpoint_zerocopy_progress(btl_endpoint);
+#endif  /* MCA_BTL_TCP_HAVE_ZEROCOPY */
     OPAL_THREAD_LOCK(&btl_endpoint->endpoint_send_lock);
     switch(btl_endpoint->endpoint_state) {
     case MCA_BTL_TCP_CONNECTING:
@@ -812,12 +1128,26 @@ static void mca_btl_tcp_endpoint_send_handler(int sd, short flags, void* user)
             mca_btl_tcp_frag_t* frag = btl_endpoint->endpoint_send_frag;
             int btl_ownership = (frag->base.des_flags & MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
 
-            if(mca_btl_tcp_frag_send(frag, btl_endpoint->endpoint_sd) == false) {
+            if(mca_btl_tcp_frag_send_batch(frag, &btl_endpoint->endpoint_frags,
+                                           btl_endpoint->endpoint_sd) == false) {
                 break;
             }
             /* progress any pending sends */
             btl_endpoint->endpoint_send_frag = (mca_btl_tcp_frag_t*)
                 opal_list_remove_first(&btl_endpoint->endpoint_frags);
+            if(btl_endpoint->endpoint_fin_ack_owed &&
+               0 == --btl_endpoint->endpoint_fin_ack_after) {
+                /* what follows goes on the next connection */
+                if(NULL != btl_endpoint->endpoint_send_frag) {
+                    opal_list_prepend(&btl_endpoint->endpoint_frags,
+                                      (opal_list_item_t*)btl_endpoint->endpoint_send_frag);
+                    btl_endpoint->endpoint_send_frag = NULL;
+                }
+                mca_btl_tcp_endpoint_send_fin_ack(btl_endpoint);
+            }
+            if(!mca_btl_tcp_endpoint_frag_sent(btl_endpoint, frag)) {
+                continue;
+            }
 
             /* if required - update request status and release fragment */
             OPAL_THREAD_UNLOCK(&btl_endpoint->endpoint_send_lock);
@@ -835,6 +1165,11 @@ static void mca_btl_tcp_endpoint_send_handler(int sd, short flags, void* user)
             opal_event_del(&btl_endpoint->endpoint_send_event);
         }
         break;
+    case MCA_BTL_TCP_CLOSING:
+    case MCA_BTL_TCP_CLOSE_WAIT:
+        /* the sends wait for the next connection */
+        opal_event_del(&btl_endpoint->endpoint_send_event);
+        break;
     default:
         BTL_ERROR(("invalid connection state (%d)", btl_endpoint->endpoint_state));
         opal_event_del(&btl_endpoint->endpoint_send_event);
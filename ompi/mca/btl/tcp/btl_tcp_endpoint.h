@@ -36,7 +36,9 @@ typedef enum {
     MCA_BTL_TCP_CONNECT_ACK,
     MCA_BTL_TCP_CLOSED,
     MCA_BTL_TCP_FAILED,
-    MCA_BTL_TCP_CONNECTED
+    MCA_BTL_TCP_CONNECTED,
+    MCA_BTL_TCP_CLOSING,        /**< idle, FIN sent, waiting for the FIN_ACK */
+    MCA_BTL_TCP_CLOSE_WAIT      /**< FIN_ACK sent, waiting for the peer to close */
 } mca_btl_tcp_state_t;
 
 /**
@@ -64,15 +66,33 @@ struct mca_btl_base_endpoint_t {
     opal_list_t                     endpoint_frags;        /**< list of pending frags to send */
     opal_mutex_t                    endpoint_send_lock;    /**< lock for concurrent access to endpoint state */
     opal_mutex_t                    endpoint_recv_lock;    /**< lock for concurrent access to endpoint state */
+    opal_event_base_t*              endpoint_evbase;       /**< event base driving this endpoint's socket */
     opal_event_t                    endpoint_send_event;   /**< event for async processing of send frags */
     opal_event_t                    endpoint_recv_event;   /**< event for async processing of recv frags */
     bool                            endpoint_nbo;          /**< convert headers to network byte order? */
+    bool                            endpoint_zerocopy;     /**< SO_ZEROCOPY is set on the socket */
+    uint32_t                        endpoint_zc_sent;      /**< MSG_ZEROCOPY sends issued on the socket */
+    uint32_t                        endpoint_zc_done;      /**< MSG_ZEROCOPY sends the kernel is done with */
+    opal_list_t                     endpoint_zc_frags;     /**< sent frags waiting for their zerocopy notification */
+    uint64_t                        endpoint_last_use;     /**< tcp_use_clock at the last message */
+    bool                            endpoint_counted;      /**< in tcp_num_connections */
+    bool                            endpoint_fin_ack_owed; /**< the peer asked to close the connection */
+    size_t                          endpoint_fin_ack_after; /**< frags to send before the FIN_ACK */
 };
 
 typedef struct mca_btl_base_endpoint_t mca_btl_base_endpoint_t;
 typedef mca_btl_base_endpoint_t  mca_btl_tcp_endpoint_t;
 OBJ_CLASS_DECLARATION(mca_btl_tcp_endpoint_t);
 
+/**
+ * Record a message on the endpoint: the least recently used idle
+ * connections are the first closed beyond btl_tcp_max_connections.
+ */
+static inline void mca_btl_tcp_endpoint_used(mca_btl_base_endpoint_t* btl_endpoint)
+{
+    btl_endpoint->endpoint_last_use = ++mca_btl_tcp_component.tcp_use_clock;
+}
+
 void mca_btl_tcp_set_socket_options(int sd);
 void mca_btl_tcp_endpoint_close(mca_btl_base_endpoint_t*);
 int  mca_btl_tcp_endpoint_send(mca_btl_base_endpoint_t*, struct mca_btl_tcp_frag_t*);
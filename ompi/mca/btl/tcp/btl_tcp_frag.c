@@ -24,6 +24,7 @@
 
 #include "ompi_config.h"
 
+#include <string.h>
 #ifdef HAVE_SYS_TYPES_H
 #include <sys/types.h>
 #endif
@@ -48,6 +49,7 @@ static void mca_btl_tcp_frag_common_constructor(mca_btl_tcp_frag_t* frag)
     frag->base.des_src_cnt = 0;
     frag->base.des_dst = NULL;
     frag->base.des_dst_cnt = 0;
+    frag->zc_pending = false;
 }
 
 static void mca_btl_tcp_frag_eager_constructor(mca_btl_tcp_frag_t* frag) 
@@ -97,56 +99,291 @@ OBJ_CLASS_INSTANCE(
     NULL); 
 
 
-bool mca_btl_tcp_frag_send(mca_btl_tcp_frag_t* frag, int sd)
+/*
+ * Account for cnt bytes written from the remaining iovecs of the
+ * fragment, and return what was not consumed by this fragment.
+ */
+static inline size_t mca_btl_tcp_frag_advance(mca_btl_tcp_frag_t* frag, size_t cnt)
+{
+    size_t i, num_vecs = frag->iov_cnt;
+
+    for(i=0; i<num_vecs; i++) {
+        if(cnt >= frag->iov_ptr->iov_len) {
+            cnt -= frag->iov_ptr->iov_len;
+            frag->iov_ptr++;
+            frag->iov_idx++;
+            frag->iov_cnt--;
+        } else {
+            frag->iov_ptr->iov_base = (ompi_iov_base_ptr_t)
+                (((unsigned char*)frag->iov_ptr->iov_base) + cnt);
+            frag->iov_ptr->iov_len -= cnt;
+            return 0;
+        }
+    }
+    return cnt;
+}
+
+/*
+ * Non-blocking write of the iovecs, continuing if interrupted.  Returns
+ * the number of bytes written, or -1 if the socket would block or the
+ * endpoint of frag had to be closed.
+ */
+static inline int mca_btl_tcp_frag_writev(mca_btl_base_endpoint_t* endpoint, int sd,
+                                          struct iovec* iov, int iov_cnt)
 {
     int cnt=-1;
-    size_t i, num_vecs;
 
-    /* non-blocking write, but continue if interrupted */
     while(cnt < 0) {
-        cnt = writev(sd, frag->iov_ptr, frag->iov_cnt);
+        cnt = writev(sd, iov, iov_cnt);
         if(cnt < 0) {
             switch(opal_socket_errno) {
             case EINTR:
                 continue;
             case EWOULDBLOCK:
-                return false;
+                return -1;
             case EFAULT:
                 BTL_ERROR(("mca_btl_tcp_frag_send: writev error (%p, %lu)\n\t%s(%lu)\n",
-                    frag->iov_ptr[0].iov_base, (unsigned long) frag->iov_ptr[0].iov_len,
-                    strerror(opal_socket_errno), (unsigned long) frag->iov_cnt));
-                frag->endpoint->endpoint_state = MCA_BTL_TCP_FAILED;
-                mca_btl_tcp_endpoint_close(frag->endpoint);
-                return false;
+                    iov[0].iov_base, (unsigned long) iov[0].iov_len,
+                    strerror(opal_socket_errno), (unsigned long) iov_cnt));
+                endpoint->endpoint_state = MCA_BTL_TCP_FAILED;
+                mca_btl_tcp_endpoint_close(endpoint);
+                return -1;
             default:
                 BTL_ERROR(("mca_btl_tcp_frag_send: writev failed: %s (%d)", 
                            strerror(opal_socket_errno),
                            opal_socket_errno));
-                frag->endpoint->endpoint_state = MCA_BTL_TCP_FAILED;
-                mca_btl_tcp_endpoint_close(frag->endpoint);
-                return false;
+                endpoint->endpoint_state = MCA_BTL_TCP_FAILED;
+                mca_btl_tcp_endpoint_close(endpoint);
+                return -1;
             }
         }
     }
+    return cnt;
+}
+
+#if MCA_BTL_TCP_HAVE_ZEROCOPY
+/* whether what is left of frag goes out with MSG_ZEROCOPY */
+static inline bool mca_btl_tcp_frag_use_zerocopy(mca_btl_tcp_frag_t* frag)
+{
+    size_t i, length = 0;
+
+    if(!frag->endpoint->endpoint_zerocopy) {
+        return false;
+    }
+    for(i = 0; i < frag->iov_cnt; i++) {
+        length += frag->iov_ptr[i].iov_len;
+    }
+    return length >= (size_t)mca_btl_tcp_component.tcp_zerocopy_limit;
+}
+
+/*
+ * Same as mca_btl_tcp_frag_writev, but with MSG_ZEROCOPY when what is
+ * left of frag is large enough.  The kernel keeps references to the
+ * pages until the peer acks the data, so frag is marked to complete
+ * only when the notification for this send comes back.
+ */
+static inline int mca_btl_tcp_frag_send_zerocopy(mca_btl_tcp_frag_t* frag, int sd)
+{
+    mca_btl_base_endpoint_t* endpoint = frag->endpoint;
+    struct msghdr msg;
+    int cnt;
+
+    if(!mca_btl_tcp_frag_use_zerocopy(frag)) {
+        return mca_btl_tcp_frag_writev(endpoint, sd, frag->iov_ptr, frag->iov_cnt);
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = frag->iov_ptr;
+    msg.msg_iovlen = frag->iov_cnt;
+    do {
+        cnt = sendmsg(sd, &msg, MSG_ZEROCOPY);
+    } while(cnt < 0 && EINTR == opal_socket_errno);
+    if(cnt > 0) {
+        frag->zc_pending = true;
+        frag->zc_seq = endpoint->endpoint_zc_sent++;
+        return cnt;
+    }
+    if(cnt < 0 && EWOULDBLOCK == opal_socket_errno) {
+        return -1;
+    }
+    /* out of pinned memory (ENOBUFS) or any other error: a plain writev
+       either copies or reports the failure */
+    return mca_btl_tcp_frag_writev(endpoint, sd, frag->iov_ptr, frag->iov_cnt);
+}
+#endif  /* MCA_BTL_TCP_HAVE_ZEROCOPY */
+
+bool mca_btl_tcp_frag_send(mca_btl_tcp_frag_t* frag, int sd)
+{
+    int cnt;
+
+    /* already pushed out as part of a batch */
+    if(0 == frag->iov_cnt) {
+        return true;
+    }
+
+#if MCA_BTL_TCP_HAVE_ZEROCOPY
+    cnt = mca_btl_tcp_frag_send_zerocopy(frag, sd);
+#else
+    cnt = mca_btl_tcp_frag_writev(frag->endpoint, sd, frag->iov_ptr, frag->iov_cnt);
+#endif  /* MCA_BTL_TCP_HAVE_ZEROCOPY */
+    if(cnt < 0) {
+        return false;
+    }
 
     /* if the write didn't complete - update the iovec state */
-    num_vecs = frag->iov_cnt;
-    for(i=0; i<num_vecs; i++) {
-        if(cnt >= (int)frag->iov_ptr->iov_len) {
-            cnt -= frag->iov_ptr->iov_len;
-            frag->iov_ptr++;
-            frag->iov_idx++;
-            frag->iov_cnt--;
-        } else {
-            frag->iov_ptr->iov_base = (ompi_iov_base_ptr_t)
-                (((unsigned char*)frag->iov_ptr->iov_base) + cnt);
-            frag->iov_ptr->iov_len -= cnt;
+    mca_btl_tcp_frag_advance(frag, (size_t)cnt);
+    return (frag->iov_cnt == 0);
+}
+
+/*
+ * Same as mca_btl_tcp_frag_send, but the iovecs of the fragments queued
+ * behind frag are appended to the same writev, so that a burst of small
+ * messages costs a single syscall.  The queued fragments stay on the
+ * list: the ones that went out completely are left with no iovec, and
+ * will be completed without any further syscall once they reach the
+ * head of the queue.  Must be called with the endpoint send lock held.
+ */
+bool mca_btl_tcp_frag_send_batch(mca_btl_tcp_frag_t* frag, opal_list_t* pending, int sd)
+{
+    struct iovec iov[MCA_BTL_TCP_SEND_BATCH_IOVEC];
+    opal_list_item_t* item;
+    int cnt, iov_cnt = 0, nfrags = 1, max_frags = mca_btl_tcp_component.tcp_send_batch;
+    size_t left;
+
+    /* nothing after the FIN_ACK the peer is waiting for */
+    if(frag->endpoint->endpoint_fin_ack_owed &&
+       frag->endpoint->endpoint_fin_ack_after < (size_t)max_frags) {
+        max_frags = (int)frag->endpoint->endpoint_fin_ack_after;
+    }
+    if((max_frags <= 1) ||
+       (opal_list_get_size(pending) == 0) || (0 == frag->iov_cnt)) {
+        return mca_btl_tcp_frag_send(frag, sd);
+    }
+#if MCA_BTL_TCP_HAVE_ZEROCOPY
+    /* a large fragment is worth a syscall of its own */
+    if(mca_btl_tcp_frag_use_zerocopy(frag)) {
+        return mca_btl_tcp_frag_send(frag, sd);
+    }
+#endif  /* MCA_BTL_TCP_HAVE_ZEROCOPY */
+
+    memcpy(iov, frag->iov_ptr, frag->iov_cnt * sizeof(struct iovec));
+    iov_cnt = (int)frag->iov_cnt;
+    for(item =  opal_list_get_first(pending);
+        item != opal_list_get_end(pending) &&
+            nfrags < max_frags;
+        item = opal_list_get_next(item), nfrags++) {
+        mca_btl_tcp_frag_t* next = (mca_btl_tcp_frag_t*)item;
+        if(iov_cnt + (int)next->iov_cnt > MCA_BTL_TCP_SEND_BATCH_IOVEC) {
             break;
         }
+        memcpy(iov + iov_cnt, next->iov_ptr, next->iov_cnt * sizeof(struct iovec));
+        iov_cnt += (int)next->iov_cnt;
+    }
+
+    cnt = mca_btl_tcp_frag_writev(frag->endpoint, sd, iov, iov_cnt);
+    if(cnt < 0) {
+        return false;
+    }
+
+    /* spread the written bytes over the fragments, in queue order */
+    left = mca_btl_tcp_frag_advance(frag, (size_t)cnt);
+    for(item =  opal_list_get_first(pending);
+        left > 0 && item != opal_list_get_end(pending);
+        item = opal_list_get_next(item)) {
+        left = mca_btl_tcp_frag_advance((mca_btl_tcp_frag_t*)item, left);
     }
     return (frag->iov_cnt == 0);
 }
 
+/* nobody waits for the tail of an immediate send */
+static void mca_btl_tcp_frag_sendi_complete(struct mca_btl_base_module_t* btl,
+                                            struct mca_btl_base_endpoint_t* endpoint,
+                                            struct mca_btl_base_descriptor_t* des,
+                                            int status)
+{
+}
+
+/*
+ * The immediate send: a single writev of the length bytes of iov on a
+ * connected endpoint with nothing queued.  What the socket does not take
+ * is copied in an eager fragment, which becomes the send in progress of
+ * the endpoint, so the caller's buffers can be reused on return.  Must
+ * be called with the endpoint send lock held.
+ */
+int mca_btl_tcp_frag_sendi(mca_btl_tcp_module_t* btl, mca_btl_base_endpoint_t* endpoint,
+                           struct iovec* iov, int iov_cnt, size_t length)
+{
+    mca_btl_tcp_frag_t* frag;
+    unsigned char* ptr;
+    int cnt, i;
+
+    cnt = mca_btl_tcp_frag_writev(endpoint, endpoint->endpoint_sd, iov, iov_cnt);
+    if(cnt < 0) {
+        if(MCA_BTL_TCP_CONNECTED != endpoint->endpoint_state) {
+            return OMPI_ERR_UNREACH;
+        }
+        cnt = 0;  /* the socket is full */
+    }
+    if((size_t)cnt == length) {
+        return OMPI_SUCCESS;
+    }
+
+    MCA_BTL_TCP_FRAG_ALLOC_EAGER(frag);
+    if(OPAL_UNLIKELY(NULL == frag)) {
+        /* nowhere to keep the rest, push it out as the connection
+           setup does */
+        for(i = 0; i < iov_cnt; i++) {
+            struct iovec rest = iov[i];
+
+            if((size_t)cnt >= rest.iov_len) {
+                cnt -= rest.iov_len;
+                continue;
+            }
+            rest.iov_base = (IOVBASE_TYPE*)((unsigned char*)rest.iov_base + cnt);
+            rest.iov_len -= cnt;
+            cnt = 0;
+            while(rest.iov_len > 0) {
+                int n = mca_btl_tcp_frag_writev(endpoint, endpoint->endpoint_sd, &rest, 1);
+                if(n < 0) {
+                    if(MCA_BTL_TCP_CONNECTED != endpoint->endpoint_state) {
+                        return OMPI_ERR_UNREACH;
+                    }
+                    continue;
+                }
+                rest.iov_base = (IOVBASE_TYPE*)((unsigned char*)rest.iov_base + n);
+                rest.iov_len -= n;
+            }
+        }
+        return OMPI_SUCCESS;
+    }
+
+    /* copy what is left */
+    ptr = (unsigned char*)(frag + 1);
+    for(i = 0; i < iov_cnt; i++) {
+        if((size_t)cnt >= iov[i].iov_len) {
+            cnt -= iov[i].iov_len;
+            continue;
+        }
+        memcpy(ptr, (unsigned char*)iov[i].iov_base + cnt, iov[i].iov_len - cnt);
+        ptr += iov[i].iov_len - cnt;
+        cnt = 0;
+    }
+
+    frag->btl = btl;
+    frag->endpoint = endpoint;
+    frag->rc = 0;
+    frag->iov_idx = 0;
+    frag->iov_cnt = 1;
+    frag->iov_ptr = frag->iov;
+    frag->iov[0].iov_base = (IOVBASE_TYPE*)(frag + 1);
+    frag->iov[0].iov_len = ptr - (unsigned char*)(frag + 1);
+    frag->base.des_flags = MCA_BTL_DES_FLAGS_BTL_OWNERSHIP | MCA_BTL_DES_SEND_ALWAYS_CALLBACK;
+    frag->base.des_cbfunc = mca_btl_tcp_frag_sendi_complete;
+    endpoint->endpoint_send_frag = frag;
+    opal_event_add(&endpoint->endpoint_send_event, 0);
+    return OMPI_SUCCESS;
+}
+
 bool mca_btl_tcp_frag_recv(mca_btl_tcp_frag_t* frag, int sd)
 {
     int cnt, dont_copy_data = 0;
@@ -197,7 +434,10 @@ bool mca_btl_tcp_frag_recv(mca_btl_tcp_frag_t* frag, int sd)
         cnt = readv(sd, frag->iov_ptr, num_vecs);
 	if( 0 < cnt ) goto advance_iov_position;
 	if( cnt == 0 ) {
-            btl_endpoint->endpoint_state = MCA_BTL_TCP_FAILED;
+            /* unless the peer closes an idle connection after our FIN_ACK */
+            if( MCA_BTL_TCP_CLOSE_WAIT != btl_endpoint->endpoint_state ) {
+                btl_endpoint->endpoint_state = MCA_BTL_TCP_FAILED;
+            }
 	    mca_btl_tcp_endpoint_close(btl_endpoint);
 	    return false;
 	}
@@ -32,19 +32,38 @@
 #include <net/uio.h>
 #endif
 
+#ifdef HAVE_LINUX_ERRQUEUE_H
+#include <linux/errqueue.h>
+#endif
+
 #include "btl_tcp.h" 
 #include "btl_tcp_hdr.h"
 
 BEGIN_C_DECLS
 
-#define MCA_BTL_TCP_FRAG_IOVEC_NUMBER  4
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+#define MCA_BTL_TCP_HAVE_ZEROCOPY 1
+#else
+#define MCA_BTL_TCP_HAVE_ZEROCOPY 0
+#endif
+
+/* maximum number of blocks of user memory a fragment can reference in
+   place of a packed copy (see btl_tcp_gather_min_block) */
+#define MCA_BTL_TCP_FRAG_GATHER_MAX    8
+
+/* header + reserved space + gathered blocks */
+#define MCA_BTL_TCP_FRAG_IOVEC_NUMBER  (MCA_BTL_TCP_FRAG_GATHER_MAX + 1)
+
+/* maximum number of iovecs gathered in a single writev by
+   mca_btl_tcp_frag_send_batch (well below any IOV_MAX) */
+#define MCA_BTL_TCP_SEND_BATCH_IOVEC   64
 
 /**
  * TCP fragment derived type.
  */
 struct mca_btl_tcp_frag_t {
     mca_btl_base_descriptor_t base; 
-    mca_btl_base_segment_t segments[2]; 
+    mca_btl_base_segment_t segments[MCA_BTL_TCP_FRAG_GATHER_MAX + 1]; 
     struct mca_btl_base_endpoint_t *endpoint; 
     struct mca_btl_tcp_module_t* btl;
     mca_btl_tcp_hdr_t hdr;
@@ -54,6 +73,8 @@ struct mca_btl_tcp_frag_t {
     size_t iov_idx;
     size_t size; 
     int rc;
+    bool zc_pending;        /**< part of it went out with MSG_ZEROCOPY */
+    uint32_t zc_seq;        /**< zerocopy notification of its last part */
     ompi_free_list_t* my_list;
 }; 
 typedef struct mca_btl_tcp_frag_t mca_btl_tcp_frag_t; 
@@ -121,6 +142,9 @@ do {                                                                       \
 
 
 bool mca_btl_tcp_frag_send(mca_btl_tcp_frag_t*, int sd);
+bool mca_btl_tcp_frag_send_batch(mca_btl_tcp_frag_t*, opal_list_t* pending, int sd);
+int mca_btl_tcp_frag_sendi(mca_btl_tcp_module_t* btl, struct mca_btl_base_endpoint_t* endpoint,
+                           struct iovec* iov, int iov_cnt, size_t length);
 bool mca_btl_tcp_frag_recv(mca_btl_tcp_frag_t*, int sd);
 
 
@@ -33,6 +33,8 @@ BEGIN_C_DECLS
 #define MCA_BTL_TCP_HDR_TYPE_SEND 1
 #define MCA_BTL_TCP_HDR_TYPE_PUT  2
 #define MCA_BTL_TCP_HDR_TYPE_GET  3
+#define MCA_BTL_TCP_HDR_TYPE_FIN  4     /* close this idle connection */
+#define MCA_BTL_TCP_HDR_TYPE_FIN_ACK 5  /* last message on the connection */
 
 struct mca_btl_tcp_hdr_t {
     mca_btl_base_header_t base;
@@ -23,6 +23,9 @@
 AC_DEFUN([MCA_ompi_btl_tcp_CONFIG],[
     AC_CONFIG_FILES([ompi/mca/btl/tcp/Makefile])
 
+    # MSG_ZEROCOPY completions come back on the socket error queue
+    AC_CHECK_HEADERS([linux/errqueue.h])
+
     # check for sockaddr_in (a good sign we have TCP)
     AC_CHECK_TYPES([struct sockaddr_in], 
                    [$1],
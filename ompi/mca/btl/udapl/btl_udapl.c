@@ -357,6 +357,7 @@ mca_btl_udapl_init(DAT_NAME_PTR ia_name, mca_btl_udapl_module_t* btl)
     res.sizeof_reg = sizeof(mca_btl_udapl_reg_t);
     res.register_mem = udapl_reg_mr;
     res.deregister_mem = udapl_dereg_mr;
+    res.implicit_reg = false;
     btl->super.btl_mpool = mca_mpool_base_module_create(
             mca_btl_udapl_component.udapl_mpool_name, &btl->super, &res);
     if (NULL == btl->super.btl_mpool) {
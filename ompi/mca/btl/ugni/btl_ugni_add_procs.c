@@ -248,6 +248,7 @@ mca_btl_ugni_setup_mpools (mca_btl_ugni_module_t *ugni_module)
     mpool_resources.sizeof_reg     = sizeof (mca_btl_ugni_reg_t);
     mpool_resources.register_mem   = ugni_reg_rdma_mem;
     mpool_resources.deregister_mem = ugni_dereg_mem;
+    mpool_resources.implicit_reg   = false;
     ugni_module->super.btl_mpool =
         mca_mpool_base_module_create("grdma", ugni_module->device,
                                      &mpool_resources);
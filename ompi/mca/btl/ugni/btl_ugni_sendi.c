@@ -0,0 +1,98 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "btl_ugni.h"
+#include "btl_ugni_frag.h"
+#include "btl_ugni_smsg.h"
+
+#include "opal/datatype/opal_convertor.h"
+
+int mca_btl_ugni_sendi (struct mca_btl_base_module_t *btl,
+                        struct mca_btl_base_endpoint_t *endpoint,
+                        struct opal_convertor_t *convertor,
+                        void *header, size_t header_size,
+                        size_t payload_size, uint8_t order,
+                        uint32_t flags, mca_btl_base_tag_t tag,
+                        mca_btl_base_descriptor_t **descriptor)
+{
+    size_t size = header_size + payload_size;
+    mca_btl_ugni_base_frag_t *frag = NULL;
+    size_t position;
+    int rc;
+
+    /* only what fits a single smsg, on a connected endpoint with nothing
+       queued ahead of it */
+    if (OPAL_UNLIKELY(size > mca_btl_ugni_component.smsg_max_data ||
+                      header_size > sizeof (frag->hdr.send_ex.pml_header) ||
+                      OMPI_SUCCESS != mca_btl_ugni_check_endpoint_state (endpoint) ||
+                      !opal_list_is_empty (&endpoint->frag_wait_list))) {
+        goto use_descriptor;
+    }
+
+    (void) MCA_BTL_UGNI_FRAG_ALLOC_SMSG(endpoint, frag);
+    if (OPAL_UNLIKELY(NULL == frag)) {
+        goto use_descriptor;
+    }
+
+    BTL_VERBOSE(("btl/ugni sending immediate from %d -> %d. length = %u",
+                 OMPI_PROC_MY_NAME->vpid, endpoint->common->ep_rem_id, (unsigned int) size));
+
+    /* the pml header goes with the btl header, the payload straight from the
+       smsg buffer of the frag */
+    frag->hdr.send.lag = (tag << 24) | size;
+    frag->hdr_size = header_size + sizeof (frag->hdr.send);
+    memcpy (frag->hdr.send_ex.pml_header, header, header_size);
+
+    position = convertor->bConverted;
+    if (payload_size) {
+        uint32_t iov_count = 1;
+        size_t max_size = payload_size;
+        struct iovec iov;
+
+        iov.iov_len  = payload_size;
+        iov.iov_base = (IOVBASE_TYPE *) frag->base.super.ptr;
+
+        rc = opal_convertor_pack (convertor, &iov, &iov_count, &max_size);
+        if (OPAL_UNLIKELY(rc < 0)) {
+            mca_btl_ugni_frag_return (frag);
+            *descriptor = NULL;
+            return OMPI_ERROR;
+        }
+    }
+
+    frag->flags |= MCA_BTL_UGNI_FRAG_BUFFERED;
+    frag->segments[1].base.seg_addr.pval = frag->base.super.ptr;
+    frag->segments[1].base.seg_len       = payload_size;
+    frag->base.order     = order;
+    /* nobody to call back: the local smsg completion returns the frag */
+    frag->base.des_flags = MCA_BTL_DES_FLAGS_BTL_OWNERSHIP;
+    frag->endpoint = endpoint;
+
+    rc = ompi_mca_btl_ugni_smsg_send (frag, &frag->hdr.send, frag->hdr_size,
+                                      frag->segments[1].base.seg_addr.pval,
+                                      payload_size, MCA_BTL_UGNI_TAG_SEND);
+    if (OPAL_LIKELY(OMPI_SUCCESS == rc)) {
+        return OMPI_SUCCESS;
+    }
+
+    mca_btl_ugni_frag_return (frag);
+    if (OMPI_ERR_OUT_OF_RESOURCE != rc) {
+        *descriptor = NULL;
+        return rc;
+    }
+    /* out of credits: the caller packs the data again in a regular frag */
+    (void) opal_convertor_set_position (convertor, &position);
+
+ use_descriptor:
+    *descriptor = mca_btl_ugni_alloc (btl, endpoint, order, size, flags);
+    return OMPI_ERR_RESOURCE_BUSY;
+}
@@ -42,11 +42,20 @@
 # include <unistd.h>
 #endif /* HAVE_UNISTD_H */
 
-/* xpmem is required by vader atm */
+#if OMPI_BTL_VADER_HAVE_XPMEM
 #include <xpmem.h>
+#endif  /* OMPI_BTL_VADER_HAVE_XPMEM */
 
+#if OMPI_BTL_VADER_HAVE_KNEM
+#include <knem_io.h>
+#endif  /* OMPI_BTL_VADER_HAVE_KNEM */
+
+#include "opal/align.h"
 #include "opal/class/opal_free_list.h"
+#include "opal/threads/mutex.h"
 #include "opal/sys/atomic.h"
+#include "opal/mca/shmem/base/base.h"
+#include "opal/mca/memcpy/base/base.h"
 
 #include "ompi/mca/rte/rte.h"
 
@@ -73,14 +82,51 @@ BEGIN_C_DECLS
 
 struct vader_fifo_t;
 
+/*
+ * Single-copy mechanisms, from the preferred one down. Without XPMEM
+ * the segments are shared through opal_shmem and the large transfers
+ * go through process_vm_readv/writev (CMA) or knem; with none of them
+ * everything is copied in and out of the segments.
+ */
+enum {
+    MCA_BTL_VADER_XPMEM = 0,
+    MCA_BTL_VADER_CMA   = 1,
+    MCA_BTL_VADER_KNEM  = 2,
+    MCA_BTL_VADER_NONE  = 3,
+};
+
 /*
  * Modex data
  */
 struct vader_modex_t {
+#if OMPI_BTL_VADER_HAVE_XPMEM
     xpmem_segid_t seg_id;
+#endif
     void *segment_base;
+    pid_t pid;              /* target of process_vm_readv/writev */
+    opal_shmem_ds_t seg_ds; /* (must be last) how to attach a non-xpmem segment */
 };
 
+/*
+ * Extensions of a segment, published in the segment itself (right after
+ * the fifo) so that the peers can attach them when they first see an
+ * address in one of them.
+ */
+typedef struct vader_segment_table_t {
+    volatile int32_t num_segments;          /* the segment and its extensions */
+    int32_t padding;
+    struct {
+        uint64_t base;                      /* address in the owner (xpmem) */
+        uint64_t size;
+        opal_shmem_ds_t seg_ds;             /* how to attach a non-xpmem extension */
+    } segments[MCA_BTL_VADER_MAX_SEGMENTS];
+} vader_segment_table_t;
+
+#define MCA_BTL_VADER_SEGMENT_TABLE(base) ((vader_segment_table_t *)((char *)(base) + 128))
+
+/* first byte of a segment that is handed out to fragments and fast boxes */
+#define MCA_BTL_VADER_SEGMENT_START OPAL_ALIGN(128 + sizeof (vader_segment_table_t), 4096, size_t)
+
 /**
  * Shared Memory (VADER) BTL module.
  */
@@ -90,10 +136,17 @@ struct mca_btl_vader_component_t {
     int vader_free_list_max;                /**< maximum size of free lists */
     int vader_free_list_inc;                /**< number of elements to alloc
                                              * when growing free lists */
+#if OMPI_BTL_VADER_HAVE_XPMEM
     xpmem_segid_t my_seg_id;                /* this rank's xpmem segment id */
+#endif
+    opal_shmem_ds_t seg_ds;                 /* this rank's segment if it is not shared through xpmem */
     char *my_segment;                       /* this rank's base pointer */
     size_t segment_size;                    /* size of my_segment */
-    size_t segment_offset;                  /* start of unused portion of my_segment */
+    size_t segment_max_size;                /* limit of my_segment and its extensions together */
+    size_t segment_total;                   /* size of my_segment and its extensions */
+    int num_segments;                       /* my_segment and its extensions */
+    size_t segment_offset;                  /* start of unused portion of the last segment */
+    opal_mutex_t lock;                      /* protects the segments (mine and the peers') */
     int32_t num_smp_procs;                  /**< current number of smp procs on this host */
     ompi_free_list_t vader_frags_eager;     /**< free list of vader send frags */
     ompi_free_list_t vader_frags_user;      /**< free list of vader put/get frags */
@@ -101,8 +154,18 @@ struct mca_btl_vader_component_t {
     int memcpy_limit;                       /** Limit where we switch from memmove to memcpy */
     int log_attach_align;                   /** Log of the alignment for xpmem segments */
     int max_inline_send;                    /** Limit for copy-in-copy-out fragments */
+    int single_copy_mechanism;              /** MCA_BTL_VADER_XPMEM, _CMA, _KNEM or _NONE */
+    int fbox_threshold;                     /** Number of sends before a peer gets a fast box */
+    int fbox_max;                           /** Maximum number of fast boxes this rank hands out */
+    int fbox_count;                         /** Number of fast boxes handed out so far */
+#if OMPI_BTL_VADER_HAVE_KNEM
+    int knem_fd;                            /** open /dev/knem, -1 if not in use */
+#endif
 
     struct mca_btl_base_endpoint_t *endpoints;
+    /* peers that have set up a fast box to this rank. only these are polled */
+    struct mca_btl_base_endpoint_t **fbox_in_endpoints;
+    int num_fbox_in_endpoints;
 };
 typedef struct mca_btl_vader_component_t mca_btl_vader_component_t;
 OMPI_MODULE_DECLSPEC extern mca_btl_vader_component_t mca_btl_vader_component;
@@ -135,20 +198,72 @@ OMPI_MODULE_DECLSPEC extern mca_btl_vader_t mca_btl_vader;
 #define MCA_BTL_VADER_LOCAL_RANK ompi_process_info.my_local_rank
 
 
-/* This only works for finding the relative address for a pointer within my_segment */
-static inline int64_t virtual2relative (char *addr)
+/**
+ * Attach segment @a segment of a peer, and its primary segment first
+ * if need be.  Failures are fatal (reported to the error callback).
+ */
+int mca_btl_vader_endpoint_attach (struct mca_btl_base_endpoint_t *ep, int segment);
+
+/**
+ * Carve @a size bytes (cache line aligned) out of my segment, extending
+ * it if it is full.  NULL once btl_vader_segment_max_size is reached.
+ */
+void *mca_btl_vader_segment_alloc (size_t size);
+
+int mca_btl_vader_segment_extend (mca_btl_vader_component_t *component, size_t min_size);
+
+static inline int mca_btl_vader_endpoint_check (struct mca_btl_base_endpoint_t *ep)
 {
-    return (int64_t)(uintptr_t) (addr - mca_btl_vader_component.my_segment) | ((int64_t)MCA_BTL_VADER_LOCAL_RANK << 32);
+    if (OPAL_LIKELY(NULL != ep->fifo)) {
+        return OMPI_SUCCESS;
+    }
+
+    return mca_btl_vader_endpoint_attach (ep, 0);
+}
+
+/*
+ * A relative address is the offset in a segment (bits 0-31), the local
+ * rank of the owner (bits 32-47) and the extension (bits 48-55, 0 for
+ * the segment itself).
+ */
+static inline int vader_segment_index (struct mca_btl_base_endpoint_t *ep, char *addr)
+{
+    int seg = 0;
+
+    /* unattached slots have a length of 0 */
+    while (OPAL_UNLIKELY((uintptr_t) addr - (uintptr_t) ep->segment_base[seg] >= ep->segment_len[seg])) {
+        assert (seg + 1 < MCA_BTL_VADER_MAX_SEGMENTS);
+        ++seg;
+    }
+
+    return seg;
 }
 
 static inline int64_t virtual2relativepeer (struct mca_btl_base_endpoint_t *endpoint, char *addr)
 {
-    return (int64_t)(uintptr_t) (addr - endpoint->segment_base) | ((int64_t)endpoint->peer_smp_rank << 32);
+    int seg = vader_segment_index (endpoint, addr);
+
+    return (int64_t)(uintptr_t) (addr - endpoint->segment_base[seg]) | ((int64_t)endpoint->peer_smp_rank << 32) |
+        ((int64_t) seg << 48);
+}
+
+/* This only works for finding the relative address for a pointer within my segments */
+static inline int64_t virtual2relative (char *addr)
+{
+    return virtual2relativepeer (mca_btl_vader_component.endpoints + MCA_BTL_VADER_LOCAL_RANK, addr);
 }
 
 static inline void *relative2virtual (int64_t offset)
 {
-    return (void *)(uintptr_t)((offset & 0xffffffffull) + mca_btl_vader_component.endpoints[offset >> 32].segment_base);
+    struct mca_btl_base_endpoint_t *ep = mca_btl_vader_component.endpoints + ((offset >> 32) & 0xffff);
+    const int seg = (int) (offset >> 48);
+
+    if (OPAL_UNLIKELY(NULL == ep->segment_base[seg])) {
+        /* the first address we see in a segment of this peer */
+        (void) mca_btl_vader_endpoint_attach (ep, seg);
+    }
+
+    return (void *)(uintptr_t)((offset & 0xffffffffull) + ep->segment_base[seg]);
 }
 
 /* memcpy is faster at larger sizes but is undefined if the
@@ -156,7 +271,7 @@ static inline void *relative2virtual (int64_t offset)
 static inline void vader_memmove (void *dst, void *src, size_t size)
 {
     if (size >= (size_t) mca_btl_vader_component.memcpy_limit) {
-        memcpy (dst, src, size);
+        opal_memcpy (dst, src, size);
     } else {
         memmove (dst, src, size);
     }
@@ -187,6 +302,7 @@ int mca_btl_vader_sendi (struct mca_btl_base_module_t *btl,
                          uint32_t flags, mca_btl_base_tag_t tag,
                          mca_btl_base_descriptor_t **descriptor);
 
+#if OMPI_BTL_VADER_HAVE_XPMEM
 /**
  * Initiate an synchronous put.
  *
@@ -208,6 +324,22 @@ int mca_btl_vader_put (struct mca_btl_base_module_t *btl,
 int mca_btl_vader_get (struct mca_btl_base_module_t *btl,
                        struct mca_btl_base_endpoint_t *endpoint,
                        struct mca_btl_base_descriptor_t *des);
+#endif  /* OMPI_BTL_VADER_HAVE_XPMEM */
+
+#if OMPI_BTL_VADER_HAVE_CMA
+int mca_btl_vader_put_cma (struct mca_btl_base_module_t *btl,
+                           struct mca_btl_base_endpoint_t *endpoint,
+                           struct mca_btl_base_descriptor_t *des);
+int mca_btl_vader_get_cma (struct mca_btl_base_module_t *btl,
+                           struct mca_btl_base_endpoint_t *endpoint,
+                           struct mca_btl_base_descriptor_t *des);
+#endif
+
+#if OMPI_BTL_VADER_HAVE_KNEM
+int mca_btl_vader_get_knem (struct mca_btl_base_module_t *btl,
+                            struct mca_btl_base_endpoint_t *endpoint,
+                            struct mca_btl_base_descriptor_t *des);
+#endif
 
 /**
  * Allocate a segment.
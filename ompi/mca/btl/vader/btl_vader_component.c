@@ -32,8 +32,20 @@
 #include "btl_vader_frag.h"
 #include "btl_vader_fifo.h"
 #include "btl_vader_fbox.h"
+#include "btl_vader_xpmem.h"
 
 #include <sys/mman.h>
+#include <errno.h>
+#include <stdio.h>
+
+#if OMPI_BTL_VADER_HAVE_KNEM
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#endif /* OMPI_BTL_VADER_HAVE_KNEM */
+
+#ifdef HAVE_SYS_PRCTL_H
+#include <sys/prctl.h>
+#endif /* HAVE_SYS_PRCTL_H */
 
 static int mca_btl_vader_component_progress (void);
 static int mca_btl_vader_component_open(void);
@@ -72,10 +84,60 @@ mca_btl_vader_component_t mca_btl_vader_component = {
     }  /* end super */
 };
 
+static mca_base_var_enum_value_t single_copy_mechanisms[] = {
+    {MCA_BTL_VADER_XPMEM, "xpmem"},
+    {MCA_BTL_VADER_CMA, "cma"},
+    {MCA_BTL_VADER_KNEM, "knem"},
+    {MCA_BTL_VADER_NONE, "none"},
+    {0, NULL}
+};
+
+#if OMPI_BTL_VADER_HAVE_CMA
+/* process_vm_readv needs ptrace rights on the peer: prctl (PR_SET_PTRACER)
+ * takes care of the yama "restricted" scope, higher scopes forbid it */
+static bool mca_btl_vader_cma_usable (void)
+{
+    FILE *fh = fopen ("/proc/sys/kernel/yama/ptrace_scope", "r");
+    int scope = 0;
+
+    if (NULL != fh) {
+        if (1 != fscanf (fh, "%d", &scope)) {
+            scope = 0;
+        }
+        fclose (fh);
+    }
+
+    return scope < 2;
+}
+#endif
+
+/* pick the best single-copy mechanism this node has to offer */
+static int mca_btl_vader_default_mechanism (void)
+{
+#if OMPI_BTL_VADER_HAVE_XPMEM
+    if (0 == access ("/dev/xpmem", R_OK | W_OK)) {
+        return MCA_BTL_VADER_XPMEM;
+    }
+#endif
+#if OMPI_BTL_VADER_HAVE_CMA
+    if (mca_btl_vader_cma_usable ()) {
+        return MCA_BTL_VADER_CMA;
+    }
+#endif
+#if OMPI_BTL_VADER_HAVE_KNEM
+    if (0 == access ("/dev/knem", R_OK | W_OK)) {
+        return MCA_BTL_VADER_KNEM;
+    }
+#endif
+    return MCA_BTL_VADER_NONE;
+}
+
 static int mca_btl_vader_component_register (void)
 {
+    mca_base_var_enum_t *new_enum;
+
     (void) mca_base_var_group_component_register(&mca_btl_vader_component.super.btl_version,
-                                                 "XPMEM shared memory byte transport later");
+                                                 "Shared memory byte transport layer");
 
     /* register VADER component variables */
     mca_btl_vader_component.vader_free_list_num = 8;
@@ -119,15 +181,27 @@ static int mca_btl_vader_component_register (void)
                                            MCA_BASE_VAR_SCOPE_LOCAL,
                                            &mca_btl_vader_component.log_attach_align);
 
-    mca_btl_vader_component.segment_size = 1 << 24;
+    mca_btl_vader_component.segment_size = 1 << 20;
     (void) mca_base_component_var_register(&mca_btl_vader_component.super.btl_version,
-                                           "segment_size", "Maximum size of all shared "
-                                           "memory buffers (default: 16M)",
+                                           "segment_size", "Initial size of the shared "
+                                           "memory buffers of each process, extended as "
+                                           "needed up to segment_max_size (default: 1M)",
                                            MCA_BASE_VAR_TYPE_INT, NULL, 0,
                                            MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
                                            MCA_BASE_VAR_SCOPE_LOCAL,
                                            &mca_btl_vader_component.segment_size);
 
+    mca_btl_vader_component.segment_max_size = 1 << 28;
+    (void) mca_base_component_var_register(&mca_btl_vader_component.super.btl_version,
+                                           "segment_max_size", "Maximum size of all shared "
+                                           "memory buffers of each process. Every extension "
+                                           "doubles the size of the previous one, and a process "
+                                           "has at most 7 (default: 256M)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_vader_component.segment_max_size);
+
     mca_btl_vader_component.max_inline_send = 256;
     (void) mca_base_component_var_register(&mca_btl_vader_component.super.btl_version,
                                            "max_inline_send", "Maximum size to transfer "
@@ -137,16 +211,69 @@ static int mca_btl_vader_component_register (void)
                                            MCA_BASE_VAR_SCOPE_LOCAL,
                                            &mca_btl_vader_component.max_inline_send);
 
+    (void) mca_base_var_enum_create ("btl_vader_single_copy_mechanisms",
+                                     single_copy_mechanisms, &new_enum);
+    mca_btl_vader_component.single_copy_mechanism = mca_btl_vader_default_mechanism ();
+    (void) mca_base_component_var_register(&mca_btl_vader_component.super.btl_version,
+                                           "single_copy_mechanism", "Single copy mechanism to use "
+                                           "for large messages (xpmem, cma, knem or none, defaults "
+                                           "to the first one available on this node in that order)",
+                                           MCA_BASE_VAR_TYPE_INT, new_enum, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_3,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_vader_component.single_copy_mechanism);
+    OBJ_RELEASE(new_enum);
+
+    mca_btl_vader_component.fbox_threshold = 16;
+    (void) mca_base_component_var_register(&mca_btl_vader_component.super.btl_version,
+                                           "fbox_threshold", "Number of messages sent to a peer "
+                                           "before a fast box is set up for it (0 disables fast "
+                                           "boxes)", MCA_BASE_VAR_TYPE_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_vader_component.fbox_threshold);
+
+    mca_btl_vader_component.fbox_max = 32;
+    (void) mca_base_component_var_register(&mca_btl_vader_component.super.btl_version,
+                                           "fbox_max", "Maximum number of peers this process "
+                                           "will set up a fast box for", MCA_BASE_VAR_TYPE_INT,
+                                           NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_btl_vader_component.fbox_max);
+
     mca_btl_vader.super.btl_exclusivity               = MCA_BTL_EXCLUSIVITY_HIGH;
-    mca_btl_vader.super.btl_eager_limit               = 32 * 1024;
+    mca_btl_vader.super.btl_max_send_size             = 32 * 1024;
+
+    switch (mca_btl_vader_component.single_copy_mechanism) {
+    case MCA_BTL_VADER_XPMEM:
+        /* sends above max_inline_send are already single copy */
+        mca_btl_vader.super.btl_eager_limit = 32 * 1024;
+        mca_btl_vader.super.btl_flags       = MCA_BTL_FLAGS_RDMA;
+        break;
+    case MCA_BTL_VADER_CMA:
+    case MCA_BTL_VADER_KNEM:
+        /* every send is copied twice: switch to the (single copy) get
+           protocol as soon as a syscall is cheaper than a second copy */
+        mca_btl_vader.super.btl_eager_limit = 4 * 1024;
+        mca_btl_vader.super.btl_flags       = MCA_BTL_FLAGS_GET;
+        if (MCA_BTL_VADER_CMA == mca_btl_vader_component.single_copy_mechanism) {
+            /* knem regions are only created on the sender side */
+            mca_btl_vader.super.btl_flags |= MCA_BTL_FLAGS_PUT;
+        }
+        break;
+    default:
+        mca_btl_vader.super.btl_eager_limit = 32 * 1024;
+        mca_btl_vader.super.btl_flags       = 0;
+        break;
+    }
+
     mca_btl_vader.super.btl_rndv_eager_limit          = mca_btl_vader.super.btl_eager_limit;
-    mca_btl_vader.super.btl_max_send_size             = mca_btl_vader.super.btl_eager_limit;
     mca_btl_vader.super.btl_rdma_pipeline_send_length = mca_btl_vader.super.btl_eager_limit;
-    mca_btl_vader.super.btl_rdma_pipeline_frag_size   = mca_btl_vader.super.btl_eager_limit;
-    mca_btl_vader.super.btl_min_rdma_pipeline_size    = mca_btl_vader.super.btl_eager_limit;
+    mca_btl_vader.super.btl_rdma_pipeline_frag_size   = mca_btl_vader.super.btl_max_send_size;
+    mca_btl_vader.super.btl_min_rdma_pipeline_size    = mca_btl_vader.super.btl_max_send_size;
 
-    mca_btl_vader.super.btl_flags     = MCA_BTL_FLAGS_RDMA | MCA_BTL_FLAGS_SEND_INPLACE;
-    mca_btl_vader.super.btl_seg_size  = sizeof (mca_btl_base_segment_t);
+    mca_btl_vader.super.btl_flags    |= MCA_BTL_FLAGS_SEND_INPLACE | MCA_BTL_FLAGS_ADD_PROCS_ON_DEMAND;
+    mca_btl_vader.super.btl_seg_size  = sizeof (mca_btl_vader_segment_t);
     mca_btl_vader.super.btl_bandwidth = 40000; /* Mbs */
     mca_btl_vader.super.btl_latency   = 1;     /* Microsecs */
 
@@ -167,11 +294,45 @@ static int mca_btl_vader_component_open(void)
     /* initialize objects */
     OBJ_CONSTRUCT(&mca_btl_vader_component.vader_frags_eager, ompi_free_list_t);
     OBJ_CONSTRUCT(&mca_btl_vader_component.vader_frags_user, ompi_free_list_t);
+    OBJ_CONSTRUCT(&mca_btl_vader_component.lock, opal_mutex_t);
+#if OMPI_BTL_VADER_HAVE_KNEM
+    mca_btl_vader_component.knem_fd = -1;
+#endif
 
     return OMPI_SUCCESS;
 }
 
 
+static void mca_btl_vader_segment_destroy (mca_btl_vader_component_t *component)
+{
+    vader_segment_table_t *table;
+    int i;
+
+    if (NULL == component->my_segment) {
+        return;
+    }
+
+    /* the extensions first, the table lives in my_segment */
+    table = MCA_BTL_VADER_SEGMENT_TABLE(component->my_segment);
+    for (i = component->num_segments - 1 ; i > 0 ; --i) {
+        if (MCA_BTL_VADER_XPMEM == component->single_copy_mechanism) {
+            munmap ((void *)(uintptr_t) table->segments[i].base, table->segments[i].size);
+        } else {
+            (void) opal_shmem_unlink (&table->segments[i].seg_ds);
+            (void) opal_shmem_segment_detach (&table->segments[i].seg_ds);
+        }
+    }
+    component->num_segments = 0;
+
+    if (MCA_BTL_VADER_XPMEM == component->single_copy_mechanism) {
+        munmap (component->my_segment, component->segment_size);
+    } else {
+        (void) opal_shmem_unlink (&component->seg_ds);
+        (void) opal_shmem_segment_detach (&component->seg_ds);
+    }
+    component->my_segment = NULL;
+}
+
 /*
  * component cleanup - sanity checking of queue lengths
  */
@@ -181,9 +342,15 @@ static int mca_btl_vader_component_close(void)
     OBJ_DESTRUCT(&mca_btl_vader_component.vader_frags_eager);
     OBJ_DESTRUCT(&mca_btl_vader_component.vader_frags_user);
 
-    if (NULL != mca_btl_vader_component.my_segment) {
-        munmap (mca_btl_vader_component.my_segment, mca_btl_vader_component.segment_size);
+    mca_btl_vader_segment_destroy (&mca_btl_vader_component);
+    OBJ_DESTRUCT(&mca_btl_vader_component.lock);
+
+#if OMPI_BTL_VADER_HAVE_KNEM
+    if (-1 != mca_btl_vader_component.knem_fd) {
+        close (mca_btl_vader_component.knem_fd);
+        mca_btl_vader_component.knem_fd = -1;
     }
+#endif
 
     return OMPI_SUCCESS;
 }
@@ -191,12 +358,212 @@ static int mca_btl_vader_component_close(void)
 static int mca_btl_base_vader_modex_send (void)
 {
     struct vader_modex_t modex;
+    size_t modex_size;
 
+#if OMPI_BTL_VADER_HAVE_XPMEM
     modex.seg_id = mca_btl_vader_component.my_seg_id;
+#endif
     modex.segment_base = mca_btl_vader_component.my_segment;
+    modex.pid = getpid ();
+
+    /* only send the used part of the shmem descriptor */
+    if (MCA_BTL_VADER_XPMEM != mca_btl_vader_component.single_copy_mechanism) {
+        memcpy (&modex.seg_ds, &mca_btl_vader_component.seg_ds,
+                opal_shmem_sizeof_shmem_ds (&mca_btl_vader_component.seg_ds));
+        modex_size = offsetof (struct vader_modex_t, seg_ds) +
+            opal_shmem_sizeof_shmem_ds (&mca_btl_vader_component.seg_ds);
+    } else {
+        modex_size = offsetof (struct vader_modex_t, seg_ds);
+    }
 
     return ompi_modex_send(&mca_btl_vader_component.super.btl_version,
-                           &modex, sizeof (modex));
+                           &modex, modex_size);
+}
+
+/*
+ * Map segment @a index of this rank (0 is my_segment, the others are its
+ * extensions). With xpmem an anonymous mapping is enough (the peers
+ * attach it through the xpmem segment of the whole address space),
+ * otherwise it has to be backed by a shared memory file.
+ */
+static char *mca_btl_vader_segment_map (mca_btl_vader_component_t *component, int index,
+                                        size_t size, opal_shmem_ds_t *seg_ds)
+{
+    char *file_name, *base;
+    int rc;
+
+    if (MCA_BTL_VADER_XPMEM == component->single_copy_mechanism) {
+        base = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_SHARED, -1, 0);
+        return ((void *)-1 == base) ? NULL : base;
+    }
+
+    if (0 == index) {
+        rc = asprintf (&file_name, "%s"OPAL_PATH_SEP"vader_segment.%s.%d",
+                       ompi_process_info.job_session_dir, ompi_process_info.nodename,
+                       MCA_BTL_VADER_LOCAL_RANK);
+    } else {
+        rc = asprintf (&file_name, "%s"OPAL_PATH_SEP"vader_segment.%s.%d.%d",
+                       ompi_process_info.job_session_dir, ompi_process_info.nodename,
+                       MCA_BTL_VADER_LOCAL_RANK, index);
+    }
+    if (0 > rc) {
+        return NULL;
+    }
+
+    rc = opal_shmem_segment_create (seg_ds, file_name, size);
+    free (file_name);
+    if (OPAL_SUCCESS != rc) {
+        return NULL;
+    }
+
+    base = opal_shmem_segment_attach (seg_ds);
+    if (NULL == base) {
+        (void) opal_shmem_unlink (seg_ds);
+    }
+
+    return base;
+}
+
+/*
+ * Create this rank's segment, starting with the fifo and the (empty)
+ * table of extensions.
+ */
+static int mca_btl_vader_segment_create (mca_btl_vader_component_t *component)
+{
+    vader_segment_table_t *table;
+
+#if OMPI_BTL_VADER_HAVE_XPMEM
+    if (MCA_BTL_VADER_XPMEM == component->single_copy_mechanism) {
+        /* create an xpmem segment for the entire memory space */
+        component->my_seg_id = xpmem_make (0, 0xffffffffffffffffll, XPMEM_PERMIT_MODE,
+                                           (void *)0666);
+        if (-1 == component->my_seg_id) {
+            return OMPI_ERROR;
+        }
+    }
+#endif
+
+    component->my_segment = mca_btl_vader_segment_map (component, 0, component->segment_size,
+                                                       &component->seg_ds);
+    if (NULL == component->my_segment) {
+        return OMPI_ERROR;
+    }
+
+    table = MCA_BTL_VADER_SEGMENT_TABLE(component->my_segment);
+    table->segments[0].base = (uint64_t)(uintptr_t) component->my_segment;
+    table->segments[0].size = component->segment_size;
+    table->num_segments = 1;
+
+    component->num_segments = 1;
+    component->segment_total = component->segment_size;
+
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Add an extension of at least @a min_size bytes, twice as large as the
+ * previous segment, and publish it in the table for the peers. Called
+ * with the component lock held once the last segment is full.
+ */
+int mca_btl_vader_segment_extend (mca_btl_vader_component_t *component, size_t min_size)
+{
+    vader_segment_table_t *table = MCA_BTL_VADER_SEGMENT_TABLE(component->my_segment);
+    struct mca_btl_base_endpoint_t *me = component->endpoints + MCA_BTL_VADER_LOCAL_RANK;
+    const int index = component->num_segments;
+    size_t size;
+    char *base;
+
+    if (MCA_BTL_VADER_MAX_SEGMENTS == index) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    size = 2 * table->segments[index - 1].size;
+    if (size < min_size) {
+        size = OPAL_ALIGN(min_size, 4096, size_t);
+    }
+    if (component->segment_total + size > component->segment_max_size) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    base = mca_btl_vader_segment_map (component, index, size, &table->segments[index].seg_ds);
+    if (NULL == base) {
+        return OMPI_ERROR;
+    }
+
+    opal_output_verbose (10, ompi_btl_base_framework.framework_output,
+                         "btl: vader: extension %d of %lu bytes", index, (unsigned long) size);
+
+    table->segments[index].base = (uint64_t)(uintptr_t) base;
+    table->segments[index].size = size;
+    me->segment_len[index] = size;
+    opal_atomic_wmb ();
+    me->segment_base[index] = base;
+    table->num_segments = index + 1;
+
+    component->num_segments = index + 1;
+    component->segment_total += size;
+    component->segment_offset = 0;
+
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Check that the selected single-copy mechanism is usable and hook up
+ * the matching put/get functions. Falls back on no single copy (and no
+ * RDMA) if it is not.
+ */
+static void mca_btl_vader_select_mechanism (mca_btl_vader_component_t *component)
+{
+    switch (component->single_copy_mechanism) {
+#if OMPI_BTL_VADER_HAVE_XPMEM
+    case MCA_BTL_VADER_XPMEM:
+        mca_btl_vader.super.btl_get = mca_btl_vader_get;
+        mca_btl_vader.super.btl_put = mca_btl_vader_put;
+        return;
+#endif
+#if OMPI_BTL_VADER_HAVE_CMA
+    case MCA_BTL_VADER_CMA:
+#if defined(PR_SET_PTRACER) && defined(PR_SET_PTRACER_ANY)
+        /* allow the local peers to process_vm_readv/writev us */
+        (void) prctl (PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+#endif
+        mca_btl_vader.super.btl_get = mca_btl_vader_get_cma;
+        mca_btl_vader.super.btl_put = mca_btl_vader_put_cma;
+        return;
+#endif
+#if OMPI_BTL_VADER_HAVE_KNEM
+    case MCA_BTL_VADER_KNEM:
+        component->knem_fd = open ("/dev/knem", O_RDWR);
+        if (-1 != component->knem_fd) {
+            struct knem_cmd_info knem_info;
+
+            if (0 == ioctl (component->knem_fd, KNEM_CMD_GET_INFO, &knem_info) &&
+                KNEM_ABI_VERSION == knem_info.abi) {
+                mca_btl_vader.super.btl_get = mca_btl_vader_get_knem;
+                mca_btl_vader.super.btl_put = NULL;
+                return;
+            }
+
+            close (component->knem_fd);
+            component->knem_fd = -1;
+        }
+        opal_output_verbose (1, ompi_btl_base_framework.framework_output,
+                             "btl: vader: can not use knem, falling back on copy in/copy out");
+        break;
+#endif
+    case MCA_BTL_VADER_NONE:
+        break;
+    default:
+        opal_output_verbose (1, ompi_btl_base_framework.framework_output,
+                             "btl: vader: single copy mechanism %d was not built in, "
+                             "falling back on copy in/copy out", component->single_copy_mechanism);
+        break;
+    }
+
+    component->single_copy_mechanism = MCA_BTL_VADER_NONE;
+    mca_btl_vader.super.btl_flags &= ~MCA_BTL_FLAGS_RDMA;
+    mca_btl_vader.super.btl_get = NULL;
+    mca_btl_vader.super.btl_put = NULL;
 }
 
 /*
@@ -225,48 +592,43 @@ static mca_btl_base_module_t **mca_btl_vader_component_init (int *num_btls,
         mca_btl_vader_component.log_attach_align = 25;
     }
 
+    /* the eager fragments also carry the pipelined sends */
+    if (mca_btl_vader.super.btl_max_send_size < mca_btl_vader.super.btl_eager_limit) {
+        mca_btl_vader.super.btl_max_send_size = mca_btl_vader.super.btl_eager_limit;
+    }
+
     btls = (mca_btl_base_module_t **) calloc (1, sizeof (mca_btl_base_module_t *));
     if (NULL == btls) {
         return NULL;
     }
 
-    /* create an xpmem segment for the entire memory space */
-    component->my_seg_id = xpmem_make (0, 0xffffffffffffffffll, XPMEM_PERMIT_MODE,
-                                       (void *)0666);
-    if (-1 == component->my_seg_id) {
-        free (btls);
-        return NULL;
-    }
+    mca_btl_vader_select_mechanism (component);
 
-    /* ensure a sane segment size */
-    if (mca_btl_vader_component.segment_size < (2 << 20)) {
-        mca_btl_vader_component.segment_size = (2 << 20);
+    /* ensure a sane segment size (the fifo, the extension table and the
+       first fragments) */
+    if (mca_btl_vader_component.segment_size < (1 << 19)) {
+        mca_btl_vader_component.segment_size = (1 << 19);
     }
 
-    component->my_segment = mmap (NULL, mca_btl_vader_component.segment_size, PROT_READ |
-                                  PROT_WRITE, MAP_ANONYMOUS | MAP_SHARED, -1, 0);
-    if ((void *)-1 == component->my_segment) {
+    if (OMPI_SUCCESS != mca_btl_vader_segment_create (component)) {
         free (btls);
         return NULL;
     }
 
     component->segment_offset = 0;
 
-    memset (component->my_segment + 4096, MCA_BTL_VADER_FBOX_FREE, MCA_BTL_VADER_NUM_LOCAL_PEERS *
-            MCA_BTL_VADER_FBOX_PEER_SIZE);
-
     /* initialize my fifo */
     rc = vader_fifo_init ((struct vader_fifo_t *) component->my_segment);
     if (OMPI_SUCCESS != rc) {
         free (btls);
-        munmap (component->my_segment, mca_btl_vader_component.segment_size);
+        mca_btl_vader_segment_destroy (component);
         return NULL;
     }
 
     rc = mca_btl_base_vader_modex_send ();
     if (OMPI_SUCCESS != rc) {
         free (btls);
-        munmap (component->my_segment, mca_btl_vader_component.segment_size);
+        mca_btl_vader_segment_destroy (component);
         return NULL;
     }
 
@@ -283,9 +645,11 @@ static mca_btl_base_module_t **mca_btl_vader_component_init (int *num_btls,
 
 static int mca_btl_vader_component_progress (void)
 {
-    mca_btl_vader_frag_t frag = {.base = {.des_dst = frag.segments, .des_dst_cnt = 1}};
+    mca_btl_vader_frag_t frag = {.base = {.des_dst = &frag.segments[0].base, .des_dst_cnt = 1}};
     const int my_smp_rank = MCA_BTL_VADER_LOCAL_RANK;
+#if OMPI_BTL_VADER_HAVE_XPMEM
     mca_mpool_base_registration_t *xpmem_reg = NULL;
+#endif
     const mca_btl_active_message_callback_t *reg;
     struct mca_btl_base_endpoint_t *endpoint;
     mca_btl_vader_hdr_t *hdr; 
@@ -305,26 +669,40 @@ static int mca_btl_vader_component_progress (void)
             mca_btl_vader_frag_complete (hdr->frag);
             continue;
         }
- 
-        reg = mca_btl_base_active_message_trigger + hdr->tag;
-        frag.segments[0].seg_addr.pval = (void *) (hdr + 1);
-        frag.segments[0].seg_len       = hdr->len;
 
         endpoint = mca_btl_vader_component.endpoints + hdr->src_smp_rank;
 
+        if (OPAL_UNLIKELY(hdr->flags & MCA_BTL_VADER_FLAG_SETUP_FBOX)) {
+            /* the peer carved a fast box for us out of its segment. start polling it */
+            endpoint->fbox_in = relative2virtual (*((int64_t *) (hdr + 1)));
+            endpoint->next_fbox_in = 0;
+            mca_btl_vader_component.fbox_in_endpoints[mca_btl_vader_component.num_fbox_in_endpoints++] = endpoint;
+
+            hdr->flags = MCA_BTL_VADER_FLAG_COMPLETE;
+            vader_fifo_write_back (hdr, endpoint);
+            continue;
+        }
+
+        reg = mca_btl_base_active_message_trigger + hdr->tag;
+        frag.segments[0].base.seg_addr.pval = (void *) (hdr + 1);
+        frag.segments[0].base.seg_len       = hdr->len;
+
+#if OMPI_BTL_VADER_HAVE_XPMEM
         if (hdr->flags & MCA_BTL_VADER_FLAG_SINGLE_COPY) {
             xpmem_reg = vader_get_registation (endpoint, hdr->sc_iov.iov_base,
                                                hdr->sc_iov.iov_len, 0,
-                                               &frag.segments[1].seg_addr.pval);
+                                               &frag.segments[1].base.seg_addr.pval);
 
-            frag.segments[1].seg_len       = hdr->sc_iov.iov_len;
+            frag.segments[1].base.seg_len       = hdr->sc_iov.iov_len;
 
             /* recv upcall */
             frag.base.des_dst_cnt = 2;
             reg->cbfunc(&mca_btl_vader.super, hdr->tag, &(frag.base), reg->cbdata);
             frag.base.des_dst_cnt = 1;
             vader_return_registration (xpmem_reg, endpoint);
-        } else {
+        } else
+#endif
+        {
             reg->cbfunc(&mca_btl_vader.super, hdr->tag, &(frag.base), reg->cbdata);
         }
 
@@ -24,9 +24,17 @@
 #ifndef MCA_BTL_VADER_ENDPOINT_H
 #define MCA_BTL_VADER_ENDPOINT_H
 
+#if OMPI_BTL_VADER_HAVE_XPMEM
 #include <xpmem.h>
+#endif
+
+#include "opal/mca/shmem/shmem_types.h"
 
 struct vader_fifo_t;
+struct ompi_proc_t;
+
+/* a segment and up to 7 extensions per process (see mca_btl_vader_segment_extend) */
+#define MCA_BTL_VADER_MAX_SEGMENTS 8
 
 /**
  *  An abstraction that represents a connection to a endpoint process.
@@ -37,13 +45,22 @@ struct vader_fifo_t;
 struct mca_btl_base_endpoint_t {
     int peer_smp_rank;  /**< My peer's SMP process rank.  Used for accessing
                          *   SMP specfic data structures. */
-    char         *segment_base;
-    struct vader_fifo_t *fifo;
+    struct ompi_proc_t *proc;   /**< peer process (for the modex) */
+    /** peer segment and its extensions, NULL until first used */
+    char         *segment_base[MCA_BTL_VADER_MAX_SEGMENTS];
+    size_t        segment_len[MCA_BTL_VADER_MAX_SEGMENTS];
+    struct vader_fifo_t *fifo;  /**< NULL until the segment is attached */
+#if OMPI_BTL_VADER_HAVE_XPMEM
     xpmem_apid_t  apid;
+#endif
+    pid_t         pid;          /**< peer pid (CMA) */
+    opal_shmem_ds_t seg_ds;     /**< peer segment when not attached through xpmem */
+    opal_shmem_ds_t *seg_ext_ds[MCA_BTL_VADER_MAX_SEGMENTS]; /**< and its extensions */
     char         *fbox_out;
     char         *fbox_in;
     int           next_fbox_out;
     int           next_fbox_in;
+    int           fbox_send_count; /**< messages sent before the fast box was set up */
     struct mca_rcache_base_module_t *rcache;
 };
 
@@ -0,0 +1,71 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2011-2013 Los Alamos National Security, LLC.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "btl_vader.h"
+#include "btl_vader_frag.h"
+#include "btl_vader_fifo.h"
+#include "btl_vader_fbox.h"
+
+/**
+ * Set up a fast box to a peer.
+ *
+ * The fast box is carved out of the unused portion of my segment and its
+ * location is sent to the peer through its fifo. The peer adds us to its
+ * list of fast boxes to poll when it receives the message so polling
+ * costs scale with the number of active peers instead of the number of
+ * local processes.
+ *
+ * @param ep (IN)       BTL peer addressing
+ */
+void mca_btl_vader_fbox_setup (struct mca_btl_base_endpoint_t *ep)
+{
+    mca_btl_vader_component_t *component = &mca_btl_vader_component;
+    mca_btl_vader_frag_t *frag;
+    char *fbox;
+
+    if (ep->peer_smp_rank == MCA_BTL_VADER_LOCAL_RANK ||
+        component->fbox_count >= component->fbox_max ||
+        OMPI_SUCCESS != mca_btl_vader_endpoint_check (ep)) {
+        return;
+    }
+
+    (void) MCA_BTL_VADER_FRAG_ALLOC_USER(frag);
+    if (OPAL_UNLIKELY(NULL == frag)) {
+        /* try again on the next send */
+        --ep->fbox_send_count;
+        return;
+    }
+
+    fbox = mca_btl_vader_segment_alloc (MCA_BTL_VADER_FBOX_PEER_SIZE);
+    if (NULL == fbox) {
+        /* out of space. this peer will not get a fast box */
+        MCA_BTL_VADER_FRAG_RETURN(frag);
+        return;
+    }
+
+    component->fbox_count++;
+    memset (fbox, MCA_BTL_VADER_FBOX_FREE, MCA_BTL_VADER_FBOX_PEER_SIZE);
+
+    frag->hdr->flags = MCA_BTL_VADER_FLAG_SETUP_FBOX;
+    frag->hdr->len   = sizeof (int64_t);
+    *((int64_t *) frag->segments[0].base.seg_addr.pval) = virtual2relative (fbox);
+
+    frag->base.des_flags = MCA_BTL_DES_FLAGS_BTL_OWNERSHIP;
+    frag->endpoint       = ep;
+
+    /* the fifo write orders the memset above with the notification */
+    vader_fifo_write (frag->hdr, ep);
+
+    ep->next_fbox_out = 0;
+    ep->fbox_out      = fbox;
+}
@@ -34,10 +34,24 @@ enum {MCA_BTL_VADER_FBOX_FREE = 0, MCA_BTL_VADER_FBOX_RESERVED = 0x80};
 #define MCA_BTL_VADER_FBOX_IN_PTR(ep, fbox) ((ep)->fbox_in + MCA_BTL_VADER_FBOX_SIZE * (fbox))
 #define MCA_BTL_VADER_NEXT_FBOX(fbox) (((fbox) + 1) & MCA_BTL_VADER_LAST_FBOX)
 
+void mca_btl_vader_fbox_setup (struct mca_btl_base_endpoint_t *ep);
+
 static inline unsigned char * restrict mca_btl_vader_reserve_fbox (struct mca_btl_base_endpoint_t *ep, const size_t size)
 {
     const int next_fbox = ep->next_fbox_out;
-    unsigned char * restrict fbox = (unsigned char * restrict) MCA_BTL_VADER_FBOX_OUT_PTR(ep, next_fbox);  
+    unsigned char * restrict fbox;
+
+    if (OPAL_UNLIKELY(NULL == ep->fbox_out)) {
+        /* only peers we talk to often get a fast box */
+        if (ep->fbox_send_count < mca_btl_vader_component.fbox_threshold &&
+            ++ep->fbox_send_count == mca_btl_vader_component.fbox_threshold) {
+            mca_btl_vader_fbox_setup (ep);
+        }
+
+        return NULL;
+    }
+
+    fbox = (unsigned char * restrict) MCA_BTL_VADER_FBOX_OUT_PTR(ep, next_fbox);
 
     /* todo -- need thread locks/atomics here for the multi-threaded case */
     if (OPAL_LIKELY(size <= MCA_BTL_VADER_FBOX_MAX_SIZE && fbox[0] == MCA_BTL_VADER_FBOX_FREE)) {
@@ -94,30 +108,28 @@ static inline int mca_btl_vader_fbox_sendi (struct mca_btl_base_endpoint_t *endp
 
 static inline void mca_btl_vader_check_fboxes (void)
 {
-    mca_btl_vader_frag_t frag = {.base = {.des_dst = frag.segments, .des_dst_cnt = 1}};
-    const int num_smp_procs = MCA_BTL_VADER_NUM_LOCAL_PEERS + 1;
+    mca_btl_vader_frag_t frag = {.base = {.des_dst = &frag.segments[0].base, .des_dst_cnt = 1}};
+    const int num_fbox_peers = mca_btl_vader_component.num_fbox_in_endpoints;
     const mca_btl_active_message_callback_t *reg;
     struct mca_btl_base_endpoint_t *endpoint;
     unsigned char * restrict fbox;
     int i, next_fbox;
 
-    for (i = 0, endpoint = mca_btl_vader_component.endpoints ; i < num_smp_procs ; ++i, ++endpoint) {
-        if (NULL == endpoint->fbox_in) {
-            continue;
-        }
-
+    /* only the peers that set up a fast box to us are polled */
+    for (i = 0 ; i < num_fbox_peers ; ++i) {
+        endpoint = mca_btl_vader_component.fbox_in_endpoints[i];
         next_fbox = endpoint->next_fbox_in;
         fbox = (unsigned char *) MCA_BTL_VADER_FBOX_IN_PTR(endpoint, next_fbox);
 
         /* process all fast-box messages */
-        while ((frag.segments[0].seg_len = fbox[0]) & 0x7f) {
+        while ((frag.segments[0].base.seg_len = fbox[0]) & 0x7f) {
             const unsigned char tag = fbox[1];
 
             opal_atomic_rmb ();
 
             reg = mca_btl_base_active_message_trigger + tag;
 
-            frag.segments[0].seg_addr.pval = fbox + 2;
+            frag.segments[0].base.seg_addr.pval = fbox + 2;
 
             reg->cbfunc(&mca_btl_vader.super, tag, &(frag.base), reg->cbdata);
 
@@ -71,14 +71,14 @@ static inline void _vader_fifo_write (vader_fifo_t *fifo, int64_t value)
 
     assert (prev != value);
 
+    /* publish the frag with release stores: the reader pairs them with
+       acquire loads, so no full barrier is needed on either side */
     if (OPAL_LIKELY(VADER_FIFO_FREE != prev)) {
         mca_btl_vader_hdr_t *hdr = (mca_btl_vader_hdr_t *) relative2virtual (prev);
-        hdr->next = value;
+        opal_atomic_store_rel_ptr (&hdr->next, (void *) value);
     } else {
-        fifo->fifo_head = value;
+        opal_atomic_store_rel_64 (&fifo->fifo_head, value);
     }
-
-    opal_atomic_wmb ();
 }
 
 /* write a frag (relative to this process' base) to another rank's fifo */
@@ -117,18 +117,14 @@ static inline mca_btl_vader_hdr_t *vader_fifo_read (vader_fifo_t *fifo)
 
         if (!opal_atomic_cmpset_ptr (&fifo->fifo_tail, (void *)value,
                                      (void *)VADER_FIFO_FREE)) {
-            while (VADER_FIFO_FREE == hdr->next) {
-                opal_atomic_rmb ();
-            }
+            while (VADER_FIFO_FREE == (intptr_t) opal_atomic_load_acq_ptr (&hdr->next));
 
-            fifo->fifo_head = hdr->next;
+            opal_atomic_store_rel_64 (&fifo->fifo_head, hdr->next);
         }
     } else {
-        fifo->fifo_head = hdr->next;
+        opal_atomic_store_rel_64 (&fifo->fifo_head, hdr->next);
     }
 
-    opal_atomic_wmb ();
-
     return hdr; 
 }
 
@@ -31,12 +31,12 @@ static inline void mca_btl_vader_frag_constructor (mca_btl_vader_frag_t *frag)
     if(frag->hdr != NULL) {
         frag->hdr->src_smp_rank = MCA_BTL_VADER_LOCAL_RANK;
         frag->hdr->frag = frag;
-        frag->segments[0].seg_addr.pval = (char *)(frag->hdr + 1);
+        frag->segments[0].base.seg_addr.pval = (char *)(frag->hdr + 1);
     }
 
-    frag->base.des_src     = frag->segments;
+    frag->base.des_src     = &frag->segments[0].base;
     frag->base.des_src_cnt = 1;
-    frag->base.des_dst     = frag->segments;
+    frag->base.des_dst     = &frag->segments[0].base;
     frag->base.des_dst_cnt = 1;
 }
 
@@ -44,25 +44,23 @@ void mca_btl_vader_frag_init (ompi_free_list_item_t *item, void *ctx)
 {
     unsigned int frag_size = (unsigned int)(uintptr_t) ctx;
 
-    if (mca_btl_vader_component.segment_size < mca_btl_vader_component.segment_offset + frag_size) {
-        item->ptr = NULL;
+    /* NULL once the segment can not be extended any more */
+    item->ptr = mca_btl_vader_segment_alloc (frag_size);
+    if (NULL == item->ptr) {
         return;
     }
 
-    item->ptr = mca_btl_vader_component.my_segment + mca_btl_vader_component.segment_offset;
-    mca_btl_vader_component.segment_offset += frag_size;
-
     mca_btl_vader_frag_constructor ((mca_btl_vader_frag_t *) item);
 }
 
 void mca_btl_vader_frag_return (mca_btl_vader_frag_t *frag)
 {
-    frag->base.des_src     = frag->segments;
+    frag->base.des_src     = &frag->segments[0].base;
     frag->base.des_src_cnt = 1;
-    frag->base.des_dst     = frag->segments;
+    frag->base.des_dst     = &frag->segments[0].base;
     frag->base.des_dst_cnt = 1;
     frag->hdr->flags       = 0;
-    frag->segments[0].seg_addr.pval = (char *)(frag->hdr + 1);
+    frag->segments[0].base.seg_addr.pval = (char *)(frag->hdr + 1);
 
     OMPI_FREE_LIST_RETURN_MT(frag->my_list, (ompi_free_list_item_t *)frag);
 }
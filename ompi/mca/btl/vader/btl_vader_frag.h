@@ -30,6 +30,7 @@
 #define MCA_BTL_VADER_FLAG_SINGLE_COPY 1
 #define MCA_BTL_VADER_FLAG_FBOX        2
 #define MCA_BTL_VADER_FLAG_COMPLETE    4
+#define MCA_BTL_VADER_FLAG_SETUP_FBOX  8
 
 struct mca_btl_vader_frag_t;
 
@@ -44,12 +45,23 @@ struct mca_btl_vader_hdr_t {
 };
 typedef struct mca_btl_vader_hdr_t mca_btl_vader_hdr_t;
 
+/**
+ * vader segment: the base segment plus what a peer needs to access the
+ * memory with the selected single-copy mechanism (the knem cookie).
+ * btl_seg_size is set to the size of this structure.
+ */
+struct mca_btl_vader_segment_t {
+    mca_btl_base_segment_t base;
+    uint64_t key;
+};
+typedef struct mca_btl_vader_segment_t mca_btl_vader_segment_t;
+
 /**
  * shared memory send fragment derived type.
  */
 struct mca_btl_vader_frag_t {
     mca_btl_base_descriptor_t base;
-    mca_btl_base_segment_t segments[2];
+    mca_btl_vader_segment_t segments[2];
     struct mca_btl_base_endpoint_t *endpoint;
     mca_btl_vader_hdr_t *hdr; /* in the shared memory region */
     ompi_free_list_t *my_list;
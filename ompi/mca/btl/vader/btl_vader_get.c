@@ -11,11 +11,27 @@
 
 #include "ompi_config.h"
 
+#include <errno.h>
+
+#include "opal/util/output.h"
+
 #include "btl_vader.h"
 #include "btl_vader_frag.h"
 #include "btl_vader_endpoint.h"
 #include "btl_vader_xpmem.h"
 
+#if OMPI_BTL_VADER_HAVE_CMA
+#include <sys/uio.h>
+#if OMPI_BTL_VADER_CMA_NEED_SYSCALL_DEFS
+#include "opal/sys/cma.h"
+#endif /* OMPI_BTL_VADER_CMA_NEED_SYSCALL_DEFS */
+#endif /* OMPI_BTL_VADER_HAVE_CMA */
+
+#if OMPI_BTL_VADER_HAVE_KNEM
+#include <sys/ioctl.h>
+#endif /* OMPI_BTL_VADER_HAVE_KNEM */
+
+#if OMPI_BTL_VADER_HAVE_XPMEM
 /**
  * Initiate an synchronous get.
  *
@@ -47,3 +63,72 @@ int mca_btl_vader_get (struct mca_btl_base_module_t *btl,
 
     return OMPI_SUCCESS;
 }
+#endif /* OMPI_BTL_VADER_HAVE_XPMEM */
+
+#if OMPI_BTL_VADER_HAVE_CMA
+/**
+ * Initiate an synchronous get with a single process_vm_readv.
+ */
+int mca_btl_vader_get_cma (struct mca_btl_base_module_t *btl,
+                           struct mca_btl_base_endpoint_t *endpoint,
+                           struct mca_btl_base_descriptor_t *des)
+{
+    mca_btl_vader_frag_t *frag = (mca_btl_vader_frag_t *) des;
+    mca_btl_base_segment_t *src = des->des_src;
+    mca_btl_base_segment_t *dst = des->des_dst;
+    const size_t size = min(dst->seg_len, src->seg_len);
+    struct iovec src_iov = {.iov_base = src->seg_addr.pval, .iov_len = size};
+    struct iovec dst_iov = {.iov_base = dst->seg_addr.pval, .iov_len = size};
+    ssize_t ret;
+
+    ret = process_vm_readv (endpoint->pid, &dst_iov, 1, &src_iov, 1, 0);
+    if (OPAL_UNLIKELY(ret != (ssize_t) size)) {
+        opal_output (0, "mca_btl_vader_get_cma: process_vm_readv failed (%ld of %lu bytes): %d",
+                     (long) ret, (unsigned long) size, errno);
+        return OMPI_ERROR;
+    }
+
+    mca_btl_vader_frag_complete (frag);
+
+    return OMPI_SUCCESS;
+}
+#endif /* OMPI_BTL_VADER_HAVE_CMA */
+
+#if OMPI_BTL_VADER_HAVE_KNEM
+/**
+ * Initiate an synchronous get from the knem region the peer created
+ * in prepare_src (the cookie travels in the segment key).
+ */
+int mca_btl_vader_get_knem (struct mca_btl_base_module_t *btl,
+                            struct mca_btl_base_endpoint_t *endpoint,
+                            struct mca_btl_base_descriptor_t *des)
+{
+    mca_btl_vader_frag_t *frag = (mca_btl_vader_frag_t *) des;
+    mca_btl_vader_segment_t *src = (mca_btl_vader_segment_t *) des->des_src;
+    mca_btl_vader_segment_t *dst = (mca_btl_vader_segment_t *) des->des_dst;
+    const size_t size = min(dst->base.seg_len, src->base.seg_len);
+    struct knem_cmd_param_iovec recv_iovec;
+    struct knem_cmd_inline_copy icopy;
+
+    recv_iovec.base = (uintptr_t) dst->base.seg_addr.lval;
+    recv_iovec.len  = size;
+
+    /* synchronous copy: the data is there when the ioctl returns */
+    icopy.local_iovec_array = (uintptr_t) &recv_iovec;
+    icopy.local_iovec_nr    = 1;
+    icopy.remote_cookie     = src->key;
+    icopy.remote_offset     = 0;
+    icopy.write             = 0;
+    icopy.flags             = 0;
+
+    if (OPAL_UNLIKELY(0 != ioctl (mca_btl_vader_component.knem_fd, KNEM_CMD_INLINE_COPY, &icopy) ||
+                      KNEM_STATUS_FAILED == icopy.current_status)) {
+        opal_output (0, "mca_btl_vader_get_knem: knem inline copy failed: %d", errno);
+        return OMPI_ERROR;
+    }
+
+    mca_btl_vader_frag_complete (frag);
+
+    return OMPI_SUCCESS;
+}
+#endif /* OMPI_BTL_VADER_HAVE_KNEM */
@@ -27,6 +27,12 @@
 #include "btl_vader_endpoint.h"
 #include "btl_vader_fifo.h"
 #include "btl_vader_fbox.h"
+#include "btl_vader_xpmem.h"
+
+#if OMPI_BTL_VADER_HAVE_KNEM
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#endif /* OMPI_BTL_VADER_HAVE_KNEM */
 
 static int vader_del_procs (struct mca_btl_base_module_t *btl,
                             size_t nprocs, struct ompi_proc_t **procs,
@@ -91,8 +97,14 @@ mca_btl_vader_t mca_btl_vader = {
         .btl_prepare_dst = vader_prepare_dst,
         .btl_send = mca_btl_vader_send,
         .btl_sendi = mca_btl_vader_sendi,
+#if OMPI_BTL_VADER_HAVE_XPMEM
         .btl_put = mca_btl_vader_put,
         .btl_get = mca_btl_vader_get,
+#else
+        /* set up by the component depending on the single-copy mechanism */
+        .btl_put = NULL,
+        .btl_get = NULL,
+#endif
         .btl_dump = mca_btl_base_dump,
         .btl_mpool = NULL,
         .btl_register_error = vader_register_error_cb,
@@ -103,12 +115,29 @@ mca_btl_vader_t mca_btl_vader = {
 static int vader_btl_first_time_init(mca_btl_vader_t *vader_btl, int n)
 {
     mca_btl_vader_component_t *component = &mca_btl_vader_component;
+    struct mca_btl_base_endpoint_t *me;
     int rc;
 
     /* generate the endpoints */
     component->endpoints = (struct mca_btl_base_endpoint_t *) calloc (n, sizeof (struct mca_btl_base_endpoint_t));
 
-    component->segment_offset = (n - 1) * MCA_BTL_VADER_FBOX_PEER_SIZE + 4096;
+    /* fast boxes are set up on demand (see mca_btl_vader_fbox_setup) */
+    component->fbox_in_endpoints = (struct mca_btl_base_endpoint_t **) calloc (n, sizeof (struct mca_btl_base_endpoint_t *));
+    if (NULL == component->endpoints || NULL == component->fbox_in_endpoints) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    /* my own segment is always attached. it translates my relative
+       addresses and the fragments below are carved out of it */
+    me = component->endpoints + MCA_BTL_VADER_LOCAL_RANK;
+    me->segment_base[0] = component->my_segment;
+    me->segment_len[0]  = component->segment_size;
+    me->fifo = (struct vader_fifo_t *) component->my_segment;
+
+    component->num_fbox_in_endpoints = 0;
+    component->fbox_count = 0;
+    /* the fifo and the extension table come first */
+    component->segment_offset = MCA_BTL_VADER_SEGMENT_START;
 
     /* initialize fragment descriptor free lists */
     /* initialize free list for put/get/single copy/inline fragments */
@@ -136,7 +165,7 @@ static int vader_btl_first_time_init(mca_btl_vader_t *vader_btl, int n)
                                     component->vader_free_list_inc,
                                     NULL, mca_btl_vader_frag_init,
                                     (void *) (sizeof (mca_btl_vader_hdr_t) +
-                                              mca_btl_vader.super.btl_eager_limit));
+                                              mca_btl_vader.super.btl_max_send_size));
     if (OMPI_SUCCESS != rc) {
         return rc;
     }
@@ -149,42 +178,169 @@ static int vader_btl_first_time_init(mca_btl_vader_t *vader_btl, int n)
 
 
 static int init_vader_endpoint (struct mca_btl_base_endpoint_t *ep, struct ompi_proc_t *proc, int remote_rank) {
-    const int fbox_in_offset = MCA_BTL_VADER_LOCAL_RANK - (MCA_BTL_VADER_LOCAL_RANK > remote_rank);
-    const int fbox_out_offset = remote_rank - (MCA_BTL_VADER_LOCAL_RANK < remote_rank);
+    if (NULL != ep->proc) {
+        /* already set up by a previous call */
+        return OMPI_SUCCESS;
+    }
+
+    ep->peer_smp_rank = remote_rank;
+    ep->proc = proc;
+
+    if (remote_rank != MCA_BTL_VADER_LOCAL_RANK) {
+        /* the segment is attached when we first talk to this peer or
+           see an address in it (mca_btl_vader_endpoint_attach) */
+        ep->next_fbox_out = 0;
+        ep->next_fbox_in  = 0;
+        ep->fbox_send_count = 0;
+        ep->fifo     = NULL;
+        /* the fast boxes are set up once the peer turns out to be a frequent target */
+        ep->fbox_in  = NULL;
+        ep->fbox_out = NULL;
+    }
+    /* my own segments are set up by vader_btl_first_time_init and
+       mca_btl_vader_segment_extend */
+
+    return OMPI_SUCCESS;
+}
+
+static int vader_attach_segment (struct mca_btl_base_endpoint_t *ep)
+{
     mca_btl_vader_component_t *component = &mca_btl_vader_component;
     struct vader_modex_t *modex;
     size_t msg_size;
+    char *base;
     int rc;
 
-    ep->peer_smp_rank = remote_rank;
+    if (OMPI_SUCCESS != (rc = ompi_modex_recv(&component->super.btl_version,
+                                              ep->proc, (void *)&modex, &msg_size))) {
+        return rc;
+    }
 
-    if (remote_rank != MCA_BTL_VADER_LOCAL_RANK) {
-        if (OMPI_SUCCESS != (rc = ompi_modex_recv(&component->super.btl_version,
-                                                  proc, (void *)&modex, &msg_size))) {
-            return rc;
-        }
+    ep->pid = modex->pid;
 
+#if OMPI_BTL_VADER_HAVE_XPMEM
+    if (MCA_BTL_VADER_XPMEM == component->single_copy_mechanism) {
         ep->apid = xpmem_get (modex->seg_id, XPMEM_RDWR, XPMEM_PERMIT_MODE, (void *) 0666);
         ep->rcache = mca_rcache_base_module_create("vma");
-        ep->next_fbox_out = 0;
-        ep->next_fbox_in  = 0;
 
         /* attatch to the remote segment */
-        (void) vader_get_registation (ep, modex->segment_base, mca_btl_vader_component.segment_size,
-                                      MCA_MPOOL_FLAGS_PERSIST, (void **) &ep->segment_base);
+        if (NULL == vader_get_registation (ep, modex->segment_base, mca_btl_vader_component.segment_size,
+                                           MCA_MPOOL_FLAGS_PERSIST, (void **) &base)) {
+            return OMPI_ERROR;
+        }
+    } else
+#endif
+    {
+        /* the segment is a regular shared memory file */
+        memcpy (&ep->seg_ds, &modex->seg_ds, opal_shmem_sizeof_shmem_ds (&modex->seg_ds));
+        base = opal_shmem_segment_attach (&ep->seg_ds);
+        if (NULL == base) {
+            return OMPI_ERROR;
+        }
+    }
 
-        ep->fifo     = (struct vader_fifo_t *) ep->segment_base;
-        ep->fbox_in  = ep->segment_base + 4096 + fbox_in_offset * MCA_BTL_VADER_FBOX_PEER_SIZE;
-        ep->fbox_out = component->my_segment + 4096 + fbox_out_offset * MCA_BTL_VADER_FBOX_PEER_SIZE;
-    } else {
-        /* set up the segment base so we can calculate a virtual to real for local pointers */
-        ep->segment_base = component->my_segment;
-        ep->fifo = (struct vader_fifo_t *) ep->segment_base;
+    /* lock-free readers test the base */
+    ep->segment_len[0] = MCA_BTL_VADER_SEGMENT_TABLE(base)->segments[0].size;
+    opal_atomic_wmb ();
+    ep->segment_base[0] = base;
+    ep->fifo = (struct vader_fifo_t *) base;
+
+    return OMPI_SUCCESS;
+}
+
+static int vader_attach_extension (struct mca_btl_base_endpoint_t *ep, int segment)
+{
+    vader_segment_table_t *table = MCA_BTL_VADER_SEGMENT_TABLE(ep->segment_base[0]);
+    char *base;
+
+    if (segment >= table->num_segments) {
+        return OMPI_ERR_BAD_PARAM;
     }
+    opal_atomic_rmb ();
+
+#if OMPI_BTL_VADER_HAVE_XPMEM
+    if (MCA_BTL_VADER_XPMEM == mca_btl_vader_component.single_copy_mechanism) {
+        if (NULL == vader_get_registation (ep, (void *)(uintptr_t) table->segments[segment].base,
+                                           table->segments[segment].size, MCA_MPOOL_FLAGS_PERSIST,
+                                           (void **) &base)) {
+            return OMPI_ERROR;
+        }
+    } else
+#endif
+    {
+        opal_shmem_ds_t *seg_ds = (opal_shmem_ds_t *) malloc (sizeof (*seg_ds));
+
+        if (NULL == seg_ds) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+
+        memcpy (seg_ds, &table->segments[segment].seg_ds,
+                opal_shmem_sizeof_shmem_ds (&table->segments[segment].seg_ds));
+        base = opal_shmem_segment_attach (seg_ds);
+        if (NULL == base) {
+            free (seg_ds);
+            return OMPI_ERROR;
+        }
+        ep->seg_ext_ds[segment] = seg_ds;
+    }
+
+    ep->segment_len[segment] = table->segments[segment].size;
+    opal_atomic_wmb ();
+    ep->segment_base[segment] = base;
 
     return OMPI_SUCCESS;
 }
 
+int mca_btl_vader_endpoint_attach (struct mca_btl_base_endpoint_t *ep, int segment)
+{
+    mca_btl_vader_component_t *component = &mca_btl_vader_component;
+    int rc = OMPI_SUCCESS;
+
+    OPAL_THREAD_LOCK(&component->lock);
+    if (NULL == ep->segment_base[0]) {
+        rc = vader_attach_segment (ep);
+    }
+    if (OMPI_SUCCESS == rc && NULL == ep->segment_base[segment]) {
+        rc = vader_attach_extension (ep, segment);
+    }
+    OPAL_THREAD_UNLOCK(&component->lock);
+
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != rc)) {
+        opal_output (0, "btl: vader: could not attach segment %d of local rank %d", segment,
+                     ep->peer_smp_rank);
+        if (NULL != mca_btl_vader.error_cb) {
+            mca_btl_vader.error_cb (&mca_btl_vader.super, MCA_BTL_ERROR_FLAGS_FATAL, ep->proc, NULL);
+        }
+    }
+
+    return rc;
+}
+
+void *mca_btl_vader_segment_alloc (size_t size)
+{
+    mca_btl_vader_component_t *component = &mca_btl_vader_component;
+    struct mca_btl_base_endpoint_t *me = component->endpoints + MCA_BTL_VADER_LOCAL_RANK;
+    void *ptr = NULL;
+    size_t offset;
+
+    OPAL_THREAD_LOCK(&component->lock);
+    offset = OPAL_ALIGN(component->segment_offset, opal_cache_line_size, size_t);
+    if (me->segment_len[component->num_segments - 1] < offset + size) {
+        /* the rest of this one is lost */
+        if (OMPI_SUCCESS != mca_btl_vader_segment_extend (component, size)) {
+            goto out;
+        }
+        offset = 0;
+    }
+
+    ptr = me->segment_base[component->num_segments - 1] + offset;
+    component->segment_offset = offset + size;
+out:
+    OPAL_THREAD_UNLOCK(&component->lock);
+
+    return ptr;
+}
+
 /**
  * PML->BTL notification of change in the process list.
  * PML->BTL Notification that a receive fragment has been matched.
@@ -253,7 +409,10 @@ static int vader_add_procs (struct mca_btl_base_module_t* btl,
 
         /* setup endpoint */
         peers[proc] = component->endpoints + local_rank;
-        init_vader_endpoint (peers[proc], procs[proc], local_rank++);
+        rc = init_vader_endpoint (peers[proc], procs[proc], local_rank++);
+        if (OMPI_SUCCESS != rc) {
+            return rc;
+        }
     }
 
     return OMPI_SUCCESS;
@@ -292,6 +451,33 @@ static int vader_del_procs(struct mca_btl_base_module_t *btl,
 
 static int vader_finalize(struct mca_btl_base_module_t *btl)
 {
+    mca_btl_vader_component_t *component = &mca_btl_vader_component;
+    int i, j;
+
+    if (NULL == component->endpoints ||
+        MCA_BTL_VADER_XPMEM == component->single_copy_mechanism) {
+        return OMPI_SUCCESS;
+    }
+
+    /* detach from the peer segments we attached through opal_shmem */
+    for (i = 0 ; i < 1 + MCA_BTL_VADER_NUM_LOCAL_PEERS ; ++i) {
+        struct mca_btl_base_endpoint_t *ep = component->endpoints + i;
+
+        if (i == MCA_BTL_VADER_LOCAL_RANK || NULL == ep->fifo) {
+            continue;
+        }
+
+        for (j = 1 ; j < MCA_BTL_VADER_MAX_SEGMENTS ; ++j) {
+            if (NULL != ep->seg_ext_ds[j]) {
+                (void) opal_shmem_segment_detach (ep->seg_ext_ds[j]);
+                free (ep->seg_ext_ds[j]);
+                ep->seg_ext_ds[j] = NULL;
+            }
+        }
+        (void) opal_shmem_segment_detach (&ep->seg_ds);
+        ep->fifo = NULL;
+    }
+
     return OMPI_SUCCESS;
 }
 
@@ -324,12 +510,12 @@ mca_btl_base_descriptor_t *mca_btl_vader_alloc(struct mca_btl_base_module_t *btl
 
     if (size <= (size_t) mca_btl_vader_component.max_inline_send) {
         (void) MCA_BTL_VADER_FRAG_ALLOC_USER(frag);
-    } else if (size <= mca_btl_vader.super.btl_eager_limit) {
+    } else if (size <= mca_btl_vader.super.btl_max_send_size) {
         (void) MCA_BTL_VADER_FRAG_ALLOC_EAGER(frag);
     }
 
     if (OPAL_LIKELY(frag != NULL)) {
-        frag->segments[0].seg_len  = size;
+        frag->segments[0].base.seg_len  = size;
         frag->endpoint         = endpoint;
 
         frag->base.des_flags   = flags;
@@ -369,8 +555,8 @@ struct mca_btl_base_descriptor_t *vader_prepare_dst(struct mca_btl_base_module_t
     
     opal_convertor_get_current_pointer (convertor, &data_ptr);
 
-    frag->segments[0].seg_addr.lval = (uint64_t)(uintptr_t) data_ptr;
-    frag->segments[0].seg_len       = *size;
+    frag->segments[0].base.seg_addr.lval = (uint64_t)(uintptr_t) data_ptr;
+    frag->segments[0].base.seg_len       = *size;
     
     frag->base.order       = order;
     frag->base.des_flags   = flags;
@@ -412,7 +598,7 @@ static struct mca_btl_base_descriptor_t *vader_prepare_src (struct mca_btl_base_
 
             iov.iov_len = *size;
             iov.iov_base =
-                (IOVBASE_TYPE *)(((uintptr_t)(frag->segments[0].seg_addr.pval)) +
+                (IOVBASE_TYPE *)(((uintptr_t)(frag->segments[0].base.seg_addr.pval)) +
                                  reserve);
 
             rc = opal_convertor_pack (convertor, &iov, &iov_count, size);
@@ -421,24 +607,31 @@ static struct mca_btl_base_descriptor_t *vader_prepare_src (struct mca_btl_base_
                 return NULL;
             }
 
-            frag->segments[0].seg_len = total_size;
+            frag->segments[0].base.seg_len = total_size;
         } else {
-            (void) MCA_BTL_VADER_FRAG_ALLOC_USER(frag);
+            const bool single_copy = MCA_BTL_VADER_XPMEM == mca_btl_vader_component.single_copy_mechanism;
+
+            if (single_copy || total_size <= (size_t) mca_btl_vader_component.max_inline_send) {
+                (void) MCA_BTL_VADER_FRAG_ALLOC_USER(frag);
+            } else {
+                /* without xpmem the data has to be copied into the segment */
+                (void) MCA_BTL_VADER_FRAG_ALLOC_EAGER(frag);
+            }
             if (OPAL_UNLIKELY(NULL == frag)) {
                 return NULL;
             }
 
-            if (total_size > (size_t) mca_btl_vader_component.max_inline_send) {
-                /* single copy send */
+            if (single_copy && total_size > (size_t) mca_btl_vader_component.max_inline_send) {
+                /* single copy send (the receiver needs to map our memory) */
                 frag->hdr->flags = MCA_BTL_VADER_FLAG_SINGLE_COPY;
 
                 /* set up single copy io vector */
                 frag->hdr->sc_iov.iov_base = data_ptr;
                 frag->hdr->sc_iov.iov_len  = *size;
 
-                frag->segments[0].seg_len = reserve;
-                frag->segments[1].seg_len = *size;
-                frag->segments[1].seg_addr.pval = data_ptr;
+                frag->segments[0].base.seg_len = reserve;
+                frag->segments[1].base.seg_len = *size;
+                frag->segments[1].base.seg_addr.pval = data_ptr;
                 frag->base.des_src_cnt = 2;
             } else {
                 /* inline send */
@@ -447,13 +640,13 @@ static struct mca_btl_base_descriptor_t *vader_prepare_src (struct mca_btl_base_
 
                 if (fbox_ptr) {
                     frag->hdr->flags |= MCA_BTL_VADER_FLAG_FBOX;
-                    frag->segments[0].seg_addr.pval = fbox_ptr;
+                    frag->segments[0].base.seg_addr.pval = fbox_ptr;
                 }
 
                 /* NTH: the covertor adds some latency so we bypass it here */
-                vader_memmove ((void *)((uintptr_t)frag->segments[0].seg_addr.pval + reserve),
+                vader_memmove ((void *)((uintptr_t)frag->segments[0].base.seg_addr.pval + reserve),
                                data_ptr, *size);
-                frag->segments[0].seg_len = total_size;
+                frag->segments[0].base.seg_len = total_size;
             }
         }
     } else {
@@ -463,8 +656,28 @@ static struct mca_btl_base_descriptor_t *vader_prepare_src (struct mca_btl_base_
             return NULL;
         }
 
-        frag->segments[0].seg_addr.lval = (uint64_t)(uintptr_t) data_ptr;
-        frag->segments[0].seg_len       = total_size;
+        frag->segments[0].base.seg_addr.lval = (uint64_t)(uintptr_t) data_ptr;
+        frag->segments[0].base.seg_len       = total_size;
+
+#if OMPI_BTL_VADER_HAVE_KNEM
+        if (MCA_BTL_VADER_KNEM == mca_btl_vader_component.single_copy_mechanism) {
+            struct knem_cmd_create_region knem_cr;
+            struct knem_cmd_param_iovec knem_iov;
+
+            /* expose the buffer to the peer's get for a single use */
+            knem_iov.base = (uintptr_t) data_ptr;
+            knem_iov.len  = total_size;
+            knem_cr.iovec_array = (uintptr_t) &knem_iov;
+            knem_cr.iovec_nr    = 1;
+            knem_cr.protection  = PROT_READ;
+            knem_cr.flags       = KNEM_FLAG_SINGLEUSE;
+            if (OPAL_UNLIKELY(ioctl (mca_btl_vader_component.knem_fd, KNEM_CMD_CREATE_REGION, &knem_cr) < 0)) {
+                MCA_BTL_VADER_FRAG_RETURN(frag);
+                return NULL;
+            }
+            frag->segments[0].key = knem_cr.cookie;
+        }
+#endif /* OMPI_BTL_VADER_HAVE_KNEM */
     }
 
     frag->base.order       = order;
@@ -11,11 +11,23 @@
 
 #include "ompi_config.h"
 
+#include <errno.h>
+
+#include "opal/util/output.h"
+
 #include "btl_vader.h"
 #include "btl_vader_frag.h"
 #include "btl_vader_endpoint.h"
 #include "btl_vader_xpmem.h"
 
+#if OMPI_BTL_VADER_HAVE_CMA
+#include <sys/uio.h>
+#if OMPI_BTL_VADER_CMA_NEED_SYSCALL_DEFS
+#include "opal/sys/cma.h"
+#endif /* OMPI_BTL_VADER_CMA_NEED_SYSCALL_DEFS */
+#endif /* OMPI_BTL_VADER_HAVE_CMA */
+
+#if OMPI_BTL_VADER_HAVE_XPMEM
 /**
  * Initiate an synchronous put.
  *
@@ -50,3 +62,36 @@ int mca_btl_vader_put (struct mca_btl_base_module_t *btl,
 
     return OMPI_SUCCESS;
 }
+#endif /* OMPI_BTL_VADER_HAVE_XPMEM */
+
+#if OMPI_BTL_VADER_HAVE_CMA
+/**
+ * Initiate an synchronous put with a single process_vm_writev.
+ */
+int mca_btl_vader_put_cma (struct mca_btl_base_module_t *btl,
+                           struct mca_btl_base_endpoint_t *endpoint,
+                           struct mca_btl_base_descriptor_t *des)
+{
+    mca_btl_vader_frag_t *frag = (mca_btl_vader_frag_t *) des;
+    mca_btl_base_segment_t *src = des->des_src;
+    mca_btl_base_segment_t *dst = des->des_dst;
+    const size_t size = min(dst->seg_len, src->seg_len);
+    struct iovec src_iov = {.iov_base = src->seg_addr.pval, .iov_len = size};
+    struct iovec dst_iov = {.iov_base = dst->seg_addr.pval, .iov_len = size};
+    ssize_t ret;
+
+    ret = process_vm_writev (endpoint->pid, &src_iov, 1, &dst_iov, 1, 0);
+    if (OPAL_UNLIKELY(ret != (ssize_t) size)) {
+        opal_output (0, "mca_btl_vader_put_cma: process_vm_writev failed (%ld of %lu bytes): %d",
+                     (long) ret, (unsigned long) size, errno);
+        return OMPI_ERROR;
+    }
+
+    /* always call the callback function */
+    frag->base.des_flags |= MCA_BTL_DES_SEND_ALWAYS_CALLBACK;
+
+    mca_btl_vader_frag_complete (frag);
+
+    return OMPI_SUCCESS;
+}
+#endif /* OMPI_BTL_VADER_HAVE_CMA */
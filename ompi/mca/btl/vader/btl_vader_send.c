@@ -42,17 +42,21 @@ int mca_btl_vader_send (struct mca_btl_base_module_t *btl,
     mca_btl_vader_frag_t *frag = (mca_btl_vader_frag_t *) descriptor;
 
     if (OPAL_LIKELY(frag->hdr->flags & MCA_BTL_VADER_FLAG_FBOX)) {
-        mca_btl_vader_fbox_send (frag->segments[0].seg_addr.pval, tag, frag->segments[0].seg_len);
+        mca_btl_vader_fbox_send (frag->segments[0].base.seg_addr.pval, tag, frag->segments[0].base.seg_len);
         mca_btl_vader_frag_complete (frag);
 
         return 1;
     }
 
     /* header (+ optional inline data) */
-    frag->hdr->len = frag->segments[0].seg_len;
+    frag->hdr->len = frag->segments[0].base.seg_len;
     /* type of message, pt-2-pt, one-sided, etc */
     frag->hdr->tag = tag;
 
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != mca_btl_vader_endpoint_check (endpoint))) {
+        return OMPI_ERROR;
+    }
+
     /* post the relative address of the descriptor into the peer's fifo */
     vader_fifo_write (frag->hdr, endpoint);
 
@@ -65,6 +65,10 @@ int mca_btl_vader_sendi (struct mca_btl_base_module_t *btl,
     /* we won't ever return a descriptor */
     *descriptor = NULL;
 
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != mca_btl_vader_endpoint_check (endpoint))) {
+        return OMPI_ERROR;
+    }
+
     /* allocate a fragment, giving up if we can't get one */
     frag = (mca_btl_vader_frag_t *) mca_btl_vader_alloc (btl, endpoint, order, length,
                                                          flags | MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
@@ -77,14 +81,14 @@ int mca_btl_vader_sendi (struct mca_btl_base_module_t *btl,
     frag->hdr->tag = tag;
 
     /* write the match header (with MPI comm/tag/etc. info) */
-    memcpy (frag->segments[0].seg_addr.pval, header, header_size);
+    memcpy (frag->segments[0].base.seg_addr.pval, header, header_size);
 
     /* write the message data if there is any */
     /* we can't use single-copy semantics here since as caller will consider the send
        complete when we return */
     if (OPAL_UNLIKELY(payload_size && opal_convertor_need_buffers (convertor))) {
         /* pack the data into the supplied buffer */
-        iov.iov_base = (IOVBASE_TYPE *)((uintptr_t)frag->segments[0].seg_addr.pval + header_size);
+        iov.iov_base = (IOVBASE_TYPE *)((uintptr_t)frag->segments[0].base.seg_addr.pval + header_size);
         iov.iov_len  = max_data = payload_size;
 
         (void) opal_convertor_pack (convertor, &iov, &iov_count, &max_data);
@@ -92,7 +96,7 @@ int mca_btl_vader_sendi (struct mca_btl_base_module_t *btl,
         assert (max_data == payload_size);
     } else if (payload_size) {
         /* bypassing the convertor may speed things up a little */
-        memcpy ((void *)((uintptr_t)frag->segments[0].seg_addr.pval + header_size), data_ptr, payload_size);
+        memcpy ((void *)((uintptr_t)frag->segments[0].base.seg_addr.pval + header_size), data_ptr, payload_size);
     }
 
     /* write the fragment pointer to peer's the FIFO. the progress function will return the fragment */
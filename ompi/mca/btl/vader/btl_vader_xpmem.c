@@ -13,6 +13,8 @@
 #include "opal/include/opal/align.h"
 #include "btl_vader_xpmem.h"
 
+#if OMPI_BTL_VADER_HAVE_XPMEM
+
 /* largest address we can attach to using xpmem */
 #define VADER_MAX_ADDRESS ((uintptr_t)0x7ffffffff000)
 
@@ -111,3 +113,5 @@ void vader_return_registration (mca_mpool_base_registration_t *reg, struct mca_b
         OBJ_RELEASE (reg);
     }
 }
+
+#endif /* OMPI_BTL_VADER_HAVE_XPMEM */
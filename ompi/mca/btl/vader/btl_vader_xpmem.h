@@ -14,6 +14,8 @@
 
 #include "btl_vader.h"
 
+#if OMPI_BTL_VADER_HAVE_XPMEM
+
 /* look up the remote pointer in the peer rcache and attach if
  * necessary */
 mca_mpool_base_registration_t *vader_get_registation (struct mca_btl_base_endpoint_t *endpoint, void *rem_ptr,
@@ -21,4 +23,6 @@ mca_mpool_base_registration_t *vader_get_registation (struct mca_btl_base_endpoi
 
 void vader_return_registration (mca_mpool_base_registration_t *reg, struct mca_btl_base_endpoint_t *endpoint);
 
+#endif /* OMPI_BTL_VADER_HAVE_XPMEM */
+
 #endif
@@ -49,13 +49,43 @@ AC_DEFUN([OMPI_CHECK_XPMEM], [
 #    OPAL_VAR_SCOPE_POP
 ])dnl
 
-# MCA_btl_sm_CONFIG([action-if-can-compile],
-#                   [action-if-cant-compile])
+# OMPI_CHECK_VADER_CMA(prefix, [action-if-found], [action-if-not-found])
+# --------------------------------------------------------
+# check if process_vm_readv/writev can be used, either from the C
+# library or through the raw syscalls in opal/sys/cma.h.  Support is
+# enabled by default on Linux (use --without-cma to disable it).
+AC_DEFUN([OMPI_CHECK_VADER_CMA],[
+    OPAL_VAR_SCOPE_PUSH([ompi_check_vader_cma_happy])
+    ompi_check_vader_cma_happy=no
+    $1_cma_need_defs=0
+
+    AS_IF([test "$with_cma" != "no"],
+          [AC_CHECK_FUNC([process_vm_readv],
+                         [ompi_check_vader_cma_happy=yes],
+                         [case "$host" in
+                              x86_64-*linux*|i?86-*linux*|ia64-*linux*|powerpc*-*linux*)
+                                  ompi_check_vader_cma_happy=yes
+                                  $1_cma_need_defs=1
+                                  ;;
+                          esac])])
+
+    AC_DEFINE_UNQUOTED([OMPI_BTL_VADER_CMA_NEED_SYSCALL_DEFS],
+                       [$$1_cma_need_defs],
+                       [Need the CMA syscalls defined for vader])
+
+    AS_IF([test "$ompi_check_vader_cma_happy" = "yes"],
+          [$2],
+          [$3])
+    OPAL_VAR_SCOPE_POP
+])dnl
+
+# MCA_btl_vader_CONFIG([action-if-can-compile],
+#                      [action-if-cant-compile])
 # ------------------------------------------------
 AC_DEFUN([MCA_ompi_btl_vader_CONFIG],[
     AC_CONFIG_FILES([ompi/mca/btl/vader/Makefile])
 
-    OPAL_VAR_SCOPE_PUSH([btl_vader_xpmem_happy])
+    OPAL_VAR_SCOPE_PUSH([btl_vader_xpmem_happy btl_vader_cma_happy btl_vader_knem_happy])
     OMPI_CHECK_XPMEM([btl_vader],
                      [btl_vader_xpmem_happy=1],
                      [btl_vader_xpmem_happy=0])
@@ -64,16 +94,33 @@ AC_DEFUN([MCA_ompi_btl_vader_CONFIG],[
                        [$btl_vader_xpmem_happy],
                        [If XPMEM support can be enabled within vader])
 
-    # at this point, we can only build vader if we have XPMEM support
-    AS_IF([test "$btl_vader_xpmem_happy" = "1"],
-          [$1],
-          [$2])
+    OMPI_CHECK_VADER_CMA([btl_vader],
+                         [btl_vader_cma_happy=1],
+                         [btl_vader_cma_happy=0])
 
-    # substitute in the things needed to build with XPMEM support
+    AC_DEFINE_UNQUOTED([OMPI_BTL_VADER_HAVE_CMA],
+                       [$btl_vader_cma_happy],
+                       [If CMA support can be enabled within vader])
+
+    OMPI_CHECK_KNEM([btl_vader],
+                    [btl_vader_knem_happy=1],
+                    [btl_vader_knem_happy=0])
+
+    AC_DEFINE_UNQUOTED([OMPI_BTL_VADER_HAVE_KNEM],
+                       [$btl_vader_knem_happy],
+                       [If knem support can be enabled within vader])
+
+    AC_CHECK_HEADERS([sys/prctl.h])
+
+    # the segments are shared through opal_shmem when there is no XPMEM,
+    # so vader can always be built
+    [$1]
+
+    # substitute in the things needed to build with XPMEM/knem support
     AC_SUBST([btl_vader_CFLAGS])
     AC_SUBST([btl_vader_CPPFLAGS])
     AC_SUBST([btl_vader_LDFLAGS])
     AC_SUBST([btl_vader_LIBS])
 
-#    OPAL_VAR_SCOPE_POP
+    OPAL_VAR_SCOPE_POP
 ])dnl
@@ -121,10 +121,23 @@ int mca_coll_base_comm_select(struct ompi_communicator_t *comm);
  */
 int mca_coll_base_comm_unselect(struct ompi_communicator_t *comm);
 
+/**
+ * Setup and teardown of the cache of the components that declined
+ * each shape of communicator (coll_base_comm_select.c).
+ */
+void mca_coll_base_select_cache_init(void);
+void mca_coll_base_select_cache_fini(void);
+
 /*
  * Globals
  */
 OMPI_DECLSPEC extern mca_base_framework_t ompi_coll_base_framework;
 
+/**
+ * Maximum number of communicator shapes whose declining components
+ * are remembered (0 queries every component for every communicator).
+ */
+extern int mca_coll_base_select_cache_size;
+
 END_C_DECLS
 #endif /* MCA_BASE_COLL_H */
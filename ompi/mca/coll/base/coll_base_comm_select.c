@@ -29,10 +29,12 @@
 
 #include "mpi.h"
 #include "ompi/communicator/communicator.h"
+#include "ompi/proc/proc.h"
 #include "opal/util/output.h"
 #include "opal/util/show_help.h"
 #include "opal/class/opal_list.h"
 #include "opal/class/opal_object.h"
+#include "opal/threads/mutex.h"
 #include "opal/mca/mca.h"
 #include "opal/mca/base/base.h"
 #include "ompi/mca/coll/coll.h"
@@ -50,6 +52,30 @@ struct avail_coll_t {
 };
 typedef struct avail_coll_t avail_coll_t;
 
+/*
+ * The components that declined a communicator of a given shape. The
+ * components only look at the kind of communicator, its size and
+ * whether the peers are on the local node to decide whether they run,
+ * so a communicator of the same shape (e.g. a dup) will be declined
+ * again and they need not be queried.
+ */
+struct select_sig_t {
+    int ss_flags;          /* inter and topology flags */
+    int ss_size;
+    int ss_remote_size;
+    int ss_local_peers;    /* peers on my node, me included */
+};
+typedef struct select_sig_t select_sig_t;
+
+struct select_cache_item_t {
+    opal_list_item_t super;
+
+    select_sig_t sc_sig;
+    int sc_ndeclined;
+    const mca_base_component_t **sc_declined;
+};
+typedef struct select_cache_item_t select_cache_item_t;
+
 
 /*
  * Local functions
@@ -60,6 +86,12 @@ static int check_one_component(ompi_communicator_t * comm,
                                const mca_base_component_t * component,
                                mca_coll_base_module_2_0_0_t ** module);
 
+static void select_cache_signature(ompi_communicator_t *comm, select_sig_t *sig);
+static select_cache_item_t *select_cache_lookup(const select_sig_t *sig);
+static void select_cache_insert(const select_sig_t *sig,
+                                const mca_base_component_t **declined,
+                                int ndeclined);
+
 static int query(const mca_base_component_t * component,
                  ompi_communicator_t * comm, int *priority,
                  mca_coll_base_module_2_0_0_t ** module);
@@ -74,6 +106,19 @@ static int query_2_0_0(const mca_coll_base_component_2_0_0_t *
  */
 static OBJ_CLASS_INSTANCE(avail_coll_t, opal_list_item_t, NULL, NULL);
 
+static void select_cache_item_destruct(select_cache_item_t *item)
+{
+    if (NULL != item->sc_declined) {
+        free(item->sc_declined);
+    }
+}
+static OBJ_CLASS_INSTANCE(select_cache_item_t, opal_list_item_t, NULL,
+                          select_cache_item_destruct);
+
+/* most recently used shapes last */
+static opal_list_t select_cache;
+static opal_mutex_t select_cache_lock;
+
 
 #define COPY(module, comm, func)                                        \
     do {                                                                \
@@ -175,6 +220,14 @@ int mca_coll_base_comm_select(ompi_communicator_t * comm)
         COPY(avail->ac_module, comm, iscan);
         COPY(avail->ac_module, comm, iscatter);
         COPY(avail->ac_module, comm, iscatterv);
+
+        COPY(avail->ac_module, comm, neighbor_allgather);
+        COPY(avail->ac_module, comm, neighbor_alltoall);
+        COPY(avail->ac_module, comm, ineighbor_allgather);
+        COPY(avail->ac_module, comm, ineighbor_alltoall);
+
+        COPY(avail->ac_module, comm, allreduce_init);
+        COPY(avail->ac_module, comm, bcast_init);
         /* release the original module reference and the list item */
         OBJ_RELEASE(avail->ac_module);
         OBJ_RELEASE(avail);
@@ -239,6 +292,86 @@ static int avail_coll_compare (opal_list_item_t **a,
     return 0;
 }
 
+static void select_cache_signature(ompi_communicator_t *comm, select_sig_t *sig)
+{
+    int i;
+    ompi_proc_t *proc;
+
+    sig->ss_flags = comm->c_flags & (OMPI_COMM_INTER | OMPI_COMM_CART |
+                                     OMPI_COMM_GRAPH | OMPI_COMM_DIST_GRAPH);
+    sig->ss_size = ompi_comm_size(comm);
+    sig->ss_remote_size = OMPI_COMM_IS_INTER(comm) ? ompi_comm_remote_size(comm) : 0;
+    sig->ss_local_peers = 0;
+    for (i = 0; i < sig->ss_size; i++) {
+        proc = ompi_group_peer_lookup(comm->c_local_group, i);
+        if (proc == ompi_proc_local() ||
+            OPAL_PROC_ON_LOCAL_NODE(proc->proc_flags)) {
+            sig->ss_local_peers++;
+        }
+    }
+}
+
+/* Returns the entry of this shape, made the most recently used */
+static select_cache_item_t *select_cache_lookup(const select_sig_t *sig)
+{
+    select_cache_item_t *item, *found = NULL;
+
+    OPAL_THREAD_LOCK(&select_cache_lock);
+    OPAL_LIST_FOREACH(item, &select_cache, select_cache_item_t) {
+        if (0 == memcmp(&item->sc_sig, sig, sizeof(select_sig_t))) {
+            found = item;
+            break;
+        }
+    }
+    if (NULL != found) {
+        opal_list_remove_item(&select_cache, &found->super);
+        opal_list_append(&select_cache, &found->super);
+    }
+    OPAL_THREAD_UNLOCK(&select_cache_lock);
+    return found;
+}
+
+/* Takes over the declined array, evicting the least recently used shape */
+static void select_cache_insert(const select_sig_t *sig,
+                                const mca_base_component_t **declined,
+                                int ndeclined)
+{
+    select_cache_item_t *item;
+
+    OPAL_THREAD_LOCK(&select_cache_lock);
+    while (opal_list_get_size(&select_cache) >= (size_t) mca_coll_base_select_cache_size) {
+        item = (select_cache_item_t *) opal_list_remove_first(&select_cache);
+        OBJ_RELEASE(item);
+    }
+    item = OBJ_NEW(select_cache_item_t);
+    item->sc_sig = *sig;
+    item->sc_declined = declined;
+    item->sc_ndeclined = ndeclined;
+    opal_list_append(&select_cache, &item->super);
+    OPAL_THREAD_UNLOCK(&select_cache_lock);
+}
+
+/*
+ * Setup and teardown of the cache, when the framework is opened and
+ * closed.
+ */
+void mca_coll_base_select_cache_init(void)
+{
+    OBJ_CONSTRUCT(&select_cache, opal_list_t);
+    OBJ_CONSTRUCT(&select_cache_lock, opal_mutex_t);
+}
+
+void mca_coll_base_select_cache_fini(void)
+{
+    opal_list_item_t *item;
+
+    while (NULL != (item = opal_list_remove_first(&select_cache))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&select_cache);
+    OBJ_DESTRUCT(&select_cache_lock);
+}
+
 /*
  * For each module in the list, check and see if it wants to run, and
  * do the resulting priority comparison.  Make a list of modules to be
@@ -248,12 +381,24 @@ static int avail_coll_compare (opal_list_item_t **a,
 static opal_list_t *check_components(opal_list_t * components,
                                      ompi_communicator_t * comm)
 {
-    int priority;
+    int priority, i, ndeclined = 0;
     const mca_base_component_t *component;
+    const mca_base_component_t **declined = NULL;
     mca_base_component_list_item_t *cli;
     mca_coll_base_module_2_0_0_t *module;
     opal_list_t *selectable;
     avail_coll_t *avail;
+    select_cache_item_t *cached = NULL;
+    select_sig_t sig;
+
+    if (0 < mca_coll_base_select_cache_size) {
+        select_cache_signature(comm, &sig);
+        cached = select_cache_lookup(&sig);
+        if (NULL == cached) {
+            declined = (const mca_base_component_t **)
+                malloc(opal_list_get_size(components) * sizeof(mca_base_component_t *));
+        }
+    }
 
     /* Make a list of the components that query successfully */
     selectable = OBJ_NEW(opal_list_t);
@@ -262,6 +407,20 @@ static opal_list_t *check_components(opal_list_t * components,
     OPAL_LIST_FOREACH(cli, &ompi_coll_base_framework.framework_components, mca_base_component_list_item_t) {
         component = cli->cli_component;
 
+        if (NULL != cached) {
+            for (i = 0; i < cached->sc_ndeclined; i++) {
+                if (cached->sc_declined[i] == component) {
+                    break;
+                }
+            }
+            if (i < cached->sc_ndeclined) {
+                opal_output_verbose(10, ompi_coll_base_framework.framework_output,
+                                    "coll:base:comm_select: component not available: %s (cached)",
+                                    component->mca_component_name);
+                continue;
+            }
+        }
+
         priority = check_one_component(comm, component, &module);
         if (priority >= 0) {
             /* We have a component that indicated that it wants to run
@@ -271,9 +430,15 @@ static opal_list_t *check_components(opal_list_t * components,
             avail->ac_module = module;
 
             opal_list_append(selectable, &avail->super);
+        } else if (NULL != declined) {
+            declined[ndeclined++] = component;
         }
     }    
 
+    if (NULL != declined) {
+        select_cache_insert(&sig, declined, ndeclined);
+    }
+
     /* If we didn't find any available components, return an error */
     if (0 == opal_list_get_size(selectable)) {
         OBJ_RELEASE(selectable);
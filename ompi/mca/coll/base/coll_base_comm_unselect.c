@@ -77,6 +77,14 @@ int mca_coll_base_comm_unselect(ompi_communicator_t * comm)
     CLOSE(comm, iscatter);
     CLOSE(comm, iscatterv);
 
+    CLOSE(comm, neighbor_allgather);
+    CLOSE(comm, neighbor_alltoall);
+    CLOSE(comm, ineighbor_allgather);
+    CLOSE(comm, ineighbor_alltoall);
+
+    CLOSE(comm, allreduce_init);
+    CLOSE(comm, bcast_init);
+
 
     /* All done */
     return OMPI_SUCCESS;
@@ -82,6 +82,14 @@ static void coll_base_module_construct(mca_coll_base_module_t *m)
     m->coll_iscatter = NULL;
     m->coll_iscatterv = NULL;
 
+    m->coll_neighbor_allgather = NULL;
+    m->coll_neighbor_alltoall = NULL;
+    m->coll_ineighbor_allgather = NULL;
+    m->coll_ineighbor_alltoall = NULL;
+
+    m->coll_allreduce_init = NULL;
+    m->coll_bcast_init = NULL;
+
     /* FT event */
     m->ft_event = NULL;
 }
@@ -89,5 +97,34 @@ static void coll_base_module_construct(mca_coll_base_module_t *m)
 OBJ_CLASS_INSTANCE(mca_coll_base_module_t, opal_object_t, 
                    coll_base_module_construct, NULL);
 
-MCA_BASE_FRAMEWORK_DECLARE(ompi, coll, "Collectives", NULL, NULL, NULL,
+int mca_coll_base_select_cache_size = 16;
+
+static int mca_coll_base_register(mca_base_register_flag_t flags)
+{
+    mca_coll_base_select_cache_size = 16;
+    (void) mca_base_var_register("ompi", "coll", "base", "select_cache_size",
+                                 "Number of communicator shapes (kind, size and number of local peers) "
+                                 "for which the components that declined to run are remembered, and "
+                                 "not queried again for a new communicator of the same shape (0: disabled)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &mca_coll_base_select_cache_size);
+    return OMPI_SUCCESS;
+}
+
+static int mca_coll_base_open(mca_base_open_flag_t flags)
+{
+    mca_coll_base_select_cache_init();
+    return mca_base_framework_components_open(&ompi_coll_base_framework, flags);
+}
+
+static int mca_coll_base_close(void)
+{
+    mca_coll_base_select_cache_fini();
+    return mca_base_framework_components_close(&ompi_coll_base_framework, NULL);
+}
+
+MCA_BASE_FRAMEWORK_DECLARE(ompi, coll, "Collectives", mca_coll_base_register,
+                           mca_coll_base_open, mca_coll_base_close,
                            mca_coll_base_static_components, 0);
@@ -40,5 +40,7 @@
 #define MCA_COLL_BASE_TAG_SCAN -23
 #define MCA_COLL_BASE_TAG_SCATTER -24
 #define MCA_COLL_BASE_TAG_SCATTERV -25
-#define MCA_COLL_BASE_TAG_NONBLOCKING_BASE -26
+#define MCA_COLL_BASE_TAG_NEIGHBOR_ALLGATHER -26
+#define MCA_COLL_BASE_TAG_NEIGHBOR_ALLTOALL -27
+#define MCA_COLL_BASE_TAG_NONBLOCKING_BASE -28
 #endif /* MCA_COLL_BASE_TAGS_H */
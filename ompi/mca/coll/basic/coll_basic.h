@@ -306,6 +306,19 @@ BEGIN_C_DECLS
                                       struct ompi_communicator_t *comm,
                                       mca_coll_base_module_t *module);
 
+    int mca_coll_basic_neighbor_allgather(void *sbuf, int scount,
+                                          struct ompi_datatype_t *sdtype,
+                                          void *rbuf, int rcount,
+                                          struct ompi_datatype_t *rdtype,
+                                          struct ompi_communicator_t *comm,
+                                          mca_coll_base_module_t *module);
+    int mca_coll_basic_neighbor_alltoall(void *sbuf, int scount,
+                                         struct ompi_datatype_t *sdtype,
+                                         void *rbuf, int rcount,
+                                         struct ompi_datatype_t *rdtype,
+                                         struct ompi_communicator_t *comm,
+                                         mca_coll_base_module_t *module);
+
     int mca_coll_basic_ft_event(int status);
 
 
@@ -325,10 +338,21 @@ struct mca_coll_basic_module_t {
 
     ompi_request_t **mccb_reqs;
     int mccb_num_reqs;
+
+    /* neighbors in the topology of the communicator, looked up by the
+       first neighborhood collective (the topology is attached after
+       the coll selection) */
+    int mccb_indegree;
+    int mccb_outdegree;
+    int *mccb_sources;
+    int *mccb_destinations;
 };
 typedef struct mca_coll_basic_module_t mca_coll_basic_module_t;
 OBJ_CLASS_DECLARATION(mca_coll_basic_module_t);
 
+    int mca_coll_basic_neighbors(mca_coll_basic_module_t *module,
+                                 struct ompi_communicator_t *comm);
+
 END_C_DECLS
 
 #endif /* MCA_COLL_BASIC_EXPORT_H */
@@ -113,12 +113,17 @@ mca_coll_basic_module_construct(mca_coll_basic_module_t *module)
 {
     module->mccb_reqs = NULL;
     module->mccb_num_reqs = 0;
+    module->mccb_indegree = 0;
+    module->mccb_outdegree = 0;
+    module->mccb_sources = NULL;
+    module->mccb_destinations = NULL;
 }
 
 static void
 mca_coll_basic_module_destruct(mca_coll_basic_module_t *module)
 {
     if (NULL != module->mccb_reqs) free(module->mccb_reqs);
+    if (NULL != module->mccb_sources) free(module->mccb_sources);
 }
 
 
@@ -25,6 +25,7 @@
 #include "mpi.h"
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/coll/base/base.h"
+#include "ompi/mca/topo/base/base.h"
 #include "coll_basic.h"
 
 
@@ -112,6 +113,8 @@ mca_coll_basic_comm_query(struct ompi_communicator_t *comm,
         basic_module->super.coll_scan       = mca_coll_basic_scan_intra;
         basic_module->super.coll_scatter    = mca_coll_basic_scatter_intra;
         basic_module->super.coll_scatterv   = mca_coll_basic_scatterv_intra;
+        basic_module->super.coll_neighbor_allgather = mca_coll_basic_neighbor_allgather;
+        basic_module->super.coll_neighbor_alltoall = mca_coll_basic_neighbor_alltoall;
     } else {
         basic_module->super.coll_allgather  = mca_coll_basic_allgather_intra;
         basic_module->super.coll_allgatherv = mca_coll_basic_allgatherv_intra;
@@ -130,12 +133,65 @@ mca_coll_basic_comm_query(struct ompi_communicator_t *comm,
         basic_module->super.coll_scan       = mca_coll_basic_scan_intra;
         basic_module->super.coll_scatter    = mca_coll_basic_scatter_intra;
         basic_module->super.coll_scatterv   = mca_coll_basic_scatterv_intra;
+        basic_module->super.coll_neighbor_allgather = mca_coll_basic_neighbor_allgather;
+        basic_module->super.coll_neighbor_alltoall = mca_coll_basic_neighbor_alltoall;
     }
 
     return &(basic_module->super);
 }
 
 
+/*
+ * Look up the neighbors of the process for the neighborhood
+ * collectives, and make sure there are enough requests for them.
+ */
+int
+mca_coll_basic_neighbors(mca_coll_basic_module_t *module,
+                         struct ompi_communicator_t *comm)
+{
+    int err, indegree, outdegree;
+    ompi_request_t **reqs;
+
+    if (NULL != module->mccb_sources) {
+        return OMPI_SUCCESS;
+    }
+
+    err = mca_topo_base_neighbor_count(comm, &indegree, &outdegree);
+    if (OMPI_SUCCESS != err) {
+        return err;
+    }
+
+    if (indegree + outdegree > module->mccb_num_reqs) {
+        reqs = (ompi_request_t**) realloc(module->mccb_reqs,
+                                          sizeof(ompi_request_t *) * (indegree + outdegree));
+        if (NULL == reqs) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        module->mccb_reqs = reqs;
+        module->mccb_num_reqs = indegree + outdegree;
+    }
+
+    /* one array for both lists, never empty */
+    module->mccb_sources = (int*) malloc(sizeof(int) * (indegree + outdegree + 1));
+    if (NULL == module->mccb_sources) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    module->mccb_destinations = module->mccb_sources + indegree;
+
+    err = mca_topo_base_neighbors(comm, module->mccb_sources,
+                                  module->mccb_destinations);
+    if (OMPI_SUCCESS != err) {
+        free(module->mccb_sources);
+        module->mccb_sources = module->mccb_destinations = NULL;
+        return err;
+    }
+    module->mccb_indegree = indegree;
+    module->mccb_outdegree = outdegree;
+
+    return OMPI_SUCCESS;
+}
+
+
 /*
  * Init module on the communicator
  */
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "coll_basic.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+
+
+/*
+ *	neighbor_allgather
+ *
+ *	Function:	- MPI_Neighbor_allgather
+ *	Accepts:	- same as MPI_Neighbor_allgather()
+ *	Returns:	- MPI_SUCCESS or an MPI error code
+ */
+int
+mca_coll_basic_neighbor_allgather(void *sbuf, int scount,
+                                  struct ompi_datatype_t *sdtype,
+                                  void *rbuf, int rcount,
+                                  struct ompi_datatype_t *rdtype,
+                                  struct ompi_communicator_t *comm,
+                                  mca_coll_base_module_t *module)
+{
+    int i;
+    int err;
+    int nreqs;
+    MPI_Aint lb;
+    MPI_Aint rcvinc;
+    ompi_request_t **req;
+    mca_coll_basic_module_t *basic_module = (mca_coll_basic_module_t*) module;
+
+    /* Initialize. */
+
+    err = mca_coll_basic_neighbors(basic_module, comm);
+    if (OMPI_SUCCESS != err) {
+        return err;
+    }
+
+    err = ompi_datatype_get_extent(rdtype, &lb, &rcvinc);
+    if (OMPI_SUCCESS != err) {
+        return err;
+    }
+    rcvinc *= rcount;
+
+    req = basic_module->mccb_reqs;
+
+    /* Post all receives first.  The blocks from MPI_PROC_NULL
+       neighbors are left as they are. */
+
+    for (nreqs = 0, i = 0; i < basic_module->mccb_indegree; ++i) {
+        if (MPI_PROC_NULL == basic_module->mccb_sources[i]) {
+            continue;
+        }
+        err = MCA_PML_CALL(irecv_init
+                           ((char *) rbuf + i * rcvinc, rcount, rdtype,
+                            basic_module->mccb_sources[i],
+                            MCA_COLL_BASE_TAG_NEIGHBOR_ALLGATHER, comm, &req[nreqs]));
+        if (MPI_SUCCESS != err) {
+            mca_coll_basic_free_reqs(req, nreqs);
+            return err;
+        }
+        ++nreqs;
+    }
+
+    /* Now post all sends */
+
+    for (i = 0; i < basic_module->mccb_outdegree; ++i) {
+        if (MPI_PROC_NULL == basic_module->mccb_destinations[i]) {
+            continue;
+        }
+        err = MCA_PML_CALL(isend_init
+                           (sbuf, scount, sdtype,
+                            basic_module->mccb_destinations[i],
+                            MCA_COLL_BASE_TAG_NEIGHBOR_ALLGATHER,
+                            MCA_PML_BASE_SEND_STANDARD, comm, &req[nreqs]));
+        if (MPI_SUCCESS != err) {
+            mca_coll_basic_free_reqs(req, nreqs);
+            return err;
+        }
+        ++nreqs;
+    }
+
+    if (0 == nreqs) {
+        return MPI_SUCCESS;
+    }
+
+    /* Start your engines.  This will never return an error. */
+
+    MCA_PML_CALL(start(nreqs, req));
+
+    /* Wait for them all.  If there's an error, note that we don't
+     * care what the error was -- just that there *was* an error.  The
+     * PML will finish all requests, even if one or more of them fail.
+     * i.e., by the end of this call, all the requests are free-able.
+     * So free them anyway -- even if there was an error, and return
+     * the error after we free everything. */
+
+    err = ompi_request_wait_all(nreqs, req, MPI_STATUSES_IGNORE);
+
+    /* Free the reqs */
+
+    mca_coll_basic_free_reqs(req, nreqs);
+
+    /* All done */
+
+    return err;
+}
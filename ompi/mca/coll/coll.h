@@ -313,6 +313,37 @@ typedef int (*mca_coll_base_module_iscatterv_fn_t)
    int root, struct ompi_communicator_t *comm, ompi_request_t ** request,
    struct mca_coll_base_module_2_0_0_t *module);
 
+/* neighborhood collectives */
+typedef int (*mca_coll_base_module_neighbor_allgather_fn_t)
+  (void *sbuf, int scount, struct ompi_datatype_t *sdtype, 
+   void *rbuf, int rcount, struct ompi_datatype_t *rdtype, 
+   struct ompi_communicator_t *comm, struct mca_coll_base_module_2_0_0_t *module);
+typedef int (*mca_coll_base_module_neighbor_alltoall_fn_t)
+  (void *sbuf, int scount, struct ompi_datatype_t *sdtype, 
+   void* rbuf, int rcount, struct ompi_datatype_t *rdtype, 
+   struct ompi_communicator_t *comm, struct mca_coll_base_module_2_0_0_t *module);
+typedef int (*mca_coll_base_module_ineighbor_allgather_fn_t)
+  (void *sbuf, int scount, struct ompi_datatype_t *sdtype, 
+   void *rbuf, int rcount, struct ompi_datatype_t *rdtype, 
+   struct ompi_communicator_t *comm, ompi_request_t ** request, 
+   struct mca_coll_base_module_2_0_0_t *module);
+typedef int (*mca_coll_base_module_ineighbor_alltoall_fn_t)
+  (void *sbuf, int scount, struct ompi_datatype_t *sdtype, 
+   void* rbuf, int rcount, struct ompi_datatype_t *rdtype, 
+   struct ompi_communicator_t *comm, ompi_request_t ** request,
+   struct mca_coll_base_module_2_0_0_t *module);
+
+/* persistent collectives: the request is returned inactive, every
+   MPI_Start runs the collective again on the same arguments */
+typedef int (*mca_coll_base_module_allreduce_init_fn_t)
+  (void *sbuf, void *rbuf, int count, struct ompi_datatype_t *dtype, 
+   struct ompi_op_t *op, struct ompi_communicator_t *comm, 
+   ompi_request_t ** request, struct mca_coll_base_module_2_0_0_t *module);
+typedef int (*mca_coll_base_module_bcast_init_fn_t)
+  (void *buff, int count, struct ompi_datatype_t *datatype, int root, 
+   struct ompi_communicator_t *comm, ompi_request_t ** request, 
+   struct mca_coll_base_module_2_0_0_t *module);
+
 /**
  * Fault Tolerance Awareness function.
  *
@@ -416,6 +447,15 @@ struct mca_coll_base_module_2_0_0_t {
     mca_coll_base_module_iscan_fn_t coll_iscan;
     mca_coll_base_module_iscatter_fn_t coll_iscatter;
     mca_coll_base_module_iscatterv_fn_t coll_iscatterv;
+    /* neighborhood functions, only used on communicators with a
+       topology */
+    mca_coll_base_module_neighbor_allgather_fn_t coll_neighbor_allgather;
+    mca_coll_base_module_neighbor_alltoall_fn_t coll_neighbor_alltoall;
+    mca_coll_base_module_ineighbor_allgather_fn_t coll_ineighbor_allgather;
+    mca_coll_base_module_ineighbor_alltoall_fn_t coll_ineighbor_alltoall;
+    /* persistent functions */
+    mca_coll_base_module_allreduce_init_fn_t coll_allreduce_init;
+    mca_coll_base_module_bcast_init_fn_t coll_bcast_init;
 
     /** Fault tolerance event trigger function */
     mca_coll_base_module_ft_event_fn_t ft_event;
@@ -507,6 +547,22 @@ struct mca_coll_base_comm_coll_t {
     mca_coll_base_module_2_0_0_t *coll_iscatter_module;
     mca_coll_base_module_iscatterv_fn_t coll_iscatterv;
     mca_coll_base_module_2_0_0_t *coll_iscatterv_module;
+
+    /* neighborhood collectives */
+    mca_coll_base_module_neighbor_allgather_fn_t coll_neighbor_allgather;
+    mca_coll_base_module_2_0_0_t *coll_neighbor_allgather_module;
+    mca_coll_base_module_neighbor_alltoall_fn_t coll_neighbor_alltoall;
+    mca_coll_base_module_2_0_0_t *coll_neighbor_alltoall_module;
+    mca_coll_base_module_ineighbor_allgather_fn_t coll_ineighbor_allgather;
+    mca_coll_base_module_2_0_0_t *coll_ineighbor_allgather_module;
+    mca_coll_base_module_ineighbor_alltoall_fn_t coll_ineighbor_alltoall;
+    mca_coll_base_module_2_0_0_t *coll_ineighbor_alltoall_module;
+
+    /* persistent collectives */
+    mca_coll_base_module_allreduce_init_fn_t coll_allreduce_init;
+    mca_coll_base_module_2_0_0_t *coll_allreduce_init_module;
+    mca_coll_base_module_bcast_init_fn_t coll_bcast_init;
+    mca_coll_base_module_2_0_0_t *coll_bcast_init_module;
 };
 typedef struct mca_coll_base_comm_coll_t mca_coll_base_comm_coll_t;
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_COLL_CUDA_EXPORT_H
+#define MCA_COLL_CUDA_EXPORT_H
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "opal/mca/mca.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/request/request.h"
+
+BEGIN_C_DECLS
+
+/*
+ * The reductions on buffers in GPU memory are staged through host
+ * memory: the data is copied to a bounce buffer, reduced there by the
+ * component below us, and the result copied back.  Each module keeps a
+ * pinned bounce buffer of up to mca_coll_cuda_component.pinned_max
+ * bytes, for which the copies run at the full speed of the bus; larger
+ * operations use a temporary buffer.
+ */
+
+struct mca_coll_cuda_component_t {
+    mca_coll_base_component_2_0_0_t super;
+
+    int priority;
+    size_t pinned_max;
+};
+typedef struct mca_coll_cuda_component_t mca_coll_cuda_component_t;
+OMPI_MODULE_DECLSPEC extern mca_coll_cuda_component_t mca_coll_cuda_component;
+
+struct mca_coll_cuda_module_t {
+    mca_coll_base_module_t super;
+
+    /* the collectives used on host memory */
+    mca_coll_base_module_allreduce_fn_t previous_allreduce;
+    mca_coll_base_module_t *previous_allreduce_module;
+    mca_coll_base_module_reduce_fn_t previous_reduce;
+    mca_coll_base_module_t *previous_reduce_module;
+
+    /* pinned bounce buffer, allocated on the first use */
+    char *bounce;
+    size_t bounce_size;
+};
+typedef struct mca_coll_cuda_module_t mca_coll_cuda_module_t;
+OBJ_CLASS_DECLARATION(mca_coll_cuda_module_t);
+
+/* tag of the bounce buffers in the messages of common/cuda */
+extern char mca_coll_cuda_bounce_msg[];
+
+int mca_coll_cuda_init_query(bool enable_progress_threads,
+                             bool enable_mpi_threads);
+mca_coll_base_module_t *
+mca_coll_cuda_comm_query(struct ompi_communicator_t *comm, int *priority);
+
+int mca_coll_cuda_allreduce(void *sbuf, void *rbuf, int count,
+                            struct ompi_datatype_t *dtype,
+                            struct ompi_op_t *op,
+                            struct ompi_communicator_t *comm,
+                            mca_coll_base_module_t *module);
+int mca_coll_cuda_reduce(void *sbuf, void *rbuf, int count,
+                         struct ompi_datatype_t *dtype,
+                         struct ompi_op_t *op,
+                         int root,
+                         struct ompi_communicator_t *comm,
+                         mca_coll_base_module_t *module);
+
+END_C_DECLS
+
+#endif /* MCA_COLL_CUDA_EXPORT_H */
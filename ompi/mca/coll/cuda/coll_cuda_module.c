@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/base.h"
+#include "ompi/mca/common/cuda/common_cuda.h"
+#include "coll_cuda.h"
+
+static int mca_coll_cuda_module_enable(mca_coll_base_module_t *module,
+                                       struct ompi_communicator_t *comm);
+
+char mca_coll_cuda_bounce_msg[] = "coll_cuda";
+
+
+static void mca_coll_cuda_module_construct(mca_coll_cuda_module_t *module)
+{
+    module->previous_allreduce = NULL;
+    module->previous_allreduce_module = NULL;
+    module->previous_reduce = NULL;
+    module->previous_reduce_module = NULL;
+    module->bounce = NULL;
+    module->bounce_size = 0;
+}
+
+static void mca_coll_cuda_module_destruct(mca_coll_cuda_module_t *module)
+{
+    if (NULL != module->bounce) {
+        mca_common_cuda_unregister(module->bounce, mca_coll_cuda_bounce_msg);
+        free(module->bounce);
+    }
+    if (NULL != module->previous_allreduce_module) {
+        OBJ_RELEASE(module->previous_allreduce_module);
+    }
+    if (NULL != module->previous_reduce_module) {
+        OBJ_RELEASE(module->previous_reduce_module);
+    }
+}
+
+OBJ_CLASS_INSTANCE(mca_coll_cuda_module_t,
+                   mca_coll_base_module_t,
+                   mca_coll_cuda_module_construct,
+                   mca_coll_cuda_module_destruct);
+
+
+/*
+ * Initial query function that is invoked during MPI_INIT, allowing
+ * this module to indicate what level of thread support it provides.
+ */
+int mca_coll_cuda_init_query(bool enable_progress_threads,
+                             bool enable_mpi_threads)
+{
+    /* Nothing to do */
+
+    return OMPI_SUCCESS;
+}
+
+
+/*
+ * Invoked when there's a new communicator that has been created.
+ * Look at the communicator and decide which set of functions and
+ * priority we want to return.
+ */
+mca_coll_base_module_t *
+mca_coll_cuda_comm_query(struct ompi_communicator_t *comm,
+                         int *priority)
+{
+    mca_coll_cuda_module_t *module;
+
+    /* We only work on intracommunicators */
+    if (OMPI_COMM_IS_INTER(comm)) {
+        return NULL;
+    }
+
+    module = OBJ_NEW(mca_coll_cuda_module_t);
+    if (NULL == module) return NULL;
+
+    *priority = mca_coll_cuda_component.priority;
+
+    module->super.coll_module_enable = mca_coll_cuda_module_enable;
+    module->super.ft_event = NULL;
+    module->super.coll_allreduce = mca_coll_cuda_allreduce;
+    module->super.coll_reduce = mca_coll_cuda_reduce;
+
+    return &(module->super);
+}
+
+
+#define CUDA_SAVE_PREV_COLL_API(__api)                                  \
+    do {                                                                \
+        s->previous_ ## __api = comm->c_coll.coll_ ## __api;            \
+        s->previous_ ## __api ## _module = comm->c_coll.coll_ ## __api ## _module; \
+        if (NULL == s->previous_ ## __api ||                            \
+            NULL == s->previous_ ## __api ## _module) {                 \
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output, \
+                                "(%d/%s): no underlying " # __api "; disqualifying myself", \
+                                comm->c_contextid, comm->c_name);       \
+            return OMPI_ERROR;                                          \
+        }                                                               \
+        OBJ_RETAIN(s->previous_ ## __api ## _module);                   \
+    } while (0)
+
+/*
+ * Init module on the communicator
+ */
+static int
+mca_coll_cuda_module_enable(mca_coll_base_module_t *module,
+                            struct ompi_communicator_t *comm)
+{
+    mca_coll_cuda_module_t *s = (mca_coll_cuda_module_t*) module;
+
+    CUDA_SAVE_PREV_COLL_API(allreduce);
+    CUDA_SAVE_PREV_COLL_API(reduce);
+
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "opal/datatype/opal_convertor.h"
+#include "opal/datatype/opal_datatype_cuda.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/common/cuda/common_cuda.h"
+#include "coll_cuda.h"
+
+/*
+ * Host memory for size bytes of staging: the pinned buffer of the module
+ * when it is allowed to grow that far, a temporary one otherwise.
+ */
+static char *
+mca_coll_cuda_get_bounce(mca_coll_cuda_module_t *s, size_t size)
+{
+    if (size > mca_coll_cuda_component.pinned_max) {
+        return (char *) malloc(size);
+    }
+    if (size > s->bounce_size) {
+        if (NULL != s->bounce) {
+            mca_common_cuda_unregister(s->bounce, mca_coll_cuda_bounce_msg);
+            free(s->bounce);
+        }
+        s->bounce_size = 0;
+        s->bounce = (char *) malloc(size);
+        if (NULL == s->bounce) {
+            return NULL;
+        }
+        mca_common_cuda_register(s->bounce, size, mca_coll_cuda_bounce_msg);
+        s->bounce_size = size;
+    }
+    return s->bounce;
+}
+
+static void
+mca_coll_cuda_put_bounce(mca_coll_cuda_module_t *s, char *bounce)
+{
+    if (bounce != s->bounce) {
+        free(bounce);
+    }
+}
+
+
+/*
+ * Reduce (root >= 0) or allreduce (root < 0) through host memory.  The
+ * whole span of the data is staged, holes included, so that the holes of
+ * rbuf come back unchanged.  A contiguous datatype, or MPI_IN_PLACE,
+ * only needs one copy, reduced in place; for the others the data of rbuf
+ * is staged next to the one of sbuf.
+ */
+static int
+mca_coll_cuda_staged_reduce(void *sbuf, void *rbuf, int count,
+                            struct ompi_datatype_t *dtype,
+                            struct ompi_op_t *op, int root,
+                            struct ompi_communicator_t *comm,
+                            mca_coll_cuda_module_t *s)
+{
+    OPAL_PTRDIFF_TYPE lb, extent, true_lb, true_extent;
+    bool has_result = (root < 0 || ompi_comm_rank(comm) == root);
+    bool in_place = (MPI_IN_PLACE == sbuf ||
+                     ompi_datatype_is_contiguous_memory_layout(dtype, count));
+    char *src = (MPI_IN_PLACE == sbuf) ? (char *) rbuf : (char *) sbuf;
+    char *bounce, *host_send;
+    size_t span;
+    int ret;
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    span = true_extent + (size_t) (count - 1) * extent;
+
+    bounce = mca_coll_cuda_get_bounce(s, (in_place || !has_result) ? span : 2 * span);
+    if (NULL == bounce) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    if (!has_result) {
+        opal_cuda_memcpy_sync(bounce, src + true_lb, span);
+        ret = s->previous_reduce(bounce - true_lb, NULL, count, dtype, op, root,
+                                 comm, s->previous_reduce_module);
+        mca_coll_cuda_put_bounce(s, bounce);
+        return ret;
+    }
+
+    if (in_place) {
+        opal_cuda_memcpy_sync(bounce, src + true_lb, span);
+        host_send = MPI_IN_PLACE;
+    } else {
+        opal_cuda_memcpy_sync(bounce, (char *) rbuf + true_lb, span);
+        opal_cuda_memcpy_sync(bounce + span, src + true_lb, span);
+        host_send = bounce + span - true_lb;
+    }
+
+    if (root < 0) {
+        ret = s->previous_allreduce(host_send, bounce - true_lb, count, dtype, op,
+                                    comm, s->previous_allreduce_module);
+    } else {
+        ret = s->previous_reduce(host_send, bounce - true_lb, count, dtype, op, root,
+                                 comm, s->previous_reduce_module);
+    }
+    if (OMPI_SUCCESS == ret) {
+        opal_cuda_memcpy_sync((char *) rbuf + true_lb, bounce, span);
+    }
+
+    mca_coll_cuda_put_bounce(s, bounce);
+    return ret;
+}
+
+
+int
+mca_coll_cuda_allreduce(void *sbuf, void *rbuf, int count,
+                        struct ompi_datatype_t *dtype,
+                        struct ompi_op_t *op,
+                        struct ompi_communicator_t *comm,
+                        mca_coll_base_module_t *module)
+{
+    mca_coll_cuda_module_t *s = (mca_coll_cuda_module_t*) module;
+
+    if (0 == count || !opal_cuda_check_bufs(rbuf, sbuf)) {
+        return s->previous_allreduce(sbuf, rbuf, count, dtype, op, comm,
+                                     s->previous_allreduce_module);
+    }
+
+    return mca_coll_cuda_staged_reduce(sbuf, rbuf, count, dtype, op, -1, comm, s);
+}
+
+
+int
+mca_coll_cuda_reduce(void *sbuf, void *rbuf, int count,
+                     struct ompi_datatype_t *dtype,
+                     struct ompi_op_t *op,
+                     int root,
+                     struct ompi_communicator_t *comm,
+                     mca_coll_base_module_t *module)
+{
+    mca_coll_cuda_module_t *s = (mca_coll_cuda_module_t*) module;
+    bool is_root = (ompi_comm_rank(comm) == root);
+
+    /* rbuf only matters at the root */
+    if (0 == count ||
+        !opal_cuda_check_bufs(is_root ? (char *) rbuf : NULL, (char *) sbuf)) {
+        return s->previous_reduce(sbuf, rbuf, count, dtype, op, root, comm,
+                                  s->previous_reduce_module);
+    }
+
+    return mca_coll_cuda_staged_reduce(sbuf, rbuf, count, dtype, op, root, comm, s);
+}
@@ -167,6 +167,9 @@ struct mca_coll_fca_component_t {
     /** MCA parameter: FCA NP */
     int   fca_np;
 
+    /** MCA parameter: Create the FCA communicator on the first collective */
+    int   fca_lazy_comm;
+
     /* FCA global stuff */
     fca_t *fca_context;                                 /* FCA context handle */
     mca_coll_fca_dtype_info_t fca_dtypes[FCA_DT_MAX_PREDEFINED]; /* FCA dtype translation */
@@ -189,6 +192,7 @@ struct mca_coll_fca_module_t {
     int                 num_local_procs;
     int                 *local_ranks;
     fca_comm_t          *fca_comm;
+    bool                fca_comm_failed;
     fca_comm_desc_t     fca_comm_desc;
     fca_comm_caps_t     fca_comm_caps;
 
@@ -231,6 +235,19 @@ OBJ_CLASS_DECLARATION(mca_coll_fca_module_t);
 int mca_coll_fca_init_query(bool enable_progress_threads, bool enable_mpi_threads);
 mca_coll_base_module_t *mca_coll_fca_comm_query(struct ompi_communicator_t *comm, int *priority);
 int mca_coll_fca_get_fca_lib(struct ompi_communicator_t *comm);
+int mca_coll_fca_comm_setup(mca_coll_fca_module_t *fca_module);
+
+/*
+ * The FCA communicator is created by the first collective that needs it
+ * (all ranks call the collectives in the same order), the collective
+ * falls back to the previous module when it cannot be created.
+ */
+#define FCA_ENSURE_COMM(__fca_module, __label) do {\
+    if (OPAL_UNLIKELY(NULL == (__fca_module)->fca_comm) &&\
+        OMPI_SUCCESS != mca_coll_fca_comm_setup(__fca_module)) {\
+        goto __label;\
+    }\
+} while(0)
 
 
 /* Collective functions */
@@ -216,6 +216,14 @@ static int fca_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_coll_fca_component.fca_np);
 
+    mca_coll_fca_component.fca_lazy_comm = 1;
+    (void) mca_base_component_var_register(c, "lazy_comm",
+                                           "[1|0|] Create the FCA communicator on the first collective call instead of at communicator creation",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_coll_fca_component.fca_lazy_comm);
+
     mca_coll_fca_component.fca_enable_barrier = OMPI_FCA_BCAST;
     (void) mca_base_component_var_register(c, "enable_barrier",
                                            "[1|0|] Enable/Disable FCA Barrier support",
@@ -360,18 +360,41 @@ static int mca_coll_fca_module_enable(mca_coll_base_module_t *module,
     if (rc != OMPI_SUCCESS)
         return rc;
 
-    rc = __get_local_ranks(fca_module);
-    if (rc != OMPI_SUCCESS)
-        return rc;
-
-    rc = __create_fca_comm(fca_module);
-    if (rc != OMPI_SUCCESS)
-        return rc;
+    if (!mca_coll_fca_component.fca_lazy_comm) {
+        rc = mca_coll_fca_comm_setup(fca_module);
+        if (rc != OMPI_SUCCESS)
+            return rc;
+    }
 
     FCA_MODULE_VERBOSE(fca_module, 1, "FCA Module initialized");
     return OMPI_SUCCESS;
 }
 
+/*
+ * Create the FCA communicator, collective over the communicator. Called
+ * from the enable step, or by the first collective with lazy_comm; a
+ * failure is remembered so that the following collectives go straight
+ * to the previous module.
+ */
+int mca_coll_fca_comm_setup(mca_coll_fca_module_t *fca_module)
+{
+    int rc;
+
+    if (fca_module->fca_comm_failed) {
+        return OMPI_ERROR;
+    }
+
+    rc = __get_local_ranks(fca_module);
+    if (rc == OMPI_SUCCESS) {
+        rc = __create_fca_comm(fca_module);
+    }
+    if (rc != OMPI_SUCCESS) {
+        FCA_MODULE_VERBOSE(fca_module, 1, "FCA communicator not created, using fallback");
+        fca_module->fca_comm_failed = true;
+    }
+    return rc;
+}
+
 
 static int mca_coll_fca_ft_event(int state)
 {    
@@ -383,6 +406,7 @@ static void mca_coll_fca_module_clear(mca_coll_fca_module_t *fca_module)
     fca_module->num_local_procs = 0;
     fca_module->local_ranks = NULL;
     fca_module->fca_comm = NULL;
+    fca_module->fca_comm_failed = false;
 
     fca_module->previous_barrier    = NULL;
     fca_module->previous_bcast      = NULL;
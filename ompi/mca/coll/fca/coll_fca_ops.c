@@ -152,6 +152,7 @@ int mca_coll_fca_barrier(struct ompi_communicator_t *comm,
     mca_coll_fca_module_t *fca_module = (mca_coll_fca_module_t*)module;
     int ret;
 
+    FCA_ENSURE_COMM(fca_module, orig_barrier);
     FCA_VERBOSE(5,"Using FCA Barrier");
     ret = fca_do_barrier(fca_module->fca_comm);
     if (ret < 0) {
@@ -186,6 +187,8 @@ int mca_coll_fca_bcast(void *buff, int count, struct ompi_datatype_t *datatype,
     FCA_VERBOSE(5, "[%d] Calling mca_coll_fca_bcast, root=%d, count=%d",
                 ompi_comm_rank(comm), root, count);
 
+    FCA_ENSURE_COMM(fca_module, orig_bcast);
+
     /* Setup exchange buffer */
     spec.root = root;
     if (mca_coll_fca_array_size(datatype, count, &gap, &size)) {
@@ -258,6 +261,8 @@ int mca_coll_fca_reduce(void *sbuf, void *rbuf, int count,
     fca_reduce_spec_t spec;
     int ret;
 
+    FCA_ENSURE_COMM(fca_module, orig_reduce);
+
     mca_coll_fca_get_reduce_root(root, fca_module->rank, &spec);
     spec.sbuf = sbuf;
     spec.rbuf = rbuf;
@@ -300,6 +305,8 @@ int mca_coll_fca_allreduce(void *sbuf, void *rbuf, int count,
     fca_reduce_spec_t spec;
     int ret;
 
+    FCA_ENSURE_COMM(fca_module, orig_allreduce);
+
     spec.sbuf = sbuf;
     spec.rbuf = rbuf;
     if (mca_coll_fca_fill_reduce_spec(count, dtype, op, &spec,
@@ -388,6 +395,8 @@ int mca_coll_fca_allgather(void *sbuf, int scount, struct ompi_datatype_t *sdtyp
     ssize_t total_rcount;
     int ret;
 
+    FCA_ENSURE_COMM(fca_module, orig_allgather);
+
     /* Setup send buffer */
     if(sbuf == MPI_IN_PLACE ) {
         FCA_DT_EXTENT(rdtype, &rdtype_extent);
@@ -458,6 +467,8 @@ int mca_coll_fca_allgatherv(void *sbuf, int scount,
     size_t displ;
     int i, ret;
 
+    FCA_ENSURE_COMM(fca_module, orig_allgatherv);
+
     comm_size = ompi_comm_size(fca_module->comm);
     FCA_DT_EXTENT(rdtype, &rdtype_extent);
 
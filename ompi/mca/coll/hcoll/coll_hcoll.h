@@ -58,6 +58,9 @@ struct mca_coll_hcoll_component_t {
     /** MCA parameter: Enable FCA */
     int   hcoll_enable;
 
+    /** MCA parameter: Create the hcoll context on the first collective */
+    int   hcoll_lazy_context;
+
     /* FCA global stuff */
     void *hcoll_lib_handle;                               /* FCA dynamic library */
     mca_coll_hcoll_ops_t hcoll_ops;
@@ -77,6 +80,7 @@ struct mca_coll_hcoll_module_t {
     MPI_Comm            comm;
     int                 rank;
     void *hcoll_context;
+    bool hcoll_context_failed;
     /* Saved handlers - for fallback */
     mca_coll_base_module_reduce_fn_t previous_reduce;
     mca_coll_base_module_t *previous_reduce_module;
@@ -113,6 +117,16 @@ int mca_coll_hcoll_init_query(bool enable_progress_threads, bool enable_mpi_thre
 mca_coll_base_module_t *mca_coll_hcoll_comm_query(struct ompi_communicator_t *comm, int *priority);
 int mca_coll_hcoll_get_lib(void);
 void hcoll_rte_fns_setup(void);
+int mca_coll_hcoll_context_setup(mca_coll_hcoll_module_t *hcoll_module);
+
+/*
+ * The hcoll context is created by the first collective that needs it (all
+ * ranks call the collectives in the same order); true when there is none
+ * and the collective has to fall back to the previous module.
+ */
+#define HCOL_NO_CONTEXT(__hcoll_module)\
+    (OPAL_UNLIKELY(NULL == (__hcoll_module)->hcoll_context) &&\
+     OMPI_SUCCESS != mca_coll_hcoll_context_setup(__hcoll_module))
 
 
 int mca_coll_hcoll_barrier(struct ompi_communicator_t *comm,
@@ -203,6 +203,12 @@ static int hcoll_register(void)
                            0));
 
 
+    CHECK(reg_int("lazy_context",NULL,
+                           "[1|0|] Create the HCOL context on the first collective call instead of at communicator creation",
+                           1,
+                           &mca_coll_hcoll_component.hcoll_lazy_context,
+                           0));
+
     CHECK(reg_string("library_path", NULL,
                            "HCOL /path/to/libhcol.so",
                            ""COLL_HCOLL_HOME"/libhcol.so",
@@ -23,6 +23,7 @@ int mca_coll_hcoll_init_query(bool enable_progress_threads, bool enable_mpi_thre
 static void mca_coll_hcoll_module_clear(mca_coll_hcoll_module_t *hcoll_module)
 {
     hcoll_module->hcoll_context = NULL;
+    hcoll_module->hcoll_context_failed = false;
     hcoll_module->previous_barrier    = NULL;
     hcoll_module->previous_bcast      = NULL;
     hcoll_module->previous_reduce     = NULL;
@@ -56,7 +57,9 @@ static void mca_coll_hcoll_module_destruct(mca_coll_hcoll_module_t *hcoll_module
     OBJ_RELEASE(hcoll_module->previous_alltoallv_module);
     OBJ_RELEASE(hcoll_module->previous_alltoallw_module);
     OBJ_RELEASE(hcoll_module->previous_reduce_scatter_module);
-    hcoll_destroy_context(hcoll_module->hcoll_context);
+    if (NULL != hcoll_module->hcoll_context) {
+        hcoll_destroy_context(hcoll_module->hcoll_context);
+    }
     mca_coll_hcoll_module_clear(hcoll_module);
 }
 
@@ -104,12 +107,33 @@ static int mca_coll_hcoll_module_enable(mca_coll_base_module_t *module,
         return OMPI_ERROR;
     }
 
+    if (!mca_coll_hcoll_component.hcoll_lazy_context) {
+        return mca_coll_hcoll_context_setup(hcoll_module);
+    }
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Create the hcoll context, collective over the communicator. Called
+ * from the enable step, or by the first collective with lazy_context; a
+ * failure is remembered so that the following collectives go straight
+ * to the previous module.
+ */
+int mca_coll_hcoll_context_setup(mca_coll_hcoll_module_t *hcoll_module)
+{
+    ompi_communicator_t *comm = hcoll_module->comm;
+
+    if (hcoll_module->hcoll_context_failed) {
+        return OMPI_ERROR;
+    }
+
     hcoll_set_runtime_tag_offset(-100,mca_pml.pml_max_tag);
 
     hcoll_module->hcoll_context = 
             hcoll_create_context((rte_grp_handle_t)comm);
     if (NULL == hcoll_module->hcoll_context){
         HCOL_VERBOSE(1,"hcoll_create_context returned NULL");
+        hcoll_module->hcoll_context_failed = true;
         return OMPI_ERROR;
     }
 
@@ -153,7 +177,9 @@ static int mca_coll_hcoll_module_enable(mca_coll_base_module_t *module,
         sleep(1);
     }
 #endif
-    hcoll_module->super.coll_barrier(comm,module);
+    if (NULL != hcoll_module->super.coll_barrier) {
+        hcoll_module->super.coll_barrier(comm,&hcoll_module->super);
+    }
     return OMPI_SUCCESS;
 }
 
@@ -18,6 +18,10 @@ int mca_coll_hcoll_barrier(struct ompi_communicator_t *comm,
     int rc;
     HCOL_VERBOSE(20,"RUNNING HCOL BARRIER");
     mca_coll_hcoll_module_t *hcoll_module = (mca_coll_hcoll_module_t*)module;
+    if (HCOL_NO_CONTEXT(hcoll_module)){
+        HCOL_VERBOSE(20,"No hcoll context; calling fallback barrier;");
+        return hcoll_module->previous_barrier(comm,hcoll_module->previous_barrier_module);
+    }
     rc = hcoll_collectives.coll_barrier(hcoll_module->hcoll_context);
     if (HCOLL_SUCCESS != rc){
         HCOL_VERBOSE(20,"RUNNING FALLBACK BARRIER");
@@ -35,6 +39,11 @@ int mca_coll_hcoll_bcast(void *buff, int count,
     int rc;
     HCOL_VERBOSE(20,"RUNNING HCOL BCAST");
     mca_coll_hcoll_module_t *hcoll_module = (mca_coll_hcoll_module_t*)module;
+    if (HCOL_NO_CONTEXT(hcoll_module)){
+        HCOL_VERBOSE(20,"No hcoll context; calling fallback bcast;");
+        return hcoll_module->previous_bcast(buff,count,datatype,root,
+                                            comm,hcoll_module->previous_bcast_module);
+    }
     dtype = ompi_dtype_2_dte_dtype(datatype);
     if (OPAL_UNLIKELY(HCOL_DTE_IS_ZERO(dtype))){
         /*If we are here then datatype is not simple predefined datatype */
@@ -66,6 +75,13 @@ int mca_coll_hcoll_allgather(void *sbuf, int scount,
     int rc;
     HCOL_VERBOSE(20,"RUNNING HCOL ALLGATHER");
     mca_coll_hcoll_module_t *hcoll_module = (mca_coll_hcoll_module_t*)module;
+    if (HCOL_NO_CONTEXT(hcoll_module)){
+        HCOL_VERBOSE(20,"No hcoll context; calling fallback allgather;");
+        return hcoll_module->previous_allgather(sbuf,scount,sdtype,
+                                                rbuf,rcount,rdtype,
+                                                comm,
+                                                hcoll_module->previous_allgather_module);
+    }
     stype = ompi_dtype_2_dte_dtype(sdtype);
     rtype = ompi_dtype_2_dte_dtype(rdtype);
     if (OPAL_UNLIKELY(HCOL_DTE_IS_ZERO(stype) || HCOL_DTE_IS_ZERO(rtype))){
@@ -103,6 +119,12 @@ int mca_coll_hcoll_allreduce(void *sbuf, void *rbuf, int count,
     int rc;
     HCOL_VERBOSE(20,"RUNNING HCOL ALLREDUCE");
     mca_coll_hcoll_module_t *hcoll_module = (mca_coll_hcoll_module_t*)module;
+    if (HCOL_NO_CONTEXT(hcoll_module)){
+        HCOL_VERBOSE(20,"No hcoll context; calling fallback allreduce;");
+        return hcoll_module->previous_allreduce(sbuf,rbuf,
+                                                count,dtype,op,
+                                                comm, hcoll_module->previous_allreduce_module);
+    }
     Dtype = ompi_dtype_2_dte_dtype(dtype);
     if (OPAL_UNLIKELY(HCOL_DTE_IS_ZERO(Dtype))){
         /*If we are here then datatype is not simple predefined datatype */
@@ -151,6 +173,13 @@ int mca_coll_hcoll_alltoall(void *sbuf, int scount,
     int rc;
     HCOL_VERBOSE(20,"RUNNING HCOL ALLTOALL");
     mca_coll_hcoll_module_t *hcoll_module = (mca_coll_hcoll_module_t*)module;
+    if (HCOL_NO_CONTEXT(hcoll_module)){
+        HCOL_VERBOSE(20,"No hcoll context; calling fallback alltoall;");
+        return hcoll_module->previous_alltoall(sbuf,scount,sdtype,
+                                               rbuf,rcount,rdtype,
+                                               comm,
+                                               hcoll_module->previous_alltoall_module);
+    }
     stype = ompi_dtype_2_dte_dtype(sdtype);
     rtype = ompi_dtype_2_dte_dtype(rdtype);
     if (OPAL_UNLIKELY(HCOL_DTE_IS_ZERO(stype) || HCOL_DTE_IS_ZERO(rtype))){
@@ -559,7 +559,7 @@ struct ompi_communicator_t*  mca_coll_hierarch_get_llcomm (int root,
 static void
 mca_coll_hierarch_checkfor_sm ( struct ompi_communicator_t *comm, int *color,  int *ncount )
 {
-    int i, size;
+    int i, size, local;
     int lncount=0;
     struct ompi_proc_t** procs=NULL;
     struct ompi_proc_t* my_proc=NULL;
@@ -570,8 +570,19 @@ mca_coll_hierarch_checkfor_sm ( struct ompi_communicator_t *comm, int *color,  i
     my_proc = ompi_proc_local();
     procs = comm->c_local_group->grp_proc_pointers;
     for ( i = 0 ; i < size ; i++) {
-	if ( procs[i]->proc_name.jobid == my_proc->proc_name.jobid &&
-	     ( OPAL_PROC_ON_LOCAL_NODE(procs[i]->proc_flags)) ) {
+	if ( procs[i]->proc_name.jobid != my_proc->proc_name.jobid ) {
+	    continue;
+	}
+	if ( mca_coll_hierarch_numa_leaders_param ) {
+	    /* The NUMA locality is computed from the binding of the processes:
+	       an unbound process does not share its NUMA domain with anybody
+	       and forms a group of its own. */
+	    local = ( procs[i] == my_proc || OPAL_PROC_ON_LOCAL_NUMA(procs[i]->proc_flags));
+	}
+	else {
+	    local = OPAL_PROC_ON_LOCAL_NODE(procs[i]->proc_flags);
+	}
+	if ( local ) {
 	    lncount++;
 	    if ( *color == -1){
 		 *color = i;
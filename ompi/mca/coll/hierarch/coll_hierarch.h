@@ -50,6 +50,7 @@ extern int mca_coll_hierarch_ignore_sm_param;
 extern int mca_coll_hierarch_detection_alg_param;
 extern int mca_coll_hierarch_bcast_alg_param;
 extern int mca_coll_hierarch_segsize_param;
+extern int mca_coll_hierarch_numa_leaders_param;
 
 
 #define COLL_HIERARCH_SEG_BCAST_ALG   0
@@ -27,13 +27,25 @@
 #include "ompi/communicator/communicator.h"
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/mca/coll/coll.h"
+#include "ompi/request/request.h"
 
 
 /*
- *	reduce_intra
+ * The allreduce is done in segments of mca_coll_hierarch_segsize_param
+ * bytes: each segment is reduced on the local leader, reduced among the
+ * local leaders and broadcast back in the low level communicator. When
+ * the low level communicator provides a non-blocking broadcast, the
+ * broadcast of a segment is not waited for before the reduction of the
+ * next one starts, so the levels of the hierarchy work at the same time.
+ * At most HIER_ALLREDUCE_NUM_PENDING broadcasts are outstanding.
+ */
+#define HIER_ALLREDUCE_NUM_PENDING 2
+
+/*
+ *	allreduce_intra
  *
- *	Function:	- reduction using two level hierarchy algorithm
- *	Accepts:	- same as MPI_Reduce()
+ *	Function:	- allreduce using two level hierarchy algorithm
+ *	Accepts:	- same as MPI_Allreduce()
  *	Returns:	- MPI_SUCCESS or error code
  */
 int mca_coll_hierarch_allreduce_intra(void *sbuf, void *rbuf, int count,
@@ -45,70 +57,138 @@ int mca_coll_hierarch_allreduce_intra(void *sbuf, void *rbuf, int count,
     struct ompi_communicator_t *llcomm=NULL;
     struct ompi_communicator_t *lcomm=NULL;
     mca_coll_hierarch_module_t *hierarch_module = (mca_coll_hierarch_module_t *) module;
+    ompi_request_t *reqs[HIER_ALLREDUCE_NUM_PENDING];
     int rank;
     int lroot, llroot;
     ptrdiff_t extent, true_extent, lb, true_lb;
+    size_t typesize=0;
     char *tmpbuf=NULL, *tbuf=NULL;
-    int ret=OMPI_SUCCESS;
+    char *sseg, *rseg;
+    int segsize = mca_coll_hierarch_segsize_param;
+    int num_segments=0, segcount=0, segindex=0, remaining_count;
+    int i, ret=OMPI_SUCCESS;
     int root=0;
 
     rank   = ompi_comm_rank ( comm );
     lcomm  = hierarch_module->hier_lcomm;
 
     if ( mca_coll_hierarch_verbose_param ) {
-      printf("%s:%d: executing hierarchical allreduce with cnt=%d \n",
-	     comm->c_name, rank, count );
+      printf("%s:%d: executing hierarchical allreduce with cnt=%d segsize=%d\n",
+	     comm->c_name, rank, count, segsize );
     }
 
     llcomm = mca_coll_hierarch_get_llcomm ( root, hierarch_module, &llroot, &lroot);
 
-    if ( MPI_COMM_NULL != lcomm ) {
-      ompi_datatype_get_extent(dtype, &lb, &extent);
-      ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
-      
-      tbuf = (char*)malloc(true_extent + (count - 1) * extent);
-      if (NULL == tbuf) {
-	return OMPI_ERR_OUT_OF_RESOURCE;
-      }
-      tmpbuf = tbuf - lb;
-      
-      if ( MPI_IN_PLACE != sbuf ) {
-	ret = lcomm->c_coll.coll_reduce (sbuf, tmpbuf, count, dtype, 
-					 op, lroot, lcomm, 
-					 lcomm->c_coll.coll_reduce_module);
-      }
-      else {
-	ret = lcomm->c_coll.coll_reduce (rbuf, tmpbuf, count, dtype, 
-					 op, lroot, lcomm, 
-					 lcomm->c_coll.coll_reduce_module);
-      }
-      if ( OMPI_SUCCESS != ret ) {
-	goto exit;
-      }
+    ompi_datatype_type_size ( dtype, &typesize );
+    ompi_datatype_get_extent ( dtype, &lb, &extent );
+    ompi_datatype_get_true_extent ( dtype, &true_lb, &true_extent );
+
+    /* Determine number of segments and number of elements per segment */
+    if ((typesize > 0) && (segsize % typesize != 0)) {
+	/* segment size must be a multiple of typesize */
+	segsize = typesize * (segsize / typesize);
+    }
+    if ((segsize <= 0) || (count == 0) || (typesize == 0)) {
+	segcount = count;
+	num_segments = 1;
+    }
+    else {
+	segcount = segsize / typesize;
+	num_segments = count / segcount;
+	if ( (count % segcount) != 0 ) {
+	    num_segments++;
+	}
+	if (num_segments == 1) {
+	    segcount = count;
+	}
+    }
+
+    /* Only the local leaders need a buffer for the result of the local
+       reduction, and one segment is enough since it is reduced among the
+       local leaders before the next segment is started. */
+    if ( MPI_COMM_NULL != lcomm && MPI_COMM_NULL != llcomm && 0 < count ) {
+	tbuf = (char*)malloc(true_extent + (segcount - 1) * extent);
+	if (NULL == tbuf) {
+	    return OMPI_ERR_OUT_OF_RESOURCE;
+	}
+	tmpbuf = tbuf - lb;
     }
 
-    if ( MPI_UNDEFINED != llroot ) {
-      if ( MPI_COMM_NULL != lcomm ) {
-	ret = llcomm->c_coll.coll_allreduce (tmpbuf, rbuf, count, dtype,
-					     op, llcomm, 
-					     llcomm->c_coll.coll_allreduce_module);
-      }
-      else {
-	ret = llcomm->c_coll.coll_allreduce (sbuf, rbuf, count, dtype,
-					     op, llcomm, 
-					     llcomm->c_coll.coll_allreduce_module);
-      }
-    }	
-
-    if ( MPI_COMM_NULL != lcomm ) {
-	ret = lcomm->c_coll.coll_bcast(rbuf, count, dtype, lroot, lcomm, 
-				       lcomm->c_coll.coll_bcast_module );
+    for ( i=0; i<HIER_ALLREDUCE_NUM_PENDING; i++ ) {
+	reqs[i] = MPI_REQUEST_NULL;
     }
 
+    sseg = (char *) ((MPI_IN_PLACE != sbuf) ? sbuf : rbuf);
+    rseg = (char *) rbuf;
+    remaining_count = segcount;
+
+    for (segindex = 0; segindex < num_segments; segindex++) {
+	/* determine how many elements are reduced in this round */
+	if( segindex == (num_segments - 1) ) {
+	    remaining_count = count - segindex*segcount;
+	}
+
+	if ( MPI_COMM_NULL != lcomm ) {
+	    /* the non-leaders do not touch the receive buffer of the reduce */
+	    ret = lcomm->c_coll.coll_reduce (sseg, (NULL != tmpbuf) ? tmpbuf : rseg,
+					     remaining_count, dtype,
+					     op, lroot, lcomm,
+					     lcomm->c_coll.coll_reduce_module);
+	    if ( OMPI_SUCCESS != ret ) {
+		goto exit;
+	    }
+	}
+
+	if ( MPI_UNDEFINED != llroot ) {
+	    if ( MPI_COMM_NULL != lcomm ) {
+		ret = llcomm->c_coll.coll_allreduce (tmpbuf, rseg, remaining_count, dtype,
+						     op, llcomm,
+						     llcomm->c_coll.coll_allreduce_module);
+	    }
+	    else {
+		ret = llcomm->c_coll.coll_allreduce (sseg, rseg, remaining_count, dtype,
+						     op, llcomm,
+						     llcomm->c_coll.coll_allreduce_module);
+	    }
+	    if ( OMPI_SUCCESS != ret ) {
+		goto exit;
+	    }
+	}
+
+	if ( MPI_COMM_NULL != lcomm ) {
+	    if ( NULL != lcomm->c_coll.coll_ibcast && 1 < num_segments ) {
+		i = segindex % HIER_ALLREDUCE_NUM_PENDING;
+		if ( MPI_REQUEST_NULL != reqs[i] ) {
+		    ret = ompi_request_wait ( &reqs[i], MPI_STATUS_IGNORE );
+		    if ( OMPI_SUCCESS != ret ) {
+			goto exit;
+		    }
+		}
+		ret = lcomm->c_coll.coll_ibcast (rseg, remaining_count, dtype, lroot,
+						 lcomm, &reqs[i],
+						 lcomm->c_coll.coll_ibcast_module );
+	    }
+	    else {
+		ret = lcomm->c_coll.coll_bcast (rseg, remaining_count, dtype, lroot, lcomm,
+						lcomm->c_coll.coll_bcast_module );
+	    }
+	    if ( OMPI_SUCCESS != ret ) {
+		goto exit;
+	    }
+	}
+
+	sseg += segcount * extent;
+	rseg += segcount * extent;
+    }
 
  exit:
-    if ( NULL != tmpbuf ) {
-	free ( tmpbuf );
+    for ( i=0; i<HIER_ALLREDUCE_NUM_PENDING; i++ ) {
+	if ( MPI_REQUEST_NULL != reqs[i] ) {
+	    ompi_request_wait ( &reqs[i], MPI_STATUS_IGNORE );
+	}
+    }
+    if ( NULL != tbuf ) {
+	free ( tbuf );
     }
 
     return ret;
@@ -48,6 +48,7 @@ int mca_coll_hierarch_ignore_sm_param=0;
 int mca_coll_hierarch_detection_alg_param=2;
 int mca_coll_hierarch_bcast_alg_param=COLL_HIERARCH_BASIC_BCAST_ALG;
 int mca_coll_hierarch_segsize_param=32768;
+int mca_coll_hierarch_numa_leaders_param=0;
 
 /*
  * Local function
@@ -160,6 +161,17 @@ static int hierarch_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_coll_hierarch_segsize_param);
 
+    mca_coll_hierarch_numa_leaders_param = 0;
+    (void) mca_base_component_var_register(&mca_coll_hierarch_component.collm_version,
+                                           "numa_leaders",
+                                           "With the two level detection algorithm, group the processes "
+                                           "by NUMA domain instead of by node, so that each NUMA domain "
+                                           "has its own local leader. Requires the processes to be bound.",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_coll_hierarch_numa_leaders_param);
+
     return OMPI_SUCCESS;
 }
 
@@ -101,8 +101,8 @@ int mca_coll_hierarch_reduce_intra(void *sbuf, void *rbuf, int count,
     }
 
  exit:
-    if ( NULL != tmpbuf ) {
-	free ( tmpbuf );
+    if ( NULL != tbuf ) {
+	free ( tbuf );
     }
 
     return ret;
@@ -79,6 +79,13 @@ struct ompi_coll_libnbc_module_t {
     opal_mutex_t mutex;
     bool comm_registered;
     int tag;
+    struct NBC_Sched_template *allreduce_template; /* last iallreduce schedule */
+    struct NBC_Sched_template *neighbor_allgather_template; /* last ineighbor_allgather schedule */
+    struct NBC_Sched_template *neighbor_alltoall_template; /* last ineighbor_alltoall schedule */
+    /* neighborhood of the topology, looked up at the first neighborhood
+       collective (destinations points into the sources array) */
+    int indegree, outdegree;
+    int *sources, *destinations;
 #ifdef NBC_CACHE_SCHEDULE
   void *NBC_Dict[NBC_NUM_COLL]; /* this should point to a struct
                                       hb_tree, but since this is a
@@ -104,9 +111,11 @@ struct ompi_coll_libnbc_request_t {
     int tag;
     volatile int req_count;
     ompi_request_t **req_array;
+    volatile int32_t req_pending; /* requests of the round not completed yet */
     NBC_Comminfo *comminfo;
     volatile NBC_Schedule *schedule;
     void *tmpbuf; /* temporary buffer e.g. used for Reduce */
+    NBC_Schedule *persistent_schedule; /* built once by the _init call, run by every start */
     /* TODO: we should make a handle pointer to a state later (that the user
      * can move request handles) */
 };
@@ -138,6 +147,8 @@ int ompi_coll_libnbc_progress(void);
 
 int NBC_Init_comm(MPI_Comm comm, ompi_coll_libnbc_module_t *module);
 int NBC_Progress(NBC_Handle *handle);
+void NBC_Free_persistent(NBC_Handle *handle);
+void NBC_Sched_template_free(struct NBC_Sched_template *tmpl);
 
 
 int ompi_coll_libnbc_iallgather(void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, 
@@ -149,6 +160,9 @@ int ompi_coll_libnbc_iallgatherv(void* sendbuf, int sendcount, MPI_Datatype send
 int ompi_coll_libnbc_iallreduce(void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, 
                                 struct ompi_communicator_t *comm, ompi_request_t ** request,
                                 struct mca_coll_base_module_2_0_0_t *module);
+int ompi_coll_libnbc_allreduce_init(void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op,
+                                    struct ompi_communicator_t *comm, ompi_request_t ** request,
+                                    struct mca_coll_base_module_2_0_0_t *module);
 int ompi_coll_libnbc_ialltoall(void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, 
                                MPI_Datatype recvtype, struct ompi_communicator_t *comm, ompi_request_t ** request,
                                struct mca_coll_base_module_2_0_0_t *module);
@@ -165,6 +179,9 @@ int ompi_coll_libnbc_ibarrier(struct ompi_communicator_t *comm, ompi_request_t *
 int ompi_coll_libnbc_ibcast(void *buffer, int count, MPI_Datatype datatype, int root,
                             struct ompi_communicator_t *comm, ompi_request_t ** request,
                             struct mca_coll_base_module_2_0_0_t *module);
+int ompi_coll_libnbc_bcast_init(void *buffer, int count, MPI_Datatype datatype, int root,
+                                struct ompi_communicator_t *comm, ompi_request_t ** request,
+                                struct mca_coll_base_module_2_0_0_t *module);
 int ompi_coll_libnbc_iexscan(void *sbuf, void *rbuf, int count, struct ompi_datatype_t *dtype, 
                              struct ompi_op_t *op, struct ompi_communicator_t *comm, ompi_request_t **request,
                              struct mca_coll_base_module_2_0_0_t *module);
@@ -196,6 +213,12 @@ int ompi_coll_libnbc_iscatterv(void* sendbuf, int *sendcounts, int *displs, MPI_
                                void* recvbuf, int recvcount, MPI_Datatype recvtype, int root, 
                                struct ompi_communicator_t *comm, ompi_request_t ** request,
                                struct mca_coll_base_module_2_0_0_t *module);
+int ompi_coll_libnbc_ineighbor_allgather(void *sbuf, int scount, MPI_Datatype stype, void *rbuf,
+                                         int rcount, MPI_Datatype rtype, struct ompi_communicator_t *comm,
+                                         ompi_request_t ** request, struct mca_coll_base_module_2_0_0_t *module);
+int ompi_coll_libnbc_ineighbor_alltoall(void *sbuf, int scount, MPI_Datatype stype, void *rbuf,
+                                        int rcount, MPI_Datatype rtype, struct ompi_communicator_t *comm,
+                                        ompi_request_t ** request, struct mca_coll_base_module_2_0_0_t *module);
 
 
 int ompi_coll_libnbc_iallgather_inter(void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, 
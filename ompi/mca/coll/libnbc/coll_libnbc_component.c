@@ -202,6 +202,10 @@ libnbc_comm_query(struct ompi_communicator_t *comm,
         module->super.coll_iscan = ompi_coll_libnbc_iscan;
         module->super.coll_iscatter = ompi_coll_libnbc_iscatter;
         module->super.coll_iscatterv = ompi_coll_libnbc_iscatterv;
+        module->super.coll_ineighbor_allgather = ompi_coll_libnbc_ineighbor_allgather;
+        module->super.coll_ineighbor_alltoall = ompi_coll_libnbc_ineighbor_alltoall;
+        module->super.coll_allreduce_init = ompi_coll_libnbc_allreduce_init;
+        module->super.coll_bcast_init = ompi_coll_libnbc_bcast_init;
     }
     module->super.ft_event = NULL;
 
@@ -247,7 +251,6 @@ ompi_coll_libnbc_progress(void)
             ompi_request_complete(&request->super, true);
             OPAL_THREAD_UNLOCK(&ompi_request_lock);
         }
-        item = opal_list_get_next(item);
     }
 
     opal_atomic_unlock(&mca_coll_libnbc_component.progress_lock);
@@ -261,6 +264,11 @@ libnbc_module_construct(ompi_coll_libnbc_module_t *module)
 {
     OBJ_CONSTRUCT(&module->mutex, opal_mutex_t);
     module->comm_registered = false;
+    module->allreduce_template = NULL;
+    module->neighbor_allgather_template = NULL;
+    module->neighbor_alltoall_template = NULL;
+    module->indegree = module->outdegree = 0;
+    module->sources = module->destinations = NULL;
 }
 
 
@@ -268,6 +276,12 @@ static void
 libnbc_module_destruct(ompi_coll_libnbc_module_t *module)
 {
     OBJ_DESTRUCT(&module->mutex);
+    NBC_Sched_template_free(module->allreduce_template);
+    NBC_Sched_template_free(module->neighbor_allgather_template);
+    NBC_Sched_template_free(module->neighbor_alltoall_template);
+    if (NULL != module->sources) {
+        free(module->sources);
+    }
 
     /* if we ever were used for a collective op, do the progress cleanup. */
     if (true == module->comm_registered) {
@@ -303,6 +317,11 @@ request_free(struct ompi_request_t **ompi_req)
         return MPI_ERR_REQUEST;
     }
 
+    if (request->super.req_persistent) {
+        NBC_Free_persistent(request);
+        request->super.req_start = NULL;
+    }
+
     OMPI_COLL_LIBNBC_REQUEST_RETURN(request);
 
     *ompi_req = MPI_REQUEST_NULL;
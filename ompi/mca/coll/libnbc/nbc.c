@@ -16,7 +16,9 @@
 #include "nbc_internal.h"
 #include "ompi/mca/coll/base/coll_tags.h"
 #include "ompi/op/op.h"
+#include "ompi/datatype/ompi_datatype.h"
 #include "ompi/mca/pml/pml.h"
+#include "ompi/mca/topo/base/base.h"
 
 /* only used in this file */
 static inline int NBC_Start_round(NBC_Handle *handle);
@@ -35,10 +37,22 @@ void NBC_Print_times(double div) {
 
 /* allocates a new schedule array */
 int NBC_Sched_create(NBC_Schedule* schedule) {
+  return NBC_Sched_create_size(schedule, NBC_SCHED_MIN_SIZE);
+}
+
+/* allocates a new schedule array with room for size bytes - see
+ * NBC_SCHED_SIZE() to estimate the size from the number of rounds and
+ * operations */
+int NBC_Sched_create_size(NBC_Schedule* schedule, int size) {
+  NBC_Sched_header *hdr;
   int *ptr;
 
-  *schedule=malloc(2*sizeof(int));
-  if(*schedule == NULL) { return NBC_OOR; }
+  if(size < NBC_SCHED_MIN_SIZE) size = NBC_SCHED_MIN_SIZE;
+  hdr = (NBC_Sched_header*)malloc(sizeof(NBC_Sched_header)+size);
+  if(hdr == NULL) { *schedule = NULL; return NBC_OOR; }
+  hdr->capacity = size;
+  hdr->last_round = sizeof(int);
+  *schedule = (NBC_Schedule)(hdr+1);
 
   /* initialize the schedule */
   ptr = (int*) *schedule;
@@ -49,9 +63,37 @@ int NBC_Sched_create(NBC_Schedule* schedule) {
   return NBC_OK;
 }
 
+/* frees the array of a schedule (not the NBC_Schedule itself) */
+void NBC_Sched_free(NBC_Schedule* schedule) {
+  if(*schedule != NULL) {
+    free((void*)NBC_SCHED_HEADER(*schedule));
+    *schedule = NULL;
+  }
+}
+
+/* makes room for additional bytes at the end of the schedule. The array
+ * grows geometrically, so building a schedule of n operations only
+ * reallocates it O(log n) times */
+static inline int NBC_Sched_grow(NBC_Schedule *schedule, int additional) {
+  NBC_Sched_header *hdr = NBC_SCHED_HEADER(*schedule);
+  int size, capacity;
+
+  NBC_GET_SIZE(*schedule, size);
+  if(size + additional <= hdr->capacity) return NBC_OK;
+
+  capacity = 2 * hdr->capacity;
+  while(capacity < size + additional) capacity *= 2;
+  hdr = (NBC_Sched_header*)realloc(hdr, sizeof(NBC_Sched_header)+capacity);
+  if(hdr == NULL) { printf("Error in realloc()\n"); return NBC_OOR; }
+  hdr->capacity = capacity;
+  *schedule = (NBC_Schedule)(hdr+1);
+
+  return NBC_OK;
+}
+
 /* this function puts a send into the schedule */
 int NBC_Sched_send(void* buf, char tmpbuf, int count, MPI_Datatype datatype, int dest, NBC_Schedule *schedule) {
-  int size;
+  int size, res;
   char* ptr;
   NBC_Fn_type type = SEND;
   NBC_Args_send send_args;
@@ -59,8 +101,8 @@ int NBC_Sched_send(void* buf, char tmpbuf, int count, MPI_Datatype datatype, int
   /* get size of actual schedule */
   NBC_GET_SIZE(*schedule, size);
   /*printf("schedule is %i bytes\n", size);*/
-  *schedule = (NBC_Schedule)realloc(*schedule, size+sizeof(NBC_Fn_type)+sizeof(NBC_Args_send));
-  if(*schedule == NULL) { printf("Error in realloc()\n"); return NBC_OOR; }
+  res = NBC_Sched_grow(schedule, sizeof(NBC_Fn_type)+sizeof(NBC_Args_send));
+  if(res != NBC_OK) { return res; }
   
   /* store the passed arguments */
   send_args.buf=buf;
@@ -86,7 +128,7 @@ int NBC_Sched_send(void* buf, char tmpbuf, int count, MPI_Datatype datatype, int
 
 /* this function puts a receive into the schedule */
 int NBC_Sched_recv(void* buf, char tmpbuf, int count, MPI_Datatype datatype, int source, NBC_Schedule *schedule) {
-  int size;
+  int size, res;
   char* ptr;
   NBC_Fn_type type = RECV;
   NBC_Args_recv recv_args;
@@ -94,8 +136,8 @@ int NBC_Sched_recv(void* buf, char tmpbuf, int count, MPI_Datatype datatype, int
   /* get size of actual schedule */
   NBC_GET_SIZE(*schedule, size);
   /*printf("schedule is %i bytes\n", size);*/
-  *schedule = (NBC_Schedule)realloc(*schedule, size+sizeof(NBC_Fn_type)+sizeof(NBC_Args_recv));
-  if(*schedule == NULL) { printf("Error in realloc()\n"); return NBC_OOR; }
+  res = NBC_Sched_grow(schedule, sizeof(NBC_Fn_type)+sizeof(NBC_Args_recv));
+  if(res != NBC_OK) { return res; }
   
   /* store the passed arguments */
   recv_args.buf=buf;
@@ -121,7 +163,7 @@ int NBC_Sched_recv(void* buf, char tmpbuf, int count, MPI_Datatype datatype, int
 
 /* this function puts an operation into the schedule */
 int NBC_Sched_op(void *buf3, char tmpbuf3, void* buf1, char tmpbuf1, void* buf2, char tmpbuf2, int count, MPI_Datatype datatype, MPI_Op op, NBC_Schedule *schedule) {
-  int size;
+  int size, res;
   char* ptr;
   NBC_Fn_type type = OP;
   NBC_Args_op op_args;
@@ -129,8 +171,8 @@ int NBC_Sched_op(void *buf3, char tmpbuf3, void* buf1, char tmpbuf1, void* buf2,
   /* get size of actual schedule */
   NBC_GET_SIZE(*schedule, size);
   /*printf("schedule is %i bytes\n", size);*/
-  *schedule = (NBC_Schedule)realloc(*schedule, size+sizeof(NBC_Fn_type)+sizeof(NBC_Args_op));
-  if(*schedule == NULL) { printf("Error in realloc()\n"); return NBC_OOR; }
+  res = NBC_Sched_grow(schedule, sizeof(NBC_Fn_type)+sizeof(NBC_Args_op));
+  if(res != NBC_OK) { return res; }
   
   /* store the passed arguments */
   op_args.buf1=buf1;
@@ -160,7 +202,7 @@ int NBC_Sched_op(void *buf3, char tmpbuf3, void* buf1, char tmpbuf1, void* buf2,
 
 /* this function puts a copy into the schedule */
 int NBC_Sched_copy(void *src, char tmpsrc, int srccount, MPI_Datatype srctype, void *tgt, char tmptgt, int tgtcount, MPI_Datatype tgttype, NBC_Schedule *schedule) {
-  int size;
+  int size, res;
   char* ptr;
   NBC_Fn_type type = COPY;
   NBC_Args_copy copy_args;
@@ -168,8 +210,8 @@ int NBC_Sched_copy(void *src, char tmpsrc, int srccount, MPI_Datatype srctype, v
   /* get size of actual schedule */
   NBC_GET_SIZE(*schedule, size);
   /*printf("schedule is %i bytes\n", size);*/
-  *schedule = (NBC_Schedule)realloc(*schedule, size+sizeof(NBC_Fn_type)+sizeof(NBC_Args_copy));
-  if(*schedule == NULL) { printf("Error in realloc()\n"); return NBC_OOR; }
+  res = NBC_Sched_grow(schedule, sizeof(NBC_Fn_type)+sizeof(NBC_Args_copy));
+  if(res != NBC_OK) { return res; }
   
   /* store the passed arguments */
   copy_args.src=src;
@@ -198,7 +240,7 @@ int NBC_Sched_copy(void *src, char tmpsrc, int srccount, MPI_Datatype srctype, v
 
 /* this function puts a unpack into the schedule */
 int NBC_Sched_unpack(void *inbuf, char tmpinbuf, int count, MPI_Datatype datatype, void *outbuf, char tmpoutbuf, NBC_Schedule *schedule) {
-  int size;
+  int size, res;
   char* ptr;
   NBC_Fn_type type = UNPACK;
   NBC_Args_unpack unpack_args;
@@ -206,8 +248,8 @@ int NBC_Sched_unpack(void *inbuf, char tmpinbuf, int count, MPI_Datatype datatyp
   /* get size of actual schedule */
   NBC_GET_SIZE(*schedule, size);
   /*printf("schedule is %i bytes\n", size);*/
-  *schedule = (NBC_Schedule)realloc(*schedule, size+sizeof(NBC_Fn_type)+sizeof(NBC_Args_unpack));
-  if(*schedule == NULL) { printf("Error in realloc()\n"); return NBC_OOR; }
+  res = NBC_Sched_grow(schedule, sizeof(NBC_Fn_type)+sizeof(NBC_Args_unpack));
+  if(res != NBC_OK) { return res; }
   
   /* store the passed arguments */
   unpack_args.inbuf=inbuf;
@@ -234,19 +276,20 @@ int NBC_Sched_unpack(void *inbuf, char tmpinbuf, int count, MPI_Datatype datatyp
 
 /* this function ends a round of a schedule */
 int NBC_Sched_barrier(NBC_Schedule *schedule) {
-  int size, num = 0;
+  int size, res, num = 0;
   char *ptr;
   char delimiter = 1;
   
   /* get size of actual schedule */
   NBC_GET_SIZE(*schedule, size);
   /*printf("round terminated at %i bytes\n", size);*/
-  *schedule = (NBC_Schedule)realloc(*schedule, size+sizeof(char)+sizeof(int));
-  if(*schedule == NULL) { printf("Error in realloc()\n"); return NBC_OOR; }
+  res = NBC_Sched_grow(schedule, sizeof(char)+sizeof(int));
+  if(res != NBC_OK) { return res; }
   
   ptr = (char*)*schedule + size;
   NBC_PUT_BYTES(ptr,delimiter);  /* round-schedule delimiter */
   NBC_PUT_BYTES(ptr,num);        /* initialize num=0 for next round-schedule */
+  NBC_SCHED_HEADER(*schedule)->last_round = size+sizeof(char);
   
   NBC_DEBUG(10, "ending round at byte %i\n", (int)(size+sizeof(char)+sizeof(int)));
   
@@ -258,13 +301,13 @@ int NBC_Sched_barrier(NBC_Schedule *schedule) {
 
 /* this function ends a schedule */
 int NBC_Sched_commit(NBC_Schedule *schedule) {
-  int size;
+  int size, res;
  
   /* get size of actual schedule */
   NBC_GET_SIZE(*schedule, size);
   /*printf("schedule terminated at %i bytes\n", size);*/
-  *schedule = (NBC_Schedule)realloc(*schedule, size+sizeof(char));
-  if(*schedule == NULL) { printf("Error in realloc()\n"); return NBC_OOR; }
+  res = NBC_Sched_grow(schedule, sizeof(char));
+  if(res != NBC_OK) { return res; }
  
   /* add the barrier char (0) because this is the last round */
   *(char*)((char*)*schedule+size)=0;
@@ -276,18 +319,169 @@ int NBC_Sched_commit(NBC_Schedule *schedule) {
   return NBC_OK;
 }
 
+/* moves a user buffer of a template to the corresponding buffer of the
+ * new call (buffers of the temporary buffer are relative and stay) */
+static inline void NBC_Sched_rebind_buf(void **buf, char tmpbuf, NBC_Sched_template *tmpl, void *sendbuf, void *recvbuf) {
+  char *p = (char*)*buf;
+
+  if(tmpbuf) return;
+  if((MPI_IN_PLACE != tmpl->sendbuf) && (p >= (char*)tmpl->sendbuf) && (p < (char*)tmpl->sendbuf + tmpl->sendspan)) {
+    *buf = (char*)sendbuf + (p - (char*)tmpl->sendbuf);
+  } else if((p >= (char*)tmpl->recvbuf) && (p < (char*)tmpl->recvbuf + tmpl->recvspan)) {
+    *buf = (char*)recvbuf + (p - (char*)tmpl->recvbuf);
+  }
+}
+
+/* releases the schedule and the objects of a template, leaving it empty */
+static inline void NBC_Sched_template_clear(NBC_Sched_template *tmpl) {
+  if(tmpl->schedule == NULL) return;
+  NBC_Sched_free(&tmpl->schedule);
+  OBJ_RELEASE(tmpl->datatype);
+  if(tmpl->recvtype != NULL) OBJ_RELEASE(tmpl->recvtype);
+  if(tmpl->op != NULL) OBJ_RELEASE(tmpl->op);
+}
+
+/* tells if the schedule of a template can be re-bound for a call with
+ * these arguments (only the buffers may differ) */
+int NBC_Sched_template_match(NBC_Sched_template *tmpl, NBC_Sched_template *args) {
+  return (tmpl != NULL) && (tmpl->schedule != NULL) &&
+         (tmpl->count == args->count) && (tmpl->datatype == args->datatype) &&
+         (tmpl->recvcount == args->recvcount) && (tmpl->recvtype == args->recvtype) &&
+         (tmpl->op == args->op) && (tmpl->alg == args->alg) &&
+         (tmpl->sendspan == args->sendspan) && (tmpl->recvspan == args->recvspan) &&
+         ((MPI_IN_PLACE == tmpl->sendbuf) == (MPI_IN_PLACE == args->sendbuf));
+}
+
+/* keeps a copy of a committed schedule as the template for the next calls
+ * with the same arguments. The datatypes and the op are retained, so that
+ * their handles are not reused for other objects while the template
+ * refers to them. */
+int NBC_Sched_template_store(NBC_Sched_template **tmpl, NBC_Schedule *schedule, NBC_Sched_template *args) {
+  NBC_Sched_template *t = *tmpl;
+  int size;
+
+  if(t == NULL) {
+    t = (NBC_Sched_template*)calloc(1, sizeof(NBC_Sched_template));
+    if(t == NULL) return NBC_OOR;
+    *tmpl = t;
+  } else {
+    NBC_Sched_template_clear(t);
+  }
+
+  NBC_GET_SIZE(*schedule, size);
+  if(NBC_OK != NBC_Sched_create_size(&t->schedule, size)) return NBC_OOR;
+  memcpy(t->schedule, *schedule, size);
+  NBC_SCHED_HEADER(t->schedule)->last_round = NBC_SCHED_HEADER(*schedule)->last_round;
+
+  t->sendbuf = args->sendbuf;
+  t->recvbuf = args->recvbuf;
+  t->sendspan = args->sendspan;
+  t->recvspan = args->recvspan;
+  t->count = args->count;
+  t->datatype = args->datatype;
+  t->recvcount = args->recvcount;
+  t->recvtype = args->recvtype;
+  t->op = args->op;
+  t->alg = args->alg;
+  OBJ_RETAIN(t->datatype);
+  if(t->recvtype != NULL) OBJ_RETAIN(t->recvtype);
+  if(t->op != NULL) OBJ_RETAIN(t->op);
+
+  return NBC_OK;
+}
+
+/* creates a schedule from a template, re-bound to new buffers. This is a
+ * copy of the schedule array and a walk over its operations, much cheaper
+ * than building the schedule again */
+int NBC_Sched_template_instantiate(NBC_Sched_template *tmpl, NBC_Schedule *schedule, void *sendbuf, void *recvbuf) {
+  int size, num, i, res;
+  char *ptr, delimiter;
+  NBC_Fn_type type;
+  NBC_Args_send     sendargs;
+  NBC_Args_recv     recvargs;
+  NBC_Args_op         opargs;
+  NBC_Args_copy     copyargs;
+  NBC_Args_unpack unpackargs;
+
+  NBC_GET_SIZE(tmpl->schedule, size);
+  res = NBC_Sched_create_size(schedule, size);
+  if(res != NBC_OK) return res;
+  memcpy(*schedule, tmpl->schedule, size);
+  NBC_SCHED_HEADER(*schedule)->last_round = NBC_SCHED_HEADER(tmpl->schedule)->last_round;
+
+  ptr = (char*)*schedule + sizeof(int);
+  do {
+    NBC_GET_BYTES(ptr,num);
+    for(i=0; i<num; i++) {
+      NBC_GET_BYTES(ptr,type);
+      switch(type) {
+        case SEND:
+          memcpy(&sendargs, ptr, sizeof(sendargs));
+          NBC_Sched_rebind_buf(&sendargs.buf, sendargs.tmpbuf, tmpl, sendbuf, recvbuf);
+          NBC_PUT_BYTES(ptr,sendargs);
+          break;
+        case RECV:
+          memcpy(&recvargs, ptr, sizeof(recvargs));
+          NBC_Sched_rebind_buf(&recvargs.buf, recvargs.tmpbuf, tmpl, sendbuf, recvbuf);
+          NBC_PUT_BYTES(ptr,recvargs);
+          break;
+        case OP:
+          memcpy(&opargs, ptr, sizeof(opargs));
+          NBC_Sched_rebind_buf(&opargs.buf1, opargs.tmpbuf1, tmpl, sendbuf, recvbuf);
+          NBC_Sched_rebind_buf(&opargs.buf2, opargs.tmpbuf2, tmpl, sendbuf, recvbuf);
+          NBC_Sched_rebind_buf(&opargs.buf3, opargs.tmpbuf3, tmpl, sendbuf, recvbuf);
+          NBC_PUT_BYTES(ptr,opargs);
+          break;
+        case COPY:
+          memcpy(&copyargs, ptr, sizeof(copyargs));
+          NBC_Sched_rebind_buf(&copyargs.src, copyargs.tmpsrc, tmpl, sendbuf, recvbuf);
+          NBC_Sched_rebind_buf(&copyargs.tgt, copyargs.tmptgt, tmpl, sendbuf, recvbuf);
+          NBC_PUT_BYTES(ptr,copyargs);
+          break;
+        case UNPACK:
+          memcpy(&unpackargs, ptr, sizeof(unpackargs));
+          NBC_Sched_rebind_buf(&unpackargs.inbuf, unpackargs.tmpinbuf, tmpl, sendbuf, recvbuf);
+          NBC_Sched_rebind_buf(&unpackargs.outbuf, unpackargs.tmpoutbuf, tmpl, sendbuf, recvbuf);
+          NBC_PUT_BYTES(ptr,unpackargs);
+          break;
+        default:
+          printf("NBC_Sched_template_instantiate: bad type %li at offset %li\n", (long)type, (long)ptr-(long)*schedule);
+          NBC_Sched_free(schedule);
+          return NBC_BAD_SCHED;
+      }
+    }
+    NBC_GET_BYTES(ptr,delimiter);
+  } while(delimiter != 0);
+
+  return NBC_OK;
+}
+
+/* releases a template and its schedule */
+void NBC_Sched_template_free(NBC_Sched_template *tmpl) {
+  if(tmpl == NULL) return;
+  NBC_Sched_template_clear(tmpl);
+  free(tmpl);
+}
+
 /* finishes a request
  *
  * to be called *only* from the progress thread !!! */
 static inline int NBC_Free(NBC_Handle* handle) {
 
+  /* a persistent request keeps its schedule and temporary buffer for the
+   * next start, they go with the request (NBC_Free_persistent) */
+  if(handle->super.req_persistent) {
+    handle->schedule = NULL;
+    return NBC_OK;
+  }
+
 #ifdef NBC_CACHE_SCHEDULE
   /* do not free schedule because it is in the cache */
   handle->schedule = NULL;
 #else
   if(handle->schedule != NULL) {
     /* free schedule */
-    free((void*)*(handle->schedule));
+    NBC_Sched_free((NBC_Schedule*)handle->schedule);
     free((void*)handle->schedule);
     handle->schedule = NULL;
   }
@@ -316,6 +510,9 @@ int NBC_Progress(NBC_Handle *handle) {
   if(handle->schedule != NULL) {
 
     if((handle->req_count > 0) && (handle->req_array != NULL)) {
+      /* the completion callbacks tell us when the round is over, there is
+       * no need to test the requests before */
+      if(handle->req_pending > 0) return NBC_CONTINUE;
       NBC_DEBUG(50, "NBC_Progress: testing for %i requests\n", handle->req_count);
 #ifdef NBC_TIMING
       Test_time -= MPI_Wtime();
@@ -374,9 +571,43 @@ error:
   return ret;
 }
 
+/* called by the PML, with ompi_request_lock held, when a request of the
+ * current round completes. Starting the next round from here would call
+ * back into the PML under the lock, so only account for the completion;
+ * the progress function (possibly running in the async progress thread)
+ * moves to the next round as soon as the count drops to zero. */
+static int NBC_Req_complete_cb(ompi_request_t *request) {
+  NBC_Handle *handle = (NBC_Handle*)request->req_complete_cb_data;
+
+  OPAL_THREAD_ADD32(&handle->req_pending, -1);
+  return OMPI_SUCCESS;
+}
+
+/* attach the completion callback to the requests posted by the round.
+ * The PML completes requests with ompi_request_lock held, so no request
+ * can complete between the check of req_complete and the setting of the
+ * callback. */
+static inline void NBC_Arm_round(NBC_Handle *handle, int first) {
+  ompi_request_t *req;
+  int32_t pending = 0;
+  int i;
+
+  OPAL_THREAD_LOCK(&ompi_request_lock);
+  for(i=first; i<handle->req_count; i++) {
+    req = handle->req_array[i];
+    if(!req->req_complete) {
+      req->req_complete_cb_data = handle;
+      req->req_complete_cb = NBC_Req_complete_cb;
+      pending++;
+    }
+  }
+  OPAL_THREAD_ADD32(&handle->req_pending, pending);
+  OPAL_THREAD_UNLOCK(&ompi_request_lock);
+}
+
 static inline int NBC_Start_round(NBC_Handle *handle) {
   int num; /* number of operations */
-  int i, res, ret=NBC_OK;
+  int i, res, ret=NBC_OK, first;
   char* ptr;
   NBC_Fn_type type;
   NBC_Args_send     sendargs; 
@@ -394,6 +625,14 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
   NBC_GET_BYTES(ptr,num);
   NBC_DEBUG(10, "start_round round at address %p : posting %i operations\n", myschedule, num);
 
+  first = handle->req_count;
+  /* room for a request per operation of the round, instead of growing the
+     array for every send and receive */
+  if(num > 0) {
+    handle->req_array = (MPI_Request*)realloc((void*)handle->req_array, (handle->req_count+num)*sizeof(MPI_Request));
+    NBC_CHECK_NULL(handle->req_array);
+  }
+
   for (i=0; i<num; i++) {
     NBC_GET_BYTES(ptr,type);
     switch(type) {
@@ -412,8 +651,6 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
 #ifdef NBC_TIMING
         Isend_time -= MPI_Wtime();
 #endif
-        handle->req_array = (MPI_Request*)realloc((void*)handle->req_array, (handle->req_count)*sizeof(MPI_Request));
-        NBC_CHECK_NULL(handle->req_array);
         res = MCA_PML_CALL(isend(buf1, sendargs.count, sendargs.datatype, sendargs.dest, handle->tag, MCA_PML_BASE_SEND_STANDARD, handle->comm, handle->req_array+handle->req_count-1));
         if(OMPI_SUCCESS != res) { printf("Error in MPI_Isend(%lu, %i, %lu, %i, %i, %lu) (%i)\n", (unsigned long)buf1, sendargs.count, (unsigned long)sendargs.datatype, sendargs.dest, handle->tag, (unsigned long)handle->comm, res); ret=res; goto error; }
 #ifdef NBC_TIMING
@@ -435,8 +672,6 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
 #ifdef NBC_TIMING
         Irecv_time -= MPI_Wtime();
 #endif
-        handle->req_array = (MPI_Request*)realloc((void*)handle->req_array, (handle->req_count)*sizeof(MPI_Request));
-        NBC_CHECK_NULL(handle->req_array);
         res = MCA_PML_CALL(irecv(buf1, recvargs.count, recvargs.datatype, recvargs.source, handle->tag, handle->comm, handle->req_array+handle->req_count-1)); 
         if(OMPI_SUCCESS != res) { printf("Error in MPI_Irecv(%lu, %i, %lu, %i, %i, %lu) (%i)\n", (unsigned long)buf1, recvargs.count, (unsigned long)recvargs.datatype, recvargs.source, handle->tag, (unsigned long)handle->comm, res); ret=res; goto error; }
 #ifdef NBC_TIMING
@@ -508,6 +743,8 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
     }
   }
 
+  if(handle->req_count > first) NBC_Arm_round(handle, first);
+
   /* check if we can make progress - not in the first round, this allows us to leave the
    * initialization faster and to reach more overlap 
    *
@@ -535,8 +772,10 @@ int NBC_Init_handle(struct ompi_communicator_t *comm, ompi_coll_libnbc_request_t
   handle->tmpbuf = NULL;
   handle->req_count = 0;
   handle->req_array = NULL;
+  handle->req_pending = 0;
   handle->comm = comm;
   handle->schedule = NULL;
+  handle->persistent_schedule = NULL;
   /* first int is the schedule size */
   handle->row_offset = sizeof(int);
 
@@ -629,6 +868,34 @@ int  NBC_Init_comm(MPI_Comm comm, NBC_Comminfo *comminfo) {
   return OMPI_SUCCESS;
 }
 
+/* looks up the neighborhood of the topology of the communicator, at the
+ * first neighborhood collective (the topology is attached to the
+ * communicator after the collectives are selected) */
+int NBC_Comm_neighbors(MPI_Comm comm, NBC_Comminfo *comminfo) {
+  int res, indegree, outdegree;
+
+  if(comminfo->sources != NULL) return NBC_OK;
+
+  res = mca_topo_base_neighbor_count(comm, &indegree, &outdegree);
+  if(OMPI_SUCCESS != res) return NBC_INVALID_TOPOLOGY_COMM;
+
+  /* one array for both lists, never empty */
+  comminfo->sources = (int*)malloc(sizeof(int)*(indegree+outdegree+1));
+  if(comminfo->sources == NULL) return NBC_OOR;
+  comminfo->destinations = comminfo->sources + indegree;
+
+  res = mca_topo_base_neighbors(comm, comminfo->sources, comminfo->destinations);
+  if(OMPI_SUCCESS != res) {
+    free(comminfo->sources);
+    comminfo->sources = comminfo->destinations = NULL;
+    return NBC_INVALID_TOPOLOGY_COMM;
+  }
+  comminfo->indegree = indegree;
+  comminfo->outdegree = outdegree;
+
+  return NBC_OK;
+}
+
 int NBC_Start(NBC_Handle *handle, NBC_Schedule *schedule) {
   int res;
 
@@ -638,11 +905,72 @@ int NBC_Start(NBC_Handle *handle, NBC_Schedule *schedule) {
   res = NBC_Start_round(handle);
   if((NBC_OK != res)) { printf("Error in NBC_Start_round() (%i)\n", res); return res; }
 
+  /* the progress function may be walking the list in the progress thread */
+  opal_atomic_lock(&mca_coll_libnbc_component.progress_lock);
   opal_list_append(&mca_coll_libnbc_component.active_requests, &(handle->super.super.super));
+  opal_atomic_unlock(&mca_coll_libnbc_component.progress_lock);
 
   return NBC_OK;
 }
 
+/* MPI_Start of persistent collectives: every start runs the schedule
+ * built by the _init call again, under a tag of its own as a new
+ * nonblocking collective would */
+static int NBC_Start_persistent(size_t count, ompi_request_t **requests) {
+  NBC_Handle *handle;
+  size_t i;
+  int res;
+
+  for(i = 0; i < count; ++i) {
+    handle = (NBC_Handle*)requests[i];
+    if(OMPI_REQUEST_ACTIVE == handle->super.req_state) return OMPI_ERR_REQUEST;
+
+    OPAL_THREAD_LOCK(&handle->comminfo->mutex);
+    if(--handle->comminfo->tag == (-1 * mca_pml.pml_max_tag)) {
+      handle->comminfo->tag = MCA_COLL_BASE_TAG_NONBLOCKING_BASE;
+    }
+    handle->tag = handle->comminfo->tag;
+    OPAL_THREAD_UNLOCK(&handle->comminfo->mutex);
+
+    handle->row_offset = sizeof(int);
+    handle->req_count = 0;
+    handle->req_array = NULL;
+    handle->req_pending = 0;
+    handle->super.req_status.MPI_ERROR = OMPI_SUCCESS;
+    handle->super.req_complete = false;
+    handle->super.req_state = OMPI_REQUEST_ACTIVE;
+
+    res = NBC_Start(handle, handle->persistent_schedule);
+    if(NBC_OK != res) { printf("Error in NBC_Start() (%i)\n", res); return OMPI_ERROR; }
+  }
+
+  return OMPI_SUCCESS;
+}
+
+/* turns the handle of an _init call into an inactive persistent request
+ * that owns the schedule and the temporary buffer */
+int NBC_Init_persistent(NBC_Handle *handle, NBC_Schedule *schedule) {
+  handle->persistent_schedule = schedule;
+  handle->super.req_persistent = true;
+  handle->super.req_start = NBC_Start_persistent;
+  handle->super.req_state = OMPI_REQUEST_INACTIVE;
+  handle->super.req_complete = true;
+
+  return NBC_OK;
+}
+
+void NBC_Free_persistent(NBC_Handle *handle) {
+  if(handle->persistent_schedule != NULL) {
+    NBC_Sched_free(handle->persistent_schedule);
+    free(handle->persistent_schedule);
+    handle->persistent_schedule = NULL;
+  }
+  if(handle->tmpbuf != NULL) {
+    free(handle->tmpbuf);
+    handle->tmpbuf = NULL;
+  }
+}
+
 #ifdef NBC_CACHE_SCHEDULE
 void NBC_SchedCache_args_delete_key_dummy(void *k) {
     /* do nothing because the key and the data element are identical :-) 
@@ -654,7 +982,7 @@ void NBC_SchedCache_args_delete(void *entry) {
   
   tmp = (struct NBC_dummyarg*)entry;
   /* free taglistentry */
-  free((void*)*(tmp->schedule));
+  NBC_Sched_free(tmp->schedule);
   /* the schedule pointer itself is also malloc'd */
   free((void*)tmp->schedule);
   free((void*)tmp);
@@ -14,6 +14,52 @@
 static inline int allred_sched_diss(int rank, int p, int count, MPI_Datatype datatype, void *sendbuf, void *recvbuf, MPI_Op op, NBC_Schedule *schedule, NBC_Handle *handle);
 static inline int allred_sched_ring(int rank, int p, int count, MPI_Datatype datatype, void *sendbuf, void *recvbuf, MPI_Op op, int size, int ext, NBC_Schedule *schedule, NBC_Handle *handle);
 
+enum { NBC_ARED_BINOMIAL, NBC_ARED_RING };
+
+/* algorithm selection */
+static inline int allred_sched_alg(int p, int size, int count, char inplace) {
+  if(p < 4 || size*count < 65536 || inplace) {
+    return NBC_ARED_BINOMIAL;
+  }
+  return NBC_ARED_RING;
+}
+
+/* builds and commits the schedule of the algorithm, with a copy of the
+ * send buffer to the receive buffer first if copy is set */
+static int allred_sched_build(int rank, int p, int count, MPI_Datatype datatype, void *sendbuf, void *recvbuf, MPI_Op op, int size, int ext, int alg, char copy, NBC_Schedule *schedule, NBC_Handle *handle) {
+  int res, maxr;
+
+  if(alg == NBC_ARED_BINOMIAL) {
+    /* reduce and bcast trees: two rounds of at most two operations per level */
+    maxr = (int)ceil((log((double)p)/LOG2));
+    res = NBC_Sched_create_size(schedule, NBC_SCHED_SIZE(2*maxr+1, 4*maxr+1));
+  } else {
+    /* reduce-scatter and allgather: two rounds of three operations per step */
+    res = NBC_Sched_create_size(schedule, NBC_SCHED_SIZE(2*p, 6*p));
+  }
+  if(res != NBC_OK) { printf("Error in NBC_Sched_create (%i)\n", res); return res; }
+
+  if(copy) {
+    res = NBC_Sched_copy(sendbuf, false, count, datatype, recvbuf, false, count, datatype, schedule);
+    if (NBC_OK != res) { printf("Error in NBC_Sched_copy() (%i)\n", res); return res; }
+  }
+
+  switch(alg) {
+    case NBC_ARED_BINOMIAL:
+      res = allred_sched_diss(rank, p, count, datatype, sendbuf, recvbuf, op, schedule, handle);
+      break;
+    case NBC_ARED_RING:
+      res = allred_sched_ring(rank, p, count, datatype, sendbuf, recvbuf, op, size, ext, schedule, handle);
+      break;
+  }
+  if (NBC_OK != res) { printf("Error in Schedule creation() (%i)\n", res); return res; }
+
+  res = NBC_Sched_commit(schedule);
+  if(res != NBC_OK) { printf("Error in NBC_Sched_commit() (%i)\n", res); return res; }
+
+  return NBC_OK;
+}
+
 #ifdef NBC_CACHE_SCHEDULE
 /* tree comparison function for schedule cache */
 int NBC_Allreduce_args_compare(NBC_Allreduce_args *a, NBC_Allreduce_args *b, void *param) {
@@ -36,13 +82,13 @@ int ompi_coll_libnbc_iallreduce(void* sendbuf, void* recvbuf, int count, MPI_Dat
                                 struct ompi_communicator_t *comm, ompi_request_t ** request,
                                 struct mca_coll_base_module_2_0_0_t *module)
 {
-  int rank, p, res, size;
+  int rank, p, res, size, alg;
   MPI_Aint ext;
   NBC_Schedule *schedule;
+  NBC_Sched_template *tmpl, key;
 #ifdef NBC_CACHE_SCHEDULE
   NBC_Allreduce_args *args, *found, search;
 #endif
-  enum { NBC_ARED_BINOMIAL, NBC_ARED_RING } alg;
   char inplace;
   NBC_Handle *handle;
   ompi_coll_libnbc_request_t **coll_req = (ompi_coll_libnbc_request_t**) request;
@@ -71,12 +117,7 @@ int ompi_coll_libnbc_iallreduce(void* sendbuf, void* recvbuf, int count, MPI_Dat
     if (NBC_OK != res) { printf("Error in NBC_Copy() (%i)\n", res); return res; }
   }
   
-  /* algorithm selection */
-  if(p < 4 || size*count < 65536 || inplace) {
-    alg = NBC_ARED_BINOMIAL;
-  } else {
-    alg = NBC_ARED_RING;
-  }
+  alg = allred_sched_alg(p, size, count, inplace);
       
 #ifdef NBC_CACHE_SCHEDULE
   /* search schedule in communicator specific tree */
@@ -91,22 +132,29 @@ int ompi_coll_libnbc_iallreduce(void* sendbuf, void* recvbuf, int count, MPI_Dat
     schedule = (NBC_Schedule*)malloc(sizeof(NBC_Schedule));
     if (NULL == schedule) { printf("Error in malloc()\n"); return res; }
 
-    res = NBC_Sched_create(schedule);
-    if(res != NBC_OK) { printf("Error in NBC_Sched_create (%i)\n", res); return res; }
+    /* same arguments as the last call on other buffers: re-bind its
+       schedule instead of building it again */
+    tmpl = libnbc_module->allreduce_template;
+    key.sendbuf = sendbuf;
+    key.recvbuf = recvbuf;
+    key.sendspan = key.recvspan = (MPI_Aint)count * ext;
+    key.count = count;
+    key.datatype = datatype;
+    key.recvcount = 0;
+    key.recvtype = NULL;
+    key.op = op;
+    key.alg = (int)alg;
+    if(NBC_Sched_template_match(tmpl, &key)) {
+      res = NBC_Sched_template_instantiate(tmpl, schedule, sendbuf, recvbuf);
+      if(res != NBC_OK) { free(handle->tmpbuf); printf("Error in NBC_Sched_template_instantiate() (%i)\n", res); return res; }
+    } else {
+      res = allred_sched_build(rank, p, count, datatype, sendbuf, recvbuf, op, size, ext, alg, 0, schedule, handle);
+      if(res != NBC_OK) { free(handle->tmpbuf); return res; }
 
-    switch(alg) {
-      case NBC_ARED_BINOMIAL:
-        res = allred_sched_diss(rank, p, count, datatype, sendbuf, recvbuf, op, schedule, handle);
-        break;
-      case NBC_ARED_RING:
-        res = allred_sched_ring(rank, p, count, datatype, sendbuf, recvbuf, op, size, ext, schedule, handle);
-        break;
+      /* failing to keep the template only costs the next call a rebuild */
+      (void)NBC_Sched_template_store(&libnbc_module->allreduce_template, schedule, &key);
     }
-    if (NBC_OK != res) { printf("Error in Schedule creation() (%i)\n", res); return res; }
-    
-    res = NBC_Sched_commit(schedule);
-    if(res != NBC_OK) { free(handle->tmpbuf); printf("Error in NBC_Sched_commit() (%i)\n", res); return res; }
-    
+
 #ifdef NBC_CACHE_SCHEDULE
     /* save schedule to tree */
     args = (NBC_Allreduce_args*)malloc(sizeof(NBC_Allreduce_args));
@@ -135,6 +183,51 @@ int ompi_coll_libnbc_iallreduce(void* sendbuf, void* recvbuf, int count, MPI_Dat
   return NBC_OK;
 }
 
+/* MPI_Allreduce_init: the algorithm is chosen and its schedule built
+ * once, every MPI_Start runs it again.  The schedule belongs to the
+ * request, it is neither taken from nor given to the template */
+int ompi_coll_libnbc_allreduce_init(void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op,
+                                    struct ompi_communicator_t *comm, ompi_request_t ** request,
+                                    struct mca_coll_base_module_2_0_0_t *module)
+{
+  int rank, p, res, size, alg;
+  MPI_Aint ext;
+  NBC_Schedule *schedule;
+  char inplace;
+  NBC_Handle *handle;
+  ompi_coll_libnbc_request_t **coll_req = (ompi_coll_libnbc_request_t**) request;
+  ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
+
+  NBC_IN_PLACE(sendbuf, recvbuf, inplace);
+
+  res = NBC_Init_handle(comm, coll_req, libnbc_module);
+  if(res != NBC_OK) { printf("Error in NBC_Init_handle(%i)\n", res); return res; }
+  handle = (*coll_req);
+  res = MPI_Comm_rank(comm, &rank);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Comm_rank() (%i)\n", res); return res; }
+  res = MPI_Comm_size(comm, &p);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Comm_size() (%i)\n", res); return res; }
+  res = MPI_Type_extent(datatype, &ext);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Type_extent() (%i)\n", res); return res; }
+  res = MPI_Type_size(datatype, &size);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Type_size() (%i)\n", res); return res; }
+
+  handle->tmpbuf = malloc(ext*count);
+  if(handle->tmpbuf == NULL) { printf("Error in malloc() (%i)\n", res); return NBC_OOR; }
+
+  schedule = (NBC_Schedule*)malloc(sizeof(NBC_Schedule));
+  if (NULL == schedule) { free(handle->tmpbuf); printf("Error in malloc()\n"); return NBC_OOR; }
+
+  /* on a single node the copy has to happen at every start */
+  alg = allred_sched_alg(p, size, count, inplace);
+  res = allred_sched_build(rank, p, count, datatype, sendbuf, recvbuf, op, size, ext, alg,
+                           (p == 1) && !inplace, schedule, handle);
+  if(res != NBC_OK) { NBC_Sched_free(schedule); free(schedule); free(handle->tmpbuf); return res; }
+
+  /* the request is inactive until MPI_Start */
+  return NBC_Init_persistent(handle, schedule);
+}
+
 
 /* binomial allreduce (binomial tree up and binomial bcast down)
  * working principle:
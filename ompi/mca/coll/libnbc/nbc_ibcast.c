@@ -14,6 +14,49 @@ static inline int bcast_sched_binomial(int rank, int p, int root, NBC_Schedule *
 static inline int bcast_sched_linear(int rank, int p, int root, NBC_Schedule *schedule, void *buffer, int count, MPI_Datatype datatype);
 static inline int bcast_sched_chain(int rank, int p, int root, NBC_Schedule *schedule, void *buffer, int count, MPI_Datatype datatype, int fragsize, int size);
 
+enum { NBC_BCAST_LINEAR, NBC_BCAST_BINOMIAL, NBC_BCAST_CHAIN };
+
+/* algorithm selection, segsize is the fragment size of the chain */
+static inline int bcast_sched_alg(int p, int size, int count, int *segsize) {
+  *segsize = 16384;
+  if(p <= 4) {
+    return NBC_BCAST_LINEAR;
+  } else if(size*count < 65536) {
+    return NBC_BCAST_BINOMIAL;
+  } else if(size*count < 524288) {
+    *segsize = 16384/2;
+    return NBC_BCAST_CHAIN;
+  }
+  *segsize = 65536/2;
+  return NBC_BCAST_CHAIN;
+}
+
+/* builds and commits the schedule of the algorithm */
+static int bcast_sched_build(int rank, int p, int root, NBC_Schedule *schedule, void *buffer, int count, MPI_Datatype datatype, int alg, int segsize, int size) {
+  int res;
+
+  res = NBC_Sched_create(schedule);
+  if(res != NBC_OK) { printf("Error in NBC_Sched_create, res = %i\n", res); return res; }
+
+  switch(alg) {
+    case NBC_BCAST_LINEAR:
+      res = bcast_sched_linear(rank, p, root, schedule, buffer, count, datatype);
+      break;
+    case NBC_BCAST_BINOMIAL:
+      res = bcast_sched_binomial(rank, p, root, schedule, buffer, count, datatype);
+      break;
+    case NBC_BCAST_CHAIN:
+      res = bcast_sched_chain(rank, p, root, schedule, buffer, count, datatype, segsize, size);
+      break;
+  }
+  if (NBC_OK != res) { printf("Error in Schedule creation() (%i)\n", res); return res; }
+
+  res = NBC_Sched_commit(schedule);
+  if (NBC_OK != res) { printf("Error in NBC_Sched_commit() (%i)\n", res); return res; }
+
+  return NBC_OK;
+}
+
 #ifdef NBC_CACHE_SCHEDULE
 /* tree comparison function for schedule cache */
 int NBC_Bcast_args_compare(NBC_Bcast_args *a, NBC_Bcast_args *b, void *param) {
@@ -35,12 +78,11 @@ int ompi_coll_libnbc_ibcast(void *buffer, int count, MPI_Datatype datatype, int
                             struct ompi_communicator_t *comm, ompi_request_t ** request,
                               struct mca_coll_base_module_2_0_0_t *module)
 {
-  int rank, p, res, size, segsize;
+  int rank, p, res, size, segsize, alg;
   NBC_Schedule *schedule;
 #ifdef NBC_CACHE_SCHEDULE
   NBC_Bcast_args *args, *found, search;
 #endif
-  enum { NBC_BCAST_LINEAR, NBC_BCAST_BINOMIAL, NBC_BCAST_CHAIN } alg;
   NBC_Handle *handle;
   ompi_coll_libnbc_request_t **coll_req = (ompi_coll_libnbc_request_t**) request;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
@@ -55,19 +97,7 @@ int ompi_coll_libnbc_ibcast(void *buffer, int count, MPI_Datatype datatype, int
   res = MPI_Type_size(datatype, &size);
   if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Type_size() (%i)\n", res); return res; }
   
-  segsize = 16384;
-  /* algorithm selection */
-  if(p <= 4) {
-    alg = NBC_BCAST_LINEAR;
-  } else if(size*count < 65536) {
-    alg = NBC_BCAST_BINOMIAL;
-  } else if(size*count < 524288) {
-    alg = NBC_BCAST_CHAIN;
-    segsize = 16384/2;
-  } else {
-    alg = NBC_BCAST_CHAIN;
-    segsize = 65536/2;
-  }
+  alg = bcast_sched_alg(p, size, count, &segsize);
 
   handle->tmpbuf=NULL;
 
@@ -81,25 +111,10 @@ int ompi_coll_libnbc_ibcast(void *buffer, int count, MPI_Datatype datatype, int
   if(found == NULL) {
 #endif
     schedule = (NBC_Schedule*)malloc(sizeof(NBC_Schedule));
-    
-    res = NBC_Sched_create(schedule);
-    if(res != NBC_OK) { printf("Error in NBC_Sched_create, res = %i\n", res); return res; }
-
-    switch(alg) {
-      case NBC_BCAST_LINEAR:
-        res = bcast_sched_linear(rank, p, root, schedule, buffer, count, datatype);
-        break;
-      case NBC_BCAST_BINOMIAL:
-        res = bcast_sched_binomial(rank, p, root, schedule, buffer, count, datatype);
-        break;
-      case NBC_BCAST_CHAIN:
-        res = bcast_sched_chain(rank, p, root, schedule, buffer, count, datatype, segsize, size);
-        break;
-    }
-    if (NBC_OK != res) { printf("Error in Schedule creation() (%i)\n", res); return res; }
-    
-    res = NBC_Sched_commit(schedule);
-    if (NBC_OK != res) { printf("Error in NBC_Sched_commit() (%i)\n", res); return res; }
+    if (NULL == schedule) { printf("Error in malloc()\n"); return NBC_OOR; }
+
+    res = bcast_sched_build(rank, p, root, schedule, buffer, count, datatype, alg, segsize, size);
+    if (NBC_OK != res) { return res; }
 #ifdef NBC_CACHE_SCHEDULE
     /* save schedule to tree */
     args = (NBC_Bcast_args*)malloc(sizeof(NBC_Bcast_args));
@@ -126,6 +141,40 @@ int ompi_coll_libnbc_ibcast(void *buffer, int count, MPI_Datatype datatype, int
   return NBC_OK;
 }
 
+/* MPI_Bcast_init: the schedule is built once and run again by every
+ * MPI_Start, it belongs to the request and stays out of the cache */
+int ompi_coll_libnbc_bcast_init(void *buffer, int count, MPI_Datatype datatype, int root,
+                                struct ompi_communicator_t *comm, ompi_request_t ** request,
+                                struct mca_coll_base_module_2_0_0_t *module)
+{
+  int rank, p, res, size, segsize, alg;
+  NBC_Schedule *schedule;
+  NBC_Handle *handle;
+  ompi_coll_libnbc_request_t **coll_req = (ompi_coll_libnbc_request_t**) request;
+  ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
+
+  res = NBC_Init_handle(comm, coll_req, libnbc_module);
+  if(res != NBC_OK) { printf("Error in NBC_Init_handle(%i)\n", res); return res; }
+  handle = (*coll_req);
+  res = MPI_Comm_rank(comm, &rank);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Comm_rank() (%i)\n", res); return res; }
+  res = MPI_Comm_size(comm, &p);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Comm_size() (%i)\n", res); return res; }
+  res = MPI_Type_size(datatype, &size);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Type_size() (%i)\n", res); return res; }
+
+  alg = bcast_sched_alg(p, size, count, &segsize);
+
+  schedule = (NBC_Schedule*)malloc(sizeof(NBC_Schedule));
+  if (NULL == schedule) { printf("Error in malloc()\n"); return NBC_OOR; }
+
+  res = bcast_sched_build(rank, p, root, schedule, buffer, count, datatype, alg, segsize, size);
+  if (NBC_OK != res) { NBC_Sched_free(schedule); free(schedule); return res; }
+
+  /* the request is inactive until MPI_Start */
+  return NBC_Init_persistent(handle, schedule);
+}
+
 /* better binomial bcast 
  * working principle:
  * - each node gets a virtual rank vrank
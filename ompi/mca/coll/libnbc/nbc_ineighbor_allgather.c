@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+#include "nbc_internal.h"
+
+/* MPI_Ineighbor_allgather
+ * a single round: the block of each source is received at its position in
+ * the neighbor list and sendbuf is sent to each destination. Blocks from
+ * the process itself (periodic dimensions of size one or two, self edges of
+ * a graph) are local copies. The schedule only depends on the counts and
+ * datatypes, a later call with the same arguments re-binds it to its
+ * buffers. */
+int ompi_coll_libnbc_ineighbor_allgather(void *sbuf, int scount, MPI_Datatype stype, void *rbuf,
+                                         int rcount, MPI_Datatype rtype, struct ompi_communicator_t *comm,
+                                         ompi_request_t ** request, struct mca_coll_base_module_2_0_0_t *module)
+{
+  int rank, res, i;
+  MPI_Aint sndext, rcvext;
+  NBC_Schedule *schedule;
+  NBC_Sched_template *tmpl, key;
+  char *buf;
+  NBC_Handle *handle;
+  ompi_coll_libnbc_request_t **coll_req = (ompi_coll_libnbc_request_t**) request;
+  ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
+
+  res = NBC_Comm_neighbors(comm, libnbc_module);
+  if(res != NBC_OK) { printf("Error in NBC_Comm_neighbors(%i)\n", res); return res; }
+
+  res = NBC_Init_handle(comm, coll_req, libnbc_module);
+  if(res != NBC_OK) { printf("Error in NBC_Init_handle(%i)\n", res); return res; }
+  handle = (*coll_req);
+  res = MPI_Comm_rank(comm, &rank);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Comm_rank() (%i)\n", res); return res; }
+  res = MPI_Type_extent(stype, &sndext);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Type_extent() (%i)\n", res); return res; }
+  res = MPI_Type_extent(rtype, &rcvext);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Type_extent() (%i)\n", res); return res; }
+
+  handle->tmpbuf = NULL;
+
+  schedule = (NBC_Schedule*)malloc(sizeof(NBC_Schedule));
+  if (NULL == schedule) { printf("Error in malloc()\n"); return NBC_OOR; }
+
+  tmpl = libnbc_module->neighbor_allgather_template;
+  key.sendbuf = sbuf;
+  key.recvbuf = rbuf;
+  key.sendspan = (MPI_Aint)scount * sndext;
+  key.recvspan = (MPI_Aint)libnbc_module->indegree * rcount * rcvext;
+  key.count = scount;
+  key.datatype = stype;
+  key.recvcount = rcount;
+  key.recvtype = rtype;
+  key.op = NULL;
+  key.alg = 0;
+  if(NBC_Sched_template_match(tmpl, &key)) {
+    res = NBC_Sched_template_instantiate(tmpl, schedule, sbuf, rbuf);
+    if(res != NBC_OK) { printf("Error in NBC_Sched_template_instantiate() (%i)\n", res); return res; }
+  } else {
+    res = NBC_Sched_create_size(schedule, NBC_SCHED_SIZE(1, libnbc_module->indegree + libnbc_module->outdegree));
+    if(NBC_OK != res) { printf("Error in NBC_Sched_create, (%i)\n", res); return res; }
+
+    for(i = 0; i < libnbc_module->indegree; i++) {
+      if(MPI_PROC_NULL == libnbc_module->sources[i]) continue;
+      buf = (char*)rbuf + (MPI_Aint)i * rcount * rcvext;
+      if(rank == libnbc_module->sources[i]) {
+        res = NBC_Sched_copy(sbuf, false, scount, stype, buf, false, rcount, rtype, schedule);
+        if (NBC_OK != res) { printf("Error in NBC_Sched_copy() (%i)\n", res); return res; }
+      } else {
+        res = NBC_Sched_recv(buf, false, rcount, rtype, libnbc_module->sources[i], schedule);
+        if (NBC_OK != res) { printf("Error in NBC_Sched_recv() (%i)\n", res); return res; }
+      }
+    }
+    for(i = 0; i < libnbc_module->outdegree; i++) {
+      /* the blocks for the process itself were copied above */
+      if((MPI_PROC_NULL == libnbc_module->destinations[i]) || (rank == libnbc_module->destinations[i])) continue;
+      res = NBC_Sched_send(sbuf, false, scount, stype, libnbc_module->destinations[i], schedule);
+      if (NBC_OK != res) { printf("Error in NBC_Sched_send() (%i)\n", res); return res; }
+    }
+
+    res = NBC_Sched_commit(schedule);
+    if (NBC_OK != res) { printf("Error in NBC_Sched_commit() (%i)\n", res); return res; }
+
+    /* failing to keep the template only costs the next call a rebuild */
+    (void)NBC_Sched_template_store(&libnbc_module->neighbor_allgather_template, schedule, &key);
+  }
+
+  res = NBC_Start(handle, schedule);
+  if (NBC_OK != res) { printf("Error in NBC_Start() (%i)\n", res); return res; }
+
+  return NBC_OK;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+#include "nbc_internal.h"
+
+/* MPI_Ineighbor_alltoall
+ * a single round: block i of recvbuf is received from source i and block j
+ * of sendbuf is sent to destination j. The messages of the process to
+ * itself are local copies, the n-th block sent to itself going to the n-th
+ * block received from itself, as the matching order of point-to-point
+ * messages would. The schedule only depends on the counts and datatypes, a
+ * later call with the same arguments re-binds it to its buffers. */
+int ompi_coll_libnbc_ineighbor_alltoall(void *sbuf, int scount, MPI_Datatype stype, void *rbuf,
+                                        int rcount, MPI_Datatype rtype, struct ompi_communicator_t *comm,
+                                        ompi_request_t ** request, struct mca_coll_base_module_2_0_0_t *module)
+{
+  int rank, res, i, j;
+  MPI_Aint sndext, rcvext;
+  NBC_Schedule *schedule;
+  NBC_Sched_template *tmpl, key;
+  char *buf;
+  NBC_Handle *handle;
+  ompi_coll_libnbc_request_t **coll_req = (ompi_coll_libnbc_request_t**) request;
+  ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
+
+  res = NBC_Comm_neighbors(comm, libnbc_module);
+  if(res != NBC_OK) { printf("Error in NBC_Comm_neighbors(%i)\n", res); return res; }
+
+  res = NBC_Init_handle(comm, coll_req, libnbc_module);
+  if(res != NBC_OK) { printf("Error in NBC_Init_handle(%i)\n", res); return res; }
+  handle = (*coll_req);
+  res = MPI_Comm_rank(comm, &rank);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Comm_rank() (%i)\n", res); return res; }
+  res = MPI_Type_extent(stype, &sndext);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Type_extent() (%i)\n", res); return res; }
+  res = MPI_Type_extent(rtype, &rcvext);
+  if (MPI_SUCCESS != res) { printf("MPI Error in MPI_Type_extent() (%i)\n", res); return res; }
+
+  handle->tmpbuf = NULL;
+
+  schedule = (NBC_Schedule*)malloc(sizeof(NBC_Schedule));
+  if (NULL == schedule) { printf("Error in malloc()\n"); return NBC_OOR; }
+
+  tmpl = libnbc_module->neighbor_alltoall_template;
+  key.sendbuf = sbuf;
+  key.recvbuf = rbuf;
+  key.sendspan = (MPI_Aint)libnbc_module->outdegree * scount * sndext;
+  key.recvspan = (MPI_Aint)libnbc_module->indegree * rcount * rcvext;
+  key.count = scount;
+  key.datatype = stype;
+  key.recvcount = rcount;
+  key.recvtype = rtype;
+  key.op = NULL;
+  key.alg = 0;
+  if(NBC_Sched_template_match(tmpl, &key)) {
+    res = NBC_Sched_template_instantiate(tmpl, schedule, sbuf, rbuf);
+    if(res != NBC_OK) { printf("Error in NBC_Sched_template_instantiate() (%i)\n", res); return res; }
+  } else {
+    res = NBC_Sched_create_size(schedule, NBC_SCHED_SIZE(1, libnbc_module->indegree + libnbc_module->outdegree));
+    if(NBC_OK != res) { printf("Error in NBC_Sched_create, (%i)\n", res); return res; }
+
+    /* j walks the destinations for the blocks sent to the process itself */
+    j = 0;
+    for(i = 0; i < libnbc_module->indegree; i++) {
+      if(MPI_PROC_NULL == libnbc_module->sources[i]) continue;
+      buf = (char*)rbuf + (MPI_Aint)i * rcount * rcvext;
+      if(rank == libnbc_module->sources[i]) {
+        while((j < libnbc_module->outdegree) && (rank != libnbc_module->destinations[j])) j++;
+        if(j == libnbc_module->outdegree) { printf("Error: no block for the process itself\n"); return NBC_INVALID_TOPOLOGY_COMM; }
+        res = NBC_Sched_copy((char*)sbuf + (MPI_Aint)j * scount * sndext, false, scount, stype,
+                             buf, false, rcount, rtype, schedule);
+        if (NBC_OK != res) { printf("Error in NBC_Sched_copy() (%i)\n", res); return res; }
+        j++;
+      } else {
+        res = NBC_Sched_recv(buf, false, rcount, rtype, libnbc_module->sources[i], schedule);
+        if (NBC_OK != res) { printf("Error in NBC_Sched_recv() (%i)\n", res); return res; }
+      }
+    }
+    for(i = 0; i < libnbc_module->outdegree; i++) {
+      /* the blocks for the process itself were copied above */
+      if((MPI_PROC_NULL == libnbc_module->destinations[i]) || (rank == libnbc_module->destinations[i])) continue;
+      buf = (char*)sbuf + (MPI_Aint)i * scount * sndext;
+      res = NBC_Sched_send(buf, false, scount, stype, libnbc_module->destinations[i], schedule);
+      if (NBC_OK != res) { printf("Error in NBC_Sched_send() (%i)\n", res); return res; }
+    }
+
+    res = NBC_Sched_commit(schedule);
+    if (NBC_OK != res) { printf("Error in NBC_Sched_commit() (%i)\n", res); return res; }
+
+    /* failing to keep the template only costs the next call a rebuild */
+    (void)NBC_Sched_template_store(&libnbc_module->neighbor_alltoall_template, schedule, &key);
+  }
+
+  res = NBC_Start(handle, schedule);
+  if (NBC_OK != res) { printf("Error in NBC_Start() (%i)\n", res); return res; }
+
+  return NBC_OK;
+}
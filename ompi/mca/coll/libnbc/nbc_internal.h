@@ -125,8 +125,50 @@ typedef struct {
   char tmpoutbuf;
 } NBC_Args_unpack;
 
+/* The array of a schedule is preceded by a header, which is not part of
+ * the schedule format: it holds the allocated size of the array, so that
+ * it grows geometrically instead of being reallocated for every operation,
+ * and the offset of the last round, so that adding an operation does not
+ * walk the whole schedule. */
+typedef struct {
+  int capacity;   /* bytes allocated for the schedule */
+  int last_round; /* offset of the [num] field of the last round */
+} NBC_Sched_header;
+
+#define NBC_SCHED_HEADER(schedule) ((NBC_Sched_header*)((char*)(schedule)-sizeof(NBC_Sched_header)))
+
+/* initial size of the schedules created without a size estimate */
+#define NBC_SCHED_MIN_SIZE 256
+
+/* upper estimate of the size of a schedule with the given number of rounds
+ * and operations, for NBC_Sched_create_size() */
+#define NBC_SCHED_SIZE(rounds, ops) \
+  ((int)(sizeof(int) + (rounds)*(sizeof(char)+sizeof(int)) + \
+         (ops)*(sizeof(NBC_Fn_type)+sizeof(NBC_Args_op)) + sizeof(char)))
+
+/* A committed schedule with the arguments it was built for. A later call
+ * with the same arguments on other buffers gets a copy of the schedule
+ * re-bound to its buffers, instead of building the schedule again. The
+ * same structure, without schedule, describes the arguments of a call. */
+struct NBC_Sched_template {
+  NBC_Schedule schedule; /* NULL if the template is empty */
+  void *sendbuf;
+  void *recvbuf;
+  MPI_Aint sendspan;     /* bytes of sendbuf used by the schedule */
+  MPI_Aint recvspan;     /* bytes of recvbuf used by the schedule */
+  int count;
+  MPI_Datatype datatype;
+  int recvcount;
+  MPI_Datatype recvtype; /* NULL if the collective has a single datatype */
+  MPI_Op op;             /* NULL if the collective has no op */
+  int alg;
+};
+typedef struct NBC_Sched_template NBC_Sched_template;
+
 /* internal function prototypes */
 int NBC_Sched_create(NBC_Schedule* schedule);
+int NBC_Sched_create_size(NBC_Schedule* schedule, int size);
+void NBC_Sched_free(NBC_Schedule* schedule);
 int NBC_Sched_send(void* buf, char tmpbuf, int count, MPI_Datatype datatype, int dest, NBC_Schedule *schedule);
 int NBC_Sched_recv(void* buf, char tmpbuf, int count, MPI_Datatype datatype, int source, NBC_Schedule *schedule);
 int NBC_Sched_op(void* buf3, char tmpbuf3, void* buf1, char tmpbuf1, void* buf2, char tmpbuf2, int count, MPI_Datatype datatype, MPI_Op op, NBC_Schedule *schedule);
@@ -134,6 +176,9 @@ int NBC_Sched_copy(void *src, char tmpsrc, int srccount, MPI_Datatype srctype, v
 int NBC_Sched_unpack(void *inbuf, char tmpinbuf, int count, MPI_Datatype datatype, void *outbuf, char tmpoutbuf, NBC_Schedule *schedule);
 int NBC_Sched_barrier(NBC_Schedule *schedule);
 int NBC_Sched_commit(NBC_Schedule *schedule);
+int NBC_Sched_template_match(NBC_Sched_template *tmpl, NBC_Sched_template *args);
+int NBC_Sched_template_store(NBC_Sched_template **tmpl, NBC_Schedule *schedule, NBC_Sched_template *args);
+int NBC_Sched_template_instantiate(NBC_Sched_template *tmpl, NBC_Schedule *schedule, void *sendbuf, void *recvbuf);
 
 #ifdef NBC_CACHE_SCHEDULE
 /* this is a dummy structure which is used to get the schedule out of
@@ -238,7 +283,9 @@ void NBC_SchedCache_args_delete_key_dummy(void *k);
 
 
 int NBC_Start(NBC_Handle *handle, NBC_Schedule *schedule);
+int NBC_Init_persistent(NBC_Handle *handle, NBC_Schedule *schedule);
 int NBC_Init_handle(struct ompi_communicator_t *comm, ompi_coll_libnbc_request_t **request, ompi_coll_libnbc_module_t *module);
+int NBC_Comm_neighbors(MPI_Comm comm, NBC_Comminfo *comminfo);
 static inline int NBC_Type_intrinsic(MPI_Datatype type);
 static inline int NBC_Copy(void *src, int srccount, MPI_Datatype srctype, void *tgt, int tgtcount, MPI_Datatype tgttype, MPI_Comm comm);
 int NBC_Create_fortran_handle(int *fhandle, NBC_Handle **handle);
@@ -324,24 +371,10 @@ int NBC_Create_fortran_handle(int *fhandle, NBC_Handle **handle);
 /* increments the number of operations in the last round */
 #define NBC_INC_NUM_ROUND(schedule) \
 { \
-  int total_size, num_last_round; \
-  long round_size; \
-  char *ptr, *lastround; \
+  int num_last_round; \
+  char *lastround; \
  \
-  NBC_GET_SIZE(schedule, total_size); \
- \
-  /* ptr begins at first round (first int is overall size) */ \
-  ptr = (char*)schedule+sizeof(int); \
-  lastround = ptr; \
-  while ((long)ptr-(long)schedule < total_size) { \
-    NBC_GET_ROUND_SIZE(ptr, round_size); \
-    /*printf("got round_size %i\n", round_size);*/ \
-    lastround = ptr; \
-    ptr += round_size; \
-    ptr += sizeof(char); /* barrier delimiter */ \
-    /*printf("(long)ptr-(long)schedule=%li, total_size=%i\n", (long)ptr-(long)schedule, total_size); */\
-  } \
-  /*printf("lastround count is at offset: %li\n", (long)lastround-(long)schedule);*/ \
+  lastround = (char*)schedule + NBC_SCHED_HEADER(schedule)->last_round; \
   /* increment the count in the last round of the schedule */ \
   memcpy(&num_last_round, lastround, sizeof(int)); \
   num_last_round++; \
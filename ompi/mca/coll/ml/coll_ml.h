@@ -576,6 +576,11 @@ struct mca_coll_ml_component_t {
     opal_list_t sequential_collectives;
     opal_mutex_t sequential_collectives_mutex;
 
+    /* non-blocking collectives scheduled through the PML, see
+     * coll_ml_allreduce.c */
+    opal_list_t hier_collectives;
+    opal_mutex_t hier_collectives_mutex;
+
     bool progress_is_busy;
 
     /* Temporary hack for IMB test - not all bcols have allgather */
@@ -784,6 +789,17 @@ struct mca_coll_ml_module_t {
     /* On this list we keep coll_op descriptors that were not
      * be able to start, since no ml buffers were available */
     opal_list_t waiting_for_memory_list;
+
+    /* The collectives of the module underneath, for the operations the
+     * hierarchical schedules cannot handle (non-commutative reductions) */
+    mca_coll_base_module_allgather_fn_t previous_allgather;
+    mca_coll_base_module_t *previous_allgather_module;
+    mca_coll_base_module_allreduce_fn_t previous_allreduce;
+    mca_coll_base_module_t *previous_allreduce_module;
+    mca_coll_base_module_iallreduce_fn_t previous_iallreduce;
+    mca_coll_base_module_t *previous_iallreduce_module;
+    mca_coll_base_module_reduce_fn_t previous_reduce;
+    mca_coll_base_module_t *previous_reduce_module;
 };
 
 typedef struct mca_coll_ml_module_t mca_coll_ml_module_t;
@@ -822,6 +838,15 @@ int mca_coll_ml_allreduce_intra(void *sbuf, void *rbuf, int count,
                                 struct ompi_communicator_t *comm,
                                 mca_coll_base_module_t *module);
 
+int mca_coll_ml_iallreduce_intra(void *sbuf, void *rbuf, int count,
+                                 struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                 struct ompi_communicator_t *comm,
+                                 ompi_request_t **req,
+                                 mca_coll_base_module_t *module);
+
+/* step the pending non-blocking allreduces, called by coll_ml_progress() */
+int mca_coll_ml_iallreduce_progress(void);
+
 int mca_coll_ml_memsync_intra(mca_coll_ml_module_t *module, int bank_index);
 
 /* Reduce blocking */
@@ -833,6 +858,31 @@ int mca_coll_ml_reduce(void *sbuf, void *rbuf, int count,
 
 int coll_ml_progress_individual_message(mca_coll_ml_fragment_t *frag_descriptor);
 
+/*
+ * Building blocks of the reduce, allreduce and allgather schedules,
+ * which move the data along the ML hierarchy through the PML
+ * (coll_ml_reduce.c)
+ */
+mca_coll_ml_topology_t *mca_coll_ml_hier_topo(mca_coll_ml_module_t *ml_module,
+        int coll, int alg);
+int mca_coll_ml_hier_max_members(mca_coll_ml_topology_t *topo);
+int mca_coll_ml_hier_top_leader(mca_coll_ml_topology_t *topo);
+int mca_coll_ml_hier_frag_count(mca_coll_ml_module_t *ml_module,
+        struct ompi_datatype_t *dtype, int count);
+int mca_coll_ml_hier_scratch_alloc(struct ompi_datatype_t *dtype, int frag_count,
+        int n_slots, char **scratch, char **scratch_base, ptrdiff_t *slot);
+/* reduce one fragment up to the leader of the top level, *top tells
+ * if I am that leader */
+int mca_coll_ml_hier_reduce_frag(mca_coll_ml_topology_t *topo,
+        void *sbuf, void *accum, int count,
+        struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+        char *scratch, ptrdiff_t slot, ompi_request_t **reqs,
+        int tag, struct ompi_communicator_t *comm, bool *top);
+/* send one fragment from the leader of the top level down to everybody */
+int mca_coll_ml_hier_bcast_frag(mca_coll_ml_topology_t *topo, void *buf, int count,
+        struct ompi_datatype_t *dtype, ompi_request_t **reqs,
+        int tag, struct ompi_communicator_t *comm);
+
 /*
  * the ml entry point for the broadcast function
  */
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/** @file
+ *
+ * Hierarchical allgather.  The blocks are gathered up the ML hierarchy
+ * straight into their place in the receive buffer: a member first
+ * sends the list of ranks it collected, then their blocks described by
+ * an indexed datatype over the receive buffer, so no packing is
+ * needed.  The leader of the top level ends with the whole buffer and
+ * sends it back down, fragment by fragment.
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/request/request.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+
+#include "coll_ml.h"
+#include "coll_ml_inlines.h"
+
+/* send or receive the blocks of the ranks in the list */
+static int ml_allgather_blocks(void *rbuf, int rcount, struct ompi_datatype_t *rdtype,
+                               int *ranks, int n_ranks, int peer, bool send,
+                               struct ompi_communicator_t *comm)
+{
+    ompi_datatype_t *blocks;
+    int i, rc;
+
+    for (i = 0 ; i < n_ranks ; ++i) {
+        ranks[i] *= rcount;
+    }
+    rc = ompi_datatype_create_indexed_block(n_ranks, rcount, ranks, rdtype, &blocks);
+    for (i = 0 ; i < n_ranks ; ++i) {
+        ranks[i] /= rcount;
+    }
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+    rc = ompi_datatype_commit(&blocks);
+    if (OMPI_SUCCESS == rc) {
+        if (send) {
+            rc = MCA_PML_CALL(send(rbuf, 1, blocks, peer, MCA_COLL_BASE_TAG_ALLGATHER,
+                                   MCA_PML_BASE_SEND_STANDARD, comm));
+        } else {
+            rc = MCA_PML_CALL(recv(rbuf, 1, blocks, peer, MCA_COLL_BASE_TAG_ALLGATHER,
+                                   comm, MPI_STATUS_IGNORE));
+        }
+    }
+    ompi_datatype_destroy(&blocks);
+    return rc;
+}
+
+/* allgather */
+int mca_coll_ml_allgather(void *sbuf, int scount,
+        struct ompi_datatype_t *sdtype,
+        void* rbuf, int rcount,
+        struct ompi_datatype_t *rdtype,
+        struct ompi_communicator_t *comm,
+        mca_coll_base_module_t *module)
+{
+    mca_coll_ml_module_t *ml_module = (mca_coll_ml_module_t *) module;
+    mca_coll_ml_topology_t *topo;
+    ompi_request_t **reqs = NULL;
+    int rank = ompi_comm_rank(comm), size = ompi_comm_size(comm);
+    int *ranks = NULL, n_ranks = 1, level, i, total, frag_count, offset, n_members, rc;
+    ptrdiff_t lb, extent;
+
+    total = size * rcount;
+    frag_count = mca_coll_ml_hier_frag_count(ml_module, rdtype, total);
+    topo = mca_coll_ml_hier_topo(ml_module, ML_ALLGATHER,
+                                 total > frag_count ? ML_LARGE_DATA_ALLGATHER :
+                                 ML_SMALL_DATA_ALLGATHER);
+    if (NULL == topo) {
+        if (NULL == ml_module->previous_allgather) {
+            return OMPI_ERR_NOT_SUPPORTED;
+        }
+        return ml_module->previous_allgather(sbuf, scount, sdtype, rbuf, rcount, rdtype, comm,
+                                             ml_module->previous_allgather_module);
+    }
+    if (0 == rcount) {
+        return OMPI_SUCCESS;
+    }
+
+    ML_VERBOSE(10, ("Allgather of %d elements per rank", rcount));
+
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+    if (MPI_IN_PLACE != sbuf) {
+        rc = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                  (char *) rbuf + (ptrdiff_t) rank * rcount * extent,
+                                  rcount, rdtype);
+        if (OMPI_SUCCESS != rc) {
+            return rc;
+        }
+    }
+
+    /* one more slot for the length of the list on the wire */
+    ranks = (int *) malloc((size + 1) * sizeof(int));
+    n_members = mca_coll_ml_hier_max_members(topo);
+    if (0 < n_members) {
+        reqs = (ompi_request_t **) malloc(n_members * sizeof(ompi_request_t *));
+    }
+    if (NULL == ranks || (0 < n_members && NULL == reqs)) {
+        rc = OMPI_ERR_OUT_OF_RESOURCE;
+        goto exit;
+    }
+    ranks[1] = rank;
+
+    for (level = 0 ; level < topo->n_levels ; ++level) {
+        mca_sbgp_base_module_t *sbgp = topo->component_pairs[level].subgroup_module;
+
+        if (0 != sbgp->my_index) {
+            ranks[0] = n_ranks;
+            rc = MCA_PML_CALL(send(ranks, n_ranks + 1, MPI_INT, sbgp->group_list[0],
+                                   MCA_COLL_BASE_TAG_ALLGATHER,
+                                   MCA_PML_BASE_SEND_STANDARD, comm));
+            if (OMPI_SUCCESS == rc) {
+                rc = ml_allgather_blocks(rbuf, rcount, rdtype, ranks + 1, n_ranks,
+                                         sbgp->group_list[0], true, comm);
+            }
+            if (OMPI_SUCCESS != rc) {
+                goto exit;
+            }
+            break;
+        }
+
+        for (i = 1 ; i < sbgp->group_size ; ++i) {
+            int *list = ranks + n_ranks, saved = *list, n_new;
+
+            /* the length lands on my last rank, put it back afterwards */
+            rc = MCA_PML_CALL(recv(list, size + 1 - n_ranks, MPI_INT, sbgp->group_list[i],
+                                   MCA_COLL_BASE_TAG_ALLGATHER, comm, MPI_STATUS_IGNORE));
+            if (OMPI_SUCCESS != rc) {
+                goto exit;
+            }
+            n_new = *list;
+            *list = saved;
+            if (n_new <= 0 || n_new > size - n_ranks) {
+                rc = OMPI_ERR_BAD_PARAM;
+                goto exit;
+            }
+            rc = ml_allgather_blocks(rbuf, rcount, rdtype, list + 1, n_new,
+                                     sbgp->group_list[i], false, comm);
+            if (OMPI_SUCCESS != rc) {
+                goto exit;
+            }
+            n_ranks += n_new;
+        }
+    }
+
+    for (offset = 0 ; offset < total ; offset += frag_count) {
+        int fcount = (total - offset < frag_count) ? total - offset : frag_count;
+
+        rc = mca_coll_ml_hier_bcast_frag(topo, (char *) rbuf + (ptrdiff_t) offset * extent,
+                                         fcount, rdtype, reqs, MCA_COLL_BASE_TAG_ALLGATHER,
+                                         comm);
+        if (OMPI_SUCCESS != rc) {
+            goto exit;
+        }
+    }
+    rc = OMPI_SUCCESS;
+
+exit:
+    if (OMPI_SUCCESS != rc) {
+        ML_ERROR(("Hierarchical allgather failed: %d", rc));
+    }
+    free(reqs);
+    free(ranks);
+    return rc;
+}
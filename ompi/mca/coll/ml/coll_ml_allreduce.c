@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/** @file
+ *
+ * Hierarchical allreduce: every fragment is reduced up the ML
+ * hierarchy, as in coll_ml_reduce.c, and the leader of the top level
+ * sends the result back down the same subgroups.
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "ompi/constants.h"
+#include "ompi/op/op.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/request/request.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+
+#include "coll_ml.h"
+#include "coll_ml_inlines.h"
+
+/* Allreduce - blocking */
+int mca_coll_ml_allreduce_intra(void *sbuf, void *rbuf, int count,
+                                struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                struct ompi_communicator_t *comm,
+                                mca_coll_base_module_t *module)
+{
+    mca_coll_ml_module_t *ml_module = (mca_coll_ml_module_t *) module;
+    mca_coll_ml_topology_t *topo;
+    char *scratch = NULL, *scratch_base = NULL;
+    ompi_request_t **reqs = NULL;
+    int frag_count, offset, n_members, rc;
+    ptrdiff_t lb, extent, slot;
+    bool top;
+
+    frag_count = mca_coll_ml_hier_frag_count(ml_module, dtype, count);
+    topo = mca_coll_ml_hier_topo(ml_module, ML_ALLREDUCE,
+                                 count > frag_count ? ML_LARGE_DATA_ALLREDUCE :
+                                 ML_SMALL_DATA_ALLREDUCE);
+    if (NULL == topo || !ompi_op_is_commute(op)) {
+        /* the hierarchy does not follow the ranks, the operation is
+           left to the module underneath */
+        if (NULL == ml_module->previous_allreduce) {
+            return OMPI_ERR_NOT_SUPPORTED;
+        }
+        return ml_module->previous_allreduce(sbuf, rbuf, count, dtype, op, comm,
+                                             ml_module->previous_allreduce_module);
+    }
+    if (0 == count) {
+        return OMPI_SUCCESS;
+    }
+
+    ML_VERBOSE(10, ("Allreduce of %d elements, fragments of %d", count, frag_count));
+
+    /* the reduction happens in place in the receive buffer */
+    if (MPI_IN_PLACE != sbuf) {
+        rc = ompi_datatype_copy_content_same_ddt(dtype, count, (char *) rbuf, (char *) sbuf);
+        if (OMPI_SUCCESS != rc) {
+            return rc;
+        }
+    }
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    n_members = mca_coll_ml_hier_max_members(topo);
+    rc = mca_coll_ml_hier_scratch_alloc(dtype, frag_count, n_members, &scratch,
+                                        &scratch_base, &slot);
+    if (OMPI_SUCCESS != rc) {
+        goto exit;
+    }
+    if (0 < n_members) {
+        reqs = (ompi_request_t **) malloc(n_members * sizeof(ompi_request_t *));
+        if (NULL == reqs) {
+            rc = OMPI_ERR_OUT_OF_RESOURCE;
+            goto exit;
+        }
+    }
+
+    for (offset = 0 ; offset < count ; offset += frag_count) {
+        int fcount = (count - offset < frag_count) ? count - offset : frag_count;
+        char *frag = (char *) rbuf + (ptrdiff_t) offset * extent;
+
+        rc = mca_coll_ml_hier_reduce_frag(topo, frag, frag, fcount, dtype, op, scratch, slot,
+                                          reqs, MCA_COLL_BASE_TAG_ALLREDUCE, comm, &top);
+        if (OMPI_SUCCESS != rc) {
+            goto exit;
+        }
+        rc = mca_coll_ml_hier_bcast_frag(topo, frag, fcount, dtype, reqs,
+                                         MCA_COLL_BASE_TAG_ALLREDUCE, comm);
+        if (OMPI_SUCCESS != rc) {
+            goto exit;
+        }
+    }
+
+exit:
+    if (OMPI_SUCCESS != rc) {
+        ML_ERROR(("Hierarchical allreduce failed: %d", rc));
+    }
+    free(reqs);
+    free(scratch_base);
+    return rc;
+}
+
+/*
+ * Allreduce - non-blocking
+ *
+ * Short vectors only, a single fragment goes through the same
+ * subgroups as the blocking allreduce, one level per step.  The steps
+ * are driven from coll_ml_progress().
+ */
+
+enum {
+    ML_IALLREDUCE_UP,           /* start the current level on the way up */
+    ML_IALLREDUCE_UP_RECV,      /* leader, waiting for the members */
+    ML_IALLREDUCE_UP_SENT,      /* member, my part is with the leader */
+    ML_IALLREDUCE_DOWN_RECV,    /* member, waiting for the result */
+    ML_IALLREDUCE_DOWN,         /* start the current level on the way down */
+    ML_IALLREDUCE_DOWN_SENT     /* leader, result sent to the members */
+};
+
+struct mca_coll_ml_iallreduce_request_t {
+    ompi_request_t super;
+
+    mca_coll_ml_topology_t *topo;
+    struct ompi_communicator_t *comm;
+    struct ompi_datatype_t *dtype;
+    struct ompi_op_t *op;
+    void *rbuf;
+    int count;
+
+    char *scratch;
+    char *scratch_base;
+    ptrdiff_t slot;
+    ompi_request_t **reqs;
+    int n_reqs;
+
+    int level;
+    int state;
+};
+typedef struct mca_coll_ml_iallreduce_request_t mca_coll_ml_iallreduce_request_t;
+
+static void ml_iallreduce_request_construct(mca_coll_ml_iallreduce_request_t *req)
+{
+    req->scratch = NULL;
+    req->scratch_base = NULL;
+    req->reqs = NULL;
+    req->n_reqs = 0;
+}
+
+static void ml_iallreduce_request_destruct(mca_coll_ml_iallreduce_request_t *req)
+{
+    free(req->reqs);
+    free(req->scratch_base);
+}
+
+static OBJ_CLASS_INSTANCE(mca_coll_ml_iallreduce_request_t, ompi_request_t,
+                          ml_iallreduce_request_construct,
+                          ml_iallreduce_request_destruct);
+
+/* the request of a non-blocking collective cannot be freed before it
+   completes */
+static int ml_iallreduce_request_free(ompi_request_t **request)
+{
+    OMPI_REQUEST_FINI(*request);
+    OBJ_RELEASE(*request);
+    *request = MPI_REQUEST_NULL;
+    return OMPI_SUCCESS;
+}
+
+static int ml_iallreduce_request_cancel(ompi_request_t *request, int complete)
+{
+    return MPI_ERR_REQUEST;
+}
+
+static void ml_iallreduce_complete(mca_coll_ml_iallreduce_request_t *req, int rc)
+{
+    if (OMPI_SUCCESS != rc) {
+        ML_ERROR(("Hierarchical iallreduce failed: %d", rc));
+    }
+    req->super.req_status.MPI_ERROR = rc;
+    OPAL_THREAD_LOCK(&ompi_request_lock);
+    ompi_request_complete(&req->super, true);
+    OPAL_THREAD_UNLOCK(&ompi_request_lock);
+}
+
+/* Run the schedule as far as the outstanding PML requests let it go.
+ * Returns 1 once the collective is complete (or failed), 0 otherwise.
+ * Completion of the PML requests is tested by hand, ompi_request_test
+ * would call into opal_progress from coll_ml_progress */
+static int ml_iallreduce_step(mca_coll_ml_iallreduce_request_t *req)
+{
+    mca_coll_ml_topology_t *topo = req->topo;
+    mca_sbgp_base_module_t *sbgp;
+    int i, rc;
+
+    for (;;) {
+        for (i = 0 ; i < req->n_reqs ; ++i) {
+            if (!req->reqs[i]->req_complete) {
+                return 0;
+            }
+        }
+        for (i = 0 ; i < req->n_reqs ; ++i) {
+            rc = req->reqs[i]->req_status.MPI_ERROR;
+            ompi_request_free(&req->reqs[i]);
+            if (OMPI_SUCCESS != rc) {
+                req->n_reqs = 0;
+                ml_iallreduce_complete(req, rc);
+                return 1;
+            }
+        }
+        req->n_reqs = 0;
+
+        switch (req->state) {
+        case ML_IALLREDUCE_UP:
+            if (req->level == topo->n_levels) {
+                /* I am the leader of the top level, turn around */
+                req->level = topo->n_levels - 1;
+                req->state = ML_IALLREDUCE_DOWN;
+                break;
+            }
+            sbgp = topo->component_pairs[req->level].subgroup_module;
+            if (0 != sbgp->my_index) {
+                rc = MCA_PML_CALL(isend(req->rbuf, req->count, req->dtype,
+                                        sbgp->group_list[0], MCA_COLL_BASE_TAG_ALLREDUCE,
+                                        MCA_PML_BASE_SEND_STANDARD, req->comm,
+                                        &req->reqs[0]));
+                if (OMPI_SUCCESS != rc) {
+                    ml_iallreduce_complete(req, rc);
+                    return 1;
+                }
+                req->n_reqs = 1;
+                req->state = ML_IALLREDUCE_UP_SENT;
+                break;
+            }
+            for (i = 0 ; i < sbgp->group_size - 1 ; ++i) {
+                rc = MCA_PML_CALL(irecv(req->scratch + i * req->slot, req->count, req->dtype,
+                                        sbgp->group_list[i + 1], MCA_COLL_BASE_TAG_ALLREDUCE,
+                                        req->comm, &req->reqs[i]));
+                if (OMPI_SUCCESS != rc) {
+                    req->n_reqs = i;
+                    ml_iallreduce_complete(req, rc);
+                    return 1;
+                }
+            }
+            req->n_reqs = sbgp->group_size - 1;
+            req->state = ML_IALLREDUCE_UP_RECV;
+            break;
+
+        case ML_IALLREDUCE_UP_RECV:
+            /* reduce in the order of the subgroup, the operation commutes */
+            sbgp = topo->component_pairs[req->level].subgroup_module;
+            for (i = 0 ; i < sbgp->group_size - 1 ; ++i) {
+                ompi_op_reduce(req->op, req->scratch + i * req->slot, req->rbuf,
+                               req->count, req->dtype);
+            }
+            ++req->level;
+            req->state = ML_IALLREDUCE_UP;
+            break;
+
+        case ML_IALLREDUCE_UP_SENT:
+            /* the result comes back from the same leader */
+            sbgp = topo->component_pairs[req->level].subgroup_module;
+            rc = MCA_PML_CALL(irecv(req->rbuf, req->count, req->dtype,
+                                    sbgp->group_list[0], MCA_COLL_BASE_TAG_ALLREDUCE,
+                                    req->comm, &req->reqs[0]));
+            if (OMPI_SUCCESS != rc) {
+                ml_iallreduce_complete(req, rc);
+                return 1;
+            }
+            req->n_reqs = 1;
+            req->state = ML_IALLREDUCE_DOWN_RECV;
+            break;
+
+        case ML_IALLREDUCE_DOWN_RECV:
+        case ML_IALLREDUCE_DOWN_SENT:
+            --req->level;
+            req->state = ML_IALLREDUCE_DOWN;
+            break;
+
+        case ML_IALLREDUCE_DOWN:
+            if (req->level < 0) {
+                ml_iallreduce_complete(req, OMPI_SUCCESS);
+                return 1;
+            }
+            sbgp = topo->component_pairs[req->level].subgroup_module;
+            for (i = 0 ; i < sbgp->group_size - 1 ; ++i) {
+                rc = MCA_PML_CALL(isend(req->rbuf, req->count, req->dtype,
+                                        sbgp->group_list[i + 1], MCA_COLL_BASE_TAG_ALLREDUCE,
+                                        MCA_PML_BASE_SEND_STANDARD, req->comm,
+                                        &req->reqs[i]));
+                if (OMPI_SUCCESS != rc) {
+                    req->n_reqs = i;
+                    ml_iallreduce_complete(req, rc);
+                    return 1;
+                }
+            }
+            req->n_reqs = sbgp->group_size - 1;
+            req->state = ML_IALLREDUCE_DOWN_SENT;
+            break;
+        }
+    }
+}
+
+int mca_coll_ml_iallreduce_progress(void)
+{
+    mca_coll_ml_component_t *cm = &mca_coll_ml_component;
+    opal_list_item_t *item, *next;
+
+    if (opal_list_is_empty(&cm->hier_collectives)) {
+        return OMPI_SUCCESS;
+    }
+
+    OPAL_THREAD_LOCK(&cm->hier_collectives_mutex);
+    for (item = opal_list_get_first(&cm->hier_collectives) ;
+         item != opal_list_get_end(&cm->hier_collectives) ; item = next) {
+        next = opal_list_get_next(item);
+        if (ml_iallreduce_step((mca_coll_ml_iallreduce_request_t *) item)) {
+            opal_list_remove_item(&cm->hier_collectives, item);
+        }
+    }
+    OPAL_THREAD_UNLOCK(&cm->hier_collectives_mutex);
+
+    return OMPI_SUCCESS;
+}
+
+int mca_coll_ml_iallreduce_intra(void *sbuf, void *rbuf, int count,
+                                 struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                 struct ompi_communicator_t *comm,
+                                 ompi_request_t **request,
+                                 mca_coll_base_module_t *module)
+{
+    mca_coll_ml_module_t *ml_module = (mca_coll_ml_module_t *) module;
+    mca_coll_ml_iallreduce_request_t *req;
+    mca_coll_ml_topology_t *topo;
+    int n_members, rc;
+
+    topo = mca_coll_ml_hier_topo(ml_module, ML_ALLREDUCE, ML_SMALL_DATA_ALLREDUCE);
+    if (NULL == topo || !ompi_op_is_commute(op) ||
+        count > mca_coll_ml_hier_frag_count(ml_module, dtype, count)) {
+        /* long vectors would need the fragmentation of the blocking
+           allreduce, they are left to the module underneath */
+        if (NULL == ml_module->previous_iallreduce) {
+            return OMPI_ERR_NOT_SUPPORTED;
+        }
+        return ml_module->previous_iallreduce(sbuf, rbuf, count, dtype, op, comm, request,
+                                              ml_module->previous_iallreduce_module);
+    }
+
+    req = OBJ_NEW(mca_coll_ml_iallreduce_request_t);
+    if (NULL == req) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    OMPI_REQUEST_INIT(&req->super, false);
+    req->super.req_type = OMPI_REQUEST_COLL;
+    req->super.req_state = OMPI_REQUEST_ACTIVE;
+    req->super.req_free = ml_iallreduce_request_free;
+    req->super.req_cancel = ml_iallreduce_request_cancel;
+    req->super.req_status.MPI_SOURCE = MPI_ANY_SOURCE;
+    req->super.req_status.MPI_TAG = MPI_ANY_TAG;
+    req->super.req_status.MPI_ERROR = OMPI_SUCCESS;
+    req->super.req_status._ucount = 0;
+    req->super.req_status._cancelled = 0;
+    req->super.req_mpi_object.comm = comm;
+    *request = &req->super;
+
+    if (0 == count) {
+        ml_iallreduce_complete(req, OMPI_SUCCESS);
+        return OMPI_SUCCESS;
+    }
+
+    req->topo = topo;
+    req->comm = comm;
+    req->dtype = dtype;
+    req->op = op;
+    req->rbuf = rbuf;
+    req->count = count;
+    req->level = 0;
+    req->state = ML_IALLREDUCE_UP;
+
+    /* the reduction happens in place in the receive buffer */
+    if (MPI_IN_PLACE != sbuf) {
+        rc = ompi_datatype_copy_content_same_ddt(dtype, count, (char *) rbuf, (char *) sbuf);
+        if (OMPI_SUCCESS != rc) {
+            goto error;
+        }
+    }
+
+    n_members = mca_coll_ml_hier_max_members(topo);
+    rc = mca_coll_ml_hier_scratch_alloc(dtype, count, n_members, &req->scratch,
+                                        &req->scratch_base, &req->slot);
+    if (OMPI_SUCCESS != rc) {
+        goto error;
+    }
+    /* a member sends to and receives from its leader, one request */
+    req->reqs = (ompi_request_t **) malloc((n_members > 0 ? n_members : 1) *
+                                           sizeof(ompi_request_t *));
+    if (NULL == req->reqs) {
+        rc = OMPI_ERR_OUT_OF_RESOURCE;
+        goto error;
+    }
+
+    ML_VERBOSE(10, ("Iallreduce of %d elements", count));
+
+    /* the first level is started right away, the progress engine does
+       the rest */
+    if (!ml_iallreduce_step(req)) {
+        OPAL_THREAD_LOCK(&mca_coll_ml_component.hier_collectives_mutex);
+        opal_list_append(&mca_coll_ml_component.hier_collectives,
+                         (opal_list_item_t *) req);
+        OPAL_THREAD_UNLOCK(&mca_coll_ml_component.hier_collectives_mutex);
+    }
+    return OMPI_SUCCESS;
+
+error:
+    *request = MPI_REQUEST_NULL;
+    OMPI_REQUEST_FINI(&req->super);
+    OBJ_RELEASE(req);
+    return rc;
+}
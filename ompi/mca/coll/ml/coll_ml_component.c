@@ -346,6 +346,9 @@ static int coll_ml_progress()
     }
     OPAL_THREAD_UNLOCK(&(cm->pending_tasks_mutex));
 
+    /* non-blocking collectives scheduled through the PML */
+    (void) mca_coll_ml_iallreduce_progress();
+
     /* return */
     cm->progress_is_busy = false;
 
@@ -439,6 +442,8 @@ static int ml_open(void)
     OBJ_CONSTRUCT(&(cs->active_tasks), opal_list_t);
     OBJ_CONSTRUCT(&(cs->sequential_collectives_mutex), opal_mutex_t);
     OBJ_CONSTRUCT(&(cs->sequential_collectives), opal_list_t);
+    OBJ_CONSTRUCT(&(cs->hier_collectives_mutex), opal_mutex_t);
+    OBJ_CONSTRUCT(&(cs->hier_collectives), opal_list_t);
 
     rc = netpatterns_init();
     if (OMPI_SUCCESS != rc) {
@@ -146,6 +146,15 @@ mca_coll_ml_module_construct(mca_coll_ml_module_t *module)
 
     OBJ_CONSTRUCT(&(module->active_bcols_list), opal_list_t);
     OBJ_CONSTRUCT(&(module->waiting_for_memory_list), opal_list_t);
+
+    module->previous_allgather = NULL;
+    module->previous_allgather_module = NULL;
+    module->previous_allreduce = NULL;
+    module->previous_allreduce_module = NULL;
+    module->previous_iallreduce = NULL;
+    module->previous_iallreduce_module = NULL;
+    module->previous_reduce = NULL;
+    module->previous_reduce_module = NULL;
 }
 
 static void
@@ -233,6 +242,19 @@ mca_coll_ml_module_destruct(mca_coll_ml_module_t *module)
             free(module->coll_ml_barrier_function);
         }
     }
+
+    if (NULL != module->previous_allgather_module) {
+        OBJ_RELEASE(module->previous_allgather_module);
+    }
+    if (NULL != module->previous_allreduce_module) {
+        OBJ_RELEASE(module->previous_allreduce_module);
+    }
+    if (NULL != module->previous_iallreduce_module) {
+        OBJ_RELEASE(module->previous_iallreduce_module);
+    }
+    if (NULL != module->previous_reduce_module) {
+        OBJ_RELEASE(module->previous_reduce_module);
+    }
 }
 
 
@@ -2901,21 +2923,15 @@ static void init_coll_func_pointers(mca_coll_ml_module_t *ml_module)
         coll_base->coll_allgather = NULL;
         coll_base->coll_iallgather = NULL;
     } else {
-        coll_base->coll_allgather = NULL;
+        coll_base->coll_allgather = mca_coll_ml_allgather;
         coll_base->coll_iallgather = NULL;
     }
 
     coll_base->coll_allgatherv = NULL;
 
-    if (mca_coll_ml_component.use_knomial_allreduce) {
-        if (true == mca_coll_ml_component.need_allreduce_support) {
-            coll_base->coll_allreduce = NULL;
-        } else {
-            coll_base->coll_allreduce = NULL;
-        }
-    } else {
-        coll_base->coll_allreduce = NULL;
-    }
+    /* No bcol provides allreduce yet: whatever the knomial and
+       need_allreduce_support settings, it runs over the PML */
+    coll_base->coll_allreduce = mca_coll_ml_allreduce_intra;
 
     if (mca_coll_ml_component.disable_alltoall) {
         coll_base->coll_alltoall = NULL;
@@ -2948,7 +2964,7 @@ static void init_coll_func_pointers(mca_coll_ml_module_t *ml_module)
 
     coll_base->coll_gatherv    = NULL;
 
-    coll_base->coll_reduce     = NULL;
+    coll_base->coll_reduce     = mca_coll_ml_reduce;
     coll_base->coll_reduce_scatter = NULL;
     coll_base->coll_scan       = NULL;
     coll_base->coll_scatter    = NULL;
@@ -2958,7 +2974,7 @@ static void init_coll_func_pointers(mca_coll_ml_module_t *ml_module)
     coll_base->coll_scatterv   = NULL;
 
     coll_base->coll_iallgatherv = NULL;
-    coll_base->coll_iallreduce  = NULL;
+    coll_base->coll_iallreduce  = mca_coll_ml_iallreduce_intra;
     coll_base->coll_ialltoallv  = NULL;
     coll_base->coll_ialltoallw  = NULL;
     coll_base->coll_ibarrier    = mca_coll_ml_ibarrier_intra;
@@ -3182,6 +3198,9 @@ static void setup_default_topology_map(mca_coll_ml_module_t *ml_module)
     ml_module->collectives_topology_map[ML_ALLREDUCE][ML_SMALL_DATA_ALLREDUCE]    = COLL_ML_HR_FULL;
     ml_module->collectives_topology_map[ML_ALLREDUCE][ML_LARGE_DATA_ALLREDUCE]    = COLL_ML_HR_FULL;
 
+    ml_module->collectives_topology_map[ML_REDUCE][ML_SMALL_DATA_REDUCE]          = COLL_ML_HR_FULL;
+    ml_module->collectives_topology_map[ML_REDUCE][ML_LARGE_DATA_REDUCE]          = COLL_ML_HR_FULL;
+
     if (mca_coll_ml_need_multi_topo(BCOL_ALLREDUCE)) {
         ml_module->collectives_topology_map[ML_ALLREDUCE][ML_SMALL_DATA_EXTRA_TOPO_ALLREDUCE] = COLL_ML_HR_ALLREDUCE;
         ml_module->collectives_topology_map[ML_ALLREDUCE][ML_LARGE_DATA_EXTRA_TOPO_ALLREDUCE] = COLL_ML_HR_ALLREDUCE;
@@ -3418,6 +3437,7 @@ ml_module_enable(mca_coll_base_module_t *module,
                          struct ompi_communicator_t *comm)
 {
     /* local variables */
+    mca_coll_ml_module_t *ml_module = (mca_coll_ml_module_t *) module;
     char output_buffer[2 * MPI_MAX_OBJECT_NAME];
 
     memset(&output_buffer[0], 0, sizeof(output_buffer));
@@ -3426,6 +3446,28 @@ ml_module_enable(mca_coll_base_module_t *module,
 
     ML_VERBOSE(10, ("coll:ml:enable: new communicator: %s.\n", output_buffer));
 
+    /* Save the collectives of the module underneath, see coll_ml_reduce.c */
+    ml_module->previous_allgather = comm->c_coll.coll_allgather;
+    ml_module->previous_allgather_module = comm->c_coll.coll_allgather_module;
+    ml_module->previous_allreduce = comm->c_coll.coll_allreduce;
+    ml_module->previous_allreduce_module = comm->c_coll.coll_allreduce_module;
+    ml_module->previous_iallreduce = comm->c_coll.coll_iallreduce;
+    ml_module->previous_iallreduce_module = comm->c_coll.coll_iallreduce_module;
+    ml_module->previous_reduce = comm->c_coll.coll_reduce;
+    ml_module->previous_reduce_module = comm->c_coll.coll_reduce_module;
+    if (NULL != ml_module->previous_allgather_module) {
+        OBJ_RETAIN(ml_module->previous_allgather_module);
+    }
+    if (NULL != ml_module->previous_allreduce_module) {
+        OBJ_RETAIN(ml_module->previous_allreduce_module);
+    }
+    if (NULL != ml_module->previous_iallreduce_module) {
+        OBJ_RETAIN(ml_module->previous_iallreduce_module);
+    }
+    if (NULL != ml_module->previous_reduce_module) {
+        OBJ_RETAIN(ml_module->previous_reduce_module);
+    }
+
     /* All done */
     return OMPI_SUCCESS;
 }
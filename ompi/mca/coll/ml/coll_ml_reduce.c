@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/** @file
+ *
+ * Reduction schedules driven by the ML hierarchy.
+ *
+ * None of the bcols implements a reduction primitive yet, so the data
+ * is moved along the subgroups discovered by ML through the PML.  At
+ * every level the members of a subgroup send their data to the local
+ * leader, the first rank of the subgroup (see ml_discover_hierarchy),
+ * which reduces it into its own and goes on with the next level.  A
+ * rank stops at the first level it does not lead, so the leader of its
+ * last level is the leader of the top of the hierarchy and holds the
+ * result.  Large messages are cut in fragments of the ML payload
+ * buffer size: while a leader reduces one fragment the lower levels
+ * already work on the next one.
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "ompi/constants.h"
+#include "ompi/op/op.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/request/request.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+
+#include "coll_ml.h"
+#include "coll_ml_inlines.h"
+
+mca_coll_ml_topology_t *mca_coll_ml_hier_topo(mca_coll_ml_module_t *ml_module,
+                                              int coll, int alg)
+{
+    int topo_index = ml_module->collectives_topology_map[coll][alg];
+
+    if (topo_index < 0 ||
+        COLL_ML_TOPO_DISABLED == ml_module->topo_list[topo_index].status ||
+        ml_module->topo_list[topo_index].n_levels <= 0) {
+        return NULL;
+    }
+    return &ml_module->topo_list[topo_index];
+}
+
+int mca_coll_ml_hier_max_members(mca_coll_ml_topology_t *topo)
+{
+    int level, max = 0;
+
+    for (level = 0 ; level < topo->n_levels ; ++level) {
+        mca_sbgp_base_module_t *sbgp = topo->component_pairs[level].subgroup_module;
+
+        if (0 != sbgp->my_index) {
+            break;
+        }
+        if (sbgp->group_size - 1 > max) {
+            max = sbgp->group_size - 1;
+        }
+    }
+    return max;
+}
+
+int mca_coll_ml_hier_top_leader(mca_coll_ml_topology_t *topo)
+{
+    sub_group_params_t *subgroups = topo->array_of_all_subgroups;
+    int i, top = 0;
+
+    /* there is a single subgroup at the highest level */
+    for (i = 1 ; i < topo->number_of_all_subgroups ; ++i) {
+        if (subgroups[i].level_in_hierarchy > subgroups[top].level_in_hierarchy) {
+            top = i;
+        }
+    }
+    return subgroups[top].root_rank_in_comm;
+}
+
+int mca_coll_ml_hier_frag_count(mca_coll_ml_module_t *ml_module,
+                                struct ompi_datatype_t *dtype, int count)
+{
+    ptrdiff_t lb, extent;
+    int frag_count;
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    if (0 == ml_module->ml_fragment_size || extent <= 0) {
+        return count;
+    }
+    frag_count = (int) (ml_module->ml_fragment_size / (size_t) extent);
+    if (frag_count < 1) {
+        frag_count = 1;
+    }
+    return frag_count < count ? frag_count : count;
+}
+
+int mca_coll_ml_hier_reduce_frag(mca_coll_ml_topology_t *topo,
+                                 void *sbuf, void *accum, int count,
+                                 struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                 char *scratch, ptrdiff_t slot, ompi_request_t **reqs,
+                                 int tag, struct ompi_communicator_t *comm, bool *top)
+{
+    void *data = sbuf;
+    int level, i, rc;
+
+    for (level = 0 ; level < topo->n_levels ; ++level) {
+        mca_sbgp_base_module_t *sbgp = topo->component_pairs[level].subgroup_module;
+        int n_members = sbgp->group_size - 1;
+
+        if (0 != sbgp->my_index) {
+            /* hand my part to the leader, the rest is its business */
+            *top = false;
+            return MCA_PML_CALL(send(data, count, dtype, sbgp->group_list[0], tag,
+                                     MCA_PML_BASE_SEND_STANDARD, comm));
+        }
+
+        for (i = 0 ; i < n_members ; ++i) {
+            rc = MCA_PML_CALL(irecv(scratch + i * slot, count, dtype,
+                                    sbgp->group_list[i + 1], tag, comm, &reqs[i]));
+            if (OMPI_SUCCESS != rc) {
+                return rc;
+            }
+        }
+
+        if (data != accum) {
+            rc = ompi_datatype_copy_content_same_ddt(dtype, count, (char *) accum,
+                                                     (char *) data);
+            if (OMPI_SUCCESS != rc) {
+                return rc;
+            }
+            data = accum;
+        }
+
+        /* reduce in the order of the subgroup, the operation commutes */
+        for (i = 0 ; i < n_members ; ++i) {
+            rc = ompi_request_wait(&reqs[i], MPI_STATUS_IGNORE);
+            if (OMPI_SUCCESS != rc) {
+                return rc;
+            }
+            ompi_op_reduce(op, scratch + i * slot, accum, count, dtype);
+        }
+    }
+
+    *top = true;
+    if (data != accum) {
+        return ompi_datatype_copy_content_same_ddt(dtype, count, (char *) accum,
+                                                   (char *) data);
+    }
+    return OMPI_SUCCESS;
+}
+
+int mca_coll_ml_hier_bcast_frag(mca_coll_ml_topology_t *topo, void *buf, int count,
+                                struct ompi_datatype_t *dtype, ompi_request_t **reqs,
+                                int tag, struct ompi_communicator_t *comm)
+{
+    int level = topo->n_levels - 1, i, rc;
+    mca_sbgp_base_module_t *sbgp = topo->component_pairs[level].subgroup_module;
+
+    /* the way down mirrors the way up */
+    if (0 != sbgp->my_index) {
+        rc = MCA_PML_CALL(recv(buf, count, dtype, sbgp->group_list[0], tag, comm,
+                               MPI_STATUS_IGNORE));
+        if (OMPI_SUCCESS != rc) {
+            return rc;
+        }
+        --level;
+    }
+
+    for ( ; level >= 0 ; --level) {
+        int n_members;
+
+        sbgp = topo->component_pairs[level].subgroup_module;
+        n_members = sbgp->group_size - 1;
+        for (i = 0 ; i < n_members ; ++i) {
+            rc = MCA_PML_CALL(isend(buf, count, dtype, sbgp->group_list[i + 1], tag,
+                                    MCA_PML_BASE_SEND_STANDARD, comm, &reqs[i]));
+            if (OMPI_SUCCESS != rc) {
+                return rc;
+            }
+        }
+        rc = ompi_request_wait_all(n_members, reqs, MPI_STATUSES_IGNORE);
+        if (OMPI_SUCCESS != rc) {
+            return rc;
+        }
+    }
+
+    return OMPI_SUCCESS;
+}
+
+int mca_coll_ml_hier_scratch_alloc(struct ompi_datatype_t *dtype, int frag_count,
+                                   int n_slots, char **scratch, char **scratch_base,
+                                   ptrdiff_t *slot)
+{
+    ptrdiff_t lb, extent, true_lb, true_extent;
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    *slot = true_extent + (ptrdiff_t) (frag_count - 1) * extent;
+
+    *scratch_base = NULL;
+    *scratch = NULL;
+    if (0 == n_slots) {
+        return OMPI_SUCCESS;
+    }
+    *scratch_base = (char *) malloc(*slot * n_slots);
+    if (NULL == *scratch_base) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    *scratch = *scratch_base - true_lb;
+    return OMPI_SUCCESS;
+}
+
+/* Reduce - blocking */
+int mca_coll_ml_reduce(void *sbuf, void *rbuf, int count,
+        struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+        int root,
+        struct ompi_communicator_t *comm,
+        mca_coll_base_module_t *module)
+{
+    mca_coll_ml_module_t *ml_module = (mca_coll_ml_module_t *) module;
+    mca_coll_ml_topology_t *topo;
+    char *scratch = NULL, *scratch_base = NULL, *work = NULL, *work_base = NULL;
+    ompi_request_t **reqs = NULL;
+    int rank = ompi_comm_rank(comm), frag_count, offset, top_leader, n_members, rc;
+    ptrdiff_t lb, extent, slot, work_slot;
+    bool top;
+
+    topo = mca_coll_ml_hier_topo(ml_module, ML_REDUCE,
+                                 count > mca_coll_ml_hier_frag_count(ml_module, dtype, count) ?
+                                 ML_LARGE_DATA_REDUCE : ML_SMALL_DATA_REDUCE);
+    if (NULL == topo || !ompi_op_is_commute(op)) {
+        /* the hierarchy does not follow the ranks, the operation is
+           left to the module underneath */
+        if (NULL == ml_module->previous_reduce) {
+            return OMPI_ERR_NOT_SUPPORTED;
+        }
+        return ml_module->previous_reduce(sbuf, rbuf, count, dtype, op, root, comm,
+                                          ml_module->previous_reduce_module);
+    }
+    if (0 == count) {
+        return OMPI_SUCCESS;
+    }
+
+    if (rank == root && MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+    }
+
+    ML_VERBOSE(10, ("Reduce of %d elements to root %d", count, root));
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    frag_count = mca_coll_ml_hier_frag_count(ml_module, dtype, count);
+    top_leader = mca_coll_ml_hier_top_leader(topo);
+    n_members = mca_coll_ml_hier_max_members(topo);
+
+    rc = mca_coll_ml_hier_scratch_alloc(dtype, frag_count, n_members, &scratch,
+                                        &scratch_base, &slot);
+    if (OMPI_SUCCESS != rc) {
+        goto exit;
+    }
+    /* the leaders other than the root accumulate in a fragment of their own */
+    if (rank != root && (0 < n_members || rank == top_leader)) {
+        rc = mca_coll_ml_hier_scratch_alloc(dtype, frag_count, 1, &work, &work_base,
+                                            &work_slot);
+        if (OMPI_SUCCESS != rc) {
+            goto exit;
+        }
+    }
+    if (0 < n_members) {
+        reqs = (ompi_request_t **) malloc(n_members * sizeof(ompi_request_t *));
+        if (NULL == reqs) {
+            rc = OMPI_ERR_OUT_OF_RESOURCE;
+            goto exit;
+        }
+    }
+
+    for (offset = 0 ; offset < count ; offset += frag_count) {
+        int fcount = (count - offset < frag_count) ? count - offset : frag_count;
+        char *frag_sbuf = (char *) sbuf + (ptrdiff_t) offset * extent;
+        char *accum = (rank == root) ? (char *) rbuf + (ptrdiff_t) offset * extent : work;
+
+        rc = mca_coll_ml_hier_reduce_frag(topo, frag_sbuf, accum, fcount, dtype, op,
+                                          scratch, slot, reqs, MCA_COLL_BASE_TAG_REDUCE,
+                                          comm, &top);
+        if (OMPI_SUCCESS != rc) {
+            goto exit;
+        }
+
+        if (root == top_leader) {
+            continue;
+        }
+        if (top) {
+            rc = MCA_PML_CALL(send(accum, fcount, dtype, root, MCA_COLL_BASE_TAG_REDUCE,
+                                   MCA_PML_BASE_SEND_STANDARD, comm));
+        } else if (rank == root) {
+            rc = MCA_PML_CALL(recv(accum, fcount, dtype, top_leader, MCA_COLL_BASE_TAG_REDUCE,
+                                   comm, MPI_STATUS_IGNORE));
+        }
+        if (OMPI_SUCCESS != rc) {
+            goto exit;
+        }
+    }
+
+exit:
+    if (OMPI_SUCCESS != rc) {
+        ML_ERROR(("Hierarchical reduce failed: %d", rc));
+    }
+    free(reqs);
+    free(work_base);
+    free(scratch_base);
+    return rc;
+}
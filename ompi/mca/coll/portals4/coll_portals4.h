@@ -34,6 +34,7 @@ struct mca_coll_portals4_component_t {
     ptl_pt_index_t finish_pt_idx;
     ptl_handle_eq_t eq_h;
     ptl_handle_me_t barrier_unex_me_h;
+    ptl_handle_me_t bcast_unex_me_h;
     ptl_handle_me_t finish_me_h;
     /** Send MD handle(s).  Use ompi_coll_portals4_get_md() to get the right md */
 #if OMPI_PORTALS4_MAX_MD_SIZE < OMPI_PORTALS4_MAX_VA_SIZE
@@ -51,6 +52,13 @@ struct mca_coll_portals4_module_t {
     mca_coll_base_module_t super;
 
     size_t barrier_count;
+    size_t bcast_count;
+
+    /* for the broadcasts which are not offloaded */
+    mca_coll_base_module_bcast_fn_t previous_bcast;
+    mca_coll_base_module_t *previous_bcast_module;
+    mca_coll_base_module_ibcast_fn_t previous_ibcast;
+    mca_coll_base_module_t *previous_ibcast_module;
 };
 typedef struct mca_coll_portals4_module_t mca_coll_portals4_module_t;
 OBJ_CLASS_DECLARATION(mca_coll_portals4_module_t);
@@ -69,7 +77,9 @@ struct ompi_coll_portals4_request_t;
 #define COLL_PORTALS4_CID_MASK      0xFFF0000000000000ULL
 #define COLL_PORTALS4_OP_COUNT_MASK 0x00001FFFFFFFFFFFULL
 
-#define COLL_PORTALS4_BARRIER 0x01
+#define COLL_PORTALS4_BARRIER     0x01
+#define COLL_PORTALS4_BCAST       0x02
+#define COLL_PORTALS4_BCAST_READY 0x03
 
 #define COLL_PORTALS4_SET_BITS(match_bits, contextid, eager, type, op_count) \
     {                                                                   \
@@ -89,6 +99,17 @@ int ompi_coll_portals4_ibarrier_intra(struct ompi_communicator_t *comm,
                                       mca_coll_base_module_t *module);
 int ompi_coll_portals4_ibarrier_intra_fini(struct ompi_coll_portals4_request_t *request);
 
+int ompi_coll_portals4_bcast_intra(void *buff, int count,
+                                   struct ompi_datatype_t *datatype, int root,
+                                   struct ompi_communicator_t *comm,
+                                   mca_coll_base_module_t *module);
+int ompi_coll_portals4_ibcast_intra(void *buff, int count,
+                                    struct ompi_datatype_t *datatype, int root,
+                                    struct ompi_communicator_t *comm,
+                                    ompi_request_t **request,
+                                    mca_coll_base_module_t *module);
+int ompi_coll_portals4_ibcast_intra_fini(struct ompi_coll_portals4_request_t *request);
+
 
 static inline ptl_process_t
 ompi_coll_portals4_get_peer(struct ompi_communicator_t *comm, int rank)
@@ -0,0 +1,447 @@
+/*
+ * Copyright (c) 2013      Sandia National Laboratories. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+
+#include "ompi_config.h"
+
+#include "coll_portals4.h"
+#include "coll_portals4_request.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "opal/util/bit_ops.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/base.h"
+
+/*
+ * The broadcast follows the hypercube tree of the barrier, rooted at
+ * root.  Every non-root process exposes its buffer in a data ME, then
+ * tells its parent with a zero-length "ready" put.  A process forwards
+ * the data to its children with triggered puts, fired by the NIC once
+ * the data has arrived and all its children are ready, so the whole tree
+ * moves without the host.  The ready puts may arrive before the ready ME
+ * is appended, they are then counted from the unexpected arena; the data
+ * puts never are, as they are only sent to a ready child.
+ *
+ * Both kinds of arrivals are counted on ct_h; the acks of the puts sent
+ * to the children are counted on ack_ct_h, the counter of an MD covering
+ * the buffer, which may then only be reused once they have all arrived.
+ */
+
+struct bcast_tree_t {
+    int nchildren;
+    ptl_size_t num_msgs;            /* arrivals expected on ct_h */
+    ptl_handle_ct_t ct_h;
+    ptl_handle_ct_t ack_ct_h;
+    ptl_handle_me_t data_me_h;
+    ptl_handle_me_t ready_me_h;
+    ptl_handle_md_t md_h;
+};
+typedef struct bcast_tree_t bcast_tree_t;
+
+
+static int
+bcast_tree_post(void *start, size_t length, int root,
+                struct ompi_communicator_t *comm,
+                mca_coll_portals4_module_t *portals4_module,
+                bcast_tree_t *tree)
+{
+    int ret, i, dim, hibit, mask;
+    int size = ompi_comm_size(comm);
+    int vrank = (ompi_comm_rank(comm) - root + size) % size;
+    size_t count;
+    ptl_match_bits_t data_bits, ready_bits;
+    ptl_handle_md_t zero_md_h;
+    ptl_md_t md;
+    ptl_me_t me;
+    void *base;
+
+    tree->ct_h = PTL_INVALID_HANDLE;
+    tree->ack_ct_h = PTL_INVALID_HANDLE;
+    tree->data_me_h = PTL_INVALID_HANDLE;
+    tree->ready_me_h = PTL_INVALID_HANDLE;
+    tree->md_h = PTL_INVALID_HANDLE;
+
+    ompi_coll_portals4_get_md(0, &zero_md_h, &base);
+
+    count = opal_atomic_add_size_t(&portals4_module->bcast_count, 1);
+
+    COLL_PORTALS4_SET_BITS(data_bits, ompi_comm_get_cid(comm),
+                           0, COLL_PORTALS4_BCAST, count);
+    COLL_PORTALS4_SET_BITS(ready_bits, ompi_comm_get_cid(comm),
+                           0, COLL_PORTALS4_BCAST_READY, count);
+
+    ret = PtlCTAlloc(mca_coll_portals4_component.ni_h, &tree->ct_h);
+    if (PTL_OK != ret) {
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "%s:%d: PtlCTAlloc failed: %d\n",
+                            __FILE__, __LINE__, ret);
+        return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+    ret = PtlCTAlloc(mca_coll_portals4_component.ni_h, &tree->ack_ct_h);
+    if (PTL_OK != ret) {
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "%s:%d: PtlCTAlloc failed: %d\n",
+                            __FILE__, __LINE__, ret);
+        return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+
+    md.start = start;
+    md.length = length;
+    md.options = PTL_MD_EVENT_CT_ACK;
+    md.eq_handle = PTL_EQ_NONE;
+    md.ct_handle = tree->ack_ct_h;
+    ret = PtlMDBind(mca_coll_portals4_component.ni_h, &md, &tree->md_h);
+    if (PTL_OK != ret) {
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "%s:%d: PtlMDBind failed: %d\n",
+                            __FILE__, __LINE__, ret);
+        return OMPI_ERROR;
+    }
+
+    /* Build "tree" out of hypercube */
+    dim = comm->c_cube_dim;
+    hibit = opal_hibit(vrank, dim);
+    --dim;
+    tree->nchildren = ompi_coll_portals4_get_nchildren(dim + 1, hibit, vrank, size);
+    tree->num_msgs = tree->nchildren;
+
+    me.ct_handle = tree->ct_h;
+    me.min_free = 0;
+    me.uid = mca_coll_portals4_component.uid;
+    me.match_id.phys.nid = PTL_NID_ANY;
+    me.match_id.phys.pid = PTL_PID_ANY;
+    me.ignore_bits = 0;
+
+    if (vrank > 0) {
+        int parent = (vrank & ~(1 << hibit)) + root;
+        if (parent >= size) parent -= size;
+
+        /* receive space for the data */
+        me.start = start;
+        me.length = length;
+        me.options = PTL_ME_OP_PUT | PTL_ME_EVENT_SUCCESS_DISABLE |
+            PTL_ME_EVENT_LINK_DISABLE | PTL_ME_EVENT_UNLINK_DISABLE |
+            PTL_ME_EVENT_CT_COMM;
+        me.match_bits = data_bits;
+        ret = PtlMEAppend(mca_coll_portals4_component.ni_h,
+                          mca_coll_portals4_component.pt_idx,
+                          &me,
+                          PTL_PRIORITY_LIST,
+                          NULL,
+                          &tree->data_me_h);
+        if (PTL_OK != ret) {
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "%s:%d: PtlMEAppend failed: %d\n",
+                                __FILE__, __LINE__, ret);
+            return OMPI_ERROR;
+        }
+
+        /* the data ME is linked, the parent may send */
+        ret = PtlPut(zero_md_h,
+                     0,
+                     0,
+                     PTL_NO_ACK_REQ,
+                     ompi_coll_portals4_get_peer(comm, parent),
+                     mca_coll_portals4_component.pt_idx,
+                     ready_bits,
+                     0,
+                     NULL,
+                     0);
+        if (PTL_OK != ret) {
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "%s:%d: PtlPut failed: %d\n",
+                                __FILE__, __LINE__, ret);
+            return OMPI_ERROR;
+        }
+
+        tree->num_msgs++;
+    }
+
+    /* ready notifications of the children */
+    me.start = NULL;
+    me.length = 0;
+    me.options = PTL_ME_OP_PUT | PTL_ME_EVENT_SUCCESS_DISABLE |
+        PTL_ME_EVENT_LINK_DISABLE | PTL_ME_EVENT_UNLINK_DISABLE |
+        PTL_ME_EVENT_CT_COMM | PTL_ME_EVENT_CT_OVERFLOW;
+    me.match_bits = ready_bits;
+    ret = PtlMEAppend(mca_coll_portals4_component.ni_h,
+                      mca_coll_portals4_component.pt_idx,
+                      &me,
+                      PTL_PRIORITY_LIST,
+                      NULL,
+                      &tree->ready_me_h);
+    if (PTL_OK != ret) {
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "%s:%d: PtlMEAppend failed: %d\n",
+                            __FILE__, __LINE__, ret);
+        return OMPI_ERROR;
+    }
+
+    /* send to children when the data is here and they are all ready */
+    for (i = hibit + 1, mask = 1 << i; i <= dim; ++i, mask <<= 1) {
+        int peer = vrank | mask;
+        if (peer < size) {
+            peer += root;
+            if (peer >= size) peer -= size;
+            ret = PtlTriggeredPut(tree->md_h,
+                                  0,
+                                  length,
+                                  PTL_CT_ACK_REQ,
+                                  ompi_coll_portals4_get_peer(comm, peer),
+                                  mca_coll_portals4_component.pt_idx,
+                                  data_bits,
+                                  0,
+                                  NULL,
+                                  0,
+                                  tree->ct_h,
+                                  tree->num_msgs);
+            if (PTL_OK != ret) {
+                opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                    "%s:%d: PtlTriggeredPut failed: %d\n",
+                                    __FILE__, __LINE__, ret);
+                return OMPI_ERROR;
+            }
+        }
+    }
+
+    return OMPI_SUCCESS;
+}
+
+
+static int
+bcast_tree_cleanup(bcast_tree_t *tree)
+{
+    int ret;
+
+    if (!PtlHandleIsEqual(tree->data_me_h, PTL_INVALID_HANDLE)) {
+        ret = PtlMEUnlink(tree->data_me_h);
+        if (PTL_OK != ret) {
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "%s:%d: PtlMEUnlink failed: %d\n",
+                                __FILE__, __LINE__, ret);
+            return OMPI_ERROR;
+        }
+    }
+    if (!PtlHandleIsEqual(tree->ready_me_h, PTL_INVALID_HANDLE)) {
+        ret = PtlMEUnlink(tree->ready_me_h);
+        if (PTL_OK != ret) {
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "%s:%d: PtlMEUnlink failed: %d\n",
+                                __FILE__, __LINE__, ret);
+            return OMPI_ERROR;
+        }
+    }
+    if (!PtlHandleIsEqual(tree->md_h, PTL_INVALID_HANDLE)) {
+        ret = PtlMDRelease(tree->md_h);
+        if (PTL_OK != ret) {
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "%s:%d: PtlMDRelease failed: %d\n",
+                                __FILE__, __LINE__, ret);
+            return OMPI_ERROR;
+        }
+    }
+    if (!PtlHandleIsEqual(tree->ack_ct_h, PTL_INVALID_HANDLE)) {
+        ret = PtlCTFree(tree->ack_ct_h);
+        if (PTL_OK != ret) {
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "%s:%d: PtlCTFree failed: %d\n",
+                                __FILE__, __LINE__, ret);
+            return OMPI_ERROR;
+        }
+    }
+    if (!PtlHandleIsEqual(tree->ct_h, PTL_INVALID_HANDLE)) {
+        ret = PtlCTFree(tree->ct_h);
+        if (PTL_OK != ret) {
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "%s:%d: PtlCTFree failed: %d\n",
+                                __FILE__, __LINE__, ret);
+            return OMPI_ERROR;
+        }
+    }
+
+    return OMPI_SUCCESS;
+}
+
+
+/* Only contiguous data is broadcast by the NIC, the rest goes to the
+   component below us. */
+static inline bool
+bcast_is_offloaded(void *buff, int count, struct ompi_datatype_t *datatype,
+                   void **start, size_t *length)
+{
+    size_t dsize;
+
+    if (!ompi_datatype_is_contiguous_memory_layout(datatype, count)) {
+        return false;
+    }
+    ompi_datatype_type_size(datatype, &dsize);
+    *length = dsize * count;
+    *start = (char*) buff + datatype->super.true_lb;
+
+    return true;
+}
+
+
+int
+ompi_coll_portals4_bcast_intra(void *buff, int count,
+                               struct ompi_datatype_t *datatype, int root,
+                               struct ompi_communicator_t *comm,
+                               mca_coll_base_module_t *module)
+{
+    mca_coll_portals4_module_t *portals4_module = (mca_coll_portals4_module_t*) module;
+    bcast_tree_t tree;
+    ptl_ct_event_t ct;
+    size_t length;
+    void *start;
+    int ret;
+
+    if (!bcast_is_offloaded(buff, count, datatype, &start, &length)) {
+        return portals4_module->previous_bcast(buff, count, datatype, root, comm,
+                                               portals4_module->previous_bcast_module);
+    }
+    if (0 == length) {
+        return OMPI_SUCCESS;
+    }
+
+    ret = bcast_tree_post(start, length, root, comm, portals4_module, &tree);
+    if (OMPI_SUCCESS != ret) {
+        bcast_tree_cleanup(&tree);
+        return ret;
+    }
+
+    /* Wait for the data and the children, then for the acks of the
+       children before handing the buffer back */
+    ret = PtlCTWait(tree.ct_h, tree.num_msgs, &ct);
+    if (PTL_OK == ret) {
+        ret = PtlCTWait(tree.ack_ct_h, tree.nchildren, &ct);
+    }
+    if (PTL_OK != ret) {
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "%s:%d: PtlCTWait failed: %d\n",
+                            __FILE__, __LINE__, ret);
+        bcast_tree_cleanup(&tree);
+        return OMPI_ERROR;
+    }
+
+    return bcast_tree_cleanup(&tree);
+}
+
+
+int
+ompi_coll_portals4_ibcast_intra(void *buff, int count,
+                                struct ompi_datatype_t *datatype, int root,
+                                struct ompi_communicator_t *comm,
+                                ompi_request_t **ompi_req,
+                                struct mca_coll_base_module_2_0_0_t *module)
+{
+    mca_coll_portals4_module_t *portals4_module = (mca_coll_portals4_module_t*) module;
+    ompi_coll_portals4_request_t *request;
+    bcast_tree_t tree;
+    ptl_ct_event_t inc;
+    ptl_handle_md_t md_h;
+    size_t length;
+    void *start, *base;
+    int ret;
+
+    if (!bcast_is_offloaded(buff, count, datatype, &start, &length) ||
+        0 == length) {
+        return portals4_module->previous_ibcast(buff, count, datatype, root, comm,
+                                                ompi_req,
+                                                portals4_module->previous_ibcast_module);
+    }
+
+    ompi_coll_portals4_get_md(0, &md_h, &base);
+
+    OMPI_COLL_PORTALS4_REQUEST_ALLOC(comm, request);
+    if (NULL == request) {
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "%s:%d: request alloc failed\n",
+                            __FILE__, __LINE__);
+        return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+    *ompi_req = &request->super;
+    request->type = OMPI_COLL_PORTALS4_TYPE_BCAST;
+
+    ret = bcast_tree_post(start, length, root, comm, portals4_module, &tree);
+    request->ct_h = tree.ct_h;
+    request->me_h = tree.ready_me_h;
+    request->ack_ct_h = tree.ack_ct_h;
+    request->data_me_h = tree.data_me_h;
+    request->md_h = tree.md_h;
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    /* Once the children have acked, count one more arrival... */
+    inc.success = 1;
+    inc.failure = 0;
+    ret = PtlTriggeredCTInc(tree.ct_h,
+                            inc,
+                            tree.ack_ct_h,
+                            tree.nchildren);
+    if (PTL_OK != ret) {
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "%s:%d: PtlTriggeredCTInc failed: %d\n",
+                            __FILE__, __LINE__, ret);
+        return OMPI_ERROR;
+    }
+
+    /* ...which sends a put to self when the broadcast is done */
+    ret = PtlTriggeredPut(md_h,
+                          0,
+                          0,
+                          PTL_NO_ACK_REQ,
+                          ompi_coll_portals4_get_peer(comm, ompi_comm_rank(comm)),
+                          mca_coll_portals4_component.finish_pt_idx,
+                          0,
+                          0,
+                          NULL,
+                          (uintptr_t) request,
+                          tree.ct_h,
+                          tree.num_msgs + 1);
+    if (PTL_OK != ret) {
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "%s:%d: PtlTriggeredPut failed: %d\n",
+                            __FILE__, __LINE__, ret);
+        return OMPI_ERROR;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_coll_portals4_ibcast_intra_fini(ompi_coll_portals4_request_t *request)
+{
+    bcast_tree_t tree;
+    int ret;
+
+    tree.ct_h = request->ct_h;
+    tree.ready_me_h = request->me_h;
+    tree.ack_ct_h = request->ack_ct_h;
+    tree.data_me_h = request->data_me_h;
+    tree.md_h = request->md_h;
+    request->ct_h = request->ack_ct_h = PTL_INVALID_HANDLE;
+    request->me_h = request->data_me_h = PTL_INVALID_HANDLE;
+    request->md_h = PTL_INVALID_HANDLE;
+
+    ret = bcast_tree_cleanup(&tree);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    OPAL_THREAD_LOCK(&ompi_request_lock);
+    ompi_request_complete(&request->super, true);
+    OPAL_THREAD_UNLOCK(&ompi_request_lock);
+
+    return OMPI_SUCCESS;
+}
@@ -103,6 +103,7 @@ portals4_open(void)
     mca_coll_portals4_component.finish_pt_idx = -1;
     mca_coll_portals4_component.eq_h = PTL_INVALID_HANDLE;
     mca_coll_portals4_component.barrier_unex_me_h = PTL_INVALID_HANDLE;
+    mca_coll_portals4_component.bcast_unex_me_h = PTL_INVALID_HANDLE;
     mca_coll_portals4_component.finish_me_h = PTL_INVALID_HANDLE;
 #if OMPI_PORTALS4_MAX_MD_SIZE < OMPI_PORTALS4_MAX_VA_SIZE
     mca_coll_portals4_component.md_hs = NULL;
@@ -172,6 +173,14 @@ portals4_close(void)
                                 __FILE__, __LINE__, ret);
         }
     }
+    if (!PtlHandleIsEqual(mca_coll_portals4_component.bcast_unex_me_h, PTL_INVALID_HANDLE)) {
+        ret = PtlMEUnlink(mca_coll_portals4_component.bcast_unex_me_h);
+        if (PTL_OK != ret) {
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "%s:%d: PtlMEUnlink failed: %d\n",
+                                __FILE__, __LINE__, ret);
+        }
+    }
     if (!PtlHandleIsEqual(mca_coll_portals4_component.barrier_unex_me_h, PTL_INVALID_HANDLE)) {
         ret = PtlMEUnlink(mca_coll_portals4_component.barrier_unex_me_h);
         if (PTL_OK != ret) {
@@ -410,6 +419,21 @@ portals4_init_query(bool enable_progress_threads,
         return OMPI_ERROR;
     }
 
+    /* Same for the ready notifications of the broadcast tree */
+    COLL_PORTALS4_SET_BITS(me.match_bits, 0, 0, COLL_PORTALS4_BCAST_READY, 0);
+    ret = PtlMEAppend(mca_coll_portals4_component.ni_h,
+                      mca_coll_portals4_component.pt_idx,
+                      &me,
+                      PTL_OVERFLOW_LIST,
+                      NULL,
+                      &mca_coll_portals4_component.bcast_unex_me_h);
+    if (PTL_OK != ret) {
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "%s:%d: PtlMEAppend of bcast unexpected failed: %d\n",
+                            __FILE__, __LINE__, ret);
+        return OMPI_ERROR;
+    }
+
     /* activate progress callback */
     ret = opal_progress_register(portals4_progress);
     if (OMPI_SUCCESS != ret) {
@@ -447,8 +471,11 @@ portals4_comm_query(struct ompi_communicator_t *comm,
     portals4_module->super.ft_event = NULL;
     portals4_module->super.coll_barrier = ompi_coll_portals4_barrier_intra;
     portals4_module->super.coll_ibarrier = ompi_coll_portals4_ibarrier_intra;
+    portals4_module->super.coll_bcast = ompi_coll_portals4_bcast_intra;
+    portals4_module->super.coll_ibcast = ompi_coll_portals4_ibcast_intra;
 
     portals4_module->barrier_count = 0;
+    portals4_module->bcast_count = 0;
 
     return &(portals4_module->super);
 }
@@ -461,6 +488,24 @@ static int
 portals4_module_enable(mca_coll_base_module_t *module,
                        struct ompi_communicator_t *comm)
 {
+    mca_coll_portals4_module_t *portals4_module = (mca_coll_portals4_module_t*) module;
+
+    /* keep the broadcasts of the component below us for the data
+       which is not contiguous */
+    if (NULL == comm->c_coll.coll_bcast_module ||
+        NULL == comm->c_coll.coll_ibcast_module) {
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "%s:%d: no underlying bcast\n",
+                            __FILE__, __LINE__);
+        return OMPI_ERROR;
+    }
+    portals4_module->previous_bcast = comm->c_coll.coll_bcast;
+    portals4_module->previous_bcast_module = comm->c_coll.coll_bcast_module;
+    OBJ_RETAIN(portals4_module->previous_bcast_module);
+    portals4_module->previous_ibcast = comm->c_coll.coll_ibcast;
+    portals4_module->previous_ibcast_module = comm->c_coll.coll_ibcast_module;
+    OBJ_RETAIN(portals4_module->previous_ibcast_module);
+
     return OMPI_SUCCESS;
 }
 
@@ -486,6 +531,9 @@ portals4_progress(void)
                 case OMPI_COLL_PORTALS4_TYPE_BARRIER:
                     ompi_coll_portals4_ibarrier_intra_fini(ptl_request);
                     break;
+                case OMPI_COLL_PORTALS4_TYPE_BCAST:
+                    ompi_coll_portals4_ibcast_intra_fini(ptl_request);
+                    break;
                 }
             } else {
                 opal_output(ompi_coll_base_framework.framework_output,
@@ -509,6 +557,29 @@ portals4_progress(void)
 }
 
 
+static void
+portals4_module_construct(mca_coll_portals4_module_t *module)
+{
+    module->previous_bcast = NULL;
+    module->previous_bcast_module = NULL;
+    module->previous_ibcast = NULL;
+    module->previous_ibcast_module = NULL;
+}
+
+
+static void
+portals4_module_destruct(mca_coll_portals4_module_t *module)
+{
+    if (NULL != module->previous_bcast_module) {
+        OBJ_RELEASE(module->previous_bcast_module);
+    }
+    if (NULL != module->previous_ibcast_module) {
+        OBJ_RELEASE(module->previous_ibcast_module);
+    }
+}
+
+
 OBJ_CLASS_INSTANCE(mca_coll_portals4_module_t,
                    mca_coll_base_module_t,
-                   NULL, NULL);
+                   portals4_module_construct,
+                   portals4_module_destruct);
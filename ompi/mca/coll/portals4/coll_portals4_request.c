@@ -47,6 +47,9 @@ request_construct(ompi_coll_portals4_request_t *request)
     request->super.req_cancel = request_cancel;
     request->ct_h = PTL_INVALID_HANDLE;
     request->me_h = PTL_INVALID_HANDLE;
+    request->ack_ct_h = PTL_INVALID_HANDLE;
+    request->data_me_h = PTL_INVALID_HANDLE;
+    request->md_h = PTL_INVALID_HANDLE;
 }
 
 OBJ_CLASS_INSTANCE(ompi_coll_portals4_request_t,
@@ -14,6 +14,7 @@
 
 enum ompi_coll_portals4_request_type_t {
     OMPI_COLL_PORTALS4_TYPE_BARRIER,
+    OMPI_COLL_PORTALS4_TYPE_BCAST,
 };
 typedef enum ompi_coll_portals4_request_type_t ompi_coll_portals4_request_type_t;
 
@@ -22,6 +23,10 @@ struct ompi_coll_portals4_request_t {
     ompi_coll_portals4_request_type_t type;
     ptl_handle_ct_t ct_h;
     ptl_handle_me_t me_h;
+    /* broadcast only */
+    ptl_handle_ct_t ack_ct_h;
+    ptl_handle_me_t data_me_h;
+    ptl_handle_md_t md_h;
 };
 typedef struct ompi_coll_portals4_request_t ompi_coll_portals4_request_t;
 
@@ -23,6 +23,10 @@
 
 #include "ompi_config.h"
 
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+
 #include "mpi.h"
 #include "opal/mca/mca.h"
 #include "opal/datatype/opal_convertor.h"
@@ -79,8 +83,18 @@ BEGIN_C_DECLS
             calculation of the "info" MCA parameter */
         int sm_info_comm_size;
 
+        /** MCA parameter: Smallest per-process block (in bytes) that
+            is copied straight between the users' buffers instead of
+            through the shared segments (0 disables it) */
+        int sm_single_copy_threshold;
+
         /******* end of MCA params ********/
 
+        /** Whether the single-copy path can be used on this node
+            (CMA support compiled in, permitted by the kernel and
+            sm_single_copy_threshold > 0) */
+        bool sm_single_copy;
+
         /** How many fragment segments are protected by a single
             in-use flags.  This is solely so that we can only perform
             the division once and then just use the value without
@@ -117,6 +131,22 @@ BEGIN_C_DECLS
         volatile uint32_t mcsiuf_operation_count;
     } mca_coll_sm_in_use_flag_t;
 
+    /**
+     * What a process posts in its control buffer of a segment for the
+     * single-copy operations: where its buffer is, so that the peers
+     * can read it directly.  The first member overlays SEGMENT_READY.
+     */
+    typedef struct mca_coll_sm_single_copy_post_t {
+        /** Set to 1 once the rest of the post is valid */
+        volatile size_t mcscp_ready;
+        /** Process owning the buffer */
+        volatile pid_t mcscp_pid;
+        /** Start of the packed data in that process */
+        char * volatile mcscp_addr;
+        /** Distance between consecutive per-process blocks */
+        volatile size_t mcscp_stride;
+    } mca_coll_sm_single_copy_post_t;
+
     /**
      * Structure containing pointers to various arrays of data in the
      * per-communicator shmem data segment (one of these indexes a
@@ -143,21 +173,25 @@ BEGIN_C_DECLS
            function */
         mca_common_sm_module_t *sm_bootstrap_meta;
 
-        /** Pointer to my barrier control pages (odd index pages are
-            "in", even index pages are "out") */
+        /** Pointer to my barrier control pages (one "in" page and
+            one "out" page for each set of barrier buffers, in this
+            order) */
         uint32_t *mcb_barrier_control_me;
 
-        /** Pointer to my parent's barrier control pages (will be NULL
-            for communicator rank 0; odd index pages are "in", even
-            index pages are "out") */
+        /** Pointer to my parent's barrier control pages in the
+            barrier tree (will be NULL for the root, communicator
+            rank 0) */
         uint32_t *mcb_barrier_control_parent;
 
-        /** Pointers to my childrens' barrier control pages (they're
-            contiguous in memory, so we only point to the base -- the
-            number of children is in my entry in the mcb_tree); will
-            be NULL if this process has no children (odd index pages
-            are "in", even index pages are "out") */
-        uint32_t *mcb_barrier_control_children;
+        /** Number of children in the barrier tree */
+        int mcb_barrier_num_children;
+
+        /** Pointers to my childrens' barrier control pages in the
+            barrier tree.  Unlike mcb_tree, this tree follows the
+            sockets: the processes of a socket fan in to the lowest
+            rank of the socket, and only these leaders fan in across
+            sockets. */
+        uint32_t **mcb_barrier_control_children;
 
         /** Number of barriers that we have executed (i.e., which set
             of barrier buffers to use). */
@@ -193,6 +227,11 @@ BEGIN_C_DECLS
         /* Underlying reduce function and module */
 	mca_coll_base_module_reduce_fn_t previous_reduce;
 	mca_coll_base_module_t *previous_reduce_module;
+
+        /* Underlying alltoall function and module, for communicators
+           too large to split a fragment among all the processes */
+	mca_coll_base_module_alltoall_fn_t previous_alltoall;
+	mca_coll_base_module_t *previous_alltoall_module;
     } mca_coll_sm_module_t;
     OBJ_CLASS_DECLARATION(mca_coll_sm_module_t);
     
@@ -314,6 +353,33 @@ BEGIN_C_DECLS
 				   struct ompi_communicator_t *comm,
 				   mca_coll_base_module_t *module);
 
+    /* Single-copy variants, used for blocks of at least
+       sm_single_copy_threshold bytes */
+    int mca_coll_sm_allgather_single_copy(void *sbuf, int scount, 
+                                          struct ompi_datatype_t *sdtype, 
+                                          void *rbuf, int rcount, 
+                                          struct ompi_datatype_t *rdtype, 
+                                          struct ompi_communicator_t *comm,
+                                          mca_coll_sm_module_t *sm_module);
+    int mca_coll_sm_alltoall_single_copy(void *sbuf, int scount, 
+                                         struct ompi_datatype_t *sdtype, 
+                                         void *rbuf, int rcount, 
+                                         struct ompi_datatype_t *rdtype, 
+                                         struct ompi_communicator_t *comm,
+                                         mca_coll_sm_module_t *sm_module);
+    int mca_coll_sm_bcast_single_copy(void *buff, int count, 
+                                      struct ompi_datatype_t *datatype,
+                                      int root, 
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_sm_module_t *sm_module);
+    int mca_coll_sm_gather_single_copy(void *sbuf, int scount, 
+                                       struct ompi_datatype_t *sdtype, 
+                                       void *rbuf, int rcount, 
+                                       struct ompi_datatype_t *rdtype, 
+                                       int root, 
+                                       struct ompi_communicator_t *comm,
+                                       mca_coll_sm_module_t *sm_module);
+
     int mca_coll_sm_ft_event(int state);
     
 /**
@@ -343,14 +409,18 @@ extern uint32_t mca_coll_sm_one;
  * been called)
  */
 #define FLAG_WAIT_FOR_OP(flag, op, label) \
-    SPIN_CONDITION((op) == flag->mcsiuf_operation_count, label)
+    SPIN_CONDITION((op) == (uint32_t) opal_atomic_load_acq_32((volatile int32_t *) \
+                                &(flag)->mcsiuf_operation_count), label)
 
 /**
- * Macro to set an in-use flag with relevant data to claim it
+ * Macro to set an in-use flag with relevant data to claim it (the
+ * operation count is stored last, with release semantics, as it is
+ * what FLAG_WAIT_FOR_OP() waits on)
  */
 #define FLAG_RETAIN(flag, num_procs, op_count) \
     (flag)->mcsiuf_num_procs_using = (num_procs); \
-    (flag)->mcsiuf_operation_count = (op_count)
+    opal_atomic_store_rel_32((volatile int32_t *) &(flag)->mcsiuf_operation_count, \
+                             (int32_t) (op_count))
 
 /**
  * Macro to release an in-use flag from this process
@@ -417,7 +487,7 @@ extern uint32_t mca_coll_sm_one;
         uint32_t volatile *ptr = ((uint32_t*) \
                                   (((char*) index->mcbmi_control) + \
                                    ((rank) * mca_coll_sm_component.sm_control_size))); \
-        SPIN_CONDITION(0 != *ptr, label); \
+        SPIN_CONDITION(0 != opal_atomic_load_acq_32((volatile int32_t *) ptr), label); \
         (value) = *ptr; \
         *ptr = 0; \
     } while (0)
@@ -443,11 +513,60 @@ extern uint32_t mca_coll_sm_one;
                                 (((char*) index->mcbmi_control) + \
                                  (mca_coll_sm_component.sm_control_size * \
                                   (parent_rank)))) + child_rank; \
-        SPIN_CONDITION(0 != *ptr, label); \
+        SPIN_CONDITION(NULL != opal_atomic_load_acq_ptr(ptr), label); \
         (value) = *ptr; \
         *ptr = 0; \
     } while (0)
 
+/**
+ * Macro for the word a process sets in its own control buffer of a
+ * segment when its fragments for the current set of segments are in
+ * place.  Used by the gather-type operations, where every process
+ * posts fragments and any process may read them.
+ */
+#define SEGMENT_READY(index, rank) \
+    (*((size_t volatile *) \
+       (((char*) (index)->mcbmi_control) + \
+        ((rank) * mca_coll_sm_component.sm_control_size))))
+
+/**
+ * Macro to release an in-use flag when every process reads from the
+ * segments.  The flag is retained for size + 1 processes; the last
+ * reader out clears the ready words of the set (see SEGMENT_READY)
+ * before dropping the extra count, so the next user of the set finds
+ * them zeroed.
+ */
+#define FLAG_RELEASE_AND_CLEAR(flag, index, size) \
+    do { \
+        opal_atomic_mb(); \
+        if (1 == opal_atomic_add_32((volatile int32_t *) \
+                                    &(flag)->mcsiuf_num_procs_using, -1)) { \
+            for (i = 0; i < (size); ++i) { \
+                SEGMENT_READY(index, i) = 0; \
+            } \
+            opal_atomic_wmb(); \
+            FLAG_RELEASE(flag); \
+        } \
+    } while (0)
+
+/**
+ * Macro for the single-copy post of a process in a segment (see
+ * mca_coll_sm_single_copy_post_t)
+ */
+#define SINGLE_COPY_POST(index, rank) \
+    ((mca_coll_sm_single_copy_post_t *) \
+     (((char*) (index)->mcbmi_control) + \
+      ((rank) * mca_coll_sm_component.sm_control_size)))
+
+/**
+ * Macro to decide whether blocks of the given size go through the
+ * single-copy path.  The size is the same on every process (the type
+ * signatures must match), so every process decides the same way.
+ */
+#define SINGLE_COPY_ELIGIBLE(bytes) \
+    (mca_coll_sm_component.sm_single_copy && \
+     (bytes) >= (size_t) mca_coll_sm_component.sm_single_copy_threshold)
+
 END_C_DECLS
 
 #endif /* MCA_COLL_SM_EXPORT_H */
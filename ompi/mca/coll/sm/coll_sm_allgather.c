@@ -18,16 +18,35 @@
 
 #include "ompi_config.h"
 
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "opal/datatype/opal_convertor.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
+#include "opal/sys/atomic.h"
 #include "coll_sm.h"
 
 
-/*
- *	allgather
+/**
+ * Shared memory allgather.
  *
- *	Function:	- allgather
- *	Accepts:	- same as MPI_Allgather()
- *	Returns:	- MPI_SUCCESS or error code
+ * Every process packs its fragments into its own slot of the
+ * segments (the slot is local to it, see the memory affinity setup
+ * in the module) and sets the ready word in its control buffer of
+ * the first segment of the set.  Every process then waits for each
+ * peer's ready word and unpacks the peer's fragments straight out of
+ * the peer's slot into the receive buffer.  Peers are read starting
+ * after the own rank so that not everybody pulls from the same slot
+ * at once.
+ *
+ * Rank 0 claims each set of segments for size + 1 users; the last
+ * process to finish reading clears the ready words (see
+ * FLAG_RELEASE_AND_CLEAR).  Messages larger than a set of segments
+ * are pipelined over several sets, one in-use flag each.
  */
 int mca_coll_sm_allgather_intra(void *sbuf, int scount,
                                 struct ompi_datatype_t *sdtype, void *rbuf,
@@ -35,5 +54,176 @@ int mca_coll_sm_allgather_intra(void *sbuf, int scount,
                                 struct ompi_communicator_t *comm,
                                 mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    struct iovec iov;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data;
+    int i, j, ret, rank, size, src;
+    int flag_num, segment_num, first_segment_num, max_segment_num;
+    size_t total_size, max_data, bytes, round_bytes;
+    ptrdiff_t lb, extent;
+    mca_coll_sm_in_use_flag_t *flag;
+    opal_convertor_t send_convertor, *recv_convertors;
+    mca_coll_sm_data_index_t *index;
+
+    /* Lazily enable the module the first time we invoke a collective
+       on it */
+    if (!sm_module->enabled) {
+        if (OMPI_SUCCESS != (ret = ompi_coll_sm_lazy_enable(module, comm))) {
+            return ret;
+        }
+    }
+    data = sm_module->sm_comm_data;
+
+    /* Large blocks are read straight out of the peers' buffers */
+    ompi_datatype_type_size(rdtype, &total_size);
+    if (SINGLE_COPY_ELIGIBLE(total_size * rcount)) {
+        return mca_coll_sm_allgather_single_copy(sbuf, scount, sdtype,
+                                                 rbuf, rcount, rdtype,
+                                                 comm, sm_module);
+    }
+
+    /* Setup some identities */
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+
+    /* My own block goes straight into the receive buffer (unless it
+       is already there) */
+
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = (char*) rbuf + (ptrdiff_t) rank * rcount * extent;
+        scount = rcount;
+        sdtype = rdtype;
+    } else {
+        ret = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                   (char*) rbuf + (ptrdiff_t) rank * rcount * extent,
+                                   rcount, rdtype);
+        if (MPI_SUCCESS != ret) {
+            return ret;
+        }
+    }
+
+    OBJ_CONSTRUCT(&send_convertor, opal_convertor_t);
+    if (OMPI_SUCCESS != 
+        (ret = 
+         opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor,
+                                                  &(sdtype->super),
+                                                  scount, 
+                                                  sbuf,
+                                                  0,
+                                                  &send_convertor))) {
+        OBJ_DESTRUCT(&send_convertor);
+        return ret;
+    }
+    opal_convertor_get_packed_size(&send_convertor, &total_size);
+
+    /* Every process contributes the same amount, so everybody agrees
+       on whether there is anything to move */
+
+    if (1 == size || 0 == total_size) {
+        OBJ_DESTRUCT(&send_convertor);
+        return OMPI_SUCCESS;
+    }
+
+    /* One receive convertor per peer, each pointing at the peer's
+       block of the receive buffer */
+
+    recv_convertors = (opal_convertor_t*) malloc(size * sizeof(opal_convertor_t));
+    if (NULL == recv_convertors) {
+        OBJ_DESTRUCT(&send_convertor);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for (src = 0; src < size; ++src) {
+        OBJ_CONSTRUCT(&recv_convertors[src], opal_convertor_t);
+    }
+    for (src = 0; src < size; ++src) {
+        if (src == rank) {
+            continue;
+        }
+        if (OMPI_SUCCESS != 
+            (ret = 
+             opal_convertor_copy_and_prepare_for_recv(ompi_mpi_local_convertor,
+                                                      &(rdtype->super),
+                                                      rcount, 
+                                                      (char*) rbuf + (ptrdiff_t) src * rcount * extent,
+                                                      0,
+                                                      &recv_convertors[src]))) {
+            goto cleanup;
+        }
+    }
+
+    /* Main loop over the sets of segments */
+
+    bytes = 0;
+    do {
+        flag_num = (data->mcb_operation_count % 
+                    mca_coll_sm_component.sm_comm_num_in_use_flags);
+        FLAG_SETUP(flag_num, flag, data);
+        if (0 == rank) {
+            FLAG_WAIT_FOR_IDLE(flag, allgather_root_label);
+            FLAG_RETAIN(flag, size + 1, data->mcb_operation_count);
+        } else {
+            FLAG_WAIT_FOR_OP(flag, data->mcb_operation_count, allgather_nonroot_label);
+        }
+        ++data->mcb_operation_count;
+
+        first_segment_num = 
+            flag_num * mca_coll_sm_component.sm_segs_per_inuse_flag;
+        max_segment_num = 
+            (flag_num + 1) * mca_coll_sm_component.sm_segs_per_inuse_flag;
+
+        /* Copy my fragments into my slot of each segment in the set */
+
+        round_bytes = bytes;
+        segment_num = first_segment_num;
+        do {
+            index = &(data->mcb_data_index[segment_num]);
+            max_data = mca_coll_sm_component.sm_fragment_size;
+            COPY_FRAGMENT_IN(send_convertor, index, rank, iov, max_data);
+            bytes += max_data;
+            ++segment_num;
+        } while (bytes < total_size && segment_num < max_segment_num);
+
+        /* Wait for the writes to absolutely complete, then tell
+           everybody that they are there */
+        opal_atomic_wmb();
+        index = &(data->mcb_data_index[first_segment_num]);
+        SEGMENT_READY(index, rank) = 1;
+
+        /* Copy out everybody else's fragments of this set */
+
+        for (j = 1; j < size; ++j) {
+            src = (rank + j) % size;
+            SPIN_CONDITION(0 != SEGMENT_READY(index, src), allgather_ready_label);
+            opal_atomic_rmb();
+
+            max_data = round_bytes;
+            segment_num = first_segment_num;
+            do {
+                size_t frag = total_size - max_data;
+                if (frag > (size_t) mca_coll_sm_component.sm_fragment_size) {
+                    frag = mca_coll_sm_component.sm_fragment_size;
+                }
+                COPY_FRAGMENT_OUT(recv_convertors[src], src,
+                                  &(data->mcb_data_index[segment_num]), iov, frag);
+                max_data += frag;
+                ++segment_num;
+            } while (max_data < total_size && segment_num < max_segment_num);
+        }
+
+        /* We're finished with this set of segments */
+        FLAG_RELEASE_AND_CLEAR(flag, index, size);
+    } while (bytes < total_size);
+
+    ret = OMPI_SUCCESS;
+
+ cleanup:
+    for (src = 0; src < size; ++src) {
+        OBJ_DESTRUCT(&recv_convertors[src]);
+    }
+    free(recv_convertors);
+    OBJ_DESTRUCT(&send_convertor);
+
+    return ret;
 }
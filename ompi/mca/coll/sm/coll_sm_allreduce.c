@@ -20,16 +20,35 @@
 
 #include "ompi_config.h"
 
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
 #include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
 #include "coll_sm.h"
 
 
+/*
+ * Local functions
+ */
+static int allreduce_slices(void *sbuf, void *rbuf, int count,
+                            struct ompi_datatype_t *dtype,
+                            struct ompi_op_t *op,
+                            struct ompi_communicator_t *comm,
+                            mca_coll_base_module_t *module);
+
+
 /**
  * Shared memory allreduce.
  *
- * For the moment, all we're doing is a reduce to root==0 and then a
- * broadcast.  It is possible that we'll do something better someday.
+ * Messages of at least one fragment of a contiguous datatype are
+ * reduced by all the processes together (see allreduce_slices()).
+ * Otherwise, all we're doing is a reduce to root==0 and then a
+ * broadcast.
  */
 int mca_coll_sm_allreduce_intra(void *sbuf, void *rbuf, int count,
                                 struct ompi_datatype_t *dtype, 
@@ -38,6 +57,28 @@ int mca_coll_sm_allreduce_intra(void *sbuf, void *rbuf, int count,
                                 mca_coll_base_module_t *module)
 {
     int ret;
+    size_t ddt_size;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+
+    /* The arrival counters of the slices live after the in-use flag,
+       in the same control line */
+    ompi_datatype_type_size(dtype, &ddt_size);
+    if (ddt_size * count >= (size_t)mca_coll_sm_component.sm_fragment_size &&
+        ddt_size <= (size_t)mca_coll_sm_component.sm_fragment_size &&
+        ompi_datatype_is_contiguous_memory_layout(dtype, count) &&
+        sizeof(mca_coll_sm_in_use_flag_t) +
+        2 * mca_coll_sm_component.sm_segs_per_inuse_flag * sizeof(int32_t) <=
+        (size_t)mca_coll_sm_component.sm_control_size) {
+        /* Lazily enable the module the first time we invoke a
+           collective on it */
+        if (!sm_module->enabled) {
+            if (OMPI_SUCCESS != 
+                (ret = ompi_coll_sm_lazy_enable(module, comm))) {
+                return ret;
+            }
+        }
+        return allreduce_slices(sbuf, rbuf, count, dtype, op, comm, module);
+    }
 
     /* Note that only the root can pass MPI_IN_PLACE to MPI_REDUCE, so
        have slightly different logic for that case. */
@@ -58,3 +99,145 @@ int mca_coll_sm_allreduce_intra(void *sbuf, void *rbuf, int count,
     return (ret == OMPI_SUCCESS) ?
         mca_coll_sm_bcast_intra(rbuf, count, dtype, 0, comm, module) : ret;
 }
+
+
+/**
+ * Reduce-scatter style shared memory allreduce.
+ *
+ * For each fragment, every process copies its operand in its part of
+ * the shared segment.  Each process then reduces its own slice of the
+ * fragment (1/size of it) from the operands of all the processes, in
+ * the same order as the reduce (from process (size-1) to 0), and
+ * writes the result back into its slice of its part of the segment.
+ * Finally every process copies the slices reduced by the others.
+ * This way the reduction work and the memory traffic are spread over
+ * all the processes instead of being done by the root alone, and the
+ * result of each slice is written by the process (and in the memory)
+ * that reduced it.
+ *
+ * Two counters per segment, right after the in-use flag of the set of
+ * segments, tell when all the operands and then all the results are
+ * in the segment.  They are reset by process 0 when it claims the set
+ * of segments, i.e., once every process is done with the previous
+ * operation.
+ */
+static int allreduce_slices(void *sbuf, void *rbuf, int count,
+                            struct ompi_datatype_t *dtype,
+                            struct ompi_op_t *op,
+                            struct ompi_communicator_t *comm,
+                            mca_coll_base_module_t *module)
+{
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data = sm_module->sm_comm_data;
+    int rank, size, peer, seg, flag_num, segment_num, max_segment_num;
+    size_t ddt_size, segment_ddt_count, count_left, n, first, len;
+    size_t fragment_size = mca_coll_sm_component.sm_fragment_size;
+    ptrdiff_t lb, extent;
+    char *src, *target, *shmem;
+    mca_coll_sm_in_use_flag_t *flag;
+    mca_coll_sm_data_index_t *index;
+    int32_t volatile *arrived;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    ompi_datatype_type_size(dtype, &ddt_size);
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    segment_ddt_count = fragment_size / ddt_size;
+    count_left = (size_t)count;
+
+    /* The operand is copied to shmem before the result of the
+       fragment is written to rbuf, so MPI_IN_PLACE needs no temporary
+       buffer */
+    src = (MPI_IN_PLACE == sbuf) ? (char*) rbuf : (char*) sbuf;
+    target = (char*) rbuf;
+
+    do {
+        flag_num = (data->mcb_operation_count % 
+                    mca_coll_sm_component.sm_comm_num_in_use_flags);
+        FLAG_SETUP(flag_num, flag, data);
+        arrived = (int32_t volatile*) (flag + 1);
+        if (0 == rank) {
+            FLAG_WAIT_FOR_IDLE(flag, allreduce_root_flag_label);
+            memset((void*) arrived, 0, 2 * sizeof(int32_t) *
+                   mca_coll_sm_component.sm_segs_per_inuse_flag);
+            opal_atomic_wmb();
+            FLAG_RETAIN(flag, size, data->mcb_operation_count);
+        } else {
+            FLAG_WAIT_FOR_OP(flag, data->mcb_operation_count, allreduce_nonroot_flag_label);
+            opal_atomic_rmb();
+        }
+        ++data->mcb_operation_count;
+
+        /* Loop over all the segments in this set */
+
+        segment_num = 
+            flag_num * mca_coll_sm_component.sm_segs_per_inuse_flag;
+        max_segment_num = 
+            (flag_num + 1) * mca_coll_sm_component.sm_segs_per_inuse_flag;
+        seg = 0;
+        do {
+            index = &(data->mcb_data_index[segment_num]);
+            shmem = index->mcbmi_data;
+            n = (count_left < segment_ddt_count) ? count_left : segment_ddt_count;
+            /* My slice of the fragment */
+            len = n / size;
+            first = len * rank + (((size_t)rank < n % size) ? (size_t)rank : n % size);
+            if ((size_t)rank < n % size) {
+                ++len;
+            }
+
+            /* Put my operand in shmem and wait for the others */
+            memcpy(shmem + rank * fragment_size, src, n * ddt_size);
+            opal_atomic_wmb();
+            opal_atomic_add_32((int32_t*) &arrived[2 * seg], 1);
+            SPIN_CONDITION(size == arrived[2 * seg], allreduce_operands_label);
+            opal_atomic_rmb();
+
+            /* Reduce my slice, and publish it */
+            if (0 < len) {
+                memcpy(target + first * extent,
+                       shmem + (size - 1) * fragment_size + first * ddt_size,
+                       len * ddt_size);
+                for (peer = size - 2; peer >= 0; --peer) {
+                    ompi_op_reduce(op, shmem + peer * fragment_size + first * ddt_size,
+                                   target + first * extent, len, dtype);
+                }
+                memcpy(shmem + rank * fragment_size + first * ddt_size,
+                       target + first * extent, len * ddt_size);
+            }
+            opal_atomic_wmb();
+            opal_atomic_add_32((int32_t*) &arrived[2 * seg + 1], 1);
+            SPIN_CONDITION(size == arrived[2 * seg + 1], allreduce_results_label);
+            opal_atomic_rmb();
+
+            /* Get the slices of the others */
+            for (peer = 0; peer < size; ++peer) {
+                if (peer == rank) {
+                    continue;
+                }
+                len = n / size;
+                first = len * peer + (((size_t)peer < n % size) ? (size_t)peer : n % size);
+                if ((size_t)peer < n % size) {
+                    ++len;
+                }
+                if (0 < len) {
+                    memcpy(target + first * extent,
+                           shmem + peer * fragment_size + first * ddt_size,
+                           len * ddt_size);
+                }
+            }
+
+            count_left -= n;
+            src += n * extent;
+            target += n * extent;
+            ++segment_num;
+            ++seg;
+        } while (count_left > 0 && segment_num < max_segment_num);
+
+        /* We're finished with this set of segments */
+        FLAG_RELEASE(flag);
+    } while (count_left > 0);
+
+    return OMPI_SUCCESS;
+}
@@ -18,22 +18,229 @@
 
 #include "ompi_config.h"
 
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/runtime/opal.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
+#include "opal/sys/atomic.h"
 #include "coll_sm.h"
 
 
-/*
- *	alltoall_intra
+/**
+ * Shared memory alltoall.
  *
- *	Function:	- MPI_Alltoall 
- *	Accepts:	- same as MPI_Alltoall()
- *	Returns:	- MPI_SUCCESS or an MPI error code
+ * Each process's slot of a segment is cut into size sub-slots, one
+ * per destination, each a whole number of cache lines so that no two
+ * destinations share a line.  Every process packs its fragment for
+ * each destination into the matching sub-slot of its own slot, sets
+ * the ready word in its control buffer of the first segment of the
+ * set, and then unpacks the fragments addressed to it out of every
+ * peer's slot.  The handshake on the sets of segments is the same as
+ * in allgather: rank 0 claims each set for size + 1 users and the
+ * last reader clears the ready words.
+ *
+ * When the communicator is too large for a cache line per
+ * destination (or for MPI_IN_PLACE), the previous alltoall module is
+ * used instead.
  */
 int mca_coll_sm_alltoall_intra(void *sbuf, int scount,
                                struct ompi_datatype_t *sdtype, void *rbuf,
                                int rcount, struct ompi_datatype_t *rdtype,
                                struct ompi_communicator_t *comm,
-                                mca_coll_base_module_t *module)
+                               mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    struct iovec iov;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data;
+    int i, j, ret, rank, size, peer;
+    int flag_num, segment_num, first_segment_num, max_segment_num;
+    size_t total_size, max_data, bytes, round_bytes, sub_size, frag;
+    ptrdiff_t lb, sextent, rextent;
+    mca_coll_sm_in_use_flag_t *flag;
+    opal_convertor_t *send_convertors, *recv_convertors;
+    mca_coll_sm_data_index_t *index;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    /* Size of the per-destination sub-slot.  This only depends on
+       MCA parameters and the communicator size, so every process
+       takes the same branch. */
+
+    sub_size = mca_coll_sm_component.sm_fragment_size / size;
+    sub_size -= sub_size % opal_cache_line_size;
+    ompi_datatype_type_size(sdtype, &total_size);
+    total_size *= scount;
+    if (MPI_IN_PLACE == sbuf ||
+        (0 == sub_size && !SINGLE_COPY_ELIGIBLE(total_size))) {
+        return sm_module->previous_alltoall(sbuf, scount, sdtype,
+                                            rbuf, rcount, rdtype, comm,
+                                            sm_module->previous_alltoall_module);
+    }
+
+    /* Lazily enable the module the first time we invoke a collective
+       on it */
+    if (!sm_module->enabled) {
+        if (OMPI_SUCCESS != (ret = ompi_coll_sm_lazy_enable(module, comm))) {
+            return ret;
+        }
+    }
+    data = sm_module->sm_comm_data;
+
+    /* Large blocks are read straight out of the peers' buffers */
+    if (SINGLE_COPY_ELIGIBLE(total_size)) {
+        return mca_coll_sm_alltoall_single_copy(sbuf, scount, sdtype,
+                                                rbuf, rcount, rdtype,
+                                                comm, sm_module);
+    }
+
+    ompi_datatype_get_extent(sdtype, &lb, &sextent);
+    ompi_datatype_get_extent(rdtype, &lb, &rextent);
+
+    /* My own block goes straight into the receive buffer */
+
+    ret = ompi_datatype_sndrcv((char*) sbuf + (ptrdiff_t) rank * scount * sextent,
+                               scount, sdtype,
+                               (char*) rbuf + (ptrdiff_t) rank * rcount * rextent,
+                               rcount, rdtype);
+    if (MPI_SUCCESS != ret || 1 == size) {
+        return ret;
+    }
+
+    /* One send convertor per destination and one receive convertor
+       per source */
+
+    send_convertors = (opal_convertor_t*) malloc(2 * size * sizeof(opal_convertor_t));
+    if (NULL == send_convertors) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    recv_convertors = send_convertors + size;
+    for (peer = 0; peer < 2 * size; ++peer) {
+        OBJ_CONSTRUCT(&send_convertors[peer], opal_convertor_t);
+    }
+    for (peer = 0; peer < size; ++peer) {
+        if (peer == rank) {
+            continue;
+        }
+        if (OMPI_SUCCESS != 
+            (ret = 
+             opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor,
+                                                      &(sdtype->super),
+                                                      scount, 
+                                                      (char*) sbuf + (ptrdiff_t) peer * scount * sextent,
+                                                      0,
+                                                      &send_convertors[peer])) ||
+            OMPI_SUCCESS != 
+            (ret = 
+             opal_convertor_copy_and_prepare_for_recv(ompi_mpi_local_convertor,
+                                                      &(rdtype->super),
+                                                      rcount, 
+                                                      (char*) rbuf + (ptrdiff_t) peer * rcount * rextent,
+                                                      0,
+                                                      &recv_convertors[peer]))) {
+            goto cleanup;
+        }
+    }
+
+    /* Every pair exchanges the same amount */
+
+    opal_convertor_get_packed_size(&send_convertors[(rank + 1) % size], &total_size);
+    ret = OMPI_SUCCESS;
+    if (0 == total_size) {
+        goto cleanup;
+    }
+
+    /* Main loop over the sets of segments */
+
+    bytes = 0;
+    do {
+        flag_num = (data->mcb_operation_count % 
+                    mca_coll_sm_component.sm_comm_num_in_use_flags);
+        FLAG_SETUP(flag_num, flag, data);
+        if (0 == rank) {
+            FLAG_WAIT_FOR_IDLE(flag, alltoall_root_label);
+            FLAG_RETAIN(flag, size + 1, data->mcb_operation_count);
+        } else {
+            FLAG_WAIT_FOR_OP(flag, data->mcb_operation_count, alltoall_nonroot_label);
+        }
+        ++data->mcb_operation_count;
+
+        first_segment_num = 
+            flag_num * mca_coll_sm_component.sm_segs_per_inuse_flag;
+        max_segment_num = 
+            (flag_num + 1) * mca_coll_sm_component.sm_segs_per_inuse_flag;
+
+        /* Copy my fragment for each destination into its sub-slot of
+           my slot in each segment of the set */
+
+        round_bytes = bytes;
+        segment_num = first_segment_num;
+        do {
+            index = &(data->mcb_data_index[segment_num]);
+            frag = total_size - bytes;
+            if (frag > sub_size) {
+                frag = sub_size;
+            }
+            for (j = 1; j < size; ++j) {
+                peer = (rank + j) % size;
+                iov.iov_base = index->mcbmi_data + 
+                    (rank * mca_coll_sm_component.sm_fragment_size) + 
+                    (peer * sub_size);
+                iov.iov_len = max_data = frag;
+                opal_convertor_pack(&send_convertors[peer], &iov,
+                                    &mca_coll_sm_one, &max_data);
+            }
+            bytes += frag;
+            ++segment_num;
+        } while (bytes < total_size && segment_num < max_segment_num);
+
+        /* Wait for the writes to absolutely complete, then tell
+           everybody that they are there */
+        opal_atomic_wmb();
+        index = &(data->mcb_data_index[first_segment_num]);
+        SEGMENT_READY(index, rank) = 1;
+
+        /* Copy out the fragments addressed to me from everybody
+           else's slot */
+
+        for (j = 1; j < size; ++j) {
+            peer = (rank + j) % size;
+            SPIN_CONDITION(0 != SEGMENT_READY(index, peer), alltoall_ready_label);
+            opal_atomic_rmb();
+
+            for (segment_num = first_segment_num; 
+                 segment_num < max_segment_num && 
+                     round_bytes + (segment_num - first_segment_num) * sub_size < total_size;
+                 ++segment_num) {
+                frag = total_size - round_bytes - 
+                    (segment_num - first_segment_num) * sub_size;
+                if (frag > sub_size) {
+                    frag = sub_size;
+                }
+                iov.iov_base = data->mcb_data_index[segment_num].mcbmi_data + 
+                    (peer * mca_coll_sm_component.sm_fragment_size) + 
+                    (rank * sub_size);
+                iov.iov_len = max_data = frag;
+                opal_convertor_unpack(&recv_convertors[peer], &iov,
+                                      &mca_coll_sm_one, &max_data);
+            }
+        }
+
+        /* We're finished with this set of segments */
+        FLAG_RELEASE_AND_CLEAR(flag, index, size);
+    } while (bytes < total_size);
+
+ cleanup:
+    for (peer = 0; peer < 2 * size; ++peer) {
+        OBJ_DESTRUCT(&send_convertors[peer]);
+    }
+    free(send_convertors);
+
+    return ret;
 }
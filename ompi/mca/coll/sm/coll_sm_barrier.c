@@ -45,6 +45,11 @@
  * buffer.  Once this happens, the process writes a "1" in each of its
  * children's "out" buffers, and returns.
  *
+ * Each buffer has its own control page (so its own cache lines), local
+ * to the process that polls it, and the tree follows the sockets (see
+ * mcb_barrier_control_children) so that few flags are written across
+ * sockets.
+ *
  * There's corner cases, of course, such as the root that has no
  * parent, and the leaves that have no children.  But that's the
  * general idea.
@@ -52,11 +57,11 @@
 int mca_coll_sm_barrier_intra(struct ompi_communicator_t *comm,
                               mca_coll_base_module_t *module)
 {
-    int rank, buffer_set;
+    int buffer_set;
     mca_coll_sm_comm_t *data;
     uint32_t i, num_children;
-    volatile uint32_t *me_in, *me_out, *parent, *children = NULL;
-    int uint_control_size;
+    volatile uint32_t *me_in, *me_out, *parent, *child;
+    size_t control_size = mca_coll_sm_component.sm_control_size;
     mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
 
     /* Lazily enable the module the first time we invoke a collective
@@ -68,23 +73,16 @@ int mca_coll_sm_barrier_intra(struct ompi_communicator_t *comm,
         }
     }
 
-    uint_control_size = 
-        mca_coll_sm_component.sm_control_size / sizeof(uint32_t);
     data = sm_module->sm_comm_data;
-    rank = ompi_comm_rank(comm);
-    num_children = data->mcb_tree[rank].mcstn_num_children;
+    num_children = data->mcb_barrier_num_children;
     buffer_set = ((data->mcb_barrier_count++) % 2) * 2;
-    me_in = &data->mcb_barrier_control_me[buffer_set];
-    me_out = me_in + uint_control_size;
-    me_out = (uint32_t*)
-        (((char*) me_in) + mca_coll_sm_component.sm_control_size);
+    me_in = (uint32_t*)
+        (((char*) data->mcb_barrier_control_me) + buffer_set * control_size);
+    me_out = (uint32_t*) (((char*) me_in) + control_size);
 
     /* Wait for my children to write to my *in* buffer */
 
     if (0 != num_children) {
-        /* Get children *out* buffer */
-        children = data->mcb_barrier_control_children + buffer_set + 
-            uint_control_size;
         SPIN_CONDITION(*me_in == num_children, exit_label1);
         *me_in = 0;
     }
@@ -98,19 +96,23 @@ int mca_coll_sm_barrier_intra(struct ompi_communicator_t *comm,
        process, and it is only changed *once* by an external
        process) */
 
-    if (0 != rank) {
+    if (NULL != data->mcb_barrier_control_parent) {
         /* Get parent *in* buffer */
-        parent = &data->mcb_barrier_control_parent[buffer_set];
+        parent = (uint32_t*)
+            (((char*) data->mcb_barrier_control_parent) + buffer_set * control_size);
         opal_atomic_add(parent, 1);
 
         SPIN_CONDITION(0 != *me_out, exit_label2);
         *me_out = 0;
     }
 
-    /* Send to my children */
+    /* Send to my children (their *out* buffer) */
 
     for (i = 0; i < num_children; ++i) {
-        children[i * uint_control_size * 4] = 1;
+        child = (uint32_t*)
+            (((char*) data->mcb_barrier_control_children[i]) +
+             (buffer_set + 1) * control_size);
+        *child = 1;
     }
 
     /* All done!  End state of the control segment:
@@ -81,6 +81,13 @@ int mca_coll_sm_bcast_intra(void *buff, int count,
     }
     data = sm_module->sm_comm_data;
 
+    /* Large messages are read straight out of the root's buffer */
+    ompi_datatype_type_size(datatype, &total_size);
+    if (SINGLE_COPY_ELIGIBLE(total_size * count)) {
+        return mca_coll_sm_bcast_single_copy(buff, count, datatype, root,
+                                             comm, sm_module);
+    }
+
     /* Setup some identities */
 
     rank = ompi_comm_rank(comm);
@@ -27,6 +27,9 @@
 
 #include "ompi_config.h"
 
+#include <stdio.h>
+
+#include "opal/runtime/opal.h"
 #include "opal/util/show_help.h"
 #include "ompi/constants.h"
 #include "ompi/mca/coll/coll.h"
@@ -128,10 +131,35 @@ static int sm_close(void)
     return OMPI_SUCCESS;
 }
 
+#if OMPI_COLL_SM_HAVE_CMA
+/* process_vm_readv needs ptrace rights on the peer: PR_SET_PTRACER
+ * (see mca_coll_sm_init_query) covers the yama "restricted" scope,
+ * higher scopes forbid it */
+static bool sm_cma_usable(void)
+{
+    FILE *fh = fopen("/proc/sys/kernel/yama/ptrace_scope", "r");
+    int scope = 0;
+
+    if (NULL != fh) {
+        if (1 != fscanf(fh, "%d", &scope)) {
+            scope = 0;
+        }
+        fclose(fh);
+    }
+
+    return scope < 2;
+}
+#endif
+
 static int sm_verify_mca_variables(void)
 {
     mca_coll_sm_component_t *cs = &mca_coll_sm_component;
 
+    /* The flags of different processes must not share a cache line */
+    if (cs->sm_control_size < opal_cache_line_size) {
+        cs->sm_control_size = opal_cache_line_size;
+    }
+
     if (0 != (cs->sm_fragment_size % cs->sm_control_size)) {
         cs->sm_fragment_size += cs->sm_control_size - 
             (cs->sm_fragment_size % cs->sm_control_size);
@@ -169,6 +197,13 @@ static int sm_verify_mca_variables(void)
         (cs->sm_comm_num_segments * (cs->sm_info_comm_size * cs->sm_control_size * 2)) +
         (cs->sm_comm_num_segments * (cs->sm_info_comm_size * cs->sm_fragment_size)));
 
+    cs->sm_single_copy = false;
+#if OMPI_COLL_SM_HAVE_CMA
+    if (cs->sm_single_copy_threshold > 0) {
+        cs->sm_single_copy = sm_cma_usable();
+    }
+#endif
+
     return OMPI_SUCCESS;
 }
 
@@ -230,6 +265,14 @@ static int sm_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &cs->sm_tree_degree);
 
+    cs->sm_single_copy_threshold = 65536;
+    (void) mca_base_component_var_register(c, "single_copy_threshold",
+                                           "Smallest per-process block (in bytes) that bcast, gather, allgather and alltoall copy directly between the processes' buffers with process_vm_readv instead of through shared memory fragments (0 = never; ignored when CMA is not available)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &cs->sm_single_copy_threshold);
+
     /* INFO: Calculate how much space we need in the per-communicator
        shmem data segment.  This formula taken directly from
        coll_sm_module.c. */
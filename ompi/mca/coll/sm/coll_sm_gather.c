@@ -18,16 +18,29 @@
 
 #include "ompi_config.h"
 
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "opal/datatype/opal_convertor.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
+#include "opal/sys/atomic.h"
 #include "coll_sm.h"
 
 
-/*                                                                             
- *      gather
+/**
+ * Shared memory gather.
  *
- *      Function:       - shared memory gather
- *      Accepts:        - same as MPI_Gather()
- *      Returns:        - MPI_SUCCESS or error code
+ * The root claims each set of segments.  Every non-root packs its
+ * fragments into its own slot of the segments, sets the ready word in
+ * its control buffer of the first segment of the set, and is done
+ * with the set.  The root waits for each peer's ready word, unpacks
+ * the peer's fragments straight out of the peer's slot into the
+ * receive buffer, and clears the ready word.  Messages larger than a
+ * set of segments are pipelined over several sets.
  */
 int mca_coll_sm_gather_intra(void *sbuf, int scount,
                              struct ompi_datatype_t *sdtype, void *rbuf,
@@ -35,5 +48,206 @@ int mca_coll_sm_gather_intra(void *sbuf, int scount,
                              int root, struct ompi_communicator_t *comm,
                              mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    struct iovec iov;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data;
+    int j, ret, rank, size, src;
+    int flag_num, segment_num, first_segment_num, max_segment_num;
+    size_t total_size, max_data, bytes, round_bytes;
+    ptrdiff_t lb, extent;
+    mca_coll_sm_in_use_flag_t *flag;
+    opal_convertor_t convertor, *recv_convertors;
+    mca_coll_sm_data_index_t *index;
+
+    /* Lazily enable the module the first time we invoke a collective
+       on it */
+    if (!sm_module->enabled) {
+        if (OMPI_SUCCESS != (ret = ompi_coll_sm_lazy_enable(module, comm))) {
+            return ret;
+        }
+    }
+    data = sm_module->sm_comm_data;
+
+    /* Setup some identities */
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    /* Large blocks are read by the root straight out of the peers'
+       buffers */
+    if (root == rank) {
+        ompi_datatype_type_size(rdtype, &total_size);
+        total_size *= rcount;
+    } else {
+        ompi_datatype_type_size(sdtype, &total_size);
+        total_size *= scount;
+    }
+    if (SINGLE_COPY_ELIGIBLE(total_size)) {
+        return mca_coll_sm_gather_single_copy(sbuf, scount, sdtype,
+                                              rbuf, rcount, rdtype, root,
+                                              comm, sm_module);
+    }
+
+    /*********************************************************************
+     * Non-root
+     *********************************************************************/
+
+    if (root != rank) {
+        OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+        if (OMPI_SUCCESS != 
+            (ret = 
+             opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor,
+                                                      &(sdtype->super),
+                                                      scount, 
+                                                      sbuf,
+                                                      0,
+                                                      &convertor))) {
+            OBJ_DESTRUCT(&convertor);
+            return ret;
+        }
+        opal_convertor_get_packed_size(&convertor, &total_size);
+
+        bytes = 0;
+        while (bytes < total_size) {
+            flag_num = (data->mcb_operation_count % 
+                        mca_coll_sm_component.sm_comm_num_in_use_flags);
+
+            /* Wait for the root to mark this set of segments as
+               ours */
+            FLAG_SETUP(flag_num, flag, data);
+            FLAG_WAIT_FOR_OP(flag, data->mcb_operation_count, gather_nonroot_label);
+            ++data->mcb_operation_count;
+
+            first_segment_num = 
+                flag_num * mca_coll_sm_component.sm_segs_per_inuse_flag;
+            max_segment_num = 
+                (flag_num + 1) * mca_coll_sm_component.sm_segs_per_inuse_flag;
+
+            /* Copy my fragments into my slot of each segment */
+
+            segment_num = first_segment_num;
+            do {
+                index = &(data->mcb_data_index[segment_num]);
+                max_data = mca_coll_sm_component.sm_fragment_size;
+                COPY_FRAGMENT_IN(convertor, index, rank, iov, max_data);
+                bytes += max_data;
+                ++segment_num;
+            } while (bytes < total_size && segment_num < max_segment_num);
+
+            /* Wait for the writes to absolutely complete, then tell
+               the root that they are there */
+            opal_atomic_wmb();
+            SEGMENT_READY(&(data->mcb_data_index[first_segment_num]), rank) = 1;
+
+            /* The root holds the set until it has read everything */
+            FLAG_RELEASE(flag);
+        }
+
+        OBJ_DESTRUCT(&convertor);
+        return OMPI_SUCCESS;
+    }
+
+    /*********************************************************************
+     * Root
+     *********************************************************************/
+
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+
+    /* My own block goes straight into the receive buffer */
+
+    if (MPI_IN_PLACE != sbuf) {
+        ret = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                   (char*) rbuf + (ptrdiff_t) rank * rcount * extent,
+                                   rcount, rdtype);
+        if (MPI_SUCCESS != ret) {
+            return ret;
+        }
+    }
+
+    if (1 == size) {
+        return OMPI_SUCCESS;
+    }
+
+    /* One receive convertor per peer, each pointing at the peer's
+       block of the receive buffer */
+
+    recv_convertors = (opal_convertor_t*) malloc(size * sizeof(opal_convertor_t));
+    if (NULL == recv_convertors) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for (src = 0; src < size; ++src) {
+        OBJ_CONSTRUCT(&recv_convertors[src], opal_convertor_t);
+    }
+    for (src = 0; src < size; ++src) {
+        if (src == rank) {
+            continue;
+        }
+        if (OMPI_SUCCESS != 
+            (ret = 
+             opal_convertor_copy_and_prepare_for_recv(ompi_mpi_local_convertor,
+                                                      &(rdtype->super),
+                                                      rcount, 
+                                                      (char*) rbuf + (ptrdiff_t) src * rcount * extent,
+                                                      0,
+                                                      &recv_convertors[src]))) {
+            goto cleanup;
+        }
+    }
+    /* Every peer sends the same amount */
+    opal_convertor_get_packed_size(&recv_convertors[(rank + 1) % size], &total_size);
+
+    bytes = 0;
+    while (bytes < total_size) {
+        flag_num = (data->mcb_operation_count % 
+                    mca_coll_sm_component.sm_comm_num_in_use_flags);
+        FLAG_SETUP(flag_num, flag, data);
+        FLAG_WAIT_FOR_IDLE(flag, gather_root_label);
+        FLAG_RETAIN(flag, size, data->mcb_operation_count);
+        ++data->mcb_operation_count;
+
+        first_segment_num = 
+            flag_num * mca_coll_sm_component.sm_segs_per_inuse_flag;
+        max_segment_num = 
+            (flag_num + 1) * mca_coll_sm_component.sm_segs_per_inuse_flag;
+        index = &(data->mcb_data_index[first_segment_num]);
+
+        /* Copy out everybody's fragments of this set, in the order
+           they show up */
+
+        round_bytes = bytes;
+        for (j = 1; j < size; ++j) {
+            src = (rank + j) % size;
+            SPIN_CONDITION(0 != SEGMENT_READY(index, src), gather_ready_label);
+            opal_atomic_rmb();
+
+            bytes = round_bytes;
+            segment_num = first_segment_num;
+            do {
+                max_data = total_size - bytes;
+                if (max_data > (size_t) mca_coll_sm_component.sm_fragment_size) {
+                    max_data = mca_coll_sm_component.sm_fragment_size;
+                }
+                COPY_FRAGMENT_OUT(recv_convertors[src], src,
+                                  &(data->mcb_data_index[segment_num]), iov, max_data);
+                bytes += max_data;
+                ++segment_num;
+            } while (bytes < total_size && segment_num < max_segment_num);
+
+            SEGMENT_READY(index, src) = 0;
+        }
+
+        /* We're finished with this set of segments */
+        opal_atomic_mb();
+        FLAG_RELEASE(flag);
+    }
+
+    ret = OMPI_SUCCESS;
+
+ cleanup:
+    for (src = 0; src < size; ++src) {
+        OBJ_DESTRUCT(&recv_convertors[src]);
+    }
+    free(recv_convertors);
+
+    return ret;
 }
@@ -45,6 +45,9 @@
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif  /* HAVE_UNISTD_H */
+#ifdef HAVE_SYS_PRCTL_H
+#include <sys/prctl.h>
+#endif  /* HAVE_SYS_PRCTL_H */
 
 #include "mpi.h"
 #include "opal_stdint.h"
@@ -74,6 +77,7 @@ static int sm_module_enable(mca_coll_base_module_t *module,
 static bool have_local_peers(ompi_group_t *group, size_t size);
 static int bootstrap_comm(ompi_communicator_t *comm,
                           mca_coll_sm_module_t *module);
+static int barrier_tree_parents(ompi_communicator_t *comm, int *parents);
 
 /*
  * Module constructor
@@ -84,6 +88,8 @@ static void mca_coll_sm_module_construct(mca_coll_sm_module_t *module)
     module->sm_comm_data = NULL;
     module->previous_reduce = NULL;
     module->previous_reduce_module = NULL;
+    module->previous_alltoall = NULL;
+    module->previous_alltoall_module = NULL;
 }
 
 /*
@@ -107,6 +113,9 @@ static void mca_coll_sm_module_destruct(mca_coll_sm_module_t *module)
     if (NULL != module->previous_reduce_module) {
         OBJ_RELEASE(module->previous_reduce_module);
     }
+    if (NULL != module->previous_alltoall_module) {
+        OBJ_RELEASE(module->previous_alltoall_module);
+    }
 
     module->enabled = false;
 }
@@ -130,6 +139,13 @@ int mca_coll_sm_init_query(bool enable_progress_threads,
     if (NULL == ompi_process_info.job_session_dir) {
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
+#if defined(PR_SET_PTRACER) && defined(PR_SET_PTRACER_ANY)
+    /* allow the local peers to process_vm_readv our buffers */
+    if (mca_coll_sm_component.sm_single_copy) {
+        (void) prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+    }
+#endif
+
     /* Don't do much here because we don't really want to allocate any
        shared memory until this component is selected to be used. */
     opal_output_verbose(10, ompi_coll_base_framework.framework_output,
@@ -175,16 +191,16 @@ mca_coll_sm_comm_query(struct ompi_communicator_t *comm, int *priority)
     /* All is good -- return a module */
     sm_module->super.coll_module_enable = sm_module_enable;
     sm_module->super.ft_event        = mca_coll_sm_ft_event;
-    sm_module->super.coll_allgather  = NULL;
+    sm_module->super.coll_allgather  = mca_coll_sm_allgather_intra;
     sm_module->super.coll_allgatherv = NULL;
     sm_module->super.coll_allreduce  = mca_coll_sm_allreduce_intra;
-    sm_module->super.coll_alltoall   = NULL;
+    sm_module->super.coll_alltoall   = mca_coll_sm_alltoall_intra;
     sm_module->super.coll_alltoallv  = NULL;
     sm_module->super.coll_alltoallw  = NULL;
     sm_module->super.coll_barrier    = mca_coll_sm_barrier_intra;
     sm_module->super.coll_bcast      = mca_coll_sm_bcast_intra;
     sm_module->super.coll_exscan     = NULL;
-    sm_module->super.coll_gather     = NULL;
+    sm_module->super.coll_gather     = mca_coll_sm_gather_intra;
     sm_module->super.coll_gatherv    = NULL;
     sm_module->super.coll_reduce     = mca_coll_sm_reduce_intra;
     sm_module->super.coll_reduce_scatter = NULL;
@@ -205,6 +221,21 @@ mca_coll_sm_comm_query(struct ompi_communicator_t *comm, int *priority)
 static int sm_module_enable(mca_coll_base_module_t *module,
                             struct ompi_communicator_t *comm)
 {
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+
+    if (NULL == comm->c_coll.coll_alltoall ||
+        NULL == comm->c_coll.coll_alltoall_module) {
+        opal_output_verbose(10, ompi_coll_base_framework.framework_output,
+                            "coll:sm:enable (%d/%s): no underlying alltoall; disqualifying myself",
+                            comm->c_contextid, comm->c_name);
+        return OMPI_ERROR;
+    }
+
+    /* Save the alltoall that is in place before us, to fall back on */
+    sm_module->previous_alltoall = comm->c_coll.coll_alltoall;
+    sm_module->previous_alltoall_module = comm->c_coll.coll_alltoall_module;
+    OBJ_RETAIN(sm_module->previous_alltoall_module);
+
     if (NULL == comm->c_coll.coll_reduce ||
         NULL == comm->c_coll.coll_reduce_module) {
         opal_output_verbose(10, ompi_coll_base_framework.framework_output,
@@ -230,7 +261,7 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
 #if OPAL_HAVE_HWLOC
     opal_hwloc_base_memory_segment_t *maffinity;
 #endif
-    int parent, min_child, max_child, num_children;
+    int parent, min_child, max_child, num_children, *parents = NULL;
     unsigned char *base = NULL;
     const int num_barrier_buffers = 2;
 
@@ -245,7 +276,7 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
        alloc here to handle the error case) */
     maffinity = (opal_hwloc_base_memory_segment_t*)
         malloc(sizeof(opal_hwloc_base_memory_segment_t) * 
-               c->sm_comm_num_segments * 3);
+               (c->sm_comm_num_segments * 2 + 2));
     if (NULL == maffinity) {
         opal_output_verbose(10, ompi_coll_base_framework.framework_output,
                             "coll:sm:enable (%d/%s): malloc failed (1)", 
@@ -265,6 +296,8 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
        4. array of sm_tree_degree pointers to other tree nodes (i.e.,
           this nodes' children) for each instance of
           mca_coll_sm_tree_node_t
+       5. array of ompi_comm_size(comm) pointers to the barrier
+          control pages of this node's children in the barrier tree
     */
     sm_module->sm_comm_data = data = (mca_coll_sm_comm_t*)
         malloc(sizeof(mca_coll_sm_comm_t) + 
@@ -272,7 +305,8 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
                 sizeof(mca_coll_sm_data_index_t)) +
                (size * 
                 (sizeof(mca_coll_sm_tree_node_t) +
-                 (sizeof(mca_coll_sm_tree_node_t*) * c->sm_tree_degree))));
+                 (sizeof(mca_coll_sm_tree_node_t*) * c->sm_tree_degree) +
+                 sizeof(uint32_t*))));
     if (NULL == data) {
 #if OPAL_HAVE_HWLOC
         free(maffinity);
@@ -298,6 +332,8 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
         data->mcb_tree[i].mcstn_children = 
             data->mcb_tree[i - 1].mcstn_children + c->sm_tree_degree;
     }
+    data->mcb_barrier_control_children = (uint32_t**)
+        (data->mcb_tree[size - 1].mcstn_children + c->sm_tree_degree);
 
     /* Pre-compute a tree for a given number of processes and degree.
        We'll re-use this tree for all possible values of root (i.e.,
@@ -338,8 +374,30 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
         }
     }
 
+    /* The barrier tree (the parent of everyone, -1 for the root).
+       This needs to communicate, so do it before attaching to the
+       shmem segment. */
+    parents = (int*) malloc(size * sizeof(int));
+    if (NULL == parents) {
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+    } else {
+        ret = barrier_tree_parents(comm, parents);
+    }
+    if (OMPI_SUCCESS != ret) {
+        if (NULL != parents) {
+            free(parents);
+        }
+        free(data);
+#if OPAL_HAVE_HWLOC
+        free(maffinity);
+#endif
+        sm_module->sm_comm_data = NULL;
+        return ret;
+    }
+
     /* Attach to this communicator's shmem data segment */
     if (OMPI_SUCCESS != (ret = bootstrap_comm(comm, sm_module))) {
+        free(parents);
         free(data);
 #if OPAL_HAVE_HWLOC
         free(maffinity);
@@ -353,30 +411,26 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
        barrier buffers.  There are 2 sets of barrier buffers (because
        there can never be more than one outstanding barrier occuring
        at any timie).  Setup pointers to my control buffers, my
-       parents, and [the beginning of] my children (note that the
-       children are contiguous, so having the first pointer and the
-       num_children from the mcb_tree data is sufficient). */
+       parent's, and my children's in the barrier tree. */
     control_size = c->sm_control_size;
     base = data->sm_bootstrap_meta->module_data_addr;
     data->mcb_barrier_control_me = (uint32_t*)
         (base + (rank * control_size * num_barrier_buffers * 2));
-    if (data->mcb_tree[rank].mcstn_parent) {
+    if (parents[rank] >= 0) {
         data->mcb_barrier_control_parent = (uint32_t*)
-            (base +
-             (data->mcb_tree[rank].mcstn_parent->mcstn_id * control_size * 
-              num_barrier_buffers * 2));
+            (base + (parents[rank] * control_size * num_barrier_buffers * 2));
     } else {
         data->mcb_barrier_control_parent = NULL;
     }
-    if (data->mcb_tree[rank].mcstn_num_children > 0) {
-        data->mcb_barrier_control_children = (uint32_t*)
-            (base +
-             (data->mcb_tree[rank].mcstn_children[0]->mcstn_id * control_size *
-              num_barrier_buffers * 2));
-    } else {
-        data->mcb_barrier_control_children = NULL;
+    data->mcb_barrier_num_children = 0;
+    for (i = 0; i < size; ++i) {
+        if (parents[i] == rank) {
+            data->mcb_barrier_control_children[data->mcb_barrier_num_children++] =
+                (uint32_t*) (base + (i * control_size * num_barrier_buffers * 2));
+        }
     }
     data->mcb_barrier_count = 0;
+    free(parents);
 
     /* Next, setup the pointer to the in-use flags.  The number of
        segments will be an even multiple of the number of in-use
@@ -384,10 +438,17 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
     base += (c->sm_control_size * size * num_barrier_buffers * 2);
     data->mcb_in_use_flags = (mca_coll_sm_in_use_flag_t*) base;
 
+    /* Memory affinity: my barrier control pages, which only I poll */
+    j = 0;
+#if OPAL_HAVE_HWLOC
+    maffinity[j].mbs_start_addr = (void *) data->mcb_barrier_control_me;
+    maffinity[j].mbs_len = c->sm_control_size * num_barrier_buffers * 2;
+    ++j;
+#endif
+
     /* All things being equal, if we're rank 0, then make the in-use
        flags be local (memory affinity).  Then zero them all out so
        that they're marked as unused. */
-    j = 0;
     if (0 == rank) {
 #if OPAL_HAVE_HWLOC
         maffinity[j].mbs_start_addr = base;
@@ -432,7 +493,7 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
         maffinity[j].mbs_len = c->sm_fragment_size;
         maffinity[j].mbs_start_addr = 
             ((char*) data->mcb_data_index[i].mcbmi_data) +
-            (rank * c->sm_control_size);
+            (rank * c->sm_fragment_size);
         ++j;
 #endif
     }
@@ -500,6 +561,99 @@ static bool have_local_peers(ompi_group_t *group, size_t size)
 }
 
 
+/*
+ * Compute the barrier tree: within each socket, a tree of degree
+ * sm_tree_degree rooted at the lowest rank of the socket (its
+ * leader), and a tree of the same degree between the leaders.  So
+ * only the leaders touch the control pages of another socket.  The
+ * socket of every process is found by exchanging the leaders that
+ * each process sees from its own locality flags.  If the processes
+ * are not bound (no process shares a socket with another one), or
+ * all of them are on the same socket, this is the usual tree of
+ * mcb_tree.
+ */
+static int barrier_tree_parents(ompi_communicator_t *comm, int *parents)
+{
+    int i, k, n, ret, leader, nleaders = 0;
+    int rank = ompi_comm_rank(comm);
+    int size = ompi_comm_size(comm);
+    int degree = mca_coll_sm_component.sm_tree_degree;
+    int *leaders, *index, *start, *members, *list;
+    ompi_proc_t *proc;
+
+    leaders = (int*) malloc(5 * size * sizeof(int));
+    if (NULL == leaders) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    index = leaders + size;    /* index of each process in its socket */
+    start = index + size;      /* where each socket starts in members
+                                  (indexed by the leader) */
+    members = start + size;    /* the processes, socket by socket */
+    list = members + size;     /* the leaders */
+
+    for (leader = rank, i = 0; i < rank; ++i) {
+        proc = ompi_group_peer_lookup(comm->c_local_group, i);
+        if (OPAL_PROC_ON_LOCAL_SOCKET(proc->proc_flags)) {
+            leader = i;
+            break;
+        }
+    }
+    ret = comm->c_coll.coll_allgather(&leader, 1, MPI_INT,
+                                      leaders, 1, MPI_INT, comm,
+                                      comm->c_coll.coll_allgather_module);
+    if (OMPI_SUCCESS != ret) {
+        free(leaders);
+        return ret;
+    }
+
+    /* Count the members of each socket (the leader comes first) */
+    for (i = 0; i < size; ++i) {
+        start[i] = 0;
+    }
+    for (i = 0; i < size; ++i) {
+        leader = leaders[i];
+        if (leader < 0 || leader > i || leaders[leader] != leader) {
+            /* not consistent: forget about the sockets */
+            nleaders = size;
+            break;
+        }
+        if (leader == i) {
+            list[nleaders++] = i;
+        }
+        index[i] = start[leader]++;
+    }
+    if (1 == nleaders || size == nleaders) {
+        for (i = 0; i < size; ++i) {
+            parents[i] = (0 == i) ? -1 : (i - 1) / degree;
+        }
+        free(leaders);
+        return OMPI_SUCCESS;
+    }
+
+    for (k = 0, i = 0; i < nleaders; ++i) {
+        n = start[list[i]];
+        start[list[i]] = k;
+        k += n;
+    }
+    for (i = 0; i < size; ++i) {
+        members[start[leaders[i]] + index[i]] = i;
+    }
+
+    /* The leaders, in their own tree, and the members of each socket
+       under their leader */
+    for (i = 0; i < nleaders; ++i) {
+        parents[list[i]] = (0 == i) ? -1 : list[(i - 1) / degree];
+    }
+    for (i = 0; i < size; ++i) {
+        if (0 != index[i]) {
+            parents[i] = members[start[leaders[i]] + (index[i] - 1) / degree];
+        }
+    }
+    free(leaders);
+    return OMPI_SUCCESS;
+}
+
+
 static int bootstrap_comm(ompi_communicator_t *comm,
                           mca_coll_sm_module_t *module)
 {
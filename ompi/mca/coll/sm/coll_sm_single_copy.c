@@ -0,0 +1,435 @@
+/*
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Single-copy bcast, gather, allgather and alltoall.
+ *
+ * Instead of packing fragments into the shared segments and unpacking
+ * them on the other side (two copies per byte per receiver), every
+ * process whose data is needed posts the address of its buffer in its
+ * control buffer of the first segment of a set (see
+ * mca_coll_sm_single_copy_post_t), and the readers pull the data
+ * straight into their own buffers with process_vm_readv.  A
+ * non-contiguous buffer is packed into (or unpacked from) a temporary
+ * contiguous buffer on its own side only.
+ *
+ * The set of segments is claimed by rank 0 for size + 1 users, as in
+ * allgather; its data slots are not used.  A process whose buffer is
+ * read must not return before every reader is done with it, so it
+ * waits until the set has been released by everybody (or has
+ * already been claimed again by a later operation).
+ */
+
+#include "ompi_config.h"
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#include <errno.h>
+#include <stdlib.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/util/output.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
+#include "opal/sys/atomic.h"
+#include "coll_sm.h"
+
+#if OMPI_COLL_SM_HAVE_CMA
+#include <sys/uio.h>
+#if OMPI_BTL_VADER_CMA_NEED_SYSCALL_DEFS
+#include "opal/sys/cma.h"
+#endif /* OMPI_BTL_VADER_CMA_NEED_SYSCALL_DEFS */
+
+/*
+ * Local state of one single-copy operation
+ */
+typedef struct single_copy_op_t {
+    mca_coll_sm_in_use_flag_t *flag;
+    mca_coll_sm_data_index_t *index;
+    uint32_t op_count;
+    /* packed copy of a non-contiguous send buffer */
+    char *bounce;
+    /* landing area for a non-contiguous receive buffer */
+    char *tmp;
+} single_copy_op_t;
+
+
+/*
+ * Return where the packed form of (buf, count, dtype) starts: the
+ * buffer itself when it is contiguous, otherwise a temporary copy.
+ */
+static char *single_copy_send_buffer(void *buf, int count,
+                                     struct ompi_datatype_t *dtype,
+                                     single_copy_op_t *sc)
+{
+    opal_convertor_t convertor;
+    struct iovec iov;
+    uint32_t iov_count = 1;
+    size_t max_data;
+    ptrdiff_t true_lb, true_extent;
+
+    if (ompi_datatype_is_contiguous_memory_layout(dtype, count)) {
+        ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+        return (char*) buf + true_lb;
+    }
+
+    OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+    if (OMPI_SUCCESS != 
+        opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor,
+                                                 &(dtype->super), count, 
+                                                 buf, 0, &convertor)) {
+        OBJ_DESTRUCT(&convertor);
+        return NULL;
+    }
+    opal_convertor_get_packed_size(&convertor, &max_data);
+    sc->bounce = (char*) malloc(max_data);
+    if (NULL != sc->bounce) {
+        iov.iov_base = sc->bounce;
+        iov.iov_len = max_data;
+        opal_convertor_pack(&convertor, &iov, &iov_count, &max_data);
+    }
+    OBJ_DESTRUCT(&convertor);
+
+    return sc->bounce;
+}
+
+
+/*
+ * Claim the next set of segments and, if my buffer is needed, post it.
+ * A NULL addr is still posted so that the readers fail instead of
+ * waiting forever.
+ */
+static void single_copy_begin(mca_coll_sm_comm_t *data, int rank, int size,
+                              bool posting, char *addr, size_t stride,
+                              single_copy_op_t *sc)
+{
+    int flag_num;
+    mca_coll_sm_single_copy_post_t *post;
+
+    flag_num = (data->mcb_operation_count % 
+                mca_coll_sm_component.sm_comm_num_in_use_flags);
+    FLAG_SETUP(flag_num, sc->flag, data);
+    if (0 == rank) {
+        FLAG_WAIT_FOR_IDLE(sc->flag, single_copy_root_label);
+        FLAG_RETAIN(sc->flag, size + 1, data->mcb_operation_count);
+    } else {
+        FLAG_WAIT_FOR_OP(sc->flag, data->mcb_operation_count, single_copy_nonroot_label);
+    }
+    sc->op_count = data->mcb_operation_count++;
+    sc->index = &(data->mcb_data_index[flag_num * 
+                                       mca_coll_sm_component.sm_segs_per_inuse_flag]);
+
+    if (posting) {
+        post = SINGLE_COPY_POST(sc->index, rank);
+        post->mcscp_pid = getpid();
+        post->mcscp_addr = addr;
+        post->mcscp_stride = stride;
+        opal_atomic_wmb();
+        post->mcscp_ready = 1;
+    }
+}
+
+
+/*
+ * Read block number "block" of len bytes posted by src into (buf,
+ * count, dtype)
+ */
+static int single_copy_read(single_copy_op_t *sc, int src, size_t block,
+                            size_t len, void *buf, int count,
+                            struct ompi_datatype_t *dtype)
+{
+    mca_coll_sm_single_copy_post_t *post = SINGLE_COPY_POST(sc->index, src);
+    opal_convertor_t convertor;
+    struct iovec local, remote;
+    uint32_t iov_count = 1;
+    ptrdiff_t true_lb, true_extent;
+    size_t max_data;
+    ssize_t nbytes;
+    char *dst;
+    int ret;
+
+    SPIN_CONDITION(0 != post->mcscp_ready, single_copy_read_label);
+    opal_atomic_rmb();
+    if (NULL == post->mcscp_addr) {
+        return OMPI_ERROR;
+    }
+
+    if (ompi_datatype_is_contiguous_memory_layout(dtype, count)) {
+        ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+        dst = (char*) buf + true_lb;
+    } else {
+        if (NULL == sc->tmp) {
+            sc->tmp = (char*) malloc(len);
+            if (NULL == sc->tmp) {
+                return OMPI_ERR_OUT_OF_RESOURCE;
+            }
+        }
+        dst = sc->tmp;
+    }
+
+    local.iov_base = dst;
+    local.iov_len = len;
+    remote.iov_base = post->mcscp_addr + block * post->mcscp_stride;
+    remote.iov_len = len;
+    while (local.iov_len > 0) {
+        nbytes = process_vm_readv(post->mcscp_pid, &local, 1, &remote, 1, 0);
+        if (nbytes <= 0) {
+            opal_output(0, "coll:sm: process_vm_readv failed (%lu bytes left): %d",
+                        (unsigned long) local.iov_len, errno);
+            return OMPI_ERROR;
+        }
+        local.iov_base = (char*) local.iov_base + nbytes;
+        local.iov_len -= nbytes;
+        remote.iov_base = (char*) remote.iov_base + nbytes;
+        remote.iov_len -= nbytes;
+    }
+
+    if (dst != sc->tmp) {
+        return OMPI_SUCCESS;
+    }
+
+    OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+    ret = opal_convertor_copy_and_prepare_for_recv(ompi_mpi_local_convertor,
+                                                   &(dtype->super), count,
+                                                   buf, 0, &convertor);
+    if (OMPI_SUCCESS == ret) {
+        local.iov_base = sc->tmp;
+        local.iov_len = max_data = len;
+        opal_convertor_unpack(&convertor, &local, &iov_count, &max_data);
+    }
+    OBJ_DESTRUCT(&convertor);
+
+    return ret;
+}
+
+
+/*
+ * Let go of the set of segments.  If my buffer was posted, also wait
+ * until every reader is done with it.
+ */
+static void single_copy_end(int size, bool posted, single_copy_op_t *sc)
+{
+    int i;
+    mca_coll_sm_in_use_flag_t *flag = sc->flag;
+
+    FLAG_RELEASE_AND_CLEAR(flag, sc->index, size);
+    if (posted) {
+        SPIN_CONDITION(0 == flag->mcsiuf_num_procs_using ||
+                       sc->op_count != flag->mcsiuf_operation_count,
+                       single_copy_end_label);
+    }
+
+    if (NULL != sc->bounce) {
+        free(sc->bounce);
+    }
+    if (NULL != sc->tmp) {
+        free(sc->tmp);
+    }
+}
+#endif /* OMPI_COLL_SM_HAVE_CMA */
+
+
+int mca_coll_sm_bcast_single_copy(void *buff, int count, 
+                                  struct ompi_datatype_t *datatype,
+                                  int root, 
+                                  struct ompi_communicator_t *comm,
+                                  mca_coll_sm_module_t *sm_module)
+{
+#if OMPI_COLL_SM_HAVE_CMA
+    single_copy_op_t sc = { NULL, NULL, 0, NULL, NULL };
+    int ret = OMPI_SUCCESS, rank, size;
+    size_t len;
+    char *addr = NULL;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    ompi_datatype_type_size(datatype, &len);
+    len *= count;
+
+    if (root == rank) {
+        addr = single_copy_send_buffer(buff, count, datatype, &sc);
+        if (NULL == addr) {
+            ret = OMPI_ERR_OUT_OF_RESOURCE;
+        }
+    }
+    single_copy_begin(sm_module->sm_comm_data, rank, size, root == rank,
+                      addr, 0, &sc);
+    if (root != rank) {
+        ret = single_copy_read(&sc, root, 0, len, buff, count, datatype);
+    }
+    single_copy_end(size, root == rank, &sc);
+
+    return ret;
+#else
+    return OMPI_ERR_NOT_SUPPORTED;
+#endif
+}
+
+
+int mca_coll_sm_gather_single_copy(void *sbuf, int scount, 
+                                   struct ompi_datatype_t *sdtype, 
+                                   void *rbuf, int rcount, 
+                                   struct ompi_datatype_t *rdtype, 
+                                   int root, 
+                                   struct ompi_communicator_t *comm,
+                                   mca_coll_sm_module_t *sm_module)
+{
+#if OMPI_COLL_SM_HAVE_CMA
+    single_copy_op_t sc = { NULL, NULL, 0, NULL, NULL };
+    int ret = OMPI_SUCCESS, rank, size, src;
+    size_t len;
+    ptrdiff_t lb, extent;
+    char *addr = NULL;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    if (root != rank) {
+        addr = single_copy_send_buffer(sbuf, scount, sdtype, &sc);
+        if (NULL == addr) {
+            ret = OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        single_copy_begin(sm_module->sm_comm_data, rank, size, true,
+                          addr, 0, &sc);
+        single_copy_end(size, true, &sc);
+        return ret;
+    }
+
+    ompi_datatype_type_size(rdtype, &len);
+    len *= rcount;
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+
+    if (MPI_IN_PLACE != sbuf) {
+        ret = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                   (char*) rbuf + (ptrdiff_t) rank * rcount * extent,
+                                   rcount, rdtype);
+    }
+
+    single_copy_begin(sm_module->sm_comm_data, rank, size, false,
+                      NULL, 0, &sc);
+    for (src = 0; src < size && OMPI_SUCCESS == ret; ++src) {
+        if (src != rank) {
+            ret = single_copy_read(&sc, src, 0, len,
+                                   (char*) rbuf + (ptrdiff_t) src * rcount * extent,
+                                   rcount, rdtype);
+        }
+    }
+    single_copy_end(size, false, &sc);
+
+    return ret;
+#else
+    return OMPI_ERR_NOT_SUPPORTED;
+#endif
+}
+
+
+int mca_coll_sm_allgather_single_copy(void *sbuf, int scount, 
+                                      struct ompi_datatype_t *sdtype, 
+                                      void *rbuf, int rcount, 
+                                      struct ompi_datatype_t *rdtype, 
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_sm_module_t *sm_module)
+{
+#if OMPI_COLL_SM_HAVE_CMA
+    single_copy_op_t sc = { NULL, NULL, 0, NULL, NULL };
+    int ret = OMPI_SUCCESS, rank, size, j, src;
+    size_t len;
+    ptrdiff_t lb, extent;
+    char *addr;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    ompi_datatype_type_size(rdtype, &len);
+    len *= rcount;
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = (char*) rbuf + (ptrdiff_t) rank * rcount * extent;
+        scount = rcount;
+        sdtype = rdtype;
+    } else {
+        ret = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                   (char*) rbuf + (ptrdiff_t) rank * rcount * extent,
+                                   rcount, rdtype);
+    }
+
+    addr = single_copy_send_buffer(sbuf, scount, sdtype, &sc);
+    if (NULL == addr) {
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    single_copy_begin(sm_module->sm_comm_data, rank, size, true,
+                      addr, 0, &sc);
+    for (j = 1; j < size && OMPI_SUCCESS == ret; ++j) {
+        src = (rank + j) % size;
+        ret = single_copy_read(&sc, src, 0, len,
+                               (char*) rbuf + (ptrdiff_t) src * rcount * extent,
+                               rcount, rdtype);
+    }
+    single_copy_end(size, true, &sc);
+
+    return ret;
+#else
+    return OMPI_ERR_NOT_SUPPORTED;
+#endif
+}
+
+
+int mca_coll_sm_alltoall_single_copy(void *sbuf, int scount, 
+                                     struct ompi_datatype_t *sdtype, 
+                                     void *rbuf, int rcount, 
+                                     struct ompi_datatype_t *rdtype, 
+                                     struct ompi_communicator_t *comm,
+                                     mca_coll_sm_module_t *sm_module)
+{
+#if OMPI_COLL_SM_HAVE_CMA
+    single_copy_op_t sc = { NULL, NULL, 0, NULL, NULL };
+    int ret, rank, size, j, src;
+    size_t len;
+    ptrdiff_t lb, sextent, rextent;
+    char *addr;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    ompi_datatype_type_size(sdtype, &len);
+    len *= scount;
+    ompi_datatype_get_extent(sdtype, &lb, &sextent);
+    ompi_datatype_get_extent(rdtype, &lb, &rextent);
+
+    ret = ompi_datatype_sndrcv((char*) sbuf + (ptrdiff_t) rank * scount * sextent,
+                               scount, sdtype,
+                               (char*) rbuf + (ptrdiff_t) rank * rcount * rextent,
+                               rcount, rdtype);
+
+    /* The blocks of the packed send buffer are len bytes apart
+       whether it is the user's buffer or a packed copy */
+    addr = single_copy_send_buffer(sbuf, size * scount, sdtype, &sc);
+    if (NULL == addr) {
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    single_copy_begin(sm_module->sm_comm_data, rank, size, true,
+                      addr, len, &sc);
+    for (j = 1; j < size && OMPI_SUCCESS == ret; ++j) {
+        src = (rank + j) % size;
+        ret = single_copy_read(&sc, src, rank, len,
+                               (char*) rbuf + (ptrdiff_t) src * rcount * rextent,
+                               rcount, rdtype);
+    }
+    single_copy_end(size, true, &sc);
+
+    return ret;
+#else
+    return OMPI_ERR_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,35 @@
+# -*- shell-script -*-
+#
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+# MCA_coll_sm_CONFIG([action-if-can-compile],
+#                    [action-if-cant-compile])
+# ------------------------------------------------
+AC_DEFUN([MCA_ompi_coll_sm_CONFIG],[
+    AC_CONFIG_FILES([ompi/mca/coll/sm/Makefile])
+
+    OPAL_VAR_SCOPE_PUSH([coll_sm_cma_happy])
+
+    # the single-copy path reads the peers' buffers with
+    # process_vm_readv (same check as the vader btl)
+    OMPI_CHECK_VADER_CMA([coll_sm],
+                         [coll_sm_cma_happy=1],
+                         [coll_sm_cma_happy=0])
+
+    AC_DEFINE_UNQUOTED([OMPI_COLL_SM_HAVE_CMA],
+                       [$coll_sm_cma_happy],
+                       [If CMA support can be enabled within coll sm])
+
+    AC_CHECK_HEADERS([sys/prctl.h])
+
+    # the fragment path only needs shared memory, so sm can always be
+    # built
+    [$1]
+
+    OPAL_VAR_SCOPE_POP
+])dnl
@@ -52,7 +52,8 @@ typedef enum COLLTYPE {
     SCAN,           /* 13 */
     SCATTER,        /* 14 */
     SCATTERV,       /* 15 */
-    COLLCOUNT       /* 16 end counter keep it as last element */
+    REDUCESCATTERBLOCK, /* 16 after the others, the rule files use the numbers */
+    COLLCOUNT       /* 17 end counter keep it as last element */
 } COLLTYPE_T;
 
 /* defined arg lists to simply auto inclusion of user overriding decision functions */
@@ -69,6 +70,7 @@ typedef enum COLLTYPE {
 #define GATHERV_ARGS void *sbuf, int scount, struct ompi_datatype_t *sdtype, void *rbuf, int *rcounts, int *disps, struct ompi_datatype_t *rdtype, int root, struct ompi_communicator_t *comm, mca_coll_base_module_t *module
 #define REDUCE_ARGS void *sbuf, void* rbuf, int count, struct ompi_datatype_t *dtype, struct ompi_op_t *op, int root, struct ompi_communicator_t *comm, mca_coll_base_module_t *module
 #define REDUCESCATTER_ARGS void *sbuf, void *rbuf, int *rcounts, struct ompi_datatype_t *dtype, struct ompi_op_t *op, struct ompi_communicator_t *comm, mca_coll_base_module_t *module
+#define REDUCESCATTERBLOCK_ARGS void *sbuf, void *rbuf, int rcount, struct ompi_datatype_t *dtype, struct ompi_op_t *op, struct ompi_communicator_t *comm, mca_coll_base_module_t *module
 #define SCAN_ARGS void *sbuf, void *rbuf, int count, struct ompi_datatype_t *dtype,  struct ompi_op_t *op, struct ompi_communicator_t *comm, mca_coll_base_module_t *module
 #define SCATTER_ARGS void *sbuf, int scount, struct ompi_datatype_t *sdtype, void *rbuf, int rcount, struct ompi_datatype_t *rdtype, int root, struct ompi_communicator_t *comm, mca_coll_base_module_t *module
 #define SCATTERV_ARGS void *sbuf, int *scounts, int *disps, struct ompi_datatype_t *sdtype, void* rbuf, int rcount, struct ompi_datatype_t *rdtype, int root, struct ompi_communicator_t *comm, mca_coll_base_module_t *module
@@ -84,7 +86,13 @@ extern bool  ompi_coll_tuned_use_dynamic_rules;
 extern char* ompi_coll_tuned_dynamic_rules_filename;
 extern int   ompi_coll_tuned_init_tree_fanout;
 extern int   ompi_coll_tuned_init_chain_fanout;
+extern int   ompi_coll_tuned_knomial_radix;
 extern int   ompi_coll_tuned_init_max_requests;
+extern bool  ompi_coll_tuned_autotune;
+extern int   ompi_coll_tuned_autotune_trials;
+extern int   ompi_coll_tuned_allreduce_ring_count;
+extern int   ompi_coll_tuned_scratch_max_size;
+extern char* ompi_coll_tuned_autotune_rules_filename;
 
 /* forced algorithm choices */
 /* this structure is for storing the indexes to the forced algorithm mca params... */
@@ -163,6 +171,7 @@ int ompi_coll_tuned_allgatherv_intra_ring(ALLGATHERV_ARGS);
 int ompi_coll_tuned_allgatherv_intra_neighborexchange(ALLGATHERV_ARGS);
 int ompi_coll_tuned_allgatherv_intra_basic_default(ALLGATHERV_ARGS);
 int ompi_coll_tuned_allgatherv_intra_two_procs(ALLGATHERV_ARGS);
+int ompi_coll_tuned_allgatherv_intra_ring_segmented(ALLGATHERV_ARGS, int segsize);
 int ompi_coll_tuned_allgatherv_inter_dec_fixed(ALLGATHERV_ARGS);
 int ompi_coll_tuned_allgatherv_inter_dec_dynamic(ALLGATHERV_ARGS);
 
@@ -176,6 +185,7 @@ int ompi_coll_tuned_allreduce_intra_nonoverlapping(ALLREDUCE_ARGS);
 int ompi_coll_tuned_allreduce_intra_recursivedoubling(ALLREDUCE_ARGS);
 int ompi_coll_tuned_allreduce_intra_ring(ALLREDUCE_ARGS);
 int ompi_coll_tuned_allreduce_intra_ring_segmented(ALLREDUCE_ARGS, uint32_t segsize);
+int ompi_coll_tuned_allreduce_intra_ring_pipelined(ALLREDUCE_ARGS, uint32_t segsize, int nrings);
 int ompi_coll_tuned_allreduce_intra_basic_linear(ALLREDUCE_ARGS);
 int ompi_coll_tuned_allreduce_inter_dec_fixed(ALLREDUCE_ARGS);
 int ompi_coll_tuned_allreduce_inter_dec_dynamic(ALLREDUCE_ARGS);
@@ -191,6 +201,7 @@ int ompi_coll_tuned_alltoall_intra_bruck(ALLTOALL_ARGS);
 int ompi_coll_tuned_alltoall_intra_basic_linear(ALLTOALL_ARGS);
 int ompi_coll_tuned_alltoall_intra_linear_sync(ALLTOALL_ARGS, int max_requests);
 int ompi_coll_tuned_alltoall_intra_two_procs(ALLTOALL_ARGS);
+int ompi_coll_tuned_alltoall_intra_throttled(ALLTOALL_ARGS, int max_requests);
 int ompi_coll_tuned_alltoall_inter_dec_fixed(ALLTOALL_ARGS);
 int ompi_coll_tuned_alltoall_inter_dec_dynamic(ALLTOALL_ARGS);
 
@@ -202,6 +213,7 @@ int ompi_coll_tuned_alltoallv_intra_do_this(ALLTOALLV_ARGS, int algorithm);
 int ompi_coll_tuned_alltoallv_intra_check_forced_init(coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 int ompi_coll_tuned_alltoallv_intra_pairwise(ALLTOALLV_ARGS);
 int ompi_coll_tuned_alltoallv_intra_basic_linear(ALLTOALLV_ARGS);
+int ompi_coll_tuned_alltoallv_intra_throttled(ALLTOALLV_ARGS, int max_requests, size_t max_bytes);
 int ompi_coll_tuned_alltoallv_inter_dec_fixed(ALLTOALLV_ARGS);
 int ompi_coll_tuned_alltoallv_inter_dec_dynamic(ALLTOALLV_ARGS);
 
@@ -225,6 +237,8 @@ int ompi_coll_tuned_barrier_intra_bruck(BARRIER_ARGS);
 int ompi_coll_tuned_barrier_intra_two_procs(BARRIER_ARGS);
 int ompi_coll_tuned_barrier_intra_linear(BARRIER_ARGS);
 int ompi_coll_tuned_barrier_intra_tree(BARRIER_ARGS);
+int ompi_coll_tuned_barrier_intra_knomial(BARRIER_ARGS, int radix);
+int ompi_coll_tuned_barrier_intra_hierarchical(BARRIER_ARGS);
 
 /* Bcast */
 int ompi_coll_tuned_bcast_intra_generic( BCAST_ARGS, uint32_t count_by_segment, ompi_coll_tree_t* tree );
@@ -237,6 +251,7 @@ int ompi_coll_tuned_bcast_intra_basic_linear(BCAST_ARGS);
 int ompi_coll_tuned_bcast_intra_chain(BCAST_ARGS, uint32_t segsize, int32_t chains);
 int ompi_coll_tuned_bcast_intra_pipeline(BCAST_ARGS, uint32_t segsize);
 int ompi_coll_tuned_bcast_intra_binomial(BCAST_ARGS, uint32_t segsize);
+int ompi_coll_tuned_bcast_intra_knomial(BCAST_ARGS, uint32_t segsize, int radix);
 int ompi_coll_tuned_bcast_intra_bintree(BCAST_ARGS, uint32_t segsize);
 int ompi_coll_tuned_bcast_intra_split_bintree(BCAST_ARGS, uint32_t segsize);
 int ompi_coll_tuned_bcast_inter_dec_fixed(BCAST_ARGS);
@@ -245,6 +260,13 @@ int ompi_coll_tuned_bcast_inter_dec_dynamic(BCAST_ARGS);
 /* Exscan */
 int ompi_coll_tuned_exscan_intra_dec_fixed(EXSCAN_ARGS);
 int ompi_coll_tuned_exscan_intra_dec_dynamic(EXSCAN_ARGS);
+int ompi_coll_tuned_exscan_intra_do_forced(EXSCAN_ARGS);
+int ompi_coll_tuned_exscan_intra_do_this(EXSCAN_ARGS, int algorithm, int faninout, int segsize);
+int ompi_coll_tuned_exscan_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
+int ompi_coll_tuned_exscan_intra_basic_linear(EXSCAN_ARGS);
+int ompi_coll_tuned_exscan_intra_recursivedoubling(EXSCAN_ARGS);
+int ompi_coll_tuned_exscan_intra_binomial(EXSCAN_ARGS);
+int ompi_coll_tuned_exscan_intra_hierarchical(EXSCAN_ARGS);
 int ompi_coll_tuned_exscan_inter_dec_fixed(EXSCAN_ARGS);
 int ompi_coll_tuned_exscan_inter_dec_dynamic(EXSCAN_ARGS);
 
@@ -256,15 +278,21 @@ int ompi_coll_tuned_gather_intra_do_this(GATHER_ARGS, int algorithm, int faninou
 int ompi_coll_tuned_gather_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 int ompi_coll_tuned_gather_intra_basic_linear(GATHER_ARGS);
 int ompi_coll_tuned_gather_intra_binomial(GATHER_ARGS);
+int ompi_coll_tuned_gather_intra_knomial(GATHER_ARGS, int radix);
 int ompi_coll_tuned_gather_intra_linear_sync(GATHER_ARGS, int first_segment_size);
 int ompi_coll_tuned_gather_inter_dec_fixed(GATHER_ARGS);
 int ompi_coll_tuned_gather_inter_dec_dynamic(GATHER_ARGS);
 
 /* GatherV */
 int ompi_coll_tuned_gatherv_intra_dec_fixed(GATHERV_ARGS);
-int ompi_coll_tuned_gatherv_intra_dec_dynamic(GATHER_ARGS);
-int ompi_coll_tuned_gatherv_inter_dec_fixed(GATHER_ARGS);
-int ompi_coll_tuned_gatherv_inter_dec_dynamic(GATHER_ARGS);
+int ompi_coll_tuned_gatherv_intra_dec_dynamic(GATHERV_ARGS);
+int ompi_coll_tuned_gatherv_intra_do_forced(GATHERV_ARGS);
+int ompi_coll_tuned_gatherv_intra_do_this(GATHERV_ARGS, int algorithm, int faninout, int segsize);
+int ompi_coll_tuned_gatherv_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
+int ompi_coll_tuned_gatherv_intra_basic_linear(GATHERV_ARGS);
+int ompi_coll_tuned_gatherv_intra_binomial(GATHERV_ARGS);
+int ompi_coll_tuned_gatherv_inter_dec_fixed(GATHERV_ARGS);
+int ompi_coll_tuned_gatherv_inter_dec_dynamic(GATHERV_ARGS);
 
 /* Reduce */
 int ompi_coll_tuned_reduce_generic( REDUCE_ARGS, ompi_coll_tree_t* tree, int count_by_segment, int max_outstanding_reqs );
@@ -278,6 +306,7 @@ int ompi_coll_tuned_reduce_intra_chain(REDUCE_ARGS, uint32_t segsize, int fanout
 int ompi_coll_tuned_reduce_intra_pipeline(REDUCE_ARGS, uint32_t segsize, int max_outstanding_reqs );
 int ompi_coll_tuned_reduce_intra_binary(REDUCE_ARGS, uint32_t segsize, int max_outstanding_reqs );
 int ompi_coll_tuned_reduce_intra_binomial(REDUCE_ARGS, uint32_t segsize, int max_outstanding_reqs );
+int ompi_coll_tuned_reduce_intra_knomial(REDUCE_ARGS, uint32_t segsize, int radix, int max_outstanding_reqs );
 int ompi_coll_tuned_reduce_intra_in_order_binary(REDUCE_ARGS, uint32_t segsize, int max_outstanding_reqs );
 int ompi_coll_tuned_reduce_inter_dec_fixed(REDUCE_ARGS);
 int ompi_coll_tuned_reduce_inter_dec_dynamic(REDUCE_ARGS);
@@ -295,9 +324,42 @@ int ompi_coll_tuned_reduce_scatter_intra_ring(REDUCESCATTER_ARGS);
 int ompi_coll_tuned_reduce_scatter_inter_dec_fixed(REDUCESCATTER_ARGS);
 int ompi_coll_tuned_reduce_scatter_inter_dec_dynamic(REDUCESCATTER_ARGS);
 
+/* Reduce_scatter_block */
+int ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed(REDUCESCATTERBLOCK_ARGS);
+int ompi_coll_tuned_reduce_scatter_block_intra_dec_dynamic(REDUCESCATTERBLOCK_ARGS);
+int ompi_coll_tuned_reduce_scatter_block_intra_do_forced(REDUCESCATTERBLOCK_ARGS);
+int ompi_coll_tuned_reduce_scatter_block_intra_do_this(REDUCESCATTERBLOCK_ARGS, int algorithm, int faninout, int segsize);
+int ompi_coll_tuned_reduce_scatter_block_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
+int ompi_coll_tuned_reduce_scatter_block_intra_basic_linear(REDUCESCATTERBLOCK_ARGS);
+int ompi_coll_tuned_reduce_scatter_block_intra_recursivehalving(REDUCESCATTERBLOCK_ARGS);
+int ompi_coll_tuned_reduce_scatter_block_intra_ring(REDUCESCATTERBLOCK_ARGS);
+int ompi_coll_tuned_reduce_scatter_block_intra_pairwise(REDUCESCATTERBLOCK_ARGS);
+
 /* Scan */
 int ompi_coll_tuned_scan_intra_dec_fixed(SCAN_ARGS);
 int ompi_coll_tuned_scan_intra_dec_dynamic(SCAN_ARGS);
+int ompi_coll_tuned_scan_intra_do_forced(SCAN_ARGS);
+int ompi_coll_tuned_scan_intra_do_this(SCAN_ARGS, int algorithm, int faninout, int segsize);
+int ompi_coll_tuned_scan_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
+int ompi_coll_tuned_scan_intra_basic_linear(SCAN_ARGS);
+int ompi_coll_tuned_scan_intra_recursivedoubling(SCAN_ARGS);
+int ompi_coll_tuned_scan_intra_binomial(SCAN_ARGS);
+int ompi_coll_tuned_scan_intra_hierarchical(SCAN_ARGS);
+/* the prefix engines shared by scan and exscan (exclusive != 0) */
+int ompi_coll_tuned_prefix_recursivedoubling(void *sbuf, void *rbuf, int count,
+                                             struct ompi_datatype_t *dtype,
+                                             struct ompi_op_t *op, int exclusive,
+                                             int *ranks, int first, int n, int vrank,
+                                             int tag,
+                                             struct ompi_communicator_t *comm);
+int ompi_coll_tuned_prefix_binomial(void *buf, int count, struct ompi_datatype_t *dtype,
+                                    struct ompi_op_t *op, int tag,
+                                    struct ompi_communicator_t *comm);
+int ompi_coll_tuned_prefix_hierarchical(void *sbuf, void *rbuf, int count,
+                                        struct ompi_datatype_t *dtype,
+                                        struct ompi_op_t *op, int exclusive, int tag,
+                                        struct ompi_communicator_t *comm,
+                                        mca_coll_base_module_t *module);
 int ompi_coll_tuned_scan_inter_dec_fixed(SCAN_ARGS);
 int ompi_coll_tuned_scan_inter_dec_dynamic(SCAN_ARGS);
 
@@ -309,12 +371,18 @@ int ompi_coll_tuned_scatter_intra_do_this(SCATTER_ARGS, int algorithm, int fanin
 int ompi_coll_tuned_scatter_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 int ompi_coll_tuned_scatter_intra_basic_linear(SCATTER_ARGS);
 int ompi_coll_tuned_scatter_intra_binomial(SCATTER_ARGS);
+int ompi_coll_tuned_scatter_intra_knomial(SCATTER_ARGS, int radix);
 int ompi_coll_tuned_scatter_inter_dec_fixed(SCATTER_ARGS);
 int ompi_coll_tuned_scatter_inter_dec_dynamic(SCATTER_ARGS);
 
 /* ScatterV */
 int ompi_coll_tuned_scatterv_intra_dec_fixed(SCATTERV_ARGS);
 int ompi_coll_tuned_scatterv_intra_dec_dynamic(SCATTERV_ARGS);
+int ompi_coll_tuned_scatterv_intra_do_forced(SCATTERV_ARGS);
+int ompi_coll_tuned_scatterv_intra_do_this(SCATTERV_ARGS, int algorithm, int faninout, int segsize);
+int ompi_coll_tuned_scatterv_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
+int ompi_coll_tuned_scatterv_intra_basic_linear(SCATTERV_ARGS);
+int ompi_coll_tuned_scatterv_intra_binomial(SCATTERV_ARGS);
 int ompi_coll_tuned_scatterv_inter_dec_fixed(SCATTERV_ARGS);
 int ompi_coll_tuned_scatterv_inter_dec_dynamic(SCATTERV_ARGS);
 
@@ -395,6 +463,16 @@ struct mca_coll_tuned_comm_t {
 	ompi_coll_tree_t *cached_in_order_bmtree;
 	int cached_in_order_bmtree_root;
     
+	/* k-nomial tree, childs ordered for the network */
+	ompi_coll_tree_t *cached_kmtree;
+	int cached_kmtree_root;
+	int cached_kmtree_radix;
+    
+	/* k-nomial tree, childs in rank order */
+	ompi_coll_tree_t *cached_in_order_kmtree;
+	int cached_in_order_kmtree_root;
+	int cached_in_order_kmtree_radix;
+    
 	/* chained tree (fanout followed by pipelines) */
 	ompi_coll_tree_t *cached_chain;
 	int cached_chain_root;
@@ -406,6 +484,27 @@ struct mca_coll_tuned_comm_t {
     
 	/* in-order binary tree (root of the in-order binary tree is rank 0) */
 	ompi_coll_tree_t *cached_in_order_bintree;
+
+	/* nodes, for the hierarchical algorithms: number of nodes (0 not
+	 * computed yet, -1 unknown), first rank of every node, ranks of mine;
+	 * when the ranks of every node are consecutive, the range of my node
+	 * and the last rank of every node */
+	int cached_node_count;
+	int *cached_node_leaders;
+	int *cached_node_peers;
+	int cached_node_size;
+	int cached_node_consecutive;
+	int cached_node_lo;
+	int cached_node_hi;
+	int *cached_node_last;
+
+	/* scratch space for the temporaries of the algorithms, kept across
+	 * calls (and registered when an mpool can do it) instead of being
+	 * allocated by every call; NULL until first used */
+	char *mcct_scratch;
+	size_t mcct_scratch_size;
+	bool mcct_scratch_registered;
+	bool mcct_scratch_busy;
 	
 	/* moving to the component */
 	ompi_coll_com_rule_t *com_rules[COLLCOUNT]; /* the communicator rules for each MPI collective for ONLY my comsize */
@@ -413,6 +512,9 @@ struct mca_coll_tuned_comm_t {
 	/* for forced algorithms we store the information on the module */
 	/* previously we only had one shared copy, ops, it really is per comm/module */
 	coll_tuned_force_algorithm_params_t user_forced[COLLCOUNT];
+
+	/* online autotuning state for each MPI collective (NULL if not autotuned) */
+	struct ompi_coll_tuned_autotune_t *autotune[COLLCOUNT];
 };
 typedef struct mca_coll_tuned_comm_t mca_coll_tuned_comm_t;
 
@@ -420,10 +522,43 @@ struct mca_coll_tuned_module_t {
 	mca_coll_base_module_t super;
     
 	mca_coll_tuned_comm_t *tuned_data;
+
+#if OMPI_ENABLE_PVAR_COUNTERS
+    /* decision functions behind the counting wrappers of coll_tuned_pvar.c */
+    mca_coll_base_module_allgather_fn_t pvar_allgather;
+    mca_coll_base_module_allgatherv_fn_t pvar_allgatherv;
+    mca_coll_base_module_allreduce_fn_t pvar_allreduce;
+    mca_coll_base_module_alltoall_fn_t pvar_alltoall;
+    mca_coll_base_module_alltoallv_fn_t pvar_alltoallv;
+    mca_coll_base_module_barrier_fn_t pvar_barrier;
+    mca_coll_base_module_bcast_fn_t pvar_bcast;
+    mca_coll_base_module_exscan_fn_t pvar_exscan;
+    mca_coll_base_module_gather_fn_t pvar_gather;
+    mca_coll_base_module_gatherv_fn_t pvar_gatherv;
+    mca_coll_base_module_reduce_fn_t pvar_reduce;
+    mca_coll_base_module_reduce_scatter_fn_t pvar_reduce_scatter;
+    mca_coll_base_module_reduce_scatter_block_fn_t pvar_reduce_scatter_block;
+    mca_coll_base_module_scan_fn_t pvar_scan;
+    mca_coll_base_module_scatter_fn_t pvar_scatter;
+    mca_coll_base_module_scatterv_fn_t pvar_scatterv;
+#endif  /* OMPI_ENABLE_PVAR_COUNTERS */
 };
 typedef struct mca_coll_tuned_module_t mca_coll_tuned_module_t;
 OBJ_CLASS_DECLARATION(mca_coll_tuned_module_t);
 
+/* MPI_T counters and timers of the collectives (coll_tuned_pvar.c) */
+int ompi_coll_tuned_pvar_register(void);
+void ompi_coll_tuned_pvar_install(mca_coll_tuned_module_t *tuned_module);
+
+/* scratch space of the communicator (coll_tuned_util.c) */
+void *ompi_coll_tuned_scratch_get(mca_coll_tuned_comm_t *data, size_t size);
+void ompi_coll_tuned_scratch_put(mca_coll_tuned_comm_t *data, void *buf);
+void ompi_coll_tuned_scratch_release(mca_coll_tuned_comm_t *data);
+
+/* nodes of the communicator (coll_tuned_util.c) */
+int ompi_coll_tuned_get_node_layout(struct ompi_communicator_t *comm,
+                                    mca_coll_tuned_comm_t *data);
+
 END_C_DECLS
 
 #define COLL_TUNED_UPDATE_BINTREE( OMPI_COMM, TUNED_MODULE, ROOT )	\
@@ -465,6 +600,41 @@ do {
     }                                                                                        \
 } while (0)
 
+/* the radix of the knomial algorithms: the fanout given by the forced
+ * parameters or the rules, or the component default */
+#define COLL_TUNED_KNOMIAL_RADIX( FANOUT )                                   \
+    (((FANOUT) >= 2) ? (FANOUT) : ompi_coll_tuned_knomial_radix)
+
+#define COLL_TUNED_UPDATE_KMTREE( OMPI_COMM, TUNED_MODULE, ROOT, RADIX )	\
+do {                                                                                         \
+    mca_coll_tuned_comm_t* coll_comm = (TUNED_MODULE)->tuned_data;                           \
+    if( !( (coll_comm->cached_kmtree)                                                        \
+           && (coll_comm->cached_kmtree_root == (ROOT))                                      \
+           && (coll_comm->cached_kmtree_radix == (RADIX)) ) ) {                              \
+        if( coll_comm->cached_kmtree ) { /* destroy previous k-nomial if defined */          \
+            ompi_coll_tuned_topo_destroy_tree( &(coll_comm->cached_kmtree) );                \
+        }                                                                                    \
+        coll_comm->cached_kmtree = ompi_coll_tuned_topo_build_kmtree( (OMPI_COMM), (ROOT), (RADIX), true ); \
+        coll_comm->cached_kmtree_root = (ROOT);                                              \
+        coll_comm->cached_kmtree_radix = (RADIX);                                            \
+    }                                                                                        \
+} while (0)
+
+#define COLL_TUNED_UPDATE_IN_ORDER_KMTREE( OMPI_COMM, TUNED_MODULE, ROOT, RADIX ) \
+do {                                                                                         \
+    mca_coll_tuned_comm_t* coll_comm = (TUNED_MODULE)->tuned_data;                           \
+    if( !( (coll_comm->cached_in_order_kmtree)                                               \
+           && (coll_comm->cached_in_order_kmtree_root == (ROOT))                             \
+           && (coll_comm->cached_in_order_kmtree_radix == (RADIX)) ) ) {                     \
+        if( coll_comm->cached_in_order_kmtree ) { /* destroy previous k-nomial if defined */ \
+            ompi_coll_tuned_topo_destroy_tree( &(coll_comm->cached_in_order_kmtree) );       \
+        }                                                                                    \
+        coll_comm->cached_in_order_kmtree = ompi_coll_tuned_topo_build_kmtree( (OMPI_COMM), (ROOT), (RADIX), false ); \
+        coll_comm->cached_in_order_kmtree_root = (ROOT);                                     \
+        coll_comm->cached_in_order_kmtree_radix = (RADIX);                                   \
+    }                                                                                        \
+} while (0)
+
 #define COLL_TUNED_UPDATE_PIPELINE( OMPI_COMM, TUNED_MODULE, ROOT )	\
 do {                                                                                             \
     mca_coll_tuned_comm_t* coll_comm = (TUNED_MODULE)->tuned_data;                               \
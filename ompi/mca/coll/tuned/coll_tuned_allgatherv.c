@@ -33,7 +33,7 @@
 #include "coll_tuned_util.h"
 
 /* allgatherv algorithm variables */
-static int coll_tuned_allgatherv_algorithm_count = 5;
+static int coll_tuned_allgatherv_algorithm_count = 6;
 static int coll_tuned_allgatherv_forced_algorithm = 0;
 static int coll_tuned_allgatherv_segment_size = 0;
 static int coll_tuned_allgatherv_tree_fanout;
@@ -47,6 +47,7 @@ static mca_base_var_enum_value_t allgatherv_algorithms[] = {
     {3, "ring"},
     {4, "neighbor"},
     {5, "two_proc"},
+    {6, "ring_segmented"},
     {0, NULL}
 };
 
@@ -572,6 +573,122 @@ int ompi_coll_tuned_allgatherv_intra_two_procs(void *sbuf, int scount,
 }
 
 
+/*
+ * ompi_coll_tuned_allgatherv_intra_ring_segmented
+ *
+ * Function:     allgatherv along the ring, streamed in segments.
+ * Accepts:      Same arguments as MPI_Allgatherv, segment size in bytes
+ * Returns:      MPI_SUCCESS or error code
+ *
+ * Description:  Every process sends to rank + 1 the blocks of
+ *               rank, rank - 1, ..., rank - size + 2 and receives from
+ *               rank - 1 the blocks of rank - 1, ..., rank - size + 1, as
+ *               in the ring algorithm, but one segment at a time and
+ *               without a common step: a segment is forwarded as soon as
+ *               it has arrived.  With the plain ring every step lasts as
+ *               long as its largest block, so a single large block slows
+ *               down all the steps; here it flows through the ring while
+ *               the small blocks go around it.  Empty blocks are skipped
+ *               on both sides.
+ * Memory requirements:
+ *               No additional memory requirements.
+ */
+int ompi_coll_tuned_allgatherv_intra_ring_segmented(void *sbuf, int scount,
+                                                    struct ompi_datatype_t *sdtype,
+                                                    void* rbuf, int *rcounts, int *rdisps,
+                                                    struct ompi_datatype_t *rdtype,
+                                                    struct ompi_communicator_t *comm,
+                                                    mca_coll_base_module_t *module,
+                                                    int segsize)
+{
+    int line = -1, rank, size, sendto, recvfrom, i, err = 0, nreqs;
+    int sstep = 0, rstep = 0, soffset = 0, roffset = 0;
+    int sblock = 0, rblock = 0, scnt = 0, rcnt = 0, segcount = 0;
+    ptrdiff_t rlb, rext;
+    size_t typelng;
+    ompi_request_t *reqs[2];
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:allgatherv_intra_ring_segmented rank %d segsize %d", rank, segsize));
+
+    err = ompi_datatype_get_extent (rdtype, &rlb, &rext);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    ompi_datatype_type_size(rdtype, &typelng);
+
+    if (MPI_IN_PLACE != sbuf) {
+        err = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                   (char*)rbuf + (ptrdiff_t)rdisps[rank] * rext,
+                                   rcounts[rank], rdtype);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl;  }
+    }
+
+    /* a segment size of 0 means whole blocks */
+    for (i = 0; i < size; i++) {
+        if (rcounts[i] > segcount) segcount = rcounts[i];
+    }
+    COLL_TUNED_COMPUTED_SEGCOUNT( (size_t)segsize, typelng, segcount );
+
+    sendto = (rank + 1) % size;
+    recvfrom = (rank - 1 + size) % size;
+
+    /* sstep k sends the block of rank - k, rstep k receives the block of
+       rank - k - 1, so the block of sstep k is the one of rstep k - 1 */
+    for (;;) {
+        while ((sstep < size - 1) && (0 == rcounts[(rank - sstep + size) % size])) sstep++;
+        while ((rstep < size - 1) && (0 == rcounts[(rank - rstep - 1 + size) % size])) rstep++;
+        if ((sstep == size - 1) && (rstep == size - 1)) break;
+
+        nreqs = 0;
+        rcnt = scnt = 0;
+        if (rstep < size - 1) {
+            rblock = (rank - rstep - 1 + size) % size;
+            rcnt = rcounts[rblock] - roffset;
+            if (rcnt > segcount) rcnt = segcount;
+            err = MCA_PML_CALL(irecv((char*)rbuf + ((ptrdiff_t)rdisps[rblock] + roffset) * rext,
+                                     rcnt, rdtype, recvfrom, MCA_COLL_BASE_TAG_ALLGATHERV,
+                                     comm, &reqs[nreqs++]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+        if (sstep < size - 1) {
+            sblock = (rank - sstep + size) % size;
+            scnt = rcounts[sblock] - soffset;
+            if (scnt > segcount) scnt = segcount;
+            /* forward only what has already arrived */
+            if ((0 == sstep) || (rstep > sstep - 1) || (soffset + scnt <= roffset)) {
+                err = MCA_PML_CALL(isend((char*)rbuf + ((ptrdiff_t)rdisps[sblock] + soffset) * rext,
+                                         scnt, rdtype, sendto, MCA_COLL_BASE_TAG_ALLGATHERV,
+                                         MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            } else {
+                scnt = 0;
+            }
+        }
+
+        err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+        if (rcnt > 0) {
+            roffset += rcnt;
+            if (roffset == rcounts[rblock]) { rstep++; roffset = 0; }
+        }
+        if (scnt > 0) {
+            soffset += scnt;
+            if (soffset == rcounts[sblock]) { sstep++; soffset = 0; }
+        }
+    }
+
+    return OMPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream,  "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    return err;
+}
+
+
 /*
  * Linear functions are copied from the BASIC coll module
  * they do not segment the message and are simple implementations
@@ -705,7 +822,7 @@ ompi_coll_tuned_allgatherv_intra_check_forced_init(coll_tuned_force_algorithm_mc
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "allgatherv_algorithm",
-                                        "Which allallgatherv algorithm is used. Can be locked down to choice of: 0 ignore, 1 default (allgathervv + bcast), 2 bruck, 3 ring, 4 neighbor exchange, 5: two proc only.",
+                                        "Which allallgatherv algorithm is used. Can be locked down to choice of: 0 ignore, 1 default (allgathervv + bcast), 2 bruck, 3 ring, 4 neighbor exchange, 5: two proc only, 6 segmented ring (segment size from allgatherv_algorithm_segmentsize).",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_READONLY,
@@ -719,7 +836,7 @@ ompi_coll_tuned_allgatherv_intra_check_forced_init(coll_tuned_force_algorithm_mc
     mca_param_indices->segsize_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "allgatherv_algorithm_segmentsize",
-                                        "Segment size in bytes used by default for allgatherv algorithms. Only has meaning if algorithm is forced and supports segmenting. 0 bytes means no segmentation. Currently, available algorithms do not support segmentation.",
+                                        "Segment size in bytes used by default for allgatherv algorithms. Only has meaning if algorithm is forced and supports segmenting. 0 bytes means no segmentation. Only the segmented ring supports segmentation.",
                                         MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_READONLY,
@@ -788,6 +905,11 @@ int ompi_coll_tuned_allgatherv_intra_do_forced(void *sbuf, int scount,
         return ompi_coll_tuned_allgatherv_intra_two_procs (sbuf, scount, sdtype, 
                                                            rbuf, rcounts, rdispls, rdtype, 
                                                            comm, module);
+    case (6):
+        return ompi_coll_tuned_allgatherv_intra_ring_segmented (sbuf, scount, sdtype,
+                                                                rbuf, rcounts, rdispls, rdtype,
+                                                                comm, module,
+                                                                data->user_forced[ALLGATHERV].segsize);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,
                      "coll:tuned:allgatherv_intra_do_forced attempt to select algorithm %d when only 0-%d is valid?", 
@@ -838,6 +960,10 @@ int ompi_coll_tuned_allgatherv_intra_do_this(void *sbuf, int scount,
         return ompi_coll_tuned_allgatherv_intra_two_procs (sbuf, scount, sdtype,
                                                            rbuf, rcounts, rdispls, rdtype, 
                                                            comm, module);
+    case (6):
+        return ompi_coll_tuned_allgatherv_intra_ring_segmented (sbuf, scount, sdtype,
+                                                                rbuf, rcounts, rdispls, rdtype,
+                                                                comm, module, segsize);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,
                      "coll:tuned:allgatherv_intra_do_this attempt to select algorithm %d when only 0-%d is valid?", 
@@ -36,11 +36,12 @@
 #include "coll_tuned_util.h"
 
 /* allreduce algorithm variables */
-static int coll_tuned_allreduce_algorithm_count = 5;
+static int coll_tuned_allreduce_algorithm_count = 6;
 static int coll_tuned_allreduce_forced_algorithm = 0;
 static int coll_tuned_allreduce_segment_size = 0;
 static int coll_tuned_allreduce_tree_fanout;
 static int coll_tuned_allreduce_chain_fanout;
+int ompi_coll_tuned_allreduce_ring_count = 1;
 
 /* valid values for coll_tuned_allreduce_forced_algorithm */
 static mca_base_var_enum_value_t allreduce_algorithms[] = {
@@ -50,6 +51,7 @@ static mca_base_var_enum_value_t allreduce_algorithms[] = {
     {3, "recursive_doubling"},
     {4, "ring"},
     {5, "segmented_ring"},
+    {6, "pipelined_ring"},
     {0, NULL}
 };
 
@@ -150,6 +152,7 @@ ompi_coll_tuned_allreduce_intra_recursivedoubling(void *sbuf, void *rbuf,
 {
     int ret, line, rank, size, adjsize, remote, distance;
     int newrank, newremote, extra_ranks;
+    mca_coll_tuned_comm_t *data = ((mca_coll_tuned_module_t*) module)->tuned_data;
     char *tmpsend = NULL, *tmprecv = NULL, *tmpswap = NULL, *inplacebuf = NULL;
     ptrdiff_t true_lb, true_extent, lb, extent;
     ompi_request_t *reqs[2] = {NULL, NULL};
@@ -175,7 +178,7 @@ ompi_coll_tuned_allreduce_intra_recursivedoubling(void *sbuf, void *rbuf,
     ret = ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
     if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
 
-    inplacebuf = (char*) malloc(true_extent + (ptrdiff_t)(count - 1) * extent);
+    inplacebuf = (char*) ompi_coll_tuned_scratch_get(data, true_extent + (ptrdiff_t)(count - 1) * extent);
     if (NULL == inplacebuf) { ret = -1; line = __LINE__; goto error_hndl; }
 
     if (MPI_IN_PLACE == sbuf) {
@@ -283,13 +286,13 @@ ompi_coll_tuned_allreduce_intra_recursivedoubling(void *sbuf, void *rbuf,
         if (ret < 0) { line = __LINE__; goto error_hndl; }
     }
 
-    if (NULL != inplacebuf) free(inplacebuf);
+    ompi_coll_tuned_scratch_put(data, inplacebuf);
     return MPI_SUCCESS;
 
  error_hndl:
     OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tRank %d Error occurred %d\n",
                  __FILE__, line, rank, ret));
-    if (NULL != inplacebuf) free(inplacebuf);
+    ompi_coll_tuned_scratch_put(data, inplacebuf);
     return ret;
 }
 
@@ -367,6 +370,7 @@ ompi_coll_tuned_allreduce_intra_ring(void *sbuf, void *rbuf, int count,
     int ret, line, rank, size, k, recv_from, send_to, block_count, inbi;
     int early_segcount, late_segcount, split_rank, max_segcount;
     size_t typelng;
+    mca_coll_tuned_comm_t *data = ((mca_coll_tuned_module_t*) module)->tuned_data;
     char *tmpsend = NULL, *tmprecv = NULL, *inbuf[2] = {NULL, NULL};
     ptrdiff_t true_lb, true_extent, lb, extent;
     ptrdiff_t block_offset, max_real_segsize;
@@ -417,11 +421,10 @@ ompi_coll_tuned_allreduce_intra_ring(void *sbuf, void *rbuf, int count,
     max_real_segsize = true_extent + (max_segcount - 1) * extent;
 
 
-    inbuf[0] = (char*)malloc(max_real_segsize);
+    inbuf[0] = (char*)ompi_coll_tuned_scratch_get(data, ((size > 2) ? 2 : 1) * max_real_segsize);
     if (NULL == inbuf[0]) { ret = -1; line = __LINE__; goto error_hndl; }
     if (size > 2) {
-        inbuf[1] = (char*)malloc(max_real_segsize);
-        if (NULL == inbuf[1]) { ret = -1; line = __LINE__; goto error_hndl; }
+        inbuf[1] = inbuf[0] + max_real_segsize;
     }
 
     /* Handle MPI_IN_PLACE */
@@ -540,16 +543,14 @@ ompi_coll_tuned_allreduce_intra_ring(void *sbuf, void *rbuf, int count,
 
     }
 
-    if (NULL != inbuf[0]) free(inbuf[0]);
-    if (NULL != inbuf[1]) free(inbuf[1]);
+    ompi_coll_tuned_scratch_put(data, inbuf[0]);
 
     return MPI_SUCCESS;
 
  error_hndl:
     OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tRank %d Error occurred %d\n",
                  __FILE__, line, rank, ret));
-    if (NULL != inbuf[0]) free(inbuf[0]);
-    if (NULL != inbuf[1]) free(inbuf[1]);
+    ompi_coll_tuned_scratch_put(data, inbuf[0]);
     return ret;
 }
 
@@ -872,6 +873,286 @@ ompi_coll_tuned_allreduce_intra_ring_segmented(void *sbuf, void *rbuf, int count
     return ret;
 }
 
+/*
+ *   ompi_coll_tuned_allreduce_intra_ring_pipelined
+ *
+ *   Function:       Pipelined ring algorithm for allreduce operation
+ *   Accepts:        Same as MPI_Allreduce(), segment size and number of rings
+ *   Returns:        MPI_SUCCESS or error code
+ *
+ *   Description:    As in the ring algorithm, the buffer is split into one
+ *                   block per process, and the reduce-scatter and allgather
+ *                   steps are run around the ring. Each block is further split
+ *                   into segments, which are streamed instead of being handled
+ *                   one step at a time: a segment is forwarded to the right
+ *                   neighbor (with a non-blocking send) as soon as it has been
+ *                   reduced, and the receives of the next segments are already
+ *                   posted, so the reduction of a segment overlaps with the
+ *                   transfer of the following ones.
+ *
+ *                   The buffer can also be divided between several rings
+ *                   running at the same time, every other ring going in the
+ *                   opposite direction, so that both directions of the links
+ *                   (and more than one rail) are used.
+ *
+ *                   All messages between two processes are sent and the
+ *                   matching receives are posted in the same (step, segment,
+ *                   ring) order, which keeps the matching correct with a single
+ *                   tag. A send slot is only reused after the previous send
+ *                   from this slot completed, and the receives are posted
+ *                   COLL_TUNED_RING_PIPELINE_DEPTH segments ahead.
+ *
+ *                   Limitations: The algorithm DOES NOT preserve order of
+ *                   operations so it can be used only for commutative
+ *                   operations.
+ */
+#define COLL_TUNED_RING_PIPELINE_DEPTH 2
+
+typedef struct {
+    ptrdiff_t offset;  /* first element of this ring in rbuf */
+    int split_rank, early_blockcount, late_blockcount;
+    int vrank, send_to, recv_from;
+    char *inbuf[COLL_TUNED_RING_PIPELINE_DEPTH];
+    ompi_request_t *rreqs[COLL_TUNED_RING_PIPELINE_DEPTH];
+    ompi_request_t **sreqs;  /* one per segment of a block */
+} coll_tuned_allreduce_ring_t;
+
+/* Position (in elements) and count of a segment of a block of a ring */
+static inline int
+coll_tuned_ring_segment(const coll_tuned_allreduce_ring_t *ring, int size,
+                        int block, int seg, int segcount, ptrdiff_t *offset)
+{
+    int block_count, count;
+
+    block = (block + size) % size;
+    block_count = ((block < ring->split_rank)? ring->early_blockcount : ring->late_blockcount);
+    *offset = ring->offset + (ptrdiff_t)seg * (ptrdiff_t)segcount +
+        ((block < ring->split_rank)?
+         ((ptrdiff_t)block * (ptrdiff_t)ring->early_blockcount) :
+         ((ptrdiff_t)block * (ptrdiff_t)ring->late_blockcount + ring->split_rank));
+    count = block_count - seg * segcount;
+    return ((count < 0)? 0 : ((count > segcount)? segcount : count));
+}
+
+/*
+ * One of the two halves of the algorithm: the reduce-scatter (reduce != 0),
+ * where the received segments are reduced in rbuf, or the allgather, where
+ * they are received in place. In both cases the block received at step k is
+ * the one sent at step k + 1.
+ */
+static int
+coll_tuned_allreduce_ring_pipelined_phase(coll_tuned_allreduce_ring_t *rings, int nrings,
+                                          int nseg, int segcount, int reduce,
+                                          char *rbuf, struct ompi_datatype_t *dtype,
+                                          struct ompi_op_t *op,
+                                          struct ompi_communicator_t *comm)
+{
+    const int size = ompi_comm_size(comm);
+    const int total = (size - 1) * nseg;  /* segments received per ring */
+    ptrdiff_t extent, lb, offset;
+    int ret, r, p, k, s, scount, slot;
+    char *buf;
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+
+    /* Post the first receives. The block received at step k is
+       (vrank - k - 1) in the reduce-scatter and (vrank - k) in the allgather. */
+    for (p = 0; (p < COLL_TUNED_RING_PIPELINE_DEPTH) && (p < total); p++) {
+        for (r = 0; r < nrings; r++) {
+            scount = coll_tuned_ring_segment(&rings[r], size, rings[r].vrank - p / nseg - reduce,
+                                             p % nseg, segcount, &offset);
+            buf = (reduce? rings[r].inbuf[p] : rbuf + offset * extent);
+            ret = MCA_PML_CALL(irecv(buf, scount, dtype, rings[r].recv_from,
+                                     MCA_COLL_BASE_TAG_ALLREDUCE, comm, &rings[r].rreqs[p]));
+            if (MPI_SUCCESS != ret) { return ret; }
+        }
+    }
+
+    /* Send the first block: mine in the reduce-scatter, the one I reduced
+       in the allgather */
+    for (s = 0; s < nseg; s++) {
+        for (r = 0; r < nrings; r++) {
+            scount = coll_tuned_ring_segment(&rings[r], size, rings[r].vrank + 1 - reduce,
+                                             s, segcount, &offset);
+            ret = MCA_PML_CALL(isend(rbuf + offset * extent, scount, dtype, rings[r].send_to,
+                                     MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &rings[r].sreqs[s]));
+            if (MPI_SUCCESS != ret) { return ret; }
+        }
+    }
+
+    for (p = 0; p < total; p++) {
+        k = p / nseg;
+        s = p % nseg;
+        slot = p % COLL_TUNED_RING_PIPELINE_DEPTH;
+        for (r = 0; r < nrings; r++) {
+            scount = coll_tuned_ring_segment(&rings[r], size, rings[r].vrank - k - reduce,
+                                             s, segcount, &offset);
+            ret = ompi_request_wait(&rings[r].rreqs[slot], MPI_STATUS_IGNORE);
+            if (MPI_SUCCESS != ret) { return ret; }
+            if (reduce) {
+                ompi_op_reduce(op, rings[r].inbuf[slot], rbuf + offset * extent, scount, dtype);
+            }
+
+            /* the slot is free again, receive the segment after the next one */
+            if (p + COLL_TUNED_RING_PIPELINE_DEPTH < total) {
+                const int np = p + COLL_TUNED_RING_PIPELINE_DEPTH;
+                ptrdiff_t noffset;
+                int ncount = coll_tuned_ring_segment(&rings[r], size,
+                                                     rings[r].vrank - np / nseg - reduce,
+                                                     np % nseg, segcount, &noffset);
+                buf = (reduce? rings[r].inbuf[slot] : rbuf + noffset * extent);
+                ret = MCA_PML_CALL(irecv(buf, ncount, dtype, rings[r].recv_from,
+                                         MCA_COLL_BASE_TAG_ALLREDUCE, comm,
+                                         &rings[r].rreqs[slot]));
+                if (MPI_SUCCESS != ret) { return ret; }
+            }
+
+            /* forward the segment, unless this was the last step */
+            if (k < size - 2) {
+                ret = ompi_request_wait(&rings[r].sreqs[s], MPI_STATUS_IGNORE);
+                if (MPI_SUCCESS != ret) { return ret; }
+                ret = MCA_PML_CALL(isend(rbuf + offset * extent, scount, dtype, rings[r].send_to,
+                                         MCA_COLL_BASE_TAG_ALLREDUCE,
+                                         MCA_PML_BASE_SEND_STANDARD, comm, &rings[r].sreqs[s]));
+                if (MPI_SUCCESS != ret) { return ret; }
+            }
+        }
+    }
+
+    for (r = 0; r < nrings; r++) {
+        ret = ompi_request_wait_all(nseg, rings[r].sreqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != ret) { return ret; }
+    }
+    return MPI_SUCCESS;
+}
+
+int
+ompi_coll_tuned_allreduce_intra_ring_pipelined(void *sbuf, void *rbuf, int count,
+                                               struct ompi_datatype_t *dtype,
+                                               struct ompi_op_t *op,
+                                               struct ompi_communicator_t *comm,
+                                               mca_coll_base_module_t *module,
+                                               uint32_t segsize, int nrings)
+{
+    int ret, line, rank, size, r, i, segcount, nseg, max_blockcount;
+    int split_ring, early_ringcount, late_ringcount;
+    size_t typelng;
+    ptrdiff_t true_lb, true_extent, lb, extent, max_real_segsize;
+    coll_tuned_allreduce_ring_t *rings = NULL;
+    ompi_request_t **sreqs = NULL;
+    char *inbufs = NULL;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:allreduce_intra_ring_pipelined rank %d, count %d, rings %d",
+                 rank, count, nrings));
+
+    /* Special case for size == 1 */
+    if (1 == size) {
+        if (MPI_IN_PLACE != sbuf) {
+            ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+            if (ret < 0) { line = __LINE__; goto error_hndl; }
+        }
+        return MPI_SUCCESS;
+    }
+
+    ret = ompi_datatype_get_extent(dtype, &lb, &extent);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    ret = ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    ret = ompi_datatype_type_size( dtype, &typelng);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    segcount = count;
+    COLL_TUNED_COMPUTED_SEGCOUNT(segsize, typelng, segcount)
+
+    /* Every ring needs at least one full segment per process */
+    if (nrings > count / (size * segcount)) {
+        nrings = count / (size * segcount);
+    }
+    if (nrings < 1) {
+        OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:allreduce_ring_pipelined rank %d/%d, count %d, switching to regular ring", rank, size, count));
+        return (ompi_coll_tuned_allreduce_intra_ring(sbuf, rbuf, count, dtype, op,
+                                                     comm, module));
+    }
+
+    /* Split the buffer between the rings, and each part between the processes */
+    COLL_TUNED_COMPUTE_BLOCKCOUNT( count, nrings, split_ring,
+                                   early_ringcount, late_ringcount )
+    COLL_TUNED_COMPUTE_BLOCKCOUNT( early_ringcount, size, i,
+                                   max_blockcount, r )
+    nseg = (max_blockcount + segcount - 1) / segcount;
+    max_real_segsize = true_extent + (ptrdiff_t)(segcount - 1) * extent;
+
+    rings = (coll_tuned_allreduce_ring_t*)calloc(nrings, sizeof(coll_tuned_allreduce_ring_t));
+    sreqs = (ompi_request_t**)malloc(sizeof(ompi_request_t*) * nrings * nseg);
+    inbufs = (char*)malloc(max_real_segsize * nrings * COLL_TUNED_RING_PIPELINE_DEPTH);
+    if ((NULL == rings) || (NULL == sreqs) || (NULL == inbufs)) {
+        ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl;
+    }
+
+    for (r = 0; r < nrings; r++) {
+        coll_tuned_allreduce_ring_t *ring = &rings[r];
+        int ring_count = ((r < split_ring)? early_ringcount : late_ringcount);
+
+        ring->offset = ((r < split_ring)?
+                        ((ptrdiff_t)r * (ptrdiff_t)early_ringcount) :
+                        ((ptrdiff_t)r * (ptrdiff_t)late_ringcount + split_ring));
+        COLL_TUNED_COMPUTE_BLOCKCOUNT( ring_count, size, ring->split_rank,
+                                       ring->early_blockcount, ring->late_blockcount )
+        /* odd rings run in the other direction */
+        if (0 == (r & 0x1)) {
+            ring->vrank     = rank;
+            ring->send_to   = (rank + 1) % size;
+            ring->recv_from = (rank + size - 1) % size;
+        } else {
+            ring->vrank     = (size - rank) % size;
+            ring->send_to   = (rank + size - 1) % size;
+            ring->recv_from = (rank + 1) % size;
+        }
+        for (i = 0; i < COLL_TUNED_RING_PIPELINE_DEPTH; i++) {
+            ring->inbuf[i] = inbufs + (ptrdiff_t)(r * COLL_TUNED_RING_PIPELINE_DEPTH + i) * max_real_segsize - lb;
+            ring->rreqs[i] = MPI_REQUEST_NULL;
+        }
+        ring->sreqs = sreqs + r * nseg;
+        for (i = 0; i < nseg; i++) {
+            ring->sreqs[i] = MPI_REQUEST_NULL;
+        }
+    }
+
+    /* Handle MPI_IN_PLACE */
+    if (MPI_IN_PLACE != sbuf) {
+        ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+        if (ret < 0) { line = __LINE__; goto error_hndl; }
+    }
+
+    /* Reduce-scatter: process (vrank) ends up with the result of block (vrank + 1) */
+    ret = coll_tuned_allreduce_ring_pipelined_phase(rings, nrings, nseg, segcount, 1,
+                                                    (char*)rbuf, dtype, op, comm);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+    /* Distribution: ring allgather of the reduced blocks */
+    ret = coll_tuned_allreduce_ring_pipelined_phase(rings, nrings, nseg, segcount, 0,
+                                                    (char*)rbuf, dtype, op, comm);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+    free(inbufs);
+    free(sreqs);
+    free(rings);
+
+    return MPI_SUCCESS;
+
+ error_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tRank %d Error occurred %d\n",
+                 __FILE__, line, rank, ret));
+    if (NULL != inbufs) free(inbufs);
+    if (NULL != sreqs) free(sreqs);
+    if (NULL != rings) free(rings);
+    return ret;
+}
+
 /*
  * Linear functions are copied from the BASIC coll module
  * they do not segment the message and are simple implementations
@@ -961,7 +1242,7 @@ int ompi_coll_tuned_allreduce_intra_check_forced_init (coll_tuned_force_algorith
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "allreduce_algorithm",
-                                        "Which allreduce algorithm is used. Can be locked down to any of: 0 ignore, 1 basic linear, 2 nonoverlapping (tuned reduce + tuned bcast), 3 recursive doubling, 4 ring, 5 segmented ring",
+                                        "Which allreduce algorithm is used. Can be locked down to any of: 0 ignore, 1 basic linear, 2 nonoverlapping (tuned reduce + tuned bcast), 3 recursive doubling, 4 ring, 5 segmented ring, 6 pipelined ring",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_READONLY,
@@ -1001,6 +1282,15 @@ int ompi_coll_tuned_allreduce_intra_check_forced_init (coll_tuned_force_algorith
                                       MCA_BASE_VAR_SCOPE_READONLY,
                                       &coll_tuned_allreduce_chain_fanout);
 
+    ompi_coll_tuned_allreduce_ring_count = 1;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "allreduce_algorithm_ring_count",
+                                           "Number of rings run at the same time by the pipelined ring allreduce, every other ring going in the opposite direction. Use more than one to drive both directions of the links, or several rails.",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_allreduce_ring_count);
+
     return (MPI_SUCCESS);
 }
 
@@ -1025,6 +1315,7 @@ int ompi_coll_tuned_allreduce_intra_do_forced(void *sbuf, void *rbuf, int count,
     case (3):  return ompi_coll_tuned_allreduce_intra_recursivedoubling (sbuf, rbuf, count, dtype, op, comm, module);
     case (4):  return ompi_coll_tuned_allreduce_intra_ring (sbuf, rbuf, count, dtype, op, comm, module);
     case (5):  return ompi_coll_tuned_allreduce_intra_ring_segmented (sbuf, rbuf, count, dtype, op, comm, module, data->user_forced[ALLREDUCE].segsize);
+    case (6):  return ompi_coll_tuned_allreduce_intra_ring_pipelined (sbuf, rbuf, count, dtype, op, comm, module, data->user_forced[ALLREDUCE].segsize, ompi_coll_tuned_allreduce_ring_count);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:allreduce_intra_do_forced attempt to select algorithm %d when only 0-%d is valid?",
                      data->user_forced[ALLREDUCE].algorithm, 
@@ -1052,6 +1343,7 @@ int ompi_coll_tuned_allreduce_intra_do_this(void *sbuf, void *rbuf, int count,
     case (3):   return ompi_coll_tuned_allreduce_intra_recursivedoubling (sbuf, rbuf, count, dtype, op, comm, module);
     case (4):   return ompi_coll_tuned_allreduce_intra_ring (sbuf, rbuf, count, dtype, op, comm, module);
     case (5):   return ompi_coll_tuned_allreduce_intra_ring_segmented (sbuf, rbuf, count, dtype, op, comm, module, segsize);
+    case (6):   return ompi_coll_tuned_allreduce_intra_ring_pipelined (sbuf, rbuf, count, dtype, op, comm, module, segsize, ompi_coll_tuned_allreduce_ring_count);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:allreduce_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
                      algorithm, ompi_coll_tuned_forced_max_algorithms[ALLREDUCE]));
@@ -33,7 +33,7 @@
 #include "coll_tuned_util.h"
 
 /* alltoall algorithm variables */
-static int coll_tuned_alltoall_algorithm_count = 5;
+static int coll_tuned_alltoall_algorithm_count = 6;
 static int coll_tuned_alltoall_forced_algorithm = 0;
 static int coll_tuned_alltoall_segment_size = 0;
 static int coll_tuned_alltoall_max_requests;
@@ -48,6 +48,7 @@ static mca_base_var_enum_value_t alltoall_algorithms[] = {
     {3, "modified_bruck"},
     {4, "linear_sync"},
     {5, "two_proc"},
+    {6, "throttled"},
     {0, NULL}
 };
 
@@ -407,6 +408,55 @@ int ompi_coll_tuned_alltoall_intra_linear_sync(void *sbuf, int scount,
 }
 
 
+/*
+ * Function:       ompi_coll_tuned_alltoall_intra_throttled
+ *
+ * Description:    Linear exchange with a limited number of outstanding
+ *                 requests, as linear_sync, but with separate windows for
+ *                 the peers on the node and for the other ones. The peers
+ *                 are served in the order of the pairwise exchange, so
+ *                 that the messages of each step find their receive.
+ */
+int ompi_coll_tuned_alltoall_intra_throttled(void *sbuf, int scount,
+                                             struct ompi_datatype_t *sdtype,
+                                             void* rbuf, int rcount,
+                                             struct ompi_datatype_t *rdtype,
+                                             struct ompi_communicator_t *comm,
+                                             mca_coll_base_module_t *module,
+                                             int max_outstanding_reqs)
+{
+    int error, rank;
+    char *psnd, *prcv;
+    ptrdiff_t slb, sext, rlb, rext;
+
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_alltoall_intra_throttled rank %d", rank));
+
+    error = ompi_datatype_get_extent(sdtype, &slb, &sext);
+    if (OMPI_SUCCESS != error) {
+        return error;
+    }
+    error = ompi_datatype_get_extent(rdtype, &rlb, &rext);
+    if (OMPI_SUCCESS != error) {
+        return error;
+    }
+
+    psnd = ((char *) sbuf) + (ptrdiff_t)rank * sext * scount;
+    prcv = ((char *) rbuf) + (ptrdiff_t)rank * rext * rcount;
+    error = ompi_datatype_sndrcv(psnd, scount, sdtype, prcv, rcount, rdtype);
+    if (MPI_SUCCESS != error) {
+        return error;
+    }
+
+    return ompi_coll_tuned_exchange_throttled(sbuf, NULL, NULL, scount, sdtype,
+                                              rbuf, NULL, NULL, rcount, rdtype,
+                                              MCA_COLL_BASE_TAG_ALLTOALL, comm,
+                                              max_outstanding_reqs, 0);
+}
+
+
 int ompi_coll_tuned_alltoall_intra_two_procs(void *sbuf, int scount,
                                              struct ompi_datatype_t *sdtype,
                                              void* rbuf, int rcount,
@@ -621,7 +671,7 @@ int ompi_coll_tuned_alltoall_intra_check_forced_init (coll_tuned_force_algorithm
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "alltoall_algorithm",
-                                        "Which alltoall algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 pairwise, 3: modified bruck, 4: linear with sync, 5:two proc only.",
+                                        "Which alltoall algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 pairwise, 3: modified bruck, 4: linear with sync, 5:two proc only, 6: throttled (node aware linear with sync).",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_READONLY,
@@ -665,7 +715,7 @@ int ompi_coll_tuned_alltoall_intra_check_forced_init (coll_tuned_force_algorithm
     mca_param_indices->max_requests_param_index = 
       mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                       "alltoall_algorithm_max_requests",
-                                      "Maximum number of outstanding send or recv requests.  Only has meaning for synchronized algorithms.",
+                                      "Maximum number of outstanding send or recv requests.  Only has meaning for synchronized algorithms (for the throttled algorithm, towards the other nodes, 0 meaning the system level default).",
                                       MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
                                       OPAL_INFO_LVL_5,
                                       MCA_BASE_VAR_SCOPE_READONLY,
@@ -707,6 +757,9 @@ int ompi_coll_tuned_alltoall_intra_do_forced(void *sbuf, int scount,
     case (3):   return ompi_coll_tuned_alltoall_intra_bruck (sbuf, scount, sdtype, rbuf, rcount, rdtype, comm, module);
     case (4):   return ompi_coll_tuned_alltoall_intra_linear_sync (sbuf, scount, sdtype, rbuf, rcount, rdtype, comm, module, data->user_forced[ALLTOALL].max_requests);
     case (5):   return ompi_coll_tuned_alltoall_intra_two_procs (sbuf, scount, sdtype, rbuf, rcount, rdtype, comm, module);
+    case (6):   return ompi_coll_tuned_alltoall_intra_throttled (sbuf, scount, sdtype, rbuf, rcount, rdtype, comm, module,
+                                                                 (0 < data->user_forced[ALLTOALL].max_requests) ?
+                                                                 data->user_forced[ALLTOALL].max_requests : ompi_coll_tuned_init_max_requests);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:alltoall_intra_do_forced attempt to select algorithm %d when only 0-%d is valid?", 
                      data->user_forced[ALLTOALL].algorithm, ompi_coll_tuned_forced_max_algorithms[ALLTOALL]));
@@ -735,6 +788,8 @@ int ompi_coll_tuned_alltoall_intra_do_this(void *sbuf, int scount,
     case (3):   return ompi_coll_tuned_alltoall_intra_bruck (sbuf, scount, sdtype, rbuf, rcount, rdtype, comm, module);
     case (4):   return ompi_coll_tuned_alltoall_intra_linear_sync (sbuf, scount, sdtype, rbuf, rcount, rdtype, comm, module, max_requests);
     case (5):   return ompi_coll_tuned_alltoall_intra_two_procs (sbuf, scount, sdtype, rbuf, rcount, rdtype, comm, module);
+    case (6):   return ompi_coll_tuned_alltoall_intra_throttled (sbuf, scount, sdtype, rbuf, rcount, rdtype, comm, module,
+                                                                 (0 < max_requests) ? max_requests : ompi_coll_tuned_init_max_requests);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:alltoall_intra_do_this attempt to select algorithm %d when only 0-%d is valid?", 
                      algorithm, ompi_coll_tuned_forced_max_algorithms[ALLTOALL]));
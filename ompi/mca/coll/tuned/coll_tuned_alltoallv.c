@@ -34,14 +34,17 @@
 #include "coll_tuned_util.h"
 
 /* alltoallv algorithm variables */
-static int coll_tuned_alltoallv_algorithm_count = 2;
+static int coll_tuned_alltoallv_algorithm_count = 3;
 static int coll_tuned_alltoallv_forced_algorithm = 0;
+static int coll_tuned_alltoallv_max_requests = 0;
+static size_t coll_tuned_alltoallv_max_bytes = 1024 * 1024;
 
 /* valid values for coll_tuned_alltoallv_forced_algorithm */
 static mca_base_var_enum_value_t alltoallv_algorithms[] = {
     {0, "ignore"},
     {1, "basic_linear"},
     {2, "pairwise"},
+    {3, "throttled"},
     {0, NULL}
 };
 
@@ -201,6 +204,54 @@ ompi_coll_tuned_alltoallv_intra_basic_linear(void *sbuf, int *scounts, int *sdis
     return err;
 }
 
+/*
+ * Function:       ompi_coll_tuned_alltoallv_intra_throttled
+ *
+ * Description:    Linear exchange with a limited number of outstanding
+ *                 requests, with separate windows for the peers on the
+ *                 node and for the other ones (see
+ *                 ompi_coll_tuned_exchange_throttled). The window is also
+ *                 limited to max_bytes in each direction, so that many
+ *                 small messages are in flight together while the large
+ *                 ones go a few at a time.
+ */
+int
+ompi_coll_tuned_alltoallv_intra_throttled(void *sbuf, int *scounts, int *sdisps,
+                                          struct ompi_datatype_t *sdtype,
+                                          void *rbuf, int *rcounts, int *rdisps,
+                                          struct ompi_datatype_t *rdtype,
+                                          struct ompi_communicator_t *comm,
+                                          mca_coll_base_module_t *module,
+                                          int max_requests, size_t max_bytes)
+{
+    int rank, err;
+    char *psnd, *prcv;
+    ptrdiff_t sext, rext;
+
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:alltoallv_intra_throttled rank %d", rank));
+
+    ompi_datatype_type_extent(sdtype, &sext);
+    ompi_datatype_type_extent(rdtype, &rext);
+
+    psnd = ((char *) sbuf) + (ptrdiff_t)sdisps[rank] * sext;
+    prcv = ((char *) rbuf) + (ptrdiff_t)rdisps[rank] * rext;
+    if (0 != scounts[rank]) {
+        err = ompi_datatype_sndrcv(psnd, scounts[rank], sdtype,
+                                   prcv, rcounts[rank], rdtype);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    return ompi_coll_tuned_exchange_throttled(sbuf, scounts, sdisps, 0, sdtype,
+                                              rbuf, rcounts, rdisps, 0, rdtype,
+                                              MCA_COLL_BASE_TAG_ALLTOALLV, comm,
+                                              max_requests, max_bytes);
+}
+
 /* 
  * The following are used by dynamic and forced rules.  Publish
  * details of each algorithm and if its forced/fixed/locked in as you add
@@ -234,7 +285,7 @@ int ompi_coll_tuned_alltoallv_intra_check_forced_init(coll_tuned_force_algorithm
                                         "alltoallv_algorithm",
                                         "Which alltoallv algorithm is used. "
                                         "Can be locked down to choice of: 0 ignore, "
-                                        "1 basic linear, 2 pairwise.",
+                                        "1 basic linear, 2 pairwise, 3 throttled.",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_READONLY,
@@ -243,7 +294,40 @@ int ompi_coll_tuned_alltoallv_intra_check_forced_init(coll_tuned_force_algorithm
     if (mca_param_indices->algorithm_param_index < 0) {
         return mca_param_indices->algorithm_param_index;
     }
-    
+
+    coll_tuned_alltoallv_max_requests = 0; /* system level default */
+    mca_param_indices->max_requests_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "alltoallv_algorithm_max_requests",
+                                        "Maximum number of outstanding send or recv "
+                                        "requests towards the other nodes for the "
+                                        "throttled algorithm (0 for the system level default).",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_alltoallv_max_requests);
+    if (mca_param_indices->max_requests_param_index < 0) {
+        return mca_param_indices->max_requests_param_index;
+    }
+
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "alltoallv_algorithm_max_bytes",
+                                           "Maximum number of bytes in flight in each "
+                                           "direction for the throttled algorithm (at "
+                                           "least one message is always in flight, 0 for no limit).",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &coll_tuned_alltoallv_max_bytes);
+
+    if (coll_tuned_alltoallv_max_requests < 0) {
+        if( 0 == ompi_comm_rank( MPI_COMM_WORLD ) ) {
+            opal_output( 0, "Maximum outstanding requests must be positive number greater than 1.  Switching to system level default %d \n",
+                         ompi_coll_tuned_init_max_requests );
+        }
+        coll_tuned_alltoallv_max_requests = 0;
+    }
+
     return (MPI_SUCCESS);
 }
 
@@ -276,6 +360,14 @@ int ompi_coll_tuned_alltoallv_intra_do_forced(void *sbuf, int *scounts, int *sdi
         return ompi_coll_tuned_alltoallv_intra_pairwise(sbuf, scounts, sdisps, sdtype,
                                                         rbuf, rcounts, rdisps, rdtype,
                                                         comm, module);
+    case (3):
+        return ompi_coll_tuned_alltoallv_intra_throttled(sbuf, scounts, sdisps, sdtype,
+                                                         rbuf, rcounts, rdisps, rdtype,
+                                                         comm, module,
+                                                         (0 < data->user_forced[ALLTOALLV].max_requests) ?
+                                                         data->user_forced[ALLTOALLV].max_requests :
+                                                         ompi_coll_tuned_init_max_requests,
+                                                         coll_tuned_alltoallv_max_bytes);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,
                      "coll:tuned:alltoallv_intra_do_forced attempt to "
@@ -313,6 +405,12 @@ int ompi_coll_tuned_alltoallv_intra_do_this(void *sbuf, int *scounts, int *sdisp
         return ompi_coll_tuned_alltoallv_intra_pairwise(sbuf, scounts, sdisps, sdtype,
                                                         rbuf, rcounts, rdisps, rdtype,
                                                         comm, module);
+    case (3):
+        return ompi_coll_tuned_alltoallv_intra_throttled(sbuf, scounts, sdisps, sdtype,
+                                                         rbuf, rcounts, rdisps, rdtype,
+                                                         comm, module,
+                                                         ompi_coll_tuned_init_max_requests,
+                                                         coll_tuned_alltoallv_max_bytes);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,
                      "coll:tuned:alltoall_intra_do_this attempt to select "
@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2005 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "mpi.h"
+#include "opal/threads/mutex.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "coll_tuned.h"
+
+/* the dynamic rule structures and the file writer */
+#include "coll_tuned_dynamic_rules.h"
+#include "coll_tuned_dynamic_file.h"
+
+/* and our own prototypes */
+#include "coll_tuned_autotune.h"
+
+/*
+ * Candidate tables: the algorithms (and segment sizes) we are willing
+ * to try for each collective.  Algorithm numbers are the ones of the
+ * coll_tuned_<coll>_algorithm MCA parameters.  Tables end with
+ * algorithm 0.
+ */
+#define AT_CHAIN     0x1  /* uses the chain fanout instead of the tree one */
+#define AT_TWO_PROCS 0x2  /* only valid on communicators of size 2 */
+#define AT_WIDE      0x4  /* twice the fanout, for a flatter k-nomial tree */
+
+typedef struct autotune_entry_t {
+    int algorithm;
+    int segsize;
+    int flags;
+} autotune_entry_t;
+
+static const autotune_entry_t allgather_candidates[] = {
+    {1, 0, 0}, {2, 0, 0}, {3, 0, 0}, {4, 0, 0}, {5, 0, 0},
+    {6, 0, AT_TWO_PROCS},
+    {0, 0, 0}
+};
+
+static const autotune_entry_t allreduce_candidates[] = {
+    {1, 0, 0}, {2, 0, 0}, {3, 0, 0}, {4, 0, 0}, {5, 1024 << 7, 0},
+    {0, 0, 0}
+};
+
+static const autotune_entry_t alltoall_candidates[] = {
+    {1, 0, 0}, {2, 0, 0}, {3, 0, 0}, {4, 0, 0},
+    {5, 0, AT_TWO_PROCS},
+    {0, 0, 0}
+};
+
+static const autotune_entry_t barrier_candidates[] = {
+    {1, 0, 0}, {2, 0, 0}, {3, 0, 0}, {4, 0, 0},
+    {5, 0, AT_TWO_PROCS}, {6, 0, 0}, {7, 0, 0}, {7, 0, AT_WIDE},
+    {0, 0, 0}
+};
+
+static const autotune_entry_t bcast_candidates[] = {
+    {1, 0, 0}, {2, 1024 << 3, AT_CHAIN}, {3, 1024 << 3, 0}, {3, 1024 << 7, 0},
+    {4, 1024 << 3, 0}, {5, 1024 << 3, 0}, {6, 0, 0}, {6, 1024 << 3, 0},
+    {7, 1024 << 3, 0}, {7, 1024 << 3, AT_WIDE},
+    {0, 0, 0}
+};
+
+static const autotune_entry_t reduce_candidates[] = {
+    {1, 0, 0}, {2, 1024 << 5, AT_CHAIN}, {3, 1024 << 5, 0}, {4, 1024 << 5, 0},
+    {5, 0, 0}, {5, 1024 << 5, 0}, {6, 1024 << 5, 0},
+    {7, 1024 << 5, 0}, {7, 1024 << 5, AT_WIDE},
+    {0, 0, 0}
+};
+
+static const autotune_entry_t *autotune_candidates (int coll_id)
+{
+    switch (coll_id) {
+    case ALLGATHER: return allgather_candidates;
+    case ALLREDUCE: return allreduce_candidates;
+    case ALLTOALL:  return alltoall_candidates;
+    case BARRIER:   return barrier_candidates;
+    case BCAST:     return bcast_candidates;
+    case REDUCE:    return reduce_candidates;
+    default:        return NULL;
+    }
+}
+
+/*
+ * What we learned, kept on the component so that it survives the
+ * communicators and can be written as a rule file at close time.
+ */
+typedef struct autotune_result_t {
+    int coll_id;
+    int mpi_comsize;
+    int bucket_id;
+    ompi_coll_tuned_autotune_candidate_t choice;
+} autotune_result_t;
+
+static autotune_result_t *autotune_results = NULL;
+static int autotune_results_len = 0;
+static int autotune_results_size = 0;
+static opal_mutex_t autotune_results_lock;
+
+static size_t autotune_bucket_lower_bound (int bucket_id)
+{
+    return (0 == bucket_id) ? 0 : ((size_t)1 << (bucket_id - 1));
+}
+
+static int autotune_bucket (size_t msgsize)
+{
+    int b = 0;
+
+    while (msgsize) {
+        msgsize >>= 1;
+        b++;
+    }
+    return b;
+}
+
+static void autotune_record (ompi_coll_tuned_autotune_t* at,
+                             ompi_coll_tuned_autotune_bucket_t* bucket)
+{
+    int i;
+
+    OPAL_THREAD_LOCK(&autotune_results_lock);
+
+    /* keep the first answer we got for a given com size */
+    for (i = 0; i < autotune_results_len; i++) {
+        if (autotune_results[i].coll_id == at->coll_id &&
+            autotune_results[i].mpi_comsize == at->mpi_comsize &&
+            autotune_results[i].bucket_id == bucket->bucket_id) {
+            OPAL_THREAD_UNLOCK(&autotune_results_lock);
+            return;
+        }
+    }
+
+    if (autotune_results_len == autotune_results_size) {
+        int new_size = (0 == autotune_results_size) ? 16 : 2 * autotune_results_size;
+        autotune_result_t *tmp = (autotune_result_t*) realloc (autotune_results,
+                                                               new_size * sizeof(autotune_result_t));
+        if (NULL == tmp) {
+            OPAL_THREAD_UNLOCK(&autotune_results_lock);
+            return;
+        }
+        autotune_results = tmp;
+        autotune_results_size = new_size;
+    }
+
+    autotune_results[autotune_results_len].coll_id = at->coll_id;
+    autotune_results[autotune_results_len].mpi_comsize = at->mpi_comsize;
+    autotune_results[autotune_results_len].bucket_id = bucket->bucket_id;
+    autotune_results[autotune_results_len].choice = at->candidates[bucket->winner];
+    autotune_results_len++;
+
+    OPAL_THREAD_UNLOCK(&autotune_results_lock);
+}
+
+static int autotune_result_cmp (const void *a, const void *b)
+{
+    const autotune_result_t *ra = (const autotune_result_t*) a;
+    const autotune_result_t *rb = (const autotune_result_t*) b;
+
+    if (ra->coll_id != rb->coll_id) return ra->coll_id - rb->coll_id;
+    if (ra->mpi_comsize != rb->mpi_comsize) return ra->mpi_comsize - rb->mpi_comsize;
+    return ra->bucket_id - rb->bucket_id;
+}
+
+/*
+ * Turn the learned results into a rule table. Each tuned bucket
+ * becomes a rule starting at its lower bound; a bucket that was not
+ * tuned (including the mandatory rule at message size 0) gets
+ * algorithm 0, i.e. falls back on the fixed decision.
+ */
+static ompi_coll_alg_rule_t* autotune_build_rules (void)
+{
+    ompi_coll_alg_rule_t *alg_rules;
+    ompi_coll_com_rule_t *com_p;
+    ompi_coll_msg_rule_t *msg_p;
+    int first, last, i, j, ncs, nms;
+
+    alg_rules = ompi_coll_tuned_mk_alg_rules (COLLCOUNT);
+    if (NULL == alg_rules) return NULL;
+
+    qsort (autotune_results, autotune_results_len, sizeof(autotune_result_t),
+           autotune_result_cmp);
+
+    for (first = 0; first < autotune_results_len; first = last) {
+        int coll_id = autotune_results[first].coll_id;
+
+        /* count the com sizes of this collective */
+        for (last = first, ncs = 0; last < autotune_results_len &&
+                 autotune_results[last].coll_id == coll_id; last++) {
+            if (last == first ||
+                autotune_results[last].mpi_comsize != autotune_results[last - 1].mpi_comsize) {
+                ncs++;
+            }
+        }
+
+        alg_rules[coll_id].com_rules = ompi_coll_tuned_mk_com_rules (ncs, coll_id);
+        if (NULL == alg_rules[coll_id].com_rules) goto on_error;
+        alg_rules[coll_id].n_com_sizes = ncs;
+
+        for (i = first, ncs = 0; i < last; ncs++) {
+            int comsize = autotune_results[i].mpi_comsize;
+            int prev_bucket = -1;
+
+            /* worst case: a rule for each bucket and one for each gap */
+            for (j = i, nms = 0; j < last && autotune_results[j].mpi_comsize == comsize; j++) {
+                nms += 2;
+            }
+            nms++;
+
+            com_p = &(alg_rules[coll_id].com_rules[ncs]);
+            com_p->mpi_comsize = comsize;
+            com_p->msg_rules = ompi_coll_tuned_mk_msg_rules (nms, coll_id, ncs, comsize);
+            if (NULL == com_p->msg_rules) goto on_error;
+
+            nms = 0;
+            for (; i < last && autotune_results[i].mpi_comsize == comsize; i++) {
+                int bucket_id = autotune_results[i].bucket_id;
+
+                if (bucket_id != prev_bucket + 1) {
+                    /* gap, including no rule for the empty message */
+                    msg_p = &(com_p->msg_rules[nms++]);
+                    msg_p->msg_size = (prev_bucket < 0) ? 0 :
+                        autotune_bucket_lower_bound (prev_bucket + 1);
+                    msg_p->result_alg = 0;
+                }
+                msg_p = &(com_p->msg_rules[nms++]);
+                msg_p->msg_size = autotune_bucket_lower_bound (bucket_id);
+                msg_p->result_alg = autotune_results[i].choice.algorithm;
+                msg_p->result_topo_faninout = autotune_results[i].choice.faninout;
+                msg_p->result_segsize = autotune_results[i].choice.segsize;
+                prev_bucket = bucket_id;
+            }
+            if ((size_t)(prev_bucket + 1) < COLL_TUNED_AUTOTUNE_BUCKETS) {
+                msg_p = &(com_p->msg_rules[nms++]);
+                msg_p->msg_size = autotune_bucket_lower_bound (prev_bucket + 1);
+                msg_p->result_alg = 0;
+            }
+            com_p->n_msg_sizes = nms;
+        }
+    }
+
+    return alg_rules;
+
+ on_error:
+    ompi_coll_tuned_free_all_rules (alg_rules, COLLCOUNT);
+    return NULL;
+}
+
+
+int ompi_coll_tuned_autotune_init (void)
+{
+    OBJ_CONSTRUCT(&autotune_results_lock, opal_mutex_t);
+    return OMPI_SUCCESS;
+}
+
+
+int ompi_coll_tuned_autotune_finalize (char *fname)
+{
+    ompi_coll_alg_rule_t *alg_rules;
+    int rc;
+
+    if (NULL != fname && autotune_results_len > 0) {
+        alg_rules = autotune_build_rules ();
+        if (NULL != alg_rules) {
+            rc = ompi_coll_tuned_write_rules_config_file (fname, alg_rules, COLLCOUNT);
+            if (rc < 0) {
+                opal_output(0, "coll:tuned: unable to write the autotuned rules to %s", fname);
+            } else {
+                OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:autotune wrote rules for %d collectives to %s",
+                             rc, fname));
+            }
+            ompi_coll_tuned_free_all_rules (alg_rules, COLLCOUNT);
+        }
+    }
+
+    if (NULL != autotune_results) {
+        free (autotune_results);
+        autotune_results = NULL;
+    }
+    autotune_results_len = autotune_results_size = 0;
+    OBJ_DESTRUCT(&autotune_results_lock);
+
+    return OMPI_SUCCESS;
+}
+
+
+ompi_coll_tuned_autotune_t* ompi_coll_tuned_autotune_create (int coll_id, int mpi_comsize)
+{
+    const autotune_entry_t *table = autotune_candidates (coll_id);
+    ompi_coll_tuned_autotune_t *at;
+    int i, n;
+
+    if (NULL == table || ompi_coll_tuned_autotune_trials <= 0) {
+        return NULL;
+    }
+
+    at = (ompi_coll_tuned_autotune_t*) calloc (1, sizeof(ompi_coll_tuned_autotune_t));
+    if (NULL == at) return NULL;
+
+    for (n = 0; 0 != table[n].algorithm; n++);
+    at->candidates = (ompi_coll_tuned_autotune_candidate_t*)
+        malloc (n * sizeof(ompi_coll_tuned_autotune_candidate_t));
+    if (NULL == at->candidates) {
+        free (at);
+        return NULL;
+    }
+
+    for (i = 0; 0 != table[i].algorithm; i++) {
+        if ((table[i].flags & AT_TWO_PROCS) && 2 != mpi_comsize) {
+            continue;
+        }
+        at->candidates[at->n_candidates].algorithm = table[i].algorithm;
+        at->candidates[at->n_candidates].segsize = table[i].segsize;
+        at->candidates[at->n_candidates].faninout = (table[i].flags & AT_CHAIN) ?
+            ompi_coll_tuned_init_chain_fanout : ompi_coll_tuned_init_tree_fanout;
+        if (table[i].flags & AT_WIDE) {
+            at->candidates[at->n_candidates].faninout *= 2;
+        }
+        at->n_candidates++;
+    }
+
+    at->coll_id = coll_id;
+    at->mpi_comsize = mpi_comsize;
+    at->current = NULL;
+
+    return at;
+}
+
+
+void ompi_coll_tuned_autotune_destroy (ompi_coll_tuned_autotune_t* at)
+{
+    size_t b;
+
+    if (NULL == at) return;
+
+    for (b = 0; b < COLL_TUNED_AUTOTUNE_BUCKETS; b++) {
+        if (NULL != at->buckets[b]) {
+            free (at->buckets[b]);
+        }
+    }
+    free (at->candidates);
+    free (at);
+}
+
+
+ompi_coll_tuned_autotune_candidate_t*
+ompi_coll_tuned_autotune_begin (ompi_coll_tuned_autotune_t* at, size_t msgsize)
+{
+    ompi_coll_tuned_autotune_bucket_t *bucket;
+    int b = autotune_bucket (msgsize);
+
+    at->current = NULL;
+
+    bucket = at->buckets[b];
+    if (NULL == bucket) {
+        /* the times are allocated right behind the bucket */
+        bucket = (ompi_coll_tuned_autotune_bucket_t*)
+            calloc (1, sizeof(ompi_coll_tuned_autotune_bucket_t) +
+                    at->n_candidates * sizeof(double));
+        if (NULL == bucket) {
+            return NULL;
+        }
+        bucket->bucket_id = b;
+        bucket->winner = -1;
+        bucket->times = (double*) (bucket + 1);
+        at->buckets[b] = bucket;
+    }
+
+    if (bucket->winner >= 0) {
+        return &(at->candidates[bucket->winner]);
+    }
+
+    /* still exploring: round robin over the candidates so that warm up
+       effects are spread over all of them */
+    at->current = bucket;
+    at->start = opal_timer_base_get_usec();
+    return &(at->candidates[bucket->calls % at->n_candidates]);
+}
+
+
+int ompi_coll_tuned_autotune_end (ompi_coll_tuned_autotune_t* at,
+                                  struct ompi_communicator_t *comm,
+                                  mca_coll_base_module_t *module)
+{
+    ompi_coll_tuned_autotune_bucket_t *bucket = at->current;
+    opal_timer_t stop;
+    int i, rc;
+
+    if (NULL == bucket) {
+        return MPI_SUCCESS;
+    }
+
+    stop = opal_timer_base_get_usec();
+    at->current = NULL;
+
+    bucket->times[bucket->calls % at->n_candidates] += (double) (stop - at->start) / 1000000.0;
+    bucket->calls++;
+
+    if (bucket->calls < at->n_candidates * ompi_coll_tuned_autotune_trials) {
+        return MPI_SUCCESS;
+    }
+
+    /* all trials are done: the cost of a candidate is the one seen by
+       the slowest process. Use an algorithm that does not go back
+       through the communicator's collectives. */
+    rc = ompi_coll_tuned_allreduce_intra_recursivedoubling (MPI_IN_PLACE, bucket->times,
+                                                            at->n_candidates, MPI_DOUBLE,
+                                                            MPI_MAX, comm, module);
+    if (MPI_SUCCESS != rc) {
+        /* start over for this bucket */
+        bucket->winner = -1;
+        bucket->calls = 0;
+        for (i = 0; i < at->n_candidates; i++) {
+            bucket->times[i] = 0.0;
+        }
+        return rc;
+    }
+
+    bucket->winner = 0;
+    for (i = 1; i < at->n_candidates; i++) {
+        if (bucket->times[i] < bucket->times[bucket->winner]) {
+            bucket->winner = i;
+        }
+    }
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:autotune collective %d comsize %d msg size >= %lu: algorithm %d faninout %d segsize %d (%g s for %d calls)",
+                 at->coll_id, at->mpi_comsize, (unsigned long) autotune_bucket_lower_bound (bucket->bucket_id),
+                 at->candidates[bucket->winner].algorithm, at->candidates[bucket->winner].faninout,
+                 at->candidates[bucket->winner].segsize, bucket->times[bucket->winner],
+                 ompi_coll_tuned_autotune_trials));
+
+    /* only the first process of MPI_COMM_WORLD writes the rule file */
+    if (0 == ompi_comm_rank (&ompi_mpi_comm_world.comm)) {
+        autotune_record (at, bucket);
+    }
+
+    return MPI_SUCCESS;
+}
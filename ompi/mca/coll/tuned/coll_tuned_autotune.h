@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2005 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_COLL_TUNED_AUTOTUNE_H_HAS_BEEN_INCLUDED
+#define MCA_COLL_TUNED_AUTOTUNE_H_HAS_BEEN_INCLUDED
+
+#include "ompi_config.h"
+
+#include "opal/mca/timer/base/base.h"
+#include "ompi/mca/coll/coll.h"
+
+BEGIN_C_DECLS
+
+/*
+ * Online autotuning of the decision functions.
+ *
+ * For every (collective, message size bucket) of a communicator, the
+ * first calls cycle through a list of candidate algorithms, each one
+ * being timed ompi_coll_tuned_autotune_trials times.  The call that
+ * completes the last trial agrees on the winner with an allreduce (the
+ * slowest process defines the cost of a candidate), and from then on
+ * the winner is used for this bucket.  As all processes see the same
+ * sequence of collective calls with the same message sizes, they all
+ * walk through the candidates in lockstep.
+ *
+ * Message sizes are bucketed by powers of two: bucket 0 is the empty
+ * message and bucket b > 0 holds the sizes in [2^(b-1), 2^b).
+ */
+#define COLL_TUNED_AUTOTUNE_BUCKETS (8 * sizeof(size_t) + 1)
+
+typedef struct ompi_coll_tuned_autotune_candidate_t {
+    int algorithm;      /* algorithm as understood by the _intra_do_this functions */
+    int faninout;       /* topology fan in/out */
+    int segsize;        /* segment size, 0 = no segmentation */
+} ompi_coll_tuned_autotune_candidate_t;
+
+typedef struct ompi_coll_tuned_autotune_bucket_t {
+    int bucket_id;      /* which message size bucket this is */
+    int calls;          /* number of calls timed so far */
+    int winner;         /* index of the selected candidate, -1 while exploring */
+    double *times;      /* accumulated time (in seconds) for each candidate */
+} ompi_coll_tuned_autotune_bucket_t;
+
+typedef struct ompi_coll_tuned_autotune_t {
+    int coll_id;        /* which MPI collective */
+    int mpi_comsize;    /* size of the communicator we are tuning */
+    int n_candidates;
+    ompi_coll_tuned_autotune_candidate_t *candidates;
+    ompi_coll_tuned_autotune_bucket_t *buckets[COLL_TUNED_AUTOTUNE_BUCKETS];
+
+    /* the call currently being timed (NULL if none) */
+    ompi_coll_tuned_autotune_bucket_t *current;
+    opal_timer_t start;
+} ompi_coll_tuned_autotune_t;
+
+/* component wide setup and tear down (the learned rules live here) */
+int ompi_coll_tuned_autotune_init (void);
+int ompi_coll_tuned_autotune_finalize (char *fname);
+
+/* per communicator state, NULL if the collective cannot be autotuned */
+ompi_coll_tuned_autotune_t* ompi_coll_tuned_autotune_create (int coll_id, int mpi_comsize);
+void ompi_coll_tuned_autotune_destroy (ompi_coll_tuned_autotune_t* at);
+
+/*
+ * Returns the candidate to use for a call with the given message size
+ * (the winner if the bucket is already tuned) and starts the timer if
+ * the call is a trial.  Returns NULL if the autotuner has nothing to
+ * say, in which case the caller should fall back on the fixed rules.
+ */
+ompi_coll_tuned_autotune_candidate_t*
+ompi_coll_tuned_autotune_begin (ompi_coll_tuned_autotune_t* at, size_t msgsize);
+
+/*
+ * Stops the timer of the current trial, if any, and agrees on the
+ * winner of the bucket once all the trials are done.  Has to be called
+ * by all processes of comm after each call that went through
+ * ompi_coll_tuned_autotune_begin.
+ */
+int ompi_coll_tuned_autotune_end (ompi_coll_tuned_autotune_t* at,
+                                  struct ompi_communicator_t *comm,
+                                  mca_coll_base_module_t *module);
+
+END_C_DECLS
+#endif /* MCA_COLL_TUNED_AUTOTUNE_H_HAS_BEEN_INCLUDED */
@@ -34,7 +34,7 @@
 #include "coll_tuned_util.h"
 
 /* barrier algorithm variables */
-static int coll_tuned_barrier_algorithm_count = 6;
+static int coll_tuned_barrier_algorithm_count = 8;
 static int coll_tuned_barrier_forced_algorithm = 0;
 
 /* valid values for coll_tuned_barrier_forced_algorithm */
@@ -46,6 +46,8 @@ static mca_base_var_enum_value_t barrier_algorithms[] = {
     {4, "bruck"},
     {5, "two_proc"},
     {6, "tree"},
+    {7, "knomial"},
+    {8, "hierarchical"},
     {0, NULL}
 };
 
@@ -410,6 +412,155 @@ int ompi_coll_tuned_barrier_intra_tree(struct ompi_communicator_t *comm,
     return MPI_SUCCESS;
 }
 
+/*
+ * Fan-in and fan-out over a k-nomial tree rooted at 0: every process
+ * waits for the empty messages of all its childs at once, notifies its
+ * parent and, once released by it, releases its childs.  With a larger
+ * radix the tree is flatter, so there are fewer steps but more messages
+ * per step.
+ */
+int ompi_coll_tuned_barrier_intra_knomial(struct ompi_communicator_t *comm,
+                                          mca_coll_base_module_t *module,
+                                          int radix)
+{
+    int rank, err, i;
+    ompi_request_t *reqs[MAXTREEFANOUT];
+    ompi_coll_tree_t *tree;
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    rank = ompi_comm_rank(comm);
+    radix = COLL_TUNED_KNOMIAL_RADIX(radix);
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_barrier_intra_knomial %d radix %d", 
+                 rank, radix));
+
+    COLL_TUNED_UPDATE_KMTREE( comm, tuned_module, 0, radix );
+    tree = data->cached_kmtree;
+    if (NULL == tree) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    /* up the tree */
+    for (i = 0; i < tree->tree_nextsize; i++) {
+        err = MCA_PML_CALL(irecv (NULL, 0, MPI_BYTE, tree->tree_next[i],
+                                  MCA_COLL_BASE_TAG_BARRIER, comm, &reqs[i]));
+        if (MPI_SUCCESS != err)
+            return err;
+    }
+    err = ompi_request_wait_all( tree->tree_nextsize, reqs, MPI_STATUSES_IGNORE );
+    if (MPI_SUCCESS != err)
+        return err;
+
+    if (0 != rank) {
+        err = MCA_PML_CALL(send (NULL, 0, MPI_BYTE, tree->tree_prev,
+                                 MCA_COLL_BASE_TAG_BARRIER,
+                                 MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != err)
+            return err;
+        err = MCA_PML_CALL(recv (NULL, 0, MPI_BYTE, tree->tree_prev,
+                                 MCA_COLL_BASE_TAG_BARRIER, comm,
+                                 MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != err)
+            return err;
+    }
+
+    /* and back down */
+    for (i = 0; i < tree->tree_nextsize; i++) {
+        err = MCA_PML_CALL(isend (NULL, 0, MPI_BYTE, tree->tree_next[i],
+                                  MCA_COLL_BASE_TAG_BARRIER,
+                                  MCA_PML_BASE_SEND_STANDARD, comm, &reqs[i]));
+        if (MPI_SUCCESS != err)
+            return err;
+    }
+    return ompi_request_wait_all( tree->tree_nextsize, reqs, MPI_STATUSES_IGNORE );
+}
+
+/*
+ * Barrier in three levels, so that its latency grows with the number of
+ * nodes rather than with the number of processes:
+ *  1. fan-in over a binomial tree of the processes of each node towards
+ *     its lowest rank, the leader, over shared memory;
+ *  2. dissemination barrier between the leaders: ceil(log2(nodes)) steps
+ *     of a single empty message, whatever the number of nodes;
+ *  3. fan-out over the same tree within the node.
+ * The nodes are found (collectively) on first use and cached on the
+ * communicator, their ranks do not need to be consecutive.
+ */
+int ompi_coll_tuned_barrier_intra_hierarchical(struct ompi_communicator_t *comm,
+                                               mca_coll_base_module_t *module)
+{
+    int rank, err, line = 0, nnodes, node, npeers, v, mask, nreqs, distance;
+    int *peers, *leaders;
+    ompi_request_t *reqs[8 * sizeof(int)];
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    rank = ompi_comm_rank(comm);
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_barrier_intra_hierarchical rank %d", rank));
+
+    nnodes = ompi_coll_tuned_get_node_layout(comm, data);
+    if (nnodes < 0) {
+        return ompi_coll_tuned_barrier_intra_bruck(comm, module);
+    }
+    peers = data->cached_node_peers;
+    npeers = data->cached_node_size;
+    leaders = data->cached_node_leaders;
+    for (v = 0; peers[v] != rank; v++);
+
+    /* 1. gather the childs, v + 1, v + 2, v + 4... below the lowest bit of v */
+    for (nreqs = 0, mask = 1; (mask < npeers) && !(v & mask); mask <<= 1) {
+        if (v + mask >= npeers) continue;
+        err = MCA_PML_CALL(irecv(NULL, 0, MPI_BYTE, peers[v + mask],
+                                 MCA_COLL_BASE_TAG_BARRIER, comm, &reqs[nreqs++]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    if (0 != v) {
+        err = MCA_PML_CALL(send(NULL, 0, MPI_BYTE, peers[v - mask],
+                                MCA_COLL_BASE_TAG_BARRIER,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        err = MCA_PML_CALL(recv(NULL, 0, MPI_BYTE, peers[v - mask],
+                                MCA_COLL_BASE_TAG_BARRIER, comm, MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    } else {
+        /* 2. the whole node is in, synchronize with the other nodes */
+        for (node = 0; leaders[node] != rank; node++);
+        for (distance = 1; distance < nnodes; distance <<= 1) {
+            err = ompi_coll_tuned_sendrecv_actual(NULL, 0, MPI_BYTE,
+                                                  leaders[(node + distance) % nnodes],
+                                                  MCA_COLL_BASE_TAG_BARRIER,
+                                                  NULL, 0, MPI_BYTE,
+                                                  leaders[(node + nnodes - distance) % nnodes],
+                                                  MCA_COLL_BASE_TAG_BARRIER,
+                                                  comm, MPI_STATUS_IGNORE);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+    }
+
+    /* 3. release the childs */
+    for (nreqs = 0, mask >>= 1; mask > 0; mask >>= 1) {
+        if (v + mask >= npeers) continue;
+        err = MCA_PML_CALL(isend(NULL, 0, MPI_BYTE, peers[v + mask],
+                                 MCA_COLL_BASE_TAG_BARRIER,
+                                 MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    return MPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"%s:%4d\tError occurred %d, rank %2d", 
+                 __FILE__, line, err, rank));
+    return err;
+}
+
 
 /* The following are used by dynamic and forced rules */
 
@@ -443,7 +594,7 @@ int ompi_coll_tuned_barrier_intra_check_forced_init (coll_tuned_force_algorithm_
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "barrier_algorithm",
-                                        "Which barrier algorithm is used. Can be locked down to choice of: 0 ignore, 1 linear, 2 double ring, 3: recursive doubling 4: bruck, 5: two proc only, 6: tree",
+                                        "Which barrier algorithm is used. Can be locked down to choice of: 0 ignore, 1 linear, 2 double ring, 3: recursive doubling 4: bruck, 5: two proc only, 6: tree, 7: knomial tree (radix from coll_tuned_knomial_radix), 8: hierarchical (fan-in within the nodes, dissemination between them)",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_READONLY,
@@ -476,6 +627,8 @@ int ompi_coll_tuned_barrier_intra_do_forced(struct ompi_communicator_t *comm,
     case (4):   return ompi_coll_tuned_barrier_intra_bruck (comm, module);
     case (5):   return ompi_coll_tuned_barrier_intra_two_procs (comm, module);
     case (6):   return ompi_coll_tuned_barrier_intra_tree (comm, module);
+    case (7):   return ompi_coll_tuned_barrier_intra_knomial (comm, module, 0);
+    case (8):   return ompi_coll_tuned_barrier_intra_hierarchical (comm, module);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:barrier_intra_do_forced attempt to select algorithm %d when only 0-%d is valid?",
                      data->user_forced[BARRIER].algorithm,
@@ -500,6 +653,8 @@ int ompi_coll_tuned_barrier_intra_do_this (struct ompi_communicator_t *comm,
     case (4):   return ompi_coll_tuned_barrier_intra_bruck (comm, module);
     case (5):   return ompi_coll_tuned_barrier_intra_two_procs (comm, module);
     case (6):   return ompi_coll_tuned_barrier_intra_tree (comm, module);
+    case (7):   return ompi_coll_tuned_barrier_intra_knomial (comm, module, faninout);
+    case (8):   return ompi_coll_tuned_barrier_intra_hierarchical (comm, module);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:barrier_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
                      algorithm, ompi_coll_tuned_forced_max_algorithms[BARRIER]));
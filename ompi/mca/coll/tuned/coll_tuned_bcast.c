@@ -32,7 +32,7 @@
 #include "coll_tuned_util.h"
 
 /* bcast algorithm variables */
-static int coll_tuned_bcast_algorithm_count = 6;
+static int coll_tuned_bcast_algorithm_count = 7;
 static int coll_tuned_bcast_forced_algorithm = 0;
 static int coll_tuned_bcast_segment_size = 0;
 static int coll_tuned_bcast_tree_fanout;
@@ -47,6 +47,7 @@ static mca_base_var_enum_value_t bcast_algorithms[] = {
     {4, "split_binary_tree"},
     {5, "binary_tree"},
     {6, "binomial"},
+    {7, "knomial"},
     {0, NULL}
 };
 
@@ -386,6 +387,50 @@ ompi_coll_tuned_bcast_intra_binomial( void* buffer,
                                                 segcount, data->cached_bmtree );
 }
 
+/*
+ * bcast_intra_knomial
+ *
+ * Function:      bcast along a k-nomial tree of the given radix, the
+ *                childs with the largest subtrees or on another node
+ *                first.  Radix 2 is the binomial tree.
+ * Accepts:       same as MPI_Bcast(), segment size and radix
+ * Returns:       MPI_SUCCESS or error code
+ */
+int
+ompi_coll_tuned_bcast_intra_knomial( void* buffer,
+                                     int count, 
+                                     struct ompi_datatype_t* datatype, 
+                                     int root,
+                                     struct ompi_communicator_t* comm,
+                                     mca_coll_base_module_t *module,
+                                     uint32_t segsize,
+                                     int radix )
+{
+    int segcount = count;
+    size_t typelng;
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    radix = COLL_TUNED_KNOMIAL_RADIX(radix);
+    COLL_TUNED_UPDATE_KMTREE( comm, tuned_module, root, radix );
+    if (NULL == data->cached_kmtree) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    /**
+     * Determine number of elements sent per operation.
+     */
+    ompi_datatype_type_size( datatype, &typelng );
+    COLL_TUNED_COMPUTED_SEGCOUNT( segsize, typelng, segcount );
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:bcast_intra_knomial rank %d ss %5d radix %d typelng %lu segcount %d",
+                 ompi_comm_rank(comm), segsize, data->cached_kmtree->tree_fanout,
+                 (unsigned long)typelng, segcount));
+
+    return ompi_coll_tuned_bcast_intra_generic( buffer, count, datatype, root, comm, module,
+                                                segcount, data->cached_kmtree );
+}
+
 int
 ompi_coll_tuned_bcast_intra_split_bintree ( void* buffer,
                                             int count, 
@@ -751,7 +796,7 @@ int ompi_coll_tuned_bcast_intra_check_forced_init (coll_tuned_force_algorithm_mc
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "bcast_algorithm",
-                                        "Which bcast algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 chain, 3: pipeline, 4: split binary tree, 5: binary tree, 6: binomial tree.",
+                                        "Which bcast algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 chain, 3: pipeline, 4: split binary tree, 5: binary tree, 6: binomial tree, 7: knomial tree (radix from bcast_algorithm_tree_fanout).",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_READONLY,
@@ -821,6 +866,9 @@ int ompi_coll_tuned_bcast_intra_do_forced(void *buf, int count,
                                                             data->user_forced[BCAST].segsize );
     case (6):   return ompi_coll_tuned_bcast_intra_binomial( buf, count, dtype, root, comm, module,
                                                              data->user_forced[BCAST].segsize );
+    case (7):   return ompi_coll_tuned_bcast_intra_knomial( buf, count, dtype, root, comm, module,
+                                                            data->user_forced[BCAST].segsize,
+                                                            data->user_forced[BCAST].tree_fanout );
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:bcast_intra_do_forced attempt to select algorithm %d when only 0-%d is valid?",
                      data->user_forced[BCAST].algorithm, ompi_coll_tuned_forced_max_algorithms[BCAST]));
@@ -848,6 +896,7 @@ int ompi_coll_tuned_bcast_intra_do_this(void *buf, int count,
     case (4):   return ompi_coll_tuned_bcast_intra_split_bintree( buf, count, dtype, root, comm, module, segsize );
     case (5):   return ompi_coll_tuned_bcast_intra_bintree( buf, count, dtype, root, comm, module, segsize );
     case (6):   return ompi_coll_tuned_bcast_intra_binomial( buf, count, dtype, root, comm, module, segsize );
+    case (7):   return ompi_coll_tuned_bcast_intra_knomial( buf, count, dtype, root, comm, module, segsize, faninout );
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:bcast_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
                      algorithm, ompi_coll_tuned_forced_max_algorithms[BCAST]));
@@ -32,6 +32,7 @@
 #include "ompi/mca/coll/coll.h"
 #include "coll_tuned.h"
 #include "coll_tuned_dynamic_file.h"
+#include "coll_tuned_autotune.h"
 
 /*
  * Public string showing the coll ompi_tuned component version number
@@ -49,7 +50,12 @@ bool  ompi_coll_tuned_use_dynamic_rules = false;
 char* ompi_coll_tuned_dynamic_rules_filename = (char*) NULL;
 int   ompi_coll_tuned_init_tree_fanout = 4;
 int   ompi_coll_tuned_init_chain_fanout = 4;
+int   ompi_coll_tuned_knomial_radix = 4;
 int   ompi_coll_tuned_init_max_requests = 128;
+int   ompi_coll_tuned_scratch_max_size = (4 * 1024 * 1024);
+bool  ompi_coll_tuned_autotune = false;
+int   ompi_coll_tuned_autotune_trials = 5;
+char* ompi_coll_tuned_autotune_rules_filename = (char*) NULL;
 
 /* forced alogrithm variables */
 /* indices for the MCA parameters */
@@ -129,6 +135,15 @@ static int tuned_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &ompi_coll_tuned_preallocate_memory_comm_size_limit);
     
+    ompi_coll_tuned_scratch_max_size = (4 * 1024 * 1024);
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "scratch_max_size",
+                                           "Largest scratch buffer (in bytes) kept on each communicator for the temporaries of the algorithms and reused across calls. Larger temporaries are allocated by each call (0 disables the scratch buffer)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_scratch_max_size);
+
     /* some initial guesses at topology parameters */
     ompi_coll_tuned_init_tree_fanout = 4;
     (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
@@ -148,6 +163,15 @@ static int tuned_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &ompi_coll_tuned_init_chain_fanout);
 
+    ompi_coll_tuned_knomial_radix = 4;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "knomial_radix",
+                                           "Radix of the k-nomial trees used by the knomial algorithms when neither the forced tree fanout nor the dynamic rules give one (2 gives the binomial tree). It is lowered if the root of the tree would have more than 32 children",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_knomial_radix);
+
     ompi_coll_tuned_use_dynamic_rules = false;
     (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                            "use_dynamic_rules",
@@ -166,6 +190,33 @@ static int tuned_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &ompi_coll_tuned_dynamic_rules_filename);
 
+    ompi_coll_tuned_autotune = false;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "autotune",
+                                           "Switch used to decide if the first calls of each collective on each communicator and message size (rounded down to a power of two) try all the candidate algorithms and then stick to the fastest one. Rules from dynamic_rules_filename and forced algorithms take precedence. Implies use_dynamic_rules",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_autotune);
+
+    ompi_coll_tuned_autotune_trials = 5;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "autotune_trials",
+                                           "Number of times each candidate algorithm is timed before the autotuner picks one",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_autotune_trials);
+
+    ompi_coll_tuned_autotune_rules_filename = NULL;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "autotune_rules_filename",
+                                           "Filename where the process of rank 0 in MPI_COMM_WORLD writes, at the end of the job, the decisions of the autotuner in the dynamic_rules_filename format",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_autotune_rules_filename);
+
     /* register forced params */
     ompi_coll_tuned_allreduce_intra_check_forced_init(&ompi_coll_tuned_forced_params[ALLREDUCE]);
     ompi_coll_tuned_alltoall_intra_check_forced_init(&ompi_coll_tuned_forced_params[ALLTOALL]);
@@ -176,8 +227,15 @@ static int tuned_register(void)
     ompi_coll_tuned_bcast_intra_check_forced_init(&ompi_coll_tuned_forced_params[BCAST]);
     ompi_coll_tuned_reduce_intra_check_forced_init(&ompi_coll_tuned_forced_params[REDUCE]);
     ompi_coll_tuned_reduce_scatter_intra_check_forced_init(&ompi_coll_tuned_forced_params[REDUCESCATTER]);
+    ompi_coll_tuned_reduce_scatter_block_intra_check_forced_init(&ompi_coll_tuned_forced_params[REDUCESCATTERBLOCK]);
+    ompi_coll_tuned_scan_intra_check_forced_init(&ompi_coll_tuned_forced_params[SCAN]);
+    ompi_coll_tuned_exscan_intra_check_forced_init(&ompi_coll_tuned_forced_params[EXSCAN]);
     ompi_coll_tuned_gather_intra_check_forced_init(&ompi_coll_tuned_forced_params[GATHER]);
+    ompi_coll_tuned_gatherv_intra_check_forced_init(&ompi_coll_tuned_forced_params[GATHERV]);
     ompi_coll_tuned_scatter_intra_check_forced_init(&ompi_coll_tuned_forced_params[SCATTER]);
+    ompi_coll_tuned_scatterv_intra_check_forced_init(&ompi_coll_tuned_forced_params[SCATTERV]);
+
+    (void) ompi_coll_tuned_pvar_register();
 
     return OMPI_SUCCESS;
 }
@@ -207,6 +265,12 @@ static int tuned_open(void)
     /* as this is the component we only lookup the indicies of the mca params */
     /* the actual values are looked up during comm create via module init */
    
+    /* the autotuner lives in the dynamic decision functions */
+    if (ompi_coll_tuned_autotune) {
+        ompi_coll_tuned_use_dynamic_rules = true;
+        ompi_coll_tuned_autotune_init();
+    }
+
     /* intra functions first */
     /* if dynamic rules allowed then look up dynamic rules config filename, else we leave it an empty filename (NULL) */
     /* by default DISABLE dynamic rules and instead use fixed [if based] rules */
@@ -246,6 +310,11 @@ static int tuned_close(void)
         mca_coll_tuned_component.all_base_rules = NULL;
     }
 
+    /* save what the autotuner learned, if asked to */
+    if (ompi_coll_tuned_autotune) {
+        ompi_coll_tuned_autotune_finalize(ompi_coll_tuned_autotune_rules_filename);
+    }
+
     return OMPI_SUCCESS;
 }
 
@@ -260,6 +329,7 @@ static void
 mca_coll_tuned_module_destruct(mca_coll_tuned_module_t *module)
 {
     mca_coll_tuned_comm_t *data;
+    int i;
 
     /* Free the space in the data mpool and the data hanging off the
        communicator */
@@ -286,6 +356,12 @@ mca_coll_tuned_module_destruct(mca_coll_tuned_module_t *module)
         if (data->cached_in_order_bmtree) { /* destroy bmtree if defined */
             ompi_coll_tuned_topo_destroy_tree (&data->cached_in_order_bmtree);
         }
+        if (data->cached_kmtree) { /* destroy kmtree if defined */
+            ompi_coll_tuned_topo_destroy_tree (&data->cached_kmtree);
+        }
+        if (data->cached_in_order_kmtree) { /* destroy in order kmtree if defined */
+            ompi_coll_tuned_topo_destroy_tree (&data->cached_in_order_kmtree);
+        }
         if (data->cached_chain) { /* destroy general chain if defined */
             ompi_coll_tuned_topo_destroy_tree (&data->cached_chain);
         }
@@ -295,6 +371,21 @@ mca_coll_tuned_module_destruct(mca_coll_tuned_module_t *module)
         if (data->cached_in_order_bintree) { /* destroy in order bintree if defined */
             ompi_coll_tuned_topo_destroy_tree (&data->cached_in_order_bintree);
         }
+        if (data->cached_node_leaders) { /* free the nodes if found */
+            free (data->cached_node_leaders);
+        }
+        if (data->cached_node_peers) {
+            free (data->cached_node_peers);
+        }
+        if (data->cached_node_last) {
+            free (data->cached_node_last);
+        }
+        ompi_coll_tuned_scratch_release (data);
+
+        /* free the autotuner state */
+        for (i = 0; i < COLLCOUNT; i++) {
+            ompi_coll_tuned_autotune_destroy (data->autotune[i]);
+        }
 
         free(data);
     }
@@ -26,9 +26,9 @@
 #include "ompi/mca/coll/base/base.h"
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/op/op.h"
 #include "coll_tuned.h"
-
-#include "coll_tuned.h"
+#include "coll_tuned_autotune.h"
 
 
 /*
@@ -39,6 +39,8 @@
  * Else
  *      use forced rules (-coll_tuned_dynamic_ALG_intra_algorithm = algorithm-number)
  * Else
+ *      use the online autotuner (-coll_tuned_autotune 1)
+ * Else
  *      use fixed (compiled) rule set (or nested ifs)
  *
  */
@@ -86,6 +88,26 @@ ompi_coll_tuned_allreduce_intra_dec_dynamic (void *sbuf, void *rbuf, int count,
         return ompi_coll_tuned_allreduce_intra_do_forced (sbuf, rbuf, count, dtype, op,
                                                           comm, module);
     }
+    /* only commutative operations can go through all the candidates */
+    if (data->autotune[ALLREDUCE] && ompi_op_is_commute(op)) {
+        ompi_coll_tuned_autotune_candidate_t *choice;
+        size_t dsize;
+        int rc;
+
+        ompi_datatype_type_size (dtype, &dsize);
+        dsize *= count;
+
+        choice = ompi_coll_tuned_autotune_begin (data->autotune[ALLREDUCE], dsize);
+        if (NULL != choice) {
+            rc = ompi_coll_tuned_allreduce_intra_do_this (sbuf, rbuf, count, dtype, op,
+                                                          comm, module,
+                                                          choice->algorithm, choice->faninout,
+                                                          choice->segsize);
+            if (MPI_SUCCESS != rc) return rc;
+            return ompi_coll_tuned_autotune_end (data->autotune[ALLREDUCE], comm, module);
+        }
+    }
+
     return ompi_coll_tuned_allreduce_intra_dec_fixed (sbuf, rbuf, count, dtype, op,
                                                       comm, module);
 }
@@ -138,6 +160,26 @@ int ompi_coll_tuned_alltoall_intra_dec_dynamic(void *sbuf, int scount,
                                                          rbuf, rcount, rdtype,
                                                          comm, module);
     }
+    if (data->autotune[ALLTOALL]) {
+        ompi_coll_tuned_autotune_candidate_t *choice;
+        size_t dsize;
+        int rc;
+
+        ompi_datatype_type_size (sdtype, &dsize);
+        dsize *= (ptrdiff_t)ompi_comm_size(comm) * (ptrdiff_t)scount;
+
+        choice = ompi_coll_tuned_autotune_begin (data->autotune[ALLTOALL], dsize);
+        if (NULL != choice) {
+            rc = ompi_coll_tuned_alltoall_intra_do_this (sbuf, scount, sdtype,
+                                                         rbuf, rcount, rdtype,
+                                                         comm, module,
+                                                         choice->algorithm, choice->faninout,
+                                                         choice->segsize, 0);
+            if (MPI_SUCCESS != rc) return rc;
+            return ompi_coll_tuned_autotune_end (data->autotune[ALLTOALL], comm, module);
+        }
+    }
+
     return ompi_coll_tuned_alltoall_intra_dec_fixed (sbuf, scount, sdtype,
                                                      rbuf, rcount, rdtype,
                                                      comm, module);
@@ -225,6 +267,20 @@ int ompi_coll_tuned_barrier_intra_dec_dynamic(struct ompi_communicator_t *comm,
     if (data->user_forced[BARRIER].algorithm) {
         return ompi_coll_tuned_barrier_intra_do_forced (comm, module);
     }
+    if (data->autotune[BARRIER]) {
+        ompi_coll_tuned_autotune_candidate_t *choice;
+        int rc;
+
+        choice = ompi_coll_tuned_autotune_begin (data->autotune[BARRIER], 0);
+        if (NULL != choice) {
+            rc = ompi_coll_tuned_barrier_intra_do_this (comm, module,
+                                                        choice->algorithm, choice->faninout,
+                                                        choice->segsize);
+            if (MPI_SUCCESS != rc) return rc;
+            return ompi_coll_tuned_autotune_end (data->autotune[BARRIER], comm, module);
+        }
+    }
+
     return ompi_coll_tuned_barrier_intra_dec_fixed (comm, module);
 }
 
@@ -270,6 +326,25 @@ int ompi_coll_tuned_bcast_intra_dec_dynamic(void *buff, int count,
         return ompi_coll_tuned_bcast_intra_do_forced (buff, count, datatype, root,
                                                       comm, module);
     }
+    if (data->autotune[BCAST]) {
+        ompi_coll_tuned_autotune_candidate_t *choice;
+        size_t dsize;
+        int rc;
+
+        ompi_datatype_type_size (datatype, &dsize);
+        dsize *= count;
+
+        choice = ompi_coll_tuned_autotune_begin (data->autotune[BCAST], dsize);
+        if (NULL != choice) {
+            rc = ompi_coll_tuned_bcast_intra_do_this (buff, count, datatype, root,
+                                                      comm, module,
+                                                      choice->algorithm, choice->faninout,
+                                                      choice->segsize);
+            if (MPI_SUCCESS != rc) return rc;
+            return ompi_coll_tuned_autotune_end (data->autotune[BCAST], comm, module);
+        }
+    }
+
     return ompi_coll_tuned_bcast_intra_dec_fixed (buff, count, datatype, root,
                                                   comm, module);
 }
@@ -322,6 +397,27 @@ int ompi_coll_tuned_reduce_intra_dec_dynamic( void *sendbuf, void *recvbuf,
                                                        op, root,
                                                        comm, module);
     }
+    /* only commutative operations can go through all the candidates */
+    if (data->autotune[REDUCE] && ompi_op_is_commute(op)) {
+        ompi_coll_tuned_autotune_candidate_t *choice;
+        size_t dsize;
+        int rc;
+
+        ompi_datatype_type_size (datatype, &dsize);
+        dsize *= count;
+
+        choice = ompi_coll_tuned_autotune_begin (data->autotune[REDUCE], dsize);
+        if (NULL != choice) {
+            rc = ompi_coll_tuned_reduce_intra_do_this (sendbuf, recvbuf, count, datatype,
+                                                       op, root,
+                                                       comm, module,
+                                                       choice->algorithm, choice->faninout,
+                                                       choice->segsize, 0);
+            if (MPI_SUCCESS != rc) return rc;
+            return ompi_coll_tuned_autotune_end (data->autotune[REDUCE], comm, module);
+        }
+    }
+
     return ompi_coll_tuned_reduce_intra_dec_fixed (sendbuf, recvbuf, count, datatype,
                                                    op, root,
                                                    comm, module);
@@ -382,6 +478,58 @@ int ompi_coll_tuned_reduce_scatter_intra_dec_dynamic(void *sbuf, void *rbuf,
                                                            comm, module);
 }
 
+/*
+ *    reduce_scatter_block_intra_dec
+ *
+ *    Function:    - seletects reduce_scatter_block algorithm to use
+ *    Accepts:    - same arguments as MPI_Reduce_scatter_block()
+ *    Returns:    - MPI_SUCCESS or error code (passed from
+ *                  the reduce_scatter_block implementation)
+ *
+ */
+int ompi_coll_tuned_reduce_scatter_block_intra_dec_dynamic(void *sbuf, void *rbuf,
+                                                           int rcount,
+                                                           struct ompi_datatype_t *dtype,
+                                                           struct ompi_op_t *op,
+                                                           struct ompi_communicator_t *comm,
+                                                           mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:reduce_scatter_block_intra_dec_dynamic"));
+
+    /* check to see if we have some filebased rules */
+    if (data->com_rules[REDUCESCATTERBLOCK]) {
+        int alg, faninout, segsize, ignoreme;
+        size_t dsize;
+
+        ompi_datatype_type_size (dtype, &dsize);
+        dsize *= (size_t)rcount * ompi_comm_size(comm);
+
+        alg = ompi_coll_tuned_get_target_method_params (data->com_rules[REDUCESCATTERBLOCK],
+                                                        dsize, &faninout,
+                                                        &segsize, &ignoreme);
+        if (alg) {
+            /* we have found a valid choice from the file based rules for this message size */
+            return ompi_coll_tuned_reduce_scatter_block_intra_do_this (sbuf, rbuf, rcount,
+                                                                       dtype, op,
+                                                                       comm, module,
+                                                                       alg, faninout,
+                                                                       segsize);
+        } /* found a method */
+    } /*end if any com rules to check */
+
+    if (data->user_forced[REDUCESCATTERBLOCK].algorithm) {
+        return ompi_coll_tuned_reduce_scatter_block_intra_do_forced (sbuf, rbuf, rcount,
+                                                                     dtype, op,
+                                                                     comm, module);
+    }
+    return ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed (sbuf, rbuf, rcount,
+                                                                 dtype, op,
+                                                                 comm, module);
+}
+
 /*
  *    allgather_intra_dec 
  *
@@ -435,6 +583,27 @@ int ompi_coll_tuned_allgather_intra_dec_dynamic(void *sbuf, int scount,
                                                           comm, module);
     }
 
+    /* Online autotuning */
+    if (data->autotune[ALLGATHER]) {
+        ompi_coll_tuned_autotune_candidate_t *choice;
+        size_t dsize;
+        int rc;
+
+        ompi_datatype_type_size (sdtype, &dsize);
+        dsize *= (ptrdiff_t)ompi_comm_size(comm) * (ptrdiff_t)scount;
+
+        choice = ompi_coll_tuned_autotune_begin (data->autotune[ALLGATHER], dsize);
+        if (NULL != choice) {
+            rc = ompi_coll_tuned_allgather_intra_do_this (sbuf, scount, sdtype,
+                                                          rbuf, rcount, rdtype,
+                                                          comm, module,
+                                                          choice->algorithm, choice->faninout,
+                                                          choice->segsize);
+            if (MPI_SUCCESS != rc) return rc;
+            return ompi_coll_tuned_autotune_end (data->autotune[ALLGATHER], comm, module);
+        }
+    }
+
     /* Use default decision */
     return ompi_coll_tuned_allgather_intra_dec_fixed (sbuf, scount, sdtype, 
                                                       rbuf, rcount, rdtype, 
@@ -599,3 +768,197 @@ int ompi_coll_tuned_scatter_intra_dec_dynamic(void *sbuf, int scount,
                                                     rbuf, rcount, rdtype, 
                                                     root, comm, module);
 }
+
+/*
+ *    gatherv_intra_dec
+ *
+ *    Function:    - seletects gatherv algorithm to use
+ *    Accepts:    - same arguments as MPI_Gatherv()
+ *    Returns:    - MPI_SUCCESS or error code (passed from
+ *                  the gatherv implementation)
+ *
+ *    The counts are only known on the root, so the rules are looked up
+ *    with a zero message size: only the communicator size matters.
+ */
+int ompi_coll_tuned_gatherv_intra_dec_dynamic(void *sbuf, int scount,
+                                              struct ompi_datatype_t *sdtype,
+                                              void* rbuf, int *rcounts, int *disps,
+                                              struct ompi_datatype_t *rdtype,
+                                              int root,
+                                              struct ompi_communicator_t *comm,
+                                              mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_gatherv_intra_dec_dynamic"));
+
+    /* check to see if we have some filebased rules */
+    if (data->com_rules[GATHERV]) {
+        int alg, faninout, segsize, ignoreme;
+
+        alg = ompi_coll_tuned_get_target_method_params (data->com_rules[GATHERV],
+                                                        0, &faninout, &segsize, &ignoreme);
+        if (alg) {
+            /* we have found a valid choice from the file based rules */
+            return ompi_coll_tuned_gatherv_intra_do_this (sbuf, scount, sdtype,
+                                                          rbuf, rcounts, disps, rdtype,
+                                                          root, comm, module,
+                                                          alg, faninout, segsize);
+        } /* found a method */
+    } /*end if any com rules to check */
+
+    if (data->user_forced[GATHERV].algorithm) {
+        return ompi_coll_tuned_gatherv_intra_do_forced (sbuf, scount, sdtype,
+                                                        rbuf, rcounts, disps, rdtype,
+                                                        root, comm, module);
+    }
+
+    return ompi_coll_tuned_gatherv_intra_dec_fixed (sbuf, scount, sdtype,
+                                                    rbuf, rcounts, disps, rdtype,
+                                                    root, comm, module);
+}
+
+/*
+ *    scatterv_intra_dec
+ *
+ *    Function:    - seletects scatterv algorithm to use
+ *    Accepts:    - same arguments as MPI_Scatterv()
+ *    Returns:    - MPI_SUCCESS or error code (passed from
+ *                  the scatterv implementation)
+ *
+ *    As for gatherv, the rules are looked up with a zero message size.
+ */
+int ompi_coll_tuned_scatterv_intra_dec_dynamic(void *sbuf, int *scounts, int *disps,
+                                               struct ompi_datatype_t *sdtype,
+                                               void* rbuf, int rcount,
+                                               struct ompi_datatype_t *rdtype,
+                                               int root, struct ompi_communicator_t *comm,
+                                               mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_scatterv_intra_dec_dynamic"));
+
+    /* check to see if we have some filebased rules */
+    if (data->com_rules[SCATTERV]) {
+        int alg, faninout, segsize, ignoreme;
+
+        alg = ompi_coll_tuned_get_target_method_params (data->com_rules[SCATTERV],
+                                                        0, &faninout, &segsize, &ignoreme);
+        if (alg) {
+            /* we have found a valid choice from the file based rules */
+            return ompi_coll_tuned_scatterv_intra_do_this (sbuf, scounts, disps, sdtype,
+                                                           rbuf, rcount, rdtype,
+                                                           root, comm, module,
+                                                           alg, faninout, segsize);
+        } /* found a method */
+    } /*end if any com rules to check */
+
+    if (data->user_forced[SCATTERV].algorithm) {
+        return ompi_coll_tuned_scatterv_intra_do_forced (sbuf, scounts, disps, sdtype,
+                                                         rbuf, rcount, rdtype,
+                                                         root, comm, module);
+    }
+
+    return ompi_coll_tuned_scatterv_intra_dec_fixed (sbuf, scounts, disps, sdtype,
+                                                     rbuf, rcount, rdtype,
+                                                     root, comm, module);
+}
+
+/*
+ *    scan_intra_dec
+ *
+ *    Function:    - seletects scan algorithm to use
+ *    Accepts:    - same arguments as MPI_Scan()
+ *    Returns:    - MPI_SUCCESS or error code (passed from
+ *                  the scan implementation)
+ *
+ */
+int ompi_coll_tuned_scan_intra_dec_dynamic(void *sbuf, void *rbuf, int count,
+                                           struct ompi_datatype_t *dtype,
+                                           struct ompi_op_t *op,
+                                           struct ompi_communicator_t *comm,
+                                           mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:scan_intra_dec_dynamic"));
+
+    /* check to see if we have some filebased rules */
+    if (data->com_rules[SCAN]) {
+        int alg, faninout, segsize, ignoreme;
+        size_t dsize;
+
+        ompi_datatype_type_size (dtype, &dsize);
+        dsize *= (size_t)count;
+
+        alg = ompi_coll_tuned_get_target_method_params (data->com_rules[SCAN],
+                                                        dsize, &faninout,
+                                                        &segsize, &ignoreme);
+        if (alg) {
+            /* we have found a valid choice from the file based rules for this message size */
+            return ompi_coll_tuned_scan_intra_do_this (sbuf, rbuf, count, dtype, op,
+                                                       comm, module,
+                                                       alg, faninout, segsize);
+        } /* found a method */
+    } /*end if any com rules to check */
+
+    if (data->user_forced[SCAN].algorithm) {
+        return ompi_coll_tuned_scan_intra_do_forced (sbuf, rbuf, count, dtype, op,
+                                                     comm, module);
+    }
+    return ompi_coll_tuned_scan_intra_dec_fixed (sbuf, rbuf, count, dtype, op,
+                                                 comm, module);
+}
+
+/*
+ *    exscan_intra_dec
+ *
+ *    Function:    - seletects exscan algorithm to use
+ *    Accepts:    - same arguments as MPI_Exscan()
+ *    Returns:    - MPI_SUCCESS or error code (passed from
+ *                  the exscan implementation)
+ *
+ */
+int ompi_coll_tuned_exscan_intra_dec_dynamic(void *sbuf, void *rbuf, int count,
+                                             struct ompi_datatype_t *dtype,
+                                             struct ompi_op_t *op,
+                                             struct ompi_communicator_t *comm,
+                                             mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:exscan_intra_dec_dynamic"));
+
+    /* check to see if we have some filebased rules */
+    if (data->com_rules[EXSCAN]) {
+        int alg, faninout, segsize, ignoreme;
+        size_t dsize;
+
+        ompi_datatype_type_size (dtype, &dsize);
+        dsize *= (size_t)count;
+
+        alg = ompi_coll_tuned_get_target_method_params (data->com_rules[EXSCAN],
+                                                        dsize, &faninout,
+                                                        &segsize, &ignoreme);
+        if (alg) {
+            /* we have found a valid choice from the file based rules for this message size */
+            return ompi_coll_tuned_exscan_intra_do_this (sbuf, rbuf, count, dtype, op,
+                                                         comm, module,
+                                                         alg, faninout, segsize);
+        } /* found a method */
+    } /*end if any com rules to check */
+
+    if (data->user_forced[EXSCAN].algorithm) {
+        return ompi_coll_tuned_exscan_intra_do_forced (sbuf, rbuf, count, dtype, op,
+                                                       comm, module);
+    }
+    return ompi_coll_tuned_exscan_intra_dec_fixed (sbuf, rbuf, count, dtype, op,
+                                                   comm, module);
+}
@@ -70,10 +70,11 @@ ompi_coll_tuned_allreduce_intra_dec_fixed (void *sbuf, void *rbuf, int count,
             return (ompi_coll_tuned_allreduce_intra_ring (sbuf, rbuf, count, dtype, 
                                                           op, comm, module));
         } else {
-            return (ompi_coll_tuned_allreduce_intra_ring_segmented (sbuf, rbuf, 
+            return (ompi_coll_tuned_allreduce_intra_ring_pipelined (sbuf, rbuf, 
                                                                     count, dtype, 
                                                                     op, comm, module,
-                                                                    segment_size));
+                                                                    segment_size,
+                                                                    ompi_coll_tuned_allreduce_ring_count));
         }
     }
 
@@ -124,6 +125,14 @@ int ompi_coll_tuned_alltoall_intra_dec_fixed(void *sbuf, int scount,
                                                     comm, module);
 
     } else if (block_dsize < 3000) {
+        /* do not flood the network with all the messages at once on
+         * large communicators */
+        if (communicator_size > ompi_coll_tuned_init_max_requests) {
+            return ompi_coll_tuned_alltoall_intra_throttled(sbuf, scount, sdtype,
+                                                            rbuf, rcount, rdtype,
+                                                            comm, module,
+                                                            ompi_coll_tuned_init_max_requests);
+        }
         return ompi_coll_tuned_alltoall_intra_basic_linear(sbuf, scount, sdtype, 
                                                            rbuf, rcount, rdtype, 
                                                            comm, module);
@@ -165,7 +174,16 @@ int ompi_coll_tuned_alltoallv_intra_dec_fixed(void *sbuf, int *scounts, int *sdi
                                               struct ompi_communicator_t *comm,
                                               mca_coll_base_module_t *module)
 {
-    /* For starters, just keep the original algorithm. */
+    /* The pairwise exchange waits for the largest message of each step,
+     * which gets expensive with irregular counts on large communicators.
+     * The choice can only depend on the size of the communicator: the
+     * algorithms do not exchange the empty messages the same way. */
+    if (ompi_comm_size(comm) > ompi_coll_tuned_init_max_requests) {
+        /* dynamic version for the byte window parameter */
+        return ompi_coll_tuned_alltoallv_intra_do_this(sbuf, scounts, sdisps, sdtype,
+                                                       rbuf, rcounts, rdisps, rdtype,
+                                                       comm, module, 3);
+    }
     return ompi_coll_tuned_alltoallv_intra_pairwise(sbuf, scounts, sdisps, sdtype, 
                                                     rbuf, rcounts, rdisps,rdtype,
                                                     comm, module);
@@ -182,13 +200,23 @@ int ompi_coll_tuned_alltoallv_intra_dec_fixed(void *sbuf, int *scounts, int *sdi
 int ompi_coll_tuned_barrier_intra_dec_fixed(struct ompi_communicator_t *comm,
                                             mca_coll_base_module_t *module)
 {
-    int communicator_size = ompi_comm_size(comm);
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    int communicator_size = ompi_comm_size(comm), nnodes;
 
     OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_barrier_intra_dec_fixed com_size %d",
                  communicator_size));
 
     if( 2 == communicator_size )
         return ompi_coll_tuned_barrier_intra_two_procs(comm, module);
+    /**
+     * With several processes per node, only the node leaders go over
+     * the network.
+     */
+    if( communicator_size > 8 ) {
+        nnodes = ompi_coll_tuned_get_node_layout(comm, tuned_module->tuned_data);
+        if( (nnodes > 1) && (nnodes < communicator_size) )
+            return ompi_coll_tuned_barrier_intra_hierarchical(comm, module);
+    }
     /**
      * Basic optimisation. If we have a power of 2 number of nodes
      * the use the recursive doubling algorithm, otherwise
@@ -505,6 +533,60 @@ int ompi_coll_tuned_reduce_scatter_intra_dec_fixed( void *sbuf, void *rbuf,
                                                      comm, module);
 }
 
+/*
+ *	reduce_scatter_block_intra_dec
+ *
+ *	Function:	- seletects reduce_scatter_block algorithm to use
+ *	Accepts:	- same arguments as MPI_Reduce_scatter_block()
+ *	Returns:	- MPI_SUCCESS or error code (passed from
+ *                        the reduce_scatter_block implementation)
+ */
+int ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed( void *sbuf, void *rbuf,
+                                                          int rcount,
+                                                          struct ompi_datatype_t *dtype,
+                                                          struct ompi_op_t *op,
+                                                          struct ompi_communicator_t *comm,
+                                                          mca_coll_base_module_t *module)
+{
+    int comm_size, pow2;
+    size_t total_message_size, dsize;
+    const double a = 0.0012;
+    const double b = 8.0;
+    const size_t small_message_size = 12 * 1024;
+    const size_t large_message_size = 256 * 1024;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed"));
+
+    if( !ompi_op_is_commute(op) ) {
+        return ompi_coll_tuned_reduce_scatter_block_intra_basic_linear (sbuf, rbuf, rcount,
+                                                                        dtype, op,
+                                                                        comm, module);
+    }
+
+    comm_size = ompi_comm_size(comm);
+    ompi_datatype_type_size(dtype, &dsize);
+    total_message_size = dsize * (size_t)rcount * comm_size;
+
+    /* same thresholds as reduce_scatter */
+    pow2 = opal_next_poweroftwo_inclusive (comm_size);
+    if ((total_message_size <= small_message_size) ||
+        ((total_message_size <= large_message_size) && (pow2 == comm_size)) ||
+        (comm_size >= a * total_message_size + b)) {
+        return ompi_coll_tuned_reduce_scatter_block_intra_recursivehalving(sbuf, rbuf, rcount,
+                                                                           dtype, op,
+                                                                           comm, module);
+    }
+    /* with large blocks, reduce each where it belongs rather than along the ring */
+    if (dsize * (size_t)rcount >= large_message_size) {
+        return ompi_coll_tuned_reduce_scatter_block_intra_pairwise(sbuf, rbuf, rcount,
+                                                                   dtype, op,
+                                                                   comm, module);
+    }
+    return ompi_coll_tuned_reduce_scatter_block_intra_ring(sbuf, rbuf, rcount,
+                                                           dtype, op,
+                                                           comm, module);
+}
+
 /*
  *	allgather_intra_dec 
  *
@@ -615,9 +697,11 @@ int ompi_coll_tuned_allgatherv_intra_dec_fixed(void *sbuf, int scount,
                                                struct ompi_communicator_t *comm,
                                                mca_coll_base_module_t *module)
 {
+    const size_t min_segment_size = 16384;
+    const size_t skew_factor = 8;
     int i;
     int communicator_size;
-    size_t dsize, total_dsize;
+    size_t dsize, total_dsize, max_dsize, segsize;
     
     communicator_size = ompi_comm_size(comm);
     
@@ -628,11 +712,15 @@ int ompi_coll_tuned_allgatherv_intra_dec_fixed(void *sbuf, int scount,
                                                            comm, module);
     }
     
-    /* Determine complete data size */
-    ompi_datatype_type_size(sdtype, &dsize);
-    total_dsize = 0;
+    /* Determine complete data size and the largest block.  The send type
+       is not significant with MPI_IN_PLACE, use the receive type */
+    ompi_datatype_type_size(rdtype, &dsize);
+    total_dsize = max_dsize = 0;
     for (i = 0; i < communicator_size; i++) {
         total_dsize += dsize * (ptrdiff_t)rcounts[i];
+        if (dsize * (size_t)rcounts[i] > max_dsize) {
+            max_dsize = dsize * (size_t)rcounts[i];
+        }
     }
     
     OPAL_OUTPUT((ompi_coll_tuned_stream, 
@@ -645,17 +733,26 @@ int ompi_coll_tuned_allgatherv_intra_dec_fixed(void *sbuf, int scount,
         return ompi_coll_tuned_allgatherv_intra_bruck(sbuf, scount, sdtype, 
                                                       rbuf, rcounts, rdispls, rdtype, 
                                                       comm, module);
-    } else {
-        if (communicator_size % 2) {
-            return ompi_coll_tuned_allgatherv_intra_ring(sbuf, scount, sdtype, 
-                                                         rbuf, rcounts, rdispls, rdtype, 
-                                                         comm, module);
-        } else {
-            return  ompi_coll_tuned_allgatherv_intra_neighborexchange(sbuf, scount, sdtype,
-                                                                      rbuf, rcounts, rdispls, rdtype, 
-                                                                      comm, module);
-        }
     }
+    /* Every step of the ring and of the neighbor exchange lasts as long
+       as its largest block, so a few blocks much larger than the average
+       slow down all the steps.  Stream the blocks in segments of about
+       the average block instead. */
+    if (max_dsize > skew_factor * (total_dsize / communicator_size)) {
+        segsize = total_dsize / communicator_size;
+        if (segsize < min_segment_size) segsize = min_segment_size;
+        return ompi_coll_tuned_allgatherv_intra_ring_segmented(sbuf, scount, sdtype,
+                                                               rbuf, rcounts, rdispls, rdtype,
+                                                               comm, module, (int)segsize);
+    }
+    if (communicator_size % 2) {
+        return ompi_coll_tuned_allgatherv_intra_ring(sbuf, scount, sdtype, 
+                                                     rbuf, rcounts, rdispls, rdtype, 
+                                                     comm, module);
+    }
+    return ompi_coll_tuned_allgatherv_intra_neighborexchange(sbuf, scount, sdtype,
+                                                             rbuf, rcounts, rdispls, rdtype, 
+                                                             comm, module);
 }
 
 /*
@@ -774,3 +871,163 @@ int ompi_coll_tuned_scatter_intra_dec_fixed(void *sbuf, int scount,
                                                        rbuf, rcount, rdtype, 
                                                        root, comm, module);
 }
+
+/*
+ *	gatherv_intra_dec 
+ *
+ *	Function:	- seletects gatherv algorithm to use
+ *	Accepts:	- same arguments as MPI_Gatherv()
+ *	Returns:	- MPI_SUCCESS or error code, passed from corresponding
+ *                        internal gatherv function.
+ *
+ *	The counts are only known on the root, every process has to reach
+ *	the same decision from the communicator size alone.
+ */
+
+int ompi_coll_tuned_gatherv_intra_dec_fixed(void *sbuf, int scount, 
+                                            struct ompi_datatype_t *sdtype,
+                                            void* rbuf, int *rcounts, int *disps,
+                                            struct ompi_datatype_t *rdtype, 
+                                            int root,
+                                            struct ompi_communicator_t *comm,
+                                            mca_coll_base_module_t *module)
+{
+    const int large_communicator_size = 60;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, 
+                 "ompi_coll_tuned_gatherv_intra_dec_fixed"));
+
+    if (ompi_comm_size(comm) > large_communicator_size) {
+        return ompi_coll_tuned_gatherv_intra_binomial (sbuf, scount, sdtype, 
+                                                       rbuf, rcounts, disps, rdtype, 
+                                                       root, comm, module);
+    }
+    return ompi_coll_tuned_gatherv_intra_basic_linear (sbuf, scount, sdtype, 
+                                                       rbuf, rcounts, disps, rdtype, 
+                                                       root, comm, module);
+}
+
+/*
+ *	scatterv_intra_dec 
+ *
+ *	Function:	- seletects scatterv algorithm to use
+ *	Accepts:	- same arguments as MPI_Scatterv()
+ *	Returns:	- MPI_SUCCESS or error code, passed from corresponding
+ *                        internal scatterv function.
+ *
+ *	As for gatherv, only the communicator size is known everywhere.
+ */
+
+int ompi_coll_tuned_scatterv_intra_dec_fixed(void *sbuf, int *scounts, int *disps,
+                                             struct ompi_datatype_t *sdtype,
+                                             void* rbuf, int rcount, 
+                                             struct ompi_datatype_t *rdtype, 
+                                             int root, struct ompi_communicator_t *comm,
+                                             mca_coll_base_module_t *module)
+{
+    const int large_communicator_size = 60;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, 
+                 "ompi_coll_tuned_scatterv_intra_dec_fixed"));
+
+    if (ompi_comm_size(comm) > large_communicator_size) {
+        return ompi_coll_tuned_scatterv_intra_binomial (sbuf, scounts, disps, sdtype, 
+                                                        rbuf, rcount, rdtype, 
+                                                        root, comm, module);
+    }
+    return ompi_coll_tuned_scatterv_intra_basic_linear (sbuf, scounts, disps, sdtype, 
+                                                        rbuf, rcount, rdtype, 
+                                                        root, comm, module);
+}
+
+/*
+ *	scan_intra_dec 
+ *
+ *	Function:	- seletects scan algorithm to use
+ *	Accepts:	- same arguments as MPI_Scan()
+ *	Returns:	- MPI_SUCCESS or error code, passed from corresponding
+ *                        internal scan function.
+ *
+ *	All the algorithms keep the order of the operation. On a large
+ *	communicator spread over several nodes of consecutive ranks, only the
+ *	node leaders go over the network. Otherwise recursive doubling for
+ *	the latency, and the binomial sweeps, which send each buffer at most
+ *	twice per process instead of log(P) times, for large buffers.
+ */
+
+int ompi_coll_tuned_scan_intra_dec_fixed(void *sbuf, void *rbuf, int count,
+                                         struct ompi_datatype_t *dtype,
+                                         struct ompi_op_t *op,
+                                         struct ompi_communicator_t *comm,
+                                         mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    const int small_communicator_size = 8;
+    const size_t large_message_size = 64 * 1024;
+    int comm_size, nnodes;
+    size_t dsize;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_scan_intra_dec_fixed"));
+
+    comm_size = ompi_comm_size(comm);
+    if (comm_size > small_communicator_size) {
+        nnodes = ompi_coll_tuned_get_node_layout(comm, tuned_module->tuned_data);
+        if ((nnodes > 1) && (nnodes < comm_size) &&
+            tuned_module->tuned_data->cached_node_consecutive) {
+            return ompi_coll_tuned_scan_intra_hierarchical (sbuf, rbuf, count, dtype, op,
+                                                            comm, module);
+        }
+    }
+
+    ompi_datatype_type_size(dtype, &dsize);
+    if (dsize * (size_t)count <= large_message_size) {
+        return ompi_coll_tuned_scan_intra_recursivedoubling (sbuf, rbuf, count, dtype, op,
+                                                             comm, module);
+    }
+    return ompi_coll_tuned_scan_intra_binomial (sbuf, rbuf, count, dtype, op,
+                                                comm, module);
+}
+
+/*
+ *	exscan_intra_dec 
+ *
+ *	Function:	- seletects exscan algorithm to use
+ *	Accepts:	- same arguments as MPI_Exscan()
+ *	Returns:	- MPI_SUCCESS or error code, passed from corresponding
+ *                        internal exscan function.
+ *
+ *	Same choices as scan.
+ */
+
+int ompi_coll_tuned_exscan_intra_dec_fixed(void *sbuf, void *rbuf, int count,
+                                           struct ompi_datatype_t *dtype,
+                                           struct ompi_op_t *op,
+                                           struct ompi_communicator_t *comm,
+                                           mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    const int small_communicator_size = 8;
+    const size_t large_message_size = 64 * 1024;
+    int comm_size, nnodes;
+    size_t dsize;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_exscan_intra_dec_fixed"));
+
+    comm_size = ompi_comm_size(comm);
+    if (comm_size > small_communicator_size) {
+        nnodes = ompi_coll_tuned_get_node_layout(comm, tuned_module->tuned_data);
+        if ((nnodes > 1) && (nnodes < comm_size) &&
+            tuned_module->tuned_data->cached_node_consecutive) {
+            return ompi_coll_tuned_exscan_intra_hierarchical (sbuf, rbuf, count, dtype, op,
+                                                              comm, module);
+        }
+    }
+
+    ompi_datatype_type_size(dtype, &dsize);
+    if (dsize * (size_t)count <= large_message_size) {
+        return ompi_coll_tuned_exscan_intra_recursivedoubling (sbuf, rbuf, count, dtype, op,
+                                                               comm, module);
+    }
+    return ompi_coll_tuned_exscan_intra_binomial (sbuf, rbuf, count, dtype, op,
+                                                  comm, module);
+}
@@ -250,6 +250,69 @@ int ompi_coll_tuned_read_rules_config_file (char *fname, ompi_coll_alg_rule_t**
 }
 
 
+/*
+ * Writes the algorithm rule table for a max of n_collectives to a rule
+ * file called fname, in the format understood by
+ * ompi_coll_tuned_read_rules_config_file. Only collectives that have
+ * at least one communicator rule are written.
+ *
+ * Returns the number of collectives written, or a negative value if
+ * the file could not be written.
+ */
+
+int ompi_coll_tuned_write_rules_config_file (char *fname, ompi_coll_alg_rule_t* rules, int n_collectives)
+{
+    FILE *fptr = (FILE*) NULL;
+    ompi_coll_com_rule_t *com_p;
+    ompi_coll_msg_rule_t *msg_p;
+    int x, ncs, nms, X = 0;
+
+    if (!fname || !rules) {
+        return (-1);
+    }
+
+    for (x=0;x<n_collectives;x++) {
+        if (rules[x].n_com_sizes > 0) X++;
+    }
+
+    fptr = fopen (fname, "w");
+    if (!fptr) {
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"cannot write rules file [%s]\n", fname));
+        return (-1);
+    }
+
+    fprintf (fptr, "%d # number of collectives\n", X);
+
+    for (x=0;x<n_collectives;x++) { /* for each collective */
+        if (rules[x].n_com_sizes <= 0) continue;
+
+        fprintf (fptr, "%d # collective ID\n", rules[x].alg_rule_id);
+        fprintf (fptr, "%d # number of com sizes\n", rules[x].n_com_sizes);
+
+        for (ncs=0;ncs<rules[x].n_com_sizes;ncs++) {	/* for each comm size */
+            com_p = &(rules[x].com_rules[ncs]);
+
+            fprintf (fptr, "%d # comm size\n", com_p->mpi_comsize);
+            fprintf (fptr, "%d # number of msg sizes\n", com_p->n_msg_sizes);
+
+            for (nms=0;nms<com_p->n_msg_sizes;nms++) {	/* for each msg size */
+                msg_p = &(com_p->msg_rules[nms]);
+                fprintf (fptr, "%lu %d %d %ld # message size, algorithm, topo faninout, segmentation size\n",
+                         (unsigned long) msg_p->msg_size, msg_p->result_alg,
+                         msg_p->result_topo_faninout, msg_p->result_segsize);
+            }
+        }
+    }
+
+    if (0 != fclose (fptr)) {
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"error while writing rules file [%s]\n", fname));
+        return (-1);
+    }
+
+    return (X);
+}
+
+
 static void skiptonewline (FILE *fptr)
 {
     char val;
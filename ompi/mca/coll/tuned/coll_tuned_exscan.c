@@ -0,0 +1,330 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/op/op.h"
+#include "coll_tuned.h"
+#include "coll_tuned_util.h"
+
+/* exscan algorithm variables */
+static int coll_tuned_exscan_algorithm_count = 4;
+static int coll_tuned_exscan_forced_algorithm = 0;
+static int coll_tuned_exscan_segment_size = 0;
+static int coll_tuned_exscan_tree_fanout;
+static int coll_tuned_exscan_chain_fanout;
+
+/* valid values for coll_tuned_exscan_forced_algorithm */
+static mca_base_var_enum_value_t exscan_algorithms[] = {
+    {0, "ignore"},
+    {1, "basic_linear"},
+    {2, "recursive_doubling"},
+    {3, "binomial"},
+    {4, "hierarchical"},
+    {0, NULL}
+};
+
+/*
+ *  exscan_intra_basic_linear
+ *
+ *  Function:   - the chain of coll/basic: every process waits for the
+ *                result of the previous one
+ *  Accepts:    - same as MPI_Exscan()
+ *  Returns:    - MPI_SUCCESS or error code
+ */
+int ompi_coll_tuned_exscan_intra_basic_linear(void *sbuf, void *rbuf, int count,
+                                              struct ompi_datatype_t *dtype,
+                                              struct ompi_op_t *op,
+                                              struct ompi_communicator_t *comm,
+                                              mca_coll_base_module_t *module)
+{
+    int err = MPI_SUCCESS, line = 0, rank, size;
+    ptrdiff_t lb, extent, true_lb, true_extent;
+    char *tmpbuf_free = NULL, *tmpbuf;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:exscan_intra_basic_linear rank %d", rank));
+
+    if (MPI_IN_PLACE == sbuf) sbuf = rbuf;
+
+    if (0 == rank) {
+        if (1 == size) return MPI_SUCCESS;
+        return MCA_PML_CALL(send(sbuf, count, dtype, rank + 1, MCA_COLL_BASE_TAG_EXSCAN,
+                                 MCA_PML_BASE_SEND_STANDARD, comm));
+    }
+    if (size - 1 == rank) {
+        return MCA_PML_CALL(recv(rbuf, count, dtype, rank - 1, MCA_COLL_BASE_TAG_EXSCAN,
+                                 comm, MPI_STATUS_IGNORE));
+    }
+
+    /* keep my input, rbuf may be sbuf */
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    tmpbuf_free = (char*)malloc(true_extent + (ptrdiff_t)(count - 1) * extent);
+    if (NULL == tmpbuf_free) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+    tmpbuf = tmpbuf_free - true_lb;
+    err = ompi_datatype_copy_content_same_ddt(dtype, count, tmpbuf, (char*)sbuf);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    err = MCA_PML_CALL(recv(rbuf, count, dtype, rank - 1, MCA_COLL_BASE_TAG_EXSCAN,
+                            comm, MPI_STATUS_IGNORE));
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    ompi_op_reduce(op, rbuf, tmpbuf, count, dtype);
+
+    err = MCA_PML_CALL(send(tmpbuf, count, dtype, rank + 1, MCA_COLL_BASE_TAG_EXSCAN,
+                            MCA_PML_BASE_SEND_STANDARD, comm));
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    free(tmpbuf_free);
+    return MPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    if (NULL != tmpbuf_free) free(tmpbuf_free);
+    return err;
+}
+
+/*
+ *  exscan_intra_recursivedoubling
+ *
+ *  Function:   - recursive doubling, log(P) steps
+ *  Accepts:    - same as MPI_Exscan()
+ *  Returns:    - MPI_SUCCESS or error code
+ */
+int ompi_coll_tuned_exscan_intra_recursivedoubling(void *sbuf, void *rbuf, int count,
+                                                   struct ompi_datatype_t *dtype,
+                                                   struct ompi_op_t *op,
+                                                   struct ompi_communicator_t *comm,
+                                                   mca_coll_base_module_t *module)
+{
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:exscan_intra_recursivedoubling rank %d",
+                 ompi_comm_rank(comm)));
+
+    if (MPI_IN_PLACE == sbuf) sbuf = rbuf;
+    return ompi_coll_tuned_prefix_recursivedoubling(sbuf, rbuf, count, dtype, op, 1,
+                                                    NULL, 0, ompi_comm_size(comm),
+                                                    ompi_comm_rank(comm),
+                                                    MCA_COLL_BASE_TAG_EXSCAN, comm);
+}
+
+/*
+ *  exscan_intra_binomial
+ *
+ *  Function:   - inclusive up sweep / down sweep, then a shift by one
+ *  Accepts:    - same as MPI_Exscan()
+ *  Returns:    - MPI_SUCCESS or error code
+ */
+int ompi_coll_tuned_exscan_intra_binomial(void *sbuf, void *rbuf, int count,
+                                          struct ompi_datatype_t *dtype,
+                                          struct ompi_op_t *op,
+                                          struct ompi_communicator_t *comm,
+                                          mca_coll_base_module_t *module)
+{
+    int err = MPI_SUCCESS, line = 0, rank, size;
+    ptrdiff_t lb, extent, true_lb, true_extent;
+    char *tmpbuf_free = NULL, *tmpbuf;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:exscan_intra_binomial rank %d", rank));
+
+    if (1 == size) return MPI_SUCCESS;
+    if (MPI_IN_PLACE == sbuf) sbuf = rbuf;
+
+    /* the last process does not need its inclusive prefix */
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    tmpbuf_free = (char*)malloc(true_extent + (ptrdiff_t)(count - 1) * extent);
+    if (NULL == tmpbuf_free) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+    tmpbuf = tmpbuf_free - true_lb;
+    err = ompi_datatype_copy_content_same_ddt(dtype, count, tmpbuf, (char*)sbuf);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    err = ompi_coll_tuned_prefix_binomial(tmpbuf, count, dtype, op, MCA_COLL_BASE_TAG_EXSCAN, comm);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    if (0 == rank) {
+        err = MCA_PML_CALL(send(tmpbuf, count, dtype, rank + 1, MCA_COLL_BASE_TAG_EXSCAN,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+    } else if (size - 1 == rank) {
+        err = MCA_PML_CALL(recv(rbuf, count, dtype, rank - 1, MCA_COLL_BASE_TAG_EXSCAN,
+                                comm, MPI_STATUS_IGNORE));
+    } else {
+        err = ompi_coll_tuned_sendrecv(tmpbuf, count, dtype, rank + 1, MCA_COLL_BASE_TAG_EXSCAN,
+                                       rbuf, count, dtype, rank - 1, MCA_COLL_BASE_TAG_EXSCAN,
+                                       comm, MPI_STATUS_IGNORE, rank);
+    }
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    free(tmpbuf_free);
+    return MPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    if (NULL != tmpbuf_free) free(tmpbuf_free);
+    return err;
+}
+
+/*
+ *  exscan_intra_hierarchical
+ *
+ *  Function:   - within the nodes, across the node leaders, then back
+ *  Accepts:    - same as MPI_Exscan()
+ *  Returns:    - MPI_SUCCESS or error code
+ */
+int ompi_coll_tuned_exscan_intra_hierarchical(void *sbuf, void *rbuf, int count,
+                                              struct ompi_datatype_t *dtype,
+                                              struct ompi_op_t *op,
+                                              struct ompi_communicator_t *comm,
+                                              mca_coll_base_module_t *module)
+{
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:exscan_intra_hierarchical rank %d",
+                 ompi_comm_rank(comm)));
+
+    if (MPI_IN_PLACE == sbuf) sbuf = rbuf;
+    return ompi_coll_tuned_prefix_hierarchical(sbuf, rbuf, count, dtype, op, 1,
+                                               MCA_COLL_BASE_TAG_EXSCAN, comm, module);
+}
+
+/* The following are used by dynamic and forced rules */
+
+/* publish details of each algorithm and if its forced/fixed/locked in */
+/* as you add methods/algorithms you must update this and the query/map routines */
+
+/* this routine is called by the component only */
+/* this makes sure that the mca parameters are set to their initial values and perms */
+/* module does not call this they call the forced_getvalues routine instead */
+
+int ompi_coll_tuned_exscan_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices)
+{
+    mca_base_var_enum_t *new_enum;
+
+    ompi_coll_tuned_forced_max_algorithms[EXSCAN] = coll_tuned_exscan_algorithm_count;
+
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "exscan_algorithm_count",
+                                           "Number of exscan algorithms available",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_CONSTANT,
+                                           &coll_tuned_exscan_algorithm_count);
+
+    /* MPI_T: This variable should eventually be bound to a communicator */
+    coll_tuned_exscan_forced_algorithm = 0;
+    (void) mca_base_var_enum_create("coll_tuned_exscan_algorithms", exscan_algorithms, &new_enum);
+    mca_param_indices->algorithm_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "exscan_algorithm",
+                                        "Which exscan algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 recursive doubling, 3 binomial (up/down sweep, then shift), 4 hierarchical (requires the ranks of each node to be consecutive)",
+                                        MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_exscan_forced_algorithm);
+    OBJ_RELEASE(new_enum);
+    if (mca_param_indices->algorithm_param_index < 0) {
+        return mca_param_indices->algorithm_param_index;
+    }
+
+    coll_tuned_exscan_segment_size = 0;
+    mca_param_indices->segsize_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "exscan_algorithm_segmentsize",
+                                        "Segment size in bytes used by default for exscan algorithms. Only has meaning if algorithm is forced and supports segmenting. 0 bytes means no segmentation.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_exscan_segment_size);
+
+    coll_tuned_exscan_tree_fanout = ompi_coll_tuned_init_tree_fanout; /* get system wide default */
+    mca_param_indices->tree_fanout_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "exscan_algorithm_tree_fanout",
+                                        "Fanout for n-tree used for exscan algorithms. Only has meaning if algorithm is forced and supports n-tree topo based operation.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_exscan_tree_fanout);
+
+    coll_tuned_exscan_chain_fanout = ompi_coll_tuned_init_chain_fanout; /* get system wide default */
+    mca_param_indices->chain_fanout_param_index =
+      mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                      "exscan_algorithm_chain_fanout",
+                                      "Fanout for chains used for exscan algorithms. Only has meaning if algorithm is forced and supports chain topo based operation.",
+                                      MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                      OPAL_INFO_LVL_5,
+                                      MCA_BASE_VAR_SCOPE_READONLY,
+                                      &coll_tuned_exscan_chain_fanout);
+
+    return (MPI_SUCCESS);
+}
+
+
+int ompi_coll_tuned_exscan_intra_do_forced(void *sbuf, void* rbuf, int count,
+                                           struct ompi_datatype_t *dtype,
+                                           struct ompi_op_t *op,
+                                           struct ompi_communicator_t *comm,
+                                           mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:exscan_intra_do_forced selected algorithm %d",
+                 data->user_forced[EXSCAN].algorithm));
+
+    return ompi_coll_tuned_exscan_intra_do_this(sbuf, rbuf, count, dtype, op, comm, module,
+                                                data->user_forced[EXSCAN].algorithm, 0, 0);
+}
+
+
+int ompi_coll_tuned_exscan_intra_do_this(void *sbuf, void* rbuf, int count,
+                                         struct ompi_datatype_t *dtype,
+                                         struct ompi_op_t *op,
+                                         struct ompi_communicator_t *comm,
+                                         mca_coll_base_module_t *module,
+                                         int algorithm, int faninout, int segsize)
+{
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:exscan_intra_do_this selected algorithm %d topo faninout %d segsize %d",
+                 algorithm, faninout, segsize));
+
+    switch (algorithm) {
+    case (0): return ompi_coll_tuned_exscan_intra_dec_fixed(sbuf, rbuf, count, dtype, op,
+                                                            comm, module);
+    case (1): return ompi_coll_tuned_exscan_intra_basic_linear(sbuf, rbuf, count, dtype, op,
+                                                               comm, module);
+    case (2): return ompi_coll_tuned_exscan_intra_recursivedoubling(sbuf, rbuf, count, dtype, op,
+                                                                    comm, module);
+    case (3): return ompi_coll_tuned_exscan_intra_binomial(sbuf, rbuf, count, dtype, op,
+                                                           comm, module);
+    case (4): return ompi_coll_tuned_exscan_intra_hierarchical(sbuf, rbuf, count, dtype, op,
+                                                               comm, module);
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:exscan_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[EXSCAN]));
+        return (MPI_ERR_ARG);
+    } /* switch */
+}
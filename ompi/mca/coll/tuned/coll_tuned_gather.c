@@ -33,7 +33,7 @@
 #include "coll_tuned_util.h"
 
 /* gather algorithm variables */
-static int coll_tuned_gather_algorithm_count = 3;
+static int coll_tuned_gather_algorithm_count = 4;
 static int coll_tuned_gather_forced_algorithm = 0;
 static int coll_tuned_gather_segment_size = 0;
 static int coll_tuned_gather_tree_fanout;
@@ -45,38 +45,39 @@ static mca_base_var_enum_value_t gather_algorithms[] = {
     {1, "basic_linear"},
     {2, "binomial"},
     {3, "linear_sync"},
+    {4, "knomial"},
     {0, NULL}
 };
 
 /* Todo: gather_intra_generic, gather_intra_binary, gather_intra_chain,
  * gather_intra_pipeline, segmentation? */
-int
-ompi_coll_tuned_gather_intra_binomial(void *sbuf, int scount,
-                                      struct ompi_datatype_t *sdtype,
-                                      void *rbuf, int rcount,
-                                      struct ompi_datatype_t *rdtype,
-                                      int root,
-                                      struct ompi_communicator_t *comm,
-                                      mca_coll_base_module_t *module)
+
+/*
+ * Gather along an in-order tree of the given radix where the subtree of
+ * each child holds the following ranks, the in-order binomial (radix 2)
+ * and k-nomial trees: every node receives the blocks of its subtree
+ * already in rank order after its own.
+ */
+static int
+ompi_coll_tuned_gather_intra_in_order_tree(void *sbuf, int scount,
+                                           struct ompi_datatype_t *sdtype,
+                                           void *rbuf, int rcount,
+                                           struct ompi_datatype_t *rdtype,
+                                           int root,
+                                           struct ompi_communicator_t *comm,
+                                           ompi_coll_tree_t* tree, int radix)
 {
     int line = -1, i, rank, vrank, size, total_recv = 0, err;
     char *ptmp     = NULL, *tempbuf  = NULL;
-    ompi_coll_tree_t* bmtree;
     MPI_Status status;
     MPI_Aint sextent, slb, strue_lb, strue_extent; 
     MPI_Aint rextent, rlb, rtrue_lb, rtrue_extent;
-    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
-    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
 
     size = ompi_comm_size(comm);
     rank = ompi_comm_rank(comm);
 
     OPAL_OUTPUT((ompi_coll_tuned_stream,
-                 "ompi_coll_tuned_gather_intra_binomial rank %d", rank));
-
-    /* create the binomial tree */
-    COLL_TUNED_UPDATE_IN_ORDER_BMTREE( comm, tuned_module, root );
-    bmtree = data->cached_in_order_bmtree;
+                 "ompi_coll_tuned_gather_intra_in_order_tree rank %d radix %d", rank, radix));
 
     ompi_datatype_get_extent(sdtype, &slb, &sextent);
     ompi_datatype_get_true_extent(sdtype, &strue_lb, &strue_extent);
@@ -116,10 +117,10 @@ ompi_coll_tuned_gather_intra_binomial(void *sbuf, int scount,
             }
         }
         total_recv = rcount;
-    } else if (!(vrank % 2)) {
+    } else if (!(vrank % radix)) {
         /* other non-leaf nodes, allocate temp buffer for data received from
-         * children, the most we need is half of the total data elements due
-         * to the property of binimoal tree */
+         * children, the most we need is 1/radix of the total data
+         * elements due to the property of the tree */
         tempbuf = (char *) malloc(strue_extent + ((ptrdiff_t)scount * (ptrdiff_t)size - 1) * sextent);
         if (NULL == tempbuf) {
             err= OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
@@ -144,23 +145,24 @@ ompi_coll_tuned_gather_intra_binomial(void *sbuf, int scount,
         total_recv = scount;
     }
 
-    if (!(vrank % 2)) {
+    if (!(vrank % radix)) {
         /* all non-leaf nodes recv from children */
-        for (i = 0; i < bmtree->tree_nextsize; i++) {
+        for (i = 0; i < tree->tree_nextsize; i++) {
             int mycount = 0, vkid;
-            /* figure out how much data I have to send to this child */
-            vkid = (bmtree->tree_next[i] - root + size) % size;
-            mycount = vkid - vrank;
+            /* figure out how much data I have to send to this child: its
+             * subtree spans the largest power of radix up to the distance */
+            vkid = (tree->tree_next[i] - root + size) % size;
+            for (mycount = 1; mycount * radix <= vkid - vrank; mycount *= radix);
             if (mycount > (size - vkid))
                 mycount = size - vkid;
             mycount *= rcount;
 
             OPAL_OUTPUT((ompi_coll_tuned_stream,
-                         "ompi_coll_tuned_gather_intra_binomial rank %d recv %d mycount = %d",
-                         rank, bmtree->tree_next[i], mycount));
+                         "ompi_coll_tuned_gather_intra_in_order_tree rank %d recv %d mycount = %d",
+                         rank, tree->tree_next[i], mycount));
 
             err = MCA_PML_CALL(recv(ptmp + total_recv*rextent, (ptrdiff_t)rcount * size - total_recv, rdtype,
-                                    bmtree->tree_next[i], MCA_COLL_BASE_TAG_GATHER,
+                                    tree->tree_next[i], MCA_COLL_BASE_TAG_GATHER,
                                     comm, &status));
             if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
 
@@ -171,11 +173,11 @@ ompi_coll_tuned_gather_intra_binomial(void *sbuf, int scount,
     if (rank != root) {
         /* all nodes except root send to parents */
         OPAL_OUTPUT((ompi_coll_tuned_stream,
-                     "ompi_coll_tuned_gather_intra_binomial rank %d send %d count %d\n",
-                     rank, bmtree->tree_prev, total_recv));
+                     "ompi_coll_tuned_gather_intra_in_order_tree rank %d send %d count %d\n",
+                     rank, tree->tree_prev, total_recv));
 
         err = MCA_PML_CALL(send(ptmp, total_recv, sdtype,
-                                bmtree->tree_prev,
+                                tree->tree_prev,
                                 MCA_COLL_BASE_TAG_GATHER,
                                 MCA_PML_BASE_SEND_STANDARD, comm));
         if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
@@ -195,7 +197,7 @@ ompi_coll_tuned_gather_intra_binomial(void *sbuf, int scount,
 
             free(tempbuf);
         }
-    } else if (!(vrank % 2)) {
+    } else if (!(vrank % radix)) {
         /* other non-leaf nodes */
         free(tempbuf);
     }
@@ -210,6 +212,60 @@ ompi_coll_tuned_gather_intra_binomial(void *sbuf, int scount,
     return err;
 }
 
+int
+ompi_coll_tuned_gather_intra_binomial(void *sbuf, int scount,
+                                      struct ompi_datatype_t *sdtype,
+                                      void *rbuf, int rcount,
+                                      struct ompi_datatype_t *rdtype,
+                                      int root,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_gather_intra_binomial rank %d", ompi_comm_rank(comm)));
+
+    /* create the binomial tree */
+    COLL_TUNED_UPDATE_IN_ORDER_BMTREE( comm, tuned_module, root );
+
+    return ompi_coll_tuned_gather_intra_in_order_tree(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                      root, comm, data->cached_in_order_bmtree, 2);
+}
+
+/*
+ *	gather_intra_knomial
+ *
+ *	Function:	- gather along an in-order k-nomial tree, radix 2 is
+ *			  the binomial tree
+ *	Accepts:	- same arguments as MPI_Gather(), radix
+ *	Returns:	- MPI_SUCCESS or error code
+ */
+int
+ompi_coll_tuned_gather_intra_knomial(void *sbuf, int scount,
+                                     struct ompi_datatype_t *sdtype,
+                                     void *rbuf, int rcount,
+                                     struct ompi_datatype_t *rdtype,
+                                     int root,
+                                     struct ompi_communicator_t *comm,
+                                     mca_coll_base_module_t *module,
+                                     int radix)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    radix = COLL_TUNED_KNOMIAL_RADIX(radix);
+    COLL_TUNED_UPDATE_IN_ORDER_KMTREE( comm, tuned_module, root, radix );
+    if (NULL == data->cached_in_order_kmtree) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    return ompi_coll_tuned_gather_intra_in_order_tree(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                      root, comm, data->cached_in_order_kmtree,
+                                                      data->cached_in_order_kmtree->tree_fanout);
+}
+
 /*
  *	gather_intra_linear_sync
  *
@@ -455,7 +511,7 @@ ompi_coll_tuned_gather_intra_check_forced_init(coll_tuned_force_algorithm_mca_pa
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "gather_algorithm",
-                                        "Which gather algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 binomial, 3 linear with synchronization.",
+                                        "Which gather algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 binomial, 3 linear with synchronization, 4 knomial (radix from gather_algorithm_tree_fanout).",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_READONLY,
@@ -532,6 +588,11 @@ ompi_coll_tuned_gather_intra_do_forced(void *sbuf, int scount,
                                                              rbuf, rcount, rdtype,
                                                              root, comm, module,
                                                              data->user_forced[GATHER].segsize);
+    case (4):
+        return ompi_coll_tuned_gather_intra_knomial(sbuf, scount, sdtype,
+                                                    rbuf, rcount, rdtype,
+                                                    root, comm, module,
+                                                    data->user_forced[GATHER].tree_fanout);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,
                      "coll:tuned:gather_intra_do_forced attempt to select algorithm %d when only 0-%d is valid?", 
@@ -573,6 +634,11 @@ ompi_coll_tuned_gather_intra_do_this(void *sbuf, int scount,
                                                          rbuf, rcount, rdtype,
                                                          root, comm, module,
                                                          segsize);
+    case (4):
+        return ompi_coll_tuned_gather_intra_knomial(sbuf, scount, sdtype,
+                                                    rbuf, rcount, rdtype,
+                                                    root, comm, module,
+                                                    faninout);
 
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,
@@ -0,0 +1,433 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "coll_tuned.h"
+#include "coll_tuned_topo.h"
+#include "coll_tuned_util.h"
+
+/* gatherv algorithm variables */
+static int coll_tuned_gatherv_algorithm_count = 2;
+static int coll_tuned_gatherv_forced_algorithm = 0;
+static int coll_tuned_gatherv_segment_size = 0;
+static int coll_tuned_gatherv_tree_fanout;
+static int coll_tuned_gatherv_chain_fanout;
+
+/* valid values for coll_tuned_gatherv_forced_algorithm */
+static mca_base_var_enum_value_t gatherv_algorithms[] = {
+    {0, "ignore"},
+    {1, "basic_linear"},
+    {2, "binomial"},
+    {0, NULL}
+};
+
+/*
+ *	gatherv_intra_binomial
+ *
+ *	Function:	- gatherv along the in-order binomial tree
+ *	Accepts:	- same arguments as MPI_Gatherv()
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ * The counts are only known on the root, so the inner nodes cannot size
+ * the blocks of their subtree.  Every node packs its own block, appends
+ * the subtrees of its childs in rank order, as many bytes as the probe
+ * reports, and sends the aggregate to its parent as MPI_PACKED.  The
+ * root receives the leaves straight in place and unpacks the other
+ * subtrees one at a time from the counts.
+ */
+int
+ompi_coll_tuned_gatherv_intra_binomial(void *sbuf, int scount,
+                                       struct ompi_datatype_t *sdtype,
+                                       void *rbuf, int *rcounts, int *disps,
+                                       struct ompi_datatype_t *rdtype,
+                                       int root,
+                                       struct ompi_communicator_t *comm,
+                                       mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+    int line = -1, i, j, r, rank, vrank, vkid, span, size, err = MPI_SUCCESS;
+    size_t dsize, bytes, total = 0, capacity = 0;
+    char *tempbuf = NULL, *newbuf;
+    ompi_status_public_t status;
+    MPI_Aint rextent, rlb;
+    ompi_coll_tree_t *tree;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_gatherv_intra_binomial rank %d", rank));
+
+    /* create the binomial tree */
+    COLL_TUNED_UPDATE_IN_ORDER_BMTREE( comm, tuned_module, root );
+    tree = data->cached_in_order_bmtree;
+
+    vrank = (rank - root + size) % size;
+
+    if (rank == root) {
+        ompi_datatype_get_extent(rdtype, &rlb, &rextent);
+        ompi_datatype_type_size(rdtype, &dsize);
+
+        if (MPI_IN_PLACE != sbuf && rcounts[rank] > 0) {
+            err = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                       (char *)rbuf + (ptrdiff_t)disps[rank] * rextent,
+                                       rcounts[rank], rdtype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+
+        for (i = 0; i < tree->tree_nextsize; i++) {
+            vkid = (tree->tree_next[i] - root + size) % size;
+            span = vkid - vrank;
+            if (span > size - vkid) span = size - vkid;
+
+            if (1 == span) {
+                /* a leaf, its block goes where it belongs */
+                err = MCA_PML_CALL(recv((char *)rbuf + (ptrdiff_t)disps[tree->tree_next[i]] * rextent,
+                                        rcounts[tree->tree_next[i]], rdtype,
+                                        tree->tree_next[i], MCA_COLL_BASE_TAG_GATHERV,
+                                        comm, MPI_STATUS_IGNORE));
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+                continue;
+            }
+
+            for (bytes = 0, j = vkid; j < vkid + span; j++) {
+                bytes += dsize * (size_t)rcounts[(j + root) % size];
+            }
+            if (bytes > capacity) {
+                free(tempbuf);
+                tempbuf = (char *) malloc(bytes);
+                if (NULL == tempbuf) {
+                    err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+                }
+                capacity = bytes;
+            }
+            err = MCA_PML_CALL(recv(tempbuf, (int)bytes, MPI_PACKED,
+                                    tree->tree_next[i], MCA_COLL_BASE_TAG_GATHERV,
+                                    comm, MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+            /* unpack the subtree, the blocks follow each other in rank order */
+            for (total = 0, j = vkid; j < vkid + span; j++) {
+                r = (j + root) % size;
+                if (0 == rcounts[r]) continue;
+                bytes = dsize * (size_t)rcounts[r];
+                err = ompi_datatype_sndrcv(tempbuf + total, (int)bytes, MPI_PACKED,
+                                           (char *)rbuf + (ptrdiff_t)disps[r] * rextent,
+                                           rcounts[r], rdtype);
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+                total += bytes;
+            }
+        }
+
+        free(tempbuf);
+        return MPI_SUCCESS;
+    }
+
+    if (0 == tree->tree_nextsize) {
+        /* leaf nodes send their block as it is */
+        return MCA_PML_CALL(send(sbuf, scount, sdtype, tree->tree_prev,
+                                 MCA_COLL_BASE_TAG_GATHERV,
+                                 MCA_PML_BASE_SEND_STANDARD, comm));
+    }
+
+    /* inner nodes: pack the local block first, then the subtrees of the
+     * childs as they arrive */
+    ompi_datatype_type_size(sdtype, &dsize);
+    capacity = dsize * (size_t)scount;
+    tempbuf = (char *) malloc(capacity > 0 ? capacity : 1);
+    if (NULL == tempbuf) {
+        err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+    }
+    if (scount > 0) {
+        err = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                   tempbuf, (int)capacity, MPI_PACKED);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    total = capacity;
+
+    for (i = 0; i < tree->tree_nextsize; i++) {
+        err = MCA_PML_CALL(probe(tree->tree_next[i], MCA_COLL_BASE_TAG_GATHERV,
+                                 comm, &status));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        bytes = status._ucount;
+
+        if (total + bytes > capacity) {
+            newbuf = (char *) realloc(tempbuf, total + bytes);
+            if (NULL == newbuf) {
+                err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+            }
+            tempbuf = newbuf;
+            capacity = total + bytes;
+        }
+        err = MCA_PML_CALL(recv(tempbuf + total, (int)bytes, MPI_PACKED,
+                                tree->tree_next[i], MCA_COLL_BASE_TAG_GATHERV,
+                                comm, MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        total += bytes;
+    }
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_gatherv_intra_binomial rank %d send %d bytes %lu",
+                 rank, tree->tree_prev, (unsigned long)total));
+
+    err = MCA_PML_CALL(send(tempbuf, (int)total, MPI_PACKED, tree->tree_prev,
+                            MCA_COLL_BASE_TAG_GATHERV,
+                            MCA_PML_BASE_SEND_STANDARD, comm));
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    free(tempbuf);
+    return MPI_SUCCESS;
+
+ err_hndl:
+    if (NULL != tempbuf)
+        free(tempbuf);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,  "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    return err;
+}
+
+/*
+ * Linear functions are copied from the BASIC coll module
+ * they do not segment the message and are simple implementations
+ * but for some small number of nodes and/or small data sizes they
+ * are just as fast as tuned/tree based segmenting operations
+ * and as such may be selected by the decision functions
+ * These are copied into this module due to the way we select modules
+ * in V1. i.e. in V2 we will handle this differently and so will not
+ * have to duplicate code.
+ */
+
+/* copied function (with appropriate renaming) starts here */
+
+/*
+ *	gatherv_intra_basic_linear
+ *
+ *	Function:	- basic gatherv operation
+ *	Accepts:	- same arguments as MPI_Gatherv()
+ *	Returns:	- MPI_SUCCESS or error code
+ */
+int
+ompi_coll_tuned_gatherv_intra_basic_linear(void *sbuf, int scount,
+                                           struct ompi_datatype_t *sdtype,
+                                           void *rbuf, int *rcounts, int *disps,
+                                           struct ompi_datatype_t *rdtype,
+                                           int root,
+                                           struct ompi_communicator_t *comm,
+                                           mca_coll_base_module_t *module)
+{
+    int i, rank, size, err = MPI_SUCCESS;
+    char *ptmp;
+    ptrdiff_t lb, extent;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_gatherv_intra_basic_linear rank %d", rank));
+
+    /* Everyone but root sends data and returns. */
+    if (rank != root) {
+        if (scount > 0) {
+            return MCA_PML_CALL(send(sbuf, scount, sdtype, root,
+                                     MCA_COLL_BASE_TAG_GATHERV,
+                                     MCA_PML_BASE_SEND_STANDARD, comm));
+        }
+        return MPI_SUCCESS;
+    }
+
+    /* I am the root, loop receiving data. */
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+    for (i = 0; i < size; ++i) {
+        ptmp = ((char *) rbuf) + (extent * disps[i]);
+
+        if (i == rank) {
+            if (MPI_IN_PLACE != sbuf && (0 < scount) && (0 < rcounts[i])) {
+                err = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                           ptmp, rcounts[i], rdtype);
+            }
+        } else if (rcounts[i] > 0) {
+            err = MCA_PML_CALL(recv(ptmp, rcounts[i], rdtype, i,
+                                    MCA_COLL_BASE_TAG_GATHERV,
+                                    comm, MPI_STATUS_IGNORE));
+        }
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    /* All done */
+
+    return MPI_SUCCESS;
+}
+
+
+/* copied function (with appropriate renaming) ends here */
+
+/* The following are used by dynamic and forced rules */
+
+/* publish details of each algorithm and if its forced/fixed/locked in */
+/* as you add methods/algorithms you must update this and the query/map
+   routines */
+
+/* this routine is called by the component only */
+/* this makes sure that the mca parameters are set to their initial values
+   and perms */
+/* module does not call this they call the forced_getvalues routine instead */
+
+int
+ompi_coll_tuned_gatherv_intra_check_forced_init(coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices)
+{
+    mca_base_var_enum_t *new_enum;
+
+    ompi_coll_tuned_forced_max_algorithms[GATHERV] = coll_tuned_gatherv_algorithm_count;
+
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "gatherv_algorithm_count",
+                                           "Number of gatherv algorithms available",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_CONSTANT,
+                                           &coll_tuned_gatherv_algorithm_count);
+
+    /* MPI_T: This variable should eventually be bound to a communicator */
+    coll_tuned_gatherv_forced_algorithm = 0;
+    (void) mca_base_var_enum_create("coll_tuned_gatherv_algorithms", gatherv_algorithms, &new_enum);
+    mca_param_indices->algorithm_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "gatherv_algorithm",
+                                        "Which gatherv algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 binomial.",
+                                        MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_gatherv_forced_algorithm);
+    OBJ_RELEASE(new_enum);
+    if (mca_param_indices->algorithm_param_index < 0) {
+        return mca_param_indices->algorithm_param_index;
+    }
+
+    coll_tuned_gatherv_segment_size = 0;
+    mca_param_indices->segsize_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "gatherv_algorithm_segmentsize",
+                                        "Segment size in bytes used by default for gatherv algorithms. Only has meaning if algorithm is forced and supports segmenting. 0 bytes means no segmentation. Currently, available algorithms do not support segmentation.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_gatherv_segment_size);
+
+    coll_tuned_gatherv_tree_fanout = ompi_coll_tuned_init_tree_fanout; /* get system wide default */
+    mca_param_indices->tree_fanout_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "gatherv_algorithm_tree_fanout",
+                                        "Fanout for n-tree used for gatherv algorithms. Only has meaning if algorithm is forced and supports n-tree topo based operation. Currently, available algorithms do not support n-tree topologies.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_gatherv_tree_fanout);
+
+    coll_tuned_gatherv_chain_fanout = ompi_coll_tuned_init_chain_fanout; /* get system wide default */
+    mca_param_indices->chain_fanout_param_index =
+      mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                      "gatherv_algorithm_chain_fanout",
+                                      "Fanout for chains used for gatherv algorithms. Only has meaning if algorithm is forced and supports chain topo based operation. Currently, available algorithms do not support chain topologies.",
+                                      MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                      OPAL_INFO_LVL_5,
+                                      MCA_BASE_VAR_SCOPE_READONLY,
+                                      &coll_tuned_gatherv_chain_fanout);
+
+    return (MPI_SUCCESS);
+}
+
+int
+ompi_coll_tuned_gatherv_intra_do_forced(void *sbuf, int scount,
+                                        struct ompi_datatype_t *sdtype,
+                                        void *rbuf, int *rcounts, int *disps,
+                                        struct ompi_datatype_t *rdtype,
+                                        int root,
+                                        struct ompi_communicator_t *comm,
+                                        mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:gatherv_intra_do_forced selected algorithm %d",
+                 data->user_forced[GATHERV].algorithm));
+
+    switch (data->user_forced[GATHERV].algorithm) {
+    case (0):
+        return ompi_coll_tuned_gatherv_intra_dec_fixed (sbuf, scount, sdtype,
+                                                        rbuf, rcounts, disps, rdtype,
+                                                        root, comm, module);
+    case (1):
+        return ompi_coll_tuned_gatherv_intra_basic_linear (sbuf, scount, sdtype,
+                                                           rbuf, rcounts, disps, rdtype,
+                                                           root, comm, module);
+    case (2):
+        return ompi_coll_tuned_gatherv_intra_binomial (sbuf, scount, sdtype,
+                                                       rbuf, rcounts, disps, rdtype,
+                                                       root, comm, module);
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,
+                     "coll:tuned:gatherv_intra_do_forced attempt to select algorithm %d when only 0-%d is valid?",
+                     data->user_forced[GATHERV].algorithm,
+                     ompi_coll_tuned_forced_max_algorithms[GATHERV]));
+        return (MPI_ERR_ARG);
+    } /* switch */
+}
+
+int
+ompi_coll_tuned_gatherv_intra_do_this(void *sbuf, int scount,
+                                      struct ompi_datatype_t *sdtype,
+                                      void *rbuf, int *rcounts, int *disps,
+                                      struct ompi_datatype_t *rdtype,
+                                      int root,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module,
+                                      int algorithm, int faninout, int segsize)
+{
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:gatherv_intra_do_this selected algorithm %d topo faninout %d segsize %d",
+                 algorithm, faninout, segsize));
+
+    switch (algorithm) {
+    case (0):
+        return ompi_coll_tuned_gatherv_intra_dec_fixed (sbuf, scount, sdtype,
+                                                        rbuf, rcounts, disps, rdtype,
+                                                        root, comm, module);
+    case (1):
+        return ompi_coll_tuned_gatherv_intra_basic_linear (sbuf, scount, sdtype,
+                                                           rbuf, rcounts, disps, rdtype,
+                                                           root, comm, module);
+    case (2):
+        return ompi_coll_tuned_gatherv_intra_binomial (sbuf, scount, sdtype,
+                                                       rbuf, rcounts, disps, rdtype,
+                                                       root, comm, module);
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,
+                     "coll:tuned:gatherv_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm,
+                     ompi_coll_tuned_forced_max_algorithms[GATHERV]));
+        return (MPI_ERR_ARG);
+    } /* switch */
+}
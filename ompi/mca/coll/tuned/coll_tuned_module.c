@@ -30,6 +30,7 @@
 #include "coll_tuned_topo.h"
 #include "coll_tuned_dynamic_rules.h"
 #include "coll_tuned_dynamic_file.h"
+#include "coll_tuned_autotune.h"
 
 static int tuned_module_enable(mca_coll_base_module_t *module,
 			       struct ompi_communicator_t *comm);
@@ -100,14 +101,15 @@ ompi_coll_tuned_comm_query(struct ompi_communicator_t *comm, int *priority)
     tuned_module->super.coll_alltoallw  = NULL;
     tuned_module->super.coll_barrier    = ompi_coll_tuned_barrier_intra_dec_fixed;
     tuned_module->super.coll_bcast      = ompi_coll_tuned_bcast_intra_dec_fixed;
-    tuned_module->super.coll_exscan     = NULL;
+    tuned_module->super.coll_exscan     = ompi_coll_tuned_exscan_intra_dec_fixed;
     tuned_module->super.coll_gather     = ompi_coll_tuned_gather_intra_dec_fixed;
-    tuned_module->super.coll_gatherv    = NULL;
+    tuned_module->super.coll_gatherv    = ompi_coll_tuned_gatherv_intra_dec_fixed;
     tuned_module->super.coll_reduce     = ompi_coll_tuned_reduce_intra_dec_fixed;
     tuned_module->super.coll_reduce_scatter = ompi_coll_tuned_reduce_scatter_intra_dec_fixed;
-    tuned_module->super.coll_scan       = NULL;
+    tuned_module->super.coll_reduce_scatter_block = ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed;
+    tuned_module->super.coll_scan       = ompi_coll_tuned_scan_intra_dec_fixed;
     tuned_module->super.coll_scatter    = ompi_coll_tuned_scatter_intra_dec_fixed;
-    tuned_module->super.coll_scatterv   = NULL;
+    tuned_module->super.coll_scatterv   = ompi_coll_tuned_scatterv_intra_dec_fixed;
 
     return &(tuned_module->super);
 }
@@ -154,6 +156,12 @@ ompi_coll_tuned_forced_getvalues( enum COLLTYPE type,
             need_dynamic_decision = 1;                                  \
             EXECUTE;                                                    \
         }                                                               \
+        if( ompi_coll_tuned_autotune ) {                                \
+            (DATA)->autotune[(TYPE)] = ompi_coll_tuned_autotune_create( (TYPE), size ); \
+            if( NULL != (DATA)->autotune[(TYPE)] ) {                    \
+                need_dynamic_decision = 1;                              \
+            }                                                           \
+        }                                                               \
         if( NULL != mca_coll_tuned_component.all_base_rules ) {         \
             (DATA)->com_rules[(TYPE)]                                   \
                 = ompi_coll_tuned_get_com_rule_ptr( mca_coll_tuned_component.all_base_rules, \
@@ -176,7 +184,7 @@ static int
 tuned_module_enable( mca_coll_base_module_t *module,
                      struct ompi_communicator_t *comm )
 {
-    int size;
+    int size, i;
     mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t *) module;
     mca_coll_tuned_comm_t *data = NULL;
 
@@ -219,6 +227,10 @@ tuned_module_enable( mca_coll_base_module_t *module,
         data->mcct_num_reqs = 0;
     }
 
+    for (i = 0; i < COLLCOUNT; i++) {
+        data->autotune[i] = NULL;
+    }
+
     if (ompi_coll_tuned_use_dynamic_rules) {
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:module_init MCW & Dynamic"));
         /**
@@ -247,21 +259,23 @@ tuned_module_enable( mca_coll_base_module_t *module,
         COLL_TUNED_EXECUTE_IF_DYNAMIC(data, BCAST,
                                       tuned_module->super.coll_bcast      = ompi_coll_tuned_bcast_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(data, EXSCAN,
-                                      tuned_module->super.coll_exscan     = NULL);
+                                      tuned_module->super.coll_exscan     = ompi_coll_tuned_exscan_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(data, GATHER,
                                       tuned_module->super.coll_gather     = ompi_coll_tuned_gather_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(data, GATHERV,
-                                      tuned_module->super.coll_gatherv    = NULL);
+                                      tuned_module->super.coll_gatherv    = ompi_coll_tuned_gatherv_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(data, REDUCE,
                                       tuned_module->super.coll_reduce     = ompi_coll_tuned_reduce_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(data, REDUCESCATTER,
                                       tuned_module->super.coll_reduce_scatter = ompi_coll_tuned_reduce_scatter_intra_dec_dynamic);
+        COLL_TUNED_EXECUTE_IF_DYNAMIC(data, REDUCESCATTERBLOCK,
+                                      tuned_module->super.coll_reduce_scatter_block = ompi_coll_tuned_reduce_scatter_block_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(data, SCAN,
-                                      tuned_module->super.coll_scan       = NULL);
+                                      tuned_module->super.coll_scan       = ompi_coll_tuned_scan_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(data, SCATTER,
                                       tuned_module->super.coll_scatter    = ompi_coll_tuned_scatter_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(data, SCATTERV,
-                                      tuned_module->super.coll_scatterv   = NULL);
+                                      tuned_module->super.coll_scatterv   = ompi_coll_tuned_scatterv_intra_dec_dynamic);
 
         if( false == ompi_coll_tuned_use_dynamic_rules ) {
             /* no real need for dynamic decisions */
@@ -278,15 +292,29 @@ tuned_module_enable( mca_coll_base_module_t *module,
     data->cached_bmtree = NULL;
     /* binomial tree */
     data->cached_in_order_bmtree = NULL;
+    /* k-nomial trees */
+    data->cached_kmtree = NULL;
+    data->cached_in_order_kmtree = NULL;
     /* chains (fanout followed by pipelines) */
     data->cached_chain = NULL;
     /* standard pipeline */
     data->cached_pipeline = NULL;
     /* in-order binary tree */
     data->cached_in_order_bintree = NULL;
+    /* nodes, found by the first hierarchical scan */
+    data->cached_node_count = 0;
+    data->cached_node_leaders = NULL;
+    data->cached_node_peers = NULL;
+    data->cached_node_last = NULL;
+    /* scratch space, allocated by the first algorithm needing it */
+    data->mcct_scratch = NULL;
+    data->mcct_scratch_size = 0;
+    data->mcct_scratch_registered = false;
+    data->mcct_scratch_busy = false;
 
     /* All done */
     tuned_module->tuned_data = data;
+    ompi_coll_tuned_pvar_install(tuned_module);
 
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:module_init Tuned is in use"));
     return OMPI_SUCCESS;
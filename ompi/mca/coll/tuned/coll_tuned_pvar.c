@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Number of calls and time spent in each collective, exported as MPI_T
+ * performance variables.  The decision functions selected for a
+ * communicator are moved behind wrappers that count and time the call,
+ * so the decision functions and the algorithms are left untouched.
+ * Collectives used internally by another collective of this component
+ * go through the communicator, and are counted as well.
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+
+#include "mpi.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/runtime/ompi_pvar_counters.h"
+#include "coll_tuned.h"
+
+#if OMPI_ENABLE_PVAR_COUNTERS
+
+static ompi_pvar_counter_t ompi_coll_tuned_pvar_calls[COLLCOUNT];
+static ompi_pvar_counter_t ompi_coll_tuned_pvar_time[COLLCOUNT];
+
+#define COLL_TUNED_PVAR_CALL(TYPE, NAME, ...)                             \
+    do {                                                                  \
+        mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module; \
+        int rc;                                                           \
+        OMPI_PVAR_TIMER_DECLARE(start);                                   \
+                                                                          \
+        OMPI_PVAR_TIMER_START(start);                                     \
+        rc = tuned_module->pvar_##NAME(__VA_ARGS__);                      \
+        OMPI_PVAR_TIMER_STOP(start, ompi_coll_tuned_pvar_time[TYPE]);     \
+        OMPI_PVAR_COUNTER_ADD(ompi_coll_tuned_pvar_calls[TYPE], 1);       \
+        return rc;                                                        \
+    } while (0)
+
+static int ompi_coll_tuned_allgather_pvar(ALLGATHER_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(ALLGATHER, allgather, sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                         comm, module);
+}
+
+static int ompi_coll_tuned_allgatherv_pvar(ALLGATHERV_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(ALLGATHERV, allgatherv, sbuf, scount, sdtype, rbuf, rcounts, disps,
+                         rdtype, comm, module);
+}
+
+static int ompi_coll_tuned_allreduce_pvar(ALLREDUCE_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(ALLREDUCE, allreduce, sbuf, rbuf, count, dtype, op, comm, module);
+}
+
+static int ompi_coll_tuned_alltoall_pvar(ALLTOALL_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(ALLTOALL, alltoall, sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                         comm, module);
+}
+
+static int ompi_coll_tuned_alltoallv_pvar(ALLTOALLV_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(ALLTOALLV, alltoallv, sbuf, scounts, sdisps, sdtype, rbuf, rcounts,
+                         rdisps, rdtype, comm, module);
+}
+
+static int ompi_coll_tuned_barrier_pvar(BARRIER_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(BARRIER, barrier, comm, module);
+}
+
+static int ompi_coll_tuned_bcast_pvar(BCAST_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(BCAST, bcast, buff, count, datatype, root, comm, module);
+}
+
+static int ompi_coll_tuned_exscan_pvar(EXSCAN_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(EXSCAN, exscan, sbuf, rbuf, count, dtype, op, comm, module);
+}
+
+static int ompi_coll_tuned_gather_pvar(GATHER_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(GATHER, gather, sbuf, scount, sdtype, rbuf, rcount, rdtype, root,
+                         comm, module);
+}
+
+static int ompi_coll_tuned_gatherv_pvar(GATHERV_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(GATHERV, gatherv, sbuf, scount, sdtype, rbuf, rcounts, disps, rdtype,
+                         root, comm, module);
+}
+
+static int ompi_coll_tuned_reduce_pvar(REDUCE_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(REDUCE, reduce, sbuf, rbuf, count, dtype, op, root, comm, module);
+}
+
+static int ompi_coll_tuned_reduce_scatter_pvar(REDUCESCATTER_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(REDUCESCATTER, reduce_scatter, sbuf, rbuf, rcounts, dtype, op,
+                         comm, module);
+}
+
+static int ompi_coll_tuned_reduce_scatter_block_pvar(REDUCESCATTERBLOCK_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(REDUCESCATTERBLOCK, reduce_scatter_block, sbuf, rbuf, rcount, dtype, op,
+                         comm, module);
+}
+
+static int ompi_coll_tuned_scan_pvar(SCAN_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(SCAN, scan, sbuf, rbuf, count, dtype, op, comm, module);
+}
+
+static int ompi_coll_tuned_scatter_pvar(SCATTER_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(SCATTER, scatter, sbuf, scount, sdtype, rbuf, rcount, rdtype, root,
+                         comm, module);
+}
+
+static int ompi_coll_tuned_scatterv_pvar(SCATTERV_ARGS)
+{
+    COLL_TUNED_PVAR_CALL(SCATTERV, scatterv, sbuf, scounts, disps, sdtype, rbuf, rcount, rdtype,
+                         root, comm, module);
+}
+
+#define COLL_TUNED_PVAR_WRAP(MODULE, NAME)                                \
+    do {                                                                  \
+        (MODULE)->pvar_##NAME = (MODULE)->super.coll_##NAME;              \
+        if (NULL != (MODULE)->pvar_##NAME) {                              \
+            (MODULE)->super.coll_##NAME = ompi_coll_tuned_##NAME##_pvar;  \
+        }                                                                 \
+    } while (0)
+
+void ompi_coll_tuned_pvar_install(mca_coll_tuned_module_t *tuned_module)
+{
+    COLL_TUNED_PVAR_WRAP(tuned_module, allgather);
+    COLL_TUNED_PVAR_WRAP(tuned_module, allgatherv);
+    COLL_TUNED_PVAR_WRAP(tuned_module, allreduce);
+    COLL_TUNED_PVAR_WRAP(tuned_module, alltoall);
+    COLL_TUNED_PVAR_WRAP(tuned_module, alltoallv);
+    COLL_TUNED_PVAR_WRAP(tuned_module, barrier);
+    COLL_TUNED_PVAR_WRAP(tuned_module, bcast);
+    COLL_TUNED_PVAR_WRAP(tuned_module, exscan);
+    COLL_TUNED_PVAR_WRAP(tuned_module, gather);
+    COLL_TUNED_PVAR_WRAP(tuned_module, gatherv);
+    COLL_TUNED_PVAR_WRAP(tuned_module, reduce);
+    COLL_TUNED_PVAR_WRAP(tuned_module, reduce_scatter);
+    COLL_TUNED_PVAR_WRAP(tuned_module, reduce_scatter_block);
+    COLL_TUNED_PVAR_WRAP(tuned_module, scan);
+    COLL_TUNED_PVAR_WRAP(tuned_module, scatter);
+    COLL_TUNED_PVAR_WRAP(tuned_module, scatterv);
+}
+
+int ompi_coll_tuned_pvar_register(void)
+{
+    static const struct {
+        int type;
+        const char *name;
+    } colls[] = {
+        {ALLGATHER, "allgather"}, {ALLGATHERV, "allgatherv"}, {ALLREDUCE, "allreduce"},
+        {ALLTOALL, "alltoall"}, {ALLTOALLV, "alltoallv"}, {BARRIER, "barrier"},
+        {BCAST, "bcast"}, {EXSCAN, "exscan"}, {GATHER, "gather"}, {GATHERV, "gatherv"},
+        {REDUCE, "reduce"}, {REDUCESCATTER, "reduce_scatter"},
+        {REDUCESCATTERBLOCK, "reduce_scatter_block"}, {SCAN, "scan"},
+        {SCATTER, "scatter"}, {SCATTERV, "scatterv"}
+    };
+    char name[64], desc[128];
+    size_t i;
+
+    for (i = 0 ; i < sizeof(colls) / sizeof(colls[0]) ; ++i) {
+        snprintf(name, sizeof(name), "%s_calls", colls[i].name);
+        snprintf(desc, sizeof(desc), "Number of %s operations done by this component",
+                 colls[i].name);
+        (void) ompi_pvar_counter_register("coll", "tuned", name, desc,
+                                          &ompi_coll_tuned_pvar_calls[colls[i].type], 1);
+
+        snprintf(name, sizeof(name), "%s_time", colls[i].name);
+        snprintf(desc, sizeof(desc), "Time spent in the %s operations done by this component",
+                 colls[i].name);
+        (void) ompi_pvar_timer_register("coll", "tuned", name, desc,
+                                        &ompi_coll_tuned_pvar_time[colls[i].type], 1);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+#else
+
+void ompi_coll_tuned_pvar_install(mca_coll_tuned_module_t *tuned_module)
+{
+}
+
+int ompi_coll_tuned_pvar_register(void)
+{
+    return OMPI_SUCCESS;
+}
+
+#endif  /* OMPI_ENABLE_PVAR_COUNTERS */
@@ -33,7 +33,7 @@
 #include "coll_tuned_topo.h"
 
 /* reduce algorithm variables */
-static int coll_tuned_reduce_algorithm_count = 6;
+static int coll_tuned_reduce_algorithm_count = 7;
 static int coll_tuned_reduce_forced_algorithm = 0;
 static int coll_tuned_reduce_segment_size = 0;
 static int coll_tuned_reduce_max_requests;
@@ -49,6 +49,7 @@ static mca_base_var_enum_value_t reduce_algorithms[] = {
     {4, "binary"},
     {5, "binomial"},
     {6, "in-order_binary"},
+    {7, "knomial"},
     {0, NULL}
 };
 
@@ -70,7 +71,8 @@ int ompi_coll_tuned_reduce_generic( void* sendbuf, void* recvbuf, int original_c
                                     ompi_coll_tree_t* tree, int count_by_segment,
                                     int max_outstanding_reqs )
 {
-    char *inbuf[2] = {NULL, NULL}, *inbuf_free[2] = {NULL, NULL};
+    mca_coll_tuned_comm_t *data = ((mca_coll_tuned_module_t*) module)->tuned_data;
+    char *inbuf[2] = {NULL, NULL}, *inbuf_free = NULL;
     char *accumbuf = NULL, *accumbuf_free = NULL;
     char *local_op_buffer = NULL, *sendtmpbuf = NULL;
     ptrdiff_t extent, lower_bound, segment_increment;
@@ -126,21 +128,17 @@ int ompi_coll_tuned_reduce_generic( void* sendbuf, void* recvbuf, int original_c
                                                 (char*)accumbuf,
                                                 (char*)sendtmpbuf);
         }
-        /* Allocate two buffers for incoming segments */
+        /* Get the buffers for incoming segments from the scratch space:
+           two if there is chance to overlap communication */
         real_segment_size = true_extent + (ptrdiff_t)(count_by_segment - 1) * extent;
-        inbuf_free[0] = (char*) malloc(real_segment_size);
-        if( inbuf_free[0] == NULL ) { 
+        inbi = ((num_segments > 1) || (tree->tree_nextsize > 1)) ? 2 : 1;
+        inbuf_free = (char*) ompi_coll_tuned_scratch_get(data, inbi * real_segment_size);
+        if( inbuf_free == NULL ) { 
             line = __LINE__; ret = -1; goto error_hndl; 
         }
-        inbuf[0] = inbuf_free[0] - lower_bound;
-        /* if there is chance to overlap communication -
-           allocate second buffer */
-        if( (num_segments > 1) || (tree->tree_nextsize > 1) ) {
-            inbuf_free[1] = (char*) malloc(real_segment_size);
-            if( inbuf_free[1] == NULL ) { 
-                line = __LINE__; ret = -1; goto error_hndl;
-            }
-            inbuf[1] = inbuf_free[1] - lower_bound;
+        inbuf[0] = inbuf_free - lower_bound;
+        if( 2 == inbi ) {
+            inbuf[1] = inbuf[0] + real_segment_size;
         } 
 
         /* reset input buffer index and receive count */
@@ -247,8 +245,7 @@ int ompi_coll_tuned_reduce_generic( void* sendbuf, void* recvbuf, int original_c
         } /* end of for each segment */
 
         /* clean up */
-        if( inbuf_free[0] != NULL) free(inbuf_free[0]);
-        if( inbuf_free[1] != NULL) free(inbuf_free[1]);
+        ompi_coll_tuned_scratch_put(data, inbuf_free);
         if( accumbuf_free != NULL ) free(accumbuf_free);
     }
 
@@ -354,8 +351,7 @@ int ompi_coll_tuned_reduce_generic( void* sendbuf, void* recvbuf, int original_c
     OPAL_OUTPUT (( ompi_coll_tuned_stream, 
                    "ERROR_HNDL: node %d file %s line %d error %d\n", 
                    rank, __FILE__, line, ret ));
-    if( inbuf_free[0] != NULL ) free(inbuf_free[0]);
-    if( inbuf_free[1] != NULL ) free(inbuf_free[1]);
+    ompi_coll_tuned_scratch_put(data, inbuf_free);
     if( accumbuf_free != NULL ) free(accumbuf);
     return ret;
 }
@@ -490,6 +486,56 @@ int ompi_coll_tuned_reduce_intra_binomial( void *sendbuf, void *recvbuf,
                                            segcount, max_outstanding_reqs );
 }
 
+/*
+ * reduce_intra_knomial
+ *
+ * Function:      reduce along a k-nomial tree of the given radix, the
+ *                childs with the largest subtrees or on another node
+ *                first.  The tree does not keep the ranks in order, so
+ *                non-commutative operations use the in-order binary tree.
+ * Accepts:       same as MPI_Reduce(), segment size and radix
+ * Returns:       MPI_SUCCESS or error code
+ */
+int ompi_coll_tuned_reduce_intra_knomial( void *sendbuf, void *recvbuf,
+                                          int count, ompi_datatype_t* datatype,
+                                          ompi_op_t* op, int root,
+                                          ompi_communicator_t* comm, 
+                                          mca_coll_base_module_t *module,
+                                          uint32_t segsize, int radix,
+                                          int max_outstanding_reqs  )
+{
+    int segcount = count;
+    size_t typelng;
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_intra_knomial rank %d ss %5d radix %d",
+                 ompi_comm_rank(comm), segsize, radix));
+
+    if (!ompi_op_is_commute(op)) {
+        return ompi_coll_tuned_reduce_intra_in_order_binary( sendbuf, recvbuf, count, datatype,
+                                                             op, root, comm, module,
+                                                             segsize, max_outstanding_reqs );
+    }
+
+    radix = COLL_TUNED_KNOMIAL_RADIX(radix);
+    COLL_TUNED_UPDATE_KMTREE( comm, tuned_module, root, radix );
+    if (NULL == data->cached_kmtree) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    /**
+     * Determine number of segments and number of elements
+     * sent per operation
+     */
+    ompi_datatype_type_size( datatype, &typelng );
+    COLL_TUNED_COMPUTED_SEGCOUNT( segsize, typelng, segcount );
+
+    return ompi_coll_tuned_reduce_generic( sendbuf, recvbuf, count, datatype, 
+                                           op, root, comm, module,
+                                           data->cached_kmtree, segcount, max_outstanding_reqs );
+}
+
 /*
  * reduce_intra_in_order_binary 
  * 
@@ -756,7 +802,7 @@ int ompi_coll_tuned_reduce_intra_check_forced_init (coll_tuned_force_algorithm_m
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "reduce_algorithm",
-                                        "Which reduce algorithm is used. Can be locked down to choice of: 0 ignore, 1 linear, 2 chain, 3 pipeline, 4 binary, 5 binomial, 6 in-order binary",
+                                        "Which reduce algorithm is used. Can be locked down to choice of: 0 ignore, 1 linear, 2 chain, 3 pipeline, 4 binary, 5 binomial, 6 in-order binary, 7 knomial (radix from reduce_algorithm_tree_fanout)",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_READONLY,
@@ -831,6 +877,7 @@ int ompi_coll_tuned_reduce_intra_do_forced(void *sbuf, void* rbuf, int count,
 
     const int segsize      = data->user_forced[REDUCE].segsize;
     const int chain_fanout = data->user_forced[REDUCE].chain_fanout;
+    const int tree_fanout  = data->user_forced[REDUCE].tree_fanout;
     const int max_requests = data->user_forced[REDUCE].max_requests;
 
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_intra_do_forced selected algorithm %d", 
@@ -857,6 +904,9 @@ int ompi_coll_tuned_reduce_intra_do_forced(void *sbuf, void* rbuf, int count,
     case (6):  return ompi_coll_tuned_reduce_intra_in_order_binary(sbuf, rbuf, count, dtype,
                                                                    op, root, comm, module,
                                                                    segsize, max_requests);
+    case (7):  return ompi_coll_tuned_reduce_intra_knomial (sbuf, rbuf, count, dtype,
+                                                            op, root, comm, module,
+                                                            segsize, tree_fanout, max_requests);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_intra_do_forced attempt to select algorithm %d when only 0-%d is valid?",
                      data->user_forced[REDUCE].algorithm, ompi_coll_tuned_forced_max_algorithms[REDUCE]));
@@ -896,6 +946,9 @@ int ompi_coll_tuned_reduce_intra_do_this(void *sbuf, void* rbuf, int count,
     case (6):  return ompi_coll_tuned_reduce_intra_in_order_binary(sbuf, rbuf, count, dtype,
                                                                    op, root, comm, module,
                                                                    segsize, max_requests);
+    case (7):  return ompi_coll_tuned_reduce_intra_knomial (sbuf, rbuf, count, dtype,
+                                                            op, root, comm, module,
+                                                            segsize, faninout, max_requests);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
                      algorithm, ompi_coll_tuned_forced_max_algorithms[REDUCE]));
@@ -0,0 +1,501 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "opal/util/bit_ops.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/op/op.h"
+#include "coll_tuned.h"
+#include "coll_tuned_topo.h"
+#include "coll_tuned_util.h"
+
+/* reduce_scatter_block algorithm variables */
+static int coll_tuned_reduce_scatter_block_algorithm_count = 4;
+static int coll_tuned_reduce_scatter_block_forced_algorithm = 0;
+static int coll_tuned_reduce_scatter_block_segment_size = 0;
+static int coll_tuned_reduce_scatter_block_tree_fanout;
+static int coll_tuned_reduce_scatter_block_chain_fanout;
+
+/* valid values for coll_tuned_reduce_scatter_block_forced_algorithm */
+static mca_base_var_enum_value_t reduce_scatter_block_algorithms[] = {
+    {0, "ignore"},
+    {1, "basic_linear"},
+    {2, "recursive_halving"},
+    {3, "ring"},
+    {4, "pairwise"},
+    {0, NULL}
+};
+
+/*******************************************************************************
+ * ompi_coll_tuned_reduce_scatter_block_intra_basic_linear
+ *
+ * A reduce of the whole buffer to rank 0, followed by a scatter. The only
+ * algorithm which keeps the order of a non commutative operation.
+ */
+int ompi_coll_tuned_reduce_scatter_block_intra_basic_linear(void *sbuf, void *rbuf,
+                                                            int rcount,
+                                                            struct ompi_datatype_t *dtype,
+                                                            struct ompi_op_t *op,
+                                                            struct ompi_communicator_t *comm,
+                                                            mca_coll_base_module_t *module)
+{
+    int err, rank, size, count;
+    const int root = 0;
+    char *tmprbuf = NULL, *tmprbuf_free = NULL;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    count = rcount * size;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_scatter_block_intra_basic_linear, rank %d", rank));
+
+    if (0 == count) {
+        return MPI_SUCCESS;
+    }
+
+    if (MPI_IN_PLACE == sbuf) {
+        /* rbuf holds the whole input, and the block of the root comes first */
+        if (root == rank) {
+            err = comm->c_coll.coll_reduce(MPI_IN_PLACE, rbuf, count, dtype, op, root,
+                                           comm, comm->c_coll.coll_reduce_module);
+            if (MPI_SUCCESS != err) return err;
+            return comm->c_coll.coll_scatter(rbuf, rcount, dtype, MPI_IN_PLACE, rcount, dtype,
+                                             root, comm, comm->c_coll.coll_scatter_module);
+        }
+        err = comm->c_coll.coll_reduce(rbuf, NULL, count, dtype, op, root,
+                                       comm, comm->c_coll.coll_reduce_module);
+    } else {
+        if (root == rank) {
+            ptrdiff_t lb, extent, tlb, textent;
+
+            ompi_datatype_get_extent(dtype, &lb, &extent);
+            ompi_datatype_get_true_extent(dtype, &tlb, &textent);
+
+            tmprbuf_free = (char*) malloc(textent + (ptrdiff_t)(count - 1) * extent);
+            if (NULL == tmprbuf_free) return OMPI_ERR_OUT_OF_RESOURCE;
+            tmprbuf = tmprbuf_free - tlb;
+        }
+        err = comm->c_coll.coll_reduce(sbuf, tmprbuf, count, dtype, op, root,
+                                       comm, comm->c_coll.coll_reduce_module);
+    }
+    if (MPI_SUCCESS == err) {
+        err = comm->c_coll.coll_scatter(tmprbuf, rcount, dtype, rbuf, rcount, dtype,
+                                        root, comm, comm->c_coll.coll_scatter_module);
+    }
+    if (NULL != tmprbuf_free) free(tmprbuf_free);
+    return err;
+}
+
+/*
+ *  reduce_scatter_block_intra_recursivehalving
+ *
+ *  Function:   - recursive halving, as the reduce_scatter one, with blocks
+ *                of a single size
+ *  Accepts:    - same as MPI_Reduce_scatter_block()
+ *  Returns:    - MPI_SUCCESS or error code
+ *  Limitation: - Works only for commutative operations.
+ *
+ *  When the size is not a power of two, the first 2 * remain processes
+ *  fold pairwise: the even ones hand their data to the next odd one and
+ *  sit out the halving, then get their block from it at the end. The odd
+ *  process of a pair then stands for two consecutive blocks, so that the
+ *  data of any range of virtual processes is still contiguous.
+ */
+#define RSB_VBLOCK(v, remain) (((v) < (remain)) ? 2 * (v) : (v) + (remain))
+
+int
+ompi_coll_tuned_reduce_scatter_block_intra_recursivehalving(void *sbuf, void *rbuf,
+                                                            int rcount,
+                                                            struct ompi_datatype_t *dtype,
+                                                            struct ompi_op_t *op,
+                                                            struct ompi_communicator_t *comm,
+                                                            mca_coll_base_module_t *module)
+{
+    int rank, size, count, err = OMPI_SUCCESS;
+    int tmp_size, remain, tmp_rank;
+    ptrdiff_t true_lb, true_extent, lb, extent, buf_size, blen;
+    char *recv_buf = NULL, *recv_buf_free = NULL;
+    char *result_buf = NULL, *result_buf_free = NULL;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    count = rcount * size;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_scatter_block_intra_recursivehalving, rank %d", rank));
+
+    if (0 == count) {
+        return OMPI_SUCCESS;
+    }
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    buf_size = true_extent + (ptrdiff_t)(count - 1) * extent;
+    blen = (ptrdiff_t)rcount * extent;
+
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+    }
+
+    recv_buf_free = (char*) malloc(buf_size);
+    result_buf_free = (char*) malloc(buf_size);
+    if (NULL == recv_buf_free || NULL == result_buf_free) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+    recv_buf = recv_buf_free - true_lb;
+    result_buf = result_buf_free - true_lb;
+
+    err = ompi_datatype_sndrcv(sbuf, count, dtype, result_buf, count, dtype);
+    if (OMPI_SUCCESS != err) goto cleanup;
+
+    /* largest power of two not above the size */
+    tmp_size = opal_next_poweroftwo(size);
+    tmp_size >>= 1;
+    remain = size - tmp_size;
+
+    if (rank < 2 * remain) {
+        if ((rank & 1) == 0) {
+            err = MCA_PML_CALL(send(result_buf, count, dtype, rank + 1,
+                                    MCA_COLL_BASE_TAG_REDUCE_SCATTER,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+            if (OMPI_SUCCESS != err) goto cleanup;
+            tmp_rank = -1;
+        } else {
+            err = MCA_PML_CALL(recv(recv_buf, count, dtype, rank - 1,
+                                    MCA_COLL_BASE_TAG_REDUCE_SCATTER,
+                                    comm, MPI_STATUS_IGNORE));
+            if (OMPI_SUCCESS != err) goto cleanup;
+            ompi_op_reduce(op, recv_buf, result_buf, count, dtype);
+            tmp_rank = rank / 2;
+        }
+    } else {
+        tmp_rank = rank - remain;
+    }
+
+    if (tmp_rank >= 0) {
+        int mask, send_index, recv_index, last_index;
+
+        /* every step keeps half of the virtual blocks still in play */
+        mask = tmp_size >> 1;
+        send_index = recv_index = 0;
+        last_index = tmp_size;
+        while (mask > 0) {
+            int tmp_peer, peer, send_first, send_last, recv_first, recv_last;
+
+            tmp_peer = tmp_rank ^ mask;
+            peer = (tmp_peer < remain) ? tmp_peer * 2 + 1 : tmp_peer + remain;
+
+            if (tmp_rank < tmp_peer) {
+                send_index = recv_index + mask;
+                send_first = send_index; send_last = last_index;
+                recv_first = recv_index; recv_last = send_index;
+            } else {
+                recv_index = send_index + mask;
+                send_first = send_index; send_last = recv_index;
+                recv_first = recv_index; recv_last = last_index;
+            }
+            send_first = RSB_VBLOCK(send_first, remain);
+            send_last = RSB_VBLOCK(send_last, remain);
+            recv_first = RSB_VBLOCK(recv_first, remain);
+            recv_last = RSB_VBLOCK(recv_last, remain);
+
+            err = ompi_coll_tuned_sendrecv(result_buf + (ptrdiff_t)send_first * blen,
+                                           (size_t)(send_last - send_first) * rcount, dtype,
+                                           peer, MCA_COLL_BASE_TAG_REDUCE_SCATTER,
+                                           recv_buf + (ptrdiff_t)recv_first * blen,
+                                           (size_t)(recv_last - recv_first) * rcount, dtype,
+                                           peer, MCA_COLL_BASE_TAG_REDUCE_SCATTER,
+                                           comm, MPI_STATUS_IGNORE, rank);
+            if (OMPI_SUCCESS != err) goto cleanup;
+
+            ompi_op_reduce(op, recv_buf + (ptrdiff_t)recv_first * blen,
+                           result_buf + (ptrdiff_t)recv_first * blen,
+                           (recv_last - recv_first) * rcount, dtype);
+
+            send_index = recv_index;
+            last_index = recv_index + mask;
+            mask >>= 1;
+        }
+
+        err = ompi_datatype_sndrcv(result_buf + (ptrdiff_t)rank * blen, rcount, dtype,
+                                   rbuf, rcount, dtype);
+        if (OMPI_SUCCESS != err) goto cleanup;
+    }
+
+    /* the folded processes get their block from their neighbor */
+    if (rank < 2 * remain) {
+        if ((rank & 1) == 0) {
+            err = MCA_PML_CALL(recv(rbuf, rcount, dtype, rank + 1,
+                                    MCA_COLL_BASE_TAG_REDUCE_SCATTER,
+                                    comm, MPI_STATUS_IGNORE));
+        } else {
+            err = MCA_PML_CALL(send(result_buf + (ptrdiff_t)(rank - 1) * blen,
+                                    rcount, dtype, rank - 1,
+                                    MCA_COLL_BASE_TAG_REDUCE_SCATTER,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+        }
+    }
+
+ cleanup:
+    if (NULL != recv_buf_free) free(recv_buf_free);
+    if (NULL != result_buf_free) free(result_buf_free);
+    return err;
+}
+
+#undef RSB_VBLOCK
+
+/*
+ *   ompi_coll_tuned_reduce_scatter_block_intra_ring
+ *
+ *   The reduce_scatter ring, with the same count for every block.
+ *   Limitation: - Works only for commutative operations.
+ */
+int
+ompi_coll_tuned_reduce_scatter_block_intra_ring(void *sbuf, void *rbuf, int rcount,
+                                                struct ompi_datatype_t *dtype,
+                                                struct ompi_op_t *op,
+                                                struct ompi_communicator_t *comm,
+                                                mca_coll_base_module_t *module)
+{
+    int i, err, size, *rcounts;
+
+    size = ompi_comm_size(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_scatter_block_intra_ring, rank %d",
+                 ompi_comm_rank(comm)));
+
+    rcounts = (int*) malloc(size * sizeof(int));
+    if (NULL == rcounts) return OMPI_ERR_OUT_OF_RESOURCE;
+    for (i = 0; i < size; i++) {
+        rcounts[i] = rcount;
+    }
+    err = ompi_coll_tuned_reduce_scatter_intra_ring(sbuf, rbuf, rcounts, dtype, op,
+                                                    comm, module);
+    free(rcounts);
+    return err;
+}
+
+/*
+ *   ompi_coll_tuned_reduce_scatter_block_intra_pairwise
+ *
+ *   Function:   - at step k every process sends its contribution to the
+ *                 block of rank + k and reduces the contribution of
+ *                 rank - k to its own block
+ *   Accepts:    - same as MPI_Reduce_scatter_block()
+ *   Returns:    - MPI_SUCCESS or error code
+ *   Limitation: - Works only for commutative operations.
+ *
+ *   Every block is reduced where it belongs, from data that crossed the
+ *   network once, and no step waits on the reduction of a previous one
+ *   elsewhere.  Needs a single block of extra buffering, two when in place.
+ */
+int
+ompi_coll_tuned_reduce_scatter_block_intra_pairwise(void *sbuf, void *rbuf, int rcount,
+                                                    struct ompi_datatype_t *dtype,
+                                                    struct ompi_op_t *op,
+                                                    struct ompi_communicator_t *comm,
+                                                    mca_coll_base_module_t *module)
+{
+    int rank, size, k, err = OMPI_SUCCESS;
+    ptrdiff_t true_lb, true_extent, lb, extent, blen;
+    char *inbuf_free = NULL, *inbuf, *accum_free = NULL, *accum;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_scatter_block_intra_pairwise, rank %d", rank));
+
+    if (0 == rcount) {
+        return OMPI_SUCCESS;
+    }
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    blen = (ptrdiff_t)rcount * extent;
+
+    inbuf_free = (char*) malloc(true_extent + (ptrdiff_t)(rcount - 1) * extent);
+    if (NULL == inbuf_free) return OMPI_ERR_OUT_OF_RESOURCE;
+    inbuf = inbuf_free - true_lb;
+
+    /* in place the input is read until the last step */
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+        accum_free = (char*) malloc(true_extent + (ptrdiff_t)(rcount - 1) * extent);
+        if (NULL == accum_free) {
+            err = OMPI_ERR_OUT_OF_RESOURCE;
+            goto cleanup;
+        }
+        accum = accum_free - true_lb;
+    } else {
+        accum = (char*) rbuf;
+    }
+
+    err = ompi_datatype_sndrcv((char*)sbuf + (ptrdiff_t)rank * blen, rcount, dtype,
+                               accum, rcount, dtype);
+    if (OMPI_SUCCESS != err) goto cleanup;
+
+    for (k = 1; k < size; k++) {
+        const int to = (rank + k) % size;
+        const int from = (rank + size - k) % size;
+
+        err = ompi_coll_tuned_sendrecv((char*)sbuf + (ptrdiff_t)to * blen, rcount, dtype,
+                                       to, MCA_COLL_BASE_TAG_REDUCE_SCATTER,
+                                       inbuf, rcount, dtype,
+                                       from, MCA_COLL_BASE_TAG_REDUCE_SCATTER,
+                                       comm, MPI_STATUS_IGNORE, rank);
+        if (OMPI_SUCCESS != err) goto cleanup;
+        ompi_op_reduce(op, inbuf, accum, rcount, dtype);
+    }
+
+    if (accum != (char*) rbuf) {
+        err = ompi_datatype_sndrcv(accum, rcount, dtype, rbuf, rcount, dtype);
+    }
+
+ cleanup:
+    if (NULL != inbuf_free) free(inbuf_free);
+    if (NULL != accum_free) free(accum_free);
+    return err;
+}
+
+
+/**
+ * The following are used by dynamic and forced rules
+ *
+ * publish details of each algorithm and if its forced/fixed/locked in
+ * as you add methods/algorithms you must update this and the query/map routines
+ *
+ * this routine is called by the component only
+ * this makes sure that the mca parameters are set to their initial values and
+ * perms module does not call this they call the forced_getvalues routine
+ * instead
+ */
+
+int ompi_coll_tuned_reduce_scatter_block_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices)
+{
+    mca_base_var_enum_t *new_enum;
+
+    ompi_coll_tuned_forced_max_algorithms[REDUCESCATTERBLOCK] = coll_tuned_reduce_scatter_block_algorithm_count;
+
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "reduce_scatter_block_algorithm_count",
+                                           "Number of reduce_scatter_block algorithms available",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_CONSTANT,
+                                           &coll_tuned_reduce_scatter_block_algorithm_count);
+
+    /* MPI_T: This variable should eventually be bound to a communicator */
+    coll_tuned_reduce_scatter_block_forced_algorithm = 0;
+    (void) mca_base_var_enum_create("coll_tuned_reduce_scatter_block_algorithms", reduce_scatter_block_algorithms, &new_enum);
+    mca_param_indices->algorithm_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "reduce_scatter_block_algorithm",
+                                        "Which reduce_scatter_block algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear (Reduce + Scatter), 2 recursive halving, 3 ring, 4 pairwise",
+                                        MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_reduce_scatter_block_forced_algorithm);
+    OBJ_RELEASE(new_enum);
+    if (mca_param_indices->algorithm_param_index < 0) {
+        return mca_param_indices->algorithm_param_index;
+    }
+
+    coll_tuned_reduce_scatter_block_segment_size = 0;
+    mca_param_indices->segsize_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "reduce_scatter_block_algorithm_segmentsize",
+                                        "Segment size in bytes used by default for reduce_scatter_block algorithms. Only has meaning if algorithm is forced and supports segmenting. 0 bytes means no segmentation.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_reduce_scatter_block_segment_size);
+
+    coll_tuned_reduce_scatter_block_tree_fanout = ompi_coll_tuned_init_tree_fanout; /* get system wide default */
+    mca_param_indices->tree_fanout_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "reduce_scatter_block_algorithm_tree_fanout",
+                                        "Fanout for n-tree used for reduce_scatter_block algorithms. Only has meaning if algorithm is forced and supports n-tree topo based operation.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_reduce_scatter_block_tree_fanout);
+
+    coll_tuned_reduce_scatter_block_chain_fanout = ompi_coll_tuned_init_chain_fanout; /* get system wide default */
+    mca_param_indices->chain_fanout_param_index =
+      mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                      "reduce_scatter_block_algorithm_chain_fanout",
+                                      "Fanout for chains used for reduce_scatter_block algorithms. Only has meaning if algorithm is forced and supports chain topo based operation.",
+                                      MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                      OPAL_INFO_LVL_5,
+                                      MCA_BASE_VAR_SCOPE_READONLY,
+                                      &coll_tuned_reduce_scatter_block_chain_fanout);
+
+    return (MPI_SUCCESS);
+}
+
+
+int ompi_coll_tuned_reduce_scatter_block_intra_do_forced(void *sbuf, void* rbuf,
+                                                         int rcount,
+                                                         struct ompi_datatype_t *dtype,
+                                                         struct ompi_op_t *op,
+                                                         struct ompi_communicator_t *comm,
+                                                         mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_scatter_block_intra_do_forced selected algorithm %d",
+                 data->user_forced[REDUCESCATTERBLOCK].algorithm));
+
+    return ompi_coll_tuned_reduce_scatter_block_intra_do_this(sbuf, rbuf, rcount, dtype, op,
+                                                              comm, module,
+                                                              data->user_forced[REDUCESCATTERBLOCK].algorithm,
+                                                              0, 0);
+}
+
+
+int ompi_coll_tuned_reduce_scatter_block_intra_do_this(void *sbuf, void* rbuf,
+                                                       int rcount,
+                                                       struct ompi_datatype_t *dtype,
+                                                       struct ompi_op_t *op,
+                                                       struct ompi_communicator_t *comm,
+                                                       mca_coll_base_module_t *module,
+                                                       int algorithm, int faninout, int segsize)
+{
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_scatter_block_intra_do_this selected algorithm %d topo faninout %d segsize %d",
+                 algorithm, faninout, segsize));
+
+    switch (algorithm) {
+    case (0): return ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed(sbuf, rbuf, rcount,
+                                                                          dtype, op, comm, module);
+    case (1): return ompi_coll_tuned_reduce_scatter_block_intra_basic_linear(sbuf, rbuf, rcount,
+                                                                             dtype, op, comm, module);
+    case (2): return ompi_coll_tuned_reduce_scatter_block_intra_recursivehalving(sbuf, rbuf, rcount,
+                                                                                 dtype, op, comm, module);
+    case (3): return ompi_coll_tuned_reduce_scatter_block_intra_ring(sbuf, rbuf, rcount,
+                                                                     dtype, op, comm, module);
+    case (4): return ompi_coll_tuned_reduce_scatter_block_intra_pairwise(sbuf, rbuf, rcount,
+                                                                         dtype, op, comm, module);
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:reduce_scatter_block_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[REDUCESCATTERBLOCK]));
+        return (MPI_ERR_ARG);
+    } /* switch */
+}
@@ -0,0 +1,569 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/op/op.h"
+#include "coll_tuned.h"
+#include "coll_tuned_util.h"
+
+/* scan algorithm variables */
+static int coll_tuned_scan_algorithm_count = 4;
+static int coll_tuned_scan_forced_algorithm = 0;
+static int coll_tuned_scan_segment_size = 0;
+static int coll_tuned_scan_tree_fanout;
+static int coll_tuned_scan_chain_fanout;
+
+/* valid values for coll_tuned_scan_forced_algorithm */
+static mca_base_var_enum_value_t scan_algorithms[] = {
+    {0, "ignore"},
+    {1, "basic_linear"},
+    {2, "recursive_doubling"},
+    {3, "binomial"},
+    {4, "hierarchical"},
+    {0, NULL}
+};
+
+/*
+ *  prefix_recursivedoubling
+ *
+ *  Function:   - recursive doubling prefix reduction over a group of
+ *                processes of comm: ranks[0..n-1], or first..first+n-1
+ *                when ranks is NULL. vrank is the position of the caller.
+ *  Accepts:    - sbuf may be rbuf (the input is copied first)
+ *  Returns:    - MPI_SUCCESS or error code. rbuf holds the reduction of
+ *                positions 0..vrank, or 0..vrank-1 when exclusive (then
+ *                rbuf is not touched at position 0).
+ *
+ *  At step k the processes exchange the reduction of their aligned block
+ *  of 2^k positions with the partner of the other half of the block. The
+ *  lower half is always the left operand, so the order of a non
+ *  commutative operation is kept.
+ */
+int ompi_coll_tuned_prefix_recursivedoubling(void *sbuf, void *rbuf, int count,
+                                             struct ompi_datatype_t *dtype,
+                                             struct ompi_op_t *op, int exclusive,
+                                             int *ranks, int first, int n, int vrank,
+                                             int tag,
+                                             struct ompi_communicator_t *comm)
+{
+    int err = MPI_SUCCESS, line = 0, rank, mask, vpeer, peer, have_prefix;
+    ptrdiff_t lb, extent, true_lb, true_extent, buf_size;
+    char *tmpbuf_free = NULL, *partial, *tmpbuf, *swap;
+
+    rank = ompi_comm_rank(comm);
+
+    if( !exclusive && (sbuf != rbuf) ) {
+        err = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    if( 1 == n ) return MPI_SUCCESS;
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    buf_size = true_extent + (ptrdiff_t)(count - 1) * extent;
+
+    tmpbuf_free = (char*)malloc(2 * buf_size);
+    if (NULL == tmpbuf_free) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+    partial = tmpbuf_free - true_lb;
+    tmpbuf = partial + buf_size;
+
+    /* the reduction of my block, starting with my own input */
+    err = ompi_datatype_copy_content_same_ddt(dtype, count, partial, (char*)sbuf);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    have_prefix = !exclusive;
+    for (mask = 1; mask < n; mask <<= 1) {
+        vpeer = vrank ^ mask;
+        if (vpeer >= n) continue;
+        peer = (NULL != ranks) ? ranks[vpeer] : first + vpeer;
+
+        err = ompi_coll_tuned_sendrecv(partial, count, dtype, peer, tag,
+                                       tmpbuf, count, dtype, peer, tag,
+                                       comm, MPI_STATUS_IGNORE, rank);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+        if (vpeer < vrank) {
+            /* the block of the peer comes before everything I have */
+            ompi_op_reduce(op, tmpbuf, partial, count, dtype);
+            if (have_prefix) {
+                ompi_op_reduce(op, tmpbuf, rbuf, count, dtype);
+            } else {
+                err = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, tmpbuf);
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+                have_prefix = 1;
+            }
+        } else if (ompi_op_is_commute(op)) {
+            ompi_op_reduce(op, tmpbuf, partial, count, dtype);
+        } else {
+            ompi_op_reduce(op, partial, tmpbuf, count, dtype);
+            swap = partial; partial = tmpbuf; tmpbuf = swap;
+        }
+    }
+
+    free(tmpbuf_free);
+    return MPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    if (NULL != tmpbuf_free) free(tmpbuf_free);
+    return err;
+}
+
+/*
+ *  prefix_binomial
+ *
+ *  Function:   - work efficient (Brent-Kung) inclusive prefix reduction of
+ *                buf over all the processes of comm, in place
+ *  Returns:    - MPI_SUCCESS or error code
+ *
+ *  The up sweep reduces the blocks of 2, 4, 8... processes along a
+ *  binomial tree onto the last process of each block, after which the
+ *  process r holds the reduction of the lowbit(r + 1) processes ending
+ *  with it. The down sweep then goes back from the largest blocks: the
+ *  last process of a block hands its complete prefix to the process
+ *  half a block further, which puts it in front of its partial. Every
+ *  process sends and receives at most twice per sweep, 2 * log(P) steps.
+ */
+int ompi_coll_tuned_prefix_binomial(void *buf, int count, struct ompi_datatype_t *dtype,
+                                    struct ompi_op_t *op, int tag,
+                                    struct ompi_communicator_t *comm)
+{
+    int err = MPI_SUCCESS, line = 0, rank, size, d;
+    ptrdiff_t lb, extent, true_lb, true_extent;
+    char *tmpbuf_free = NULL, *tmpbuf;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+    if (1 == size) return MPI_SUCCESS;
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    tmpbuf_free = (char*)malloc(true_extent + (ptrdiff_t)(count - 1) * extent);
+    if (NULL == tmpbuf_free) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+    tmpbuf = tmpbuf_free - true_lb;
+
+    /* up sweep */
+    for (d = 1; d < size; d <<= 1) {
+        if (0 == (rank + 1) % (2 * d)) {
+            err = MCA_PML_CALL(recv(tmpbuf, count, dtype, rank - d, tag, comm,
+                                    MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            ompi_op_reduce(op, tmpbuf, buf, count, dtype);
+        } else {
+            /* my block is the lower half of the next one, I am done */
+            if (rank + d < size) {
+                err = MCA_PML_CALL(send(buf, count, dtype, rank + d, tag,
+                                        MCA_PML_BASE_SEND_STANDARD, comm));
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            }
+            break;
+        }
+    }
+
+    /* down sweep, from the largest power of two below the size */
+    for (d = 1; 2 * d < size; d <<= 1);
+    for ( ; d > 0; d >>= 1) {
+        if (0 == (rank + 1) % (2 * d)) {
+            if (rank + d < size) {
+                err = MCA_PML_CALL(send(buf, count, dtype, rank + d, tag,
+                                        MCA_PML_BASE_SEND_STANDARD, comm));
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            }
+        } else if ((d == (rank + 1) % (2 * d)) && (rank + 1 > d)) {
+            err = MCA_PML_CALL(recv(tmpbuf, count, dtype, rank - d, tag, comm,
+                                    MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            ompi_op_reduce(op, tmpbuf, buf, count, dtype);
+        }
+    }
+
+    free(tmpbuf_free);
+    return MPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    if (NULL != tmpbuf_free) free(tmpbuf_free);
+    return err;
+}
+
+/*
+ *  prefix_hierarchical
+ *
+ *  Function:   - prefix reduction in three levels, for nodes holding
+ *                consecutive ranks
+ *  Accepts:    - same as MPI_Scan() / MPI_Exscan(), sbuf resolved
+ *  Returns:    - MPI_SUCCESS or error code
+ *
+ *  1. a recursive doubling prefix within each node, over shared memory;
+ *  2. the last process of each node, which then has the reduction of the
+ *     whole node, takes part in an exclusive recursive doubling prefix
+ *     over these leaders: only log(nodes) steps cross the network;
+ *  3. the leader broadcasts the prefix of the previous nodes within its
+ *     node (binomial tree), and everybody puts it in front of its result.
+ *
+ *  Falls back to the flat recursive doubling when the nodes do not hold
+ *  consecutive ranks, the order of the operation could not be kept.
+ */
+int ompi_coll_tuned_prefix_hierarchical(void *sbuf, void *rbuf, int count,
+                                        struct ompi_datatype_t *dtype,
+                                        struct ompi_op_t *op, int exclusive, int tag,
+                                        struct ompi_communicator_t *comm,
+                                        mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+    int err = MPI_SUCCESS, line = 0, rank, nnodes, node, lo, hi, nlocal, v, mask;
+    ptrdiff_t lb, extent, true_lb, true_extent;
+    char *tmpbuf_free = NULL, *prefix;
+
+    rank = ompi_comm_rank(comm);
+
+    nnodes = ompi_coll_tuned_get_node_layout(comm, data);
+    if ((nnodes < 0) || !data->cached_node_consecutive) {
+        return ompi_coll_tuned_prefix_recursivedoubling(sbuf, rbuf, count, dtype, op, exclusive,
+                                                        NULL, 0, ompi_comm_size(comm), rank,
+                                                        tag, comm);
+    }
+    lo = data->cached_node_lo;
+    hi = data->cached_node_hi;
+    nlocal = hi - lo + 1;
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    tmpbuf_free = (char*)malloc(true_extent + (ptrdiff_t)(count - 1) * extent);
+    if (NULL == tmpbuf_free) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+    prefix = tmpbuf_free - true_lb;
+
+    /* an exclusive prefix loses the input of the leader, keep it for the node total */
+    if (exclusive && (rank == hi)) {
+        err = ompi_datatype_copy_content_same_ddt(dtype, count, prefix, (char*)sbuf);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    /* 1. within the node */
+    err = ompi_coll_tuned_prefix_recursivedoubling(sbuf, rbuf, count, dtype, op, exclusive,
+                                                   NULL, lo, nlocal, rank - lo, tag, comm);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    for (node = 0; data->cached_node_last[node] != hi; node++);
+
+    /* 2. across the leaders */
+    if ((rank == hi) && (nnodes > 1)) {
+        if (!exclusive) {
+            err = ompi_coll_tuned_prefix_recursivedoubling(rbuf, prefix, count, dtype, op, 1,
+                                                           data->cached_node_last, 0, nnodes, node,
+                                                           tag, comm);
+        } else {
+            if (nlocal > 1) ompi_op_reduce(op, rbuf, prefix, count, dtype);
+            err = ompi_coll_tuned_prefix_recursivedoubling(prefix, prefix, count, dtype, op, 1,
+                                                           data->cached_node_last, 0, nnodes, node,
+                                                           tag, comm);
+        }
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    /* 3. back within the node, nothing comes before the first node */
+    if (0 == node) {
+        free(tmpbuf_free);
+        return MPI_SUCCESS;
+    }
+    v = hi - rank;
+    for (mask = 1; mask < nlocal; mask <<= 1) {
+        if (v & mask) {
+            err = MCA_PML_CALL(recv(prefix, count, dtype, hi - (v - mask), tag, comm,
+                                    MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            break;
+        }
+    }
+    for (mask >>= 1; mask > 0; mask >>= 1) {
+        if (v + mask < nlocal) {
+            err = MCA_PML_CALL(send(prefix, count, dtype, hi - (v + mask), tag,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+    }
+
+    if (exclusive && (rank == lo)) {
+        err = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, prefix);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    } else {
+        ompi_op_reduce(op, prefix, rbuf, count, dtype);
+    }
+
+    free(tmpbuf_free);
+    return MPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    if (NULL != tmpbuf_free) free(tmpbuf_free);
+    return err;
+}
+
+/*
+ *  scan_intra_basic_linear
+ *
+ *  Function:   - the chain of coll/basic: every process waits for the
+ *                result of the previous one
+ *  Accepts:    - same as MPI_Scan()
+ *  Returns:    - MPI_SUCCESS or error code
+ */
+int ompi_coll_tuned_scan_intra_basic_linear(void *sbuf, void *rbuf, int count,
+                                            struct ompi_datatype_t *dtype,
+                                            struct ompi_op_t *op,
+                                            struct ompi_communicator_t *comm,
+                                            mca_coll_base_module_t *module)
+{
+    int err = MPI_SUCCESS, line = 0, rank, size;
+    ptrdiff_t lb, extent, true_lb, true_extent;
+    char *tmpbuf_free = NULL, *tmpbuf;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_basic_linear rank %d", rank));
+
+    if (MPI_IN_PLACE != sbuf) {
+        err = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    if (0 != rank) {
+        ompi_datatype_get_extent(dtype, &lb, &extent);
+        ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+        tmpbuf_free = (char*)malloc(true_extent + (ptrdiff_t)(count - 1) * extent);
+        if (NULL == tmpbuf_free) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+        tmpbuf = tmpbuf_free - true_lb;
+
+        err = MCA_PML_CALL(recv(tmpbuf, count, dtype, rank - 1, MCA_COLL_BASE_TAG_SCAN,
+                                comm, MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        ompi_op_reduce(op, tmpbuf, rbuf, count, dtype);
+        free(tmpbuf_free);
+        tmpbuf_free = NULL;
+    }
+
+    if (rank < size - 1) {
+        err = MCA_PML_CALL(send(rbuf, count, dtype, rank + 1, MCA_COLL_BASE_TAG_SCAN,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    return MPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    if (NULL != tmpbuf_free) free(tmpbuf_free);
+    return err;
+}
+
+/*
+ *  scan_intra_recursivedoubling
+ *
+ *  Function:   - recursive doubling, log(P) steps
+ *  Accepts:    - same as MPI_Scan()
+ *  Returns:    - MPI_SUCCESS or error code
+ */
+int ompi_coll_tuned_scan_intra_recursivedoubling(void *sbuf, void *rbuf, int count,
+                                                 struct ompi_datatype_t *dtype,
+                                                 struct ompi_op_t *op,
+                                                 struct ompi_communicator_t *comm,
+                                                 mca_coll_base_module_t *module)
+{
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_recursivedoubling rank %d",
+                 ompi_comm_rank(comm)));
+
+    if (MPI_IN_PLACE == sbuf) sbuf = rbuf;
+    return ompi_coll_tuned_prefix_recursivedoubling(sbuf, rbuf, count, dtype, op, 0,
+                                                    NULL, 0, ompi_comm_size(comm),
+                                                    ompi_comm_rank(comm),
+                                                    MCA_COLL_BASE_TAG_SCAN, comm);
+}
+
+/*
+ *  scan_intra_binomial
+ *
+ *  Function:   - up sweep / down sweep along binomial trees
+ *  Accepts:    - same as MPI_Scan()
+ *  Returns:    - MPI_SUCCESS or error code
+ */
+int ompi_coll_tuned_scan_intra_binomial(void *sbuf, void *rbuf, int count,
+                                        struct ompi_datatype_t *dtype,
+                                        struct ompi_op_t *op,
+                                        struct ompi_communicator_t *comm,
+                                        mca_coll_base_module_t *module)
+{
+    int err;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_binomial rank %d",
+                 ompi_comm_rank(comm)));
+
+    if (MPI_IN_PLACE != sbuf) {
+        err = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+        if (MPI_SUCCESS != err) return err;
+    }
+    return ompi_coll_tuned_prefix_binomial(rbuf, count, dtype, op, MCA_COLL_BASE_TAG_SCAN, comm);
+}
+
+/*
+ *  scan_intra_hierarchical
+ *
+ *  Function:   - within the nodes, across the node leaders, then back
+ *  Accepts:    - same as MPI_Scan()
+ *  Returns:    - MPI_SUCCESS or error code
+ */
+int ompi_coll_tuned_scan_intra_hierarchical(void *sbuf, void *rbuf, int count,
+                                            struct ompi_datatype_t *dtype,
+                                            struct ompi_op_t *op,
+                                            struct ompi_communicator_t *comm,
+                                            mca_coll_base_module_t *module)
+{
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_hierarchical rank %d",
+                 ompi_comm_rank(comm)));
+
+    if (MPI_IN_PLACE == sbuf) sbuf = rbuf;
+    return ompi_coll_tuned_prefix_hierarchical(sbuf, rbuf, count, dtype, op, 0,
+                                               MCA_COLL_BASE_TAG_SCAN, comm, module);
+}
+
+/* The following are used by dynamic and forced rules */
+
+/* publish details of each algorithm and if its forced/fixed/locked in */
+/* as you add methods/algorithms you must update this and the query/map routines */
+
+/* this routine is called by the component only */
+/* this makes sure that the mca parameters are set to their initial values and perms */
+/* module does not call this they call the forced_getvalues routine instead */
+
+int ompi_coll_tuned_scan_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices)
+{
+    mca_base_var_enum_t *new_enum;
+
+    ompi_coll_tuned_forced_max_algorithms[SCAN] = coll_tuned_scan_algorithm_count;
+
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "scan_algorithm_count",
+                                           "Number of scan algorithms available",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_CONSTANT,
+                                           &coll_tuned_scan_algorithm_count);
+
+    /* MPI_T: This variable should eventually be bound to a communicator */
+    coll_tuned_scan_forced_algorithm = 0;
+    (void) mca_base_var_enum_create("coll_tuned_scan_algorithms", scan_algorithms, &new_enum);
+    mca_param_indices->algorithm_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "scan_algorithm",
+                                        "Which scan algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 recursive doubling, 3 binomial (up/down sweep), 4 hierarchical (requires the ranks of each node to be consecutive)",
+                                        MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_scan_forced_algorithm);
+    OBJ_RELEASE(new_enum);
+    if (mca_param_indices->algorithm_param_index < 0) {
+        return mca_param_indices->algorithm_param_index;
+    }
+
+    coll_tuned_scan_segment_size = 0;
+    mca_param_indices->segsize_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "scan_algorithm_segmentsize",
+                                        "Segment size in bytes used by default for scan algorithms. Only has meaning if algorithm is forced and supports segmenting. 0 bytes means no segmentation.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_scan_segment_size);
+
+    coll_tuned_scan_tree_fanout = ompi_coll_tuned_init_tree_fanout; /* get system wide default */
+    mca_param_indices->tree_fanout_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "scan_algorithm_tree_fanout",
+                                        "Fanout for n-tree used for scan algorithms. Only has meaning if algorithm is forced and supports n-tree topo based operation.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_scan_tree_fanout);
+
+    coll_tuned_scan_chain_fanout = ompi_coll_tuned_init_chain_fanout; /* get system wide default */
+    mca_param_indices->chain_fanout_param_index =
+      mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                      "scan_algorithm_chain_fanout",
+                                      "Fanout for chains used for scan algorithms. Only has meaning if algorithm is forced and supports chain topo based operation.",
+                                      MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                      OPAL_INFO_LVL_5,
+                                      MCA_BASE_VAR_SCOPE_READONLY,
+                                      &coll_tuned_scan_chain_fanout);
+
+    return (MPI_SUCCESS);
+}
+
+
+int ompi_coll_tuned_scan_intra_do_forced(void *sbuf, void* rbuf, int count,
+                                         struct ompi_datatype_t *dtype,
+                                         struct ompi_op_t *op,
+                                         struct ompi_communicator_t *comm,
+                                         mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_do_forced selected algorithm %d",
+                 data->user_forced[SCAN].algorithm));
+
+    return ompi_coll_tuned_scan_intra_do_this(sbuf, rbuf, count, dtype, op, comm, module,
+                                              data->user_forced[SCAN].algorithm, 0, 0);
+}
+
+
+int ompi_coll_tuned_scan_intra_do_this(void *sbuf, void* rbuf, int count,
+                                       struct ompi_datatype_t *dtype,
+                                       struct ompi_op_t *op,
+                                       struct ompi_communicator_t *comm,
+                                       mca_coll_base_module_t *module,
+                                       int algorithm, int faninout, int segsize)
+{
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_do_this selected algorithm %d topo faninout %d segsize %d",
+                 algorithm, faninout, segsize));
+
+    switch (algorithm) {
+    case (0): return ompi_coll_tuned_scan_intra_dec_fixed(sbuf, rbuf, count, dtype, op,
+                                                          comm, module);
+    case (1): return ompi_coll_tuned_scan_intra_basic_linear(sbuf, rbuf, count, dtype, op,
+                                                             comm, module);
+    case (2): return ompi_coll_tuned_scan_intra_recursivedoubling(sbuf, rbuf, count, dtype, op,
+                                                                  comm, module);
+    case (3): return ompi_coll_tuned_scan_intra_binomial(sbuf, rbuf, count, dtype, op,
+                                                         comm, module);
+    case (4): return ompi_coll_tuned_scan_intra_hierarchical(sbuf, rbuf, count, dtype, op,
+                                                             comm, module);
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm, ompi_coll_tuned_forced_max_algorithms[SCAN]));
+        return (MPI_ERR_ARG);
+    } /* switch */
+}
@@ -33,7 +33,7 @@
 #include "coll_tuned_util.h"
 
 /* scatter algorithm variables */
-static int coll_tuned_scatter_algorithm_count = 2;
+static int coll_tuned_scatter_algorithm_count = 3;
 static int coll_tuned_scatter_forced_algorithm = 0;
 static int coll_tuned_scatter_segment_size = 0;
 static int coll_tuned_scatter_tree_fanout;
@@ -44,36 +44,36 @@ static mca_base_var_enum_value_t scatter_algorithms[] = {
     {0, "ignore"},
     {1, "basic_linear"},
     {2, "binomial"},
+    {3, "knomial"},
     {0, NULL}
 };
 
-int
-ompi_coll_tuned_scatter_intra_binomial(void *sbuf, int scount,
-                                       struct ompi_datatype_t *sdtype,
-                                       void *rbuf, int rcount,
-                                       struct ompi_datatype_t *rdtype,
-                                       int root,
-                                       struct ompi_communicator_t *comm,
-                                       mca_coll_base_module_t *module)
+/*
+ * Scatter along an in-order tree of the given radix where the subtree
+ * of each child holds the following ranks, the in-order binomial
+ * (radix 2) and k-nomial trees: every node forwards contiguous slices
+ * of the blocks it got from its parent.
+ */
+static int
+ompi_coll_tuned_scatter_intra_in_order_tree(void *sbuf, int scount,
+                                            struct ompi_datatype_t *sdtype,
+                                            void *rbuf, int rcount,
+                                            struct ompi_datatype_t *rdtype,
+                                            int root,
+                                            struct ompi_communicator_t *comm,
+                                            ompi_coll_tree_t* tree, int radix)
 {
     int line = -1, i, rank, vrank, size, total_send = 0, err;
     char *ptmp, *tempbuf = NULL;
-    ompi_coll_tree_t* bmtree;
     MPI_Status status;
     MPI_Aint sextent, slb, strue_lb, strue_extent; 
     MPI_Aint rextent, rlb, rtrue_lb, rtrue_extent;
-    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
-    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
 
     size = ompi_comm_size(comm);
     rank = ompi_comm_rank(comm);
 
     OPAL_OUTPUT((ompi_coll_tuned_stream,
-                 "ompi_coll_tuned_scatter_intra_binomial rank %d", rank));
-
-    /* create the binomial tree */
-    COLL_TUNED_UPDATE_IN_ORDER_BMTREE( comm, tuned_module, root );
-    bmtree = data->cached_in_order_bmtree;
+                 "ompi_coll_tuned_scatter_intra_in_order_tree rank %d radix %d", rank, radix));
 
     ompi_datatype_get_extent(sdtype, &slb, &sextent);
     ompi_datatype_get_true_extent(sdtype, &strue_lb, &strue_extent);
@@ -120,9 +120,9 @@ ompi_coll_tuned_scatter_intra_binomial(void *sbuf, int scount,
             }
         }
         total_send = scount;
-    } else if (!(vrank % 2)) {
+    } else if (!(vrank % radix)) {
         /* non-root, non-leaf nodes, allocte temp buffer for recv
-         * the most we need is rcount*size/2 */
+         * the most we need is rcount*size/radix */
         tempbuf = (char *) malloc(rtrue_extent + ((ptrdiff_t)rcount * (ptrdiff_t)size - 1) * rextent);
         if (NULL == tempbuf) {
             err= OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
@@ -136,10 +136,10 @@ ompi_coll_tuned_scatter_intra_binomial(void *sbuf, int scount,
         total_send = scount;
     }
 
-    if (!(vrank % 2)) {
+    if (!(vrank % radix)) {
         if (rank != root) {
             /* recv from parent on non-root */
-            err = MCA_PML_CALL(recv(ptmp, (ptrdiff_t)rcount * (ptrdiff_t)size, rdtype, bmtree->tree_prev,
+            err = MCA_PML_CALL(recv(ptmp, (ptrdiff_t)rcount * (ptrdiff_t)size, rdtype, tree->tree_prev,
                                     MCA_COLL_BASE_TAG_SCATTER, comm, &status));
             if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
             /* local copy to rbuf */
@@ -148,18 +148,19 @@ ompi_coll_tuned_scatter_intra_binomial(void *sbuf, int scount,
             if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
         }
         /* send to children on all non-leaf */
-        for (i = 0; i < bmtree->tree_nextsize; i++) {
+        for (i = 0; i < tree->tree_nextsize; i++) {
             size_t mycount = 0;
             int vkid;
-            /* figure out how much data I have to send to this child */
-            vkid = (bmtree->tree_next[i] - root + size) % size;
-            mycount = vkid - vrank;
+            /* figure out how much data I have to send to this child: its
+             * subtree spans the largest power of radix up to the distance */
+            vkid = (tree->tree_next[i] - root + size) % size;
+            for (mycount = 1; (int)mycount * radix <= vkid - vrank; mycount *= radix);
             if( (int)mycount > (size - vkid) )
                 mycount = size - vkid;
             mycount *= scount;
 
             err = MCA_PML_CALL(send(ptmp + (ptrdiff_t)total_send * sextent, mycount, sdtype,
-                                    bmtree->tree_next[i],
+                                    tree->tree_next[i],
                                     MCA_COLL_BASE_TAG_SCATTER,
                                     MCA_PML_BASE_SEND_STANDARD, comm));
             if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
@@ -171,7 +172,7 @@ ompi_coll_tuned_scatter_intra_binomial(void *sbuf, int scount,
             free(tempbuf);
     } else {
         /* recv from parent on leaf nodes */
-        err = MCA_PML_CALL(recv(ptmp, rcount, rdtype, bmtree->tree_prev,
+        err = MCA_PML_CALL(recv(ptmp, rcount, rdtype, tree->tree_prev,
                                 MCA_COLL_BASE_TAG_SCATTER, comm, &status));
         if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
     }
@@ -187,6 +188,60 @@ ompi_coll_tuned_scatter_intra_binomial(void *sbuf, int scount,
     return err;
 }
 
+int
+ompi_coll_tuned_scatter_intra_binomial(void *sbuf, int scount,
+                                       struct ompi_datatype_t *sdtype,
+                                       void *rbuf, int rcount,
+                                       struct ompi_datatype_t *rdtype,
+                                       int root,
+                                       struct ompi_communicator_t *comm,
+                                       mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_scatter_intra_binomial rank %d", ompi_comm_rank(comm)));
+
+    /* create the binomial tree */
+    COLL_TUNED_UPDATE_IN_ORDER_BMTREE( comm, tuned_module, root );
+
+    return ompi_coll_tuned_scatter_intra_in_order_tree(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                       root, comm, data->cached_in_order_bmtree, 2);
+}
+
+/*
+ *	scatter_intra_knomial
+ *
+ *	Function:	- scatter along an in-order k-nomial tree, radix 2 is
+ *			  the binomial tree
+ *	Accepts:	- same arguments as MPI_Scatter(), radix
+ *	Returns:	- MPI_SUCCESS or error code
+ */
+int
+ompi_coll_tuned_scatter_intra_knomial(void *sbuf, int scount,
+                                      struct ompi_datatype_t *sdtype,
+                                      void *rbuf, int rcount,
+                                      struct ompi_datatype_t *rdtype,
+                                      int root,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module,
+                                      int radix)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    radix = COLL_TUNED_KNOMIAL_RADIX(radix);
+    COLL_TUNED_UPDATE_IN_ORDER_KMTREE( comm, tuned_module, root, radix );
+    if (NULL == data->cached_in_order_kmtree) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    return ompi_coll_tuned_scatter_intra_in_order_tree(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                       root, comm, data->cached_in_order_kmtree,
+                                                       data->cached_in_order_kmtree->tree_fanout);
+}
+
 /*
  * Linear functions are copied from the BASIC coll module
  * they do not segment the message and are simple implementations
@@ -303,7 +358,7 @@ ompi_coll_tuned_scatter_intra_check_forced_init(coll_tuned_force_algorithm_mca_p
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "scatter_algorithm",
-                                        "Which scatter algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 binomial.",       
+                                        "Which scatter algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 binomial, 3 knomial (radix from scatter_algorithm_tree_fanout).",       
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_READONLY,
@@ -375,6 +430,11 @@ ompi_coll_tuned_scatter_intra_do_forced(void *sbuf, int scount,
         return ompi_coll_tuned_scatter_intra_binomial(sbuf, scount, sdtype,
                                                       rbuf, rcount, rdtype,
                                                       root, comm, module);
+    case (3):
+        return ompi_coll_tuned_scatter_intra_knomial(sbuf, scount, sdtype,
+                                                     rbuf, rcount, rdtype,
+                                                     root, comm, module,
+                                                     data->user_forced[SCATTER].tree_fanout);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,
                      "coll:tuned:scatter_intra_do_forced attempt to select algorithm %d when only 0-%d is valid?", 
@@ -411,6 +471,11 @@ ompi_coll_tuned_scatter_intra_do_this(void *sbuf, int scount,
         return ompi_coll_tuned_scatter_intra_binomial(sbuf, scount, sdtype,
                                                       rbuf, rcount, rdtype,
                                                       root, comm, module);
+    case (3):
+        return ompi_coll_tuned_scatter_intra_knomial(sbuf, scount, sdtype,
+                                                     rbuf, rcount, rdtype,
+                                                     root, comm, module,
+                                                     faninout);
     default:
         OPAL_OUTPUT((ompi_coll_tuned_stream,
                      "coll:tuned:scatter_intra_do_this attempt to select algorithm %d when only 0-%d is valid?", 
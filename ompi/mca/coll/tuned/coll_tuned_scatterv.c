@@ -0,0 +1,453 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <string.h>
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "coll_tuned.h"
+#include "coll_tuned_topo.h"
+#include "coll_tuned_util.h"
+
+/* scatterv algorithm variables */
+static int coll_tuned_scatterv_algorithm_count = 2;
+static int coll_tuned_scatterv_forced_algorithm = 0;
+static int coll_tuned_scatterv_segment_size = 0;
+static int coll_tuned_scatterv_tree_fanout;
+static int coll_tuned_scatterv_chain_fanout;
+
+/* valid values for coll_tuned_scatterv_forced_algorithm */
+static mca_base_var_enum_value_t scatterv_algorithms[] = {
+    {0, "ignore"},
+    {1, "basic_linear"},
+    {2, "binomial"},
+    {0, NULL}
+};
+
+/* offset of the n-th record of an aggregated subtree, each record is
+ * the length of a packed block followed by the block */
+static size_t
+scatterv_record_offset(char *buf, int n)
+{
+    size_t offset = 0;
+    MPI_Aint len;
+
+    while (n-- > 0) {
+        memcpy(&len, buf + offset, sizeof(MPI_Aint));
+        offset += sizeof(MPI_Aint) + (size_t)len;
+    }
+    return offset;
+}
+
+/*
+ *	scatterv_intra_binomial
+ *
+ *	Function:	- scatterv along the in-order binomial tree
+ *	Accepts:	- same arguments as MPI_Scatterv()
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ * The counts are only known on the root, so each subtree travels as a
+ * single MPI_PACKED message of records, the packed length of a block
+ * followed by the block, in rank order.  The subtree of a child is a
+ * contiguous range of records and goes down as it is; leaves get their
+ * block alone, straight in their receive buffer.  The largest subtrees
+ * are sent first.
+ */
+int
+ompi_coll_tuned_scatterv_intra_binomial(void *sbuf, int *scounts, int *disps,
+                                        struct ompi_datatype_t *sdtype,
+                                        void *rbuf, int rcount,
+                                        struct ompi_datatype_t *rdtype,
+                                        int root,
+                                        struct ompi_communicator_t *comm,
+                                        mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+    int line = -1, i, j, r, rank, vrank, vkid, span, size, err = MPI_SUCCESS;
+    size_t dsize, bytes, start, end, capacity = 0;
+    char *tempbuf = NULL;
+    ompi_status_public_t status;
+    MPI_Aint sextent, slb, len;
+    ompi_coll_tree_t *tree;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_scatterv_intra_binomial rank %d", rank));
+
+    /* create the binomial tree */
+    COLL_TUNED_UPDATE_IN_ORDER_BMTREE( comm, tuned_module, root );
+    tree = data->cached_in_order_bmtree;
+
+    vrank = (rank - root + size) % size;
+
+    if (rank == root) {
+        ompi_datatype_get_extent(sdtype, &slb, &sextent);
+        ompi_datatype_type_size(sdtype, &dsize);
+
+        if (MPI_IN_PLACE != rbuf && scounts[rank] > 0) {
+            err = ompi_datatype_sndrcv((char *)sbuf + (ptrdiff_t)disps[rank] * sextent,
+                                       scounts[rank], sdtype, rbuf, rcount, rdtype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+
+        for (i = tree->tree_nextsize - 1; i >= 0; i--) {
+            vkid = (tree->tree_next[i] - root + size) % size;
+            span = vkid - vrank;
+            if (span > size - vkid) span = size - vkid;
+
+            if (1 == span) {
+                r = tree->tree_next[i];
+                err = MCA_PML_CALL(send((char *)sbuf + (ptrdiff_t)disps[r] * sextent,
+                                        scounts[r], sdtype, r,
+                                        MCA_COLL_BASE_TAG_SCATTERV,
+                                        MCA_PML_BASE_SEND_STANDARD, comm));
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+                continue;
+            }
+
+            for (bytes = 0, j = vkid; j < vkid + span; j++) {
+                bytes += sizeof(MPI_Aint) + dsize * (size_t)scounts[(j + root) % size];
+            }
+            if (bytes > capacity) {
+                free(tempbuf);
+                tempbuf = (char *) malloc(bytes);
+                if (NULL == tempbuf) {
+                    err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+                }
+                capacity = bytes;
+            }
+
+            for (bytes = 0, j = vkid; j < vkid + span; j++) {
+                r = (j + root) % size;
+                len = (MPI_Aint)(dsize * (size_t)scounts[r]);
+                memcpy(tempbuf + bytes, &len, sizeof(MPI_Aint));
+                bytes += sizeof(MPI_Aint);
+                if (0 == len) continue;
+                err = ompi_datatype_sndrcv((char *)sbuf + (ptrdiff_t)disps[r] * sextent,
+                                           scounts[r], sdtype,
+                                           tempbuf + bytes, (int)len, MPI_PACKED);
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+                bytes += (size_t)len;
+            }
+
+            err = MCA_PML_CALL(send(tempbuf, (int)bytes, MPI_PACKED,
+                                    tree->tree_next[i], MCA_COLL_BASE_TAG_SCATTERV,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+
+        free(tempbuf);
+        return MPI_SUCCESS;
+    }
+
+    /* the subtree of a rank spans its lowest set bit */
+    span = vrank & -vrank;
+    if (span > size - vrank) span = size - vrank;
+
+    if (1 == span) {
+        /* leaf nodes get their block alone */
+        return MCA_PML_CALL(recv(rbuf, rcount, rdtype, tree->tree_prev,
+                                 MCA_COLL_BASE_TAG_SCATTERV,
+                                 comm, MPI_STATUS_IGNORE));
+    }
+
+    err = MCA_PML_CALL(probe(tree->tree_prev, MCA_COLL_BASE_TAG_SCATTERV,
+                             comm, &status));
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    bytes = status._ucount;
+
+    tempbuf = (char *) malloc(bytes);
+    if (NULL == tempbuf) {
+        err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+    }
+    err = MCA_PML_CALL(recv(tempbuf, (int)bytes, MPI_PACKED, tree->tree_prev,
+                            MCA_COLL_BASE_TAG_SCATTERV, comm, MPI_STATUS_IGNORE));
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    /* the first record is the local block */
+    memcpy(&len, tempbuf, sizeof(MPI_Aint));
+    if (len > 0) {
+        err = ompi_datatype_sndrcv(tempbuf + sizeof(MPI_Aint), (int)len, MPI_PACKED,
+                                   rbuf, rcount, rdtype);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    for (i = tree->tree_nextsize - 1; i >= 0; i--) {
+        int cspan;
+
+        vkid = (tree->tree_next[i] - root + size) % size;
+        cspan = vkid - vrank;
+        if (cspan > size - vkid) cspan = size - vkid;
+
+        start = scatterv_record_offset(tempbuf, vkid - vrank);
+        if (1 == cspan) {
+            memcpy(&len, tempbuf + start, sizeof(MPI_Aint));
+            start += sizeof(MPI_Aint);
+            end = start + (size_t)len;
+        } else {
+            end = start + scatterv_record_offset(tempbuf + start, cspan);
+        }
+
+        err = MCA_PML_CALL(send(tempbuf + start, (int)(end - start), MPI_PACKED,
+                                tree->tree_next[i], MCA_COLL_BASE_TAG_SCATTERV,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    free(tempbuf);
+    return MPI_SUCCESS;
+
+ err_hndl:
+    if (NULL != tempbuf)
+        free(tempbuf);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,  "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    return err;
+}
+
+/*
+ * Linear functions are copied from the BASIC coll module
+ * they do not segment the message and are simple implementations
+ * but for some small number of nodes and/or small data sizes they
+ * are just as fast as tuned/tree based segmenting operations
+ * and as such may be selected by the decision functions
+ * These are copied into this module due to the way we select modules
+ * in V1. i.e. in V2 we will handle this differently and so will not
+ * have to duplicate code.
+ */
+
+/* copied function (with appropriate renaming) starts here */
+
+/*
+ *	scatterv_intra_basic_linear
+ *
+ *	Function:	- basic scatterv operation
+ *	Accepts:	- same arguments as MPI_Scatterv()
+ *	Returns:	- MPI_SUCCESS or error code
+ */
+int
+ompi_coll_tuned_scatterv_intra_basic_linear(void *sbuf, int *scounts, int *disps,
+                                            struct ompi_datatype_t *sdtype,
+                                            void *rbuf, int rcount,
+                                            struct ompi_datatype_t *rdtype,
+                                            int root,
+                                            struct ompi_communicator_t *comm,
+                                            mca_coll_base_module_t *module)
+{
+    int i, rank, size, err = MPI_SUCCESS;
+    char *ptmp;
+    ptrdiff_t lb, extent;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_scatterv_intra_basic_linear rank %d", rank));
+
+    /* If not root, receive data. */
+    if (rank != root) {
+        if (rcount > 0) {
+            return MCA_PML_CALL(recv(rbuf, rcount, rdtype, root,
+                                     MCA_COLL_BASE_TAG_SCATTERV,
+                                     comm, MPI_STATUS_IGNORE));
+        }
+        return MPI_SUCCESS;
+    }
+
+    /* I am the root, loop sending data. */
+    ompi_datatype_get_extent(sdtype, &lb, &extent);
+    for (i = 0; i < size; ++i) {
+        ptmp = ((char *) sbuf) + (extent * disps[i]);
+
+        if (i == rank) {
+            if (scounts[i] > 0 && MPI_IN_PLACE != rbuf) {
+                err = ompi_datatype_sndrcv(ptmp, scounts[i], sdtype,
+                                           rbuf, rcount, rdtype);
+            }
+        } else if (scounts[i] > 0) {
+            err = MCA_PML_CALL(send(ptmp, scounts[i], sdtype, i,
+                                    MCA_COLL_BASE_TAG_SCATTERV,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+        }
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    /* All done */
+
+    return MPI_SUCCESS;
+}
+
+
+/* copied function (with appropriate renaming) ends here */
+
+/* The following are used by dynamic and forced rules */
+
+/* publish details of each algorithm and if its forced/fixed/locked in */
+/* as you add methods/algorithms you must update this and the query/map
+   routines */
+
+/* this routine is called by the component only */
+/* this makes sure that the mca parameters are set to their initial values
+   and perms */
+/* module does not call this they call the forced_getvalues routine instead */
+
+int
+ompi_coll_tuned_scatterv_intra_check_forced_init(coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices)
+{
+    mca_base_var_enum_t *new_enum;
+
+    ompi_coll_tuned_forced_max_algorithms[SCATTERV] = coll_tuned_scatterv_algorithm_count;
+
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "scatterv_algorithm_count",
+                                           "Number of scatterv algorithms available",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_CONSTANT,
+                                           &coll_tuned_scatterv_algorithm_count);
+
+    /* MPI_T: This variable should eventually be bound to a communicator */
+    coll_tuned_scatterv_forced_algorithm = 0;
+    (void) mca_base_var_enum_create("coll_tuned_scatterv_algorithms", scatterv_algorithms, &new_enum);
+    mca_param_indices->algorithm_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "scatterv_algorithm",
+                                        "Which scatterv algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 binomial.",
+                                        MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_scatterv_forced_algorithm);
+    OBJ_RELEASE(new_enum);
+    if (mca_param_indices->algorithm_param_index < 0) {
+        return mca_param_indices->algorithm_param_index;
+    }
+
+    coll_tuned_scatterv_segment_size = 0;
+    mca_param_indices->segsize_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "scatterv_algorithm_segmentsize",
+                                        "Segment size in bytes used by default for scatterv algorithms. Only has meaning if algorithm is forced and supports segmenting. 0 bytes means no segmentation. Currently, available algorithms do not support segmentation.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_scatterv_segment_size);
+
+    coll_tuned_scatterv_tree_fanout = ompi_coll_tuned_init_tree_fanout; /* get system wide default */
+    mca_param_indices->tree_fanout_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "scatterv_algorithm_tree_fanout",
+                                        "Fanout for n-tree used for scatterv algorithms. Only has meaning if algorithm is forced and supports n-tree topo based operation. Currently, available algorithms do not support n-tree topologies.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_READONLY,
+                                        &coll_tuned_scatterv_tree_fanout);
+
+    coll_tuned_scatterv_chain_fanout = ompi_coll_tuned_init_chain_fanout; /* get system wide default */
+    mca_param_indices->chain_fanout_param_index =
+      mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                      "scatterv_algorithm_chain_fanout",
+                                      "Fanout for chains used for scatterv algorithms. Only has meaning if algorithm is forced and supports chain topo based operation. Currently, available algorithms do not support chain topologies.",
+                                      MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                      OPAL_INFO_LVL_5,
+                                      MCA_BASE_VAR_SCOPE_READONLY,
+                                      &coll_tuned_scatterv_chain_fanout);
+
+    return (MPI_SUCCESS);
+}
+
+int
+ompi_coll_tuned_scatterv_intra_do_forced(void *sbuf, int *scounts, int *disps,
+                                         struct ompi_datatype_t *sdtype,
+                                         void *rbuf, int rcount,
+                                         struct ompi_datatype_t *rdtype,
+                                         int root,
+                                         struct ompi_communicator_t *comm,
+                                         mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    mca_coll_tuned_comm_t *data = tuned_module->tuned_data;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:scatterv_intra_do_forced selected algorithm %d",
+                 data->user_forced[SCATTERV].algorithm));
+
+    switch (data->user_forced[SCATTERV].algorithm) {
+    case (0):
+        return ompi_coll_tuned_scatterv_intra_dec_fixed (sbuf, scounts, disps, sdtype,
+                                                         rbuf, rcount, rdtype,
+                                                         root, comm, module);
+    case (1):
+        return ompi_coll_tuned_scatterv_intra_basic_linear (sbuf, scounts, disps, sdtype,
+                                                            rbuf, rcount, rdtype,
+                                                            root, comm, module);
+    case (2):
+        return ompi_coll_tuned_scatterv_intra_binomial (sbuf, scounts, disps, sdtype,
+                                                        rbuf, rcount, rdtype,
+                                                        root, comm, module);
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,
+                     "coll:tuned:scatterv_intra_do_forced attempt to select algorithm %d when only 0-%d is valid?",
+                     data->user_forced[SCATTERV].algorithm,
+                     ompi_coll_tuned_forced_max_algorithms[SCATTERV]));
+        return (MPI_ERR_ARG);
+    } /* switch */
+}
+
+int
+ompi_coll_tuned_scatterv_intra_do_this(void *sbuf, int *scounts, int *disps,
+                                       struct ompi_datatype_t *sdtype,
+                                       void *rbuf, int rcount,
+                                       struct ompi_datatype_t *rdtype,
+                                       int root,
+                                       struct ompi_communicator_t *comm,
+                                       mca_coll_base_module_t *module,
+                                       int algorithm, int faninout, int segsize)
+{
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:scatterv_intra_do_this selected algorithm %d topo faninout %d segsize %d",
+                 algorithm, faninout, segsize));
+
+    switch (algorithm) {
+    case (0):
+        return ompi_coll_tuned_scatterv_intra_dec_fixed (sbuf, scounts, disps, sdtype,
+                                                         rbuf, rcount, rdtype,
+                                                         root, comm, module);
+    case (1):
+        return ompi_coll_tuned_scatterv_intra_basic_linear (sbuf, scounts, disps, sdtype,
+                                                            rbuf, rcount, rdtype,
+                                                            root, comm, module);
+    case (2):
+        return ompi_coll_tuned_scatterv_intra_binomial (sbuf, scounts, disps, sdtype,
+                                                        rbuf, rcount, rdtype,
+                                                        root, comm, module);
+    default:
+        OPAL_OUTPUT((ompi_coll_tuned_stream,
+                     "coll:tuned:scatterv_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
+                     algorithm,
+                     ompi_coll_tuned_forced_max_algorithms[SCATTERV]));
+        return (MPI_ERR_ARG);
+    } /* switch */
+}
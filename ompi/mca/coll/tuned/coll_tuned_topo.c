@@ -20,8 +20,10 @@
 
 #include "mpi.h"
 #include "opal/util/bit_ops.h"
+#include "opal/mca/hwloc/hwloc.h"
 #include "ompi/constants.h"
 #include "ompi/communicator/communicator.h"
+#include "ompi/proc/proc.h"
 #include "ompi/mca/coll/base/coll_tags.h"
 #include "coll_tuned.h"
 #include "coll_tuned_topo.h"
@@ -454,6 +456,140 @@ ompi_coll_tuned_topo_build_in_order_bmtree( struct ompi_communicator_t* comm,
 }
 
 
+/*
+ * Constructs an in-order k-nomial tree, the generalization of the
+ * in-order binomial tree above to any radix.  With the ranks shifted so
+ * that the root is 0, the parent of a rank is found by clearing its
+ * lowest non-zero digit in base radix, and the childs sit at
+ * vrank + j * radix^l for every level l under that digit and
+ * j = 1..radix-1.  The subtree of a child at level l holds the radix^l
+ * ranks following it, so gather and scatter can keep their data in
+ * rank order exactly as with the binomial tree.
+ *
+ * Here is an example of this tree for radix 3:
+ * size = 9
+ *          0
+ *       / | \ \
+ *      1  2  3  6
+ *           /|  |\
+ *          4 5  7 8
+ *
+ * The radix is lowered until the root has no more than MAXTREEFANOUT
+ * childs; the radix really used is stored in tree_fanout.
+ *
+ * If reorder is set the childs are listed largest subtree first, and
+ * among subtrees of the same size the ones on another node first, so
+ * the transfers that take longest to complete start earliest.  The
+ * childs are then no longer in rank order, so only collectives that do
+ * not care about the order (bcast, commutative reduce) can use it.
+ */
+static int kmtree_root_childs( int radix, int size )
+{
+    int childs = 0, span, n;
+
+    for( span = 1; span < size; span *= radix ) {
+        n = (size - 1) / span;
+        childs += (n < radix - 1) ? n : radix - 1;
+        if( span > size / radix ) break;
+    }
+    return childs;
+}
+
+ompi_coll_tree_t*
+ompi_coll_tuned_topo_build_kmtree( struct ompi_communicator_t* comm,
+                                   int root, int radix, bool reorder )
+{
+    int childs = 0, rank, vrank, size, span, j, i, first, vkid, remote, pass;
+    int next[MAXTREEFANOUT], nnext = 0;
+    ompi_coll_tree_t *kmtree;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:topo:build_kmtree rt %d radix %d reorder %d",
+                 root, radix, (int)reorder));
+
+    /* 
+     * Get size and rank of the process in this communicator 
+     */
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    vrank = (rank - root + size) % size;
+
+    if( radix < 2 ) {
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:topo:build_kmtree WARNING invalid radix %d, forcing to 2 (binomial)!", radix));
+        radix = 2;
+    }
+    if( radix > size ) {
+        radix = (size < 2) ? 2 : size;
+    }
+    while( (radix > 2) && (kmtree_root_childs(radix, size) > MAXTREEFANOUT) ) {
+        radix--;
+    }
+
+    kmtree = (ompi_coll_tree_t*)malloc(sizeof(ompi_coll_tree_t));
+    if (!kmtree) {
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:topo:build_kmtree PANIC out of memory"));
+        return NULL;
+    }
+
+    kmtree->tree_bmtree   = 0;
+    kmtree->tree_fanout   = radix;
+    kmtree->tree_root     = MPI_UNDEFINED;
+    kmtree->tree_nextsize = MPI_UNDEFINED;
+    for( i = 0; i < MAXTREEFANOUT; i++ ) {
+        kmtree->tree_next[i] = -1;
+    }
+
+    kmtree->tree_prev = root;
+    for( span = 1; span < size; span *= radix ) {
+        if( 0 != (vrank / span) % radix ) {
+            /* my lowest non-zero digit: my parent clears it */
+            remote = vrank - ((vrank / span) % radix) * span;
+            kmtree->tree_prev = (remote + root) % size;
+            break;
+        }
+        for( j = 1; j < radix; j++ ) {
+            remote = vrank + j * span;
+            if( remote >= size ) break;
+            if (childs==MAXTREEFANOUT) {
+                OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:topo:build_kmtree max fanout incorrect %d needed %d", MAXTREEFANOUT, childs));
+                free(kmtree);
+                return NULL;
+            }
+            kmtree->tree_next[childs++] = (remote + root) % size;
+        }
+        if( span > size / radix ) break;
+    }
+
+    if( reorder && (childs > 1) ) {
+        /* the childs come in groups of equal subtrees, smallest first:
+         * walk the groups backward and put the remote childs of each
+         * group before the local ones */
+        for( i = childs - 1; i >= 0; i = first - 1 ) {
+            vkid = (kmtree->tree_next[i] - root + size) % size;
+            for( span = 1; span * radix <= vkid - vrank; span *= radix );
+            for( first = i; first > 0; first-- ) {
+                vkid = (kmtree->tree_next[first - 1] - root + size) % size;
+                if( vkid - vrank < span ) break;
+            }
+            for( pass = 0; pass < 2; pass++ ) {
+                for( j = i; j >= first; j-- ) {
+                    ompi_proc_t *proc = ompi_comm_peer_lookup(comm, kmtree->tree_next[j]);
+                    if( (0 == pass) != (0 != OPAL_PROC_ON_LOCAL_NODE(proc->proc_flags)) ) {
+                        next[nnext++] = kmtree->tree_next[j];
+                    }
+                }
+            }
+        }
+        for( i = 0; i < childs; i++ ) {
+            kmtree->tree_next[i] = next[i];
+        }
+    }
+
+    kmtree->tree_nextsize = childs;
+    kmtree->tree_root     = root;
+    return kmtree;
+}
+
 ompi_coll_tree_t*
 ompi_coll_tuned_topo_build_chain( int fanout,
                                   struct ompi_communicator_t* comm,
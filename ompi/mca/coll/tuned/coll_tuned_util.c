@@ -20,11 +20,16 @@
 #include "coll_tuned.h"
 
 #include "mpi.h"
+#include "opal/mca/hwloc/hwloc.h"
 #include "ompi/constants.h"
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/communicator/communicator.h"
+#include "ompi/group/group.h"
+#include "ompi/info/info.h"
+#include "ompi/proc/proc.h"
 #include "ompi/mca/coll/base/coll_tags.h"
 #include "ompi/mca/pml/pml.h"
+#include "ompi/mca/mpool/mpool.h"
 #include "coll_tuned_util.h"
 
 int ompi_coll_tuned_sendrecv_actual( void* sendbuf, size_t scount, 
@@ -160,3 +165,300 @@ int ompi_coll_tuned_sendrecv_actual_localcompleted( void* sendbuf, size_t scount
     return (err);
 }
 
+
+/*
+ * One direction of the throttled exchange, towards the peers on the node
+ * or towards the other ones. The peers are in the order of the steps of
+ * the pairwise exchange, and the stream owns a range of the requests.
+ */
+typedef struct {
+    int*   peers;
+    int    npeers;
+    int    next;        /* next peer to post */
+    int    first_slot;
+    int    nslots;
+    int    active;      /* outstanding requests */
+    size_t bytes;       /* outstanding bytes */
+    bool   send;
+} ompi_coll_tuned_stream_t;
+
+static int
+ompi_coll_tuned_stream_post( ompi_coll_tuned_stream_t* stream,
+                             ompi_request_t** reqs, size_t* slot_bytes,
+                             char* buf, int* counts, int* disps, int count,
+                             ompi_datatype_t* dtype, ptrdiff_t ext, size_t dsize,
+                             int tag, size_t max_bytes,
+                             struct ompi_communicator_t* comm )
+{
+    int err, peer, slot = stream->first_slot, c;
+    char* ptr;
+
+    while( (stream->next < stream->npeers) && (stream->active < stream->nslots) &&
+           ((0 == max_bytes) || (stream->bytes < max_bytes) || (0 == stream->active)) ) {
+        peer = stream->peers[stream->next++];
+        c = (NULL == counts) ? count : counts[peer];
+        if( 0 == c ) continue;
+        ptr = buf + ((NULL == counts) ? (ptrdiff_t)peer * count : (ptrdiff_t)disps[peer]) * ext;
+        while( MPI_REQUEST_NULL != reqs[slot] ) slot++;
+        if( stream->send ) {
+            err = MCA_PML_CALL(isend(ptr, c, dtype, peer, tag,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[slot]));
+        } else {
+            err = MCA_PML_CALL(irecv(ptr, c, dtype, peer, tag, comm, &reqs[slot]));
+        }
+        if( MPI_SUCCESS != err ) return err;
+        slot_bytes[slot] = (size_t)c * dsize;
+        stream->bytes += slot_bytes[slot];
+        stream->active++;
+    }
+    return MPI_SUCCESS;
+}
+
+int ompi_coll_tuned_exchange_throttled( void* sendbuf, int *scounts, int *sdisps,
+                                        int scount, ompi_datatype_t* sdtype,
+                                        void* recvbuf, int *rcounts, int *rdisps,
+                                        int rcount, ompi_datatype_t* rdtype,
+                                        int tag, struct ompi_communicator_t* comm,
+                                        int max_requests, size_t max_bytes )
+{
+    int err = MPI_SUCCESS, line = 0, rank, size, nlocal, i, k, peer, nslots, completed;
+    int *peers = NULL, nl[2], nr[2];
+    size_t *slot_bytes = NULL, sdsize, rdsize;
+    ptrdiff_t lb, sext, rext;
+    ompi_request_t **reqs = NULL;
+    ompi_proc_t *proc;
+    ompi_coll_tuned_stream_t streams[4];  /* local recv, remote recv, local send, remote send */
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+    if( 1 == size ) return MPI_SUCCESS;
+
+    ompi_datatype_get_extent(sdtype, &lb, &sext);
+    ompi_datatype_get_extent(rdtype, &lb, &rext);
+    ompi_datatype_type_size(sdtype, &sdsize);
+    ompi_datatype_type_size(rdtype, &rdsize);
+
+    for( nlocal = 0, peer = 0; peer < size; peer++ ) {
+        proc = ompi_group_peer_lookup(comm->c_local_group, peer);
+        if( (peer != rank) && OPAL_PROC_ON_LOCAL_NODE(proc->proc_flags) ) nlocal++;
+    }
+
+    /* the receives then the sends, each with the peers on the node first */
+    peers = (int*)malloc(2 * (size - 1) * sizeof(int));
+    if( NULL == peers ) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+    nl[0] = nl[1] = nr[0] = nr[1] = 0;
+    for( k = 1; k < size; k++ ) {
+        for( i = 0; i < 2; i++ ) {
+            peer = (0 == i) ? (rank + size - k) % size : (rank + k) % size;
+            proc = ompi_group_peer_lookup(comm->c_local_group, peer);
+            if( OPAL_PROC_ON_LOCAL_NODE(proc->proc_flags) ) {
+                peers[i * (size - 1) + nl[i]++] = peer;
+            } else {
+                peers[i * (size - 1) + nlocal + nr[i]++] = peer;
+            }
+        }
+    }
+
+    if( (max_requests <= 0) || (max_requests > size - 1 - nlocal) ) max_requests = size - 1 - nlocal;
+    nslots = 0;
+    for( i = 0; i < 4; i++ ) {
+        ompi_coll_tuned_stream_t* stream = &streams[i];
+        stream->send   = (i >= 2);
+        stream->peers  = peers + (stream->send ? (size - 1) : 0) + ((i & 1) ? nlocal : 0);
+        stream->npeers = (i & 1) ? size - 1 - nlocal : nlocal;
+        stream->next   = stream->active = 0;
+        stream->bytes  = 0;
+        /* the shared memory copies need a smaller window than the network */
+        stream->nslots = (i & 1) ? max_requests : ((max_requests / 4) > 0 ? (max_requests / 4) : 1);
+        if( stream->nslots > stream->npeers ) stream->nslots = stream->npeers;
+        stream->first_slot = nslots;
+        nslots += stream->nslots;
+    }
+
+    reqs = (ompi_request_t**)malloc(nslots * sizeof(ompi_request_t*));
+    slot_bytes = (size_t*)malloc(nslots * sizeof(size_t));
+    if( (NULL == reqs) || (NULL == slot_bytes) ) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+    for( i = 0; i < nslots; i++ ) reqs[i] = MPI_REQUEST_NULL;
+
+    /* post the receives first */
+    for( i = 0; i < 4; i++ ) {
+        if( streams[i].send ) {
+            err = ompi_coll_tuned_stream_post(&streams[i], reqs, slot_bytes, (char*)sendbuf, scounts, sdisps,
+                                              scount, sdtype, sext, sdsize, tag, max_bytes, comm);
+        } else {
+            err = ompi_coll_tuned_stream_post(&streams[i], reqs, slot_bytes, (char*)recvbuf, rcounts, rdisps,
+                                              rcount, rdtype, rext, rdsize, tag, max_bytes, comm);
+        }
+        if( MPI_SUCCESS != err ) { line = __LINE__; goto error_hndl; }
+    }
+
+    while( (streams[0].active + streams[1].active + streams[2].active + streams[3].active) > 0 ) {
+        err = ompi_request_wait_any(nslots, reqs, &completed, MPI_STATUS_IGNORE);
+        if( MPI_SUCCESS != err ) { line = __LINE__; goto error_hndl; }
+        reqs[completed] = MPI_REQUEST_NULL;
+        for( i = 3; streams[i].first_slot > completed; i-- );
+        streams[i].active--;
+        streams[i].bytes -= slot_bytes[completed];
+        if( streams[i].send ) {
+            err = ompi_coll_tuned_stream_post(&streams[i], reqs, slot_bytes, (char*)sendbuf, scounts, sdisps,
+                                              scount, sdtype, sext, sdsize, tag, max_bytes, comm);
+        } else {
+            err = ompi_coll_tuned_stream_post(&streams[i], reqs, slot_bytes, (char*)recvbuf, rcounts, rdisps,
+                                              rcount, rdtype, rext, rdsize, tag, max_bytes, comm);
+        }
+        if( MPI_SUCCESS != err ) { line = __LINE__; goto error_hndl; }
+    }
+
+    free(peers);
+    free(reqs);
+    free(slot_bytes);
+    return MPI_SUCCESS;
+
+ error_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    if( NULL != peers ) free(peers);
+    if( NULL != reqs ) free(reqs);
+    if( NULL != slot_bytes ) free(slot_bytes);
+    return err;
+}
+
+/*
+ * Scratch space for the temporaries of the algorithms. The buffer hangs
+ * off the communicator and only grows, up to scratch_max_size, so that
+ * consecutive calls neither go through the allocator nor hand fresh
+ * memory to the network; it comes from the mpools, as MPI_Alloc_mem
+ * memory does, so it is registered once. Only one algorithm at a time
+ * can hold it: a collective calling another one on the same
+ * communicator, or a temporary larger than the limit, gets its own
+ * malloc'ed buffer. Every buffer from ompi_coll_tuned_scratch_get is
+ * given back through ompi_coll_tuned_scratch_put.
+ */
+void *ompi_coll_tuned_scratch_get(mca_coll_tuned_comm_t *data, size_t size)
+{
+    char *buf;
+
+    if( data->mcct_scratch_busy || (size > (size_t)ompi_coll_tuned_scratch_max_size) ) {
+        return malloc(size);
+    }
+    if( size > data->mcct_scratch_size ) {
+        /* grow by doubling, bounded by the limit */
+        size_t new_size = (0 == data->mcct_scratch_size) ? 4096 : data->mcct_scratch_size;
+        while( new_size < size ) new_size *= 2;
+        if( new_size > (size_t)ompi_coll_tuned_scratch_max_size ) {
+            new_size = (size_t)ompi_coll_tuned_scratch_max_size;
+        }
+        ompi_coll_tuned_scratch_release(data);
+        buf = (char*)mca_mpool_base_alloc(new_size, &ompi_mpi_info_null.info);
+        data->mcct_scratch_registered = (NULL != buf);
+        if( NULL == buf ) buf = (char*)malloc(new_size);
+        if( NULL == buf ) return NULL;
+        data->mcct_scratch = buf;
+        data->mcct_scratch_size = new_size;
+    }
+    data->mcct_scratch_busy = true;
+    return data->mcct_scratch;
+}
+
+void ompi_coll_tuned_scratch_put(mca_coll_tuned_comm_t *data, void *buf)
+{
+    if( NULL == buf ) return;
+    if( buf == (void*)data->mcct_scratch ) {
+        data->mcct_scratch_busy = false;
+        return;
+    }
+    free(buf);
+}
+
+void ompi_coll_tuned_scratch_release(mca_coll_tuned_comm_t *data)
+{
+    if( NULL == data->mcct_scratch ) return;
+    if( data->mcct_scratch_registered ) {
+        mca_mpool_base_free(data->mcct_scratch);
+    } else {
+        free(data->mcct_scratch);
+    }
+    data->mcct_scratch = NULL;
+    data->mcct_scratch_size = 0;
+    data->mcct_scratch_registered = false;
+    data->mcct_scratch_busy = false;
+}
+
+/*
+ * Find the nodes of the communicator for the hierarchical algorithms.
+ * Collective the first time, the result is then cached on the
+ * communicator: the number of nodes, the first rank of each (its leader)
+ * and the ranks of mine. When every node holds a range of consecutive
+ * ranks (the usual by-slot mapping), which is what the order of a scan
+ * needs, the range of mine and the last rank of each node are known too.
+ * Returns the number of nodes, or -1 on failure.
+ */
+int ompi_coll_tuned_get_node_layout(struct ompi_communicator_t *comm,
+                                    mca_coll_tuned_comm_t *data)
+{
+    int err, line = 0, rank, size, peer, nnodes, npeers, consecutive, local[3], *all = NULL;
+    ompi_proc_t *proc;
+
+    if( 0 != data->cached_node_count ) return data->cached_node_count;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    /* the lowest and highest ranks on my node, and their number */
+    local[0] = local[1] = rank;
+    local[2] = 0;
+    for( peer = 0; peer < size; peer++ ) {
+        proc = ompi_group_peer_lookup(comm->c_local_group, peer);
+        if( (peer != rank) && !OPAL_PROC_ON_LOCAL_NODE(proc->proc_flags) ) continue;
+        if( peer < local[0] ) local[0] = peer;
+        local[1] = peer;
+        local[2]++;
+    }
+
+    /* everybody needs every node to agree on the outcome */
+    all = (int*)malloc(3 * size * sizeof(int));
+    if( NULL == all ) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+    err = comm->c_coll.coll_allgather(local, 3, MPI_INT, all, 3, MPI_INT,
+                                      comm, comm->c_coll.coll_allgather_module);
+    if( MPI_SUCCESS != err ) { line = __LINE__; goto error_hndl; }
+
+    /* a node is named after its lowest rank; the ranges must be full */
+    for( nnodes = 0, consecutive = 1, peer = 0; peer < size; peer++ ) {
+        if( all[3 * peer] == peer ) nnodes++;
+        if( (all[3 * peer + 1] - all[3 * peer] + 1) != all[3 * peer + 2] ) consecutive = 0;
+    }
+
+    data->cached_node_leaders = (int*)malloc(nnodes * sizeof(int));
+    data->cached_node_peers = (int*)malloc(local[2] * sizeof(int));
+    if( consecutive ) data->cached_node_last = (int*)malloc(nnodes * sizeof(int));
+    if( (NULL == data->cached_node_leaders) || (NULL == data->cached_node_peers) ||
+        (consecutive && (NULL == data->cached_node_last)) ) {
+        err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl;
+    }
+    for( nnodes = 0, npeers = 0, peer = 0; peer < size; peer++ ) {
+        if( all[3 * peer] == peer ) data->cached_node_leaders[nnodes++] = peer;
+        if( all[3 * peer] == local[0] ) data->cached_node_peers[npeers++] = peer;
+    }
+    if( consecutive ) {
+        for( nnodes = 0, peer = 0; peer < size; peer++ ) {
+            if( all[3 * peer + 1] == peer ) data->cached_node_last[nnodes++] = peer;
+        }
+        data->cached_node_lo = local[0];
+        data->cached_node_hi = local[1];
+    }
+    data->cached_node_consecutive = consecutive;
+    data->cached_node_size = local[2];
+    data->cached_node_count = nnodes;
+    free(all);
+    return nnodes;
+
+ error_hndl:
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    if( NULL != all ) free(all);
+    if( NULL != data->cached_node_leaders ) { free(data->cached_node_leaders); data->cached_node_leaders = NULL; }
+    if( NULL != data->cached_node_peers ) { free(data->cached_node_peers); data->cached_node_peers = NULL; }
+    if( NULL != data->cached_node_last ) { free(data->cached_node_last); data->cached_node_last = NULL; }
+    data->cached_node_count = -1;
+    return -1;
+}
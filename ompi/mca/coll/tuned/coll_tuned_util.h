@@ -119,6 +119,24 @@ ompi_coll_tuned_isendrecv( void* sendbuf, size_t scount, ompi_datatype_t* sdtype
     return ret;
 }
 
+/*
+ * Exchange a block with every other process, as in an alltoall(v): the
+ * block for peer p is at disp(p) * extent of sendbuf, with disp(p) =
+ * sdisps[p] and the count scounts[p], or p * scount and scount when
+ * scounts is NULL (the same for the receive side). At most max_requests
+ * receives and as many sends, and max_bytes bytes in each direction, are
+ * outstanding towards the other nodes (max_bytes 0 means no limit); the
+ * peers on the node have a window of their own, so that the intra-node
+ * transfers overlap with the inter-node ones. Empty blocks are skipped.
+ * The block of the calling process is not exchanged.
+ */
+int ompi_coll_tuned_exchange_throttled( void* sendbuf, int *scounts, int *sdisps,
+                                        int scount, ompi_datatype_t* sdtype,
+                                        void* recvbuf, int *rcounts, int *rdisps,
+                                        int rcount, ompi_datatype_t* rdtype,
+                                        int tag, struct ompi_communicator_t* comm,
+                                        int max_requests, size_t max_bytes );
+
 END_C_DECLS
 #endif /* MCA_COLL_TUNED_UTIL_EXPORT_H */
 
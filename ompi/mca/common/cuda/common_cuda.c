@@ -101,7 +101,10 @@ static bool mca_common_cuda_register_memory = true;
 static bool mca_common_cuda_warning = false;
 static opal_list_t common_cuda_memory_registrations;
 static CUstream ipcStream;
-static CUstream dtohStream;
+static CUstream *dtohStreams;
+static int mca_common_cuda_dtoh_streams = 4;
+static int dtoh_next_stream = 0;
+static int dtoh_next_progress = 0;
 static CUstream htodStream;
 
 /* Functions called by opal layer - plugged into opal function table */
@@ -129,7 +132,8 @@ OBJ_CLASS_INSTANCE( common_cuda_mem_regs_t,
 static int mca_common_cuda_async = 1;
 
 /* Array of CUDA events to be queried for IPC stream, sending side and
- * receiving side. */
+ * receiving side.  The dtoh array holds cuda_event_max events for each
+ * of the dtoh streams, every stream being its own circular buffer. */
 CUevent *cuda_event_ipc_array;
 CUevent *cuda_event_dtoh_array;
 CUevent *cuda_event_htod_array;
@@ -141,13 +145,16 @@ struct mca_btl_base_descriptor_t **cuda_event_dtoh_frag_array;
 struct mca_btl_base_descriptor_t **cuda_event_htod_frag_array;
 
 /* First free/available location in cuda_event_status_array */
-int cuda_event_ipc_first_avail, cuda_event_dtoh_first_avail, cuda_event_htod_first_avail;
+int cuda_event_ipc_first_avail, cuda_event_htod_first_avail;
+int *cuda_event_dtoh_first_avail;
 
 /* First currently-being used location in the cuda_event_status_array */
-int cuda_event_ipc_first_used, cuda_event_dtoh_first_used, cuda_event_htod_first_used;
+int cuda_event_ipc_first_used, cuda_event_htod_first_used;
+int *cuda_event_dtoh_first_used;
 
 /* Number of status items currently in use */
-int cuda_event_ipc_num_used, cuda_event_dtoh_num_used, cuda_event_htod_num_used;
+int cuda_event_ipc_num_used, cuda_event_htod_num_used;
+int *cuda_event_dtoh_num_used;
 
 /* Size of array holding events */
 int cuda_event_max = 200;
@@ -239,6 +246,20 @@ int mca_common_cuda_register_mca_variables(void)
                                  OPAL_INFO_LVL_9,
                                  MCA_BASE_VAR_SCOPE_READONLY,
                                  &cuda_event_max);
+
+    /* Each GPU send request gets one of these streams, so that the copies
+     * of one request do not queue behind the ones of another */
+    mca_common_cuda_dtoh_streams = 4;
+    (void) mca_base_var_register("ompi", "mpi", "common_cuda", "dtoh_streams",
+                                 "Number of CUDA streams used for asynchronous device to host "
+                                 "copies on the sending side (must be >= 1)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &mca_common_cuda_dtoh_streams);
+    if (mca_common_cuda_dtoh_streams < 1) {
+        mca_common_cuda_dtoh_streams = 1;
+    }
 #endif /* OMPI_CUDA_SUPPORT_41 */
 
     return OMPI_SUCCESS;
@@ -367,11 +388,18 @@ static int mca_common_cuda_init(opal_common_cuda_function_table_t *ftable)
          * sending side for asynchronous copies. */
         cuda_event_dtoh_array = NULL;
         cuda_event_dtoh_frag_array = NULL;
-        cuda_event_dtoh_num_used = 0;
-        cuda_event_dtoh_first_avail = 0;
-        cuda_event_dtoh_first_used = 0;
+        cuda_event_dtoh_num_used = (int *) calloc(mca_common_cuda_dtoh_streams, sizeof(int));
+        cuda_event_dtoh_first_avail = (int *) calloc(mca_common_cuda_dtoh_streams, sizeof(int));
+        cuda_event_dtoh_first_used = (int *) calloc(mca_common_cuda_dtoh_streams, sizeof(int));
+        if (NULL == cuda_event_dtoh_num_used || NULL == cuda_event_dtoh_first_avail ||
+            NULL == cuda_event_dtoh_first_used) {
+            opal_show_help("help-mpi-common-cuda.txt", "No memory",
+                           true, errno, strerror(errno));
+            return OMPI_ERROR;
+        }
 
-        cuda_event_dtoh_array = (CUevent *) malloc(sizeof(CUevent) * cuda_event_max);
+        cuda_event_dtoh_array = (CUevent *)
+            malloc(sizeof(CUevent) * cuda_event_max * mca_common_cuda_dtoh_streams);
         if (NULL == cuda_event_dtoh_array) {
             opal_show_help("help-mpi-common-cuda.txt", "No memory",
                            true, errno, strerror(errno));
@@ -379,7 +407,7 @@ static int mca_common_cuda_init(opal_common_cuda_function_table_t *ftable)
         }
 
         /* Create the events since they can be reused. */
-        for (i = 0; i < cuda_event_max; i++) {
+        for (i = 0; i < cuda_event_max * mca_common_cuda_dtoh_streams; i++) {
             res = cuFunc.cuEventCreate(&cuda_event_dtoh_array[i], CU_EVENT_DISABLE_TIMING);
             if (CUDA_SUCCESS != res) {
                 opal_show_help("help-mpi-common-cuda.txt", "cuEventCreate failed",
@@ -391,7 +419,8 @@ static int mca_common_cuda_init(opal_common_cuda_function_table_t *ftable)
         /* The first available status index is 0.  Make an empty frag
            array. */
         cuda_event_dtoh_frag_array = (struct mca_btl_base_descriptor_t **)
-            malloc(sizeof(struct mca_btl_base_descriptor_t *) * cuda_event_max);
+            malloc(sizeof(struct mca_btl_base_descriptor_t *) * cuda_event_max *
+                   mca_common_cuda_dtoh_streams);
         if (NULL == cuda_event_dtoh_frag_array) {
             opal_show_help("help-mpi-common-cuda.txt", "No memory",
                            true, errno, strerror(errno));
@@ -465,13 +494,20 @@ static int mca_common_cuda_init(opal_common_cuda_function_table_t *ftable)
         return OMPI_ERROR;
     }
 
-    /* Create stream for use in dtoh asynchronous copies */
-    res = cuFunc.cuStreamCreate(&dtohStream, 0);
-    if (res != CUDA_SUCCESS) {
-        opal_show_help("help-mpi-common-cuda.txt", "cuStreamCreate failed",
-                       true, res);
+    /* Create streams for use in dtoh asynchronous copies */
+    dtohStreams = (CUstream *) malloc(sizeof(CUstream) * mca_common_cuda_dtoh_streams);
+    if (NULL == dtohStreams) {
+        opal_show_help("help-mpi-common-cuda.txt", "No memory",
+                       true, errno, strerror(errno));
         return OMPI_ERROR;
-
+    }
+    for (i = 0; i < mca_common_cuda_dtoh_streams; i++) {
+        res = cuFunc.cuStreamCreate(&dtohStreams[i], 0);
+        if (res != CUDA_SUCCESS) {
+            opal_show_help("help-mpi-common-cuda.txt", "cuStreamCreate failed",
+                           true, res);
+            return OMPI_ERROR;
+        }
     }
 
     /* Create stream for use in htod asynchronous copies */
@@ -1074,33 +1110,44 @@ int mca_common_cuda_memcpy(void *dst, void *src, size_t amount, char *msg,
  * Record an event and save the frag.  This is called by the sending side and
  * is used to queue an event when a htod copy has been initiated.
  */
-int mca_common_cuda_record_dtoh_event(char *msg, struct mca_btl_base_descriptor_t *frag)
+int mca_common_cuda_record_dtoh_event(char *msg, struct mca_btl_base_descriptor_t *frag,
+                                      void *stream)
 {
     CUresult result;
+    int s, slot;
+
+    /* Find which of the dtoh streams the copy was queued on.  Events of one
+     * stream complete in order, so each stream has its own circular buffer. */
+    for (s = 0; s < mca_common_cuda_dtoh_streams - 1; s++) {
+        if ((CUstream)stream == dtohStreams[s]) {
+            break;
+        }
+    }
 
     /* First make sure there is room to store the event.  If not, then
      * return an error.  The error message will tell the user to try and
      * run again, but with a larger array for storing events. */
-    if (cuda_event_dtoh_num_used == cuda_event_max) {
+    if (cuda_event_dtoh_num_used[s] == cuda_event_max) {
         opal_show_help("help-mpi-common-cuda.txt", "Out of cuEvent handles",
                        true, cuda_event_max, cuda_event_max+100, cuda_event_max+100);
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
 
-    result = cuFunc.cuEventRecord(cuda_event_dtoh_array[cuda_event_dtoh_first_avail], dtohStream);
+    slot = s * cuda_event_max + cuda_event_dtoh_first_avail[s];
+    result = cuFunc.cuEventRecord(cuda_event_dtoh_array[slot], dtohStreams[s]);
     if (CUDA_SUCCESS != result) {
         opal_show_help("help-mpi-common-cuda.txt", "cuEventRecord failed",
                        true, result);
         return OMPI_ERROR;
     }
-    cuda_event_dtoh_frag_array[cuda_event_dtoh_first_avail] = frag;
+    cuda_event_dtoh_frag_array[slot] = frag;
 
     /* Bump up the first available slot and number used by 1 */
-    cuda_event_dtoh_first_avail++;
-    if (cuda_event_dtoh_first_avail >= cuda_event_max) {
-        cuda_event_dtoh_first_avail = 0;
+    cuda_event_dtoh_first_avail[s]++;
+    if (cuda_event_dtoh_first_avail[s] >= cuda_event_max) {
+        cuda_event_dtoh_first_avail[s] = 0;
     }
-    cuda_event_dtoh_num_used++;
+    cuda_event_dtoh_num_used[s]++;
 
     return OMPI_SUCCESS;
 }
@@ -1141,10 +1188,17 @@ int mca_common_cuda_record_htod_event(char *msg, struct mca_btl_base_descriptor_
 }
 
 /**
- * Used to get the dtoh stream for initiating asynchronous copies.
+ * Used to get a dtoh stream for initiating asynchronous copies.  The
+ * streams are handed out round-robin, one per request, so the copies of
+ * concurrent requests proceed independently of each other.
  */
 void *mca_common_cuda_get_dtoh_stream(void) {
-    return (void *)dtohStream;
+    int s = dtoh_next_stream;
+
+    if (++dtoh_next_stream >= mca_common_cuda_dtoh_streams) {
+        dtoh_next_stream = 0;
+    }
+    return (void *)dtohStreams[s];
 }
 
 /**
@@ -1203,20 +1257,27 @@ int progress_one_cuda_ipc_event(struct mca_btl_base_descriptor_t **frag) {
  */
 int progress_one_cuda_dtoh_event(struct mca_btl_base_descriptor_t **frag) {
     CUresult result;
-
-    if (cuda_event_dtoh_num_used > 0) {
+    int i, s, slot;
+
+    /* Look at the oldest event of every stream, starting after the stream
+     * that completed last so that none of them is starved. */
+    for (i = 0; i < mca_common_cuda_dtoh_streams; i++) {
+        s = (dtoh_next_progress + i) % mca_common_cuda_dtoh_streams;
+        if (0 == cuda_event_dtoh_num_used[s]) {
+            continue;
+        }
         opal_output_verbose(20, mca_common_cuda_output,
-                           "CUDA: progress_one_cuda_dtoh_event, outstanding_events=%d",
-                            cuda_event_dtoh_num_used);
+                           "CUDA: progress_one_cuda_dtoh_event, stream=%d, outstanding_events=%d",
+                            s, cuda_event_dtoh_num_used[s]);
 
-        result = cuFunc.cuEventQuery(cuda_event_dtoh_array[cuda_event_dtoh_first_used]);
+        slot = s * cuda_event_max + cuda_event_dtoh_first_used[s];
+        result = cuFunc.cuEventQuery(cuda_event_dtoh_array[slot]);
 
-        /* We found an event that is not ready, so return. */
+        /* We found an event that is not ready, so try the next stream. */
         if (CUDA_ERROR_NOT_READY == result) {
             opal_output_verbose(20, mca_common_cuda_output,
                                 "CUDA: cuEventQuery returned CUDA_ERROR_NOT_READY");
-            *frag = NULL;
-            return 0;
+            continue;
         } else if (CUDA_SUCCESS != result) {
             opal_show_help("help-mpi-common-cuda.txt", "cuEventQuery failed",
                            true, result);
@@ -1224,19 +1285,21 @@ int progress_one_cuda_dtoh_event(struct mca_btl_base_descriptor_t **frag) {
             return OMPI_ERROR;
         }
 
-        *frag = cuda_event_dtoh_frag_array[cuda_event_dtoh_first_used];
+        *frag = cuda_event_dtoh_frag_array[slot];
         opal_output_verbose(10, mca_common_cuda_output,
                             "CUDA: cuEventQuery returned %d", result);
 
         /* Bump counters, loop around the circular buffer if necessary */
-        --cuda_event_dtoh_num_used;
-        ++cuda_event_dtoh_first_used;
-        if (cuda_event_dtoh_first_used >= cuda_event_max) {
-            cuda_event_dtoh_first_used = 0;
+        --cuda_event_dtoh_num_used[s];
+        ++cuda_event_dtoh_first_used[s];
+        if (cuda_event_dtoh_first_used[s] >= cuda_event_max) {
+            cuda_event_dtoh_first_used[s] = 0;
         }
+        dtoh_next_progress = (s + 1) % mca_common_cuda_dtoh_streams;
         /* A return value of 1 indicates an event completed and a frag was returned */
         return 1;
     }
+    *frag = NULL;
     return 0;
 }
 
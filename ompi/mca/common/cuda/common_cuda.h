@@ -45,7 +45,8 @@ OMPI_DECLSPEC int mca_common_cuda_memcpy(void *dst, void *src, size_t amount, ch
 OMPI_DECLSPEC int mca_common_cuda_record_ipc_event(char *msg,
                                                struct mca_btl_base_descriptor_t *frag);
 OMPI_DECLSPEC int mca_common_cuda_record_dtoh_event(char *msg,
-                                                    struct mca_btl_base_descriptor_t *frag);
+                                                    struct mca_btl_base_descriptor_t *frag,
+                                                    void *stream);
 OMPI_DECLSPEC int mca_common_cuda_record_htod_event(char *msg,
                                                     struct mca_btl_base_descriptor_t *frag);
 
@@ -90,6 +90,17 @@ static int ft_event_state = OPAL_CRS_RUNNING;
  */
 opal_list_t ompi_crcp_bkmrk_pml_peer_refs;
 
+/*
+ * The peers we exchanged messages with since the last checkpoint, the
+ * only ones a bookmark is exchanged with, and the peers of our job
+ * indexed by vpid.
+ */
+static ompi_crcp_bkmrk_pml_peer_ref_t **active_peers = NULL;
+static int num_active_peers = 0;
+static int max_active_peers = 0;
+static ompi_crcp_bkmrk_pml_peer_ref_t **peer_refs_by_vpid = NULL;
+static size_t num_peer_refs_by_vpid = 0;
+
 /*
  * MPI_ANY_SOURCE recv lists
  */
@@ -301,6 +312,18 @@ static int drain_message_copy_remove_persistent(ompi_crcp_bkmrk_pml_drain_messag
  */
 static ompi_crcp_bkmrk_pml_peer_ref_t* find_peer(ompi_process_name_t proc);
 
+/*
+ * Add a peer to the set of active peers
+ */
+static int peer_ref_activate(ompi_crcp_bkmrk_pml_peer_ref_t *peer_ref);
+
+#define PEER_REF_ACTIVATE(peer_ref)             \
+ {                                              \
+    if( !(peer_ref)->active ) {                 \
+        peer_ref_activate(peer_ref);            \
+    }                                           \
+ }
+
 /*
  * Peer List: Find the peer reference matching the index into the communicator
  */
@@ -319,23 +342,29 @@ static int ft_event_coordinate_peers(void);
  */
 static int ft_event_finalize_exchange(void);
 
+/*
+ * Count the bookmarks each process is going to receive
+ */
+static int exchange_bookmark_counts(int32_t *counts, int num_peers, int *num_bookmarks);
+
 /*
  * Exchange the bookmarks
- *  - Staggered All-to-All
+ *  - Only with the active peers, received from any peer
  * LAM/MPI used a staggered all-to-all algoritm for bookmark exachange
  *    http://www.lam-mpi.org/papers/lacsi2003/
+ * which is one message per peer, used or not.
  */
 static int ft_event_exchange_bookmarks(void);
 
 /*
  * Send Bookmarks to peer
  */
-static int send_bookmarks(int peer_idx);
+static int send_bookmarks(ompi_crcp_bkmrk_pml_peer_ref_t *peer_ref);
 
 /*
- * Recv Bookmarks from peer
+ * Recv Bookmarks from any peer
  */
-static int recv_bookmarks(int peer_idx);
+static int recv_bookmarks(void);
 
 /*
  * Callback to receive the bookmarks from a peer
@@ -717,6 +746,8 @@ void ompi_crcp_bkmrk_pml_peer_ref_construct(ompi_crcp_bkmrk_pml_peer_ref_t *peer
     peer_ref->total_drained_msgs = 0;
 
     peer_ref->ack_required = false;
+
+    peer_ref->active = false;
 }
 
 void ompi_crcp_bkmrk_pml_peer_ref_destruct( ompi_crcp_bkmrk_pml_peer_ref_t *peer_ref) {
@@ -1198,6 +1229,19 @@ int ompi_crcp_bkmrk_pml_finalize(void) {
 
     OBJ_DESTRUCT(&ompi_crcp_bkmrk_pml_peer_refs);
 
+    if( NULL != active_peers ) {
+        free(active_peers);
+        active_peers = NULL;
+    }
+    num_active_peers = 0;
+    max_active_peers = 0;
+
+    if( NULL != peer_refs_by_vpid ) {
+        free(peer_refs_by_vpid);
+        peer_refs_by_vpid = NULL;
+    }
+    num_peer_refs_by_vpid = 0;
+
     OBJ_DESTRUCT(&unknown_recv_from_list);
     OBJ_DESTRUCT(&unknown_persist_recv_list);
 
@@ -1426,8 +1470,9 @@ ompi_crcp_base_pml_state_t* ompi_crcp_bkmrk_pml_add_procs(
                                    size_t nprocs, 
                                    ompi_crcp_base_pml_state_t* pml_state )
 {
-    ompi_crcp_bkmrk_pml_peer_ref_t *new_peer_ref;
-    size_t i;
+    ompi_crcp_bkmrk_pml_peer_ref_t *new_peer_ref, **tmp_peer_refs;
+    size_t i, max_vpid;
+    int exit_status = OMPI_SUCCESS;
 
     if( OMPI_CRCP_PML_PRE != pml_state->state ){
         goto DONE;
@@ -1436,6 +1481,29 @@ ompi_crcp_base_pml_state_t* ompi_crcp_bkmrk_pml_add_procs(
     OPAL_OUTPUT_VERBOSE((30, mca_crcp_bkmrk_component.super.output_handle,
                         "crcp:bkmrk: pml_add_procs()"));
 
+    /*
+     * Grow the vpid index of our job to the new peers
+     */
+    max_vpid = num_peer_refs_by_vpid;
+    for( i = 0; i < nprocs; ++i) {
+        if( procs[i]->proc_name.jobid == OMPI_PROC_MY_NAME->jobid &&
+            procs[i]->proc_name.vpid >= max_vpid ) {
+            max_vpid = procs[i]->proc_name.vpid + 1;
+        }
+    }
+    if( max_vpid > num_peer_refs_by_vpid ) {
+        tmp_peer_refs = (ompi_crcp_bkmrk_pml_peer_ref_t **)realloc(peer_refs_by_vpid,
+                                                                    max_vpid * sizeof(ompi_crcp_bkmrk_pml_peer_ref_t *));
+        if( NULL == tmp_peer_refs ) {
+            exit_status = OMPI_ERR_OUT_OF_RESOURCE;
+            goto DONE;
+        }
+        memset(tmp_peer_refs + num_peer_refs_by_vpid, 0,
+               (max_vpid - num_peer_refs_by_vpid) * sizeof(ompi_crcp_bkmrk_pml_peer_ref_t *));
+        peer_refs_by_vpid = tmp_peer_refs;
+        num_peer_refs_by_vpid = max_vpid;
+    }
+
     /*
      * Save pointers to the wrapped PML
      */
@@ -1450,12 +1518,17 @@ ompi_crcp_base_pml_state_t* ompi_crcp_bkmrk_pml_add_procs(
 
         new_peer_ref->proc_name.jobid  = procs[i]->proc_name.jobid;
         new_peer_ref->proc_name.vpid   = procs[i]->proc_name.vpid;
+        new_peer_ref->active           = false;
 
         opal_list_append(&ompi_crcp_bkmrk_pml_peer_refs, &(new_peer_ref->super));
+
+        if( new_peer_ref->proc_name.jobid == OMPI_PROC_MY_NAME->jobid ) {
+            peer_refs_by_vpid[new_peer_ref->proc_name.vpid] = new_peer_ref;
+        }
     }
 
  DONE:
-    pml_state->error_code = OMPI_SUCCESS;
+    pml_state->error_code = exit_status;
     return pml_state;
 }
 
@@ -1468,6 +1541,7 @@ ompi_crcp_base_pml_state_t* ompi_crcp_bkmrk_pml_del_procs(
     ompi_crcp_bkmrk_pml_peer_ref_t *old_peer_ref;
     int exit_status = OMPI_SUCCESS;
     size_t i;
+    int j;
 
     if( OMPI_CRCP_PML_PRE != pml_state->state ){
         goto DONE;
@@ -1489,6 +1563,22 @@ ompi_crcp_base_pml_state_t* ompi_crcp_bkmrk_pml_del_procs(
         /* Remove the found peer from the list */
         opal_list_remove_item(&ompi_crcp_bkmrk_pml_peer_refs, item);
         old_peer_ref = (ompi_crcp_bkmrk_pml_peer_ref_t*)item;
+
+        /* ... and from the vpid index and the active set */
+        if( old_peer_ref->proc_name.jobid == OMPI_PROC_MY_NAME->jobid &&
+            old_peer_ref->proc_name.vpid < num_peer_refs_by_vpid ) {
+            peer_refs_by_vpid[old_peer_ref->proc_name.vpid] = NULL;
+        }
+        if( old_peer_ref->active ) {
+            for( j = 0; j < num_active_peers; ++j ) {
+                if( active_peers[j] == old_peer_ref ) {
+                    active_peers[j] = active_peers[--num_active_peers];
+                    break;
+                }
+            }
+            old_peer_ref->active = false;
+        }
+
         HOKE_PEER_REF_RETURN(old_peer_ref);
     }
 
@@ -1634,6 +1724,7 @@ static int ompi_crcp_bkmrk_pml_start_isend_init(ompi_request_t **request)
         if( !content_ref->already_drained ) {
             /* Account for this inflight send */
             peer_ref->total_msgs_sent += 1;
+            PEER_REF_ACTIVATE(peer_ref);
         }
     }
 
@@ -1754,6 +1845,7 @@ ompi_crcp_base_pml_state_t* ompi_crcp_bkmrk_pml_isend(
 
         /*  Bookkeeping */
         peer_ref->total_msgs_sent += 1;
+        PEER_REF_ACTIVATE(peer_ref);
 
         /* Save the pointers */
         CREATE_COORD_STATE(coord_state, pml_state,
@@ -1912,6 +2004,7 @@ ompi_crcp_base_pml_state_t* ompi_crcp_bkmrk_pml_send(
 
         /*  Bookkeeping */
         peer_ref->total_msgs_sent += 1;
+        PEER_REF_ACTIVATE(peer_ref);
         current_msg_id = msg_ref->msg_id;
         current_msg_type = COORD_MSG_TYPE_B_SEND;
 
@@ -2361,6 +2454,7 @@ static int ompi_crcp_bkmrk_request_complete_irecv_init(struct ompi_request_t *re
 
     if( !content_ref->already_drained ) {
         peer_ref->total_msgs_recvd += 1;
+        PEER_REF_ACTIVATE(peer_ref);
         msg_ref->done++;
         msg_ref->active--;
     } else {
@@ -2598,6 +2692,7 @@ static int ompi_crcp_bkmrk_request_complete_irecv(struct ompi_request_t *request
 
     if( !content_ref->already_drained ) {
         peer_ref->total_msgs_recvd += 1;
+        PEER_REF_ACTIVATE(peer_ref);
         msg_ref->done++;
         msg_ref->active--;
     } else {
@@ -2752,6 +2847,7 @@ ompi_crcp_base_pml_state_t* ompi_crcp_bkmrk_pml_recv(
         }
 
         peer_ref->total_msgs_recvd += 1;
+        PEER_REF_ACTIVATE(peer_ref);
         current_msg_id = 0;
         current_msg_type = COORD_MSG_TYPE_UNKNOWN;
 
@@ -4144,6 +4240,14 @@ static ompi_crcp_bkmrk_pml_peer_ref_t * find_peer(ompi_process_name_t proc)
     opal_list_item_t* item = NULL;
     ompi_rte_cmp_bitmask_t mask;
 
+    /* The peers of our job are indexed by vpid */
+    if( proc.jobid == OMPI_PROC_MY_NAME->jobid ) {
+        if( proc.vpid < num_peer_refs_by_vpid ) {
+            return peer_refs_by_vpid[proc.vpid];
+        }
+        return NULL;
+    }
+
     for(item  = opal_list_get_first(&ompi_crcp_bkmrk_pml_peer_refs);
         item != opal_list_get_end(&ompi_crcp_bkmrk_pml_peer_refs);
         item  = opal_list_get_next(item) ) {
@@ -4162,6 +4266,41 @@ static ompi_crcp_bkmrk_pml_peer_ref_t * find_peer(ompi_process_name_t proc)
     return NULL;
 }
 
+static int peer_ref_activate(ompi_crcp_bkmrk_pml_peer_ref_t *peer_ref)
+{
+    ompi_crcp_bkmrk_pml_peer_ref_t **tmp_peers;
+
+    if( peer_ref->active ) {
+        return OMPI_SUCCESS;
+    }
+
+    if( num_active_peers == max_active_peers ) {
+        tmp_peers = (ompi_crcp_bkmrk_pml_peer_ref_t **)realloc(active_peers,
+                                                                (max_active_peers + 16) * sizeof(ompi_crcp_bkmrk_pml_peer_ref_t *));
+        if( NULL == tmp_peers ) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        active_peers = tmp_peers;
+        max_active_peers += 16;
+    }
+
+    active_peers[num_active_peers++] = peer_ref;
+    peer_ref->active = true;
+
+    return OMPI_SUCCESS;
+}
+
+static int peer_ref_vpid_cmp(const void *a, const void *b)
+{
+    const ompi_crcp_bkmrk_pml_peer_ref_t *peer_a = *(ompi_crcp_bkmrk_pml_peer_ref_t * const *)a;
+    const ompi_crcp_bkmrk_pml_peer_ref_t *peer_b = *(ompi_crcp_bkmrk_pml_peer_ref_t * const *)b;
+
+    if( peer_a->proc_name.vpid < peer_b->proc_name.vpid ) {
+        return -1;
+    }
+    return (peer_a->proc_name.vpid > peer_b->proc_name.vpid) ? 1 : 0;
+}
+
 static int find_peer_in_comm(struct ompi_communicator_t* comm, int proc_idx,
                              ompi_crcp_bkmrk_pml_peer_ref_t **peer_ref)
 {
@@ -4327,6 +4466,8 @@ static int ft_event_finalize_exchange(void)
 
         peer_ref->ack_required = false;
 
+        peer_ref->active = false;
+
         /* Clear send_list */
         for(rm_item  = opal_list_get_last(&peer_ref->send_list);
             rm_item != opal_list_get_begin(&peer_ref->send_list);
@@ -4415,51 +4556,236 @@ static int ft_event_finalize_exchange(void)
         }
     }
 
+    num_active_peers = 0;
+
     return exit_status;
 }
 
 static int ft_event_exchange_bookmarks(void)
 {
-    int peer_idx  = 0;
-    int my_idx    = OMPI_PROC_MY_NAME->vpid;
-    int iter      = 0;
-    int num_peers = 0;
-    
+    ompi_crcp_bkmrk_pml_peer_ref_t *peer_ref;
+    int32_t *counts = NULL;
+    int num_peers, num_bookmarks = 0;
+    int i, ret, exit_status = OMPI_SUCCESS;
+
     num_peers = opal_list_get_size(&ompi_crcp_bkmrk_pml_peer_refs);
 
-    for( peer_idx = (num_peers - my_idx - 1), iter = 0;
-         iter < num_peers;
-         peer_idx = (peer_idx + 1) % num_peers, ++iter) 
-        {
-            if(my_idx > peer_idx) {
-                /* Send our bookmark status */
-                send_bookmarks(peer_idx);
-                /* Recv peer bookmark status */
-                recv_bookmarks(peer_idx);
-            }
-            else if(my_idx < peer_idx) {
-                /* Recv peer bookmark status */
-                recv_bookmarks(peer_idx);
-                /* Send our bookmark status */
-                send_bookmarks(peer_idx);
-            }
+    /*
+     * A peer we did not exchange any message with since the last
+     * checkpoint has nothing to compare with our bookmark, which is all
+     * zeros: only the active peers get one.  The peers that do not send
+     * us one leave our matched counters at zero.
+     * Post the receive first, some peers may already be there.
+     */
+    if( OMPI_SUCCESS != (ret = recv_bookmarks()) ) {
+        return ret;
+    }
+
+    if( NULL == (counts = (int32_t *)calloc(num_peers, sizeof(int32_t))) ) {
+        exit_status = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+    for(i = 0; i < num_active_peers; ++i) {
+        peer_ref = active_peers[i];
+        if( peer_ref->proc_name.jobid != OMPI_PROC_MY_NAME->jobid ||
+            peer_ref->proc_name.vpid  == OMPI_PROC_MY_NAME->vpid ||
+            (int)peer_ref->proc_name.vpid >= num_peers ) {
+            continue;
+        }
+        counts[peer_ref->proc_name.vpid] = 1;
+    }
+
+    /* How many peers have us in their active set */
+    START_TIMER(CRCP_TIMER_CKPT_EX_PEER_R);
+    ret = exchange_bookmark_counts(counts, num_peers, &num_bookmarks);
+    END_TIMER(CRCP_TIMER_CKPT_EX_PEER_R);
+    if( OMPI_SUCCESS != ret ) {
+        opal_output(mca_crcp_bkmrk_component.super.output_handle,
+                    "crcp:bkmrk: exchange_bookmarks: Failed to count the bookmarks: Return %d\n",
+                    ret);
+        exit_status = ret;
+        goto cleanup;
+    }
+    total_recv_bookmarks += num_bookmarks;
+
+    for(i = 0; i < num_peers; ++i) {
+        if( 0 == counts[i] || NULL == peer_refs_by_vpid[i] ) {
+            continue;
         }
+        if( OMPI_SUCCESS != (ret = send_bookmarks(peer_refs_by_vpid[i])) ) {
+            exit_status = ret;
+            goto cleanup;
+        }
+    }
 
     /* Wait for all bookmarks to arrive */
     START_TIMER(CRCP_TIMER_CKPT_EX_WAIT);
     while( total_recv_bookmarks > 0 ) {
         opal_event_loop(opal_event_base, OPAL_EVLOOP_NONBLOCK);
     }
-    total_recv_bookmarks = 0;
     END_TIMER(CRCP_TIMER_CKPT_EX_WAIT);
 
-    return OMPI_SUCCESS;
+ cleanup:
+    ompi_rte_recv_cancel(OMPI_NAME_WILDCARD, OMPI_CRCP_COORD_BOOKMARK_SPARSE_TAG);
+    total_recv_bookmarks = 0;
+
+    if( NULL != counts ) {
+        free(counts);
+    }
+
+    return exit_status;
+}
+
+/*
+ * Sum the counts of all the processes, leaving each process with its
+ * own entry: a recursive halving reduce-scatter over the vpids, so that
+ * every process sends log(P) messages instead of one per peer.  The
+ * processes past the largest power of two fold their counts into a
+ * partner first and get their entry back from it at the end.  The
+ * lowest vpid of a pair always sends first, as in the bookmark checks.
+ */
+static int exchange_counts_sendrecv(int peer_idx, int32_t *sbuf, int32_t scount,
+                                    int32_t *rbuf, int32_t rcount)
+{
+    ompi_process_name_t peer_name;
+    opal_buffer_t *buffer = NULL;
+    int32_t n;
+    int step, ret, exit_status = OMPI_SUCCESS;
+
+    peer_name.jobid = OMPI_PROC_MY_NAME->jobid;
+    peer_name.vpid  = peer_idx;
+
+    for(step = 0; step < 2; ++step) {
+        if( (0 == step) == ((int)OMPI_PROC_MY_NAME->vpid < peer_idx) ) {
+            if( 0 == scount ) {
+                continue;
+            }
+            if (NULL == (buffer = OBJ_NEW(opal_buffer_t))) {
+                exit_status = OMPI_ERROR;
+                goto cleanup;
+            }
+            PACK_BUFFER(buffer, *sbuf, scount, OPAL_INT32,
+                        "crcp:bkmrk: exchange_bookmark_counts: Unable to pack counts");
+            if ( 0 > (ret = ompi_rte_send_buffer(&peer_name, buffer, OMPI_CRCP_COORD_BOOKMARK_COUNT_TAG, 0)) ) {
+                exit_status = ret;
+                goto cleanup;
+            }
+        } else {
+            if( 0 == rcount ) {
+                continue;
+            }
+            if (NULL == (buffer = OBJ_NEW(opal_buffer_t))) {
+                exit_status = OMPI_ERROR;
+                goto cleanup;
+            }
+            if ( 0 > (ret = ompi_rte_recv_buffer(&peer_name, buffer, OMPI_CRCP_COORD_BOOKMARK_COUNT_TAG, 0)) ) {
+                exit_status = ret;
+                goto cleanup;
+            }
+            n = rcount;
+            if (OPAL_SUCCESS != (ret = opal_dss.unpack(buffer, rbuf, &n, OPAL_INT32)) ) {
+                opal_output(mca_crcp_bkmrk_component.super.output_handle,
+                            "crcp:bkmrk: exchange_bookmark_counts: Unable to unpack counts (Return %d)", ret);
+                exit_status = ret;
+                goto cleanup;
+            }
+        }
+        OBJ_RELEASE(buffer);
+        buffer = NULL;
+    }
+
+ cleanup:
+    if( NULL != buffer ) {
+        OBJ_RELEASE(buffer);
+    }
+
+    return exit_status;
+}
+
+static int exchange_bookmark_counts(int32_t *counts, int num_peers, int *num_bookmarks)
+{
+    int my_idx = OMPI_PROC_MY_NAME->vpid;
+    int32_t *work = NULL, *tmp = NULL, mine = 0;
+    int pof2, rem, mask, lo, hi, mid, i;
+    int ret, exit_status = OMPI_SUCCESS;
+
+    for(pof2 = 1; pof2 * 2 <= num_peers; pof2 *= 2) ;
+    rem = num_peers - pof2;
+
+    if( my_idx >= pof2 ) {
+        if( OMPI_SUCCESS != (ret = exchange_counts_sendrecv(my_idx - pof2, counts, num_peers, NULL, 0)) ) {
+            return ret;
+        }
+        ret = exchange_counts_sendrecv(my_idx - pof2, NULL, 0, &mine, 1);
+        *num_bookmarks = mine;
+        return ret;
+    }
+
+    /* Slot 2i counts for vpid i, slot 2i+1 for vpid i + pof2 */
+    work = (int32_t *)calloc(2 * pof2, sizeof(int32_t));
+    tmp  = (int32_t *)malloc((num_peers > pof2 ? num_peers : pof2) * sizeof(int32_t));
+    if( NULL == work || NULL == tmp ) {
+        exit_status = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+    for(i = 0; i < num_peers; ++i) {
+        work[i < pof2 ? 2 * i : 2 * (i - pof2) + 1] = counts[i];
+    }
+
+    if( my_idx < rem ) {
+        if( OMPI_SUCCESS != (ret = exchange_counts_sendrecv(my_idx + pof2, NULL, 0, tmp, num_peers)) ) {
+            exit_status = ret;
+            goto cleanup;
+        }
+        for(i = 0; i < num_peers; ++i) {
+            work[i < pof2 ? 2 * i : 2 * (i - pof2) + 1] += tmp[i];
+        }
+    }
+
+    lo = 0;
+    hi = pof2;
+    for(mask = pof2 / 2; mask > 0; mask /= 2) {
+        mid = lo + mask;
+        if( my_idx & mask ) {
+            ret = exchange_counts_sendrecv(my_idx ^ mask, work + 2 * lo, 2 * mask,
+                                           tmp, 2 * mask);
+            lo = mid;
+        } else {
+            ret = exchange_counts_sendrecv(my_idx ^ mask, work + 2 * mid, 2 * mask,
+                                           tmp, 2 * mask);
+            hi = mid;
+        }
+        if( OMPI_SUCCESS != ret ) {
+            exit_status = ret;
+            goto cleanup;
+        }
+        for(i = 0; i < 2 * mask; ++i) {
+            work[2 * lo + i] += tmp[i];
+        }
+    }
+    assert(lo == my_idx && hi == my_idx + 1);
+
+    *num_bookmarks = work[2 * my_idx];
+
+    if( my_idx < rem ) {
+        exit_status = exchange_counts_sendrecv(my_idx + pof2, &work[2 * my_idx + 1], 1, NULL, 0);
+    }
+
+ cleanup:
+    if( NULL != work ) {
+        free(work);
+    }
+    if( NULL != tmp ) {
+        free(tmp);
+    }
+
+    return exit_status;
 }
 
 static int ft_event_check_bookmarks(void)
 {
     opal_list_item_t* item = NULL;
-    int ret;
+    int i, ret;
     int p_n_to_p_m   = 0;
     int p_n_from_p_m = 0;
 
@@ -4499,15 +4825,19 @@ static int ft_event_check_bookmarks(void)
     }
 
     /*
-     * For each peer:
+     * For each active peer:
      * - Check bookmarks
      * - if mis-matched then post outstanding recvs.
+     * The others sent and received nothing on either side.  Go in vpid
+     * order, like every other process, so the pairwise exchanges of
+     * message details below cannot wait on each other in a cycle.
      */
-    for(item  = opal_list_get_first(&ompi_crcp_bkmrk_pml_peer_refs);
-        item != opal_list_get_end(&ompi_crcp_bkmrk_pml_peer_refs);
-        item  = opal_list_get_next(item) ) {
+    qsort(active_peers, num_active_peers, sizeof(ompi_crcp_bkmrk_pml_peer_ref_t *),
+          peer_ref_vpid_cmp);
+
+    for(i = 0; i < num_active_peers; ++i) {
         ompi_crcp_bkmrk_pml_peer_ref_t *peer_ref;
-        peer_ref = (ompi_crcp_bkmrk_pml_peer_ref_t*)item;
+        peer_ref = active_peers[i];
 
         if( OPAL_EQUAL == ompi_rte_compare_name_fields(OMPI_RTE_CMP_ALL,
                                                         (OMPI_PROC_MY_NAME),
@@ -5255,28 +5585,15 @@ static int wait_quiesce_drain_ack(void)
 }
 
 /* Paired with recv_bookmarks */
-static int send_bookmarks(int peer_idx)
+static int send_bookmarks(ompi_crcp_bkmrk_pml_peer_ref_t *peer_ref)
 {
-    ompi_crcp_bkmrk_pml_peer_ref_t *peer_ref;
     ompi_process_name_t peer_name;
     opal_buffer_t *buffer = NULL;
     int exit_status = OMPI_SUCCESS;
     int ret;
 
     START_TIMER(CRCP_TIMER_CKPT_EX_PEER_S);
-    /*
-     * Find the peer structure for this peer
-     */
-    peer_name.jobid  = OMPI_PROC_MY_NAME->jobid;
-    peer_name.vpid   = peer_idx;
-
-    if( NULL == (peer_ref = find_peer(peer_name))) {
-        opal_output(mca_crcp_bkmrk_component.super.output_handle,
-                    "crcp:bkmrk: send_bookmarks: Error: Could not find peer indexed %d\n",
-                    peer_idx);
-        exit_status = OMPI_ERROR;
-        goto cleanup;
-    }
+    peer_name = peer_ref->proc_name;
 
     OPAL_OUTPUT_VERBOSE((15, mca_crcp_bkmrk_component.super.output_handle,
                          "crcp:bkmrk: %s --> %s Sending bookmark  (S[%6d] R[%6d])\n",
@@ -5298,7 +5615,7 @@ static int send_bookmarks(int peer_idx)
     PACK_BUFFER(buffer, (peer_ref->total_msgs_recvd),     1, OPAL_UINT32,
                 "crcp:bkmrk: send_bookmarks: Unable to pack total_msgs_recvd");
 
-    if ( 0 > ( ret = ompi_rte_send_buffer(&peer_name, buffer, OMPI_CRCP_COORD_BOOKMARK_TAG, 0)) ) {
+    if ( 0 > ( ret = ompi_rte_send_buffer(&peer_name, buffer, OMPI_CRCP_COORD_BOOKMARK_SPARSE_TAG, 0)) ) {
         opal_output(mca_crcp_bkmrk_component.super.output_handle,
                     "crcp:bkmrk: send_bookmarks: Failed to send bookmark to peer %s: Return %d\n",
                     OMPI_NAME_PRINT(&peer_name),
@@ -5313,44 +5630,28 @@ static int send_bookmarks(int peer_idx)
     }
 
     END_TIMER(CRCP_TIMER_CKPT_EX_PEER_S);
-    DISPLAY_INDV_TIMER(CRCP_TIMER_CKPT_EX_PEER_S, peer_idx, 1);
+    DISPLAY_INDV_TIMER(CRCP_TIMER_CKPT_EX_PEER_S, peer_name.vpid, 1);
 
     return exit_status;
 }
 
-/* Paired with send_bookmarks */
-static int recv_bookmarks(int peer_idx)
+/* Paired with send_bookmarks, until the exchange is over */
+static int recv_bookmarks(void)
 {
-    ompi_process_name_t peer_name;
-    int exit_status = OMPI_SUCCESS;
     int ret;
 
-    START_TIMER(CRCP_TIMER_CKPT_EX_PEER_R);
-
-    peer_name.jobid  = OMPI_PROC_MY_NAME->jobid;
-    peer_name.vpid   = peer_idx;
-
-    if ( 0 > (ret = ompi_rte_recv_buffer_nb(&peer_name,
-                                            OMPI_CRCP_COORD_BOOKMARK_TAG,
-                                            0,
+    if ( 0 > (ret = ompi_rte_recv_buffer_nb(OMPI_NAME_WILDCARD,
+                                            OMPI_CRCP_COORD_BOOKMARK_SPARSE_TAG,
+                                            OMPI_RML_PERSISTENT,
                                             recv_bookmarks_cbfunc,
                                             NULL) ) ) {
         opal_output(mca_crcp_bkmrk_component.super.output_handle,
-                    "crcp:bkmrk: recv_bookmarks: Failed to post receive bookmark from peer %s: Return %d\n",
-                    OMPI_NAME_PRINT(&peer_name),
+                    "crcp:bkmrk: recv_bookmarks: Failed to post receive bookmark: Return %d\n",
                     ret);
-        exit_status = ret;
-        goto cleanup;
+        return ret;
     }
 
-    ++total_recv_bookmarks;
-
- cleanup:
-    END_TIMER(CRCP_TIMER_CKPT_EX_PEER_R);
-    /* JJH Doesn't make much sense to print this. The real bottleneck is always the send_bookmarks() */
-    /*DISPLAY_INDV_TIMER(CRCP_TIMER_CKPT_EX_PEER_R, peer_idx, 1);*/
-
-    return exit_status;
+    return OMPI_SUCCESS;
 }
 
 static void recv_bookmarks_cbfunc(int status,
@@ -5385,6 +5686,9 @@ static void recv_bookmarks_cbfunc(int status,
                   "crcp:bkmrk: recv_bookmarks: Unable to unpack total_msgs_recvd");
     peer_ref->matched_msgs_recvd = tmp_int;
 
+    /* The peer knows of messages we may not: check them */
+    PEER_REF_ACTIVATE(peer_ref);
+
     OPAL_OUTPUT_VERBOSE((15, mca_crcp_bkmrk_component.super.output_handle,
                          "crcp:bkmrk: %s <-- %s Received bookmark (S[%6d] R[%6d]) vs. (S[%6d] R[%6d])\n",
                          OMPI_NAME_PRINT(OMPI_PROC_MY_NAME),
@@ -424,6 +424,9 @@ BEGIN_C_DECLS
 
         /** If peer is expecting an ACK after draining the messages */
         bool ack_required;
+
+        /** If we exchanged messages with the peer since the last checkpoint */
+        bool active;
     };
     typedef struct ompi_crcp_bkmrk_pml_peer_ref_t ompi_crcp_bkmrk_pml_peer_ref_t;
     
@@ -196,7 +196,9 @@ static int connect_accept ( ompi_communicator_t *comm, int root,
              * multiple threads can do simultaneous connect/accept, 
              * and the same processes can be engaged in multiple
              * connect/accepts at the same time. Only one side
-             * needs to do this, so have it be send_first
+             * needs to do this, so have it be send_first. The id
+             * then travels with our list of processes, so that the
+             * two roots need a single exchange
              */
             nbuf = OBJ_NEW(opal_buffer_t);
             if (NULL == nbuf) {
@@ -218,31 +220,32 @@ static int connect_accept ( ompi_communicator_t *comm, int root,
                 return OMPI_ERROR;
             }
             OBJ_RELEASE(cabuf);
-            /* send it to my peer on the other side */
-            nbuf = OBJ_NEW(opal_buffer_t);
-            if (NULL == nbuf) {
-                return OMPI_ERROR;
-            }
-            if (ORTE_SUCCESS != (rc = opal_dss.pack(nbuf, &id, 1, ORTE_GRPCOMM_COLL_ID_T))) {
-                ORTE_ERROR_LOG(rc);
-                goto exit;
-            }
-            rc = orte_rml.send_buffer_nb(&port, nbuf, tag, 0, rml_cbfunc, NULL);
+            cabuf = NULL;
         } else {
-            /* wait to recv the collective id */
+            opal_buffer_t idbuf;
+
+            /* the list of processes of the other side comes first, and
+             * starts with the collective id
+             */
+            OPAL_OUTPUT_VERBOSE((3, ompi_dpm_base_framework.framework_output,
+                                 "%s dpm:orte:connect_accept recving first",
+                                 ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
             waiting_for_recv = true;
             cabuf = OBJ_NEW(opal_buffer_t);
             rc = orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, tag,
                                          ORTE_RML_NON_PERSISTENT, recv_cb, NULL);
             /* wait for response */
             ORTE_WAIT_FOR_COMPLETION(waiting_for_recv);
+            OBJ_CONSTRUCT(&idbuf, opal_buffer_t);
             i=1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(cabuf, &id, &i, ORTE_GRPCOMM_COLL_ID_T))) {
+            if (OPAL_SUCCESS != (rc = opal_dss.copy_payload(&idbuf, cabuf)) ||
+                OPAL_SUCCESS != (rc = opal_dss.unpack(&idbuf, &id, &i, ORTE_GRPCOMM_COLL_ID_T))) {
                 ORTE_ERROR_LOG(rc);
+                OBJ_DESTRUCT(&idbuf);
                 OBJ_RELEASE(cabuf);
                 return OMPI_ERROR;
             }
-            OBJ_RELEASE(cabuf);
+            OBJ_DESTRUCT(&idbuf);
         }
 
         /* Generate the message buffer containing the number of processes and the list of
@@ -296,18 +299,13 @@ static int connect_accept ( ompi_communicator_t *comm, int root,
             goto exit;
         }
 
-        if (NULL != cabuf) {
-            OBJ_RELEASE(cabuf);
-        }
-        
-        cabuf = OBJ_NEW(opal_buffer_t);
-        if (NULL == cabuf ) {
-            rc = OMPI_ERROR;
-            goto exit;
-        }
-
         /* Exchange the number and the list of processes in the groups */
         if ( send_first ) {
+            cabuf = OBJ_NEW(opal_buffer_t);
+            if (NULL == cabuf ) {
+                rc = OMPI_ERROR;
+                goto exit;
+            }
             OPAL_OUTPUT_VERBOSE((3, ompi_dpm_base_framework.framework_output,
                                  "%s dpm:orte:connect_accept sending first to %s",
                                  ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
@@ -328,16 +326,7 @@ static int connect_accept ( ompi_communicator_t *comm, int root,
                                  ORTE_NAME_PRINT(&carport)));
             
         } else {
-            OPAL_OUTPUT_VERBOSE((3, ompi_dpm_base_framework.framework_output,
-                                 "%s dpm:orte:connect_accept recving first",
-                                 ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
-            /* setup to recv */
-            waiting_for_recv = true;
-            rc = orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, tag,
-                                         ORTE_RML_NON_PERSISTENT, recv_cb, NULL);
-            /* wait for response */
-            ORTE_WAIT_FOR_COMPLETION(waiting_for_recv);
-            /* now send our info */
+            /* we already have theirs, now send our info */
             OPAL_OUTPUT_VERBOSE((3, ompi_dpm_base_framework.framework_output,
                                  "%s dpm:orte:connect_accept sending info to %s",
                                  ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
@@ -345,7 +334,10 @@ static int connect_accept ( ompi_communicator_t *comm, int root,
             rc = orte_rml.send_buffer(&carport, nbuf, tag, 0);
         }
 
-        if (OPAL_SUCCESS != (rc = opal_dss.unload(cabuf, &rnamebuf, &rnamebuflen))) {
+        rc = opal_dss.unload(cabuf, &rnamebuf, &rnamebuflen);
+        OBJ_RELEASE(cabuf);
+        cabuf = NULL;
+        if (OPAL_SUCCESS != rc) {
             ORTE_ERROR_LOG(rc);
             goto exit;
         }
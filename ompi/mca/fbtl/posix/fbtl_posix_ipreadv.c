@@ -26,10 +26,19 @@
 #include "ompi/mca/fbtl/fbtl.h"
 
 size_t 
-mca_fbtl_posix_ipreadv (mca_io_ompio_file_t *file,
+mca_fbtl_posix_ipreadv (mca_io_ompio_file_t *fh,
                         int *sorted,
                         ompi_request_t **request)
 {
-    printf ("POSIX IPREADV\n");
+    size_t ret;
+
+    /* No asynchronous read here: the transfer is done right away and an
+     * already completed request is returned, so that the callers can
+     * use the nonblocking interface whatever the fbtl. */
+    ret = mca_fbtl_posix_preadv (fh, sorted);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    *request = &ompi_request_empty;
     return OMPI_SUCCESS;
 }
@@ -34,6 +34,8 @@ mca_fbtl_posix_preadv (mca_io_ompio_file_t *fh,
     struct iovec *iov = NULL;
     int iov_count = 0;
     OMPI_MPI_OFFSET_TYPE iov_offset = 0;
+    int ops = 0;
+    double start = MPI_Wtime ();
 #if 0
     int k;
     int merge = 0;
@@ -102,6 +104,7 @@ mca_fbtl_posix_preadv (mca_io_ompio_file_t *fh,
             }
             else {
                 iov_count = 0;
+                ops ++;
             }
         }
     }
@@ -148,6 +151,7 @@ mca_fbtl_posix_preadv (mca_io_ompio_file_t *fh,
             }
             else {
                 iov_count = 0;
+                ops ++;
             }
         }
     }
@@ -263,5 +267,6 @@ mca_fbtl_posix_preadv (mca_io_ompio_file_t *fh,
         }
     }
 #endif
+    ompi_io_ompio_record_fbtl (fh, ops, MPI_Wtime () - start);
     return OMPI_SUCCESS;
 }
@@ -36,6 +36,8 @@ mca_fbtl_posix_pwritev (mca_io_ompio_file_t *fh,
     struct iovec *iov = NULL;
     int iov_count = 0;
     OMPI_MPI_OFFSET_TYPE iov_offset = 0;
+    int ops = 0;
+    double start = MPI_Wtime ();
 #if 0
     int merge = 0;
     size_t k;
@@ -105,6 +107,7 @@ mca_fbtl_posix_pwritev (mca_io_ompio_file_t *fh,
                 return OMPI_ERROR;
             }
             iov_count = 0;
+            ops ++;
         }
     }
 
@@ -161,6 +164,7 @@ mca_fbtl_posix_pwritev (mca_io_ompio_file_t *fh,
                 return OMPI_ERROR;
             }
             iov_count = 0;
+            ops ++;
         }
     }
 
@@ -294,5 +298,6 @@ mca_fbtl_posix_pwritev (mca_io_ompio_file_t *fh,
         }
     }
 #endif
+    ompi_io_ompio_record_fbtl (fh, ops, MPI_Wtime () - start);
     return OMPI_SUCCESS;
 }
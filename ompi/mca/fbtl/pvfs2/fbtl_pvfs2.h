@@ -25,6 +25,7 @@
 #include "ompi/mca/fbtl/fbtl.h"
 #include "ompi/mca/io/ompio/io_ompio.h"
 #include "ompi/mca/fs/pvfs2/fs_pvfs2.h"
+#include "ompi/request/request.h"
 #include "pvfs2.h"
 #include "pvfs2-compat.h"
 
@@ -38,9 +39,37 @@
 #endif
 */
 extern int mca_fbtl_pvfs2_priority;
+extern int mca_fbtl_pvfs2_list_count;
 
 BEGIN_C_DECLS
 
+struct mca_fbtl_pvfs2_request_t;
+
+/**
+ * One list I/O: a run of at most list_count entries of f_io_array,
+ * described by an indexed memory request and an indexed file request.
+ */
+typedef struct mca_fbtl_pvfs2_op_t {
+    struct mca_fbtl_pvfs2_request_t *req;
+    PVFS_Request                     mem_req;
+    PVFS_Request                     file_req;
+    PVFS_sysresp_io                  resp;
+    PVFS_sys_op_id                   op_id;
+    bool                             done;
+} mca_fbtl_pvfs2_op_t;
+
+typedef struct mca_fbtl_pvfs2_request_t {
+    ompi_request_t        super;
+    mca_fbtl_pvfs2_op_t  *ops;
+    int                   nops;
+    int                   pending;     /**< list I/Os posted and not completed */
+    int                   error;
+    size_t                bytes;
+    bool                  user_freed;  /**< freed by the user before completion */
+} mca_fbtl_pvfs2_request_t;
+
+OBJ_CLASS_DECLARATION(mca_fbtl_pvfs2_request_t);
+
 int mca_fbtl_pvfs2_component_init_query(bool enable_progress_threads,
                                         bool enable_mpi_threads);
 struct mca_fbtl_base_module_1_0_0_t *
@@ -50,6 +79,13 @@ int mca_fbtl_pvfs2_component_file_unquery (mca_io_ompio_file_t *file);
 int mca_fbtl_pvfs2_module_init (mca_io_ompio_file_t *file);
 int mca_fbtl_pvfs2_module_finalize (mca_io_ompio_file_t *file);
 
+/* list I/O, in fbtl_pvfs2_list_io.c */
+int mca_fbtl_pvfs2_list_io (mca_io_ompio_file_t *fh, int *sorted, bool write,
+                            size_t *bytes);
+int mca_fbtl_pvfs2_list_start (mca_io_ompio_file_t *fh, int *sorted, bool write,
+                               mca_fbtl_pvfs2_request_t **request);
+void mca_fbtl_pvfs2_list_fini (void);
+
 OMPI_MODULE_DECLSPEC extern mca_fbtl_base_component_2_0_0_t mca_fbtl_pvfs2_component;
 /*
  * ******************************************************************
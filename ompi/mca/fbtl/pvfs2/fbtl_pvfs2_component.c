@@ -34,6 +34,10 @@ const char *mca_fbtl_pvfs2_component_version_string =
   "OMPI/MPI pvfs2 FBTL MCA component version " OMPI_VERSION;
 
 int mca_fbtl_pvfs2_priority = 0;
+int mca_fbtl_pvfs2_list_count = 64;
+
+static int pvfs2_register(void);
+static int pvfs2_close(void);
 
 /*
  * Instantiate the public struct with all of our public information
@@ -53,7 +57,9 @@ mca_fbtl_base_component_2_0_0_t mca_fbtl_pvfs2_component = {
         OMPI_MINOR_VERSION,
         OMPI_RELEASE_VERSION,
         NULL,
-        NULL
+        pvfs2_close,
+        NULL,
+        pvfs2_register
     },
     {
         /* This component is checkpointable */
@@ -63,3 +69,32 @@ mca_fbtl_base_component_2_0_0_t mca_fbtl_pvfs2_component = {
     mca_fbtl_pvfs2_component_file_query,      /* get priority and actions */
     mca_fbtl_pvfs2_component_file_unquery     /* undo what was done by previous function */
 };
+
+
+static int
+pvfs2_register(void)
+{
+    mca_fbtl_pvfs2_priority = 0;
+    (void) mca_base_component_var_register(&mca_fbtl_pvfs2_component.fbtlm_version,
+                                           "priority", "Priority of the pvfs2 fbtl component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_fbtl_pvfs2_priority);
+    mca_fbtl_pvfs2_list_count = 64;
+    (void) mca_base_component_var_register(&mca_fbtl_pvfs2_component.fbtlm_version,
+                                           "list_count",
+                                           "Maximum number of entries of the I/O array described by a "
+                                           "single list I/O request (0: no limit)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_fbtl_pvfs2_list_count);
+
+    return OMPI_SUCCESS;
+}
+
+static int
+pvfs2_close(void)
+{
+    mca_fbtl_pvfs2_list_fini();
+    return OMPI_SUCCESS;
+}
@@ -26,9 +26,20 @@
 #include "ompi/mca/fbtl/fbtl.h"
 
 size_t 
-mca_fbtl_pvfs2_ipreadv (mca_io_ompio_file_t *file,
+mca_fbtl_pvfs2_ipreadv (mca_io_ompio_file_t *fh,
                         int *sorted, ompi_request_t **request)
 {
-    printf ("PVFS2 IPREADV\n");
+    mca_fbtl_pvfs2_request_t *req;
+    int ret;
+
+    if (NULL == fh->f_io_array) {
+        return OMPI_ERROR;
+    }
+
+    ret = mca_fbtl_pvfs2_list_start (fh, sorted, false, &req);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    *request = &req->super;
     return OMPI_SUCCESS;
 }
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_pvfs2.h"
+
+#include <stdlib.h>
+
+#include "opal/runtime/opal_progress.h"
+#include "opal/util/output.h"
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/base/base.h"
+
+/*
+ * The entries of f_io_array are transferred with PVFS2 list I/O: up to
+ * list_count of them are described by an indexed memory request (the
+ * user buffers, relative to PVFS_BOTTOM) and an indexed file request
+ * (their offsets), and moved by a single read or write. The non
+ * blocking calls post all the list I/Os of the array at once, their
+ * completions are tested from the progress loop.
+ */
+
+static opal_list_t pvfs2_active;
+static opal_mutex_t pvfs2_lock;
+static bool pvfs2_active_ready = false;
+
+static void mca_fbtl_pvfs2_request_construct (mca_fbtl_pvfs2_request_t *req)
+{
+    req->super.req_type = OMPI_REQUEST_IO;
+    req->super.req_free = NULL;
+    req->super.req_cancel = NULL;
+    req->ops = NULL;
+    req->nops = 0;
+}
+
+static void mca_fbtl_pvfs2_request_destruct (mca_fbtl_pvfs2_request_t *req)
+{
+    if (NULL != req->ops) {
+        free (req->ops);
+    }
+}
+
+OBJ_CLASS_INSTANCE(mca_fbtl_pvfs2_request_t, ompi_request_t,
+                   mca_fbtl_pvfs2_request_construct,
+                   mca_fbtl_pvfs2_request_destruct);
+
+static int pvfs2_progress (void);
+
+/* Describe count entries of f_io_array, starting at first in the order
+ * given by sorted, as a memory and a file request. */
+static int pvfs2_list_requests (mca_io_ompio_file_t *fh, int *sorted,
+                                int first, int count,
+                                PVFS_Request *mem_req, PVFS_Request *file_req)
+{
+    int32_t *lengths;
+    PVFS_size *mem_disps, *file_disps;
+    int i, idx, ret;
+
+    lengths = (int32_t *) malloc (count * sizeof(int32_t));
+    mem_disps = (PVFS_size *) malloc (count * sizeof(PVFS_size));
+    file_disps = (PVFS_size *) malloc (count * sizeof(PVFS_size));
+    if (NULL == lengths || NULL == mem_disps || NULL == file_disps) {
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+        goto exit;
+    }
+
+    for (i = 0 ; i < count ; i++) {
+        idx = (NULL == sorted) ? first + i : sorted[first + i];
+        lengths[i] = (int32_t) fh->f_io_array[idx].length;
+        mem_disps[i] = (PVFS_size) (intptr_t) fh->f_io_array[idx].memory_address;
+        file_disps[i] = (PVFS_size) (intptr_t) fh->f_io_array[idx].offset;
+    }
+
+    ret = PVFS_Request_hindexed (count, lengths, mem_disps, PVFS_BYTE, mem_req);
+    if (0 != ret) {
+        perror("PVFS_Request_hindexed() error");
+        ret = OMPI_ERROR;
+        goto exit;
+    }
+    ret = PVFS_Request_hindexed (count, lengths, file_disps, PVFS_BYTE, file_req);
+    if (0 != ret) {
+        perror("PVFS_Request_hindexed() error");
+        PVFS_Request_free (mem_req);
+        ret = OMPI_ERROR;
+        goto exit;
+    }
+    ret = OMPI_SUCCESS;
+
+ exit:
+    if (NULL != lengths) {
+        free (lengths);
+    }
+    if (NULL != mem_disps) {
+        free (mem_disps);
+    }
+    if (NULL != file_disps) {
+        free (file_disps);
+    }
+    return ret;
+}
+
+static int pvfs2_list_size (mca_io_ompio_file_t *fh, int first)
+{
+    int count = fh->f_num_of_io_entries - first;
+
+    if (mca_fbtl_pvfs2_list_count > 0 && count > mca_fbtl_pvfs2_list_count) {
+        count = mca_fbtl_pvfs2_list_count;
+    }
+    return count;
+}
+
+int mca_fbtl_pvfs2_list_io (mca_io_ompio_file_t *fh, int *sorted, bool write,
+                            size_t *bytes)
+{
+    mca_fs_pvfs2 *pvfs2_fs = (mca_fs_pvfs2 *) fh->f_fs_ptr;
+    PVFS_Request mem_req, file_req;
+    PVFS_sysresp_io resp_io;
+    int first, count, ret;
+
+    *bytes = 0;
+    for (first = 0 ; first < fh->f_num_of_io_entries ; first += count) {
+        count = pvfs2_list_size (fh, first);
+        ret = pvfs2_list_requests (fh, sorted, first, count, &mem_req, &file_req);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
+
+        if (write) {
+            ret = PVFS_sys_write (pvfs2_fs->object_ref, file_req, 0,
+                                  PVFS_BOTTOM, mem_req,
+                                  &(pvfs2_fs->credentials), &resp_io);
+        } else {
+            ret = PVFS_sys_read (pvfs2_fs->object_ref, file_req, 0,
+                                 PVFS_BOTTOM, mem_req,
+                                 &(pvfs2_fs->credentials), &resp_io);
+        }
+        PVFS_Request_free (&mem_req);
+        PVFS_Request_free (&file_req);
+        if (0 != ret) {
+            perror(write ? "PVFS_sys_write() error" : "PVFS_sys_read() error");
+            return OMPI_ERROR;
+        }
+        *bytes += resp_io.total_completed;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static void pvfs2_request_release (mca_fbtl_pvfs2_request_t *req)
+{
+    OMPI_REQUEST_FINI(&req->super);
+    OBJ_RELEASE(req);
+}
+
+static int pvfs2_request_free (ompi_request_t **request)
+{
+    mca_fbtl_pvfs2_request_t *req = (mca_fbtl_pvfs2_request_t *) *request;
+
+    OPAL_THREAD_LOCK(&pvfs2_lock);
+    if (req->super.req_complete) {
+        pvfs2_request_release (req);
+    } else {
+        /* released when the last list I/O completes */
+        req->user_freed = true;
+    }
+    OPAL_THREAD_UNLOCK(&pvfs2_lock);
+
+    *request = MPI_REQUEST_NULL;
+    return OMPI_SUCCESS;
+}
+
+/* Called with the lock held */
+static void pvfs2_request_complete (mca_fbtl_pvfs2_request_t *req)
+{
+    opal_list_remove_item (&pvfs2_active, (opal_list_item_t *) req);
+
+    req->super.req_status.MPI_ERROR = (0 == req->error) ? OMPI_SUCCESS : OMPI_ERROR;
+    req->super.req_status._ucount = req->bytes;
+
+    if (req->user_freed) {
+        req->super.req_complete = true;
+        pvfs2_request_release (req);
+        return;
+    }
+    OPAL_THREAD_LOCK(&ompi_request_lock);
+    ompi_request_complete (&req->super, true);
+    OPAL_THREAD_UNLOCK(&ompi_request_lock);
+}
+
+/* Test the list I/Os of a request still in flight. Called with the lock
+ * held. Returns the number of list I/Os completed. */
+static int pvfs2_request_test (mca_fbtl_pvfs2_request_t *req)
+{
+    PVFS_sys_op_id op_ids[req->pending];
+    void *user_ptrs[req->pending];
+    int errors[req->pending];
+    mca_fbtl_pvfs2_op_t *op;
+    int i, n = 0, count;
+
+    for (i = 0 ; i < req->nops ; i++) {
+        if (!req->ops[i].done) {
+            op_ids[n++] = req->ops[i].op_id;
+        }
+    }
+    count = n;
+    if (0 != PVFS_sys_testsome (op_ids, &count, user_ptrs, errors, 0)) {
+        count = 0;
+    }
+
+    for (i = 0 ; i < count ; i++) {
+        op = (mca_fbtl_pvfs2_op_t *) user_ptrs[i];
+        op->done = true;
+        if (0 != errors[i]) {
+            req->error = errors[i];
+        } else {
+            req->bytes += op->resp.total_completed;
+        }
+        PVFS_Request_free (&op->mem_req);
+        PVFS_Request_free (&op->file_req);
+        PVFS_sys_release (op->op_id);
+        req->pending--;
+    }
+    if (0 == req->pending) {
+        pvfs2_request_complete (req);
+    }
+
+    return count;
+}
+
+static int pvfs2_progress (void)
+{
+    opal_list_item_t *item, *next;
+    int count = 0;
+
+    if (0 == opal_list_get_size (&pvfs2_active)) {
+        return 0;
+    }
+    if (OPAL_THREAD_TRYLOCK(&pvfs2_lock)) {
+        return 0;
+    }
+    for (item = opal_list_get_first (&pvfs2_active) ;
+         item != opal_list_get_end (&pvfs2_active) ; item = next) {
+        next = opal_list_get_next (item);
+        count += pvfs2_request_test ((mca_fbtl_pvfs2_request_t *) item);
+    }
+    OPAL_THREAD_UNLOCK(&pvfs2_lock);
+
+    return count;
+}
+
+int mca_fbtl_pvfs2_list_start (mca_io_ompio_file_t *fh, int *sorted, bool write,
+                               mca_fbtl_pvfs2_request_t **request)
+{
+    mca_fs_pvfs2 *pvfs2_fs = (mca_fs_pvfs2 *) fh->f_fs_ptr;
+    mca_fbtl_pvfs2_request_t *req;
+    mca_fbtl_pvfs2_op_t *op;
+    int first, count, nops = 0, ret;
+
+    if (!pvfs2_active_ready) {
+        OBJ_CONSTRUCT(&pvfs2_active, opal_list_t);
+        OBJ_CONSTRUCT(&pvfs2_lock, opal_mutex_t);
+        /* file I/O completions are not latency critical */
+        opal_progress_register_lp (pvfs2_progress);
+        pvfs2_active_ready = true;
+    }
+
+    req = OBJ_NEW(mca_fbtl_pvfs2_request_t);
+    if (NULL == req) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for (first = 0 ; first < fh->f_num_of_io_entries ; first += count) {
+        count = pvfs2_list_size (fh, first);
+        nops++;
+    }
+    req->ops = (mca_fbtl_pvfs2_op_t *) calloc (nops > 0 ? nops : 1,
+                                               sizeof(mca_fbtl_pvfs2_op_t));
+    if (NULL == req->ops) {
+        OBJ_RELEASE(req);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    OMPI_REQUEST_INIT(&req->super, false);
+    req->super.req_state = OMPI_REQUEST_ACTIVE;
+    req->super.req_free = pvfs2_request_free;
+    req->super.req_status.MPI_SOURCE = MPI_ANY_SOURCE;
+    req->super.req_status.MPI_TAG = MPI_ANY_TAG;
+    req->super.req_status.MPI_ERROR = OMPI_SUCCESS;
+    req->super.req_status._cancelled = 0;
+    req->super.req_status._ucount = 0;
+    req->nops = 0;
+    req->pending = 0;
+    req->error = 0;
+    req->bytes = 0;
+    req->user_freed = false;
+
+    OPAL_THREAD_LOCK(&pvfs2_lock);
+    for (first = 0 ; first < fh->f_num_of_io_entries ; first += count) {
+        count = pvfs2_list_size (fh, first);
+        op = &req->ops[req->nops];
+        ret = pvfs2_list_requests (fh, sorted, first, count,
+                                   &op->mem_req, &op->file_req);
+        if (OMPI_SUCCESS != ret) {
+            req->error = ret;
+            break;
+        }
+        op->req = req;
+        op->done = false;
+        ret = PVFS_isys_io (pvfs2_fs->object_ref, op->file_req, 0,
+                            PVFS_BOTTOM, op->mem_req,
+                            &(pvfs2_fs->credentials), &op->resp,
+                            write ? PVFS_IO_WRITE : PVFS_IO_READ,
+                            &op->op_id, op);
+        if (0 != ret) {
+            perror("PVFS_isys_io() error");
+            PVFS_Request_free (&op->mem_req);
+            PVFS_Request_free (&op->file_req);
+            req->error = ret;
+            break;
+        }
+        req->nops++;
+        req->pending++;
+    }
+
+    if (0 == req->nops) {
+        OPAL_THREAD_UNLOCK(&pvfs2_lock);
+        if (0 != req->error) {
+            pvfs2_request_release (req);
+            return OMPI_ERROR;
+        }
+        /* nothing to transfer */
+        req->super.req_status._ucount = 0;
+        OPAL_THREAD_LOCK(&ompi_request_lock);
+        ompi_request_complete (&req->super, false);
+        OPAL_THREAD_UNLOCK(&ompi_request_lock);
+        *request = req;
+        return OMPI_SUCCESS;
+    }
+    /* what was posted before an error completes normally, the error is
+       reported by the request */
+    opal_list_append (&pvfs2_active, (opal_list_item_t *) req);
+    OPAL_THREAD_UNLOCK(&pvfs2_lock);
+
+    *request = req;
+    return OMPI_SUCCESS;
+}
+
+void mca_fbtl_pvfs2_list_fini (void)
+{
+    if (!pvfs2_active_ready) {
+        return;
+    }
+
+    opal_progress_unregister (pvfs2_progress);
+    OBJ_DESTRUCT(&pvfs2_active);
+    OBJ_DESTRUCT(&pvfs2_lock);
+    pvfs2_active_ready = false;
+}
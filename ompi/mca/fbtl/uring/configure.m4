@@ -0,0 +1,53 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2013      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+# 
+# Additional copyrights may follow
+# 
+# $HEADER$
+#
+
+# MCA_fbtl_uring_CONFIG(action-if-can-compile, 
+#                        [action-if-cant-compile])
+# ------------------------------------------------
+AC_DEFUN([MCA_ompi_fbtl_uring_CONFIG],[
+    AC_CONFIG_FILES([ompi/mca/fbtl/uring/Makefile])
+
+    OPAL_VAR_SCOPE_PUSH([fbtl_uring_happy fbtl_uring_dir fbtl_uring_libdir])
+
+    AC_ARG_WITH([uring],
+                [AC_HELP_STRING([--with-uring(=DIR)],
+                [Build the io_uring fbtl component, searching for liburing in DIR])])
+    OMPI_CHECK_WITHDIR([uring], [$with_uring], [include/liburing.h])
+
+    AC_ARG_WITH([uring-libdir],
+                [AC_HELP_STRING([--with-uring-libdir=DIR],
+                                [Search for liburing in DIR])])
+    OMPI_CHECK_WITHDIR([uring-libdir], [$with_uring_libdir], [liburing.*])
+
+    AS_IF([test "$with_uring" != "no"],
+          [AS_IF([test ! -z "$with_uring" -a "$with_uring" != "yes"],
+                 [fbtl_uring_dir="$with_uring"])
+           AS_IF([test ! -z "$with_uring_libdir" -a "$with_uring_libdir" != "yes"],
+                 [fbtl_uring_libdir="$with_uring_libdir"])
+           OMPI_CHECK_PACKAGE([fbtl_uring], [liburing.h], [uring], [io_uring_queue_init], [],
+                              [$fbtl_uring_dir], [$fbtl_uring_libdir],
+                              [fbtl_uring_happy="yes"], [fbtl_uring_happy="no"])],
+          [fbtl_uring_happy="no"])
+
+    AS_IF([test "$fbtl_uring_happy" = "yes"],
+          [$1],
+          [AS_IF([test ! -z "$with_uring" -a "$with_uring" != "no"],
+                 [AC_MSG_ERROR([io_uring support requested but not found.  Aborting])])
+           $2])
+
+    # substitute in the things needed to build uring
+    AC_SUBST([fbtl_uring_CPPFLAGS])
+    AC_SUBST([fbtl_uring_LDFLAGS])
+    AC_SUBST([fbtl_uring_LIBS])
+
+    OPAL_VAR_SCOPE_POP
+])dnl
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include <unistd.h>
+
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/fbtl/uring/fbtl_uring.h"
+
+/*
+ * *******************************************************************
+ * ************************ actions structure ************************
+ * *******************************************************************
+ */
+static mca_fbtl_base_module_1_0_0_t uring =  {
+    mca_fbtl_uring_module_init, /* initalise after being selected */
+    mca_fbtl_uring_module_finalize, /* close a module on a communicator */
+    mca_fbtl_uring_preadv,
+    mca_fbtl_uring_ipreadv,
+    mca_fbtl_uring_pwritev,
+    mca_fbtl_uring_ipwritev
+};
+/*
+ * *******************************************************************
+ * ************************* structure ends **************************
+ * *******************************************************************
+ */
+
+int mca_fbtl_uring_component_init_query(bool enable_progress_threads,
+                                        bool enable_mpi_threads) {
+    /* Nothing to do */
+
+   return OMPI_SUCCESS;
+}
+
+struct mca_fbtl_base_module_1_0_0_t *
+mca_fbtl_uring_component_file_query (mca_io_ompio_file_t *fh, int *priority) {
+   /* the kernel might not support io_uring, or forbid it */
+   if (OMPI_SUCCESS != mca_fbtl_uring_ring_init()) {
+       return NULL;
+   }
+
+   *priority = mca_fbtl_uring_priority;
+
+   /* same files as posix, a bit higher */
+   if (UFS == fh->f_fstype) {
+       if (*priority < 60) {
+           *priority = 60;
+       }
+   }
+
+   return &uring;
+}
+
+int mca_fbtl_uring_component_file_unquery (mca_io_ompio_file_t *file) {
+   /* The ring is kept until the component is closed */
+
+   return OMPI_SUCCESS;
+}
+
+int mca_fbtl_uring_module_init (mca_io_ompio_file_t *file) {
+    mca_fbtl_uring_file_t *data;
+
+    data = (mca_fbtl_uring_file_t *) malloc (sizeof(mca_fbtl_uring_file_t));
+    if (NULL == data) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    /* the file is not opened yet, the O_DIRECT descriptor is opened on
+     * first use */
+    data->direct_fd = -1;
+    data->direct_checked = false;
+    file->f_fbtl_ptr = data;
+
+    return OMPI_SUCCESS;
+}
+
+
+int mca_fbtl_uring_module_finalize (mca_io_ompio_file_t *file) {
+    mca_fbtl_uring_file_t *data = (mca_fbtl_uring_file_t *) file->f_fbtl_ptr;
+
+    if (NULL != data) {
+        if (-1 != data->direct_fd) {
+            close (data->direct_fd);
+        }
+        free (data);
+        file->f_fbtl_ptr = NULL;
+    }
+
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_FBTL_URING_H
+#define MCA_FBTL_URING_H
+
+#include "ompi_config.h"
+
+#include <sys/uio.h>
+#include <liburing.h>
+
+#include "opal/mca/mca.h"
+#include "opal/class/opal_list.h"
+#include "opal/threads/mutex.h"
+#include "ompi/class/ompi_free_list.h"
+#include "ompi/request/request.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "ompi/mca/io/ompio/io_ompio.h"
+
+BEGIN_C_DECLS
+
+extern int mca_fbtl_uring_priority;
+extern int mca_fbtl_uring_queue_depth;
+extern int mca_fbtl_uring_direct;
+extern int mca_fbtl_uring_direct_alignment;
+
+/**
+ * State shared by all the files using the component: a single ring is
+ * used for the process, and the number of operations submitted to it is
+ * kept below its depth. The requests which could not submit all their
+ * operations wait in a list, and are resumed from the progress loop.
+ */
+typedef struct mca_fbtl_uring_globals_t {
+    struct io_uring    ring;
+    bool               ring_ready;
+    int                inflight;
+    ompi_free_list_t   requests;
+    opal_list_t        waiting;
+    opal_mutex_t       lock;
+} mca_fbtl_uring_globals_t;
+
+extern mca_fbtl_uring_globals_t mca_fbtl_uring_globals;
+
+/**
+ * Per file data, hung on f_fbtl_ptr. The second descriptor is opened with
+ * O_DIRECT the first time it could be used.
+ */
+typedef struct mca_fbtl_uring_file_t {
+    int   direct_fd;
+    bool  direct_checked;
+} mca_fbtl_uring_file_t;
+
+struct mca_fbtl_uring_request_t;
+
+/**
+ * One readv or writev of the ring: a run of entries of f_io_array
+ * covering a contiguous range of the file.
+ */
+typedef struct mca_fbtl_uring_op_t {
+    struct mca_fbtl_uring_request_t *req;
+    struct iovec                    *iov;
+    int                              iovcnt;
+    int                              fd;
+    OMPI_MPI_OFFSET_TYPE             offset;
+    size_t                           length;
+} mca_fbtl_uring_op_t;
+
+typedef struct mca_fbtl_uring_request_t {
+    ompi_request_t        super;
+    struct iovec         *iov;
+    int                   iov_size;
+    mca_fbtl_uring_op_t  *ops;
+    int                   ops_size;
+    int                   nops;
+    int                   next_op;     /**< first op not submitted yet */
+    int                   pending;     /**< ops submitted and not completed */
+    int                   error;
+    int                   fd;          /**< descriptor used for the short transfers */
+    size_t                bytes;
+    bool                  write;
+    bool                  user_freed;  /**< freed by the user before completion */
+} mca_fbtl_uring_request_t;
+
+OBJ_CLASS_DECLARATION(mca_fbtl_uring_request_t);
+
+int mca_fbtl_uring_component_init_query(bool enable_progress_threads,
+                                        bool enable_mpi_threads);
+struct mca_fbtl_base_module_1_0_0_t *
+mca_fbtl_uring_component_file_query (mca_io_ompio_file_t *file, int *priority);
+int mca_fbtl_uring_component_file_unquery (mca_io_ompio_file_t *file);
+
+int mca_fbtl_uring_module_init (mca_io_ompio_file_t *file);
+int mca_fbtl_uring_module_finalize (mca_io_ompio_file_t *file);
+
+OMPI_MODULE_DECLSPEC extern mca_fbtl_base_component_2_0_0_t mca_fbtl_uring_component;
+
+/* ring and requests, in fbtl_uring_request.c */
+int mca_fbtl_uring_ring_init (void);
+void mca_fbtl_uring_ring_fini (void);
+int mca_fbtl_uring_start (mca_io_ompio_file_t *fh, int *sorted, bool write,
+                          mca_fbtl_uring_request_t **request);
+int mca_fbtl_uring_wait (mca_fbtl_uring_request_t *req);
+
+/*
+ * ******************************************************************
+ * ********* functions which are implemented in this module *********
+ * ******************************************************************
+ */
+
+size_t mca_fbtl_uring_preadv (mca_io_ompio_file_t *file,
+                              int *sorted);
+size_t mca_fbtl_uring_pwritev (mca_io_ompio_file_t *file,
+                               int *sorted);
+size_t mca_fbtl_uring_ipreadv (mca_io_ompio_file_t *file,
+                               int *sorted,
+                               ompi_request_t **request);
+size_t mca_fbtl_uring_ipwritev (mca_io_ompio_file_t *file,
+                                int *sorted,
+                                ompi_request_t **request);
+
+/*
+ * ******************************************************************
+ * ************ functions implemented in this module end ************
+ * ******************************************************************
+ */
+
+END_C_DECLS
+
+#endif /* MCA_FBTL_URING_H */
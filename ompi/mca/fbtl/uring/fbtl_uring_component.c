@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * These symbols are in a file by themselves to provide nice linker
+ * semantics.  Since linkers generally pull in symbols by object
+ * files, keeping these symbols as the only symbols in this file
+ * prevents utility programs such as "ompi_info" from having to import
+ * entire components just to query their version and parameters.
+ */
+
+#include "ompi_config.h"
+#include "fbtl_uring.h"
+#include "mpi.h"
+
+/*
+ * Public string showing the fbtl uring component version number
+ */
+const char *mca_fbtl_uring_component_version_string =
+  "OMPI/MPI uring FBTL MCA component version " OMPI_VERSION;
+
+int mca_fbtl_uring_priority = 20;
+int mca_fbtl_uring_queue_depth = 64;
+int mca_fbtl_uring_direct = 0;
+int mca_fbtl_uring_direct_alignment = 4096;
+
+static int uring_register(void);
+static int uring_close(void);
+
+/*
+ * Instantiate the public struct with all of our public information
+ * and pointers to our public functions in it
+ */
+mca_fbtl_base_component_2_0_0_t mca_fbtl_uring_component = {
+
+    /* First, the mca_component_t struct containing meta information
+       about the component itself */
+
+    {
+        MCA_FBTL_BASE_VERSION_2_0_0,
+
+        /* Component name and version */
+        "uring",
+        OMPI_MAJOR_VERSION,
+        OMPI_MINOR_VERSION,
+        OMPI_RELEASE_VERSION,
+        NULL,
+        uring_close,
+        NULL,
+        uring_register
+    },
+    {
+        /* This component is checkpointable */
+      MCA_BASE_METADATA_PARAM_CHECKPOINT
+    },
+    mca_fbtl_uring_component_init_query,      /* get thread level */
+    mca_fbtl_uring_component_file_query,      /* get priority and actions */
+    mca_fbtl_uring_component_file_unquery     /* undo what was done by previous function */
+};
+
+
+static int
+uring_register(void)
+{
+    mca_fbtl_uring_priority = 20;
+    (void) mca_base_component_var_register(&mca_fbtl_uring_component.fbtlm_version,
+                                           "priority", "Priority of the uring fbtl component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_fbtl_uring_priority);
+    mca_fbtl_uring_queue_depth = 64;
+    (void) mca_base_component_var_register(&mca_fbtl_uring_component.fbtlm_version,
+                                           "queue_depth",
+                                           "Number of entries of the submission queue, which is also the maximum "
+                                           "number of reads and writes in flight for the process",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_fbtl_uring_queue_depth);
+    mca_fbtl_uring_direct = 0;
+    (void) mca_base_component_var_register(&mca_fbtl_uring_component.fbtlm_version,
+                                           "direct",
+                                           "Bypass the page cache (O_DIRECT) for the transfers whose buffers, "
+                                           "length and file offset are aligned on direct_alignment",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_fbtl_uring_direct);
+    mca_fbtl_uring_direct_alignment = 4096;
+    (void) mca_base_component_var_register(&mca_fbtl_uring_component.fbtlm_version,
+                                           "direct_alignment",
+                                           "Alignment required by the file system for O_DIRECT transfers",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_fbtl_uring_direct_alignment);
+
+    return OMPI_SUCCESS;
+}
+
+static int
+uring_close(void)
+{
+    mca_fbtl_uring_ring_fini();
+    return OMPI_SUCCESS;
+}
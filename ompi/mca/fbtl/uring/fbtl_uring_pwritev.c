@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_uring.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/fbtl.h"
+
+size_t
+mca_fbtl_uring_pwritev (mca_io_ompio_file_t *fh,
+                       int *sorted)
+{
+    mca_fbtl_uring_request_t *req;
+    double start = MPI_Wtime ();
+    int rc;
+
+    if (NULL == fh->f_io_array) {
+        return OMPI_ERROR;
+    }
+
+    rc = mca_fbtl_uring_start (fh, sorted, true, &req);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+    rc = mca_fbtl_uring_wait (req);
+    OMPIO_STATS_ADD(fh, fbtl_time, MPI_Wtime () - start);
+    return rc;
+}
+
+size_t
+mca_fbtl_uring_ipwritev (mca_io_ompio_file_t *fh,
+                        int *sorted,
+                        ompi_request_t **request)
+{
+    mca_fbtl_uring_request_t *req;
+    int rc;
+
+    if (NULL == fh->f_io_array) {
+        return OMPI_ERROR;
+    }
+
+    rc = mca_fbtl_uring_start (fh, sorted, true, &req);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+    *request = &req->super;
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,482 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "fbtl_uring.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include "opal/runtime/opal_progress.h"
+#include "opal/util/output.h"
+#include "ompi/constants.h"
+#include "ompi/mca/fbtl/base/base.h"
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/*
+ * The entries of f_io_array covering a contiguous range of the file are
+ * transferred by a single readv or writev, directly from the user
+ * buffers. When they are all aligned, the operation goes through a second
+ * descriptor opened with O_DIRECT. The completions are reaped by the
+ * blocking calls and from the progress loop; what a short transfer left
+ * over is completed synchronously.
+ */
+
+mca_fbtl_uring_globals_t mca_fbtl_uring_globals;
+
+static bool ring_failed = false;
+
+static void mca_fbtl_uring_request_construct (mca_fbtl_uring_request_t *req)
+{
+    req->super.req_type = OMPI_REQUEST_IO;
+    req->super.req_free = NULL;
+    req->super.req_cancel = NULL;
+    req->iov = NULL;
+    req->iov_size = 0;
+    req->ops = NULL;
+    req->ops_size = 0;
+}
+
+static void mca_fbtl_uring_request_destruct (mca_fbtl_uring_request_t *req)
+{
+    if (NULL != req->iov) {
+        free (req->iov);
+    }
+    if (NULL != req->ops) {
+        free (req->ops);
+    }
+}
+
+OBJ_CLASS_INSTANCE(mca_fbtl_uring_request_t, ompi_request_t,
+                   mca_fbtl_uring_request_construct,
+                   mca_fbtl_uring_request_destruct);
+
+static int uring_progress (void);
+
+int mca_fbtl_uring_ring_init (void)
+{
+    int rc;
+
+    if (mca_fbtl_uring_globals.ring_ready) {
+        return OMPI_SUCCESS;
+    }
+    if (ring_failed) {
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    if (mca_fbtl_uring_queue_depth < 1) {
+        mca_fbtl_uring_queue_depth = 1;
+    }
+    rc = io_uring_queue_init (mca_fbtl_uring_queue_depth,
+                              &mca_fbtl_uring_globals.ring, 0);
+    if (rc < 0) {
+        opal_output_verbose(10, ompi_fbtl_base_framework.framework_output,
+                            "fbtl:uring: io_uring_queue_init failed (%d)", -rc);
+        ring_failed = true;
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    OBJ_CONSTRUCT(&mca_fbtl_uring_globals.requests, ompi_free_list_t);
+    ompi_free_list_init_new (&mca_fbtl_uring_globals.requests,
+                             sizeof(mca_fbtl_uring_request_t),
+                             opal_cache_line_size,
+                             OBJ_CLASS(mca_fbtl_uring_request_t),
+                             0, opal_cache_line_size,
+                             4, -1, 4, NULL);
+    OBJ_CONSTRUCT(&mca_fbtl_uring_globals.waiting, opal_list_t);
+    OBJ_CONSTRUCT(&mca_fbtl_uring_globals.lock, opal_mutex_t);
+    mca_fbtl_uring_globals.inflight = 0;
+    mca_fbtl_uring_globals.ring_ready = true;
+
+    /* file I/O completions are not latency critical */
+    opal_progress_register_lp (uring_progress);
+
+    return OMPI_SUCCESS;
+}
+
+void mca_fbtl_uring_ring_fini (void)
+{
+    if (!mca_fbtl_uring_globals.ring_ready) {
+        return;
+    }
+
+    opal_progress_unregister (uring_progress);
+    io_uring_queue_exit (&mca_fbtl_uring_globals.ring);
+    OBJ_DESTRUCT(&mca_fbtl_uring_globals.waiting);
+    OBJ_DESTRUCT(&mca_fbtl_uring_globals.requests);
+    OBJ_DESTRUCT(&mca_fbtl_uring_globals.lock);
+    mca_fbtl_uring_globals.ring_ready = false;
+}
+
+static void uring_request_release (mca_fbtl_uring_request_t *req)
+{
+    OMPI_REQUEST_FINI(&req->super);
+    OMPI_FREE_LIST_RETURN_MT(&mca_fbtl_uring_globals.requests,
+                             (ompi_free_list_item_t *) req);
+}
+
+static int uring_request_free (ompi_request_t **request)
+{
+    mca_fbtl_uring_request_t *req = (mca_fbtl_uring_request_t *) *request;
+
+    OPAL_THREAD_LOCK(&mca_fbtl_uring_globals.lock);
+    if (req->super.req_complete) {
+        uring_request_release (req);
+    } else {
+        /* released when the last operation completes */
+        req->user_freed = true;
+    }
+    OPAL_THREAD_UNLOCK(&mca_fbtl_uring_globals.lock);
+
+    *request = MPI_REQUEST_NULL;
+    return OMPI_SUCCESS;
+}
+
+static void uring_request_complete (mca_fbtl_uring_request_t *req)
+{
+    req->super.req_status.MPI_ERROR = (0 == req->error) ? OMPI_SUCCESS : OMPI_ERROR;
+    req->super.req_status._ucount = req->bytes;
+
+    if (req->user_freed) {
+        req->super.req_complete = true;
+        uring_request_release (req);
+        return;
+    }
+    OPAL_THREAD_LOCK(&ompi_request_lock);
+    ompi_request_complete (&req->super, true);
+    OPAL_THREAD_UNLOCK(&ompi_request_lock);
+}
+
+/* Synchronous transfer of what follows the first done bytes of an
+ * operation. For reads, stops at the end of the file. */
+static void uring_op_finish (mca_fbtl_uring_op_t *op, size_t done)
+{
+    mca_fbtl_uring_request_t *req = op->req;
+    char *base;
+    size_t len;
+    ssize_t ret;
+    int i;
+
+    for (i = 0 ; i < op->iovcnt ; i++) {
+        if (done >= op->iov[i].iov_len) {
+            done -= op->iov[i].iov_len;
+            continue;
+        }
+        base = (char *) op->iov[i].iov_base + done;
+        len = op->iov[i].iov_len - done;
+        done = 0;
+        while (0 < len) {
+            if (req->write) {
+                ret = pwrite (req->fd, base, len, op->offset);
+            } else {
+                ret = pread (req->fd, base, len, op->offset);
+            }
+            if (ret < 0) {
+                if (EINTR == errno) {
+                    continue;
+                }
+                req->error = errno;
+                return;
+            }
+            if (0 == ret) {
+                /* end of file */
+                return;
+            }
+            base += ret;
+            len -= ret;
+            op->offset += ret;
+            req->bytes += ret;
+        }
+    }
+}
+
+/* Push the operations of a request to the submission queue, as long as
+ * the ring has room. Returns the number of operations queued. Called with
+ * the lock held. */
+static int uring_request_submit (mca_fbtl_uring_request_t *req)
+{
+    struct io_uring_sqe *sqe;
+    mca_fbtl_uring_op_t *op;
+    int queued = 0;
+
+    while (req->next_op < req->nops &&
+           mca_fbtl_uring_globals.inflight < mca_fbtl_uring_queue_depth) {
+        sqe = io_uring_get_sqe (&mca_fbtl_uring_globals.ring);
+        if (NULL == sqe) {
+            break;
+        }
+        op = &req->ops[req->next_op];
+        if (req->write) {
+            io_uring_prep_writev (sqe, op->fd, op->iov, op->iovcnt, op->offset);
+        } else {
+            io_uring_prep_readv (sqe, op->fd, op->iov, op->iovcnt, op->offset);
+        }
+        io_uring_sqe_set_data (sqe, op);
+        req->next_op++;
+        req->pending++;
+        mca_fbtl_uring_globals.inflight++;
+        queued++;
+    }
+
+    return queued;
+}
+
+/* Handle the available completions, then move on the requests waiting
+ * for room in the ring. Called with the lock held. */
+static int uring_reap (void)
+{
+    struct io_uring_cqe *cqe;
+    mca_fbtl_uring_op_t *op;
+    mca_fbtl_uring_request_t *req;
+    opal_list_item_t *item;
+    int count = 0, queued = 0, res;
+
+    while (0 == io_uring_peek_cqe (&mca_fbtl_uring_globals.ring, &cqe)) {
+        op = (mca_fbtl_uring_op_t *) io_uring_cqe_get_data (cqe);
+        res = cqe->res;
+        io_uring_cqe_seen (&mca_fbtl_uring_globals.ring, cqe);
+        mca_fbtl_uring_globals.inflight--;
+        count++;
+
+        req = op->req;
+        if (res < 0) {
+            req->error = -res;
+        } else {
+            req->bytes += res;
+            if ((size_t) res < op->length && (0 != res || req->write)) {
+                uring_op_finish (op, (size_t) res);
+            }
+        }
+        req->pending--;
+        if (0 == req->pending && req->next_op == req->nops) {
+            uring_request_complete (req);
+        }
+    }
+
+    while (mca_fbtl_uring_globals.inflight < mca_fbtl_uring_queue_depth &&
+           NULL != (item = opal_list_get_first (&mca_fbtl_uring_globals.waiting)) &&
+           item != opal_list_get_end (&mca_fbtl_uring_globals.waiting)) {
+        req = (mca_fbtl_uring_request_t *) item;
+        queued += uring_request_submit (req);
+        if (req->next_op < req->nops) {
+            break;
+        }
+        opal_list_remove_first (&mca_fbtl_uring_globals.waiting);
+    }
+    if (0 < queued) {
+        io_uring_submit (&mca_fbtl_uring_globals.ring);
+    }
+
+    return count;
+}
+
+static int uring_progress (void)
+{
+    int count;
+
+    if (0 == mca_fbtl_uring_globals.inflight) {
+        return 0;
+    }
+    if (OPAL_THREAD_TRYLOCK(&mca_fbtl_uring_globals.lock)) {
+        return 0;
+    }
+    count = uring_reap ();
+    OPAL_THREAD_UNLOCK(&mca_fbtl_uring_globals.lock);
+
+    return count;
+}
+
+static bool uring_op_aligned (mca_fbtl_uring_op_t *op)
+{
+    size_t align = (size_t) mca_fbtl_uring_direct_alignment;
+    int i;
+
+    if (0 != (op->offset % align)) {
+        return false;
+    }
+    for (i = 0 ; i < op->iovcnt ; i++) {
+        if (0 != ((uintptr_t) op->iov[i].iov_base % align) ||
+            0 != (op->iov[i].iov_len % align)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int uring_direct_fd (mca_io_ompio_file_t *fh)
+{
+    mca_fbtl_uring_file_t *data = (mca_fbtl_uring_file_t *) fh->f_fbtl_ptr;
+
+    if (NULL == data || !mca_fbtl_uring_direct || 0 >= mca_fbtl_uring_direct_alignment) {
+        return -1;
+    }
+#ifdef O_DIRECT
+    if (!data->direct_checked) {
+        int flags = fcntl (fh->fd, F_GETFL);
+
+        data->direct_checked = true;
+        if (-1 != flags) {
+            /* the file exists now, don't create or truncate it again */
+            data->direct_fd = open (fh->f_filename, (flags & O_ACCMODE) | O_DIRECT);
+        }
+    }
+#endif
+    return data->direct_fd;
+}
+
+static int uring_request_grow (mca_fbtl_uring_request_t *req, int entries)
+{
+    void *tmp;
+
+    if (req->iov_size < entries) {
+        tmp = realloc (req->iov, entries * sizeof(struct iovec));
+        if (NULL == tmp) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        req->iov = (struct iovec *) tmp;
+        req->iov_size = entries;
+    }
+    if (req->ops_size < entries) {
+        tmp = realloc (req->ops, entries * sizeof(mca_fbtl_uring_op_t));
+        if (NULL == tmp) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        req->ops = (mca_fbtl_uring_op_t *) tmp;
+        req->ops_size = entries;
+    }
+    return OMPI_SUCCESS;
+}
+
+int mca_fbtl_uring_start (mca_io_ompio_file_t *fh, int *sorted, bool write,
+                          mca_fbtl_uring_request_t **request)
+{
+    mca_fbtl_uring_request_t *req;
+    mca_fbtl_uring_op_t *op = NULL;
+    ompi_free_list_item_t *item;
+    OMPI_MPI_OFFSET_TYPE offset;
+    int i, k, rc, direct_fd;
+
+    OMPI_FREE_LIST_GET_MT(&mca_fbtl_uring_globals.requests, item);
+    if (NULL == item) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    req = (mca_fbtl_uring_request_t *) item;
+
+    rc = uring_request_grow (req, fh->f_num_of_io_entries);
+    if (OMPI_SUCCESS != rc) {
+        OMPI_FREE_LIST_RETURN_MT(&mca_fbtl_uring_globals.requests, item);
+        return rc;
+    }
+
+    OMPI_REQUEST_INIT(&req->super, false);
+    req->super.req_state = OMPI_REQUEST_ACTIVE;
+    req->super.req_free = uring_request_free;
+    req->super.req_status.MPI_SOURCE = MPI_ANY_SOURCE;
+    req->super.req_status.MPI_TAG = MPI_ANY_TAG;
+    req->super.req_status.MPI_ERROR = OMPI_SUCCESS;
+    req->super.req_status._cancelled = 0;
+    req->super.req_status._ucount = 0;
+    req->nops = 0;
+    req->next_op = 0;
+    req->pending = 0;
+    req->error = 0;
+    req->fd = fh->fd;
+    req->bytes = 0;
+    req->write = write;
+    req->user_freed = false;
+
+    /* one operation per contiguous range of the file */
+    for (i = 0 ; i < fh->f_num_of_io_entries ; i++) {
+        k = (NULL != sorted) ? sorted[i] : i;
+        offset = (OMPI_MPI_OFFSET_TYPE)(intptr_t) fh->f_io_array[k].offset;
+        req->iov[i].iov_base = fh->f_io_array[k].memory_address;
+        req->iov[i].iov_len = fh->f_io_array[k].length;
+
+        if (NULL != op && op->offset + (OMPI_MPI_OFFSET_TYPE) op->length == offset &&
+            op->iovcnt < IOV_MAX) {
+            op->iovcnt++;
+            op->length += req->iov[i].iov_len;
+            continue;
+        }
+        op = &req->ops[req->nops++];
+        op->req = req;
+        op->iov = &req->iov[i];
+        op->iovcnt = 1;
+        op->fd = fh->fd;
+        op->offset = offset;
+        op->length = req->iov[i].iov_len;
+    }
+
+    direct_fd = uring_direct_fd (fh);
+    if (-1 != direct_fd) {
+        for (i = 0 ; i < req->nops ; i++) {
+            if (uring_op_aligned (&req->ops[i])) {
+                req->ops[i].fd = direct_fd;
+            }
+        }
+    }
+
+    /* the time is only known to the blocking calls, which add it */
+    ompi_io_ompio_record_fbtl (fh, req->nops, 0.0);
+
+    if (0 == req->nops) {
+        uring_request_complete (req);
+        *request = req;
+        return OMPI_SUCCESS;
+    }
+
+    OPAL_THREAD_LOCK(&mca_fbtl_uring_globals.lock);
+    /* the requests already waiting go first */
+    if (opal_list_is_empty (&mca_fbtl_uring_globals.waiting)) {
+        uring_request_submit (req);
+    }
+    if (req->next_op < req->nops) {
+        opal_list_append (&mca_fbtl_uring_globals.waiting, (opal_list_item_t *) req);
+    }
+    if (0 < req->pending) {
+        rc = io_uring_submit (&mca_fbtl_uring_globals.ring);
+        if (rc < 0) {
+            opal_output(1, "fbtl:uring: io_uring_submit failed (%d)\n", -rc);
+        }
+    }
+    OPAL_THREAD_UNLOCK(&mca_fbtl_uring_globals.lock);
+
+    *request = req;
+    return OMPI_SUCCESS;
+}
+
+int mca_fbtl_uring_wait (mca_fbtl_uring_request_t *req)
+{
+    struct io_uring_cqe *cqe;
+    int rc;
+
+    while (!req->super.req_complete) {
+        OPAL_THREAD_LOCK(&mca_fbtl_uring_globals.lock);
+        if (!req->super.req_complete && 0 < mca_fbtl_uring_globals.inflight) {
+            /* sleep until something completes, the cqe is handled below */
+            io_uring_wait_cqe (&mca_fbtl_uring_globals.ring, &cqe);
+        }
+        uring_reap ();
+        OPAL_THREAD_UNLOCK(&mca_fbtl_uring_globals.lock);
+    }
+
+    rc = (0 == req->error) ? OMPI_SUCCESS : OMPI_ERROR;
+    OPAL_THREAD_LOCK(&mca_fbtl_uring_globals.lock);
+    uring_request_release (req);
+    OPAL_THREAD_UNLOCK(&mca_fbtl_uring_globals.lock);
+
+    return rc;
+}
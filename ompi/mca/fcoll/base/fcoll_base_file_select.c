@@ -257,6 +257,11 @@ int mca_fcoll_base_file_select (struct mca_io_ompio_file_t *file,
 
 int mca_fcoll_base_query_table (struct mca_io_ompio_file_t *file, char *name)
 {
+    /* processes writing disjoint contiguous parts of the file gain
+       nothing from shuffling the data through aggregators */
+    if (file->f_flags & OMPIO_DISJOINT_FVIEW) {
+        return !strcmp (name, "individual");
+    }
     if (!strcmp (name, "individual")) {
         if ((int)file->f_cc_size >= file->f_bytes_per_agg && 
             file->f_cc_size >= file->f_stripe_size) {
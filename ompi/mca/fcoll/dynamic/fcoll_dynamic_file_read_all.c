@@ -44,6 +44,11 @@
 			    int num_entries,
 			    int *sorted);
 
+ static int wait_previous_scatter (int procs_per_group,
+				   MPI_Request **send_req,
+				   ompi_datatype_t ***sendtype,
+				   char **global_buf);
+
 
 
  int
@@ -94,6 +99,12 @@
      MPI_Aint *total_bytes_per_process = NULL;
      ompi_datatype_t **sendtype = NULL;
      MPI_Request *send_req=NULL, *recv_req=NULL;
+     /* scatter of the previous cycle, going on during the read of the
+	current one */
+     MPI_Request *prev_send_req = NULL;
+     ompi_datatype_t **prev_sendtype = NULL;
+     char *prev_global_buf = NULL;
+     ompi_request_t *read_req = MPI_REQUEST_NULL;
 
 
  #if TIME_BREAKDOWN
@@ -618,13 +629,28 @@
  #endif
 
 	 if (fh->f_num_of_io_entries) {
-	   if (OMPI_SUCCESS != fh->f_fbtl->fbtl_preadv (fh, NULL)) {
+	   if (OMPI_SUCCESS != fh->f_fbtl->fbtl_ipreadv (fh, NULL, &read_req)) {
 	     opal_output (1, "READ FAILED\n");
 	     ret = OMPI_ERROR;
 	     goto exit;
 	   }
 	 }
 
+	 /* the data of the previous cycle was on its way meanwhile */
+	 ret = wait_previous_scatter (fh->f_procs_per_group, &prev_send_req,
+				      &prev_sendtype, &prev_global_buf);
+	 if (OMPI_SUCCESS != ret){
+	   goto exit;
+	 }
+
+	 if (MPI_REQUEST_NULL != read_req) {
+	   ret = ompi_request_wait (&read_req, MPI_STATUS_IGNORE);
+	   if (OMPI_SUCCESS != ret) {
+	     opal_output (1, "READ FAILED\n");
+	     goto exit;
+	   }
+	 }
+
  #if TIME_BREAKDOWN
 	 end_read_time = MPI_Wtime();
 	 read_time += end_read_time - start_read_time;
@@ -733,15 +759,8 @@
        }
        
        
-       if (fh->f_procs_in_group[fh->f_aggregator_index] == fh->f_rank){
-	 ret = ompi_request_wait_all (fh->f_procs_per_group,
-				    send_req,
-				      MPI_STATUS_IGNORE);
-	 if (OMPI_SUCCESS != ret){
-	   goto exit;
-	 }
-       }
-       
+       /* the sends of the aggregator are completed during the read of
+	  the next cycle */
        ret = ompi_request_wait (recv_req, MPI_STATUS_IGNORE);
        if (OMPI_SUCCESS != ret){
 	 goto exit;
@@ -802,20 +821,13 @@
 	   free (fh->f_io_array);
 	   fh->f_io_array = NULL;
 	 }
-	 if (NULL != global_buf) {
-	   free (global_buf);
-	   global_buf = NULL;
-	 }
-	 for (i = 0; i < fh->f_procs_per_group; i++)
-	   ompi_datatype_destroy(sendtype+i);
-	 if (NULL != sendtype){
-	   free(sendtype);
-	   sendtype=NULL;
-	 }
-	 if (NULL != send_req){
-	   free(send_req);
-	   send_req = NULL;
-	 }
+	 /* released once the sends are over */
+	 prev_global_buf = global_buf;
+	 global_buf = NULL;
+	 prev_sendtype = sendtype;
+	 sendtype = NULL;
+	 prev_send_req = send_req;
+	 send_req = NULL;
 	 if (NULL != sorted_file_offsets){
 	   free(sorted_file_offsets);
 	   sorted_file_offsets = NULL;
@@ -835,6 +847,14 @@
        }
      }
      
+     if (fh->f_procs_in_group[fh->f_aggregator_index] == fh->f_rank) {
+       ret = wait_previous_scatter (fh->f_procs_per_group, &prev_send_req,
+				    &prev_sendtype, &prev_global_buf);
+       if (OMPI_SUCCESS != ret){
+	 goto exit;
+       }
+     }
+
  #if TIME_BREAKDOWN
      end_rexch = MPI_Wtime();
      read_exch += end_rexch - start_rexch;
@@ -853,6 +873,13 @@
  #endif
 
  exit:
+     if (fh->f_procs_in_group[fh->f_aggregator_index] == fh->f_rank) {
+       if (MPI_REQUEST_NULL != read_req) {
+	 ompi_request_wait (&read_req, MPI_STATUS_IGNORE);
+       }
+       wait_previous_scatter (fh->f_procs_per_group, &prev_send_req,
+			      &prev_sendtype, &prev_global_buf);
+     }
      if (NULL != sorted) {
        free (sorted);
        sorted = NULL;
@@ -1016,5 +1043,29 @@
      return OMPI_SUCCESS;
  }
 
+ static int wait_previous_scatter (int procs_per_group,
+				   MPI_Request **send_req,
+				   ompi_datatype_t ***sendtype,
+				   char **global_buf)
+ {
+     int i, ret = OMPI_SUCCESS;
 
-
+     if (NULL != *send_req) {
+	 ret = ompi_request_wait_all (procs_per_group,
+				      *send_req,
+				      MPI_STATUS_IGNORE);
+	 free (*send_req);
+	 *send_req = NULL;
+     }
+     if (NULL != *sendtype) {
+	 for (i = 0; i < procs_per_group; i++)
+	     ompi_datatype_destroy ((*sendtype)+i);
+	 free (*sendtype);
+	 *sendtype = NULL;
+     }
+     if (NULL != *global_buf) {
+	 free (*global_buf);
+	 *global_buf = NULL;
+     }
+     return ret;
+ }
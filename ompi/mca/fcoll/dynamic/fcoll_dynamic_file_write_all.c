@@ -46,6 +46,9 @@ static int local_heap_sort (local_io_array *io_array,
 			    int num_entries,
 			    int *sorted);
 
+static int wait_previous_write (ompi_request_t **write_req,
+				char **write_buf);
+
 
 int
 mca_fcoll_dynamic_file_write_all (mca_io_ompio_file_t *fh,
@@ -96,6 +99,10 @@ mca_fcoll_dynamic_file_write_all (mca_io_ompio_file_t *fh,
     MPI_Aint *total_bytes_per_process = NULL;
     MPI_Request *send_req=NULL, *recv_req=NULL;
     int recv_req_count=0;
+    /* write of the previous cycle, going on during the exchange of the
+       current one, and the buffer it is writing from */
+    ompi_request_t *write_req = MPI_REQUEST_NULL;
+    char *write_buf = NULL;
     
 
 #if TIME_BREAKDOWN
@@ -932,13 +939,25 @@ mca_fcoll_dynamic_file_write_all (mca_io_ompio_file_t *fh,
 #endif
 
 
+	  /* The data of this cycle is here: the buffer of the previous
+	     one can go once its write is over */
+	  ret = wait_previous_write (&write_req, &write_buf);
+	  if (OMPI_SUCCESS != ret) {
+	    opal_output (1, "WRITE FAILED\n");
+	    goto exit;
+	  }
+
 	  if (fh->f_num_of_io_entries) {
-	    if (OMPI_SUCCESS != fh->f_fbtl->fbtl_pwritev (fh, NULL)) {
+	    if (OMPI_SUCCESS != fh->f_fbtl->fbtl_ipwritev (fh, NULL, &write_req)) {
 	      opal_output (1, "WRITE FAILED\n");
 	      ret = OMPI_ERROR;
 	      goto exit;
 	    }
 	  }
+	  /* keep the buffer until the write completes, the next cycle
+	     receives in a new one */
+	  write_buf = global_buf;
+	  global_buf = NULL;
 #if TIME_BREAKDOWN
 	  end_write_time = MPI_Wtime();
 	  write_time += end_write_time - start_write_time;
@@ -979,6 +998,20 @@ mca_fcoll_dynamic_file_write_all (mca_io_ompio_file_t *fh,
 	
     }
 
+    if (fh->f_procs_in_group[fh->f_aggregator_index] == fh->f_rank) {
+      if (fh->f_split_coll_in_use) {
+	/* write_all_begin: the last write completes in write_all_end */
+	ompi_io_ompio_split_coll_defer (fh, write_req, write_buf);
+	write_req = MPI_REQUEST_NULL;
+	write_buf = NULL;
+      }
+      ret = wait_previous_write (&write_req, &write_buf);
+      if (OMPI_SUCCESS != ret) {
+	opal_output (1, "WRITE FAILED\n");
+	goto exit;
+      }
+    }
+
 #if TIME_BREAKDOWN
       end_exch = MPI_Wtime();
       exch_write += end_exch - start_exch;
@@ -999,6 +1032,7 @@ mca_fcoll_dynamic_file_write_all (mca_io_ompio_file_t *fh,
 
  exit :
     if (fh->f_procs_in_group[fh->f_aggregator_index] == fh->f_rank) {
+      wait_previous_write (&write_req, &write_buf);
       if (NULL != fh->f_io_array) {
 	free (fh->f_io_array);
 	fh->f_io_array = NULL;
@@ -1170,3 +1204,22 @@ static int local_heap_sort (local_io_array *io_array,
 }
 
 
+
+static int wait_previous_write (ompi_request_t **write_req,
+				char **write_buf)
+{
+    int ret = OMPI_SUCCESS;
+
+    if (MPI_REQUEST_NULL != *write_req) {
+        ret = ompi_request_wait (write_req, MPI_STATUS_IGNORE);
+        if (MPI_REQUEST_NULL != *write_req) {
+            /* not released by the wait on error */
+            ompi_request_free (write_req);
+        }
+    }
+    if (NULL != *write_buf) {
+        free (*write_buf);
+        *write_buf = NULL;
+    }
+    return ret;
+}
@@ -31,6 +31,8 @@ mca_fcoll_dynamic_file_write_all_begin (mca_io_ompio_file_t *fh,
                                       int count, 
                                       struct ompi_datatype_t *datatype)
 {
-    printf ("DYNAMIC WRITE ALL BEGIN\n");
-    return OMPI_SUCCESS;
+    /* the last write of the aggregators is left in flight, ompio
+       waits for it in the _end */
+    return mca_fcoll_dynamic_file_write_all (fh, buf, count, datatype,
+                                             MPI_STATUS_IGNORE);
 }
@@ -31,6 +31,7 @@ mca_fcoll_individual_file_read_all_begin (mca_io_ompio_file_t *fh,
                                int count, 
                                struct ompi_datatype_t *datatype)
 {
-    printf ("INDIVIDUAL READ ALL BEGIN\n");
-    return OMPI_SUCCESS;
+    /* done here, ompio only sets the status in the _end */
+    return mca_fcoll_individual_file_read_all (fh, buf, count, datatype,
+                                               MPI_STATUS_IGNORE);
 }
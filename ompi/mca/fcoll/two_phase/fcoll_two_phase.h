@@ -36,6 +36,7 @@ extern int mca_fcoll_two_phase_priority;
 extern int mca_fcoll_two_phase_num_io_procs;
 extern int mca_fcoll_two_phase_constant_cbs;
 extern int mca_fcoll_two_phase_cycle_buffer_size;
+extern int mca_fcoll_two_phase_aggregators_per_ost;
 
 OMPI_MODULE_DECLSPEC extern mca_fcoll_base_component_2_0_0_t mca_fcoll_two_phase_component;
 
@@ -125,6 +126,10 @@ int mca_fcoll_two_phase_domain_partition (mca_io_ompio_file_t *fh,
 					   int striping_unit,
 					   int nprocs_for_coll);
 
+int mca_fcoll_two_phase_stripe_aggregators (mca_io_ompio_file_t *fh,
+					    int *num_aggregators,
+					    int **aggregator_list);
+
 
 
 
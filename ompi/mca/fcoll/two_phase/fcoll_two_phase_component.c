@@ -44,6 +44,7 @@ int mca_fcoll_two_phase_priority = 10;
 int mca_fcoll_two_phase_num_io_procs = -1;
 int mca_fcoll_two_phase_constant_cbs = 0;
 int mca_fcoll_two_phase_cycle_buffer_size = OMPIO_PREALLOC_MAX_BUF_SIZE;
+int mca_fcoll_two_phase_aggregators_per_ost = 1;
 
 /*
  * Local function
@@ -111,6 +112,14 @@ two_phase_register(void)
                                     MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
                                     OPAL_INFO_LVL_9,
                                     MCA_BASE_VAR_SCOPE_READONLY, &mca_fcoll_two_phase_cycle_buffer_size);
+    mca_fcoll_two_phase_aggregators_per_ost = 1;
+    mca_base_component_var_register(&mca_fcoll_two_phase_component.fcollm_version,
+                                    "aggregators_per_ost",
+                                    "Number of aggregators per object of a striped lustre file, used when num_io_procs "
+                                    "is not set. The file domains are then aligned on the stripes",
+                                    MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                    OPAL_INFO_LVL_9,
+                                    MCA_BASE_VAR_SCOPE_READONLY, &mca_fcoll_two_phase_aggregators_per_ost);
 
     return OMPI_SUCCESS;
 }
@@ -54,7 +54,7 @@ static int two_phase_read_and_exch(mca_io_ompio_file_t *fh,
 				   OMPI_MPI_OFFSET_TYPE *fd_end,
 				   Flatlist_node *flat_buf,
 				   size_t *buf_idx, int striping_unit,
-				   int *aggregator_list);
+				   int num_io_procs, int *aggregator_list);
 
 static int  two_phase_exchange_data(mca_io_ompio_file_t *fh,
 				    void *buf,
@@ -72,7 +72,7 @@ static int  two_phase_exchange_data(mca_io_ompio_file_t *fh,
 				    mca_io_ompio_access_array_t *others_req,
 				    int iter,
 				    size_t *buf_idx, MPI_Aint buftype_extent,
-				    int striping_unit, int *aggregator_list);
+				    int striping_unit, int num_io_procs, int *aggregator_list);
 
 
 static void two_phase_fill_user_buffer(mca_io_ompio_file_t *fh,
@@ -89,7 +89,15 @@ static void two_phase_fill_user_buffer(mca_io_ompio_file_t *fh,
 				       OMPI_MPI_OFFSET_TYPE *fd_start, 
 				       OMPI_MPI_OFFSET_TYPE *fd_end,
 				       MPI_Aint buftype_extent,
-				       int striping_unit, int *aggregator_list);
+				       int striping_unit, int num_io_procs, int *aggregator_list);
+
+static int two_phase_start_read(mca_io_ompio_file_t *fh,
+				char *read_buf,
+				OMPI_MPI_OFFSET_TYPE off,
+				OMPI_MPI_OFFSET_TYPE len,
+				ompi_request_t **read_req);
+
+static int two_phase_wait_read(ompi_request_t **read_req);
 #if TIME_BREAKDOWN
 static int isread_aggregator(int rank,
 			     int nprocs_for_coll,
@@ -123,6 +131,7 @@ mca_fcoll_two_phase_file_read_all (mca_io_ompio_file_t *fh,
   int count_other_req_procs;
   size_t *buf_indices=NULL;
   int *aggregator_list = NULL, local_count = 0, local_size = 0;
+  int num_io_procs = mca_fcoll_two_phase_num_io_procs;
   OMPI_MPI_OFFSET_TYPE start_offset = 0, end_offset = 0, fd_size = 0;
   OMPI_MPI_OFFSET_TYPE *start_offsets=NULL, *end_offsets=NULL;
   OMPI_MPI_OFFSET_TYPE *fd_start=NULL, *fd_end=NULL, min_st_offset = 0;
@@ -172,34 +181,47 @@ mca_fcoll_two_phase_file_read_all (mca_io_ompio_file_t *fh,
     status->_ucount = max_data;
   }
 
-  if(-1 == mca_fcoll_two_phase_num_io_procs){
+  if(-1 == num_io_procs && LUSTRE == fh->f_fstype &&
+     fh->f_stripe_count > 0 && fh->f_stripe_size > 0){
+    /* aggregators and file domains following the objects of the file */
+    ret = mca_fcoll_two_phase_stripe_aggregators (fh,
+						  &num_io_procs,
+						  &aggregator_list);
+    if (OMPI_SUCCESS != ret){
+      return ret;
+    }
+    striping_unit = fh->f_stripe_size;
+  }
+  else if(-1 == num_io_procs){
     ret = ompi_io_ompio_set_aggregator_props (fh, 
-					      mca_fcoll_two_phase_num_io_procs,
+					      num_io_procs,
 					      max_data);
     if (OMPI_SUCCESS != ret){
       return ret;
     }
 
-      mca_fcoll_two_phase_num_io_procs = 
+      num_io_procs = 
 	ceil((float)fh->f_size/fh->f_procs_per_group);
       
   }
   
-  if (mca_fcoll_two_phase_num_io_procs > fh->f_size){
-    mca_fcoll_two_phase_num_io_procs = fh->f_size;
+  if (num_io_procs > fh->f_size){
+    num_io_procs = fh->f_size;
   }
   
-  aggregator_list = (int *) calloc (mca_fcoll_two_phase_num_io_procs,
-				    sizeof(int));
   if (NULL == aggregator_list){
-    ret = OMPI_ERR_OUT_OF_RESOURCE;
-    goto exit;
-  }
+    aggregator_list = (int *) calloc (num_io_procs,
+				      sizeof(int));
+    if (NULL == aggregator_list){
+      ret = OMPI_ERR_OUT_OF_RESOURCE;
+      goto exit;
+    }
 
-  for (i=0; i< mca_fcoll_two_phase_num_io_procs; i++){
-    aggregator_list[i] = i;
-    /*This is similar to ranklist in romio's two-phase.
-      There is nothing fancy in the way romio assigns it too!!*/
+    for (i=0; i< num_io_procs; i++){
+      aggregator_list[i] = i;
+      /*This is similar to ranklist in romio's two-phase.
+	There is nothing fancy in the way romio assigns it too!!*/
+    }
   }
   
   ret = ompi_io_ompio_generate_current_file_view (fh, 
@@ -373,13 +395,13 @@ mca_fcoll_two_phase_file_read_all (mca_io_ompio_file_t *fh,
 					     domain_size, 
 					     &fd_size,
 					     striping_unit,
-					     mca_fcoll_two_phase_num_io_procs);
+					     num_io_procs);
   if (OMPI_SUCCESS != ret){
     goto exit;
   }
   
 #if DEBUG
-  for (i=0;i<mca_fcoll_two_phase_num_io_procs;i++){
+  for (i=0;i<num_io_procs;i++){
     printf("fd_start[%d] : %lld, fd_end[%d] : %lld, local_count: %d\n",
 	   i, fd_start[i], i, fd_end[i], local_count);
   }
@@ -397,7 +419,7 @@ mca_fcoll_two_phase_file_read_all (mca_io_ompio_file_t *fh,
 					      &my_req,
 					      &buf_indices,
 					      striping_unit,
-					      mca_fcoll_two_phase_num_io_procs,
+					      num_io_procs,
 					      aggregator_list);
   if ( OMPI_SUCCESS != ret ){
     goto exit;
@@ -437,7 +459,7 @@ mca_fcoll_two_phase_file_read_all (mca_io_ompio_file_t *fh,
 				flat_buf,
 				buf_indices,
 				striping_unit,
-				aggregator_list);
+				num_io_procs, aggregator_list);
   
   
   if (OMPI_SUCCESS != ret){
@@ -450,14 +472,14 @@ mca_fcoll_two_phase_file_read_all (mca_io_ompio_file_t *fh,
     nentry.time[1] = rcomm_time;
     nentry.time[2] = read_exch;
     if (isread_aggregator(fh->f_rank,
-			      mca_fcoll_two_phase_num_io_procs,
+			      num_io_procs,
 			  aggregator_list)){
       nentry.aggregator = 1;
     }
     else{
       nentry.aggregator = 0;
     }
-    nentry.nprocs_for_coll = mca_fcoll_two_phase_num_io_procs;
+    nentry.nprocs_for_coll = num_io_procs;
     
     
     if (!ompi_io_ompio_full_print_queue(READ_PRINT_QUEUE)){
@@ -509,7 +531,7 @@ static int two_phase_read_and_exch(mca_io_ompio_file_t *fh,
 				   OMPI_MPI_OFFSET_TYPE *fd_end,
 				   Flatlist_node *flat_buf,
 				   size_t *buf_idx, int striping_unit,
-				   int *aggregator_list){
+				   int num_io_procs, int *aggregator_list){
 
 
   int ret=OMPI_SUCCESS, i = 0, j = 0, ntimes = 0, max_ntimes = 0;
@@ -520,9 +542,15 @@ static int two_phase_read_and_exch(mca_io_ompio_file_t *fh,
   MPI_Aint buftype_extent=0;
   size_t byte_size = 0;
   OMPI_MPI_OFFSET_TYPE st_loc=-1, end_loc=-1, off=0, done=0, for_next_iter=0;
-  OMPI_MPI_OFFSET_TYPE size=0, req_off=0, real_size=0, real_off=0, len=0;
+  OMPI_MPI_OFFSET_TYPE size=0, req_off=0, real_size=0, real_off=0;
   OMPI_MPI_OFFSET_TYPE for_curr_iter=0;
-  char *read_buf=NULL, *tmp_buf=NULL;
+  char *read_buf=NULL;
+  /* cycle m is exchanged from read_bufs[m%2] while cycle m+1 is read
+     in the other one */
+  char *read_bufs[2] = {NULL, NULL};
+  OMPI_MPI_OFFSET_TYPE read_bufs_size[2] = {0, 0};
+  OMPI_MPI_OFFSET_TYPE next_size = 0;
+  ompi_request_t *read_req = MPI_REQUEST_NULL;
   MPI_Datatype byte = MPI_BYTE;
   
   opal_datatype_type_size(&byte->super, 
@@ -562,11 +590,14 @@ static int two_phase_read_and_exch(mca_io_ompio_file_t *fh,
 				     fh->f_comm->c_coll.coll_allreduce_module);
   
   if (ntimes){
-    read_buf = (char *) calloc (mca_fcoll_two_phase_cycle_buffer_size, 
-			       sizeof(char));
-    if ( NULL == read_buf ){
-      ret =  OMPI_ERR_OUT_OF_RESOURCE;
-      goto exit;
+    for (i=0; i<2 && i<ntimes; i++) {
+      read_bufs[i] = (char *) calloc (mca_fcoll_two_phase_cycle_buffer_size, 
+				      sizeof(char));
+      if ( NULL == read_bufs[i] ){
+	ret =  OMPI_ERR_OUT_OF_RESOURCE;
+	goto exit;
+      }
+      read_bufs_size[i] = mca_fcoll_two_phase_cycle_buffer_size;
     }
   }
   
@@ -622,6 +653,7 @@ static int two_phase_read_and_exch(mca_io_ompio_file_t *fh,
   
   for (m=0; m<ntimes; m++) {
     
+    read_buf = read_bufs[m%2];
     size = OMPIO_MIN((unsigned)mca_fcoll_two_phase_cycle_buffer_size, end_loc-st_loc+1-done); 
     real_off = off - for_curr_iter;
     real_size = size + for_curr_iter;
@@ -681,57 +713,50 @@ static int two_phase_read_and_exch(mca_io_ompio_file_t *fh,
     flag = 0;
     for (i=0; i<fh->f_size; i++) 
       if (count[i]) flag = 1;
-    
-    if (flag) {
 
 #if TIME_BREAKDOWN
-	start_read_time = MPI_Wtime();
+    start_read_time = MPI_Wtime();
 #endif
 
-      len = size * byte_size;
-      fh->f_io_array = (mca_io_ompio_io_array_t *)calloc 
-	(1,sizeof(mca_io_ompio_io_array_t));
-      if (NULL == fh->f_io_array) {
-	opal_output(1, "OUT OF MEMORY\n");
-	return OMPI_ERR_OUT_OF_RESOURCE;
-      }
-      fh->f_io_array[0].offset = (IOVBASE_TYPE *)(intptr_t)off;
-      fh->f_io_array[0].length = len;
-      fh->f_io_array[0].memory_address = 
-	read_buf+for_curr_iter;
-      fh->f_num_of_io_entries = 1;
-      
-      if (fh->f_num_of_io_entries){
-	if (OMPI_SUCCESS != fh->f_fbtl->fbtl_preadv (fh, NULL)) {
-	  opal_output(1, "READ FAILED\n");
-	  return OMPI_ERROR;
-	}
-      }
-      
-#if 0
-      int ii;
-      printf("%d: len/4 : %lld\n",
-	     fh->f_rank,
-	     len/4);
-      for (ii = 0; ii < len/4 ;ii++){
-	printf("%d: read_buf[%d]: %ld\n", 
-	       fh->f_rank,
-	       ii,
-	       (int *)read_buf[ii]);
-      }
-#endif
-      fh->f_num_of_io_entries = 0;
-      if (NULL != fh->f_io_array) {
-	free (fh->f_io_array);
-	fh->f_io_array = NULL;
+    /* the next cycles are read ahead, during the exchange of the
+       previous one */
+    if (0 == m && flag) {
+      ret = two_phase_start_read (fh, read_buf+for_curr_iter, off,
+				  size * byte_size, &read_req);
+      if (OMPI_SUCCESS != ret) {
+	goto exit;
       }
-      
+    }
+    ret = two_phase_wait_read (&read_req);
+    if (OMPI_SUCCESS != ret) {
+      opal_output(1, "READ FAILED\n");
+      goto exit;
+    }
+
 #if TIME_BREAKDOWN
-	end_read_time = MPI_Wtime();
-	read_time += (end_read_time - start_read_time);
+    end_read_time = MPI_Wtime();
+    read_time += (end_read_time - start_read_time);
 #endif
 
-
+    if (m+1 < ntimes) {
+      /* the end of this cycle may be needed by the next one, it is
+	 copied at the beginning of its buffer after the exchange */
+      if (read_bufs_size[(m+1)%2] < for_next_iter+mca_fcoll_two_phase_cycle_buffer_size) {
+	free (read_bufs[(m+1)%2]);
+	read_bufs_size[(m+1)%2] = for_next_iter+mca_fcoll_two_phase_cycle_buffer_size;
+	read_bufs[(m+1)%2] = (char *) malloc (read_bufs_size[(m+1)%2]);
+	if (NULL == read_bufs[(m+1)%2]) {
+	  ret = OMPI_ERR_OUT_OF_RESOURCE;
+	  goto exit;
+	}
+      }
+      next_size = OMPIO_MIN((unsigned)mca_fcoll_two_phase_cycle_buffer_size,
+			    end_loc-st_loc+1-(done+size));
+      ret = two_phase_start_read (fh, read_bufs[(m+1)%2]+for_next_iter,
+				  off+size, next_size * byte_size, &read_req);
+      if (OMPI_SUCCESS != ret) {
+	goto exit;
+      }
     }
  
     for_curr_iter = for_next_iter;
@@ -745,17 +770,13 @@ static int two_phase_read_and_exch(mca_io_ompio_file_t *fh,
 			    contig_access_count,
 			    min_st_offset, fd_size, fd_start, fd_end,
 			    flat_buf, others_req, m, buf_idx,
-			    buftype_extent, striping_unit, aggregator_list); 
+			    buftype_extent, striping_unit, num_io_procs, aggregator_list); 
 
-    if (for_next_iter){
-      tmp_buf = (char *) calloc (for_next_iter, sizeof(char));
-      memcpy(tmp_buf, 
+    if (for_next_iter && m+1 < ntimes){
+      /* outside of the range being read */
+      memcpy(read_bufs[(m+1)%2], 
 	     read_buf+real_size-for_next_iter, 
 	     for_next_iter);
-      free(read_buf);
-      read_buf = (char *)malloc(for_next_iter+mca_fcoll_two_phase_cycle_buffer_size);
-      memcpy(read_buf, tmp_buf, for_next_iter);
-      free(tmp_buf);
     }
     
     off += size;
@@ -770,9 +791,14 @@ static int two_phase_read_and_exch(mca_io_ompio_file_t *fh,
 			    contig_access_count,
 			    min_st_offset, fd_size, fd_start, fd_end,
 			    flat_buf, others_req, m, buf_idx,
-			    buftype_extent, striping_unit, aggregator_list); 
+			    buftype_extent, striping_unit, num_io_procs, aggregator_list); 
   if (ntimes){ 
-    free(read_buf);
+    for (i=0; i<2; i++) {
+      if (NULL != read_bufs[i]) {
+	free(read_bufs[i]);
+	read_bufs[i] = NULL;
+      }
+    }
     read_buf = NULL;
   }
   if (NULL != curr_offlen_ptr){
@@ -805,6 +831,12 @@ static int two_phase_read_and_exch(mca_io_ompio_file_t *fh,
   }
 
  exit:
+  two_phase_wait_read (&read_req);
+  for (i=0; i<2; i++) {
+    if (NULL != read_bufs[i]) {
+      free(read_bufs[i]);
+    }
+  }
   return ret;
   
 }
@@ -822,7 +854,7 @@ static int two_phase_exchange_data(mca_io_ompio_file_t *fh,
 				   mca_io_ompio_access_array_t *others_req, 
 				   int iter, size_t *buf_idx, 
 				   MPI_Aint buftype_extent, int striping_unit,
-				   int *aggregator_list)
+				   int num_io_procs, int *aggregator_list)
 {
   
   int i=0, j=0, k=0, tmp=0, nprocs_recv=0, nprocs_send=0;
@@ -966,7 +998,7 @@ static int two_phase_exchange_data(mca_io_ompio_file_t *fh,
 				 (unsigned *)recv_size, requests,
 				 recd_from_proc, contig_access_count,
 				 min_st_offset, fd_size, fd_start, fd_end,
-				 buftype_extent, striping_unit, aggregator_list);
+				 buftype_extent, striping_unit, num_io_procs, aggregator_list);
     }
   }
 
@@ -1061,7 +1093,7 @@ static void two_phase_fill_user_buffer(mca_io_ompio_file_t *fh,
 				       OMPI_MPI_OFFSET_TYPE *fd_start, 
 				       OMPI_MPI_OFFSET_TYPE *fd_end,
 				       MPI_Aint buftype_extent,
-				       int striping_unit, int *aggregator_list){
+				       int striping_unit, int num_io_procs, int *aggregator_list){
   
   int i = 0, p = 0, flat_buf_idx = 0;
   OMPI_MPI_OFFSET_TYPE flat_buf_sz = 0, size_in_buf = 0, buf_incr = 0, size = 0;
@@ -1111,7 +1143,7 @@ static void two_phase_fill_user_buffer(mca_io_ompio_file_t *fh,
 					      fd_start,
 					      fd_end,
 					      striping_unit,
-					      mca_fcoll_two_phase_num_io_procs,
+					      num_io_procs,
 					      aggregator_list);
       
       if (recv_buf_idx[p] < recv_size[p]) {
@@ -1168,3 +1200,48 @@ int isread_aggregator(int rank,
   return 0;
 }
 #endif
+
+static int two_phase_start_read(mca_io_ompio_file_t *fh,
+				char *read_buf,
+				OMPI_MPI_OFFSET_TYPE off,
+				OMPI_MPI_OFFSET_TYPE len,
+				ompi_request_t **read_req)
+{
+  int ret = OMPI_SUCCESS;
+
+  fh->f_io_array = (mca_io_ompio_io_array_t *)calloc 
+    (1,sizeof(mca_io_ompio_io_array_t));
+  if (NULL == fh->f_io_array) {
+    opal_output(1, "OUT OF MEMORY\n");
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
+  fh->f_io_array[0].offset = (IOVBASE_TYPE *)(intptr_t)off;
+  fh->f_io_array[0].length = len;
+  fh->f_io_array[0].memory_address = read_buf;
+  fh->f_num_of_io_entries = 1;
+
+  if (OMPI_SUCCESS != fh->f_fbtl->fbtl_ipreadv (fh, NULL, read_req)) {
+    opal_output(1, "READ FAILED\n");
+    ret = OMPI_ERROR;
+  }
+
+  fh->f_num_of_io_entries = 0;
+  free (fh->f_io_array);
+  fh->f_io_array = NULL;
+
+  return ret;
+}
+
+static int two_phase_wait_read(ompi_request_t **read_req)
+{
+  int ret = OMPI_SUCCESS;
+
+  if (MPI_REQUEST_NULL != *read_req) {
+    ret = ompi_request_wait (read_req, MPI_STATUS_IGNORE);
+    if (MPI_REQUEST_NULL != *read_req) {
+      /* not released by the wait on error */
+      ompi_request_free (read_req);
+    }
+  }
+  return ret;
+}
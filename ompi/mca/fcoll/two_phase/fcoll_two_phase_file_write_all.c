@@ -62,7 +62,7 @@ static int two_phase_exch_and_write(mca_io_ompio_file_t *fh,
 				    OMPI_MPI_OFFSET_TYPE *fd_end,
 				    Flatlist_node *flat_buf,
 				    size_t *buf_idx, int striping_unit,
-				    int *aggregator_list);
+				    int num_io_procs, int *aggregator_list);
 
 
 
@@ -85,9 +85,10 @@ static int  two_phase_exchage_data(mca_io_ompio_file_t *fh,
 				   int *send_buf_idx, int *curr_to_proc,
 				   int *done_to_proc, int iter,
 				   size_t *buf_idx, MPI_Aint buftype_extent,
-				   int striping_unit, int *aggregator_list,
+				   int striping_unit, int num_io_procs, int *aggregator_list,
 				   int *hole);
 				   
+static int two_phase_wait_write(ompi_request_t **write_req);
 
 static int two_phase_fill_send_buffer(mca_io_ompio_file_t *fh,
 				      void *buf,
@@ -106,7 +107,7 @@ static int two_phase_fill_send_buffer(mca_io_ompio_file_t *fh,
 				      int *curr_to_proc, 
 				      int *done_to_proc,
 				      int iter, MPI_Aint buftype_extent,
-				      int striping_unit, int *aggregator_list);
+				      int striping_unit, int num_io_procs, int *aggregator_list);
 #if TIME_BREAKDOWN
 static int is_aggregator(int rank,
 			 int nprocs_for_coll,
@@ -151,6 +152,7 @@ mca_fcoll_two_phase_file_write_all (mca_io_ompio_file_t *fh,
   int count_other_req_procs,  ret=OMPI_SUCCESS;
   size_t *buf_indices=NULL;
   int local_count = 0, local_size=0,*aggregator_list = NULL;
+  int num_io_procs = mca_fcoll_two_phase_num_io_procs;
   struct iovec *iov = NULL;
   
   OMPI_MPI_OFFSET_TYPE start_offset, end_offset, fd_size;
@@ -209,36 +211,49 @@ mca_fcoll_two_phase_file_write_all (mca_io_ompio_file_t *fh,
   }
 
   
-  if(-1 == mca_fcoll_two_phase_num_io_procs){
+  if(-1 == num_io_procs && LUSTRE == fh->f_fstype &&
+     fh->f_stripe_count > 0 && fh->f_stripe_size > 0){
+    /* aggregators and file domains following the objects of the file */
+    ret = mca_fcoll_two_phase_stripe_aggregators (fh,
+						  &num_io_procs,
+						  &aggregator_list);
+    if ( OMPI_SUCCESS != ret){
+      return  ret;
+    }
+    striping_unit = fh->f_stripe_size;
+  }
+  else if(-1 == num_io_procs){
     ret = ompi_io_ompio_set_aggregator_props (fh, 
-					      mca_fcoll_two_phase_num_io_procs,
+					      num_io_procs,
 					      max_data);
     if ( OMPI_SUCCESS != ret){
       return  ret;
     }
     
-    mca_fcoll_two_phase_num_io_procs = 
+    num_io_procs = 
       ceil((float)fh->f_size/fh->f_procs_per_group);
     
   }
   
-  if (mca_fcoll_two_phase_num_io_procs > fh->f_size){
-    mca_fcoll_two_phase_num_io_procs = fh->f_size;
+  if (num_io_procs > fh->f_size){
+    num_io_procs = fh->f_size;
   }
   
 #if DEBUG_ON
-  printf("Number of aggregators : %ld\n", mca_fcoll_two_phase_num_io_procs);
+  printf("Number of aggregators : %ld\n", num_io_procs);
 #endif
 
-  aggregator_list = (int *) malloc (mca_fcoll_two_phase_num_io_procs *
-				    sizeof(int));
-  
   if ( NULL == aggregator_list ) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+    aggregator_list = (int *) malloc (num_io_procs *
+				      sizeof(int));
   
-  for (i =0; i< mca_fcoll_two_phase_num_io_procs; i++){
-    aggregator_list[i] = i;
+    if ( NULL == aggregator_list ) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+  
+    for (i =0; i< num_io_procs; i++){
+      aggregator_list[i] = i;
+    }
   }
   
   
@@ -424,14 +439,14 @@ mca_fcoll_two_phase_file_write_all (mca_io_ompio_file_t *fh,
 					       domain_size, 
 					       &fd_size,
 					       striping_unit,
-					       mca_fcoll_two_phase_num_io_procs);
+					       num_io_procs);
     if ( OMPI_SUCCESS != ret ){
       goto exit;
     }
     
     
 #if  DEBUG_ON
-	for (i=0;i<mca_fcoll_two_phase_num_io_procs;i++){
+	for (i=0;i<num_io_procs;i++){
 	  printf("fd_start[%d] : %lld, fd_end[%d] : %lld, local_count: %d\n",
 		   i, fd_start[i], i, fd_end[i], local_count);
 	}
@@ -450,7 +465,7 @@ mca_fcoll_two_phase_file_write_all (mca_io_ompio_file_t *fh,
 						    &my_req,
 						    &buf_indices,
 						    striping_unit,
-						    mca_fcoll_two_phase_num_io_procs,
+						    num_io_procs,
 						    aggregator_list);
 	if ( OMPI_SUCCESS != ret ){
 	  goto exit;
@@ -490,7 +505,7 @@ mca_fcoll_two_phase_file_write_all (mca_io_ompio_file_t *fh,
 				       flat_buf,
 				       buf_indices,
 				       striping_unit,
-				       aggregator_list);
+				       num_io_procs, aggregator_list);
 
 	if (OMPI_SUCCESS != ret){
 	  goto exit;
@@ -505,14 +520,14 @@ mca_fcoll_two_phase_file_write_all (mca_io_ompio_file_t *fh,
 	nentry.time[1] = comm_time;
 	nentry.time[2] = exch_write;
 	if (is_aggregator(fh->f_rank,
-			  mca_fcoll_two_phase_num_io_procs,
+			  num_io_procs,
 			  aggregator_list)){
 	  nentry.aggregator = 1;
 	}
 	else{
 	  nentry.aggregator = 0;
 	}
-	nentry.nprocs_for_coll = mca_fcoll_two_phase_num_io_procs;
+	nentry.nprocs_for_coll = num_io_procs;
 	if (!ompi_io_ompio_full_print_queue(WRITE_PRINT_QUEUE)){
 	  ompi_io_ompio_register_print_entry(WRITE_PRINT_QUEUE,
 					     nentry);
@@ -562,7 +577,7 @@ static int two_phase_exch_and_write(mca_io_ompio_file_t *fh,
 				    OMPI_MPI_OFFSET_TYPE *fd_end,
 				    Flatlist_node *flat_buf,
 				    size_t *buf_idx, int striping_unit,
-				    int *aggregator_list)
+				    int num_io_procs, int *aggregator_list)
     
 {
 
@@ -583,6 +598,10 @@ static int two_phase_exch_and_write(mca_io_ompio_file_t *fh,
     #endif
 
     char *write_buf=NULL;
+    /* cycle m is received in write_bufs[m%2] while the data of cycle m-1
+       is written from the other one */
+    char *write_bufs[2] = {NULL, NULL};
+    ompi_request_t *write_req = MPI_REQUEST_NULL;
 
 
     opal_datatype_type_size(&byte->super,
@@ -620,10 +639,18 @@ static int two_phase_exch_and_write(mca_io_ompio_file_t *fh,
 				       fh->f_comm->c_coll.coll_allreduce_module);
 
     if (ntimes){
-      write_buf = (char *) malloc (mca_fcoll_two_phase_cycle_buffer_size);
-      if ( NULL == write_buf ){
+      write_bufs[0] = (char *) malloc (mca_fcoll_two_phase_cycle_buffer_size);
+      if ( NULL == write_bufs[0] ){
 	return OMPI_ERR_OUT_OF_RESOURCE;
       }
+      if (ntimes > 1) {
+	write_bufs[1] = (char *) malloc (mca_fcoll_two_phase_cycle_buffer_size);
+	if ( NULL == write_bufs[1] ){
+	  free (write_bufs[0]);
+	  return OMPI_ERR_OUT_OF_RESOURCE;
+	}
+      }
+      write_buf = write_bufs[0];
     }
 
     curr_offlen_ptr = (int *) calloc(fh->f_size, sizeof(int)); 
@@ -692,6 +719,7 @@ static int two_phase_exch_and_write(mca_io_ompio_file_t *fh,
     
     ompi_datatype_type_extent(datatype, &buftype_extent);
     for (m=0;m <ntimes; m++){
+	write_buf = write_bufs[m%2];
 	for (i=0; i< fh->f_size; i++) count[i] = recv_size[i] = 0;
 	
 	size = OMPIO_MIN((unsigned)mca_fcoll_two_phase_cycle_buffer_size,
@@ -757,7 +785,7 @@ static int two_phase_exch_and_write(mca_io_ompio_file_t *fh,
 				     send_buf_idx, curr_to_proc,
 				     done_to_proc, m, buf_idx, 
 				     buftype_extent, striping_unit,
-				     aggregator_list, &hole);
+				     num_io_procs, aggregator_list, &hole);
 	
 	if ( OMPI_SUCCESS != ret ){
 	  goto exit;
@@ -789,7 +817,8 @@ static int two_phase_exch_and_write(mca_io_ompio_file_t *fh,
 		(sizeof(mca_io_ompio_io_array_t));
 	    if (NULL == fh->f_io_array) {
 		opal_output(1, "OUT OF MEMORY\n");
-		return OMPI_ERR_OUT_OF_RESOURCE;
+		ret = OMPI_ERR_OUT_OF_RESOURCE;
+		goto exit;
 	    }
 
 	    fh->f_io_array[0].offset  =(IOVBASE_TYPE *)(intptr_t) off;
@@ -807,10 +836,18 @@ static int two_phase_exch_and_write(mca_io_ompio_file_t *fh,
             }
             #endif
 
+	    /* one write in flight: the buffer of the previous cycle is
+	       reused by the next exchange */
+	    ret = two_phase_wait_write (&write_req);
+	    if ( OMPI_SUCCESS != ret ){
+		opal_output(1, "WRITE FAILED\n");
+		goto exit;
+	    }
 	    if (fh->f_num_of_io_entries){
-		if (OMPI_SUCCESS != fh->f_fbtl->fbtl_pwritev (fh, NULL)) {
+		if (OMPI_SUCCESS != fh->f_fbtl->fbtl_ipwritev (fh, NULL, &write_req)) {
 		    opal_output(1, "WRITE FAILED\n");
-		    return OMPI_ERROR;
+		    ret = OMPI_ERROR;
+		    goto exit;
 		}
 	    }
 #if TIME_BREAKDOWN
@@ -832,6 +869,16 @@ static int two_phase_exch_and_write(mca_io_ompio_file_t *fh,
 	done += size;
 	
     }
+    /* in a write_all_begin the last write stays in flight during the
+       remaining exchanges, which do not receive anything here, and
+       completes in write_all_end */
+    if (!fh->f_split_coll_in_use) {
+	ret = two_phase_wait_write (&write_req);
+	if ( OMPI_SUCCESS != ret ){
+	    opal_output(1, "WRITE FAILED\n");
+	    goto exit;
+	}
+    }
     for (i=0; i<fh->f_size; i++) count[i] = recv_size[i] = 0;
     for (m=ntimes; m<max_ntimes; m++) {
       ret = two_phase_exchage_data(fh, buf, write_buf,
@@ -845,17 +892,31 @@ static int two_phase_exch_and_write(mca_io_ompio_file_t *fh,
 				   send_buf_idx, curr_to_proc,
 				   done_to_proc, m, buf_idx,
 				   buftype_extent, striping_unit,
-				   aggregator_list, &hole);
+				   num_io_procs, aggregator_list, &hole);
       if ( OMPI_SUCCESS != ret ){
 	goto exit;
       }
     }
+    if (fh->f_split_coll_in_use && MPI_REQUEST_NULL != write_req) {
+	ompi_io_ompio_split_coll_defer (fh, write_req, write_buf);
+	write_req = MPI_REQUEST_NULL;
+	if (write_bufs[0] == write_buf) {
+	    write_bufs[0] = NULL;
+	}
+	else {
+	    write_bufs[1] = NULL;
+	}
+    }
     
  exit:    
     
+    two_phase_wait_write (&write_req);
     if (ntimes){
-      if ( NULL != write_buf ){
-	free(write_buf);
+      if ( NULL != write_bufs[0] ){
+	free(write_bufs[0]);
+      }
+      if ( NULL != write_bufs[1] ){
+	free(write_bufs[1]);
       }
     }
     if ( NULL != curr_offlen_ptr ){
@@ -911,7 +972,7 @@ static int two_phase_exchage_data(mca_io_ompio_file_t *fh,
 				  int *send_buf_idx, int *curr_to_proc,
 				  int *done_to_proc, int iter,
 				  size_t *buf_idx,MPI_Aint buftype_extent,
-				  int striping_unit, int *aggregator_list,
+				  int striping_unit, int num_io_procs, int *aggregator_list,
 				  int *hole){
   
     int *tmp_len=NULL, sum, *srt_len=NULL, nprocs_recv, nprocs_send,  k,i,j;
@@ -1143,7 +1204,7 @@ static int two_phase_exchage_data(mca_io_ompio_file_t *fh,
 				       fd_start, fd_end, send_buf_idx,
 				       curr_to_proc, done_to_proc,
 				       iter, buftype_extent, striping_unit,
-				       aggregator_list);
+				       num_io_procs, aggregator_list);
       
       if ( OMPI_SUCCESS != ret ){
 	goto exit;
@@ -1243,7 +1304,7 @@ static int two_phase_fill_send_buffer(mca_io_ompio_file_t *fh,
 				      int *curr_to_proc, 
 				      int *done_to_proc,
 				      int iter, MPI_Aint buftype_extent,
-				      int striping_unit, int *aggregator_list){
+				      int striping_unit, int num_io_procs, int *aggregator_list){
 
     int i, p, flat_buf_idx;
     OMPI_MPI_OFFSET_TYPE flat_buf_sz, size_in_buf, buf_incr, size;
@@ -1277,7 +1338,7 @@ static int two_phase_fill_send_buffer(mca_io_ompio_file_t *fh,
 						    fd_start,
 						    fd_end,
 						    striping_unit,
-						    mca_fcoll_two_phase_num_io_procs,
+						    num_io_procs,
 						    aggregator_list);
 
 	    if (send_buf_idx[p] < send_size[p]) {
@@ -1476,3 +1537,17 @@ int is_aggregator(int rank,
   return 0;
 }
 #endif
+
+static int two_phase_wait_write(ompi_request_t **write_req)
+{
+    int ret = OMPI_SUCCESS;
+
+    if (MPI_REQUEST_NULL != *write_req) {
+	ret = ompi_request_wait (write_req, MPI_STATUS_IGNORE);
+	if (MPI_REQUEST_NULL != *write_req) {
+	    /* not released by the wait on error */
+	    ompi_request_free (write_req);
+	}
+    }
+    return ret;
+}
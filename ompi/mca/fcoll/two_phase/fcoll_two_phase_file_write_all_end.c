@@ -30,6 +30,6 @@ mca_fcoll_two_phase_file_write_all_end (mca_io_ompio_file_t *fh,
                                     void *buf,
                                     ompi_status_public_t *status)
 {
-    printf ("DYNAMIC WRITE ALL END\n");
+    /* ompio completes the operation */
     return OMPI_SUCCESS;
 }
@@ -9,6 +9,8 @@
 #include "opal/mca/base/base.h"
 #include "math.h"
 #include "ompi/mca/pml/pml.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/proc/proc.h"
 #include <unistd.h>
 
 /*Based on ROMIO's domain partitioning implementaion 
@@ -67,35 +69,29 @@ int mca_fcoll_two_phase_domain_partition (mca_io_ompio_file_t *fh,
     
     
     if (striping_unit > 0){
-	
-	/* Lock Boundary based domain partitioning */
-	int rem_front, rem_back;
-	OMPI_MPI_OFFSET_TYPE end_off;
-	
-	printf("striping unit based partitioning!\n ");
+
+	/* Domains made of whole stripes, so that a stripe and the lock
+	   covering it belong to a single aggregator. A domain spanning more
+	   than the stripe count is rounded so that the next one starts on
+	   the following object: the aggregators all access the beginning
+	   of their domain in the same cycle, and would otherwise hit the
+	   same server. */
+	OMPI_MPI_OFFSET_TYPE first_stripe, nstripes, stripes_per_agg;
+	int stripe_count = fh->f_stripe_count;
+
+	first_stripe = min_st_offset / striping_unit;
+	nstripes = max_end_offset / striping_unit - first_stripe + 1;
+	stripes_per_agg = (nstripes + nprocs_for_coll - 1) / nprocs_for_coll;
+	if (stripe_count > 1 && stripes_per_agg > stripe_count) {
+	    stripes_per_agg += (stripe_count + 1 - stripes_per_agg % stripe_count) % stripe_count;
+	}
+	fd_size = stripes_per_agg * striping_unit;
+
+	for (i=0; i<nprocs_for_coll; i++) {
+	    fd_start[i] = (first_stripe + i * stripes_per_agg) * striping_unit;
+	    fd_end[i] = fd_start[i] + fd_size - 1;
+	}
 	fd_start[0] = min_st_offset;
-        end_off     = fd_start[0] + fd_size;
-        rem_front   = end_off % striping_unit;
-        rem_back    = striping_unit - rem_front;
-        if (rem_front < rem_back) 
-		end_off -= rem_front;
-        else                      
-		end_off += rem_back;
-        fd_end[0] = end_off - 1;
-    
-	/* align fd_end[i] to the nearest file lock boundary */
-        for (i=1; i<nprocs_for_coll; i++) {
-            fd_start[i] = fd_end[i-1] + 1;
-            end_off     = min_st_offset + fd_size * (i+1);
-            rem_front   = end_off % striping_unit;
-            rem_back    = striping_unit - rem_front;
-            if (rem_front < rem_back) 
-		    end_off -= rem_front;
-            else                      
-		    end_off += rem_back;
-            fd_end[i] = end_off - 1;
-        }
-        fd_end[nprocs_for_coll-1] = max_end_offset;
     }
     else{
 	fd_start[0] = min_st_offset;
@@ -142,8 +138,8 @@ int mca_fcoll_two_phase_calc_aggregator(mca_io_ompio_file_t *fh,
     rank_index = (int) ((off - min_off + fd_size)/ fd_size - 1);
     
     if (striping_unit > 0){
-	rank_index = 0;
-	while (off > fd_end[rank_index]) rank_index++;
+	/* the domains start on a stripe boundary, except the first one */
+	rank_index = (int) ((off - (min_off / striping_unit) * striping_unit) / fd_size);
     }
     
 
@@ -488,3 +484,88 @@ int mca_fcoll_two_phase_calc_my_requests (mca_io_ompio_file_t *fh,
     return OMPI_SUCCESS;
 }
 /*Two-phase support functions ends here!*/				    
+
+
+/* Aggregators for a file striped over f_stripe_count objects:
+   aggregators_per_ost of them for each object, taken in a round robin
+   way over the nodes so that the servers are not all fed through the
+   links of the same nodes. */
+int mca_fcoll_two_phase_stripe_aggregators (mca_io_ompio_file_t *fh,
+					    int *num_aggregators,
+					    int **aggregator_list)
+{
+    int i, n, level, num, node, factor, ret = OMPI_SUCCESS;
+    int *node_of = NULL, *pos_in_node = NULL, *seen = NULL, *list = NULL;
+    ompi_proc_t *proc;
+
+    factor = mca_fcoll_two_phase_aggregators_per_ost;
+    if (factor < 1) {
+	factor = 1;
+    }
+    num = fh->f_stripe_count * factor;
+    if (num > fh->f_size) {
+	num = fh->f_size;
+    }
+
+    list = (int *) malloc (num * sizeof(int));
+    node_of = (int *) malloc (3 * fh->f_size * sizeof(int));
+    if (NULL == list || NULL == node_of) {
+	ret = OMPI_ERR_OUT_OF_RESOURCE;
+	goto exit;
+    }
+    pos_in_node = node_of + fh->f_size;
+    seen = pos_in_node + fh->f_size;
+
+    /* a node is named after the lowest rank running on it */
+    node = fh->f_rank;
+    for (i=0; i<fh->f_rank; i++) {
+	proc = ompi_group_peer_lookup (fh->f_comm->c_local_group, i);
+	if (OPAL_PROC_ON_LOCAL_NODE(proc->proc_flags)) {
+	    node = i;
+	    break;
+	}
+    }
+
+    ret = fh->f_comm->c_coll.coll_allgather (&node,
+					     1,
+					     MPI_INT,
+					     node_of,
+					     1,
+					     MPI_INT,
+					     fh->f_comm,
+					     fh->f_comm->c_coll.coll_allgather_module);
+    if (OMPI_SUCCESS != ret) {
+	goto exit;
+    }
+
+    /* the node names are ranks, count the processes met on each node to
+       get the position of every process on its node */
+    for (i=0; i<fh->f_size; i++) {
+	seen[i] = 0;
+    }
+    for (i=0; i<fh->f_size; i++) {
+	pos_in_node[i] = seen[node_of[i]]++;
+    }
+
+    /* the first process of every node, then the second ... */
+    for (n=0, level=0; n<num; level++) {
+	for (i=0; i<fh->f_size && n<num; i++) {
+	    if (pos_in_node[i] == level) {
+		list[n++] = i;
+	    }
+	}
+    }
+
+    *num_aggregators = num;
+    *aggregator_list = list;
+    list = NULL;
+
+exit:
+    if (NULL != node_of) {
+	free (node_of);
+    }
+    if (NULL != list) {
+	free (list);
+    }
+    return ret;
+}
@@ -50,6 +50,8 @@ mca_fs_lustre_file_open (struct ompi_communicator_t *comm,
     int amode;
     int old_mask, perm;
     int rc;
+    /* errno of the open, stripe size and count of the layout */
+    int layout[3] = {0, 0, 0};
 
     struct lov_user_md *lump=NULL;
 
@@ -74,47 +76,69 @@ mca_fs_lustre_file_open (struct ompi_communicator_t *comm,
     if (access_mode & MPI_MODE_EXCL)
         amode = amode | O_EXCL;
 
-    if ((mca_fs_lustre_stripe_size || mca_fs_lustre_stripe_width) &&
-        (amode&O_CREAT) && (amode&O_RDWR)) {
-        if (0 == fh->f_rank) {
-            llapi_file_create(filename, 
-                              mca_fs_lustre_stripe_size,
-                              -1, /* MSC need to change that */
-                              mca_fs_lustre_stripe_width,
-                              0); /* MSC need to change that */
+    /* The metadata operations -- the create, the layout and the query
+       of the layout -- are done by one process and their results
+       broadcast. The other processes only open the existing file, so
+       the metadata server does not see them once per process. */
+    if (OMPIO_ROOT == fh->f_rank) {
+        if ((mca_fs_lustre_stripe_size || mca_fs_lustre_stripe_width) &&
+            (amode&O_CREAT) && (amode&O_RDWR)) {
+            rc = llapi_file_create(filename, 
+                                   mca_fs_lustre_stripe_size,
+                                   -1, /* MSC need to change that */
+                                   mca_fs_lustre_stripe_width,
+                                   0); /* MSC need to change that */
+            if (0 == rc) {
+                /* this process just created the file */
+                amode &= ~O_EXCL;
+            }
+        }
 
-            fh->fd = open(filename, O_CREAT | O_RDWR | O_LOV_DELAY_CREATE, perm);
-            if (fh->fd < 0) {
-                fprintf(stderr, "Can't open %s file: %d (%s)\n", 
-                        filename, errno, strerror(errno));
-                return OMPI_ERROR;
+        fh->fd = open (filename, amode, perm);
+        if (fh->fd < 0) {
+            layout[0] = errno;
+        }
+        else {
+            /* The file may exist already with another layout than the one
+               given by the parameters, so ask lustre for it. The objects of the
+               layout are returned after the header, make room for all of them. */
+            lump = (struct lov_user_md *) malloc (sizeof(struct lov_user_md) +
+                                                  LOV_MAX_STRIPE_COUNT * sizeof(struct lov_user_ost_data));
+            if (NULL != lump && 0 == llapi_file_get_stripe(filename, lump)) {
+                layout[1] = lump->lmm_stripe_size;
+                layout[2] = lump->lmm_stripe_count;
             }
-            close (fh->fd);
+            free (lump);
         }
-        fh->f_comm->c_coll.coll_barrier (fh->f_comm, 
-                                         fh->f_comm->c_coll.coll_barrier_module);
     }
-
-    fh->fd = open (filename, amode, perm);
-    if (fh->fd < 0) {
+    fh->f_comm->c_coll.coll_bcast (layout,
+                                   3,
+                                   MPI_INT,
+                                   OMPIO_ROOT,
+                                   fh->f_comm,
+                                   fh->f_comm->c_coll.coll_bcast_module);
+    if (0 != layout[0]) {
+        errno = layout[0];
         return OMPI_ERROR;
     }
 
-    if (mca_fs_lustre_stripe_size > 0) {
-        fh->f_stripe_size = mca_fs_lustre_stripe_size;
+    if (OMPIO_ROOT != fh->f_rank) {
+        fh->fd = open (filename, amode & ~(O_CREAT | O_EXCL), perm);
+        if (fh->fd < 0) {
+            return OMPI_ERROR;
+        }
+    }
+
+    if (0 != layout[1]) {
+        fh->f_stripe_size = layout[1];
+        fh->f_stripe_count = layout[2];
     }
     else {
-      lump = (struct lov_user_md  *) malloc (sizeof(struct lov_user_md));
-      if (NULL == lump ){
-	fprintf(stderr,"Cannot Allocate Lump for extracting stripe size\n");
-	return OMPI_ERROR;
-      }
-      rc = llapi_file_get_stripe(filename, lump);
-      if (rc != 0) {
-	  fprintf(stderr, "get_stripe failed: %d (%s)\n",errno, strerror(errno));
-	  return -1;
-      }
-      fh->f_stripe_size = lump->lmm_stripe_size;
+        if (mca_fs_lustre_stripe_size > 0) {
+            fh->f_stripe_size = mca_fs_lustre_stripe_size;
+        }
+        fh->f_stripe_count = mca_fs_lustre_stripe_width;
     }
+
     return OMPI_SUCCESS;
 }
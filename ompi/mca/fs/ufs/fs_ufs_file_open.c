@@ -22,6 +22,7 @@
 #include "fs_ufs.h"
 
 #include <fcntl.h>
+#include <errno.h>
 #include <sys/stat.h>
 #include "mpi.h"
 #include "ompi/constants.h"
@@ -45,6 +46,7 @@ mca_fs_ufs_file_open (struct ompi_communicator_t *comm,
 {
     int amode;
     int old_mask, perm;
+    int err = 0;
 
     if (fh->f_perm == OMPIO_PERM_NULL)  {
         old_mask = umask(022);
@@ -68,6 +70,32 @@ mca_fs_ufs_file_open (struct ompi_communicator_t *comm,
     if (access_mode & MPI_MODE_EXCL)
         amode = amode | O_EXCL;
 
+    if (amode & O_CREAT) {
+        /* only one process creates the file and the others open it
+           once it exists, so that the file system sees a single create
+           instead of one per process */
+        if (OMPIO_ROOT == fh->f_rank) {
+            fh->fd = open (filename, amode, perm);
+            if (-1 == fh->fd) {
+                err = errno;
+            }
+        }
+        fh->f_comm->c_coll.coll_bcast (&err,
+                                       1,
+                                       MPI_INT,
+                                       OMPIO_ROOT,
+                                       fh->f_comm,
+                                       fh->f_comm->c_coll.coll_bcast_module);
+        if (0 != err) {
+            errno = err;
+            return OMPI_ERROR;
+        }
+        if (OMPIO_ROOT == fh->f_rank) {
+            return OMPI_SUCCESS;
+        }
+        amode &= ~(O_CREAT | O_EXCL);
+    }
+
     fh->fd = open (filename, amode, perm);
     if (-1 == fh->fd) {
         return OMPI_ERROR;
@@ -63,6 +63,16 @@ int ompi_io_ompio_set_file_defaults (mca_io_ompio_file_t *fh)
         int i;
 
         fh->f_io_array = NULL;
+        fh->f_fbtl_ptr = NULL;
+        fh->f_sharedfp = NULL;
+        fh->f_sharedfp_ptr = NULL;
+        fh->f_cache = NULL;
+        fh->f_stage = NULL;
+        fh->f_split_coll_in_use = 0;
+        fh->f_split_coll_req = MPI_REQUEST_NULL;
+        fh->f_split_coll_buf = NULL;
+        fh->f_split_coll_bytes = 0;
+        memset (&fh->f_stats, 0, sizeof(mca_io_ompio_stats_t));
         fh->f_perm = OMPIO_PERM_NULL;
         fh->f_flags = 0;
         fh->f_bytes_per_agg = mca_io_ompio_bytes_per_agg;
@@ -91,8 +101,11 @@ int ompi_io_ompio_set_file_defaults (mca_io_ompio_file_t *fh)
         /* Default file View */
         fh->f_iov_type = MPI_DATATYPE_NULL;
         fh->f_stripe_size = mca_io_ompio_bytes_per_agg;
+        fh->f_stripe_count = 0;
 	/*Decoded iovec of the file-view*/
 	fh->f_decoded_iov = NULL;
+        fh->f_view_block_len = 0;
+        fh->f_view_block_starts = NULL;
        
 	mca_io_ompio_set_view_internal(fh,
 				       0,
@@ -434,8 +447,9 @@ int ompi_io_ompio_generate_current_file_view (mca_io_ompio_file_t *fh,
 int ompi_io_ompio_set_explicit_offset (mca_io_ompio_file_t *fh,
                                        OMPI_MPI_OFFSET_TYPE offset)
 {
-    int i = 0;
-    int k = 0;
+    size_t i = 0;
+    size_t k = 0;
+    int lo, hi, mid;
 
     /* starting offset of the current copy of the filew view */
     fh->f_offset = (fh->f_view_extent * 
@@ -453,7 +467,31 @@ int ompi_io_ompio_set_explicit_offset (mca_io_ompio_file_t *fh,
     fh->f_position_in_file_view = 0;
 
     /* determine block id that the offset is located in and
-       the starting offset of that block */
+       the starting offset of that block: directly when all the blocks
+       have the same length, which is the case of the vectors and
+       subarrays, else by bisection over their starts */
+    if (0 < fh->f_view_block_len) {
+        fh->f_index_in_file_view = i / fh->f_view_block_len;
+        fh->f_position_in_file_view = fh->f_index_in_file_view * fh->f_view_block_len;
+        return OMPI_SUCCESS;
+    }
+    if (NULL != fh->f_view_block_starts) {
+        lo = 0;
+        hi = (int) fh->f_iov_count - 1;
+        while (lo < hi) {
+            mid = (lo + hi + 1) / 2;
+            if (fh->f_view_block_starts[mid] <= i) {
+                lo = mid;
+            }
+            else {
+                hi = mid - 1;
+            }
+        }
+        fh->f_index_in_file_view = lo;
+        fh->f_position_in_file_view = fh->f_view_block_starts[lo];
+        return OMPI_SUCCESS;
+    }
+
     k = fh->f_decoded_iov[fh->f_index_in_file_view].iov_len;
     while (i >= k) {
         fh->f_position_in_file_view = k;
@@ -464,6 +502,244 @@ int ompi_io_ompio_set_explicit_offset (mca_io_ompio_file_t *fh,
     return OMPI_SUCCESS;
 }
 
+int ompi_io_ompio_split_coll_begin (mca_io_ompio_file_t *fh,
+                                    int count,
+                                    struct ompi_datatype_t *datatype)
+{
+    size_t size;
+
+    if (fh->f_split_coll_in_use) {
+        opal_output (1, "Only one split collective I/O operation allowed per file handle at a time\n");
+        return MPI_ERR_OTHER;
+    }
+
+    opal_datatype_type_size (&datatype->super, &size);
+    fh->f_split_coll_bytes = count * size;
+    fh->f_split_coll_in_use = 1;
+
+    return OMPI_SUCCESS;
+}
+
+void ompi_io_ompio_split_coll_defer (mca_io_ompio_file_t *fh,
+                                     ompi_request_t *request,
+                                     void *buf)
+{
+    fh->f_split_coll_req = request;
+    fh->f_split_coll_buf = buf;
+}
+
+int ompi_io_ompio_split_coll_end (mca_io_ompio_file_t *fh,
+                                  ompi_status_public_t *status)
+{
+    int ret = OMPI_SUCCESS;
+
+    if (MPI_REQUEST_NULL != fh->f_split_coll_req) {
+        ret = ompi_request_wait (&fh->f_split_coll_req, MPI_STATUS_IGNORE);
+        if (MPI_REQUEST_NULL != fh->f_split_coll_req) {
+            /* not released by the wait on error */
+            ompi_request_free (&fh->f_split_coll_req);
+        }
+        fh->f_split_coll_req = MPI_REQUEST_NULL;
+    }
+    if (NULL != fh->f_split_coll_buf) {
+        free (fh->f_split_coll_buf);
+        fh->f_split_coll_buf = NULL;
+    }
+
+    if (OMPI_SUCCESS == ret && MPI_STATUS_IGNORE != status) {
+        status->_ucount = fh->f_split_coll_bytes;
+    }
+    fh->f_split_coll_in_use = 0;
+
+    return ret;
+}
+
+void ompi_io_ompio_record_fbtl (mca_io_ompio_file_t *fh,
+                                int ops,
+                                double time)
+{
+    unsigned long long bytes = 0;
+    int i;
+
+    for (i = 0 ; i < fh->f_num_of_io_entries ; i++) {
+        bytes += fh->f_io_array[i].length;
+    }
+
+    OMPIO_STATS_ADD(fh, fbtl_calls, 1);
+    OMPIO_STATS_ADD(fh, fbtl_entries, fh->f_num_of_io_entries);
+    OMPIO_STATS_ADD(fh, fbtl_ops, ops);
+    OMPIO_STATS_ADD(fh, fbtl_bytes, bytes);
+    OMPIO_STATS_ADD(fh, fbtl_time, time);
+}
+
+void ompi_io_ompio_stats_mark (mca_io_ompio_file_t *fh,
+                               mca_io_ompio_stats_mark_t *mark)
+{
+    mark->time = MPI_Wtime ();
+    mark->fbtl_time = fh->f_stats.fbtl_time;
+    mark->fbtl_bytes = fh->f_stats.fbtl_bytes;
+}
+
+void ompi_io_ompio_stats_coll (mca_io_ompio_file_t *fh,
+                               const mca_io_ompio_stats_mark_t *mark)
+{
+    double time = MPI_Wtime () - mark->time;
+    double fbtl_time = fh->f_stats.fbtl_time - mark->fbtl_time;
+
+    OMPIO_STATS_ADD(fh, coll_time, time);
+    OMPIO_STATS_ADD(fh, coll_fbtl_time, fbtl_time);
+    OMPIO_STATS_ADD(fh, coll_exchange_time, OMPIO_MAX(time - fbtl_time, 0.0));
+    OMPIO_STATS_ADD(fh, coll_fbtl_bytes, fh->f_stats.fbtl_bytes - mark->fbtl_bytes);
+}
+
+int ompi_io_ompio_print_stats (mca_io_ompio_file_t *fh)
+{
+    /* the counters are summed, the times and the bytes of the
+       aggregators also have their maximum */
+    unsigned long long counts[7], total_counts[7];
+    double times[7], max_times[7], total_times[7];
+    int ret;
+
+    counts[0] = fh->f_stats.bytes_written;
+    counts[1] = fh->f_stats.bytes_read;
+    counts[2] = fh->f_stats.coll_fbtl_bytes;
+    counts[3] = fh->f_stats.fbtl_calls;
+    counts[4] = fh->f_stats.fbtl_entries;
+    counts[5] = fh->f_stats.fbtl_ops;
+    counts[6] = fh->f_stats.fbtl_bytes;
+    times[0] = fh->f_stats.fbtl_time;
+    times[1] = fh->f_stats.coll_time;
+    times[2] = fh->f_stats.coll_fbtl_time;
+    times[3] = fh->f_stats.coll_exchange_time;
+    times[4] = fh->f_stats.indep_time;
+    times[5] = fh->f_stats.sync_time;
+    times[6] = (double) fh->f_stats.coll_fbtl_bytes;
+
+    ret = fh->f_comm->c_coll.coll_reduce (counts, total_counts, 7,
+                                          MPI_UNSIGNED_LONG_LONG, MPI_SUM,
+                                          OMPIO_ROOT, fh->f_comm,
+                                          fh->f_comm->c_coll.coll_reduce_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = fh->f_comm->c_coll.coll_reduce (times, max_times, 7,
+                                          MPI_DOUBLE, MPI_MAX,
+                                          OMPIO_ROOT, fh->f_comm,
+                                          fh->f_comm->c_coll.coll_reduce_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = fh->f_comm->c_coll.coll_reduce (times, total_times, 7,
+                                          MPI_DOUBLE, MPI_SUM,
+                                          OMPIO_ROOT, fh->f_comm,
+                                          fh->f_comm->c_coll.coll_reduce_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    if (OMPIO_ROOT == fh->f_rank) {
+        printf ("ompio summary of %s on %d processes:\n", fh->f_filename, fh->f_size);
+        printf ("  bytes written %llu, read %llu\n", total_counts[0], total_counts[1]);
+        printf ("  fbtl: %llu calls, %llu entries in %llu operations (%.2f entries per operation), "
+                "%llu bytes\n", total_counts[3], total_counts[4], total_counts[5],
+                total_counts[5] ? (double) total_counts[4] / (double) total_counts[5] : 0.0,
+                total_counts[6]);
+        printf ("  collective fbtl bytes %llu, max per process %.0f\n",
+                total_counts[2], max_times[6]);
+        printf ("  time (s)           avg         max\n");
+        printf ("  fbtl          %10.6f  %10.6f\n", total_times[0] / fh->f_size, max_times[0]);
+        printf ("  collective    %10.6f  %10.6f\n", total_times[1] / fh->f_size, max_times[1]);
+        printf ("    file access %10.6f  %10.6f\n", total_times[2] / fh->f_size, max_times[2]);
+        printf ("    exchange    %10.6f  %10.6f\n", total_times[3] / fh->f_size, max_times[3]);
+        printf ("  independent   %10.6f  %10.6f\n", total_times[4] / fh->f_size, max_times[4]);
+        printf ("  sync          %10.6f  %10.6f\n", total_times[5] / fh->f_size, max_times[5]);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+void ompi_io_ompio_save_position (mca_io_ompio_file_t *fh,
+                                  mca_io_ompio_fp_position_t *position)
+{
+    position->f_offset = fh->f_offset;
+    position->f_total_bytes = fh->f_total_bytes;
+    position->f_index_in_file_view = fh->f_index_in_file_view;
+    position->f_position_in_file_view = fh->f_position_in_file_view;
+}
+
+void ompi_io_ompio_restore_position (mca_io_ompio_file_t *fh,
+                                     mca_io_ompio_fp_position_t *position)
+{
+    fh->f_offset = position->f_offset;
+    fh->f_total_bytes = position->f_total_bytes;
+    fh->f_index_in_file_view = position->f_index_in_file_view;
+    fh->f_position_in_file_view = position->f_position_in_file_view;
+}
+
+int ompi_io_ompio_get_shared_offset (mca_io_ompio_file_t *fh,
+                                     size_t bytes,
+                                     OMPI_MPI_OFFSET_TYPE *offset)
+{
+    if (NULL == fh->f_sharedfp) {
+        return MPI_ERR_OTHER;
+    }
+
+    return fh->f_sharedfp->sharedfp_update (fh,
+                                            bytes / fh->f_etype_size,
+                                            offset);
+}
+
+int ompi_io_ompio_get_ordered_offset (mca_io_ompio_file_t *fh,
+                                      size_t bytes,
+                                      OMPI_MPI_OFFSET_TYPE *offset)
+{
+    OMPI_MPI_OFFSET_TYPE etypes, prefix = 0, result[2];
+    int ret;
+
+    if (NULL == fh->f_sharedfp) {
+        return MPI_ERR_OTHER;
+    }
+
+    /* the accesses of the lower ranks come first */
+    etypes = bytes / fh->f_etype_size;
+    ret = fh->f_comm->c_coll.coll_exscan (&etypes,
+                                          &prefix,
+                                          1,
+                                          MPI_OFFSET,
+                                          MPI_SUM,
+                                          fh->f_comm,
+                                          fh->f_comm->c_coll.coll_exscan_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    if (0 == fh->f_rank) {
+        prefix = 0;
+    }
+
+    /* the last process knows the total, it moves the pointer once for
+       everybody, and sends where it was along with its error */
+    if (fh->f_size - 1 == fh->f_rank) {
+        result[1] = fh->f_sharedfp->sharedfp_update (fh,
+                                                     prefix + etypes,
+                                                     &result[0]);
+    }
+    ret = fh->f_comm->c_coll.coll_bcast (result,
+                                         2,
+                                         MPI_OFFSET,
+                                         fh->f_size - 1,
+                                         fh->f_comm,
+                                         fh->f_comm->c_coll.coll_bcast_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    if (OMPI_SUCCESS != (int) result[1]) {
+        return (int) result[1];
+    }
+
+    *offset = result[0] + prefix;
+    return OMPI_SUCCESS;
+}
+
 int ompi_io_ompio_decode_datatype (mca_io_ompio_file_t *fh, 
                                    ompi_datatype_t *datatype,
                                    int count,
@@ -907,6 +1183,7 @@ int ompi_io_ompio_set_aggregator_props (mca_io_ompio_file_t *fh,
     int *dims=NULL, *periods=NULL, *coords=NULL, *coords_tmp=NULL;
     int procs_per_node = 1; /* MSC TODO - Figure out a way to get this info */
     size_t max_bytes_per_proc = 0;
+    size_t bytes_per_agg = 0;
  
 
 
@@ -1121,6 +1398,15 @@ int ompi_io_ompio_set_aggregator_props (mca_io_ompio_file_t *fh,
                                                fh->f_comm,
                                                fh->f_comm->c_coll.coll_allreduce_module);
         }
+        bytes_per_agg = (size_t) fh->f_bytes_per_agg;
+        if (mca_io_ompio_pattern_select && 
+            (fh->f_flags & OMPIO_INTERLEAVED_FVIEW) &&
+            0 < fh->f_stripe_count && fh->f_stripe_count < fh->f_size) {
+            /* interleaved accesses to a striped file: use one aggregator
+               per stripe, so that each one writes to its own server */
+            bytes_per_agg = max_bytes_per_proc * 
+                ((fh->f_size + fh->f_stripe_count - 1) / fh->f_stripe_count);
+        }
         /*
         printf ("BEFORE ADJUSTMENT: %d ---> procs_per_group = %d\n", 
                 fh->f_rank, fh->f_procs_per_group);
@@ -1132,9 +1418,9 @@ int ompi_io_ompio_set_aggregator_props (mca_io_ompio_file_t *fh,
                 fh->f_procs_per_group*bytes_per_proc);
         */
         /* check if the current grouping needs to be expanded or shrinked */
-        if ((size_t)mca_io_ompio_bytes_per_agg < 
+        if (bytes_per_agg < 
             max_bytes_per_proc * fh->f_procs_per_group) {
-            root_offset = ceil ((float)mca_io_ompio_bytes_per_agg/max_bytes_per_proc);
+            root_offset = ceil ((float)bytes_per_agg/max_bytes_per_proc);
 
             if (fh->f_procs_per_group/root_offset != 
                 (fh->f_rank%fh->f_procs_per_group)/root_offset) {
@@ -1144,9 +1430,9 @@ int ompi_io_ompio_set_aggregator_props (mca_io_ompio_file_t *fh,
                 fh->f_procs_per_group = fh->f_procs_per_group%root_offset;
             }
         }
-        else if ((size_t)mca_io_ompio_bytes_per_agg > 
+        else if (bytes_per_agg > 
                  max_bytes_per_proc * fh->f_procs_per_group) {
-            i = ceil ((float)mca_io_ompio_bytes_per_agg/
+            i = ceil ((float)bytes_per_agg/
                       (max_bytes_per_proc * fh->f_procs_per_group));
             root_offset = fh->f_procs_per_group * i;
             i = root_offset;
@@ -42,7 +42,12 @@
 extern int mca_io_ompio_cycle_buffer_size;
 extern int mca_io_ompio_bytes_per_agg;
 extern int mca_io_ompio_record_offset_info;
+extern int mca_io_ompio_cache_size;
+extern int mca_io_ompio_cache_page_size;
 OMPI_DECLSPEC extern int mca_io_ompio_coll_timing_info;
+extern int mca_io_ompio_file_summary;
+extern int mca_io_ompio_pattern_select;
+extern char *mca_io_ompio_stage_dir;
 
 /*
  * Flags
@@ -53,6 +58,10 @@ OMPI_DECLSPEC extern int mca_io_ompio_coll_timing_info;
 #define OMPIO_FILE_VIEW_IS_SET  0x00000008
 #define OMPIO_CONTIGUOUS_FVIEW  0x00000010
 #define OMPIO_AGGREGATOR_IS_SET 0x00000020
+/* the file domains of the processes in the view overlap */
+#define OMPIO_INTERLEAVED_FVIEW 0x00000040
+/* the file domains do not overlap and each one is contiguous */
+#define OMPIO_DISJOINT_FVIEW    0x00000080
 #define QUEUESIZE 2048
 
 #define OMPIO_MIN(a, b) (((a) < (b)) ? (a) : (b))
@@ -127,6 +136,43 @@ typedef struct mca_io_ompio_offlen_array_t{
     int                  process_id;
 }mca_io_ompio_offlen_array_t;
 
+/*
+ * I/O statistics of each file, and of the process for the MPI_T
+ * performance variables. The fbtl time is the time spent in the
+ * blocking fbtl calls, and the exchange time what is left of the time
+ * of the collective operations without it.
+ */
+typedef struct mca_io_ompio_stats_t {
+    unsigned long long bytes_written;    /* by the application */
+    unsigned long long bytes_read;
+    unsigned long long coll_fbtl_bytes;  /* fbtl bytes of the collective operations */
+    unsigned long long fbtl_calls;
+    unsigned long long fbtl_entries;     /* entries of f_io_array they were given */
+    unsigned long long fbtl_ops;         /* system calls or ring operations they issued */
+    unsigned long long fbtl_bytes;
+    double             fbtl_time;
+    double             coll_time;        /* in the collective reads and writes */
+    double             coll_fbtl_time;
+    double             coll_exchange_time;
+    double             indep_time;       /* in the independent reads and writes */
+    double             sync_time;
+} mca_io_ompio_stats_t;
+
+OMPI_DECLSPEC extern mca_io_ompio_stats_t mca_io_ompio_stats;
+
+#define OMPIO_STATS_ADD(fh, field, value)       \
+    do {                                        \
+        (fh)->f_stats.field += (value);         \
+        mca_io_ompio_stats.field += (value);    \
+    } while (0)
+
+/* start of a collective operation, see ompi_io_ompio_stats_coll */
+typedef struct mca_io_ompio_stats_mark_t {
+    double             time;
+    double             fbtl_time;
+    unsigned long long fbtl_bytes;
+} mca_io_ompio_stats_mark_t;
+
 /*To extract time-information */
 typedef struct {
     double time[3];
@@ -162,8 +208,13 @@ struct mca_io_ompio_file_t {
     ompi_info_t           *f_info;
     int32_t                f_flags;
     void                  *f_fs_ptr;
+    void                  *f_fbtl_ptr;
+    void                  *f_sharedfp_ptr;
+    struct mca_io_ompio_cache_t *f_cache;
+    struct mca_io_ompio_stage_t *f_stage;
     int                    f_atomicity;
     size_t                 f_stripe_size;
+    int                    f_stripe_count;
     size_t                 f_cc_size;
     int                    f_bytes_per_agg;
     enum ompio_fs_type     f_fstype;
@@ -182,6 +233,8 @@ struct mca_io_ompio_file_t {
     int               f_index_in_file_view;
     OPAL_PTRDIFF_TYPE f_view_extent;
     size_t            f_view_size;
+    size_t            f_view_block_len;    /* length of every block, 0 if they differ */
+    size_t           *f_view_block_starts; /* view bytes before each block, or NULL */
     ompi_datatype_t  *f_etype;
     ompi_datatype_t  *f_filetype;
     size_t            f_etype_size;
@@ -190,6 +243,15 @@ struct mca_io_ompio_file_t {
     mca_io_ompio_io_array_t *f_io_array;
     int                     f_num_of_io_entries;
 
+    /* split collective in progress, and what the fcoll left in flight
+       to be completed by its _end */
+    int                     f_split_coll_in_use;
+    ompi_request_t         *f_split_coll_req;
+    void                   *f_split_coll_buf;
+    size_t                  f_split_coll_bytes;
+
+    mca_io_ompio_stats_t    f_stats;
+
     /* Hooks for modules to hang things */
     mca_base_component_t *f_fs_component;
     mca_base_component_t *f_fcoll_component;
@@ -214,6 +276,18 @@ struct mca_io_ompio_data_t {
 };
 typedef struct mca_io_ompio_data_t mca_io_ompio_data_t;
 
+/*
+ * The individual file pointer, kept aside by the shared file pointer
+ * operations, which go through the explicit offset ones
+ */
+struct mca_io_ompio_fp_position_t {
+    OMPI_MPI_OFFSET_TYPE f_offset;
+    size_t               f_total_bytes;
+    int                  f_index_in_file_view;
+    size_t               f_position_in_file_view;
+};
+typedef struct mca_io_ompio_fp_position_t mca_io_ompio_fp_position_t;
+
 OMPI_DECLSPEC extern print_queue *coll_write_time;
 OMPI_DECLSPEC extern print_queue *coll_read_time;
 
@@ -253,6 +327,79 @@ OMPI_DECLSPEC int ompi_io_ompio_sort_offlen (mca_io_ompio_offlen_array_t *io_arr
 OMPI_DECLSPEC int ompi_io_ompio_set_explicit_offset (mca_io_ompio_file_t *fh, 
 						     OMPI_MPI_OFFSET_TYPE offset);
 
+/*
+ * Statistics: the fbtl components record each of their calls on the
+ * entries of f_io_array, with the number of operations they issued and
+ * the time it took when they waited for them. A collective operation
+ * is bracketed by ompi_io_ompio_stats_mark and ompi_io_ompio_stats_coll.
+ * ompi_io_ompio_print_stats is collective and prints the summary of the
+ * file on its first process.
+ */
+OMPI_DECLSPEC void ompi_io_ompio_record_fbtl (mca_io_ompio_file_t *fh,
+                                              int ops,
+                                              double time);
+OMPI_DECLSPEC void ompi_io_ompio_stats_mark (mca_io_ompio_file_t *fh,
+                                             mca_io_ompio_stats_mark_t *mark);
+OMPI_DECLSPEC void ompi_io_ompio_stats_coll (mca_io_ompio_file_t *fh,
+                                             const mca_io_ompio_stats_mark_t *mark);
+OMPI_DECLSPEC int ompi_io_ompio_print_stats (mca_io_ompio_file_t *fh);
+
+/*
+ * Split collectives. The fcoll does the operation in its _begin, and
+ * may hand its last file access over with ompi_io_ompio_split_coll_defer
+ * instead of waiting for it, with the buffer to release once it is over;
+ * ompi_io_ompio_split_coll_end waits for it and sets the status.
+ */
+OMPI_DECLSPEC int ompi_io_ompio_split_coll_begin (mca_io_ompio_file_t *fh,
+                                                  int count,
+                                                  struct ompi_datatype_t *datatype);
+OMPI_DECLSPEC void ompi_io_ompio_split_coll_defer (mca_io_ompio_file_t *fh,
+                                                   ompi_request_t *request,
+                                                   void *buf);
+OMPI_DECLSPEC int ompi_io_ompio_split_coll_end (mca_io_ompio_file_t *fh,
+                                                ompi_status_public_t *status);
+
+OMPI_DECLSPEC void ompi_io_ompio_save_position (mca_io_ompio_file_t *fh,
+                                                mca_io_ompio_fp_position_t *position);
+OMPI_DECLSPEC void ompi_io_ompio_restore_position (mca_io_ompio_file_t *fh,
+                                                   mca_io_ompio_fp_position_t *position);
+
+/*
+ * Offset, in etypes, of an access of the given size through the shared
+ * file pointer, which is moved past it. The ordered version is
+ * collective, and places the accesses of the processes in rank order.
+ */
+OMPI_DECLSPEC int ompi_io_ompio_get_shared_offset (mca_io_ompio_file_t *fh,
+                                                   size_t bytes,
+                                                   OMPI_MPI_OFFSET_TYPE *offset);
+OMPI_DECLSPEC int ompi_io_ompio_get_ordered_offset (mca_io_ompio_file_t *fh,
+                                                    size_t bytes,
+                                                    OMPI_MPI_OFFSET_TYPE *offset);
+
+/*
+ * Write-behind cache of the independent writes, in io_ompio_cache.c.
+ * ompi_io_ompio_cache_pwritev takes the place of fbtl_pwritev for the
+ * entries of f_io_array, and the cache has to be flushed before any
+ * access which could see the file.
+ */
+OMPI_DECLSPEC int ompi_io_ompio_cache_init (mca_io_ompio_file_t *fh);
+OMPI_DECLSPEC int ompi_io_ompio_cache_fini (mca_io_ompio_file_t *fh);
+OMPI_DECLSPEC int ompi_io_ompio_cache_flush (mca_io_ompio_file_t *fh);
+OMPI_DECLSPEC int ompi_io_ompio_cache_pwritev (mca_io_ompio_file_t *fh);
+
+/*
+ * Staging of the collective writes in node-local storage, in
+ * io_ompio_stage.c. The collective writes are bracketed by
+ * ompi_io_ompio_stage_begin and ompi_io_ompio_stage_end, and the staged
+ * data is drained in the background; like the cache, the stage has to
+ * be flushed before any other access to the file.
+ */
+OMPI_DECLSPEC int ompi_io_ompio_stage_init (mca_io_ompio_file_t *fh);
+OMPI_DECLSPEC int ompi_io_ompio_stage_fini (mca_io_ompio_file_t *fh);
+OMPI_DECLSPEC int ompi_io_ompio_stage_flush (mca_io_ompio_file_t *fh);
+OMPI_DECLSPEC void ompi_io_ompio_stage_begin (mca_io_ompio_file_t *fh);
+OMPI_DECLSPEC void ompi_io_ompio_stage_end (mca_io_ompio_file_t *fh);
+
 OMPI_DECLSPEC int ompi_io_ompio_generate_current_file_view (mca_io_ompio_file_t *fh,
                                                             size_t max_data,
                                                             struct iovec **f_iov,
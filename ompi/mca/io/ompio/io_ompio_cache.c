@@ -0,0 +1,280 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2013      University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/class/opal_hash_table.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "io_ompio.h"
+
+/*
+ * Write-behind cache of the independent writes.
+ *
+ * The file is cut in pages of mca_io_ompio_cache_page_size bytes, and
+ * the cache holds up to mca_io_ompio_cache_size bytes of them. Each page
+ * keeps a single dirty range: the small writes falling inside or next to
+ * it are merged in memory, one which would leave a hole writes the page
+ * out first. The pages are written in file order, so the fbtl merges the
+ * consecutive ones, when the cache is full, and before any operation
+ * which could observe the file: reads, collective writes, sync, size
+ * changes and close. Pieces of a page or more are not worth copying and
+ * are written directly, after the cache.
+ *
+ * MPI only guarantees that the writes of a process are visible to the
+ * others after a sync, so this is transparent, except in atomic mode
+ * where the cache is bypassed.
+ */
+
+typedef struct mca_io_ompio_cache_page_t {
+    OMPI_MPI_OFFSET_TYPE  index;   /* offset in the file / page size */
+    size_t                lo;      /* dirty bytes: [lo, hi) */
+    size_t                hi;
+    char                 *data;
+} mca_io_ompio_cache_page_t;
+
+struct mca_io_ompio_cache_t {
+    size_t                     page_size;
+    int                        num_pages;
+    int                        used;
+    char                      *buffer;
+    mca_io_ompio_cache_page_t *pages;
+    opal_hash_table_t          table;    /* page index -> page */
+};
+
+static int cache_write (mca_io_ompio_file_t *fh,
+                        mca_io_ompio_io_array_t *entries,
+                        int num_entries)
+{
+    mca_io_ompio_io_array_t *io_array = fh->f_io_array;
+    int num_of_io_entries = fh->f_num_of_io_entries;
+    int ret;
+
+    /* the caller may be in the middle of its own io_array */
+    fh->f_io_array = entries;
+    fh->f_num_of_io_entries = num_entries;
+    ret = (int) fh->f_fbtl->fbtl_pwritev (fh, NULL);
+    fh->f_io_array = io_array;
+    fh->f_num_of_io_entries = num_of_io_entries;
+
+    return ret;
+}
+
+static int cache_write_page (mca_io_ompio_file_t *fh,
+                             mca_io_ompio_cache_page_t *page)
+{
+    mca_io_ompio_io_array_t entry;
+    int ret = OMPI_SUCCESS;
+
+    if (page->hi > page->lo) {
+        entry.memory_address = page->data + page->lo;
+        entry.offset = (IOVBASE_TYPE *)(intptr_t)
+            (page->index * (OMPI_MPI_OFFSET_TYPE) fh->f_cache->page_size + page->lo);
+        entry.length = page->hi - page->lo;
+        ret = cache_write (fh, &entry, 1);
+    }
+    page->lo = page->hi = 0;
+
+    return ret;
+}
+
+static int cache_compare_pages (const void *a, const void *b)
+{
+    const mca_io_ompio_cache_page_t *pa = (const mca_io_ompio_cache_page_t *) a;
+    const mca_io_ompio_cache_page_t *pb = (const mca_io_ompio_cache_page_t *) b;
+
+    if (pa->index < pb->index) {
+        return -1;
+    }
+    return (pa->index > pb->index) ? 1 : 0;
+}
+
+int ompi_io_ompio_cache_init (mca_io_ompio_file_t *fh)
+{
+    struct mca_io_ompio_cache_t *cache;
+    int i;
+
+    fh->f_cache = NULL;
+    if (mca_io_ompio_cache_page_size <= 0 ||
+        mca_io_ompio_cache_size < mca_io_ompio_cache_page_size ||
+        (fh->f_amode & MPI_MODE_RDONLY)) {
+        return OMPI_SUCCESS;
+    }
+
+    cache = (struct mca_io_ompio_cache_t *) malloc (sizeof(struct mca_io_ompio_cache_t));
+    if (NULL == cache) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    cache->page_size = mca_io_ompio_cache_page_size;
+    cache->num_pages = mca_io_ompio_cache_size / mca_io_ompio_cache_page_size;
+    cache->used = 0;
+    cache->buffer = (char *) malloc (cache->num_pages * cache->page_size);
+    cache->pages = (mca_io_ompio_cache_page_t *)
+        malloc (cache->num_pages * sizeof(mca_io_ompio_cache_page_t));
+    if (NULL == cache->buffer || NULL == cache->pages) {
+        if (NULL != cache->buffer) {
+            free (cache->buffer);
+        }
+        if (NULL != cache->pages) {
+            free (cache->pages);
+        }
+        free (cache);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for (i = 0; i < cache->num_pages; i++) {
+        cache->pages[i].data = cache->buffer + i * cache->page_size;
+    }
+    OBJ_CONSTRUCT(&cache->table, opal_hash_table_t);
+    opal_hash_table_init (&cache->table, cache->num_pages);
+
+    fh->f_cache = cache;
+    return OMPI_SUCCESS;
+}
+
+int ompi_io_ompio_cache_flush (mca_io_ompio_file_t *fh)
+{
+    struct mca_io_ompio_cache_t *cache = fh->f_cache;
+    mca_io_ompio_io_array_t *entries;
+    int i, n, ret = OMPI_SUCCESS;
+
+    if (NULL == cache || 0 == cache->used) {
+        return OMPI_SUCCESS;
+    }
+
+    entries = (mca_io_ompio_io_array_t *)
+        malloc (cache->used * sizeof(mca_io_ompio_io_array_t));
+    if (NULL == entries) {
+        /* write the pages one by one */
+        for (i = 0; i < cache->used; i++) {
+            if (OMPI_SUCCESS != cache_write_page (fh, &cache->pages[i])) {
+                ret = OMPI_ERROR;
+            }
+        }
+    }
+    else {
+        /* sorting moves the descriptors under the table, which is reset
+           below anyway */
+        qsort (cache->pages, cache->used, sizeof(mca_io_ompio_cache_page_t),
+               cache_compare_pages);
+        for (i = 0, n = 0; i < cache->used; i++) {
+            if (cache->pages[i].hi > cache->pages[i].lo) {
+                entries[n].memory_address = cache->pages[i].data + cache->pages[i].lo;
+                entries[n].offset = (IOVBASE_TYPE *)(intptr_t)
+                    (cache->pages[i].index * (OMPI_MPI_OFFSET_TYPE) cache->page_size +
+                     cache->pages[i].lo);
+                entries[n].length = cache->pages[i].hi - cache->pages[i].lo;
+                n++;
+            }
+        }
+        /* the fbtl turns a run of consecutive pages into one vector, keep
+           the vectors short */
+        for (i = 0; i < n; i += OMPIO_IOVEC_INITIAL_SIZE) {
+            if (OMPI_SUCCESS != cache_write (fh, entries + i,
+                                             OMPIO_MIN(n - i, OMPIO_IOVEC_INITIAL_SIZE))) {
+                ret = OMPI_ERROR;
+            }
+        }
+        free (entries);
+    }
+
+    opal_hash_table_remove_all (&cache->table);
+    cache->used = 0;
+
+    return ret;
+}
+
+int ompi_io_ompio_cache_pwritev (mca_io_ompio_file_t *fh)
+{
+    struct mca_io_ompio_cache_t *cache = fh->f_cache;
+    mca_io_ompio_cache_page_t *page;
+    OMPI_MPI_OFFSET_TYPE off;
+    size_t len, in_page, chunk;
+    char *mem;
+    int i, ret;
+
+    if (NULL == cache || fh->f_atomicity) {
+        return (int) fh->f_fbtl->fbtl_pwritev (fh, NULL);
+    }
+
+    for (i = 0; i < fh->f_num_of_io_entries; i++) {
+        if (fh->f_io_array[i].length >= cache->page_size) {
+            ret = ompi_io_ompio_cache_flush (fh);
+            if (OMPI_SUCCESS != ret) {
+                return ret;
+            }
+            return (int) fh->f_fbtl->fbtl_pwritev (fh, NULL);
+        }
+    }
+
+    for (i = 0; i < fh->f_num_of_io_entries; i++) {
+        off = (OMPI_MPI_OFFSET_TYPE)(intptr_t) fh->f_io_array[i].offset;
+        mem = (char *) fh->f_io_array[i].memory_address;
+        len = fh->f_io_array[i].length;
+
+        while (len > 0) {
+            in_page = off % cache->page_size;
+            chunk = OMPIO_MIN(len, cache->page_size - in_page);
+
+            if (OPAL_SUCCESS != opal_hash_table_get_value_uint64 (&cache->table,
+                                                                  off / cache->page_size,
+                                                                  (void **) &page)) {
+                if (cache->used == cache->num_pages) {
+                    ret = ompi_io_ompio_cache_flush (fh);
+                    if (OMPI_SUCCESS != ret) {
+                        return ret;
+                    }
+                }
+                page = &cache->pages[cache->used++];
+                page->index = off / cache->page_size;
+                page->lo = page->hi = in_page;
+                opal_hash_table_set_value_uint64 (&cache->table, page->index, page);
+            }
+            else if (in_page > page->hi || in_page + chunk < page->lo) {
+                ret = cache_write_page (fh, page);
+                if (OMPI_SUCCESS != ret) {
+                    return ret;
+                }
+                page->lo = page->hi = in_page;
+            }
+
+            memcpy (page->data + in_page, mem, chunk);
+            page->lo = OMPIO_MIN(page->lo, in_page);
+            page->hi = OMPIO_MAX(page->hi, in_page + chunk);
+
+            off += chunk;
+            mem += chunk;
+            len -= chunk;
+        }
+    }
+
+    return OMPI_SUCCESS;
+}
+
+int ompi_io_ompio_cache_fini (mca_io_ompio_file_t *fh)
+{
+    struct mca_io_ompio_cache_t *cache = fh->f_cache;
+    int ret;
+
+    if (NULL == cache) {
+        return OMPI_SUCCESS;
+    }
+
+    ret = ompi_io_ompio_cache_flush (fh);
+
+    OBJ_DESTRUCT(&cache->table);
+    free (cache->pages);
+    free (cache->buffer);
+    free (cache);
+    fh->f_cache = NULL;
+
+    return ret;
+}
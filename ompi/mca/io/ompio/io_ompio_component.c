@@ -19,10 +19,13 @@
 
 #include "ompi_config.h"
 
+#include <string.h>
+
 #include "mpi.h"
 #include "opal/class/opal_list.h"
 #include "opal/threads/mutex.h"
 #include "opal/mca/base/base.h"
+#include "opal/mca/base/mca_base_pvar.h"
 #include "ompi/mca/io/io.h"
 #include "io_ompio.h"
 
@@ -30,12 +33,21 @@ int mca_io_ompio_cycle_buffer_size = OMPIO_PREALLOC_MAX_BUF_SIZE;
 int mca_io_ompio_bytes_per_agg = OMPIO_PREALLOC_MAX_BUF_SIZE;
 int mca_io_ompio_record_offset_info = 0;
 int mca_io_ompio_coll_timing_info = 0;
+int mca_io_ompio_cache_size = 0;
+int mca_io_ompio_cache_page_size = 65536;
+int mca_io_ompio_file_summary = 0;
+int mca_io_ompio_pattern_select = 1;
+char *mca_io_ompio_stage_dir = NULL;
+mca_io_ompio_stats_t mca_io_ompio_stats;
 
 
 /*
  * Private functions
  */
 static int register_component(void);
+static void register_stats_pvar(const char *name, const char *description,
+                                int var_class, mca_base_var_type_t type, void *ctx);
+static int get_fbtl_merge_ratio(const struct mca_base_pvar_t *pvar, void *value, void *obj);
 static int open_component(void);
 static int close_component(void);
 static int init_query(bool enable_progress_threads,
@@ -183,6 +195,110 @@ static int register_component(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_io_ompio_bytes_per_agg);
 
+    mca_io_ompio_pattern_select = 1;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "pattern_select",
+                                           "Use the layout of the file view of all processes (whether their file "
+                                           "domains overlap) to select the fcoll component, and the stripe count "
+                                           "of the file to bound the number of aggregators (0: disabled)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_pattern_select);
+
+    mca_io_ompio_cache_size = 0;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "cache_size",
+                                           "Size in bytes of the write-behind cache of the independent writes of each file (0: disabled)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_cache_size);
+
+    mca_io_ompio_cache_page_size = 65536;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "cache_page_size",
+                                           "Size in bytes of the pages of the write-behind cache",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_cache_page_size);
+
+    mca_io_ompio_file_summary = 0;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "file_summary",
+                                           "Print a summary of the I/O statistics of each file when it is closed",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_file_summary);
+
+    mca_io_ompio_stage_dir = NULL;
+    (void) mca_base_component_var_register(&mca_io_ompio_component.io_version,
+                                           "stage_dir",
+                                           "Node-local directory where the collective writes are staged "
+                                           "before being copied to the file in the background (default: "
+                                           "none, the ompio_stage_dir info key can also set it per file)",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_io_ompio_stage_dir);
+
+    /* statistics of all the files of the process */
+    memset (&mca_io_ompio_stats, 0, sizeof(mca_io_ompio_stats_t));
+    register_stats_pvar("bytes_written", "Bytes written by the application",
+                        MPI_T_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG,
+                        &mca_io_ompio_stats.bytes_written);
+    register_stats_pvar("bytes_read", "Bytes read by the application",
+                        MPI_T_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG,
+                        &mca_io_ompio_stats.bytes_read);
+    register_stats_pvar("coll_fbtl_bytes", "Bytes read or written by this process as an "
+                        "aggregator of the collective operations",
+                        MPI_T_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG,
+                        &mca_io_ompio_stats.coll_fbtl_bytes);
+    register_stats_pvar("fbtl_calls", "Number of fbtl read and write calls",
+                        MPI_T_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG,
+                        &mca_io_ompio_stats.fbtl_calls);
+    register_stats_pvar("fbtl_entries", "Number of pieces of data passed to the fbtl calls",
+                        MPI_T_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG,
+                        &mca_io_ompio_stats.fbtl_entries);
+    register_stats_pvar("fbtl_ops", "Number of system calls or ring operations issued by "
+                        "the fbtl calls once the contiguous pieces are merged",
+                        MPI_T_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG,
+                        &mca_io_ompio_stats.fbtl_ops);
+    register_stats_pvar("fbtl_bytes", "Bytes read or written by the fbtl calls",
+                        MPI_T_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG,
+                        &mca_io_ompio_stats.fbtl_bytes);
+    register_stats_pvar("fbtl_time", "Seconds spent in the blocking fbtl calls",
+                        MPI_T_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE,
+                        &mca_io_ompio_stats.fbtl_time);
+    register_stats_pvar("coll_time", "Seconds spent in the collective reads and writes",
+                        MPI_T_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE,
+                        &mca_io_ompio_stats.coll_time);
+    register_stats_pvar("coll_fbtl_time", "Seconds of the collective reads and writes "
+                        "spent in the fbtl calls",
+                        MPI_T_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE,
+                        &mca_io_ompio_stats.coll_fbtl_time);
+    register_stats_pvar("coll_exchange_time", "Seconds of the collective reads and writes "
+                        "spent outside of the fbtl calls: exchange of the data and waiting "
+                        "for the other processes",
+                        MPI_T_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE,
+                        &mca_io_ompio_stats.coll_exchange_time);
+    register_stats_pvar("indep_time", "Seconds spent in the independent reads and writes",
+                        MPI_T_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE,
+                        &mca_io_ompio_stats.indep_time);
+    register_stats_pvar("sync_time", "Seconds spent in MPI_File_sync",
+                        MPI_T_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE,
+                        &mca_io_ompio_stats.sync_time);
+    (void) mca_base_component_pvar_register(&mca_io_ompio_component.io_version,
+                                            "fbtl_merge_ratio",
+                                            "Average number of pieces of data per operation "
+                                            "issued by the fbtl calls",
+                                            OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_GENERIC,
+                                            MCA_BASE_VAR_TYPE_DOUBLE, NULL, MPI_T_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            get_fbtl_merge_ratio, NULL, NULL, NULL);
+
     /*
     reg_string(&mca_io_ompio_component.io_version,
                               "user_configure_params", 
@@ -199,6 +315,24 @@ static int register_component(void)
     return OMPI_SUCCESS;
 }
 
+static void register_stats_pvar(const char *name, const char *description,
+                                int var_class, mca_base_var_type_t type, void *ctx)
+{
+    (void) mca_base_component_pvar_register(&mca_io_ompio_component.io_version,
+                                            name, description, OPAL_INFO_LVL_4,
+                                            var_class, type, NULL, MPI_T_BIND_NO_OBJECT,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            NULL, NULL, NULL, ctx);
+}
+
+static int get_fbtl_merge_ratio(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    *(double *) value = mca_io_ompio_stats.fbtl_ops ?
+        (double) mca_io_ompio_stats.fbtl_entries / (double) mca_io_ompio_stats.fbtl_ops : 0.0;
+
+    return OMPI_SUCCESS;
+}
+
 static int open_component(void)
 {
     /* Create the mutex */
@@ -28,6 +28,8 @@
 #include "ompi/mca/fcoll/base/base.h"
 #include "ompi/mca/fbtl/fbtl.h"
 #include "ompi/mca/fbtl/base/base.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/sharedfp/base/base.h"
 
 #include <unistd.h>
 #include "io_ompio.h"
@@ -139,14 +141,45 @@ mca_io_ompio_file_open (ompi_communicator_t *comm,
 
     fh->f_flags |= OMPIO_FILE_IS_OPEN;
 
+    /* A file can be used without shared file pointer, the operations
+       needing it fail then */
+    if (OMPI_SUCCESS != mca_sharedfp_base_file_select (&data->ompio_fh, 
+                                                       NULL)) {
+        opal_output(1, "mca_sharedfp_base_file_select() failed\n");
+        data->ompio_fh.f_sharedfp = NULL;
+    }
+
+    ret = ompi_io_ompio_cache_init (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        goto fn_fail;
+    }
+    ret = ompi_io_ompio_stage_init (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        goto fn_fail;
+    }
+
     /* If file has been opened in the append mode, move the internal 
        file pointer of OMPIO to the very end of the file. */
     if ( data->ompio_fh.f_amode & MPI_MODE_APPEND ) {
-	OMPI_MPI_OFFSET_TYPE current_size;
+	OMPI_MPI_OFFSET_TYPE current_size = 0;
 
-        data->ompio_fh.f_fs->fs_file_get_size (&data->ompio_fh, 
-					       &current_size);
+        /* asking the file system for the size is a metadata operation,
+           do it once */
+        if (OMPIO_ROOT == data->ompio_fh.f_rank) {
+            data->ompio_fh.f_fs->fs_file_get_size (&data->ompio_fh, 
+                                                   &current_size);
+        }
+        data->ompio_fh.f_comm->c_coll.coll_bcast (&current_size,
+                                                  1,
+                                                  MPI_LONG_LONG,
+                                                  OMPIO_ROOT,
+                                                  data->ompio_fh.f_comm,
+                                                  data->ompio_fh.f_comm->c_coll.coll_bcast_module);
 	ompi_io_ompio_set_explicit_offset (&data->ompio_fh, current_size);
+        if (NULL != data->ompio_fh.f_sharedfp) {
+            data->ompio_fh.f_sharedfp->sharedfp_seek (&data->ompio_fh, 
+                                                      current_size);
+        }
     }
 
 
@@ -200,6 +233,18 @@ mca_io_ompio_file_close (ompi_file_t *fh)
 	delete_flag = 1;
     }
 
+    /* the pending writes of the cache, of the stage, or of a split
+       collective never ended, have to reach the file before it is
+       closed, and possibly deleted */
+    if (data->ompio_fh.f_split_coll_in_use) {
+        ompi_io_ompio_split_coll_end (&data->ompio_fh, MPI_STATUS_IGNORE);
+    }
+    ompi_io_ompio_cache_fini (&data->ompio_fh);
+    ompi_io_ompio_stage_fini (&data->ompio_fh);
+    if (mca_io_ompio_file_summary) {
+        ompi_io_ompio_print_stats (&data->ompio_fh);
+    }
+
     ret = data->ompio_fh.f_fs->fs_file_close (&data->ompio_fh);
     if ( delete_flag && 0 == data->ompio_fh.f_rank ) {
 	mca_io_ompio_file_delete ( data->ompio_fh.f_filename, MPI_INFO_NULL );
@@ -210,6 +255,7 @@ mca_io_ompio_file_close (ompi_file_t *fh)
     mca_fs_base_file_unselect (&data->ompio_fh);
     mca_fbtl_base_file_unselect (&data->ompio_fh);
     mca_fcoll_base_file_unselect (&data->ompio_fh);
+    mca_sharedfp_base_file_unselect (&data->ompio_fh);
 
     if (NULL != data->ompio_fh.f_io_array) {
         free (data->ompio_fh.f_io_array);
@@ -226,6 +272,11 @@ mca_io_ompio_file_close (ompi_file_t *fh)
         data->ompio_fh.f_decoded_iov = NULL;
     }
 
+    if (NULL != data->ompio_fh.f_view_block_starts) {
+        free (data->ompio_fh.f_view_block_starts);
+        data->ompio_fh.f_view_block_starts = NULL;
+    }
+
     if (NULL != data->ompio_fh.f_convertor) {
         free (data->ompio_fh.f_convertor);
         data->ompio_fh.f_convertor = NULL;
@@ -389,6 +440,15 @@ mca_io_ompio_file_set_size (ompi_file_t *fh,
         return OMPI_ERROR;
     }
 
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = ompi_io_ompio_stage_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
     ret = data->ompio_fh.f_fs->fs_file_set_size (&data->ompio_fh, size);
 
     return ret;
@@ -403,6 +463,15 @@ mca_io_ompio_file_get_size (ompi_file_t *fh,
 
     data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
 
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = ompi_io_ompio_stage_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
     ret = data->ompio_fh.f_fs->fs_file_get_size (&data->ompio_fh, size);
 
     return ret;
@@ -488,6 +557,12 @@ mca_io_ompio_file_set_atomicity (ompi_file_t *fh,
         return OMPI_ERROR;
     }
 
+    /* the writes done before are visible once the mode is atomic */
+    if (flag && (OMPI_SUCCESS != ompi_io_ompio_cache_flush (&data->ompio_fh) ||
+                 OMPI_SUCCESS != ompi_io_ompio_stage_flush (&data->ompio_fh))) {
+        return OMPI_ERROR;
+    }
+
     data->ompio_fh.f_atomicity = flag;
 
     return OMPI_SUCCESS;
@@ -511,10 +586,21 @@ mca_io_ompio_file_sync (ompi_file_t *fh)
 {
     int ret = OMPI_SUCCESS;
     mca_io_ompio_data_t *data;
+    double start = MPI_Wtime ();
 
     data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
 
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = ompi_io_ompio_stage_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
     ret = data->ompio_fh.f_fs->fs_file_sync (&data->ompio_fh);
+    OMPIO_STATS_ADD(&data->ompio_fh, sync_time, MPI_Wtime () - start);
 
     return ret;
 }
@@ -547,6 +633,14 @@ mca_io_ompio_file_seek (ompi_file_t *fh,
         }
         break;
     case MPI_SEEK_END:
+        ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
+        ret = ompi_io_ompio_stage_flush (&data->ompio_fh);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
         ret = data->ompio_fh.f_fs->fs_file_get_size (&data->ompio_fh, 
                                                      &temp_offset);
         offset += temp_offset;
@@ -623,8 +717,47 @@ mca_io_ompio_file_seek_shared (ompi_file_t *fh,
                                OMPI_MPI_OFFSET_TYPE offset,
                                int whence)
 {
-    int ret = MPI_ERR_OTHER;
-    return ret;
+    int ret = OMPI_SUCCESS;
+    mca_io_ompio_data_t *data;
+    OMPI_MPI_OFFSET_TYPE current;
+
+    data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
+    if (NULL == data->ompio_fh.f_sharedfp) {
+        return MPI_ERR_OTHER;
+    }
+
+    /* the shared file pointer is in etypes, its seek is collective and
+       waits for everybody to have read the current value */
+    switch(whence) {
+    case MPI_SEEK_SET:
+        break;
+    case MPI_SEEK_CUR:
+        ret = data->ompio_fh.f_sharedfp->sharedfp_update (&data->ompio_fh, 
+                                                          0,
+                                                          &current);
+        offset += current;
+        break;
+    case MPI_SEEK_END:
+        ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
+        ret = ompi_io_ompio_stage_flush (&data->ompio_fh);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
+        ret = data->ompio_fh.f_fs->fs_file_get_size (&data->ompio_fh, 
+                                                     &current);
+        offset += current / data->ompio_fh.f_etype_size;
+        break;
+    default:
+        return OMPI_ERROR;
+    }
+    if (OMPI_SUCCESS != ret || offset < 0) {
+        return OMPI_ERROR;
+    }
+
+    return data->ompio_fh.f_sharedfp->sharedfp_seek (&data->ompio_fh, offset);
 }
 
 
@@ -632,6 +765,14 @@ int
 mca_io_ompio_file_get_position_shared (ompi_file_t *fh,
                                        OMPI_MPI_OFFSET_TYPE * offset)
 {
-    int ret = MPI_ERR_OTHER;
-    return ret;
+    mca_io_ompio_data_t *data;
+
+    data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
+    if (NULL == data->ompio_fh.f_sharedfp) {
+        return MPI_ERR_OTHER;
+    }
+
+    return data->ompio_fh.f_sharedfp->sharedfp_update (&data->ompio_fh, 
+                                                       0,
+                                                       offset);
 }
@@ -53,6 +53,7 @@ mca_io_ompio_file_read (ompi_file_t *fp,
     struct iovec *decoded_iov = NULL;
 
     size_t max_data = 0; 
+    double start = MPI_Wtime ();
     int i = 0; /* index into the decoded iovec of the buffer */
     int j = 0; /* index into the file vie iovec */
     int k = 0; /* index into the io_array */
@@ -75,6 +76,16 @@ mca_io_ompio_file_read (ompi_file_t *fp,
       return ret;
     }
 
+    /* the data of the write-behind cache may be read back */
+    ret = ompi_io_ompio_cache_flush (fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = ompi_io_ompio_stage_flush (fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
     ompi_io_ompio_decode_datatype (fh, 
                                    datatype, 
                                    count, 
@@ -220,6 +231,9 @@ mca_io_ompio_file_read (ompi_file_t *fp,
         decoded_iov = NULL;
     }
 
+    OMPIO_STATS_ADD(fh, indep_time, MPI_Wtime () - start);
+    OMPIO_STATS_ADD(fh, bytes_read, max_data);
+
     if ( MPI_STATUS_IGNORE != status ) {
 	status->_ucount = max_data;
     }
@@ -259,15 +273,30 @@ mca_io_ompio_file_read_all (ompi_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
     mca_io_ompio_data_t *data;
+    mca_io_ompio_stats_mark_t mark;
+    size_t type_size;
 
     data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
 
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = ompi_io_ompio_stage_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_stats_mark (&data->ompio_fh, &mark);
     ret = data->ompio_fh.
         f_fcoll->fcoll_file_read_all (&data->ompio_fh, 
                                      buf, 
                                      count, 
                                      datatype,
                                      status);
+    ompi_io_ompio_stats_coll (&data->ompio_fh, &mark);
+    opal_datatype_type_size (&datatype->super, &type_size);
+    OMPIO_STATS_ADD(&data->ompio_fh, bytes_read, (size_t) count * type_size);
     if ( MPI_STATUS_IGNORE != status ) {
 	size_t size;
 
@@ -286,14 +315,34 @@ mca_io_ompio_file_read_all_begin (ompi_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
     mca_io_ompio_data_t *data;
+    mca_io_ompio_stats_mark_t mark;
+    size_t type_size;
 
     data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
 
+    ret = ompi_io_ompio_split_coll_begin (&data->ompio_fh, count, datatype);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = ompi_io_ompio_stage_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_stats_mark (&data->ompio_fh, &mark);
     ret = data->ompio_fh.
         f_fcoll->fcoll_file_read_all_begin (&data->ompio_fh, 
                                            buf, 
                                            count,
                                            datatype);
+    ompi_io_ompio_stats_coll (&data->ompio_fh, &mark);
+    opal_datatype_type_size (&datatype->super, &type_size);
+    OMPIO_STATS_ADD(&data->ompio_fh, bytes_read, (size_t) count * type_size);
 
     return ret;
 }
@@ -312,6 +361,9 @@ mca_io_ompio_file_read_all_end (ompi_file_t *fh,
         f_fcoll->fcoll_file_read_all_end (&data->ompio_fh, 
                                          buf, 
                                          status);
+    if (OMPI_SUCCESS != ompi_io_ompio_split_coll_end (&data->ompio_fh, status)) {
+        ret = OMPI_ERROR;
+    }
 
     return ret;
 }
@@ -326,17 +378,32 @@ mca_io_ompio_file_read_at_all (ompi_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
     mca_io_ompio_data_t *data;
+    mca_io_ompio_stats_mark_t mark;
+    size_t type_size;
 
     data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
 
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = ompi_io_ompio_stage_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
     ompi_io_ompio_set_explicit_offset (&data->ompio_fh, offset);
 
+    ompi_io_ompio_stats_mark (&data->ompio_fh, &mark);
     ret = data->ompio_fh.
         f_fcoll->fcoll_file_read_all (&data->ompio_fh, 
                                      buf, 
                                      count,
                                      datatype, 
                                      status);
+    ompi_io_ompio_stats_coll (&data->ompio_fh, &mark);
+    opal_datatype_type_size (&datatype->super, &type_size);
+    OMPIO_STATS_ADD(&data->ompio_fh, bytes_read, (size_t) count * type_size);
     return ret;
 }
 
@@ -349,16 +416,36 @@ mca_io_ompio_file_read_at_all_begin (ompi_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
     mca_io_ompio_data_t *data;
+    mca_io_ompio_stats_mark_t mark;
+    size_t type_size;
 
     data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
 
+    ret = ompi_io_ompio_split_coll_begin (&data->ompio_fh, count, datatype);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    ret = ompi_io_ompio_stage_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
     ompi_io_ompio_set_explicit_offset (&data->ompio_fh, offset);
 
+    ompi_io_ompio_stats_mark (&data->ompio_fh, &mark);
     ret = data->ompio_fh.
         f_fcoll->fcoll_file_read_all_begin (&data->ompio_fh, 
                                            buf,
                                            count, 
                                            datatype);
+    ompi_io_ompio_stats_coll (&data->ompio_fh, &mark);
+    opal_datatype_type_size (&datatype->super, &type_size);
+    OMPIO_STATS_ADD(&data->ompio_fh, bytes_read, (size_t) count * type_size);
 
     return ret;
 }
@@ -377,6 +464,9 @@ mca_io_ompio_file_read_at_all_end (ompi_file_t *fh,
         f_fcoll->fcoll_file_read_all_end (&data->ompio_fh, 
                                          buf, 
                                          status);
+    if (OMPI_SUCCESS != ompi_io_ompio_split_coll_end (&data->ompio_fh, status)) {
+        ret = OMPI_ERROR;
+    }
 
     return ret;
 }
@@ -411,7 +501,29 @@ mca_io_ompio_file_read_shared (ompi_file_t *fh,
                                struct ompi_datatype_t *datatype,
                                ompi_status_public_t * status)
 {
-    int ret = MPI_ERR_OTHER;
+    int ret = OMPI_SUCCESS;
+    mca_io_ompio_data_t *data;
+    mca_io_ompio_fp_position_t position;
+    OMPI_MPI_OFFSET_TYPE offset;
+
+    data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
+
+    ret = ompi_io_ompio_get_shared_offset (&data->ompio_fh,
+                                           count * datatype->super.size,
+                                           &offset);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_save_position (&data->ompio_fh, &position);
+    ret = mca_io_ompio_file_read_at (fh,
+                                     offset,
+                                     buf,
+                                     count,
+                                     datatype,
+                                     status);
+    ompi_io_ompio_restore_position (&data->ompio_fh, &position);
+
     return ret;
 }
 
@@ -422,7 +534,29 @@ mca_io_ompio_file_iread_shared (ompi_file_t *fh,
                                 struct ompi_datatype_t *datatype,
                                 ompi_request_t **request)
 {
-    int ret = MPI_ERR_OTHER;
+    int ret = OMPI_SUCCESS;
+    mca_io_ompio_data_t *data;
+    mca_io_ompio_fp_position_t position;
+    OMPI_MPI_OFFSET_TYPE offset;
+
+    data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
+
+    ret = ompi_io_ompio_get_shared_offset (&data->ompio_fh,
+                                           count * datatype->super.size,
+                                           &offset);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_save_position (&data->ompio_fh, &position);
+    ret = mca_io_ompio_file_iread_at (fh,
+                                      offset,
+                                      buf,
+                                      count,
+                                      datatype,
+                                      request);
+    ompi_io_ompio_restore_position (&data->ompio_fh, &position);
+
     return ret;
 }
 
@@ -433,7 +567,29 @@ mca_io_ompio_file_read_ordered (ompi_file_t *fh,
                                 struct ompi_datatype_t *datatype,
                                 ompi_status_public_t * status)
 {
-    int ret = MPI_ERR_OTHER;
+    int ret = OMPI_SUCCESS;
+    mca_io_ompio_data_t *data;
+    mca_io_ompio_fp_position_t position;
+    OMPI_MPI_OFFSET_TYPE offset;
+
+    data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
+
+    ret = ompi_io_ompio_get_ordered_offset (&data->ompio_fh,
+                                            count * datatype->super.size,
+                                            &offset);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_save_position (&data->ompio_fh, &position);
+    ret = mca_io_ompio_file_read_at_all (fh,
+                                         offset,
+                                         buf,
+                                         count,
+                                         datatype,
+                                         status);
+    ompi_io_ompio_restore_position (&data->ompio_fh, &position);
+
     return ret;
 }
 
@@ -443,15 +599,37 @@ mca_io_ompio_file_read_ordered_begin (ompi_file_t *fh,
                                       int count,
                                       struct ompi_datatype_t *datatype)
 {
-    int ret = MPI_ERR_OTHER;
+    int ret = OMPI_SUCCESS;
+    mca_io_ompio_data_t *data;
+    mca_io_ompio_fp_position_t position;
+    OMPI_MPI_OFFSET_TYPE offset;
+
+    data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
+
+    ret = ompi_io_ompio_get_ordered_offset (&data->ompio_fh,
+                                            count * datatype->super.size,
+                                            &offset);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_save_position (&data->ompio_fh, &position);
+    ret = mca_io_ompio_file_read_at_all_begin (fh,
+                                               offset,
+                                               buf,
+                                               count,
+                                               datatype);
+    ompi_io_ompio_restore_position (&data->ompio_fh, &position);
+
     return ret;
 }
 
 int
 mca_io_ompio_file_read_ordered_end (ompi_file_t *fh,
                                     void *buf,
-                                    ompi_status_public_t * status)
+                                    ompi_status_public_t *status)
 {
-    int ret = MPI_ERR_OTHER;
-    return ret;
+    return mca_io_ompio_file_read_at_all_end (fh,
+                                              buf,
+                                              status);
 }
@@ -30,6 +30,7 @@
 #include "opal/datatype/opal_convertor.h"
 #include "ompi/datatype/ompi_datatype.h"
 #include <stdlib.h>
+#include <limits.h>
 #include <stdio.h>
 
 #include <unistd.h>
@@ -47,6 +48,7 @@ int mca_io_ompio_set_view_internal(mca_io_ompio_file_t *fh,
 {
     size_t max_data = 0;
     MPI_Aint lb,ub;    
+    uint32_t i;
 
     fh->f_iov_count   = 0;
     fh->f_disp        = disp;
@@ -61,6 +63,34 @@ int mca_io_ompio_set_view_internal(mca_io_ompio_file_t *fh,
                                    &fh->f_decoded_iov, 
                                    &fh->f_iov_count);
 
+    /* keep what set_explicit_offset needs to find the block of an offset
+       without walking the view */
+    if (NULL != fh->f_view_block_starts) {
+        free (fh->f_view_block_starts);
+        fh->f_view_block_starts = NULL;
+    }
+    fh->f_view_block_len = 0;
+    if (0 < fh->f_iov_count) {
+        fh->f_view_block_len = fh->f_decoded_iov[0].iov_len;
+        for (i = 1 ; i < fh->f_iov_count ; i++) {
+            if (fh->f_decoded_iov[i].iov_len != fh->f_view_block_len) {
+                fh->f_view_block_len = 0;
+                break;
+            }
+        }
+        if (0 == fh->f_view_block_len) {
+            /* without the starts, the view is walked as before */
+            fh->f_view_block_starts = (size_t *) malloc (fh->f_iov_count * sizeof(size_t));
+            if (NULL != fh->f_view_block_starts) {
+                fh->f_view_block_starts[0] = 0;
+                for (i = 1 ; i < fh->f_iov_count ; i++) {
+                    fh->f_view_block_starts[i] = fh->f_view_block_starts[i-1] +
+                        fh->f_decoded_iov[i-1].iov_len;
+                }
+            }
+        }
+    }
+
     opal_datatype_get_extent(&filetype->super, &lb, &fh->f_view_extent);
     opal_datatype_type_ub   (&filetype->super, &ub);
     opal_datatype_type_size (&etype->super, &fh->f_etype_size);
@@ -68,8 +98,6 @@ int mca_io_ompio_set_view_internal(mca_io_ompio_file_t *fh,
     ompi_datatype_duplicate (etype, &fh->f_etype);
     ompi_datatype_duplicate (filetype, &fh->f_filetype);
     
-    fh->f_cc_size = get_contiguous_chunk_size (fh);
-
     if (opal_datatype_is_contiguous_memory_layout(&etype->super,1)) {
         if (opal_datatype_is_contiguous_memory_layout(&filetype->super,1) && 
 	    fh->f_view_extent == (OPAL_PTRDIFF_TYPE)fh->f_view_size ) {
@@ -77,6 +105,8 @@ int mca_io_ompio_set_view_internal(mca_io_ompio_file_t *fh,
         }
     }
 
+    fh->f_cc_size = get_contiguous_chunk_size (fh);
+
     return OMPI_SUCCESS;
 }
 
@@ -148,10 +178,13 @@ int mca_io_ompio_file_get_view (struct ompi_file_t *fp,
 
 OMPI_MPI_OFFSET_TYPE get_contiguous_chunk_size (mca_io_ompio_file_t *fh)
 {
-    int uniform = 0, global_uniform = 0;
+    int uniform = 0;
     int i = 0;
-    OMPI_MPI_OFFSET_TYPE avg[3] = {0,0,0};
-    OMPI_MPI_OFFSET_TYPE global_avg[3] = {0,0,0};
+    OMPI_MPI_OFFSET_TYPE avg[4] = {0,0,0,0};
+    OMPI_MPI_OFFSET_TYPE global_avg[4] = {0,0,0,0};
+    OMPI_MPI_OFFSET_TYPE ext[4] = {0,0,0,0};
+    OMPI_MPI_OFFSET_TYPE global_ext[4] = {0,0,0,0};
+    OMPI_MPI_OFFSET_TYPE start = 0, end = 0, base;
 
     /* This function does two things: first, it determines the average data chunk 
     ** size in the file view for each process and across all processes. 
@@ -159,9 +192,19 @@ OMPI_MPI_OFFSET_TYPE get_contiguous_chunk_size (mca_io_ompio_file_t *fh)
     ** By definition, uniform means:
     ** 1. the file view of each process has the same number of contiguous sections
     ** 2. each section in the file view has exactly the same size
+    ** The same reductions also give the part of the file covered by the
+    ** first instance of the filetype of each process, to tell whether
+    ** these file domains overlap.
     */
 
     for (i=0 ; i<(int)fh->f_iov_count ; i++) {
+        base = fh->f_disp + (OMPI_MPI_OFFSET_TYPE)(intptr_t)fh->f_decoded_iov[i].iov_base;
+        if (0 == i || base < start) {
+            start = base;
+        }
+        if (0 == i || base + (OMPI_MPI_OFFSET_TYPE)fh->f_decoded_iov[i].iov_len > end) {
+            end = base + fh->f_decoded_iov[i].iov_len;
+        }
         avg[0] += fh->f_decoded_iov[i].iov_len;
         if (i && 0 == uniform) {
             if (fh->f_decoded_iov[i].iov_len != fh->f_decoded_iov[i-1].iov_len) {
@@ -174,10 +217,11 @@ OMPI_MPI_OFFSET_TYPE get_contiguous_chunk_size (mca_io_ompio_file_t *fh)
     }
     avg[1] = (OMPI_MPI_OFFSET_TYPE) fh->f_iov_count;
     avg[2] = (OMPI_MPI_OFFSET_TYPE) uniform;
+    avg[3] = end - start;
 
     fh->f_comm->c_coll.coll_allreduce (avg,
                                        global_avg,
-                                       3,
+                                       4,
                                        MPI_LONG,
                                        MPI_SUM,
                                        fh->f_comm,
@@ -196,21 +240,44 @@ OMPI_MPI_OFFSET_TYPE get_contiguous_chunk_size (mca_io_ompio_file_t *fh)
     }
 
     /* second confirmation round to see whether all processes agree
-    ** on having a uniform file view or not 
+    ** on having a uniform file view or not, along with the bounds of
+    ** the file domains and whether they are all contiguous
     */
-    fh->f_comm->c_coll.coll_allreduce (&uniform,
-				       &global_uniform,
-				       1,
-				       MPI_INT,
+    ext[0] = uniform;
+    if (0 != fh->f_iov_count) {
+        ext[1] = -start;
+        ext[2] = end;
+    }
+    else {
+        /* an empty view covers nothing */
+        ext[1] = LONG_MIN;
+        ext[2] = 0;
+    }
+    ext[3] = (fh->f_flags & OMPIO_CONTIGUOUS_FVIEW) ? 0 : 1;
+    fh->f_comm->c_coll.coll_allreduce (ext,
+				       global_ext,
+				       4,
+				       MPI_LONG,
 				       MPI_MAX,
 				       fh->f_comm,
 				       fh->f_comm->c_coll.coll_allreduce_module);
 
-    if ( 0 == global_uniform  ){
+    if ( 0 == global_ext[0]  ){
 	/* yes, everybody agrees on having a uniform file view */
 	fh->f_flags |= OMPIO_UNIFORM_FVIEW;
     }
 
+    if (mca_io_ompio_pattern_select && 0 < global_avg[1]) {
+        /* the file domains overlap if together they are larger than
+           the part of the file they cover */
+        if (global_avg[3] > global_ext[2] + global_ext[1]) {
+            fh->f_flags |= OMPIO_INTERLEAVED_FVIEW;
+        }
+        else if (0 == global_ext[3]) {
+            fh->f_flags |= OMPIO_DISJOINT_FVIEW;
+        }
+    }
+
 
     return global_avg[0];
 }
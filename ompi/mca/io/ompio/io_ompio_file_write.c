@@ -53,6 +53,7 @@ mca_io_ompio_file_write (ompi_file_t *fp,
     struct iovec *decoded_iov = NULL;
 
     size_t max_data = 0; 
+    double start = MPI_Wtime ();
     int i = 0; /* index into the decoded iovec of the buffer */
     int j = 0; /* index into the file vie iovec */
     int k = 0; /* index into the io_array */
@@ -69,6 +70,12 @@ mca_io_ompio_file_write (ompi_file_t *fp,
     data = (mca_io_ompio_data_t *) fp->f_io_selected_data;
     fh = &data->ompio_fh;
 
+    /* the staged collective writes may overlap this one */
+    ret = ompi_io_ompio_stage_flush (fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
     ompi_io_ompio_decode_datatype (fh, 
                                    datatype, 
                                    count, 
@@ -192,7 +199,7 @@ mca_io_ompio_file_write (ompi_file_t *fp,
 #endif
 
         if (fh->f_num_of_io_entries) {
-            fh->f_fbtl->fbtl_pwritev (fh, NULL);
+            ompi_io_ompio_cache_pwritev (fh);
         }
 
         fh->f_num_of_io_entries = 0;
@@ -207,6 +214,9 @@ mca_io_ompio_file_write (ompi_file_t *fp,
         decoded_iov = NULL;
     }
 
+    OMPIO_STATS_ADD(fh, indep_time, MPI_Wtime () - start);
+    OMPIO_STATS_ADD(fh, bytes_written, max_data);
+
     if ( MPI_STATUS_IGNORE != status ) {
 	status->_ucount = max_data;
     }
@@ -247,15 +257,28 @@ mca_io_ompio_file_write_all (ompi_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
     mca_io_ompio_data_t *data;
+    mca_io_ompio_stats_mark_t mark;
+    size_t type_size;
 
     data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
 
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_stats_mark (&data->ompio_fh, &mark);
+    ompi_io_ompio_stage_begin (&data->ompio_fh);
     ret = data->ompio_fh.
         f_fcoll->fcoll_file_write_all (&data->ompio_fh, 
                                        buf, 
                                        count, 
                                        datatype,
                                        status);
+    ompi_io_ompio_stage_end (&data->ompio_fh);
+    ompi_io_ompio_stats_coll (&data->ompio_fh, &mark);
+    opal_datatype_type_size (&datatype->super, &type_size);
+    OMPIO_STATS_ADD(&data->ompio_fh, bytes_written, (size_t) count * type_size);
     
     if ( MPI_STATUS_IGNORE != status ) {
 	size_t size;
@@ -275,14 +298,32 @@ mca_io_ompio_file_write_all_begin (ompi_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
     mca_io_ompio_data_t *data;
+    mca_io_ompio_stats_mark_t mark;
+    size_t type_size;
 
     data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
 
+    ret = ompi_io_ompio_split_coll_begin (&data->ompio_fh, count, datatype);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_stats_mark (&data->ompio_fh, &mark);
+    ompi_io_ompio_stage_begin (&data->ompio_fh);
     ret = data->ompio_fh.
         f_fcoll->fcoll_file_write_all_begin (&data->ompio_fh, 
                                             buf, 
                                             count,
                                             datatype);
+    ompi_io_ompio_stage_end (&data->ompio_fh);
+    ompi_io_ompio_stats_coll (&data->ompio_fh, &mark);
+    opal_datatype_type_size (&datatype->super, &type_size);
+    OMPIO_STATS_ADD(&data->ompio_fh, bytes_written, (size_t) count * type_size);
 
     return ret;
 }
@@ -301,6 +342,9 @@ mca_io_ompio_file_write_all_end (ompi_file_t *fh,
         f_fcoll->fcoll_file_write_all_end (&data->ompio_fh, 
                                           buf, 
                                           status);
+    if (OMPI_SUCCESS != ompi_io_ompio_split_coll_end (&data->ompio_fh, status)) {
+        ret = OMPI_ERROR;
+    }
     
     return ret;
 }
@@ -315,17 +359,30 @@ mca_io_ompio_file_write_at_all (ompi_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
     mca_io_ompio_data_t *data;
+    mca_io_ompio_stats_mark_t mark;
+    size_t type_size;
 
     data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
 
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
     ompi_io_ompio_set_explicit_offset (&data->ompio_fh, offset);
 
+    ompi_io_ompio_stats_mark (&data->ompio_fh, &mark);
+    ompi_io_ompio_stage_begin (&data->ompio_fh);
     ret = data->ompio_fh.
         f_fcoll->fcoll_file_write_all (&data->ompio_fh, 
                                        buf, 
                                        count, 
                                        datatype, 
                                        status);
+    ompi_io_ompio_stage_end (&data->ompio_fh);
+    ompi_io_ompio_stats_coll (&data->ompio_fh, &mark);
+    opal_datatype_type_size (&datatype->super, &type_size);
+    OMPIO_STATS_ADD(&data->ompio_fh, bytes_written, (size_t) count * type_size);
 
     return ret;
 }
@@ -339,16 +396,34 @@ mca_io_ompio_file_write_at_all_begin (ompi_file_t *fh,
 {
     int ret = OMPI_SUCCESS;
     mca_io_ompio_data_t *data;
+    mca_io_ompio_stats_mark_t mark;
+    size_t type_size;
 
     data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
 
+    ret = ompi_io_ompio_split_coll_begin (&data->ompio_fh, count, datatype);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ret = ompi_io_ompio_cache_flush (&data->ompio_fh);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
     ompi_io_ompio_set_explicit_offset (&data->ompio_fh, offset);
 
+    ompi_io_ompio_stats_mark (&data->ompio_fh, &mark);
+    ompi_io_ompio_stage_begin (&data->ompio_fh);
     ret = data->ompio_fh.
         f_fcoll->fcoll_file_write_all_begin (&data->ompio_fh, 
                                             buf, 
                                             count, 
                                             datatype);
+    ompi_io_ompio_stage_end (&data->ompio_fh);
+    ompi_io_ompio_stats_coll (&data->ompio_fh, &mark);
+    opal_datatype_type_size (&datatype->super, &type_size);
+    OMPIO_STATS_ADD(&data->ompio_fh, bytes_written, (size_t) count * type_size);
 
     return ret;
 }
@@ -367,6 +442,9 @@ mca_io_ompio_file_write_at_all_end (ompi_file_t *fh,
         f_fcoll->fcoll_file_write_all_end (&data->ompio_fh, 
                                           buf, 
                                           status);
+    if (OMPI_SUCCESS != ompi_io_ompio_split_coll_end (&data->ompio_fh, status)) {
+        ret = OMPI_ERROR;
+    }
 
     return ret;
 }
@@ -412,7 +490,29 @@ mca_io_ompio_file_write_shared (ompi_file_t *fh,
                                 struct ompi_datatype_t *datatype,
                                 ompi_status_public_t * status)
 {
-    int ret = MPI_ERR_OTHER;
+    int ret = OMPI_SUCCESS;
+    mca_io_ompio_data_t *data;
+    mca_io_ompio_fp_position_t position;
+    OMPI_MPI_OFFSET_TYPE offset;
+
+    data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
+
+    ret = ompi_io_ompio_get_shared_offset (&data->ompio_fh,
+                                           count * datatype->super.size,
+                                           &offset);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_save_position (&data->ompio_fh, &position);
+    ret = mca_io_ompio_file_write_at (fh,
+                                      offset,
+                                      buf,
+                                      count,
+                                      datatype,
+                                      status);
+    ompi_io_ompio_restore_position (&data->ompio_fh, &position);
+
     return ret;
 }
 
@@ -423,7 +523,29 @@ mca_io_ompio_file_iwrite_shared (ompi_file_t *fh,
                                  struct ompi_datatype_t *datatype,
                                  ompi_request_t **request)
 {
-    int ret = MPI_ERR_OTHER;
+    int ret = OMPI_SUCCESS;
+    mca_io_ompio_data_t *data;
+    mca_io_ompio_fp_position_t position;
+    OMPI_MPI_OFFSET_TYPE offset;
+
+    data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
+
+    ret = ompi_io_ompio_get_shared_offset (&data->ompio_fh,
+                                           count * datatype->super.size,
+                                           &offset);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_save_position (&data->ompio_fh, &position);
+    ret = mca_io_ompio_file_iwrite_at (fh,
+                                       offset,
+                                       buf,
+                                       count,
+                                       datatype,
+                                       request);
+    ompi_io_ompio_restore_position (&data->ompio_fh, &position);
+
     return ret;
 }
 
@@ -434,7 +556,29 @@ mca_io_ompio_file_write_ordered (ompi_file_t *fh,
                                  struct ompi_datatype_t *datatype,
                                  ompi_status_public_t * status)
 {
-    int ret = MPI_ERR_OTHER;
+    int ret = OMPI_SUCCESS;
+    mca_io_ompio_data_t *data;
+    mca_io_ompio_fp_position_t position;
+    OMPI_MPI_OFFSET_TYPE offset;
+
+    data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
+
+    ret = ompi_io_ompio_get_ordered_offset (&data->ompio_fh,
+                                            count * datatype->super.size,
+                                            &offset);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_save_position (&data->ompio_fh, &position);
+    ret = mca_io_ompio_file_write_at_all (fh,
+                                          offset,
+                                          buf,
+                                          count,
+                                          datatype,
+                                          status);
+    ompi_io_ompio_restore_position (&data->ompio_fh, &position);
+
     return ret;
 }
 
@@ -444,7 +588,28 @@ mca_io_ompio_file_write_ordered_begin (ompi_file_t *fh,
                                        int count,
                                        struct ompi_datatype_t *datatype)
 {
-    int ret = MPI_ERR_OTHER;
+    int ret = OMPI_SUCCESS;
+    mca_io_ompio_data_t *data;
+    mca_io_ompio_fp_position_t position;
+    OMPI_MPI_OFFSET_TYPE offset;
+
+    data = (mca_io_ompio_data_t *) fh->f_io_selected_data;
+
+    ret = ompi_io_ompio_get_ordered_offset (&data->ompio_fh,
+                                            count * datatype->super.size,
+                                            &offset);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    ompi_io_ompio_save_position (&data->ompio_fh, &position);
+    ret = mca_io_ompio_file_write_at_all_begin (fh,
+                                                offset,
+                                                buf,
+                                                count,
+                                                datatype);
+    ompi_io_ompio_restore_position (&data->ompio_fh, &position);
+
     return ret;
 }
 
@@ -453,6 +618,7 @@ mca_io_ompio_file_write_ordered_end (ompi_file_t *fh,
                                      void *buf,
                                      ompi_status_public_t *status)
 {
-    int ret = MPI_ERR_OTHER;
-    return ret;
+    return mca_io_ompio_file_write_at_all_end (fh,
+                                               buf,
+                                               status);
 }
@@ -0,0 +1,510 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2013      University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if OPAL_HAVE_POSIX_THREADS
+#include <pthread.h>
+#endif
+
+#include "opal/threads/threads.h"
+#include "opal/util/output.h"
+#include "ompi/info/info.h"
+#include "ompi/mca/fbtl/fbtl.h"
+#include "io_ompio.h"
+
+/*
+ * Staging of the collective writes in node-local storage.
+ *
+ * While a collective write runs, the fbtl of the file is replaced by the
+ * functions below, which append the pieces the aggregators write to a
+ * log in the staging directory (tmpfs, a local disk...) and remember
+ * where each of them goes in the file. When the operation is over, a
+ * thread copies the log to the file in the background, while the
+ * application carries on. There are two logs: one is filled while the
+ * other is drained, and the writes done during a drain pile up in the
+ * same log until the thread is free again.
+ *
+ * The logs have to be drained before anything could observe the file:
+ * the reads, the independent writes, sync, size changes and close all
+ * call ompi_io_ompio_stage_flush. A read done by the fcoll itself in the
+ * middle of a collective write, for data sieving, drains them first as
+ * well. If a log cannot be written, the logs are drained and the pieces
+ * are written to the file directly.
+ *
+ * Only the files accessed through a file descriptor, and not in atomic
+ * mode, are staged.
+ */
+
+#if OPAL_HAVE_POSIX_THREADS
+
+typedef struct mca_io_ompio_stage_extent_t {
+    OMPI_MPI_OFFSET_TYPE  offset;      /* in the file */
+    OMPI_MPI_OFFSET_TYPE  log_offset;
+    size_t                length;
+} mca_io_ompio_stage_extent_t;
+
+typedef struct mca_io_ompio_stage_log_t {
+    int                          fd;
+    OMPI_MPI_OFFSET_TYPE         size;
+    mca_io_ompio_stage_extent_t *extents;
+    int                          num_extents;
+    int                          max_extents;
+} mca_io_ompio_stage_log_t;
+
+struct mca_io_ompio_stage_t {
+    mca_fbtl_base_module_t    module;    /* swapped in during the writes */
+    mca_fbtl_base_module_t   *fbtl;      /* of the file */
+    int                       fd;        /* of the file */
+    mca_io_ompio_stage_log_t  logs[2];
+    int                       fill;      /* log being written */
+    bool                      draining;  /* the other one is being copied */
+    bool                      shutdown;
+    int                       error;
+    char                     *buffer;
+    size_t                    buffer_size;
+    opal_thread_t             thread;
+    pthread_mutex_t           lock;
+    pthread_cond_t            cond;
+};
+
+/* protect against the interruptions and the short transfers */
+static int stage_pread (int fd, char *buf, size_t len, OMPI_MPI_OFFSET_TYPE off)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = pread (fd, buf, len, off);
+        if (n < 0 && EINTR == errno) {
+            continue;
+        }
+        if (n <= 0) {
+            return OMPI_ERROR;
+        }
+        buf += n;
+        off += n;
+        len -= n;
+    }
+    return OMPI_SUCCESS;
+}
+
+static int stage_pwrite (int fd, const char *buf, size_t len, OMPI_MPI_OFFSET_TYPE off)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = pwrite (fd, buf, len, off);
+        if (n < 0 && EINTR == errno) {
+            continue;
+        }
+        if (n <= 0) {
+            return OMPI_ERROR;
+        }
+        buf += n;
+        off += n;
+        len -= n;
+    }
+    return OMPI_SUCCESS;
+}
+
+static int stage_drain_log (struct mca_io_ompio_stage_t *stage,
+                            mca_io_ompio_stage_log_t *log)
+{
+    mca_io_ompio_stage_extent_t *ext;
+    size_t done, chunk;
+    int i, ret = OMPI_SUCCESS;
+
+    /* in the order of the writes, so that the last one of a region wins */
+    for (i = 0; i < log->num_extents && OMPI_SUCCESS == ret; i++) {
+        ext = &log->extents[i];
+        for (done = 0; done < ext->length; done += chunk) {
+            chunk = OMPIO_MIN(ext->length - done, stage->buffer_size);
+            ret = stage_pread (log->fd, stage->buffer, chunk,
+                               ext->log_offset + (OMPI_MPI_OFFSET_TYPE) done);
+            if (OMPI_SUCCESS == ret) {
+                ret = stage_pwrite (stage->fd, stage->buffer, chunk,
+                                    ext->offset + (OMPI_MPI_OFFSET_TYPE) done);
+            }
+            if (OMPI_SUCCESS != ret) {
+                opal_output (1, "ompio: draining the staged data failed: %s\n",
+                             strerror (errno));
+                break;
+            }
+        }
+    }
+
+    if (0 != ftruncate (log->fd, 0)) {
+        ret = OMPI_ERROR;
+    }
+    log->size = 0;
+    log->num_extents = 0;
+
+    return ret;
+}
+
+static void *stage_drain_thread (opal_object_t *obj)
+{
+    struct mca_io_ompio_stage_t *stage = (struct mca_io_ompio_stage_t *)
+        ((opal_thread_t *) obj)->t_arg;
+    mca_io_ompio_stage_log_t *log;
+    int ret;
+
+    pthread_mutex_lock (&stage->lock);
+    while (1) {
+        while (!stage->draining && !stage->shutdown) {
+            pthread_cond_wait (&stage->cond, &stage->lock);
+        }
+        if (!stage->draining) {
+            break;
+        }
+        log = &stage->logs[1 - stage->fill];
+        pthread_mutex_unlock (&stage->lock);
+
+        ret = stage_drain_log (stage, log);
+
+        pthread_mutex_lock (&stage->lock);
+        if (OMPI_SUCCESS != ret) {
+            stage->error = ret;
+        }
+        stage->draining = false;
+        pthread_cond_broadcast (&stage->cond);
+    }
+    pthread_mutex_unlock (&stage->lock);
+
+    return NULL;
+}
+
+/* hand the log being filled over to the thread, if it is free */
+static void stage_kick (struct mca_io_ompio_stage_t *stage)
+{
+    pthread_mutex_lock (&stage->lock);
+    if (!stage->draining && stage->logs[stage->fill].num_extents > 0) {
+        stage->fill = 1 - stage->fill;
+        stage->draining = true;
+        pthread_cond_broadcast (&stage->cond);
+    }
+    pthread_mutex_unlock (&stage->lock);
+}
+
+static int stage_append (struct mca_io_ompio_stage_t *stage,
+                         mca_io_ompio_file_t *fh)
+{
+    mca_io_ompio_stage_log_t *log = &stage->logs[stage->fill];
+    mca_io_ompio_stage_extent_t *ext, *tmp;
+    OMPI_MPI_OFFSET_TYPE off;
+    size_t len;
+    int i;
+
+    for (i = 0; i < fh->f_num_of_io_entries; i++) {
+        off = (OMPI_MPI_OFFSET_TYPE)(intptr_t) fh->f_io_array[i].offset;
+        len = fh->f_io_array[i].length;
+
+        if (OMPI_SUCCESS != stage_pwrite (log->fd, fh->f_io_array[i].memory_address,
+                                          len, log->size)) {
+            return OMPI_ERROR;
+        }
+
+        ext = (log->num_extents > 0) ? &log->extents[log->num_extents - 1] : NULL;
+        if (NULL != ext && ext->offset + (OMPI_MPI_OFFSET_TYPE) ext->length == off &&
+            ext->log_offset + (OMPI_MPI_OFFSET_TYPE) ext->length == log->size) {
+            ext->length += len;
+        }
+        else {
+            if (log->num_extents == log->max_extents) {
+                tmp = (mca_io_ompio_stage_extent_t *)
+                    realloc (log->extents, 2 * log->max_extents *
+                             sizeof(mca_io_ompio_stage_extent_t));
+                if (NULL == tmp) {
+                    return OMPI_ERR_OUT_OF_RESOURCE;
+                }
+                log->extents = tmp;
+                log->max_extents *= 2;
+            }
+            ext = &log->extents[log->num_extents++];
+            ext->offset = off;
+            ext->log_offset = log->size;
+            ext->length = len;
+        }
+        log->size += len;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static size_t stage_pwritev (mca_io_ompio_file_t *fh, int *sorted)
+{
+    struct mca_io_ompio_stage_t *stage = fh->f_stage;
+    double start = MPI_Wtime ();
+
+    if (NULL == fh->f_io_array) {
+        return OMPI_ERROR;
+    }
+
+    if (OMPI_SUCCESS != stage_append (stage, fh)) {
+        /* the local storage is full, or failing: what was appended is
+           written again, straight to the file */
+        if (OMPI_SUCCESS != ompi_io_ompio_stage_flush (fh)) {
+            return OMPI_ERROR;
+        }
+        return stage->fbtl->fbtl_pwritev (fh, sorted);
+    }
+
+    ompi_io_ompio_record_fbtl (fh, fh->f_num_of_io_entries, MPI_Wtime () - start);
+    return OMPI_SUCCESS;
+}
+
+static size_t stage_ipwritev (mca_io_ompio_file_t *fh, int *sorted,
+                              ompi_request_t **request)
+{
+    size_t ret;
+
+    /* appending to the log is fast, and the buffer can go right away */
+    ret = stage_pwritev (fh, sorted);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    *request = &ompi_request_empty;
+    return OMPI_SUCCESS;
+}
+
+static size_t stage_preadv (mca_io_ompio_file_t *fh, int *sorted)
+{
+    struct mca_io_ompio_stage_t *stage = fh->f_stage;
+
+    if (OMPI_SUCCESS != ompi_io_ompio_stage_flush (fh)) {
+        return OMPI_ERROR;
+    }
+    return stage->fbtl->fbtl_preadv (fh, sorted);
+}
+
+static size_t stage_ipreadv (mca_io_ompio_file_t *fh, int *sorted,
+                             ompi_request_t **request)
+{
+    struct mca_io_ompio_stage_t *stage = fh->f_stage;
+
+    if (OMPI_SUCCESS != ompi_io_ompio_stage_flush (fh)) {
+        return OMPI_ERROR;
+    }
+    return stage->fbtl->fbtl_ipreadv (fh, sorted, request);
+}
+
+static int stage_open_log (const char *dir, mca_io_ompio_stage_log_t *log)
+{
+    char *path;
+
+    log->fd = -1;
+    log->size = 0;
+    log->num_extents = 0;
+    log->max_extents = OMPIO_IOVEC_INITIAL_SIZE;
+    log->extents = (mca_io_ompio_stage_extent_t *)
+        malloc (log->max_extents * sizeof(mca_io_ompio_stage_extent_t));
+    if (NULL == log->extents) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    if (0 > asprintf (&path, "%s/ompio-stage-XXXXXX", dir)) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    log->fd = mkstemp (path);
+    if (-1 != log->fd) {
+        /* nothing is left behind, whatever happens to the process */
+        unlink (path);
+    }
+    free (path);
+
+    return (-1 == log->fd) ? OMPI_ERROR : OMPI_SUCCESS;
+}
+
+static void stage_close_log (mca_io_ompio_stage_log_t *log)
+{
+    if (-1 != log->fd) {
+        close (log->fd);
+    }
+    if (NULL != log->extents) {
+        free (log->extents);
+    }
+}
+
+static void stage_free (struct mca_io_ompio_stage_t *stage)
+{
+    stage_close_log (&stage->logs[0]);
+    stage_close_log (&stage->logs[1]);
+    if (NULL != stage->buffer) {
+        free (stage->buffer);
+    }
+    pthread_cond_destroy (&stage->cond);
+    pthread_mutex_destroy (&stage->lock);
+    free (stage);
+}
+
+int ompi_io_ompio_stage_init (mca_io_ompio_file_t *fh)
+{
+    struct mca_io_ompio_stage_t *stage;
+    char dir[MPI_MAX_INFO_VAL + 1];
+    int flag = 0;
+
+    fh->f_stage = NULL;
+    if ((fh->f_amode & MPI_MODE_RDONLY) ||
+        (UFS != fh->f_fstype && LUSTRE != fh->f_fstype)) {
+        return OMPI_SUCCESS;
+    }
+
+    if (NULL != fh->f_info && MPI_INFO_NULL != fh->f_info) {
+        ompi_info_get (fh->f_info, "ompio_stage_dir", MPI_MAX_INFO_VAL, dir, &flag);
+    }
+    if (!flag) {
+        if (NULL == mca_io_ompio_stage_dir || '\0' == mca_io_ompio_stage_dir[0]) {
+            return OMPI_SUCCESS;
+        }
+        strncpy (dir, mca_io_ompio_stage_dir, MPI_MAX_INFO_VAL);
+        dir[MPI_MAX_INFO_VAL] = '\0';
+    }
+
+    stage = (struct mca_io_ompio_stage_t *) calloc (1, sizeof(struct mca_io_ompio_stage_t));
+    if (NULL == stage) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    pthread_mutex_init (&stage->lock, NULL);
+    pthread_cond_init (&stage->cond, NULL);
+    stage->logs[0].fd = stage->logs[1].fd = -1;
+
+    stage->fbtl = fh->f_fbtl;
+    stage->fd = fh->fd;
+    stage->module = *fh->f_fbtl;
+    stage->module.fbtl_preadv = stage_preadv;
+    stage->module.fbtl_ipreadv = stage_ipreadv;
+    stage->module.fbtl_pwritev = stage_pwritev;
+    stage->module.fbtl_ipwritev = stage_ipwritev;
+    stage->buffer_size = mca_io_ompio_cycle_buffer_size;
+    stage->buffer = (char *) malloc (stage->buffer_size);
+
+    if (NULL == stage->buffer ||
+        OMPI_SUCCESS != stage_open_log (dir, &stage->logs[0]) ||
+        OMPI_SUCCESS != stage_open_log (dir, &stage->logs[1])) {
+        /* the file is usable without */
+        opal_output (1, "ompio: cannot stage the writes of %s in %s\n",
+                     fh->f_filename, dir);
+        stage_free (stage);
+        return OMPI_SUCCESS;
+    }
+
+    OBJ_CONSTRUCT(&stage->thread, opal_thread_t);
+    stage->thread.t_run = stage_drain_thread;
+    stage->thread.t_arg = stage;
+    if (OPAL_SUCCESS != opal_thread_start (&stage->thread)) {
+        OBJ_DESTRUCT(&stage->thread);
+        stage_free (stage);
+        return OMPI_SUCCESS;
+    }
+
+    fh->f_stage = stage;
+    return OMPI_SUCCESS;
+}
+
+void ompi_io_ompio_stage_begin (mca_io_ompio_file_t *fh)
+{
+    if (NULL != fh->f_stage && !fh->f_atomicity) {
+        fh->f_fbtl = &fh->f_stage->module;
+    }
+}
+
+void ompi_io_ompio_stage_end (mca_io_ompio_file_t *fh)
+{
+    if (NULL != fh->f_stage && fh->f_fbtl == &fh->f_stage->module) {
+        fh->f_fbtl = fh->f_stage->fbtl;
+        stage_kick (fh->f_stage);
+    }
+}
+
+int ompi_io_ompio_stage_flush (mca_io_ompio_file_t *fh)
+{
+    struct mca_io_ompio_stage_t *stage = fh->f_stage;
+    int ret;
+
+    if (NULL == stage) {
+        return OMPI_SUCCESS;
+    }
+
+    pthread_mutex_lock (&stage->lock);
+    while (stage->draining || stage->logs[stage->fill].num_extents > 0) {
+        if (!stage->draining) {
+            stage->fill = 1 - stage->fill;
+            stage->draining = true;
+            pthread_cond_broadcast (&stage->cond);
+        }
+        pthread_cond_wait (&stage->cond, &stage->lock);
+    }
+    ret = stage->error;
+    stage->error = OMPI_SUCCESS;
+    pthread_mutex_unlock (&stage->lock);
+
+    return ret;
+}
+
+int ompi_io_ompio_stage_fini (mca_io_ompio_file_t *fh)
+{
+    struct mca_io_ompio_stage_t *stage = fh->f_stage;
+    int ret;
+
+    if (NULL == stage) {
+        return OMPI_SUCCESS;
+    }
+
+    ret = ompi_io_ompio_stage_flush (fh);
+
+    pthread_mutex_lock (&stage->lock);
+    stage->shutdown = true;
+    pthread_cond_broadcast (&stage->cond);
+    pthread_mutex_unlock (&stage->lock);
+    opal_thread_join (&stage->thread, NULL);
+    OBJ_DESTRUCT(&stage->thread);
+
+    stage_free (stage);
+    fh->f_stage = NULL;
+
+    return ret;
+}
+
+#else /* OPAL_HAVE_POSIX_THREADS */
+
+/* without a thread to drain them, the writes are not staged */
+
+int ompi_io_ompio_stage_init (mca_io_ompio_file_t *fh)
+{
+    fh->f_stage = NULL;
+    return OMPI_SUCCESS;
+}
+
+void ompi_io_ompio_stage_begin (mca_io_ompio_file_t *fh)
+{
+}
+
+void ompi_io_ompio_stage_end (mca_io_ompio_file_t *fh)
+{
+}
+
+int ompi_io_ompio_stage_flush (mca_io_ompio_file_t *fh)
+{
+    return OMPI_SUCCESS;
+}
+
+int ompi_io_ompio_stage_fini (mca_io_ompio_file_t *fh)
+{
+    return OMPI_SUCCESS;
+}
+
+#endif /* OPAL_HAVE_POSIX_THREADS */
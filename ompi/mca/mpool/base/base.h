@@ -83,6 +83,26 @@ OMPI_DECLSPEC extern uint32_t mca_mpool_base_page_size_log;
 /* only used within base -- no need to DECLSPEC */
 extern int mca_mpool_base_used_mem_hooks;
 
+/* allocator component behind MPI_Alloc_mem, none when empty */
+extern char *mca_mpool_base_alloc_mem_allocator;
+
+void mca_mpool_base_alloc_cache_init(void);
+void mca_mpool_base_alloc_cache_finalize(void);
+void *mca_mpool_base_alloc_cache_get(size_t size);
+bool mca_mpool_base_alloc_cache_put(void *base);
+
+/**
+ * Give the unused segments of the MPI_Alloc_mem allocator back to the
+ * system, with their registrations.  Only the buffers cached by the
+ * calling thread are taken back, those of the other threads stay.
+ */
+OMPI_DECLSPEC int mca_mpool_base_alloc_trim(void);
+
+/* set when the registrations are implicit (e.g. on-demand paging): a
+   freed buffer cannot leave a stale registration behind, so leave_pinned
+   does not need the memory hooks */
+OMPI_DECLSPEC extern bool mca_mpool_base_implicit_reg;
+
 OMPI_DECLSPEC extern mca_base_framework_t ompi_mpool_base_framework;
     
 END_C_DECLS
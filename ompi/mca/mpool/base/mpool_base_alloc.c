@@ -86,7 +86,10 @@ static void unregister_tree_item(mca_mpool_base_tree_item_t *mpool_tree_item)
  *
  * If the info parameter is MPI_INFO_NULL, then this function will try to allocate
  * the memory and register it with as many mpools as possible. However, 
- * if any of the registratons fail the mpool will simply be ignored.
+ * if any of the registratons fail the mpool will simply be ignored.  The
+ * memory then comes from the allocator of mpool_base_alloc_cache.c, out of
+ * segments registered once, unless an mpool without a registration
+ * function has to provide it.
  *
  * @param size the size of the memory area to allocate
  * @param info an info object which tells us what kind of memory to allocate
@@ -196,6 +199,14 @@ void *mca_mpool_base_alloc(size_t size, ompi_info_t *info)
         }
     }
     
+    if(&ompi_mpi_info_null.info == info && NULL == no_reg_function) {
+        /* the common case: buffers out of segments registered once with
+         * all the mpools */
+        mem = mca_mpool_base_alloc_cache_get(size);
+        if(NULL != mem)
+            goto out;
+    }
+
     if(NULL == no_reg_function && 0 == reg_module_num)
     {
         if(!mpool_requested)
@@ -284,6 +295,9 @@ int mca_mpool_base_free(void *base)
     mpool_tree_item = mca_mpool_base_tree_find(base);
 
     if(!mpool_tree_item) { 
+        if(mca_mpool_base_alloc_cache_put(base)) {
+            return OMPI_SUCCESS;
+        }
         /* nothing in the tree this was just plain old malloc'd memory */
         free(base);
         return OMPI_SUCCESS;
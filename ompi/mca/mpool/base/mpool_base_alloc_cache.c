@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Allocator behind MPI_Alloc_mem when the info is MPI_INFO_NULL.
+ *
+ * Rather than one registration per call, the allocator named by
+ * mpool_base_alloc_mem_allocator takes 2MB segments, backed by huge
+ * pages when the system has some, registers every segment once with all
+ * the mpools that serve MPI_Alloc_mem and cuts it in small buffers.  The
+ * segments are recorded by address so that mca_mpool_base_free can
+ * recognize the buffers it hands out.
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include "opal/sys/atomic.h"
+#include "opal/threads/mutex.h"
+#include "opal/util/output.h"
+#include "ompi/constants.h"
+#include "ompi/mca/allocator/base/base.h"
+#include "ompi/mca/mpool/mpool.h"
+#include "ompi/mca/mpool/base/base.h"
+#include "mpool_base_tree.h"
+
+#define ALLOC_CACHE_PAGE_SIZE  (2 * 1024 * 1024)
+
+/**
+ * A segment given to the allocator.
+ */
+typedef struct {
+    unsigned char *base;
+    size_t size;
+    bool mapped;                  /**< from mmap rather than posix_memalign */
+    int count;
+    mca_mpool_base_module_t *mpools[MCA_MPOOL_BASE_TREE_MAX];
+    mca_mpool_base_registration_t *regs[MCA_MPOOL_BASE_TREE_MAX];
+} alloc_cache_segment_t;
+
+char *mca_mpool_base_alloc_mem_allocator = NULL;
+
+static opal_mutex_t alloc_cache_lock;
+static mca_allocator_base_module_t *alloc_cache = NULL;
+/* 0 not tried yet, 1 ready, -1 not available */
+static int alloc_cache_state = 0;
+/* the registrations went away with the mpools */
+static bool alloc_cache_closing = false;
+/* sorted by address */
+static alloc_cache_segment_t **segments = NULL;
+static int n_segments = 0, max_segments = 0;
+
+static int segment_index(void *addr)
+{
+    int low = 0, high = n_segments - 1;
+
+    while (low <= high) {
+        int mid = (low + high) / 2;
+
+        if ((unsigned char *) addr < segments[mid]->base) {
+            high = mid - 1;
+        } else if ((unsigned char *) addr >= segments[mid]->base + segments[mid]->size) {
+            low = mid + 1;
+        } else {
+            return mid;
+        }
+    }
+    return -(low + 1);
+}
+
+static void *alloc_cache_pages(size_t size, bool *mapped)
+{
+    void *addr = NULL;
+
+#if defined(HAVE_SYS_MMAN_H) && defined(MAP_HUGETLB) && defined(MAP_ANONYMOUS)
+    addr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (MAP_FAILED != addr) {
+        *mapped = true;
+        return addr;
+    }
+#endif
+    *mapped = false;
+    if (0 != posix_memalign(&addr, ALLOC_CACHE_PAGE_SIZE, size)) {
+        return NULL;
+    }
+#if defined(HAVE_SYS_MMAN_H) && defined(MADV_HUGEPAGE)
+    /* transparent huge pages, when there are no reserved ones */
+    (void) madvise(addr, size, MADV_HUGEPAGE);
+#endif
+    return addr;
+}
+
+static void alloc_cache_segment_release(alloc_cache_segment_t *seg)
+{
+    int i;
+
+    if (!alloc_cache_closing) {
+        for (i = 0 ; i < seg->count ; ++i) {
+            seg->mpools[i]->mpool_deregister(seg->mpools[i], seg->regs[i]);
+        }
+    }
+#if defined(HAVE_SYS_MMAN_H)
+    if (seg->mapped) {
+        (void) munmap(seg->base, seg->size);
+    } else
+#endif
+    {
+        free(seg->base);
+    }
+    free(seg);
+}
+
+static void *alloc_cache_segment_alloc(mca_mpool_base_module_t *unused, size_t *size,
+                                       mca_mpool_base_registration_t **registration)
+{
+    alloc_cache_segment_t *seg;
+    opal_list_item_t *item;
+    int index;
+
+    seg = (alloc_cache_segment_t *) calloc(1, sizeof(*seg));
+    if (NULL == seg) {
+        return NULL;
+    }
+    seg->size = (*size + ALLOC_CACHE_PAGE_SIZE - 1) & ~((size_t) ALLOC_CACHE_PAGE_SIZE - 1);
+    seg->base = (unsigned char *) alloc_cache_pages(seg->size, &seg->mapped);
+    if (NULL == seg->base) {
+        free(seg);
+        return NULL;
+    }
+
+    /* a single registration per segment and mpool */
+    for (item = opal_list_get_first(&mca_mpool_base_modules) ;
+         item != opal_list_get_end(&mca_mpool_base_modules) &&
+             seg->count < MCA_MPOOL_BASE_TREE_MAX ;
+         item = opal_list_get_next(item)) {
+        mca_mpool_base_module_t *mpool = ((mca_mpool_base_selected_module_t *) item)->mpool_module;
+
+        if (!(mpool->flags & MCA_MPOOL_FLAGS_MPI_ALLOC_MEM) || NULL == mpool->mpool_register) {
+            continue;
+        }
+        if (OMPI_SUCCESS == mpool->mpool_register(mpool, seg->base, seg->size,
+                                                  MCA_MPOOL_FLAGS_PERSIST,
+                                                  &seg->regs[seg->count])) {
+            seg->mpools[seg->count++] = mpool;
+        }
+    }
+
+    OPAL_THREAD_LOCK(&alloc_cache_lock);
+    if (n_segments == max_segments) {
+        alloc_cache_segment_t **tmp;
+
+        tmp = (alloc_cache_segment_t **) realloc(segments, (max_segments + 16) * sizeof(*tmp));
+        if (NULL == tmp) {
+            OPAL_THREAD_UNLOCK(&alloc_cache_lock);
+            alloc_cache_segment_release(seg);
+            return NULL;
+        }
+        segments = tmp;
+        max_segments += 16;
+    }
+    index = -segment_index(seg->base) - 1;
+    memmove(segments + index + 1, segments + index, (n_segments - index) * sizeof(*segments));
+    segments[index] = seg;
+    ++n_segments;
+    OPAL_THREAD_UNLOCK(&alloc_cache_lock);
+
+    *size = seg->size;
+    *registration = (0 < seg->count) ? seg->regs[0] : NULL;
+    return seg->base;
+}
+
+static void alloc_cache_segment_free(mca_mpool_base_module_t *unused, void *base)
+{
+    alloc_cache_segment_t *seg = NULL;
+    int index;
+
+    OPAL_THREAD_LOCK(&alloc_cache_lock);
+    index = segment_index(base);
+    if (index >= 0) {
+        seg = segments[index];
+        --n_segments;
+        memmove(segments + index, segments + index + 1, (n_segments - index) * sizeof(*segments));
+    }
+    OPAL_THREAD_UNLOCK(&alloc_cache_lock);
+
+    if (NULL != seg) {
+        alloc_cache_segment_release(seg);
+    }
+}
+
+static bool alloc_cache_ready(void)
+{
+    mca_allocator_base_component_t *component;
+
+    if (OPAL_LIKELY(0 != alloc_cache_state)) {
+        return 1 == alloc_cache_state;
+    }
+
+    OPAL_THREAD_LOCK(&alloc_cache_lock);
+    if (0 == alloc_cache_state) {
+        int state = -1;
+
+        if (NULL != mca_mpool_base_alloc_mem_allocator &&
+            '\0' != mca_mpool_base_alloc_mem_allocator[0]) {
+            component = mca_allocator_component_lookup(mca_mpool_base_alloc_mem_allocator);
+            if (NULL != component) {
+                alloc_cache = component->allocator_init(opal_using_threads(),
+                                                        alloc_cache_segment_alloc,
+                                                        alloc_cache_segment_free, NULL);
+            }
+            if (NULL != alloc_cache) {
+                state = 1;
+            } else {
+                opal_output_verbose(10, ompi_mpool_base_framework.framework_output,
+                                    "mpool:base: allocator %s not available for MPI_Alloc_mem",
+                                    mca_mpool_base_alloc_mem_allocator);
+            }
+        }
+        /* the allocator is complete before anybody sees the state */
+        opal_atomic_wmb();
+        alloc_cache_state = state;
+    }
+    OPAL_THREAD_UNLOCK(&alloc_cache_lock);
+    return 1 == alloc_cache_state;
+}
+
+void mca_mpool_base_alloc_cache_init(void)
+{
+    OBJ_CONSTRUCT(&alloc_cache_lock, opal_mutex_t);
+    alloc_cache_state = 0;
+    alloc_cache_closing = false;
+}
+
+void *mca_mpool_base_alloc_cache_get(size_t size)
+{
+    if (!alloc_cache_ready()) {
+        return NULL;
+    }
+    return alloc_cache->alc_alloc(alloc_cache, size, 0, NULL);
+}
+
+bool mca_mpool_base_alloc_cache_put(void *base)
+{
+    int index;
+
+    if (1 != alloc_cache_state) {
+        return false;
+    }
+    OPAL_THREAD_LOCK(&alloc_cache_lock);
+    index = segment_index(base);
+    OPAL_THREAD_UNLOCK(&alloc_cache_lock);
+    if (index < 0) {
+        return false;
+    }
+    alloc_cache->alc_free(alloc_cache, base);
+    return true;
+}
+
+int mca_mpool_base_alloc_trim(void)
+{
+    if (1 != alloc_cache_state) {
+        return OMPI_SUCCESS;
+    }
+    return alloc_cache->alc_compact(alloc_cache);
+}
+
+void mca_mpool_base_alloc_cache_finalize(void)
+{
+    if (1 == alloc_cache_state) {
+        alloc_cache_closing = true;
+        alloc_cache->alc_finalize(alloc_cache);
+        alloc_cache = NULL;
+    }
+    alloc_cache_state = 0;
+    /* the large buffers still allocated had a segment of their own */
+    while (0 < n_segments) {
+        alloc_cache_segment_release(segments[--n_segments]);
+    }
+    free(segments);
+    segments = NULL;
+    n_segments = max_segments = 0;
+    OBJ_DESTRUCT(&alloc_cache_lock);
+}
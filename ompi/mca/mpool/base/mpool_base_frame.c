@@ -51,11 +51,28 @@
 /* whether we actually used the mem hooks or not */
 int mca_mpool_base_used_mem_hooks = 0;
 
+/* whether the registrations cover the whole address space (set by the
+   btls before creating their mpools) */
+bool mca_mpool_base_implicit_reg = false;
+
 uint32_t mca_mpool_base_page_size; 
 uint32_t mca_mpool_base_page_size_log;
 
 opal_list_t mca_mpool_base_modules;
 
+static int mca_mpool_base_register(mca_base_register_flag_t flags)
+{
+    mca_mpool_base_alloc_mem_allocator = "slab";
+    (void) mca_base_framework_var_register(&ompi_mpool_base_framework, "alloc_mem_allocator",
+                                           "Allocator component serving MPI_Alloc_mem without "
+                                           "info keys from registered huge page segments (empty "
+                                           "for one allocation and registration per call)",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_mpool_base_alloc_mem_allocator);
+    return OMPI_SUCCESS;
+}
+
 /**
  * Function for finding and opening either all MCA components, or the one
  * that was specifically requested via a MCA parameter.
@@ -80,6 +97,7 @@ static int mca_mpool_base_open(mca_base_open_flag_t flags)
 
     /* setup tree for tracking MPI_Alloc_mem */ 
     mca_mpool_base_tree_init();
+    mca_mpool_base_alloc_cache_init();
     
     return OMPI_SUCCESS;
 }
@@ -95,6 +113,9 @@ static int mca_mpool_base_close(void)
    */
   modules_length = opal_list_get_size(&mca_mpool_base_modules);
 
+  /* the mpools are not needed to drop the MPI_Alloc_mem segments, their
+     finalize releases the registrations */
+
   /* Finalize all the mpool components and free their list items */
 
   while(NULL != (item = opal_list_remove_first(&mca_mpool_base_modules))) {
@@ -110,6 +131,7 @@ static int mca_mpool_base_close(void)
     }
     OBJ_RELEASE(sm);
   }
+  mca_mpool_base_alloc_cache_finalize();
 
   /* Close all remaining available components (may be one if this is a
      OMPI RTE program, or [possibly] multiple if this is ompi_info) */
@@ -125,5 +147,5 @@ static int mca_mpool_base_close(void)
   return OMPI_SUCCESS;
 }
 
-MCA_BASE_FRAMEWORK_DECLARE(ompi, mpool, NULL, NULL, mca_mpool_base_open,
+MCA_BASE_FRAMEWORK_DECLARE(ompi, mpool, NULL, mca_mpool_base_register, mca_mpool_base_open,
                            mca_mpool_base_close, mca_mpool_base_static_components, 0);
@@ -107,7 +107,8 @@ mca_mpool_base_module_t* mca_mpool_base_module_create(
            leave_pinned variables may have been set by a user MCA
            param or elsewhere in the code base).  Yes, we could have
            coded this more succinctly, but this is more clear. */
-        if (ompi_mpi_leave_pinned > 0 || ompi_mpi_leave_pinned_pipeline) {
+        if ((ompi_mpi_leave_pinned > 0 || ompi_mpi_leave_pinned_pipeline) &&
+            !mca_mpool_base_implicit_reg) {
             use_mem_hooks = 1;
         }
 
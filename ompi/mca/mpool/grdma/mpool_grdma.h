@@ -70,6 +70,10 @@ struct mca_mpool_base_resources_t {
     int (*register_mem)(void *reg_data, void *base, size_t size,
         mca_mpool_base_registration_t *reg);
     int (*deregister_mem)(void *reg_data, mca_mpool_base_registration_t *reg);
+    /* register_mem hands out a registration covering the whole address
+       space (e.g. an implicit on-demand paging memory region): there is
+       nothing worth caching */
+    bool implicit_reg;
 };
 typedef struct mca_mpool_base_resources_t mca_mpool_base_resources_t;
 
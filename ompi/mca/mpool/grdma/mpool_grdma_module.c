@@ -205,6 +205,42 @@ bool mca_mpool_grdma_evict (struct mca_mpool_base_module_t *mpool)
     return mca_mpool_grdma_evict_lru_local (((mca_mpool_grdma_module_t *) mpool)->pool);
 }
 
+/*
+ * register memory when the registrations are implicit: no cache lookup,
+ * no LRU, and no lock
+ */
+static int register_implicit(mca_mpool_grdma_module_t *mpool_grdma,
+                             unsigned char *base, unsigned char *bound,
+                             uint32_t flags,
+                             mca_mpool_base_registration_t **reg)
+{
+    mca_mpool_base_registration_t *grdma_reg;
+    ompi_free_list_item_t *item;
+    int rc;
+
+    OMPI_FREE_LIST_GET_MT(&mpool_grdma->reg_list, item);
+    if(NULL == item) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    grdma_reg = (mca_mpool_base_registration_t*)item;
+
+    grdma_reg->mpool = &mpool_grdma->super;
+    grdma_reg->base = base;
+    grdma_reg->bound = bound;
+    grdma_reg->flags = flags | MCA_MPOOL_FLAGS_CACHE_BYPASS;
+
+    rc = mpool_grdma->resources.register_mem(mpool_grdma->resources.reg_data,
+                                             base, bound - base + 1, grdma_reg);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != rc)) {
+        OMPI_FREE_LIST_RETURN_MT(&mpool_grdma->reg_list, item);
+        return rc;
+    }
+
+    grdma_reg->ref_count = 1;
+    *reg = grdma_reg;
+    return OMPI_SUCCESS;
+}
+
 /*
  * register memory
  */
@@ -219,12 +255,17 @@ int mca_mpool_grdma_register(mca_mpool_base_module_t *mpool, void *addr,
     bool bypass_cache = !!(flags & MCA_MPOOL_FLAGS_CACHE_BYPASS);
     int rc;
 
-    OPAL_THREAD_LOCK(&mpool->rcache->lock);
-
-    /* if cache bypass is requested don't use the cache */
     base = (unsigned char *) down_align_addr(addr, mca_mpool_base_page_size_log);
     bound = (unsigned char *) up_align_addr((void*)((char*) addr + size - 1),
                                             mca_mpool_base_page_size_log);
+
+    if (mpool_grdma->resources.implicit_reg) {
+        return register_implicit(mpool_grdma, base, bound, flags, reg);
+    }
+
+    OPAL_THREAD_LOCK(&mpool->rcache->lock);
+
+    /* if cache bypass is requested don't use the cache */
     if (!opal_list_is_empty (&mpool_grdma->pool->gc_list))
         do_unregistration_gc(mpool);
 
@@ -389,6 +430,19 @@ int mca_mpool_grdma_deregister(struct mca_mpool_base_module_t *mpool,
     int rc = OMPI_SUCCESS;
     assert(reg->ref_count > 0);
 
+    if (mpool_grdma->resources.implicit_reg) {
+        if (OPAL_THREAD_ADD32(&reg->ref_count, -1) > 0) {
+            return OMPI_SUCCESS;
+        }
+        rc = mpool_grdma->resources.deregister_mem(mpool_grdma->resources.reg_data,
+                                                   reg);
+        if (OPAL_LIKELY(OMPI_SUCCESS == rc)) {
+            OMPI_FREE_LIST_RETURN_MT(&mpool_grdma->reg_list,
+                                     (ompi_free_list_item_t *) reg);
+        }
+        return rc;
+    }
+
     OPAL_THREAD_LOCK(&mpool->rcache->lock);
     reg->ref_count--;
     if(reg->ref_count > 0) {
@@ -41,6 +41,9 @@ struct mca_mpool_sm_component_t {
     /* mca_allocator_base_module_t* sm_allocator; */
     char *sm_allocator_name;
     int verbose;
+    /* granularity at which a process claims the shared segment when
+     * its allocations are bound to a NUMA node */
+    unsigned long arena_size;
     /* struct mca_mpool_sm_mmap_t *sm_mmap; */
 };
 typedef struct mca_mpool_sm_component_t mca_mpool_sm_component_t;
@@ -61,6 +64,9 @@ typedef struct mca_mpool_sm_module_t {
     struct mca_mpool_sm_mmap_t *sm_mmap;
     mca_common_sm_module_t *sm_common_module;
     int32_t mem_node;
+    /* what is left of the current arena, bound to mem_node */
+    char *arena;
+    size_t arena_left;
 } mca_mpool_sm_module_t;
 
 /*
@@ -74,6 +80,17 @@ void mca_mpool_sm_module_init(mca_mpool_sm_module_t* mpool);
  */
 void* mca_mpool_sm_base(mca_mpool_base_module_t*);
 
+/**
+ * Segment allocation function of the allocator.  With a memory node
+ * the segment is claimed by page aligned arenas, each bound to the
+ * node as a whole, so that the fragments of a process never share a
+ * page with the ones of a process on another node.
+ */
+void* mca_mpool_sm_seg_alloc(
+    struct mca_mpool_base_module_t* mpool,
+    size_t* size,
+    mca_mpool_base_registration_t** registration);
+
 /**
   *  Allocate block of shared memory.
   */
@@ -107,6 +107,16 @@ static int mca_mpool_sm_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &ompi_mpool_sm_min_size);
 
+    mca_mpool_sm_component.arena_size = 1 << 20;
+    (void) mca_base_component_var_register(&mca_mpool_sm_component.super.mpool_version,
+                                           "arena_size", "Size of the chunks of the shared memory "
+                                           "file a process claims and binds to its NUMA node, when "
+                                           "its memory is bound (rounded up to a page)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_LONG, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_mpool_sm_component.arena_size);
+
     ompi_mpool_sm_verbose = 0;
     (void) mca_base_component_var_register(&mca_mpool_sm_component.super.mpool_version,
                                            "verbose", "Enable verbose output for mpool sm component",
@@ -216,7 +226,7 @@ mca_mpool_sm_init(struct mca_mpool_base_resources_t *resources)
     /* setup allocator */
     mpool_module->sm_allocator = 
       allocator_component->allocator_init(true,
-                                          mca_common_sm_seg_alloc, 
+                                          mca_mpool_sm_seg_alloc,
                                           NULL, &(mpool_module->super));
     if (NULL == mpool_module->sm_allocator) {
         opal_output(0, "mca_mpool_sm_init: unable to initialize allocator");
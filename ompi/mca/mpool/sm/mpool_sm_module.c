@@ -61,6 +61,8 @@ void mca_mpool_sm_module_init(mca_mpool_sm_module_t* mpool)
     mpool->sm_mmap = NULL;
     mpool->sm_common_module = NULL;
     mpool->mem_node = -1;
+    mpool->arena = NULL;
+    mpool->arena_left = 0;
 }
 
 /*
@@ -73,6 +75,79 @@ void* mca_mpool_sm_base(mca_mpool_base_module_t* mpool)
         sm_mpool->sm_common_module->module_seg_addr : NULL;
 }
 
+/**
+  * segment allocation function of the allocator
+  */
+void* mca_mpool_sm_seg_alloc(
+    struct mca_mpool_base_module_t* mpool,
+    size_t* size,
+    mca_mpool_base_registration_t** registration)
+{
+    mca_mpool_sm_module_t* mpool_sm = (mca_mpool_sm_module_t*)mpool;
+    size_t page = (size_t) getpagesize(), len, claim;
+    void *addr;
+
+    if (mpool_sm->mem_node < 0) {
+        addr = mca_common_sm_seg_alloc(mpool, size, registration);
+        if (NULL == addr) {
+            opal_output(mca_mpool_sm_component.verbose,
+                        "mca_mpool_sm_seg_alloc: shared memory exhausted, "
+                        "consider raising mpool_sm_min_size");
+        }
+        return addr;
+    }
+
+    if (*size > mpool_sm->arena_left) {
+        opal_hwloc_base_memory_segment_t mseg;
+        char *base;
+
+        /* what is left of the current arena is lost, a new one starts
+           on a page of its own.  Near the end of the segment, settle
+           for what this allocation needs */
+        len = (*size + page - 1) & ~(page - 1);
+        if (len < mca_mpool_sm_component.arena_size) {
+            claim = (mca_mpool_sm_component.arena_size + page - 1) & ~(page - 1);
+            claim += page;
+            base = (char *) mca_common_sm_seg_alloc(mpool, &claim, NULL);
+            if (NULL != base) {
+                len = claim - page;
+            }
+        } else {
+            base = NULL;
+        }
+        if (NULL == base) {
+            claim = len + page;
+            base = (char *) mca_common_sm_seg_alloc(mpool, &claim, NULL);
+        }
+        if (NULL == base) {
+            opal_output(mca_mpool_sm_component.verbose,
+                        "mca_mpool_sm_seg_alloc: shared memory exhausted, "
+                        "consider raising mpool_sm_min_size");
+            return NULL;
+        }
+        mseg.mbs_start_addr = (void *) (((uintptr_t) base + page - 1) & ~((uintptr_t) page - 1));
+        mseg.mbs_len = len;
+#if OPAL_HAVE_HWLOC
+        opal_hwloc_base_membind(&mseg, 1, mpool_sm->mem_node);
+#endif
+        mpool_sm->arena = (char *) mseg.mbs_start_addr;
+        mpool_sm->arena_left = len;
+    }
+
+    addr = mpool_sm->arena;
+    /* keep the next allocation aligned on a sizeof(long) boundary */
+    len = (*size + sizeof(long) - 1) & ~(sizeof(long) - 1);
+    if (len > mpool_sm->arena_left) {
+        len = mpool_sm->arena_left;
+    }
+    mpool_sm->arena += len;
+    mpool_sm->arena_left -= len;
+    if (NULL != registration) {
+        *registration = NULL;
+    }
+    return addr;
+}
+
 /**
   * allocate function
   */
@@ -84,26 +159,19 @@ void* mca_mpool_sm_alloc(
     mca_mpool_base_registration_t** registration)
 {
     mca_mpool_sm_module_t* mpool_sm = (mca_mpool_sm_module_t*)mpool;
-    opal_hwloc_base_memory_segment_t mseg;
+    void *addr;
 
-    mseg.mbs_start_addr =
-        mpool_sm->sm_allocator->alc_alloc(mpool_sm->sm_allocator, size, align, registration);
-
-    if(mpool_sm->mem_node >= 0) {
-        mseg.mbs_len = size;
-#if OPAL_HAVE_HWLOC
-        opal_hwloc_base_membind(&mseg, 1, mpool_sm->mem_node);
-#endif
-    }
+    /* the memory comes from an arena already bound to mem_node */
+    addr = mpool_sm->sm_allocator->alc_alloc(mpool_sm->sm_allocator, size, align, registration);
 
 #if OPAL_CUDA_SUPPORT
     if (flags & MCA_MPOOL_FLAGS_CUDA_REGISTER_MEM) {
-        mca_common_cuda_register(mseg.mbs_start_addr, size,
+        mca_common_cuda_register(addr, size,
                                  mpool->mpool_component->mpool_version.mca_component_name);
     }
 #endif
 
-    return mseg.mbs_start_addr;
+    return addr;
 }
 
 /**
@@ -116,19 +184,9 @@ void* mca_mpool_sm_realloc(
     mca_mpool_base_registration_t** registration)
 {
     mca_mpool_sm_module_t* mpool_sm = (mca_mpool_sm_module_t*)mpool;
-    opal_hwloc_base_memory_segment_t mseg;
-
-    mseg.mbs_start_addr =
-        mpool_sm->sm_allocator->alc_realloc(mpool_sm->sm_allocator, addr, size,
-                                            registration);
-    if(mpool_sm->mem_node >= 0) {
-        mseg.mbs_len = size;
-#if OPAL_HAVE_HWLOC
-        opal_hwloc_base_membind(&mseg, 1, mpool_sm->mem_node);
-#endif
-    }
 
-    return mseg.mbs_start_addr;
+    return mpool_sm->sm_allocator->alc_realloc(mpool_sm->sm_allocator, addr, size,
+                                               registration);
 }
 
 /**
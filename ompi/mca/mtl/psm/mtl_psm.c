@@ -86,14 +86,13 @@ int ompi_mtl_psm_progress( void );
 
 int ompi_mtl_psm_module_init(int local_rank, int num_local_procs) { 
     psm_error_t err;
-    psm_ep_t	ep; /* endpoint handle */
-    psm_mq_t	mq;
-    psm_epid_t	epid; /* unique lid+port identifier */
     psm_uuid_t  unique_job_key;
     struct psm_ep_open_opts ep_opt;
     unsigned long long *uu = (unsigned long long *) unique_job_key;
     char *generated_key;
     char env_string[256];
+    int nctx = ompi_mtl_psm.num_contexts, ctx;
+    bool set_local_ranks;
     
     generated_key = getenv("OMPI_MCA_orte_precondition_transports");
     memset(uu, 0, sizeof(psm_uuid_t));
@@ -109,15 +108,27 @@ int ompi_mtl_psm_module_init(int local_rank, int num_local_procs) {
       
     }
 
+    ompi_mtl_psm.ep   = (psm_ep_t *) calloc(nctx, sizeof(psm_ep_t));
+    ompi_mtl_psm.mq   = (psm_mq_t *) calloc(nctx, sizeof(psm_mq_t));
+    ompi_mtl_psm.epid = (psm_epid_t *) calloc(nctx, sizeof(psm_epid_t));
+    if (NULL == ompi_mtl_psm.ep || NULL == ompi_mtl_psm.mq ||
+        NULL == ompi_mtl_psm.epid) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
     /* Handle our own errors for opening endpoints */
-    psm_error_register_handler(ompi_mtl_psm.ep, ompi_mtl_psm_errhandler);
+    psm_error_register_handler(NULL, ompi_mtl_psm_errhandler);
 
     /* Setup MPI_LOCALRANKID and MPI_LOCALNRANKS so PSM can allocate hardware
-     * contexts correctly.
+     * contexts correctly.  With several contexts per process every
+     * endpoint counts as a local rank of its own, unless the user set
+     * them.
      */
-    snprintf(env_string, sizeof(env_string), "%d", local_rank);
+    set_local_ranks = (NULL == getenv("MPI_LOCALRANKID") &&
+                       NULL == getenv("MPI_LOCALNRANKS"));
+    snprintf(env_string, sizeof(env_string), "%d", local_rank * nctx);
     setenv("MPI_LOCALRANKID", env_string, 0);
-    snprintf(env_string, sizeof(env_string), "%d", num_local_procs);
+    snprintf(env_string, sizeof(env_string), "%d", num_local_procs * nctx);
     setenv("MPI_LOCALNRANKS", env_string, 0);
     
     /* Setup the endpoint options. */
@@ -142,38 +153,43 @@ int ompi_mtl_psm_module_init(int local_rank, int num_local_procs) {
     ep_opt.path_res_type = ompi_mtl_psm.path_res_type;
 #endif
 
-    /* Open PSM endpoint */
-    err = psm_ep_open(unique_job_key, &ep_opt, &ep, &epid);
-    if (err) {
-      opal_show_help("help-mtl-psm.txt",
-		     "unable to open endpoint", true,
-		     psm_error_get_string(err));
-      return OMPI_ERROR;
+    for (ctx = 0; ctx < nctx; ctx++) {
+      if (set_local_ranks) {
+        snprintf(env_string, sizeof(env_string), "%d", local_rank * nctx + ctx);
+        setenv("MPI_LOCALRANKID", env_string, 1);
+      }
+
+      /* Open PSM endpoint */
+      err = psm_ep_open(unique_job_key, &ep_opt,
+                        &ompi_mtl_psm.ep[ctx], &ompi_mtl_psm.epid[ctx]);
+      if (err) {
+        opal_show_help("help-mtl-psm.txt",
+		       "unable to open endpoint", true,
+		       psm_error_get_string(err));
+        return OMPI_ERROR;
+      }
+
+      err = psm_mq_init(ompi_mtl_psm.ep[ctx], 
+		        0xffff000000000000ULL, 
+		        NULL,
+		        0,
+		        &ompi_mtl_psm.mq[ctx]);
+      if (err) {
+        opal_show_help("help-mtl-psm.txt",
+		       "psm init", true,
+		       psm_error_get_string(err));
+        return OMPI_ERROR;
+      }
     }
 
     /* Future errors are handled by the default error handler */
-    psm_error_register_handler(ompi_mtl_psm.ep, PSM_ERRHANDLER_DEFAULT);
-    
-    err = psm_mq_init(ep, 
-		      0xffff000000000000ULL, 
-		      NULL,
-		      0,
-		      &mq);
-    if (err) {
-      opal_show_help("help-mtl-psm.txt",
-		     "psm init", true,
-		     psm_error_get_string(err));
-      return OMPI_ERROR;
-    }
-
-    ompi_mtl_psm.ep   = ep;
-    ompi_mtl_psm.epid = epid;
-    ompi_mtl_psm.mq   = mq;
+    psm_error_register_handler(NULL, PSM_ERRHANDLER_DEFAULT);
 
+    /* the epids of all the contexts, in order */
     if (OMPI_SUCCESS != 
 	ompi_modex_send( &mca_mtl_psm_component.super.mtl_version, 
-                             &ompi_mtl_psm.epid, 
-			     sizeof(psm_epid_t))) {
+                             ompi_mtl_psm.epid, 
+			     nctx * sizeof(psm_epid_t))) {
 	opal_output(0, "Open MPI couldn't send PSM epid to head node process"); 
 	return OMPI_ERROR;
     }
@@ -187,23 +203,29 @@ int ompi_mtl_psm_module_init(int local_rank, int num_local_procs) {
 int
 ompi_mtl_psm_finalize(struct mca_mtl_base_module_t* mtl) { 
     psm_error_t err;
+    int ctx;
 
     opal_progress_unregister(ompi_mtl_psm_progress);
 
     /* free resources */
-    err = psm_mq_finalize(ompi_mtl_psm.mq);
-    if (err) {
-        opal_output(0, "Error in psm_mq_finalize (error %s)\n", 
-		    psm_error_get_string(err));
-        return OMPI_ERROR;
-    }
-
-    err = psm_ep_close(ompi_mtl_psm.ep, PSM_EP_CLOSE_GRACEFUL, 1*1e9);
-    if (err) {
-        opal_output(0, "Error in psm_ep_close (error %s)\n", 
-		    psm_error_get_string(err));
-        return OMPI_ERROR;
+    for (ctx = 0; ctx < ompi_mtl_psm.num_contexts; ctx++) {
+        err = psm_mq_finalize(ompi_mtl_psm.mq[ctx]);
+        if (err) {
+            opal_output(0, "Error in psm_mq_finalize (error %s)\n", 
+		        psm_error_get_string(err));
+            return OMPI_ERROR;
+        }
+
+        err = psm_ep_close(ompi_mtl_psm.ep[ctx], PSM_EP_CLOSE_GRACEFUL, 1*1e9);
+        if (err) {
+            opal_output(0, "Error in psm_ep_close (error %s)\n", 
+		        psm_error_get_string(err));
+            return OMPI_ERROR;
+        }
     }
+    free(ompi_mtl_psm.mq);
+    free(ompi_mtl_psm.ep);
+    free(ompi_mtl_psm.epid);
 
     err = psm_finalize();
     if (err) {
@@ -251,11 +273,11 @@ ompi_mtl_psm_add_procs(struct mca_mtl_base_module_t *mtl,
                       struct mca_mtl_base_endpoint_t **mtl_peer_data)
 {
     int i,j; 
-    int rc;
+    int rc, ctx, nctx = ompi_mtl_psm.num_contexts;
     psm_epid_t   *epids_in = NULL;
     psm_epid_t	 *epid;
     psm_epaddr_t *epaddrs_out = NULL;
-    psm_error_t  *errs_out = NULL, err;
+    psm_error_t  *errs_out = NULL, err = PSM_OK;
     size_t size;
     int proc_errors[PSM_ERROR_LAST] = { 0 };
     int timeout_in_secs;
@@ -267,11 +289,12 @@ ompi_mtl_psm_add_procs(struct mca_mtl_base_module_t *mtl,
     if (errs_out == NULL) {
 	goto bail;
     }
-    epids_in = (psm_epid_t *) malloc(nprocs * sizeof(psm_epid_t));
+    /* the epids and addresses of context ctx are at [ctx * nprocs] */
+    epids_in = (psm_epid_t *) malloc(nctx * nprocs * sizeof(psm_epid_t));
     if (epids_in == NULL) {
 	goto bail;
     }
-    epaddrs_out = (psm_epaddr_t *) malloc(nprocs * sizeof(psm_epaddr_t));
+    epaddrs_out = (psm_epaddr_t *) malloc(nctx * nprocs * sizeof(psm_epaddr_t));
     if (epaddrs_out == NULL) {
 	goto bail;
     }
@@ -281,23 +304,46 @@ ompi_mtl_psm_add_procs(struct mca_mtl_base_module_t *mtl,
     for (i = 0; i < (int) nprocs; i++) {
 	rc = ompi_modex_recv(&mca_mtl_psm_component.super.mtl_version, 
 				     procs[i], (void**)&epid, &size);
-	if (rc != OMPI_SUCCESS || size != sizeof(psm_epid_t)) {
-	  return OMPI_ERROR;
+	if (rc != OMPI_SUCCESS || size % sizeof(psm_epid_t) != 0) {
+	  rc = OMPI_ERROR;
+	  goto bail;
+	}
+	if (size != nctx * sizeof(psm_epid_t)) {
+	  opal_output(0, "PSM: %s opened %d contexts, this process %d "
+		      "(mtl_psm_num_contexts must be the same everywhere)\n",
+		      procs[i]->proc_hostname, (int) (size / sizeof(psm_epid_t)),
+		      nctx);
+	  rc = OMPI_ERROR;
+	  goto bail;
+	}
+	for (ctx = 0; ctx < nctx; ctx++) {
+	    epids_in[ctx * nprocs + i] = epid[ctx];
 	}
-	epids_in[i] = *epid;
     }
 
     timeout_in_secs = max(ompi_mtl_psm.connect_timeout, 0.5 * nprocs);
 
-    psm_error_register_handler(ompi_mtl_psm.ep, PSM_ERRHANDLER_NOP);
+    /* every context only talks to the same context of its peers */
+    for (ctx = 0; ctx < nctx; ctx++) {
+	psm_error_register_handler(ompi_mtl_psm.ep[ctx], PSM_ERRHANDLER_NOP);
+
+	err = psm_ep_connect(ompi_mtl_psm.ep[ctx],
+			     nprocs,
+			     epids_in + ctx * nprocs,
+			     NULL, /* connect all */
+			     errs_out,
+			     epaddrs_out + ctx * nprocs,
+			     timeout_in_secs * 1e9);
+	if (err) {
+	    break;
+	}
+
+	/* Default error handling is enabled, errors will not be returned to
+	 * user.  PSM prints the error and the offending endpoint's hostname
+	 * and exits with -1 */
+	psm_error_register_handler(ompi_mtl_psm.ep[ctx], PSM_ERRHANDLER_DEFAULT);
+    }
 
-    err = psm_ep_connect(ompi_mtl_psm.ep,
-			 nprocs,
-			 epids_in,
-			 NULL, /* connect all */
-			 errs_out,
-			 epaddrs_out,
-			 timeout_in_secs * 1e9);
     if (err) {
 	char *errstr = (char *) ompi_mtl_psm_connect_error_msg(err);
 	if (errstr == NULL) {
@@ -323,17 +369,23 @@ ompi_mtl_psm_add_procs(struct mca_mtl_base_module_t *mtl,
 	rc = OMPI_ERROR;
     }
     else {
-	/* Default error handling is enabled, errors will not be returned to
-	 * user.  PSM prints the error and the offending endpoint's hostname
-	 * and exits with -1 */
-	psm_error_register_handler(ompi_mtl_psm.ep, PSM_ERRHANDLER_DEFAULT);
-		
 	/* Fill in endpoint data */
 	for (i = 0; i < (int) nprocs; i++) { 
 	    mtl_peer_data[i] =
 		(mca_mtl_psm_endpoint_t *) OBJ_NEW(mca_mtl_psm_endpoint_t);
-	    mtl_peer_data[i]->peer_epid = epids_in[i];
-	    mtl_peer_data[i]->peer_addr = epaddrs_out[i];
+	    mtl_peer_data[i]->peer_epid =
+		(psm_epid_t *) malloc(nctx * sizeof(psm_epid_t));
+	    mtl_peer_data[i]->peer_addr =
+		(psm_epaddr_t *) malloc(nctx * sizeof(psm_epaddr_t));
+	    if (NULL == mtl_peer_data[i]->peer_epid ||
+		NULL == mtl_peer_data[i]->peer_addr) {
+		rc = OMPI_ERR_OUT_OF_RESOURCE;
+		goto bail;
+	    }
+	    for (ctx = 0; ctx < nctx; ctx++) {
+		mtl_peer_data[i]->peer_epid[ctx] = epids_in[ctx * nprocs + i];
+		mtl_peer_data[i]->peer_addr[ctx] = epaddrs_out[ctx * nprocs + i];
+	    }
 	}
 
 	rc = OMPI_SUCCESS;
@@ -379,7 +431,7 @@ ompi_mtl_psm_del_comm(struct mca_mtl_base_module_t *mtl,
 }
 
 
-int ompi_mtl_psm_progress( void ) { 
+static int ompi_mtl_psm_progress_mq(psm_mq_t mq) { 
     psm_error_t err;
     mca_mtl_psm_request_t* mtl_psm_request;
     psm_mq_status_t psm_status;
@@ -387,7 +439,7 @@ int ompi_mtl_psm_progress( void ) {
     int completed = 1;
 
     do {
-        err = psm_mq_ipeek(ompi_mtl_psm.mq, &req, NULL);
+        err = psm_mq_ipeek(mq, &req, NULL);
 	if (err == PSM_MQ_INCOMPLETE) {
 	    return completed;
 	} else if (err != PSM_OK) {
@@ -448,3 +500,12 @@ int ompi_mtl_psm_progress( void ) {
     return 1;
 }
 
+
+int ompi_mtl_psm_progress( void ) { 
+    int ctx, completed = 0;
+
+    for (ctx = 0; ctx < ompi_mtl_psm.num_contexts; ctx++) {
+        completed += ompi_mtl_psm_progress_mq(ompi_mtl_psm.mq[ctx]);
+    }
+    return completed;
+}
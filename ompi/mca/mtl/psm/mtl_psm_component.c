@@ -135,6 +135,15 @@ ompi_mtl_psm_component_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &ompi_mtl_psm.ib_pkey);
     
+    ompi_mtl_psm.num_contexts = 1;
+    (void) mca_base_component_var_register(&mca_mtl_psm_component.super.mtl_version,
+                                           "num_contexts",
+                                           "Number of PSM endpoints (hardware contexts) opened by each process, communicators are spread over them by context id so that threads working on different communicators do not share a matched queue (must be the same in all processes)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_mtl_psm.num_contexts);
+
 #if PSM_VERNO >= 0x010d
     ompi_mtl_psm.ib_service_id = 0x1000117500000000ull;
     (void) mca_base_component_var_register(&mca_mtl_psm_component.super.mtl_version,
@@ -171,6 +180,10 @@ ompi_mtl_psm_component_open(void)
       ompi_mtl_psm.ib_service_level = 15;
     }
 
+    if (ompi_mtl_psm.num_contexts < 1) {
+      ompi_mtl_psm.num_contexts = 1;
+    }
+
   /* Component available only if Truescale hardware is present */
   if (0 == stat("/dev/ipath", &st)) {
     return OMPI_SUCCESS;
@@ -274,7 +287,9 @@ ompi_mtl_psm_component_init(bool enable_progress_threads,
     }
     
     /* Complete PSM initialization */
-    ompi_mtl_psm_module_init(local_rank, num_local_procs);
+    if (OMPI_SUCCESS != ompi_mtl_psm_module_init(local_rank, num_local_procs)) {
+      return NULL;
+    }
 
     ompi_mtl_psm.super.mtl_request_size = 
       sizeof(mca_mtl_psm_request_t) - 
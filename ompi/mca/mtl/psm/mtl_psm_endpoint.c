@@ -21,6 +21,7 @@
 #include "ompi_config.h"
 #include <sys/time.h>
 #include <time.h>
+#include <stdlib.h>
 #include "ompi/types.h"
 #include "mtl_psm.h"
 #include "mtl_psm_types.h"
@@ -34,6 +35,8 @@
 static void mca_mtl_psm_endpoint_construct(mca_mtl_psm_endpoint_t* endpoint)
 {
     endpoint->mtl_psm_module = NULL;
+    endpoint->peer_epid = NULL;
+    endpoint->peer_addr = NULL;
 }
 
 /*
@@ -43,6 +46,12 @@ static void mca_mtl_psm_endpoint_construct(mca_mtl_psm_endpoint_t* endpoint)
 
 static void mca_mtl_psm_endpoint_destruct(mca_mtl_psm_endpoint_t* endpoint)
 {
+    if (NULL != endpoint->peer_epid) {
+        free(endpoint->peer_epid);
+    }
+    if (NULL != endpoint->peer_addr) {
+        free(endpoint->peer_addr);
+    }
 }
 
 
@@ -44,11 +44,11 @@ struct mca_mtl_base_endpoint_t {
     struct mca_mtl_psm_module_t* mtl_psm_module;
     /**< MTL instance that created this connection */
     
-    psm_epid_t	    peer_epid;
-    /**< The unique epid for the opened port */
+    psm_epid_t	    *peer_epid;
+    /**< The unique epid of each context of the peer */
 
-    psm_epaddr_t    peer_addr;
-    /**< The connected endpoint handle*/
+    psm_epaddr_t    *peer_addr;
+    /**< The connected endpoint handle of each context */
 };
 
 typedef struct mca_mtl_base_endpoint_t mca_mtl_base_endpoint_t;
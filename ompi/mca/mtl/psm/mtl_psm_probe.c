@@ -39,7 +39,7 @@ int ompi_mtl_psm_iprobe(struct mca_mtl_base_module_t* mtl,
 
     PSM_MAKE_TAGSEL(src, tag, comm->c_contextid, mqtag, tagsel);
 
-    err = psm_mq_iprobe(ompi_mtl_psm.mq, mqtag, tagsel, &mqstat);
+    err = psm_mq_iprobe(ompi_mtl_psm.mq[OMPI_MTL_PSM_CONTEXT(comm)], mqtag, tagsel, &mqstat);
     if (err == PSM_OK) {
 	*flag = 1;
 	if(MPI_STATUS_IGNORE != status) { 
@@ -59,7 +59,7 @@ ompi_mtl_psm_irecv(struct mca_mtl_base_module_t* mtl,
 #if 0
     printf("recv bits:   0x%016llx 0x%016llx\n", mqtag, tagsel);
 #endif
-    err = psm_mq_irecv(ompi_mtl_psm.mq, 
+    err = psm_mq_irecv(ompi_mtl_psm.mq[OMPI_MTL_PSM_CONTEXT(comm)], 
 		       mqtag,
 		       tagsel,
 		       0,
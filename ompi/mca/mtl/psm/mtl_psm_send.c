@@ -39,7 +39,7 @@ ompi_mtl_psm_send(struct mca_mtl_base_module_t* mtl,
     mca_mtl_psm_request_t mtl_psm_request;
     uint64_t mqtag;
     uint32_t flags = 0;
-    int ret;
+    int ret, ctx;
     size_t length;
     ompi_proc_t* ompi_proc = ompi_comm_peer_lookup( comm, dest );
     mca_mtl_psm_endpoint_t* psm_endpoint = (mca_mtl_psm_endpoint_t*) ompi_proc->proc_pml;
@@ -63,8 +63,9 @@ ompi_mtl_psm_send(struct mca_mtl_base_module_t* mtl,
     if (mode == MCA_PML_BASE_SEND_SYNCHRONOUS)
 	flags |= PSM_MQ_FLAG_SENDSYNC;
 
-    err = psm_mq_send(ompi_mtl_psm.mq,
-		      psm_endpoint->peer_addr,
+    ctx = OMPI_MTL_PSM_CONTEXT(comm);
+    err = psm_mq_send(ompi_mtl_psm.mq[ctx],
+		      psm_endpoint->peer_addr[ctx],
 		      flags,
 		      mqtag,
 		      mtl_psm_request.buf,
@@ -90,7 +91,7 @@ ompi_mtl_psm_isend(struct mca_mtl_base_module_t* mtl,
     psm_error_t psm_error;
     uint64_t mqtag;
     uint32_t flags = 0;
-    int ret;
+    int ret, ctx;
     mca_mtl_psm_request_t * mtl_psm_request = (mca_mtl_psm_request_t*) mtl_request;
     size_t length;
     ompi_proc_t* ompi_proc = ompi_comm_peer_lookup( comm, dest );
@@ -115,8 +116,9 @@ ompi_mtl_psm_isend(struct mca_mtl_base_module_t* mtl,
     if (mode == MCA_PML_BASE_SEND_SYNCHRONOUS)
 	flags |= PSM_MQ_FLAG_SENDSYNC;
     
-    psm_error = psm_mq_isend(ompi_mtl_psm.mq,
-			     psm_endpoint->peer_addr,
+    ctx = OMPI_MTL_PSM_CONTEXT(comm);
+    psm_error = psm_mq_isend(ompi_mtl_psm.mq[ctx],
+			     psm_endpoint->peer_addr[ctx],
 			     flags,
 			     mqtag,
 			     mtl_psm_request->buf,
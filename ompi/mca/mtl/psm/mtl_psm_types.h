@@ -55,10 +55,12 @@ struct mca_mtl_psm_module_t {
     int          path_res_type;
 #endif
 
-    psm_ep_t	 ep;
-    psm_mq_t	 mq;
-    psm_epid_t	 epid;
-    psm_epaddr_t epaddr;
+    /* one PSM endpoint and matched queue per context, communicators
+       are spread over the contexts by context id */
+    int32_t      num_contexts;
+    psm_ep_t	 *ep;
+    psm_mq_t	 *mq;
+    psm_epid_t	 *epid;
 }; 
 
 typedef struct mca_mtl_psm_module_t mca_mtl_psm_module_t;
@@ -72,6 +74,11 @@ typedef struct mca_mtl_psm_component_t mca_mtl_psm_component_t;
 
 OMPI_DECLSPEC mca_mtl_psm_component_t mca_mtl_psm_component;
     
+/* the context of a communicator must be the same in every process, so
+   that the sender queues the message where the receiver matches it */
+#define OMPI_MTL_PSM_CONTEXT(comm)                                      \
+        ((int) ((comm)->c_contextid % (uint32_t) ompi_mtl_psm.num_contexts))
+
 #define PSM_MAKE_MQTAG(ctxt,rank,utag)		    \
         ( (((ctxt)&0xffffULL)<<48)| (((rank)&0xffffULL)<<32)| \
 	  (((utag)&0xffffffffULL)) )
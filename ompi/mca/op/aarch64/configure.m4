@@ -0,0 +1,57 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+#                         University Research and Technology
+#                         Corporation.  All rights reserved.
+# Copyright (c) 2004-2005 The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# Copyright (c) 2004-2005 High Performance Computing Center Stuttgart, 
+#                         University of Stuttgart.  All rights reserved.
+# Copyright (c) 2004-2005 The Regents of the University of California.
+#                         All rights reserved.
+# Copyright (c) 2008-2010 Cisco Systems, Inc.  All rights reserved.
+# $COPYRIGHT$
+# 
+# Additional copyrights may follow
+# 
+# $HEADER$
+#
+
+# MCA_op_aarch64_CONFIG([action-if-found], [action-if-not-found])
+# ---------------------------------------------------------------
+# The component is built on 64 bit ARM, where Advanced SIMD (NEON) is
+# part of the base architecture.  SVE kernels are added when the
+# compiler can generate SVE code through the function "target"
+# attribute; whether they are used is decided at run time from the
+# HWCAP bits of the auxiliary vector.
+AC_DEFUN([MCA_ompi_op_aarch64_CONFIG],[
+    AC_CONFIG_FILES([ompi/mca/op/aarch64/Makefile])
+
+    op_aarch64_happy=0
+    op_aarch64_have_sve=0
+
+    case "$host" in
+        aarch64-*|arm64-*)
+            AC_CHECK_HEADERS([sys/auxv.h arm_neon.h], [op_aarch64_happy=1],
+                             [op_aarch64_happy=0; break])
+            ;;
+    esac
+
+    AS_IF([test $op_aarch64_happy -eq 1],
+          [AC_MSG_CHECKING([if $CC supports the +sve function target])
+           AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[#include <arm_sve.h>
+__attribute__((__target__("+sve"))) void op_aarch64_test(double *a, const double *b, long n)
+{
+    svbool_t pg = svwhilelt_b64(0L, n);
+    svst1(pg, a, svadd_x(pg, svld1(pg, a), svld1(pg, b)));
+}]], [[]])],
+               [AC_MSG_RESULT([yes])
+                op_aarch64_have_sve=1],
+               [AC_MSG_RESULT([no])])])
+
+    AC_DEFINE_UNQUOTED([OMPI_OP_AARCH64_HAVE_SVE], [$op_aarch64_have_sve],
+                       [Whether the compiler can generate SVE kernels for the aarch64 op component])
+
+    AS_IF([test $op_aarch64_happy -eq 1], [$1], [$2])
+])dnl
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2004-2008 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2005 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart, 
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2008-2009 Cisco Systems, Inc.  All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#ifndef MCA_OP_AARCH64_EXPORT_H
+#define MCA_OP_AARCH64_EXPORT_H
+
+#include "ompi_config.h"
+
+#include "opal/mca/mca.h"
+#include "opal/class/opal_object.h"
+
+#include "ompi/mca/op/op.h"
+
+BEGIN_C_DECLS
+
+/**
+ * Flags for each hardware type
+ */
+typedef enum {
+    OP_AARCH64_HW_FLAGS_NEON = 1,
+    OP_AARCH64_HW_FLAGS_SVE = 2
+} op_aarch64_hw_flags_t;
+
+/**
+ * Instruction set tiers that we have kernels for, in increasing
+ * order of preference.
+ */
+enum {
+    OMPI_OP_AARCH64_ISA_NEON = 0,
+    OMPI_OP_AARCH64_ISA_SVE,
+
+    OMPI_OP_AARCH64_ISA_MAX
+};
+
+/**
+ * Derive a struct from the base op component struct, allowing us to
+ * cache some component-specific information on our well-known
+ * component struct.
+ */
+typedef struct {
+    /** The base op component struct */
+    ompi_op_base_component_1_0_0_t super;
+
+    /* What hardware do we have? */
+    op_aarch64_hw_flags_t oac_hw_flags;
+
+    /* Highest ISA tier that the user allows us to use (MCA param) */
+    int oac_max_isa;
+
+    /* Priority of this component relative to the base functions */
+    int oac_priority;
+} ompi_op_aarch64_component_t;
+
+/**
+ * Derive a struct from the base op module struct.  The kernels are
+ * stateless, so there is nothing to cache here; the same module type
+ * is used for every MPI_Op that we support.
+ */
+typedef struct {
+    ompi_op_base_module_1_0_0_t super;
+} ompi_op_aarch64_module_t;
+
+OBJ_CLASS_DECLARATION(ompi_op_aarch64_module_t);
+
+/**
+ * Well-known component instance
+ */
+OMPI_DECLSPEC extern ompi_op_aarch64_component_t mca_op_aarch64_component;
+
+/**
+ * Kernel tables, indexed by [ISA tier][MPI_Op][datatype].  A NULL
+ * entry means that there is no vector kernel for that combination at
+ * that tier (e.g., 64 bit integer multiply).
+ */
+OMPI_DECLSPEC extern ompi_op_base_handler_fn_t
+    ompi_op_aarch64_functions[OMPI_OP_AARCH64_ISA_MAX][OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+OMPI_DECLSPEC extern ompi_op_base_3buff_handler_fn_t
+    ompi_op_aarch64_3buff_functions[OMPI_OP_AARCH64_ISA_MAX][OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+
+/**
+ * Fill in the kernel tables entries for the Fortran and MPI_BYTE
+ * datatypes from the C fixed-width entries of the same size.
+ */
+OMPI_DECLSPEC void ompi_op_aarch64_functions_init(void);
+
+/**
+ * Setup for any supported intrinsic MPI_Op and return a module (or
+ * NULL if we have no kernels for this MPI_Op on this hardware).
+ */
+OMPI_DECLSPEC ompi_op_base_module_t *ompi_op_aarch64_setup(ompi_op_t *op);
+
+END_C_DECLS
+
+#endif /* MCA_OP_AARCH64_EXPORT_H */
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2004-2007 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2007 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart, 
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2008-2013 Cisco Systems, Inc.  All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * This is the "aarch64" component source code.  It contains the
+ * well-known struct that OMPI will dlsym() (or equivalent) for to
+ * find how to access the rest of the component and any modules that
+ * are created.
+ */
+
+#include "ompi_config.h"
+
+#if defined(HAVE_SYS_AUXV_H)
+#include <sys/auxv.h>
+#endif
+
+/* Not every libc exports the HWCAP bits of the kernel */
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD (1 << 1)
+#endif
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1 << 22)
+#endif
+
+#include "opal/util/output.h"
+#include "opal/mca/base/mca_base_var.h"
+
+#include "ompi/constants.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/mca/op/base/base.h"
+#include "ompi/mca/op/aarch64/op_aarch64.h"
+
+static int aarch64_component_open(void);
+static int aarch64_component_close(void);
+static int aarch64_component_init_query(bool enable_progress_threads,
+                                     bool enable_mpi_threads);
+static struct ompi_op_base_module_1_0_0_t *
+    aarch64_component_op_query(struct ompi_op_t *op, int *priority);
+static int aarch64_component_register(void);
+
+ompi_op_aarch64_component_t mca_op_aarch64_component = {
+    /* First, the mca_base_component_t struct containing meta
+       information about the component itself */
+    {
+        {
+            OMPI_OP_BASE_VERSION_1_0_0,
+            
+            "aarch64",
+            OMPI_MAJOR_VERSION,
+            OMPI_MINOR_VERSION,
+            OMPI_RELEASE_VERSION,
+            aarch64_component_open,
+            aarch64_component_close,
+            NULL,
+            aarch64_component_register
+        },
+        {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        },
+        
+        aarch64_component_init_query,
+        aarch64_component_op_query,
+    },
+
+    /* Now comes the aarch64-component-specific data.  In this case,
+       we'll just leave it blank, defaulting all the values to
+       0/false/whatever.  We'll fill them in with meaningful values
+       during _component_init_query(). */
+};
+
+/*
+ * Component open
+ */
+static int aarch64_component_open(void)
+{
+    opal_output(ompi_op_base_framework.framework_output, "aarch64 component open");
+
+    /* A first level check to see if aarch64 is even available in this
+       process.  E.g., you may want to do a first-order check to see
+       if hardware is available.  If so, return OMPI_SUCCESS.  If not,
+       return anything other than OMPI_SUCCESS and the component will
+       silently be ignored.
+
+       Note that if this function returns non-OMPI_SUCCESS, then this
+       component won't even be shown in ompi_info output (which is
+       probably not what you want).
+    */
+
+    return OMPI_SUCCESS;
+}
+
+
+/*
+ * Component close
+ */
+static int aarch64_component_close(void)
+{
+    opal_output(ompi_op_base_framework.framework_output, "aarch64 component close");
+
+    /* If aarch64 was opened successfully, close it (i.e., release any
+       resources that may have been allocated on this component).
+       Note that _component_close() will always be called at the end
+       of the process, so it may have been after any/all of the other
+       component functions have been invoked (and possibly even after
+       modules have been created and/or destroyed). */
+
+    return OMPI_SUCCESS;
+}
+
+
+/*
+ * Probe the hardware and see what we have.  Advanced SIMD is part of
+ * the base ARMv8-A architecture, but the kernel still reports it (and
+ * SVE, which also needs the kernel to save the Z registers) in the
+ * auxiliary vector.
+ */
+static void hardware_probe(void)
+{
+#if defined(HAVE_SYS_AUXV_H)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    int flags = 0;
+
+    if (0 != (hwcap & HWCAP_ASIMD)) {
+        flags |= OP_AARCH64_HW_FLAGS_NEON;
+    }
+    if (0 != (hwcap & HWCAP_SVE)) {
+        flags |= OP_AARCH64_HW_FLAGS_SVE;
+    }
+
+    mca_op_aarch64_component.oac_hw_flags = (op_aarch64_hw_flags_t) flags;
+#endif
+}
+
+static bool aarch64_neon_available;
+static bool aarch64_sve_available;
+
+/*
+ * Register MCA params.
+ */
+static int aarch64_component_register(void)
+{
+    opal_output(ompi_op_base_framework.framework_output, "aarch64 component register");
+
+    /* Probe the hardware and see what we have */
+    hardware_probe();
+
+    aarch64_neon_available = (0 != (mca_op_aarch64_component.oac_hw_flags & OP_AARCH64_HW_FLAGS_NEON));
+    (void) mca_base_component_var_register(&mca_op_aarch64_component.super.opc_version,
+                                           "neon_available", "Whether the hardware supports Advanced SIMD (NEON) or not",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &aarch64_neon_available);
+
+    aarch64_sve_available = (0 != (mca_op_aarch64_component.oac_hw_flags & OP_AARCH64_HW_FLAGS_SVE));
+    (void) mca_base_component_var_register(&mca_op_aarch64_component.super.opc_version,
+                                           "sve_available", "Whether the hardware (and OS) supports SVE or not",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &aarch64_sve_available);
+
+    mca_op_aarch64_component.oac_max_isa = OMPI_OP_AARCH64_ISA_MAX - 1;
+    (void) mca_base_component_var_register(&mca_op_aarch64_component.super.opc_version,
+                                           "max_isa", "Highest instruction set tier to use for reduction kernels "
+                                           "(0 = NEON, 1 = SVE).  Tiers that the hardware "
+                                           "does not support are never used.",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_op_aarch64_component.oac_max_isa);
+
+    mca_op_aarch64_component.oac_priority = 25;
+    (void) mca_base_component_var_register(&mca_op_aarch64_component.super.opc_version,
+                                           "priority", "Priority of the aarch64 op component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_op_aarch64_component.oac_priority);
+
+    return OMPI_SUCCESS;
+}
+
+
+/*
+ * Query whether this component wants to be used in this process.
+ */
+static int aarch64_component_init_query(bool enable_progress_threads,
+                                        bool enable_mpi_threads)
+{
+    opal_output(ompi_op_base_framework.framework_output, "aarch64 component init query");
+
+    /* Clamp the user's choice to what the hardware can do */
+    if (0 == (mca_op_aarch64_component.oac_hw_flags & OP_AARCH64_HW_FLAGS_SVE) &&
+        mca_op_aarch64_component.oac_max_isa >= OMPI_OP_AARCH64_ISA_SVE) {
+        mca_op_aarch64_component.oac_max_isa = OMPI_OP_AARCH64_ISA_NEON;
+    }
+
+    /* The kernels are stateless, so they are safe to use with any
+       thread level.  All we need is (at least) NEON. */
+    if (0 == (mca_op_aarch64_component.oac_hw_flags & OP_AARCH64_HW_FLAGS_NEON) ||
+        mca_op_aarch64_component.oac_max_isa < OMPI_OP_AARCH64_ISA_NEON) {
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    ompi_op_aarch64_functions_init();
+    return OMPI_SUCCESS;
+}
+
+
+/*
+ * Query whether this component can be used for a specific op
+ */
+static struct ompi_op_base_module_1_0_0_t *
+    aarch64_component_op_query(struct ompi_op_t *op, int *priority)
+{
+    ompi_op_base_module_t *module = NULL;
+
+    opal_output(ompi_op_base_framework.framework_output, "aarch64 component op query");
+
+    /* Sanity check -- although the framework should never invoke the
+       _component_op_query() on non-intrinsic MPI_Op's, we'll put a
+       check here just to be sure. */
+    if (0 == (OMPI_OP_FLAGS_INTRINSIC & op->o_flags)) {
+        opal_output(0, "aarch64 component op query: not an intrinsic MPI_Op -- skipping");
+        return NULL;
+    }
+
+    /* Note that we *do* have the hardware; _component_init_query()
+       would not have returned OMPI_SUCCESS if we didn't have the
+       hardware (and therefore this function would never have been
+       called).  The setup function will figure out for which
+       datatypes we have kernels. */
+    switch (op->o_f_to_c_index) {
+    case OMPI_OP_BASE_FORTRAN_SUM:
+    case OMPI_OP_BASE_FORTRAN_PROD:
+    case OMPI_OP_BASE_FORTRAN_MAX:
+    case OMPI_OP_BASE_FORTRAN_MIN:
+    case OMPI_OP_BASE_FORTRAN_BAND:
+    case OMPI_OP_BASE_FORTRAN_BOR:
+    case OMPI_OP_BASE_FORTRAN_BXOR:
+        module = ompi_op_aarch64_setup(op);
+        break;
+    }
+
+    /* If we got a module from above, we'll return it.  Otherwise,
+       we'll return NULL, indicating that this component does not want
+       to be considered for selection for this MPI_Op.  Note that the
+       "setup" functions each returned a *aarch64* component pointer
+       (vs. a *base* component pointer -- where an *aarch64* component
+       is a base component plus some other module-specific cached
+       information), so we have to cast it to the right pointer type
+       before returning. */
+    if (NULL != module) {
+        *priority = mca_op_aarch64_component.oac_priority;
+    }
+    return (ompi_op_base_module_1_0_0_t *) module;
+}
@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2004-2006 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2010 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2007 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2006-2009 Cisco Systems, Inc.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * Vector reduction kernels for the aarch64 op component.
+ *
+ * Advanced SIMD (NEON) is part of the base architecture, so those
+ * kernels are compiled with the default CFLAGS; the SVE kernels are
+ * compiled with the compiler's function "target" attribute, and the
+ * tier is picked at run time from the HWCAP bits.  The NEON kernels
+ * have a 128 bit main loop and do the remainder with scalar code; the
+ * SVE kernels are vector length agnostic and handle the remainder
+ * with a predicate.  Both have exactly the same semantics as the base
+ * functions in ompi/mca/op/base/op_base_functions.c: MAX and MIN are
+ * done with a compare and a select rather than FMAX / FMIN, so that
+ * NaNs and signed zeros come out as with (a > b ? a : b).
+ */
+
+#include "ompi_config.h"
+
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#include <stdint.h>
+#include <string.h>
+#include <arm_neon.h>
+#if OMPI_OP_AARCH64_HAVE_SVE
+#include <arm_sve.h>
+#endif
+
+#include "ompi/op/op.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/mca/op/aarch64/op_aarch64.h"
+
+ompi_op_base_handler_fn_t
+    ompi_op_aarch64_functions[OMPI_OP_AARCH64_ISA_MAX][OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+ompi_op_base_3buff_handler_fn_t
+    ompi_op_aarch64_3buff_functions[OMPI_OP_AARCH64_ISA_MAX][OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+
+#define OP_AARCH64_TARGET_sve __attribute__((__target__("+sve")))
+
+/*
+ * Scalar versions of the operations, used for the tail of each NEON
+ * kernel.  Argument order is (out, in) for the 2-buffer variants and
+ * (in1, in2) for the 3-buffer variants, just like the base functions.
+ */
+#define OP_AARCH64_S_sum(a, b)  ((a) + (b))
+#define OP_AARCH64_S_prod(a, b) ((a) * (b))
+#define OP_AARCH64_S_max(a, b)  ((a) > (b) ? (a) : (b))
+#define OP_AARCH64_S_min(a, b)  ((a) < (b) ? (a) : (b))
+#define OP_AARCH64_S_band(a, b) ((a) & (b))
+#define OP_AARCH64_S_bor(a, b)  ((a) | (b))
+#define OP_AARCH64_S_bxor(a, b) ((a) ^ (b))
+
+/*
+ * NEON versions, by intrinsic suffix (s8, u8, ..., f64)
+ */
+#define OP_AARCH64_NEON_sum(sfx, a, b)  vaddq_##sfx(a, b)
+#define OP_AARCH64_NEON_prod(sfx, a, b) vmulq_##sfx(a, b)
+#define OP_AARCH64_NEON_max(sfx, a, b)  vbslq_##sfx(vcgtq_##sfx(a, b), a, b)
+#define OP_AARCH64_NEON_min(sfx, a, b)  vbslq_##sfx(vcltq_##sfx(a, b), a, b)
+#define OP_AARCH64_NEON_band(sfx, a, b) vandq_##sfx(a, b)
+#define OP_AARCH64_NEON_bor(sfx, a, b)  vorrq_##sfx(a, b)
+#define OP_AARCH64_NEON_bxor(sfx, a, b) veorq_##sfx(a, b)
+
+/*
+ * SVE versions, with the (overloaded) ACLE intrinsics
+ */
+#define OP_AARCH64_SVE_sum(pg, a, b)  svadd_x(pg, a, b)
+#define OP_AARCH64_SVE_prod(pg, a, b) svmul_x(pg, a, b)
+#define OP_AARCH64_SVE_max(pg, a, b)  svsel(svcmpgt(pg, a, b), a, b)
+#define OP_AARCH64_SVE_min(pg, a, b)  svsel(svcmplt(pg, a, b), a, b)
+#define OP_AARCH64_SVE_band(pg, a, b) svand_x(pg, a, b)
+#define OP_AARCH64_SVE_bor(pg, a, b)  svorr_x(pg, a, b)
+#define OP_AARCH64_SVE_bxor(pg, a, b) sveor_x(pg, a, b)
+
+/*
+ * Since all the functions in this file are essentially identical, we
+ * use a macro to substitute in names and types.  This generates both
+ * the (out op= in) and the (out = in1 op in2) variants.  The NEON
+ * loads and stores have no alignment requirement.
+ */
+#define OP_AARCH64_NEON_FUNC(name, type_name, type, vtype, sfx)         \
+  static void                                                           \
+  ompi_op_aarch64_neon_##name##_##type_name(void *in, void *out, int *count, \
+                                            struct ompi_datatype_t **dtype, \
+                                            struct ompi_op_base_module_1_0_0_t *module) \
+  {                                                                     \
+      const int width = (int) (sizeof(vtype) / sizeof(type));           \
+      int i = 0, n = *count;                                            \
+      type *a = (type *) in;                                            \
+      type *b = (type *) out;                                           \
+      for (; i + width <= n; i += width) {                              \
+          vtype va = vld1q_##sfx(a + i);                                \
+          vtype vb = vld1q_##sfx(b + i);                                \
+          vst1q_##sfx(b + i, OP_AARCH64_NEON_##name(sfx, vb, va));      \
+      }                                                                 \
+      for (; i < n; ++i) {                                              \
+          b[i] = OP_AARCH64_S_##name(b[i], a[i]);                       \
+      }                                                                 \
+  }                                                                     \
+  static void                                                           \
+  ompi_op_aarch64_3buff_neon_##name##_##type_name(void * restrict in1,  \
+          void * restrict in2, void * restrict out, int *count,         \
+          struct ompi_datatype_t **dtype,                               \
+          struct ompi_op_base_module_1_0_0_t *module)                   \
+  {                                                                     \
+      const int width = (int) (sizeof(vtype) / sizeof(type));           \
+      int i = 0, n = *count;                                            \
+      type *a1 = (type *) in1;                                          \
+      type *a2 = (type *) in2;                                          \
+      type *b = (type *) out;                                           \
+      for (; i + width <= n; i += width) {                              \
+          vtype v1 = vld1q_##sfx(a1 + i);                               \
+          vtype v2 = vld1q_##sfx(a2 + i);                               \
+          vst1q_##sfx(b + i, OP_AARCH64_NEON_##name(sfx, v1, v2));      \
+      }                                                                 \
+      for (; i < n; ++i) {                                              \
+          b[i] = OP_AARCH64_S_##name(a1[i], a2[i]);                     \
+      }                                                                 \
+  }
+
+#define OP_AARCH64_SVE_FUNC(name, type_name, type, vtype, bits)         \
+  static void OP_AARCH64_TARGET_sve                                     \
+  ompi_op_aarch64_sve_##name##_##type_name(void *in, void *out, int *count, \
+                                           struct ompi_datatype_t **dtype, \
+                                           struct ompi_op_base_module_1_0_0_t *module) \
+  {                                                                     \
+      const int64_t width = (int64_t) (svcntb() / sizeof(type));        \
+      int64_t i, n = *count;                                            \
+      type *a = (type *) in;                                            \
+      type *b = (type *) out;                                           \
+      for (i = 0; i < n; i += width) {                                  \
+          svbool_t pg = svwhilelt_b##bits(i, n);                        \
+          vtype va = svld1(pg, a + i);                                  \
+          vtype vb = svld1(pg, b + i);                                  \
+          svst1(pg, b + i, OP_AARCH64_SVE_##name(pg, vb, va));          \
+      }                                                                 \
+  }                                                                     \
+  static void OP_AARCH64_TARGET_sve                                     \
+  ompi_op_aarch64_3buff_sve_##name##_##type_name(void * restrict in1,   \
+          void * restrict in2, void * restrict out, int *count,         \
+          struct ompi_datatype_t **dtype,                               \
+          struct ompi_op_base_module_1_0_0_t *module)                   \
+  {                                                                     \
+      const int64_t width = (int64_t) (svcntb() / sizeof(type));        \
+      int64_t i, n = *count;                                            \
+      type *a1 = (type *) in1;                                          \
+      type *a2 = (type *) in2;                                          \
+      type *b = (type *) out;                                           \
+      for (i = 0; i < n; i += width) {                                  \
+          svbool_t pg = svwhilelt_b##bits(i, n);                        \
+          vtype v1 = svld1(pg, a1 + i);                                 \
+          vtype v2 = svld1(pg, a2 + i);                                 \
+          svst1(pg, b + i, OP_AARCH64_SVE_##name(pg, v1, v2));          \
+      }                                                                 \
+  }
+
+/* Every operation is available for every integer type with both
+   instruction sets, except for the 64 bit NEON multiply */
+#define OP_AARCH64_NEON_INT_FUNCS(name)                                   \
+  OP_AARCH64_NEON_FUNC(name,   int8_t,   int8_t,  int8x16_t,  s8)         \
+  OP_AARCH64_NEON_FUNC(name,  uint8_t,  uint8_t, uint8x16_t,  u8)         \
+  OP_AARCH64_NEON_FUNC(name,  int16_t,  int16_t,  int16x8_t, s16)         \
+  OP_AARCH64_NEON_FUNC(name, uint16_t, uint16_t, uint16x8_t, u16)         \
+  OP_AARCH64_NEON_FUNC(name,  int32_t,  int32_t,  int32x4_t, s32)         \
+  OP_AARCH64_NEON_FUNC(name, uint32_t, uint32_t, uint32x4_t, u32)
+
+#define OP_AARCH64_NEON_INT64_FUNCS(name)                                 \
+  OP_AARCH64_NEON_FUNC(name,  int64_t,  int64_t,  int64x2_t, s64)         \
+  OP_AARCH64_NEON_FUNC(name, uint64_t, uint64_t, uint64x2_t, u64)
+
+#define OP_AARCH64_NEON_FP_FUNCS(name)                                    \
+  OP_AARCH64_NEON_FUNC(name,    float,    float, float32x4_t, f32)        \
+  OP_AARCH64_NEON_FUNC(name,   double,   double, float64x2_t, f64)
+
+#define OP_AARCH64_SVE_INT_FUNCS(name)                                    \
+  OP_AARCH64_SVE_FUNC(name,   int8_t,   int8_t,   svint8_t,  8)           \
+  OP_AARCH64_SVE_FUNC(name,  uint8_t,  uint8_t,  svuint8_t,  8)           \
+  OP_AARCH64_SVE_FUNC(name,  int16_t,  int16_t,  svint16_t, 16)           \
+  OP_AARCH64_SVE_FUNC(name, uint16_t, uint16_t, svuint16_t, 16)           \
+  OP_AARCH64_SVE_FUNC(name,  int32_t,  int32_t,  svint32_t, 32)           \
+  OP_AARCH64_SVE_FUNC(name, uint32_t, uint32_t, svuint32_t, 32)           \
+  OP_AARCH64_SVE_FUNC(name,  int64_t,  int64_t,  svint64_t, 64)           \
+  OP_AARCH64_SVE_FUNC(name, uint64_t, uint64_t, svuint64_t, 64)
+
+#define OP_AARCH64_SVE_FP_FUNCS(name)                                     \
+  OP_AARCH64_SVE_FUNC(name,    float,    float, svfloat32_t, 32)          \
+  OP_AARCH64_SVE_FUNC(name,   double,   double, svfloat64_t, 64)
+
+/*
+ * Record a kernel (both variants) in the tables
+ */
+#define OP_AARCH64_SET(isa_index, isa, op_index, name, type_index, type_name) \
+  do {                                                                  \
+      ompi_op_aarch64_functions[isa_index][op_index][type_index] =      \
+          ompi_op_aarch64_##isa##_##name##_##type_name;                 \
+      ompi_op_aarch64_3buff_functions[isa_index][op_index][type_index] = \
+          ompi_op_aarch64_3buff_##isa##_##name##_##type_name;           \
+  } while (0)
+
+#define OP_AARCH64_SET_INT(isa_index, isa, op_index, name)              \
+  do {                                                                  \
+      OP_AARCH64_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT8_T, int8_t); \
+      OP_AARCH64_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT8_T, uint8_t); \
+      OP_AARCH64_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT16_T, int16_t); \
+      OP_AARCH64_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT16_T, uint16_t); \
+      OP_AARCH64_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT32_T, int32_t); \
+      OP_AARCH64_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t); \
+  } while (0)
+
+#define OP_AARCH64_SET_INT64(isa_index, isa, op_index, name)            \
+  do {                                                                  \
+      OP_AARCH64_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT64_T, int64_t); \
+      OP_AARCH64_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT64_T, uint64_t); \
+  } while (0)
+
+#define OP_AARCH64_SET_FP(isa_index, isa, op_index, name)               \
+  do {                                                                  \
+      OP_AARCH64_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_FLOAT, float); \
+      OP_AARCH64_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_DOUBLE, double); \
+  } while (0)
+
+/*************************************************************************
+ * NEON
+ *************************************************************************/
+
+OP_AARCH64_NEON_INT_FUNCS(sum)
+OP_AARCH64_NEON_INT64_FUNCS(sum)
+OP_AARCH64_NEON_FP_FUNCS(sum)
+
+OP_AARCH64_NEON_INT_FUNCS(prod)
+OP_AARCH64_NEON_FP_FUNCS(prod)
+
+OP_AARCH64_NEON_INT_FUNCS(max)
+OP_AARCH64_NEON_INT64_FUNCS(max)
+OP_AARCH64_NEON_FP_FUNCS(max)
+
+OP_AARCH64_NEON_INT_FUNCS(min)
+OP_AARCH64_NEON_INT64_FUNCS(min)
+OP_AARCH64_NEON_FP_FUNCS(min)
+
+OP_AARCH64_NEON_INT_FUNCS(band)
+OP_AARCH64_NEON_INT64_FUNCS(band)
+OP_AARCH64_NEON_INT_FUNCS(bor)
+OP_AARCH64_NEON_INT64_FUNCS(bor)
+OP_AARCH64_NEON_INT_FUNCS(bxor)
+OP_AARCH64_NEON_INT64_FUNCS(bxor)
+
+/*************************************************************************
+ * SVE
+ *************************************************************************/
+
+#if OMPI_OP_AARCH64_HAVE_SVE
+OP_AARCH64_SVE_INT_FUNCS(sum)
+OP_AARCH64_SVE_FP_FUNCS(sum)
+OP_AARCH64_SVE_INT_FUNCS(prod)
+OP_AARCH64_SVE_FP_FUNCS(prod)
+OP_AARCH64_SVE_INT_FUNCS(max)
+OP_AARCH64_SVE_FP_FUNCS(max)
+OP_AARCH64_SVE_INT_FUNCS(min)
+OP_AARCH64_SVE_FP_FUNCS(min)
+OP_AARCH64_SVE_INT_FUNCS(band)
+OP_AARCH64_SVE_INT_FUNCS(bor)
+OP_AARCH64_SVE_INT_FUNCS(bxor)
+#endif /* OMPI_OP_AARCH64_HAVE_SVE */
+
+/*************************************************************************
+ * Table setup
+ *************************************************************************/
+
+/*
+ * Return the C fixed-width type index of a signed integer / floating
+ * point type of a given size, or -1 if we have no such type.
+ */
+static int __opal_attribute_unused__ integer_type_of_size(size_t size)
+{
+    switch (size) {
+    case 1: return OMPI_OP_BASE_TYPE_INT8_T;
+    case 2: return OMPI_OP_BASE_TYPE_INT16_T;
+    case 4: return OMPI_OP_BASE_TYPE_INT32_T;
+    case 8: return OMPI_OP_BASE_TYPE_INT64_T;
+    }
+    return -1;
+}
+
+static int __opal_attribute_unused__ real_type_of_size(size_t size)
+{
+    if (sizeof(float) == size) {
+        return OMPI_OP_BASE_TYPE_FLOAT;
+    } else if (sizeof(double) == size) {
+        return OMPI_OP_BASE_TYPE_DOUBLE;
+    }
+    return -1;
+}
+
+/*
+ * Make the kernels of C type "from" also serve datatype "to"
+ */
+static void alias_type(int to, int from)
+{
+    int isa, op;
+
+    if (from < 0) {
+        return;
+    }
+    for (isa = 0; isa < OMPI_OP_AARCH64_ISA_MAX; ++isa) {
+        for (op = 0; op < OMPI_OP_BASE_FORTRAN_OP_MAX; ++op) {
+            ompi_op_aarch64_functions[isa][op][to] =
+                ompi_op_aarch64_functions[isa][op][from];
+            ompi_op_aarch64_3buff_functions[isa][op][to] =
+                ompi_op_aarch64_3buff_functions[isa][op][from];
+        }
+    }
+}
+
+void ompi_op_aarch64_functions_init(void)
+{
+    int isa;
+
+    memset(ompi_op_aarch64_functions, 0, sizeof(ompi_op_aarch64_functions));
+    memset(ompi_op_aarch64_3buff_functions, 0,
+           sizeof(ompi_op_aarch64_3buff_functions));
+
+    /* NEON */
+    isa = OMPI_OP_AARCH64_ISA_NEON;
+    OP_AARCH64_SET_INT(isa, neon, OMPI_OP_BASE_FORTRAN_SUM, sum);
+    OP_AARCH64_SET_INT64(isa, neon, OMPI_OP_BASE_FORTRAN_SUM, sum);
+    OP_AARCH64_SET_FP(isa, neon, OMPI_OP_BASE_FORTRAN_SUM, sum);
+
+    OP_AARCH64_SET_INT(isa, neon, OMPI_OP_BASE_FORTRAN_PROD, prod);
+    OP_AARCH64_SET_FP(isa, neon, OMPI_OP_BASE_FORTRAN_PROD, prod);
+
+    OP_AARCH64_SET_INT(isa, neon, OMPI_OP_BASE_FORTRAN_MAX, max);
+    OP_AARCH64_SET_INT64(isa, neon, OMPI_OP_BASE_FORTRAN_MAX, max);
+    OP_AARCH64_SET_FP(isa, neon, OMPI_OP_BASE_FORTRAN_MAX, max);
+
+    OP_AARCH64_SET_INT(isa, neon, OMPI_OP_BASE_FORTRAN_MIN, min);
+    OP_AARCH64_SET_INT64(isa, neon, OMPI_OP_BASE_FORTRAN_MIN, min);
+    OP_AARCH64_SET_FP(isa, neon, OMPI_OP_BASE_FORTRAN_MIN, min);
+
+    OP_AARCH64_SET_INT(isa, neon, OMPI_OP_BASE_FORTRAN_BAND, band);
+    OP_AARCH64_SET_INT64(isa, neon, OMPI_OP_BASE_FORTRAN_BAND, band);
+    OP_AARCH64_SET_INT(isa, neon, OMPI_OP_BASE_FORTRAN_BOR, bor);
+    OP_AARCH64_SET_INT64(isa, neon, OMPI_OP_BASE_FORTRAN_BOR, bor);
+    OP_AARCH64_SET_INT(isa, neon, OMPI_OP_BASE_FORTRAN_BXOR, bxor);
+    OP_AARCH64_SET_INT64(isa, neon, OMPI_OP_BASE_FORTRAN_BXOR, bxor);
+
+#if OMPI_OP_AARCH64_HAVE_SVE
+    isa = OMPI_OP_AARCH64_ISA_SVE;
+    OP_AARCH64_SET_INT(isa, sve, OMPI_OP_BASE_FORTRAN_SUM, sum);
+    OP_AARCH64_SET_INT64(isa, sve, OMPI_OP_BASE_FORTRAN_SUM, sum);
+    OP_AARCH64_SET_FP(isa, sve, OMPI_OP_BASE_FORTRAN_SUM, sum);
+
+    OP_AARCH64_SET_INT(isa, sve, OMPI_OP_BASE_FORTRAN_PROD, prod);
+    OP_AARCH64_SET_INT64(isa, sve, OMPI_OP_BASE_FORTRAN_PROD, prod);
+    OP_AARCH64_SET_FP(isa, sve, OMPI_OP_BASE_FORTRAN_PROD, prod);
+
+    OP_AARCH64_SET_INT(isa, sve, OMPI_OP_BASE_FORTRAN_MAX, max);
+    OP_AARCH64_SET_INT64(isa, sve, OMPI_OP_BASE_FORTRAN_MAX, max);
+    OP_AARCH64_SET_FP(isa, sve, OMPI_OP_BASE_FORTRAN_MAX, max);
+
+    OP_AARCH64_SET_INT(isa, sve, OMPI_OP_BASE_FORTRAN_MIN, min);
+    OP_AARCH64_SET_INT64(isa, sve, OMPI_OP_BASE_FORTRAN_MIN, min);
+    OP_AARCH64_SET_FP(isa, sve, OMPI_OP_BASE_FORTRAN_MIN, min);
+
+    OP_AARCH64_SET_INT(isa, sve, OMPI_OP_BASE_FORTRAN_BAND, band);
+    OP_AARCH64_SET_INT64(isa, sve, OMPI_OP_BASE_FORTRAN_BAND, band);
+    OP_AARCH64_SET_INT(isa, sve, OMPI_OP_BASE_FORTRAN_BOR, bor);
+    OP_AARCH64_SET_INT64(isa, sve, OMPI_OP_BASE_FORTRAN_BOR, bor);
+    OP_AARCH64_SET_INT(isa, sve, OMPI_OP_BASE_FORTRAN_BXOR, bxor);
+    OP_AARCH64_SET_INT64(isa, sve, OMPI_OP_BASE_FORTRAN_BXOR, bxor);
+#endif
+
+    /* Fortran types and MPI_BYTE share the kernels of the C type of
+       the same size.  The module only installs a kernel where the
+       base table has a function, so aliasing a slot that the base
+       does not support for a given MPI_Op is harmless. */
+#if OMPI_HAVE_FORTRAN_INTEGER
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER1
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER1,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER1));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER2
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER2,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER2));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER4
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER4,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER4));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER8
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER8,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER8));
+#endif
+#if OMPI_HAVE_FORTRAN_REAL
+    alias_type(OMPI_OP_BASE_TYPE_REAL,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_REAL));
+#endif
+#if OMPI_HAVE_FORTRAN_REAL4
+    alias_type(OMPI_OP_BASE_TYPE_REAL4,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_REAL4));
+#endif
+#if OMPI_HAVE_FORTRAN_REAL8
+    alias_type(OMPI_OP_BASE_TYPE_REAL8,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_REAL8));
+#endif
+#if OMPI_HAVE_FORTRAN_DOUBLE_PRECISION
+    alias_type(OMPI_OP_BASE_TYPE_DOUBLE_PRECISION,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_DOUBLE_PRECISION));
+#endif
+    alias_type(OMPI_OP_BASE_TYPE_BYTE, OMPI_OP_BASE_TYPE_UINT8_T);
+}
@@ -21,8 +21,90 @@
 #define OMPI_OP_BASE_FUNCTIONS_H
 
 #include "ompi_config.h"
+
+#include <string.h>
+
 #include "ompi/mca/op/op.h"
 
+/*
+ * 16 bit floating point: MPIX_FLOAT16 is IEEE 754 binary16 and
+ * MPIX_BFLOAT16 the upper half of a binary32.  The reductions are done
+ * in float and rounded back to nearest even.  For one addition or
+ * multiplication the float result is exact enough that this is the
+ * correctly rounded 16 bit result.  NaNs come back quiet.
+ */
+static inline float ompi_op_base_float16_to_float(uint16_t h)
+{
+    uint32_t sign = ((uint32_t) (h & 0x8000)) << 16;
+    uint32_t exp = (h >> 10) & 0x1f, mant = h & 0x3ff, bits;
+    float f;
+
+    if (0x1f == exp) {
+        /* infinity or NaN */
+        bits = sign | 0x7f800000 | (mant << 13);
+    } else if (0 != exp) {
+        bits = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+    } else {
+        /* zero or subnormal: mant * 2^-24 is exact in float */
+        f = (float) mant * 5.9604644775390625e-08f;
+        return sign ? -f : f;
+    }
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static inline uint16_t ompi_op_base_float_to_float16(float f)
+{
+    uint32_t bits, sign;
+    float magic;
+
+    memcpy(&bits, &f, sizeof(bits));
+    sign = (bits >> 16) & 0x8000;
+    bits &= 0x7fffffff;
+
+    if (bits >= 0x7f800000) {
+        /* infinity, or a quiet NaN with the top of the payload */
+        return (uint16_t) (sign | 0x7c00 |
+                           (bits > 0x7f800000 ? 0x200 | ((bits >> 13) & 0x3ff) : 0));
+    }
+    if (bits >= ((127 + 16) << 23)) {
+        return (uint16_t) (sign | 0x7c00);
+    }
+    if (bits < ((127 - 14) << 23)) {
+        /* subnormal result: let the FPU round by adding 0.5 */
+        bits = 0x3f000000;
+        memcpy(&magic, &bits, sizeof(magic));
+        f = (sign ? -f : f) + magic;
+        memcpy(&bits, &f, sizeof(bits));
+        return (uint16_t) (sign | (bits - 0x3f000000));
+    }
+    /* rebias the exponent and round the 13 dropped bits to even;
+       a carry out of the mantissa gives the next exponent or infinity */
+    bits += ((uint32_t) (15 - 127) << 23) + 0xfff + ((bits >> 13) & 1);
+    return (uint16_t) (sign | (bits >> 13));
+}
+
+static inline float ompi_op_base_bfloat16_to_float(uint16_t b)
+{
+    uint32_t bits = ((uint32_t) b) << 16;
+    float f;
+
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static inline uint16_t ompi_op_base_float_to_bfloat16(float f)
+{
+    uint32_t bits;
+
+    memcpy(&bits, &f, sizeof(bits));
+    if ((bits & 0x7fffffff) > 0x7f800000) {
+        return (uint16_t) ((bits >> 16) | 0x40);
+    }
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return (uint16_t) (bits >> 16);
+}
+
 /*
  * Since we have so many of these, and they're all identical except
  * for the name, use macros to prototype them.
@@ -91,7 +173,9 @@
   void ompi_op_base_##name##_double OMPI_OP_PROTO; \
   void ompi_op_base_##name##_fortran_real OMPI_OP_PROTO; \
   void ompi_op_base_##name##_fortran_double_precision OMPI_OP_PROTO; \
-  void ompi_op_base_##name##_long_double OMPI_OP_PROTO;
+  void ompi_op_base_##name##_long_double OMPI_OP_PROTO; \
+  void ompi_op_base_##name##_float16 OMPI_OP_PROTO; \
+  void ompi_op_base_##name##_bfloat16 OMPI_OP_PROTO;
 #if OMPI_HAVE_FORTRAN_REAL2
 #define OMPI_OP_HANDLER_FLOATING_POINT_REAL2(name) \
   void ompi_op_base_##name##_fortran_real2 OMPI_OP_PROTO;
@@ -337,7 +421,9 @@ BEGIN_C_DECLS
   void ompi_op_base_3buff_##name##_double OMPI_OP_PROTO_3BUF; \
   void ompi_op_base_3buff_##name##_fortran_real OMPI_OP_PROTO_3BUF; \
   void ompi_op_base_3buff_##name##_fortran_double_precision OMPI_OP_PROTO_3BUF; \
-  void ompi_op_base_3buff_##name##_long_double OMPI_OP_PROTO_3BUF;
+  void ompi_op_base_3buff_##name##_long_double OMPI_OP_PROTO_3BUF; \
+  void ompi_op_base_3buff_##name##_float16 OMPI_OP_PROTO_3BUF; \
+  void ompi_op_base_3buff_##name##_bfloat16 OMPI_OP_PROTO_3BUF;
 #if OMPI_HAVE_FORTRAN_REAL2
 #define OMPI_OP_3BUFF_HANDLER_FLOATING_POINT_REAL2(name) \
   void ompi_op_base_3buff_##name##_fortran_real2 OMPI_OP_PROTO_3BUF;
@@ -100,6 +100,30 @@
       }                                                                  \
   }
 
+/*
+ * 16 bit floating point types are uint16_t in memory and computed in
+ * float (see functions.h).
+ *
+ * This macro is for (out = op(out, in))
+ */
+#define HALF_FUNC(name, type_name) \
+  void ompi_op_base_##name##_##type_name(void *in, void *out, int *count, \
+                                         struct ompi_datatype_t **dtype,  \
+                                         struct ompi_op_base_module_1_0_0_t *module)\
+  {                                                                      \
+      int i;                                                             \
+      float fa, fb;                                                      \
+      uint16_t *a = (uint16_t *) in;                                     \
+      uint16_t *b = (uint16_t *) out;                                    \
+      for (i = 0; i < *count; ++i) {                                     \
+          fa = ompi_op_base_##type_name##_to_float(*(a));                \
+          fb = ompi_op_base_##type_name##_to_float(*(b));                \
+          *(b) = ompi_op_base_float_to_##type_name(current_func(fb, fa)); \
+          ++b;                                                           \
+          ++a;                                                           \
+      }                                                                  \
+  }
+
 /*
  * Since all the functions in this file are essentially identical, we
  * use a macro to substitute in names and types.  The core operation
@@ -189,6 +213,9 @@ FUNC_FUNC(max, fortran_real8, ompi_fortran_real8_t)
 #if OMPI_HAVE_FORTRAN_REAL16
 FUNC_FUNC(max, fortran_real16, ompi_fortran_real16_t)
 #endif
+/* 16 bit floating point */
+HALF_FUNC(max, float16)
+HALF_FUNC(max, bfloat16)
 
 
 /*************************************************************************
@@ -249,6 +276,9 @@ FUNC_FUNC(min, fortran_real8, ompi_fortran_real8_t)
 #if OMPI_HAVE_FORTRAN_REAL16
 FUNC_FUNC(min, fortran_real16, ompi_fortran_real16_t)
 #endif
+/* 16 bit floating point */
+HALF_FUNC(min, float16)
+HALF_FUNC(min, bfloat16)
 
 /*************************************************************************
  * Sum
@@ -306,6 +336,11 @@ OP_FUNC(sum, fortran_real8, ompi_fortran_real8_t, +=)
 #if OMPI_HAVE_FORTRAN_REAL16
 OP_FUNC(sum, fortran_real16, ompi_fortran_real16_t, +=)
 #endif
+/* 16 bit floating point */
+#undef current_func
+#define current_func(a, b) ((a) + (b))
+HALF_FUNC(sum, float16)
+HALF_FUNC(sum, bfloat16)
 /* Complex */
 #if OMPI_HAVE_FORTRAN_REAL && OMPI_HAVE_FORTRAN_COMPLEX
 COMPLEX_OP_FUNC_SUM(fortran_complex, ompi_fortran_complex_t)
@@ -379,6 +414,11 @@ OP_FUNC(prod, fortran_real8, ompi_fortran_real8_t, *=)
 #if OMPI_HAVE_FORTRAN_REAL16
 OP_FUNC(prod, fortran_real16, ompi_fortran_real16_t, *=)
 #endif
+/* 16 bit floating point */
+#undef current_func
+#define current_func(a, b) ((a) * (b))
+HALF_FUNC(prod, float16)
+HALF_FUNC(prod, bfloat16)
 /* Complex */
 #if OMPI_HAVE_FORTRAN_REAL && OMPI_HAVE_FORTRAN_COMPLEX
 COMPLEX_OP_FUNC_PROD(fortran_complex, ompi_fortran_complex_t)
@@ -717,6 +757,32 @@ LOC_FUNC(minloc, long_double_int, <)
       }                                                                  \
   }
 
+/*
+ * 16 bit floating point types, computed in float.
+ *
+ * This macro is for (out = op(in1, in2))
+ */
+#define HALF_FUNC_3BUF(name, type_name) \
+  void ompi_op_base_3buff_##name##_##type_name(void * restrict in1,      \
+          void * restrict in2, void * restrict out, int *count,          \
+          struct ompi_datatype_t **dtype,                                \
+          struct ompi_op_base_module_1_0_0_t *module)                          \
+  {                                                                      \
+      int i;                                                             \
+      float f1, f2;                                                      \
+      uint16_t *a1 = (uint16_t *) in1;                                   \
+      uint16_t *a2 = (uint16_t *) in2;                                   \
+      uint16_t *b = (uint16_t *) out;                                    \
+      for (i = 0; i < *count; ++i) {                                     \
+          f1 = ompi_op_base_##type_name##_to_float(*(a1));               \
+          f2 = ompi_op_base_##type_name##_to_float(*(a2));               \
+          *(b) = ompi_op_base_float_to_##type_name(current_func(f1, f2)); \
+          ++b;                                                           \
+          ++a1;                                                          \
+          ++a2;                                                          \
+      }                                                                  \
+  }
+
 /*
  * Since all the functions in this file are essentially identical, we
  * use a macro to substitute in names and types.  The core operation
@@ -814,6 +880,9 @@ FUNC_FUNC_3BUF(max, fortran_real8, ompi_fortran_real8_t)
 #if OMPI_HAVE_FORTRAN_REAL16
 FUNC_FUNC_3BUF(max, fortran_real16, ompi_fortran_real16_t)
 #endif
+/* 16 bit floating point */
+HALF_FUNC_3BUF(max, float16)
+HALF_FUNC_3BUF(max, bfloat16)
 
 
 /*************************************************************************
@@ -874,6 +943,9 @@ FUNC_FUNC_3BUF(min, fortran_real8, ompi_fortran_real8_t)
 #if OMPI_HAVE_FORTRAN_REAL16
 FUNC_FUNC_3BUF(min, fortran_real16, ompi_fortran_real16_t)
 #endif
+/* 16 bit floating point */
+HALF_FUNC_3BUF(min, float16)
+HALF_FUNC_3BUF(min, bfloat16)
 
 /*************************************************************************
  * Sum
@@ -931,6 +1003,11 @@ OP_FUNC_3BUF(sum, fortran_real8, ompi_fortran_real8_t, +)
 #if OMPI_HAVE_FORTRAN_REAL16
 OP_FUNC_3BUF(sum, fortran_real16, ompi_fortran_real16_t, +)
 #endif
+/* 16 bit floating point */
+#undef current_func
+#define current_func(a, b) ((a) + (b))
+HALF_FUNC_3BUF(sum, float16)
+HALF_FUNC_3BUF(sum, bfloat16)
 /* Complex */
 #if OMPI_HAVE_FORTRAN_REAL && OMPI_HAVE_FORTRAN_COMPLEX
 COMPLEX_OP_FUNC_SUM_3BUF(fortran_complex, ompi_fortran_complex_t)
@@ -1004,6 +1081,11 @@ OP_FUNC_3BUF(prod, fortran_real8, ompi_fortran_real8_t, *)
 #if OMPI_HAVE_FORTRAN_REAL16
 OP_FUNC_3BUF(prod, fortran_real16, ompi_fortran_real16_t, *)
 #endif
+/* 16 bit floating point */
+#undef current_func
+#define current_func(a, b) ((a) * (b))
+HALF_FUNC_3BUF(prod, float16)
+HALF_FUNC_3BUF(prod, bfloat16)
 /* Complex */
 #if OMPI_HAVE_FORTRAN_REAL && OMPI_HAVE_FORTRAN_COMPLEX
 COMPLEX_OP_FUNC_PROD_3BUF(fortran_complex, ompi_fortran_complex_t)
@@ -1471,14 +1553,18 @@ LOC_FUNC_3BUF(minloc, long_double_int, <)
   ompi_op_base_##name##_double,                   /* OMPI_OP_BASE_TYPE_DOUBLE */\
   FLOATING_POINT_FORTRAN_REAL(name),                 /* OMPI_OP_BASE_TYPE_REAL */ \
   FLOATING_POINT_FORTRAN_DOUBLE_PRECISION(name),     /* OMPI_OP_BASE_TYPE_DOUBLE_PRECISION */ \
-  ompi_op_base_##name##_long_double               /* OMPI_OP_BASE_TYPE_LONG_DOUBLE */
+  ompi_op_base_##name##_long_double,              /* OMPI_OP_BASE_TYPE_LONG_DOUBLE */ \
+  ompi_op_base_##name##_float16,                  /* OMPI_OP_BASE_TYPE_FLOAT16 */ \
+  ompi_op_base_##name##_bfloat16                  /* OMPI_OP_BASE_TYPE_BFLOAT16 */
 
 #define FLOATING_POINT_3BUFF(name) \
   ompi_op_base_3buff_##name##_float,                    /* OMPI_OP_BASE_TYPE_FLOAT */\
   ompi_op_base_3buff_##name##_double,                   /* OMPI_OP_BASE_TYPE_DOUBLE */\
   FLOATING_POINT_FORTRAN_REAL_3BUFF(name),                 /* OMPI_OP_BASE_TYPE_REAL */ \
   FLOATING_POINT_FORTRAN_DOUBLE_PRECISION_3BUFF(name),     /* OMPI_OP_BASE_TYPE_DOUBLE_PRECISION */ \
-  ompi_op_base_3buff_##name##_long_double               /* OMPI_OP_BASE_TYPE_LONG_DOUBLE */
+  ompi_op_base_3buff_##name##_long_double,              /* OMPI_OP_BASE_TYPE_LONG_DOUBLE */ \
+  ompi_op_base_3buff_##name##_float16,                  /* OMPI_OP_BASE_TYPE_FLOAT16 */ \
+  ompi_op_base_3buff_##name##_bfloat16                  /* OMPI_OP_BASE_TYPE_BFLOAT16 */
 
 #define FLOATING_POINT_NULL \
   NULL, /* OMPI_OP_BASE_TYPE_FLOAT */ \
@@ -1489,7 +1575,9 @@ LOC_FUNC_3BUF(minloc, long_double_int, <)
   NULL, /* OMPI_OP_BASE_TYPE_REAL8 */ \
   NULL, /* OMPI_OP_BASE_TYPE_REAL16 */ \
   NULL, /* OMPI_OP_BASE_TYPE_DOUBLE_PRECISION */ \
-  NULL  /* OMPI_OP_BASE_TYPE_LONG_DOUBLE */
+  NULL, /* OMPI_OP_BASE_TYPE_LONG_DOUBLE */ \
+  NULL, /* OMPI_OP_BASE_TYPE_FLOAT16 */ \
+  NULL  /* OMPI_OP_BASE_TYPE_BFLOAT16 */
 
 #define FLOATING_POINT_NULL_3BUFF \
   NULL, /* OMPI_OP_BASE_TYPE_FLOAT */ \
@@ -1500,7 +1588,9 @@ LOC_FUNC_3BUF(minloc, long_double_int, <)
   NULL, /* OMPI_OP_BASE_TYPE_REAL8 */ \
   NULL, /* OMPI_OP_BASE_TYPE_REAL16 */ \
   NULL, /* OMPI_OP_BASE_TYPE_DOUBLE_PRECISION */ \
-  NULL  /* OMPI_OP_BASE_TYPE_LONG_DOUBLE */
+  NULL, /* OMPI_OP_BASE_TYPE_LONG_DOUBLE */ \
+  NULL, /* OMPI_OP_BASE_TYPE_FLOAT16 */ \
+  NULL  /* OMPI_OP_BASE_TYPE_BFLOAT16 */
 
 /** Fortran logical *****************************************************/
 
@@ -146,6 +146,10 @@ enum {
     OMPI_OP_BASE_TYPE_DOUBLE_PRECISION,
     /** Floating point: long double */
     OMPI_OP_BASE_TYPE_LONG_DOUBLE,
+    /** Floating point: IEEE 754 half precision (MPIX_FLOAT16) */
+    OMPI_OP_BASE_TYPE_FLOAT16,
+    /** Floating point: bfloat16 (MPIX_BFLOAT16) */
+    OMPI_OP_BASE_TYPE_BFLOAT16,
 
     /** Logical */
     OMPI_OP_BASE_TYPE_LOGICAL,
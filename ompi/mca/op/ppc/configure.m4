@@ -0,0 +1,70 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+#                         University Research and Technology
+#                         Corporation.  All rights reserved.
+# Copyright (c) 2004-2005 The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# Copyright (c) 2004-2005 High Performance Computing Center Stuttgart, 
+#                         University of Stuttgart.  All rights reserved.
+# Copyright (c) 2004-2005 The Regents of the University of California.
+#                         All rights reserved.
+# Copyright (c) 2008-2010 Cisco Systems, Inc.  All rights reserved.
+# $COPYRIGHT$
+# 
+# Additional copyrights may follow
+# 
+# $HEADER$
+#
+
+# MCA_op_ppc_CONFIG([action-if-found], [action-if-not-found])
+# -----------------------------------------------------------
+# The component is built on 64 bit POWER when the compiler generates
+# AltiVec code with the default CFLAGS (always the case on ppc64le,
+# whose base architecture is POWER8) and accepts the VSX function
+# target.  POWER8 (ISA 2.07) kernels for 64 bit integers and 32 bit
+# multiply are added when the compiler supports that target as well;
+# which ones are actually used is decided at run time from the HWCAP
+# bits of the auxiliary vector.
+AC_DEFUN([MCA_ompi_op_ppc_CONFIG],[
+    AC_CONFIG_FILES([ompi/mca/op/ppc/Makefile])
+
+    op_ppc_happy=0
+    op_ppc_have_power8=0
+
+    case "$host" in
+        powerpc64-*|powerpc64le-*)
+            AC_CHECK_HEADERS([sys/auxv.h altivec.h], [op_ppc_happy=1],
+                             [op_ppc_happy=0; break])
+            ;;
+    esac
+
+    AS_IF([test $op_ppc_happy -eq 1],
+          [_OMPI_OP_PPC_CHECK_TARGET([vsx], [__vector double],
+               [vec_add(a, b)], [], [op_ppc_happy=0])])
+    AS_IF([test $op_ppc_happy -eq 1],
+          [_OMPI_OP_PPC_CHECK_TARGET([cpu=power8], [__vector signed long long],
+               [vec_max(a, b)], [op_ppc_have_power8=1], [])])
+
+    AC_DEFINE_UNQUOTED([OMPI_OP_PPC_HAVE_POWER8], [$op_ppc_have_power8],
+                       [Whether the compiler can generate POWER8 kernels for the ppc op component])
+
+    AS_IF([test $op_ppc_happy -eq 1], [$1], [$2])
+])dnl
+
+# _OMPI_OP_PPC_CHECK_TARGET(target, vector type, expression,
+#                           [action-if-supported], [action-if-not])
+# --------------------------------------------------------------------
+AC_DEFUN([_OMPI_OP_PPC_CHECK_TARGET],[
+    AC_MSG_CHECKING([if $CC supports the $1 function target])
+    AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[#include <altivec.h>
+__attribute__((__target__("$1"))) $2 op_ppc_test($2 a, $2 b)
+{
+    return $3;
+}]], [[]])],
+        [AC_MSG_RESULT([yes])
+         $4],
+        [AC_MSG_RESULT([no])
+         $5])
+])dnl
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2004-2007 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2007 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart, 
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2008-2013 Cisco Systems, Inc.  All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * This is the "ppc" component source code.  It contains the
+ * well-known struct that OMPI will dlsym() (or equivalent) for to
+ * find how to access the rest of the component and any modules that
+ * are created.
+ */
+
+#include "ompi_config.h"
+
+#if defined(HAVE_SYS_AUXV_H)
+#include <sys/auxv.h>
+#endif
+
+/* Not every libc exports the HWCAP bits of the kernel */
+#ifndef PPC_FEATURE_HAS_ALTIVEC
+#define PPC_FEATURE_HAS_ALTIVEC 0x10000000
+#endif
+#ifndef PPC_FEATURE_HAS_VSX
+#define PPC_FEATURE_HAS_VSX 0x00000080
+#endif
+#ifndef PPC_FEATURE2_ARCH_2_07
+#define PPC_FEATURE2_ARCH_2_07 0x80000000
+#endif
+
+#include "opal/util/output.h"
+#include "opal/mca/base/mca_base_var.h"
+
+#include "ompi/constants.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/mca/op/base/base.h"
+#include "ompi/mca/op/ppc/op_ppc.h"
+
+static int ppc_component_open(void);
+static int ppc_component_close(void);
+static int ppc_component_init_query(bool enable_progress_threads,
+                                     bool enable_mpi_threads);
+static struct ompi_op_base_module_1_0_0_t *
+    ppc_component_op_query(struct ompi_op_t *op, int *priority);
+static int ppc_component_register(void);
+
+ompi_op_ppc_component_t mca_op_ppc_component = {
+    /* First, the mca_base_component_t struct containing meta
+       information about the component itself */
+    {
+        {
+            OMPI_OP_BASE_VERSION_1_0_0,
+            
+            "ppc",
+            OMPI_MAJOR_VERSION,
+            OMPI_MINOR_VERSION,
+            OMPI_RELEASE_VERSION,
+            ppc_component_open,
+            ppc_component_close,
+            NULL,
+            ppc_component_register
+        },
+        {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        },
+        
+        ppc_component_init_query,
+        ppc_component_op_query,
+    },
+
+    /* Now comes the ppc-component-specific data.  In this case,
+       we'll just leave it blank, defaulting all the values to
+       0/false/whatever.  We'll fill them in with meaningful values
+       during _component_init_query(). */
+};
+
+/*
+ * Component open
+ */
+static int ppc_component_open(void)
+{
+    opal_output(ompi_op_base_framework.framework_output, "ppc component open");
+
+    /* A first level check to see if ppc is even available in this
+       process.  E.g., you may want to do a first-order check to see
+       if hardware is available.  If so, return OMPI_SUCCESS.  If not,
+       return anything other than OMPI_SUCCESS and the component will
+       silently be ignored.
+
+       Note that if this function returns non-OMPI_SUCCESS, then this
+       component won't even be shown in ompi_info output (which is
+       probably not what you want).
+    */
+
+    return OMPI_SUCCESS;
+}
+
+
+/*
+ * Component close
+ */
+static int ppc_component_close(void)
+{
+    opal_output(ompi_op_base_framework.framework_output, "ppc component close");
+
+    /* If ppc was opened successfully, close it (i.e., release any
+       resources that may have been allocated on this component).
+       Note that _component_close() will always be called at the end
+       of the process, so it may have been after any/all of the other
+       component functions have been invoked (and possibly even after
+       modules have been created and/or destroyed). */
+
+    return OMPI_SUCCESS;
+}
+
+
+/*
+ * Probe the hardware and see what we have.  VSX came with POWER7
+ * (ISA 2.06); POWER8 (ISA 2.07) added the 64 bit integer vector
+ * operations and the 32 bit integer multiply.
+ */
+static void hardware_probe(void)
+{
+#if defined(HAVE_SYS_AUXV_H)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    unsigned long hwcap2 = getauxval(AT_HWCAP2);
+    int flags = 0;
+
+    if (0 != (hwcap & PPC_FEATURE_HAS_ALTIVEC)) {
+        flags |= OP_PPC_HW_FLAGS_ALTIVEC;
+    }
+    if (0 != (hwcap & PPC_FEATURE_HAS_VSX)) {
+        flags |= OP_PPC_HW_FLAGS_VSX;
+        if (0 != (hwcap2 & PPC_FEATURE2_ARCH_2_07)) {
+            flags |= OP_PPC_HW_FLAGS_POWER8;
+        }
+    }
+
+    mca_op_ppc_component.oppc_hw_flags = (op_ppc_hw_flags_t) flags;
+#endif
+}
+
+static bool ppc_altivec_available;
+static bool ppc_vsx_available;
+static bool ppc_power8_available;
+
+/*
+ * Register MCA params.
+ */
+static int ppc_component_register(void)
+{
+    opal_output(ompi_op_base_framework.framework_output, "ppc component register");
+
+    /* Probe the hardware and see what we have */
+    hardware_probe();
+
+    ppc_altivec_available = (0 != (mca_op_ppc_component.oppc_hw_flags & OP_PPC_HW_FLAGS_ALTIVEC));
+    (void) mca_base_component_var_register(&mca_op_ppc_component.super.opc_version,
+                                           "altivec_available", "Whether the hardware supports AltiVec (VMX) or not",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ppc_altivec_available);
+
+    ppc_vsx_available = (0 != (mca_op_ppc_component.oppc_hw_flags & OP_PPC_HW_FLAGS_VSX));
+    (void) mca_base_component_var_register(&mca_op_ppc_component.super.opc_version,
+                                           "vsx_available", "Whether the hardware supports VSX (POWER7) or not",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ppc_vsx_available);
+
+    ppc_power8_available = (0 != (mca_op_ppc_component.oppc_hw_flags & OP_PPC_HW_FLAGS_POWER8));
+    (void) mca_base_component_var_register(&mca_op_ppc_component.super.opc_version,
+                                           "power8_available", "Whether the hardware supports the POWER8 (ISA 2.07) vector instructions or not",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ppc_power8_available);
+
+    mca_op_ppc_component.oppc_max_isa = OMPI_OP_PPC_ISA_MAX - 1;
+    (void) mca_base_component_var_register(&mca_op_ppc_component.super.opc_version,
+                                           "max_isa", "Highest instruction set tier to use for reduction kernels "
+                                           "(0 = VSX, 1 = POWER8).  Tiers that the hardware "
+                                           "does not support are never used.",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_op_ppc_component.oppc_max_isa);
+
+    mca_op_ppc_component.oppc_priority = 25;
+    (void) mca_base_component_var_register(&mca_op_ppc_component.super.opc_version,
+                                           "priority", "Priority of the ppc op component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_op_ppc_component.oppc_priority);
+
+    return OMPI_SUCCESS;
+}
+
+
+/*
+ * Query whether this component wants to be used in this process.
+ */
+static int ppc_component_init_query(bool enable_progress_threads,
+                                        bool enable_mpi_threads)
+{
+    opal_output(ompi_op_base_framework.framework_output, "ppc component init query");
+
+    /* Clamp the user's choice to what the hardware can do */
+    if (0 == (mca_op_ppc_component.oppc_hw_flags & OP_PPC_HW_FLAGS_POWER8) &&
+        mca_op_ppc_component.oppc_max_isa >= OMPI_OP_PPC_ISA_POWER8) {
+        mca_op_ppc_component.oppc_max_isa = OMPI_OP_PPC_ISA_VSX;
+    }
+
+    /* The kernels are stateless, so they are safe to use with any
+       thread level.  All we need is (at least) VSX. */
+    if (0 == (mca_op_ppc_component.oppc_hw_flags & OP_PPC_HW_FLAGS_VSX) ||
+        mca_op_ppc_component.oppc_max_isa < OMPI_OP_PPC_ISA_VSX) {
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    ompi_op_ppc_functions_init();
+    return OMPI_SUCCESS;
+}
+
+
+/*
+ * Query whether this component can be used for a specific op
+ */
+static struct ompi_op_base_module_1_0_0_t *
+    ppc_component_op_query(struct ompi_op_t *op, int *priority)
+{
+    ompi_op_base_module_t *module = NULL;
+
+    opal_output(ompi_op_base_framework.framework_output, "ppc component op query");
+
+    /* Sanity check -- although the framework should never invoke the
+       _component_op_query() on non-intrinsic MPI_Op's, we'll put a
+       check here just to be sure. */
+    if (0 == (OMPI_OP_FLAGS_INTRINSIC & op->o_flags)) {
+        opal_output(0, "ppc component op query: not an intrinsic MPI_Op -- skipping");
+        return NULL;
+    }
+
+    /* Note that we *do* have the hardware; _component_init_query()
+       would not have returned OMPI_SUCCESS if we didn't have the
+       hardware (and therefore this function would never have been
+       called).  The setup function will figure out for which
+       datatypes we have kernels. */
+    switch (op->o_f_to_c_index) {
+    case OMPI_OP_BASE_FORTRAN_SUM:
+    case OMPI_OP_BASE_FORTRAN_PROD:
+    case OMPI_OP_BASE_FORTRAN_MAX:
+    case OMPI_OP_BASE_FORTRAN_MIN:
+    case OMPI_OP_BASE_FORTRAN_BAND:
+    case OMPI_OP_BASE_FORTRAN_BOR:
+    case OMPI_OP_BASE_FORTRAN_BXOR:
+        module = ompi_op_ppc_setup(op);
+        break;
+    }
+
+    /* If we got a module from above, we'll return it.  Otherwise,
+       we'll return NULL, indicating that this component does not want
+       to be considered for selection for this MPI_Op.  Note that the
+       "setup" functions each returned a *ppc* component pointer
+       (vs. a *base* component pointer -- where an *ppc* component
+       is a base component plus some other module-specific cached
+       information), so we have to cast it to the right pointer type
+       before returning. */
+    if (NULL != module) {
+        *priority = mca_op_ppc_component.oppc_priority;
+    }
+    return (ompi_op_base_module_1_0_0_t *) module;
+}
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2004-2006 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2010 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2007 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2006-2009 Cisco Systems, Inc.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * Vector reduction kernels for the ppc op component.
+ *
+ * Each kernel is compiled for one instruction set tier (VSX, i.e.
+ * POWER7, and POWER8) with the compiler's function "target"
+ * attribute, and the tier is picked at run time from the HWCAP bits.
+ * The kernels use the unaligned VSX loads and stores for the main
+ * loop and do the remainder with scalar code that has exactly the
+ * same semantics as the base functions in
+ * ompi/mca/op/base/op_base_functions.c.  Floating point MAX and MIN
+ * are done with a compare and a select rather than xvmaxdp / xvmindp,
+ * so that NaNs and signed zeros come out as with (a > b ? a : b).
+ */
+
+#include "ompi_config.h"
+
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#include <stdint.h>
+#include <string.h>
+
+#include "ompi/op/op.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/mca/op/ppc/op_ppc.h"
+
+/* altivec.h makes "vector", "pixel" and "bool" macros.  It comes last
+   so that the OMPI headers still see the stdbool.h bool, and we only
+   use the __vector spelling below. */
+#include <altivec.h>
+#undef vector
+#undef pixel
+#undef bool
+#define bool _Bool
+
+ompi_op_base_handler_fn_t
+    ompi_op_ppc_functions[OMPI_OP_PPC_ISA_MAX][OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+ompi_op_base_3buff_handler_fn_t
+    ompi_op_ppc_3buff_functions[OMPI_OP_PPC_ISA_MAX][OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+
+/*
+ * Per-tier compiler target attributes
+ */
+#define OP_PPC_TARGET_vsx    __attribute__((__target__("vsx")))
+#define OP_PPC_TARGET_power8 __attribute__((__target__("cpu=power8")))
+
+/*
+ * Scalar versions of the operations, used for the tail of each
+ * buffer.  Argument order is (out, in) for the 2-buffer variants and
+ * (in1, in2) for the 3-buffer variants, just like the base functions.
+ */
+#define OP_PPC_S_sum(a, b)  ((a) + (b))
+#define OP_PPC_S_prod(a, b) ((a) * (b))
+#define OP_PPC_S_max(a, b)  ((a) > (b) ? (a) : (b))
+#define OP_PPC_S_min(a, b)  ((a) < (b) ? (a) : (b))
+#define OP_PPC_S_band(a, b) ((a) & (b))
+#define OP_PPC_S_bor(a, b)  ((a) | (b))
+#define OP_PPC_S_bxor(a, b) ((a) ^ (b))
+
+/*
+ * Vector versions.  vec_sel(x, y, m) takes y where m is set.
+ */
+#define OP_PPC_V_sum(a, b)  vec_add(a, b)
+#define OP_PPC_V_prod(a, b) vec_mul(a, b)
+#define OP_PPC_V_max(a, b)  vec_sel(b, a, vec_cmpgt(a, b))
+#define OP_PPC_V_min(a, b)  vec_sel(b, a, vec_cmplt(a, b))
+#define OP_PPC_V_imax(a, b) vec_max(a, b)
+#define OP_PPC_V_imin(a, b) vec_min(a, b)
+#define OP_PPC_V_band(a, b) vec_and(a, b)
+#define OP_PPC_V_bor(a, b)  vec_or(a, b)
+#define OP_PPC_V_bxor(a, b) vec_xor(a, b)
+
+/*
+ * Since all the functions in this file are essentially identical, we
+ * use a macro to substitute in names and types.  This generates both
+ * the (out op= in) and the (out = in1 op in2) variants.  "etype" is
+ * the element type of the altivec.h vector type, which is not always
+ * spelled like the C fixed-width type (e.g., signed long long vs.
+ * int64_t), and "vop" the vector operation (OP_PPC_V_*).
+ */
+#define OP_PPC_FUNC(isa, name, type_name, type, etype, vop)             \
+  static void OP_PPC_TARGET_##isa                                       \
+  ompi_op_ppc_##isa##_##name##_##type_name(void *in, void *out, int *count, \
+                                           struct ompi_datatype_t **dtype, \
+                                           struct ompi_op_base_module_1_0_0_t *module) \
+  {                                                                     \
+      const int width = (int) (sizeof(__vector etype) / sizeof(type));  \
+      int i = 0, n = *count;                                            \
+      type *a = (type *) in;                                            \
+      type *b = (type *) out;                                           \
+      for (; i + width <= n; i += width) {                              \
+          __vector etype va = vec_xl(0, (etype *) (a + i));             \
+          __vector etype vb = vec_xl(0, (etype *) (b + i));             \
+          vec_xst(OP_PPC_V_##vop(vb, va), 0, (etype *) (b + i));        \
+      }                                                                 \
+      for (; i < n; ++i) {                                              \
+          b[i] = OP_PPC_S_##name(b[i], a[i]);                           \
+      }                                                                 \
+  }                                                                     \
+  static void OP_PPC_TARGET_##isa                                       \
+  ompi_op_ppc_3buff_##isa##_##name##_##type_name(void * restrict in1,   \
+          void * restrict in2, void * restrict out, int *count,         \
+          struct ompi_datatype_t **dtype,                               \
+          struct ompi_op_base_module_1_0_0_t *module)                   \
+  {                                                                     \
+      const int width = (int) (sizeof(__vector etype) / sizeof(type));  \
+      int i = 0, n = *count;                                            \
+      type *a1 = (type *) in1;                                          \
+      type *a2 = (type *) in2;                                          \
+      type *b = (type *) out;                                           \
+      for (; i + width <= n; i += width) {                              \
+          __vector etype v1 = vec_xl(0, (etype *) (a1 + i));            \
+          __vector etype v2 = vec_xl(0, (etype *) (a2 + i));            \
+          vec_xst(OP_PPC_V_##vop(v1, v2), 0, (etype *) (b + i));        \
+      }                                                                 \
+      for (; i < n; ++i) {                                              \
+          b[i] = OP_PPC_S_##name(a1[i], a2[i]);                         \
+      }                                                                 \
+  }
+
+/* Integer operations that AltiVec has for 8, 16 and 32 bit elements;
+   POWER8 adds the 64 bit ones */
+#define OP_PPC_INT_FUNCS(isa, name, vop)                                  \
+  OP_PPC_FUNC(isa, name,   int8_t,   int8_t,   signed char, vop)          \
+  OP_PPC_FUNC(isa, name,  uint8_t,  uint8_t, unsigned char, vop)          \
+  OP_PPC_FUNC(isa, name,  int16_t,  int16_t,   signed short, vop)         \
+  OP_PPC_FUNC(isa, name, uint16_t, uint16_t, unsigned short, vop)         \
+  OP_PPC_FUNC(isa, name,  int32_t,  int32_t,   signed int, vop)           \
+  OP_PPC_FUNC(isa, name, uint32_t, uint32_t, unsigned int, vop)
+
+#define OP_PPC_INT64_FUNCS(isa, name, vop)                                \
+  OP_PPC_FUNC(isa, name,  int64_t,  int64_t,   signed long long, vop)     \
+  OP_PPC_FUNC(isa, name, uint64_t, uint64_t, unsigned long long, vop)
+
+#define OP_PPC_FP_FUNCS(isa, name, vop)                                   \
+  OP_PPC_FUNC(isa, name,    float,    float,  float, vop)                 \
+  OP_PPC_FUNC(isa, name,   double,   double, double, vop)
+
+/*
+ * Record a kernel (both variants) in the tables
+ */
+#define OP_PPC_SET(isa_index, isa, op_index, name, type_index, type_name) \
+  do {                                                                  \
+      ompi_op_ppc_functions[isa_index][op_index][type_index] =          \
+          ompi_op_ppc_##isa##_##name##_##type_name;                     \
+      ompi_op_ppc_3buff_functions[isa_index][op_index][type_index] =    \
+          ompi_op_ppc_3buff_##isa##_##name##_##type_name;               \
+  } while (0)
+
+#define OP_PPC_SET_INT(isa_index, isa, op_index, name)                  \
+  do {                                                                  \
+      OP_PPC_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT8_T, int8_t); \
+      OP_PPC_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT8_T, uint8_t); \
+      OP_PPC_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT16_T, int16_t); \
+      OP_PPC_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT16_T, uint16_t); \
+      OP_PPC_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT32_T, int32_t); \
+      OP_PPC_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t); \
+  } while (0)
+
+#define OP_PPC_SET_INT64(isa_index, isa, op_index, name)                \
+  do {                                                                  \
+      OP_PPC_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT64_T, int64_t); \
+      OP_PPC_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT64_T, uint64_t); \
+  } while (0)
+
+#define OP_PPC_SET_FP(isa_index, isa, op_index, name)                   \
+  do {                                                                  \
+      OP_PPC_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_FLOAT, float); \
+      OP_PPC_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_DOUBLE, double); \
+  } while (0)
+
+/*************************************************************************
+ * VSX (POWER7)
+ *************************************************************************/
+
+OP_PPC_INT_FUNCS(vsx, sum, sum)
+OP_PPC_FP_FUNCS(vsx, sum, sum)
+OP_PPC_FP_FUNCS(vsx, prod, prod)
+OP_PPC_INT_FUNCS(vsx, max, imax)
+OP_PPC_FP_FUNCS(vsx, max, max)
+OP_PPC_INT_FUNCS(vsx, min, imin)
+OP_PPC_FP_FUNCS(vsx, min, min)
+
+OP_PPC_INT_FUNCS(vsx, band, band)
+OP_PPC_INT64_FUNCS(vsx, band, band)
+OP_PPC_INT_FUNCS(vsx, bor, bor)
+OP_PPC_INT64_FUNCS(vsx, bor, bor)
+OP_PPC_INT_FUNCS(vsx, bxor, bxor)
+OP_PPC_INT64_FUNCS(vsx, bxor, bxor)
+
+/*************************************************************************
+ * POWER8 (ISA 2.07): 64 bit integer add / max / min and 32 bit
+ * integer multiply.  The other kernels would be the same
+ * instructions as the VSX ones, so they stay on that tier.
+ *************************************************************************/
+
+#if OMPI_OP_PPC_HAVE_POWER8
+OP_PPC_INT64_FUNCS(power8, sum, sum)
+OP_PPC_FUNC(power8, prod,  int32_t,  int32_t,   signed int, prod)
+OP_PPC_FUNC(power8, prod, uint32_t, uint32_t, unsigned int, prod)
+OP_PPC_INT64_FUNCS(power8, max, imax)
+OP_PPC_INT64_FUNCS(power8, min, imin)
+#endif /* OMPI_OP_PPC_HAVE_POWER8 */
+
+/*************************************************************************
+ * Table setup
+ *************************************************************************/
+
+/*
+ * Return the C fixed-width type index of a signed integer / floating
+ * point type of a given size, or -1 if we have no such type.
+ */
+static int __opal_attribute_unused__ integer_type_of_size(size_t size)
+{
+    switch (size) {
+    case 1: return OMPI_OP_BASE_TYPE_INT8_T;
+    case 2: return OMPI_OP_BASE_TYPE_INT16_T;
+    case 4: return OMPI_OP_BASE_TYPE_INT32_T;
+    case 8: return OMPI_OP_BASE_TYPE_INT64_T;
+    }
+    return -1;
+}
+
+static int __opal_attribute_unused__ real_type_of_size(size_t size)
+{
+    if (sizeof(float) == size) {
+        return OMPI_OP_BASE_TYPE_FLOAT;
+    } else if (sizeof(double) == size) {
+        return OMPI_OP_BASE_TYPE_DOUBLE;
+    }
+    return -1;
+}
+
+/*
+ * Make the kernels of C type "from" also serve datatype "to"
+ */
+static void alias_type(int to, int from)
+{
+    int isa, op;
+
+    if (from < 0) {
+        return;
+    }
+    for (isa = 0; isa < OMPI_OP_PPC_ISA_MAX; ++isa) {
+        for (op = 0; op < OMPI_OP_BASE_FORTRAN_OP_MAX; ++op) {
+            ompi_op_ppc_functions[isa][op][to] =
+                ompi_op_ppc_functions[isa][op][from];
+            ompi_op_ppc_3buff_functions[isa][op][to] =
+                ompi_op_ppc_3buff_functions[isa][op][from];
+        }
+    }
+}
+
+void ompi_op_ppc_functions_init(void)
+{
+    int isa;
+
+    memset(ompi_op_ppc_functions, 0, sizeof(ompi_op_ppc_functions));
+    memset(ompi_op_ppc_3buff_functions, 0,
+           sizeof(ompi_op_ppc_3buff_functions));
+
+    /* VSX */
+    isa = OMPI_OP_PPC_ISA_VSX;
+    OP_PPC_SET_INT(isa, vsx, OMPI_OP_BASE_FORTRAN_SUM, sum);
+    OP_PPC_SET_FP(isa, vsx, OMPI_OP_BASE_FORTRAN_SUM, sum);
+
+    OP_PPC_SET_FP(isa, vsx, OMPI_OP_BASE_FORTRAN_PROD, prod);
+
+    OP_PPC_SET_INT(isa, vsx, OMPI_OP_BASE_FORTRAN_MAX, max);
+    OP_PPC_SET_FP(isa, vsx, OMPI_OP_BASE_FORTRAN_MAX, max);
+
+    OP_PPC_SET_INT(isa, vsx, OMPI_OP_BASE_FORTRAN_MIN, min);
+    OP_PPC_SET_FP(isa, vsx, OMPI_OP_BASE_FORTRAN_MIN, min);
+
+    OP_PPC_SET_INT(isa, vsx, OMPI_OP_BASE_FORTRAN_BAND, band);
+    OP_PPC_SET_INT64(isa, vsx, OMPI_OP_BASE_FORTRAN_BAND, band);
+    OP_PPC_SET_INT(isa, vsx, OMPI_OP_BASE_FORTRAN_BOR, bor);
+    OP_PPC_SET_INT64(isa, vsx, OMPI_OP_BASE_FORTRAN_BOR, bor);
+    OP_PPC_SET_INT(isa, vsx, OMPI_OP_BASE_FORTRAN_BXOR, bxor);
+    OP_PPC_SET_INT64(isa, vsx, OMPI_OP_BASE_FORTRAN_BXOR, bxor);
+
+#if OMPI_OP_PPC_HAVE_POWER8
+    isa = OMPI_OP_PPC_ISA_POWER8;
+    OP_PPC_SET_INT64(isa, power8, OMPI_OP_BASE_FORTRAN_SUM, sum);
+    OP_PPC_SET(isa, power8, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_INT32_T, int32_t);
+    OP_PPC_SET(isa, power8, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t);
+    OP_PPC_SET_INT64(isa, power8, OMPI_OP_BASE_FORTRAN_MAX, max);
+    OP_PPC_SET_INT64(isa, power8, OMPI_OP_BASE_FORTRAN_MIN, min);
+#endif
+
+    /* Fortran types and MPI_BYTE share the kernels of the C type of
+       the same size.  The module only installs a kernel where the
+       base table has a function, so aliasing a slot that the base
+       does not support for a given MPI_Op is harmless. */
+#if OMPI_HAVE_FORTRAN_INTEGER
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER1
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER1,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER1));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER2
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER2,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER2));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER4
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER4,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER4));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER8
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER8,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER8));
+#endif
+#if OMPI_HAVE_FORTRAN_REAL
+    alias_type(OMPI_OP_BASE_TYPE_REAL,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_REAL));
+#endif
+#if OMPI_HAVE_FORTRAN_REAL4
+    alias_type(OMPI_OP_BASE_TYPE_REAL4,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_REAL4));
+#endif
+#if OMPI_HAVE_FORTRAN_REAL8
+    alias_type(OMPI_OP_BASE_TYPE_REAL8,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_REAL8));
+#endif
+#if OMPI_HAVE_FORTRAN_DOUBLE_PRECISION
+    alias_type(OMPI_OP_BASE_TYPE_DOUBLE_PRECISION,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_DOUBLE_PRECISION));
+#endif
+    alias_type(OMPI_OP_BASE_TYPE_BYTE, OMPI_OP_BASE_TYPE_UINT8_T);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2004-2007 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2010 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2008-2009 Cisco Systems, Inc.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * This is the module source code.  It contains the "setup" function
+ * that will create a module for any of the MPI_Ops that we have
+ * vector kernels for (SUM, PROD, MAX, MIN, BAND, BOR, BXOR).
+ */
+
+#include "ompi_config.h"
+
+#include "opal/class/opal_object.h"
+#include "opal/util/output.h"
+
+#include "ompi/constants.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/mca/op/base/base.h"
+#include "ompi/mca/op/ppc/op_ppc.h"
+
+/**
+ * Setup the class for the ppc module, listing:
+ * - the name of the class
+ * - the "parent" of the class
+ * - function pointer for the constructor (or NULL)
+ * - function pointer for the destructor (or NULL)
+ *
+ * The kernels do not need any fallback functions (the remainder of
+ * each buffer is done in scalar code inside the kernel), so there is
+ * nothing to construct or destruct.
+ */
+OBJ_CLASS_INSTANCE(ompi_op_ppc_module_t,
+                   ompi_op_base_module_t,
+                   NULL, NULL);
+
+/**
+ * Setup function for the supported MPI_Ops.  If we get here, we can
+ * assume that a) the hardware is present and b) the MPI_Op is one
+ * that we have kernels for.  So this function's job is to create a
+ * module and fill in function pointers for the best instruction set
+ * tier that both the hardware and the user allow, for each datatype.
+ *
+ * We only install a kernel for a datatype where the base already has
+ * a function; the op framework requires that the pattern of NULL /
+ * non-NULL function pointers stays the same as in the base table.
+ */
+ompi_op_base_module_t *ompi_op_ppc_setup(ompi_op_t *op)
+{
+    int i, isa, found = 0;
+    int op_index = op->o_f_to_c_index;
+    ompi_op_ppc_module_t *module = OBJ_NEW(ompi_op_ppc_module_t);
+
+    for (i = 0; i < OMPI_OP_BASE_TYPE_MAX; ++i) {
+        if (NULL == op->o_func.intrinsic.fns[i]) {
+            continue;
+        }
+        for (isa = mca_op_ppc_component.oppc_max_isa; isa >= 0; --isa) {
+            if (NULL != ompi_op_ppc_functions[isa][op_index][i]) {
+                module->super.opm_fns[i] =
+                    ompi_op_ppc_functions[isa][op_index][i];
+                if (NULL != op->o_3buff_intrinsic.fns[i]) {
+                    module->super.opm_3buff_fns[i] =
+                        ompi_op_ppc_3buff_functions[isa][op_index][i];
+                }
+                ++found;
+                break;
+            }
+        }
+    }
+
+    opal_output_verbose(10, ompi_op_base_framework.framework_output,
+                        "op:ppc: %s: using vector kernels for %d datatypes (highest ISA tier %d)",
+                        op->o_name, found, mca_op_ppc_component.oppc_max_isa);
+
+    if (0 == found) {
+        OBJ_RELEASE(module);
+        return NULL;
+    }
+
+    return (ompi_op_base_module_t*) module;
+}
@@ -20,15 +20,61 @@
 
 # MCA_op_x86_CONFIG([action-if-found], [action-if-not-found])
 # -----------------------------------------------------------
+# The component is built on IA32 / x86_64 when the compiler can
+# generate SSE2 code through the function "target" attribute.  AVX2
+# and AVX-512F kernels are added when the compiler supports those
+# targets as well; which ones are actually used is decided at run
+# time from CPUID.  The AVX2 MPIX_FLOAT16 kernels also need F16C.
 AC_DEFUN([MCA_ompi_op_x86_CONFIG],[
     AC_CONFIG_FILES([ompi/mca/op/x86/Makefile])
 
-    # check for sockaddr_in (a good sign we have TCP)
-    AC_CHECK_TYPES([struct sockaddr_in], 
-                   [$1],
-                   [$2], 
-                   [AC_INCLUDES_DEFAULT
-#ifdef HAVE_NETINET_IN_H
-#include <netinet/in.h>
-#endif])
+    op_x86_happy=0
+    op_x86_have_avx2=0
+    op_x86_have_avx512f=0
+    op_x86_have_f16c=0
+
+    case "$host" in
+        i?86-*|x86_64-*|amd64-*)
+            AC_CHECK_HEADERS([cpuid.h immintrin.h], [op_x86_happy=1],
+                             [op_x86_happy=0; break])
+            ;;
+    esac
+
+    AS_IF([test $op_x86_happy -eq 1],
+          [_OMPI_OP_X86_CHECK_TARGET([sse2], [__m128i],
+               [_mm_add_epi32(a, b)], [], [op_x86_happy=0])])
+    AS_IF([test $op_x86_happy -eq 1],
+          [_OMPI_OP_X86_CHECK_TARGET([avx2], [__m256i],
+               [_mm256_max_epu16(a, b)], [op_x86_have_avx2=1], [])
+           _OMPI_OP_X86_CHECK_TARGET([avx512f], [__m512i],
+               [_mm512_min_epu64(a, b)], [op_x86_have_avx512f=1], [])])
+    AS_IF([test $op_x86_have_avx2 -eq 1],
+          [_OMPI_OP_X86_CHECK_TARGET([avx2,f16c], [__m256],
+               [_mm256_add_ps(_mm256_cvtph_ps(_mm256_cvtps_ph(a, 0)), b)],
+               [op_x86_have_f16c=1], [])])
+
+    AC_DEFINE_UNQUOTED([OMPI_OP_X86_HAVE_AVX2], [$op_x86_have_avx2],
+                       [Whether the compiler can generate AVX2 kernels for the x86 op component])
+    AC_DEFINE_UNQUOTED([OMPI_OP_X86_HAVE_AVX512F], [$op_x86_have_avx512f],
+                       [Whether the compiler can generate AVX-512F kernels for the x86 op component])
+    AC_DEFINE_UNQUOTED([OMPI_OP_X86_HAVE_F16C], [$op_x86_have_f16c],
+                       [Whether the compiler can generate AVX2 + F16C kernels for the x86 op component])
+
+    AS_IF([test $op_x86_happy -eq 1], [$1], [$2])
+])dnl
+
+# _OMPI_OP_X86_CHECK_TARGET(target, vector type, expression,
+#                           [action-if-supported], [action-if-not])
+# --------------------------------------------------------------------
+AC_DEFUN([_OMPI_OP_X86_CHECK_TARGET],[
+    AC_MSG_CHECKING([if $CC supports the $1 function target])
+    AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[#include <immintrin.h>
+__attribute__((__target__("$1"))) $2 op_x86_test($2 a, $2 b)
+{
+    return $3;
+}]], [[]])],
+        [AC_MSG_RESULT([yes])
+         $4],
+        [AC_MSG_RESULT([no])
+         $5])
 ])dnl
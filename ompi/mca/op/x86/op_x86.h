@@ -37,9 +37,25 @@ typedef enum {
     OP_X86_HW_FLAGS_MMX2 = 2,
     OP_X86_HW_FLAGS_SSE = 4,
     OP_X86_HW_FLAGS_SSE2 = 8,
-    OP_X86_HW_FLAGS_SSE3 = 16
+    OP_X86_HW_FLAGS_SSE3 = 16,
+    OP_X86_HW_FLAGS_AVX = 32,
+    OP_X86_HW_FLAGS_AVX2 = 64,
+    OP_X86_HW_FLAGS_AVX512F = 128,
+    OP_X86_HW_FLAGS_F16C = 256
 } op_x86_hw_flags_t;
 
+/**
+ * Instruction set tiers that we have kernels for, in increasing
+ * order of preference.
+ */
+enum {
+    OMPI_OP_X86_ISA_SSE2 = 0,
+    OMPI_OP_X86_ISA_AVX2,
+    OMPI_OP_X86_ISA_AVX512F,
+
+    OMPI_OP_X86_ISA_MAX
+};
+
 /**
  * Derive a struct from the base op component struct, allowing us to
  * cache some component-specific information on our well-known
@@ -51,19 +67,24 @@ typedef struct {
 
     /* What hardware do we have? */
     op_x86_hw_flags_t oxc_hw_flags;
+
+    /* Highest ISA tier that the user allows us to use (MCA param) */
+    int oxc_max_isa;
+
+    /* Priority of this component relative to the base functions */
+    int oxc_priority;
 } ompi_op_x86_component_t;
 
 /**
- * Derive a struct from the base op module struct, allowing us to
- * cache some module-specific information for SUM. 
+ * Derive a struct from the base op module struct.  The kernels are
+ * stateless, so there is nothing to cache here; the same module type
+ * is used for every MPI_Op that we support.
  */
 typedef struct {
     ompi_op_base_module_1_0_0_t super;
+} ompi_op_x86_module_t;
 
-    /* JMS need anything here? */
-} ompi_op_x86_module_sum_t;
-
-OBJ_CLASS_DECLARATION(ompi_op_x86_module_sum_t);
+OBJ_CLASS_DECLARATION(ompi_op_x86_module_t);
 
 /**
  * Well-known component instance
@@ -71,9 +92,26 @@ OBJ_CLASS_DECLARATION(ompi_op_x86_module_sum_t);
 OMPI_DECLSPEC extern ompi_op_x86_component_t mca_op_x86_component;
 
 /**
- * Setup for MPI_MAX and return a module.
+ * Kernel tables, indexed by [ISA tier][MPI_Op][datatype].  A NULL
+ * entry means that there is no vector kernel for that combination at
+ * that tier (e.g., 64 bit integer multiply).
+ */
+OMPI_DECLSPEC extern ompi_op_base_handler_fn_t
+    ompi_op_x86_functions[OMPI_OP_X86_ISA_MAX][OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+OMPI_DECLSPEC extern ompi_op_base_3buff_handler_fn_t
+    ompi_op_x86_3buff_functions[OMPI_OP_X86_ISA_MAX][OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+
+/**
+ * Fill in the kernel tables entries for the Fortran and MPI_BYTE
+ * datatypes from the C fixed-width entries of the same size.
+ */
+OMPI_DECLSPEC void ompi_op_x86_functions_init(void);
+
+/**
+ * Setup for any supported intrinsic MPI_Op and return a module (or
+ * NULL if we have no kernels for this MPI_Op on this hardware).
  */
-OMPI_DECLSPEC ompi_op_base_module_t *ompi_op_x86_setup_sum(ompi_op_t *op);
+OMPI_DECLSPEC ompi_op_base_module_t *ompi_op_x86_setup(ompi_op_t *op);
 
 END_C_DECLS
 
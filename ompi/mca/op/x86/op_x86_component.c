@@ -27,6 +27,10 @@
 
 #include "ompi_config.h"
 
+#if defined(HAVE_CPUID_H)
+#include <cpuid.h>
+#endif
+
 #include "opal/util/output.h"
 #include "opal/mca/base/mca_base_var.h"
 
@@ -115,12 +119,76 @@ static int x86_component_close(void)
 }
 
 
+#if defined(HAVE_CPUID_H)
+/*
+ * Read the extended control register (XCR0) so that we know whether
+ * the OS saves the AVX / AVX-512 register state on context switches.
+ */
+static uint64_t x86_xgetbv(void)
+{
+    uint32_t eax, edx;
+
+    __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return ((uint64_t) edx << 32) | eax;
+}
+#endif
+
 /*
  * Probe the hardware and see what we have
  */
 static void hardware_probe(void)
 {
-    /* ... JMS fill in here ... */
+#if defined(HAVE_CPUID_H)
+    unsigned int max_leaf, eax, ebx, ecx, edx;
+    uint64_t xcr0 = 0;
+    int flags = 0;
+
+    max_leaf = __get_cpuid_max(0, NULL);
+    if (max_leaf < 1) {
+        return;
+    }
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    if (0 != (edx & (1 << 23))) {
+        flags |= OP_X86_HW_FLAGS_MMX;
+    }
+    if (0 != (edx & (1 << 25))) {
+        /* The MMX extensions came with SSE */
+        flags |= OP_X86_HW_FLAGS_SSE | OP_X86_HW_FLAGS_MMX2;
+    }
+    if (0 != (edx & (1 << 26))) {
+        flags |= OP_X86_HW_FLAGS_SSE2;
+    }
+    if (0 != (ecx & 1)) {
+        flags |= OP_X86_HW_FLAGS_SSE3;
+    }
+
+    /* AVX needs both the CPU bit and the OS to have enabled the XMM
+       and YMM state (OSXSAVE + XCR0 bits 1 and 2) */
+    if (0 != (ecx & (1 << 27))) {
+        xcr0 = x86_xgetbv();
+    }
+    if (0 != (ecx & (1 << 28)) && 0x6 == (xcr0 & 0x6)) {
+        flags |= OP_X86_HW_FLAGS_AVX;
+        if (0 != (ecx & (1 << 29))) {
+            flags |= OP_X86_HW_FLAGS_F16C;
+        }
+
+        if (max_leaf >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            if (0 != (ebx & (1 << 5))) {
+                flags |= OP_X86_HW_FLAGS_AVX2;
+            }
+            /* AVX-512 additionally needs the opmask and ZMM state
+               (XCR0 bits 5, 6 and 7) */
+            if (0 != (ebx & (1 << 16)) && 0xe6 == (xcr0 & 0xe6)) {
+                flags |= OP_X86_HW_FLAGS_AVX512F;
+            }
+        }
+    }
+
+    mca_op_x86_component.oxc_hw_flags = (op_x86_hw_flags_t) flags;
+#endif
 }
 
 static bool x86_mmx_available;
@@ -128,6 +196,9 @@ static bool x86_mmx2_available;
 static bool x86_sse_available;
 static bool x86_sse2_available;
 static bool x86_sse3_available;
+static bool x86_avx_available;
+static bool x86_avx2_available;
+static bool x86_avx512f_available;
 
 /*
  * Register MCA params.
@@ -182,7 +253,52 @@ static int x86_component_register(void)
                                            MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
                                            OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_READONLY,
-                                           &x86_sse3_available);    
+                                           &x86_sse3_available);
+
+    x86_avx_available = (0 != (mca_op_x86_component.oxc_hw_flags & OP_X86_HW_FLAGS_AVX));
+    (void) mca_base_component_var_register(&mca_op_x86_component.super.opc_version,
+                                           "avx_available", "Whether the hardware (and OS) supports AVX or not",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &x86_avx_available);
+
+    x86_avx2_available = (0 != (mca_op_x86_component.oxc_hw_flags & OP_X86_HW_FLAGS_AVX2));
+    (void) mca_base_component_var_register(&mca_op_x86_component.super.opc_version,
+                                           "avx2_available", "Whether the hardware (and OS) supports AVX2 or not",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &x86_avx2_available);
+
+    x86_avx512f_available = (0 != (mca_op_x86_component.oxc_hw_flags & OP_X86_HW_FLAGS_AVX512F));
+    (void) mca_base_component_var_register(&mca_op_x86_component.super.opc_version,
+                                           "avx512f_available", "Whether the hardware (and OS) supports AVX-512F or not",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &x86_avx512f_available);
+
+    mca_op_x86_component.oxc_max_isa = OMPI_OP_X86_ISA_MAX - 1;
+    (void) mca_base_component_var_register(&mca_op_x86_component.super.opc_version,
+                                           "max_isa", "Highest instruction set tier to use for reduction kernels "
+                                           "(0 = SSE2, 1 = AVX2, 2 = AVX-512F).  Tiers that the hardware "
+                                           "does not support are never used.",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_op_x86_component.oxc_max_isa);
+
+    mca_op_x86_component.oxc_priority = 25;
+    (void) mca_base_component_var_register(&mca_op_x86_component.super.opc_version,
+                                           "priority", "Priority of the x86 op component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_op_x86_component.oxc_priority);
 
     return OMPI_SUCCESS;
 }
@@ -196,11 +312,25 @@ static int x86_component_init_query(bool enable_progress_threads,
 {
     opal_output(ompi_op_base_framework.framework_output, "x86 component init query");
 
-    /* If we have any hardware and we're not threaded, success */
-    if (0 != mca_op_x86_component.oxc_hw_flags && !enable_mpi_threads) {
-        return OMPI_SUCCESS;
+    /* Clamp the user's choice to what the hardware can do */
+    if (0 == (mca_op_x86_component.oxc_hw_flags & OP_X86_HW_FLAGS_AVX512F) &&
+        mca_op_x86_component.oxc_max_isa >= OMPI_OP_X86_ISA_AVX512F) {
+        mca_op_x86_component.oxc_max_isa = OMPI_OP_X86_ISA_AVX2;
+    }
+    if (0 == (mca_op_x86_component.oxc_hw_flags & OP_X86_HW_FLAGS_AVX2) &&
+        mca_op_x86_component.oxc_max_isa >= OMPI_OP_X86_ISA_AVX2) {
+        mca_op_x86_component.oxc_max_isa = OMPI_OP_X86_ISA_SSE2;
+    }
+
+    /* The kernels are stateless, so they are safe to use with any
+       thread level.  All we need is (at least) SSE2. */
+    if (0 == (mca_op_x86_component.oxc_hw_flags & OP_X86_HW_FLAGS_SSE2) ||
+        mca_op_x86_component.oxc_max_isa < OMPI_OP_X86_ISA_SSE2) {
+        return OMPI_ERR_NOT_SUPPORTED;
     }
-    return OMPI_ERR_NOT_SUPPORTED;
+
+    ompi_op_x86_functions_init();
+    return OMPI_SUCCESS;
 }
 
 
@@ -222,31 +352,20 @@ static struct ompi_op_base_module_1_0_0_t *
         return NULL;
     }
 
-    /* What follows is an x86 of how to determine whether your
-       component supports the queried MPI_Op.  You can do this lots of
-       different ways; this is but one x86. */
-
     /* Note that we *do* have the hardware; _component_init_query()
        would not have returned OMPI_SUCCESS if we didn't have the
        hardware (and therefore this function would never have been
-       called).  So we don't need to check for the hardware again.
-       Instead, we need to do finer-grained checks (e.g., do we
-       support this op, and if so, what datatypes are supported?).
-
-       So check to see whether this MPI_Op operation is supported on
-       the hardware that this component supports (which may involve
-       querying the hardware to see what it is capable of).
-
-       You can see what operation is being requested by checking the
-       "op->o_f_to_c_index" value against the OMPI_OP_BASE_FORTRAN_*
-       enums.  See ompi/mca/op/op.h for a full list of the
-       OMPI_OP_BASE_FORTRAN_* enums.
-
-       In this x86 component, we support MAX and BXOR. */
+       called).  The setup function will figure out for which
+       datatypes we have kernels. */
     switch (op->o_f_to_c_index) {
     case OMPI_OP_BASE_FORTRAN_SUM:
-        /* Corresponds to MPI_SUM */
-        module = ompi_op_x86_setup_sum(op);
+    case OMPI_OP_BASE_FORTRAN_PROD:
+    case OMPI_OP_BASE_FORTRAN_MAX:
+    case OMPI_OP_BASE_FORTRAN_MIN:
+    case OMPI_OP_BASE_FORTRAN_BAND:
+    case OMPI_OP_BASE_FORTRAN_BOR:
+    case OMPI_OP_BASE_FORTRAN_BXOR:
+        module = ompi_op_x86_setup(op);
         break;
     }
 
@@ -259,7 +378,7 @@ static struct ompi_op_base_module_1_0_0_t *
        information), so we have to cast it to the right pointer type
        before returning. */
     if (NULL != module) {
-        *priority = 25;
+        *priority = mca_op_x86_component.oxc_priority;
     }
     return (ompi_op_base_module_1_0_0_t *) module;
 }
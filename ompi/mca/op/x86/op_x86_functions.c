@@ -0,0 +1,703 @@
+/*
+ * Copyright (c) 2004-2006 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2010 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2007 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2006-2009 Cisco Systems, Inc.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * Vector reduction kernels for the x86 op component.
+ *
+ * Each kernel is compiled for one instruction set tier (SSE2, AVX2,
+ * AVX-512F) with the compiler's function "target" attribute, so that
+ * the whole component can be built with the default CFLAGS and the
+ * right tier is picked at run time from the CPUID results.  Each
+ * kernel has an aligned and an unaligned main loop; the remainder is
+ * done with scalar code that has exactly the same semantics as the
+ * base functions in ompi/mca/op/base/op_base_functions.c (including
+ * NaN handling for MAX and MIN, which matches the operand order of
+ * the max/min instructions used below).
+ *
+ * MPIX_FLOAT16 and MPIX_BFLOAT16 are widened to float in registers,
+ * reduced with the float instructions and rounded back to nearest
+ * even, so that they give bit for bit the results of the base
+ * functions.
+ */
+
+#include "ompi_config.h"
+
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include "ompi/op/op.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/mca/op/base/functions.h"
+#include "ompi/mca/op/x86/op_x86.h"
+
+ompi_op_base_handler_fn_t
+    ompi_op_x86_functions[OMPI_OP_X86_ISA_MAX][OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+ompi_op_base_3buff_handler_fn_t
+    ompi_op_x86_3buff_functions[OMPI_OP_X86_ISA_MAX][OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+
+/*
+ * Per-tier compiler target attributes
+ */
+#define OP_X86_TARGET_sse2    __attribute__((__target__("sse2")))
+#define OP_X86_TARGET_avx2    __attribute__((__target__("avx2")))
+#define OP_X86_TARGET_avx512f __attribute__((__target__("avx512f")))
+#define OP_X86_TARGET_avx2_f16c __attribute__((__target__("avx2,f16c")))
+
+/*
+ * Vector "families": the vector type and the aligned / unaligned
+ * load and store for each (tier, element class) pair.
+ */
+#define OP_X86_VF_sse2_i_T            __m128i
+#define OP_X86_VF_sse2_i_LD(p)        _mm_load_si128((const __m128i *) (p))
+#define OP_X86_VF_sse2_i_LDU(p)       _mm_loadu_si128((const __m128i *) (p))
+#define OP_X86_VF_sse2_i_ST(p, v)     _mm_store_si128((__m128i *) (p), (v))
+#define OP_X86_VF_sse2_i_STU(p, v)    _mm_storeu_si128((__m128i *) (p), (v))
+#define OP_X86_VF_sse2_ps_T           __m128
+#define OP_X86_VF_sse2_ps_LD(p)       _mm_load_ps(p)
+#define OP_X86_VF_sse2_ps_LDU(p)      _mm_loadu_ps(p)
+#define OP_X86_VF_sse2_ps_ST(p, v)    _mm_store_ps((p), (v))
+#define OP_X86_VF_sse2_ps_STU(p, v)   _mm_storeu_ps((p), (v))
+#define OP_X86_VF_sse2_pd_T           __m128d
+#define OP_X86_VF_sse2_pd_LD(p)       _mm_load_pd(p)
+#define OP_X86_VF_sse2_pd_LDU(p)      _mm_loadu_pd(p)
+#define OP_X86_VF_sse2_pd_ST(p, v)    _mm_store_pd((p), (v))
+#define OP_X86_VF_sse2_pd_STU(p, v)   _mm_storeu_pd((p), (v))
+
+#define OP_X86_VF_avx2_i_T            __m256i
+#define OP_X86_VF_avx2_i_LD(p)        _mm256_load_si256((const __m256i *) (p))
+#define OP_X86_VF_avx2_i_LDU(p)       _mm256_loadu_si256((const __m256i *) (p))
+#define OP_X86_VF_avx2_i_ST(p, v)     _mm256_store_si256((__m256i *) (p), (v))
+#define OP_X86_VF_avx2_i_STU(p, v)    _mm256_storeu_si256((__m256i *) (p), (v))
+#define OP_X86_VF_avx2_ps_T           __m256
+#define OP_X86_VF_avx2_ps_LD(p)       _mm256_load_ps(p)
+#define OP_X86_VF_avx2_ps_LDU(p)      _mm256_loadu_ps(p)
+#define OP_X86_VF_avx2_ps_ST(p, v)    _mm256_store_ps((p), (v))
+#define OP_X86_VF_avx2_ps_STU(p, v)   _mm256_storeu_ps((p), (v))
+#define OP_X86_VF_avx2_pd_T           __m256d
+#define OP_X86_VF_avx2_pd_LD(p)       _mm256_load_pd(p)
+#define OP_X86_VF_avx2_pd_LDU(p)      _mm256_loadu_pd(p)
+#define OP_X86_VF_avx2_pd_ST(p, v)    _mm256_store_pd((p), (v))
+#define OP_X86_VF_avx2_pd_STU(p, v)   _mm256_storeu_pd((p), (v))
+
+#define OP_X86_VF_avx512f_i_T         __m512i
+#define OP_X86_VF_avx512f_i_LD(p)     _mm512_load_si512((const void *) (p))
+#define OP_X86_VF_avx512f_i_LDU(p)    _mm512_loadu_si512((const void *) (p))
+#define OP_X86_VF_avx512f_i_ST(p, v)  _mm512_store_si512((void *) (p), (v))
+#define OP_X86_VF_avx512f_i_STU(p, v) _mm512_storeu_si512((void *) (p), (v))
+#define OP_X86_VF_avx512f_ps_T        __m512
+#define OP_X86_VF_avx512f_ps_LD(p)    _mm512_load_ps(p)
+#define OP_X86_VF_avx512f_ps_LDU(p)   _mm512_loadu_ps(p)
+#define OP_X86_VF_avx512f_ps_ST(p, v) _mm512_store_ps((p), (v))
+#define OP_X86_VF_avx512f_ps_STU(p, v) _mm512_storeu_ps((p), (v))
+#define OP_X86_VF_avx512f_pd_T        __m512d
+#define OP_X86_VF_avx512f_pd_LD(p)    _mm512_load_pd(p)
+#define OP_X86_VF_avx512f_pd_LDU(p)   _mm512_loadu_pd(p)
+#define OP_X86_VF_avx512f_pd_ST(p, v) _mm512_store_pd((p), (v))
+#define OP_X86_VF_avx512f_pd_STU(p, v) _mm512_storeu_pd((p), (v))
+
+/*
+ * Scalar versions of the operations, used for the tail of each
+ * buffer.  Argument order is (out, in) for the 2-buffer variants and
+ * (in1, in2) for the 3-buffer variants, just like the base functions.
+ */
+#define OP_X86_S_sum(a, b)  ((a) + (b))
+#define OP_X86_S_prod(a, b) ((a) * (b))
+#define OP_X86_S_max(a, b)  ((a) > (b) ? (a) : (b))
+#define OP_X86_S_min(a, b)  ((a) < (b) ? (a) : (b))
+#define OP_X86_S_band(a, b) ((a) & (b))
+#define OP_X86_S_bor(a, b)  ((a) | (b))
+#define OP_X86_S_bxor(a, b) ((a) ^ (b))
+
+/*
+ * Since all the functions in this file are essentially identical, we
+ * use a macro to substitute in names and types.  This generates both
+ * the (out op= in) and the (out = in1 op in2) variants.
+ */
+#define OP_X86_FUNC(isa, fam, name, type_name, type, vop)               \
+  static void OP_X86_TARGET_##isa                                       \
+  ompi_op_x86_##isa##_##name##_##type_name(void *in, void *out, int *count, \
+                                           struct ompi_datatype_t **dtype, \
+                                           struct ompi_op_base_module_1_0_0_t *module) \
+  {                                                                     \
+      const int width = (int) (sizeof(OP_X86_VF_##fam##_T) / sizeof(type)); \
+      int i = 0, n = *count;                                            \
+      type *a = (type *) in;                                            \
+      type *b = (type *) out;                                           \
+      if (0 == (((uintptr_t) a | (uintptr_t) b) &                       \
+                (sizeof(OP_X86_VF_##fam##_T) - 1))) {                   \
+          for (; i + width <= n; i += width) {                          \
+              OP_X86_VF_##fam##_T va = OP_X86_VF_##fam##_LD(a + i);     \
+              OP_X86_VF_##fam##_T vb = OP_X86_VF_##fam##_LD(b + i);     \
+              OP_X86_VF_##fam##_ST(b + i, vop(vb, va));                 \
+          }                                                             \
+      } else {                                                          \
+          for (; i + width <= n; i += width) {                          \
+              OP_X86_VF_##fam##_T va = OP_X86_VF_##fam##_LDU(a + i);    \
+              OP_X86_VF_##fam##_T vb = OP_X86_VF_##fam##_LDU(b + i);    \
+              OP_X86_VF_##fam##_STU(b + i, vop(vb, va));                \
+          }                                                             \
+      }                                                                 \
+      for (; i < n; ++i) {                                              \
+          b[i] = OP_X86_S_##name(b[i], a[i]);                           \
+      }                                                                 \
+  }                                                                     \
+  static void OP_X86_TARGET_##isa                                       \
+  ompi_op_x86_3buff_##isa##_##name##_##type_name(void * restrict in1,   \
+          void * restrict in2, void * restrict out, int *count,         \
+          struct ompi_datatype_t **dtype,                               \
+          struct ompi_op_base_module_1_0_0_t *module)                   \
+  {                                                                     \
+      const int width = (int) (sizeof(OP_X86_VF_##fam##_T) / sizeof(type)); \
+      int i = 0, n = *count;                                            \
+      type *a1 = (type *) in1;                                          \
+      type *a2 = (type *) in2;                                          \
+      type *b = (type *) out;                                           \
+      if (0 == (((uintptr_t) a1 | (uintptr_t) a2 | (uintptr_t) b) &     \
+                (sizeof(OP_X86_VF_##fam##_T) - 1))) {                   \
+          for (; i + width <= n; i += width) {                          \
+              OP_X86_VF_##fam##_T v1 = OP_X86_VF_##fam##_LD(a1 + i);    \
+              OP_X86_VF_##fam##_T v2 = OP_X86_VF_##fam##_LD(a2 + i);    \
+              OP_X86_VF_##fam##_ST(b + i, vop(v1, v2));                 \
+          }                                                             \
+      } else {                                                          \
+          for (; i + width <= n; i += width) {                          \
+              OP_X86_VF_##fam##_T v1 = OP_X86_VF_##fam##_LDU(a1 + i);   \
+              OP_X86_VF_##fam##_T v2 = OP_X86_VF_##fam##_LDU(a2 + i);   \
+              OP_X86_VF_##fam##_STU(b + i, vop(v1, v2));                \
+          }                                                             \
+      }                                                                 \
+      for (; i < n; ++i) {                                              \
+          b[i] = OP_X86_S_##name(a1[i], a2[i]);                         \
+      }                                                                 \
+  }
+
+/*
+ * 16 bit floating point: the loads widen a vector's worth of uint16_t
+ * to float and the stores round back, both unaligned since the
+ * 16 bit side is half the vector width anyway.  The bfloat16 rounding
+ * is done with integer arithmetic (round to nearest even on the 16
+ * dropped bits, NaNs made quiet) exactly like
+ * ompi_op_base_float_to_bfloat16().
+ */
+#define OP_X86_HALF_FUNC(isa, target, name, type_name, vop)             \
+  static void OP_X86_TARGET_##target                                    \
+  ompi_op_x86_##isa##_##name##_##type_name(void *in, void *out, int *count, \
+                                           struct ompi_datatype_t **dtype, \
+                                           struct ompi_op_base_module_1_0_0_t *module) \
+  {                                                                     \
+      const int width = (int) (sizeof(OP_X86_VF_##isa##_ps_T) / sizeof(float)); \
+      int i = 0, n = *count;                                            \
+      uint16_t *a = (uint16_t *) in;                                    \
+      uint16_t *b = (uint16_t *) out;                                   \
+      for (; i + width <= n; i += width) {                              \
+          OP_X86_VF_##isa##_ps_T va = op_x86_##isa##_##type_name##_ld(a + i); \
+          OP_X86_VF_##isa##_ps_T vb = op_x86_##isa##_##type_name##_ld(b + i); \
+          op_x86_##isa##_##type_name##_st(b + i, vop(vb, va));         \
+      }                                                                 \
+      for (; i < n; ++i) {                                              \
+          float fa = ompi_op_base_##type_name##_to_float(a[i]);         \
+          float fb = ompi_op_base_##type_name##_to_float(b[i]);         \
+          b[i] = ompi_op_base_float_to_##type_name(OP_X86_S_##name(fb, fa)); \
+      }                                                                 \
+  }                                                                     \
+  static void OP_X86_TARGET_##target                                    \
+  ompi_op_x86_3buff_##isa##_##name##_##type_name(void * restrict in1,   \
+          void * restrict in2, void * restrict out, int *count,         \
+          struct ompi_datatype_t **dtype,                               \
+          struct ompi_op_base_module_1_0_0_t *module)                   \
+  {                                                                     \
+      const int width = (int) (sizeof(OP_X86_VF_##isa##_ps_T) / sizeof(float)); \
+      int i = 0, n = *count;                                            \
+      uint16_t *a1 = (uint16_t *) in1;                                  \
+      uint16_t *a2 = (uint16_t *) in2;                                  \
+      uint16_t *b = (uint16_t *) out;                                   \
+      for (; i + width <= n; i += width) {                              \
+          OP_X86_VF_##isa##_ps_T v1 = op_x86_##isa##_##type_name##_ld(a1 + i); \
+          OP_X86_VF_##isa##_ps_T v2 = op_x86_##isa##_##type_name##_ld(a2 + i); \
+          op_x86_##isa##_##type_name##_st(b + i, vop(v1, v2));         \
+      }                                                                 \
+      for (; i < n; ++i) {                                              \
+          float f1 = ompi_op_base_##type_name##_to_float(a1[i]);        \
+          float f2 = ompi_op_base_##type_name##_to_float(a2[i]);        \
+          b[i] = ompi_op_base_float_to_##type_name(OP_X86_S_##name(f1, f2)); \
+      }                                                                 \
+  }
+
+#define OP_X86_HALF_FUNCS(isa, target, type_name, pfx)                  \
+  OP_X86_HALF_FUNC(isa, target, sum,  type_name, pfx##_add_ps)          \
+  OP_X86_HALF_FUNC(isa, target, prod, type_name, pfx##_mul_ps)          \
+  OP_X86_HALF_FUNC(isa, target, max,  type_name, pfx##_max_ps)          \
+  OP_X86_HALF_FUNC(isa, target, min,  type_name, pfx##_min_ps)
+
+/* Bitwise operations are the same for all integer types of a tier */
+#define OP_X86_BITWISE_FUNCS(isa, name, vop)                    \
+  OP_X86_FUNC(isa, isa##_i, name,   int8_t,   int8_t, vop)      \
+  OP_X86_FUNC(isa, isa##_i, name,  uint8_t,  uint8_t, vop)      \
+  OP_X86_FUNC(isa, isa##_i, name,  int16_t,  int16_t, vop)      \
+  OP_X86_FUNC(isa, isa##_i, name, uint16_t, uint16_t, vop)      \
+  OP_X86_FUNC(isa, isa##_i, name,  int32_t,  int32_t, vop)      \
+  OP_X86_FUNC(isa, isa##_i, name, uint32_t, uint32_t, vop)      \
+  OP_X86_FUNC(isa, isa##_i, name,  int64_t,  int64_t, vop)      \
+  OP_X86_FUNC(isa, isa##_i, name, uint64_t, uint64_t, vop)
+
+/*
+ * Record a kernel (both variants) in the tables
+ */
+#define OP_X86_SET(isa_index, isa, op_index, name, type_index, type_name) \
+  do {                                                                  \
+      ompi_op_x86_functions[isa_index][op_index][type_index] =          \
+          ompi_op_x86_##isa##_##name##_##type_name;                     \
+      ompi_op_x86_3buff_functions[isa_index][op_index][type_index] =    \
+          ompi_op_x86_3buff_##isa##_##name##_##type_name;               \
+  } while (0)
+
+#define OP_X86_SET_HALF(isa_index, isa, type_index, type_name)          \
+  do {                                                                  \
+      OP_X86_SET(isa_index, isa, OMPI_OP_BASE_FORTRAN_SUM, sum, type_index, type_name); \
+      OP_X86_SET(isa_index, isa, OMPI_OP_BASE_FORTRAN_PROD, prod, type_index, type_name); \
+      OP_X86_SET(isa_index, isa, OMPI_OP_BASE_FORTRAN_MAX, max, type_index, type_name); \
+      OP_X86_SET(isa_index, isa, OMPI_OP_BASE_FORTRAN_MIN, min, type_index, type_name); \
+  } while (0)
+
+#define OP_X86_SET_BITWISE(isa_index, isa, op_index, name)              \
+  do {                                                                  \
+      OP_X86_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT8_T, int8_t); \
+      OP_X86_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT8_T, uint8_t); \
+      OP_X86_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT16_T, int16_t); \
+      OP_X86_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT16_T, uint16_t); \
+      OP_X86_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT32_T, int32_t); \
+      OP_X86_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t); \
+      OP_X86_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_INT64_T, int64_t); \
+      OP_X86_SET(isa_index, isa, op_index, name, OMPI_OP_BASE_TYPE_UINT64_T, uint64_t); \
+  } while (0)
+
+/*************************************************************************
+ * SSE2
+ *************************************************************************/
+
+OP_X86_FUNC(sse2, sse2_i,  sum,   int8_t,   int8_t, _mm_add_epi8)
+OP_X86_FUNC(sse2, sse2_i,  sum,  uint8_t,  uint8_t, _mm_add_epi8)
+OP_X86_FUNC(sse2, sse2_i,  sum,  int16_t,  int16_t, _mm_add_epi16)
+OP_X86_FUNC(sse2, sse2_i,  sum, uint16_t, uint16_t, _mm_add_epi16)
+OP_X86_FUNC(sse2, sse2_i,  sum,  int32_t,  int32_t, _mm_add_epi32)
+OP_X86_FUNC(sse2, sse2_i,  sum, uint32_t, uint32_t, _mm_add_epi32)
+OP_X86_FUNC(sse2, sse2_i,  sum,  int64_t,  int64_t, _mm_add_epi64)
+OP_X86_FUNC(sse2, sse2_i,  sum, uint64_t, uint64_t, _mm_add_epi64)
+OP_X86_FUNC(sse2, sse2_ps, sum,    float,    float, _mm_add_ps)
+OP_X86_FUNC(sse2, sse2_pd, sum,   double,   double, _mm_add_pd)
+
+OP_X86_FUNC(sse2, sse2_i,  prod,  int16_t,  int16_t, _mm_mullo_epi16)
+OP_X86_FUNC(sse2, sse2_i,  prod, uint16_t, uint16_t, _mm_mullo_epi16)
+OP_X86_FUNC(sse2, sse2_ps, prod,    float,    float, _mm_mul_ps)
+OP_X86_FUNC(sse2, sse2_pd, prod,   double,   double, _mm_mul_pd)
+
+OP_X86_FUNC(sse2, sse2_i,  max,  uint8_t,  uint8_t, _mm_max_epu8)
+OP_X86_FUNC(sse2, sse2_i,  max,  int16_t,  int16_t, _mm_max_epi16)
+OP_X86_FUNC(sse2, sse2_ps, max,    float,    float, _mm_max_ps)
+OP_X86_FUNC(sse2, sse2_pd, max,   double,   double, _mm_max_pd)
+
+OP_X86_FUNC(sse2, sse2_i,  min,  uint8_t,  uint8_t, _mm_min_epu8)
+OP_X86_FUNC(sse2, sse2_i,  min,  int16_t,  int16_t, _mm_min_epi16)
+OP_X86_FUNC(sse2, sse2_ps, min,    float,    float, _mm_min_ps)
+OP_X86_FUNC(sse2, sse2_pd, min,   double,   double, _mm_min_pd)
+
+OP_X86_BITWISE_FUNCS(sse2, band, _mm_and_si128)
+OP_X86_BITWISE_FUNCS(sse2, bor,  _mm_or_si128)
+OP_X86_BITWISE_FUNCS(sse2, bxor, _mm_xor_si128)
+
+/*************************************************************************
+ * AVX2
+ *************************************************************************/
+
+#if OMPI_OP_X86_HAVE_AVX2
+OP_X86_FUNC(avx2, avx2_i,  sum,   int8_t,   int8_t, _mm256_add_epi8)
+OP_X86_FUNC(avx2, avx2_i,  sum,  uint8_t,  uint8_t, _mm256_add_epi8)
+OP_X86_FUNC(avx2, avx2_i,  sum,  int16_t,  int16_t, _mm256_add_epi16)
+OP_X86_FUNC(avx2, avx2_i,  sum, uint16_t, uint16_t, _mm256_add_epi16)
+OP_X86_FUNC(avx2, avx2_i,  sum,  int32_t,  int32_t, _mm256_add_epi32)
+OP_X86_FUNC(avx2, avx2_i,  sum, uint32_t, uint32_t, _mm256_add_epi32)
+OP_X86_FUNC(avx2, avx2_i,  sum,  int64_t,  int64_t, _mm256_add_epi64)
+OP_X86_FUNC(avx2, avx2_i,  sum, uint64_t, uint64_t, _mm256_add_epi64)
+OP_X86_FUNC(avx2, avx2_ps, sum,    float,    float, _mm256_add_ps)
+OP_X86_FUNC(avx2, avx2_pd, sum,   double,   double, _mm256_add_pd)
+
+OP_X86_FUNC(avx2, avx2_i,  prod,  int16_t,  int16_t, _mm256_mullo_epi16)
+OP_X86_FUNC(avx2, avx2_i,  prod, uint16_t, uint16_t, _mm256_mullo_epi16)
+OP_X86_FUNC(avx2, avx2_i,  prod,  int32_t,  int32_t, _mm256_mullo_epi32)
+OP_X86_FUNC(avx2, avx2_i,  prod, uint32_t, uint32_t, _mm256_mullo_epi32)
+OP_X86_FUNC(avx2, avx2_ps, prod,    float,    float, _mm256_mul_ps)
+OP_X86_FUNC(avx2, avx2_pd, prod,   double,   double, _mm256_mul_pd)
+
+OP_X86_FUNC(avx2, avx2_i,  max,   int8_t,   int8_t, _mm256_max_epi8)
+OP_X86_FUNC(avx2, avx2_i,  max,  uint8_t,  uint8_t, _mm256_max_epu8)
+OP_X86_FUNC(avx2, avx2_i,  max,  int16_t,  int16_t, _mm256_max_epi16)
+OP_X86_FUNC(avx2, avx2_i,  max, uint16_t, uint16_t, _mm256_max_epu16)
+OP_X86_FUNC(avx2, avx2_i,  max,  int32_t,  int32_t, _mm256_max_epi32)
+OP_X86_FUNC(avx2, avx2_i,  max, uint32_t, uint32_t, _mm256_max_epu32)
+OP_X86_FUNC(avx2, avx2_ps, max,    float,    float, _mm256_max_ps)
+OP_X86_FUNC(avx2, avx2_pd, max,   double,   double, _mm256_max_pd)
+
+OP_X86_FUNC(avx2, avx2_i,  min,   int8_t,   int8_t, _mm256_min_epi8)
+OP_X86_FUNC(avx2, avx2_i,  min,  uint8_t,  uint8_t, _mm256_min_epu8)
+OP_X86_FUNC(avx2, avx2_i,  min,  int16_t,  int16_t, _mm256_min_epi16)
+OP_X86_FUNC(avx2, avx2_i,  min, uint16_t, uint16_t, _mm256_min_epu16)
+OP_X86_FUNC(avx2, avx2_i,  min,  int32_t,  int32_t, _mm256_min_epi32)
+OP_X86_FUNC(avx2, avx2_i,  min, uint32_t, uint32_t, _mm256_min_epu32)
+OP_X86_FUNC(avx2, avx2_ps, min,    float,    float, _mm256_min_ps)
+OP_X86_FUNC(avx2, avx2_pd, min,   double,   double, _mm256_min_pd)
+
+OP_X86_BITWISE_FUNCS(avx2, band, _mm256_and_si256)
+OP_X86_BITWISE_FUNCS(avx2, bor,  _mm256_or_si256)
+OP_X86_BITWISE_FUNCS(avx2, bxor, _mm256_xor_si256)
+
+static inline __m256 OP_X86_TARGET_avx2
+op_x86_avx2_bfloat16_ld(const uint16_t *p)
+{
+    __m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) p));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(v, 16));
+}
+
+static inline void OP_X86_TARGET_avx2
+op_x86_avx2_bfloat16_st(uint16_t *p, __m256 v)
+{
+    __m256i bits = _mm256_castps_si256(v);
+    __m256i odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+    __m256i rounded = _mm256_add_epi32(bits, _mm256_add_epi32(odd, _mm256_set1_epi32(0x7fff)));
+    __m256i quiet = _mm256_or_si256(bits, _mm256_set1_epi32(0x400000));
+    __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+
+    bits = _mm256_srli_epi32(_mm256_blendv_epi8(rounded, quiet, nan), 16);
+    _mm_storeu_si128((__m128i *) p,
+                     _mm_packus_epi32(_mm256_castsi256_si128(bits),
+                                      _mm256_extracti128_si256(bits, 1)));
+}
+
+OP_X86_HALF_FUNCS(avx2, avx2, bfloat16, _mm256)
+
+#if OMPI_OP_X86_HAVE_F16C
+static inline __m256 OP_X86_TARGET_avx2_f16c
+op_x86_avx2_float16_ld(const uint16_t *p)
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *) p));
+}
+
+static inline void OP_X86_TARGET_avx2_f16c
+op_x86_avx2_float16_st(uint16_t *p, __m256 v)
+{
+    _mm_storeu_si128((__m128i *) p, _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+}
+
+OP_X86_HALF_FUNCS(avx2, avx2_f16c, float16, _mm256)
+#endif /* OMPI_OP_X86_HAVE_F16C */
+#endif /* OMPI_OP_X86_HAVE_AVX2 */
+
+/*************************************************************************
+ * AVX-512F (8 and 16 bit integer arithmetic needs AVX-512BW, so those
+ * types stay on the AVX2 kernels)
+ *************************************************************************/
+
+#if OMPI_OP_X86_HAVE_AVX512F
+OP_X86_FUNC(avx512f, avx512f_i,  sum,  int32_t,  int32_t, _mm512_add_epi32)
+OP_X86_FUNC(avx512f, avx512f_i,  sum, uint32_t, uint32_t, _mm512_add_epi32)
+OP_X86_FUNC(avx512f, avx512f_i,  sum,  int64_t,  int64_t, _mm512_add_epi64)
+OP_X86_FUNC(avx512f, avx512f_i,  sum, uint64_t, uint64_t, _mm512_add_epi64)
+OP_X86_FUNC(avx512f, avx512f_ps, sum,    float,    float, _mm512_add_ps)
+OP_X86_FUNC(avx512f, avx512f_pd, sum,   double,   double, _mm512_add_pd)
+
+OP_X86_FUNC(avx512f, avx512f_i,  prod,  int32_t,  int32_t, _mm512_mullo_epi32)
+OP_X86_FUNC(avx512f, avx512f_i,  prod, uint32_t, uint32_t, _mm512_mullo_epi32)
+OP_X86_FUNC(avx512f, avx512f_ps, prod,    float,    float, _mm512_mul_ps)
+OP_X86_FUNC(avx512f, avx512f_pd, prod,   double,   double, _mm512_mul_pd)
+
+OP_X86_FUNC(avx512f, avx512f_i,  max,  int32_t,  int32_t, _mm512_max_epi32)
+OP_X86_FUNC(avx512f, avx512f_i,  max, uint32_t, uint32_t, _mm512_max_epu32)
+OP_X86_FUNC(avx512f, avx512f_i,  max,  int64_t,  int64_t, _mm512_max_epi64)
+OP_X86_FUNC(avx512f, avx512f_i,  max, uint64_t, uint64_t, _mm512_max_epu64)
+OP_X86_FUNC(avx512f, avx512f_ps, max,    float,    float, _mm512_max_ps)
+OP_X86_FUNC(avx512f, avx512f_pd, max,   double,   double, _mm512_max_pd)
+
+OP_X86_FUNC(avx512f, avx512f_i,  min,  int32_t,  int32_t, _mm512_min_epi32)
+OP_X86_FUNC(avx512f, avx512f_i,  min, uint32_t, uint32_t, _mm512_min_epu32)
+OP_X86_FUNC(avx512f, avx512f_i,  min,  int64_t,  int64_t, _mm512_min_epi64)
+OP_X86_FUNC(avx512f, avx512f_i,  min, uint64_t, uint64_t, _mm512_min_epu64)
+OP_X86_FUNC(avx512f, avx512f_ps, min,    float,    float, _mm512_min_ps)
+OP_X86_FUNC(avx512f, avx512f_pd, min,   double,   double, _mm512_min_pd)
+
+OP_X86_BITWISE_FUNCS(avx512f, band, _mm512_and_si512)
+OP_X86_BITWISE_FUNCS(avx512f, bor,  _mm512_or_si512)
+OP_X86_BITWISE_FUNCS(avx512f, bxor, _mm512_xor_si512)
+
+static inline __m512 OP_X86_TARGET_avx512f
+op_x86_avx512f_float16_ld(const uint16_t *p)
+{
+    return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i *) p));
+}
+
+static inline void OP_X86_TARGET_avx512f
+op_x86_avx512f_float16_st(uint16_t *p, __m512 v)
+{
+    _mm256_storeu_si256((__m256i *) p, _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+}
+
+static inline __m512 OP_X86_TARGET_avx512f
+op_x86_avx512f_bfloat16_ld(const uint16_t *p)
+{
+    __m512i v = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *) p));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(v, 16));
+}
+
+static inline void OP_X86_TARGET_avx512f
+op_x86_avx512f_bfloat16_st(uint16_t *p, __m512 v)
+{
+    __m512i bits = _mm512_castps_si512(v);
+    __m512i odd = _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+    __m512i rounded = _mm512_add_epi32(bits, _mm512_add_epi32(odd, _mm512_set1_epi32(0x7fff)));
+    __m512i quiet = _mm512_or_si512(bits, _mm512_set1_epi32(0x400000));
+    __mmask16 nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+
+    bits = _mm512_srli_epi32(_mm512_mask_blend_epi32(nan, rounded, quiet), 16);
+    _mm256_storeu_si256((__m256i *) p, _mm512_cvtepi32_epi16(bits));
+}
+
+OP_X86_HALF_FUNCS(avx512f, avx512f, float16, _mm512)
+OP_X86_HALF_FUNCS(avx512f, avx512f, bfloat16, _mm512)
+#endif /* OMPI_OP_X86_HAVE_AVX512F */
+
+/*************************************************************************
+ * Table setup
+ *************************************************************************/
+
+/*
+ * Return the C fixed-width type index of a signed integer / floating
+ * point type of a given size, or -1 if we have no such type.
+ */
+static int __opal_attribute_unused__ integer_type_of_size(size_t size)
+{
+    switch (size) {
+    case 1: return OMPI_OP_BASE_TYPE_INT8_T;
+    case 2: return OMPI_OP_BASE_TYPE_INT16_T;
+    case 4: return OMPI_OP_BASE_TYPE_INT32_T;
+    case 8: return OMPI_OP_BASE_TYPE_INT64_T;
+    }
+    return -1;
+}
+
+static int __opal_attribute_unused__ real_type_of_size(size_t size)
+{
+    if (sizeof(float) == size) {
+        return OMPI_OP_BASE_TYPE_FLOAT;
+    } else if (sizeof(double) == size) {
+        return OMPI_OP_BASE_TYPE_DOUBLE;
+    }
+    return -1;
+}
+
+/*
+ * Make the kernels of C type "from" also serve datatype "to"
+ */
+static void alias_type(int to, int from)
+{
+    int isa, op;
+
+    if (from < 0) {
+        return;
+    }
+    for (isa = 0; isa < OMPI_OP_X86_ISA_MAX; ++isa) {
+        for (op = 0; op < OMPI_OP_BASE_FORTRAN_OP_MAX; ++op) {
+            ompi_op_x86_functions[isa][op][to] =
+                ompi_op_x86_functions[isa][op][from];
+            ompi_op_x86_3buff_functions[isa][op][to] =
+                ompi_op_x86_3buff_functions[isa][op][from];
+        }
+    }
+}
+
+void ompi_op_x86_functions_init(void)
+{
+    int isa;
+
+    memset(ompi_op_x86_functions, 0, sizeof(ompi_op_x86_functions));
+    memset(ompi_op_x86_3buff_functions, 0,
+           sizeof(ompi_op_x86_3buff_functions));
+
+    /* SSE2 */
+    isa = OMPI_OP_X86_ISA_SSE2;
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_INT8_T, int8_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_UINT8_T, uint8_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_INT16_T, int16_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_UINT16_T, uint16_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_INT32_T, int32_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_INT64_T, int64_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_UINT64_T, uint64_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_INT16_T, int16_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_UINT16_T, uint16_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_UINT8_T, uint8_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_INT16_T, int16_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_UINT8_T, uint8_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_INT16_T, int16_t);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, sse2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET_BITWISE(isa, sse2, OMPI_OP_BASE_FORTRAN_BAND, band);
+    OP_X86_SET_BITWISE(isa, sse2, OMPI_OP_BASE_FORTRAN_BOR, bor);
+    OP_X86_SET_BITWISE(isa, sse2, OMPI_OP_BASE_FORTRAN_BXOR, bxor);
+
+#if OMPI_OP_X86_HAVE_AVX2
+    isa = OMPI_OP_X86_ISA_AVX2;
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_INT8_T, int8_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_UINT8_T, uint8_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_INT16_T, int16_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_UINT16_T, uint16_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_INT32_T, int32_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_INT64_T, int64_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_UINT64_T, uint64_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_INT16_T, int16_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_UINT16_T, uint16_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_INT32_T, int32_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_INT8_T, int8_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_UINT8_T, uint8_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_INT16_T, int16_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_UINT16_T, uint16_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_INT32_T, int32_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_INT8_T, int8_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_UINT8_T, uint8_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_INT16_T, int16_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_UINT16_T, uint16_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_INT32_T, int32_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, avx2, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET_BITWISE(isa, avx2, OMPI_OP_BASE_FORTRAN_BAND, band);
+    OP_X86_SET_BITWISE(isa, avx2, OMPI_OP_BASE_FORTRAN_BOR, bor);
+    OP_X86_SET_BITWISE(isa, avx2, OMPI_OP_BASE_FORTRAN_BXOR, bxor);
+
+    OP_X86_SET_HALF(isa, avx2, OMPI_OP_BASE_TYPE_BFLOAT16, bfloat16);
+#if OMPI_OP_X86_HAVE_F16C
+    if (0 != (mca_op_x86_component.oxc_hw_flags & OP_X86_HW_FLAGS_F16C)) {
+        OP_X86_SET_HALF(isa, avx2, OMPI_OP_BASE_TYPE_FLOAT16, float16);
+    }
+#endif
+#endif
+
+#if OMPI_OP_X86_HAVE_AVX512F
+    isa = OMPI_OP_X86_ISA_AVX512F;
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_INT32_T, int32_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_INT64_T, int64_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_UINT64_T, uint64_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_SUM, sum, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_INT32_T, int32_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_PROD, prod, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_INT32_T, int32_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_INT64_T, int64_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_UINT64_T, uint64_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MAX, max, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_INT32_T, int32_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_UINT32_T, uint32_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_INT64_T, int64_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_UINT64_T, uint64_t);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_FLOAT, float);
+    OP_X86_SET(isa, avx512f, OMPI_OP_BASE_FORTRAN_MIN, min, OMPI_OP_BASE_TYPE_DOUBLE, double);
+
+    OP_X86_SET_BITWISE(isa, avx512f, OMPI_OP_BASE_FORTRAN_BAND, band);
+    OP_X86_SET_BITWISE(isa, avx512f, OMPI_OP_BASE_FORTRAN_BOR, bor);
+    OP_X86_SET_BITWISE(isa, avx512f, OMPI_OP_BASE_FORTRAN_BXOR, bxor);
+
+    OP_X86_SET_HALF(isa, avx512f, OMPI_OP_BASE_TYPE_FLOAT16, float16);
+    OP_X86_SET_HALF(isa, avx512f, OMPI_OP_BASE_TYPE_BFLOAT16, bfloat16);
+#endif
+
+    /* Fortran types and MPI_BYTE share the kernels of the C type of
+       the same size.  The module only installs a kernel where the
+       base table has a function, so aliasing a slot that the base
+       does not support for a given MPI_Op is harmless. */
+#if OMPI_HAVE_FORTRAN_INTEGER
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER1
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER1,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER1));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER2
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER2,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER2));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER4
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER4,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER4));
+#endif
+#if OMPI_HAVE_FORTRAN_INTEGER8
+    alias_type(OMPI_OP_BASE_TYPE_INTEGER8,
+               integer_type_of_size(OMPI_SIZEOF_FORTRAN_INTEGER8));
+#endif
+#if OMPI_HAVE_FORTRAN_REAL
+    alias_type(OMPI_OP_BASE_TYPE_REAL,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_REAL));
+#endif
+#if OMPI_HAVE_FORTRAN_REAL4
+    alias_type(OMPI_OP_BASE_TYPE_REAL4,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_REAL4));
+#endif
+#if OMPI_HAVE_FORTRAN_REAL8
+    alias_type(OMPI_OP_BASE_TYPE_REAL8,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_REAL8));
+#endif
+#if OMPI_HAVE_FORTRAN_DOUBLE_PRECISION
+    alias_type(OMPI_OP_BASE_TYPE_DOUBLE_PRECISION,
+               real_type_of_size(OMPI_SIZEOF_FORTRAN_DOUBLE_PRECISION));
+#endif
+    alias_type(OMPI_OP_BASE_TYPE_BYTE, OMPI_OP_BASE_TYPE_UINT8_T);
+}
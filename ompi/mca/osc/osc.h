@@ -22,8 +22,9 @@
  * One-sided Communication interface
  *
  * Interface for implementing the one-sided communication chapter of
- * the MPI-2 standard.  Similar in scope to the PML for point-to-point
- * communication from MPI-1.
+ * the MPI-2 standard, and the passive target additions of MPI-3
+ * (flush, lock_all, request based operations and atomics).  Similar
+ * in scope to the PML for point-to-point communication from MPI-1.
  */
 
 #ifndef OMPI_MCA_OSC_OSC_H
@@ -49,6 +50,7 @@ struct ompi_communicator_t;
 struct ompi_group_t;
 struct ompi_datatype_t;
 struct ompi_op_t;
+struct ompi_request_t;
 
 
 /* ******************************************************************** */
@@ -101,7 +103,9 @@ typedef int (*ompi_osc_base_component_finalize_fn_t)(void);
  *
  * @return The selection priority of the component
  *
- * @param[in]  win  The window handle, already filled in by MPI_WIN_CREATE()
+ * @param[in]  win  The window handle, already filled in by MPI_WIN_CREATE(),
+ *                  MPI_WIN_ALLOCATE_SHARED() or MPI_WIN_CREATE_DYNAMIC().
+ *                  win->w_flavor tells which one.
  * @param[in]  info An info structure with hints from the user
  *                  regarding the usage of the component
  * @param[in]  comm The communicator specified by the user for the
@@ -125,6 +129,17 @@ typedef int (*ompi_osc_base_component_query_fn_t)(struct ompi_win_t *win,
  * module is responsible for providing any required collective
  * synchronization before the end of the call.  
  *
+ * For the windows of MPI_WIN_ALLOCATE_SHARED (win->w_flavor is
+ * OMPI_WIN_FLAVOR_SHARED), the component allocates the win->w_size
+ * bytes of the local process in memory shared by all the processes
+ * of comm and sets win->w_baseptr.
+ *
+ * The windows of MPI_WIN_CREATE_DYNAMIC (OMPI_WIN_FLAVOR_DYNAMIC)
+ * start without memory: win->w_baseptr is MPI_BOTTOM, the displacement
+ * unit is 1 and target displacements are absolute addresses in the
+ * target.  Memory comes and goes through osc_win_attach and
+ * osc_win_detach.
+ *
  * @note The comm is the communicator specified from the user, so
  * normal internal usage rules apply.  In other words, if you need
  * communication for the life of the window, you should call
@@ -254,6 +269,83 @@ typedef int (*ompi_osc_base_module_unlock_fn_t)(int target,
                                              struct ompi_win_t *win);
 
 
+typedef int (*ompi_osc_base_module_rput_fn_t)(void *origin_addr,
+                                             int origin_count,
+                                             struct ompi_datatype_t *origin_dt,
+                                             int target,
+                                             OPAL_PTRDIFF_TYPE target_disp,
+                                             int target_count,
+                                             struct ompi_datatype_t *target_dt,
+                                             struct ompi_win_t *win,
+                                             struct ompi_request_t **request);
+
+
+typedef int (*ompi_osc_base_module_rget_fn_t)(void *origin_addr,
+                                             int origin_count,
+                                             struct ompi_datatype_t *origin_dt,
+                                             int target,
+                                             OPAL_PTRDIFF_TYPE target_disp,
+                                             int target_count,
+                                             struct ompi_datatype_t *target_dt,
+                                             struct ompi_win_t *win,
+                                             struct ompi_request_t **request);
+
+
+typedef int (*ompi_osc_base_module_fetch_and_op_fn_t)(void *origin_addr,
+                                                     void *result_addr,
+                                                     struct ompi_datatype_t *dt,
+                                                     int target,
+                                                     OPAL_PTRDIFF_TYPE target_disp,
+                                                     struct ompi_op_t *op,
+                                                     struct ompi_win_t *win);
+
+
+typedef int (*ompi_osc_base_module_compare_and_swap_fn_t)(void *origin_addr,
+                                                         void *compare_addr,
+                                                         void *result_addr,
+                                                         struct ompi_datatype_t *dt,
+                                                         int target,
+                                                         OPAL_PTRDIFF_TYPE target_disp,
+                                                         struct ompi_win_t *win);
+
+
+typedef int (*ompi_osc_base_module_lock_all_fn_t)(int assert,
+                                                 struct ompi_win_t *win);
+
+
+typedef int (*ompi_osc_base_module_unlock_all_fn_t)(struct ompi_win_t *win);
+
+
+typedef int (*ompi_osc_base_module_flush_fn_t)(int target,
+                                              struct ompi_win_t *win);
+
+
+typedef int (*ompi_osc_base_module_flush_all_fn_t)(struct ompi_win_t *win);
+
+
+typedef int (*ompi_osc_base_module_flush_local_fn_t)(int target,
+                                                    struct ompi_win_t *win);
+
+
+typedef int (*ompi_osc_base_module_flush_local_all_fn_t)(struct ompi_win_t *win);
+
+
+typedef int (*ompi_osc_base_module_shared_query_fn_t)(struct ompi_win_t *win,
+                                                     int rank,
+                                                     size_t *size,
+                                                     int *disp_unit,
+                                                     void *baseptr);
+
+
+typedef int (*ompi_osc_base_module_win_attach_fn_t)(struct ompi_win_t *win,
+                                                   void *base,
+                                                   size_t len);
+
+
+typedef int (*ompi_osc_base_module_win_detach_fn_t)(struct ompi_win_t *win,
+                                                   void *base);
+
+
 /* ******************************************************************** */
 
 
@@ -265,6 +357,10 @@ typedef int (*ompi_osc_base_module_unlock_fn_t)(int target,
  * module instead of a base module itself so that the component is
  * free to create a structure that inherits this one for use as the
  * module structure.
+ *
+ * The functions after osc_unlock implement the MPI-3 passive target
+ * interface.  A component not providing them leaves them NULL, and the
+ * MPI layer returns MPI_ERR_UNSUPPORTED_OPERATION.
  */
 struct ompi_osc_base_module_1_0_0_t {
     /** Free resources associated with the window */
@@ -295,6 +391,38 @@ struct ompi_osc_base_module_1_0_0_t {
     ompi_osc_base_module_lock_fn_t osc_lock;
     /* Implement MPI_WIN_UNLOCK */
     ompi_osc_base_module_unlock_fn_t osc_unlock;
+
+    /** Implement MPI_RPUT */
+    ompi_osc_base_module_rput_fn_t osc_rput;
+    /** Implement MPI_RGET */
+    ompi_osc_base_module_rget_fn_t osc_rget;
+    /** Implement MPI_FETCH_AND_OP */
+    ompi_osc_base_module_fetch_and_op_fn_t osc_fetch_and_op;
+    /** Implement MPI_COMPARE_AND_SWAP */
+    ompi_osc_base_module_compare_and_swap_fn_t osc_compare_and_swap;
+
+    /* Implement MPI_WIN_LOCK_ALL */
+    ompi_osc_base_module_lock_all_fn_t osc_lock_all;
+    /* Implement MPI_WIN_UNLOCK_ALL */
+    ompi_osc_base_module_unlock_all_fn_t osc_unlock_all;
+
+    /* Implement MPI_WIN_FLUSH */
+    ompi_osc_base_module_flush_fn_t osc_flush;
+    /* Implement MPI_WIN_FLUSH_ALL */
+    ompi_osc_base_module_flush_all_fn_t osc_flush_all;
+    /* Implement MPI_WIN_FLUSH_LOCAL */
+    ompi_osc_base_module_flush_local_fn_t osc_flush_local;
+    /* Implement MPI_WIN_FLUSH_LOCAL_ALL */
+    ompi_osc_base_module_flush_local_all_fn_t osc_flush_local_all;
+
+    /** Implement MPI_WIN_SHARED_QUERY, for the windows of
+        MPI_WIN_ALLOCATE_SHARED only */
+    ompi_osc_base_module_shared_query_fn_t osc_shared_query;
+
+    /** Implement MPI_WIN_ATTACH and MPI_WIN_DETACH, for the windows
+        of MPI_WIN_CREATE_DYNAMIC only */
+    ompi_osc_base_module_win_attach_fn_t osc_win_attach;
+    ompi_osc_base_module_win_detach_fn_t osc_win_detach;
 };
 typedef struct ompi_osc_base_module_1_0_0_t ompi_osc_base_module_1_0_0_t;
 typedef ompi_osc_base_module_1_0_0_t ompi_osc_base_module_t;
@@ -42,6 +42,9 @@ struct ompi_osc_pt2pt_component_t {
     /** max size of eager message */
     unsigned long long p2p_c_eager_size;
 
+    /** max number of accumulates sent in the same message */
+    int p2p_c_acc_batch_count;
+
     /** free list of ompi_osc_pt2pt_sendreq_t structures */
     opal_free_list_t p2p_c_sendreqs;
     /** free list of ompi_osc_pt2pt_replyreq_t structures */
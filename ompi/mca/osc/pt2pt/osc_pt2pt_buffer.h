@@ -29,6 +29,8 @@ struct ompi_osc_pt2pt_buffer_t {
     void *data;
     void *payload;
     size_t len;
+    /* number of sendreqs packed in the buffer (origin side) */
+    int count;
 };
 typedef struct ompi_osc_pt2pt_buffer_t ompi_osc_pt2pt_buffer_t;
 OBJ_CLASS_DECLARATION(ompi_osc_pt2pt_buffer_t);
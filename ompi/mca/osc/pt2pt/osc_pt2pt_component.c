@@ -101,6 +101,17 @@ component_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_osc_pt2pt_component.p2p_c_eager_size);
 
+    mca_osc_pt2pt_component.p2p_c_acc_batch_count = 64;
+    (void) mca_base_component_var_register(&mca_osc_pt2pt_component.super.osc_version,
+                                           "acc_batch_count",
+                                           "Max number of short accumulates to the same target "
+                                           "sent in one message, up to the eager limit "
+                                           "(1 disables the batching)",
+                                           MCA_BASE_VAR_TYPE_INT,
+                                           NULL, 0, 0, OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_osc_pt2pt_component.p2p_c_acc_batch_count);
+
     return OMPI_SUCCESS;
 }
 
@@ -160,6 +171,10 @@ ompi_osc_pt2pt_component_query(ompi_win_t *win,
                               ompi_info_t *info,
                               ompi_communicator_t *comm)
 {
+    /* we do not allocate the memory of the window, nor attach any */
+    if (OMPI_WIN_FLAVOR_SHARED == win->w_flavor ||
+        OMPI_WIN_FLAVOR_DYNAMIC == win->w_flavor) return -1;
+
     /* we can always run - return a low priority */
     return 5;
 }
@@ -390,8 +405,13 @@ component_fragment_cb(ompi_request_t *request)
                 }
             }
 
-            /* receive into temporary buffer */
-            ret = ompi_osc_pt2pt_sendreq_recv_accum(module, header, payload);
+            if (header->hdr_base.hdr_flags & OMPI_OSC_PT2PT_HDR_FLAG_MORE) {
+                /* several accumulates in the message */
+                ret = ompi_osc_pt2pt_sendreq_recv_accum_batch(module, header);
+            } else {
+                /* receive into temporary buffer */
+                ret = ompi_osc_pt2pt_sendreq_recv_accum(module, header, payload);
+            }
         }
         break;
 
@@ -23,6 +23,7 @@
 #include "osc_pt2pt_data_move.h"
 #include "osc_pt2pt_buffer.h"
 
+#include "opal/align.h"
 #include "opal/util/arch.h"
 #include "opal/util/output.h"
 #include "opal/sys/atomic.h"
@@ -142,7 +143,7 @@ ompi_osc_pt2pt_sendreq_send_cb(ompi_request_t *request)
         if (header->hdr_msg_length != 0) {
             /* sendreq is done.  Mark it as so and get out of here */
             OPAL_THREAD_LOCK(&sendreq->req_module->p2p_lock);
-            count = (sendreq->req_module->p2p_num_pending_out -= 1);
+            count = (sendreq->req_module->p2p_num_pending_out -= buffer->count);
             OPAL_THREAD_UNLOCK(&sendreq->req_module->p2p_lock);
             ompi_osc_pt2pt_sendreq_free(sendreq);
             if (0 == count) opal_condition_broadcast(&sendreq->req_module->p2p_cond);
@@ -158,6 +159,109 @@ ompi_osc_pt2pt_sendreq_send_cb(ompi_request_t *request)
 }
 
 
+/* pack the short accumulates waiting for the same target behind the
+   one already in the buffer, so the target handles all of them in one
+   message and under one acquisition of its accumulate lock.  Each one
+   gets its own header, datatype and payload, starting on an 8 byte
+   boundary, and the previous header is flagged with
+   OMPI_OSC_PT2PT_HDR_FLAG_MORE.  The scan stops at the first request
+   for the target which cannot be packed, so the order of the
+   operations to a target is not changed. */
+static int
+ompi_osc_pt2pt_sendreq_batch_accum(ompi_osc_pt2pt_module_t *module,
+                                   ompi_osc_pt2pt_buffer_t *buffer,
+                                   ompi_osc_pt2pt_send_header_t *header,
+                                   size_t *written_data)
+{
+    ompi_osc_pt2pt_sendreq_t *first = (ompi_osc_pt2pt_sendreq_t*) buffer->data;
+    opal_list_item_t *item, *next;
+    int ret;
+
+    for (item = opal_list_get_first(&module->p2p_copy_pending_sendreqs) ;
+         item != opal_list_get_end(&module->p2p_copy_pending_sendreqs) &&
+             buffer->count < mca_osc_pt2pt_component.p2p_c_acc_batch_count ;
+         item = next) {
+        ompi_osc_pt2pt_sendreq_t *sendreq = (ompi_osc_pt2pt_sendreq_t*) item;
+        ompi_osc_pt2pt_send_header_t *next_header;
+        size_t offset, packed_ddt_len;
+        const void *packed_ddt;
+        struct iovec iov;
+        uint32_t iov_count = 1;
+        size_t max_data;
+
+        next = opal_list_get_next(item);
+        if (sendreq->req_target_rank != first->req_target_rank) continue;
+        if (OMPI_OSC_PT2PT_ACC != sendreq->req_type ||
+            0 == sendreq->req_origin_bytes_packed) break;
+
+        offset = OPAL_ALIGN(*written_data, sizeof(uint64_t), size_t);
+        packed_ddt_len = ompi_datatype_pack_description_length(sendreq->req_target_datatype);
+        if (offset + sizeof(ompi_osc_pt2pt_send_header_t) + packed_ddt_len +
+            sendreq->req_origin_bytes_packed > mca_osc_pt2pt_component.p2p_c_eager_size) {
+            break;
+        }
+
+        ret = ompi_datatype_get_pack_description(sendreq->req_target_datatype, &packed_ddt);
+        if (OMPI_SUCCESS != ret) return ret;
+
+        next_header = (ompi_osc_pt2pt_send_header_t*)
+            ((unsigned char*) buffer->payload + offset);
+        offset += sizeof(ompi_osc_pt2pt_send_header_t);
+        next_header->hdr_base.hdr_type = OMPI_OSC_PT2PT_HDR_ACC;
+        next_header->hdr_base.hdr_flags = 0;
+        next_header->hdr_origin = ompi_comm_rank(module->p2p_comm);
+        next_header->hdr_origin_sendreq.pval = NULL;
+        next_header->hdr_origin_tag = 0;
+        next_header->hdr_target_disp = sendreq->req_target_disp;
+        next_header->hdr_target_count = sendreq->req_target_count;
+        next_header->hdr_target_op = sendreq->req_op_id;
+        next_header->hdr_msg_length = sendreq->req_origin_bytes_packed;
+
+        memcpy((unsigned char*) buffer->payload + offset, packed_ddt, packed_ddt_len);
+        offset += packed_ddt_len;
+
+        max_data = sendreq->req_origin_bytes_packed;
+        iov.iov_len = max_data;
+        iov.iov_base = (IOVBASE_TYPE*)((unsigned char*) buffer->payload + offset);
+        MEMCHECKER(
+            memchecker_convertor_call(&opal_memchecker_base_mem_defined,
+                                      &sendreq->req_origin_convertor);
+        );
+        ret = opal_convertor_pack(&sendreq->req_origin_convertor, &iov, &iov_count,
+                                  &max_data );
+        MEMCHECKER(
+            memchecker_convertor_call(&opal_memchecker_base_mem_noaccess,
+                                      &sendreq->req_origin_convertor);
+        );
+        if (ret < 0) return OMPI_ERR_FATAL;
+        assert(max_data == sendreq->req_origin_bytes_packed);
+        offset += max_data;
+
+#ifdef WORDS_BIGENDIAN
+        next_header->hdr_base.hdr_flags |= OMPI_OSC_PT2PT_HDR_FLAG_NBO;
+#elif OPAL_ENABLE_HETEROGENEOUS_SUPPORT
+        if (sendreq->req_target_proc->proc_arch & OPAL_ARCH_ISBIGENDIAN) {
+            next_header->hdr_base.hdr_flags |= OMPI_OSC_PT2PT_HDR_FLAG_NBO;
+            OMPI_OSC_PT2PT_SEND_HDR_HTON(*next_header);
+        }
+#endif
+
+        /* the flags are not byte swapped */
+        header->hdr_base.hdr_flags |= OMPI_OSC_PT2PT_HDR_FLAG_MORE;
+        header = next_header;
+        *written_data = offset;
+        buffer->count++;
+
+        /* everything is in the buffer, the sendreq is done. It is
+           accounted for in the completion of the buffer. */
+        opal_list_remove_item(&module->p2p_copy_pending_sendreqs, item);
+        ompi_osc_pt2pt_sendreq_free(sendreq);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+
 /* create the initial fragment, pack header, datatype, and payload (if
    size fits) and send */
 int
@@ -197,6 +301,7 @@ ompi_osc_pt2pt_sendreq_send(ompi_osc_pt2pt_module_t *module,
 
     /* setup buffer */
     buffer->data = sendreq;
+    buffer->count = 1;
 
     /* pack header */
     header = (ompi_osc_pt2pt_send_header_t*) buffer->payload;
@@ -265,6 +370,13 @@ ompi_osc_pt2pt_sendreq_send(ompi_osc_pt2pt_module_t *module,
             written_data += max_data;
 
             header->hdr_msg_length = sendreq->req_origin_bytes_packed;
+
+            if (OMPI_OSC_PT2PT_ACC == sendreq->req_type && 0 != max_data &&
+                mca_osc_pt2pt_component.p2p_c_acc_batch_count > 1) {
+                ret = ompi_osc_pt2pt_sendreq_batch_accum(module, buffer, header,
+                                                         &written_data);
+                if (OMPI_SUCCESS != ret) goto cleanup;
+            }
         } else {
             header->hdr_msg_length = 0;
             header->hdr_origin_tag = create_send_tag(module);
@@ -718,16 +830,20 @@ ompi_osc_pt2pt_sendreq_recv_accum_long_cb(ompi_request_t *request)
 }
 
 
-int
-ompi_osc_pt2pt_sendreq_recv_accum(ompi_osc_pt2pt_module_t *module,
-                                  ompi_osc_pt2pt_send_header_t *header,
-                                  void *payload)
+/* apply an accumulate whose data came with the header, advancing
+   payload past the data.  Must be called with the accumulate lock
+   held. */
+static int
+ompi_osc_pt2pt_sendreq_apply_accum(ompi_osc_pt2pt_module_t *module,
+                                   ompi_osc_pt2pt_send_header_t *header,
+                                   void **payload_ptr)
 {
     int ret = OMPI_SUCCESS;
     struct ompi_op_t *op = ompi_osc_base_op_create(header->hdr_target_op);
     ompi_proc_t *proc = ompi_comm_peer_lookup( module->p2p_comm, header->hdr_origin );
     struct ompi_datatype_t *datatype = 
-        ompi_osc_base_datatype_create(proc, &payload);
+        ompi_osc_base_datatype_create(proc, payload_ptr);
+    void *payload = *payload_ptr;
     void *target = (unsigned char*) module->p2p_win->w_baseptr + 
         ((unsigned long)header->hdr_target_disp * module->p2p_win->w_disp_unit);    
 
@@ -737,24 +853,62 @@ ompi_osc_pt2pt_sendreq_recv_accum(ompi_osc_pt2pt_module_t *module,
         ompi_mpi_abort(module->p2p_comm, 1, false);
     }
 
-    if (header->hdr_msg_length > 0) {
-        /* lock the window for accumulates */
-        OPAL_THREAD_LOCK(&module->p2p_acc_lock);
+    if (op == &ompi_mpi_op_replace.op) {
+        opal_convertor_t convertor;
+        struct iovec iov;
+        uint32_t iov_count = 1;
+        size_t max_data;
+
+        /* create convertor */
+        OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+
+        /* initialize convertor */
+        opal_convertor_copy_and_prepare_for_recv(proc->proc_convertor,
+                                                 &(datatype->super),
+                                                 header->hdr_target_count,
+                                                 target,
+                                                 0,
+                                                 &convertor);
 
-        if (op == &ompi_mpi_op_replace.op) {
+        iov.iov_len = header->hdr_msg_length;
+        iov.iov_base = (IOVBASE_TYPE*)payload;
+        max_data = iov.iov_len;
+        opal_convertor_unpack(&convertor, 
+                              &iov,
+                              &iov_count,
+                              &max_data);
+        OBJ_DESTRUCT(&convertor);
+    } else {
+        void *buffer = NULL;
+
+#if OPAL_ENABLE_HETEROGENEOUS_SUPPORT
+        if (proc->proc_arch != ompi_proc_local()->proc_arch) {
             opal_convertor_t convertor;
             struct iovec iov;
             uint32_t iov_count = 1;
             size_t max_data;
+            struct ompi_datatype_t *primitive_datatype = NULL;
+            uint32_t primitive_count;
+            size_t buflen;
+
+            ompi_osc_base_get_primitive_type_info(datatype, &primitive_datatype, &primitive_count);
+            primitive_count *= header->hdr_target_count;
+
+            /* figure out how big a buffer we need */
+            ompi_datatype_type_size(primitive_datatype, &buflen);
+            buflen *= primitive_count;
 
             /* create convertor */
             OBJ_CONSTRUCT(&convertor, opal_convertor_t);
 
+            buffer = (void*) malloc(buflen);
+            if (NULL == buffer) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+
             /* initialize convertor */
             opal_convertor_copy_and_prepare_for_recv(proc->proc_convertor,
-                                                     &(datatype->super),
-                                                     header->hdr_target_count,
-                                                     target,
+                                                     &(primitive_datatype->super),
+                                                     primitive_count,
+                                                     buffer,
                                                      0,
                                                      &convertor);
 
@@ -767,86 +921,114 @@ ompi_osc_pt2pt_sendreq_recv_accum(ompi_osc_pt2pt_module_t *module,
                                   &max_data);
             OBJ_DESTRUCT(&convertor);
         } else {
-            void *buffer = NULL;
-
-#if OPAL_ENABLE_HETEROGENEOUS_SUPPORT
-            if (proc->proc_arch != ompi_proc_local()->proc_arch) {
-                opal_convertor_t convertor;
-                struct iovec iov;
-                uint32_t iov_count = 1;
-                size_t max_data;
-                struct ompi_datatype_t *primitive_datatype = NULL;
-                uint32_t primitive_count;
-                size_t buflen;
-
-                ompi_osc_base_get_primitive_type_info(datatype, &primitive_datatype, &primitive_count);
-                primitive_count *= header->hdr_target_count;
-
-                /* figure out how big a buffer we need */
-                ompi_datatype_type_size(primitive_datatype, &buflen);
-                buflen *= primitive_count;
-
-                /* create convertor */
-                OBJ_CONSTRUCT(&convertor, opal_convertor_t);
-
-                buffer = (void*) malloc(buflen);
-                if (NULL == buffer) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
-
-                /* initialize convertor */
-                opal_convertor_copy_and_prepare_for_recv(proc->proc_convertor,
-                                                         &(primitive_datatype->super),
-                                                         primitive_count,
-                                                         buffer,
-                                                         0,
-                                                         &convertor);
-
-                iov.iov_len = header->hdr_msg_length;
-                iov.iov_base = (IOVBASE_TYPE*)payload;
-                max_data = iov.iov_len;
-                opal_convertor_unpack(&convertor, 
-                                      &iov,
-                                      &iov_count,
-                                      &max_data);
-                OBJ_DESTRUCT(&convertor);
-            } else {
-                buffer = payload;
-            }
-#else
             buffer = payload;
+        }
+#else
+        buffer = payload;
 #endif
-            /* 
-             * Before copy to the user buffer, make the target part 
-             * accessable.
-             */
-            MEMCHECKER(
-                opal_memchecker_base_mem_defined( target, header->hdr_msg_length );
-            );
-            /* copy the data from the temporary buffer into the user window */
-            ret = ompi_osc_base_process_op(target,
-                                           buffer,
-                                           header->hdr_msg_length,
-                                           datatype,
-                                           header->hdr_target_count,
-                                           op);
-            /* Copy finished, make the user buffer unaccessable. */
-            MEMCHECKER(
-                opal_memchecker_base_mem_noaccess( target, header->hdr_msg_length );
-            );
+        /* 
+         * Before copy to the user buffer, make the target part 
+         * accessable.
+         */
+        MEMCHECKER(
+            opal_memchecker_base_mem_defined( target, header->hdr_msg_length );
+        );
+        /* copy the data from the temporary buffer into the user window */
+        ret = ompi_osc_base_process_op(target,
+                                       buffer,
+                                       header->hdr_msg_length,
+                                       datatype,
+                                       header->hdr_target_count,
+                                       op);
+        /* Copy finished, make the user buffer unaccessable. */
+        MEMCHECKER(
+            opal_memchecker_base_mem_noaccess( target, header->hdr_msg_length );
+        );
 
 #if OPAL_ENABLE_HETEROGENEOUS_SUPPORT
-            if (proc->proc_arch != ompi_proc_local()->proc_arch) {
-                if (NULL == buffer) free(buffer);
-            }
+        if (proc->proc_arch != ompi_proc_local()->proc_arch) {
+            if (NULL == buffer) free(buffer);
+        }
 #endif
+    }
+
+    /* Release datatype & op */
+    OBJ_RELEASE(datatype);
+    OBJ_RELEASE(op);
+
+    *payload_ptr = (unsigned char*) payload + header->hdr_msg_length;
+
+    return ret;
+}
+
+
+/* receive a message holding several accumulates (see
+   ompi_osc_pt2pt_sendreq_send).  All of them carry their data and are
+   applied under a single acquisition of the accumulate lock. */
+int
+ompi_osc_pt2pt_sendreq_recv_accum_batch(ompi_osc_pt2pt_module_t *module,
+                                        void *base)
+{
+    int ret = OMPI_SUCCESS, count = 0;
+    ompi_osc_pt2pt_send_header_t *header =
+        (ompi_osc_pt2pt_send_header_t*) base;
+    void *payload;
+    size_t offset;
+
+    /* lock the window for accumulates */
+    OPAL_THREAD_LOCK(&module->p2p_acc_lock);
+
+    while (1) {
+        payload = (void*) (header + 1);
+        ret = ompi_osc_pt2pt_sendreq_apply_accum(module, header, &payload);
+        if (OMPI_SUCCESS != ret) break;
+        ++count;
+
+        if (0 == (header->hdr_base.hdr_flags & OMPI_OSC_PT2PT_HDR_FLAG_MORE)) break;
+
+        /* the next header starts on the next aligned offset */
+        offset = OPAL_ALIGN((size_t) ((unsigned char*) payload - (unsigned char*) base),
+                            sizeof(uint64_t), size_t);
+        header = (ompi_osc_pt2pt_send_header_t*) ((unsigned char*) base + offset);
+#if !defined(WORDS_BIGENDIAN) && OPAL_ENABLE_HETEROGENEOUS_SUPPORT
+        if (header->hdr_base.hdr_flags & OMPI_OSC_PT2PT_HDR_FLAG_NBO) {
+            OMPI_OSC_PT2PT_SEND_HDR_NTOH(*header);
         }
+#endif
+    }
+
+    /* unlock the window for accumulates */
+    OPAL_THREAD_UNLOCK(&module->p2p_acc_lock);
+
+    OPAL_OUTPUT_VERBOSE((50, ompi_osc_base_framework.framework_output,
+                         "%d received %d accum messages from %d",
+                         ompi_comm_rank(module->p2p_comm), count,
+                         header->hdr_origin));
+
+    for ( ; count > 0 ; --count) {
+        inmsg_mark_complete(module);
+    }
+
+    return ret;
+}
+
+
+int
+ompi_osc_pt2pt_sendreq_recv_accum(ompi_osc_pt2pt_module_t *module,
+                                  ompi_osc_pt2pt_send_header_t *header,
+                                  void *payload)
+{
+    int ret = OMPI_SUCCESS;
+
+    if (header->hdr_msg_length > 0) {
+        /* lock the window for accumulates */
+        OPAL_THREAD_LOCK(&module->p2p_acc_lock);
+
+        ret = ompi_osc_pt2pt_sendreq_apply_accum(module, header, &payload);
 
         /* unlock the window for accumulates */
         OPAL_THREAD_UNLOCK(&module->p2p_acc_lock);
 
-        /* Release datatype & op */
-        OBJ_RELEASE(datatype);
-        OBJ_RELEASE(op);
-
         inmsg_mark_complete(module);
 
         OPAL_OUTPUT_VERBOSE((50, ompi_osc_base_framework.framework_output,
@@ -854,11 +1036,22 @@ ompi_osc_pt2pt_sendreq_recv_accum(ompi_osc_pt2pt_module_t *module,
                              ompi_comm_rank(module->p2p_comm),
                              header->hdr_origin));
     } else {
+        struct ompi_op_t *op = ompi_osc_base_op_create(header->hdr_target_op);
+        ompi_proc_t *proc = ompi_comm_peer_lookup( module->p2p_comm, header->hdr_origin );
+        struct ompi_datatype_t *datatype = 
+            ompi_osc_base_datatype_create(proc, &payload);
+
         ompi_osc_pt2pt_longreq_t *longreq;
         size_t buflen;
         struct ompi_datatype_t *primitive_datatype = NULL;
         uint32_t primitive_count;
 
+        if (NULL == datatype) {
+            opal_output(ompi_osc_base_framework.framework_output,
+                        "Error recreating datatype.  Aborting.");
+            ompi_mpi_abort(module->p2p_comm, 1, false);
+        }
+
         /* get underlying type... */
         ompi_osc_base_get_primitive_type_info(datatype, &primitive_datatype, &primitive_count);
         primitive_count *= header->hdr_target_count;
@@ -41,6 +41,11 @@ int ompi_osc_pt2pt_sendreq_recv_accum(ompi_osc_pt2pt_module_t *module,
                                       ompi_osc_pt2pt_send_header_t *header,
                                       void *payload);
 
+/* receive the target side of a message holding several short
+   accumulates, starting with the header at base */
+int ompi_osc_pt2pt_sendreq_recv_accum_batch(ompi_osc_pt2pt_module_t *module,
+                                            void *base);
+
 /* receive the origin side of a replyreq (the reply part of an
    MPI_Get), directly into the user's window */
 int ompi_osc_pt2pt_replyreq_recv(ompi_osc_pt2pt_module_t *module,
@@ -37,6 +37,8 @@
 #define OMPI_OSC_PT2PT_HDR_UNLOCK_REPLY 0x0009
 
 #define OMPI_OSC_PT2PT_HDR_FLAG_NBO   0x0001
+/* another send header follows the data, at the next 8 byte boundary */
+#define OMPI_OSC_PT2PT_HDR_FLAG_MORE  0x0002
 
 struct ompi_osc_pt2pt_base_header_t {
     uint8_t hdr_type;
@@ -54,6 +54,8 @@ ompi_osc_rdma_module_free(ompi_win_t *win)
 
     win->w_osc_module = NULL;
 
+    ompi_osc_rdma_regions_fini(module);
+    OBJ_DESTRUCT(&module->m_comm_ranks);
     OBJ_DESTRUCT(&module->m_unlocks_pending);
     OBJ_DESTRUCT(&module->m_locks_pending);
     OBJ_DESTRUCT(&module->m_queued_sendreqs);
@@ -63,12 +65,21 @@ ompi_osc_rdma_module_free(ompi_win_t *win)
     OBJ_DESTRUCT(&module->m_cond);
     OBJ_DESTRUCT(&module->m_lock);
 
+    if (NULL != module->m_passive_pending_in) {
+        free(module->m_passive_pending_in);
+    }
+    if (NULL != module->m_passive_lock_granted) {
+        free(module->m_passive_lock_granted);
+    }
     if (NULL != module->m_sc_remote_ranks) {
         free(module->m_sc_remote_ranks);
     }
     if (NULL != module->m_sc_remote_active_ranks) {
         free(module->m_sc_remote_active_ranks);
     }
+    if (NULL != module->m_post_flags) {
+        free(module->m_post_flags);
+    }
     if (NULL != module->m_pending_buffers) {
         free(module->m_pending_buffers);
     }
@@ -135,3 +146,127 @@ ompi_osc_rdma_peer_info_free(ompi_osc_rdma_peer_info_t *peer_info)
 
     return OMPI_SUCCESS;
 }
+
+
+/*
+ * Dynamic windows.  The target displacements are absolute addresses,
+ * which the active message path handles as for any other window
+ * (w_baseptr is MPI_BOTTOM and w_disp_unit 1), so attaching and
+ * detaching is only local bookkeeping.  The regions are kept in a red
+ * black tree like the vma tree of rcache/vma: ordered by base
+ * address, and searched by address.
+ */
+
+static int
+region_compare(void *key1, void *key2)
+{
+    ompi_osc_rdma_region_t *region1 = (ompi_osc_rdma_region_t*) key1;
+    ompi_osc_rdma_region_t *region2 = (ompi_osc_rdma_region_t*) key2;
+
+    if (region1->base < region2->base) return -1;
+    if (region1->base > region2->base) return 1;
+    return 0;
+}
+
+
+/* key1 is an address: find the region holding it */
+static int
+region_compare_search(void *key1, void *key2)
+{
+    uintptr_t addr = (uintptr_t) key1;
+    ompi_osc_rdma_region_t *region = (ompi_osc_rdma_region_t*) key2;
+
+    if (addr < region->base) return -1;
+    if (addr >= region->base + region->len) return 1;
+    return 0;
+}
+
+
+static int
+region_any(void *value)
+{
+    return 1;
+}
+
+
+static void
+region_free(void *key, void *value)
+{
+    free(value);
+}
+
+
+int
+ompi_osc_rdma_regions_init(ompi_osc_rdma_module_t *module)
+{
+    OBJ_CONSTRUCT(&module->m_regions, ompi_rb_tree_t);
+    return ompi_rb_tree_init(&module->m_regions, region_compare);
+}
+
+
+void
+ompi_osc_rdma_regions_fini(ompi_osc_rdma_module_t *module)
+{
+    ompi_rb_tree_traverse(&module->m_regions, region_any, region_free);
+    OBJ_DESTRUCT(&module->m_regions);
+}
+
+
+int
+ompi_osc_rdma_module_win_attach(ompi_win_t *win, void *base, size_t len)
+{
+    ompi_osc_rdma_module_t *module = GET_MODULE(win);
+    ompi_osc_rdma_region_t *region;
+    int ret;
+
+    if (0 == len) {
+        return OMPI_SUCCESS;
+    }
+
+    region = (ompi_osc_rdma_region_t*) malloc(sizeof(ompi_osc_rdma_region_t));
+    if (NULL == region) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    region->base = (uintptr_t) base;
+    region->len = len;
+
+    OPAL_THREAD_LOCK(&module->m_lock);
+    /* the same memory can not be attached twice */
+    if (NULL != ompi_rb_tree_find_with(&module->m_regions, base,
+                                       region_compare_search) ||
+        NULL != ompi_rb_tree_find_with(&module->m_regions,
+                                       (char*) base + len - 1,
+                                       region_compare_search)) {
+        ret = MPI_ERR_ARG;
+    } else {
+        ret = ompi_rb_tree_insert(&module->m_regions, region, region);
+    }
+    OPAL_THREAD_UNLOCK(&module->m_lock);
+
+    if (OMPI_SUCCESS != ret) free(region);
+
+    return ret;
+}
+
+
+int
+ompi_osc_rdma_module_win_detach(ompi_win_t *win, void *base)
+{
+    ompi_osc_rdma_module_t *module = GET_MODULE(win);
+    ompi_osc_rdma_region_t *region;
+    int ret = OMPI_SUCCESS;
+
+    OPAL_THREAD_LOCK(&module->m_lock);
+    region = (ompi_osc_rdma_region_t*)
+        ompi_rb_tree_find_with(&module->m_regions, base, region_compare_search);
+    if (NULL == region || region->base != (uintptr_t) base) {
+        /* base must be the start of an attached region */
+        region = NULL;
+        ret = MPI_ERR_ARG;
+    } else {
+        ompi_rb_tree_delete(&module->m_regions, region);
+    }
+    OPAL_THREAD_UNLOCK(&module->m_lock);
+
+    if (NULL != region) free(region);
+
+    return ret;
+}
@@ -26,6 +26,7 @@
 #include "opal/class/opal_hash_table.h"
 #include "opal/threads/threads.h"
 
+#include "ompi/class/ompi_rb_tree.h"
 #include "ompi/win/win.h"
 #include "ompi/communicator/communicator.h"
 #include "ompi/request/request.h"
@@ -108,6 +109,14 @@ struct ompi_osc_rdma_setup_info_t {
 typedef struct ompi_osc_rdma_setup_info_t ompi_osc_rdma_setup_info_t;
 
 
+/* memory attached to a dynamic window */
+struct ompi_osc_rdma_region_t {
+    uintptr_t base;
+    size_t len;
+};
+typedef struct ompi_osc_rdma_region_t ompi_osc_rdma_region_t;
+
+
 struct ompi_osc_rdma_module_t {
     /** Extend the basic osc module interface */
     ompi_osc_base_module_t super;
@@ -153,8 +162,8 @@ struct ompi_osc_rdma_module_t {
         atomic counter operations. */
     int32_t m_num_pending_in;
 
-    /** Number of "ping" messages from the remote post group we've
-        received */
+    /** Number of members of the current start group whose post we
+        are still waiting for */
     int32_t m_num_post_msgs;
 
     /** Number of "count" messages from the remote complete group
@@ -182,6 +191,13 @@ struct ompi_osc_rdma_module_t {
     ompi_osc_rdma_peer_info_t *m_peer_info;
     int32_t m_rdma_num_pending;
 
+    /** Number of sendreqs that went through active messages instead
+        of RDMA since the last fence.  While it is zero everywhere,
+        fence needs no count exchange (see
+        ompi_osc_rdma_module_fence).  Not protected by m_lock - must
+        use atomic counter operations. */
+    int32_t m_fence_am_sendreqs;
+
      /*** buffering ***/
      bool m_use_buffers;
      ompi_osc_rdma_buffer_t *m_pending_buffers;
@@ -194,15 +210,42 @@ struct ompi_osc_rdma_module_t {
     /* ********************* PWSC data ************************ */
     struct ompi_group_t *m_pw_group;
     struct ompi_group_t *m_sc_group;
+    /* an array of <sizeof(m_comm)> bools, set for the ranks of
+       m_sc_group.  Cleared entry by entry at complete, so an epoch
+       costs the size of its group rather than of the window. */
     bool *m_sc_remote_active_ranks;
     int *m_sc_remote_ranks;
+    /* an array of <sizeof(m_comm)> post flags: the posts received
+       from each rank minus the ones start consumed.  Start decrements
+       the flag of every member of its group, a negative flag is a
+       post start is still waiting for.  m_lock must be held when
+       modifying this field. */
+    int32_t *m_post_flags;
+    /* the rank in m_comm of every ompi_proc_t of m_comm, to translate
+       the start groups without scanning the communicator */
+    opal_hash_table_t m_comm_ranks;
 
     /* ********************* LOCK data ************************ */
     int32_t m_lock_status; /* one of 0, MPI_LOCK_EXCLUSIVE, MPI_LOCK_SHARED */
     int32_t m_shared_count;
     opal_list_t m_locks_pending;
     opal_list_t m_unlocks_pending;
-    int32_t m_lock_received_ack;
+    /* number of targets we have a lock on, or are waiting for */
+    int32_t m_passive_num_locks;
+    /* an array of <sizeof(m_comm)> bools, set when the target granted
+       our lock request */
+    bool *m_passive_lock_granted;
+    /* an array of <sizeof(m_comm)> counters of the passive target
+       messages from each origin we are waiting for.  Counting them
+       per origin lets the unlock or flush of one origin complete
+       while the others keep on sending. */
+    int32_t *m_passive_pending_in;
+
+    /* ********************* DYNAMIC data ********************** */
+    /* the ompi_osc_rdma_region_t attached to a dynamic window,
+       ordered by base address.  m_lock must be held when modifying
+       this field. */
+    ompi_rb_tree_t m_regions;
 };
 typedef struct ompi_osc_rdma_module_t ompi_osc_rdma_module_t;
 OMPI_MODULE_DECLSPEC extern ompi_osc_rdma_component_t mca_osc_rdma_component;
@@ -307,6 +350,68 @@ int ompi_osc_rdma_module_lock(int lock_type,
 int ompi_osc_rdma_module_unlock(int target,
                                 struct ompi_win_t *win);
 
+int ompi_osc_rdma_module_rput(void *origin_addr,
+                              int origin_count,
+                              struct ompi_datatype_t *origin_dt,
+                              int target,
+                              OPAL_PTRDIFF_TYPE target_disp,
+                              int target_count,
+                              struct ompi_datatype_t *target_dt,
+                              struct ompi_win_t *win,
+                              struct ompi_request_t **request);
+
+int ompi_osc_rdma_module_rget(void *origin_addr,
+                              int origin_count,
+                              struct ompi_datatype_t *origin_dt,
+                              int target,
+                              OPAL_PTRDIFF_TYPE target_disp,
+                              int target_count,
+                              struct ompi_datatype_t *target_dt,
+                              struct ompi_win_t *win,
+                              struct ompi_request_t **request);
+
+int ompi_osc_rdma_module_fetch_and_op(void *origin_addr,
+                                      void *result_addr,
+                                      struct ompi_datatype_t *dt,
+                                      int target,
+                                      OPAL_PTRDIFF_TYPE target_disp,
+                                      struct ompi_op_t *op,
+                                      struct ompi_win_t *win);
+
+int ompi_osc_rdma_module_compare_and_swap(void *origin_addr,
+                                          void *compare_addr,
+                                          void *result_addr,
+                                          struct ompi_datatype_t *dt,
+                                          int target,
+                                          OPAL_PTRDIFF_TYPE target_disp,
+                                          struct ompi_win_t *win);
+
+int ompi_osc_rdma_module_lock_all(int assert,
+                                  struct ompi_win_t *win);
+
+int ompi_osc_rdma_module_unlock_all(struct ompi_win_t *win);
+
+int ompi_osc_rdma_module_flush(int target,
+                               struct ompi_win_t *win);
+
+int ompi_osc_rdma_module_flush_all(struct ompi_win_t *win);
+
+int ompi_osc_rdma_module_flush_local(int target,
+                                     struct ompi_win_t *win);
+
+int ompi_osc_rdma_module_flush_local_all(struct ompi_win_t *win);
+
+int ompi_osc_rdma_module_win_attach(struct ompi_win_t *win,
+                                    void *base,
+                                    size_t len);
+
+int ompi_osc_rdma_module_win_detach(struct ompi_win_t *win,
+                                    void *base);
+
+int ompi_osc_rdma_regions_init(ompi_osc_rdma_module_t *module);
+
+void ompi_osc_rdma_regions_fini(ompi_osc_rdma_module_t *module);
+
 /*
  * passive side sync interface functions
  */
@@ -318,6 +423,10 @@ int ompi_osc_rdma_passive_unlock(ompi_osc_rdma_module_t *module,
                                   int32_t origin,
                                   int32_t count);
 
+int ompi_osc_rdma_passive_flush(ompi_osc_rdma_module_t *module,
+                                int32_t origin,
+                                int32_t count);
+
 int ompi_osc_rdma_passive_unlock_complete(ompi_osc_rdma_module_t *module);
 
 
@@ -44,6 +44,39 @@ enqueue_sendreq(ompi_osc_rdma_module_t *module,
 }
 
 
+/* send the sendreq now if eager sends are allowed, queue it for the
+   next synchronization otherwise */
+static int
+start_sendreq(ompi_osc_rdma_module_t *module,
+              ompi_osc_rdma_sendreq_t *sendreq)
+{
+    int ret;
+
+    if (module->m_eager_send_active) {
+        OPAL_THREAD_LOCK(&module->m_lock);
+        sendreq->req_module->m_num_pending_out += 1;
+        module->m_num_pending_sendreqs[sendreq->req_target_rank] += 1;
+        OPAL_THREAD_UNLOCK(&(module->m_lock));
+
+        ret  = ompi_osc_rdma_sendreq_send(module, sendreq);
+
+        if (OMPI_ERR_TEMP_OUT_OF_RESOURCE == ret) {
+            OPAL_THREAD_LOCK(&module->m_lock);
+            sendreq->req_module->m_num_pending_out -= 1;
+            opal_list_append(&(module->m_pending_sendreqs),
+                             (opal_list_item_t*) sendreq);
+            OPAL_THREAD_UNLOCK(&module->m_lock);
+            ret = OMPI_SUCCESS;
+        }
+    } else {
+        /* enqueue sendreq */
+        ret = enqueue_sendreq(module, sendreq);
+    }
+
+    return ret;
+}
+
+
 int
 ompi_osc_rdma_module_accumulate(void *origin_addr, int origin_count,
                                  struct ompi_datatype_t *origin_dt,
@@ -154,15 +187,16 @@ ompi_osc_rdma_module_accumulate(void *origin_addr, int origin_count,
 }
 
 
-int
-ompi_osc_rdma_module_get(void *origin_addr,
-                          int origin_count,
-                          struct ompi_datatype_t *origin_dt,
-                          int target,
-                          OPAL_PTRDIFF_TYPE target_disp,
-                          int target_count,
-                          struct ompi_datatype_t *target_dt,
-                          ompi_win_t *win)
+static int
+get_internal(void *origin_addr,
+             int origin_count,
+             struct ompi_datatype_t *origin_dt,
+             int target,
+             OPAL_PTRDIFF_TYPE target_disp,
+             int target_count,
+             struct ompi_datatype_t *target_dt,
+             ompi_win_t *win,
+             ompi_request_t **request)
 {
     int ret;
     ompi_osc_rdma_sendreq_t *sendreq;
@@ -181,7 +215,8 @@ ompi_osc_rdma_module_get(void *origin_addr,
 
     /* shortcut 0 count case */
     if (0 == origin_count || 0 == target_count) {
-            return OMPI_SUCCESS;
+        if (NULL != request) *request = &ompi_request_empty;
+        return OMPI_SUCCESS;
     }
 
     /* create sendreq */
@@ -201,37 +236,21 @@ ompi_osc_rdma_module_get(void *origin_addr,
     );
     if (OMPI_SUCCESS != ret) return ret;
 
-    if (module->m_eager_send_active) {
-        OPAL_THREAD_LOCK(&module->m_lock);
-        sendreq->req_module->m_num_pending_out += 1;
-        module->m_num_pending_sendreqs[sendreq->req_target_rank] += 1;
-        OPAL_THREAD_UNLOCK(&(module->m_lock));
-
-        ret  = ompi_osc_rdma_sendreq_send(module, sendreq);
-
-        if (OMPI_ERR_TEMP_OUT_OF_RESOURCE == ret) {
-            OPAL_THREAD_LOCK(&module->m_lock);
-            sendreq->req_module->m_num_pending_out -= 1;
-            opal_list_append(&(module->m_pending_sendreqs),
-                             (opal_list_item_t*) sendreq);
-            OPAL_THREAD_UNLOCK(&module->m_lock);
-            ret = OMPI_SUCCESS;
-        }
-    } else {
-        /* enqueue sendreq */
-        ret = enqueue_sendreq(module, sendreq);
+    if (NULL != request) {
+        ompi_osc_rdma_sendreq_user_init(sendreq, request);
     }
 
-    return ret;
+    return start_sendreq(module, sendreq);
 }
 
 
-int
-ompi_osc_rdma_module_put(void *origin_addr, int origin_count,
-                          struct ompi_datatype_t *origin_dt,
-                          int target, OPAL_PTRDIFF_TYPE target_disp, 
-                          int target_count,
-                          struct ompi_datatype_t *target_dt, ompi_win_t *win)
+static int
+put_internal(void *origin_addr, int origin_count,
+             struct ompi_datatype_t *origin_dt,
+             int target, OPAL_PTRDIFF_TYPE target_disp, 
+             int target_count,
+             struct ompi_datatype_t *target_dt, ompi_win_t *win,
+             ompi_request_t **request)
 {
     int ret;
     ompi_osc_rdma_sendreq_t *sendreq;
@@ -250,7 +269,8 @@ ompi_osc_rdma_module_put(void *origin_addr, int origin_count,
 
     /* shortcut 0 count case */
     if (0 == origin_count || 0 == target_count) {
-            return OMPI_SUCCESS;
+        if (NULL != request) *request = &ompi_request_empty;
+        return OMPI_SUCCESS;
     }
 
     /* create sendreq */
@@ -270,26 +290,141 @@ ompi_osc_rdma_module_put(void *origin_addr, int origin_count,
     );
     if (OMPI_SUCCESS != ret) return ret;
 
-    if (module->m_eager_send_active) {
-        OPAL_THREAD_LOCK(&module->m_lock);
-        sendreq->req_module->m_num_pending_out += 1;
-        module->m_num_pending_sendreqs[sendreq->req_target_rank] += 1;
-        OPAL_THREAD_UNLOCK(&(module->m_lock));
+    if (NULL != request) {
+        ompi_osc_rdma_sendreq_user_init(sendreq, request);
+    }
 
-        ret  = ompi_osc_rdma_sendreq_send(module, sendreq);
+    return start_sendreq(module, sendreq);
+}
 
-        if (OMPI_ERR_TEMP_OUT_OF_RESOURCE == ret) {
-            OPAL_THREAD_LOCK(&module->m_lock);
-            sendreq->req_module->m_num_pending_out -= 1;
-            opal_list_append(&(module->m_pending_sendreqs),
-                             (opal_list_item_t*) sendreq);
-            OPAL_THREAD_UNLOCK(&module->m_lock);
-            ret = OMPI_SUCCESS;
-        }
-    } else {
-        /* enqueue sendreq */
-        ret = enqueue_sendreq(module, sendreq);
+
+int
+ompi_osc_rdma_module_get(void *origin_addr,
+                          int origin_count,
+                          struct ompi_datatype_t *origin_dt,
+                          int target,
+                          OPAL_PTRDIFF_TYPE target_disp,
+                          int target_count,
+                          struct ompi_datatype_t *target_dt,
+                          ompi_win_t *win)
+{
+    return get_internal(origin_addr, origin_count, origin_dt, target,
+                        target_disp, target_count, target_dt, win, NULL);
+}
+
+
+int
+ompi_osc_rdma_module_put(void *origin_addr, int origin_count,
+                          struct ompi_datatype_t *origin_dt,
+                          int target, OPAL_PTRDIFF_TYPE target_disp, 
+                          int target_count,
+                          struct ompi_datatype_t *target_dt, ompi_win_t *win)
+{
+    return put_internal(origin_addr, origin_count, origin_dt, target,
+                        target_disp, target_count, target_dt, win, NULL);
+}
+
+
+int
+ompi_osc_rdma_module_rget(void *origin_addr,
+                          int origin_count,
+                          struct ompi_datatype_t *origin_dt,
+                          int target,
+                          OPAL_PTRDIFF_TYPE target_disp,
+                          int target_count,
+                          struct ompi_datatype_t *target_dt,
+                          ompi_win_t *win,
+                          ompi_request_t **request)
+{
+    return get_internal(origin_addr, origin_count, origin_dt, target,
+                        target_disp, target_count, target_dt, win, request);
+}
+
+
+int
+ompi_osc_rdma_module_rput(void *origin_addr, int origin_count,
+                          struct ompi_datatype_t *origin_dt,
+                          int target, OPAL_PTRDIFF_TYPE target_disp, 
+                          int target_count,
+                          struct ompi_datatype_t *target_dt, ompi_win_t *win,
+                          ompi_request_t **request)
+{
+    return put_internal(origin_addr, origin_count, origin_dt, target,
+                        target_disp, target_count, target_dt, win, request);
+}
+
+
+/* The atomic operations are single active messages: the target applies
+   them under the accumulate lock and sends the previous value back, the
+   same way it answers a get. */
+static int
+atomic_internal(ompi_osc_rdma_req_type_t type,
+                void *origin_addr, void *compare_addr, void *result_addr,
+                struct ompi_datatype_t *dt, int target,
+                OPAL_PTRDIFF_TYPE target_disp, struct ompi_op_t *op,
+                ompi_win_t *win)
+{
+    int ret;
+    ompi_osc_rdma_sendreq_t *sendreq;
+    ompi_osc_rdma_module_t *module = GET_MODULE(win);
+
+    if ((OMPI_WIN_STARTED & ompi_win_get_mode(win)) &&
+        (!module->m_sc_remote_active_ranks[target])) {
+        return MPI_ERR_RMA_SYNC;
     }
 
-    return ret;
+    if (OMPI_WIN_FENCE & ompi_win_get_mode(win)) {
+        /* well, we're definitely in an access epoch now */
+        ompi_win_set_mode(win, OMPI_WIN_FENCE | OMPI_WIN_ACCESS_EPOCH |
+                          OMPI_WIN_EXPOSE_EPOCH);
+    }
+
+    /* the result is received like the data of a get */
+    ret = ompi_osc_rdma_sendreq_alloc_init(type,
+                                           result_addr,
+                                           1,
+                                           dt,
+                                           target,
+                                           target_disp,
+                                           1,
+                                           dt,
+                                           module,
+                                           &sendreq);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    sendreq->req_origin_addr = origin_addr;
+    sendreq->req_compare_addr = compare_addr;
+    if (NULL != op) {
+        sendreq->req_op_id = op->o_f_to_c_index;
+    }
+
+    return start_sendreq(module, sendreq);
+}
+
+
+int
+ompi_osc_rdma_module_fetch_and_op(void *origin_addr,
+                                  void *result_addr,
+                                  struct ompi_datatype_t *dt,
+                                  int target,
+                                  OPAL_PTRDIFF_TYPE target_disp,
+                                  struct ompi_op_t *op,
+                                  ompi_win_t *win)
+{
+    return atomic_internal(OMPI_OSC_RDMA_FOP, origin_addr, NULL, result_addr,
+                           dt, target, target_disp, op, win);
+}
+
+
+int
+ompi_osc_rdma_module_compare_and_swap(void *origin_addr,
+                                      void *compare_addr,
+                                      void *result_addr,
+                                      struct ompi_datatype_t *dt,
+                                      int target,
+                                      OPAL_PTRDIFF_TYPE target_disp,
+                                      ompi_win_t *win)
+{
+    return atomic_internal(OMPI_OSC_RDMA_CSWAP, origin_addr, compare_addr,
+                           result_addr, dt, target, target_disp, NULL, win);
 }
@@ -96,6 +96,22 @@ ompi_osc_rdma_module_t ompi_osc_rdma_module_template = {
 
         ompi_osc_rdma_module_lock,
         ompi_osc_rdma_module_unlock,
+
+        ompi_osc_rdma_module_rput,
+        ompi_osc_rdma_module_rget,
+        ompi_osc_rdma_module_fetch_and_op,
+        ompi_osc_rdma_module_compare_and_swap,
+
+        ompi_osc_rdma_module_lock_all,
+        ompi_osc_rdma_module_unlock_all,
+        ompi_osc_rdma_module_flush,
+        ompi_osc_rdma_module_flush_all,
+        ompi_osc_rdma_module_flush_local,
+        ompi_osc_rdma_module_flush_local_all,
+
+        NULL, /* shared_query */
+        ompi_osc_rdma_module_win_attach,
+        ompi_osc_rdma_module_win_detach,
     }
 };
 
@@ -280,6 +296,9 @@ ompi_osc_rdma_component_query(ompi_win_t *win,
                               ompi_info_t *info,
                               ompi_communicator_t *comm)
 {
+    /* we do not allocate the memory of the window */
+    if (OMPI_WIN_FLAVOR_SHARED == win->w_flavor) return -1;
+
     /* if we inited, then the BMLs are available and we have a path to
        each peer.  Return slightly higher priority than the
        point-to-point code */
@@ -314,6 +333,9 @@ ompi_osc_rdma_component_select(ompi_win_t *win,
     OBJ_CONSTRUCT(&module->m_queued_sendreqs, opal_list_t);
     OBJ_CONSTRUCT(&module->m_locks_pending, opal_list_t);
     OBJ_CONSTRUCT(&module->m_unlocks_pending, opal_list_t);
+    OBJ_CONSTRUCT(&module->m_comm_ranks, opal_hash_table_t);
+    ret = ompi_osc_rdma_regions_init(module);
+    if (OMPI_SUCCESS != ret) goto cleanup;
 
     module->m_win = win;
 
@@ -343,6 +365,7 @@ ompi_osc_rdma_component_select(ompi_win_t *win,
 
     module->m_num_pending_out = 0;
     module->m_num_pending_in = 0;
+    module->m_fence_am_sendreqs = 0;
     module->m_num_post_msgs = 0;
     module->m_num_complete_msgs = 0;
     module->m_tag_counter = 0;
@@ -363,7 +386,10 @@ ompi_osc_rdma_component_select(ompi_win_t *win,
     module->m_eager_send_active = module->m_eager_send_ok;
 
     /* allocate space for rdma information */
-    module->m_use_rdma = check_config_value_bool("use_rdma", info);
+    /* the memory of a dynamic window is not known up front, so it
+       goes through the active message path */
+    module->m_use_rdma = check_config_value_bool("use_rdma", info) &&
+        OMPI_WIN_FLAVOR_DYNAMIC != win->w_flavor;
     module->m_rdma_wait_completion = check_config_value_bool("rdma_completion_wait", info);
     module->m_setup_info = NULL;
     module->m_peer_info = NULL;
@@ -390,7 +416,7 @@ ompi_osc_rdma_component_select(ompi_win_t *win,
     module->m_pw_group = NULL;
     module->m_sc_group = NULL;
     module->m_sc_remote_active_ranks = (bool*)
-        malloc(sizeof(bool) * ompi_comm_size(module->m_comm));
+        calloc(ompi_comm_size(module->m_comm), sizeof(bool));
     if (NULL == module->m_sc_remote_active_ranks) {
         ret = OMPI_ERR_TEMP_OUT_OF_RESOURCE;
         goto cleanup;
@@ -401,11 +427,36 @@ ompi_osc_rdma_component_select(ompi_win_t *win,
         ret = OMPI_ERR_TEMP_OUT_OF_RESOURCE;
         goto cleanup;
     }
+    module->m_post_flags = (int32_t*)
+        calloc(ompi_comm_size(module->m_comm), sizeof(int32_t));
+    if (NULL == module->m_post_flags) {
+        ret = OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+    ret = opal_hash_table_init(&module->m_comm_ranks, ompi_comm_size(module->m_comm));
+    if (OMPI_SUCCESS != ret) goto cleanup;
+    for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
+        opal_hash_table_set_value_uint64(&module->m_comm_ranks,
+                                         (uint64_t) (uintptr_t) ompi_comm_peer_lookup(module->m_comm, i),
+                                         (void*) (intptr_t) i);
+    }
 
     /* lock data */
     module->m_lock_status = 0;
     module->m_shared_count = 0;
-    module->m_lock_received_ack = 0;
+    module->m_passive_num_locks = 0;
+    module->m_passive_lock_granted = (bool*)
+        calloc(ompi_comm_size(module->m_comm), sizeof(bool));
+    if (NULL == module->m_passive_lock_granted) {
+        ret = OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+    module->m_passive_pending_in = (int32_t*)
+        calloc(ompi_comm_size(module->m_comm), sizeof(int32_t));
+    if (NULL == module->m_passive_pending_in) {
+        ret = OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
 
     /* update component data */
     OPAL_THREAD_LOCK(&mca_osc_rdma_component.c_lock);
@@ -452,6 +503,8 @@ ompi_osc_rdma_component_select(ompi_win_t *win,
     return OMPI_SUCCESS;
 
  cleanup:
+    ompi_osc_rdma_regions_fini(module);
+    OBJ_DESTRUCT(&module->m_comm_ranks);
     OBJ_DESTRUCT(&module->m_unlocks_pending);
     OBJ_DESTRUCT(&module->m_locks_pending);
     OBJ_DESTRUCT(&module->m_queued_sendreqs);
@@ -461,12 +514,21 @@ ompi_osc_rdma_component_select(ompi_win_t *win,
     OBJ_DESTRUCT(&module->m_cond);
     OBJ_DESTRUCT(&module->m_lock);
 
+    if (NULL != module->m_passive_pending_in) {
+        free(module->m_passive_pending_in);
+    }
+    if (NULL != module->m_passive_lock_granted) {
+        free(module->m_passive_lock_granted);
+    }
     if (NULL != module->m_sc_remote_ranks) {
         free(module->m_sc_remote_ranks);
     }
     if (NULL != module->m_sc_remote_active_ranks) {
         free(module->m_sc_remote_active_ranks);
     }
+    if (NULL != module->m_post_flags) {
+        free(module->m_post_flags);
+    }
     if (NULL != module->m_fence_coll_counts) {
         free(module->m_fence_coll_counts);
     }
@@ -574,6 +636,39 @@ component_fragment_cb(struct mca_btl_base_module_t *btl,
             }
             break;
 
+        case OMPI_OSC_RDMA_HDR_FOP:
+        case OMPI_OSC_RDMA_HDR_CSWAP:
+            {
+                ompi_osc_rdma_send_header_t *header;
+
+                /* get our header and payload */
+                header = (ompi_osc_rdma_send_header_t*) base_header;
+                payload = (void*) (header + 1);
+
+#if !defined(WORDS_BIGENDIAN) && OPAL_ENABLE_HETEROGENEOUS_SUPPORT
+                if (header->hdr_base.hdr_flags & OMPI_OSC_RDMA_HDR_FLAG_NBO) {
+                    OMPI_OSC_RDMA_SEND_HDR_NTOH(*header);
+                }
+#endif
+
+                /* get our module pointer */
+                module = ompi_osc_rdma_windx_to_module(header->hdr_windx);
+                if (NULL == module) return;
+
+                if (!ompi_win_exposure_epoch(module->m_win)) {
+                    if (OMPI_WIN_FENCE & ompi_win_get_mode(module->m_win)) {
+                        /* well, we're definitely in an access epoch now */
+                        ompi_win_set_mode(module->m_win, 
+                                          OMPI_WIN_FENCE | 
+                                          OMPI_WIN_ACCESS_EPOCH |
+                                          OMPI_WIN_EXPOSE_EPOCH);
+                    }
+                }
+
+                ret = ompi_osc_rdma_sendreq_recv_atomic(module, header, &payload);
+            }
+            break;
+
         case OMPI_OSC_RDMA_HDR_GET:
             {
                 ompi_datatype_t *datatype;
@@ -623,6 +718,10 @@ component_fragment_cb(struct mca_btl_base_module_t *btl,
                                                         header->hdr_target_count,
                                                         datatype,
                                                         &replyreq);
+                if (OMPI_SUCCESS == ret &&
+                    0 != (header->hdr_base.hdr_flags & OMPI_OSC_RDMA_HDR_FLAG_PASSIVE)) {
+                    replyreq->rep_passive_origin = header->hdr_origin;
+                }
 
                 /* send replyreq */
                 ompi_osc_rdma_replyreq_send(module, replyreq);
@@ -672,8 +771,15 @@ component_fragment_cb(struct mca_btl_base_module_t *btl,
                 module = ompi_osc_rdma_windx_to_module(header->hdr_windx);
                 if (NULL == module) return;
 
+                /* raise the flag of the origin.  Only a post a start
+                   is already waiting for counts, the others are
+                   matched by the start they belong to. */
                 OPAL_THREAD_LOCK(&module->m_lock);
-                count = (module->m_num_post_msgs -= 1);
+                if (module->m_post_flags[header->hdr_value[1]]++ < 0) {
+                    count = (module->m_num_post_msgs -= 1);
+                } else {
+                    count = -1;
+                }
                 OPAL_THREAD_UNLOCK(&module->m_lock);
                 if (count == 0) {
                     module->m_eager_send_active = module->m_eager_send_ok;
@@ -743,7 +849,6 @@ component_fragment_cb(struct mca_btl_base_module_t *btl,
             {
                 ompi_osc_rdma_control_header_t *header = 
                     (ompi_osc_rdma_control_header_t*) base_header;
-                int32_t count;
                 payload = (void*) (header + 1);
 
 #if !defined(WORDS_BIGENDIAN) && OPAL_ENABLE_HETEROGENEOUS_SUPPORT
@@ -760,11 +865,12 @@ component_fragment_cb(struct mca_btl_base_module_t *btl,
                     ompi_osc_rdma_passive_lock(module, header->hdr_value[0], 
                                                header->hdr_value[1]);
                 } else {
+                    /* lock granted by the target in value[0] */
                     OPAL_THREAD_LOCK(&module->m_lock);
-                    count = (module->m_lock_received_ack += 1);
+                    module->m_passive_lock_granted[header->hdr_value[0]] = true;
                     OPAL_THREAD_UNLOCK(&module->m_lock);
 
-                    if (count != 0) opal_condition_broadcast(&module->m_cond);
+                    opal_condition_broadcast(&module->m_cond);
                 }
             }
             break;
@@ -790,7 +896,29 @@ component_fragment_cb(struct mca_btl_base_module_t *btl,
             }
             break;
 
+        case OMPI_OSC_RDMA_HDR_FLUSH_REQ:
+            {
+                ompi_osc_rdma_control_header_t *header = 
+                    (ompi_osc_rdma_control_header_t*) base_header;
+                payload = (void*) (header + 1);
+
+#if !defined(WORDS_BIGENDIAN) && OPAL_ENABLE_HETEROGENEOUS_SUPPORT
+                if (header->hdr_base.hdr_flags & OMPI_OSC_RDMA_HDR_FLAG_NBO) {
+                    OMPI_OSC_RDMA_CONTROL_HDR_NTOH(*header);
+                }
+#endif
+
+                /* get our module pointer */
+                module = ompi_osc_rdma_windx_to_module(header->hdr_windx);
+                if (NULL == module) return;
+
+                ompi_osc_rdma_passive_flush(module, header->hdr_value[0],
+                                            header->hdr_value[1]);
+            }
+            break;
+
         case OMPI_OSC_RDMA_HDR_UNLOCK_REPLY:
+        case OMPI_OSC_RDMA_HDR_FLUSH_REPLY:
             {
                 ompi_osc_rdma_control_header_t *header = 
                     (ompi_osc_rdma_control_header_t*) base_header;
@@ -831,10 +959,18 @@ component_fragment_cb(struct mca_btl_base_module_t *btl,
                 module = ompi_osc_rdma_windx_to_module(header->hdr_windx);
                 if (NULL == module) return;
 
-                OPAL_THREAD_LOCK(&module->m_lock);
-                count = (module->m_num_pending_in -= header->hdr_value[0]);
-                OPAL_THREAD_UNLOCK(&module->m_lock);
-                if (count == 0) opal_condition_broadcast(&module->m_cond);
+                if (header->hdr_value[1] < 0) {
+                    OPAL_THREAD_LOCK(&module->m_lock);
+                    count = (module->m_num_pending_in -= header->hdr_value[0]);
+                    OPAL_THREAD_UNLOCK(&module->m_lock);
+                    if (count == 0) opal_condition_broadcast(&module->m_cond);
+                } else {
+                    /* passive target transfers from the origin in value[1] */
+                    OPAL_THREAD_LOCK(&module->m_lock);
+                    count = (module->m_passive_pending_in[header->hdr_value[1]] -= header->hdr_value[0]);
+                    OPAL_THREAD_UNLOCK(&module->m_lock);
+                    if (count == 0) ompi_osc_rdma_passive_unlock_complete(module);
+                }
             }
             break;
 
@@ -863,7 +999,7 @@ component_fragment_cb(struct mca_btl_base_module_t *btl,
 
                 /* find the bml_btl */
                 proc = ompi_comm_peer_lookup(module->m_comm, origin);
-                endpoint = (mca_bml_base_endpoint_t*) proc->proc_bml;
+                endpoint = mca_bml_base_get_endpoint(proc);
                 bml_btl = mca_bml_base_btl_array_find(&endpoint->btl_rdma, btl);
                 if (NULL == bml_btl) {
                     opal_output(ompi_osc_base_framework.framework_output,
@@ -1172,8 +1308,7 @@ setup_rdma(ompi_osc_rdma_module_t *module)
     for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
         ompi_proc_t *proc = ompi_comm_peer_lookup(module->m_comm, i);
         ompi_osc_rdma_peer_info_t *peer_info = &module->m_peer_info[i];
-        mca_bml_base_endpoint_t *endpoint = 
-            (mca_bml_base_endpoint_t*) proc->proc_bml;
+        mca_bml_base_endpoint_t *endpoint = mca_bml_base_get_endpoint(proc);
         int num_avail =
             mca_bml_base_btl_array_get_size(&endpoint->btl_rdma);
         size_t j, size;
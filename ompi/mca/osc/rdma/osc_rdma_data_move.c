@@ -62,17 +62,22 @@ create_send_tag(ompi_osc_rdma_module_t *module)
 }
 
 
+/* passive_origin is the origin of a passive target message, -1 for
+   the other messages */
 static inline void
-inmsg_mark_complete(ompi_osc_rdma_module_t *module)
+inmsg_mark_complete(ompi_osc_rdma_module_t *module, int passive_origin)
 {
     int32_t count;
     bool need_unlock = false;
 
     OPAL_THREAD_LOCK(&module->m_lock);
-    count = (module->m_num_pending_in -= 1);
-    if ((0 != module->m_lock_status) &&
-        (opal_list_get_size(&module->m_unlocks_pending) != 0)) {
-        need_unlock = true;
+    if (passive_origin < 0) {
+        count = (module->m_num_pending_in -= 1);
+    } else {
+        count = (module->m_passive_pending_in[passive_origin] -= 1);
+        if (opal_list_get_size(&module->m_unlocks_pending) != 0) {
+            need_unlock = true;
+        }
     }
     OPAL_THREAD_UNLOCK(&module->m_lock);
 
@@ -82,6 +87,15 @@ inmsg_mark_complete(ompi_osc_rdma_module_t *module)
     }
 }
 
+static inline int
+passive_origin_of(ompi_osc_rdma_send_header_t *header)
+{
+    if (0 != (header->hdr_base.hdr_flags & OMPI_OSC_RDMA_HDR_FLAG_PASSIVE)) {
+        return header->hdr_origin;
+    }
+    return -1;
+}
+
 /**********************************************************************
  *
  * Multi-buffer support
@@ -317,12 +331,15 @@ ompi_osc_rdma_sendreq_send_cb(struct mca_btl_base_module_t* btl,
            a synchronization point in the case of get, as we really
            don't care when it completes - only when the data
            arrives. */
-        if (OMPI_OSC_RDMA_HDR_GET != header->hdr_base.hdr_type) {
 #if !defined(WORDS_BIGENDIAN) && OPAL_ENABLE_HETEROGENEOUS_SUPPORT
-            if (header->hdr_base.hdr_flags & OMPI_OSC_RDMA_HDR_FLAG_NBO) {
-                OMPI_OSC_RDMA_SEND_HDR_NTOH(*header);
-            }
+        if (header->hdr_base.hdr_flags & OMPI_OSC_RDMA_HDR_FLAG_NBO) {
+            OMPI_OSC_RDMA_SEND_HDR_NTOH(*header);
+        }
 #endif
+        /* the atomic operations complete with their reply, as the get */
+        if (OMPI_OSC_RDMA_HDR_GET != header->hdr_base.hdr_type &&
+            OMPI_OSC_RDMA_HDR_FOP != header->hdr_base.hdr_type &&
+            OMPI_OSC_RDMA_HDR_CSWAP != header->hdr_base.hdr_type) {
             /* do we need to post a send? */
             if (header->hdr_msg_length != 0) {
                 /* sendreq is done.  Mark it as so and get out of here */
@@ -425,22 +442,33 @@ ompi_osc_rdma_sendreq_send(ompi_osc_rdma_module_t *module,
     size_t offset;
     size_t needed_len = sizeof(ompi_osc_rdma_send_header_t);
     const void *packed_ddt;
-    size_t packed_ddt_len, remain;
+    size_t packed_ddt_len, remain, atomic_len = 0;
 
     if ((module->m_eager_send_active) && 
         (module->m_use_rdma) &&
         (ompi_datatype_is_contiguous_memory_layout(sendreq->req_target_datatype,
                                               sendreq->req_target_count)) &&
         (!opal_convertor_need_buffers(&sendreq->req_origin_convertor)) &&
-        (sendreq->req_type != OMPI_OSC_RDMA_ACC)) {
+        (sendreq->req_type == OMPI_OSC_RDMA_PUT ||
+         sendreq->req_type == OMPI_OSC_RDMA_GET)) {
         ret = ompi_osc_rdma_sendreq_rdma(module, sendreq);
         if (OPAL_LIKELY(OMPI_SUCCESS == ret)) return ret;
     }
 
+    /* the target has to be told to expect this one */
+    OPAL_THREAD_ADD32(&module->m_fence_am_sendreqs, 1);
+
     /* we always need to send the ddt */
     packed_ddt_len = ompi_datatype_pack_description_length(sendreq->req_target_datatype);
     needed_len += packed_ddt_len;
-    if (OMPI_OSC_RDMA_GET != sendreq->req_type) {
+    if (OMPI_OSC_RDMA_FOP == sendreq->req_type) {
+        atomic_len = sendreq->req_origin_bytes_packed;
+        needed_len += atomic_len;
+    } else if (OMPI_OSC_RDMA_CSWAP == sendreq->req_type) {
+        /* the new value, then the value to compare with */
+        atomic_len = 2 * sendreq->req_origin_bytes_packed;
+        needed_len += atomic_len;
+    } else if (OMPI_OSC_RDMA_GET != sendreq->req_type) {
         needed_len += sendreq->req_origin_bytes_packed;
     }
 
@@ -463,7 +491,7 @@ ompi_osc_rdma_sendreq_send(ompi_osc_rdma_module_t *module,
         }
 
         /* get a buffer... */
-        endpoint = (mca_bml_base_endpoint_t*) sendreq->req_target_proc->proc_bml;
+        endpoint = mca_bml_base_get_endpoint(sendreq->req_target_proc);
         bml_btl = mca_bml_base_btl_array_get_next(&endpoint->btl_eager);
         btl = bml_btl->btl;
         mca_bml_base_alloc(bml_btl, &descriptor, MCA_BTL_NO_ORDER,
@@ -502,6 +530,9 @@ ompi_osc_rdma_sendreq_send(ompi_osc_rdma_module_t *module,
     header->hdr_origin_tag = 0;
     header->hdr_target_disp = sendreq->req_target_disp;
     header->hdr_target_count = sendreq->req_target_count;
+    if (0 != (ompi_win_get_mode(module->m_win) & OMPI_WIN_LOCK_ACCESS)) {
+        header->hdr_base.hdr_flags |= OMPI_OSC_RDMA_HDR_FLAG_PASSIVE;
+    }
 
     switch (sendreq->req_type) {
     case OMPI_OSC_RDMA_PUT:
@@ -520,6 +551,20 @@ ompi_osc_rdma_sendreq_send(ompi_osc_rdma_module_t *module,
         header->hdr_base.hdr_type = OMPI_OSC_RDMA_HDR_GET;
 #if OPAL_ENABLE_MEM_DEBUG
         header->hdr_target_op = 0;
+#endif
+        sendreq->req_refcount++;
+        break;
+
+    case OMPI_OSC_RDMA_FOP:
+        header->hdr_base.hdr_type = OMPI_OSC_RDMA_HDR_FOP;
+        header->hdr_target_op = sendreq->req_op_id;
+        sendreq->req_refcount++;
+        break;
+
+    case OMPI_OSC_RDMA_CSWAP:
+        header->hdr_base.hdr_type = OMPI_OSC_RDMA_HDR_CSWAP;
+#if OPAL_ENABLE_MEM_DEBUG
+        header->hdr_target_op = 0;
 #endif
         sendreq->req_refcount++;
         break;
@@ -532,7 +577,25 @@ ompi_osc_rdma_sendreq_send(ompi_osc_rdma_module_t *module,
            packed_ddt, packed_ddt_len);
     written_data += packed_ddt_len;
 
-    if (OMPI_OSC_RDMA_GET != sendreq->req_type) {
+    if (0 != atomic_len) {
+        /* the operands are single predefined elements, always sent
+           with the header */
+        unsigned char *ptr = (unsigned char*) descriptor->des_src[0].seg_addr.pval +
+            descriptor->des_src[0].seg_len + written_data;
+
+        if (remain < written_data + atomic_len) {
+            ret = MPI_ERR_TRUNCATE;
+            goto cleanup;
+        }
+        memcpy(ptr, sendreq->req_origin_addr, sendreq->req_origin_bytes_packed);
+        if (OMPI_OSC_RDMA_CSWAP == sendreq->req_type) {
+            memcpy(ptr + sendreq->req_origin_bytes_packed, sendreq->req_compare_addr,
+                   sendreq->req_origin_bytes_packed);
+        }
+        written_data += atomic_len;
+        descriptor->des_src[0].seg_len += written_data;
+        header->hdr_msg_length = atomic_len;
+    } else if (OMPI_OSC_RDMA_GET != sendreq->req_type) {
         /* if sending data and it fits, pack payload */
         if (remain >= written_data + sendreq->req_origin_bytes_packed) {
             struct iovec iov;
@@ -654,7 +717,7 @@ ompi_osc_rdma_replyreq_send_long_cb(ompi_request_t *request)
         (ompi_osc_rdma_longreq_t*) request->req_complete_cb_data;
     ompi_osc_rdma_replyreq_t *replyreq = longreq->req_basereq.req_replyreq;
 
-    inmsg_mark_complete(replyreq->rep_module);
+    inmsg_mark_complete(replyreq->rep_module, replyreq->rep_passive_origin);
 
     ompi_osc_rdma_longreq_free(longreq);
     ompi_osc_rdma_replyreq_free(replyreq);
@@ -692,7 +755,7 @@ ompi_osc_rdma_replyreq_send_cb(struct mca_btl_base_module_t* btl,
     /* do we need to post a send? */
     if (header->hdr_msg_length != 0) {
         /* sendreq is done.  Mark it as so and get out of here */
-        inmsg_mark_complete(replyreq->rep_module);
+        inmsg_mark_complete(replyreq->rep_module, replyreq->rep_passive_origin);
         ompi_osc_rdma_replyreq_free(replyreq);
     } else {
             ompi_osc_rdma_longreq_t *longreq;
@@ -727,7 +790,7 @@ ompi_osc_rdma_replyreq_send(ompi_osc_rdma_module_t *module,
     size_t written_data = 0;
         
     /* Get a BTL and a fragment to go with it */
-    endpoint = (mca_bml_base_endpoint_t*) replyreq->rep_origin_proc->proc_bml;
+    endpoint = mca_bml_base_get_endpoint(replyreq->rep_origin_proc);
     bml_btl = mca_bml_base_btl_array_get_next(&endpoint->btl_eager);
     mca_bml_base_alloc(bml_btl, &descriptor, MCA_BTL_NO_ORDER,
             bml_btl->btl->btl_eager_limit, MCA_BTL_DES_FLAGS_PRIORITY | MCA_BTL_DES_SEND_ALWAYS_CALLBACK);
@@ -831,7 +894,7 @@ ompi_osc_rdma_sendreq_recv_put_long_cb(ompi_request_t *request)
                          "%d finished receiving long put message",
                          ompi_comm_rank(longreq->req_module->m_comm))); 
 
-    inmsg_mark_complete(longreq->req_module);
+    inmsg_mark_complete(longreq->req_module, longreq->req_passive_origin);
     ompi_osc_rdma_longreq_free(longreq);
 
     ompi_request_free(&request);
@@ -891,7 +954,7 @@ ompi_osc_rdma_sendreq_recv_put(ompi_osc_rdma_module_t *module,
         );
         OBJ_DESTRUCT(&convertor);
         OBJ_RELEASE(datatype);
-        inmsg_mark_complete(module);
+        inmsg_mark_complete(module, passive_origin_of(header));
         *inbuf = ((char*) *inbuf) + header->hdr_msg_length;
 
         OPAL_OUTPUT_VERBOSE((50, ompi_osc_base_framework.framework_output,
@@ -904,6 +967,7 @@ ompi_osc_rdma_sendreq_recv_put(ompi_osc_rdma_module_t *module,
         ompi_osc_rdma_longreq_alloc(&longreq);
         longreq->req_datatype = datatype;
         longreq->req_module = module;
+        longreq->req_passive_origin = passive_origin_of(header);
 
         ompi_osc_rdma_component_irecv(target,
                                       header->hdr_target_count,
@@ -1008,7 +1072,7 @@ ompi_osc_rdma_sendreq_recv_accum_long_cb(ompi_request_t *request)
     OBJ_RELEASE(longreq->req_datatype);
     OBJ_RELEASE(longreq->req_op);
 
-    inmsg_mark_complete(longreq->req_module);
+    inmsg_mark_complete(longreq->req_module, longreq->req_passive_origin);
 
     ompi_osc_rdma_longreq_free(longreq);
 
@@ -1150,7 +1214,7 @@ ompi_osc_rdma_sendreq_recv_accum(ompi_osc_rdma_module_t *module,
         OBJ_RELEASE(datatype);
         OBJ_RELEASE(op);
 
-        inmsg_mark_complete(module);
+        inmsg_mark_complete(module, passive_origin_of(header));
 
         OPAL_OUTPUT_VERBOSE((50, ompi_osc_base_framework.framework_output,
                              "%d received accum message from %d",
@@ -1178,6 +1242,7 @@ ompi_osc_rdma_sendreq_recv_accum(ompi_osc_rdma_module_t *module,
         longreq->req_datatype = datatype;
         longreq->req_op = op;
         longreq->req_module = module;
+        longreq->req_passive_origin = passive_origin_of(header);
 
         /* allocate a buffer to receive into ... */
         longreq->req_basereq.req_sendhdr = (ompi_osc_rdma_send_header_t *) malloc(buflen + sizeof(ompi_osc_rdma_send_header_t));
@@ -1209,6 +1274,86 @@ ompi_osc_rdma_sendreq_recv_accum(ompi_osc_rdma_module_t *module,
 }
 
 
+/**********************************************************************
+ *
+ * Receive an atomic operation on the target side
+ *
+ **********************************************************************/
+int
+ompi_osc_rdma_sendreq_recv_atomic(ompi_osc_rdma_module_t *module,
+                                  ompi_osc_rdma_send_header_t *header,
+                                  void **payload)
+{
+    int ret;
+    ompi_proc_t *proc = ompi_comm_peer_lookup( module->m_comm, header->hdr_origin );
+    struct ompi_datatype_t *datatype = 
+        ompi_osc_base_datatype_create(proc, payload);
+    ompi_osc_rdma_replyreq_t *replyreq;
+    unsigned char *target_buffer, *buffer, *operand;
+    size_t len;
+
+    if (NULL == datatype) {
+        opal_output(ompi_osc_base_framework.framework_output,
+                    "Error recreating datatype.  Aborting.");
+        ompi_mpi_abort(module->m_comm, 1, false);
+    }
+
+    target_buffer = (unsigned char*) module->m_win->w_baseptr + 
+        ((unsigned long)header->hdr_target_disp * module->m_win->w_disp_unit);
+    operand = (unsigned char*) *payload;
+    ompi_datatype_type_size(datatype, &len);
+
+    /* the previous value goes back to the origin */
+    buffer = (unsigned char*) malloc(len);
+    if (NULL == buffer) {
+        OBJ_RELEASE(datatype);
+        return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    }
+
+    OPAL_THREAD_LOCK(&module->m_acc_lock);
+    memcpy(buffer, target_buffer, len);
+    if (OMPI_OSC_RDMA_HDR_CSWAP == header->hdr_base.hdr_type) {
+        if (0 == memcmp(operand + len, target_buffer, len)) {
+            memcpy(target_buffer, operand, len);
+        }
+    } else {
+        struct ompi_op_t *op = ompi_osc_base_op_create(header->hdr_target_op);
+
+        if (op == &ompi_mpi_op_replace.op) {
+            memcpy(target_buffer, operand, len);
+        } else {
+            (void)ompi_osc_base_process_op(target_buffer, operand, len,
+                                           datatype, 1, op);
+        }
+        OBJ_RELEASE(op);
+    }
+    OPAL_THREAD_UNLOCK(&module->m_acc_lock);
+
+    *payload = ((char*) *payload) + header->hdr_msg_length;
+
+    ret = ompi_osc_rdma_replyreq_alloc(module, header->hdr_origin, &replyreq);
+    if (OMPI_SUCCESS != ret) {
+        free(buffer);
+        OBJ_RELEASE(datatype);
+        return ret;
+    }
+    replyreq->rep_buffer = buffer;
+    replyreq->rep_passive_origin = passive_origin_of(header);
+    ompi_osc_rdma_replyreq_init_target(replyreq, buffer, 1, datatype);
+    ompi_osc_rdma_replyreq_init_origin(replyreq, header->hdr_origin_sendreq);
+
+    /* the replyreq does the right retain, so we can release safely */
+    OBJ_RELEASE(datatype);
+
+    OPAL_OUTPUT_VERBOSE((50, ompi_osc_base_framework.framework_output,
+                         "%d received atomic message from %d",
+                         ompi_comm_rank(module->m_comm),
+                         header->hdr_origin));
+
+    return ompi_osc_rdma_replyreq_send(module, replyreq);
+}
+
+
 /**********************************************************************
  *
  * Recveive a get on the origin side
@@ -1330,7 +1475,7 @@ ompi_osc_rdma_control_send(ompi_osc_rdma_module_t *module,
     ompi_osc_rdma_control_header_t *header = NULL;
         
     /* Get a BTL and a fragment to go with it */
-    endpoint = (mca_bml_base_endpoint_t*) proc->proc_bml;
+    endpoint = mca_bml_base_get_endpoint(proc);
     bml_btl = mca_bml_base_btl_array_get_next(&endpoint->btl_eager);
     mca_bml_base_alloc(bml_btl, &descriptor, MCA_BTL_NO_ORDER,
             sizeof(ompi_osc_rdma_control_header_t),
@@ -1418,7 +1563,9 @@ ompi_osc_rdma_rdma_ack_send(ompi_osc_rdma_module_t *module,
     header->hdr_base.hdr_type = OMPI_OSC_RDMA_HDR_RDMA_COMPLETE;
     header->hdr_base.hdr_flags = 0;
     header->hdr_value[0] = rdma_btl->num_sent;
-    header->hdr_value[1] = 0;
+    /* passive target transfers are counted per origin on the target */
+    header->hdr_value[1] = (0 != (ompi_win_get_mode(module->m_win) & OMPI_WIN_LOCK_ACCESS)) ?
+        ompi_comm_rank(module->m_comm) : -1;
     header->hdr_windx = ompi_comm_get_cid(module->m_comm);
 
 #ifdef WORDS_BIGENDIAN
@@ -41,6 +41,12 @@ int ompi_osc_rdma_sendreq_recv_accum(ompi_osc_rdma_module_t *module,
                                      ompi_osc_rdma_send_header_t *header,
                                      void **payload);
 
+/* receive the target side of a fetch and op or a compare and swap,
+   and send the previous value of the target back */
+int ompi_osc_rdma_sendreq_recv_atomic(ompi_osc_rdma_module_t *module,
+                                      ompi_osc_rdma_send_header_t *header,
+                                      void **payload);
+
 /* receive the origin side of a replyreq (the reply part of an
    MPI_Get), directly into the user's window */
 int ompi_osc_rdma_replyreq_recv(ompi_osc_rdma_module_t *module,
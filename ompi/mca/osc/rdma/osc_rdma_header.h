@@ -27,7 +27,7 @@
 
 #include "opal/types.h"
 
-/* Note -- 0x05 to 0x0C are of control_hdr type */
+/* Note -- 0x05 to 0x0E are of control_hdr type */
 #define OMPI_OSC_RDMA_HDR_PUT           0x01
 #define OMPI_OSC_RDMA_HDR_ACC           0x02
 #define OMPI_OSC_RDMA_HDR_GET           0x03
@@ -40,10 +40,16 @@
 #define OMPI_OSC_RDMA_HDR_RDMA_COMPLETE 0x0A
 #define OMPI_OSC_RDMA_HDR_MULTI_END     0x0B
 #define OMPI_OSC_RDMA_HDR_RDMA_INFO     0x0C
+#define OMPI_OSC_RDMA_HDR_FLUSH_REQ     0x0D
+#define OMPI_OSC_RDMA_HDR_FLUSH_REPLY   0x0E
+#define OMPI_OSC_RDMA_HDR_FOP           0x0F
+#define OMPI_OSC_RDMA_HDR_CSWAP         0x10
 
 #define OMPI_OSC_RDMA_HDR_FLAG_ALIGN_MASK 0x0F
 #define OMPI_OSC_RDMA_HDR_FLAG_NBO        0x10
 #define OMPI_OSC_RDMA_HDR_FLAG_MULTI      0x20
+/* sent in a passive target epoch, counted per origin by the target */
+#define OMPI_OSC_RDMA_HDR_FLAG_PASSIVE    0x40
 
 struct ompi_osc_rdma_base_header_t {
     uint8_t hdr_type;
@@ -42,6 +42,9 @@ struct ompi_osc_rdma_longreq_t {
     /* for long receives, to avoid a longrecvreq type */
     struct ompi_op_t *req_op;
     struct ompi_datatype_t *req_datatype;
+
+    /* origin of a passive target message, -1 otherwise */
+    int req_passive_origin;
 };
 typedef struct ompi_osc_rdma_longreq_t ompi_osc_rdma_longreq_t;
 OBJ_CLASS_DECLARATION(ompi_osc_rdma_longreq_t);
@@ -56,6 +59,7 @@ ompi_osc_rdma_longreq_alloc(ompi_osc_rdma_longreq_t **longreq)
                        item, ret);
 
     *longreq = (ompi_osc_rdma_longreq_t*) item;
+    if (NULL != item) (*longreq)->req_passive_origin = -1;
     return ret;
 }
 
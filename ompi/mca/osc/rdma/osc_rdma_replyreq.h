@@ -50,6 +50,11 @@ struct ompi_osc_rdma_replyreq_t {
     ompi_proc_t *rep_origin_proc;
 
     ompi_ptr_t rep_origin_sendreq;
+
+    /** origin of a passive target get, -1 otherwise */
+    int rep_passive_origin;
+    /** copy of the target data sent back by an atomic operation */
+    void *rep_buffer;
 };
 typedef struct ompi_osc_rdma_replyreq_t ompi_osc_rdma_replyreq_t;
 OBJ_CLASS_DECLARATION(ompi_osc_rdma_replyreq_t);
@@ -87,6 +92,8 @@ ompi_osc_rdma_replyreq_alloc(ompi_osc_rdma_module_t *module,
     (*replyreq)->rep_module = module;
     (*replyreq)->rep_origin_rank = origin_rank;
     (*replyreq)->rep_origin_proc = proc;
+    (*replyreq)->rep_passive_origin = -1;
+    (*replyreq)->rep_buffer = NULL;
 
     return OMPI_SUCCESS;
 }
@@ -135,6 +142,11 @@ ompi_osc_rdma_replyreq_free(ompi_osc_rdma_replyreq_t *replyreq)
 
     OBJ_RELEASE(replyreq->rep_target_datatype);
 
+    if (NULL != replyreq->rep_buffer) {
+        free(replyreq->rep_buffer);
+        replyreq->rep_buffer = NULL;
+    }
+
     OPAL_FREE_LIST_RETURN(&mca_osc_rdma_component.c_replyreqs,
                           (opal_list_item_t*) replyreq);
  
@@ -64,6 +64,39 @@ ompi_osc_rdma_sendreq_alloc_init(ompi_osc_rdma_req_type_t req_type,
 }
 
 
+static int
+ompi_osc_rdma_sendreq_user_free(ompi_request_t **request)
+{
+    ompi_osc_rdma_sendreq_t *sendreq = (ompi_osc_rdma_sendreq_t*) *request;
+
+    sendreq->req_user_request = false;
+    OMPI_REQUEST_FINI(&sendreq->super);
+    ompi_osc_rdma_sendreq_free(sendreq);
+    *request = MPI_REQUEST_NULL;
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_rdma_sendreq_user_init(ompi_osc_rdma_sendreq_t *sendreq,
+                                ompi_request_t **request)
+{
+    OMPI_REQUEST_INIT(&sendreq->super, false);
+    sendreq->super.req_state = OMPI_REQUEST_ACTIVE;
+    sendreq->super.req_status.MPI_SOURCE = MPI_ANY_SOURCE;
+    sendreq->super.req_status.MPI_ERROR = OMPI_SUCCESS;
+    sendreq->super.req_status._cancelled = 0;
+    sendreq->super.req_free = ompi_osc_rdma_sendreq_user_free;
+
+    sendreq->req_user_request = true;
+    sendreq->req_refcount++;
+    *request = &sendreq->super;
+
+    return OMPI_SUCCESS;
+}
+
+
 static void ompi_osc_rdma_sendreq_construct(ompi_osc_rdma_sendreq_t *req)
 {
     req->super.req_type = OMPI_REQUEST_WIN;
@@ -33,7 +33,9 @@
 typedef enum {
     OMPI_OSC_RDMA_GET,
     OMPI_OSC_RDMA_ACC,
-    OMPI_OSC_RDMA_PUT
+    OMPI_OSC_RDMA_PUT,
+    OMPI_OSC_RDMA_FOP,
+    OMPI_OSC_RDMA_CSWAP
 } ompi_osc_rdma_req_type_t;
 
 
@@ -50,7 +52,8 @@ struct ompi_osc_rdma_sendreq_t {
     /** Datatype for the origin side of the operation */
     struct ompi_datatype_t *req_origin_datatype;
     /** Convertor for the origin side of the operation.  Setup for
-        either send (Put / Accumulate) or receive (Get) */
+        either send (Put / Accumulate) or receive (Get, and the result
+        of the atomic operations) */
     opal_convertor_t req_origin_convertor;
     /** packed size of message on the origin side */
     size_t req_origin_bytes_packed;
@@ -70,6 +73,14 @@ struct ompi_osc_rdma_sendreq_t {
     /** op index on the target */
     int req_op_id;
 
+    /** operands of the atomic operations, one element each */
+    void *req_origin_addr;
+    void *req_compare_addr;
+
+    /** the sendreq is also the request returned by MPI_Rput /
+        MPI_Rget, and holds a reference for it */
+    bool req_user_request;
+
     uint8_t remote_segs[MCA_BTL_SEG_MAX_SIZE];
 };
 typedef struct ompi_osc_rdma_sendreq_t ompi_osc_rdma_sendreq_t;
@@ -109,6 +120,9 @@ ompi_osc_rdma_sendreq_alloc(ompi_osc_rdma_module_t *module,
     (*sendreq)->req_target_rank = target_rank;
     (*sendreq)->req_target_proc = proc;
     (*sendreq)->req_refcount = 1;
+    (*sendreq)->req_origin_addr = NULL;
+    (*sendreq)->req_compare_addr = NULL;
+    (*sendreq)->req_user_request = false;
 
     return OMPI_SUCCESS;
 }
@@ -125,7 +139,9 @@ ompi_osc_rdma_sendreq_init_origin(ompi_osc_rdma_sendreq_t *sendreq,
     sendreq->req_origin_datatype = origin_dt;
     sendreq->req_type = req_type;
 
-    if (req_type != OMPI_OSC_RDMA_GET) {
+    if (req_type != OMPI_OSC_RDMA_GET &&
+        req_type != OMPI_OSC_RDMA_FOP &&
+        req_type != OMPI_OSC_RDMA_CSWAP) {
         opal_convertor_copy_and_prepare_for_send(sendreq->req_target_proc->proc_convertor,
                                                  &(origin_dt->super),
                                                  origin_count,
@@ -165,10 +181,22 @@ ompi_osc_rdma_sendreq_init_target(ompi_osc_rdma_sendreq_t *sendreq,
 }
 
 
+/** turn the sendreq into the user request of MPI_Rput / MPI_Rget */
+int ompi_osc_rdma_sendreq_user_init(ompi_osc_rdma_sendreq_t *sendreq,
+                                    struct ompi_request_t **request);
+
 static inline int
 ompi_osc_rdma_sendreq_free(ompi_osc_rdma_sendreq_t *sendreq)
 {
-    if (0 == (--sendreq->req_refcount)) {
+    int refcount = --sendreq->req_refcount;
+
+    if (1 == refcount && sendreq->req_user_request) {
+        /* only the reference of the user is left: the operation is
+           complete at the origin */
+        OPAL_THREAD_LOCK(&ompi_request_lock);
+        ompi_request_complete(&sendreq->super, true);
+        OPAL_THREAD_UNLOCK(&ompi_request_lock);
+    } else if (0 == refcount) {
         MEMCHECKER(
             memchecker_convertor_call(&opal_memchecker_base_mem_defined,
                                       &sendreq->req_origin_convertor);
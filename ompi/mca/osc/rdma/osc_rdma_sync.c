@@ -52,13 +52,44 @@ ompi_osc_rdma_flip_sendreqs(ompi_osc_rdma_module_t *module)
 }
 
 
+/* Put the requests of a failed fence back for the user.  This is
+   not cheap, but the user lost his data if we don't. */
+static void
+ompi_osc_rdma_fence_restore(ompi_osc_rdma_module_t *module)
+{
+    int i;
+
+    OPAL_THREAD_LOCK(&(module->m_lock));
+    opal_list_join(&module->m_pending_sendreqs,
+                   opal_list_get_end(&module->m_pending_sendreqs),
+                   &module->m_copy_pending_sendreqs);
+
+    for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
+        module->m_num_pending_sendreqs[i] +=
+            module->m_copy_num_pending_sendreqs[i];
+    }
+    OPAL_THREAD_UNLOCK(&(module->m_lock));
+}
+
+
+/* When the window does RDMA and waits for its completion locally,
+   every put / get of the epoch is complete at its target once its
+   origin has seen the completion.  If no process sent anything
+   through active messages, a fence is then just that local flush
+   followed by a barrier, and nobody needs to know how many
+   operations to expect.  The barrier is an allreduce of the number
+   of active message sendreqs, so the same collective tells everybody
+   whether the counting protocol is needed after all. */
 int
 ompi_osc_rdma_module_fence(int assert, ompi_win_t *win)
 {
-    unsigned int incoming_reqs;
+    unsigned int incoming_reqs = 0;
     int ret = OMPI_SUCCESS, i, len, started_send;
     ompi_osc_rdma_module_t *module = GET_MODULE(win);
     int num_outgoing = 0;
+    bool rdma_fence = module->m_use_rdma && module->m_rdma_wait_completion;
+    bool counted = false;
+    int local_am, global_am;
 
     if (0 != (assert & MPI_MODE_NOPRECEDE)) {
         /* check that the user didn't lie to us - since NOPRECEDED
@@ -79,33 +110,24 @@ ompi_osc_rdma_module_fence(int assert, ompi_win_t *win)
 
         num_outgoing = opal_list_get_size(&(module->m_copy_pending_sendreqs));
 
-        /* find out how much data everyone is going to send us.  Need
-           to have the lock during this period so that we have a sane
-           view of the number of sendreqs */
-        ret = module->m_comm->
-            c_coll.coll_reduce_scatter(module->m_copy_num_pending_sendreqs,
-                                       &incoming_reqs,
-                                       module->m_fence_coll_counts,
-                                       MPI_UNSIGNED,
-                                       MPI_SUM,
-                                       module->m_comm,
-                                       module->m_comm->c_coll.coll_reduce_scatter_module);
-
-        if (OMPI_SUCCESS != ret) {
-            /* put the stupid data back for the user.  This is not
-               cheap, but the user lost his data if we don't. */
-            OPAL_THREAD_LOCK(&(module->m_lock));
-            opal_list_join(&module->m_pending_sendreqs,
-                           opal_list_get_end(&module->m_pending_sendreqs),
-                           &module->m_copy_pending_sendreqs);
-            
-            for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
-                module->m_num_pending_sendreqs[i] +=
-                    module->m_copy_num_pending_sendreqs[i];
-            }
+        if (!rdma_fence) {
+            /* find out how much data everyone is going to send us.
+               Need to have the lock during this period so that we
+               have a sane view of the number of sendreqs */
+            ret = module->m_comm->
+                c_coll.coll_reduce_scatter(module->m_copy_num_pending_sendreqs,
+                                           &incoming_reqs,
+                                           module->m_fence_coll_counts,
+                                           MPI_UNSIGNED,
+                                           MPI_SUM,
+                                           module->m_comm,
+                                           module->m_comm->c_coll.coll_reduce_scatter_module);
 
-            OPAL_THREAD_UNLOCK(&(module->m_lock));
-            return ret;
+            if (OMPI_SUCCESS != ret) {
+                ompi_osc_rdma_fence_restore(module);
+                return ret;
+            }
+            counted = true;
         }
 
         /* try to start all the requests.  We've copied everything we
@@ -161,10 +183,46 @@ ompi_osc_rdma_module_fence(int assert, ompi_win_t *win)
                 OPAL_THREAD_UNLOCK(&module->m_lock);
             }
 
+            if (rdma_fence) {
+                /* if anything went through active messages (queued
+                   sendreqs that could not all be started count as
+                   such), fall back to counting */
+                local_am = module->m_fence_am_sendreqs +
+                    (int) opal_list_get_size(&module->m_copy_pending_sendreqs);
+                ret = module->m_comm->
+                    c_coll.coll_allreduce(&local_am, &global_am, 1,
+                                          MPI_INT, MPI_MAX,
+                                          module->m_comm,
+                                          module->m_comm->c_coll.coll_allreduce_module);
+                if (OMPI_SUCCESS != ret) {
+                    return ret;
+                }
+
+                if (0 != global_am) {
+                    ret = module->m_comm->
+                        c_coll.coll_reduce_scatter(module->m_copy_num_pending_sendreqs,
+                                                   &incoming_reqs,
+                                                   module->m_fence_coll_counts,
+                                                   MPI_UNSIGNED,
+                                                   MPI_SUM,
+                                                   module->m_comm,
+                                                   module->m_comm->c_coll.coll_reduce_scatter_module);
+                    if (OMPI_SUCCESS != ret) {
+                        return ret;
+                    }
+                    counted = true;
+                }
+            }
+
             for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
                 int j;
                 for (j = 0 ; j < module->m_peer_info[i].peer_num_btls ; ++j) {
                     if (module->m_peer_info[i].peer_btls[j].num_sent > 0) {
+                        if (!counted) {
+                            /* the barrier already told the target */
+                            module->m_peer_info[i].peer_btls[j].num_sent = 0;
+                            continue;
+                        }
                         ret = ompi_osc_rdma_rdma_ack_send(module,
                                                           ompi_comm_peer_lookup(module->m_comm, i),
                                                           &(module->m_peer_info[i].peer_btls[j]));
@@ -206,6 +264,9 @@ ompi_osc_rdma_module_fence(int assert, ompi_win_t *win)
                0 != module->m_num_pending_out) {
             opal_condition_wait(&module->m_cond, &module->m_lock);
         }
+
+        /* a new epoch starts with no active message sendreqs */
+        module->m_fence_am_sendreqs = 0;
         OPAL_THREAD_UNLOCK(&module->m_lock);
     }
 
@@ -227,7 +288,7 @@ ompi_osc_rdma_module_start(ompi_group_t *group,
 {
     int i, ret = OMPI_SUCCESS;
     ompi_osc_rdma_module_t *module = GET_MODULE(win);
-    int32_t count;
+    int32_t count = 0;
 
     OBJ_RETAIN(group);
     ompi_group_increment_proc_count(group);
@@ -241,38 +302,37 @@ ompi_osc_rdma_module_start(ompi_group_t *group,
         ret = MPI_ERR_RMA_SYNC;
         goto clean;
     }
-    module->m_sc_group = group;    
-
-    /* possible we've already received a couple in messages, so
-       add however many we're going to wait for */
-    count = (module->m_num_post_msgs += ompi_group_size(module->m_sc_group));
-    OPAL_THREAD_UNLOCK(&(module->m_lock));
-
-    memset(module->m_sc_remote_active_ranks, 0,
-           sizeof(bool) * ompi_comm_size(module->m_comm));
 
     /* for each process in the specified group, find it's rank in our
-       communicator, store those indexes, and set the true / false in
-       the active ranks table */
+       communicator and store those indexes */
     for (i = 0 ; i < ompi_group_size(group) ; i++) {
-        int comm_rank = -1, j;
-        
-        /* find the rank in the communicator associated with this windows */
-        for (j = 0 ; j < ompi_comm_size(module->m_comm) ; ++j) {
-            if (ompi_group_peer_lookup(module->m_sc_group, i) ==
-                ompi_comm_peer_lookup(module->m_comm, j)) {
-                comm_rank = j;
-                break;
-            }
-        }
-        if (comm_rank == -1) {
+        void *comm_rank;
+
+        if (OPAL_SUCCESS !=
+            opal_hash_table_get_value_uint64(&module->m_comm_ranks,
+                                             (uint64_t) (uintptr_t) ompi_group_peer_lookup(group, i),
+                                             &comm_rank)) {
+            OPAL_THREAD_UNLOCK(&module->m_lock);
             ret = MPI_ERR_RMA_SYNC;
             goto clean;
         }
+        module->m_sc_remote_ranks[i] = (int) (intptr_t) comm_rank;
+    }
+
+    /* set the true / false in the active ranks table and match the
+       posts we already received.  The ones still missing are counted
+       down by the post handler. */
+    for (i = 0 ; i < ompi_group_size(group) ; i++) {
+        int comm_rank = module->m_sc_remote_ranks[i];
 
         module->m_sc_remote_active_ranks[comm_rank] = true;
-        module->m_sc_remote_ranks[i] = comm_rank;
+        if (--module->m_post_flags[comm_rank] < 0) {
+            ++count;
+        }
     }
+    module->m_num_post_msgs = count;
+    module->m_sc_group = group;
+    OPAL_THREAD_UNLOCK(&(module->m_lock));
 
     /* Set our mode to access w/ start */
     ompi_win_remove_mode(win, OMPI_WIN_FENCE);
@@ -381,6 +441,9 @@ ompi_osc_rdma_module_complete(ompi_win_t *win)
 
     group = module->m_sc_group;
     module->m_sc_group = NULL;
+    for (i = 0 ; i < ompi_group_size(group) ; ++i) {
+        module->m_sc_remote_active_ranks[module->m_sc_remote_ranks[i]] = false;
+    }
 
     OPAL_THREAD_UNLOCK(&(module->m_lock));
 
@@ -418,11 +481,12 @@ ompi_osc_rdma_module_post(ompi_group_t *group,
         ompi_group_size(module->m_pw_group);
     OPAL_THREAD_UNLOCK(&(module->m_lock));
 
-    /* send a hello counter to everyone in group */
+    /* raise our post flag at everyone in group */
     for (i = 0 ; i < ompi_group_size(module->m_pw_group) ; ++i) {
         ompi_osc_rdma_control_send(module, 
                                    ompi_group_peer_lookup(group, i),
-                                   OMPI_OSC_RDMA_HDR_POST, 1, 0);
+                                   OMPI_OSC_RDMA_HDR_POST, 1,
+                                   ompi_comm_rank(module->m_comm));
     }    
 
     return OMPI_SUCCESS;
@@ -490,13 +554,163 @@ ompi_osc_rdma_module_test(ompi_win_t *win,
 struct ompi_osc_rdma_pending_lock_t {
     opal_list_item_t super;
     ompi_proc_t *proc;
+    int32_t origin;
     int32_t lock_type;
+    /* for the pending unlocks: the request is a flush, which does not
+       release the lock */
+    bool is_flush;
 };
 typedef struct ompi_osc_rdma_pending_lock_t ompi_osc_rdma_pending_lock_t;
 OBJ_CLASS_INSTANCE(ompi_osc_rdma_pending_lock_t, opal_list_item_t,
                    NULL, NULL);
 
 
+/* start the requests to target that were queued during the epoch. */
+static int
+start_target_sendreqs(ompi_osc_rdma_module_t *module, int target)
+{
+    opal_list_item_t *item, *next;
+    opal_list_t copy;
+    int ret = OMPI_SUCCESS;
+
+    OBJ_CONSTRUCT(&copy, opal_list_t);
+
+    OPAL_THREAD_LOCK(&module->m_lock);
+    for (item = opal_list_get_first(&module->m_pending_sendreqs) ;
+         item != opal_list_get_end(&module->m_pending_sendreqs) ;
+         item = next) {
+        next = opal_list_get_next(item);
+        if (target == ((ompi_osc_rdma_sendreq_t*) item)->req_target_rank) {
+            opal_list_remove_item(&module->m_pending_sendreqs, item);
+            opal_list_append(&copy, item);
+        }
+    }
+    module->m_num_pending_out += (int32_t) opal_list_get_size(&copy);
+    OPAL_THREAD_UNLOCK(&module->m_lock);
+
+    while (NULL != (item = opal_list_remove_first(&copy))) {
+        ret = ompi_osc_rdma_sendreq_send(module, (ompi_osc_rdma_sendreq_t*) item);
+        if (OMPI_ERR_TEMP_OUT_OF_RESOURCE == ret) {
+            opal_list_prepend(&copy, item);
+            ret = OMPI_SUCCESS;
+            break;
+        } else if (OMPI_SUCCESS != ret) {
+            break;
+        }
+    }
+
+    /* if some requests couldn't be started, push into the "queued"
+       list, where we will try to restart them later. */
+    OPAL_THREAD_LOCK(&module->m_lock);
+    if (opal_list_get_size(&copy)) {
+        opal_list_join(&module->m_queued_sendreqs,
+                       opal_list_get_end(&module->m_queued_sendreqs),
+                       &copy);
+    }
+    OPAL_THREAD_UNLOCK(&module->m_lock);
+    OBJ_DESTRUCT(&copy);
+
+    return ret;
+}
+
+
+/* start all the requests to target and tell it how many it has to wait
+   for before replying to the unlock or flush request.  The caller waits
+   for m_num_pending_out to drop to zero. */
+static int
+passive_sync_send(ompi_osc_rdma_module_t *module, int target, uint8_t type)
+{
+    ompi_proc_t *proc = ompi_comm_peer_lookup( module->m_comm, target );
+    int32_t count;
+    int ret, j;
+
+    ret = start_target_sendreqs(module, target);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    if (module->m_use_rdma) {
+        if (module->m_rdma_wait_completion) {
+            OPAL_THREAD_LOCK(&module->m_lock);
+            while (module->m_rdma_num_pending != 0) {
+                opal_condition_wait(&module->m_cond, &module->m_lock);
+            }
+            OPAL_THREAD_UNLOCK(&module->m_lock);
+        }
+
+        for (j = 0 ; j < module->m_peer_info[target].peer_num_btls ; ++j) {
+            if (module->m_peer_info[target].peer_btls[j].num_sent > 0) {
+                ret = ompi_osc_rdma_rdma_ack_send(module, proc,
+                                                  &(module->m_peer_info[target].peer_btls[j]));
+                if (OPAL_LIKELY(OMPI_SUCCESS == ret)) {
+                    module->m_peer_info[target].peer_btls[j].num_sent = 0;
+                } else {
+                    return ret;
+                }
+            }
+        }
+    }
+
+    ompi_osc_rdma_flush(module);
+
+    /* we wait for one more completion event for the control message
+       ack from the target saying it's done */
+    OPAL_THREAD_LOCK(&module->m_lock);
+    count = module->m_num_pending_sendreqs[target];
+    module->m_num_pending_sendreqs[target] = 0;
+    module->m_num_pending_out += 1;
+    OPAL_THREAD_UNLOCK(&module->m_lock);
+
+    OPAL_OUTPUT_VERBOSE((40, ompi_osc_base_framework.framework_output,
+                         "%d sending %s request to %d with %d requests", 
+                         ompi_comm_rank(module->m_comm),
+                         (OMPI_OSC_RDMA_HDR_UNLOCK_REQ == type) ? "unlock" : "flush",
+                         target, count));
+    return ompi_osc_rdma_control_send(module, proc, type,
+                                      ompi_comm_rank(module->m_comm),
+                                      count);
+}
+
+
+static void
+wait_pending_out(ompi_osc_rdma_module_t *module)
+{
+    OPAL_THREAD_LOCK(&module->m_lock);
+    while (0 != module->m_num_pending_out) {
+        opal_condition_wait(&module->m_cond, &module->m_lock);
+    }
+    OPAL_THREAD_UNLOCK(&module->m_lock);
+}
+
+
+/* send the lock request, the caller waits for the grant */
+static int
+lock_request(ompi_osc_rdma_module_t *module, int lock_type, int target)
+{
+    module->m_passive_num_locks++;
+
+    OPAL_OUTPUT_VERBOSE((40, ompi_osc_base_framework.framework_output,
+                         "%d sending lock request to %d", 
+                         ompi_comm_rank(module->m_comm), target));
+    /* generate a lock request */
+    return ompi_osc_rdma_control_send(module, 
+                                      ompi_comm_peer_lookup(module->m_comm, target),
+                                      OMPI_OSC_RDMA_HDR_LOCK_REQ,
+                                      ompi_comm_rank(module->m_comm),
+                                      lock_type);
+}
+
+
+static void
+unlock_done(ompi_osc_rdma_module_t *module, int target)
+{
+    module->m_passive_lock_granted[target] = false;
+    if (0 == --module->m_passive_num_locks) {
+        /* set our mode on the window */
+        ompi_win_remove_mode(module->m_win, OMPI_WIN_ACCESS_EPOCH | OMPI_WIN_LOCK_ACCESS);
+        module->m_eager_send_active = module->m_eager_send_ok;
+    }
+}
+
+
 int
 ompi_osc_rdma_module_lock(int lock_type,
                            int target,
@@ -504,7 +718,7 @@ ompi_osc_rdma_module_lock(int lock_type,
                            ompi_win_t *win)
 {
     ompi_osc_rdma_module_t *module = GET_MODULE(win);
-    ompi_proc_t *proc = ompi_comm_peer_lookup( module->m_comm, target );
+    int ret;
 
     assert(lock_type != 0);
 
@@ -512,29 +726,20 @@ ompi_osc_rdma_module_lock(int lock_type,
     ompi_win_remove_mode(win, OMPI_WIN_FENCE);
     ompi_win_append_mode(win, OMPI_WIN_ACCESS_EPOCH | OMPI_WIN_LOCK_ACCESS);
 
-    OPAL_OUTPUT_VERBOSE((40, ompi_osc_base_framework.framework_output,
-                         "%d sending lock request to %d", 
-                         ompi_comm_rank(module->m_comm), target));
-    /* generate a lock request */
-    ompi_osc_rdma_control_send(module, 
-                               proc,
-                               OMPI_OSC_RDMA_HDR_LOCK_REQ,
-                               ompi_comm_rank(module->m_comm),
-                               lock_type);
+    ret = lock_request(module, lock_type, target);
+    if (OMPI_SUCCESS != ret) return ret;
 
-    module->m_eager_send_active = false;
-
-    if (ompi_comm_rank(module->m_comm) == target) {
-        /* If we're trying to lock locally, have to wait to actually
-           acquire the lock */
-        OPAL_THREAD_LOCK(&module->m_lock);
-        while (module->m_lock_received_ack == 0) {
-            opal_condition_wait(&module->m_cond, &module->m_lock);
-        }
-        OPAL_THREAD_UNLOCK(&module->m_lock);
+    /* wait for the lock, so that the operations of the epoch can go
+       out as soon as they are started, and flush knows where the
+       target stands */
+    OPAL_THREAD_LOCK(&module->m_lock);
+    while (!module->m_passive_lock_granted[target]) {
+        opal_condition_wait(&module->m_cond, &module->m_lock);
     }
+    OPAL_THREAD_UNLOCK(&module->m_lock);
+
+    module->m_eager_send_active = module->m_eager_send_ok;
 
-    /* return */
     return OMPI_SUCCESS;
 }
 
@@ -543,81 +748,141 @@ int
 ompi_osc_rdma_module_unlock(int target,
                              ompi_win_t *win)
 {
-    int32_t out_count;
-    opal_list_item_t *item;
     int ret;
     ompi_osc_rdma_module_t *module = GET_MODULE(win);
-    ompi_proc_t *proc = ompi_comm_peer_lookup( module->m_comm, target );
 
-    OPAL_THREAD_LOCK(&module->m_lock);
-    while (0 == module->m_lock_received_ack) {
-        opal_condition_wait(&module->m_cond, &module->m_lock);
-    }
+    ret = passive_sync_send(module, target, OMPI_OSC_RDMA_HDR_UNLOCK_REQ);
+    if (OMPI_SUCCESS != ret) return ret;
 
-    module->m_lock_received_ack -= 1;
+    /* wait for all the requests and the unlock ack */
+    wait_pending_out(module);
 
-    /* start all the requests */
-    ompi_osc_rdma_flip_sendreqs(module);
+    unlock_done(module, target);
 
-    /* try to start all the requests.  We've copied everything we need
-       out of pending_sendreqs, so don't need the lock here */
-    out_count = opal_list_get_size(&module->m_copy_pending_sendreqs);
+    return OMPI_SUCCESS;
+}
 
-    /* we want to send all the requests, plus we wait for one more
-       completion event for the control message ack from the unlocker
-       saying we're done */
-    module->m_num_pending_out += (out_count + 1);
-    OPAL_THREAD_UNLOCK(&module->m_lock);
 
-    /* send the unlock request */
-    OPAL_OUTPUT_VERBOSE((40, ompi_osc_base_framework.framework_output,
-                         "%d sending unlock request to %d with %d requests", 
-                         ompi_comm_rank(module->m_comm), target,
-                         out_count));
-    ompi_osc_rdma_control_send(module, 
-                               proc,
-                               OMPI_OSC_RDMA_HDR_UNLOCK_REQ,
-                               ompi_comm_rank(module->m_comm),
-                               out_count);
+int
+ompi_osc_rdma_module_lock_all(int assert,
+                              ompi_win_t *win)
+{
+    ompi_osc_rdma_module_t *module = GET_MODULE(win);
+    int i, ret;
 
-    /* try to start all the requests.  We've copied everything we
-       need out of pending_sendreqs, so don't need the lock
-       here */
-    while (NULL != 
-           (item = opal_list_remove_first(&(module->m_copy_pending_sendreqs)))) {
-        ompi_osc_rdma_sendreq_t *req = 
-            (ompi_osc_rdma_sendreq_t*) item;
+    ompi_win_remove_mode(win, OMPI_WIN_FENCE);
+    ompi_win_append_mode(win, OMPI_WIN_ACCESS_EPOCH | OMPI_WIN_LOCK_ACCESS);
 
-        ret = ompi_osc_rdma_sendreq_send(module, req);
-        if (OMPI_ERR_TEMP_OUT_OF_RESOURCE == ret) {
-            opal_list_append(&(module->m_copy_pending_sendreqs), item);
-            break;
-        } else if (OMPI_SUCCESS != ret) {
-            return ret;
+    /* ask everybody first, then wait for the grants */
+    for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
+        ret = lock_request(module, MPI_LOCK_SHARED, i);
+        if (OMPI_SUCCESS != ret) return ret;
+    }
+
+    OPAL_THREAD_LOCK(&module->m_lock);
+    for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
+        while (!module->m_passive_lock_granted[i]) {
+            opal_condition_wait(&module->m_cond, &module->m_lock);
         }
     }
+    OPAL_THREAD_UNLOCK(&module->m_lock);
 
-    ompi_osc_rdma_flush(module);
+    module->m_eager_send_active = module->m_eager_send_ok;
 
-    OPAL_THREAD_LOCK(&module->m_lock);
-    /* if some requests couldn't be started, push into the
-       "queued" list, where we will try to restart them later. */
-    if (opal_list_get_size(&module->m_copy_pending_sendreqs)) {
-        opal_list_join(&module->m_queued_sendreqs,
-                       opal_list_get_end(&module->m_queued_sendreqs),
-                       &module->m_copy_pending_sendreqs);
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_rdma_module_unlock_all(ompi_win_t *win)
+{
+    ompi_osc_rdma_module_t *module = GET_MODULE(win);
+    int i, ret;
+
+    for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
+        if (!module->m_passive_lock_granted[i]) continue;
+        ret = passive_sync_send(module, i, OMPI_OSC_RDMA_HDR_UNLOCK_REQ);
+        if (OMPI_SUCCESS != ret) return ret;
     }
 
-    /* wait for all the requests */
-    while (0 != module->m_num_pending_out) {
-        opal_condition_wait(&module->m_cond, &module->m_lock);
+    wait_pending_out(module);
+
+    for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
+        if (module->m_passive_lock_granted[i]) unlock_done(module, i);
     }
-    OPAL_THREAD_UNLOCK(&module->m_lock);
 
-    /* set our mode on the window */
-    ompi_win_remove_mode(win, OMPI_WIN_ACCESS_EPOCH | OMPI_WIN_LOCK_ACCESS);
+    return OMPI_SUCCESS;
+}
 
-    module->m_eager_send_active = module->m_eager_send_ok;
+
+int
+ompi_osc_rdma_module_flush(int target,
+                           ompi_win_t *win)
+{
+    ompi_osc_rdma_module_t *module = GET_MODULE(win);
+    int ret;
+
+    ret = passive_sync_send(module, target, OMPI_OSC_RDMA_HDR_FLUSH_REQ);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    /* m_num_pending_out is not per target: this also waits for the
+       operations to the other targets started so far */
+    wait_pending_out(module);
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_rdma_module_flush_all(ompi_win_t *win)
+{
+    ompi_osc_rdma_module_t *module = GET_MODULE(win);
+    int i, ret;
+
+    for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
+        if (!module->m_passive_lock_granted[i]) continue;
+        ret = passive_sync_send(module, i, OMPI_OSC_RDMA_HDR_FLUSH_REQ);
+        if (OMPI_SUCCESS != ret) return ret;
+    }
+
+    wait_pending_out(module);
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_rdma_module_flush_local(int target,
+                                 ompi_win_t *win)
+{
+    ompi_osc_rdma_module_t *module = GET_MODULE(win);
+    int ret;
+
+    /* local completion only: the sends are done when the origin
+       buffers can be reused, the gets when the data arrived */
+    ret = start_target_sendreqs(module, target);
+    if (OMPI_SUCCESS != ret) return ret;
+    ompi_osc_rdma_flush(module);
+
+    wait_pending_out(module);
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_rdma_module_flush_local_all(ompi_win_t *win)
+{
+    ompi_osc_rdma_module_t *module = GET_MODULE(win);
+    int i, ret;
+
+    for (i = 0 ; i < ompi_comm_size(module->m_comm) ; ++i) {
+        ret = start_target_sendreqs(module, i);
+        if (OMPI_SUCCESS != ret) return ret;
+    }
+    ompi_osc_rdma_flush(module);
+
+    wait_pending_out(module);
 
     return OMPI_SUCCESS;
 }
@@ -645,6 +910,7 @@ ompi_osc_rdma_passive_lock(ompi_osc_rdma_module_t *module,
                                  origin, lock_type));
             new_pending = OBJ_NEW(ompi_osc_rdma_pending_lock_t);
             new_pending->proc = proc;
+            new_pending->origin = origin;
             new_pending->lock_type = lock_type;
             opal_list_append(&(module->m_locks_pending), &(new_pending->super));
         }
@@ -661,6 +927,7 @@ ompi_osc_rdma_passive_lock(ompi_osc_rdma_module_t *module,
                                  origin, lock_type));
             new_pending = OBJ_NEW(ompi_osc_rdma_pending_lock_t);
             new_pending->proc = proc;
+            new_pending->origin = origin;
             new_pending->lock_type = lock_type;
             opal_list_append(&(module->m_locks_pending), &(new_pending->super));
         }
@@ -681,10 +948,11 @@ ompi_osc_rdma_passive_lock(ompi_osc_rdma_module_t *module,
 }
 
 
-int
-ompi_osc_rdma_passive_unlock(ompi_osc_rdma_module_t *module,
-                             int32_t origin,
-                             int32_t count)
+static int
+passive_sync_recv(ompi_osc_rdma_module_t *module,
+                  int32_t origin,
+                  int32_t count,
+                  bool is_flush)
 {
     ompi_proc_t *proc = ompi_comm_peer_lookup( module->m_comm, origin );
     ompi_osc_rdma_pending_lock_t *new_pending = NULL;
@@ -692,14 +960,16 @@ ompi_osc_rdma_passive_unlock(ompi_osc_rdma_module_t *module,
     assert(module->m_lock_status != 0);
 
     OPAL_OUTPUT_VERBOSE((40, ompi_osc_base_framework.framework_output,
-                         "received unlock request from %d with %d requests\n",
-                         origin, count));
+                         "received %s request from %d with %d requests\n",
+                         is_flush ? "flush" : "unlock", origin, count));
 
     new_pending = OBJ_NEW(ompi_osc_rdma_pending_lock_t);
     new_pending->proc = proc;
+    new_pending->origin = origin;
     new_pending->lock_type = 0;
+    new_pending->is_flush = is_flush;
     OPAL_THREAD_LOCK(&(module->m_lock));
-    module->m_num_pending_in += count;
+    module->m_passive_pending_in[origin] += count;
     opal_list_append(&module->m_unlocks_pending, &(new_pending->super));
     OPAL_THREAD_UNLOCK(&(module->m_lock));
 
@@ -707,73 +977,99 @@ ompi_osc_rdma_passive_unlock(ompi_osc_rdma_module_t *module,
 }
 
 
+int
+ompi_osc_rdma_passive_unlock(ompi_osc_rdma_module_t *module,
+                             int32_t origin,
+                             int32_t count)
+{
+    return passive_sync_recv(module, origin, count, false);
+}
+
+
+int
+ompi_osc_rdma_passive_flush(ompi_osc_rdma_module_t *module,
+                            int32_t origin,
+                            int32_t count)
+{
+    return passive_sync_recv(module, origin, count, true);
+}
+
+
 int
 ompi_osc_rdma_passive_unlock_complete(ompi_osc_rdma_module_t *module)
 {
     ompi_osc_rdma_pending_lock_t *new_pending = NULL;
-    opal_list_t copy_unlock_acks;
+    opal_list_item_t *item, *next;
+    opal_list_t copy_unlock_acks, copy_lock_acks;
+    bool released = false;
 
-    if (module->m_num_pending_in != 0) return OMPI_SUCCESS;
+    OBJ_CONSTRUCT(&copy_unlock_acks, opal_list_t);
+    OBJ_CONSTRUCT(&copy_lock_acks, opal_list_t);
 
     OPAL_THREAD_LOCK(&module->m_lock);
-    if (module->m_num_pending_in != 0) {
-        OPAL_THREAD_UNLOCK(&module->m_lock);
-        return OMPI_SUCCESS;
+    /* copy over the unlocks and flushes whose origin has no message
+       left in flight */
+    for (item = opal_list_get_first(&module->m_unlocks_pending) ;
+         item != opal_list_get_end(&module->m_unlocks_pending) ;
+         item = next) {
+        next = opal_list_get_next(item);
+        new_pending = (ompi_osc_rdma_pending_lock_t*) item;
+        if (0 != module->m_passive_pending_in[new_pending->origin]) continue;
+
+        opal_list_remove_item(&module->m_unlocks_pending, item);
+        opal_list_append(&copy_unlock_acks, item);
+        if (new_pending->is_flush) continue;
+
+        if (module->m_lock_status == MPI_LOCK_EXCLUSIVE) {
+            module->m_lock_status = 0;
+        } else if (0 == --module->m_shared_count) {
+            module->m_lock_status = 0;
+        }
+        released = true;
     }
 
-    if (module->m_lock_status == MPI_LOCK_EXCLUSIVE) {
+    /* if we were really unlocked, see if we have other lock requests
+       we can satisfy: the next exclusive one, or all the shared ones
+       in front of the queue */
+    if (released && 0 == module->m_lock_status) {
         ompi_win_remove_mode(module->m_win, OMPI_WIN_EXPOSE_EPOCH);
-        module->m_lock_status = 0;
-    } else {
-        module->m_shared_count -= opal_list_get_size(&module->m_unlocks_pending);
-        if (module->m_shared_count == 0) {
-            ompi_win_remove_mode(module->m_win, OMPI_WIN_EXPOSE_EPOCH);
-            module->m_lock_status = 0;
+        while (NULL != (item = opal_list_get_first(&module->m_locks_pending)) &&
+               item != opal_list_get_end(&module->m_locks_pending)) {
+            new_pending = (ompi_osc_rdma_pending_lock_t*) item;
+            if (MPI_LOCK_EXCLUSIVE == new_pending->lock_type &&
+                0 != module->m_lock_status) {
+                break;
+            }
+            opal_list_remove_item(&module->m_locks_pending, item);
+            opal_list_append(&copy_lock_acks, item);
+            /* set lock state and generate a lock request */
+            module->m_lock_status = new_pending->lock_type;
+            if (MPI_LOCK_EXCLUSIVE == new_pending->lock_type) break;
+            module->m_shared_count++;
+        }
+        if (0 != module->m_lock_status) {
+            ompi_win_append_mode(module->m_win, OMPI_WIN_EXPOSE_EPOCH);
         }
     }
-
-    OBJ_CONSTRUCT(&copy_unlock_acks, opal_list_t);
-    /* copy over any unlocks that have been satisfied (possibly
-       multiple if SHARED) */
-    opal_list_join(&copy_unlock_acks,
-                   opal_list_get_end(&copy_unlock_acks),
-                   &module->m_unlocks_pending);
     OPAL_THREAD_UNLOCK(&module->m_lock);
 
     /* issue whichever unlock acks we should issue */
     while (NULL != (new_pending = (ompi_osc_rdma_pending_lock_t*)
                     opal_list_remove_first(&copy_unlock_acks))) {
         OPAL_OUTPUT_VERBOSE((40, ompi_osc_base_framework.framework_output,
-                             "sending unlock reply to proc"));
+                             "sending %s reply to proc",
+                             new_pending->is_flush ? "flush" : "unlock"));
         ompi_osc_rdma_control_send(module,
                                    new_pending->proc,
+                                   new_pending->is_flush ?
+                                   OMPI_OSC_RDMA_HDR_FLUSH_REPLY :
                                    OMPI_OSC_RDMA_HDR_UNLOCK_REPLY,
                                    OMPI_SUCCESS, OMPI_SUCCESS);
         OBJ_RELEASE(new_pending);
     }
 
-    OBJ_DESTRUCT(&copy_unlock_acks);
-
-    /* if we were really unlocked, see if we have another lock request
-       we can satisfy */
-    OPAL_THREAD_LOCK(&(module->m_lock));
-    if (0 == module->m_lock_status) {
-        new_pending = (ompi_osc_rdma_pending_lock_t*) 
-            opal_list_remove_first(&(module->m_locks_pending));
-        if (NULL != new_pending) {
-            ompi_win_append_mode(module->m_win, OMPI_WIN_EXPOSE_EPOCH);
-            /* set lock state and generate a lock request */
-            module->m_lock_status = new_pending->lock_type;
-            if (MPI_LOCK_SHARED == new_pending->lock_type) {
-                module->m_shared_count++;
-            }
-        }
-    } else {
-        new_pending = NULL;
-    }
-    OPAL_THREAD_UNLOCK(&(module->m_lock));
-
-    if (NULL != new_pending) {
+    while (NULL != (new_pending = (ompi_osc_rdma_pending_lock_t*)
+                    opal_list_remove_first(&copy_lock_acks))) {
         OPAL_OUTPUT_VERBOSE((40, ompi_osc_base_framework.framework_output,
                              "sending lock request to proc"));
         ompi_osc_rdma_control_send(module,
@@ -784,5 +1080,8 @@ ompi_osc_rdma_passive_unlock_complete(ompi_osc_rdma_module_t *module)
         OBJ_RELEASE(new_pending);
     }
 
+    OBJ_DESTRUCT(&copy_unlock_acks);
+    OBJ_DESTRUCT(&copy_lock_acks);
+
     return OMPI_SUCCESS;
 }
@@ -0,0 +1,228 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * One-sided communication in shared memory, for the windows of
+ * MPI_WIN_ALLOCATE_SHARED.  The memory of all the processes of the
+ * window is in a single opal/mca/shmem segment mapped by each of them,
+ * so the communication calls are plain loads and stores (under a
+ * per-target spin lock for the accumulates and atomics) and the
+ * synchronization only needs memory barriers and counters in the
+ * segment.
+ *
+ * The segment starts with the state of each process (lock, counters
+ * of the active target synchronization), followed by the memory of
+ * the processes in rank order.  By default the memory is contiguous
+ * across ranks as required by MPI; with the alloc_shared_noncontig
+ * info key the memory of each process starts on a page boundary.
+ * Each process touches its own part first, bound to its NUMA node
+ * when hwloc knows it, so the pages follow the placement of the
+ * processes.
+ */
+
+#ifndef OMPI_OSC_SM_H
+#define OMPI_OSC_SM_H
+
+#include "ompi_config.h"
+#include "opal/sys/atomic.h"
+#include "opal/mca/shmem/base/base.h"
+
+#include "ompi/win/win.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/group/group.h"
+#include "ompi/mca/osc/osc.h"
+
+BEGIN_C_DECLS
+
+/* state of a process, in the shared segment */
+struct ompi_osc_sm_node_state_t {
+    /** -1 when locked exclusive, else the number of shared lockers */
+    volatile int32_t lock_counter;
+    /** number of MPI_WIN_COMPLETE received for the current
+        exposure epoch */
+    volatile int32_t complete_count;
+    /** serializes the accumulates and atomics to this process */
+    opal_atomic_lock_t accumulate_lock;
+};
+typedef struct ompi_osc_sm_node_state_t ompi_osc_sm_node_state_t;
+
+struct ompi_osc_sm_component_t {
+    /** Extend the basic osc component interface */
+    ompi_osc_base_component_t super;
+};
+typedef struct ompi_osc_sm_component_t ompi_osc_sm_component_t;
+OMPI_DECLSPEC extern ompi_osc_sm_component_t mca_osc_sm_component;
+
+struct ompi_osc_sm_module_t {
+    /** Extend the basic osc module interface */
+    ompi_osc_base_module_t super;
+
+    /** private communicator for the window */
+    ompi_communicator_t *comm;
+
+    /** the shared segment */
+    opal_shmem_ds_t seg_ds;
+    unsigned char *segment_base;
+
+    /** size, displacement unit and base of the memory of each process */
+    size_t *sizes;
+    int *disp_units;
+    unsigned char **bases;
+
+    /** state of each process */
+    ompi_osc_sm_node_state_t **node_states;
+    /** post_counts[i * size + j]: number of MPI_WIN_POST from j to i
+        not matched by a MPI_WIN_START yet */
+    volatile int32_t *post_counts;
+
+    /** active target synchronization */
+    ompi_group_t *start_group;
+    int *start_ranks;
+    bool *start_active;
+    ompi_group_t *post_group;
+
+    /** lock type held on each process, 0 if none, negative for
+        the epochs opened with MPI_MODE_NOCHECK */
+    int *outstanding_locks;
+};
+typedef struct ompi_osc_sm_module_t ompi_osc_sm_module_t;
+
+#define GET_MODULE(win) ((ompi_osc_sm_module_t*) win->w_osc_module)
+
+/* address of the target_disp in the memory of target */
+static inline void*
+ompi_osc_sm_target_addr(ompi_osc_sm_module_t *module, int target,
+                        OPAL_PTRDIFF_TYPE target_disp)
+{
+    return module->bases[target] + target_disp * module->disp_units[target];
+}
+
+
+/*
+ * Module interface function types 
+ */
+int ompi_osc_sm_module_free(struct ompi_win_t *win);
+
+int ompi_osc_sm_module_put(void *origin_addr,
+                           int origin_count,
+                           struct ompi_datatype_t *origin_dt,
+                           int target,
+                           OPAL_PTRDIFF_TYPE target_disp,
+                           int target_count,
+                           struct ompi_datatype_t *target_dt,
+                           struct ompi_win_t *win);
+
+int ompi_osc_sm_module_accumulate(void *origin_addr,
+                                  int origin_count,
+                                  struct ompi_datatype_t *origin_dt,
+                                  int target,
+                                  OPAL_PTRDIFF_TYPE target_disp,
+                                  int target_count,
+                                  struct ompi_datatype_t *target_dt,
+                                  struct ompi_op_t *op,
+                                  struct ompi_win_t *win);
+
+int ompi_osc_sm_module_get(void *origin_addr,
+                           int origin_count,
+                           struct ompi_datatype_t *origin_dt,
+                           int target,
+                           OPAL_PTRDIFF_TYPE target_disp,
+                           int target_count,
+                           struct ompi_datatype_t *target_dt,
+                           struct ompi_win_t *win);
+
+int ompi_osc_sm_module_rput(void *origin_addr,
+                            int origin_count,
+                            struct ompi_datatype_t *origin_dt,
+                            int target,
+                            OPAL_PTRDIFF_TYPE target_disp,
+                            int target_count,
+                            struct ompi_datatype_t *target_dt,
+                            struct ompi_win_t *win,
+                            struct ompi_request_t **request);
+
+int ompi_osc_sm_module_rget(void *origin_addr,
+                            int origin_count,
+                            struct ompi_datatype_t *origin_dt,
+                            int target,
+                            OPAL_PTRDIFF_TYPE target_disp,
+                            int target_count,
+                            struct ompi_datatype_t *target_dt,
+                            struct ompi_win_t *win,
+                            struct ompi_request_t **request);
+
+int ompi_osc_sm_module_fetch_and_op(void *origin_addr,
+                                    void *result_addr,
+                                    struct ompi_datatype_t *dt,
+                                    int target,
+                                    OPAL_PTRDIFF_TYPE target_disp,
+                                    struct ompi_op_t *op,
+                                    struct ompi_win_t *win);
+
+int ompi_osc_sm_module_compare_and_swap(void *origin_addr,
+                                        void *compare_addr,
+                                        void *result_addr,
+                                        struct ompi_datatype_t *dt,
+                                        int target,
+                                        OPAL_PTRDIFF_TYPE target_disp,
+                                        struct ompi_win_t *win);
+
+int ompi_osc_sm_module_fence(int assert, struct ompi_win_t *win);
+
+int ompi_osc_sm_module_start(struct ompi_group_t *group,
+                             int assert,
+                             struct ompi_win_t *win);
+
+int ompi_osc_sm_module_complete(struct ompi_win_t *win);
+
+int ompi_osc_sm_module_post(struct ompi_group_t *group,
+                            int assert,
+                            struct ompi_win_t *win);
+
+int ompi_osc_sm_module_wait(struct ompi_win_t *win);
+
+int ompi_osc_sm_module_test(struct ompi_win_t *win,
+                            int *flag);
+
+int ompi_osc_sm_module_lock(int lock_type,
+                            int target,
+                            int assert,
+                            struct ompi_win_t *win);
+
+int ompi_osc_sm_module_unlock(int target,
+                              struct ompi_win_t *win);
+
+int ompi_osc_sm_module_lock_all(int assert,
+                                struct ompi_win_t *win);
+
+int ompi_osc_sm_module_unlock_all(struct ompi_win_t *win);
+
+int ompi_osc_sm_module_flush(int target,
+                             struct ompi_win_t *win);
+
+int ompi_osc_sm_module_flush_all(struct ompi_win_t *win);
+
+int ompi_osc_sm_module_flush_local(int target,
+                                   struct ompi_win_t *win);
+
+int ompi_osc_sm_module_flush_local_all(struct ompi_win_t *win);
+
+int ompi_osc_sm_module_shared_query(struct ompi_win_t *win,
+                                    int rank,
+                                    size_t *size,
+                                    int *disp_unit,
+                                    void *baseptr);
+
+END_C_DECLS
+
+#endif /* OMPI_OSC_SM_H */
@@ -0,0 +1,282 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "osc_sm.h"
+
+#include "opal/datatype/opal_convertor.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/request/request.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/osc/base/osc_base_obj_convert.h"
+
+/* All the operations complete before returning: the data is moved by
+   the calling process, directly to or from the memory of the target. */
+
+static inline int
+check_epoch(ompi_osc_sm_module_t *module, int target, ompi_win_t *win)
+{
+    if ((OMPI_WIN_STARTED & ompi_win_get_mode(win)) &&
+        (!module->start_active[target])) {
+        return MPI_ERR_RMA_SYNC;
+    }
+
+    if (OMPI_WIN_FENCE & ompi_win_get_mode(win)) {
+        /* well, we're definitely in an access epoch now */
+        ompi_win_set_mode(win, OMPI_WIN_FENCE | OMPI_WIN_ACCESS_EPOCH |
+                          OMPI_WIN_EXPOSE_EPOCH);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_put(void *origin_addr,
+                       int origin_count,
+                       struct ompi_datatype_t *origin_dt,
+                       int target,
+                       OPAL_PTRDIFF_TYPE target_disp,
+                       int target_count,
+                       struct ompi_datatype_t *target_dt,
+                       struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    int ret;
+
+    ret = check_epoch(module, target, win);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    /* shortcut 0 count case */
+    if (0 == origin_count || 0 == target_count) {
+        return OMPI_SUCCESS;
+    }
+
+    return ompi_datatype_sndrcv(origin_addr, origin_count, origin_dt,
+                                ompi_osc_sm_target_addr(module, target, target_disp),
+                                target_count, target_dt);
+}
+
+
+int
+ompi_osc_sm_module_get(void *origin_addr,
+                       int origin_count,
+                       struct ompi_datatype_t *origin_dt,
+                       int target,
+                       OPAL_PTRDIFF_TYPE target_disp,
+                       int target_count,
+                       struct ompi_datatype_t *target_dt,
+                       struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    int ret;
+
+    ret = check_epoch(module, target, win);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    /* shortcut 0 count case */
+    if (0 == origin_count || 0 == target_count) {
+        return OMPI_SUCCESS;
+    }
+
+    return ompi_datatype_sndrcv(ompi_osc_sm_target_addr(module, target, target_disp),
+                                target_count, target_dt,
+                                origin_addr, origin_count, origin_dt);
+}
+
+
+int
+ompi_osc_sm_module_rput(void *origin_addr,
+                        int origin_count,
+                        struct ompi_datatype_t *origin_dt,
+                        int target,
+                        OPAL_PTRDIFF_TYPE target_disp,
+                        int target_count,
+                        struct ompi_datatype_t *target_dt,
+                        struct ompi_win_t *win,
+                        struct ompi_request_t **request)
+{
+    int ret;
+
+    ret = ompi_osc_sm_module_put(origin_addr, origin_count, origin_dt,
+                                 target, target_disp, target_count,
+                                 target_dt, win);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    /* already complete */
+    *request = &ompi_request_empty;
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_rget(void *origin_addr,
+                        int origin_count,
+                        struct ompi_datatype_t *origin_dt,
+                        int target,
+                        OPAL_PTRDIFF_TYPE target_disp,
+                        int target_count,
+                        struct ompi_datatype_t *target_dt,
+                        struct ompi_win_t *win,
+                        struct ompi_request_t **request)
+{
+    int ret;
+
+    ret = ompi_osc_sm_module_get(origin_addr, origin_count, origin_dt,
+                                 target, target_disp, target_count,
+                                 target_dt, win);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    /* already complete */
+    *request = &ompi_request_empty;
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_accumulate(void *origin_addr,
+                              int origin_count,
+                              struct ompi_datatype_t *origin_dt,
+                              int target,
+                              OPAL_PTRDIFF_TYPE target_disp,
+                              int target_count,
+                              struct ompi_datatype_t *target_dt,
+                              struct ompi_op_t *op,
+                              struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    void *target_addr = ompi_osc_sm_target_addr(module, target, target_disp);
+    void *packed = NULL, *inbuf;
+    size_t packed_size;
+    int ret;
+
+    ret = check_epoch(module, target, win);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    /* shortcut 0 count case */
+    if (0 == origin_count || 0 == target_count) {
+        return OMPI_SUCCESS;
+    }
+
+    if (&ompi_mpi_op_replace.op == op) {
+        opal_atomic_lock(&module->node_states[target]->accumulate_lock);
+        ret = ompi_datatype_sndrcv(origin_addr, origin_count, origin_dt,
+                                   target_addr, target_count, target_dt);
+        opal_atomic_unlock(&module->node_states[target]->accumulate_lock);
+        return ret;
+    }
+
+    /* the op is applied to a contiguous buffer of the origin data, as
+       if it had been received from the origin */
+    opal_datatype_type_size(&origin_dt->super, &packed_size);
+    packed_size *= origin_count;
+    if (opal_datatype_is_contiguous_memory_layout(&origin_dt->super, origin_count)) {
+        inbuf = (char*) origin_addr + origin_dt->super.true_lb;
+    } else {
+        opal_convertor_t convertor;
+        struct iovec iov;
+        uint32_t iov_count = 1;
+        size_t max_data = packed_size;
+
+        packed = malloc(packed_size);
+        if (NULL == packed) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+
+        OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+        ret = opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor,
+                                                       &origin_dt->super, origin_count,
+                                                       origin_addr, 0, &convertor);
+        if (OMPI_SUCCESS == ret) {
+            iov.iov_base = (IOVBASE_TYPE*) packed;
+            iov.iov_len = packed_size;
+            ret = opal_convertor_pack(&convertor, &iov, &iov_count, &max_data);
+            ret = (ret < 0) ? OMPI_ERROR : OMPI_SUCCESS;
+        }
+        OBJ_DESTRUCT(&convertor);
+        if (OMPI_SUCCESS != ret) {
+            free(packed);
+            return ret;
+        }
+        inbuf = packed;
+    }
+
+    opal_atomic_lock(&module->node_states[target]->accumulate_lock);
+    ret = ompi_osc_base_process_op(target_addr, inbuf, packed_size,
+                                   target_dt, target_count, op);
+    opal_atomic_unlock(&module->node_states[target]->accumulate_lock);
+
+    if (NULL != packed) free(packed);
+
+    return ret;
+}
+
+
+int
+ompi_osc_sm_module_fetch_and_op(void *origin_addr,
+                                void *result_addr,
+                                struct ompi_datatype_t *dt,
+                                int target,
+                                OPAL_PTRDIFF_TYPE target_disp,
+                                struct ompi_op_t *op,
+                                struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    void *target_addr = ompi_osc_sm_target_addr(module, target, target_disp);
+    int ret;
+
+    ret = check_epoch(module, target, win);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    /* dt is predefined, so one element is dt->super.size contiguous bytes */
+    opal_atomic_lock(&module->node_states[target]->accumulate_lock);
+    memcpy(result_addr, target_addr, dt->super.size);
+    if (&ompi_mpi_op_replace.op == op) {
+        memcpy(target_addr, origin_addr, dt->super.size);
+    } else {
+        ompi_op_reduce(op, origin_addr, target_addr, 1, dt);
+    }
+    opal_atomic_unlock(&module->node_states[target]->accumulate_lock);
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_compare_and_swap(void *origin_addr,
+                                    void *compare_addr,
+                                    void *result_addr,
+                                    struct ompi_datatype_t *dt,
+                                    int target,
+                                    OPAL_PTRDIFF_TYPE target_disp,
+                                    struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    void *target_addr = ompi_osc_sm_target_addr(module, target, target_disp);
+    int ret;
+
+    ret = check_epoch(module, target, win);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    opal_atomic_lock(&module->node_states[target]->accumulate_lock);
+    memcpy(result_addr, target_addr, dt->super.size);
+    if (0 == memcmp(compare_addr, target_addr, dt->super.size)) {
+        memcpy(target_addr, origin_addr, dt->super.size);
+    }
+    opal_atomic_unlock(&module->node_states[target]->accumulate_lock);
+
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,396 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "osc_sm.h"
+
+#include "opal/align.h"
+#include "opal/runtime/opal.h"
+#include "opal/util/output.h"
+#include "opal/mca/hwloc/hwloc.h"
+
+#include "ompi/info/info.h"
+#include "ompi/proc/proc.h"
+#include "ompi/mca/rte/rte.h"
+#include "ompi/mca/osc/osc.h"
+#include "ompi/mca/osc/base/base.h"
+
+static int component_init(bool enable_progress_threads,
+                          bool enable_mpi_threads);
+static int component_finalize(void);
+static int component_query(ompi_win_t *win,
+                           ompi_info_t *info,
+                           ompi_communicator_t *comm);
+static int component_select(ompi_win_t *win,
+                            ompi_info_t *info,
+                            ompi_communicator_t *comm);
+
+ompi_osc_sm_component_t mca_osc_sm_component = {
+    { /* ompi_osc_base_component_t */
+        { /* ompi_base_component_t */
+            OMPI_OSC_BASE_VERSION_2_0_0,
+            "sm",
+            OMPI_MAJOR_VERSION,  /* MCA component major version */
+            OMPI_MINOR_VERSION,  /* MCA component minor version */
+            OMPI_RELEASE_VERSION,  /* MCA component release version */
+            NULL,
+            NULL,
+            NULL,
+            NULL
+        },
+        { /* mca_base_component_data */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        },
+        component_init,
+        component_query,
+        component_select,
+        component_finalize
+    }
+};
+
+
+static ompi_osc_sm_module_t ompi_osc_sm_module_template = {
+    {
+        ompi_osc_sm_module_free,
+
+        ompi_osc_sm_module_put,
+        ompi_osc_sm_module_get,
+        ompi_osc_sm_module_accumulate,
+
+        ompi_osc_sm_module_fence,
+
+        ompi_osc_sm_module_start,
+        ompi_osc_sm_module_complete,
+        ompi_osc_sm_module_post,
+        ompi_osc_sm_module_wait,
+        ompi_osc_sm_module_test,
+
+        ompi_osc_sm_module_lock,
+        ompi_osc_sm_module_unlock,
+
+        ompi_osc_sm_module_rput,
+        ompi_osc_sm_module_rget,
+        ompi_osc_sm_module_fetch_and_op,
+        ompi_osc_sm_module_compare_and_swap,
+
+        ompi_osc_sm_module_lock_all,
+        ompi_osc_sm_module_unlock_all,
+        ompi_osc_sm_module_flush,
+        ompi_osc_sm_module_flush_all,
+        ompi_osc_sm_module_flush_local,
+        ompi_osc_sm_module_flush_local_all,
+
+        ompi_osc_sm_module_shared_query,
+    }
+};
+
+
+static int
+component_init(bool enable_progress_threads,
+               bool enable_mpi_threads)
+{
+    return OMPI_SUCCESS;
+}
+
+
+static int
+component_finalize(void)
+{
+    return OMPI_SUCCESS;
+}
+
+
+static int
+component_query(ompi_win_t *win,
+                ompi_info_t *info,
+                ompi_communicator_t *comm)
+{
+    int i;
+
+    /* we only do the windows we allocate ourselves */
+    if (OMPI_WIN_FLAVOR_SHARED != win->w_flavor) return -1;
+
+    for (i = 0 ; i < ompi_comm_size(comm) ; ++i) {
+        ompi_proc_t *proc = ompi_comm_peer_lookup(comm, i);
+        if (!OPAL_PROC_ON_LOCAL_NODE(proc->proc_flags)) return -1;
+    }
+
+    return 100;
+}
+
+
+/* Touch the local memory of the window first, so that its pages are
+   placed on our NUMA node.  If we are bound, ask hwloc to bind the
+   memory there explicitly. */
+static void
+place_local_memory(void *base, size_t size)
+{
+    if (0 == size) return;
+
+#if OPAL_HAVE_HWLOC
+    if (ompi_rte_proc_is_bound && NULL != opal_hwloc_topology) {
+        hwloc_bitmap_t cpuset = hwloc_bitmap_alloc();
+
+        if (NULL != cpuset) {
+            if (0 == hwloc_get_cpubind(opal_hwloc_topology, cpuset, 0)) {
+                /* failures only lose the placement */
+                (void) hwloc_set_area_membind(opal_hwloc_topology, base, size, cpuset,
+                                              HWLOC_MEMBIND_BIND, 0);
+            }
+            hwloc_bitmap_free(cpuset);
+        }
+    }
+#endif
+
+    memset(base, 0, size);
+}
+
+
+static int
+component_select(ompi_win_t *win,
+                 ompi_info_t *info,
+                 ompi_communicator_t *comm)
+{
+    ompi_osc_sm_module_t *module = NULL;
+    int ret, i, rank, size, flag, failed;
+    size_t pagesize = (size_t) getpagesize();
+    size_t state_size, my_size = win->w_size, total;
+    bool noncontig = false;
+    char *file_name;
+
+    /* create module structure */
+    module = (ompi_osc_sm_module_t*)
+        calloc(1, sizeof(ompi_osc_sm_module_t));
+    if (NULL == module) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+
+    /* fill in the function pointer part */
+    memcpy(module, &ompi_osc_sm_module_template, 
+           sizeof(ompi_osc_base_module_t));
+
+    ret = ompi_comm_dup(comm, &module->comm);
+    if (OMPI_SUCCESS != ret) goto cleanup;
+
+    rank = ompi_comm_rank(module->comm);
+    size = ompi_comm_size(module->comm);
+
+    opal_output_verbose(1, ompi_osc_base_framework.framework_output,
+                        "sm component creating window with id %d",
+                        ompi_comm_get_cid(module->comm));
+
+    module->sizes = (size_t*) malloc(sizeof(size_t) * size);
+    module->disp_units = (int*) malloc(sizeof(int) * size);
+    module->bases = (unsigned char**) malloc(sizeof(unsigned char*) * size);
+    module->node_states = (ompi_osc_sm_node_state_t**)
+        malloc(sizeof(ompi_osc_sm_node_state_t*) * size);
+    module->start_ranks = (int*) malloc(sizeof(int) * size);
+    module->start_active = (bool*) calloc(size, sizeof(bool));
+    module->outstanding_locks = (int*) calloc(size, sizeof(int));
+    if (NULL == module->sizes || NULL == module->disp_units ||
+        NULL == module->bases || NULL == module->node_states ||
+        NULL == module->start_ranks || NULL == module->start_active ||
+        NULL == module->outstanding_locks) {
+        ret = OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+
+    /* everybody needs the layout of the whole window */
+    ret = module->comm->c_coll.coll_allgather(&my_size, sizeof(size_t), MPI_BYTE,
+                                              module->sizes, sizeof(size_t), MPI_BYTE,
+                                              module->comm,
+                                              module->comm->c_coll.coll_allgather_module);
+    if (OMPI_SUCCESS != ret) goto cleanup;
+    ret = module->comm->c_coll.coll_allgather(&win->w_disp_unit, 1, MPI_INT,
+                                              module->disp_units, 1, MPI_INT,
+                                              module->comm,
+                                              module->comm->c_coll.coll_allgather_module);
+    if (OMPI_SUCCESS != ret) goto cleanup;
+
+    if (OMPI_SUCCESS != ompi_info_get_bool(info, "alloc_shared_noncontig",
+                                           &noncontig, &flag) || 0 == flag) {
+        noncontig = false;
+    }
+
+    /* the states, each on its own cache line, and the post counters.
+       The memory of the processes starts on the next page (the shmem
+       header is at the beginning of the mapping, which is page
+       aligned) */
+    state_size = OPAL_ALIGN(sizeof(ompi_osc_sm_node_state_t), opal_cache_line_size, size_t) * size +
+        sizeof(int32_t) * size * size;
+    total = OPAL_ALIGN(sizeof(opal_shmem_seg_hdr_t) + state_size, pagesize, size_t) -
+        sizeof(opal_shmem_seg_hdr_t);
+    for (i = 0 ; i < size ; ++i) {
+        total += noncontig ? OPAL_ALIGN(module->sizes[i], pagesize, size_t) : module->sizes[i];
+    }
+
+    /* the first process creates the segment, the others attach to it */
+    if (0 == rank) {
+        if (0 > asprintf(&file_name, "%s"OPAL_PATH_SEP"osc_sm.%s.%lu.%d",
+                         ompi_process_info.job_session_dir, ompi_process_info.nodename,
+                         (unsigned long) OMPI_PROC_MY_NAME->vpid,
+                         ompi_comm_get_cid(module->comm))) {
+            ret = OMPI_ERR_OUT_OF_RESOURCE;
+        } else {
+            ret = opal_shmem_segment_create(&module->seg_ds, file_name, total);
+            free(file_name);
+        }
+    }
+    failed = (0 == rank && OMPI_SUCCESS != ret);
+    ret = module->comm->c_coll.coll_bcast(&failed, 1, MPI_INT, 0, module->comm,
+                                          module->comm->c_coll.coll_bcast_module);
+    if (OMPI_SUCCESS != ret) goto cleanup;
+    if (failed) {
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+    ret = module->comm->c_coll.coll_bcast(&module->seg_ds, sizeof(opal_shmem_ds_t), MPI_BYTE,
+                                          0, module->comm,
+                                          module->comm->c_coll.coll_bcast_module);
+    if (OMPI_SUCCESS != ret) goto cleanup;
+
+    module->segment_base = (unsigned char*) opal_shmem_segment_attach(&module->seg_ds);
+    failed = (NULL == module->segment_base);
+
+    if (!failed) {
+        unsigned char *ptr = module->segment_base;
+
+        for (i = 0 ; i < size ; ++i) {
+            module->node_states[i] = (ompi_osc_sm_node_state_t*) ptr;
+            ptr += OPAL_ALIGN(sizeof(ompi_osc_sm_node_state_t), opal_cache_line_size, size_t);
+        }
+        module->post_counts = (volatile int32_t*) ptr;
+
+        ptr = module->segment_base +
+            OPAL_ALIGN(sizeof(opal_shmem_seg_hdr_t) + state_size, pagesize, size_t) -
+            sizeof(opal_shmem_seg_hdr_t);
+        for (i = 0 ; i < size ; ++i) {
+            module->bases[i] = (0 == module->sizes[i]) ? NULL : ptr;
+            ptr += noncontig ? OPAL_ALIGN(module->sizes[i], pagesize, size_t) : module->sizes[i];
+        }
+
+        /* the segment is zeroed by the creation, only the lock needs
+           an explicit initialization */
+        opal_atomic_init(&module->node_states[rank]->accumulate_lock, OPAL_ATOMIC_UNLOCKED);
+        place_local_memory(module->bases[rank], module->sizes[rank]);
+        opal_atomic_wmb();
+    }
+
+    /* wait for everybody to be attached (and initialized) before
+       removing the backing file */
+    ret = module->comm->c_coll.coll_allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX,
+                                              module->comm,
+                                              module->comm->c_coll.coll_allreduce_module);
+    if (0 == rank) {
+        (void) opal_shmem_unlink(&module->seg_ds);
+    }
+    if (OMPI_SUCCESS != ret) goto cleanup;
+    if (failed) {
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+
+    /* fill in window information */
+    win->w_baseptr = module->bases[rank];
+    win->w_osc_module = (ompi_osc_base_module_t*) module;
+
+    return OMPI_SUCCESS;
+
+ cleanup:
+    if (NULL != module->segment_base) {
+        (void) opal_shmem_segment_detach(&module->seg_ds);
+    }
+    if (NULL != module->outstanding_locks) free(module->outstanding_locks);
+    if (NULL != module->start_active) free(module->start_active);
+    if (NULL != module->start_ranks) free(module->start_ranks);
+    if (NULL != module->node_states) free(module->node_states);
+    if (NULL != module->bases) free(module->bases);
+    if (NULL != module->disp_units) free(module->disp_units);
+    if (NULL != module->sizes) free(module->sizes);
+    if (NULL != module->comm) ompi_comm_free(&module->comm);
+    free(module);
+
+    return ret;
+}
+
+
+int
+ompi_osc_sm_module_shared_query(struct ompi_win_t *win,
+                                int rank,
+                                size_t *size,
+                                int *disp_unit,
+                                void *baseptr)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    int i;
+
+    /* MPI_PROC_NULL: the first process with some memory */
+    if (MPI_PROC_NULL == rank) {
+        for (i = 0 ; i < ompi_comm_size(module->comm) ; ++i) {
+            if (0 != module->sizes[i]) {
+                rank = i;
+                break;
+            }
+        }
+        if (MPI_PROC_NULL == rank) {
+            *size = 0;
+            *disp_unit = 0;
+            *((void**) baseptr) = NULL;
+            return OMPI_SUCCESS;
+        }
+    }
+
+    *size = module->sizes[rank];
+    *disp_unit = module->disp_units[rank];
+    *((void**) baseptr) = module->bases[rank];
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_free(struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    int ret = OMPI_SUCCESS;
+
+    opal_output_verbose(1, ompi_osc_base_framework.framework_output,
+                        "sm component destroying window with id %d",
+                        ompi_comm_get_cid(module->comm));
+
+    /* nobody may still be accessing our memory */
+    if (ompi_comm_size(module->comm) > 1) {
+        ret = module->comm->c_coll.coll_barrier(module->comm,
+                                                module->comm->c_coll.coll_barrier_module);
+    }
+
+    win->w_osc_module = NULL;
+
+    (void) opal_shmem_segment_detach(&module->seg_ds);
+
+    if (NULL != module->start_group) OBJ_RELEASE(module->start_group);
+    if (NULL != module->post_group) OBJ_RELEASE(module->post_group);
+    free(module->outstanding_locks);
+    free(module->start_active);
+    free(module->start_ranks);
+    free(module->node_states);
+    free(module->bases);
+    free(module->disp_units);
+    free(module->sizes);
+    ompi_comm_free(&module->comm);
+    free(module);
+
+    return ret;
+}
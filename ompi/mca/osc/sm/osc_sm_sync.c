@@ -0,0 +1,406 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "osc_sm.h"
+
+#include "opal/runtime/opal_progress.h"
+#include "ompi/group/group.h"
+
+/* The data movement is synchronous, so the synchronization calls only
+   have to order the memory accesses and wait on the counters of the
+   other processes. */
+
+int
+ompi_osc_sm_module_fence(int assert, struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    int ret = OMPI_SUCCESS;
+
+    /* can't enter an active target epoch when in a passive one */
+    if (0 != (ompi_win_get_mode(win) & OMPI_WIN_LOCK_ACCESS)) {
+        return MPI_ERR_RMA_SYNC;
+    }
+
+    opal_atomic_mb();
+    if (0 == (assert & MPI_MODE_NOPRECEDE) || 0 == (assert & MPI_MODE_NOSUCCEED)) {
+        ret = module->comm->c_coll.coll_barrier(module->comm,
+                                                module->comm->c_coll.coll_barrier_module);
+    }
+
+    if (0 == (assert & MPI_MODE_NOSUCCEED)) {
+        ompi_win_set_mode(win, OMPI_WIN_FENCE);
+    } else {
+        ompi_win_set_mode(win, 0);
+    }
+
+    return ret;
+}
+
+
+/* window ranks of the processes of group */
+static int
+group_ranks(ompi_osc_sm_module_t *module, ompi_group_t *group, int *ranks)
+{
+    int i, ret, *tmp;
+
+    tmp = (int*) malloc(sizeof(int) * ompi_group_size(group));
+    if (NULL == tmp) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    for (i = 0 ; i < ompi_group_size(group) ; ++i) {
+        tmp[i] = i;
+    }
+
+    ret = ompi_group_translate_ranks(group, ompi_group_size(group), tmp,
+                                     module->comm->c_local_group, ranks);
+    free(tmp);
+
+    return ret;
+}
+
+
+int
+ompi_osc_sm_module_start(struct ompi_group_t *group,
+                         int assert,
+                         struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    int i, ret, rank = ompi_comm_rank(module->comm);
+    int size = ompi_comm_size(module->comm);
+
+    OBJ_RETAIN(group);
+    ompi_group_increment_proc_count(group);
+    module->start_group = group;
+
+    ret = group_ranks(module, group, module->start_ranks);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    /* wait for the post of each target, unless the user says it
+       already happened */
+    for (i = 0 ; i < ompi_group_size(group) ; ++i) {
+        int target = module->start_ranks[i];
+
+        if (0 == (assert & MPI_MODE_NOCHECK)) {
+            volatile int32_t *count = &module->post_counts[rank * size + target];
+
+            while (0 == *count) {
+                opal_progress();
+            }
+            opal_atomic_add_32(count, -1);
+        }
+        module->start_active[target] = true;
+    }
+    opal_atomic_mb();
+
+    ompi_win_remove_mode(win, OMPI_WIN_FENCE);
+    ompi_win_append_mode(win, OMPI_WIN_ACCESS_EPOCH | OMPI_WIN_STARTED);
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_complete(struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    ompi_group_t *group = module->start_group;
+    int i;
+
+    /* our accesses are done before the targets can see the count */
+    opal_atomic_mb();
+    for (i = 0 ; i < ompi_group_size(group) ; ++i) {
+        int target = module->start_ranks[i];
+
+        opal_atomic_add_32(&module->node_states[target]->complete_count, 1);
+        module->start_active[target] = false;
+    }
+
+    module->start_group = NULL;
+    ompi_group_decrement_proc_count(group);
+    OBJ_RELEASE(group);
+
+    ompi_win_remove_mode(win, OMPI_WIN_ACCESS_EPOCH | OMPI_WIN_STARTED);
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_post(struct ompi_group_t *group,
+                        int assert,
+                        struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    int i, ret, *ranks, rank = ompi_comm_rank(module->comm);
+    int size = ompi_comm_size(module->comm);
+
+    OBJ_RETAIN(group);
+    ompi_group_increment_proc_count(group);
+    module->post_group = group;
+
+    ompi_win_remove_mode(win, OMPI_WIN_FENCE);
+    ompi_win_append_mode(win, OMPI_WIN_EXPOSE_EPOCH | OMPI_WIN_POSTED);
+
+    if (0 != (assert & MPI_MODE_NOCHECK)) return OMPI_SUCCESS;
+
+    ranks = (int*) malloc(sizeof(int) * ompi_group_size(group));
+    if (NULL == ranks) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    ret = group_ranks(module, group, ranks);
+    if (OMPI_SUCCESS != ret) {
+        free(ranks);
+        return ret;
+    }
+
+    /* the local accesses to our memory are done before the origins
+       start theirs */
+    opal_atomic_mb();
+    for (i = 0 ; i < ompi_group_size(group) ; ++i) {
+        opal_atomic_add_32(&module->post_counts[ranks[i] * size + rank], 1);
+    }
+    free(ranks);
+
+    return OMPI_SUCCESS;
+}
+
+
+static bool
+post_done(ompi_osc_sm_module_t *module, bool blocking)
+{
+    volatile int32_t *count =
+        &module->node_states[ompi_comm_rank(module->comm)]->complete_count;
+    int32_t expected = ompi_group_size(module->post_group);
+
+    while (*count < expected) {
+        if (!blocking) return false;
+        opal_progress();
+    }
+    opal_atomic_add_32(count, -expected);
+    opal_atomic_mb();
+
+    ompi_group_decrement_proc_count(module->post_group);
+    OBJ_RELEASE(module->post_group);
+    module->post_group = NULL;
+
+    return true;
+}
+
+
+int
+ompi_osc_sm_module_wait(struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+
+    (void) post_done(module, true);
+
+    ompi_win_remove_mode(win, OMPI_WIN_EXPOSE_EPOCH | OMPI_WIN_POSTED);
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_test(struct ompi_win_t *win,
+                        int *flag)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+
+    if (!post_done(module, false)) {
+        *flag = 0;
+        opal_progress();
+        return OMPI_SUCCESS;
+    }
+
+    *flag = 1;
+
+    ompi_win_remove_mode(win, OMPI_WIN_EXPOSE_EPOCH | OMPI_WIN_POSTED);
+
+    return OMPI_SUCCESS;
+}
+
+
+static void
+lock_acquire(ompi_osc_sm_module_t *module, int lock_type, int target)
+{
+    volatile int32_t *counter = &module->node_states[target]->lock_counter;
+    int32_t value;
+
+    if (MPI_LOCK_EXCLUSIVE == lock_type) {
+        while (!opal_atomic_cmpset_acq_32(counter, 0, -1)) {
+            opal_progress();
+        }
+    } else {
+        while (1) {
+            value = *counter;
+            if (value >= 0 && opal_atomic_cmpset_acq_32(counter, value, value + 1)) break;
+            opal_progress();
+        }
+    }
+}
+
+
+static void
+lock_release(ompi_osc_sm_module_t *module, int lock_type, int target)
+{
+    volatile int32_t *counter = &module->node_states[target]->lock_counter;
+
+    /* our accesses are done before the next locker can see the lock */
+    opal_atomic_mb();
+    if (MPI_LOCK_EXCLUSIVE == lock_type) {
+        *counter = 0;
+        opal_atomic_wmb();
+    } else {
+        opal_atomic_add_32(counter, -1);
+    }
+}
+
+
+int
+ompi_osc_sm_module_lock(int lock_type,
+                        int target,
+                        int assert,
+                        struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+
+    /* with MPI_MODE_NOCHECK, no conflicting lock can be held: only
+       remember the epoch, with a negative lock type */
+    if (0 == (assert & MPI_MODE_NOCHECK)) {
+        lock_acquire(module, lock_type, target);
+        module->outstanding_locks[target] = lock_type;
+    } else {
+        module->outstanding_locks[target] = -lock_type;
+    }
+
+    ompi_win_remove_mode(win, OMPI_WIN_FENCE);
+    ompi_win_append_mode(win, OMPI_WIN_ACCESS_EPOCH | OMPI_WIN_LOCK_ACCESS);
+
+    return OMPI_SUCCESS;
+}
+
+
+static void
+unlock_target(ompi_osc_sm_module_t *module, int target)
+{
+    if (0 < module->outstanding_locks[target]) {
+        lock_release(module, module->outstanding_locks[target], target);
+    } else {
+        opal_atomic_mb();
+    }
+    module->outstanding_locks[target] = 0;
+}
+
+
+static bool
+holds_locks(ompi_osc_sm_module_t *module)
+{
+    int i;
+
+    for (i = 0 ; i < ompi_comm_size(module->comm) ; ++i) {
+        if (0 != module->outstanding_locks[i]) return true;
+    }
+    return false;
+}
+
+
+int
+ompi_osc_sm_module_unlock(int target,
+                          struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+
+    unlock_target(module, target);
+
+    if (!holds_locks(module)) {
+        ompi_win_remove_mode(win, OMPI_WIN_ACCESS_EPOCH | OMPI_WIN_LOCK_ACCESS);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_lock_all(int assert,
+                            struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    int i;
+
+    for (i = 0 ; i < ompi_comm_size(module->comm) ; ++i) {
+        if (0 == (assert & MPI_MODE_NOCHECK)) {
+            lock_acquire(module, MPI_LOCK_SHARED, i);
+            module->outstanding_locks[i] = MPI_LOCK_SHARED;
+        } else {
+            module->outstanding_locks[i] = -MPI_LOCK_SHARED;
+        }
+    }
+
+    ompi_win_remove_mode(win, OMPI_WIN_FENCE);
+    ompi_win_append_mode(win, OMPI_WIN_ACCESS_EPOCH | OMPI_WIN_LOCK_ACCESS);
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_unlock_all(struct ompi_win_t *win)
+{
+    ompi_osc_sm_module_t *module = GET_MODULE(win);
+    int i;
+
+    for (i = 0 ; i < ompi_comm_size(module->comm) ; ++i) {
+        unlock_target(module, i);
+    }
+
+    ompi_win_remove_mode(win, OMPI_WIN_ACCESS_EPOCH | OMPI_WIN_LOCK_ACCESS);
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_flush(int target,
+                         struct ompi_win_t *win)
+{
+    opal_atomic_mb();
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_flush_all(struct ompi_win_t *win)
+{
+    opal_atomic_mb();
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_flush_local(int target,
+                               struct ompi_win_t *win)
+{
+    opal_atomic_mb();
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_osc_sm_module_flush_local_all(struct ompi_win_t *win)
+{
+    opal_atomic_mb();
+
+    return OMPI_SUCCESS;
+}
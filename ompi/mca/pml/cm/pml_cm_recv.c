@@ -16,6 +16,10 @@
 
 #include "ompi_config.h"
 
+#ifdef HAVE_ALLOCA_H
+#include <alloca.h>
+#endif
+
 #include "opal/prefetch.h"
 
 #include "ompi/request/request.h"
@@ -82,6 +86,19 @@ mca_pml_cm_irecv(void *addr,
 }
 
 
+/*
+ * Completion of the blocking receive: its request lives on the stack of
+ * the waiting thread, there is nothing to return.
+ */
+static void
+mca_pml_cm_recv_fast_completion(struct mca_mtl_request_t *mtl_request)
+{
+    OPAL_THREAD_LOCK(&ompi_request_lock);
+    ompi_request_complete(mtl_request->ompi_req, true);
+    OPAL_THREAD_UNLOCK(&ompi_request_lock);
+}
+
+
 int
 mca_pml_cm_recv(void *addr,
                 size_t count,
@@ -94,33 +111,46 @@ mca_pml_cm_recv(void *addr,
     int ret;
     mca_pml_cm_thin_recv_request_t *recvreq;
     ompi_proc_t* ompi_proc;
-    
-    MCA_PML_CM_THIN_RECV_REQUEST_ALLOC(recvreq);
-    if( OPAL_UNLIKELY(NULL == recvreq) ) return OMPI_ERR_OUT_OF_RESOURCE;
 
-    MCA_PML_CM_THIN_RECV_REQUEST_INIT(recvreq,
-                                      ompi_proc,
-                                      comm, 
-                                      src,
-                                      datatype,
-                                      addr,
-                                      count);
-    
-    
-    MCA_PML_CM_THIN_RECV_REQUEST_START(recvreq, comm, tag, src, ret);
-    if( OPAL_UNLIKELY(OMPI_SUCCESS != ret) ) {
-        /* BWB - XXX - need cleanup of request here */
-        MCA_PML_CM_THIN_RECV_REQUEST_RETURN(recvreq);
-        return ret;
+    /* The caller waits for the request, and the communicator and the
+     * datatype cannot go away meanwhile: keep the request on the stack,
+     * out of the free list and without reference counting. */
+    recvreq = (mca_pml_cm_thin_recv_request_t *)
+        alloca(sizeof(mca_pml_cm_thin_recv_request_t) + ompi_mtl->mtl_request_size);
+    recvreq->req_base.req_pml_type = MCA_PML_CM_REQUEST_RECV_THIN;
+    recvreq->req_mtl.ompi_req = (ompi_request_t*) recvreq;
+    recvreq->req_mtl.completion_callback = mca_pml_cm_recv_fast_completion;
+
+    OMPI_REQUEST_INIT(&recvreq->req_base.req_ompi, false);
+    recvreq->req_base.req_ompi.req_complete_cb = NULL;
+    recvreq->req_base.req_ompi.req_mpi_object.comm = comm;
+    recvreq->req_base.req_free_called = false;
+    recvreq->req_base.req_comm = comm;
+    recvreq->req_base.req_datatype = datatype;
+
+    if( MPI_ANY_SOURCE == src ) {
+        ompi_proc = ompi_proc_local_proc;
+    } else {
+        ompi_proc = ompi_comm_peer_lookup( comm, src );
     }
+    OBJ_CONSTRUCT(&recvreq->req_base.req_convertor, opal_convertor_t);
+    opal_convertor_copy_and_prepare_for_recv(ompi_proc->proc_convertor,
+                                             &(datatype->super),
+                                             count,
+                                             addr,
+                                             0,
+                                             &recvreq->req_base.req_convertor);
 
-    ompi_request_wait_completion(&recvreq->req_base.req_ompi);
+    MCA_PML_CM_THIN_RECV_REQUEST_START(recvreq, comm, tag, src, ret);
+    if( OPAL_LIKELY(OMPI_SUCCESS == ret) ) {
+        ompi_request_wait_completion(&recvreq->req_base.req_ompi);
 
-    if (NULL != status) {  /* return status */
-        *status = recvreq->req_base.req_ompi.req_status;
+        if (NULL != status) {  /* return status */
+            *status = recvreq->req_base.req_ompi.req_status;
+        }
+        ret = recvreq->req_base.req_ompi.req_status.MPI_ERROR;
     }
-    ret = recvreq->req_base.req_ompi.req_status.MPI_ERROR;
-    ompi_request_free( (ompi_request_t**)&recvreq );
+    OBJ_DESTRUCT(&recvreq->req_base.req_convertor);
 
     return ret;
 }
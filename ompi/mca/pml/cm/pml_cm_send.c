@@ -150,31 +150,29 @@ mca_pml_cm_send(void *buf,
         
         ompi_request_free( (ompi_request_t**)&sendreq );
     } else { 
-        mca_pml_cm_thin_send_request_t *sendreq;
-        ompi_proc_t * ompi_proc;
-        MCA_PML_CM_THIN_SEND_REQUEST_ALLOC(sendreq, comm, dst, ompi_proc);
-        if (OPAL_UNLIKELY(NULL == sendreq)) return OMPI_ERR_OUT_OF_RESOURCE;
-        
-        MCA_PML_CM_THIN_SEND_REQUEST_INIT(sendreq,
-                                          ompi_proc,
-                                          comm,
-                                          tag,
-                                          dst, 
-                                          datatype,
-                                          sendmode,
-                                          buf,
-                                          count);
-        MCA_PML_CM_SEND_REQUEST_START_SETUP((&sendreq->req_send));
-            
+        /* The MTL send is blocking, so no request is needed: skip the
+         * free list, the reference counts on the communicator and the
+         * datatype, and the completion under ompi_request_lock. For a
+         * contiguous datatype preparing the convertor is only a few
+         * assignments. */
+        opal_convertor_t convertor;
+        ompi_proc_t * ompi_proc = ompi_comm_peer_lookup(comm, dst);
+        if (OPAL_UNLIKELY(NULL == ompi_proc)) return OMPI_ERR_OUT_OF_RESOURCE;
+
+        OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+        opal_convertor_copy_and_prepare_for_send(ompi_proc->proc_convertor,
+                                                 &(datatype->super),
+                                                 count,
+                                                 buf,
+                                                 0,
+                                                 &convertor);
         ret = OMPI_MTL_CALL(send(ompi_mtl,                             
                                  comm, 
                                  dst, 
                                  tag,  
-                                 &sendreq->req_send.req_base.req_convertor,
+                                 &convertor,
                                  sendmode));
-        /* Allow a quick path for the request return */
-        sendreq->req_send.req_base.req_free_called = true;
-        MCA_PML_CM_THIN_SEND_REQUEST_PML_COMPLETE(sendreq);
+        OBJ_DESTRUCT(&convertor);
     }
     
     return ret;
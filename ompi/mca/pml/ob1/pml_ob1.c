@@ -43,6 +43,7 @@
 #include "ompi/runtime/ompi_cr.h"
 
 #include "pml_ob1.h"
+#include "pml_ob1_coalesce.h"
 #include "pml_ob1_component.h"
 #include "pml_ob1_comm.h"
 #include "pml_ob1_hdr.h"
@@ -91,6 +92,9 @@ int mca_pml_ob1_enable(bool enable)
     }
 
     OBJ_CONSTRUCT(&mca_pml_ob1.lock, opal_mutex_t);
+    OBJ_CONSTRUCT(&mca_pml_ob1.rail_lock, opal_mutex_t);
+    OBJ_CONSTRUCT(&mca_pml_ob1.coalesce_lock, opal_mutex_t);
+    OBJ_CONSTRUCT(&mca_pml_ob1.coalesce_pending, opal_list_t);
 
     /* fragments */
     OBJ_CONSTRUCT(&mca_pml_ob1.rdma_frags, ompi_free_list_t);
@@ -179,6 +183,7 @@ int mca_pml_ob1_enable(bool enable)
                          mca_pml_ob1.free_list_inc,
                          NULL );
 
+    mca_pml_ob1_req_cache_init();
     mca_pml_ob1.enabled = true;
     return OMPI_SUCCESS;
 }
@@ -204,6 +209,9 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
     }
 
     mca_pml_ob1_comm_init_size(pml_comm, comm->c_remote_group->grp_proc_count);
+    pml_comm->no_any_source = !!OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE(comm);
+    pml_comm->no_any_tag = !!OMPI_COMM_CHECK_ASSERT_NO_ANY_TAG(comm);
+    pml_comm->allow_overtaking = !!OMPI_COMM_CHECK_ASSERT_ALLOW_OVERTAKING(comm);
     comm->c_pml_comm = pml_comm;
 
     for( i = 0; i < comm->c_remote_group->grp_proc_count; i++ ) {
@@ -247,10 +255,19 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
          */
         pml_proc = &(pml_comm->procs[hdr->hdr_src]);
 
-        if( ((uint16_t)hdr->hdr_seq) == ((uint16_t)pml_proc->expected_sequence) ) {
+        if( !mca_pml_ob1_comm_ordered(pml_comm, hdr->hdr_tag) ) {
+            /* no ordering to restore, the fragments simply are unexpected */
+            opal_list_append( mca_pml_ob1_comm_proc_unexpected_queue(pml_proc, hdr->hdr_tag),
+                              (opal_list_item_t*)frag );
+            frag->stamp = pml_proc->unexpected_stamp++;
+            PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_INSERT_IN_UNEX_Q, comm,
+                                   hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
+        } else if( ((uint16_t)hdr->hdr_seq) == ((uint16_t)pml_proc->expected_sequence) ) {
             /* We're now expecting the next sequence number. */
             pml_proc->expected_sequence++;
-            opal_list_append( &pml_proc->unexpected_frags, (opal_list_item_t*)frag );
+            opal_list_append( mca_pml_ob1_comm_proc_unexpected_queue(pml_proc, hdr->hdr_tag),
+                              (opal_list_item_t*)frag );
+            frag->stamp = pml_proc->unexpected_stamp++;
             PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_INSERT_IN_UNEX_Q, comm,
                                    hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
             /* And now the ugly part. As some fragments can be inserted in the cant_match list,
@@ -368,6 +385,9 @@ int mca_pml_ob1_add_procs(ompi_proc_t** procs, size_t nprocs)
             rc = OMPI_ERR_BAD_PARAM;
             goto cleanup_and_return;
         }
+
+        /* the rails are kept in the order of the btl modules */
+        mca_pml_ob1_rail_add(sm->btl_module);
     }
 
 
@@ -378,6 +398,12 @@ int mca_pml_ob1_add_procs(ompi_proc_t** procs, size_t nprocs)
     if(OMPI_SUCCESS != rc)
         goto cleanup_and_return;
     
+    rc = mca_bml.bml_register( MCA_PML_OB1_HDR_TYPE_CMATCH,
+                               mca_pml_ob1_recv_frag_callback_cmatch,
+                               NULL );
+    if(OMPI_SUCCESS != rc)
+        goto cleanup_and_return;
+
     rc = mca_bml.bml_register( MCA_PML_OB1_HDR_TYPE_RNDV,
                                mca_pml_ob1_recv_frag_callback_rndv,
                                NULL );
@@ -413,6 +439,18 @@ int mca_pml_ob1_add_procs(ompi_proc_t** procs, size_t nprocs)
                                NULL );
     if(OMPI_SUCCESS != rc)
         goto cleanup_and_return;
+
+    rc = mca_bml.bml_register( MCA_PML_OB1_HDR_TYPE_AGGR,
+                               mca_pml_ob1_recv_frag_callback_aggr,
+                               NULL );
+    if(OMPI_SUCCESS != rc)
+        goto cleanup_and_return;
+
+    rc = mca_bml.bml_register( MCA_PML_OB1_HDR_TYPE_FLOW,
+                               mca_pml_ob1_recv_frag_callback_flow,
+                               NULL );
+    if(OMPI_SUCCESS != rc)
+        goto cleanup_and_return;
     
     /* register error handlers */
     rc = mca_bml.bml_register_error(mca_pml_ob1_error_handler);
@@ -432,6 +470,12 @@ int mca_pml_ob1_add_procs(ompi_proc_t** procs, size_t nprocs)
 
 int mca_pml_ob1_del_procs(ompi_proc_t** procs, size_t nprocs)
 {
+    size_t i;
+
+    for(i = 0; i < nprocs; i++) {
+        mca_pml_ob1_coalesce_del_proc(procs[i]);
+    }
+
     return mca_bml.bml_del_procs(nprocs, procs);
 }
 
@@ -450,6 +494,20 @@ static void mca_pml_ob1_dump_hdr(mca_pml_ob1_hdr_t* hdr)
                   hdr->hdr_match.hdr_ctx, hdr->hdr_match.hdr_src,
                   hdr->hdr_match.hdr_tag, hdr->hdr_match.hdr_seq);
         break;
+    case MCA_PML_OB1_HDR_TYPE_CMATCH:
+        type = "CMATCH";
+        snprintf( header, 128, "ctx %5d src %d tag %d seq %d",
+                  ((mca_pml_ob1_cmatch_hdr_t*)hdr)->hdr_ctx,
+                  ((mca_pml_ob1_cmatch_hdr_t*)hdr)->hdr_src,
+                  ((mca_pml_ob1_cmatch_hdr_t*)hdr)->hdr_tag,
+                  ((mca_pml_ob1_cmatch_hdr_t*)hdr)->hdr_seq);
+        break;
+    case MCA_PML_OB1_HDR_TYPE_FLOW:
+        type = "FLOW";
+        snprintf( header, 128, "ctx %5d src %d eager %d",
+                  hdr->hdr_flow.hdr_ctx, hdr->hdr_flow.hdr_src,
+                  (int)hdr->hdr_flow.hdr_eager);
+        break;
     case MCA_PML_OB1_HDR_TYPE_RNDV:
         type = "RNDV";
         snprintf( header, 128, "ctx %5d src %d tag %d seq %d msg_length %" PRIu64,
@@ -532,6 +590,20 @@ static void mca_pml_ob1_dump_frag_list(opal_list_t* queue, bool is_req)
     }
 }
 
+/* dump a matching queue, whether it is a single list or tag buckets */
+static void mca_pml_ob1_dump_queue(opal_list_t* queue, opal_list_t* buckets, bool is_req)
+{
+    int i;
+
+    if( 0 == mca_pml_ob1.match_buckets ) {
+        mca_pml_ob1_dump_frag_list(queue, is_req);
+        return;
+    }
+    for( i = 0; NULL != buckets && i < (int)MCA_PML_OB1_NUM_TAG_BUCKETS; i++ ) {
+        mca_pml_ob1_dump_frag_list(buckets + i, is_req);
+    }
+}
+
 int mca_pml_ob1_dump(struct ompi_communicator_t* comm, int verbose)
 {
     struct mca_pml_comm_t* pml_comm = comm->c_pml_comm;
@@ -542,9 +614,9 @@ int mca_pml_ob1_dump(struct ompi_communicator_t* comm, int verbose)
     opal_output(0, "Communicator %s [%p](%d) rank %d recv_seq %d num_procs %lu last_probed %lu\n",
                 comm->c_name, (void*) comm, comm->c_contextid, comm->c_my_rank,
                 pml_comm->recv_sequence, pml_comm->num_procs, pml_comm->last_probed);
-    if( opal_list_get_size(&pml_comm->wild_receives) ) {
+    if( mca_pml_ob1_comm_queue_size(&pml_comm->wild_receives, pml_comm->wild_buckets) ) {
         opal_output(0, "expected MPI_ANY_SOURCE fragments\n");
-        mca_pml_ob1_dump_frag_list(&pml_comm->wild_receives, true);
+        mca_pml_ob1_dump_queue(&pml_comm->wild_receives, pml_comm->wild_buckets, true);
     }
 
     /* iterate through all procs on communicator */
@@ -557,20 +629,21 @@ int mca_pml_ob1_dump(struct ompi_communicator_t* comm, int verbose)
                     i, proc->expected_sequence, (void*) proc->ompi_proc, 
                     proc->send_sequence);
         /* dump all receive queues */
-        if( opal_list_get_size(&proc->specific_receives) ) {
+        if( mca_pml_ob1_comm_queue_size(&proc->specific_receives, proc->specific_buckets) ) {
             opal_output(0, "expected specific receives\n");
-            mca_pml_ob1_dump_frag_list(&proc->specific_receives, true);
+            mca_pml_ob1_dump_queue(&proc->specific_receives, proc->specific_buckets, true);
         }
         if( opal_list_get_size(&proc->frags_cant_match) ) {
             opal_output(0, "out of sequence\n");
             mca_pml_ob1_dump_frag_list(&proc->frags_cant_match, false);
         }
-        if( opal_list_get_size(&proc->unexpected_frags) ) {
+        if( mca_pml_ob1_comm_queue_size(&proc->unexpected_frags, proc->unexpected_buckets) ) {
             opal_output(0, "unexpected frag\n");
-            mca_pml_ob1_dump_frag_list(&proc->unexpected_frags, false);
+            mca_pml_ob1_dump_queue(&proc->unexpected_frags, proc->unexpected_buckets, false);
         }
-        /* dump all btls used for eager messages */
-        for( n = 0; n < ep->btl_eager.arr_size; n++ ) {
+        /* dump all btls used for eager messages (if the BML has set
+           them up for this peer yet) */
+        for( n = 0; NULL != ep && n < ep->btl_eager.arr_size; n++ ) {
             mca_bml_base_btl_t* bml_btl = &ep->btl_eager.bml_btls[n];
             bml_btl->btl->btl_dump(bml_btl->btl, bml_btl->btl_endpoint, verbose);
         }
@@ -640,6 +713,52 @@ int mca_pml_ob1_send_fin( ompi_proc_t* proc,
     return OMPI_ERR_OUT_OF_RESOURCE;
 }
 
+int mca_pml_ob1_send_flow( ompi_proc_t* proc,
+                           uint16_t ctx,
+                           int32_t src,
+                           bool eager )
+{
+    mca_bml_base_endpoint_t* endpoint = mca_bml_base_get_endpoint(proc);
+    mca_bml_base_btl_t* bml_btl;
+    mca_btl_base_descriptor_t* des;
+    mca_pml_ob1_flow_hdr_t* hdr;
+    int rc;
+
+    if( OPAL_UNLIKELY(NULL == endpoint ||
+                      0 == mca_bml_base_btl_array_get_size(&endpoint->btl_eager)) ) {
+        return OMPI_ERR_UNREACH;
+    }
+    bml_btl = mca_bml_base_btl_array_get_next(&endpoint->btl_eager);
+
+    mca_bml_base_alloc(bml_btl, &des, MCA_BTL_NO_ORDER, sizeof(mca_pml_ob1_flow_hdr_t),
+                       MCA_BTL_DES_FLAGS_PRIORITY | MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
+    if( OPAL_UNLIKELY(NULL == des) ) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    des->des_cbfunc = mca_pml_ob1_fin_completion;
+    des->des_cbdata = NULL;
+
+    /* fill in header */
+    hdr = (mca_pml_ob1_flow_hdr_t*)des->des_src->seg_addr.pval;
+    hdr->hdr_common.hdr_flags = 0;
+    hdr->hdr_common.hdr_type = MCA_PML_OB1_HDR_TYPE_FLOW;
+    hdr->hdr_ctx = ctx;
+    hdr->hdr_src = src;
+    hdr->hdr_eager = eager ? 1 : 0;
+
+    ob1_hdr_hton(hdr, MCA_PML_OB1_HDR_TYPE_FLOW, proc);
+
+    rc = mca_bml_base_send( bml_btl, des, MCA_PML_OB1_HDR_TYPE_FLOW );
+    if( OPAL_LIKELY( rc >= 0 ) ) {
+        if( OPAL_LIKELY( 1 == rc ) ) {
+            MCA_PML_OB1_PROGRESS_PENDING(bml_btl);
+        }
+        return OMPI_SUCCESS;
+    }
+    mca_bml_base_free(bml_btl, des);
+    return OMPI_ERR_OUT_OF_RESOURCE;
+}
+
 void mca_pml_ob1_process_pending_packets(mca_bml_base_btl_t* bml_btl)
 {
     mca_pml_ob1_pckt_pending_t *pckt;
@@ -988,9 +1107,9 @@ int mca_pml_ob1_com_btl_comp(const void *v1, const void *v2)
     const mca_pml_ob1_com_btl_t *b1 = (const mca_pml_ob1_com_btl_t *) v1;
     const mca_pml_ob1_com_btl_t *b2 = (const mca_pml_ob1_com_btl_t *) v2;
 
-    if(b1->bml_btl->btl_weight < b2->bml_btl->btl_weight)
+    if(b1->weight < b2->weight)
         return 1;
-    if(b1->bml_btl->btl_weight > b2->bml_btl->btl_weight)
+    if(b1->weight > b2->weight)
         return -1;
 
     return 0;
@@ -28,6 +28,7 @@
 #define MCA_PML_OB1_H
 
 #include "ompi_config.h"
+#include "opal/threads/tsd.h"
 #include "ompi/class/ompi_free_list.h"
 #include "ompi/request/request.h"
 #include "ompi/mca/pml/pml.h"
@@ -39,9 +40,38 @@
 #include "ompi/mca/bml/base/base.h"
 #include "ompi/proc/proc.h"
 #include "ompi/mca/allocator/base/base.h"
+#include "ompi/runtime/ompi_pvar_counters.h"
 
 BEGIN_C_DECLS
 
+#define MCA_PML_OB1_MAX_RAILS 8
+
+/**
+ * Throughput measured on a BTL module (a rail) used to stripe large
+ * messages. The time is only counted while operations are in flight
+ * on the rail, so that a rail which is not used does not look slow.
+ */
+struct mca_pml_ob1_rail_t {
+    struct mca_btl_base_module_t *btl;
+    int32_t in_flight;       /* operations issued and not completed */
+    uint64_t busy_since;     /* start of the current busy period (usec) */
+    uint64_t sample_usec;    /* busy time of the current sample */
+    uint64_t sample_bytes;   /* bytes completed during the current sample */
+    double bandwidth;        /* smoothed throughput in MB/s, 0 until measured */
+};
+typedef struct mca_pml_ob1_rail_t mca_pml_ob1_rail_t;
+
+/**
+ * Protocols counted by the pml_ob1_protocol_count performance variable
+ */
+enum {
+    MCA_PML_OB1_PROTOCOL_EAGER,
+    MCA_PML_OB1_PROTOCOL_RNDV,
+    MCA_PML_OB1_PROTOCOL_RDMA,
+    MCA_PML_OB1_PROTOCOL_UNEXPECTED,
+    MCA_PML_OB1_PROTOCOL_MAX
+};
+
 /**
  * OB1 PML module
  */
@@ -55,6 +85,9 @@ struct mca_pml_ob1_t {
     int free_list_inc;      /* number of elements to grow free list */
     size_t send_pipeline_depth;
     size_t recv_pipeline_depth;
+    size_t pack_pipeline_depth; /* fragments in flight for non-contiguous sends */
+    size_t rdma_pipeline_frag_min; /* first fragment of the receiver put pipeline, 0 = fixed size */
+    size_t rdma_pipeline_btl_depth; /* puts in flight per btl, 0 = no limit */
     size_t rdma_retries_limit;
     int max_rdma_per_request;
     int max_send_per_range;
@@ -82,6 +115,33 @@ struct mca_pml_ob1_t {
     char* allocator_name;
     mca_allocator_base_module_t* allocator; 
     unsigned int unexpected_limit;
+    size_t unexpected_max_bytes;    /* cap on the buffered unexpected data, 0 disables */
+    volatile size_t unexpected_bytes; /* data currently held in receive fragments */
+    unsigned int match_buckets;  /* number of tag buckets per matching queue (0 = linear queues) */
+
+    /* striping from the measured throughput of the rails */
+    bool adaptive_striping;
+    int rail_count;
+    mca_pml_ob1_rail_t rails[MCA_PML_OB1_MAX_RAILS];
+    opal_mutex_t rail_lock;
+
+    /* coalescing of short messages */
+    size_t coalesce_size;           /* largest message coalesced, 0 disables */
+    unsigned int coalesce_window;   /* usec a fragment may wait for more messages */
+    opal_list_t coalesce_pending;   /* peers with a fragment being filled */
+    opal_mutex_t coalesce_lock;
+
+    /* largest eager message sent with the compact match header, 0 disables */
+    size_t compact_match_size;
+
+    /* per-thread request caches */
+    unsigned int req_cache_size;    /* requests moved at a time, 0 disables */
+    bool req_cache_valid;
+    opal_tsd_key_t req_cache_key;
+
+    /* MPI_T counters */
+    ompi_pvar_counter_t protocol_count[MCA_PML_OB1_PROTOCOL_MAX];
+    ompi_pvar_counter_t match_time;
 };
 typedef struct mca_pml_ob1_t mca_pml_ob1_t; 
 
@@ -255,6 +315,13 @@ do {                                                            \
 int mca_pml_ob1_send_fin(ompi_proc_t* proc, mca_bml_base_btl_t* bml_btl, 
         ompi_ptr_t hdr_des, uint8_t order, uint32_t status);
 
+/* Tell the peer whether it may send eager data to this process on the
+ * communicator ctx, where this process has rank src. Unlike FIN the notice
+ * is not queued when no descriptor is available: the caller tries again
+ * with a later message. */
+int mca_pml_ob1_send_flow(ompi_proc_t* proc, uint16_t ctx, int32_t src,
+        bool eager);
+
 /* This function tries to resend FIN/ACK packets from pckt_pending queue.
  * Packets are added to the queue when sending of FIN or ACK is failed due to
  * resource unavailability. bml_btl passed to the function doesn't represents
@@ -340,13 +407,79 @@ struct mca_pml_ob1_com_btl_t {
     mca_bml_base_btl_t *bml_btl;
     struct mca_mpool_base_registration_t* btl_reg;
     size_t length;
+    double weight;   /* share of the message, set by mca_pml_ob1_calc_weighted_length */
+    size_t pipeline_depth;  /* puts in flight on this btl, receiver side only */
 };
 typedef struct mca_pml_ob1_com_btl_t mca_pml_ob1_com_btl_t;
 
 int mca_pml_ob1_com_btl_comp(const void *v1, const void *v2);
 
+void mca_pml_ob1_rail_add(struct mca_btl_base_module_t *btl);
+void mca_pml_ob1_rail_start_slow(struct mca_btl_base_module_t *btl);
+void mca_pml_ob1_rail_complete_slow(struct mca_btl_base_module_t *btl, size_t bytes);
+
+static inline mca_pml_ob1_rail_t *
+mca_pml_ob1_rail_lookup(struct mca_btl_base_module_t *btl)
+{
+    int i;
+
+    for (i = 0 ; i < mca_pml_ob1.rail_count ; ++i) {
+        if (mca_pml_ob1.rails[i].btl == btl) {
+            return mca_pml_ob1.rails + i;
+        }
+    }
+
+    return NULL;
+}
+
+/* An operation is about to be issued on the rail. Called before the BTL
+ * call, as the completion can happen before it returns */
+static inline void mca_pml_ob1_rail_start(struct mca_btl_base_module_t *btl)
+{
+    if (OPAL_UNLIKELY(mca_pml_ob1.adaptive_striping)) {
+        mca_pml_ob1_rail_start_slow(btl);
+    }
+}
+
+/* An operation completed (or failed to be issued, with 0 bytes) */
+static inline void mca_pml_ob1_rail_complete(struct mca_btl_base_module_t *btl, size_t bytes)
+{
+    if (OPAL_UNLIKELY(mca_pml_ob1.adaptive_striping)) {
+        mca_pml_ob1_rail_complete_slow(btl, bytes);
+    }
+}
+
+/* Use the measured throughput of the rails as weights. Returns false if
+ * one of them has not been measured yet */
+static inline bool
+mca_pml_ob1_rail_weights(mca_pml_ob1_com_btl_t *btls, int num_btls, double *weight_total)
+{
+    mca_pml_ob1_rail_t *rail;
+    double total = 0;
+    int i;
+
+    if (OPAL_LIKELY(!mca_pml_ob1.adaptive_striping)) {
+        return false;
+    }
+
+    for (i = 0 ; i < num_btls ; ++i) {
+        rail = mca_pml_ob1_rail_lookup(btls[i].bml_btl->btl);
+        if (NULL == rail || 0 == rail->bandwidth) {
+            return false;
+        }
+        total += rail->bandwidth;
+    }
+
+    for (i = 0 ; i < num_btls ; ++i) {
+        btls[i].weight = mca_pml_ob1_rail_lookup(btls[i].bml_btl->btl)->bandwidth;
+    }
+    *weight_total = total;
+
+    return true;
+}
+
 /* Calculate what percentage of a message to send through each BTL according to
- * relative weight */
+ * relative weight (the measured throughput of the rails with adaptive striping) */
 static inline void
 mca_pml_ob1_calc_weighted_length( mca_pml_ob1_com_btl_t *btls, int num_btls, size_t size,
                                   double weight_total )
@@ -360,6 +493,12 @@ mca_pml_ob1_calc_weighted_length( mca_pml_ob1_com_btl_t *btls, int num_btls, siz
         return;
     }
 
+    if( !mca_pml_ob1_rail_weights(btls, num_btls, &weight_total) ) {
+        for(i = 0; i < num_btls; i++) {
+            btls[i].weight = btls[i].bml_btl->btl_weight;
+        }
+    }
+
     /* sort BTLs according of their weights so BTLs with smaller weight will
      * not hijack all of the traffic */
     qsort( btls, num_btls, sizeof(mca_pml_ob1_com_btl_t),
@@ -370,7 +509,7 @@ mca_pml_ob1_calc_weighted_length( mca_pml_ob1_com_btl_t *btls, int num_btls, siz
         size_t length = 0;
         if( OPAL_UNLIKELY(0 != length_left) ) {
             length = (length_left > bml_btl->btl->btl_eager_limit)?
-                ((size_t)(size * (bml_btl->btl_weight / weight_total))) :
+                ((size_t)(size * (btls[i].weight / weight_total))) :
                 length_left;
 
             if(length > length_left)
@@ -384,4 +523,18 @@ mca_pml_ob1_calc_weighted_length( mca_pml_ob1_com_btl_t *btls, int num_btls, siz
     btls[0].length += length_left;
 }
 
+/* Split again what is left to transfer according to the last measured
+ * throughput of the rails. Does nothing until all of them are measured */
+static inline void
+mca_pml_ob1_rebalance_weighted_length( mca_pml_ob1_com_btl_t *btls, int num_btls, size_t size )
+{
+    double weight_total;
+
+    if( OPAL_LIKELY(num_btls < 2) || !mca_pml_ob1_rail_weights(btls, num_btls, &weight_total) ) {
+        return;
+    }
+
+    mca_pml_ob1_calc_weighted_length(btls, num_btls, size, weight_total);
+}
+
 #endif
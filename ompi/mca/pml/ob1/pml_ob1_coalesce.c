@@ -0,0 +1,275 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <string.h>
+
+#include "opal/mca/timer/base/base.h"
+#include "ompi/constants.h"
+#include "ompi/memchecker.h"
+#include "ompi/proc/proc.h"
+#include "ompi/mca/bml/bml.h"
+#include "pml_ob1.h"
+#include "pml_ob1_hdr.h"
+#include "pml_ob1_coalesce.h"
+#include "pml_ob1_recvfrag.h"
+#include "pml_ob1_recvreq.h"
+#include "pml_ob1_sendreq.h"
+
+/* coalescing state of a peer, stored in proc_pml */
+struct mca_pml_ob1_coalesce_t {
+    opal_list_item_t super;          /* in coalesce_pending while des is set */
+    mca_bml_base_btl_t* bml_btl;
+    mca_btl_base_descriptor_t* des;  /* fragment being filled */
+    size_t limit;                    /* size of the fragment */
+    uint64_t start;                  /* time of the first message */
+};
+typedef struct mca_pml_ob1_coalesce_t mca_pml_ob1_coalesce_t;
+
+static OBJ_CLASS_INSTANCE(mca_pml_ob1_coalesce_t, opal_list_item_t, NULL, NULL);
+
+#define MCA_PML_OB1_AGGR_ENTRY_SIZE(size) \
+    MCA_PML_OB1_AGGR_ENTRY_ALIGN(sizeof(uint32_t) + OMPI_PML_OB1_MATCH_HDR_LEN + (size))
+
+static void mca_pml_ob1_coalesce_completion( mca_btl_base_module_t* btl,
+                                             struct mca_btl_base_endpoint_t* ep,
+                                             struct mca_btl_base_descriptor_t* des,
+                                             int status )
+{
+    mca_bml_base_btl_t* bml_btl = (mca_bml_base_btl_t*) des->des_context;
+
+    /* check for pending requests */
+    MCA_PML_OB1_PROGRESS_PENDING(bml_btl);
+}
+
+/* called with the coalesce lock held */
+static int mca_pml_ob1_coalesce_flush_nolock(mca_pml_ob1_coalesce_t* agg)
+{
+    int rc;
+
+    if( NULL == agg->des ) {
+        return OMPI_SUCCESS;
+    }
+
+    agg->des->des_cbfunc = mca_pml_ob1_coalesce_completion;
+    rc = mca_bml_base_send(agg->bml_btl, agg->des, MCA_PML_OB1_HDR_TYPE_AGGR);
+    if( OPAL_UNLIKELY(rc < 0) ) {
+        /* the messages are already complete for the sender, keep the
+         * fragment and try again from the progress loop */
+        return rc;
+    }
+
+    agg->des = NULL;
+    opal_list_remove_item(&mca_pml_ob1.coalesce_pending, &agg->super);
+    return OMPI_SUCCESS;
+}
+
+int mca_pml_ob1_coalesce_send(mca_pml_ob1_send_request_t* sendreq,
+                              mca_bml_base_btl_t* bml_btl,
+                              size_t size)
+{
+    ompi_proc_t* proc = (ompi_proc_t*)sendreq->req_send.req_base.req_proc;
+    mca_pml_ob1_coalesce_t* agg;
+    mca_pml_ob1_aggr_hdr_t* aggr_hdr;
+    mca_pml_ob1_match_hdr_t* hdr;
+    mca_btl_base_segment_t* segment;
+    unsigned char* entry;
+    struct iovec iov;
+    uint32_t iov_count;
+    size_t max_data = size;
+
+    /* synchronous sends need an ack and buffered ones are already copied */
+    if( size > mca_pml_ob1.coalesce_size ||
+        (MCA_PML_BASE_SEND_STANDARD != sendreq->req_send.req_send_mode &&
+         MCA_PML_BASE_SEND_READY != sendreq->req_send.req_send_mode) ||
+        sizeof(mca_pml_ob1_aggr_hdr_t) + MCA_PML_OB1_AGGR_ENTRY_SIZE(size) > bml_btl->btl->btl_eager_limit ||
+        proc->proc_arch != ompi_proc_local()->proc_arch ) {
+        /* keep the messages in order, send what is waiting for this peer first */
+        if( NULL != proc->proc_pml ) {
+            OPAL_THREAD_LOCK(&mca_pml_ob1.coalesce_lock);
+            (void) mca_pml_ob1_coalesce_flush_nolock((mca_pml_ob1_coalesce_t*)proc->proc_pml);
+            OPAL_THREAD_UNLOCK(&mca_pml_ob1.coalesce_lock);
+        }
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    OPAL_THREAD_LOCK(&mca_pml_ob1.coalesce_lock);
+    agg = (mca_pml_ob1_coalesce_t*)proc->proc_pml;
+    if( OPAL_UNLIKELY(NULL == agg) ) {
+        agg = OBJ_NEW(mca_pml_ob1_coalesce_t);
+        agg->des = NULL;
+        proc->proc_pml = (struct mca_pml_endpoint_t*)agg;
+    }
+
+    if( NULL != agg->des &&
+        agg->des->des_src->seg_len + MCA_PML_OB1_AGGR_ENTRY_SIZE(size) > agg->limit ) {
+        (void) mca_pml_ob1_coalesce_flush_nolock(agg);
+    }
+
+    if( NULL == agg->des ) {
+        mca_bml_base_alloc(bml_btl, &agg->des, MCA_BTL_NO_ORDER,
+                           bml_btl->btl->btl_eager_limit,
+                           MCA_BTL_DES_FLAGS_PRIORITY | MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
+        if( OPAL_UNLIKELY(NULL == agg->des) ) {
+            OPAL_THREAD_UNLOCK(&mca_pml_ob1.coalesce_lock);
+            return OMPI_ERR_NOT_AVAILABLE;
+        }
+        agg->bml_btl = bml_btl;
+        agg->limit = bml_btl->btl->btl_eager_limit;
+        agg->start = (0 != mca_pml_ob1.coalesce_window) ? opal_timer_base_get_usec() : 0;
+
+        aggr_hdr = (mca_pml_ob1_aggr_hdr_t*)agg->des->des_src->seg_addr.pval;
+        aggr_hdr->hdr_common.hdr_type = MCA_PML_OB1_HDR_TYPE_AGGR;
+        aggr_hdr->hdr_common.hdr_flags = 0;
+        aggr_hdr->hdr_count = 0;
+        aggr_hdr->hdr_padding = 0;
+        agg->des->des_src->seg_len = sizeof(mca_pml_ob1_aggr_hdr_t);
+        opal_list_append(&mca_pml_ob1.coalesce_pending, &agg->super);
+    } else if( OPAL_UNLIKELY(agg->des->des_src->seg_len + MCA_PML_OB1_AGGR_ENTRY_SIZE(size) > agg->limit) ) {
+        /* the full fragment could not be sent */
+        OPAL_THREAD_UNLOCK(&mca_pml_ob1.coalesce_lock);
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    segment = agg->des->des_src;
+    aggr_hdr = (mca_pml_ob1_aggr_hdr_t*)segment->seg_addr.pval;
+    entry = (unsigned char*)segment->seg_addr.pval + segment->seg_len;
+    hdr = (mca_pml_ob1_match_hdr_t*)(entry + sizeof(uint32_t));
+
+    if( size > 0 ) {
+        iov.iov_base = (IOVBASE_TYPE*)((unsigned char*)hdr + OMPI_PML_OB1_MATCH_HDR_LEN);
+        iov.iov_len  = size;
+        iov_count    = 1;
+        MEMCHECKER(
+            memchecker_call(&opal_memchecker_base_mem_defined,
+                            sendreq->req_send.req_base.req_addr,
+                            sendreq->req_send.req_base.req_count,
+                            sendreq->req_send.req_base.req_datatype);
+        );
+        (void)opal_convertor_pack( &sendreq->req_send.req_base.req_convertor,
+                                   &iov, &iov_count, &max_data );
+        MEMCHECKER(
+            memchecker_call(&opal_memchecker_base_mem_noaccess,
+                            sendreq->req_send.req_base.req_addr,
+                            sendreq->req_send.req_base.req_count,
+                            sendreq->req_send.req_base.req_datatype);
+        );
+    }
+
+    hdr->hdr_common.hdr_flags = 0;
+    hdr->hdr_common.hdr_type = MCA_PML_OB1_HDR_TYPE_MATCH;
+    hdr->hdr_ctx = sendreq->req_send.req_base.req_comm->c_contextid;
+    hdr->hdr_src = sendreq->req_send.req_base.req_comm->c_my_rank;
+    hdr->hdr_tag = sendreq->req_send.req_base.req_tag;
+    hdr->hdr_seq = (uint16_t)sendreq->req_send.req_base.req_sequence;
+    *((uint32_t*)entry) = (uint32_t)(OMPI_PML_OB1_MATCH_HDR_LEN + max_data);
+
+    segment->seg_len += MCA_PML_OB1_AGGR_ENTRY_SIZE(max_data);
+    aggr_hdr->hdr_count++;
+
+    /* no room left for another message */
+    if( UINT16_MAX == aggr_hdr->hdr_count ||
+        segment->seg_len + MCA_PML_OB1_AGGR_ENTRY_SIZE(0) > agg->limit ) {
+        (void) mca_pml_ob1_coalesce_flush_nolock(agg);
+    }
+    OPAL_THREAD_UNLOCK(&mca_pml_ob1.coalesce_lock);
+
+    if( size > 0 ) {
+        PERUSE_TRACE_COMM_EVENT( PERUSE_COMM_REQ_XFER_BEGIN,
+                                 &(sendreq->req_send.req_base), PERUSE_SEND );
+    }
+
+    /* the data is in the fragment, the request is done */
+    send_request_pml_complete(sendreq);
+    return OMPI_SUCCESS;
+}
+
+void mca_pml_ob1_coalesce_progress(void)
+{
+    opal_list_item_t *item, *next;
+    uint64_t now = 0;
+
+    if( 0 != mca_pml_ob1.coalesce_window ) {
+        now = opal_timer_base_get_usec();
+    }
+
+    OPAL_THREAD_LOCK(&mca_pml_ob1.coalesce_lock);
+    for( item = opal_list_get_first(&mca_pml_ob1.coalesce_pending);
+         item != opal_list_get_end(&mca_pml_ob1.coalesce_pending);
+         item = next ) {
+        mca_pml_ob1_coalesce_t* agg = (mca_pml_ob1_coalesce_t*)item;
+
+        next = opal_list_get_next(item);
+        if( now - agg->start >= mca_pml_ob1.coalesce_window ) {
+            (void) mca_pml_ob1_coalesce_flush_nolock(agg);
+        }
+    }
+    OPAL_THREAD_UNLOCK(&mca_pml_ob1.coalesce_lock);
+}
+
+void mca_pml_ob1_coalesce_del_proc(ompi_proc_t* proc)
+{
+    mca_pml_ob1_coalesce_t* agg;
+
+    OPAL_THREAD_LOCK(&mca_pml_ob1.coalesce_lock);
+    agg = (mca_pml_ob1_coalesce_t*)proc->proc_pml;
+    if( NULL != agg ) {
+        if( OMPI_SUCCESS != mca_pml_ob1_coalesce_flush_nolock(agg) ) {
+            mca_bml_base_free(agg->bml_btl, agg->des);
+            opal_list_remove_item(&mca_pml_ob1.coalesce_pending, &agg->super);
+        }
+        OBJ_RELEASE(agg);
+        proc->proc_pml = NULL;
+    }
+    OPAL_THREAD_UNLOCK(&mca_pml_ob1.coalesce_lock);
+}
+
+void mca_pml_ob1_recv_frag_callback_aggr( mca_btl_base_module_t* btl,
+                                          mca_btl_base_tag_t tag,
+                                          mca_btl_base_descriptor_t* des,
+                                          void* cbdata )
+{
+    mca_btl_base_segment_t* segments = des->des_dst;
+    mca_pml_ob1_aggr_hdr_t* hdr = (mca_pml_ob1_aggr_hdr_t*)segments->seg_addr.pval;
+    unsigned char* entry = (unsigned char*)(hdr + 1);
+    unsigned char* end = (unsigned char*)hdr + segments->seg_len;
+    mca_btl_base_descriptor_t message;
+    mca_btl_base_segment_t segment;
+    uint32_t length;
+    uint16_t i;
+
+    assert(1 == des->des_dst_cnt);
+
+    if( OPAL_UNLIKELY(segments->seg_len < sizeof(mca_pml_ob1_aggr_hdr_t)) ) {
+        return;
+    }
+
+    /* each message goes through the usual matching, as if it came alone */
+    memset(&message, 0, sizeof(message));
+    message.des_dst = &segment;
+    message.des_dst_cnt = 1;
+
+    for( i = 0; i < hdr->hdr_count; i++ ) {
+        if( OPAL_UNLIKELY(entry + sizeof(uint32_t) > end) ) {
+            break;
+        }
+        length = *((uint32_t*)entry);
+        if( OPAL_UNLIKELY(entry + sizeof(uint32_t) + length > end) ) {
+            break;
+        }
+        segment.seg_addr.pval = entry + sizeof(uint32_t);
+        segment.seg_len = length;
+        mca_pml_ob1_recv_frag_callback_match(btl, MCA_PML_OB1_HDR_TYPE_MATCH, &message, cbdata);
+        entry += MCA_PML_OB1_AGGR_ENTRY_ALIGN(sizeof(uint32_t) + length);
+    }
+}
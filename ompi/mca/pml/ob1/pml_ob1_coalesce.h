@@ -0,0 +1,64 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ *  @file
+ *
+ *  Coalescing of short messages. Short standard sends to a peer are
+ *  copied one after the other in a single fragment, which is sent when it
+ *  is full, when the coalescing window expires (checked from the progress
+ *  loop) or before a message to the same peer that cannot be coalesced.
+ *  The receiver splits the fragment and matches the messages one by one.
+ */
+
+#ifndef MCA_PML_OB1_COALESCE_H
+#define MCA_PML_OB1_COALESCE_H
+
+#include "ompi_config.h"
+#include "ompi/mca/btl/btl.h"
+
+BEGIN_C_DECLS
+
+struct mca_pml_ob1_send_request_t;
+struct mca_bml_base_btl_t;
+struct ompi_proc_t;
+
+/**
+ * Add the message of a send request to the fragment being filled for its
+ * peer, and complete the request. Returns OMPI_ERR_NOT_AVAILABLE if the
+ * message has to be sent by the usual protocols; in this case the messages
+ * waiting for the peer are sent first.
+ */
+int mca_pml_ob1_coalesce_send(struct mca_pml_ob1_send_request_t* sendreq,
+                              struct mca_bml_base_btl_t* bml_btl,
+                              size_t size);
+
+/**
+ * Send the fragments whose coalescing window is over.
+ */
+void mca_pml_ob1_coalesce_progress(void);
+
+/**
+ * Send what is waiting for a peer and release the coalescing state.
+ */
+void mca_pml_ob1_coalesce_del_proc(struct ompi_proc_t* proc);
+
+/**
+ *  Callback from BTL on receipt of coalesced messages.
+ */
+extern void mca_pml_ob1_recv_frag_callback_aggr( mca_btl_base_module_t *btl,
+                                                 mca_btl_base_tag_t tag,
+                                                 mca_btl_base_descriptor_t* descriptor,
+                                                 void* cbdata );
+
+END_C_DECLS
+
+#endif
@@ -19,6 +19,7 @@
 #include "ompi_config.h"
 #include <string.h>
 
+#include "ompi/mca/rte/rte.h"
 #include "pml_ob1.h"
 #include "pml_ob1_comm.h"
 
@@ -26,20 +27,87 @@
 
 static void mca_pml_ob1_comm_proc_construct(mca_pml_ob1_comm_proc_t* proc)
 {
+    OBJ_CONSTRUCT(&proc->matching_lock, opal_mutex_t);
     proc->expected_sequence = 1;
     proc->ompi_proc = NULL;
     proc->send_sequence = 0;
     OBJ_CONSTRUCT(&proc->frags_cant_match, opal_list_t);
     OBJ_CONSTRUCT(&proc->specific_receives, opal_list_t);
     OBJ_CONSTRUCT(&proc->unexpected_frags, opal_list_t);
+    proc->specific_buckets = NULL;
+    proc->unexpected_buckets = NULL;
+    proc->unexpected_stamp = 0;
+    proc->flow_throttled = false;
+    proc->eager_disabled = false;
+}
+
+static opal_list_t* mca_pml_ob1_comm_buckets_create(void)
+{
+    opal_list_t* buckets;
+    int i;
+
+    buckets = (opal_list_t*)malloc(sizeof(opal_list_t) * MCA_PML_OB1_NUM_TAG_BUCKETS);
+    if (NULL == buckets) {
+        return NULL;
+    }
+    for (i = 0; i < (int)MCA_PML_OB1_NUM_TAG_BUCKETS; i++) {
+        OBJ_CONSTRUCT(buckets + i, opal_list_t);
+    }
+    return buckets;
+}
+
+static void mca_pml_ob1_comm_buckets_free(opal_list_t* buckets)
+{
+    int i;
+
+    if (NULL == buckets) {
+        return;
+    }
+    for (i = 0; i < (int)MCA_PML_OB1_NUM_TAG_BUCKETS; i++) {
+        OBJ_DESTRUCT(buckets + i);
+    }
+    free(buckets);
+}
+
+void mca_pml_ob1_comm_proc_alloc_buckets(mca_pml_ob1_comm_proc_t* proc)
+{
+    if (NULL == proc->specific_buckets) {
+        proc->specific_buckets = mca_pml_ob1_comm_buckets_create();
+    }
+    if (NULL == proc->unexpected_buckets) {
+        proc->unexpected_buckets = mca_pml_ob1_comm_buckets_create();
+    }
+    if (OPAL_UNLIKELY(NULL == proc->specific_buckets || NULL == proc->unexpected_buckets)) {
+        OMPI_ERROR_LOG(OMPI_ERR_OUT_OF_RESOURCE);
+        ompi_rte_abort(-1, NULL);
+    }
+}
+
+size_t mca_pml_ob1_comm_queue_size(opal_list_t* list, opal_list_t* buckets)
+{
+    size_t size = 0;
+    int i;
+
+    if (0 == mca_pml_ob1.match_buckets) {
+        return opal_list_get_size(list);
+    }
+    if (NULL != buckets) {
+        for (i = 0; i < (int)MCA_PML_OB1_NUM_TAG_BUCKETS; i++) {
+            size += opal_list_get_size(buckets + i);
+        }
+    }
+    return size;
 }
 
 
 static void mca_pml_ob1_comm_proc_destruct(mca_pml_ob1_comm_proc_t* proc)
 {
+    OBJ_DESTRUCT(&proc->matching_lock);
     OBJ_DESTRUCT(&proc->frags_cant_match);
     OBJ_DESTRUCT(&proc->specific_receives);
     OBJ_DESTRUCT(&proc->unexpected_frags);
+    mca_pml_ob1_comm_buckets_free(proc->specific_buckets);
+    mca_pml_ob1_comm_buckets_free(proc->unexpected_buckets);
 }
 
 
@@ -53,7 +121,12 @@ static OBJ_CLASS_INSTANCE(
 static void mca_pml_ob1_comm_construct(mca_pml_ob1_comm_t* comm)
 {
     OBJ_CONSTRUCT(&comm->wild_receives, opal_list_t);
+    comm->wild_buckets = NULL;
     OBJ_CONSTRUCT(&comm->matching_lock, opal_mutex_t);
+    comm->num_wild = 0;
+    comm->no_any_source = false;
+    comm->no_any_tag = false;
+    comm->allow_overtaking = false;
     comm->recv_sequence = 0;
     comm->procs = NULL;
     comm->last_probed = 0;
@@ -69,6 +142,7 @@ static void mca_pml_ob1_comm_destruct(mca_pml_ob1_comm_t* comm)
     if(NULL != comm->procs)
         free(comm->procs);
     OBJ_DESTRUCT(&comm->wild_receives);
+    mca_pml_ob1_comm_buckets_free(comm->wild_buckets);
     OBJ_DESTRUCT(&comm->matching_lock);
 }
 
@@ -89,6 +163,14 @@ int mca_pml_ob1_comm_init_size(mca_pml_ob1_comm_t* comm, size_t size)
     if(NULL == comm->procs) {
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
+    if (0 != mca_pml_ob1.match_buckets) {
+        comm->wild_buckets = mca_pml_ob1_comm_buckets_create();
+        if (NULL == comm->wild_buckets) {
+            free(comm->procs);
+            comm->procs = NULL;
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+    }
     for(i=0; i<size; i++) {
         OBJ_CONSTRUCT(comm->procs+i, mca_pml_ob1_comm_proc_t);
     }
@@ -24,11 +24,13 @@
 #include "opal/threads/mutex.h"
 #include "opal/class/opal_list.h"
 #include "ompi/proc/proc.h"
+#include "pml_ob1.h"
 BEGIN_C_DECLS
 
 
 struct mca_pml_ob1_comm_proc_t {
     opal_object_t super;
+    opal_mutex_t matching_lock;    /**< protects the queues and expected_sequence of the peer */
     uint16_t expected_sequence;    /**< send message sequence number - receiver side */
     struct ompi_proc_t* ompi_proc;
 #if OPAL_ENABLE_MULTI_THREADS
@@ -39,6 +41,12 @@ struct mca_pml_ob1_comm_proc_t {
     opal_list_t frags_cant_match;  /**< out-of-order fragment queues */
     opal_list_t specific_receives; /**< queues of unmatched specific receives */
     opal_list_t unexpected_frags;  /**< unexpected fragment queues */
+    /* tag matching engine (only used when mca_pml_ob1.match_buckets != 0) */
+    opal_list_t *specific_buckets;   /**< specific receives hashed by tag, allocated on first use */
+    opal_list_t *unexpected_buckets; /**< unexpected fragments hashed by tag, allocated on first use */
+    uint64_t unexpected_stamp;       /**< arrival order of the unexpected fragments */
+    bool flow_throttled;             /**< the peer was asked not to send eager data - receiver side */
+    bool eager_disabled;             /**< the peer asked for no eager data - sender side */
 };
 typedef struct mca_pml_ob1_comm_proc_t mca_pml_ob1_comm_proc_t;
 
@@ -54,8 +62,13 @@ struct mca_pml_comm_t {
 #else
     uint32_t recv_sequence;  /**< recv request sequence number - receiver side */
 #endif
-    opal_mutex_t matching_lock;   /**< matching lock */
+    opal_mutex_t matching_lock;   /**< protects the wild receives, taken before any proc lock */
+    volatile int32_t num_wild;    /**< wild receives posted, or being posted */
     opal_list_t wild_receives;    /**< queue of unmatched wild (source process not specified) receives */
+    opal_list_t *wild_buckets;    /**< wild receives hashed by tag (tag matching engine only) */
+    bool no_any_source;           /**< mpi_assert_no_any_source: no wild receive is ever posted */
+    bool no_any_tag;              /**< mpi_assert_no_any_tag: no receive is posted with MPI_ANY_TAG */
+    bool allow_overtaking;        /**< mpi_assert_allow_overtaking: user messages match in arrival order */
     mca_pml_ob1_comm_proc_t* procs;
     size_t num_procs;
     size_t last_probed;
@@ -75,6 +88,135 @@ OBJ_CLASS_DECLARATION(mca_pml_ob1_comm_t);
 
 extern int mca_pml_ob1_comm_init_size(mca_pml_ob1_comm_t* comm, size_t size);
 
+/*
+ * Tag matching engine.
+ *
+ * When the pml_ob1_match_buckets MCA parameter is non-zero the posted
+ * receive and unexpected fragment queues are split into buckets by
+ * tag.  With n buckets, [0, n) hold the non-negative (user) tags,
+ * [n, 2n) the negative (internal) tags and bucket 2n holds the
+ * receives posted with MPI_ANY_TAG.  Each bucket keeps the insertion
+ * order of the original queue, so the MPI ordering rules are kept by
+ * comparing the sequence numbers (for receives) or arrival stamps
+ * (for fragments) of the heads of the few candidate buckets.
+ */
+
+/** Number of lists in a bucket array */
+#define MCA_PML_OB1_NUM_TAG_BUCKETS (2 * mca_pml_ob1.match_buckets + 1)
+
+/** Bucket index of a tag */
+static inline int mca_pml_ob1_tag_bucket(int tag)
+{
+    int n = (int) mca_pml_ob1.match_buckets;
+
+    if (OMPI_ANY_TAG == tag) {
+        return 2 * n;
+    }
+    return (tag >= 0) ? (tag & (n - 1)) : n + ((-(tag + 1)) & (n - 1));
+}
+
+/**
+ * Allocate the bucket arrays of a proc.  Failure to allocate is fatal,
+ * as there is no way to report it from the matching code.
+ */
+extern void mca_pml_ob1_comm_proc_alloc_buckets(mca_pml_ob1_comm_proc_t* proc);
+
+/**
+ * Number of elements in a queue, whether it is a single list or a
+ * bucket array.
+ */
+extern size_t mca_pml_ob1_comm_queue_size(opal_list_t* list, opal_list_t* buckets);
+
+/**
+ * Queue on which a specific receive with the given tag is posted
+ * (allocates the proc's buckets if needed).
+ */
+static inline opal_list_t* mca_pml_ob1_comm_proc_specific_queue(mca_pml_ob1_comm_proc_t* proc,
+                                                                int tag)
+{
+    if (0 == mca_pml_ob1.match_buckets) {
+        return &proc->specific_receives;
+    }
+    if (OPAL_UNLIKELY(NULL == proc->specific_buckets)) {
+        mca_pml_ob1_comm_proc_alloc_buckets(proc);
+    }
+    return proc->specific_buckets + mca_pml_ob1_tag_bucket(tag);
+}
+
+/**
+ * Queue on which an unexpected fragment with the given tag is kept
+ * (allocates the proc's buckets if needed).
+ */
+static inline opal_list_t* mca_pml_ob1_comm_proc_unexpected_queue(mca_pml_ob1_comm_proc_t* proc,
+                                                                  int tag)
+{
+    if (0 == mca_pml_ob1.match_buckets) {
+        return &proc->unexpected_frags;
+    }
+    if (OPAL_UNLIKELY(NULL == proc->unexpected_buckets)) {
+        mca_pml_ob1_comm_proc_alloc_buckets(proc);
+    }
+    return proc->unexpected_buckets + mca_pml_ob1_tag_bucket(tag);
+}
+
+/**
+ * Queue on which a wild (MPI_ANY_SOURCE) receive with the given tag
+ * is posted.
+ */
+static inline opal_list_t* mca_pml_ob1_comm_wild_queue(mca_pml_ob1_comm_t* comm, int tag)
+{
+    if (0 == mca_pml_ob1.match_buckets) {
+        return &comm->wild_receives;
+    }
+    return comm->wild_buckets + mca_pml_ob1_tag_bucket(tag);
+}
+
+/**
+ * Whether messages with this tag are sequenced.  Under
+ * mpi_assert_allow_overtaking the user messages (non-negative tags)
+ * neither consume nor check a sequence number, while the internal ones
+ * (collectives, ...) keep their ordering.
+ */
+static inline bool mca_pml_ob1_comm_ordered(mca_pml_ob1_comm_t* comm, int tag)
+{
+    return !comm->allow_overtaking || tag < 0;
+}
+
+/**
+ * Lock the matching state of a peer before matching one of its
+ * fragments.  The peers are locked independently, and the lock of the
+ * communicator is only added while wild receives are posted, as the
+ * fragment then has to be matched against them too.  A wild receive
+ * announces itself in num_wild before going through the peers, so a
+ * fragment that finds it at 0 under the peer lock can ignore the wild
+ * queue, and so can every fragment of a communicator asserting
+ * mpi_assert_no_any_source.  Returns whether the communicator lock was
+ * taken.
+ */
+static inline bool mca_pml_ob1_match_lock(mca_pml_ob1_comm_t* comm,
+                                          mca_pml_ob1_comm_proc_t* proc)
+{
+    OPAL_THREAD_LOCK(&proc->matching_lock);
+    if (OPAL_LIKELY(comm->no_any_source || 0 == comm->num_wild)) {
+        return false;
+    }
+    /* keep the lock order: communicator first */
+    OPAL_THREAD_UNLOCK(&proc->matching_lock);
+    OPAL_THREAD_LOCK(&comm->matching_lock);
+    OPAL_THREAD_LOCK(&proc->matching_lock);
+    return true;
+}
+
+static inline void mca_pml_ob1_match_unlock(mca_pml_ob1_comm_t* comm,
+                                            mca_pml_ob1_comm_proc_t* proc,
+                                            bool wild)
+{
+    OPAL_THREAD_UNLOCK(&proc->matching_lock);
+    if (wild) {
+        OPAL_THREAD_UNLOCK(&comm->matching_lock);
+    }
+}
+
 END_C_DECLS
 #endif
 
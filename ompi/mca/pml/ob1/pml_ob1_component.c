@@ -148,7 +148,8 @@ static int mca_pml_ob1_get_unex_msgq_size (mca_base_pvar_t *pvar, void *value, v
     for (i = 0 ; i < comm_size ; ++i) {
         pml_proc = pml_comm->procs + i;
 
-        values[i] = opal_list_get_size (&pml_proc->unexpected_frags);
+        values[i] = mca_pml_ob1_comm_queue_size (&pml_proc->unexpected_frags,
+                                                 pml_proc->unexpected_buckets);
     }
 
     return OMPI_SUCCESS;
@@ -166,7 +167,37 @@ static int mca_pml_ob1_get_posted_recvq_size (mca_base_pvar_t *pvar, void *value
     for (i = 0 ; i < comm_size ; ++i) {
         pml_proc = pml_comm->procs + i;
 
-        values[i] = opal_list_get_size (&pml_proc->specific_receives);
+        values[i] = mca_pml_ob1_comm_queue_size (&pml_proc->specific_receives,
+                                                 pml_proc->specific_buckets);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int mca_pml_ob1_get_unex_bytes (mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    *(unsigned long *) value = (unsigned long) mca_pml_ob1.unexpected_bytes;
+
+    return OMPI_SUCCESS;
+}
+
+static int mca_pml_ob1_rail_count_notify (mca_base_pvar_t *pvar, mca_base_pvar_event_t event, void *obj_handle, int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        /* rails may still be added when the handle is bound */
+        *count = MCA_PML_OB1_MAX_RAILS;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int mca_pml_ob1_get_rail_bandwidth (mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    double *values = (double *) value;
+    int i;
+
+    for (i = 0 ; i < MCA_PML_OB1_MAX_RAILS ; ++i) {
+        values[i] = (i < mca_pml_ob1.rail_count) ? mca_pml_ob1.rails[i].bandwidth : 0.0;
     }
 
     return OMPI_SUCCESS;
@@ -182,6 +213,20 @@ static int mca_pml_ob1_component_register(void)
     mca_pml_ob1_param_register_int("priority", 20, &mca_pml_ob1.priority);
     mca_pml_ob1_param_register_sizet("send_pipeline_depth", 3, &mca_pml_ob1.send_pipeline_depth);
     mca_pml_ob1_param_register_sizet("recv_pipeline_depth", 4, &mca_pml_ob1.recv_pipeline_depth);
+    /* packing is done fragment by fragment as earlier ones complete, so a deeper
+       pipeline keeps the wire busy while the next fragment is packed */
+    mca_pml_ob1_param_register_sizet("pack_pipeline_depth", 4, &mca_pml_ob1.pack_pipeline_depth);
+    if (0 == mca_pml_ob1.pack_pipeline_depth) {
+        mca_pml_ob1.pack_pipeline_depth = 1;
+    }
+    /* the put pipeline of unregistered buffers starts with small fragments
+       and doubles them as they complete, up to btl_rdma_pipeline_frag_size,
+       so the first bytes are not held by a large registration and the
+       registration of a fragment overlaps the transfer of the previous one */
+    mca_pml_ob1_param_register_sizet("rdma_pipeline_frag_min", 64 * 1024,
+                                     &mca_pml_ob1.rdma_pipeline_frag_min);
+    mca_pml_ob1_param_register_sizet("rdma_pipeline_btl_depth", 2,
+                                     &mca_pml_ob1.rdma_pipeline_btl_depth);
 
     /* NTH: we can get into a live-lock situation in the RDMA failure path so disable
        RDMA retries for now. Falling back to send may suck but it is better than
@@ -193,7 +238,74 @@ static int mca_pml_ob1_component_register(void)
     mca_pml_ob1_param_register_int("max_send_per_range", 4, &mca_pml_ob1.max_send_per_range);
 
     mca_pml_ob1_param_register_uint("unexpected_limit", 128, &mca_pml_ob1.unexpected_limit);
+
+    mca_pml_ob1.unexpected_max_bytes = 0;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "unexpected_max_bytes",
+                                           "Largest amount of unexpected message data buffered by the process "
+                                           "(0 = no limit).  Above it the peers of further unexpected messages "
+                                           "are asked to use the rendezvous protocol until the buffered data "
+                                           "drops under half of the limit",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.unexpected_max_bytes);
+
+    mca_pml_ob1.req_cache_size = 16;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "req_cache_size",
+                                           "Number of send or receive requests moved at a time between the "
+                                           "free lists and the request cache of each thread, when running "
+                                           "with threads (0 = no per-thread caches)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.req_cache_size);
+
+    mca_pml_ob1.match_buckets = 0;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "match_buckets",
+                                           "Number of tag buckets used for the posted receive and unexpected "
+                                           "message queues of each peer (0 = use linear queues).  Useful when "
+                                           "many receives with distinct tags are outstanding.  Rounded up to "
+                                           "a power of 2",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.match_buckets);
+    if (0 != mca_pml_ob1.match_buckets) {
+        unsigned int buckets = 1;
+        while (buckets < mca_pml_ob1.match_buckets) {
+            buckets <<= 1;
+        }
+        mca_pml_ob1.match_buckets = buckets;
+    }
  
+    mca_pml_ob1.adaptive_striping = false;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "adaptive_striping",
+                                           "Split large messages between the BTLs according to the throughput "
+                                           "measured on each of them instead of their bandwidth parameter.  The "
+                                           "split of the part of the message not yet scheduled is updated as "
+                                           "fragments complete",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.adaptive_striping);
+
+    mca_pml_ob1.coalesce_size = 0;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "coalesce_size",
+                                           "Short standard sends of at most this many bytes to the same peer "
+                                           "are copied together into a single fragment (0 = disabled)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.coalesce_size);
+
+    mca_pml_ob1.coalesce_window = 0;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "coalesce_window",
+                                           "Time in microseconds a fragment of coalesced messages which is "
+                                           "not full waits for more messages (0 = until the next progress call)",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.coalesce_window);
+
+    mca_pml_ob1.compact_match_size = 64;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "compact_match_size",
+                                           "Eager messages of at most this many bytes are sent with a 10 byte "
+                                           "match header when the source rank and tag fit in 16 bits "
+                                           "(0 = disabled, at most 256)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.compact_match_size);
+    if (mca_pml_ob1.compact_match_size > MCA_PML_OB1_CMATCH_MAX_PAYLOAD) {
+        mca_pml_ob1.compact_match_size = MCA_PML_OB1_CMATCH_MAX_PAYLOAD;
+    }
+
     mca_pml_ob1.allocator_name = "bucket";
     (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "allocator",
                                            "Name of allocator component for unexpected messages",
@@ -212,6 +324,36 @@ static int mca_pml_ob1_component_register(void)
                                    MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
                                    mca_pml_ob1_get_posted_recvq_size, NULL, mca_pml_ob1_comm_size_notify, NULL);
 
+    (void) mca_base_pvar_register ("ompi", "pml", "ob1", "unexpected_bytes", "Amount of message data currently "
+                                   "buffered by the process for messages not yet matched by a receive",
+                                   OPAL_INFO_LVL_4, MPI_T_PVAR_CLASS_SIZE, MCA_BASE_VAR_TYPE_UNSIGNED_LONG, NULL,
+                                   MPI_T_BIND_NO_OBJECT, MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                   mca_pml_ob1_get_unex_bytes, NULL, NULL, NULL);
+
+    (void) mca_base_pvar_register ("ompi", "pml", "ob1", "rail_bandwidth", "Throughput in MB/s measured on each "
+                                   "BTL module used for large messages, in the order of the BTL modules (0 if not "
+                                   "measured).  Only measured with pml_ob1_adaptive_striping", OPAL_INFO_LVL_4,
+                                   MPI_T_PVAR_CLASS_GENERIC, MCA_BASE_VAR_TYPE_DOUBLE, NULL, MPI_T_BIND_NO_OBJECT,
+                                   MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                   mca_pml_ob1_get_rail_bandwidth, NULL, mca_pml_ob1_rail_count_notify, NULL);
+
+    (void) ompi_pvar_counter_register("pml", "ob1", "protocol_count", "Number of messages sent with the "
+                                      "eager, rendezvous and RDMA (pipelined or get) protocols, and number of "
+                                      "messages received before the matching receive was posted",
+                                      mca_pml_ob1.protocol_count, MCA_PML_OB1_PROTOCOL_MAX);
+    (void) ompi_pvar_timer_register("pml", "ob1", "match_time", "Time spent searching the posted receives "
+                                    "for the match of incoming messages",
+                                    &mca_pml_ob1.match_time, 1);
+
+    (void) ompi_pvar_free_list_register("pml", "ob1", "send_requests_allocated", "Largest number of send "
+                                        "requests allocated", &mca_pml_base_send_requests);
+    (void) ompi_pvar_free_list_register("pml", "ob1", "recv_requests_allocated", "Largest number of receive "
+                                        "requests allocated", &mca_pml_base_recv_requests);
+    (void) ompi_pvar_free_list_register("pml", "ob1", "recv_frags_allocated", "Largest number of fragments "
+                                        "allocated for unexpected messages", &mca_pml_ob1.recv_frags);
+    (void) ompi_pvar_free_list_register("pml", "ob1", "rdma_frags_allocated", "Largest number of RDMA "
+                                        "fragments allocated", &mca_pml_ob1.rdma_frags);
+
     return OMPI_SUCCESS;
 }
 
@@ -292,6 +434,7 @@ int mca_pml_ob1_component_fini(void)
 
     if(!mca_pml_ob1.enabled)
         return OMPI_SUCCESS; /* never selected.. return success.. */  
+    mca_pml_ob1_req_cache_fini();
     mca_pml_ob1.enabled = false;  /* not anymore */
 
     OBJ_DESTRUCT(&mca_pml_ob1.rdma_pending);
@@ -303,6 +446,9 @@ int mca_pml_ob1_component_fini(void)
     OBJ_DESTRUCT(&mca_pml_ob1.pending_pckts);
     OBJ_DESTRUCT(&mca_pml_ob1.recv_frags);
     OBJ_DESTRUCT(&mca_pml_ob1.rdma_frags);
+    OBJ_DESTRUCT(&mca_pml_ob1.coalesce_pending);
+    OBJ_DESTRUCT(&mca_pml_ob1.coalesce_lock);
+    OBJ_DESTRUCT(&mca_pml_ob1.rail_lock);
     OBJ_DESTRUCT(&mca_pml_ob1.lock);
 
     if(OMPI_SUCCESS != (rc = mca_pml_ob1.allocator->alc_finalize(mca_pml_ob1.allocator))) {
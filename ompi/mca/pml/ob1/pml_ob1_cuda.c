@@ -125,6 +125,7 @@ size_t mca_pml_ob1_rdma_cuda_btls(
 
             rdma_btls[num_btls_used].bml_btl = bml_btl;
             rdma_btls[num_btls_used].btl_reg = reg;
+            rdma_btls[num_btls_used].pipeline_depth = 0;
             weight_total += bml_btl->btl_weight;
             num_btls_used++;
         }
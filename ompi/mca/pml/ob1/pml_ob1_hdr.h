@@ -47,6 +47,9 @@
 #define MCA_PML_OB1_HDR_TYPE_GET       (MCA_BTL_TAG_PML + 7)
 #define MCA_PML_OB1_HDR_TYPE_PUT       (MCA_BTL_TAG_PML + 8)
 #define MCA_PML_OB1_HDR_TYPE_FIN       (MCA_BTL_TAG_PML + 9)
+#define MCA_PML_OB1_HDR_TYPE_AGGR      (MCA_BTL_TAG_PML + 10)
+#define MCA_PML_OB1_HDR_TYPE_CMATCH    (MCA_BTL_TAG_PML + 11)
+#define MCA_PML_OB1_HDR_TYPE_FLOW      (MCA_BTL_TAG_PML + 12)
 
 #define MCA_PML_OB1_HDR_FLAGS_ACK     1  /* is an ack required */
 #define MCA_PML_OB1_HDR_FLAGS_NBO     2  /* is the hdr in network byte order */
@@ -117,6 +120,35 @@ do { \
     (h).hdr_seq = htons((h).hdr_seq); \
 } while (0) 
 
+/**
+ *  Compact form of the match header for short eager messages whose
+ *  source rank and tag fit in 16 bits. The receiver expands it back
+ *  into a mca_pml_ob1_match_hdr_t before matching, so it is only used
+ *  for payloads up to MCA_PML_OB1_CMATCH_MAX_PAYLOAD bytes, and only
+ *  between processes with the same architecture.
+ */
+struct mca_pml_ob1_cmatch_hdr_t {
+    mca_pml_ob1_common_hdr_t hdr_common;   /**< common attributes */
+    uint16_t hdr_ctx;                      /**< communicator index */
+    uint16_t hdr_src;                      /**< source rank */
+    int16_t  hdr_tag;                      /**< user tag */
+    uint16_t hdr_seq;                      /**< message sequence number */
+};
+typedef struct mca_pml_ob1_cmatch_hdr_t mca_pml_ob1_cmatch_hdr_t;
+
+#define OMPI_PML_OB1_CMATCH_HDR_LEN     10
+#define MCA_PML_OB1_CMATCH_MAX_PAYLOAD  256
+
+/* can this send use the compact match header */
+#if OPAL_ENABLE_HETEROGENEOUS_SUPPORT
+#define MCA_PML_OB1_CMATCH_ELIGIBLE(rank, tag, size) false
+#else
+#define MCA_PML_OB1_CMATCH_ELIGIBLE(rank, tag, size)                    \
+    ((size) <= mca_pml_ob1.compact_match_size &&                        \
+     (rank) <= UINT16_MAX &&                                            \
+     (tag) >= INT16_MIN && (tag) <= INT16_MAX)
+#endif
+
 /**
  * Header definition for the first fragment when an acknowledgment
  * is required. This could be the first fragment of a large message
@@ -335,6 +367,21 @@ struct mca_pml_ob1_fin_hdr_t {
 };
 typedef struct mca_pml_ob1_fin_hdr_t mca_pml_ob1_fin_hdr_t;
 
+/**
+ *  Header of a fragment holding several short messages. It is followed
+ *  by hdr_count entries, each one a 32 bit length and the match header
+ *  and data of a message, padded to 4 bytes. Only sent between processes
+ *  with the same architecture.
+ */
+struct mca_pml_ob1_aggr_hdr_t {
+    mca_pml_ob1_common_hdr_t hdr_common;      /**< common attributes */
+    uint16_t hdr_count;                       /**< number of messages */
+    uint32_t hdr_padding;
+};
+typedef struct mca_pml_ob1_aggr_hdr_t mca_pml_ob1_aggr_hdr_t;
+
+#define MCA_PML_OB1_AGGR_ENTRY_ALIGN(len) (((len) + 3) & ~((size_t) 3))
+
 #if OPAL_ENABLE_HETEROGENEOUS_SUPPORT && OPAL_ENABLE_DEBUG
 #define MCA_PML_OB1_FIN_HDR_FILL(h) \
 do {                                \
@@ -356,6 +403,36 @@ do {                                \
         MCA_PML_OB1_FIN_HDR_FILL(h); \
     } while (0) 
 
+/**
+ *  Flow control notice sent by a receiver to a peer. While hdr_eager is 0
+ *  the peer starts its messages on the communicator with a rendezvous
+ *  carrying no data, so that the receiver does not buffer anything more
+ *  from it before the receive is posted.
+ */
+struct mca_pml_ob1_flow_hdr_t {
+    mca_pml_ob1_common_hdr_t hdr_common;      /**< common attributes */
+    uint16_t hdr_ctx;                         /**< communicator index */
+    int32_t  hdr_src;                         /**< rank of the receiver in the communicator */
+    uint32_t hdr_eager;                       /**< eager data is accepted again */
+};
+typedef struct mca_pml_ob1_flow_hdr_t mca_pml_ob1_flow_hdr_t;
+
+#define MCA_PML_OB1_FLOW_HDR_NTOH(h) \
+    do { \
+        MCA_PML_OB1_COMMON_HDR_NTOH((h).hdr_common); \
+        (h).hdr_ctx = ntohs((h).hdr_ctx); \
+        (h).hdr_src = ntohl((h).hdr_src); \
+        (h).hdr_eager = ntohl((h).hdr_eager); \
+    } while (0)
+
+#define MCA_PML_OB1_FLOW_HDR_HTON(h) \
+    do { \
+        MCA_PML_OB1_COMMON_HDR_HTON((h).hdr_common); \
+        (h).hdr_ctx = htons((h).hdr_ctx); \
+        (h).hdr_src = htonl((h).hdr_src); \
+        (h).hdr_eager = htonl((h).hdr_eager); \
+    } while (0)
+
 /**
  * Union of defined hdr types.
  */
@@ -368,6 +445,7 @@ union mca_pml_ob1_hdr_t {
     mca_pml_ob1_ack_hdr_t hdr_ack;
     mca_pml_ob1_rdma_hdr_t hdr_rdma;
     mca_pml_ob1_fin_hdr_t hdr_fin;
+    mca_pml_ob1_flow_hdr_t hdr_flow;
 };
 typedef union mca_pml_ob1_hdr_t mca_pml_ob1_hdr_t;
 
@@ -400,6 +478,9 @@ ob1_hdr_ntoh(mca_pml_ob1_hdr_t *hdr, const uint8_t hdr_type)
         case MCA_PML_OB1_HDR_TYPE_FIN:
             MCA_PML_OB1_FIN_HDR_NTOH(hdr->hdr_fin);
             break;
+        case MCA_PML_OB1_HDR_TYPE_FLOW:
+            MCA_PML_OB1_FLOW_HDR_NTOH(hdr->hdr_flow);
+            break;
         default:
             assert(0);
             break;
@@ -446,6 +527,9 @@ ob1_hdr_hton_intr(mca_pml_ob1_hdr_t *hdr, const uint8_t hdr_type,
         case MCA_PML_OB1_HDR_TYPE_FIN:
             MCA_PML_OB1_FIN_HDR_HTON(hdr->hdr_fin);
             break;
+        case MCA_PML_OB1_HDR_TYPE_FLOW:
+            MCA_PML_OB1_FLOW_HDR_HTON(hdr->hdr_flow);
+            break;
         default:
             assert(0);
             break;
@@ -22,7 +22,35 @@
 #include "ompi/request/request.h"
 #include "ompi/message/message.h"
 #include "pml_ob1_recvreq.h"
+#include "pml_ob1_comm.h"
 
+/*
+ * Whether a probe can only fail: the source is specific and has no
+ * unexpected fragment the tag could match.  Read without the matching
+ * lock, a fragment arriving meanwhile might as well have arrived after
+ * the probe.
+ */
+static inline bool probe_cannot_match(int src, int tag,
+                                      struct ompi_communicator_t *comm)
+{
+    mca_pml_ob1_comm_proc_t *proc;
+
+    if (OMPI_ANY_SOURCE == src) {
+        return false;
+    }
+    proc = &((mca_pml_ob1_comm_t *) comm->c_pml_comm)->procs[src];
+    if (0 == mca_pml_ob1.match_buckets) {
+        return opal_list_is_empty(&proc->unexpected_frags);
+    }
+    if (OMPI_ANY_TAG == tag) {
+        return false;
+    }
+    /* the buckets only exist once something was queued */
+    if (NULL == proc->unexpected_buckets) {
+        return true;
+    }
+    return opal_list_is_empty(proc->unexpected_buckets + mca_pml_ob1_tag_bucket(tag));
+}
 
 int mca_pml_ob1_iprobe(int src,
                        int tag,
@@ -32,6 +60,12 @@ int mca_pml_ob1_iprobe(int src,
     int rc = OMPI_SUCCESS;
     mca_pml_ob1_recv_request_t recvreq;
 
+    if (probe_cannot_match(src, tag, comm)) {
+        *matched = 0;
+        opal_progress();
+        return OMPI_SUCCESS;
+    }
+
     OBJ_CONSTRUCT( &recvreq, mca_pml_ob1_recv_request_t );
     recvreq.req_recv.req_base.req_ompi.req_type = OMPI_REQUEST_PML;
     recvreq.req_recv.req_base.req_type = MCA_PML_REQUEST_IPROBE;
@@ -91,6 +125,15 @@ mca_pml_ob1_improbe(int src,
     int rc = OMPI_SUCCESS;
     mca_pml_ob1_recv_request_t *recvreq;
 
+    /* a polling receiver mostly misses: do it without the message and
+       the request */
+    if (probe_cannot_match(src, tag, comm)) {
+        *matched = 0;
+        *message = MPI_MESSAGE_NULL;
+        opal_progress();
+        return OMPI_SUCCESS;
+    }
+
     *message = ompi_message_alloc();
     if (NULL == *message) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
 
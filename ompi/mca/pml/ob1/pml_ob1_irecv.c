@@ -113,12 +113,16 @@ int mca_pml_ob1_recv(void *addr,
 }
 
 
-int
-mca_pml_ob1_imrecv( void *buf,
-                    size_t count,
-                    ompi_datatype_t *datatype,
-                    struct ompi_message_t **message,
-                    struct ompi_request_t **request )
+/*
+ * Turn the request of a matched probe back into a receive request and
+ * start it on the fragment the probe took out of the unexpected queue,
+ * without going through the matching again.
+ */
+static mca_pml_ob1_recv_request_t *
+mrecv_start( void *buf,
+             size_t count,
+             ompi_datatype_t *datatype,
+             struct ompi_message_t **message )
 {
     mca_pml_ob1_recv_frag_t* frag;
     mca_pml_ob1_recv_request_t *recvreq;
@@ -160,11 +164,12 @@ mca_pml_ob1_imrecv( void *buf,
                              &((recvreq)->req_recv.req_base),
                              PERUSE_RECV);
 
-    /* init/re-init the request */
+    /* init/re-init the request, as mca_pml_ob1_recv_req_start does */
     recvreq->req_lock = 0;
     recvreq->req_pipeline_depth  = 0;
     recvreq->req_bytes_received  = 0;
-    /* What about req_rdma_cnt ? */
+    recvreq->req_bytes_expected  = 0;
+    recvreq->req_rdma_cnt = 0;
     recvreq->req_rdma_idx = 0;
     recvreq->req_pending = false;
     recvreq->req_ack_sent = false;
@@ -198,12 +203,24 @@ mca_pml_ob1_imrecv( void *buf,
     default:
         assert(0);
     }
+    /* whatever the protocol needs from the frag was taken by now, as
+       when the frag is matched by a posted receive */
     MCA_PML_OB1_RECV_FRAG_RETURN(frag);
     
     ompi_message_return(*message);
     *message = MPI_MESSAGE_NULL;
-    *request = (ompi_request_t *) recvreq;
+    return recvreq;
+}
+
 
+int
+mca_pml_ob1_imrecv( void *buf,
+                    size_t count,
+                    ompi_datatype_t *datatype,
+                    struct ompi_message_t **message,
+                    struct ompi_request_t **request )
+{
+    *request = (ompi_request_t *) mrecv_start(buf, count, datatype, message);
     return OMPI_SUCCESS;
 }
 
@@ -215,90 +232,12 @@ mca_pml_ob1_mrecv( void *buf,
                    struct ompi_message_t **message,
                    ompi_status_public_t* status )
 {
-    mca_pml_ob1_recv_frag_t* frag;
     mca_pml_ob1_recv_request_t *recvreq;
-    mca_pml_ob1_hdr_t *hdr;
-    int src, tag, rc;
-    ompi_communicator_t *comm;
-    mca_pml_ob1_comm_proc_t* proc;
-    mca_pml_ob1_comm_t* ob1_comm;
-    uint64_t seq;
-
-    /* get the request from the message and the frag from the request
-       before we overwrite everything */
-    comm = (*message)->comm;
-    recvreq = (mca_pml_ob1_recv_request_t*) (*message)->req_ptr;
-    frag = (mca_pml_ob1_recv_frag_t*) recvreq->req_recv.req_base.req_addr;
-    src = recvreq->req_recv.req_base.req_ompi.req_status.MPI_SOURCE;
-    tag = recvreq->req_recv.req_base.req_ompi.req_status.MPI_TAG;
-    seq = recvreq->req_recv.req_base.req_sequence;
-    ob1_comm = recvreq->req_recv.req_base.req_comm->c_pml_comm;
-
-    /* make the request a recv request again */
-    /* The old request kept pointers to comm and the char datatype.
-       We're about to release those, but need to make sure comm
-       doesn't go out of scope (we don't care about the char datatype
-       anymore).  So retain comm, then release the frag, then reinit
-       the frag (which will retain comm), then release comm (but the
-       frag still has it's ref, so it'll stay in scope).  Make
-       sense? */
-    OBJ_RETAIN(comm);
-    MCA_PML_BASE_RECV_REQUEST_FINI(&recvreq->req_recv);
-    recvreq->req_recv.req_base.req_type = MCA_PML_REQUEST_RECV;
-    MCA_PML_OB1_RECV_REQUEST_INIT(recvreq,
-                                  buf,
-                                  count, datatype, 
-                                  src, tag, comm, false);
-    OBJ_RELEASE(comm);
-
-    PERUSE_TRACE_COMM_EVENT (PERUSE_COMM_REQ_ACTIVATE,
-                             &((recvreq)->req_recv.req_base),
-                             PERUSE_RECV);
-
-    /* init/re-init the request */
-    recvreq->req_lock = 0;
-    recvreq->req_pipeline_depth  = 0;
-    recvreq->req_bytes_received  = 0;
-    recvreq->req_rdma_cnt = 0;
-    recvreq->req_rdma_idx = 0;
-    recvreq->req_pending = false;
-
-    MCA_PML_BASE_RECV_START(&recvreq->req_recv.req_base);
-
-    /* Note - sequence number already assigned */
-    recvreq->req_recv.req_base.req_sequence = seq;
-
-    proc = &ob1_comm->procs[recvreq->req_recv.req_base.req_peer];
-    recvreq->req_recv.req_base.req_proc = proc->ompi_proc;
-    prepare_recv_req_converter(recvreq);
+    int rc;
 
-    /* we can't go through the match, since we already have the match.
-       Cheat and do what REQUEST_START does, but without the frag
-       search */
-    hdr = (mca_pml_ob1_hdr_t*)frag->segments->seg_addr.pval;
-    switch(hdr->hdr_common.hdr_type) {
-    case MCA_PML_OB1_HDR_TYPE_MATCH:
-        mca_pml_ob1_recv_request_progress_match(recvreq, frag->btl, frag->segments,
-                                                frag->num_segments);
-        break;
-    case MCA_PML_OB1_HDR_TYPE_RNDV:
-        mca_pml_ob1_recv_request_progress_rndv(recvreq, frag->btl, frag->segments,
-                                               frag->num_segments);
-        break;
-    case MCA_PML_OB1_HDR_TYPE_RGET:
-        mca_pml_ob1_recv_request_progress_rget(recvreq, frag->btl, frag->segments,
-                                               frag->num_segments);
-        break;
-    default:
-        assert(0);
-    }
-    
-    ompi_message_return(*message);
-    *message = MPI_MESSAGE_NULL;
+    recvreq = mrecv_start(buf, count, datatype, message);
     ompi_request_wait_completion(&(recvreq->req_recv.req_base.req_ompi));
 
-    MCA_PML_OB1_RECV_FRAG_RETURN(frag);
-
     if (NULL != status) {  /* return status */
         *status = recvreq->req_recv.req_base.req_ompi.req_status;
     }
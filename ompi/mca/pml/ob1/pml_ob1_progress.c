@@ -20,6 +20,7 @@
 #include "ompi_config.h"
 
 #include "pml_ob1.h"
+#include "pml_ob1_coalesce.h"
 #include "pml_ob1_sendreq.h"
 #include "ompi/mca/bml/base/base.h" 
 #if OMPI_CUDA_SUPPORT
@@ -39,6 +40,9 @@ int mca_pml_ob1_progress(void)
     mca_pml_ob1_process_pending_cuda_async_copies();
 #endif /* OMPI_CUDA_SUPPORT */
 
+    if( OPAL_UNLIKELY(0 != opal_list_get_size(&mca_pml_ob1.coalesce_pending)) )
+        mca_pml_ob1_coalesce_progress();
+
     if( OPAL_LIKELY(0 == queue_length) )
         return 0;
 
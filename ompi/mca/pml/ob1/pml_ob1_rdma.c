@@ -20,6 +20,10 @@
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
 #include "ompi_config.h"
+
+#include <string.h>
+
+#include "opal/mca/timer/base/base.h"
 #include "ompi/constants.h"
 #include "ompi/mca/pml/pml.h"
 #include "ompi/mca/bml/bml.h"
@@ -76,6 +80,7 @@ size_t mca_pml_ob1_rdma_btls(
 
         rdma_btls[num_btls_used].bml_btl = bml_btl;
         rdma_btls[num_btls_used].btl_reg = reg;
+        rdma_btls[num_btls_used].pipeline_depth = 0;
         weight_total += bml_btl->btl_weight;
         num_btls_used++;
     }
@@ -107,6 +112,7 @@ size_t mca_pml_ob1_rdma_pipeline_btls( mca_bml_base_endpoint_t* bml_endpoint,
             rdma_btls[i].btl_reg = NULL;
         else
             rdma_btls[i].btl_reg = &pml_ob1_dummy_reg;
+        rdma_btls[i].pipeline_depth = 0;
 
         weight_total += rdma_btls[i].bml_btl->btl_weight;
     }
@@ -115,3 +121,83 @@ size_t mca_pml_ob1_rdma_pipeline_btls( mca_bml_base_endpoint_t* bml_endpoint,
 
     return i;
 }
+
+/*
+ * Throughput of the rails for adaptive striping. A sample is the number
+ * of bytes completed on a rail divided by the time the rail was busy,
+ * samples shorter than MCA_PML_OB1_RAIL_SAMPLE_USEC are accumulated so
+ * that the timer resolution and small fragments do not add noise. The
+ * samples are smoothed so that a single slow operation does not move all
+ * the traffic away from a rail.
+ */
+#define MCA_PML_OB1_RAIL_SAMPLE_USEC 100
+
+void mca_pml_ob1_rail_add(struct mca_btl_base_module_t *btl)
+{
+    if (NULL != mca_pml_ob1_rail_lookup(btl) ||
+        MCA_PML_OB1_MAX_RAILS == mca_pml_ob1.rail_count) {
+        return;
+    }
+
+    memset(mca_pml_ob1.rails + mca_pml_ob1.rail_count, 0, sizeof(mca_pml_ob1_rail_t));
+    mca_pml_ob1.rails[mca_pml_ob1.rail_count].btl = btl;
+    /* the lookups do not take the lock */
+    opal_atomic_wmb();
+    mca_pml_ob1.rail_count++;
+}
+
+void mca_pml_ob1_rail_start_slow(struct mca_btl_base_module_t *btl)
+{
+    mca_pml_ob1_rail_t *rail = mca_pml_ob1_rail_lookup(btl);
+
+    if (OPAL_UNLIKELY(NULL == rail)) {
+        return;
+    }
+
+    OPAL_THREAD_LOCK(&mca_pml_ob1.rail_lock);
+    if (0 == rail->in_flight++) {
+        rail->busy_since = opal_timer_base_get_usec();
+    }
+    OPAL_THREAD_UNLOCK(&mca_pml_ob1.rail_lock);
+}
+
+void mca_pml_ob1_rail_complete_slow(struct mca_btl_base_module_t *btl, size_t bytes)
+{
+    mca_pml_ob1_rail_t *rail = mca_pml_ob1_rail_lookup(btl);
+    uint64_t now, busy;
+    double sample;
+
+    if (OPAL_UNLIKELY(NULL == rail)) {
+        return;
+    }
+
+    now = opal_timer_base_get_usec();
+
+    OPAL_THREAD_LOCK(&mca_pml_ob1.rail_lock);
+    if (OPAL_UNLIKELY(0 == rail->in_flight)) {
+        /* started before the rail was added */
+        OPAL_THREAD_UNLOCK(&mca_pml_ob1.rail_lock);
+        return;
+    }
+
+    rail->sample_bytes += bytes;
+    busy = rail->sample_usec + (now - rail->busy_since);
+
+    if (busy >= MCA_PML_OB1_RAIL_SAMPLE_USEC && 0 != rail->sample_bytes) {
+        sample = (double) rail->sample_bytes / (double) busy;
+        if (0 == rail->bandwidth) {
+            rail->bandwidth = sample;
+        } else {
+            rail->bandwidth = 0.75 * rail->bandwidth + 0.25 * sample;
+        }
+        rail->sample_bytes = 0;
+        rail->sample_usec = 0;
+        rail->busy_since = now;
+    } else if (1 == rail->in_flight) {
+        /* the rail goes idle, keep the busy time for the next sample */
+        rail->sample_usec = busy;
+    }
+
+    rail->in_flight--;
+    OPAL_THREAD_UNLOCK(&mca_pml_ob1.rail_lock);
+}
@@ -49,6 +49,15 @@
 #include "ompi/mca/common/cuda/common_cuda.h"
 #endif /* OMPI_CUDA_SUPPORT */
 
+#if OMPI_ENABLE_PVAR_COUNTERS
+#define MCA_PML_OB1_RECV_FRAG_COUNT(btl, des)                            \
+    mca_btl_base_pvar_count((btl), MCA_BTL_BASE_PVAR_FRAGS_RECV,         \
+                            mca_btl_base_segments_size((des)->des_dst,   \
+                                                       (des)->des_dst_cnt))
+#else
+#define MCA_PML_OB1_RECV_FRAG_COUNT(btl, des)
+#endif
+
 OBJ_CLASS_INSTANCE( mca_pml_ob1_buffer_t,
                     ompi_free_list_item_t,
                     NULL,
@@ -66,9 +75,9 @@ OBJ_CLASS_INSTANCE( mca_pml_ob1_recv_frag_t,
 /**
  * Append a unexpected descriptor to a queue. This function will allocate and
  * initialize the fragment (if necessary) and then will add it to the specified
- * queue. The allocated fragment is not returned to the caller.
+ * queue. The fragment is returned to the caller.
  */
-static void
+static mca_pml_ob1_recv_frag_t*
 append_frag_to_list(opal_list_t *queue, mca_btl_base_module_t *btl,
                     mca_pml_ob1_match_hdr_t *hdr, mca_btl_base_segment_t* segments,
                     size_t num_segments, mca_pml_ob1_recv_frag_t* frag)
@@ -78,6 +87,7 @@ append_frag_to_list(opal_list_t *queue, mca_btl_base_module_t *btl,
         MCA_PML_OB1_RECV_FRAG_INIT(frag, hdr, segments, num_segments, btl);
     }
     opal_list_append(queue, (opal_list_item_t*)frag);
+    return frag;
 }
 
 /**
@@ -101,7 +111,7 @@ match_one(mca_btl_base_module_t *btl,
           mca_pml_ob1_match_hdr_t *hdr, mca_btl_base_segment_t* segments,
           size_t num_segments, ompi_communicator_t *comm_ptr,
           mca_pml_ob1_comm_proc_t *proc,
-          mca_pml_ob1_recv_frag_t* frag);
+          mca_pml_ob1_recv_frag_t* frag, bool wild);
  
 void mca_pml_ob1_recv_frag_callback_match(mca_btl_base_module_t* btl, 
                                           mca_btl_base_tag_t tag,
@@ -116,8 +126,10 @@ void mca_pml_ob1_recv_frag_callback_match(mca_btl_base_module_t* btl,
     mca_pml_ob1_comm_proc_t *proc;
     size_t num_segments = des->des_dst_cnt;
     size_t bytes_received = 0;
+    bool wild;
 
     assert(num_segments <= MCA_BTL_DES_MAX_SEGMENTS);
+    MCA_PML_OB1_RECV_FRAG_COUNT(btl, des);
     
     if( OPAL_UNLIKELY(segments->seg_len < OMPI_PML_OB1_MATCH_HDR_LEN) ) {
         return;
@@ -159,20 +171,22 @@ void mca_pml_ob1_recv_frag_callback_match(mca_btl_base_module_t* btl,
      * end points) from being processed, and potentially "loosing"
      * the fragment.
      */
-    OPAL_THREAD_LOCK(&comm->matching_lock);
+    wild = mca_pml_ob1_match_lock(comm, proc);
     
-     /* get sequence number of next message that can be processed */
-    if(OPAL_UNLIKELY((((uint16_t) hdr->hdr_seq) != ((uint16_t) proc->expected_sequence)) ||
-                     (opal_list_get_size(&proc->frags_cant_match) > 0 ))) {
-        goto slow_path;
+    if(OPAL_LIKELY(mca_pml_ob1_comm_ordered(comm, hdr->hdr_tag))) {
+        /* get sequence number of next message that can be processed */
+        if(OPAL_UNLIKELY((((uint16_t) hdr->hdr_seq) != ((uint16_t) proc->expected_sequence)) ||
+                         (opal_list_get_size(&proc->frags_cant_match) > 0 ))) {
+            goto slow_path;
+        }
+
+        /* This is the sequence number we were expecting, so we can try
+         * matching it to already posted receives.
+         */
+
+        /* We're now expecting the next sequence number. */
+        proc->expected_sequence++;
     }
-    
-    /* This is the sequence number we were expecting, so we can try
-     * matching it to already posted receives.
-     */
-    
-    /* We're now expecting the next sequence number. */
-    proc->expected_sequence++;
 
     /* We generate the SEARCH_POSTED_QUEUE only when the message is
      * received in the correct sequence. Otherwise, we delay the event
@@ -181,7 +195,7 @@ void mca_pml_ob1_recv_frag_callback_match(mca_btl_base_module_t* btl,
     PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_SEARCH_POSTED_Q_BEGIN, comm_ptr,
                             hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
     
-    match = match_one(btl, hdr, segments, num_segments, comm_ptr, proc, NULL);
+    match = match_one(btl, hdr, segments, num_segments, comm_ptr, proc, NULL, wild);
     
     /* The match is over. We generate the SEARCH_POSTED_Q_END here,
      * before going into the mca_pml_ob1_check_cantmatch_for_match so
@@ -192,7 +206,7 @@ void mca_pml_ob1_recv_frag_callback_match(mca_btl_base_module_t* btl,
                            hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
     
     /* release matching lock before processing fragment */
-    OPAL_THREAD_UNLOCK(&comm->matching_lock);
+    mca_pml_ob1_match_unlock(comm, proc, wild);
 
     if(OPAL_LIKELY(match)) {
         bytes_received = segments->seg_len - OMPI_PML_OB1_MATCH_HDR_LEN;
@@ -245,12 +259,65 @@ void mca_pml_ob1_recv_frag_callback_match(mca_btl_base_module_t* btl,
     return;
     
  slow_path:
-    OPAL_THREAD_UNLOCK(&comm->matching_lock);
+    mca_pml_ob1_match_unlock(comm, proc, wild);
     mca_pml_ob1_recv_frag_match(btl, hdr, segments,
                                 num_segments, MCA_PML_OB1_HDR_TYPE_MATCH);
 }
 
 
+void mca_pml_ob1_recv_frag_callback_cmatch(mca_btl_base_module_t* btl,
+                                           mca_btl_base_tag_t tag,
+                                           mca_btl_base_descriptor_t* des,
+                                           void* cbdata )
+{
+    mca_btl_base_segment_t* segments = des->des_dst;
+    mca_pml_ob1_cmatch_hdr_t* chdr = (mca_pml_ob1_cmatch_hdr_t*)segments->seg_addr.pval;
+    union {
+        mca_pml_ob1_match_hdr_t hdr;
+        unsigned char bytes[OMPI_PML_OB1_MATCH_HDR_LEN + MCA_PML_OB1_CMATCH_MAX_PAYLOAD];
+    } buffer;
+    mca_btl_base_descriptor_t message;
+    mca_btl_base_segment_t segment;
+    unsigned char *ptr;
+    size_t i, length;
+
+    if( OPAL_UNLIKELY(segments->seg_len < OMPI_PML_OB1_CMATCH_HDR_LEN) ) {
+        return;
+    }
+    length = segments->seg_len - OMPI_PML_OB1_CMATCH_HDR_LEN;
+    for( i = 1; i < des->des_dst_cnt; i++ ) {
+        length += segments[i].seg_len;
+    }
+    if( OPAL_UNLIKELY(length > MCA_PML_OB1_CMATCH_MAX_PAYLOAD) ) {
+        return;
+    }
+
+    /* rebuild the full match header in front of a copy of the payload,
+     * which is small by construction, and match it as usual */
+    buffer.hdr.hdr_common.hdr_type = MCA_PML_OB1_HDR_TYPE_MATCH;
+    buffer.hdr.hdr_common.hdr_flags = chdr->hdr_common.hdr_flags;
+    buffer.hdr.hdr_ctx = chdr->hdr_ctx;
+    buffer.hdr.hdr_src = chdr->hdr_src;
+    buffer.hdr.hdr_tag = chdr->hdr_tag;
+    buffer.hdr.hdr_seq = chdr->hdr_seq;
+
+    ptr = buffer.bytes + OMPI_PML_OB1_MATCH_HDR_LEN;
+    memcpy(ptr, (unsigned char*)chdr + OMPI_PML_OB1_CMATCH_HDR_LEN,
+           segments->seg_len - OMPI_PML_OB1_CMATCH_HDR_LEN);
+    ptr += segments->seg_len - OMPI_PML_OB1_CMATCH_HDR_LEN;
+    for( i = 1; i < des->des_dst_cnt; i++ ) {
+        memcpy(ptr, segments[i].seg_addr.pval, segments[i].seg_len);
+        ptr += segments[i].seg_len;
+    }
+
+    memset(&message, 0, sizeof(message));
+    segment.seg_addr.pval = buffer.bytes;
+    segment.seg_len = OMPI_PML_OB1_MATCH_HDR_LEN + length;
+    message.des_dst = &segment;
+    message.des_dst_cnt = 1;
+    mca_pml_ob1_recv_frag_callback_match(btl, MCA_PML_OB1_HDR_TYPE_MATCH, &message, cbdata);
+}
+
 void mca_pml_ob1_recv_frag_callback_rndv(mca_btl_base_module_t* btl, 
                                          mca_btl_base_tag_t tag,
                                          mca_btl_base_descriptor_t* des,
@@ -259,6 +326,7 @@ void mca_pml_ob1_recv_frag_callback_rndv(mca_btl_base_module_t* btl,
     mca_btl_base_segment_t* segments = des->des_dst;
     mca_pml_ob1_hdr_t* hdr = (mca_pml_ob1_hdr_t*)segments->seg_addr.pval;
     
+    MCA_PML_OB1_RECV_FRAG_COUNT(btl, des);
     if( OPAL_UNLIKELY(segments->seg_len < sizeof(mca_pml_ob1_common_hdr_t)) ) {
         return;
     }
@@ -276,6 +344,7 @@ void mca_pml_ob1_recv_frag_callback_rget(mca_btl_base_module_t* btl,
     mca_btl_base_segment_t* segments = des->des_dst;
     mca_pml_ob1_hdr_t* hdr = (mca_pml_ob1_hdr_t*)segments->seg_addr.pval;
     
+    MCA_PML_OB1_RECV_FRAG_COUNT(btl, des);
     if( OPAL_UNLIKELY(segments->seg_len < sizeof(mca_pml_ob1_common_hdr_t)) ) {
         return;
     }
@@ -296,6 +365,7 @@ void mca_pml_ob1_recv_frag_callback_ack(mca_btl_base_module_t* btl,
     mca_pml_ob1_hdr_t* hdr = (mca_pml_ob1_hdr_t*)segments->seg_addr.pval;
     mca_pml_ob1_send_request_t* sendreq;
     
+    MCA_PML_OB1_RECV_FRAG_COUNT(btl, des);
     if( OPAL_UNLIKELY(segments->seg_len < sizeof(mca_pml_ob1_common_hdr_t)) ) {
          return;
     }
@@ -314,6 +384,13 @@ void mca_pml_ob1_recv_frag_callback_ack(mca_btl_base_module_t* btl,
         }
 
         sendreq->req_throttle_sends = true;
+
+        /* a non-contiguous send packs each fragment when an earlier one
+         * completes. keep enough of them in flight to overlap the packing
+         * with the transfer */
+        if (opal_convertor_need_buffers(&sendreq->req_send.req_base.req_convertor)) {
+            sendreq->req_pipeline_max = mca_pml_ob1.pack_pipeline_depth;
+        }
     }
     
     mca_pml_ob1_send_request_copy_in_out(sendreq,
@@ -359,6 +436,7 @@ void mca_pml_ob1_recv_frag_callback_frag(mca_btl_base_module_t* btl,
     mca_pml_ob1_hdr_t* hdr = (mca_pml_ob1_hdr_t*)segments->seg_addr.pval;
     mca_pml_ob1_recv_request_t* recvreq;
 
+    MCA_PML_OB1_RECV_FRAG_COUNT(btl, des);
     if( OPAL_UNLIKELY(segments->seg_len < sizeof(mca_pml_ob1_common_hdr_t)) ) {
         return;
     }
@@ -394,6 +472,7 @@ void mca_pml_ob1_recv_frag_callback_put(mca_btl_base_module_t* btl,
     mca_pml_ob1_hdr_t* hdr = (mca_pml_ob1_hdr_t*)segments->seg_addr.pval;
     mca_pml_ob1_send_request_t* sendreq;
     
+    MCA_PML_OB1_RECV_FRAG_COUNT(btl, des);
     if( OPAL_UNLIKELY(segments->seg_len < sizeof(mca_pml_ob1_common_hdr_t)) ) {
         return;
     }
@@ -414,6 +493,7 @@ void mca_pml_ob1_recv_frag_callback_fin(mca_btl_base_module_t* btl,
     mca_pml_ob1_hdr_t* hdr = (mca_pml_ob1_hdr_t*)segments->seg_addr.pval;
     mca_btl_base_descriptor_t* rdma;
     
+    MCA_PML_OB1_RECV_FRAG_COUNT(btl, des);
     if( OPAL_UNLIKELY(segments->seg_len < sizeof(mca_pml_ob1_common_hdr_t)) ) {
         return;
     }
@@ -426,6 +506,63 @@ void mca_pml_ob1_recv_frag_callback_fin(mca_btl_base_module_t* btl,
     return;
 }
 
+void mca_pml_ob1_recv_frag_callback_flow(mca_btl_base_module_t* btl,
+                                         mca_btl_base_tag_t tag,
+                                         mca_btl_base_descriptor_t* des,
+                                         void* cbdata ) {
+    mca_btl_base_segment_t* segments = des->des_dst;
+    mca_pml_ob1_hdr_t* hdr = (mca_pml_ob1_hdr_t*)segments->seg_addr.pval;
+    ompi_communicator_t *comm_ptr;
+    mca_pml_ob1_comm_t *comm;
+
+    MCA_PML_OB1_RECV_FRAG_COUNT(btl, des);
+    if( OPAL_UNLIKELY(segments->seg_len < sizeof(mca_pml_ob1_flow_hdr_t)) ) {
+        return;
+    }
+
+    ob1_hdr_ntoh(hdr, MCA_PML_OB1_HDR_TYPE_FLOW);
+
+    /* the communicator may already be gone on this side, the notice
+     * is then of no use */
+    comm_ptr = ompi_comm_lookup(hdr->hdr_flow.hdr_ctx);
+    if( OPAL_UNLIKELY(NULL == comm_ptr || NULL == comm_ptr->c_pml_comm) ) {
+        return;
+    }
+    comm = (mca_pml_ob1_comm_t *)comm_ptr->c_pml_comm;
+    if( OPAL_UNLIKELY((size_t)hdr->hdr_flow.hdr_src >= comm->num_procs) ) {
+        return;
+    }
+
+    comm->procs[hdr->hdr_flow.hdr_src].eager_disabled = (0 == hdr->hdr_flow.hdr_eager);
+}
+
+void mca_pml_ob1_recv_frag_flow_check(ompi_communicator_t *comm_ptr,
+                                      mca_pml_ob1_comm_proc_t *proc,
+                                      bool unexpected)
+{
+    size_t max_bytes = mca_pml_ob1.unexpected_max_bytes;
+    bool eager;
+
+    if(unexpected) {
+        if(proc->flow_throttled || mca_pml_ob1.unexpected_bytes <= max_bytes)
+            return;
+        eager = false;
+    } else {
+        if(OPAL_LIKELY(!proc->flow_throttled) || mca_pml_ob1.unexpected_bytes >= max_bytes / 2)
+            return;
+        eager = true;
+    }
+
+    /* the flag only decides when to send a notice, a race between two
+     * threads at worst sends it twice */
+    proc->flow_throttled = !eager;
+    if(OMPI_SUCCESS != mca_pml_ob1_send_flow(proc->ompi_proc, comm_ptr->c_contextid,
+                                             comm_ptr->c_my_rank, eager)) {
+        /* try again with the next message from this peer */
+        proc->flow_throttled = eager;
+    }
+}
+
 
 
 #define PML_MAX_SEQ ~((mca_pml_sequence_t)0);
@@ -450,16 +587,85 @@ static inline mca_pml_ob1_recv_request_t* get_next_posted_recv(
     return (mca_pml_ob1_recv_request_t*)i;
 }
 
+/*
+ * Tag matching engine version of match_incomming: only the buckets
+ * that can hold a matching receive are looked at (the bucket of the
+ * tag and the MPI_ANY_TAG bucket, for both the specific and the wild
+ * receives), and the oldest matching receive among them wins.
+ */
+static mca_pml_ob1_recv_request_t *match_incomming_buckets(
+        mca_pml_ob1_match_hdr_t *hdr, mca_pml_ob1_comm_t *comm,
+        mca_pml_ob1_comm_proc_t *proc, bool wild)
+{
+    mca_pml_ob1_recv_request_t *match = NULL;
+    opal_list_t *queues[4], *match_queue = NULL;
+    int i, num_queues = 0, num_specific, match_index = 0, tag = hdr->hdr_tag;
+
+    /* the MPI_ANY_TAG buckets stay empty under mpi_assert_no_any_tag */
+    if (NULL != proc->specific_buckets) {
+        queues[num_queues++] = proc->specific_buckets + mca_pml_ob1_tag_bucket(tag);
+        if (tag >= 0 && !comm->no_any_tag) {
+            queues[num_queues++] = proc->specific_buckets + mca_pml_ob1_tag_bucket(OMPI_ANY_TAG);
+        }
+    }
+    num_specific = num_queues;
+    if (wild) {
+        queues[num_queues++] = comm->wild_buckets + mca_pml_ob1_tag_bucket(tag);
+        if (tag >= 0 && !comm->no_any_tag) {
+            queues[num_queues++] = comm->wild_buckets + mca_pml_ob1_tag_bucket(OMPI_ANY_TAG);
+        }
+    }
+
+    for (i = 0; i < num_queues; i++) {
+        mca_pml_ob1_recv_request_t *req;
+
+        /* each bucket is in posting order, so the first receive that
+           matches is the oldest one of this bucket */
+        OPAL_LIST_FOREACH(req, queues[i], mca_pml_ob1_recv_request_t) {
+            int req_tag = req->req_recv.req_base.req_tag;
+
+            if (req_tag == tag || (req_tag == OMPI_ANY_TAG && tag >= 0)) {
+                if (NULL == match ||
+                    req->req_recv.req_base.req_sequence < match->req_recv.req_base.req_sequence) {
+                    match = req;
+                    match_queue = queues[i];
+                    match_index = i;
+                }
+                break;
+            }
+        }
+    }
+
+    if (NULL != match) {
+        opal_list_remove_item(match_queue, (opal_list_item_t*)match);
+        if (match_index >= num_specific) {
+            OPAL_THREAD_ADD32(&comm->num_wild, -1);
+        }
+        PERUSE_TRACE_COMM_EVENT(PERUSE_COMM_REQ_REMOVE_FROM_POSTED_Q,
+                                &(match->req_recv.req_base), PERUSE_RECV);
+    }
+
+    return match;
+}
+
+/*
+ * Match a fragment against the receives posted for its peer and, when
+ * the caller holds the communicator lock (wild), against the wild ones.
+ */
 static mca_pml_ob1_recv_request_t *match_incomming(
         mca_pml_ob1_match_hdr_t *hdr, mca_pml_ob1_comm_t *comm,
-        mca_pml_ob1_comm_proc_t *proc)
+        mca_pml_ob1_comm_proc_t *proc, bool wild)
 {
     mca_pml_ob1_recv_request_t *specific_recv, *wild_recv;
     mca_pml_sequence_t wild_recv_seq, specific_recv_seq;
     int tag = hdr->hdr_tag;
 
+    if (0 != mca_pml_ob1.match_buckets) {
+        return match_incomming_buckets(hdr, comm, proc, wild);
+    }
+
     specific_recv = get_posted_recv(&proc->specific_receives);
-    wild_recv = get_posted_recv(&comm->wild_receives);
+    wild_recv = wild ? get_posted_recv(&comm->wild_receives) : NULL;
 
     wild_recv_seq = wild_recv ?
         wild_recv->req_recv.req_base.req_sequence : PML_MAX_SEQ;
@@ -486,6 +692,9 @@ static mca_pml_ob1_recv_request_t *match_incomming(
         req_tag = (*match)->req_recv.req_base.req_tag;
         if(req_tag == tag || (req_tag == OMPI_ANY_TAG && tag >= 0)) {
             opal_list_remove_item(queue, (opal_list_item_t*)(*match));
+            if (match == &wild_recv) {
+                OPAL_THREAD_ADD32(&comm->num_wild, -1);
+            }
             PERUSE_TRACE_COMM_EVENT(PERUSE_COMM_REQ_REMOVE_FROM_POSTED_Q,
                     &((*match)->req_recv.req_base), PERUSE_RECV);
             return *match;
@@ -503,13 +712,16 @@ match_one(mca_btl_base_module_t *btl,
           mca_pml_ob1_match_hdr_t *hdr, mca_btl_base_segment_t* segments,
           size_t num_segments, ompi_communicator_t *comm_ptr,
           mca_pml_ob1_comm_proc_t *proc,
-          mca_pml_ob1_recv_frag_t* frag)
+          mca_pml_ob1_recv_frag_t* frag, bool wild)
 {
     mca_pml_ob1_recv_request_t *match;
     mca_pml_ob1_comm_t *comm = (mca_pml_ob1_comm_t *)comm_ptr->c_pml_comm;
+    OMPI_PVAR_TIMER_DECLARE(match_start);
 
     do {
-        match = match_incomming(hdr, comm, proc);
+        OMPI_PVAR_TIMER_START(match_start);
+        match = match_incomming(hdr, comm, proc, wild);
+        OMPI_PVAR_TIMER_STOP(match_start, mca_pml_ob1.match_time);
 
         /* if match found, process data */
         if(OPAL_LIKELY(NULL != match)) {
@@ -547,8 +759,10 @@ match_one(mca_btl_base_module_t *btl,
         }
 
         /* if no match found, place on unexpected queue */
-        append_frag_to_list(&proc->unexpected_frags, btl, hdr, segments,
-                            num_segments, frag);
+        frag = append_frag_to_list(mca_pml_ob1_comm_proc_unexpected_queue(proc, hdr->hdr_tag),
+                                   btl, hdr, segments, num_segments, frag);
+        frag->stamp = proc->unexpected_stamp++;
+        OMPI_PVAR_COUNTER_ADD(mca_pml_ob1.protocol_count[MCA_PML_OB1_PROTOCOL_UNEXPECTED], 1);
         PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_INSERT_IN_UNEX_Q, comm_ptr,
                                hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
         return NULL;
@@ -623,6 +837,7 @@ static int mca_pml_ob1_recv_frag_match( mca_btl_base_module_t *btl,
     mca_pml_ob1_comm_t *comm;
     mca_pml_ob1_comm_proc_t *proc;
     mca_pml_ob1_recv_frag_t* frag = NULL;
+    bool wild;
 
     /* communicator pointer */
     comm_ptr = ompi_comm_lookup(hdr->hdr_ctx);
@@ -660,11 +875,12 @@ static int mca_pml_ob1_recv_frag_match( mca_btl_base_module_t *btl,
      * end points) from being processed, and potentially "loosing"
      * the fragment.
      */
-    OPAL_THREAD_LOCK(&comm->matching_lock);
+    wild = mca_pml_ob1_match_lock(comm, proc);
 
     /* get sequence number of next message that can be processed */
     next_msg_seq_expected = (uint16_t)proc->expected_sequence;
-    if(OPAL_UNLIKELY(frag_msg_seq != next_msg_seq_expected))
+    if(OPAL_UNLIKELY(frag_msg_seq != next_msg_seq_expected) &&
+       mca_pml_ob1_comm_ordered(comm, hdr->hdr_tag))
         goto wrong_seq;
 
     /*
@@ -675,7 +891,8 @@ static int mca_pml_ob1_recv_frag_match( mca_btl_base_module_t *btl,
 
 out_of_order_match:
     /* We're now expecting the next sequence number. */
-    proc->expected_sequence++;
+    if(OPAL_LIKELY(mca_pml_ob1_comm_ordered(comm, hdr->hdr_tag)))
+        proc->expected_sequence++;
 
     /**
      * We generate the SEARCH_POSTED_QUEUE only when the message is received
@@ -685,7 +902,7 @@ out_of_order_match:
     PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_SEARCH_POSTED_Q_BEGIN, comm_ptr,
                             hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
 
-    match = match_one(btl, hdr, segments, num_segments, comm_ptr, proc, frag);
+    match = match_one(btl, hdr, segments, num_segments, comm_ptr, proc, frag, wild);
 
     /**
      * The match is over. We generate the SEARCH_POSTED_Q_END here, before going
@@ -696,7 +913,7 @@ out_of_order_match:
                             hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
 
     /* release matching lock before processing fragment */
-    OPAL_THREAD_UNLOCK(&comm->matching_lock);
+    mca_pml_ob1_match_unlock(comm, proc, wild);
 
     if(OPAL_LIKELY(match)) {
         switch(type) { 
@@ -714,6 +931,10 @@ out_of_order_match:
         if(OPAL_UNLIKELY(frag))
             MCA_PML_OB1_RECV_FRAG_RETURN(frag);
     }
+
+    if(OPAL_UNLIKELY(0 != mca_pml_ob1.unexpected_max_bytes)) {
+        mca_pml_ob1_recv_frag_flow_check(comm_ptr, proc, NULL == match);
+    }
     
     /* 
      * Now that new message has arrived, check to see if
@@ -721,7 +942,7 @@ out_of_order_match:
      * may now be used to form new matchs
      */
     if(OPAL_UNLIKELY(opal_list_get_size(&proc->frags_cant_match) > 0)) {
-        OPAL_THREAD_LOCK(&comm->matching_lock);
+        wild = mca_pml_ob1_match_lock(comm, proc);
         if((frag = check_cantmatch_for_match(proc))) {
             hdr = &frag->hdr.hdr_match;
             segments = frag->segments;
@@ -730,7 +951,7 @@ out_of_order_match:
             type = hdr->hdr_common.hdr_type;
             goto out_of_order_match;
         }
-        OPAL_THREAD_UNLOCK(&comm->matching_lock);
+        mca_pml_ob1_match_unlock(comm, proc, wild);
     }
 
     return OMPI_SUCCESS;
@@ -741,7 +962,7 @@ wrong_seq:
      */
     append_frag_to_list(&proc->frags_cant_match, btl, hdr, segments,
                         num_segments, NULL);
-    OPAL_THREAD_UNLOCK(&comm->matching_lock);
+    mca_pml_ob1_match_unlock(comm, proc, wild);
     return OMPI_SUCCESS;
 }
 
@@ -44,6 +44,7 @@ struct mca_pml_ob1_recv_frag_t {
     mca_pml_ob1_hdr_t hdr;
     size_t num_segments;
     mca_btl_base_module_t* btl;
+    uint64_t stamp;   /**< arrival order on the unexpected queue of its proc */
     mca_btl_base_segment_t segments[MCA_BTL_DES_MAX_SEGMENTS];
     mca_pml_ob1_buffer_t buffers[MCA_BTL_DES_MAX_SEGMENTS];
     unsigned char addr[1];
@@ -88,6 +89,7 @@ do {                                                                    \
         macro_segments[0].seg_addr.pval = buffers[0].addr;              \
     }                                                                   \
     macro_segments[0].seg_len = _size;                                  \
+    OPAL_THREAD_ADD_SIZE_T(&mca_pml_ob1.unexpected_bytes, (int)_size);  \
     for( i = 0; i < cnt; i++ ) {                                        \
         memcpy( _ptr, segs[i].seg_addr.pval, segs[i].seg_len);          \
         _ptr += segs[i].seg_len;                                        \
@@ -102,6 +104,8 @@ do {                                                                    \
         mca_pml_ob1.allocator->alc_free( mca_pml_ob1.allocator,         \
                                          frag->buffers[0].addr );       \
     }                                                                   \
+    OPAL_THREAD_ADD_SIZE_T(&mca_pml_ob1.unexpected_bytes,               \
+                           -(int)frag->segments[0].seg_len);            \
     frag->num_segments = 0;                                             \
                                                                         \
     /* return recv_frag */                                              \
@@ -119,6 +123,24 @@ extern void mca_pml_ob1_recv_frag_callback_match( mca_btl_base_module_t *btl,
                                                   mca_btl_base_descriptor_t* descriptor,
                                                   void* cbdata );
                                                                  
+/**
+ *  Callback from BTL on receipt of a recv_frag (compact match).
+ */
+
+extern void mca_pml_ob1_recv_frag_callback_cmatch( mca_btl_base_module_t *btl,
+                                                   mca_btl_base_tag_t tag,
+                                                   mca_btl_base_descriptor_t* descriptor,
+                                                   void* cbdata );
+
+/**
+ *  Callback from BTL on receipt of a flow control notice.
+ */
+
+extern void mca_pml_ob1_recv_frag_callback_flow( mca_btl_base_module_t *btl,
+                                                 mca_btl_base_tag_t tag,
+                                                 mca_btl_base_descriptor_t* descriptor,
+                                                 void* cbdata );
+
 /**
  *  Callback from BTL on receipt of a recv_frag (rndv).
  */
@@ -169,6 +191,20 @@ extern void mca_pml_ob1_recv_frag_callback_fin( mca_btl_base_module_t *btl,
                                                 mca_btl_base_descriptor_t* descriptor,
                                                 void* cbdata );
 
+struct mca_pml_ob1_comm_proc_t;
+
+/**
+ *  Flow control of the unexpected messages, called when pml_ob1_unexpected_max_bytes
+ *  is set. A message from proc just went to the unexpected queue (unexpected is
+ *  true) or was matched by a receive: ask the peer to stop sending eager data when
+ *  the unexpected data goes over the limit, and allow it again once it dropped
+ *  under half of the limit.
+ */
+
+extern void mca_pml_ob1_recv_frag_flow_check( struct ompi_communicator_t *comm_ptr,
+                                              struct mca_pml_ob1_comm_proc_t *proc,
+                                              bool unexpected );
+
                                               
 END_C_DECLS
 
@@ -107,21 +107,27 @@ static int mca_pml_ob1_recv_request_cancel(struct ompi_request_t* ompi_request,
     }
 
     /* The rest should be protected behind the match logic lock */
-    OPAL_THREAD_LOCK(&comm->matching_lock);
     if( request->req_recv.req_base.req_peer == OMPI_ANY_SOURCE ) {
-        opal_list_remove_item( &comm->wild_receives, (opal_list_item_t*)request );
+        OPAL_THREAD_LOCK(&comm->matching_lock);
+        opal_list_remove_item( mca_pml_ob1_comm_wild_queue(comm, request->req_recv.req_base.req_tag),
+                               (opal_list_item_t*)request );
+        OPAL_THREAD_ADD32(&comm->num_wild, -1);
+        /**
+         * As now the PML is done with this request we have to force the pml_complete
+         * to true. Otherwise, the request will never be freed.
+         */
+        request->req_recv.req_base.req_pml_complete = true;
+        OPAL_THREAD_UNLOCK(&comm->matching_lock);
     } else {
         mca_pml_ob1_comm_proc_t* proc = comm->procs + request->req_recv.req_base.req_peer;
-        opal_list_remove_item(&proc->specific_receives, (opal_list_item_t*)request);
+        OPAL_THREAD_LOCK(&proc->matching_lock);
+        opal_list_remove_item(mca_pml_ob1_comm_proc_specific_queue(proc, request->req_recv.req_base.req_tag),
+                              (opal_list_item_t*)request);
+        request->req_recv.req_base.req_pml_complete = true;
+        OPAL_THREAD_UNLOCK(&proc->matching_lock);
     }
     PERUSE_TRACE_COMM_EVENT( PERUSE_COMM_REQ_REMOVE_FROM_POSTED_Q,
                              &(request->req_recv.req_base), PERUSE_RECV );
-    /**
-     * As now the PML is done with this request we have to force the pml_complete
-     * to true. Otherwise, the request will never be freed.
-     */
-    request->req_recv.req_base.req_pml_complete = true;
-    OPAL_THREAD_UNLOCK(&comm->matching_lock);
     
     OPAL_THREAD_LOCK(&ompi_request_lock);
     ompi_request->req_status._cancelled = true;
@@ -185,13 +191,26 @@ static void mca_pml_ob1_put_completion( mca_btl_base_module_t* btl,
     mca_bml_base_btl_t* bml_btl = (mca_bml_base_btl_t*)des->des_context;
     mca_pml_ob1_recv_request_t* recvreq = (mca_pml_ob1_recv_request_t*)des->des_cbdata;
     size_t bytes_received = 0;
+    uint32_t i;
 
     if( OPAL_LIKELY(status == OMPI_SUCCESS) ) {
         bytes_received = mca_pml_ob1_compute_segment_length (btl->btl_seg_size,
                                                              (void *) des->des_dst,
                                                              des->des_dst_cnt, 0);
     }
+    for(i = 0; i < recvreq->req_rdma_cnt; i++) {
+        if(recvreq->req_rdma[i].bml_btl == bml_btl) {
+            OPAL_THREAD_ADD_SIZE_T(&recvreq->req_rdma[i].pipeline_depth, -1);
+            break;
+        }
+    }
+    /* the registration is done, the next fragments can be larger */
+    if(0 != recvreq->req_rdma_frag_size &&
+       recvreq->req_rdma_frag_size < recvreq->req_send_offset) {
+        recvreq->req_rdma_frag_size *= 2;
+    }
     OPAL_THREAD_ADD_SIZE_T(&recvreq->req_pipeline_depth,-1);
+    mca_pml_ob1_rail_complete(btl, bytes_received);
 
     mca_bml_base_free(bml_btl, des);
 
@@ -255,7 +274,7 @@ static int mca_pml_ob1_recv_request_ack(
     ompi_proc_t* proc = (ompi_proc_t*)recvreq->req_recv.req_base.req_proc;
     mca_bml_base_endpoint_t* bml_endpoint = NULL;
 
-    bml_endpoint = (mca_bml_base_endpoint_t*) proc->proc_bml; 
+    bml_endpoint = mca_bml_base_get_endpoint(proc);
 
     /* by default copy everything */
     recvreq->req_send_offset = bytes_received;
@@ -648,7 +667,7 @@ void mca_pml_ob1_recv_request_progress_rget( mca_pml_ob1_recv_request_t* recvreq
     }
     
     /* lookup bml datastructures */
-    bml_endpoint = (mca_bml_base_endpoint_t*)recvreq->req_recv.req_base.req_proc->proc_bml;
+    bml_endpoint = mca_bml_base_get_endpoint(recvreq->req_recv.req_base.req_proc);
     rdma_bml = mca_bml_base_btl_array_find(&bml_endpoint->btl_rdma, btl);
 
 #if OMPI_CUDA_SUPPORT
@@ -748,6 +767,7 @@ void mca_pml_ob1_recv_request_progress_rndv( mca_pml_ob1_recv_request_t* recvreq
     recvreq->req_recv.req_bytes_packed = hdr->hdr_rndv.hdr_msg_length;
     recvreq->remote_req_send = hdr->hdr_rndv.hdr_src_req;
     recvreq->req_rdma_offset = bytes_received;
+    recvreq->req_rdma_frag_size = mca_pml_ob1.rdma_pipeline_frag_min;
     MCA_PML_OB1_RECV_REQUEST_MATCHED(recvreq, &hdr->hdr_match);
     mca_pml_ob1_recv_request_ack(recvreq, &hdr->hdr_rndv, bytes_received);
     /**
@@ -894,10 +914,14 @@ int mca_pml_ob1_recv_request_schedule_once( mca_pml_ob1_recv_request_t* recvreq,
 {
     mca_bml_base_btl_t* bml_btl; 
     int num_tries = recvreq->req_rdma_cnt, num_fail = 0;
-    size_t i, prev_bytes_remaining = 0;
+    size_t i, j, prev_bytes_remaining = 0;
     size_t bytes_remaining = recvreq->req_send_offset -
         recvreq->req_rdma_offset;
 
+    /* follow the throughput measured while the previous fragments completed */
+    mca_pml_ob1_rebalance_weighted_length(recvreq->req_rdma, (int)recvreq->req_rdma_cnt,
+                                          bytes_remaining);
+
     /* if starting bml_btl is provided schedule next fragment on it first */
     if(start_bml_btl != NULL) {
         for(i = 0; i < recvreq->req_rdma_cnt; i++) {
@@ -936,21 +960,38 @@ int mca_pml_ob1_recv_request_schedule_once( mca_pml_ob1_recv_request_t* recvreq,
             prev_bytes_remaining = bytes_remaining;
         }
 
-        do {
+        /* next btl with something left and room in its pipeline */
+        for(j = 0; j < recvreq->req_rdma_cnt; j++) {
             rdma_idx = recvreq->req_rdma_idx;
-            bml_btl = recvreq->req_rdma[rdma_idx].bml_btl;
-            reg = recvreq->req_rdma[rdma_idx].btl_reg;
-            size = recvreq->req_rdma[rdma_idx].length;
             if(++recvreq->req_rdma_idx >= recvreq->req_rdma_cnt)
                 recvreq->req_rdma_idx = 0;
-        } while(!size);
+            if(0 != recvreq->req_rdma[rdma_idx].length &&
+               (0 == mca_pml_ob1.rdma_pipeline_btl_depth ||
+                recvreq->req_rdma[rdma_idx].pipeline_depth < mca_pml_ob1.rdma_pipeline_btl_depth)) {
+                break;
+            }
+        }
+        if(j == recvreq->req_rdma_cnt) {
+            /* all full, the put completions schedule the rest */
+            break;
+        }
+        bml_btl = recvreq->req_rdma[rdma_idx].bml_btl;
+        reg = recvreq->req_rdma[rdma_idx].btl_reg;
+        size = recvreq->req_rdma[rdma_idx].length;
         btl = bml_btl->btl;
 
         /* makes sure that we don't exceed BTL max rdma size
-         * if memory is not pinned already */
-        if( (NULL == reg) && (btl->btl_rdma_pipeline_frag_size != 0) &&
-                             (size > btl->btl_rdma_pipeline_frag_size)) {
-            size = btl->btl_rdma_pipeline_frag_size;
+         * if memory is not pinned already, nor the current size
+         * of the adaptive pipeline */
+        if(NULL == reg) {
+            if( (btl->btl_rdma_pipeline_frag_size != 0) &&
+                (size > btl->btl_rdma_pipeline_frag_size)) {
+                size = btl->btl_rdma_pipeline_frag_size;
+            }
+            if( (recvreq->req_rdma_frag_size != 0) &&
+                (size > recvreq->req_rdma_frag_size)) {
+                size = recvreq->req_rdma_frag_size;
+            }
         }
 
         /* take lock to protect converter against concurrent access
@@ -1008,14 +1049,17 @@ int mca_pml_ob1_recv_request_schedule_once( mca_pml_ob1_recv_request_t* recvreq,
                                       PERUSE_RECV);
 
         /* send rdma request to peer */
+        mca_pml_ob1_rail_start(btl);
         rc = mca_bml_base_send(bml_btl, ctl, MCA_PML_OB1_HDR_TYPE_PUT);
         if( OPAL_LIKELY( rc >= 0 ) ) {
             /* update request state */
             recvreq->req_rdma_offset += size;
             OPAL_THREAD_ADD_SIZE_T(&recvreq->req_pipeline_depth, 1);
+            OPAL_THREAD_ADD_SIZE_T(&recvreq->req_rdma[rdma_idx].pipeline_depth, 1);
             recvreq->req_rdma[rdma_idx].length -= size;
             bytes_remaining -= size;
         } else {
+            mca_pml_ob1_rail_complete(btl, 0);
             mca_bml_base_free(bml_btl,ctl);
             mca_bml_base_free(bml_btl,dst);
         }
@@ -1054,6 +1098,47 @@ static inline void append_recv_req_to_queue(opal_list_t *queue,
     }
 }
 
+/*
+ * Tag matching engine version of recv_req_match_specific_proc.  For a
+ * specific tag only the bucket of that tag is searched.  For
+ * MPI_ANY_TAG the oldest fragment among the heads of the non-negative
+ * tag buckets is the match (negative tags are never matched by
+ * MPI_ANY_TAG, and each bucket is in arrival order).
+ */
+static mca_pml_ob1_recv_frag_t*
+recv_req_match_specific_proc_buckets( const mca_pml_ob1_recv_request_t *req,
+                                      mca_pml_ob1_comm_proc_t *proc )
+{
+    mca_pml_ob1_recv_frag_t *frag, *match = NULL;
+    int i, tag = req->req_recv.req_base.req_tag;
+
+    if (NULL == proc->unexpected_buckets) {
+        return NULL;
+    }
+
+    if( OMPI_ANY_TAG == tag ) {
+        for (i = 0; i < (int)mca_pml_ob1.match_buckets; i++) {
+            opal_list_t *queue = proc->unexpected_buckets + i;
+
+            if (0 == opal_list_get_size(queue)) {
+                continue;
+            }
+            frag = (mca_pml_ob1_recv_frag_t*)opal_list_get_first(queue);
+            if (NULL == match || frag->stamp < match->stamp) {
+                match = frag;
+            }
+        }
+        return match;
+    }
+
+    OPAL_LIST_FOREACH(frag, proc->unexpected_buckets + mca_pml_ob1_tag_bucket(tag),
+                      mca_pml_ob1_recv_frag_t) {
+        if( frag->hdr.hdr_match.hdr_tag == tag )
+            return frag;
+    }
+    return NULL;
+}
+
 /*
  *  this routine tries to match a posted receive.  If a match is found,
  *  it places the request in the appropriate matched receive list. This
@@ -1068,6 +1153,10 @@ recv_req_match_specific_proc( const mca_pml_ob1_recv_request_t *req,
     mca_pml_ob1_recv_frag_t* frag;
     int tag = req->req_recv.req_base.req_tag;
 
+    if (0 != mca_pml_ob1.match_buckets) {
+        return recv_req_match_specific_proc_buckets(req, proc);
+    }
+
     if(opal_list_get_size(unexpected_frags) == 0)
         return NULL;
 
@@ -1095,7 +1184,9 @@ recv_req_match_specific_proc( const mca_pml_ob1_recv_request_t *req,
 
 /*
  * this routine is used to try and match a wild posted receive - where
- * wild is determined by the value assigned to the source process
+ * wild is determined by the value assigned to the source process.
+ * Each peer is locked while its unexpected queue is searched, and the
+ * lock of the peer that matched is still held on return.
 */
 static mca_pml_ob1_recv_frag_t*
 recv_req_match_wild( mca_pml_ob1_recv_request_t* req,
@@ -1117,6 +1208,7 @@ recv_req_match_wild( mca_pml_ob1_recv_request_t* req,
         mca_pml_ob1_recv_frag_t* frag;
 
         /* loop over messages from the current proc */
+        OPAL_THREAD_LOCK(&proc[i].matching_lock);
         if((frag = recv_req_match_specific_proc(req, &proc[i]))) {
             *p = &proc[i];
             comm->last_probed = i;
@@ -1124,11 +1216,13 @@ recv_req_match_wild( mca_pml_ob1_recv_request_t* req,
             prepare_recv_req_converter(req);
             return frag; /* match found */
         }
+        OPAL_THREAD_UNLOCK(&proc[i].matching_lock);
     }
     for (i = 0; i <= comm->last_probed; i++) {
         mca_pml_ob1_recv_frag_t* frag;
 
         /* loop over messages from the current proc */
+        OPAL_THREAD_LOCK(&proc[i].matching_lock);
         if((frag = recv_req_match_specific_proc(req, &proc[i]))) {
             *p = &proc[i];
             comm->last_probed = i;
@@ -1136,6 +1230,7 @@ recv_req_match_wild( mca_pml_ob1_recv_request_t* req,
             prepare_recv_req_converter(req);
             return frag; /* match found */
         }
+        OPAL_THREAD_UNLOCK(&proc[i].matching_lock);
     }
 
     *p = NULL;
@@ -1146,10 +1241,11 @@ recv_req_match_wild( mca_pml_ob1_recv_request_t* req,
 void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
 {
     mca_pml_ob1_comm_t* comm = req->req_recv.req_base.req_comm->c_pml_comm;
-    mca_pml_ob1_comm_proc_t* proc;
+    mca_pml_ob1_comm_proc_t* proc = NULL;
     mca_pml_ob1_recv_frag_t* frag;
     opal_list_t *queue;
     mca_pml_ob1_hdr_t* hdr;
+    bool wild = (req->req_recv.req_base.req_peer == OMPI_ANY_SOURCE);
 
     /* init/re-init the request */
     req->req_lock = 0;
@@ -1163,7 +1259,17 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
 
     MCA_PML_BASE_RECV_START(&req->req_recv.req_base);
 
-    OPAL_THREAD_LOCK(&comm->matching_lock);
+    /* A specific receive only needs the lock of its peer. A wild one
+     * holds the communicator lock, and announces itself in num_wild
+     * before looking at the peers so that the fragments they receive
+     * from now on are matched against the wild queue as well. */
+    if(wild) {
+        OPAL_THREAD_LOCK(&comm->matching_lock);
+        OPAL_THREAD_ADD32(&comm->num_wild, 1);
+    } else {
+        proc = &comm->procs[req->req_recv.req_base.req_peer];
+        OPAL_THREAD_LOCK(&proc->matching_lock);
+    }
     /**
      * The laps of time between the ACTIVATE event and the SEARCH_UNEX one include
      * the cost of the request lock.
@@ -1172,12 +1278,13 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
                             &(req->req_recv.req_base), PERUSE_RECV);
 
     /* assign sequence number */
-    req->req_recv.req_base.req_sequence = comm->recv_sequence++;
+    req->req_recv.req_base.req_sequence =
+        (uint32_t) OPAL_THREAD_ADD32((volatile int32_t*) &comm->recv_sequence, 1) - 1;
 
     /* attempt to match posted recv */
-    if(req->req_recv.req_base.req_peer == OMPI_ANY_SOURCE) {
+    if(wild) {
         frag = recv_req_match_wild(req, &proc);
-        queue = &comm->wild_receives;
+        queue = mca_pml_ob1_comm_wild_queue(comm, req->req_recv.req_base.req_tag);
 #if !OPAL_ENABLE_HETEROGENEOUS_SUPPORT
         /* As we are in a homogeneous environment we know that all remote
          * architectures are exactly the same as the local one. Therefore,
@@ -1190,10 +1297,9 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
         }
 #endif  /* !OPAL_ENABLE_HETEROGENEOUS_SUPPORT */
     } else {
-        proc = &comm->procs[req->req_recv.req_base.req_peer];
         req->req_recv.req_base.req_proc = proc->ompi_proc;
         frag = recv_req_match_specific_proc(req, proc);
-        queue = &proc->specific_receives;
+        queue = mca_pml_ob1_comm_proc_specific_queue(proc, req->req_recv.req_base.req_tag);
         /* wild cardrecv will be prepared on match */ 
         prepare_recv_req_converter(req);
     }
@@ -1205,8 +1311,16 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
            it when the message comes in. */
         append_recv_req_to_queue(queue, req);
         req->req_match_received = false;
-        OPAL_THREAD_UNLOCK(&comm->matching_lock);
+        if(wild) {
+            OPAL_THREAD_UNLOCK(&comm->matching_lock);
+        } else {
+            OPAL_THREAD_UNLOCK(&proc->matching_lock);
+        }
     } else {
+        /* matched right away: the wild receive is not queued after all */
+        if(wild) {
+            OPAL_THREAD_ADD32(&comm->num_wild, -1);
+        }
         if(OPAL_LIKELY(!IS_PROB_REQ(req))) {
             PERUSE_TRACE_COMM_EVENT(PERUSE_COMM_REQ_MATCH_UNEX,
                                     &(req->req_recv.req_base), PERUSE_RECV);
@@ -1221,9 +1335,9 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
             PERUSE_TRACE_COMM_EVENT(PERUSE_COMM_SEARCH_UNEX_Q_END,
                                     &(req->req_recv.req_base), PERUSE_RECV);
 
-            opal_list_remove_item(&proc->unexpected_frags,
+            opal_list_remove_item(mca_pml_ob1_comm_proc_unexpected_queue(proc, frag->hdr.hdr_match.hdr_tag),
                                   (opal_list_item_t*)frag);
-            OPAL_THREAD_UNLOCK(&comm->matching_lock);
+            mca_pml_ob1_match_unlock(comm, proc, wild);
             
             switch(hdr->hdr_common.hdr_type) {
             case MCA_PML_OB1_HDR_TYPE_MATCH:
@@ -1244,6 +1358,10 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
             
             MCA_PML_OB1_RECV_FRAG_RETURN(frag);
 
+            if(OPAL_UNLIKELY(0 != mca_pml_ob1.unexpected_max_bytes)) {
+                mca_pml_ob1_recv_frag_flow_check(req->req_recv.req_base.req_comm, proc, false);
+            }
+
         } else if (OPAL_UNLIKELY(IS_MPROB_REQ(req))) {
             /* Remove the fragment from the match list, as it's now
                matched.  Stash it somewhere in the request (which,
@@ -1251,16 +1369,16 @@ void mca_pml_ob1_recv_req_start(mca_pml_ob1_recv_request_t *req)
                during the end of mprobe.  The request will then be
                "recreated" as a receive request, and the frag will be
                restarted with this request during mrecv */
-            opal_list_remove_item(&proc->unexpected_frags,
+            opal_list_remove_item(mca_pml_ob1_comm_proc_unexpected_queue(proc, frag->hdr.hdr_match.hdr_tag),
                                   (opal_list_item_t*)frag);
-            OPAL_THREAD_UNLOCK(&comm->matching_lock);
+            mca_pml_ob1_match_unlock(comm, proc, wild);
 
             req->req_recv.req_base.req_addr = frag;
             mca_pml_ob1_recv_request_matched_probe(req, frag->btl,
                                                    frag->segments, frag->num_segments);
 
         } else {
-            OPAL_THREAD_UNLOCK(&comm->matching_lock);
+            mca_pml_ob1_match_unlock(comm, proc, wild);
             mca_pml_ob1_recv_request_matched_probe(req, frag->btl,
                                                    frag->segments, frag->num_segments);
         }
@@ -28,6 +28,7 @@
 #include "pml_ob1.h"
 #include "pml_ob1_rdma.h"
 #include "pml_ob1_rdmafrag.h"
+#include "pml_ob1_reqcache.h"
 #include "ompi/proc/proc.h"
 #include "ompi/mca/pml/ob1/pml_ob1_comm.h"
 #include "ompi/mca/mpool/base/base.h"
@@ -44,6 +45,7 @@ struct mca_pml_ob1_recv_request_t {
     size_t  req_bytes_expected; /**< local size of the data as suggested by the user */
     size_t  req_rdma_offset;
     size_t  req_send_offset;
+    size_t  req_rdma_frag_size; /**< next fragment of the put pipeline, 0 if fixed */
     uint32_t req_rdma_cnt;
     uint32_t req_rdma_idx;
     bool req_pending;
@@ -75,7 +77,7 @@ static inline bool unlock_recv_request(mca_pml_ob1_recv_request_t *recvreq)
 #define MCA_PML_OB1_RECV_REQUEST_ALLOC(recvreq)                    \
 do {                                                               \
    ompi_free_list_item_t* item;                                    \
-   OMPI_FREE_LIST_GET_MT(&mca_pml_base_recv_requests, item);          \
+   item = mca_pml_ob1_req_cache_get(MCA_PML_OB1_REQ_CACHE_RECV, false); \
    recvreq = (mca_pml_ob1_recv_request_t*)item;                    \
 } while(0)
 
@@ -129,8 +131,8 @@ do {                                                                \
 #define MCA_PML_OB1_RECV_REQUEST_RETURN(recvreq)                        \
     {                                                                   \
         MCA_PML_BASE_RECV_REQUEST_FINI(&(recvreq)->req_recv);           \
-        OMPI_FREE_LIST_RETURN_MT( &mca_pml_base_recv_requests,             \
-                               (ompi_free_list_item_t*)(recvreq));      \
+        mca_pml_ob1_req_cache_put(MCA_PML_OB1_REQ_CACHE_RECV,           \
+                                  (ompi_free_list_item_t*)(recvreq));   \
     }
 
 /**
@@ -409,8 +411,7 @@ static inline int mca_pml_ob1_recv_request_ack_send(ompi_proc_t* proc,
 {
     size_t i;
     mca_bml_base_btl_t* bml_btl;
-    mca_bml_base_endpoint_t* endpoint =
-        (mca_bml_base_endpoint_t*)proc->proc_bml;
+    mca_bml_base_endpoint_t* endpoint = mca_bml_base_get_endpoint(proc);
 
     for(i = 0; i < mca_bml_base_btl_array_get_size(&endpoint->btl_eager); i++) {
         bml_btl = mca_bml_base_btl_array_get_next(&endpoint->btl_eager);
@@ -0,0 +1,103 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "ompi/constants.h"
+#include "pml_ob1.h"
+#include "pml_ob1_reqcache.h"
+
+static void mca_pml_ob1_req_cache_release(void *value)
+{
+    mca_pml_ob1_req_cache_t *cache = (mca_pml_ob1_req_cache_t *) value;
+
+    /* a thread exiting while the PML is up hands its requests back */
+    if (mca_pml_ob1.enabled) {
+        mca_pml_ob1_req_cache_flush(cache, MCA_PML_OB1_REQ_CACHE_SEND,
+                                    cache->count[MCA_PML_OB1_REQ_CACHE_SEND]);
+        mca_pml_ob1_req_cache_flush(cache, MCA_PML_OB1_REQ_CACHE_RECV,
+                                    cache->count[MCA_PML_OB1_REQ_CACHE_RECV]);
+    }
+    free(cache);
+}
+
+void mca_pml_ob1_req_cache_init(void)
+{
+    mca_pml_ob1.req_cache_valid = (0 != mca_pml_ob1.req_cache_size &&
+        OPAL_SUCCESS == opal_tsd_key_create(&mca_pml_ob1.req_cache_key,
+                                            mca_pml_ob1_req_cache_release));
+}
+
+void mca_pml_ob1_req_cache_fini(void)
+{
+    mca_pml_ob1_req_cache_t *cache;
+
+    if (!mca_pml_ob1.req_cache_valid) {
+        return;
+    }
+    /* the caches of the other threads are left to the free lists, that
+       release their memory as a whole */
+    if (OPAL_SUCCESS == opal_tsd_getspecific(mca_pml_ob1.req_cache_key, (void **) &cache) &&
+        NULL != cache) {
+        opal_tsd_setspecific(mca_pml_ob1.req_cache_key, NULL);
+        mca_pml_ob1_req_cache_release(cache);
+    }
+    opal_tsd_key_delete(mca_pml_ob1.req_cache_key);
+    mca_pml_ob1.req_cache_valid = false;
+}
+
+ompi_free_list_item_t *mca_pml_ob1_req_cache_refill(mca_pml_ob1_req_cache_t *cache,
+                                                    int which)
+{
+    ompi_free_list_t *list = mca_pml_ob1_req_cache_list(which);
+    int size = (int) mca_pml_ob1.req_cache_size;
+    ompi_free_list_item_t *item;
+
+    if (NULL == cache) {
+        cache = (mca_pml_ob1_req_cache_t *)
+            malloc(sizeof(*cache) + 4 * size * sizeof(ompi_free_list_item_t *));
+        if (NULL == cache) {
+            return NULL;
+        }
+        cache->count[0] = cache->count[1] = 0;
+        cache->items[0] = (ompi_free_list_item_t **) (cache + 1);
+        cache->items[1] = cache->items[0] + 2 * size;
+        if (OPAL_SUCCESS != opal_tsd_setspecific(mca_pml_ob1.req_cache_key, cache)) {
+            free(cache);
+            return NULL;
+        }
+    }
+
+    /* one request for the caller, the rest of the batch for later */
+    while (cache->count[which] < size) {
+        OMPI_FREE_LIST_GET_MT(list, item);
+        if (NULL == item) {
+            break;
+        }
+        cache->items[which][cache->count[which]++] = item;
+    }
+
+    return (cache->count[which] > 0) ? cache->items[which][--cache->count[which]] : NULL;
+}
+
+void mca_pml_ob1_req_cache_flush(mca_pml_ob1_req_cache_t *cache, int which, int count)
+{
+    ompi_free_list_t *list = mca_pml_ob1_req_cache_list(which);
+    ompi_free_list_item_t *item;
+
+    while (count-- > 0 && cache->count[which] > 0) {
+        item = cache->items[which][--cache->count[which]];
+        OMPI_FREE_LIST_RETURN_MT(list, item);
+    }
+}
@@ -0,0 +1,120 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ *  @file
+ *
+ *  Per-thread caches of send and receive requests. When threads are in
+ *  use each thread keeps a few requests of its own, taken from and
+ *  given back to the global free lists mca_pml_ob1.req_cache_size at a
+ *  time, so that the allocation of a request does not touch the head of
+ *  the shared list on every call.
+ */
+
+#ifndef MCA_PML_OB1_REQCACHE_H
+#define MCA_PML_OB1_REQCACHE_H
+
+#include "ompi_config.h"
+#include "opal/threads/tsd.h"
+#include "ompi/class/ompi_free_list.h"
+#include "ompi/mca/pml/base/pml_base_request.h"
+#include "pml_ob1.h"
+
+BEGIN_C_DECLS
+
+#define MCA_PML_OB1_REQ_CACHE_SEND 0
+#define MCA_PML_OB1_REQ_CACHE_RECV 1
+
+struct mca_pml_ob1_req_cache_t {
+    int count[2];                     /**< requests held, send and receive */
+    ompi_free_list_item_t **items[2]; /**< 2 * req_cache_size slots each */
+};
+typedef struct mca_pml_ob1_req_cache_t mca_pml_ob1_req_cache_t;
+
+/** Create the key of the caches; on failure they are not used */
+void mca_pml_ob1_req_cache_init(void);
+
+/** Give back the requests of the calling thread and delete the key */
+void mca_pml_ob1_req_cache_fini(void);
+
+/**
+ * Refill an empty cache with a batch from the free list and return one
+ * of the requests, creating the cache of the thread if it has none yet.
+ * Returns NULL if nothing could be taken.
+ */
+ompi_free_list_item_t *mca_pml_ob1_req_cache_refill(mca_pml_ob1_req_cache_t *cache,
+                                                    int which);
+
+/** Give count requests of the cache back to the free list */
+void mca_pml_ob1_req_cache_flush(mca_pml_ob1_req_cache_t *cache, int which, int count);
+
+static inline ompi_free_list_t *mca_pml_ob1_req_cache_list(int which)
+{
+    return (MCA_PML_OB1_REQ_CACHE_SEND == which) ?
+        &mca_pml_base_send_requests : &mca_pml_base_recv_requests;
+}
+
+static inline bool mca_pml_ob1_req_cache_lookup(mca_pml_ob1_req_cache_t **cache)
+{
+    return (mca_pml_ob1.req_cache_valid && opal_using_threads() &&
+            OPAL_SUCCESS == opal_tsd_getspecific(mca_pml_ob1.req_cache_key,
+                                                 (void **) cache));
+}
+
+/**
+ * Allocate a request, from the cache of the thread when there is one.
+ * With wait, block until the free list can provide one.
+ */
+static inline ompi_free_list_item_t *mca_pml_ob1_req_cache_get(int which, bool wait)
+{
+    mca_pml_ob1_req_cache_t *cache;
+    ompi_free_list_item_t *item = NULL;
+
+    if (mca_pml_ob1_req_cache_lookup(&cache)) {
+        if (OPAL_LIKELY(NULL != cache && cache->count[which] > 0)) {
+            return cache->items[which][--cache->count[which]];
+        }
+        item = mca_pml_ob1_req_cache_refill(cache, which);
+        if (NULL != item) {
+            return item;
+        }
+    }
+
+    if (wait) {
+        OMPI_FREE_LIST_WAIT_MT(mca_pml_ob1_req_cache_list(which), item);
+    } else {
+        OMPI_FREE_LIST_GET_MT(mca_pml_ob1_req_cache_list(which), item);
+    }
+    return item;
+}
+
+/**
+ * Release a request to the cache of the thread; once the cache holds
+ * twice its batch, one batch goes back to the free list.
+ */
+static inline void mca_pml_ob1_req_cache_put(int which, ompi_free_list_item_t *item)
+{
+    mca_pml_ob1_req_cache_t *cache;
+
+    if (mca_pml_ob1_req_cache_lookup(&cache) && NULL != cache) {
+        if (OPAL_UNLIKELY(cache->count[which] == 2 * (int) mca_pml_ob1.req_cache_size)) {
+            mca_pml_ob1_req_cache_flush(cache, which, (int) mca_pml_ob1.req_cache_size);
+        }
+        cache->items[which][cache->count[which]++] = item;
+        return;
+    }
+
+    OMPI_FREE_LIST_RETURN_MT(mca_pml_ob1_req_cache_list(which), item);
+}
+
+END_C_DECLS
+
+#endif
@@ -137,6 +137,7 @@ static void mca_pml_ob1_send_request_construct(mca_pml_ob1_send_request_t* req)
     req->req_send.req_base.req_ompi.req_free = mca_pml_ob1_send_request_free;
     req->req_send.req_base.req_ompi.req_cancel = mca_pml_ob1_send_request_cancel;
     req->req_rdma_cnt = 0;
+    req->req_rdma_cached = 0;
     req->req_throttle_sends = false;
     OBJ_CONSTRUCT(&req->req_send_ranges, opal_list_t);
     OBJ_CONSTRUCT(&req->req_send_range_lock, opal_mutex_t);
@@ -322,6 +323,7 @@ mca_pml_ob1_frag_completion( mca_btl_base_module_t* btl,
 
     OPAL_THREAD_ADD_SIZE_T(&sendreq->req_pipeline_depth, -1);
     OPAL_THREAD_ADD_SIZE_T(&sendreq->req_bytes_delivered, req_bytes_delivered);
+    mca_pml_ob1_rail_complete(btl, req_bytes_delivered);
 
     if(send_request_pml_complete_check(sendreq) == false) {
         mca_pml_ob1_send_request_schedule(sendreq);
@@ -487,10 +489,27 @@ int mca_pml_ob1_send_request_start_copy( mca_pml_ob1_send_request_t* sendreq,
     struct iovec iov;
     unsigned int iov_count;
     size_t max_data = size;
+    ompi_communicator_t *comm = sendreq->req_send.req_base.req_comm;
+    bool compact = MCA_PML_OB1_CMATCH_ELIGIBLE(comm->c_my_rank,
+                                               sendreq->req_send.req_base.req_tag, size);
+    size_t hdr_len = compact ? OMPI_PML_OB1_CMATCH_HDR_LEN : OMPI_PML_OB1_MATCH_HDR_LEN;
+    mca_btl_base_tag_t hdr_type = compact ? MCA_PML_OB1_HDR_TYPE_CMATCH : MCA_PML_OB1_HDR_TYPE_MATCH;
     int rc;
 
     if(NULL != bml_btl->btl->btl_sendi) {
         mca_pml_ob1_match_hdr_t match;
+        mca_pml_ob1_cmatch_hdr_t cmatch;
+        void *hdr_ptr = &match;
+
+        if( compact ) {
+            cmatch.hdr_common.hdr_flags = 0;
+            cmatch.hdr_common.hdr_type = MCA_PML_OB1_HDR_TYPE_CMATCH;
+            cmatch.hdr_ctx = comm->c_contextid;
+            cmatch.hdr_src = (uint16_t)comm->c_my_rank;
+            cmatch.hdr_tag = (int16_t)sendreq->req_send.req_base.req_tag;
+            cmatch.hdr_seq = (uint16_t)sendreq->req_send.req_base.req_sequence;
+            hdr_ptr = &cmatch;
+        }
         match.hdr_common.hdr_flags = 0;
         match.hdr_common.hdr_type = MCA_PML_OB1_HDR_TYPE_MATCH;
         match.hdr_ctx = sendreq->req_send.req_base.req_comm->c_contextid;
@@ -503,10 +522,10 @@ int mca_pml_ob1_send_request_start_copy( mca_pml_ob1_send_request_t* sendreq,
 
         /* try to send immediately */
         rc = mca_bml_base_sendi( bml_btl, &sendreq->req_send.req_base.req_convertor,
-                                 &match, OMPI_PML_OB1_MATCH_HDR_LEN, 
+                                 hdr_ptr, hdr_len,
                                  size, MCA_BTL_NO_ORDER, 
                                  MCA_BTL_DES_FLAGS_PRIORITY | MCA_BTL_DES_FLAGS_BTL_OWNERSHIP,
-                                 MCA_PML_OB1_HDR_TYPE_MATCH, 
+                                 hdr_type,
                                  &des);
         if( OPAL_LIKELY(OMPI_SUCCESS == rc) ) {
             /* signal request completion */
@@ -525,7 +544,7 @@ int mca_pml_ob1_send_request_start_copy( mca_pml_ob1_send_request_t* sendreq,
         /* allocate descriptor */
         mca_bml_base_alloc( bml_btl, &des,
                             MCA_BTL_NO_ORDER,
-                            OMPI_PML_OB1_MATCH_HDR_LEN + size,
+                            hdr_len + size,
                             MCA_BTL_DES_FLAGS_PRIORITY | MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
     }
     if( OPAL_UNLIKELY(NULL == des) ) {
@@ -537,7 +556,7 @@ int mca_pml_ob1_send_request_start_copy( mca_pml_ob1_send_request_t* sendreq,
     if(size > 0) {
         /* pack the data into the supplied buffer */
         iov.iov_base = (IOVBASE_TYPE*)((unsigned char*)segment->seg_addr.pval +
-                                       OMPI_PML_OB1_MATCH_HDR_LEN);
+                                       hdr_len);
         iov.iov_len  = size;
         iov_count    = 1;
         /*
@@ -566,25 +585,35 @@ int mca_pml_ob1_send_request_start_copy( mca_pml_ob1_send_request_t* sendreq,
     
     /* build match header */
     hdr = (mca_pml_ob1_hdr_t*)segment->seg_addr.pval;
-    hdr->hdr_common.hdr_flags = 0;
-    hdr->hdr_common.hdr_type = MCA_PML_OB1_HDR_TYPE_MATCH;
-    hdr->hdr_match.hdr_ctx = sendreq->req_send.req_base.req_comm->c_contextid;
-    hdr->hdr_match.hdr_src = sendreq->req_send.req_base.req_comm->c_my_rank;
-    hdr->hdr_match.hdr_tag = sendreq->req_send.req_base.req_tag;
-    hdr->hdr_match.hdr_seq = (uint16_t)sendreq->req_send.req_base.req_sequence;
+    if( compact ) {
+        mca_pml_ob1_cmatch_hdr_t *chdr = (mca_pml_ob1_cmatch_hdr_t*)hdr;
+        chdr->hdr_common.hdr_flags = 0;
+        chdr->hdr_common.hdr_type = MCA_PML_OB1_HDR_TYPE_CMATCH;
+        chdr->hdr_ctx = comm->c_contextid;
+        chdr->hdr_src = (uint16_t)comm->c_my_rank;
+        chdr->hdr_tag = (int16_t)sendreq->req_send.req_base.req_tag;
+        chdr->hdr_seq = (uint16_t)sendreq->req_send.req_base.req_sequence;
+    } else {
+        hdr->hdr_common.hdr_flags = 0;
+        hdr->hdr_common.hdr_type = MCA_PML_OB1_HDR_TYPE_MATCH;
+        hdr->hdr_match.hdr_ctx = comm->c_contextid;
+        hdr->hdr_match.hdr_src = comm->c_my_rank;
+        hdr->hdr_match.hdr_tag = sendreq->req_send.req_base.req_tag;
+        hdr->hdr_match.hdr_seq = (uint16_t)sendreq->req_send.req_base.req_sequence;
 
-    ob1_hdr_hton(hdr, MCA_PML_OB1_HDR_TYPE_MATCH,
-                 sendreq->req_send.req_base.req_proc);
+        ob1_hdr_hton(hdr, MCA_PML_OB1_HDR_TYPE_MATCH,
+                     sendreq->req_send.req_base.req_proc);
+    }
 
     /* update lengths */
-    segment->seg_len = OMPI_PML_OB1_MATCH_HDR_LEN + max_data;
+    segment->seg_len = hdr_len + max_data;
 
     /* short message */
     des->des_cbdata = sendreq;
     des->des_cbfunc = mca_pml_ob1_match_completion_free;
 
     /* send */
-    rc = mca_bml_base_send_status(bml_btl, des, MCA_PML_OB1_HDR_TYPE_MATCH);
+    rc = mca_bml_base_send_status(bml_btl, des, hdr_type);
     if( OPAL_LIKELY( rc >= OMPI_SUCCESS ) ) {
         if( OPAL_LIKELY( 1 == rc ) ) {
             mca_pml_ob1_match_completion_free_request( bml_btl, sendreq );
@@ -952,13 +981,19 @@ mca_pml_ob1_send_request_schedule_once(mca_pml_ob1_send_request_t* sendreq)
 
     /* check pipeline_depth here before attempting to get any locks */
     if(true == sendreq->req_throttle_sends &&
-            sendreq->req_pipeline_depth >= mca_pml_ob1.send_pipeline_depth)
+            sendreq->req_pipeline_depth >= sendreq->req_pipeline_max)
         return OMPI_SUCCESS;
 
     range = get_send_range(sendreq);
 
+    /* follow the throughput measured while the previous fragments completed */
+    if(NULL != range) {
+        mca_pml_ob1_rebalance_weighted_length(range->range_btls, range->range_btl_cnt,
+                                              (size_t)range->range_send_length);
+    }
+
     while(range && (false == sendreq->req_throttle_sends ||
-            sendreq->req_pipeline_depth < mca_pml_ob1.send_pipeline_depth)) {
+            sendreq->req_pipeline_depth < sendreq->req_pipeline_max)) {
         mca_pml_ob1_frag_hdr_t* hdr;
         mca_btl_base_descriptor_t* des;
         int rc, btl_idx;
@@ -1089,6 +1124,7 @@ cannot_pack:
 #endif /* OMPI_CUDA_SUPPORT */
 
         /* initiate send - note that this may complete before the call returns */
+        mca_pml_ob1_rail_start(bml_btl->btl);
         rc = mca_bml_base_send(bml_btl, des, MCA_PML_OB1_HDR_TYPE_FRAG);
         if( OPAL_LIKELY(rc >= 0) ) {
             /* update state */
@@ -1101,6 +1137,7 @@ cannot_pack:
                 prev_bytes_remaining = 0;
             }
         } else { 
+            mca_pml_ob1_rail_complete(bml_btl->btl, 0);
             mca_bml_base_free(bml_btl,des);
         }
     }
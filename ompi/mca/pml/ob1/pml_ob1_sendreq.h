@@ -27,12 +27,15 @@
 #include "ompi/mca/btl/btl.h"
 #include "ompi/mca/pml/base/pml_base_sendreq.h"
 #include "ompi/mca/mpool/base/base.h"
+#include "pml_ob1_coalesce.h"
 #include "pml_ob1_comm.h"
 #include "pml_ob1_hdr.h"
 #include "pml_ob1_rdma.h"
 #include "pml_ob1_rdmafrag.h"
+#include "pml_ob1_reqcache.h"
 #include "opal/datatype/opal_convertor.h"
 #include "ompi/mca/bml/bml.h" 
+#include "ompi/mca/bml/base/base.h"
 
 BEGIN_C_DECLS
 
@@ -50,8 +53,10 @@ struct mca_pml_ob1_send_request_t {
     int32_t req_lock;
     bool req_throttle_sends;
     size_t req_pipeline_depth;
+    size_t req_pipeline_max;   /**< max fragments in flight when throttled */
     size_t req_bytes_delivered;
     uint32_t req_rdma_cnt; 
+    uint32_t req_rdma_cached;  /**< req_rdma entries kept between starts of a persistent request */
     mca_pml_ob1_send_pending_t req_pending;
     opal_mutex_t req_send_range_lock; 
     opal_list_t req_send_ranges;
@@ -125,7 +130,7 @@ get_request_from_send_pending(mca_pml_ob1_send_pending_t *type)
         ompi_free_list_item_t* item;                                    \
                                                                         \
         if( OPAL_LIKELY(NULL != proc) ) {                               \
-            OMPI_FREE_LIST_WAIT_MT(&mca_pml_base_send_requests, item);     \
+            item = mca_pml_ob1_req_cache_get(MCA_PML_OB1_REQ_CACHE_SEND, true); \
             sendreq = (mca_pml_ob1_send_request_t*)item;                \
             sendreq->req_send.req_base.req_proc = proc;                 \
             sendreq->src_des = NULL;                                    \
@@ -168,16 +173,68 @@ static inline void mca_pml_ob1_free_rdma_resources(mca_pml_ob1_send_request_t* s
 {
     size_t r;
 
-    /* return mpool resources */
-    for(r = 0; r < sendreq->req_rdma_cnt; r++) {
-        mca_mpool_base_registration_t* reg = sendreq->req_rdma[r].btl_reg;
-        if( NULL != reg && reg->mpool != NULL ) {
-            reg->mpool->mpool_deregister(reg->mpool, reg);
+    /* the registrations of a persistent request are kept for the next start */
+    if( 0 == sendreq->req_rdma_cached ) {
+        /* return mpool resources */
+        for(r = 0; r < sendreq->req_rdma_cnt; r++) {
+            mca_mpool_base_registration_t* reg = sendreq->req_rdma[r].btl_reg;
+            if( NULL != reg && reg->mpool != NULL ) {
+                reg->mpool->mpool_deregister(reg->mpool, reg);
+            }
         }
     }
     sendreq->req_rdma_cnt = 0;
 }
 
+static inline void mca_pml_ob1_free_cached_rdma_resources(mca_pml_ob1_send_request_t* sendreq)
+{
+    if( 0 != sendreq->req_rdma_cached ) {
+        sendreq->req_rdma_cnt = sendreq->req_rdma_cached;
+        sendreq->req_rdma_cached = 0;
+        mca_pml_ob1_free_rdma_resources(sendreq);
+    }
+}
+
+/*
+ * Find the RDMA btls for the buffer of the request. A persistent request
+ * keeps the registrations of its buffer from one start to the next: the
+ * first start looks them up in the mpools, the following ones reuse them
+ * as long as the btls are still used to reach the peer.
+ */
+static inline uint32_t
+mca_pml_ob1_send_request_rdma_btls(mca_pml_ob1_send_request_t* sendreq, unsigned char* base)
+{
+    mca_bml_base_endpoint_t* endpoint = sendreq->req_endpoint;
+    size_t size = sendreq->req_send.req_bytes_packed;
+    uint32_t i, count = sendreq->req_rdma_cached;
+    size_t n, num_btls = mca_bml_base_btl_array_get_size(&endpoint->btl_rdma);
+    double weight_total = 0;
+
+    for(i = 0; i < count; i++) {
+        /* compare the pointers, the btl may be gone */
+        for(n = 0; n < num_btls; n++) {
+            if(mca_bml_base_btl_array_get_index(&endpoint->btl_rdma, n) ==
+               sendreq->req_rdma[i].bml_btl)
+                break;
+        }
+        if(n == num_btls)
+            break;
+        weight_total += sendreq->req_rdma[i].bml_btl->btl_weight;
+    }
+
+    if( OPAL_LIKELY(0 != count && i == count) ) {
+        mca_pml_ob1_calc_weighted_length(sendreq->req_rdma, (int)count, size, weight_total);
+        return count;
+    }
+    /* the btls changed since the last start */
+    mca_pml_ob1_free_cached_rdma_resources(sendreq);
+
+    count = (uint32_t)mca_pml_ob1_rdma_btls(endpoint, base, size, sendreq->req_rdma);
+    if(sendreq->req_send.req_base.req_ompi.req_persistent)
+        sendreq->req_rdma_cached = count;
+    return count;
+}
+
 
 /**
  * Start a send request. 
@@ -214,10 +271,11 @@ do {
 
 #define MCA_PML_OB1_SEND_REQUEST_RETURN(sendreq)                        \
     do {                                                                \
+    mca_pml_ob1_free_cached_rdma_resources(sendreq);                    \
     /*  Let the base handle the reference counts */                     \
     MCA_PML_BASE_SEND_REQUEST_FINI((&(sendreq)->req_send));             \
-    OMPI_FREE_LIST_RETURN_MT( &mca_pml_base_send_requests,                 \
-                           (ompi_free_list_item_t*)sendreq);            \
+    mca_pml_ob1_req_cache_put(MCA_PML_OB1_REQ_CACHE_SEND,               \
+                              (ompi_free_list_item_t*)sendreq);         \
     } while(0)
 
 
@@ -364,20 +422,34 @@ mca_pml_ob1_send_request_start_btl( mca_pml_ob1_send_request_t* sendreq,
     size_t size = sendreq->req_send.req_bytes_packed;
     mca_btl_base_module_t* btl = bml_btl->btl;
     size_t eager_limit = btl->btl_eager_limit - sizeof(mca_pml_ob1_hdr_t);
+    mca_pml_ob1_comm_t* comm = sendreq->req_send.req_base.req_comm->c_pml_comm;
+    int protocol = MCA_PML_OB1_PROTOCOL_RNDV;
     int rc;
 
+    if( OPAL_UNLIKELY(comm->procs[sendreq->req_send.req_base.req_peer].eager_disabled) ) {
+        /* the peer buffers too much unexpected data: send nothing but
+         * the match header before the receive is posted */
+        eager_limit = 0;
+    } else if( OPAL_UNLIKELY(0 != mca_pml_ob1.coalesce_size) &&
+        OMPI_SUCCESS == mca_pml_ob1_coalesce_send(sendreq, bml_btl, size) ) {
+        return OMPI_SUCCESS;
+    }
+
     if( OPAL_LIKELY(size <= eager_limit) ) {
         switch(sendreq->req_send.req_send_mode) {
         case MCA_PML_BASE_SEND_SYNCHRONOUS:
             rc = mca_pml_ob1_send_request_start_rndv(sendreq, bml_btl, size, 0);
             break;
         case MCA_PML_BASE_SEND_BUFFERED:
+            protocol = MCA_PML_OB1_PROTOCOL_EAGER;
             rc = mca_pml_ob1_send_request_start_copy(sendreq, bml_btl, size);
             break;
         case MCA_PML_BASE_SEND_COMPLETE:
+            protocol = MCA_PML_OB1_PROTOCOL_EAGER;
             rc = mca_pml_ob1_send_request_start_prepare(sendreq, bml_btl, size);
             break;
         default:
+            protocol = MCA_PML_OB1_PROTOCOL_EAGER;
             if (size != 0 && bml_btl->btl_flags & MCA_BTL_FLAGS_SEND_INPLACE) {
                 rc = mca_pml_ob1_send_request_start_prepare(sendreq, bml_btl, size);
             } else {
@@ -396,11 +468,8 @@ mca_pml_ob1_send_request_start_btl( mca_pml_ob1_send_request_t* sendreq,
             unsigned char *base;
             opal_convertor_get_current_pointer( &sendreq->req_send.req_base.req_convertor, (void**)&base );
             
-            if( 0 != (sendreq->req_rdma_cnt = (uint32_t)mca_pml_ob1_rdma_btls(
-                                                                              sendreq->req_endpoint,
-                                                                              base,
-                                                                              sendreq->req_send.req_bytes_packed,
-                                                                              sendreq->req_rdma))) {
+            if( 0 != (sendreq->req_rdma_cnt = mca_pml_ob1_send_request_rdma_btls(sendreq, base)) ) {
+                protocol = MCA_PML_OB1_PROTOCOL_RDMA;
                 rc = mca_pml_ob1_send_request_start_rdma(sendreq, bml_btl,
                                                          sendreq->req_send.req_bytes_packed);
                 if( OPAL_UNLIKELY(OMPI_SUCCESS != rc) ) {
@@ -420,6 +489,9 @@ mca_pml_ob1_send_request_start_btl( mca_pml_ob1_send_request_t* sendreq,
         }
     }
 
+    if( OPAL_LIKELY(OMPI_SUCCESS == rc) ) {
+        OMPI_PVAR_COUNTER_ADD(mca_pml_ob1.protocol_count[protocol], 1);
+    }
     return rc;
 }
 
@@ -427,8 +499,8 @@ static inline int
 mca_pml_ob1_send_request_start( mca_pml_ob1_send_request_t* sendreq )
 {   
     mca_pml_ob1_comm_t* comm = sendreq->req_send.req_base.req_comm->c_pml_comm;
-    mca_bml_base_endpoint_t* endpoint = (mca_bml_base_endpoint_t*)
-                                        sendreq->req_send.req_base.req_proc->proc_bml;
+    mca_bml_base_endpoint_t* endpoint =
+        mca_bml_base_get_endpoint(sendreq->req_send.req_base.req_proc);
     size_t i;
 
     if( OPAL_UNLIKELY(endpoint == NULL) ) {
@@ -439,10 +511,16 @@ mca_pml_ob1_send_request_start( mca_pml_ob1_send_request_t* sendreq )
     sendreq->req_state = 0;
     sendreq->req_lock = 0;
     sendreq->req_pipeline_depth = 0;
+    sendreq->req_pipeline_max = mca_pml_ob1.send_pipeline_depth;
+    sendreq->req_throttle_sends = false;
     sendreq->req_bytes_delivered = 0;
     sendreq->req_pending = MCA_PML_OB1_SEND_PENDING_NONE;
-    sendreq->req_send.req_base.req_sequence = OPAL_THREAD_ADD32(
-        &comm->procs[sendreq->req_send.req_base.req_peer].send_sequence,1);
+    if (OPAL_LIKELY(mca_pml_ob1_comm_ordered(comm, sendreq->req_send.req_base.req_tag))) {
+        sendreq->req_send.req_base.req_sequence = OPAL_THREAD_ADD32(
+            &comm->procs[sendreq->req_send.req_base.req_peer].send_sequence,1);
+    } else {
+        sendreq->req_send.req_base.req_sequence = 0;
+    }
 
     MCA_PML_BASE_SEND_START( &sendreq->req_send.req_base );
 
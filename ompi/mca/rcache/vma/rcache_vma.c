@@ -22,6 +22,9 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #include MCA_memory_IMPLEMENTATION_HEADER
 #include "opal/mca/memory/memory.h"
 #include "ompi/mca/rcache/rcache.h"
@@ -42,6 +45,73 @@ void mca_rcache_vma_module_init( mca_rcache_vma_module_t* rcache ) {
     rcache->base.rcache_finalize = mca_rcache_vma_finalize; 
     OBJ_CONSTRUCT(&rcache->base.lock, opal_mutex_t);
     mca_rcache_vma_tree_init(rcache);
+    rcache->generation = 0;
+    rcache->mru_key_valid =
+        (OPAL_SUCCESS == opal_tsd_key_create(&rcache->mru_key, free));
+}
+
+/*
+ * The registrations found last by this thread.  Nothing is freed from
+ * the tree without bumping the generation first, and the callers
+ * serialize find and delete, so an entry seen under the current
+ * generation is still in the tree.
+ */
+static inline mca_mpool_base_registration_t *
+mru_find(mca_rcache_vma_module_t *vma_rcache, unsigned char *base,
+         unsigned char *bound)
+{
+    mca_rcache_vma_mru_t *mru;
+    int i;
+
+    if (!vma_rcache->mru_key_valid ||
+        OPAL_SUCCESS != opal_tsd_getspecific(vma_rcache->mru_key, (void **) &mru) ||
+        NULL == mru || mru->generation != vma_rcache->generation) {
+        return NULL;
+    }
+
+    for (i = 0 ; i < MCA_RCACHE_VMA_MRU_SIZE ; ++i) {
+        if (NULL != mru->entries[i].reg &&
+            mru->entries[i].base <= base && mru->entries[i].bound >= bound &&
+            !(mru->entries[i].reg->flags & MCA_MPOOL_FLAGS_INVALID)) {
+            return mru->entries[i].reg;
+        }
+    }
+
+    return NULL;
+}
+
+static inline void mru_insert(mca_rcache_vma_module_t *vma_rcache,
+                              mca_mpool_base_registration_t *reg)
+{
+    mca_rcache_vma_mru_t *mru;
+
+    if (!vma_rcache->mru_key_valid ||
+        OPAL_SUCCESS != opal_tsd_getspecific(vma_rcache->mru_key, (void **) &mru)) {
+        return;
+    }
+
+    if (NULL == mru) {
+        mru = (mca_rcache_vma_mru_t *) malloc(sizeof(*mru));
+        if (NULL == mru) {
+            return;
+        }
+        if (OPAL_SUCCESS != opal_tsd_setspecific(vma_rcache->mru_key, mru)) {
+            free(mru);
+            return;
+        }
+        mru->generation = vma_rcache->generation - 1;
+    }
+
+    if (mru->generation != vma_rcache->generation) {
+        memset(mru->entries, 0, sizeof(mru->entries));
+        mru->generation = vma_rcache->generation;
+        mru->next = 0;
+    }
+
+    mru->entries[mru->next].base = reg->base;
+    mru->entries[mru->next].bound = reg->bound;
+    mru->entries[mru->next].reg = reg;
+    mru->next = (mru->next + 1) % MCA_RCACHE_VMA_MRU_SIZE;
 }
 
 int mca_rcache_vma_find(struct mca_rcache_base_module_t* rcache,
@@ -65,8 +135,22 @@ int mca_rcache_vma_find(struct mca_rcache_base_module_t* rcache,
         return rc;
     }
 
+    /* the common case is the same buffer as last time */
+    *reg = mru_find((mca_rcache_vma_module_t*)rcache, (unsigned char*)base_addr,
+            (unsigned char*)bound_addr);
+    if (NULL != *reg) {
+        OMPI_PVAR_COUNTER_ADD(mca_rcache_vma_component.lookups[MCA_RCACHE_VMA_PVAR_MRU_HITS], 1);
+        return OMPI_SUCCESS;
+    }
+
     *reg = mca_rcache_vma_tree_find((mca_rcache_vma_module_t*)rcache, (unsigned char*)base_addr,
             (unsigned char*)bound_addr); 
+    if (NULL != *reg) {
+        OMPI_PVAR_COUNTER_ADD(mca_rcache_vma_component.lookups[MCA_RCACHE_VMA_PVAR_TREE_HITS], 1);
+        mru_insert((mca_rcache_vma_module_t*)rcache, *reg);
+    } else {
+        OMPI_PVAR_COUNTER_ADD(mca_rcache_vma_component.lookups[MCA_RCACHE_VMA_PVAR_MISSES], 1);
+    }
 
     return OMPI_SUCCESS;
 }
@@ -132,6 +216,11 @@ int mca_rcache_vma_delete(struct mca_rcache_base_module_t* rcache,
         mca_mpool_base_registration_t* reg)
 {
     mca_rcache_vma_module_t *vma_rcache = (mca_rcache_vma_module_t*)rcache;
+
+    /* forget every per-thread entry before the registration can be
+       reused */
+    OPAL_THREAD_ADD32(&vma_rcache->generation, 1);
+
     /* Tell the memory manager that we no longer care about this
        region */
     opal_memory->memoryc_deregister(reg->base,
@@ -170,4 +259,17 @@ int mca_rcache_vma_clean(struct mca_rcache_base_module_t* rcache)
   */
 void mca_rcache_vma_finalize(struct mca_rcache_base_module_t* rcache)
 {
+    mca_rcache_vma_module_t *vma_rcache = (mca_rcache_vma_module_t*)rcache;
+    mca_rcache_vma_mru_t *mru;
+
+    /* the other threads' caches go with the threads */
+    if (vma_rcache->mru_key_valid) {
+        if (OPAL_SUCCESS == opal_tsd_getspecific(vma_rcache->mru_key, (void **) &mru) &&
+            NULL != mru) {
+            opal_tsd_setspecific(vma_rcache->mru_key, NULL);
+            free(mru);
+        }
+        opal_tsd_key_delete(vma_rcache->mru_key);
+        vma_rcache->mru_key_valid = false;
+    }
 }
@@ -29,23 +29,56 @@
 #include "ompi_config.h"
 #include "opal/mca/mca.h"
 #include "opal/class/opal_list.h" 
+#include "opal/threads/tsd.h"
 #include "ompi/class/ompi_rb_tree.h"
 #include "ompi/mca/rcache/rcache.h"
+#include "ompi/runtime/ompi_pvar_counters.h"
 
 BEGIN_C_DECLS
 
+/* number of recent registrations each thread remembers */
+#define MCA_RCACHE_VMA_MRU_SIZE 4
+
+/**
+ * Per-thread cache of the registrations most recently found, checked
+ * before walking the tree.  It is only trusted while its generation
+ * matches the module's one, which every delete bumps.
+ */
+struct mca_rcache_vma_mru_t {
+    int32_t generation;
+    int next;
+    struct {
+        unsigned char *base;
+        unsigned char *bound;
+        mca_mpool_base_registration_t *reg;
+    } entries[MCA_RCACHE_VMA_MRU_SIZE];
+};
+typedef struct mca_rcache_vma_mru_t mca_rcache_vma_mru_t;
+
 struct mca_rcache_vma_module_t { 
     mca_rcache_base_module_t base;
     ompi_rb_tree_t rb_tree;
     opal_list_t vma_list;
     opal_list_t vma_delete_list;
     size_t reg_cur_cache_size;
+    opal_tsd_key_t mru_key;
+    bool mru_key_valid;
+    volatile int32_t generation;
 };
 typedef struct mca_rcache_vma_module_t mca_rcache_vma_module_t; 
 
 
+/* lookups counted by the rcache_vma_lookups performance variable */
+enum {
+    MCA_RCACHE_VMA_PVAR_MRU_HITS,
+    MCA_RCACHE_VMA_PVAR_TREE_HITS,
+    MCA_RCACHE_VMA_PVAR_MISSES,
+    MCA_RCACHE_VMA_PVAR_MAX
+};
+
 struct mca_rcache_vma_component_t { 
     mca_rcache_base_component_t super; 
+    ompi_pvar_counter_t lookups[MCA_RCACHE_VMA_PVAR_MAX];
 };
 typedef struct mca_rcache_vma_component_t mca_rcache_vma_component_t; 
 
@@ -43,6 +43,10 @@ mca_rcache_vma_component_t mca_rcache_vma_component = {
 
 static int mca_rcache_vma_component_open(void)
 {
+    (void) ompi_pvar_counter_register("rcache", "vma", "lookups", "Number of registrations "
+                                      "found in the per-thread cache of recent registrations, "
+                                      "found in the tree, and not found",
+                                      mca_rcache_vma_component.lookups, MCA_RCACHE_VMA_PVAR_MAX);
     return OMPI_SUCCESS; 
 }
 
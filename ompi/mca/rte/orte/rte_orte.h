@@ -65,6 +65,7 @@ typedef orte_node_rank_t ompi_node_rank_t;
 typedef orte_local_rank_t ompi_local_rank_t;
 #define ompi_process_info orte_process_info
 #define ompi_rte_proc_is_bound orte_proc_is_bound
+#define ompi_rte_direct_modex orte_direct_modex
 
 /* Error handling objects and operations */
 OMPI_DECLSPEC void ompi_rte_abort(int error_code, char *fmt, ...);
@@ -17,6 +17,7 @@
 #include "orte/mca/errmgr/errmgr.h"
 #include "orte/mca/ess/ess.h"
 #include "orte/mca/grpcomm/grpcomm.h"
+#include "orte/mca/grpcomm/base/base.h"
 #include "orte/mca/odls/odls.h"
 #include "orte/mca/plm/plm.h"
 #include "orte/mca/rml/rml.h"
@@ -145,10 +146,28 @@ int ompi_rte_db_store(const orte_process_name_t *nm, const char* key,
     return opal_db.store((opal_identifier_t*)nm, OPAL_DB_GLOBAL, key, data, type);
 }
 
+/* with the direct modex, the entries of a peer are brought in from
+ * its daemon the first time one of them is looked up - the orte
+ * ones come with the nidmap and are always there
+ */
+static int direct_modex_fetch(const orte_process_name_t *nm, const char *key)
+{
+    if (!orte_direct_modex ||
+        (NULL != key && 0 == strncmp(key, "orte.", strlen("orte.")))) {
+        return ORTE_SUCCESS;
+    }
+    return orte_grpcomm_base_fetch_modex(nm);
+}
+
 int ompi_rte_db_fetch(const orte_process_name_t *nm,
                       const char *key,
                       void **data, opal_data_type_t type)
 {
+    int rc;
+
+    if (ORTE_SUCCESS != (rc = direct_modex_fetch(nm, key))) {
+        return rc;
+    }
     return opal_db.fetch((opal_identifier_t*)nm, key, data, type);
 }
 
@@ -156,6 +175,11 @@ int ompi_rte_db_fetch_pointer(const orte_process_name_t *nm,
                               const char *key,
                               void **data, opal_data_type_t type)
 {
+    int rc;
+
+    if (ORTE_SUCCESS != (rc = direct_modex_fetch(nm, key))) {
+        return rc;
+    }
     return opal_db.fetch_pointer((opal_identifier_t*)nm, key, data, type);
 }
 
@@ -163,6 +187,11 @@ int ompi_rte_db_fetch_multiple(const orte_process_name_t *nm,
                                const char *key,
                                opal_list_t *kvs)
 {
+    int rc;
+
+    if (ORTE_SUCCESS != (rc = direct_modex_fetch(nm, key))) {
+        return rc;
+    }
     return opal_db.fetch_multiple((opal_identifier_t*)nm, key, kvs);
 }
 
@@ -98,6 +98,7 @@ typedef struct ompi_process_info_t ompi_process_info_t;
 
 OMPI_DECLSPEC extern ompi_process_info_t ompi_process_info;
 OMPI_DECLSPEC extern bool ompi_rte_proc_is_bound;
+#define ompi_rte_direct_modex false
 
 /* Error handling objects and operations */
 OMPI_DECLSPEC void ompi_rte_abort(int error_code, char *fmt, ...);
@@ -93,6 +93,9 @@
  *              process is on
  *     2. ompi_rte_proc_is_bound - global boolean that will be true if the runtime bound 
  *        the process to a particular core or set of cores and is false otherwise.
+ *     3. ompi_rte_direct_modex - boolean that will be true if the modex data of
+ *        a peer is only retrieved when it is first looked up, rather than
+ *        exchanged by ompi_rte_modex.
  *
  * (d) Error handling objects and operations
  *     1. void ompi_rte_abort(int err_code, char *fmt, ...) - Abort the current 
@@ -201,6 +204,13 @@ BEGIN_C_DECLS
 #define OMPI_RML_TAG_OFACM                          OMPI_RML_TAG_BASE+11
 #define OMPI_RML_TAG_XOFACM                         OMPI_RML_TAG_BASE+12
 
+/* clock offsets for a global MPI_Wtime */
+#define OMPI_RML_TAG_CLOCK_SYNC                     OMPI_RML_TAG_BASE+13
+
+/* sparse bookmark exchange of crcp/bkmrk */
+#define OMPI_CRCP_COORD_BOOKMARK_COUNT_TAG          OMPI_RML_TAG_BASE+14
+#define OMPI_CRCP_COORD_BOOKMARK_SPARSE_TAG         OMPI_RML_TAG_BASE+15
+
 #define OMPI_RML_TAG_DYNAMIC                        OMPI_RML_TAG_BASE+200
 
 typedef struct {
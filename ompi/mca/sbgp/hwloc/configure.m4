@@ -0,0 +1,20 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2013      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+# 
+# Additional copyrights may follow
+# 
+# $HEADER$
+#
+# MCA_sbgp_hwloc_CONFIG([action-if-found], [action-if-not-found])
+# -----------------------------------------------------------
+AC_DEFUN([MCA_ompi_sbgp_hwloc_CONFIG], [
+    AC_CONFIG_FILES([ompi/mca/sbgp/hwloc/Makefile])
+
+    AS_IF([test "$OPAL_HAVE_HWLOC" = 1],
+          [$1],
+          [$2])
+])
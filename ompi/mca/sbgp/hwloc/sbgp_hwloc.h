@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Subgrouping by hwloc object.  Every instance of the component in
+ * sbgp_base_subgroups_string builds one level of the hierarchy, made
+ * of the local processes bound inside the same object of the type
+ * given as key, for instance
+ *
+ *   --mca sbgp_base_subgroups_string hwloc:L3,hwloc:Socket,basesmuma,p2p
+ *
+ * The key is an hwloc type name (Core, Socket or Package, NUMANode,
+ * Machine, ...) or L<n> for the caches of depth n.  Without a key the
+ * sbgp_hwloc_object parameter is used.
+ */
+
+#ifndef MCA_SBGP_HWLOC_EXPORT_H
+#define MCA_SBGP_HWLOC_EXPORT_H
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "opal/mca/mca.h"
+#include "ompi/mca/sbgp/sbgp.h"
+#include "ompi/proc/proc.h"
+
+BEGIN_C_DECLS
+
+/**
+ * Structure to hold the hwloc sbgp component.
+ */
+struct mca_sbgp_hwloc_component_t {
+    /** Base sbgp component */
+    mca_sbgp_base_component_2_0_0_t super;
+
+    /** object type used when the subgroup has no key */
+    char *default_object;
+};
+
+/**
+ * Convenience typedef
+ */
+typedef struct mca_sbgp_hwloc_component_t mca_sbgp_hwloc_component_t;
+
+/*
+** Base sub-group module
+**/
+
+struct mca_sbgp_hwloc_module_t {
+    /** Collective modules all inherit from opal_object */
+    mca_sbgp_base_module_t super;
+
+    /** logical index of the object shared by the group */
+    int object_index;
+};
+typedef struct mca_sbgp_hwloc_module_t mca_sbgp_hwloc_module_t;
+OBJ_CLASS_DECLARATION(mca_sbgp_hwloc_module_t);
+
+/**
+* Global component instance
+*/
+OMPI_MODULE_DECLSPEC extern mca_sbgp_hwloc_component_t mca_sbgp_hwloc_component;
+
+END_C_DECLS
+
+#endif /* MCA_SBGP_HWLOC_EXPORT_H */
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ */
+
+#include "ompi_config.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_STRINGS_H
+#include <strings.h>
+#endif
+
+#include "opal/mca/hwloc/hwloc.h"
+#include "opal/mca/hwloc/base/base.h"
+#include "opal/util/output.h"
+
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/sbgp/base/base.h"
+#include "sbgp_hwloc.h"
+
+#include "ompi/patterns/comm/coll_ops.h"
+
+/*
+ * Public string showing the sbgp hwloc component version number
+ */
+const char *mca_sbgp_hwloc_component_version_string =
+    "Open MPI sbgp - hwloc collective MCA component version " OMPI_VERSION;
+
+/*
+ * Local functions
+ */
+
+static int hwloc_register(void);
+static mca_sbgp_base_module_t *mca_sbgp_hwloc_select_procs(struct ompi_proc_t ** procs,
+        int n_procs_in,
+        struct ompi_communicator_t *comm,
+        char *key,
+        void *output_data
+        );
+static int mca_sbgp_hwloc_init_query(bool enable_progress_threads,
+        bool enable_mpi_threads);
+/*----end local functions ----*/
+
+/*
+ * Instantiate the public struct with all of our public information
+ * and pointers to our public functions in it
+ */
+
+mca_sbgp_hwloc_component_t mca_sbgp_hwloc_component = {
+
+    /* First, fill in the super */
+
+    {
+        /* First, the mca_component_t struct containing meta
+           information about the component itself */
+
+        {
+            MCA_SBGP_BASE_VERSION_2_0_0,
+
+            /* Component name and version */
+
+            "hwloc",
+            OMPI_MAJOR_VERSION,
+            OMPI_MINOR_VERSION,
+            OMPI_RELEASE_VERSION,
+
+            /* Component open and close functions */
+
+            NULL,
+            NULL,
+            NULL,
+            hwloc_register
+        },
+
+    mca_sbgp_hwloc_init_query,
+    mca_sbgp_hwloc_select_procs,
+
+    /* (default) priority */
+    0
+    }
+
+};
+
+/*
+ * Register the component
+ */
+static int hwloc_register(void)
+{
+    mca_sbgp_hwloc_component_t *cs = &mca_sbgp_hwloc_component;
+
+    cs->super.priority = 90;
+    (void) mca_base_component_var_register(&cs->super.sbgp_version,
+                                           "priority", "Priority for the sbgp hwloc component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &cs->super.priority);
+
+    cs->default_object = "Socket";
+    (void) mca_base_component_var_register(&cs->super.sbgp_version,
+                                           "object", "hwloc object shared by the processes of a "
+                                           "subgroup when sbgp_base_subgroups_string gives no "
+                                           "key (hwloc:<object>): an hwloc type name such as "
+                                           "Core, Socket or Package, NUMANode, Machine, or L<n> "
+                                           "for the caches of depth n",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &cs->default_object);
+
+    return OMPI_SUCCESS;
+}
+
+/* query to see if the component is available for use, and can
+ * satisfy the thread and progress requirements
+ */
+static int mca_sbgp_hwloc_init_query(bool enable_progress_threads,
+        bool enable_mpi_threads)
+{
+    /* done */
+    return OMPI_SUCCESS;
+}
+
+/* depth in the topology of the objects named by the key */
+static int mca_sbgp_hwloc_object_depth(const char *name)
+{
+    hwloc_obj_type_t type;
+
+    if (('L' == name[0] || 'l' == name[0]) && isdigit((unsigned char) name[1])) {
+        /* the data or unified cache of that level */
+        return hwloc_get_cache_type_depth(opal_hwloc_topology, (unsigned) atoi(name + 1),
+                                          HWLOC_OBJ_CACHE_DATA);
+    }
+
+    if (0 == strcasecmp(name, "Package")) {
+        type = HWLOC_OBJ_SOCKET;
+    } else {
+        type = hwloc_obj_type_of_string(name);
+        if ((hwloc_obj_type_t) -1 == type) {
+            return HWLOC_TYPE_DEPTH_UNKNOWN;
+        }
+    }
+    return hwloc_get_type_depth(opal_hwloc_topology, type);
+}
+
+/* logical index of the object at depth that holds all my PUs, -1 if
+ * my binding spans several of them */
+static int mca_sbgp_hwloc_my_object(int depth)
+{
+    hwloc_cpuset_t bound;
+    hwloc_obj_t obj;
+    int index = -1;
+
+    bound = hwloc_bitmap_alloc();
+    if (NULL == bound) {
+        return -1;
+    }
+
+    if (0 == hwloc_get_cpubind(opal_hwloc_topology, bound, 0) && !hwloc_bitmap_iszero(bound)) {
+        obj = hwloc_get_obj_covering_cpuset(opal_hwloc_topology, bound);
+        while (NULL != obj && (int) obj->depth > depth) {
+            obj = obj->parent;
+        }
+        if (NULL != obj && (int) obj->depth == depth) {
+            index = (int) obj->logical_index;
+        }
+    }
+
+    hwloc_bitmap_free(bound);
+    return index;
+}
+
+/* This routine is used to find the list of procs that run on the
+** same host as the calling process and under the same hwloc object.
+*/
+
+static mca_sbgp_base_module_t *mca_sbgp_hwloc_select_procs(struct ompi_proc_t ** procs,
+    int n_procs_in,
+    struct ompi_communicator_t *comm,
+    char *key,
+    void *output_data
+    )
+{
+    mca_sbgp_hwloc_module_t *module;
+    const char *object = (NULL != key) ? key : mca_sbgp_hwloc_component.default_object;
+    ompi_proc_t *my_proc = ompi_proc_local();
+    int *local_ranks_in_comm = NULL, *object_info = NULL;
+    int proc, rank, n_local_peers = 0, my_local_index = -1, my_object = -1, depth, cnt, ret;
+    int comm_size = ompi_comm_size(comm);
+
+    /* check the key first: a bad one is a configuration error that
+     * every local process sees the same way */
+    if (NULL == opal_hwloc_topology) {
+        return NULL;
+    }
+    depth = mca_sbgp_hwloc_object_depth(object);
+    if (depth < 0) {
+        opal_output_verbose(10, ompi_sbgp_base_framework.framework_output,
+                            "sbgp:hwloc: no single level of %s objects in the topology",
+                            object);
+        return NULL;
+    }
+
+    /* the local procs in the input list, with their rank in comm.  The
+     * procs are in the same relative order as in the communicator */
+    local_ranks_in_comm = (int *) malloc(sizeof(int) * n_procs_in);
+    if (NULL == local_ranks_in_comm) {
+        return NULL;
+    }
+    for (proc = 0, rank = 0 ; proc < n_procs_in ; proc++) {
+        if (!OPAL_PROC_ON_LOCAL_NODE(procs[proc]->proc_flags)) {
+            continue;
+        }
+        for ( ; rank < comm_size ; rank++) {
+            if (procs[proc] == ompi_comm_peer_lookup(comm, rank)) {
+                break;
+            }
+        }
+        if (my_proc == procs[proc]) {
+            my_local_index = n_local_peers;
+        }
+        local_ranks_in_comm[n_local_peers++] = rank;
+    }
+
+    /* nobody to group with */
+    if (n_local_peers <= 1 || -1 == my_local_index) {
+        free(local_ranks_in_comm);
+        return NULL;
+    }
+
+    /* everybody takes part in the exchange, even when not bound inside
+     * a single object */
+    my_object = mca_sbgp_hwloc_my_object(depth);
+    object_info = (int *) malloc(sizeof(int) * n_local_peers);
+    if (NULL == object_info) {
+        free(local_ranks_in_comm);
+        return NULL;
+    }
+    ret = comm_allgather_pml(&my_object, object_info, 1, MPI_INT, my_local_index,
+                             n_local_peers, local_ranks_in_comm, comm);
+    if (OMPI_SUCCESS != ret || -1 == my_object) {
+        opal_output_verbose(10, ompi_sbgp_base_framework.framework_output,
+                            "sbgp:hwloc: rank %d not grouped by %s (%d)",
+                            ompi_comm_rank(comm), object, ret);
+        free(object_info);
+        free(local_ranks_in_comm);
+        return NULL;
+    }
+
+    module = OBJ_NEW(mca_sbgp_hwloc_module_t);
+    if (NULL == module) {
+        free(object_info);
+        free(local_ranks_in_comm);
+        return NULL;
+    }
+    module->super.group_comm = comm;
+    /* the levels under the node share the memory of a socket at most */
+    module->super.group_net = (HWLOC_OBJ_MACHINE == hwloc_get_depth_type(opal_hwloc_topology, depth)) ?
+        OMPI_SBGP_MUMA : OMPI_SBGP_SOCKET;
+    module->object_index = my_object;
+    module->super.group_list = (int *) malloc(sizeof(int) * n_local_peers);
+    if (NULL == module->super.group_list) {
+        OBJ_RELEASE(module);
+        free(object_info);
+        free(local_ranks_in_comm);
+        return NULL;
+    }
+
+    for (proc = 0, cnt = 0 ; proc < n_local_peers ; proc++) {
+        if (object_info[proc] == my_object) {
+            module->super.group_list[cnt++] = local_ranks_in_comm[proc];
+        }
+    }
+    module->super.group_size = cnt;
+
+    opal_output_verbose(10, ompi_sbgp_base_framework.framework_output,
+                        "sbgp:hwloc: rank %d shares %s %d with %d processes",
+                        ompi_comm_rank(comm), object, my_object, cnt);
+
+    free(object_info);
+    free(local_ranks_in_comm);
+    return (mca_sbgp_base_module_t *) module;
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ */
+
+#include "ompi_config.h"
+
+#include "ompi/constants.h"
+#include "ompi/mca/sbgp/hwloc/sbgp_hwloc.h"
+
+static void
+mca_sbgp_hwloc_module_construct(mca_sbgp_hwloc_module_t *module)
+{
+    module->object_index = -1;
+}
+
+OBJ_CLASS_INSTANCE(mca_sbgp_hwloc_module_t,
+                   mca_sbgp_base_module_t,
+                   mca_sbgp_hwloc_module_construct,
+                   NULL);
@@ -54,9 +54,11 @@ int mca_sharedfp_dummy_component_init_query(bool enable_progress_threads,
 }      
 
 struct mca_sharedfp_base_module_1_0_0_t *
-mca_sharedfp_dummy_component_file_query (int *priority)
+mca_sharedfp_dummy_component_file_query (mca_io_ompio_file_t *file, int *priority)
 {
-   *priority = 20;
+   /* only keeps the shared file pointer operations from crashing, the
+      other components shall win */
+   *priority = 1;
 
    return &dummy;
 }
@@ -31,7 +31,7 @@ BEGIN_C_DECLS
 int mca_sharedfp_dummy_component_init_query(bool enable_progress_threads,
                                         bool enable_mpi_threads);
 struct mca_sharedfp_base_module_1_0_0_t *
-mca_sharedfp_dummy_component_file_query (int *priority);
+mca_sharedfp_dummy_component_file_query (mca_io_ompio_file_t *file, int *priority);
 int mca_sharedfp_dummy_component_file_unquery (mca_io_ompio_file_t *file);
 
 int mca_sharedfp_dummy_module_init (mca_io_ompio_file_t *file);
@@ -45,8 +45,8 @@ OMPI_MODULE_DECLSPEC extern mca_sharedfp_base_component_2_0_0_t mca_sharedfp_dum
  */ 
 
 int mca_sharedfp_dummy_update (mca_io_ompio_file_t *fh, 
-                               int num_bytes,
-                               OMPI_MPI_OFFSET_TYPE current_position);
+                               OMPI_MPI_OFFSET_TYPE num_etypes,
+                               OMPI_MPI_OFFSET_TYPE *position);
 int mca_sharedfp_dummy_seek (mca_io_ompio_file_t *fh, 
                              OMPI_MPI_OFFSET_TYPE position);
 
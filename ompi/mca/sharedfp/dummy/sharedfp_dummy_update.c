@@ -27,9 +27,10 @@
 
 int
 mca_sharedfp_dummy_update (mca_io_ompio_file_t *fh, 
-                           int num_bytes,
-                           OMPI_MPI_OFFSET_TYPE current_position)
+                           OMPI_MPI_OFFSET_TYPE num_etypes,
+                           OMPI_MPI_OFFSET_TYPE *position)
 {
     printf ("DUMMY UPDATING\n");
+    *position = 0;
     return OMPI_SUCCESS;
 }
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2013      University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ *
+ * These symbols are in a file by themselves to provide nice linker
+ * semantics. Since linkers generally pull in symbols by object fules,
+ * keeping these symbols as the only symbols in this file prevents
+ * utility programs such as "ompi_info" from having to import entire
+ * modules just to query their version and parameters
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/sharedfp/lockedfile/sharedfp_lockedfile.h"
+
+/*
+ * *******************************************************************
+ * ************************ actions structure ************************
+ * *******************************************************************
+ */
+static mca_sharedfp_base_module_1_0_0_t lockedfile =  {
+    mca_sharedfp_lockedfile_module_init, /* initalise after being selected */
+    mca_sharedfp_lockedfile_module_finalize, /* close a module on a communicator */
+    mca_sharedfp_lockedfile_update,
+    mca_sharedfp_lockedfile_seek
+};
+/*
+ * *******************************************************************
+ * ************************* structure ends **************************
+ * *******************************************************************
+ */
+
+int mca_sharedfp_lockedfile_component_init_query(bool enable_progress_threads,
+                                                 bool enable_mpi_threads)
+{
+    /* Nothing to do */
+   
+   return OMPI_SUCCESS;
+}      
+
+struct mca_sharedfp_base_module_1_0_0_t *
+mca_sharedfp_lockedfile_component_file_query (mca_io_ompio_file_t *fh, int *priority)
+{
+   /* works on any number of nodes, as long as the file system honours
+      the locks */
+   *priority = mca_sharedfp_lockedfile_priority;
+
+   return &lockedfile;
+}
+
+int mca_sharedfp_lockedfile_component_file_unquery (mca_io_ompio_file_t *file)
+{    
+   /* This function might be needed for some purposes later. for now it
+    * does not have anything to do since there are no steps which need 
+    * to be undone if this module is not selected */
+
+   return OMPI_SUCCESS;
+}
+
+int mca_sharedfp_lockedfile_module_init (mca_io_ompio_file_t *fh)
+{
+    mca_sharedfp_lockedfile_data_t *data;
+    char hostname[64];
+    int64_t zero = 0;
+    int ret, len, opened, all_opened;
+
+    data = (mca_sharedfp_lockedfile_data_t *) malloc (sizeof(mca_sharedfp_lockedfile_data_t));
+    if (NULL == data) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    data->handle = -1;
+    data->filename[0] = '\0';
+
+    /* the first process names the pointer file after the data file, its
+       host and its pid, so that two jobs, or two opens of the same file,
+       do not share it, and creates it. An empty name tells the others
+       that it failed */
+    if (0 == fh->f_rank) {
+        gethostname (hostname, sizeof(hostname));
+        hostname[sizeof(hostname) - 1] = '\0';
+        len = snprintf (data->filename, sizeof(data->filename), "%s-%s-%d-%d.lockedfile",
+                        fh->f_filename, hostname, (int) getpid(), fh->f_comm->c_contextid);
+        if (len > 0 && len < (int) sizeof(data->filename)) {
+            data->handle = open (data->filename, O_CREAT | O_TRUNC | O_RDWR, 0644);
+        }
+        if (-1 != data->handle &&
+            sizeof(zero) != pwrite (data->handle, &zero, sizeof(zero), 0)) {
+            close (data->handle);
+            unlink (data->filename);
+            data->handle = -1;
+        }
+        if (-1 == data->handle) {
+            data->filename[0] = '\0';
+        }
+    }
+
+    ret = fh->f_comm->c_coll.coll_bcast (data->filename,
+                                         sizeof(data->filename),
+                                         MPI_CHAR,
+                                         0,
+                                         fh->f_comm,
+                                         fh->f_comm->c_coll.coll_bcast_module);
+    if (OMPI_SUCCESS != ret) {
+        goto exit;
+    }
+    if (0 != fh->f_rank && '\0' != data->filename[0]) {
+        data->handle = open (data->filename, O_RDWR);
+    }
+
+    opened = (-1 != data->handle);
+    ret = fh->f_comm->c_coll.coll_allreduce (&opened,
+                                             &all_opened,
+                                             1,
+                                             MPI_INT,
+                                             MPI_MIN,
+                                             fh->f_comm,
+                                             fh->f_comm->c_coll.coll_allreduce_module);
+    if (OMPI_SUCCESS != ret) {
+        goto exit;
+    }
+    if (!all_opened) {
+        ret = OMPI_ERROR;
+        goto exit;
+    }
+
+    fh->f_sharedfp_ptr = data;
+    return OMPI_SUCCESS;
+
+ exit:
+    if (-1 != data->handle) {
+        close (data->handle);
+        if (0 == fh->f_rank) {
+            unlink (data->filename);
+        }
+    }
+    free (data);
+    return ret;
+}
+
+   
+int mca_sharedfp_lockedfile_module_finalize (mca_io_ompio_file_t *fh) 
+{
+    mca_sharedfp_lockedfile_data_t *data =
+        (mca_sharedfp_lockedfile_data_t *) fh->f_sharedfp_ptr;
+
+    if (NULL == data) {
+        return OMPI_SUCCESS;
+    }
+
+    /* the file is removed once nobody uses it any more */
+    close (data->handle);
+    fh->f_comm->c_coll.coll_barrier (fh->f_comm,
+                                     fh->f_comm->c_coll.coll_barrier_module);
+    if (0 == fh->f_rank) {
+        unlink (data->filename);
+    }
+    free (data);
+    fh->f_sharedfp_ptr = NULL;
+
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2013      University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#ifndef MCA_SHAREDFP_LOCKEDFILE_H
+#define MCA_SHAREDFP_LOCKEDFILE_H
+
+#include "ompi_config.h"
+#include "opal/mca/mca.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/io/ompio/io_ompio.h"
+
+
+BEGIN_C_DECLS
+
+extern int mca_sharedfp_lockedfile_priority;
+
+/*
+ * hung on f_sharedfp_ptr. The shared file pointer is the only content of
+ * a small file next to the data file, and is updated under an fcntl
+ * lock, which works across the nodes on the file systems supporting the
+ * locks.
+ */
+typedef struct mca_sharedfp_lockedfile_data_t {
+    int   handle;
+    char  filename[OPAL_PATH_MAX];
+} mca_sharedfp_lockedfile_data_t;
+
+int mca_sharedfp_lockedfile_component_init_query(bool enable_progress_threads,
+                                                 bool enable_mpi_threads);
+struct mca_sharedfp_base_module_1_0_0_t *
+mca_sharedfp_lockedfile_component_file_query (mca_io_ompio_file_t *file, int *priority);
+int mca_sharedfp_lockedfile_component_file_unquery (mca_io_ompio_file_t *file);
+
+int mca_sharedfp_lockedfile_module_init (mca_io_ompio_file_t *file);
+int mca_sharedfp_lockedfile_module_finalize (mca_io_ompio_file_t *file);
+
+OMPI_MODULE_DECLSPEC extern mca_sharedfp_base_component_2_0_0_t mca_sharedfp_lockedfile_component;
+/*
+ * ******************************************************************
+ * ********* functions which are implemented in this module *********
+ * ******************************************************************
+ */ 
+
+int mca_sharedfp_lockedfile_update (mca_io_ompio_file_t *fh, 
+                                    OMPI_MPI_OFFSET_TYPE num_etypes,
+                                    OMPI_MPI_OFFSET_TYPE *position);
+int mca_sharedfp_lockedfile_seek (mca_io_ompio_file_t *fh, 
+                                  OMPI_MPI_OFFSET_TYPE position);
+
+/* Reads the pointer into *old, then stores either operand (replace) or
+   the old value plus operand, under the lock of the pointer file. A read
+   only access takes a shared lock. */
+int mca_sharedfp_lockedfile_fetch_and_op (mca_sharedfp_lockedfile_data_t *data,
+                                          OMPI_MPI_OFFSET_TYPE operand,
+                                          bool replace,
+                                          OMPI_MPI_OFFSET_TYPE *old);
+
+/*
+ * ******************************************************************
+ * ************ functions implemented in this module end ************
+ * ******************************************************************
+ */ 
+                                     
+END_C_DECLS
+
+#endif /* MCA_SHAREDFP_LOCKEDFILE_H */
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2013      University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+
+#include "ompi_config.h"
+#include "sharedfp_lockedfile.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+
+int
+mca_sharedfp_lockedfile_seek (mca_io_ompio_file_t *fh, 
+                              OMPI_MPI_OFFSET_TYPE position)
+{
+    mca_sharedfp_lockedfile_data_t *data =
+        (mca_sharedfp_lockedfile_data_t *) fh->f_sharedfp_ptr;
+    int ret = OMPI_SUCCESS, all_ret;
+
+    /* nobody may still use the old value when it is replaced, and nobody
+       may use the new one before it is stored */
+    ret = fh->f_comm->c_coll.coll_barrier (fh->f_comm,
+                                           fh->f_comm->c_coll.coll_barrier_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    if (0 == fh->f_rank) {
+        ret = mca_sharedfp_lockedfile_fetch_and_op (data, position, true, NULL);
+    }
+
+    /* the error of the first process is everybody's */
+    all_ret = fh->f_comm->c_coll.coll_bcast (&ret,
+                                             1,
+                                             MPI_INT,
+                                             0,
+                                             fh->f_comm,
+                                             fh->f_comm->c_coll.coll_bcast_module);
+    if (OMPI_SUCCESS != all_ret) {
+        return all_ret;
+    }
+    return ret;
+}
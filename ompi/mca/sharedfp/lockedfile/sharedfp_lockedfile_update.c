@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2013      University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+
+#include "ompi_config.h"
+#include "sharedfp_lockedfile.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+
+static int lockedfile_lock (int handle, short type)
+{
+    struct flock lock;
+
+    lock.l_type   = type;
+    lock.l_whence = SEEK_SET;
+    lock.l_start  = 0;
+    lock.l_len    = sizeof(int64_t);
+
+    while (-1 == fcntl (handle, F_SETLKW, &lock)) {
+        if (EINTR != errno) {
+            return OMPI_ERROR;
+        }
+    }
+    return OMPI_SUCCESS;
+}
+
+int
+mca_sharedfp_lockedfile_fetch_and_op (mca_sharedfp_lockedfile_data_t *data,
+                                      OMPI_MPI_OFFSET_TYPE operand,
+                                      bool replace,
+                                      OMPI_MPI_OFFSET_TYPE *old)
+{
+    bool read_only = (!replace && 0 == operand);
+    int64_t value;
+    int ret;
+
+    ret = lockedfile_lock (data->handle, read_only ? F_RDLCK : F_WRLCK);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    if (sizeof(value) != pread (data->handle, &value, sizeof(value), 0)) {
+        ret = OMPI_ERROR;
+        goto unlock;
+    }
+    if (NULL != old) {
+        *old = (OMPI_MPI_OFFSET_TYPE) value;
+    }
+
+    if (!read_only) {
+        value = replace ? (int64_t) operand : value + (int64_t) operand;
+        if (sizeof(value) != pwrite (data->handle, &value, sizeof(value), 0)) {
+            ret = OMPI_ERROR;
+        }
+    }
+
+ unlock:
+    if (OMPI_SUCCESS != lockedfile_lock (data->handle, F_UNLCK)) {
+        ret = OMPI_ERROR;
+    }
+    return ret;
+}
+
+int
+mca_sharedfp_lockedfile_update (mca_io_ompio_file_t *fh, 
+                                OMPI_MPI_OFFSET_TYPE num_etypes,
+                                OMPI_MPI_OFFSET_TYPE *position)
+{
+    mca_sharedfp_lockedfile_data_t *data =
+        (mca_sharedfp_lockedfile_data_t *) fh->f_sharedfp_ptr;
+
+    return mca_sharedfp_lockedfile_fetch_and_op (data, num_etypes, false, position);
+}
@@ -58,6 +58,12 @@ struct mca_io_ompio_file_t;
  * In addition, two functions, namely updating the value of a shared
  * file pointer and moving the shared file pointer (seek) have to be provided
  * by every module.
+ *
+ * The shared file pointer is kept in etypes, relative to the current
+ * view, like the offsets given to the explicit offset functions. The
+ * update is an atomic fetch and add: it returns the position before
+ * moving the pointer by num_etypes. The seek is collective, and sets the
+ * pointer once all the processes are done with the previous value.
  */
 
 /*
@@ -71,7 +77,8 @@ typedef int (*mca_sharedfp_base_component_init_query_1_0_0_fn_t)
      bool enable_mpi_threads);
 
 typedef struct mca_sharedfp_base_module_1_0_0_t * 
-(*mca_sharedfp_base_component_file_query_1_0_0_fn_t) (int *priority);
+(*mca_sharedfp_base_component_file_query_1_0_0_fn_t) (struct mca_io_ompio_file_t *file,
+                                                      int *priority);
 
 typedef int (*mca_sharedfp_base_component_file_unquery_1_0_0_fn_t)
     (struct mca_io_ompio_file_t *file);
@@ -107,8 +114,8 @@ typedef int (*mca_sharedfp_base_module_finalize_1_0_0_fn_t)
 (struct mca_io_ompio_file_t *file);
 
 typedef int (*mca_sharedfp_base_module_update_fn_t)(
-    struct mca_io_ompio_file_t *fh, int num_bytes,
-    OMPI_MPI_OFFSET_TYPE current_position);
+    struct mca_io_ompio_file_t *fh, OMPI_MPI_OFFSET_TYPE num_etypes,
+    OMPI_MPI_OFFSET_TYPE *position);
 typedef int (*mca_sharedfp_base_module_seek_fn_t)(
     struct mca_io_ompio_file_t *fh, OMPI_MPI_OFFSET_TYPE position);
 
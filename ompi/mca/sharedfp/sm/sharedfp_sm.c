@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2013      University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ *
+ * These symbols are in a file by themselves to provide nice linker
+ * semantics. Since linkers generally pull in symbols by object fules,
+ * keeping these symbols as the only symbols in this file prevents
+ * utility programs such as "ompi_info" from having to import entire
+ * modules just to query their version and parameters
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "opal/util/os_path.h"
+#include "opal/mca/shmem/base/base.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/group/group.h"
+#include "ompi/proc/proc.h"
+#include "ompi/mca/rte/rte.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/sharedfp/sm/sharedfp_sm.h"
+
+/*
+ * *******************************************************************
+ * ************************ actions structure ************************
+ * *******************************************************************
+ */
+static mca_sharedfp_base_module_1_0_0_t sm =  {
+    mca_sharedfp_sm_module_init, /* initalise after being selected */
+    mca_sharedfp_sm_module_finalize, /* close a module on a communicator */
+    mca_sharedfp_sm_update,
+    mca_sharedfp_sm_seek
+};
+/*
+ * *******************************************************************
+ * ************************* structure ends **************************
+ * *******************************************************************
+ */
+
+int mca_sharedfp_sm_component_init_query(bool enable_progress_threads,
+                                         bool enable_mpi_threads)
+{
+    /* Nothing to do */
+   
+   return OMPI_SUCCESS;
+}      
+
+struct mca_sharedfp_base_module_1_0_0_t *
+mca_sharedfp_sm_component_file_query (mca_io_ompio_file_t *fh, int *priority)
+{
+#if OPAL_HAVE_ATOMIC_MATH_64
+    ompi_proc_t *proc;
+    int i;
+
+    /* the answer is the same on all the processes: as soon as the file
+       spans two nodes, every process has a peer on the other one */
+    for (i = 0; i < fh->f_size; i++) {
+        proc = ompi_group_peer_lookup (fh->f_comm->c_local_group, i);
+        if (i != fh->f_rank && !OPAL_PROC_ON_LOCAL_NODE(proc->proc_flags)) {
+            return NULL;
+        }
+    }
+
+    *priority = mca_sharedfp_sm_priority;
+    return &sm;
+#else
+    return NULL;
+#endif
+}
+
+int mca_sharedfp_sm_component_file_unquery (mca_io_ompio_file_t *file)
+{    
+   /* This function might be needed for some purposes later. for now it
+    * does not have anything to do since there are no steps which need 
+    * to be undone if this module is not selected */
+
+   return OMPI_SUCCESS;
+}
+
+int mca_sharedfp_sm_module_init (mca_io_ompio_file_t *fh)
+{
+    mca_sharedfp_sm_data_t *data;
+    char *shortpath = NULL, *fullpath = NULL;
+    int ret, attached, all_attached;
+
+    data = (mca_sharedfp_sm_data_t *) malloc (sizeof(mca_sharedfp_sm_data_t));
+    if (NULL == data) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    data->sm_offset = NULL;
+    OPAL_SHMEM_DS_INVALIDATE(&data->seg_ds);
+
+    /* the first process creates and initializes the segment. The file
+       communicator is a private duplicate, its CID and the PID of its
+       first process name the segment of this file only */
+    if (0 == fh->f_rank) {
+        asprintf (&shortpath, "sharedfp-sm-cid-%d-pid-%d.mmap",
+                  fh->f_comm->c_contextid, (int) getpid());
+        if (NULL != shortpath) {
+            fullpath = opal_os_path (false, ompi_process_info.job_session_dir,
+                                     shortpath, NULL);
+            free (shortpath);
+        }
+        if (NULL != fullpath &&
+            OPAL_SUCCESS == opal_shmem_segment_create (&data->seg_ds, fullpath,
+                                                       sizeof(mca_sharedfp_sm_offset_t))) {
+            data->sm_offset = (mca_sharedfp_sm_offset_t *)
+                opal_shmem_segment_attach (&data->seg_ds);
+            if (NULL == data->sm_offset) {
+                opal_shmem_unlink (&data->seg_ds);
+                OPAL_SHMEM_DS_INVALIDATE(&data->seg_ds);
+            }
+            else {
+                data->sm_offset->offset = 0;
+                opal_atomic_wmb ();
+            }
+        }
+        if (NULL != fullpath) {
+            free (fullpath);
+        }
+    }
+
+    ret = fh->f_comm->c_coll.coll_bcast (&data->seg_ds,
+                                         sizeof(opal_shmem_ds_t),
+                                         MPI_BYTE,
+                                         0,
+                                         fh->f_comm,
+                                         fh->f_comm->c_coll.coll_bcast_module);
+    if (OMPI_SUCCESS != ret) {
+        goto exit;
+    }
+
+    if (0 != fh->f_rank && OPAL_SHMEM_DS_IS_VALID(&data->seg_ds)) {
+        data->sm_offset = (mca_sharedfp_sm_offset_t *)
+            opal_shmem_segment_attach (&data->seg_ds);
+    }
+
+    /* once everybody is attached, the backing file can go */
+    attached = (NULL != data->sm_offset);
+    ret = fh->f_comm->c_coll.coll_allreduce (&attached,
+                                             &all_attached,
+                                             1,
+                                             MPI_INT,
+                                             MPI_MIN,
+                                             fh->f_comm,
+                                             fh->f_comm->c_coll.coll_allreduce_module);
+    if (OMPI_SUCCESS != ret) {
+        goto exit;
+    }
+    if (0 == fh->f_rank && attached) {
+        opal_shmem_unlink (&data->seg_ds);
+    }
+    if (!all_attached) {
+        ret = OMPI_ERROR;
+        goto exit;
+    }
+
+    fh->f_sharedfp_ptr = data;
+    return OMPI_SUCCESS;
+
+ exit:
+    if (NULL != data->sm_offset) {
+        opal_shmem_segment_detach (&data->seg_ds);
+    }
+    free (data);
+    return ret;
+}
+
+   
+int mca_sharedfp_sm_module_finalize (mca_io_ompio_file_t *fh) 
+{
+    mca_sharedfp_sm_data_t *data = (mca_sharedfp_sm_data_t *) fh->f_sharedfp_ptr;
+
+    if (NULL != data) {
+        opal_shmem_segment_detach (&data->seg_ds);
+        free (data);
+        fh->f_sharedfp_ptr = NULL;
+    }
+
+    return OMPI_SUCCESS;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2013      University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#ifndef MCA_SHAREDFP_SM_H
+#define MCA_SHAREDFP_SM_H
+
+#include "ompi_config.h"
+#include "opal/mca/mca.h"
+#include "opal/mca/shmem/shmem.h"
+#include "opal/sys/atomic.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+#include "ompi/mca/io/ompio/io_ompio.h"
+
+
+BEGIN_C_DECLS
+
+extern int mca_sharedfp_sm_priority;
+
+/*
+ * The shared file pointer, alone in a segment created by the first
+ * process of the file communicator. It is only ever modified with
+ * atomic operations.
+ */
+typedef struct mca_sharedfp_sm_offset_t {
+    volatile int64_t offset;
+} mca_sharedfp_sm_offset_t;
+
+/* hung on f_sharedfp_ptr */
+typedef struct mca_sharedfp_sm_data_t {
+    opal_shmem_ds_t           seg_ds;
+    mca_sharedfp_sm_offset_t *sm_offset;
+} mca_sharedfp_sm_data_t;
+
+int mca_sharedfp_sm_component_init_query(bool enable_progress_threads,
+                                         bool enable_mpi_threads);
+struct mca_sharedfp_base_module_1_0_0_t *
+mca_sharedfp_sm_component_file_query (mca_io_ompio_file_t *file, int *priority);
+int mca_sharedfp_sm_component_file_unquery (mca_io_ompio_file_t *file);
+
+int mca_sharedfp_sm_module_init (mca_io_ompio_file_t *file);
+int mca_sharedfp_sm_module_finalize (mca_io_ompio_file_t *file);
+
+OMPI_MODULE_DECLSPEC extern mca_sharedfp_base_component_2_0_0_t mca_sharedfp_sm_component;
+/*
+ * ******************************************************************
+ * ********* functions which are implemented in this module *********
+ * ******************************************************************
+ */ 
+
+int mca_sharedfp_sm_update (mca_io_ompio_file_t *fh, 
+                            OMPI_MPI_OFFSET_TYPE num_etypes,
+                            OMPI_MPI_OFFSET_TYPE *position);
+int mca_sharedfp_sm_seek (mca_io_ompio_file_t *fh, 
+                          OMPI_MPI_OFFSET_TYPE position);
+
+/*
+ * ******************************************************************
+ * ************ functions implemented in this module end ************
+ * ******************************************************************
+ */ 
+                                     
+END_C_DECLS
+
+#endif /* MCA_SHAREDFP_SM_H */
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2013      University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+
+#include "ompi_config.h"
+#include "sharedfp_sm.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+
+int
+mca_sharedfp_sm_seek (mca_io_ompio_file_t *fh, 
+                      OMPI_MPI_OFFSET_TYPE position)
+{
+    mca_sharedfp_sm_data_t *data = (mca_sharedfp_sm_data_t *) fh->f_sharedfp_ptr;
+    int ret;
+
+    /* nobody may still use the old value when it is replaced, and nobody
+       may use the new one before it is stored */
+    ret = fh->f_comm->c_coll.coll_barrier (fh->f_comm,
+                                           fh->f_comm->c_coll.coll_barrier_module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    if (0 == fh->f_rank) {
+        data->sm_offset->offset = (int64_t) position;
+        opal_atomic_wmb ();
+    }
+
+    return fh->f_comm->c_coll.coll_barrier (fh->f_comm,
+                                            fh->f_comm->c_coll.coll_barrier_module);
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2013      University of Houston. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+
+#include "ompi_config.h"
+#include "sharedfp_sm.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/mca/sharedfp/sharedfp.h"
+
+int
+mca_sharedfp_sm_update (mca_io_ompio_file_t *fh, 
+                        OMPI_MPI_OFFSET_TYPE num_etypes,
+                        OMPI_MPI_OFFSET_TYPE *position)
+{
+    mca_sharedfp_sm_data_t *data = (mca_sharedfp_sm_data_t *) fh->f_sharedfp_ptr;
+
+    if (0 == num_etypes) {
+        opal_atomic_rmb ();
+        *position = (OMPI_MPI_OFFSET_TYPE) data->sm_offset->offset;
+        return OMPI_SUCCESS;
+    }
+
+    /* the add returns the new value */
+    *position = (OMPI_MPI_OFFSET_TYPE)
+        (opal_atomic_add_64 (&data->sm_offset->offset, (int64_t) num_etypes) -
+         (int64_t) num_etypes);
+
+    return OMPI_SUCCESS;
+}
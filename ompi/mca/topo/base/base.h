@@ -45,6 +45,9 @@ OMPI_DECLSPEC int mca_topo_base_lazy_init(void);
  */
 OMPI_DECLSPEC extern mca_base_framework_t ompi_topo_base_framework;
 
+/* Reorder the ranks of the new topologies when the application allows it */
+OMPI_DECLSPEC extern bool mca_topo_base_reorder;
+
 /* Select a topo module for a particular type of topology */
 OMPI_DECLSPEC int
 mca_topo_base_comm_select(const ompi_communicator_t*  comm,
@@ -191,6 +194,47 @@ OMPI_DECLSPEC int
 mca_topo_base_dist_graph_neighbors_count(ompi_communicator_t *comm,
                                          int *inneighbors, int *outneighbors, int *weighted);
 
+/**
+ * Number of neighbors of the calling process in any kind of topology,
+ * as seen by the neighborhood collectives. A cartesian topology has
+ * two neighbors per dimension, some of them maybe MPI_PROC_NULL.
+ */
+OMPI_DECLSPEC int
+mca_topo_base_neighbor_count(ompi_communicator_t *comm,
+                             int *indegree, int *outdegree);
+
+/**
+ * Ranks the neighborhood collectives receive from and send to, in the
+ * order of the blocks of the buffers. The arrays must hold the counts
+ * returned by mca_topo_base_neighbor_count.
+ */
+OMPI_DECLSPEC int
+mca_topo_base_neighbors(ompi_communicator_t *comm,
+                        int sources[], int destinations[]);
+
+/**
+ * Mapping of the vertices of a topology to the processes of comm, for
+ * the creation of a topology with reorder: on return map[v] is the rank
+ * in comm of the process given the vertex v (and rank v in the new
+ * communicator). The vertices of a cartesian or graph topology only go
+ * to the processes among the first nnodes ranks, all the processes of
+ * comm take part in a distributed graph. The map tries to keep the
+ * neighbors on the same node, then on the same socket; it is the
+ * identity when this would not help. Collective over comm.
+ */
+OMPI_DECLSPEC int
+mca_topo_base_cart_map_procs(ompi_communicator_t *comm, int ndims,
+                             int *dims, int *periods, int *map);
+
+OMPI_DECLSPEC int
+mca_topo_base_graph_map_procs(ompi_communicator_t *comm, int nnodes,
+                              int *index, int *edges, int *map);
+
+OMPI_DECLSPEC int
+mca_topo_base_dist_graph_map_procs(ompi_communicator_t *comm, int n,
+                                   int nodes[], int degrees[], int targets[],
+                                   int weights[], int *map);
+
 END_C_DECLS
 
 #endif /* MCA_BASE_TOPO_H */
@@ -36,7 +36,8 @@
  * @param reorder ranking may be reordered (true) or not (false) (logical)
  * @param comm_cart communicator with new cartesian topology (handle)
  *
- * Open MPI currently ignores the 'reorder' flag.
+ * With 'reorder' the grid is mapped to the processes so that neighbors
+ * share a node or a socket (see mca_topo_base_cart_map_procs).
  *
  * @retval OMPI_SUCCESS
  */                       
@@ -49,7 +50,7 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
                               bool reorder,
                               ompi_communicator_t** comm_topo)
 {
-    int nprocs = 1, i, *p, new_rank, num_procs, ret;
+    int nprocs = 1, i, *p, new_rank, num_procs, ret, *map = NULL;
     ompi_communicator_t *new_comm;
     ompi_proc_t **topo_procs = NULL;
     mca_topo_base_comm_cart_2_1_0_t* cart;
@@ -77,15 +78,47 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
         num_procs = nprocs;
     }
    
+    if (reorder && mca_topo_base_reorder) {
+        /* all the processes take part, even the ones left out of the grid */
+        map = (int*)malloc(nprocs * sizeof(int));
+        ret = mca_topo_base_cart_map_procs(old_comm, ndims, dims, periods, map);
+        if (OMPI_SUCCESS != ret) {
+            if (NULL != map) free(map);
+            return ret;
+        }
+        for (i = 0; (i < nprocs) && (map[i] != new_rank); ++i);
+        new_rank = i;  /* nprocs if the process is not in the grid */
+    }
+
     if (new_rank > (nprocs-1)) {
         ndims = 0;
         new_rank = MPI_UNDEFINED;
         num_procs = 0;
     }
 
+    /* Copy the proc structure from the previous communicator over to
+       the new one, in the order of the new ranks.  The topology module
+       is then able to work on this copy and rearrange it as it deems
+       fit. */
+    topo_procs = (ompi_proc_t**)malloc(num_procs * sizeof(ompi_proc_t *));
+    if (NULL != map) {
+        for(i = 0 ; i < num_procs; i++) {
+            topo_procs[i] = ompi_group_peer_lookup(old_comm->c_local_group, map[i]);
+        }
+        free(map);
+    } else if(OMPI_GROUP_IS_DENSE(old_comm->c_local_group)) {
+        memcpy(topo_procs, 
+               old_comm->c_local_group->grp_proc_pointers,
+               num_procs * sizeof(ompi_proc_t *));
+    } else {
+        for(i = 0 ; i < num_procs; i++) {
+            topo_procs[i] = ompi_group_peer_lookup(old_comm->c_local_group,i);
+        }
+    }
+
     cart = (mca_topo_base_comm_cart_2_1_0_t*)calloc(1, sizeof(mca_topo_base_comm_cart_2_1_0_t));
     if( NULL == cart ) {
-        ompi_comm_free(&new_comm);
+        free(topo_procs);
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
     cart->ndims = ndims;
@@ -95,6 +128,7 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
     if( ndims > 0 ) {
         cart->dims = (int*)malloc(sizeof(int) * ndims);
         if (NULL == cart->dims) {
+            free(topo_procs);
             free(cart);
             return OMPI_ERROR;
         }
@@ -103,6 +137,7 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
         /* Cartesian communicator; copy the right data to the common information */
         cart->periods = (int*)malloc(sizeof(int) * ndims);
         if (NULL == cart->periods) {
+            free(topo_procs);
             if(NULL != cart->dims) free(cart->dims);
             free(cart);
             return OMPI_ERR_OUT_OF_RESOURCE;
@@ -111,6 +146,7 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
         
         cart->coords = (int*)malloc(sizeof(int) * ndims);
         if (NULL == cart->coords) {
+            free(topo_procs);
             free(cart->periods);
             if(NULL != cart->dims) free(cart->dims);
             free(cart);
@@ -127,20 +163,6 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
         }
     }
 
-    /* Copy the proc structure from the previous communicator over to
-       the new one.  The topology module is then able to work on this
-       copy and rearrange it as it deems fit. */
-    topo_procs = (ompi_proc_t**)malloc(num_procs * sizeof(ompi_proc_t *));
-    if(OMPI_GROUP_IS_DENSE(old_comm->c_local_group)) {
-        memcpy(topo_procs, 
-               old_comm->c_local_group->grp_proc_pointers,
-               num_procs * sizeof(ompi_proc_t *));
-    } else {
-        for(i = 0 ; i < num_procs; i++) {
-            topo_procs[i] = ompi_group_peer_lookup(old_comm->c_local_group,i);
-        }
-    }
-
     /* allocate a new communicator */
     new_comm = ompi_comm_allocate(num_procs, 0);
     if (NULL == new_comm) {
@@ -13,6 +13,7 @@
 #include "ompi_config.h"
 
 #include "ompi/communicator/communicator.h"
+#include "ompi/group/group.h"
 #include "ompi/info/info.h"
 #include "ompi/mca/topo/base/base.h"
 #include "ompi/datatype/ompi_datatype.h"
@@ -298,11 +299,32 @@ int mca_topo_base_dist_graph_create(mca_topo_base_module_t* module,
                                     ompi_info_t *info, int reorder, 
                                     ompi_communicator_t **newcomm)
 {
-    int err;
+    int err, *map;
+    ompi_group_t *group = comm_old->c_local_group;
 
-    if( OMPI_SUCCESS != (err = ompi_comm_create(comm_old,
-                                                comm_old->c_local_group,
-                                                newcomm)) ) {
+    if( reorder && mca_topo_base_reorder ) {
+        /* the nodes of the graph are the ranks in the new communicator,
+           given to the processes so that neighbors share a node or a
+           socket */
+        map = (int*)malloc(ompi_comm_size(comm_old) * sizeof(int));
+        err = mca_topo_base_dist_graph_map_procs(comm_old, n, nodes, degrees,
+                                                 targets, weights, map);
+        if( OMPI_SUCCESS == err ) {
+            err = ompi_group_incl(comm_old->c_local_group, ompi_comm_size(comm_old),
+                                  map, &group);
+        }
+        if( NULL != map ) free(map);
+        if( OMPI_SUCCESS != err ) {
+            OBJ_RELEASE(module);
+            return err;
+        }
+    }
+
+    err = ompi_comm_create(comm_old, group, newcomm);
+    if( group != comm_old->c_local_group ) {
+        OBJ_RELEASE(group);
+    }
+    if( OMPI_SUCCESS != err ) {
         OBJ_RELEASE(module);
         return err;
     }
@@ -40,6 +40,19 @@
 OBJ_CLASS_INSTANCE(mca_topo_base_module_t, opal_object_t,
                    NULL, NULL);
 
+static int mca_topo_base_register(mca_base_register_flag_t flags)
+{
+    mca_topo_base_reorder = true;
+    (void) mca_base_var_register("ompi", "topo", "base", "reorder",
+                                 "Map the topologies created with reorder to the processes so that "
+                                 "neighbors share a node or a socket (the ranks are never reordered if false)",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &mca_topo_base_reorder);
+    return OMPI_SUCCESS;
+}
+
 static int mca_topo_base_close(void) 
 {
     return mca_base_framework_components_close(&ompi_topo_base_framework, NULL);
@@ -54,7 +67,7 @@ static int mca_topo_base_open(mca_base_open_flag_t flags)
     return mca_base_framework_components_open(&ompi_topo_base_framework, flags);
 }
 
-MCA_BASE_FRAMEWORK_DECLARE(ompi, topo, "OMPI Topo", NULL,
+MCA_BASE_FRAMEWORK_DECLARE(ompi, topo, "OMPI Topo", mca_topo_base_register,
                            mca_topo_base_open, mca_topo_base_close,
                            mca_topo_base_static_components, 0);
 
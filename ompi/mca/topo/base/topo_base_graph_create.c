@@ -32,6 +32,10 @@
  * @param reorder ranking may be reordered (true) or not (false) (logical)
  * @param comm_graph communicator with graph topology added (handle)
  *
+ * With 'reorder' the nodes of the graph are mapped to the processes so
+ * that neighbors share a node or a socket (see
+ * mca_topo_base_graph_map_procs).
+ *
  * @retval MPI_SUCCESS
  * @retval MPI_ERR_OUT_OF_RESOURCE
  */
@@ -45,7 +49,7 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
                                ompi_communicator_t** comm_topo)
 {
     ompi_communicator_t *new_comm;
-    int new_rank, num_procs, ret, i;
+    int new_rank, num_procs, ret, i, *map = NULL;
     ompi_proc_t **topo_procs = NULL;
     mca_topo_base_comm_graph_2_1_0_t* graph;
 
@@ -59,6 +63,17 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
     if( num_procs > nnodes ) {
         num_procs = nnodes;
     }
+    if( reorder && mca_topo_base_reorder ) {
+        /* all the processes take part, even the ones left out of the graph */
+        map = (int*)malloc(nnodes * sizeof(int));
+        ret = mca_topo_base_graph_map_procs(old_comm, nnodes, index, edges, map);
+        if( OMPI_SUCCESS != ret ) {
+            if( NULL != map ) free(map);
+            return ret;
+        }
+        for( i = 0; (i < nnodes) && (map[i] != new_rank); ++i );
+        new_rank = i;  /* nnodes if the process is not in the graph */
+    }
     if( new_rank > (nnodes - 1) ) {
         new_rank = MPI_UNDEFINED;
         num_procs = 0;
@@ -67,6 +82,7 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
 
     graph = (mca_topo_base_comm_graph_2_1_0_t*)malloc(sizeof(mca_topo_base_comm_graph_2_1_0_t));
     if( NULL == graph ) {
+        if( NULL != map ) free(map);
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
     graph->nnodes = nnodes;
@@ -75,6 +91,7 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
 
     graph->index = (int*)malloc(sizeof(int) * nnodes);
     if (NULL == graph->index) {
+        if( NULL != map ) free(map);
         free(graph);
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
@@ -83,6 +100,7 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
     /* Graph communicator; copy the right data to the common information */
     graph->edges = (int*)malloc(sizeof(int) * index[nnodes-1]);
     if (NULL == graph->edges) {
+        if( NULL != map ) free(map);
         free(graph->index);
         free(graph);
         return OMPI_ERR_OUT_OF_RESOURCE;
@@ -90,7 +108,13 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
     memcpy(graph->edges, edges, index[nnodes-1] * sizeof(int));
 
     topo_procs = (ompi_proc_t**)malloc(num_procs * sizeof(ompi_proc_t *));
-    if(OMPI_GROUP_IS_DENSE(old_comm->c_local_group)) {
+    if( NULL != map ) {
+        /* in the order of the new ranks */
+        for(i = 0 ; i < num_procs; i++) {
+            topo_procs[i] = ompi_group_peer_lookup(old_comm->c_local_group, map[i]);
+        }
+        free(map);
+    } else if(OMPI_GROUP_IS_DENSE(old_comm->c_local_group)) {
         memcpy(topo_procs, 
                old_comm->c_local_group->grp_proc_pointers,
                num_procs * sizeof(ompi_proc_t *));
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/topo/base/base.h"
+
+/*
+ * The neighborhoods used by the neighborhood collectives. For a
+ * cartesian topology these are, for each dimension, the source and the
+ * destination of a shift by 1 (in this order). For a graph topology the
+ * neighbors of the process are both the sources and the destinations,
+ * and for a distributed graph the sources and destinations given at
+ * creation.
+ */
+
+int mca_topo_base_neighbor_count(ompi_communicator_t *comm,
+                                 int *indegree, int *outdegree)
+{
+    if (OMPI_COMM_IS_CART(comm)) {
+        *indegree = *outdegree = 2 * comm->c_topo->mtc.cart->ndims;
+    } else if (OMPI_COMM_IS_GRAPH(comm)) {
+        int nneighbors;
+
+        mca_topo_base_graph_neighbors_count(comm, ompi_comm_rank(comm), &nneighbors);
+        *indegree = *outdegree = nneighbors;
+    } else if (OMPI_COMM_IS_DIST_GRAPH(comm)) {
+        *indegree = comm->c_topo->mtc.dist_graph->indegree;
+        *outdegree = comm->c_topo->mtc.dist_graph->outdegree;
+    } else {
+        return OMPI_ERR_NOT_FOUND;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+int mca_topo_base_neighbors(ompi_communicator_t *comm,
+                            int sources[], int destinations[])
+{
+    int i, indegree, outdegree, rc;
+
+    rc = mca_topo_base_neighbor_count(comm, &indegree, &outdegree);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    if (OMPI_COMM_IS_CART(comm)) {
+        for (i = 0 ; i < comm->c_topo->mtc.cart->ndims ; ++i) {
+            mca_topo_base_cart_shift(comm, i, 1, &sources[2 * i], &sources[2 * i + 1]);
+            destinations[2 * i] = sources[2 * i];
+            destinations[2 * i + 1] = sources[2 * i + 1];
+        }
+    } else if (OMPI_COMM_IS_GRAPH(comm)) {
+        mca_topo_base_graph_neighbors(comm, ompi_comm_rank(comm), indegree, sources);
+        for (i = 0 ; i < outdegree ; ++i) {
+            destinations[i] = sources[i];
+        }
+    } else {
+        mca_topo_base_comm_dist_graph_2_1_0_t *dist_graph = comm->c_topo->mtc.dist_graph;
+
+        for (i = 0 ; i < indegree ; ++i) {
+            sources[i] = dist_graph->in[i];
+        }
+        for (i = 0 ; i < outdegree ; ++i) {
+            destinations[i] = dist_graph->out[i];
+        }
+    }
+
+    return OMPI_SUCCESS;
+}
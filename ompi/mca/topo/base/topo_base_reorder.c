@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/mca/hwloc/hwloc.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/proc/proc.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/topo/base/base.h"
+
+/*
+ * Mapping of the vertices of a topology to the processes when the
+ * application allows the ranks to be reordered. The vertices are given
+ * to the nodes one node after the other: the region of a node grows from
+ * its first vertex by adding the vertex with the heaviest edges to the
+ * region, until the node is full. The vertices of a node are then given
+ * to its processes socket by socket, in the order they were added.
+ *
+ * Every process computes the same mapping from the topology (the same on
+ * all processes) and the location of all processes, first exchanged with
+ * an allgather. A node (or a socket) is named by the lowest rank running
+ * on it. The mapping is only kept if it has less weight between nodes
+ * (then between sockets) than the identity.
+ */
+
+bool mca_topo_base_reorder = true;
+
+typedef struct {
+    int node;
+    int socket;
+    int rank;
+} mca_topo_base_location_t;
+
+static int topo_base_location_compare(const void *a, const void *b)
+{
+    const mca_topo_base_location_t *la = (const mca_topo_base_location_t*)a;
+    const mca_topo_base_location_t *lb = (const mca_topo_base_location_t*)b;
+
+    if (la->node != lb->node) return (la->node < lb->node) ? -1 : 1;
+    if (la->socket != lb->socket) return (la->socket < lb->socket) ? -1 : 1;
+    return (la->rank < lb->rank) ? -1 : ((la->rank > lb->rank) ? 1 : 0);
+}
+
+/* node and socket of the calling process, as the lowest ranks sharing them */
+static void topo_base_local_location(ompi_communicator_t *comm, int *node, int *socket)
+{
+    int i, size = ompi_comm_size(comm);
+    ompi_proc_t *proc;
+    opal_hwloc_locality_t locality;
+
+    *node = *socket = ompi_comm_rank(comm);
+    for (i = 0; i < size; ++i) {
+        proc = ompi_group_peer_lookup(comm->c_local_group, i);
+        locality = (proc == ompi_proc_local()) ? OPAL_PROC_ALL_LOCAL : proc->proc_flags;
+        if (OPAL_PROC_ON_LOCAL_NODE(locality)) {
+            if (i < *node) *node = i;
+            if (OPAL_PROC_ON_LOCAL_SOCKET(locality) && (i < *socket)) *socket = i;
+        }
+    }
+}
+
+/* weight of the edges between nodes, and between sockets of a node */
+static void topo_base_map_cost(int n, int *offsets, int *edges, int *weights,
+                               mca_topo_base_location_t *where, int *map,
+                               int64_t *node_cost, int64_t *socket_cost)
+{
+    int v, e, w;
+
+    *node_cost = *socket_cost = 0;
+    for (v = 0; v < n; ++v) {
+        for (e = offsets[v]; e < offsets[v + 1]; ++e) {
+            w = (NULL == weights) ? 1 : weights[e];
+            if (where[map[v]].node != where[map[edges[e]]].node) {
+                *node_cost += w;
+            } else if (where[map[v]].socket != where[map[edges[e]]].socket) {
+                *socket_cost += w;
+            }
+        }
+    }
+}
+
+/**
+ * Map the n vertices of a graph (given as offsets and edges) to ranks
+ * 0..n-1 of comm: on return map[v] is the rank handling the vertex v.
+ * Collective over comm; a process passing ok false or no map (or failing
+ * to allocate its buffers) makes all the processes use the identity.
+ */
+static int topo_base_map_procs(ompi_communicator_t *comm, int n,
+                               int *offsets, int *edges, int *weights,
+                               int *map, bool ok)
+{
+    int i, v, e, f, best, cursor, pos, node, size = ompi_comm_size(comm);
+    int mine[3], *all = NULL, *gain = NULL, *frontier = NULL, *slots = NULL;
+    char *state = NULL;  /* 1 in the frontier, 2 mapped */
+    mca_topo_base_location_t *where = NULL, *sorted = NULL;
+    int64_t cost[2], new_cost[2];
+
+    all = (int*)malloc(3 * size * sizeof(int));
+    if (NULL == all) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    if (NULL != map) {
+        for (v = 0; v < n; ++v) {
+            map[v] = v;
+        }
+    }
+    where = (mca_topo_base_location_t*)malloc(size * sizeof(mca_topo_base_location_t));
+    sorted = (mca_topo_base_location_t*)malloc(n * sizeof(mca_topo_base_location_t));
+    gain = (int*)malloc(n * sizeof(int));
+    frontier = (int*)malloc(n * sizeof(int));
+    slots = (int*)malloc(n * sizeof(int));
+    state = (char*)calloc(n, sizeof(char));
+    ok = ok && (NULL != map) && (NULL != where) && (NULL != sorted) && (NULL != gain) &&
+        (NULL != frontier) && (NULL != slots) && (NULL != state);
+
+    topo_base_local_location(comm, &mine[0], &mine[1]);
+    mine[2] = ok ? 1 : 0;
+    comm->c_coll.coll_allgather(mine, 3, MPI_INT, all, 3, MPI_INT, comm,
+                                comm->c_coll.coll_allgather_module);
+    if (!ok) goto done;
+    for (i = 0; i < size; ++i) {
+        if (0 == all[3 * i + 2]) goto done;
+        where[i].node = all[3 * i];
+        where[i].socket = all[3 * i + 1];
+        where[i].rank = i;
+    }
+    /* only the first n processes get a vertex, as without reordering */
+    memcpy(sorted, where, n * sizeof(mca_topo_base_location_t));
+    qsort(sorted, n, sizeof(mca_topo_base_location_t), topo_base_location_compare);
+    if ((sorted[0].node == sorted[n - 1].node) && (sorted[0].socket == sorted[n - 1].socket)) {
+        goto done;  /* nothing to win */
+    }
+
+    /* grow the region of each node */
+    for (pos = cursor = 0; pos < n; ) {
+        node = sorted[pos].node;
+        f = 0;
+        for (; (pos < n) && (sorted[pos].node == node); ++pos) {
+            best = -1;
+            for (i = 0; i < f; ++i) {
+                if ((-1 == best) || (gain[frontier[i]] > gain[frontier[best]]) ||
+                    ((gain[frontier[i]] == gain[frontier[best]]) && (frontier[i] < frontier[best]))) {
+                    best = i;
+                }
+            }
+            if (-1 != best) {
+                v = frontier[best];
+                frontier[best] = frontier[--f];
+            } else {
+                while (0 != state[cursor]) ++cursor;
+                v = cursor;
+            }
+            state[v] = 2;
+            slots[pos] = v;
+            for (e = offsets[v]; e < offsets[v + 1]; ++e) {
+                if (2 == state[edges[e]]) continue;
+                if (0 == state[edges[e]]) {
+                    state[edges[e]] = 1;
+                    gain[edges[e]] = 0;
+                    frontier[f++] = edges[e];
+                }
+                gain[edges[e]] += (NULL == weights) ? 1 : weights[e];
+            }
+        }
+        /* the gains are relative to the region of this node */
+        for (i = 0; i < f; ++i) {
+            state[frontier[i]] = 0;
+        }
+    }
+
+    topo_base_map_cost(n, offsets, edges, weights, where, map, &cost[0], &cost[1]);
+    for (pos = 0; pos < n; ++pos) {
+        gain[slots[pos]] = sorted[pos].rank;  /* gain is free, keep the new map there */
+    }
+    topo_base_map_cost(n, offsets, edges, weights, where, gain, &new_cost[0], &new_cost[1]);
+    if ((new_cost[0] < cost[0]) || ((new_cost[0] == cost[0]) && (new_cost[1] < cost[1]))) {
+        memcpy(map, gain, n * sizeof(int));
+    }
+
+ done:
+    free(all);
+    if (NULL != where) free(where);
+    if (NULL != sorted) free(sorted);
+    if (NULL != gain) free(gain);
+    if (NULL != frontier) free(frontier);
+    if (NULL != slots) free(slots);
+    if (NULL != state) free(state);
+    return ok ? OMPI_SUCCESS : OMPI_ERR_OUT_OF_RESOURCE;
+}
+
+int mca_topo_base_cart_map_procs(ompi_communicator_t *comm, int ndims,
+                                 int *dims, int *periods, int *map)
+{
+    int i, d, v, c, nnodes = 1, stride, rc;
+    int *offsets, *edges;
+
+    for (d = 0; d < ndims; ++d) {
+        nnodes *= dims[d];
+    }
+    offsets = (int*)malloc((nnodes + 1) * sizeof(int));
+    edges = (int*)malloc((0 == ndims ? 1 : 2 * ndims * nnodes) * sizeof(int));
+    if ((NULL == offsets) || (NULL == edges)) {
+        free(offsets);
+        free(edges);
+        return topo_base_map_procs(comm, nnodes, NULL, NULL, NULL,
+                                   map, false);
+    }
+
+    /* the shifts by 1 in each dimension, in row major order */
+    for (v = i = 0; v < nnodes; ++v) {
+        offsets[v] = i;
+        for (stride = nnodes, d = 0; d < ndims; ++d) {
+            stride /= dims[d];
+            c = (v / stride) % dims[d];
+            if (1 == dims[d]) continue;
+            if ((c > 0) || periods[d]) {
+                edges[i++] = v + (((c > 0) ? c - 1 : dims[d] - 1) - c) * stride;
+            }
+            if ((c < dims[d] - 1) || periods[d]) {
+                edges[i++] = v + (((c < dims[d] - 1) ? c + 1 : 0) - c) * stride;
+            }
+        }
+    }
+    offsets[nnodes] = i;
+
+    rc = topo_base_map_procs(comm, nnodes, offsets, edges, NULL, map, true);
+    free(offsets);
+    free(edges);
+    return rc;
+}
+
+int mca_topo_base_graph_map_procs(ompi_communicator_t *comm, int nnodes,
+                                  int *index, int *edges, int *map)
+{
+    int v, rc, *offsets;
+
+    offsets = (int*)malloc((nnodes + 1) * sizeof(int));
+    if (NULL == offsets) {
+        return topo_base_map_procs(comm, nnodes, NULL, NULL, NULL,
+                                   map, false);
+    }
+    offsets[0] = 0;
+    for (v = 0; v < nnodes; ++v) {
+        offsets[v + 1] = index[v];
+    }
+    rc = topo_base_map_procs(comm, nnodes, offsets, edges, NULL, map, true);
+    free(offsets);
+    return rc;
+}
+
+int mca_topo_base_dist_graph_map_procs(ompi_communicator_t *comm, int n,
+                                       int nodes[], int degrees[], int targets[],
+                                       int weights[], int *map)
+{
+    int i, j, e, rc, count, total, size = ompi_comm_size(comm);
+    int mine[2], *counts, *displs, *local = NULL, *global = NULL;
+    int *offsets = NULL, *edges = NULL, *edge_weights = NULL;
+    bool ok;
+
+    if (NULL != map) {
+        for (i = 0; i < size; ++i) {
+            map[i] = i;
+        }
+    }
+
+    /* everybody learns every edge, as (source, target, weight) */
+    for (count = i = 0; i < n; ++i) {
+        count += degrees[i];
+    }
+    /* counts and displacements, then the exchanged (count, ok) pairs */
+    counts = (int*)malloc(4 * size * sizeof(int));
+    if (NULL == counts) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    displs = counts + size;
+    local = (int*)malloc((3 * count + 1) * sizeof(int));
+    ok = (NULL != map) && (NULL != local);
+    if (ok) {
+        for (e = i = 0; i < n; ++i) {
+            for (j = 0; j < degrees[i]; ++j, ++e) {
+                local[3 * e] = nodes[i];
+                local[3 * e + 1] = targets[e];
+                local[3 * e + 2] = (MPI_UNWEIGHTED == (void*)weights) ? 1 : weights[e];
+            }
+        }
+    }
+    mine[0] = 3 * count;
+    mine[1] = ok ? 1 : 0;
+    rc = comm->c_coll.coll_allgather(mine, 2, MPI_INT, counts + 2 * size, 2, MPI_INT, comm,
+                                     comm->c_coll.coll_allgather_module);
+    if (!ok || (OMPI_SUCCESS != rc)) goto bail_out;
+    for (total = i = 0; i < size; ++i) {
+        if (0 == counts[2 * size + 2 * i + 1]) goto bail_out;
+        counts[i] = counts[2 * size + 2 * i];
+        displs[i] = total;
+        total += counts[i];
+    }
+    global = (int*)malloc((total + 1) * sizeof(int));
+    if (NULL == global) {
+        rc = OMPI_ERR_OUT_OF_RESOURCE;
+        goto bail_out;
+    }
+    rc = comm->c_coll.coll_allgatherv(local, 3 * count, MPI_INT, global, counts, displs, MPI_INT,
+                                      comm, comm->c_coll.coll_allgatherv_module);
+    if (OMPI_SUCCESS != rc) goto bail_out;
+    total /= 3;
+
+    /* the communications go both ways: keep each edge at both ends */
+    offsets = (int*)calloc(size + 1, sizeof(int));
+    edges = (int*)malloc((2 * total + 1) * sizeof(int));
+    edge_weights = (int*)malloc((2 * total + 1) * sizeof(int));
+    ok = (NULL != offsets) && (NULL != edges) && (NULL != edge_weights);
+    if (ok) {
+        for (e = 0; e < total; ++e) {
+            offsets[global[3 * e] + 1]++;
+            offsets[global[3 * e + 1] + 1]++;
+        }
+        for (i = 0; i < size; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+        for (e = 0; e < total; ++e) {
+            /* offsets[v] is the next free position of v until the shift below */
+            i = offsets[global[3 * e]]++;
+            edges[i] = global[3 * e + 1];
+            edge_weights[i] = global[3 * e + 2];
+            i = offsets[global[3 * e + 1]]++;
+            edges[i] = global[3 * e];
+            edge_weights[i] = global[3 * e + 2];
+        }
+        for (i = size; i > 0; --i) {
+            offsets[i] = offsets[i - 1];
+        }
+        offsets[0] = 0;
+    }
+    rc = topo_base_map_procs(comm, size, offsets, edges, edge_weights, map, ok);
+
+ bail_out:
+    free(counts);
+    if (NULL != local) free(local);
+    if (NULL != global) free(global);
+    if (NULL != offsets) free(offsets);
+    if (NULL != edges) free(edges);
+    if (NULL != edge_weights) free(edge_weights);
+    if ((OMPI_SUCCESS == rc) && !ok) {
+        rc = OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    return rc;
+}
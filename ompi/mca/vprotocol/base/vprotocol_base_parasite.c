@@ -43,6 +43,8 @@ int mca_vprotocol_base_parasite(void) {
         mca_pml.pml_start = mca_vprotocol.start;
     if(mca_vprotocol.dump) 
         mca_pml.pml_dump = mca_vprotocol.dump;
+    if(mca_vprotocol.ft_event)
+        mca_pml.pml_ft_event = mca_vprotocol.ft_event;
     if(mca_vprotocol.wait)
         ompi_request_functions.req_wait = mca_vprotocol.wait;
     if(mca_vprotocol.wait_all)
@@ -32,6 +32,7 @@ mca_vprotocol_example_module_t mca_vprotocol_example =
     /* mca_pml_base_module_start_fn_t         */ mca_vprotocol_example_start, 
 
     /* mca_pml_base_module_dump_fn_t          */ mca_vprotocol_example_dump,
+    /* mca_pml_base_module_ft_event_fn_t      */ NULL,
     
     /* opal_class_t *                         */ NULL,
   },
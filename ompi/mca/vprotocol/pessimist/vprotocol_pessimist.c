@@ -8,6 +8,7 @@
  * $HEADER$
  */
 #include "ompi_config.h"
+#include "opal/mca/crs/crs.h"
 #include "vprotocol_pessimist.h"
 
 mca_vprotocol_pessimist_module_t mca_vprotocol_pessimist = 
@@ -33,6 +34,7 @@ mca_vprotocol_pessimist_module_t mca_vprotocol_pessimist =
     /* mca_pml_base_module_probe_fn_t         */ mca_vprotocol_pessimist_probe,
     /* mca_pml_base_module_start_fn_t         */ mca_vprotocol_pessimist_start, 
     /* mca_pml_base_module_dump_fn_t          */ mca_vprotocol_pessimist_dump,
+    /* mca_pml_base_module_ft_event_fn_t      */ mca_vprotocol_pessimist_ft_event,
 
     /* ompi_request_test_fn_t                 */ mca_vprotocol_pessimist_test,
     /* ompi_request_testany_fn_t              */ mca_vprotocol_pessimist_test_any,
@@ -53,3 +55,13 @@ int mca_vprotocol_pessimist_dump(struct ompi_communicator_t* comm, int verbose)
   V_OUTPUT_VERBOSE(verbose, "vprotocol_pessimist: dump for comm %d", comm->c_contextid);
   return mca_pml_v.host_pml.pml_dump(comm, verbose);
 }
+
+int mca_vprotocol_pessimist_ft_event(int state)
+{
+  int ret = mca_pml_v.host_pml.pml_ft_event(state);
+
+  /* the coordinated checkpoint holds what the logged messages could replay */
+  if(OMPI_SUCCESS == ret && OPAL_CRS_CONTINUE == state)
+    vprotocol_pessimist_sender_based_gc();
+  return ret;
+}
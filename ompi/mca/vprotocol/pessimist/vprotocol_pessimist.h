@@ -52,6 +52,7 @@ OMPI_DECLSPEC extern mca_vprotocol_base_component_t mca_vprotocol_pessimist_comp
 
 int mca_vprotocol_pessimist_enable(bool enable);
 int mca_vprotocol_pessimist_dump(struct ompi_communicator_t* comm, int verbose);
+int mca_vprotocol_pessimist_ft_event(int state);
 
 int mca_vprotocol_pessimist_add_procs(struct ompi_proc_t **procs, size_t nprocs);
 int mca_vprotocol_pessimist_del_procs(struct ompi_proc_t **procs, size_t nprocs);
@@ -27,6 +27,10 @@ static int _free_list_inc;
 static int _sender_based_size;
 static int _event_buffer_size;
 static char *_mmap_file_name;
+#if OPAL_HAVE_POSIX_THREADS
+static bool _sender_based_async;
+static size_t _sender_based_async_min;
+#endif
 
 mca_vprotocol_base_component_2_0_0_t mca_vprotocol_pessimist_component = 
 {
@@ -92,6 +96,20 @@ static int mca_vprotocol_pessimist_component_register(void)
                                            "sender_based_file", NULL, MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
                                            OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_READONLY, &_mmap_file_name);
+#if OPAL_HAVE_POSIX_THREADS
+    _sender_based_async = false;
+    (void) mca_base_component_var_register(&mca_vprotocol_pessimist_component.pmlm_version,
+                                           "sender_based_async", "Copy the large contiguous messages to the sender-based log from a helper thread rather than on the send path",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &_sender_based_async);
+    _sender_based_async_min = 64 * 1024;
+    (void) mca_base_component_var_register(&mca_vprotocol_pessimist_component.pmlm_version,
+                                           "sender_based_async_min", "Smallest message, in bytes, copied by the helper thread of sender_based_async",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &_sender_based_async_min);
+#endif
     return OMPI_SUCCESS;
 }
 
@@ -160,6 +178,10 @@ static int mca_vprotocol_pessimist_component_finalize(void)
 int mca_vprotocol_pessimist_enable(bool enable) {
     if(enable) {
         int ret;
+#if OPAL_HAVE_POSIX_THREADS
+        mca_vprotocol_pessimist.sender_based.sb_async = _sender_based_async;
+        mca_vprotocol_pessimist.sender_based.sb_async_min = _sender_based_async_min;
+#endif
         if((ret = vprotocol_pessimist_sender_based_init(_mmap_file_name, 
                                                  _sender_based_size)) != OMPI_SUCCESS)
             return ret;
@@ -56,9 +56,11 @@ static void sb_mmap_alloc(void)
         close(sb.sb_fd);
         ompi_mpi_abort(MPI_COMM_NULL, MPI_ERR_NO_SPACE, false);
     }
+    /* shared, so that the kernel writes the log back to the file in the 
+     * background and the memory it takes stays bounded */
     sb.sb_addr = (uintptr_t) mmap((void *) sb.sb_addr, sb.sb_length, 
                                   PROT_WRITE | PROT_READ, 
-                                  MAP_PRIVATE | MAP_NOCACHE, sb.sb_fd, 
+                                  MAP_SHARED | MAP_NOCACHE, sb.sb_fd, 
                                   sb.sb_offset);
     if(((uintptr_t) -1) == sb.sb_addr)
     {
@@ -77,6 +79,14 @@ static void sb_mmap_free(void)
                      (void *) sb.sb_addr, strerror(errno));
 }
 
+#if OPAL_HAVE_POSIX_THREADS
+static void sb_copy_thread_start(void);
+static void sb_copy_thread_stop(void);
+static void sb_copy_drain(void);
+#else
+#define sb_copy_drain()
+#endif
+
 int vprotocol_pessimist_sender_based_init(const char *mmapfile, size_t size) 
 {
     char *path;
@@ -95,17 +105,27 @@ int vprotocol_pessimist_sender_based_init(const char *mmapfile, size_t size)
 #ifdef SB_USE_PROGRESS_METHOD
     OBJ_CONSTRUCT(&sb.sb_sendreq, opal_list_t);
 #endif
+#if OPAL_HAVE_POSIX_THREADS
+    sb.sb_thread_running = false;
+#endif
     
     asprintf(&path, "%s"OPAL_PATH_SEP"%s", ompi_process_info.proc_session_dir, 
                 mmapfile);
     if(OPAL_SUCCESS != sb_mmap_file_open(path))
         return OPAL_ERR_FILE_OPEN_FAILURE; 
     free(path);
+#if OPAL_HAVE_POSIX_THREADS
+    if(sb.sb_async)
+        sb_copy_thread_start();
+#endif
     return OMPI_SUCCESS;
 }
 
 void vprotocol_pessimist_sender_based_finalize(void)
 {
+#if OPAL_HAVE_POSIX_THREADS
+    sb_copy_thread_stop();
+#endif
     if(((uintptr_t) NULL) != sb.sb_addr)
         sb_mmap_free();
     sb_mmap_file_close();
@@ -117,6 +137,7 @@ void vprotocol_pessimist_sender_based_finalize(void)
   */
 void vprotocol_pessimist_sender_based_alloc(size_t len)
 {
+    sb_copy_drain();
     if(((uintptr_t) NULL) != sb.sb_addr)
         sb_mmap_free();
 #ifdef SB_USE_SELFCOMM_METHOD
@@ -142,8 +163,132 @@ void vprotocol_pessimist_sender_based_alloc(size_t len)
     V_OUTPUT_VERBOSE(30, "pessimist:\tsb\tgrow\toffset %llu\tlength %llu\tbase %p\tcursor %p", (unsigned long long) sb.sb_offset, (unsigned long long) sb.sb_length, (void *) sb.sb_addr, (void *) sb.sb_cursor);
 }   
 
+/** Once every process checkpointed, no message logged before can be 
+  * asked for again: the window starts over at the beginning of the file,
+  * and the file is cut back to it.
+  */
+void vprotocol_pessimist_sender_based_gc(void)
+{
+    if(((uintptr_t) NULL) == sb.sb_addr)
+        return;
+    sb_copy_drain();
+    V_OUTPUT_VERBOSE(30, "pessimist:\tsb\tgc\treclaiming %llu bytes", (unsigned long long) (sb.sb_offset + (sb.sb_cursor - sb.sb_addr)));
+    sb_mmap_free();
+    if(-1 == ftruncate(sb.sb_fd, 0))
+        V_OUTPUT_ERR("pml_v: vprotocol_pessimist: sender_based_gc: ftruncate: %s", 
+                     strerror(errno));
+    sb.sb_offset = 0;
+    sb.sb_available = sb.sb_length;
+    sb_mmap_alloc();
+    sb.sb_cursor = sb.sb_addr;
+}
+
 #undef sb
 
+#if OPAL_HAVE_POSIX_THREADS
+static vprotocol_pessimist_sender_based_t * const sbp = &mca_vprotocol_pessimist.sender_based;
+
+static void *sb_copy_thread(opal_object_t *obj)
+{
+    mca_vprotocol_pessimist_request_t *ftreq;
+    mca_pml_base_send_request_t *pmlreq;
+
+    pthread_mutex_lock(&sbp->sb_lock);
+    while(1)
+    {
+        while(opal_list_is_empty(&sbp->sb_copies) && !sbp->sb_shutdown)
+            pthread_cond_wait(&sbp->sb_cond, &sbp->sb_lock);
+        if(opal_list_is_empty(&sbp->sb_copies))
+            break;
+        ftreq = (mca_vprotocol_pessimist_request_t *) 
+            opal_list_remove_first(&sbp->sb_copies);
+        pthread_mutex_unlock(&sbp->sb_lock);
+
+        pmlreq = (mca_pml_base_send_request_t *) VPROTOCOL_SEND_REQ(ftreq);
+        MEMCPY((void *) ftreq->sb.cursor, ftreq->sb.source, pmlreq->req_bytes_packed);
+
+        pthread_mutex_lock(&sbp->sb_lock);
+        ftreq->sb.pending = false;
+        sbp->sb_pending--;
+        pthread_cond_broadcast(&sbp->sb_cond);
+    }
+    pthread_mutex_unlock(&sbp->sb_lock);
+    return NULL;
+}
+
+static void sb_copy_thread_start(void)
+{
+    OBJ_CONSTRUCT(&sbp->sb_copies, opal_list_t);
+    pthread_mutex_init(&sbp->sb_lock, NULL);
+    pthread_cond_init(&sbp->sb_cond, NULL);
+    sbp->sb_pending = 0;
+    sbp->sb_shutdown = false;
+    OBJ_CONSTRUCT(&sbp->sb_thread, opal_thread_t);
+    sbp->sb_thread.t_run = sb_copy_thread;
+    sbp->sb_thread.t_arg = NULL;
+    sbp->sb_thread_running = (OPAL_SUCCESS == opal_thread_start(&sbp->sb_thread));
+    if(!sbp->sb_thread_running)
+    {
+        V_OUTPUT_VERBOSE(1, "pessimist:\tsb\tno copy thread, copying on the send path");
+        sbp->sb_async = false;
+        OBJ_DESTRUCT(&sbp->sb_thread);
+        pthread_cond_destroy(&sbp->sb_cond);
+        pthread_mutex_destroy(&sbp->sb_lock);
+        OBJ_DESTRUCT(&sbp->sb_copies);
+    }
+}
+
+static void sb_copy_thread_stop(void)
+{
+    if(!sbp->sb_thread_running)
+        return;
+    pthread_mutex_lock(&sbp->sb_lock);
+    sbp->sb_shutdown = true;
+    pthread_cond_broadcast(&sbp->sb_cond);
+    pthread_mutex_unlock(&sbp->sb_lock);
+    opal_thread_join(&sbp->sb_thread, NULL);
+    sbp->sb_thread_running = false;
+    OBJ_DESTRUCT(&sbp->sb_thread);
+    pthread_cond_destroy(&sbp->sb_cond);
+    pthread_mutex_destroy(&sbp->sb_lock);
+    OBJ_DESTRUCT(&sbp->sb_copies);
+}
+
+/* the copies must be done before the window they go to moves */
+static void sb_copy_drain(void)
+{
+    if(!sbp->sb_thread_running)
+        return;
+    pthread_mutex_lock(&sbp->sb_lock);
+    while(0 < sbp->sb_pending)
+        pthread_cond_wait(&sbp->sb_cond, &sbp->sb_lock);
+    pthread_mutex_unlock(&sbp->sb_lock);
+}
+
+void vprotocol_pessimist_sender_based_copy_async(mca_pml_base_send_request_t *pmlreq)
+{
+    mca_vprotocol_pessimist_request_t *ftreq = VPESSIMIST_SEND_FTREQ(pmlreq);
+    opal_convertor_t *conv = &pmlreq->req_base.req_convertor;
+
+    /* contiguous, from the start of the payload whatever the PML sent already */
+    ftreq->sb.source = conv->pBaseBuf + conv->pDesc->true_lb;
+    ftreq->sb.pending = true;
+    pthread_mutex_lock(&sbp->sb_lock);
+    sbp->sb_pending++;
+    opal_list_append(&sbp->sb_copies, &ftreq->list_item);
+    pthread_cond_signal(&sbp->sb_cond);
+    pthread_mutex_unlock(&sbp->sb_lock);
+}
+
+void vprotocol_pessimist_sender_based_wait(mca_vprotocol_pessimist_request_t *ftreq)
+{
+    pthread_mutex_lock(&sbp->sb_lock);
+    while(ftreq->sb.pending)
+        pthread_cond_wait(&sbp->sb_cond, &sbp->sb_lock);
+    pthread_mutex_unlock(&sbp->sb_lock);
+}
+#endif /* OPAL_HAVE_POSIX_THREADS */
+
 #ifdef SB_USE_CONVERTOR_METHOD
 int32_t vprotocol_pessimist_sender_based_convertor_advance(opal_convertor_t* pConvertor,
                                                             struct iovec* iov,
@@ -33,6 +33,21 @@ void vprotocol_pessimist_sender_based_finalize(void);
   */
 void vprotocol_pessimist_sender_based_alloc(size_t len);
 
+/** Give back the space of the messages logged so far. Called once a 
+  * coordinated checkpoint holds the state they could replay.
+  */
+void vprotocol_pessimist_sender_based_gc(void);
+
+#if OPAL_HAVE_POSIX_THREADS
+/** Hand the copy of a contiguous payload to the sender-based thread
+  */
+void vprotocol_pessimist_sender_based_copy_async(mca_pml_base_send_request_t *pmlreq);
+
+/** Wait for the sender-based thread to be done with a request
+  */
+void vprotocol_pessimist_sender_based_wait(mca_vprotocol_pessimist_request_t *ftreq);
+#endif
+
 
 /*******************************************************************************
  * Convertor pack (blocking) method (good latency, bad bandwidth)
@@ -50,13 +65,31 @@ static inline void __SENDER_BASED_METHOD_COPY(mca_pml_base_send_request_t *pmlre
 
         max_data = iov.iov_len = pmlreq->req_bytes_packed;
         iov.iov_base = (IOVBASE_TYPE *) VPESSIMIST_SEND_FTREQ(pmlreq)->sb.cursor;
+#if OPAL_HAVE_POSIX_THREADS
+        /* large contiguous payloads are copied off the critical path, the
+         * send buffer stays untouched until the request is freed */
+        if(mca_vprotocol_pessimist.sender_based.sb_async &&
+           pmlreq->req_bytes_packed >= mca_vprotocol_pessimist.sender_based.sb_async_min &&
+           !opal_convertor_need_buffers(&pmlreq->req_base.req_convertor))
+        {
+            vprotocol_pessimist_sender_based_copy_async(pmlreq);
+            return;
+        }
+#endif
         opal_convertor_clone_with_position( &pmlreq->req_base.req_convertor,
                                             &conv, 0, &zero );
         opal_convertor_pack(&conv, &iov, &iov_count, &max_data);
     }
 }
 
+#if OPAL_HAVE_POSIX_THREADS
+#define __SENDER_BASED_METHOD_FLUSH(REQ) do {                                 \
+    if(OPAL_UNLIKELY(VPESSIMIST_FTREQ(REQ)->sb.pending))                      \
+        vprotocol_pessimist_sender_based_wait(VPESSIMIST_FTREQ(REQ));         \
+} while(0)
+#else
 #define __SENDER_BASED_METHOD_FLUSH(REQ)
+#endif
 
 
 /*******************************************************************************
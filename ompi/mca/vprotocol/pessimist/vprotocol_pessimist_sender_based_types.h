@@ -13,6 +13,10 @@
 
 #include "ompi_config.h"
 #include "vprotocol_pessimist_event.h"
+#if OPAL_HAVE_POSIX_THREADS
+#include <pthread.h>
+#include "opal/threads/threads.h"
+#endif
 
 BEGIN_C_DECLS
 
@@ -39,6 +43,17 @@ typedef struct vprotocol_pessimist_sender_based_t
 #ifdef SB_USE_PROGRESS_METHOD
     opal_list_t sb_sendreq; /* requests that needs to be progressed */
 #endif
+#if OPAL_HAVE_POSIX_THREADS
+    bool sb_async;          /* contiguous payloads copied by sb_thread */
+    size_t sb_async_min;    /* smallest payload left to sb_thread */
+    bool sb_thread_running;
+    bool sb_shutdown;
+    opal_thread_t sb_thread;
+    pthread_mutex_t sb_lock;
+    pthread_cond_t sb_cond;
+    opal_list_t sb_copies;  /* requests waiting for sb_thread */
+    int sb_pending;         /* copies queued or in progress */
+#endif
 } vprotocol_pessimist_sender_based_t;
 
 typedef struct vprotocol_pessimist_sender_based_header_t
@@ -54,6 +69,8 @@ typedef struct vprotocol_pessimist_sender_based_request_t
 {
     uintptr_t cursor;
     size_t bytes_progressed;
+    const void *source;     /* contiguous payload, for sb_thread */
+    volatile bool pending;  /* sb_thread has not copied it yet */
     convertor_advance_fct_t conv_advance;
     uint32_t conv_flags;
 } vprotocol_pessimist_sender_based_request_t;
@@ -73,6 +73,7 @@ typedef struct mca_vprotocol_base_module_2_0_0_t
     mca_pml_base_module_probe_fn_t          probe;
     mca_pml_base_module_start_fn_t          start;
     mca_pml_base_module_dump_fn_t           dump;
+    mca_pml_base_module_ft_event_fn_t       ft_event;
     /* Request wait/test stuff */
     ompi_request_test_fn_t                  test;
     ompi_request_test_any_fn_t              test_any;
@@ -0,0 +1,57 @@
+/*
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#include "ompi_config.h"
+#include <stdio.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/errhandler/errhandler.h"
+#include "ompi/info/info.h"
+#include "ompi/memchecker.h"
+
+#if OPAL_HAVE_WEAK_SYMBOLS && OMPI_PROFILING_DEFINES
+#pragma weak MPI_Comm_dup_with_info = PMPI_Comm_dup_with_info
+#endif
+
+#if OMPI_PROFILING_DEFINES
+#include "ompi/mpi/c/profile/defines.h"
+#endif
+
+static const char FUNC_NAME[] = "MPI_Comm_dup_with_info";
+
+int MPI_Comm_dup_with_info(MPI_Comm comm, MPI_Info info, MPI_Comm *newcomm) 
+{
+    int rc=MPI_SUCCESS;
+
+    MEMCHECKER(
+        memchecker_comm(comm);
+    );
+
+    /* argument checking */
+    if ( MPI_PARAM_CHECK ) {
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
+
+        if (ompi_comm_invalid (comm))
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_COMM, 
+                                          FUNC_NAME);
+
+        if (NULL == info || ompi_info_is_freed(info))
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_INFO,
+                                          FUNC_NAME);
+
+        if ( NULL == newcomm )
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_ARG, 
+                                          FUNC_NAME);
+    }
+
+    OPAL_CR_ENTER_LIBRARY();
+
+    rc = ompi_comm_dup_with_info ( comm, info, newcomm );
+    OMPI_ERRHANDLER_RETURN ( rc, comm, rc, FUNC_NAME);
+}
@@ -61,7 +61,8 @@ int MPI_Comm_split_type(MPI_Comm comm, int split_type, int key,
                                           FUNC_NAME);
         }
 
-        if ( MPI_COMM_TYPE_SHARED != split_type &&  
+        if ( (MPI_COMM_TYPE_SHARED > split_type ||
+              OMPI_COMM_TYPE_CLUSTER < split_type) &&
              MPI_UNDEFINED != split_type ) {
             return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_ARG, 
                                           FUNC_NAME);
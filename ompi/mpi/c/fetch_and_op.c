@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#include "ompi_config.h"
+#include <stdio.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/errhandler/errhandler.h"
+#include "ompi/win/win.h"
+#include "ompi/mca/osc/osc.h"
+#include "ompi/op/op.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/memchecker.h"
+
+#if OPAL_HAVE_WEAK_SYMBOLS && OMPI_PROFILING_DEFINES
+#pragma weak MPI_Fetch_and_op = PMPI_Fetch_and_op
+#endif
+
+#if OMPI_PROFILING_DEFINES
+#include "ompi/mpi/c/profile/defines.h"
+#endif
+
+static const char FUNC_NAME[] = "MPI_Fetch_and_op";
+
+
+int MPI_Fetch_and_op(void *origin_addr, void *result_addr, MPI_Datatype datatype,
+                     int target_rank, MPI_Aint target_disp, MPI_Op op, MPI_Win win) 
+{
+    int rc;
+
+    MEMCHECKER(
+        memchecker_datatype(datatype);
+        memchecker_call(&opal_memchecker_base_isdefined, origin_addr, 1, datatype);
+    );
+
+    if (MPI_PARAM_CHECK) {
+        char *msg;
+
+        rc = OMPI_SUCCESS;
+
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
+
+        if (ompi_win_invalid(win)) {
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_WIN, FUNC_NAME);
+        } else if (ompi_win_peer_invalid(win, target_rank) &&
+                   (MPI_PROC_NULL != target_rank)) {
+            rc = MPI_ERR_RANK;
+        } else if (MPI_OP_NULL == op || !ompi_op_is_intrinsic(op)) {
+            rc = MPI_ERR_OP;
+        } else if (!ompi_win_comm_allowed(win)) {
+            rc = MPI_ERR_RMA_SYNC;
+        } else if ( target_disp < 0 ) {
+            rc = MPI_ERR_DISP;
+        } else if (NULL == datatype || MPI_DATATYPE_NULL == datatype ||
+                   !ompi_datatype_is_predefined(datatype)) {
+            /* only a single element of a predefined datatype */
+            rc = MPI_ERR_TYPE;
+        } else if (op != &ompi_mpi_op_replace.op &&
+                   !ompi_op_is_valid(op, datatype, &msg, FUNC_NAME)) {
+            int ret = OMPI_ERRHANDLER_INVOKE(win, MPI_ERR_OP, msg);
+            free(msg);
+            return ret;
+        }
+        OMPI_ERRHANDLER_CHECK(rc, win, rc, FUNC_NAME);
+    }
+
+    if (MPI_PROC_NULL == target_rank) {
+        return MPI_SUCCESS;
+    }
+
+    if (NULL == win->w_osc_module->osc_fetch_and_op) {
+        return OMPI_ERRHANDLER_INVOKE(win, MPI_ERR_UNSUPPORTED_OPERATION, FUNC_NAME);
+    }
+
+    OPAL_CR_ENTER_LIBRARY();
+
+    rc = win->w_osc_module->osc_fetch_and_op(origin_addr, result_addr, datatype,
+                                             target_rank, target_disp, op, win);
+    OMPI_ERRHANDLER_RETURN(rc, win, rc, FUNC_NAME);
+}
@@ -56,6 +56,12 @@ int MPI_Iprobe(int source, int tag, MPI_Comm comm, int *flag, MPI_Status *status
                    (MPI_PROC_NULL != source) &&
                    ompi_comm_peer_invalid(comm, source)) {
             rc = MPI_ERR_RANK;
+        } else if ((MPI_ANY_SOURCE == source) &&
+                   OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE(comm)) {
+            rc = MPI_ERR_RANK;
+        } else if ((MPI_ANY_TAG == tag) &&
+                   OMPI_COMM_CHECK_ASSERT_NO_ANY_TAG(comm)) {
+            rc = MPI_ERR_TAG;
         }
         OMPI_ERRHANDLER_CHECK(rc, comm, rc, FUNC_NAME);
     }
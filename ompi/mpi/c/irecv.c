@@ -60,6 +60,12 @@ int MPI_Irecv(void *buf, int count, MPI_Datatype type, int source,
                    (MPI_PROC_NULL != source) &&
                    ompi_comm_peer_invalid(comm, source)) {
             rc = MPI_ERR_RANK;
+        } else if ((MPI_ANY_SOURCE == source) &&
+                   OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE(comm)) {
+            rc = MPI_ERR_RANK;
+        } else if ((MPI_ANY_TAG == tag) &&
+                   OMPI_COMM_CHECK_ASSERT_NO_ANY_TAG(comm)) {
+            rc = MPI_ERR_TAG;
         } else if (NULL == request) {
             rc = MPI_ERR_REQUEST;
         }
@@ -49,6 +49,12 @@ int MPI_Mprobe(int source, int tag, MPI_Comm comm,
                    (MPI_PROC_NULL != source) &&
                    ompi_comm_peer_invalid(comm, source)) {
             rc = MPI_ERR_RANK;
+        } else if ((MPI_ANY_SOURCE == source) &&
+                   OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE(comm)) {
+            rc = MPI_ERR_RANK;
+        } else if ((MPI_ANY_TAG == tag) &&
+                   OMPI_COMM_CHECK_ASSERT_NO_ANY_TAG(comm)) {
+            rc = MPI_ERR_TAG;
         } else if (NULL == message) {
             rc = MPI_ERR_REQUEST;
         }
@@ -78,6 +78,7 @@
 #define MPI_Comm_delete_attr PMPI_Comm_delete_attr
 #define MPI_Comm_disconnect PMPI_Comm_disconnect
 #define MPI_Comm_dup PMPI_Comm_dup
+#define MPI_Comm_dup_with_info PMPI_Comm_dup_with_info
 #define MPI_Comm_f2c PMPI_Comm_f2c
 #define MPI_Comm_free_keyval PMPI_Comm_free_keyval
 #define MPI_Comm_free PMPI_Comm_free
@@ -103,6 +104,7 @@
 #define MPI_Comm_split PMPI_Comm_split
 #define MPI_Comm_split_type PMPI_Comm_split_type
 #define MPI_Comm_test_inter PMPI_Comm_test_inter
+#define MPI_Compare_and_swap PMPI_Compare_and_swap
 #define MPI_Dims_create PMPI_Dims_create
 #define MPI_Errhandler_c2f PMPI_Errhandler_c2f
 #define MPI_Errhandler_f2c PMPI_Errhandler_f2c
@@ -114,6 +116,7 @@
 #define MPI_Error_string PMPI_Error_string
 #define MPI_Exscan PMPI_Exscan
 #define MPI_Iexscan PMPI_Iexscan
+#define MPI_Fetch_and_op PMPI_Fetch_and_op
 #define MPI_File_c2f PMPI_File_c2f
 #define MPI_File_call_errhandler PMPI_File_call_errhandler
 #define MPI_File_close PMPI_File_close
@@ -242,6 +245,10 @@
 #define MPI_Mprobe PMPI_Mprobe
 #define MPI_Mrecv PMPI_Mrecv
 #define MPI_Message_cancel PMPI_Message_cancel
+#define MPI_Neighbor_allgather PMPI_Neighbor_allgather
+#define MPI_Ineighbor_allgather PMPI_Ineighbor_allgather
+#define MPI_Neighbor_alltoall PMPI_Neighbor_alltoall
+#define MPI_Ineighbor_alltoall PMPI_Ineighbor_alltoall
 #define MPI_Op_c2f PMPI_Op_c2f 
 #define MPI_Op_commutative PMPI_Op_commutative 
 #define MPI_Op_create PMPI_Op_create 
@@ -271,6 +278,8 @@
 #define MPI_Request_f2c PMPI_Request_f2c
 #define MPI_Request_free PMPI_Request_free
 #define MPI_Request_get_status PMPI_Request_get_status 
+#define MPI_Rget PMPI_Rget
+#define MPI_Rput PMPI_Rput
 #define MPI_Rsend_init PMPI_Rsend_init 
 #define MPI_Rsend PMPI_Rsend 
 #define MPI_Scan PMPI_Scan
@@ -346,15 +355,23 @@
 #define MPI_Waitall PMPI_Waitall
 #define MPI_Waitany PMPI_Waitany
 #define MPI_Waitsome PMPI_Waitsome
+#define MPI_Win_allocate_shared PMPI_Win_allocate_shared
+#define MPI_Win_attach PMPI_Win_attach
 #define MPI_Win_c2f PMPI_Win_c2f 
 #define MPI_Win_call_errhandler PMPI_Win_call_errhandler 
 #define MPI_Win_complete PMPI_Win_complete
 #define MPI_Win_create_errhandler PMPI_Win_create_errhandler 
 #define MPI_Win_create_keyval PMPI_Win_create_keyval
 #define MPI_Win_create PMPI_Win_create
+#define MPI_Win_create_dynamic PMPI_Win_create_dynamic
 #define MPI_Win_delete_attr PMPI_Win_delete_attr 
+#define MPI_Win_detach PMPI_Win_detach
 #define MPI_Win_f2c PMPI_Win_f2c
 #define MPI_Win_fence PMPI_Win_fence
+#define MPI_Win_flush PMPI_Win_flush
+#define MPI_Win_flush_all PMPI_Win_flush_all
+#define MPI_Win_flush_local PMPI_Win_flush_local
+#define MPI_Win_flush_local_all PMPI_Win_flush_local_all
 #define MPI_Win_free_keyval PMPI_Win_free_keyval 
 #define MPI_Win_free PMPI_Win_free 
 #define MPI_Win_get_attr PMPI_Win_get_attr 
@@ -362,13 +379,16 @@
 #define MPI_Win_get_group PMPI_Win_get_group
 #define MPI_Win_get_name PMPI_Win_get_name
 #define MPI_Win_lock PMPI_Win_lock
+#define MPI_Win_lock_all PMPI_Win_lock_all
 #define MPI_Win_post PMPI_Win_post 
 #define MPI_Win_set_attr PMPI_Win_set_attr
 #define MPI_Win_set_errhandler PMPI_Win_set_errhandler 
 #define MPI_Win_set_name PMPI_Win_set_name 
+#define MPI_Win_shared_query PMPI_Win_shared_query
 #define MPI_Win_start PMPI_Win_start
 #define MPI_Win_test PMPI_Win_test
 #define MPI_Win_unlock PMPI_Win_unlock
+#define MPI_Win_unlock_all PMPI_Win_unlock_all
 #define MPI_Win_wait PMPI_Win_wait
 #define MPI_Wtick PMPI_Wtick 
 #define MPI_Wtime PMPI_Wtime
@@ -68,6 +68,10 @@ int MPI_Sendrecv(void *sendbuf, int sendcount, MPI_Datatype sendtype,
             rc = MPI_ERR_RANK;
         } else if (((recvtag < 0) && (recvtag !=  MPI_ANY_TAG)) || (recvtag > mca_pml.pml_max_tag)) {
                 rc = MPI_ERR_TAG;
+        } else if (MPI_ANY_SOURCE == source && OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE(comm)) {
+            rc = MPI_ERR_RANK;
+        } else if (MPI_ANY_TAG == recvtag && OMPI_COMM_CHECK_ASSERT_NO_ANY_TAG(comm)) {
+            rc = MPI_ERR_TAG;
         }
         OMPI_ERRHANDLER_CHECK(rc, comm, rc, FUNC_NAME);
     }
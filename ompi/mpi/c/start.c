@@ -69,6 +69,19 @@ int MPI_Start(MPI_Request *request)
         return MPI_SUCCESS;
         break;
 
+    case OMPI_REQUEST_COLL:
+        if (NULL != (*request)->req_start) {
+            OPAL_CR_ENTER_LIBRARY();
+
+            ret = (*request)->req_start(1, request);
+
+            OPAL_CR_EXIT_LIBRARY();
+            return ret;
+        }
+        /* non-blocking collectives cannot be started */
+        return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_REQUEST, FUNC_NAME);
+        break;
+
     default:
         return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_REQUEST, FUNC_NAME);
     }
@@ -42,7 +42,7 @@ static const char FUNC_NAME[] = "MPI_Startall";
 
 int MPI_Startall(int count, MPI_Request requests[]) 
 {
-    int ret = OMPI_SUCCESS;
+    int i, ret = OMPI_SUCCESS;
 
     MEMCHECKER(
         int j;
@@ -52,7 +52,6 @@ int MPI_Startall(int count, MPI_Request requests[])
     );
 
     if ( MPI_PARAM_CHECK ) {
-        int i;
         int rc = MPI_SUCCESS;
         OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
         if (NULL == requests) {
@@ -63,7 +62,9 @@ int MPI_Startall(int count, MPI_Request requests[])
             for (i = 0; i < count; ++i) {
                 if (NULL == requests[i] ||
                     (OMPI_REQUEST_PML != requests[i]->req_type &&
-                     OMPI_REQUEST_NOOP != requests[i]->req_type)) {
+                     OMPI_REQUEST_NOOP != requests[i]->req_type &&
+                     (OMPI_REQUEST_COLL != requests[i]->req_type ||
+                      NULL == requests[i]->req_start))) {
                     rc = MPI_ERR_REQUEST;
                     break;
                 }
@@ -74,7 +75,15 @@ int MPI_Startall(int count, MPI_Request requests[])
 
     OPAL_CR_ENTER_LIBRARY();
 
+    /* the PML skips the requests that are not its own, the persistent
+     * collectives are started afterwards */
     ret = MCA_PML_CALL(start(count, requests));
+    for (i = 0; i < count && OMPI_SUCCESS == ret; ++i) {
+        if (OMPI_REQUEST_COLL == requests[i]->req_type &&
+            NULL != requests[i]->req_start) {
+            ret = requests[i]->req_start(1, &requests[i]);
+        }
+    }
 
     OPAL_CR_EXIT_LIBRARY();
     return ret;
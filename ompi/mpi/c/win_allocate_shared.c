@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#include "ompi_config.h"
+#include <stdio.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/errhandler/errhandler.h"
+#include "ompi/info/info.h"
+#include "ompi/win/win.h"
+#include "ompi/memchecker.h"
+
+#if OPAL_HAVE_WEAK_SYMBOLS && OMPI_PROFILING_DEFINES
+#pragma weak MPI_Win_allocate_shared = PMPI_Win_allocate_shared
+#endif
+
+#if OMPI_PROFILING_DEFINES
+#include "ompi/mpi/c/profile/defines.h"
+#endif
+
+static const char FUNC_NAME[] = "MPI_Win_allocate_shared";
+
+
+int MPI_Win_allocate_shared(MPI_Aint size, int disp_unit, MPI_Info info,
+                            MPI_Comm comm, void *baseptr, MPI_Win *win) 
+{
+    int ret = MPI_SUCCESS;
+    
+    MEMCHECKER(
+        memchecker_comm(comm);
+    );
+    /* argument checking */
+    if (MPI_PARAM_CHECK) {
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
+
+        if (ompi_comm_invalid (comm)) {
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_COMM, 
+                                          FUNC_NAME);
+
+        } else if (NULL == info || ompi_info_is_freed(info)) {
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_INFO,
+                                          FUNC_NAME);
+
+        } else if (NULL == win) {
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_WIN, FUNC_NAME);
+        } else if (NULL == baseptr) {
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_ARG, FUNC_NAME);
+        } else if ( size < 0 ) {
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_SIZE, FUNC_NAME);            
+        } else if ( disp_unit <= 0 ) {
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_DISP, FUNC_NAME);
+        }
+    }
+
+    /* communicator must be an intracommunicator */
+    if (OMPI_COMM_IS_INTER(comm)) {
+        return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_COMM, FUNC_NAME);
+    }
+
+    OPAL_CR_ENTER_LIBRARY();
+
+    /* create window and return.  This fails if the processes of comm
+       can not share memory. */
+    ret = ompi_win_allocate_shared((size_t)size, disp_unit, comm,
+                                   info, baseptr, win);
+    if (OMPI_SUCCESS != ret) {
+        *win = MPI_WIN_NULL;
+        OPAL_CR_EXIT_LIBRARY();
+        return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_WIN, FUNC_NAME);
+    }
+
+    OPAL_CR_EXIT_LIBRARY();
+    return MPI_SUCCESS;
+}
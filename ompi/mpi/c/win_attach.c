@@ -0,0 +1,55 @@
+/*
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#include "ompi_config.h"
+#include <stdio.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/errhandler/errhandler.h"
+#include "ompi/win/win.h"
+#include "ompi/mca/osc/osc.h"
+
+#if OPAL_HAVE_WEAK_SYMBOLS && OMPI_PROFILING_DEFINES
+#pragma weak MPI_Win_attach = PMPI_Win_attach
+#endif
+
+#if OMPI_PROFILING_DEFINES
+#include "ompi/mpi/c/profile/defines.h"
+#endif
+
+static const char FUNC_NAME[] = "MPI_Win_attach";
+
+
+int MPI_Win_attach(MPI_Win win, void *base, MPI_Aint size) 
+{
+    int rc;
+
+    if (MPI_PARAM_CHECK) {
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
+
+        if (ompi_win_invalid(win)) {
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_WIN, FUNC_NAME);
+        } else if (NULL == base) {
+            return OMPI_ERRHANDLER_INVOKE(win, MPI_ERR_ARG, FUNC_NAME);
+        } else if (size < 0) {
+            return OMPI_ERRHANDLER_INVOKE(win, MPI_ERR_SIZE, FUNC_NAME);
+        }
+    }
+
+    /* only the windows from MPI_Win_create_dynamic take memory */
+    if (OMPI_WIN_FLAVOR_DYNAMIC != win->w_flavor ||
+        NULL == win->w_osc_module->osc_win_attach) {
+        return OMPI_ERRHANDLER_INVOKE(win, MPI_ERR_WIN, FUNC_NAME);
+    }
+
+    OPAL_CR_ENTER_LIBRARY();
+
+    rc = win->w_osc_module->osc_win_attach(win, base, (size_t) size);
+    OMPI_ERRHANDLER_RETURN(rc, win, rc, FUNC_NAME);
+}
@@ -0,0 +1,71 @@
+/*
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#include "ompi_config.h"
+#include <stdio.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/errhandler/errhandler.h"
+#include "ompi/info/info.h"
+#include "ompi/win/win.h"
+#include "ompi/memchecker.h"
+
+#if OPAL_HAVE_WEAK_SYMBOLS && OMPI_PROFILING_DEFINES
+#pragma weak MPI_Win_create_dynamic = PMPI_Win_create_dynamic
+#endif
+
+#if OMPI_PROFILING_DEFINES
+#include "ompi/mpi/c/profile/defines.h"
+#endif
+
+static const char FUNC_NAME[] = "MPI_Win_create_dynamic";
+
+
+int MPI_Win_create_dynamic(MPI_Info info, MPI_Comm comm, MPI_Win *win) 
+{
+    int ret = MPI_SUCCESS;
+    
+    MEMCHECKER(
+        memchecker_comm(comm);
+    );
+    /* argument checking */
+    if (MPI_PARAM_CHECK) {
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
+
+        if (ompi_comm_invalid (comm)) {
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_COMM, 
+                                          FUNC_NAME);
+
+        } else if (NULL == info || ompi_info_is_freed(info)) {
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_INFO,
+                                          FUNC_NAME);
+
+        } else if (NULL == win) {
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_WIN, FUNC_NAME);
+        }
+    }
+
+    /* communicator must be an intracommunicator */
+    if (OMPI_COMM_IS_INTER(comm)) {
+        return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_COMM, FUNC_NAME);
+    }
+
+    OPAL_CR_ENTER_LIBRARY();
+
+    /* create window and return */
+    ret = ompi_win_create_dynamic(comm, info, win);
+    if (OMPI_SUCCESS != ret) {
+        *win = MPI_WIN_NULL;
+        OPAL_CR_EXIT_LIBRARY();
+        return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_WIN, FUNC_NAME);
+    }
+
+    OPAL_CR_EXIT_LIBRARY();
+    return MPI_SUCCESS;
+}
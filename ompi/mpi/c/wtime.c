@@ -26,6 +26,7 @@
 #include MCA_timer_IMPLEMENTATION_HEADER
 #include "ompi/mpi/c/bindings.h"
 #include "ompi/runtime/mpiruntime.h"
+#include "ompi/runtime/ompi_clock_sync.h"
 
 #if OPAL_HAVE_WEAK_SYMBOLS && OMPI_PROFILING_DEFINES
 #pragma weak MPI_Wtime = PMPI_Wtime
@@ -42,6 +43,12 @@ double MPI_Wtime(void)
 {
     double wtime;
 
+    if (OPAL_UNLIKELY(ompi_clock_sync_active)) {
+        wtime = ompi_clock_global();
+        OPAL_CR_NOOP_PROGRESS();
+        return wtime;
+    }
+
 #if OPAL_TIMER_USEC_NATIVE
     wtime = ((double) opal_timer_base_get_usec()) / 1000000.0;
 #else
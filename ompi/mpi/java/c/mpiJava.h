@@ -50,6 +50,9 @@ void* ompi_java_getBufPtr(void** bufbase,
 void ompi_java_releaseBufPtr(JNIEnv *env, jobject buf,
                              void* bufbase, int baseType);
 
+void* ompi_java_getDirectBufPtr(JNIEnv *env, jobject buf,
+                                int baseType, int offset);
+
 void* ompi_java_getMPIWriteBuf(int* bsize, int count,
                                MPI_Datatype type, MPI_Comm comm);
 
@@ -169,6 +169,33 @@ void ompi_java_releaseBufPtr(JNIEnv *env, jobject buf,
     }
 }
 
+/* `getDirectBufPtr' is used in 
+     Send, Recv, Isend, Irecv ...
+   for getting the address of the item at `offset' of a direct
+   `java.nio' buffer.  Returns NULL if `buf' is not a direct buffer,
+   in which case the caller goes through the array path.
+
+   Direct buffers are used in place, with no copies in or out, and
+   may be the target of non-blocking operations.  The data is sent in
+   its native representation, like from C: in builds without
+   GC_DOES_PINNING, a message sent from a direct buffer must be
+   received into a direct buffer (or by a C process), and conversely.
+*/
+void* ompi_java_getDirectBufPtr(JNIEnv *env, jobject buf,
+                                int baseType, int offset)
+{
+    char* addr ;
+
+    if (NULL == buf || baseType < 1 || baseType > 12) {
+        return NULL ;
+    }
+    addr = (char*) (*env)->GetDirectBufferAddress(env, buf) ;
+    if (NULL == addr) {
+        return NULL ;
+    }
+    return addr + (size_t) offset * ompi_java.dt_sizes[baseType] ;
+}
+
 #ifndef GC_DOES_PINNING
 
 /* `getBufCritical' is used in 
@@ -610,6 +637,14 @@ JNIEXPORT void JNICALL Java_mpi_Comm_send(JNIEnv *env, jobject jthis,
 
     void *bufptr ;
 
+    bufptr = ompi_java_getDirectBufPtr(env, buf, baseType, offset) ;
+    if (NULL != bufptr) {
+        ompi_java_clearFreeList(env) ;
+
+        MPI_Send(bufptr, count, mpi_type, dest, tag, mpi_comm) ;
+        return ;
+    }
+
 #ifdef GC_DOES_PINNING 
 
     void *bufbase ;
@@ -658,6 +693,22 @@ JNIEXPORT jobject JNICALL Java_mpi_Comm_Recv(JNIEnv *env, jobject jthis,
 
     void *bufptr ;
 
+    bufptr = ompi_java_getDirectBufPtr(env, buf, baseType, offset) ;
+    if (NULL != bufptr) {
+        int elements ;
+
+        ompi_java_clearFreeList(env) ;
+
+        MPI_Recv(bufptr, count, mpi_type, source, tag, mpi_comm, status);
+        MPI_Get_count(status, MPI_BYTE, &elements) ;
+
+        (*env)->SetIntField(env, stat, ompi_java.elementsID, elements);
+        (*env)->SetIntField(env, stat, ompi_java.sourceID, status->MPI_SOURCE);
+        (*env)->SetIntField(env, stat, ompi_java.tagID, status->MPI_TAG);
+
+        return stat;
+    }
+
 #ifdef GC_DOES_PINNING 
 
     void *bufbase ;
@@ -844,6 +895,14 @@ JNIEXPORT void JNICALL Java_mpi_Comm_bsend(JNIEnv *env, jobject jthis,
 
     void *bufptr ;
 
+    bufptr = ompi_java_getDirectBufPtr(env, buf, baseType, offset) ;
+    if (NULL != bufptr) {
+        ompi_java_clearFreeList(env) ;
+
+        MPI_Bsend(bufptr, count, mpi_type, dest, tag, mpi_comm) ;
+        return ;
+    }
+
 #ifdef GC_DOES_PINNING 
 
     void *bufbase ;
@@ -886,6 +945,14 @@ JNIEXPORT void JNICALL Java_mpi_Comm_ssend(JNIEnv *env, jobject jthis,
 
     void *bufptr ;
 
+    bufptr = ompi_java_getDirectBufPtr(env, buf, baseType, offset) ;
+    if (NULL != bufptr) {
+        ompi_java_clearFreeList(env) ;
+
+        MPI_Ssend(bufptr, count, mpi_type, dest, tag, mpi_comm) ;
+        return ;
+    }
+
 #ifdef GC_DOES_PINNING 
 
     void *bufbase ;
@@ -928,6 +995,14 @@ JNIEXPORT void JNICALL Java_mpi_Comm_rsend(JNIEnv *env, jobject jthis,
 
     void *bufptr ;
 
+    bufptr = ompi_java_getDirectBufPtr(env, buf, baseType, offset) ;
+    if (NULL != bufptr) {
+        ompi_java_clearFreeList(env) ;
+
+        MPI_Rsend(bufptr, count, mpi_type, dest, tag, mpi_comm) ;
+        return ;
+    }
+
 #ifdef GC_DOES_PINNING 
 
     void *bufbase ;
@@ -972,6 +1047,23 @@ JNIEXPORT jobject JNICALL Java_mpi_Comm_Isend(JNIEnv *env, jobject jthis,
 
     void *bufptr ;
 
+    bufptr = ompi_java_getDirectBufPtr(env, buf, baseType, offset) ;
+    if (NULL != bufptr) {
+        ompi_java_clearFreeList(env) ;
+
+        MPI_Isend(bufptr, count, mpi_type, dest, tag, mpi_comm, &request) ;
+
+        /* Nothing to release, but keep the buffer reachable until
+           the request completes */
+
+        (*env)->SetIntField(env, req, ompi_java.opTagID, 2) ;  /* Request.OP_DIRECT */
+
+        (*env)->SetObjectField(env, req, ompi_java.bufSaveID, buf) ;
+
+        (*env)->SetLongField(env,req,ompi_java.reqhandleID,(jlong)request);
+        return req;
+    }
+
 #ifdef GC_DOES_PINNING 
 
     void *bufbase ;
@@ -1034,6 +1126,23 @@ JNIEXPORT jobject JNICALL Java_mpi_Comm_Ibsend(JNIEnv *env, jobject jthis,
 
     void *bufptr ;
 
+    bufptr = ompi_java_getDirectBufPtr(env, buf, baseType, offset) ;
+    if (NULL != bufptr) {
+        ompi_java_clearFreeList(env) ;
+
+        MPI_Ibsend(bufptr, count, mpi_type, dest, tag, mpi_comm, &request) ;
+
+        /* Nothing to release, but keep the buffer reachable until
+           the request completes */
+
+        (*env)->SetIntField(env, req, ompi_java.opTagID, 2) ;  /* Request.OP_DIRECT */
+
+        (*env)->SetObjectField(env, req, ompi_java.bufSaveID, buf) ;
+
+        (*env)->SetLongField(env,req,ompi_java.reqhandleID,(jlong)request);
+        return req;
+    }
+
 #ifdef GC_DOES_PINNING 
 
     void *bufbase ;
@@ -1096,6 +1205,23 @@ JNIEXPORT jobject JNICALL Java_mpi_Comm_Issend(JNIEnv *env, jobject jthis,
 
     void *bufptr ;
 
+    bufptr = ompi_java_getDirectBufPtr(env, buf, baseType, offset) ;
+    if (NULL != bufptr) {
+        ompi_java_clearFreeList(env) ;
+
+        MPI_Issend(bufptr, count, mpi_type, dest, tag, mpi_comm, &request) ;
+
+        /* Nothing to release, but keep the buffer reachable until
+           the request completes */
+
+        (*env)->SetIntField(env, req, ompi_java.opTagID, 2) ;  /* Request.OP_DIRECT */
+
+        (*env)->SetObjectField(env, req, ompi_java.bufSaveID, buf) ;
+
+        (*env)->SetLongField(env,req,ompi_java.reqhandleID,(jlong)request);
+        return req;
+    }
+
 #ifdef GC_DOES_PINNING 
 
     void *bufbase ;
@@ -1158,6 +1284,23 @@ JNIEXPORT jobject JNICALL Java_mpi_Comm_Irsend(JNIEnv *env, jobject jthis,
 
     void *bufptr ;
 
+    bufptr = ompi_java_getDirectBufPtr(env, buf, baseType, offset) ;
+    if (NULL != bufptr) {
+        ompi_java_clearFreeList(env) ;
+
+        MPI_Irsend(bufptr, count, mpi_type, dest, tag, mpi_comm, &request) ;
+
+        /* Nothing to release, but keep the buffer reachable until
+           the request completes */
+
+        (*env)->SetIntField(env, req, ompi_java.opTagID, 2) ;  /* Request.OP_DIRECT */
+
+        (*env)->SetObjectField(env, req, ompi_java.bufSaveID, buf) ;
+
+        (*env)->SetLongField(env,req,ompi_java.reqhandleID,(jlong)request);
+        return req;
+    }
+
 #ifdef GC_DOES_PINNING 
 
     void *bufbase ;
@@ -1220,6 +1363,23 @@ JNIEXPORT jobject JNICALL Java_mpi_Comm_Irecv(JNIEnv *env, jobject jthis,
 
     void *bufptr ;
 
+    bufptr = ompi_java_getDirectBufPtr(env, buf, baseType, offset) ;
+    if (NULL != bufptr) {
+        ompi_java_clearFreeList(env) ;
+
+        MPI_Irecv(bufptr, count, mpi_type, source, tag, mpi_comm, &request) ;
+
+        /* Nothing to release, but keep the buffer reachable until
+           the request completes */
+
+        (*env)->SetIntField(env, req, ompi_java.opTagID, 2) ;  /* Request.OP_DIRECT */
+
+        (*env)->SetObjectField(env, req, ompi_java.bufSaveID, buf) ;
+
+        (*env)->SetLongField(env,req,ompi_java.reqhandleID,(jlong)request);
+        return req;
+    }
+
 #ifdef GC_DOES_PINNING 
 
     void *bufbase ;
@@ -181,8 +181,14 @@ JNIEXPORT jobjectArray JNICALL Java_mpi_MPI_InitNative(JNIEnv *env, jclass obj,
  */
 JNIEXPORT void JNICALL Java_mpi_MPI_Finalize(JNIEnv *env, jclass obj)
 {
+    jmethodID releaseID ;
+
     ompi_java_clearFreeList(env) ;
 
+    /* give the pooled direct buffers back before MPI goes away */
+    releaseID = (*env)->GetStaticMethodID(env, obj, "releaseBuffers", "()V");
+    (*env)->CallStaticVoidMethod(env, obj, releaseID) ;
+
 #if OPAL_WANT_LIBLTDL
     /* need to balance the ltdl inits */
     lt_dlexit();
@@ -291,6 +297,39 @@ JNIEXPORT void JNICALL Java_mpi_MPI_Buffer_1detach_1native(JNIEnv *env, jclass j
     }
 }
 
+/*
+ * Class:     mpi_MPI
+ * Method:    allocMem
+ * Signature: (I)Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL Java_mpi_MPI_allocMem(JNIEnv *env, jclass jthis, jint capacity)
+{
+    void *bufptr ;
+
+    ompi_java_clearFreeList(env) ;
+
+    if (MPI_SUCCESS != MPI_Alloc_mem((MPI_Aint) capacity, MPI_INFO_NULL, &bufptr)) {
+        return NULL ;
+    }
+    return (*env)->NewDirectByteBuffer(env, bufptr, (jlong) capacity) ;
+}
+
+/*
+ * Class:     mpi_MPI
+ * Method:    freeMem
+ * Signature: (Ljava/nio/ByteBuffer;)V
+ */
+JNIEXPORT void JNICALL Java_mpi_MPI_freeMem(JNIEnv *env, jclass jthis, jobject buf)
+{
+    void *bufptr = (*env)->GetDirectBufferAddress(env, buf) ;
+
+    ompi_java_clearFreeList(env) ;
+
+    if (NULL != bufptr) {
+        MPI_Free_mem(bufptr) ;
+    }
+}
+
 /*
  * Class:     mpi_MPI
  * Method:    SetConstant
@@ -102,6 +102,19 @@ static void releaseBuf(int* elements, JNIEnv *env,
 
         /* Try not to create too many local references... */
         (*env)->DeleteLocalRef(env, buf) ;
+
+        break ;
+    }
+    case 2 : {  /* Request.OP_DIRECT */
+
+        /* The data is in place in the direct buffer: only drop the
+           reference that kept it alive */
+
+        MPI_Get_count(status, MPI_BYTE, elements) ;
+
+        (*env)->SetObjectField(env, req, ompi_java.bufSaveID, NULL) ;
+
+        break ;
     }
     }
 }
@@ -25,6 +25,8 @@
 package mpi;
 
 import java.util.LinkedList ;
+import java.nio.ByteBuffer ;
+import java.nio.ByteOrder ;
 
 public class MPI {
 
@@ -277,6 +279,98 @@ public class MPI {
 
   static private native void Buffer_detach_native(byte[] buffer);
 
+  // Direct buffer allocation
+
+  private static final int BUFFER_MIN_CLASS = 6 ;    // 64 bytes
+  private static final int BUFFER_MAX_CLASS = 30 ;   // 1 GB
+
+  private static LinkedList [] bufferPool =
+      new LinkedList [BUFFER_MAX_CLASS + 1] ;
+
+  /**
+   * Allocate a direct buffer in memory obtained from MPI.
+   * <p>
+   * <table>
+   * <tr><td><tt> capacity </tt></td><td> size of the buffer in bytes </tr>
+   * <tr><td><em> returns: </em></td><td> direct buffer, in native
+   *                                      byte order </tr>
+   * </table>
+   * <p>
+   * Uses the MPI operation <tt>MPI_ALLOC_MEM</tt>, so that the memory
+   * may be registered with the network.  Sends and receives on a
+   * direct buffer (including the non-blocking ones) work on its memory
+   * in place, with no copies; the value <tt>offset</tt> then counts
+   * items of the datatype from the start of the buffer.  The data is
+   * not converted, so unless the JVM pins arrays the peer must use a
+   * direct buffer too.
+   * <p>
+   * Give the buffer back with <tt>freeBuffer</tt>: it is kept for
+   * reuse by a later allocation of a similar size.
+   */
+
+  static synchronized public ByteBuffer newBuffer(int capacity)
+                                                  throws MPIException {
+    int sizeClass = bufferClass(capacity) ;
+    ByteBuffer buf = null ;
+
+    if (sizeClass < 0)
+      buf = allocMem(capacity) ;
+    else if (bufferPool[sizeClass] != null && !bufferPool[sizeClass].isEmpty())
+      buf = (ByteBuffer) bufferPool[sizeClass].removeFirst() ;
+    else
+      buf = allocMem(1 << sizeClass) ;
+
+    if (buf == null)
+      throw new MPIException("MPI_Alloc_mem failed") ;
+
+    buf.clear() ;
+    buf.limit(capacity) ;
+    return buf.order(ByteOrder.nativeOrder()) ;
+  }
+
+  /**
+   * Return a buffer obtained from <tt>newBuffer</tt>.  The buffer must
+   * not be used afterwards, nor be in use by a pending operation.
+   */
+
+  static synchronized public void freeBuffer(ByteBuffer buf) {
+    int sizeClass = bufferClass(buf.capacity()) ;
+
+    if (sizeClass < 0 || (1 << sizeClass) != buf.capacity()) {
+      freeMem(buf) ;
+      return ;
+    }
+    if (bufferPool[sizeClass] == null)
+      bufferPool[sizeClass] = new LinkedList() ;
+    bufferPool[sizeClass].addFirst(buf) ;
+  }
+
+  /*
+   * Smallest power of two class holding `capacity' bytes, or -1 if the
+   * buffer is too large to be pooled.
+   */
+
+  private static int bufferClass(int capacity) {
+    int sizeClass = BUFFER_MIN_CLASS ;
+
+    while (sizeClass <= BUFFER_MAX_CLASS && (1 << sizeClass) < capacity)
+      sizeClass++ ;
+    return (sizeClass <= BUFFER_MAX_CLASS) ? sizeClass : -1 ;
+  }
+
+  /*
+   * Called from `Finalize', as the memory must go back before MPI does.
+   */
+
+  synchronized static void releaseBuffers() {
+    for (int i = 0 ; i < bufferPool.length ; i++)
+      while (bufferPool[i] != null && !bufferPool[i].isEmpty())
+        freeMem((ByteBuffer) bufferPool[i].removeFirst()) ;
+  }
+
+  static private native ByteBuffer allocMem(int capacity) ;
+  static private native void freeMem(ByteBuffer buf) ;
+
   static LinkedList freeList = new LinkedList() ;
 
   synchronized static void clearFreeList() {
@@ -47,6 +47,7 @@ public class Request {
 
   protected final static int OP_SEND     = 0;
   protected final static int OP_RECV     = 1;
+  protected final static int OP_DIRECT   = 2;  // direct buffer, send or recv
 
   protected Request hdrReq ;
   protected int typeTag = TYPE_NORMAL   ;
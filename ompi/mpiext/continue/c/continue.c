@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#include "ompi_config.h"
+#include <stdio.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/errhandler/errhandler.h"
+#include "ompi/request/request.h"
+
+#include "ompi/mpiext/continue/c/continue.h"
+
+static const char FUNC_NAME[] = "MPIX_Continue";
+
+
+int MPIX_Continue(MPI_Request *request, MPIX_Continue_cb_function *cb,
+                  void *cb_data, MPI_Status *status)
+{
+    int rc;
+
+    if (MPI_PARAM_CHECK) {
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
+        if (NULL == request || NULL == *request) {
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_REQUEST,
+                                          FUNC_NAME);
+        }
+        if (NULL == cb) {
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_ARG,
+                                          FUNC_NAME);
+        }
+    }
+
+    OPAL_CR_ENTER_LIBRARY();
+
+    rc = ompi_continue_attach(1, request, cb, cb_data,
+                              MPI_STATUS_IGNORE == status ? NULL : status, true);
+    OMPI_ERRHANDLER_RETURN(rc, MPI_COMM_WORLD, rc, FUNC_NAME);
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#ifndef OMPI_MPIEXT_CONTINUE_H
+#define OMPI_MPIEXT_CONTINUE_H
+
+#include "ompi_config.h"
+
+#include "ompi/request/request.h"
+#include "ompi/mpiext/continue/c/mpiext_continue_c.h"
+
+BEGIN_C_DECLS
+
+/**
+ * Attach a continuation to the requests.  The handles of the
+ * non-persistent requests are set to MPI_REQUEST_NULL on success.
+ *
+ * @param count     number of requests
+ * @param requests  the requests, MPI_REQUEST_NULL and inactive ones are skipped
+ * @param cb        callback run once all of them completed
+ * @param cb_data   argument of the callback
+ * @param statuses  count statuses to fill in, or NULL
+ * @param single    MPIX_Continue semantic for the status and error
+ *
+ * @return OMPI_SUCCESS, or MPI_ERR_REQUEST if a request already has a
+ * completion callback (another continuation, or a request internal to
+ * a component); nothing is attached then.
+ */
+int ompi_continue_attach(int count, ompi_request_t **requests,
+                         MPIX_Continue_cb_function *cb, void *cb_data,
+                         ompi_status_public_t *statuses, bool single);
+
+END_C_DECLS
+
+#endif /* OMPI_MPIEXT_CONTINUE_H */
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#include "ompi_config.h"
+#include <stdio.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/errhandler/errhandler.h"
+#include "ompi/request/request.h"
+
+#include "ompi/mpiext/continue/c/continue.h"
+
+static const char FUNC_NAME[] = "MPIX_Continueall";
+
+
+int MPIX_Continueall(int count, MPI_Request array_of_requests[],
+                     MPIX_Continue_cb_function *cb, void *cb_data,
+                     MPI_Status array_of_statuses[])
+{
+    int i, rc;
+
+    if (MPI_PARAM_CHECK) {
+        rc = MPI_SUCCESS;
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
+        if ((NULL == array_of_requests) && (count > 0)) {
+            rc = MPI_ERR_REQUEST;
+        } else {
+            for (i = 0; i < count; i++) {
+                if (NULL == array_of_requests[i]) {
+                    rc = MPI_ERR_REQUEST;
+                    break;
+                }
+            }
+        }
+        if (count < 0) {
+            rc = MPI_ERR_ARG;
+        }
+        if (NULL == cb) {
+            rc = MPI_ERR_ARG;
+        }
+        OMPI_ERRHANDLER_CHECK(rc, MPI_COMM_WORLD, rc, FUNC_NAME);
+    }
+
+    OPAL_CR_ENTER_LIBRARY();
+
+    rc = ompi_continue_attach(count, array_of_requests, cb, cb_data,
+                              MPI_STATUSES_IGNORE == array_of_statuses ?
+                              NULL : array_of_statuses, false);
+    OMPI_ERRHANDLER_RETURN(rc, MPI_COMM_WORLD, rc, FUNC_NAME);
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ *
+ */
+
+/********************************
+ * Request completion callbacks
+ ********************************/
+/*
+ * Attach a callback to one or all of a set of requests.  The callback
+ * is called once, from the progress engine (the progress thread when
+ * one runs), after all the requests completed: rc is the error of the
+ * request for MPIX_Continue, MPI_SUCCESS or MPI_ERR_IN_STATUS for
+ * MPIX_Continueall, and the statuses, unless ignored, are filled in
+ * by then.  The requests belong to the continuation from the call on:
+ * non-persistent ones are freed and their handles set to
+ * MPI_REQUEST_NULL, persistent ones become inactive again before the
+ * callback runs and must not be waited on or tested until then.  The
+ * callback must not block in MPI.
+ */
+typedef int (MPIX_Continue_cb_function)(int rc, void *cb_data);
+
+OMPI_DECLSPEC int MPIX_Continue(MPI_Request *request, MPIX_Continue_cb_function *cb,
+                                void *cb_data, MPI_Status *status);
+OMPI_DECLSPEC int MPIX_Continueall(int count, MPI_Request array_of_requests[],
+                                   MPIX_Continue_cb_function *cb, void *cb_data,
+                                   MPI_Status array_of_statuses[]);
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+/*
+ * Continuations: a callback hangs off the req_complete_cb of each
+ * request of the set, and the last completion queues the continuation
+ * on a lock-free list.  The completion callbacks run inside the PML,
+ * with ompi_request_lock held, so the user callback and the release of
+ * the requests are left to a progress function.
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "opal/class/opal_atomic_lifo.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/sys/atomic.h"
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/mpiext/mpiext.h"
+#include "ompi/request/grequest.h"
+#include "ompi/mpiext/continue/c/continue.h"
+
+struct ompi_continue_t {
+    opal_list_item_t super;
+    MPIX_Continue_cb_function *cb;
+    void *cb_data;
+    volatile int32_t pending;       /**< requests not completed, plus one while attaching */
+    int count;
+    ompi_request_t **requests;      /**< the attached requests, NULL for the skipped ones */
+    ompi_status_public_t *statuses;
+    bool single;
+};
+typedef struct ompi_continue_t ompi_continue_t;
+
+static void ompi_continue_construct(ompi_continue_t *cont)
+{
+    cont->requests = NULL;
+}
+
+static void ompi_continue_destruct(ompi_continue_t *cont)
+{
+    if (NULL != cont->requests) {
+        free(cont->requests);
+    }
+}
+
+static OBJ_CLASS_INSTANCE(ompi_continue_t, opal_list_item_t,
+                          ompi_continue_construct, ompi_continue_destruct);
+
+/** continuations whose requests all completed */
+static opal_atomic_lifo_t continue_ready;
+static opal_mutex_t continue_lock;
+static bool continue_registered = false;
+
+static int continue_progress(void);
+
+static int continue_request_complete_cb(ompi_request_t *request)
+{
+    ompi_continue_t *cont = (ompi_continue_t *) request->req_complete_cb_data;
+
+    if (0 == OPAL_THREAD_ADD32(&cont->pending, -1)) {
+        opal_atomic_lifo_push(&continue_ready, &cont->super);
+    }
+    return OMPI_SUCCESS;
+}
+
+int ompi_continue_attach(int count, ompi_request_t **requests,
+                         MPIX_Continue_cb_function *cb, void *cb_data,
+                         ompi_status_public_t *statuses, bool single)
+{
+    ompi_continue_t *cont;
+    ompi_request_t *request;
+    int i;
+
+    if (!continue_registered) {
+        OPAL_THREAD_LOCK(&continue_lock);
+        if (!continue_registered) {
+            opal_progress_register(continue_progress);
+            continue_registered = true;
+        }
+        OPAL_THREAD_UNLOCK(&continue_lock);
+    }
+
+    cont = OBJ_NEW(ompi_continue_t);
+    if (NULL == cont) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    cont->requests = (ompi_request_t **) malloc((count > 0 ? count : 1) *
+                                                sizeof(ompi_request_t *));
+    if (NULL == cont->requests) {
+        OBJ_RELEASE(cont);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    cont->cb = cb;
+    cont->cb_data = cb_data;
+    cont->pending = 1;
+    cont->count = count;
+    cont->statuses = statuses;
+    cont->single = single;
+
+    /* As in libnbc, the PML completes requests with ompi_request_lock
+     * held: none of them can complete between the check of
+     * req_complete and the setting of the callback. */
+    OPAL_THREAD_LOCK(&ompi_request_lock);
+    for (i = 0; i < count; i++) {
+        request = requests[i];
+        if (MPI_REQUEST_NULL != request && OMPI_REQUEST_INACTIVE != request->req_state &&
+            NULL != request->req_complete_cb) {
+            OPAL_THREAD_UNLOCK(&ompi_request_lock);
+            OBJ_RELEASE(cont);
+            return MPI_ERR_REQUEST;
+        }
+    }
+    for (i = 0; i < count; i++) {
+        request = requests[i];
+        if (MPI_REQUEST_NULL == request || OMPI_REQUEST_INACTIVE == request->req_state) {
+            cont->requests[i] = NULL;
+            continue;
+        }
+        cont->requests[i] = request;
+        if (!request->req_complete) {
+            request->req_complete_cb_data = cont;
+            request->req_complete_cb = continue_request_complete_cb;
+            cont->pending++;
+        }
+        if (!request->req_persistent) {
+            requests[i] = MPI_REQUEST_NULL;
+        }
+    }
+    OPAL_THREAD_UNLOCK(&ompi_request_lock);
+
+    /* even when everything already completed, the callback only runs
+     * from progress, never from within the call */
+    if (0 == OPAL_THREAD_ADD32(&cont->pending, -1)) {
+        opal_atomic_lifo_push(&continue_ready, &cont->super);
+    }
+    return OMPI_SUCCESS;
+}
+
+/* release the requests of a continuation and run its callback */
+static void continue_invoke(ompi_continue_t *cont)
+{
+    ompi_request_t *request;
+    int i, rc = MPI_SUCCESS;
+
+    for (i = 0; i < cont->count; i++) {
+        request = cont->requests[i];
+        if (NULL == request) {
+            if (NULL != cont->statuses && !cont->single) {
+                cont->statuses[i] = ompi_status_empty;
+            }
+            continue;
+        }
+        if (OMPI_REQUEST_GEN == request->req_type) {
+            ompi_grequest_invoke_query(request, &request->req_status);
+        }
+        if (NULL != cont->statuses) {
+            if (cont->single) {
+                /* as MPI_Wait, leave MPI_ERROR alone */
+                int old_error = cont->statuses[0].MPI_ERROR;
+                cont->statuses[0] = request->req_status;
+                cont->statuses[0].MPI_ERROR = old_error;
+            } else {
+                cont->statuses[i] = request->req_status;
+            }
+        }
+        if (MPI_SUCCESS != request->req_status.MPI_ERROR) {
+            rc = cont->single ? request->req_status.MPI_ERROR : MPI_ERR_IN_STATUS;
+        }
+        if (request->req_persistent) {
+            request->req_state = OMPI_REQUEST_INACTIVE;
+        } else {
+            ompi_request_free(&request);
+        }
+    }
+
+    cont->cb(rc, cont->cb_data);
+    OBJ_RELEASE(cont);
+}
+
+static int continue_progress(void)
+{
+    ompi_continue_t *cont;
+    int i, completed = 0;
+
+    while (NULL != (cont = (ompi_continue_t *)
+                    opal_atomic_lifo_pop(&continue_ready))) {
+        /* the completion callback runs right before the request is
+         * flagged complete: with threads, the completer may not be
+         * done with the last request yet, try again later */
+        for (i = 0; i < cont->count; i++) {
+            if (NULL != cont->requests[i] && !cont->requests[i]->req_complete) {
+                break;
+            }
+        }
+        if (i < cont->count) {
+            opal_atomic_lifo_push(&continue_ready, &cont->super);
+            break;
+        }
+        opal_atomic_rmb();
+        continue_invoke(cont);
+        completed++;
+    }
+    return completed;
+}
+
+static int continue_init(void)
+{
+    OBJ_CONSTRUCT(&continue_ready, opal_atomic_lifo_t);
+    OBJ_CONSTRUCT(&continue_lock, opal_mutex_t);
+    return OMPI_SUCCESS;
+}
+
+static int continue_fini(void)
+{
+    opal_list_item_t *item;
+
+    if (continue_registered) {
+        opal_progress_unregister(continue_progress);
+        continue_registered = false;
+    }
+    /* the callbacks of the continuations still pending are not run */
+    while (NULL != (item = opal_atomic_lifo_pop(&continue_ready))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&continue_lock);
+    OBJ_DESTRUCT(&continue_ready);
+    return OMPI_SUCCESS;
+}
+
+ompi_mpiext_component_t ompi_mpiext_continue = {
+    continue_init,
+    continue_fini
+};
@@ -0,0 +1,24 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2013      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+# 
+# Additional copyrights may follow
+# 
+# $HEADER$
+#
+
+# OMPI_MPIEXT_continue_CONFIG([action-if-found], [action-if-not-found])
+# -----------------------------------------------------------
+AC_DEFUN([OMPI_MPIEXT_continue_CONFIG], [
+    AC_CONFIG_FILES([ompi/mpiext/continue/Makefile])
+    AC_CONFIG_FILES([ompi/mpiext/continue/c/Makefile])
+
+    # Only needs the request layer, so it can always build.
+    $1
+])
+
+# the progress callback is set up and torn down by init/fini hooks
+AC_DEFUN([OMPI_MPIEXT_continue_NEED_INIT], [1])
@@ -60,6 +60,14 @@ OMPI_DECLSPEC int OMPI_CR_self_register_checkpoint_callback(OMPI_CR_self_checkpo
 OMPI_DECLSPEC int OMPI_CR_self_register_restart_callback(OMPI_CR_self_restart_fn function);
 OMPI_DECLSPEC int OMPI_CR_self_register_continue_callback(OMPI_CR_self_continue_fn function);
 
+/*
+ * Add a memory region to the checkpoints of the self CRS, written whole
+ * the first time and then only its modified pages when crs_base_incr is
+ * set.  At restart the region gets its content back as soon as it is
+ * registered again, so register the same regions, in the same order.
+ */
+OMPI_DECLSPEC int OMPI_CR_self_register_region(void *base, MPI_Aint size);
+
 
 /********************************
  * Quiescence Interfaces
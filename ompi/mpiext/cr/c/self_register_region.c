@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#include "ompi_config.h"
+#include <stdio.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "opal/runtime/opal_cr.h"
+#include "ompi/mpiext/cr/c/mpiext_cr_c.h"
+
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/errhandler/errhandler.h"
+#include "opal/mca/crs/crs.h"
+#include "opal/mca/crs/base/base.h"
+
+static const char FUNC_NAME[] = "OMPI_CR_self_register_region";
+
+int OMPI_CR_self_register_region(void *base, MPI_Aint size)
+{
+    int rc;
+
+    if ( MPI_PARAM_CHECK ) {
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME); 
+        if (NULL == base || 0 > size) {
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_ARG, FUNC_NAME);
+        }
+    }
+
+    OPAL_CR_ENTER_LIBRARY();
+
+    rc = opal_crs_base_incr_register(base, (size_t) size);
+
+    OMPI_ERRHANDLER_RETURN(rc, MPI_COMM_WORLD, rc, FUNC_NAME);
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ *
+ */
+
+/********************************
+ * Extended generalized requests
+ ********************************/
+/*
+ * As MPI_Grequest_start, with two more callbacks that let MPI drive
+ * the operation instead of a helper thread of the application:
+ *
+ * - poll_fn is called from the progress engine while the request is
+ *   pending.  It must not block; it calls MPI_Grequest_complete once
+ *   the operation is done.
+ * - wait_fn is called by MPI_Wait and MPI_Waitall on a pending
+ *   request.  It blocks until the operations of the count states
+ *   complete, timeout seconds at most (0 means no limit), and calls
+ *   MPI_Grequest_complete on their requests.
+ *
+ * Either may be NULL.  The status argument of both is scratch space,
+ * the status of the request is still set by query_fn.
+ */
+typedef int (MPIX_Grequest_poll_function)(void *extra_state, MPI_Status *status);
+typedef int (MPIX_Grequest_wait_function)(int count, void **array_of_states,
+                                          double timeout, MPI_Status *status);
+
+OMPI_DECLSPEC int MPIX_Grequest_start(MPI_Grequest_query_function *query_fn,
+                                      MPI_Grequest_free_function *free_fn,
+                                      MPI_Grequest_cancel_function *cancel_fn,
+                                      MPIX_Grequest_poll_function *poll_fn,
+                                      MPIX_Grequest_wait_function *wait_fn,
+                                      void *extra_state, MPI_Request *request);
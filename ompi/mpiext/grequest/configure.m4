@@ -0,0 +1,21 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2013      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+# 
+# Additional copyrights may follow
+# 
+# $HEADER$
+#
+
+# OMPI_MPIEXT_grequest_CONFIG([action-if-found], [action-if-not-found])
+# -----------------------------------------------------------
+AC_DEFUN([OMPI_MPIEXT_grequest_CONFIG], [
+    AC_CONFIG_FILES([ompi/mpiext/grequest/Makefile])
+    AC_CONFIG_FILES([ompi/mpiext/grequest/c/Makefile])
+
+    # Only needs the request layer, so it can always build.
+    $1
+])
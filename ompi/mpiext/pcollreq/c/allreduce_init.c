@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#include "ompi_config.h"
+#include <stdio.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/errhandler/errhandler.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
+
+#include "ompi/mpiext/pcollreq/c/mpiext_pcollreq_c.h"
+
+static const char FUNC_NAME[] = "MPIX_Allreduce_init";
+
+
+int MPIX_Allreduce_init(void *sendbuf, void *recvbuf, int count,
+                        MPI_Datatype datatype, MPI_Op op, MPI_Comm comm,
+                        MPI_Request *request)
+{
+    int err;
+
+    if (MPI_PARAM_CHECK) {
+        char *msg;
+
+        err = MPI_SUCCESS;
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
+        if (ompi_comm_invalid(comm)) {
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_COMM, 
+                                          FUNC_NAME);
+        } else if (NULL == request) {
+            err = MPI_ERR_REQUEST;
+        } else if (MPI_OP_NULL == op) {
+            err = MPI_ERR_OP;
+        } else if (!ompi_op_is_valid(op, datatype, &msg, FUNC_NAME)) {
+            int ret = OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_OP, msg);
+            free(msg);
+            return ret;
+        } else if (MPI_IN_PLACE == recvbuf) {
+            err = MPI_ERR_BUFFER;
+        } else if ((sendbuf == recvbuf) && 
+                   (MPI_BOTTOM != sendbuf) &&
+                   (count > 1)) {
+            err = MPI_ERR_BUFFER;
+        } else {
+            OMPI_CHECK_DATATYPE_FOR_SEND(err, datatype, count);
+        }
+        OMPI_ERRHANDLER_CHECK(err, comm, err, FUNC_NAME);
+    }
+
+    if (NULL == comm->c_coll.coll_allreduce_init) {
+        return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_UNSUPPORTED_OPERATION,
+                                      FUNC_NAME);
+    }
+
+    OPAL_CR_ENTER_LIBRARY();
+
+    /* Invoke the coll component to build the persistent operation */
+
+    err = comm->c_coll.coll_allreduce_init(sendbuf, recvbuf, count,
+                                           datatype, op, comm, request,
+                                           comm->c_coll.coll_allreduce_init_module);
+    OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+#include "ompi_config.h"
+#include <stdio.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/errhandler/errhandler.h"
+#include "ompi/datatype/ompi_datatype.h"
+
+#include "ompi/mpiext/pcollreq/c/mpiext_pcollreq_c.h"
+
+static const char FUNC_NAME[] = "MPIX_Bcast_init";
+
+
+int MPIX_Bcast_init(void *buffer, int count, MPI_Datatype datatype,
+                    int root, MPI_Comm comm, MPI_Request *request)
+{
+    int err;
+
+    if (MPI_PARAM_CHECK) {
+        err = MPI_SUCCESS;
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
+        if (ompi_comm_invalid(comm)) {
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_COMM, 
+                                          FUNC_NAME);
+        }
+        if (NULL == request) {
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_REQUEST, FUNC_NAME);
+        }
+
+        OMPI_CHECK_DATATYPE_FOR_SEND(err, datatype, count);
+        OMPI_ERRHANDLER_CHECK(err, comm, err, FUNC_NAME);
+        if (MPI_IN_PLACE == buffer) {
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_ARG, FUNC_NAME);
+        }
+        if ((root >= ompi_comm_size(comm)) || (root < 0)) {
+            return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_ROOT, FUNC_NAME);
+        }
+    }
+
+    /* only libnbc provides persistent collectives, on intracommunicators */
+    if (NULL == comm->c_coll.coll_bcast_init) {
+        return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_UNSUPPORTED_OPERATION,
+                                      FUNC_NAME);
+    }
+
+    OPAL_CR_ENTER_LIBRARY();
+
+    /* Invoke the coll component to build the persistent operation */
+
+    err = comm->c_coll.coll_bcast_init(buffer, count, datatype, root, comm,
+                                       request,
+                                       comm->c_coll.coll_bcast_init_module);
+    OMPI_ERRHANDLER_RETURN(err, comm, err, FUNC_NAME);
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ *
+ */
+
+/********************************
+ * Persistent collectives
+ ********************************/
+/*
+ * The request is created inactive: MPI_Start or MPI_Startall run the
+ * collective on the arguments of the init call, MPI_Wait or MPI_Test
+ * complete it, and MPI_Request_free releases it.  All the processes
+ * of the communicator have to start their requests in the same order.
+ */
+OMPI_DECLSPEC int MPIX_Allreduce_init(void *sendbuf, void *recvbuf, int count,
+                                      MPI_Datatype datatype, MPI_Op op, MPI_Comm comm,
+                                      MPI_Request *request);
+OMPI_DECLSPEC int MPIX_Bcast_init(void *buffer, int count, MPI_Datatype datatype,
+                                  int root, MPI_Comm comm, MPI_Request *request);
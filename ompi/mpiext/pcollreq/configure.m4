@@ -0,0 +1,21 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2013      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+# 
+# Additional copyrights may follow
+# 
+# $HEADER$
+#
+
+# OMPI_MPIEXT_pcollreq_CONFIG([action-if-found], [action-if-not-found])
+# -----------------------------------------------------------
+AC_DEFUN([OMPI_MPIEXT_pcollreq_CONFIG], [
+    AC_CONFIG_FILES([ompi/mpiext/pcollreq/Makefile])
+    AC_CONFIG_FILES([ompi/mpiext/pcollreq/c/Makefile])
+
+    # Only needs the coll framework, so it can always build.
+    $1
+])
@@ -21,6 +21,7 @@
 #include "ompi_config.h"
 
 #include "opal/class/opal_pointer_array.h"
+#include "opal/datatype/opal_convertor.h"
 
 #include "ompi/constants.h"
 #include "ompi/op/op.h"
@@ -194,6 +195,10 @@ int ompi_op_init(void)
 #warning Unsupported definition for MPI_COUNT
 #endif
 
+    /* Open MPI extensions */
+    ompi_op_ddt_map[OMPI_DATATYPE_MPI_FLOAT16] = OMPI_OP_BASE_TYPE_FLOAT16;
+    ompi_op_ddt_map[OMPI_DATATYPE_MPI_BFLOAT16] = OMPI_OP_BASE_TYPE_BFLOAT16;
+
     /* Create the intrinsic ops */
 
     if (OMPI_SUCCESS != 
@@ -339,6 +344,56 @@ void ompi_op_set_cxx_callback(ompi_op_t *op, MPI_User_function *fn)
 }
 
 
+/*
+ * The optimized description of the datatype gives the contiguous pieces
+ * of the target, OMPI_OP_REDUCE_IOV at a time. The source has the same
+ * layout, its pieces are at the same offsets.
+ */
+#define OMPI_OP_REDUCE_IOV 32
+
+void ompi_op_reduce_derived(ompi_op_t *op, void *source, void *target,
+                            int count, ompi_datatype_t *dtype)
+{
+    ompi_datatype_t *predef;
+    opal_convertor_t convertor;
+    struct iovec iov[OMPI_OP_REDUCE_IOV];
+    uint32_t iov_count, i;
+    size_t length, predef_size, dtype_size;
+    ptrdiff_t offset;
+    int32_t done;
+
+    /* checked by ompi_op_is_valid() */
+    predef = (NULL == dtype->args) ? NULL :
+        ompi_datatype_get_single_predefined_type_from_args(dtype);
+    if (NULL == predef || 0 == count) {
+        return;
+    }
+    ompi_datatype_type_size(predef, &predef_size);
+    ompi_datatype_type_size(dtype, &dtype_size);
+
+    if (ompi_datatype_is_contiguous_memory_layout(dtype, count)) {
+        offset = dtype->super.true_lb;
+        ompi_op_reduce(op, (char*)source + offset, (char*)target + offset,
+                       (int)(count * (dtype_size / predef_size)), predef);
+        return;
+    }
+
+    OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+    opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor, &dtype->super,
+                                             count, target, 0, &convertor);
+    do {
+        iov_count = OMPI_OP_REDUCE_IOV;
+        done = opal_convertor_raw(&convertor, iov, &iov_count, &length);
+        for (i = 0; i < iov_count; i++) {
+            offset = (char*)iov[i].iov_base - (char*)target;
+            ompi_op_reduce(op, (char*)source + offset, iov[i].iov_base,
+                           (int)(iov[i].iov_len / predef_size), predef);
+        }
+    } while (0 == done);
+    OBJ_DESTRUCT(&convertor);
+}
+
+
 /**************************************************************************
  *
  * Static functions
@@ -342,6 +342,25 @@ ompi_op_t *ompi_op_create_user(bool commute,
 OMPI_DECLSPEC void ompi_op_set_cxx_callback(ompi_op_t * op,
                                             MPI_User_function * fn);
 
+/**
+ * Apply an intrinsic MPI_Op to a derived datatype, in place.
+ *
+ * @param op The intrinsic operation
+ * @param source Source (input) buffer
+ * @param target Target (input/output) buffer
+ * @param count Number of datatypes in the buffers
+ * @param dtype Derived datatype made of a single predefined type
+ *
+ * Walks the contiguous pieces of the target, from the optimized
+ * description of the datatype, and applies the function of the
+ * predefined type to each of them, with the piece at the same offset
+ * in the source. Nothing is packed or copied. Called by
+ * ompi_op_reduce(), other callers should use that one.
+ */
+OMPI_DECLSPEC void ompi_op_reduce_derived(ompi_op_t * op, void *source,
+                                          void *target, int count,
+                                          ompi_datatype_t * dtype);
+
 /**
  * Check to see if an op is intrinsic.
  *
@@ -412,7 +431,8 @@ static inline bool ompi_op_is_valid(ompi_op_t * op, ompi_datatype_t * ddt,
                                     char **msg, const char *func)
 {
     /* Check:
-       - non-intrinsic ddt's cannot be invoked on intrinsic op's
+       - non-intrinsic ddt's invoked on intrinsic op's must be built from
+         a single intrinsic ddt the op is defined on
        - if intrinsic ddt invoked on intrinsic op:
        - ensure the datatype is defined in the op map
        - ensure we have a function pointer for that combination
@@ -429,14 +449,21 @@ static inline bool ompi_op_is_valid(ompi_op_t * op, ompi_datatype_t * ddt,
                 return false;
             }
         } else {
-            /* Non-intrinsic ddt on intrinsic op */
+            /* Non-intrinsic ddt on intrinsic op: allowed when the ddt
+               is built from a single predefined type the op supports */
+            ompi_datatype_t *predef = (NULL == ddt->args) ? NULL :
+                ompi_datatype_get_single_predefined_type_from_args(ddt);
+            if (NULL != predef && -1 != ompi_op_ddt_map[predef->id] &&
+                NULL != op->o_func.intrinsic.fns[ompi_op_ddt_map[predef->id]]) {
+                return true;
+            }
             if ('\0' != ddt->name[0]) {
                 (void) asprintf(msg,
-                                "%s: the reduction operation %s is not defined for non-intrinsic datatypes (attempted with datatype named \"%s\")",
+                                "%s: the reduction operation %s is only defined for non-intrinsic datatypes built from a single intrinsic datatype it supports (attempted with datatype named \"%s\")",
                                 func, op->o_name, ddt->name);
             } else {
                 (void) asprintf(msg,
-                                "%s: the reduction operation %s is not defined for non-intrinsic datatypes",
+                                "%s: the reduction operation %s is only defined for non-intrinsic datatypes built from a single intrinsic datatype it supports",
                                 func, op->o_name);
             }
             return false;
@@ -509,6 +536,10 @@ static inline void ompi_op_reduce(ompi_op_t * op, void *source,
 
     /* For intrinsics, we also pass the corresponding op module */
     if (0 != (op->o_flags & OMPI_OP_FLAGS_INTRINSIC)) {
+        if (OPAL_UNLIKELY(!ompi_datatype_is_predefined(dtype))) {
+            ompi_op_reduce_derived(op, source, target, count, dtype);
+            return;
+        }
         op->o_func.intrinsic.fns[ompi_op_ddt_map[dtype->id]](source, target,
                                                              &count, &dtype,
                                                              op->o_func.intrinsic.modules[ompi_op_ddt_map[dtype->id]]);
@@ -19,6 +19,9 @@
 #include "ompi/communicator/communicator.h"
 #include "ompi/file/file.h"
 #include "ompi/win/win.h"
+#if OMPI_WANT_PERUSE
+#include "ompi/peruse/peruse_trace.h"
+#endif
 
 BEGIN_C_DECLS
 
@@ -71,6 +74,11 @@ int ompi_peruse_finalize (void);
 #if OMPI_WANT_PERUSE
 #define PERUSE_TRACE_COMM_EVENT(event, base_req, op)                                   \
 do {                                                                                   \
+    if( OPAL_UNLIKELY(ompi_peruse_trace_enabled) ) {                                   \
+        ompi_peruse_trace_event((event), (base_req)->req_comm, (base_req)->req_peer,   \
+                                (base_req)->req_tag, (base_req)->req_count,            \
+                                (void*)(base_req), (op));                              \
+    }                                                                                  \
     if( NULL != (base_req)->req_comm->c_peruse_handles ) {                             \
         ompi_peruse_handle_t * _ptr = (base_req)->req_comm->c_peruse_handles[(event)]; \
         if (NULL != _ptr && _ptr->active) {                                            \
@@ -89,6 +97,11 @@ do {
 
 #define PERUSE_TRACE_COMM_OMPI_EVENT(event, base_req, size, op)                        \
 do {                                                                                   \
+    if( OPAL_UNLIKELY(ompi_peruse_trace_enabled) ) {                                   \
+        ompi_peruse_trace_event((event), (base_req)->req_comm, (base_req)->req_peer,   \
+                                (base_req)->req_tag, (size),                           \
+                                (void*)(base_req), (op));                              \
+    }                                                                                  \
     if( NULL != (base_req)->req_comm->c_peruse_handles ) {                             \
         ompi_peruse_handle_t * _ptr = (base_req)->req_comm->c_peruse_handles[(event)]; \
         if (NULL != _ptr && _ptr->active) {                                            \
@@ -107,6 +120,10 @@ do {
 
 #define PERUSE_TRACE_MSG_EVENT(event, comm_ptr, hdr_peer, hdr_tag, op)            \
     do {                                                                          \
+        if( OPAL_UNLIKELY(ompi_peruse_trace_enabled) ) {                          \
+            ompi_peruse_trace_event((event), (ompi_communicator_t*) (comm_ptr),   \
+                                    (hdr_peer), (hdr_tag), 0, NULL, (op));        \
+        }                                                                         \
         if( NULL != (comm_ptr)->c_peruse_handles ) {                              \
             ompi_peruse_handle_t * _ptr = (comm_ptr)->c_peruse_handles[(event)];  \
             if (NULL != _ptr && _ptr->active) {                                   \
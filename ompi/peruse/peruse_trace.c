@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "opal/sys/atomic.h"
+#include "opal/util/output.h"
+#include "ompi/constants.h"
+#include "ompi/mca/rte/rte.h"
+#include "ompi/runtime/params.h"
+#include "ompi/runtime/ompi_clock_sync.h"
+#include "ompi/peruse/peruse_trace.h"
+
+bool ompi_peruse_trace_enabled = false;
+opal_tsd_key_t ompi_peruse_trace_key;
+uint64_t ompi_peruse_trace_mask = 0;
+
+/* rings of all the threads, pushed at creation and never unlinked
+   before finalize, so the signal handler can walk them */
+static ompi_peruse_trace_buffer_t * volatile ompi_peruse_trace_buffers = NULL;
+static volatile int32_t ompi_peruse_trace_num_buffers = 0;
+static uint32_t ompi_peruse_trace_rank = 0;
+static char ompi_peruse_trace_path[OPAL_PATH_MAX];
+
+static void ompi_peruse_trace_signal(int signo)
+{
+    int saved_errno = errno;
+
+    (void) ompi_peruse_trace_flush();
+    errno = saved_errno;
+}
+
+int ompi_peruse_trace_init(void)
+{
+    uint64_t size = 1;
+
+    if (NULL == ompi_mpi_peruse_trace || '\0' == ompi_mpi_peruse_trace[0]) {
+        return OMPI_SUCCESS;
+    }
+
+    while (size < (uint64_t) ompi_mpi_peruse_trace_records) {
+        size <<= 1;
+    }
+    ompi_peruse_trace_mask = size - 1;
+
+    ompi_peruse_trace_rank = OMPI_PROC_MY_NAME->vpid;
+    snprintf(ompi_peruse_trace_path, sizeof(ompi_peruse_trace_path), "%s.%u",
+             ompi_mpi_peruse_trace, ompi_peruse_trace_rank);
+
+    if (OPAL_SUCCESS != opal_tsd_key_create(&ompi_peruse_trace_key, NULL)) {
+        return OMPI_ERROR;
+    }
+
+    if (0 < ompi_mpi_peruse_trace_signal) {
+        struct sigaction act;
+
+        memset(&act, 0, sizeof(act));
+        act.sa_handler = ompi_peruse_trace_signal;
+        sigemptyset(&act.sa_mask);
+        act.sa_flags = SA_RESTART;
+        if (0 != sigaction(ompi_mpi_peruse_trace_signal, &act, NULL)) {
+            opal_output(0, "peruse trace: cannot catch signal %d, the trace will only be "
+                        "written at MPI_FINALIZE", ompi_mpi_peruse_trace_signal);
+        }
+    }
+
+    ompi_peruse_trace_enabled = true;
+    return OMPI_SUCCESS;
+}
+
+ompi_peruse_trace_buffer_t *ompi_peruse_trace_buffer_create(void)
+{
+    ompi_peruse_trace_buffer_t *buffer;
+
+    buffer = (ompi_peruse_trace_buffer_t *)
+        malloc(sizeof(ompi_peruse_trace_buffer_t) +
+               ompi_peruse_trace_mask * sizeof(ompi_peruse_trace_record_t));
+    if (NULL == buffer) {
+        return NULL;
+    }
+    buffer->thread = (uint32_t) (opal_atomic_add_32(&ompi_peruse_trace_num_buffers, 1) - 1);
+    buffer->num_written = 0;
+
+    do {
+        buffer->next_buffer = ompi_peruse_trace_buffers;
+    } while (!opal_atomic_cmpset_ptr((void *) &ompi_peruse_trace_buffers,
+                                     buffer->next_buffer, buffer));
+
+    if (OPAL_SUCCESS != opal_tsd_setspecific(ompi_peruse_trace_key, buffer)) {
+        /* still flushed, but the thread will not find it again */
+        return NULL;
+    }
+    return buffer;
+}
+
+/* write(2) the whole buffer, async-signal-safe */
+static int ompi_peruse_trace_write(int fd, const void *data, size_t length)
+{
+    const char *ptr = (const char *) data;
+
+    while (length > 0) {
+        ssize_t ret = write(fd, ptr, length);
+        if (ret < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return OMPI_ERROR;
+        }
+        ptr += ret;
+        length -= (size_t) ret;
+    }
+    return OMPI_SUCCESS;
+}
+
+int ompi_peruse_trace_flush(void)
+{
+    ompi_peruse_trace_header_t header;
+    ompi_peruse_trace_buffer_t *buffer;
+    int fd, i, rc = OMPI_SUCCESS;
+
+    if (!ompi_peruse_trace_enabled) {
+        return OMPI_SUCCESS;
+    }
+
+    fd = open(ompi_peruse_trace_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return OMPI_ERR_FILE_OPEN_FAILURE;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, OMPI_PERUSE_TRACE_MAGIC, sizeof(OMPI_PERUSE_TRACE_MAGIC));
+    header.version = OMPI_PERUSE_TRACE_VERSION;
+    header.rank = ompi_peruse_trace_rank;
+#if OPAL_TIMER_CYCLE_NATIVE
+    header.frequency = (uint64_t) opal_timer_base_get_freq();
+#else
+    header.frequency = 1000000;
+#endif
+    for (i = 0 ; i < ompi_clock_sync_num_points && i < 2 ; ++i) {
+        header.sync_time[i] = ompi_clock_sync_points[i].ticks;
+        header.sync_offset[i] = ompi_clock_sync_points[i].offset;
+    }
+    header.num_syncs = (uint32_t) i;
+    rc = ompi_peruse_trace_write(fd, &header, sizeof(header));
+
+    for (buffer = ompi_peruse_trace_buffers ; OMPI_SUCCESS == rc && NULL != buffer ;
+         buffer = buffer->next_buffer) {
+        uint64_t written = buffer->num_written;
+        uint64_t size = ompi_peruse_trace_mask + 1;
+        ompi_peruse_trace_chunk_t chunk;
+
+        chunk.thread = buffer->thread;
+        chunk.num_records = (uint32_t) (written < size ? written : size);
+        chunk.num_lost = written - chunk.num_records;
+        rc = ompi_peruse_trace_write(fd, &chunk, sizeof(chunk));
+        if (OMPI_SUCCESS != rc || 0 == chunk.num_records) {
+            continue;
+        }
+
+        if (written <= size) {
+            rc = ompi_peruse_trace_write(fd, buffer->records,
+                                         written * sizeof(ompi_peruse_trace_record_t));
+        } else {
+            /* the oldest record is the next one to be overwritten */
+            uint64_t first = written & ompi_peruse_trace_mask;
+            rc = ompi_peruse_trace_write(fd, buffer->records + first,
+                                         (size - first) * sizeof(ompi_peruse_trace_record_t));
+            if (OMPI_SUCCESS == rc) {
+                rc = ompi_peruse_trace_write(fd, buffer->records,
+                                             first * sizeof(ompi_peruse_trace_record_t));
+            }
+        }
+    }
+
+    close(fd);
+    return rc;
+}
+
+int ompi_peruse_trace_finalize(void)
+{
+    ompi_peruse_trace_buffer_t *buffer;
+    int rc;
+
+    if (!ompi_peruse_trace_enabled) {
+        return OMPI_SUCCESS;
+    }
+
+    rc = ompi_peruse_trace_flush();
+    if (OMPI_SUCCESS != rc) {
+        opal_output(0, "peruse trace: cannot write %s", ompi_peruse_trace_path);
+    }
+
+    ompi_peruse_trace_enabled = false;
+    if (0 < ompi_mpi_peruse_trace_signal) {
+        signal(ompi_mpi_peruse_trace_signal, SIG_DFL);
+    }
+
+    while (NULL != (buffer = ompi_peruse_trace_buffers)) {
+        ompi_peruse_trace_buffers = buffer->next_buffer;
+        free(buffer);
+    }
+    return OMPI_SUCCESS;
+}
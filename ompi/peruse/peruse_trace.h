@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Built-in consumer of the PERUSE events.  When mpi_peruse_trace names
+ * a file prefix, every event is stored as a fixed size binary record
+ * into a ring owned by the calling thread (no lock, no atomic: a ring
+ * has a single writer), and the rings are written to <prefix>.<rank>
+ * at MPI_FINALIZE, or when the process receives mpi_peruse_trace_signal.
+ * A ring keeps the last mpi_peruse_trace_records events of its thread.
+ *
+ * File layout, in the byte order of the process:
+ *
+ *   ompi_peruse_trace_header_t
+ *   for each thread that recorded events:
+ *     ompi_peruse_trace_chunk_t
+ *     chunk.num_records ompi_peruse_trace_record_t, oldest first
+ *
+ * Times are in ticks of header.frequency per second, from an arbitrary
+ * origin common to all the threads of the process.  With
+ * mpi_wtime_global, header.num_syncs measurements of the clock of rank 0
+ * line the files up: at tick sync_time[i], sync_offset[i] seconds
+ * added to time / frequency give the clock of rank 0; in between the
+ * offset is interpolated linearly.
+ */
+
+#ifndef OMPI_PERUSE_TRACE_H
+#define OMPI_PERUSE_TRACE_H
+
+#include "ompi_config.h"
+
+#include "opal/threads/tsd.h"
+#include "opal/mca/timer/base/base.h"
+#include "ompi/communicator/communicator.h"
+
+BEGIN_C_DECLS
+
+#define OMPI_PERUSE_TRACE_MAGIC   "OMPITRC"
+#define OMPI_PERUSE_TRACE_VERSION 2
+
+typedef struct ompi_peruse_trace_header_t {
+    char magic[8];              /**< OMPI_PERUSE_TRACE_MAGIC */
+    uint32_t version;           /**< OMPI_PERUSE_TRACE_VERSION */
+    uint32_t rank;              /**< rank in MPI_COMM_WORLD */
+    uint64_t frequency;         /**< ticks per second of the times */
+    uint32_t num_syncs;         /**< clock measurements, at MPI_INIT and MPI_FINALIZE */
+    uint32_t reserved;
+    uint64_t sync_time[2];      /**< tick of each measurement */
+    double sync_offset[2];      /**< seconds to the clock of rank 0 */
+} ompi_peruse_trace_header_t;
+
+typedef struct ompi_peruse_trace_chunk_t {
+    uint32_t thread;            /**< order in which the threads recorded their first event */
+    uint32_t num_records;
+    uint64_t num_lost;          /**< older events overwritten in the ring */
+} ompi_peruse_trace_chunk_t;
+
+typedef struct ompi_peruse_trace_record_t {
+    uint64_t time;
+    uint64_t id;                /**< address of the request, 0 for message events */
+    uint64_t count;             /**< as in peruse_comm_spec_t */
+    uint32_t cid;               /**< context id of the communicator */
+    int32_t event;              /**< PERUSE_COMM_* */
+    int32_t peer;
+    int32_t tag;
+    int32_t operation;          /**< PERUSE_SEND or PERUSE_RECV */
+    int32_t reserved;
+} ompi_peruse_trace_record_t;
+
+typedef struct ompi_peruse_trace_buffer_t {
+    struct ompi_peruse_trace_buffer_t *next_buffer;
+    uint32_t thread;
+    uint64_t num_written;       /**< records ever written, the ring holds the last ones */
+    ompi_peruse_trace_record_t records[1];
+} ompi_peruse_trace_buffer_t;
+
+OMPI_DECLSPEC extern bool ompi_peruse_trace_enabled;
+OMPI_DECLSPEC extern opal_tsd_key_t ompi_peruse_trace_key;
+OMPI_DECLSPEC extern uint64_t ompi_peruse_trace_mask;
+
+int ompi_peruse_trace_init(void);
+int ompi_peruse_trace_finalize(void);
+
+/**
+ * Write the rings to the trace file.  Only uses async-signal-safe calls;
+ * records written while the rings are flushed may come out torn.
+ */
+int ompi_peruse_trace_flush(void);
+
+/**
+ * The ring of the calling thread, created on its first event.
+ */
+OMPI_DECLSPEC ompi_peruse_trace_buffer_t *ompi_peruse_trace_buffer_create(void);
+
+static inline void ompi_peruse_trace_event(int event, ompi_communicator_t *comm,
+                                           int peer, int tag, size_t count,
+                                           void *id, int operation)
+{
+    ompi_peruse_trace_buffer_t *buffer;
+    ompi_peruse_trace_record_t *record;
+
+    if (OPAL_UNLIKELY(OPAL_SUCCESS != opal_tsd_getspecific(ompi_peruse_trace_key, (void **) &buffer) ||
+                      NULL == buffer)) {
+        buffer = ompi_peruse_trace_buffer_create();
+        if (NULL == buffer) {
+            return;
+        }
+    }
+
+    record = &buffer->records[buffer->num_written & ompi_peruse_trace_mask];
+#if OPAL_TIMER_CYCLE_NATIVE
+    record->time = (uint64_t) opal_timer_base_get_cycles();
+#else
+    record->time = (uint64_t) opal_timer_base_get_usec();
+#endif
+    record->id = (uint64_t) (uintptr_t) id;
+    record->count = (uint64_t) count;
+    record->cid = comm->c_contextid;
+    record->event = event;
+    record->peer = peer;
+    record->tag = tag;
+    record->operation = operation;
+    record->reserved = 0;
+    buffer->num_written++;
+}
+
+END_C_DECLS
+
+#endif  /* OMPI_PERUSE_TRACE_H */
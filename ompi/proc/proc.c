@@ -39,6 +39,11 @@ static opal_list_t  ompi_proc_list;
 static opal_mutex_t ompi_proc_lock;
 ompi_proc_t* ompi_proc_local_proc = NULL;
 
+/* The procs of our own job indexed by vpid, so that they can be found
+ * without walking ompi_proc_list.  The entries do not hold a reference. */
+static ompi_proc_t **ompi_proc_world_table = NULL;
+static ompi_vpid_t ompi_proc_world_table_size = 0;
+
 static void ompi_proc_construct(ompi_proc_t* proc);
 static void ompi_proc_destruct(ompi_proc_t* proc);
 
@@ -84,10 +89,30 @@ void ompi_proc_destruct(ompi_proc_t* proc)
      */
     OPAL_THREAD_LOCK(&ompi_proc_lock);
     opal_list_remove_item(&ompi_proc_list, (opal_list_item_t*)proc);
+    if (proc->proc_name.vpid < ompi_proc_world_table_size &&
+        proc == ompi_proc_world_table[proc->proc_name.vpid]) {
+        ompi_proc_world_table[proc->proc_name.vpid] = NULL;
+    }
     OPAL_THREAD_UNLOCK(&ompi_proc_lock);
 }
 
 
+/*
+ * Lookup of a proc of our own job in ompi_proc_world_table.  Returns
+ * NULL for other jobs, in which case the caller searches the list.
+ * Must be called with ompi_proc_lock held.
+ */
+static inline ompi_proc_t *ompi_proc_find_world(const ompi_process_name_t *name)
+{
+    if (name->vpid < ompi_proc_world_table_size &&
+        OPAL_EQUAL == ompi_rte_compare_name_fields(OMPI_RTE_CMP_JOBID, name,
+                                                   OMPI_PROC_MY_NAME)) {
+        return ompi_proc_world_table[name->vpid];
+    }
+    return NULL;
+}
+
+
 int ompi_proc_init(void)
 {
     ompi_vpid_t i;
@@ -96,10 +121,21 @@ int ompi_proc_init(void)
     OBJ_CONSTRUCT(&ompi_proc_list, opal_list_t);
     OBJ_CONSTRUCT(&ompi_proc_lock, opal_mutex_t);
 
+    ompi_proc_world_table = (ompi_proc_t **) calloc(ompi_process_info.num_procs,
+                                                    sizeof(ompi_proc_t *));
+    if (NULL == ompi_proc_world_table) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    ompi_proc_world_table_size = ompi_process_info.num_procs;
+
     /* create proc structures and find self */
     for( i = 0; i < ompi_process_info.num_procs; i++ ) {
         ompi_proc_t *proc = OBJ_NEW(ompi_proc_t);
+        if (NULL == proc) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
         opal_list_append(&ompi_proc_list, (opal_list_item_t*)proc);
+        ompi_proc_world_table[i] = proc;
 
         proc->proc_name.jobid = OMPI_PROC_MY_NAME->jobid;
         proc->proc_name.vpid = i;
@@ -158,6 +194,15 @@ int ompi_proc_complete_init(void)
                 errcode = ret;
                 break;
             }
+#if !OPAL_ENABLE_HETEROGENEOUS_SUPPORT
+            if (ompi_rte_direct_modex) {
+                /* the peers must have our arch anyway - do not fetch
+                 * the entries of every proc just to check it
+                 */
+                proc->proc_arch = opal_local_arch;
+                continue;
+            }
+#endif
             /* get the remote architecture */
             ui32ptr = &(proc->proc_arch);
             ret = ompi_modex_recv_key_value("OMPI_ARCH", proc, (void**)&ui32ptr, OPAL_UINT32);
@@ -215,6 +260,10 @@ int ompi_proc_finalize (void)
     while (opal_list_get_end(&ompi_proc_list) != (item = opal_list_get_first(&ompi_proc_list))) {
         OBJ_RELEASE(item);
     }
+    free(ompi_proc_world_table);
+    ompi_proc_world_table = NULL;
+    ompi_proc_world_table_size = 0;
+
     /* now destruct the list and thread lock */
     OBJ_DESTRUCT(&ompi_proc_list);
     OBJ_DESTRUCT(&ompi_proc_lock);
@@ -237,8 +286,29 @@ ompi_proc_t** ompi_proc_world(size_t *size)
     mask = OMPI_RTE_CMP_JOBID;
     my_name = ompi_proc_local_proc->proc_name;
 
-    /* First count how many match this jobid */
     OPAL_THREAD_LOCK(&ompi_proc_lock);
+
+    /* our job is all in the table, everything else is of no interest */
+    if (NULL != ompi_proc_world_table) {
+        ompi_vpid_t i;
+
+        procs = (ompi_proc_t**) malloc(ompi_proc_world_table_size * sizeof(ompi_proc_t*));
+        if (NULL == procs) {
+            OPAL_THREAD_UNLOCK(&ompi_proc_lock);
+            return NULL;
+        }
+        /* DO NOT RETAIN THESE OBJECTS - see below */
+        for (i = 0; i < ompi_proc_world_table_size; i++) {
+            if (NULL != ompi_proc_world_table[i]) {
+                procs[count++] = ompi_proc_world_table[i];
+            }
+        }
+        OPAL_THREAD_UNLOCK(&ompi_proc_lock);
+        *size = count;
+        return procs;
+    }
+
+    /* First count how many match this jobid */
     for (proc =  (ompi_proc_t*)opal_list_get_first(&ompi_proc_list);
          proc != (ompi_proc_t*)opal_list_get_end(&ompi_proc_list);
          proc =  (ompi_proc_t*)opal_list_get_next(proc)) {
@@ -340,6 +410,11 @@ ompi_proc_t * ompi_proc_find ( const ompi_process_name_t * name )
     /* return the proc-struct which matches this jobid+process id */
     mask = OMPI_RTE_CMP_JOBID | OMPI_RTE_CMP_VPID;
     OPAL_THREAD_LOCK(&ompi_proc_lock);
+    rproc = ompi_proc_find_world(name);
+    if (NULL != rproc) {
+        OPAL_THREAD_UNLOCK(&ompi_proc_lock);
+        return rproc;
+    }
     for(proc =  (ompi_proc_t*)opal_list_get_first(&ompi_proc_list);
         proc != (ompi_proc_t*)opal_list_get_end(&ompi_proc_list);
         proc =  (ompi_proc_t*)opal_list_get_next(proc)) {
@@ -469,8 +544,12 @@ ompi_proc_find_and_add(const ompi_process_name_t * name, bool* isnew)
     /* return the proc-struct which matches this jobid+process id */
     mask = OMPI_RTE_CMP_JOBID | OMPI_RTE_CMP_VPID;
     OPAL_THREAD_LOCK(&ompi_proc_lock);
+    rproc = ompi_proc_find_world(name);
+    if (NULL != rproc) {
+        *isnew = false;
+    }
     for(proc =  (ompi_proc_t*)opal_list_get_first(&ompi_proc_list);
-        proc != (ompi_proc_t*)opal_list_get_end(&ompi_proc_list);
+        NULL == rproc && proc != (ompi_proc_t*)opal_list_get_end(&ompi_proc_list);
         proc =  (ompi_proc_t*)opal_list_get_next(proc)) {
         if (OPAL_EQUAL == ompi_rte_compare_name_fields(mask, &proc->proc_name, name)) {
             rproc = proc;
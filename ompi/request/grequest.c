@@ -19,10 +19,30 @@
  */
 
 #include "ompi_config.h"
+#include "opal/class/opal_list.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/sys/atomic.h"
 #include "ompi/communicator/communicator.h"
 #include "ompi/request/grequest.h"
 #include "ompi/mpi/fortran/base/fint_2_int.h"
 
+/*
+ * Extended generalized requests with a poll function are kept on
+ * ompi_grequest_polled, each holding a reference on its request, until
+ * the poll function completes them.
+ */
+struct ompi_grequest_poll_item_t {
+    opal_list_item_t super;
+    ompi_grequest_t *greq;
+};
+typedef struct ompi_grequest_poll_item_t ompi_grequest_poll_item_t;
+static OBJ_CLASS_INSTANCE(ompi_grequest_poll_item_t, opal_list_item_t, NULL, NULL);
+
+static opal_list_t ompi_grequest_polled;
+static opal_mutex_t ompi_grequest_lock;
+static volatile int32_t ompi_grequest_polling = 0;
+static bool ompi_grequest_registered = false;
+
 
 /*
  * See the comment in the grequest destructor for the weird semantics
@@ -67,6 +87,8 @@ static void ompi_grequest_construct(ompi_grequest_t* greq)
     greq->greq_base.req_cancel   = ompi_grequest_cancel;
     greq->greq_base.req_type = OMPI_REQUEST_GEN;
     greq->greq_base.req_mpi_object.comm = &(ompi_mpi_comm_world.comm);
+    greq->greq_poll = NULL;
+    greq->greq_wait = NULL;
     /* Set the function pointers to C here; the F77 MPI API will
        override this value if the gen request was created from
        Fortran */
@@ -169,6 +191,110 @@ int ompi_grequest_start(
 }
 
 
+/*
+ * Call the poll functions of the pending extended generalized
+ * requests.  The list is taken out of ompi_grequest_polled while the
+ * poll functions run, so that they can start new requests, and a poll
+ * function calling back into MPI (and so into opal_progress) does not
+ * poll recursively.
+ */
+static int ompi_grequest_progress(void)
+{
+    opal_list_t polling;
+    opal_list_item_t *item, *next;
+    ompi_grequest_t *greq;
+    ompi_status_public_t status;
+    int completed = 0;
+
+    if (0 == opal_list_get_size(&ompi_grequest_polled) ||
+        !opal_atomic_cmpset_32(&ompi_grequest_polling, 0, 1)) {
+        return 0;
+    }
+
+    OBJ_CONSTRUCT(&polling, opal_list_t);
+    OPAL_THREAD_LOCK(&ompi_grequest_lock);
+    opal_list_join(&polling, opal_list_get_end(&polling), &ompi_grequest_polled);
+    OPAL_THREAD_UNLOCK(&ompi_grequest_lock);
+
+    for (item = opal_list_get_first(&polling);
+         item != opal_list_get_end(&polling); item = next) {
+        next = opal_list_get_next(item);
+        greq = ((ompi_grequest_poll_item_t*) item)->greq;
+        if (!greq->greq_base.req_complete) {
+            status = ompi_status_empty;
+            greq->greq_poll(greq->greq_state, &status);
+        }
+        if (greq->greq_base.req_complete) {
+            opal_list_remove_item(&polling, item);
+            OBJ_RELEASE(item);
+            OBJ_RELEASE(greq);
+            completed++;
+        }
+    }
+
+    OPAL_THREAD_LOCK(&ompi_grequest_lock);
+    opal_list_join(&ompi_grequest_polled, opal_list_get_end(&ompi_grequest_polled),
+                   &polling);
+    OPAL_THREAD_UNLOCK(&ompi_grequest_lock);
+    OBJ_DESTRUCT(&polling);
+
+    opal_atomic_wmb();
+    ompi_grequest_polling = 0;
+    return completed;
+}
+
+
+int ompi_grequest_start_ext(
+    MPI_Grequest_query_function *gquery_fn,
+    MPI_Grequest_free_function *gfree_fn,
+    MPI_Grequest_cancel_function *gcancel_fn,
+    ompi_grequest_poll_function *gpoll_fn,
+    ompi_grequest_wait_function *gwait_fn,
+    void* gstate,
+    ompi_request_t** request)
+{
+    ompi_grequest_poll_item_t *item;
+    ompi_grequest_t *greq;
+    int rc;
+
+    rc = ompi_grequest_start(gquery_fn, gfree_fn, gcancel_fn, gstate, request);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+    greq = (ompi_grequest_t*) *request;
+    greq->greq_poll = gpoll_fn;
+    greq->greq_wait = gwait_fn;
+    if (NULL == gpoll_fn) {
+        return OMPI_SUCCESS;
+    }
+
+    item = OBJ_NEW(ompi_grequest_poll_item_t);
+    if (NULL == item) {
+        /* drop both references taken by ompi_grequest_start, without
+           calling the free function of a request the user never saw */
+        greq->greq_free.c_free = NULL;
+        OBJ_RELEASE(greq);
+        OBJ_RELEASE(greq);
+        *request = MPI_REQUEST_NULL;
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    /* the poll reference, released once the request completed */
+    OBJ_RETAIN(greq);
+    item->greq = greq;
+
+    OPAL_THREAD_LOCK(&ompi_grequest_lock);
+    opal_list_append(&ompi_grequest_polled, &item->super);
+    /* registered on first use, so that processes without extended
+       generalized requests do not pay for the callback */
+    if (!ompi_grequest_registered) {
+        opal_progress_register(ompi_grequest_progress);
+        ompi_grequest_registered = true;
+    }
+    OPAL_THREAD_UNLOCK(&ompi_grequest_lock);
+    return OMPI_SUCCESS;
+}
+
+
 /*
  * Beware the odd semantics listed in MPI-2:8.2...  See the comment in
  * the grequest destructor.
@@ -227,3 +353,50 @@ int ompi_grequest_invoke_query(ompi_request_t *request,
     return rc;
 }
 
+
+int ompi_grequest_invoke_wait(size_t count, ompi_request_t **requests)
+{
+    ompi_grequest_t *greq;
+    ompi_status_public_t status;
+    size_t i;
+    int waited = 0;
+
+    for (i = 0; i < count; i++) {
+        greq = (ompi_grequest_t*) requests[i];
+        if (NULL == greq || OMPI_REQUEST_GEN != greq->greq_base.req_type ||
+            greq->greq_base.req_complete || NULL == greq->greq_wait) {
+            continue;
+        }
+        status = ompi_status_empty;
+        greq->greq_wait(1, &greq->greq_state, 0.0, &status);
+        waited++;
+    }
+    return waited;
+}
+
+
+int ompi_grequest_init(void)
+{
+    OBJ_CONSTRUCT(&ompi_grequest_polled, opal_list_t);
+    OBJ_CONSTRUCT(&ompi_grequest_lock, opal_mutex_t);
+    return OMPI_SUCCESS;
+}
+
+
+int ompi_grequest_finalize(void)
+{
+    opal_list_item_t *item;
+
+    if (ompi_grequest_registered) {
+        opal_progress_unregister(ompi_grequest_progress);
+        ompi_grequest_registered = false;
+    }
+    /* requests never completed keep their memory, as their free
+       function cannot be called from here */
+    while (NULL != (item = opal_list_remove_first(&ompi_grequest_polled))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&ompi_grequest_lock);
+    OBJ_DESTRUCT(&ompi_grequest_polled);
+    return OMPI_SUCCESS;
+}
@@ -68,6 +68,23 @@ typedef union {
     MPI_F_Grequest_cancel_function* f_cancel;
 } MPI_Grequest_cancel_fct_t;
 
+/**
+ * Poll function of an extended generalized request: called from
+ * opal_progress() until the request completes, it checks on the
+ * operation without blocking and calls MPI_Grequest_complete once it
+ * is done.
+ */
+typedef int (ompi_grequest_poll_function)(void *extra_state, MPI_Status *status);
+
+/**
+ * Wait function of an extended generalized request: called by a
+ * blocking wait, it blocks until the operation of each state completes
+ * (or timeout seconds passed, 0 meaning no limit) and calls
+ * MPI_Grequest_complete on their requests.
+ */
+typedef int (ompi_grequest_wait_function)(int count, void **array_of_states,
+                                          double timeout, MPI_Status *status);
+
 /**
  * Main structure for MPI generalized requests
  */
@@ -76,6 +93,8 @@ struct ompi_grequest_t {
     MPI_Grequest_query_fct_t greq_query;
     MPI_Grequest_free_fct_t greq_free;
     MPI_Grequest_cancel_fct_t greq_cancel;
+    ompi_grequest_poll_function *greq_poll;   /**< extended requests only */
+    ompi_grequest_wait_function *greq_wait;   /**< extended requests only */
     void *greq_state;
     bool greq_funcs_are_c;
 };
@@ -94,6 +113,20 @@ OMPI_DECLSPEC int ompi_grequest_start(
     void* gstate,
     ompi_request_t** request);
 
+/**
+ * Start an extended generalized request, progressed by its poll
+ * function from opal_progress() and by its wait function in blocking
+ * waits (back end for MPIX_Grequest_start).  Either may be NULL.
+ */
+OMPI_DECLSPEC int ompi_grequest_start_ext(
+    MPI_Grequest_query_function *gquery,
+    MPI_Grequest_free_function *gfree,
+    MPI_Grequest_cancel_function *gcancel,
+    ompi_grequest_poll_function *gpoll,
+    ompi_grequest_wait_function *gwait,
+    void* gstate,
+    ompi_request_t** request);
+
 /**
  * Complete a generalized request (back end for MPI_GREQUEST_COMPLETE)
  */
@@ -104,6 +137,22 @@ OMPI_DECLSPEC int ompi_grequest_complete(ompi_request_t *req);
  */
 OMPI_DECLSPEC int ompi_grequest_invoke_query(ompi_request_t *request,
                                              ompi_status_public_t *status);
+
+/**
+ * Block in the wait functions of the pending extended generalized
+ * requests of an array, if they have one.  The caller still waits on
+ * the requests afterwards.
+ *
+ * @return the number of wait functions called
+ */
+OMPI_DECLSPEC int ompi_grequest_invoke_wait(size_t count, ompi_request_t **requests);
+
+/**
+ * Set up and tear down the polling of extended generalized requests
+ * (called from ompi_request_init / ompi_request_finalize)
+ */
+int ompi_grequest_init(void);
+int ompi_grequest_finalize(void);
 END_C_DECLS
 
 #endif
@@ -33,12 +33,88 @@
 static int ompi_progress_thread_count=0;
 #endif
 
+void ompi_request_wait_sync(size_t count, ompi_request_t **requests)
+{
+    ompi_request_wait_sync_some(count, requests, count);
+}
+
+void ompi_request_wait_sync_some(size_t count, ompi_request_t **requests,
+                                 size_t wanted)
+{
+    ompi_wait_sync_t sync;
+    ompi_request_t *request;
+    size_t i, attached;
+
+    OBJ_CONSTRUCT(&sync.lock, opal_mutex_t);
+    OBJ_CONSTRUCT(&sync.cond, opal_condition_t);
+    sync.count = 0;
+    sync.completed = 0;
+    sync.wanted = (int32_t)wanted;
+    sync.failed = false;
+
+    /* Completers account for the sync under its lock, so holding it
+     * while attaching keeps count consistent. A request that completed
+     * before we attached did not see the sync: take it back, unless the
+     * completer beat us to it, in which case it decrements count.
+     * Inactive requests (MPI_REQUEST_NULL, persistent requests not
+     * started) never complete and are left alone. */
+    opal_mutex_lock(&sync.lock);
+    for (i = 0; i < count && sync.completed < sync.wanted; i++) {
+        request = requests[i];
+        if (NULL == request || OMPI_REQUEST_INACTIVE == request->req_state) {
+            continue;
+        }
+        if (true == request->req_complete) {
+            sync.completed++;
+            continue;
+        }
+        if (!opal_atomic_cmpset_ptr(&request->req_wait_sync, NULL, &sync)) {
+            continue;
+        }
+        sync.count++;
+        if (true == request->req_complete &&
+            opal_atomic_cmpset_ptr(&request->req_wait_sync, &sync, NULL)) {
+            sync.count--;
+            sync.completed++;
+        }
+    }
+    attached = i;
+
+    while (sync.count > 0 && sync.completed < sync.wanted && !sync.failed) {
+        opal_condition_wait(&sync.cond, &sync.lock);
+    }
+
+    /* On error, or once enough requests completed, detach from the
+     * requests still pending, then wait for the completers already
+     * holding the sync to let go of it. */
+    if (sync.count > 0) {
+        for (i = 0; i < attached; i++) {
+            request = requests[i];
+            if (NULL != request && &sync == request->req_wait_sync &&
+                opal_atomic_cmpset_ptr(&request->req_wait_sync, &sync, NULL)) {
+                sync.count--;
+            }
+        }
+        while (sync.count > 0) {
+            opal_condition_wait(&sync.cond, &sync.lock);
+        }
+    }
+    opal_mutex_unlock(&sync.lock);
+
+    OBJ_DESTRUCT(&sync.cond);
+    OBJ_DESTRUCT(&sync.lock);
+}
+
+
 int ompi_request_default_wait(
     ompi_request_t ** req_ptr,
     ompi_status_public_t * status)
 {
     ompi_request_t *req = *req_ptr;
 
+    if (OPAL_UNLIKELY(OMPI_REQUEST_GEN == req->req_type)) {
+        ompi_grequest_invoke_wait(1, &req);
+    }
     ompi_request_wait_completion(req);
 
 #if OPAL_ENABLE_FT_CR == 1
@@ -129,6 +205,13 @@ int ompi_request_default_wait_any(
     OPAL_THREAD_ADD32(&ompi_progress_thread_count,-1);
 #endif
 
+    /* sleep on a sync of our own until one of the requests completes,
+     * rather than rescanning the array every time a request of the
+     * process completes. The scan below then finds the completed
+     * request, and only requests another thread waits on still go
+     * through ompi_request_cond. */
+    ompi_request_wait_sync_some(count, requests, 1);
+
     /* give up and sleep until completion */
     OPAL_THREAD_LOCK(&ompi_request_lock);
     ompi_request_waiting++;
@@ -242,6 +325,44 @@ int ompi_request_default_wait_all( size_t count,
         goto finish;
     }
 
+    /* extended generalized requests block in their wait function,
+     * then recount as the loops below expect an accurate count */
+    if (completed != count && ompi_grequest_invoke_wait(count, requests) > 0) {
+        rptr = requests;
+        for (failed = completed = i = 0; i < count; i++) {
+            request = *rptr++;
+            if (request->req_complete == true) {
+                if( OPAL_UNLIKELY( MPI_SUCCESS != request->req_status.MPI_ERROR ) ) {
+                    failed++;
+                }
+                completed++;
+            }
+        }
+        if( failed > 0 ) {
+            goto finish;
+        }
+    }
+
+    /* with threads, block on a sync of our own rather than on the
+     * process-wide condition, then recount: what is left (requests
+     * another thread waits on, or a failure) goes the usual way */
+    if (completed != count && opal_using_threads()) {
+        ompi_request_wait_sync(count, requests);
+        rptr = requests;
+        for (failed = completed = i = 0; i < count; i++) {
+            request = *rptr++;
+            if (request->req_complete == true) {
+                if( OPAL_UNLIKELY( MPI_SUCCESS != request->req_status.MPI_ERROR ) ) {
+                    failed++;
+                }
+                completed++;
+            }
+        }
+        if( failed > 0 ) {
+            goto finish;
+        }
+    }
+
     /* if all requests have not completed -- defer acquiring lock
      * unless required
      */
@@ -492,6 +613,10 @@ int ompi_request_default_wait_some(
     OPAL_THREAD_ADD32(&ompi_progress_thread_count,-1);
 #endif
 
+    /* as in wait_any, sleep on a sync of our own until the first
+     * request of the array completes */
+    ompi_request_wait_sync_some(count, requests, 1);
+
     /*
      * We only get here when outcount still is 0.
      * give up and sleep until completion
@@ -26,6 +26,7 @@
 #include "opal/class/opal_object.h"
 #include "ompi/request/request.h"
 #include "ompi/request/request_default.h"
+#include "ompi/request/grequest.h"
 #include "ompi/constants.h"
 
 opal_pointer_array_t             ompi_request_f_to_c_table;
@@ -54,6 +55,7 @@ static void ompi_request_construct(ompi_request_t* req)
     OMPI_REQUEST_INIT(req, false);
     req->req_free         = NULL;
     req->req_cancel       = NULL;
+    req->req_start        = NULL;
     req->req_complete_cb  = NULL;
     req->req_complete_cb_data = NULL;
     req->req_f_to_c_index = MPI_UNDEFINED;
@@ -103,6 +105,7 @@ int ompi_request_init(void)
 {
     OBJ_CONSTRUCT(&ompi_request_lock, opal_mutex_t);
     OBJ_CONSTRUCT(&ompi_request_cond, opal_condition_t);
+    ompi_grequest_init();
 
     OBJ_CONSTRUCT(&ompi_request_null, ompi_request_t);
     OBJ_CONSTRUCT(&ompi_request_f_to_c_table, opal_pointer_array_t);
@@ -174,6 +177,7 @@ int ompi_request_init(void)
 
 int ompi_request_finalize(void)
 {
+    ompi_grequest_finalize();
     OMPI_REQUEST_FINI( &ompi_request_null.request );
     OBJ_DESTRUCT( &ompi_request_null.request );
     OMPI_REQUEST_FINI( &ompi_request_empty );
@@ -69,6 +69,12 @@ typedef int (*ompi_request_cancel_fn_t)(struct ompi_request_t* request, int flag
  */
 typedef int (*ompi_request_complete_fn_t)(struct ompi_request_t* request);
 
+/*
+ * Function to start persistent requests that are not PML requests
+ * (e.g. persistent collectives), called by MPI_Start and MPI_Startall.
+ */
+typedef int (*ompi_request_start_fn_t)(size_t count, struct ompi_request_t** requests);
+
 /**
  * Forward declaration
  */
@@ -106,9 +112,11 @@ struct ompi_request_t {
     int req_f_to_c_index;                       /**< Index in Fortran <-> C translation array */
     ompi_request_free_fn_t req_free;            /**< Called by free */
     ompi_request_cancel_fn_t req_cancel;        /**< Optional function to cancel the request */
+    ompi_request_start_fn_t req_start;          /**< Starts a persistent request not owned by the PML */
     ompi_request_complete_fn_t req_complete_cb; /**< Called when the request is MPI completed */
     void *req_complete_cb_data;
     ompi_mpi_object_t req_mpi_object;           /**< Pointer to MPI object that created this request */
+    struct ompi_wait_sync_t * volatile req_wait_sync; /**< Thread blocked on this request, if any */
 };
 
 /**
@@ -130,6 +138,22 @@ struct ompi_predefined_request_t {
 
 typedef struct ompi_predefined_request_t ompi_predefined_request_t;
 
+/**
+ * Per-wait synchronization object. A thread blocking on a set of
+ * requests hangs one of these off each pending request, and the
+ * completion of such a request only wakes this thread, instead of
+ * broadcasting ompi_request_cond to every waiter of the process.
+ */
+struct ompi_wait_sync_t {
+    int32_t count;              /**< Attached requests not yet completed */
+    int32_t completed;          /**< Requests of the set seen completed */
+    int32_t wanted;             /**< Completions the waiter needs */
+    bool failed;                /**< One of them completed in error */
+    opal_mutex_t lock;          /**< Protects the fields above */
+    opal_condition_t cond;      /**< Signaled when count drops to 0, wanted is reached or on error */
+};
+typedef struct ompi_wait_sync_t ompi_wait_sync_t;
+
 /**
  * Initialize a request.  This is a macro to avoid function call
  * overhead, since this is typically invoked in the critical
@@ -141,6 +165,7 @@ typedef struct ompi_predefined_request_t ompi_predefined_request_t;
         (request)->req_complete = false;              \
         (request)->req_state = OMPI_REQUEST_INACTIVE; \
         (request)->req_persistent = (persistent);     \
+        (request)->req_wait_sync = NULL;              \
     } while (0); 
 
 /**
@@ -333,6 +358,24 @@ OMPI_DECLSPEC int ompi_request_persistent_proc_null_free(ompi_request_t **reques
  */
 int ompi_request_finalize(void);
 
+/**
+ * Block the calling thread until all the requests of the array that
+ * are pending and not already waited on by another thread complete,
+ * or one of them fails. The caller still has to check the requests
+ * afterwards.
+ */
+OMPI_DECLSPEC void ompi_request_wait_sync(size_t count, ompi_request_t **requests);
+
+/**
+ * Same as ompi_request_wait_sync, but return as soon as wanted
+ * requests of the array are complete (MPI_Waitany, MPI_Waitsome).
+ * Only the completions of the array wake the caller, so the array is
+ * walked once to attach the sync and once to detach it, however many
+ * other requests of the process complete in between.
+ */
+OMPI_DECLSPEC void ompi_request_wait_sync_some(size_t count, ompi_request_t **requests,
+                                               size_t wanted);
+
 /**
  * Cancel a pending request.
  */
@@ -375,6 +418,26 @@ static inline void ompi_request_wait_completion(ompi_request_t *req)
             return;
         }
 #endif
+#if OPAL_ENABLE_MULTI_THREADS
+        if (opal_progress_thread_active) {
+            /* The progress thread completes the request for us: poll
+               the flag for a while without taking ompi_request_lock,
+               and only fall back to the condition if that fails. */
+            int c;
+            for (c = 0; c < opal_progress_spin_count; ++c) {
+                if (true == req->req_complete) {
+                    opal_atomic_rmb();
+                    return;
+                }
+            }
+        }
+#endif
+        if (opal_using_threads()) {
+            ompi_request_wait_sync(1, &req);
+            if (true == req->req_complete) {
+                return;
+            }
+        }
         OPAL_THREAD_LOCK(&ompi_request_lock);
         ompi_request_waiting++;
         while(false == req->req_complete) {
@@ -385,6 +448,34 @@ static inline void ompi_request_wait_completion(ompi_request_t *req)
     }
 }
 
+/**
+ * Wake the thread blocked on the request in ompi_request_wait_sync, if
+ * any. The sync is detached with a compare-and-swap so that exactly one
+ * of the completer and a waiter giving up on it accounts for it.
+ */
+static inline void ompi_request_signal_sync(ompi_request_t *request)
+{
+    ompi_wait_sync_t *sync;
+
+    /* order the store to req_complete before the load of the sync */
+    opal_atomic_mb();
+    sync = request->req_wait_sync;
+    if (OPAL_LIKELY(NULL == sync) ||
+        !opal_atomic_cmpset_ptr(&request->req_wait_sync, sync, NULL)) {
+        return;
+    }
+    opal_mutex_lock(&sync->lock);
+    if (OPAL_UNLIKELY(MPI_SUCCESS != request->req_status.MPI_ERROR)) {
+        sync->failed = true;
+    }
+    sync->count--;
+    sync->completed++;
+    if (0 == sync->count || sync->completed >= sync->wanted || sync->failed) {
+        opal_condition_signal(&sync->cond);
+    }
+    opal_mutex_unlock(&sync->lock);
+}
+
 /**
  *  Signal or mark a request as complete. If with_signal is true this will
  *  wake any thread pending on the request and ompi_request_lock should be
@@ -406,6 +497,11 @@ static inline int ompi_request_complete(ompi_request_t* request, bool with_signa
     if( OPAL_UNLIKELY(MPI_SUCCESS != request->req_status.MPI_ERROR) ) {
         ompi_request_failed++;
     }
+    /* without threads nobody can attach concurrently, so the sync
+       only has to be looked at when one is there */
+    if (opal_using_threads() || OPAL_UNLIKELY(NULL != request->req_wait_sync)) {
+        ompi_request_signal_sync(request);
+    }
     if(with_signal && ompi_request_waiting) {
         /* Broadcast the condition, otherwise if there is already a thread
          * waiting on another request it can use all signals.
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "opal/dss/dss.h"
+#include "ompi/constants.h"
+#include "ompi/mca/rte/rte.h"
+#include "ompi/proc/proc.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/runtime/params.h"
+#include "ompi/runtime/ompi_clock_sync.h"
+
+bool ompi_clock_sync_active = false;
+ompi_clock_sync_point_t ompi_clock_sync_points[2];
+int ompi_clock_sync_num_points = 0;
+
+static bool clock_sync_serving = false;
+
+static int64_t clock_sync_usec(void)
+{
+    return (int64_t) (ompi_clock_local() * 1000000.0);
+}
+
+static void clock_sync_send_cb(int status, ompi_process_name_t *peer,
+                               opal_buffer_t *buffer, ompi_rml_tag_t tag,
+                               void *cbdata)
+{
+    OBJ_RELEASE(buffer);
+}
+
+/* rank 0 answers every ping with its clock, read as soon as possible */
+static void clock_sync_ping_cb(int status, ompi_process_name_t *peer,
+                               opal_buffer_t *buffer, ompi_rml_tag_t tag,
+                               void *cbdata)
+{
+    int64_t now = clock_sync_usec();
+    opal_buffer_t *reply;
+
+    reply = OBJ_NEW(opal_buffer_t);
+    if (NULL == reply) {
+        return;
+    }
+    if (OPAL_SUCCESS != opal_dss.pack(reply, &now, 1, OPAL_INT64) ||
+        OMPI_SUCCESS != ompi_rte_send_buffer_nb(peer, reply, OMPI_RML_TAG_CLOCK_SYNC, 0,
+                                                clock_sync_send_cb, NULL)) {
+        OBJ_RELEASE(reply);
+    }
+}
+
+/* offset to rank 0 in usec, from the ping of smallest round trip */
+static int clock_sync_measure(ompi_process_name_t *root, int64_t *offset)
+{
+    int64_t best = -1, t0, t1, remote;
+    int32_t n;
+    int round, rc;
+
+    for (round = 0 ; round < ompi_mpi_wtime_sync_rounds ; ++round) {
+        opal_buffer_t ping, pong;
+
+        OBJ_CONSTRUCT(&ping, opal_buffer_t);
+        OBJ_CONSTRUCT(&pong, opal_buffer_t);
+        rc = opal_dss.pack(&ping, &round, 1, OPAL_INT);
+        t0 = clock_sync_usec();
+        if (OPAL_SUCCESS == rc) {
+            rc = ompi_rte_send_buffer(root, &ping, OMPI_RML_TAG_CLOCK_SYNC, 0);
+        }
+        if (0 <= rc) {
+            rc = ompi_rte_recv_buffer(root, &pong, OMPI_RML_TAG_CLOCK_SYNC, 0);
+        }
+        t1 = clock_sync_usec();
+        n = 1;
+        if (0 <= rc) {
+            rc = opal_dss.unpack(&pong, &remote, &n, OPAL_INT64);
+        }
+        OBJ_DESTRUCT(&ping);
+        OBJ_DESTRUCT(&pong);
+        if (0 > rc) {
+            return rc;
+        }
+
+        /* the clock of rank 0 was read half way, more or less the
+           asymmetry of the path, which the shortest trip bounds best */
+        if (best < 0 || t1 - t0 < best) {
+            best = t1 - t0;
+            *offset = remote - (t0 + t1) / 2;
+        }
+    }
+    return OMPI_SUCCESS;
+}
+
+/* the processes of the node share the measurement of the first one */
+static int clock_sync_measure_node(void)
+{
+    ompi_proc_t **procs, *leader = NULL;
+    ompi_process_name_t root = *OMPI_PROC_MY_NAME;
+    ompi_proc_t *me = ompi_proc_local();
+    int64_t offset = 0;
+    size_t i, nprocs;
+    int rc = OMPI_SUCCESS;
+
+    procs = ompi_proc_world(&nprocs);
+    if (NULL == procs) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for (i = 0 ; i < nprocs ; ++i) {
+        if ((procs[i] == me || OPAL_PROC_ON_LOCAL_NODE(procs[i]->proc_flags)) &&
+            (NULL == leader || procs[i]->proc_name.vpid < leader->proc_name.vpid)) {
+            leader = procs[i];
+        }
+    }
+
+    if (leader == me) {
+        /* rank 0 is the reference */
+        if (0 != me->proc_name.vpid) {
+            root.vpid = 0;
+            rc = clock_sync_measure(&root, &offset);
+        }
+        for (i = 0 ; OMPI_SUCCESS == rc && i < nprocs ; ++i) {
+            opal_buffer_t buf;
+
+            if (procs[i] == me || !OPAL_PROC_ON_LOCAL_NODE(procs[i]->proc_flags)) {
+                continue;
+            }
+            OBJ_CONSTRUCT(&buf, opal_buffer_t);
+            rc = opal_dss.pack(&buf, &offset, 1, OPAL_INT64);
+            if (OPAL_SUCCESS == rc) {
+                rc = ompi_rte_send_buffer(&procs[i]->proc_name, &buf, OMPI_RML_TAG_CLOCK_SYNC, 0);
+                rc = (0 > rc) ? rc : OMPI_SUCCESS;
+            }
+            OBJ_DESTRUCT(&buf);
+        }
+    } else {
+        opal_buffer_t buf;
+        int32_t n = 1;
+
+        OBJ_CONSTRUCT(&buf, opal_buffer_t);
+        rc = ompi_rte_recv_buffer(&leader->proc_name, &buf, OMPI_RML_TAG_CLOCK_SYNC, 0);
+        if (0 <= rc) {
+            rc = opal_dss.unpack(&buf, &offset, &n, OPAL_INT64);
+        }
+        OBJ_DESTRUCT(&buf);
+    }
+    free(procs);
+
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+#if OPAL_TIMER_CYCLE_NATIVE
+    ompi_clock_sync_points[ompi_clock_sync_num_points].ticks = (uint64_t) opal_timer_base_get_cycles();
+#else
+    ompi_clock_sync_points[ompi_clock_sync_num_points].ticks = (uint64_t) opal_timer_base_get_usec();
+#endif
+    ompi_clock_sync_points[ompi_clock_sync_num_points].local = ompi_clock_local();
+    ompi_clock_sync_points[ompi_clock_sync_num_points].offset = (double) offset / 1000000.0;
+    ompi_clock_sync_num_points++;
+    return OMPI_SUCCESS;
+}
+
+int ompi_clock_sync_init(void)
+{
+    ompi_communicator_t *comm = &ompi_mpi_comm_world.comm;
+    int rc;
+
+    if (!ompi_mpi_wtime_global) {
+        return OMPI_SUCCESS;
+    }
+
+    ompi_clock_sync_num_points = 0;
+    if (0 == OMPI_PROC_MY_NAME->vpid) {
+        rc = ompi_rte_recv_buffer_nb(OMPI_NAME_WILDCARD, OMPI_RML_TAG_CLOCK_SYNC,
+                                     OMPI_RML_PERSISTENT, clock_sync_ping_cb, NULL);
+        if (OMPI_SUCCESS != rc) {
+            return rc;
+        }
+        clock_sync_serving = true;
+    }
+
+    rc = clock_sync_measure_node();
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+    /* rank 0 serves the pings while it waits */
+    rc = comm->c_coll.coll_barrier(comm, comm->c_coll.coll_barrier_module);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    ompi_clock_sync_active = true;
+    return OMPI_SUCCESS;
+}
+
+int ompi_clock_sync_finalize(void)
+{
+    if (!ompi_clock_sync_active) {
+        return OMPI_SUCCESS;
+    }
+    return clock_sync_measure_node();
+}
+
+void ompi_clock_sync_release(void)
+{
+    if (clock_sync_serving) {
+        (void) ompi_rte_recv_cancel(OMPI_NAME_WILDCARD, OMPI_RML_TAG_CLOCK_SYNC);
+        clock_sync_serving = false;
+    }
+}
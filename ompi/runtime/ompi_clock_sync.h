@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Offset of the local clock to the one of rank 0 of MPI_COMM_WORLD, for
+ * a globally consistent MPI_Wtime (mpi_wtime_global).  At MPI_INIT the
+ * first process of every node ping-pongs with rank 0 over the RTE and
+ * keeps the sample of smallest round trip, then hands the offset to the
+ * other processes of its node, which read the same clock.  The same
+ * measurement at MPI_FINALIZE gives the drift over the run, for the
+ * tools that line up the timelines afterwards: MPI_Wtime itself only
+ * applies the offset measured at MPI_INIT.
+ */
+
+#ifndef OMPI_CLOCK_SYNC_H
+#define OMPI_CLOCK_SYNC_H
+
+#include "ompi_config.h"
+
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#include "opal/mca/timer/base/base.h"
+
+BEGIN_C_DECLS
+
+/**
+ * One measurement: the local clock when it was taken, and what to add
+ * to the local clock to get the one of rank 0, both in seconds.
+ */
+typedef struct ompi_clock_sync_point_t {
+    double local;
+    double offset;
+    uint64_t ticks;             /**< timer cycles at the measurement (usec without
+                                     a cycle counter), the unit of the PERUSE trace */
+} ompi_clock_sync_point_t;
+
+/** set once the offset of MPI_INIT is known */
+OMPI_DECLSPEC extern bool ompi_clock_sync_active;
+/** the measurements of MPI_INIT and MPI_FINALIZE */
+OMPI_DECLSPEC extern ompi_clock_sync_point_t ompi_clock_sync_points[2];
+OMPI_DECLSPEC extern int ompi_clock_sync_num_points;
+
+/**
+ * The local clock, in seconds from an arbitrary origin.
+ */
+static inline double ompi_clock_local(void)
+{
+#if OPAL_TIMER_USEC_SUPPORTED
+    return (double) opal_timer_base_get_usec() / 1000000.0;
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (double) tv.tv_sec + (double) tv.tv_usec / 1000000.0;
+#endif
+}
+
+/**
+ * The clock of rank 0 of MPI_COMM_WORLD, as measured at MPI_INIT.
+ */
+static inline double ompi_clock_global(void)
+{
+    return ompi_clock_local() + ompi_clock_sync_points[0].offset;
+}
+
+/**
+ * Measure the offset to rank 0, collective over MPI_COMM_WORLD.
+ * Nothing to do unless mpi_wtime_global is set.
+ */
+int ompi_clock_sync_init(void);
+
+/**
+ * Measure the offset again before the final barrier, which keeps rank 0
+ * answering until the other nodes are done.
+ */
+int ompi_clock_sync_finalize(void);
+
+/**
+ * Stop answering the other nodes, after the final barrier.
+ */
+void ompi_clock_sync_release(void);
+
+END_C_DECLS
+
+#endif /* OMPI_CLOCK_SYNC_H */
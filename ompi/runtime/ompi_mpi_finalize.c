@@ -60,6 +60,7 @@
 #include "ompi/attribute/attribute.h"
 #include "ompi/mca/pml/pml.h"
 #include "ompi/mca/pml/base/base.h"
+#include "ompi/mca/btl/base/base.h"
 #include "ompi/mca/osc/base/base.h"
 #include "ompi/mca/coll/base/base.h"
 #include "ompi/mca/rte/rte.h"
@@ -74,21 +75,23 @@
 #include "ompi/mca/dpm/base/base.h"
 #include "ompi/mca/pubsub/base/base.h"
 #include "ompi/mpiext/mpiext.h"
+#if OMPI_WANT_PERUSE
+#include "ompi/peruse/peruse_trace.h"
+#endif
 
 #if OPAL_ENABLE_FT_CR == 1
 #include "ompi/mca/crcp/crcp.h"
 #include "ompi/mca/crcp/base/base.h"
 #endif
 #include "ompi/runtime/ompi_cr.h"
-
-extern bool ompi_enable_timing;
+#include "ompi/runtime/ompi_clock_sync.h"
+#include "ompi/runtime/ompi_mpi_timing.h"
 
 int ompi_mpi_finalize(void)
 {
     int ret;
     static int32_t finalize_has_already_started = 0;
     opal_list_item_t *item;
-    struct timeval ompistart, ompistop;
     ompi_rte_collective_t *coll;
 
     /* Be a bit social if an erroneous program calls MPI_FINALIZE in
@@ -109,6 +112,7 @@ int ompi_mpi_finalize(void)
                        true, hostname, pid);
         return MPI_ERR_OTHER;
     }
+    ompi_mpi_timing_start("ompi_mpi_finalize");
 
     ompi_mpiext_fini();
 
@@ -128,10 +132,15 @@ int ompi_mpi_finalize(void)
         ompi_mpi_comm_self.comm.c_keyhash = NULL;
     }
 
+    ompi_mpi_timing_mark("mpiext+comm_self");
+
     /* Proceed with MPI_FINALIZE */
 
     ompi_mpi_finalized = true;
 
+    /* the rest of finalize progresses from this thread */
+    opal_progress_thread_stop();
+
 #if OMPI_ENABLE_PROGRESS_THREADS == 0
     opal_progress_set_event_flag(OPAL_EVLOOP_ONCE | OPAL_EVLOOP_NONBLOCK);
 #endif
@@ -139,11 +148,7 @@ int ompi_mpi_finalize(void)
     /* Redo ORTE calling opal_progress_event_users_increment() during
        MPI lifetime, to get better latency when not using TCP */
     opal_progress_event_users_increment();
-
-    /* check to see if we want timing information */
-    if (ompi_enable_timing != 0 && 0 == OMPI_PROC_MY_NAME->vpid) {
-        gettimeofday(&ompistart, NULL);
-    }
+    ompi_mpi_timing_mark("progress thread stop");
 
     /* NOTE: MPI-2.1 requires that MPI_FINALIZE is "collective" across
        *all* connected processes.  This only means that all processes
@@ -200,32 +205,47 @@ int ompi_mpi_finalize(void)
       have many other, much higher priority issues to handle that deal
       with non-erroneous cases. */
 
-    /* wait for everyone to reach this point
-       This is a grpcomm barrier instead of an MPI barrier because an
-       MPI barrier doesn't ensure that all messages have been transmitted
-       before exiting, so the possibility of a stranded message exists.
-    */
-    coll = OBJ_NEW(ompi_rte_collective_t);
-    coll->id = ompi_process_info.peer_fini_barrier;
-    if (OMPI_SUCCESS != (ret = ompi_rte_barrier(coll))) {
-        OMPI_ERROR_LOG(ret);
-        return ret;
-    }
-
-    /* wait for barrier to complete */
-    while (coll->active) {
-        opal_progress();  /* block in progress pending events */
-    }
-    OBJ_RELEASE(coll);
+    /* the drift of the clock since MPI_INIT, rank 0 answers during the
+       barrier below */
+    (void) ompi_clock_sync_finalize();
+    ompi_mpi_timing_mark("clock sync");
+
+    /* the phases so far are reduced across MPI_COMM_WORLD while the
+       PML still runs; everyone is done with the reduction when they
+       leave the barrier below */
+    ompi_mpi_timing_report(true);
+
+    if (ompi_mpi_finalize_quiesce && !ompi_clock_sync_active) {
+        /* all the messages of this process have been transmitted once
+           its BTLs have nothing left in flight: the peers that still
+           have to receive them are progressing towards their own
+           finalize, and the runtime learns about the end of the job
+           from the exit of every process, not from a barrier */
+        while (OMPI_SUCCESS != mca_btl_base_quiesce()) {
+            opal_progress();
+        }
+        ompi_mpi_timing_mark("btl quiesce");
+    } else {
+        /* wait for everyone to reach this point
+           This is a grpcomm barrier instead of an MPI barrier because an
+           MPI barrier doesn't ensure that all messages have been transmitted
+           before exiting, so the possibility of a stranded message exists.
+           Rank 0 answers the clock sync requests until the barrier.
+        */
+        coll = OBJ_NEW(ompi_rte_collective_t);
+        coll->id = ompi_process_info.peer_fini_barrier;
+        if (OMPI_SUCCESS != (ret = ompi_rte_barrier(coll))) {
+            OMPI_ERROR_LOG(ret);
+            return ret;
+        }
 
-    /* check for timing request - get stop time and report elapsed
-     time if so */
-    if (ompi_enable_timing && 0 == OMPI_PROC_MY_NAME->vpid) {
-        gettimeofday(&ompistop, NULL);
-        opal_output(0, "ompi_mpi_finalize[%ld]: time to execute barrier %ld usec",
-                    (long)OMPI_PROC_MY_NAME->vpid,
-                    (long int)((ompistop.tv_sec - ompistart.tv_sec)*1000000 +
-                               (ompistop.tv_usec - ompistart.tv_usec)));
+        /* wait for barrier to complete */
+        while (coll->active) {
+            opal_progress();  /* block in progress pending events */
+        }
+        OBJ_RELEASE(coll);
+        ompi_clock_sync_release();
+        ompi_mpi_timing_mark("fini barrier");
     }
 
     /*
@@ -270,10 +290,18 @@ int ompi_mpi_finalize(void)
         return ret;
     }
 
+#if OMPI_WANT_PERUSE
+    /* write the trace of the PERUSE events, all the communication is done */
+    (void) ompi_peruse_trace_finalize();
+#endif
+
+    ompi_mpi_timing_mark("file+win+osc finalize");
+
     /* free pml resource */ 
     if(OMPI_SUCCESS != (ret = mca_pml_base_finalize())) { 
       return ret;
     }
+    ompi_mpi_timing_mark("pml finalize");
     /* free communicator resources */
     if (OMPI_SUCCESS != (ret = ompi_comm_finalize())) {
         return ret;
@@ -287,6 +315,7 @@ int ompi_mpi_finalize(void)
     if (OMPI_SUCCESS != (ret = ompi_message_finalize())) {
         return ret;
     }
+    ompi_mpi_timing_mark("comm+request finalize");
 
     /* If requested, print out a list of memory allocated by ALLOC_MEM
        but not freed by FREE_MEM */
@@ -303,6 +332,7 @@ int ompi_mpi_finalize(void)
 
     /* shut down buffered send code */
     mca_pml_base_bsend_fini();
+    ompi_mpi_timing_mark("pml close");
 
 #if OPAL_ENABLE_FT_CR == 1
     /*
@@ -372,6 +402,7 @@ int ompi_mpi_finalize(void)
     if (OMPI_SUCCESS != (ret = ompi_info_finalize())) {
         return ret;
     }
+    ompi_mpi_timing_mark("mpi handles finalize");
 
     /* Close down MCA modules */
 
@@ -398,6 +429,10 @@ int ompi_mpi_finalize(void)
     if (OMPI_SUCCESS != (ret = mca_base_framework_close(&ompi_rcache_base_framework))) {
         return ret;
     }
+    ompi_mpi_timing_mark("frameworks close");
+
+    /* only rank 0 can still tell its own */
+    ompi_mpi_timing_report(false);
 
     /* Leave the RTE */
 
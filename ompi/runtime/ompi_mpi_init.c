@@ -40,6 +40,7 @@
 #include "opal/mca/base/base.h"
 #include "opal/mca/hwloc/base/base.h"
 #include "opal/runtime/opal_progress.h"
+#include "opal/runtime/opal_params.h"
 #include "opal/threads/threads.h"
 #include "opal/util/arch.h"
 #include "opal/util/argv.h"
@@ -83,12 +84,17 @@
 #include "ompi/mca/dpm/base/base.h"
 #include "ompi/mca/pubsub/base/base.h"
 #include "ompi/mpiext/mpiext.h"
+#if OMPI_WANT_PERUSE
+#include "ompi/peruse/peruse_trace.h"
+#endif
 
 #if OPAL_ENABLE_FT_CR == 1
 #include "ompi/mca/crcp/crcp.h"
 #include "ompi/mca/crcp/base/base.h"
 #endif
 #include "ompi/runtime/ompi_cr.h"
+#include "ompi/runtime/ompi_mpi_timing.h"
+#include "ompi/runtime/ompi_clock_sync.h"
 
 #if defined(MEMORY_LINUX_PTMALLOC2) && MEMORY_LINUX_PTMALLOC2
 #include "opal/mca/memory/linux/memory_linux.h"
@@ -359,10 +365,10 @@ static int ompi_register_mca_variables(void)
     /* check to see if we want timing information */
     ompi_enable_timing = false;
     (void) mca_base_var_register("ompi", "ompi", NULL, "timing",
-                                 "Request that critical timing loops be measured",
+                                 "Request that critical timing loops be measured: MPI_INIT and MPI_FINALIZE report the time spent in each of their phases (min, mean and max across MPI_COMM_WORLD)",
                                  MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
                                  OPAL_INFO_LVL_9,
-                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 MCA_BASE_VAR_SCOPE_ALL_EQ,
                                  &ompi_enable_timing);
 
     return OMPI_SUCCESS;
@@ -374,7 +380,6 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
     ompi_proc_t** procs;
     size_t nprocs;
     char *error = NULL;
-    struct timeval ompistart, ompistop;
     bool rte_setup = false;
     ompi_rte_collective_t *coll;
     char *cmd=NULL, *av=NULL;
@@ -387,6 +392,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
        something sorta similar in a static local variable in
        ompi_mpi_finalize(). */
     ompi_mpi_init_started = true;
+    ompi_mpi_timing_start("ompi_mpi_init");
 
     /* Setup enough to check get/set MCA params */
 
@@ -431,10 +437,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
            side-effects with launching RTE tools... */
         mca_base_var_set_value(ret, allvalue, 4, MCA_BASE_VAR_SOURCE_DEFAULT, NULL);
     }
-
-    if (ompi_enable_timing && 0 == OMPI_PROC_MY_NAME->vpid) {
-        gettimeofday(&ompistart, NULL);
-    }
+    ompi_mpi_timing_mark("opal_init_util");
 
     /* if we were not externally started, then we need to setup
      * some envars so the MPI_INFO_ENV can get the cmd name
@@ -459,16 +462,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         goto error;
     }
     rte_setup = true;
-    
-    /* check for timing request - get stop time and report elapsed time if so */
-    if (ompi_enable_timing && 0 == OMPI_PROC_MY_NAME->vpid) {
-        gettimeofday(&ompistop, NULL);
-        opal_output(0, "ompi_mpi_init [%ld]: time from start to completion of rte_init %ld usec",
-                    (long)OMPI_PROC_MY_NAME->vpid,
-                    (long int)((ompistop.tv_sec - ompistart.tv_sec)*1000000 +
-                               (ompistop.tv_usec - ompistart.tv_usec)));
-        gettimeofday(&ompistart, NULL);
-    }
+    ompi_mpi_timing_mark("rte_init");
 
 #if OPAL_HAVE_HWLOC
     /* if hwloc is available but didn't get setup for some
@@ -519,6 +513,15 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "mca_proc_init() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("datatype+proc init");
+
+#if OMPI_WANT_PERUSE
+    /* the built-in tracer of the PERUSE events */
+    if (OMPI_SUCCESS != (ret = ompi_peruse_trace_init())) {
+        error = "ompi_peruse_trace_init() failed";
+        goto error;
+    }
+#endif
 
     /* Initialize the op framework. This has to be done *after*
        ddt_init, but befor mca_coll_base_open, since some collective
@@ -538,6 +541,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "ompi_op_init() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("op open+select");
 
     /* Open up MPI-related MCA components */
 
@@ -545,27 +549,33 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "mca_allocator_base_open() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("allocator open");
     if (OMPI_SUCCESS != (ret = mca_base_framework_open(&ompi_rcache_base_framework, 0))) {
         error = "mca_rcache_base_open() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("rcache open");
     if (OMPI_SUCCESS != (ret = mca_base_framework_open(&ompi_mpool_base_framework, 0))) {
         error = "mca_mpool_base_open() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("mpool open");
     if (OMPI_SUCCESS != (ret = mca_base_framework_open(&ompi_pml_base_framework, 0))) {
         error = "mca_pml_base_open() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("pml open");
     if (OMPI_SUCCESS != (ret = mca_base_framework_open(&ompi_coll_base_framework, 0))) {
         error = "mca_coll_base_open() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("coll open");
 
     if (OMPI_SUCCESS != (ret = mca_base_framework_open(&ompi_osc_base_framework, 0))) {
         error = "ompi_osc_base_open() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("osc open");
 
 #if OPAL_ENABLE_FT_CR == 1
     if (OMPI_SUCCESS != (ret = mca_base_framework_open(&ompi_crcp_base_framework, 0))) {
@@ -588,6 +598,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "mca_mpool_base_init() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("mpool select");
 
     if (OMPI_SUCCESS != 
         (ret = mca_pml_base_select(OMPI_ENABLE_PROGRESS_THREADS,
@@ -595,17 +606,8 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "mca_pml_base_select() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("pml select");
 
-    /* check for timing request - get stop time and report elapsed time if so */
-    if (ompi_enable_timing && 0 == OMPI_PROC_MY_NAME->vpid) {
-        gettimeofday(&ompistop, NULL);
-        opal_output(0, "ompi_mpi_init[%ld]: time from completion of rte_init to modex %ld usec",
-                    (long)OMPI_PROC_MY_NAME->vpid,
-                    (long int)((ompistop.tv_sec - ompistart.tv_sec)*1000000 +
-                               (ompistop.tv_usec - ompistart.tv_usec)));
-        gettimeofday(&ompistart, NULL);
-    }
-    
     /* exchange connection info - this function also acts as a barrier
      * as it will not return until the exchange is complete
      */
@@ -623,15 +625,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         opal_progress();  /* block in progress pending events */
     }
     OBJ_RELEASE(coll);
-
-    if (ompi_enable_timing && 0 == OMPI_PROC_MY_NAME->vpid) {
-        gettimeofday(&ompistop, NULL);
-        opal_output(0, "ompi_mpi_init[%ld]: time to execute modex %ld usec",
-                    (long)OMPI_PROC_MY_NAME->vpid,
-                    (long int)((ompistop.tv_sec - ompistart.tv_sec)*1000000 +
-                               (ompistop.tv_usec - ompistart.tv_usec)));
-        gettimeofday(&ompistart, NULL);
-    }
+    ompi_mpi_timing_mark("modex");
 
     /* select buffered send allocator component to be used */
     ret=mca_pml_base_bsend_init(OMPI_ENABLE_THREAD_MULTIPLE);
@@ -646,6 +640,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "mca_coll_base_find_available() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("coll select");
 
     if (OMPI_SUCCESS != 
         (ret = ompi_osc_base_find_available(OMPI_ENABLE_PROGRESS_THREADS,
@@ -653,6 +648,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "ompi_osc_base_find_available() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("osc select");
 
 #if OPAL_ENABLE_FT_CR == 1
     if (OMPI_SUCCESS != (ret = ompi_crcp_base_select() ) ) {
@@ -737,11 +733,13 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "ompi_proc_complete_init failed";
         goto error;
     }
+    ompi_mpi_timing_mark("mpi handles init");
 
     /* If thread support was enabled, then setup OPAL to allow for
        them. */
     if ((OMPI_ENABLE_PROGRESS_THREADS == 1) ||
-        (*provided != MPI_THREAD_SINGLE)) {
+        (*provided != MPI_THREAD_SINGLE) ||
+        (OPAL_ENABLE_MULTI_THREADS && opal_progress_thread_enable)) {
         opal_set_using_threads(true);
     }
 
@@ -751,6 +749,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "PML control failed";
         goto error;
     }
+    ompi_mpi_timing_mark("pml enable");
 
     /* add all ompi_proc_t's to PML */
     if (NULL == (procs = ompi_proc_world(&nprocs))) {
@@ -774,6 +773,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
 
     MCA_PML_CALL(add_comm(&ompi_mpi_comm_world.comm));
     MCA_PML_CALL(add_comm(&ompi_mpi_comm_self.comm));
+    ompi_mpi_timing_mark("pml/bml add_procs");
 
     /*
      * Dump all MCA parameters if requested
@@ -786,17 +786,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
 
     /* Do we need to wait for a debugger? */
     ompi_rte_wait_for_debugger();
-
-    /* check for timing request - get stop time and report elapsed
-       time if so, then start the clock again */
-    if (ompi_enable_timing && 0 == OMPI_PROC_MY_NAME->vpid) {
-        gettimeofday(&ompistop, NULL);
-        opal_output(0, "ompi_mpi_init[%ld]: time from modex to first barrier %ld usec",
-                    (long)OMPI_PROC_MY_NAME->vpid,
-                    (long int)((ompistop.tv_sec - ompistart.tv_sec)*1000000 +
-                               (ompistop.tv_usec - ompistart.tv_usec)));
-        gettimeofday(&ompistart, NULL);
-    }
+    ompi_mpi_timing_mark("wait for debugger");
 
     /* wait for everyone to reach this point */
     coll = OBJ_NEW(ompi_rte_collective_t);
@@ -810,17 +800,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         opal_progress();  /* block in progress pending events */
     }
     OBJ_RELEASE(coll);
-
-    /* check for timing request - get stop time and report elapsed
-       time if so, then start the clock again */
-    if (ompi_enable_timing && 0 == OMPI_PROC_MY_NAME->vpid) {
-        gettimeofday(&ompistop, NULL);
-        opal_output(0, "ompi_mpi_init[%ld]: time to execute barrier %ld usec",
-                    (long)OMPI_PROC_MY_NAME->vpid,
-                    (long int)((ompistop.tv_sec - ompistart.tv_sec)*1000000 +
-                               (ompistop.tv_usec - ompistart.tv_usec)));
-        gettimeofday(&ompistart, NULL);
-    }
+    ompi_mpi_timing_mark("init barrier");
 
 #if OMPI_ENABLE_PROGRESS_THREADS == 0
     /* Start setting up the event engine for MPI operations.  Don't
@@ -840,6 +820,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "ompi_mpi_do_preconnect_all() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("preconnect");
 
     /* Setup the publish/subscribe (PUBSUB) framework */
     if (OMPI_SUCCESS != (ret = mca_base_framework_open(&ompi_pubsub_base_framework, 0))) {
@@ -860,6 +841,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "ompi_dpm_base_select() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("pubsub+dpm select");
 
     /* Determine the overall threadlevel support of all processes 
        in MPI_COMM_WORLD. This has to be done before calling 
@@ -888,6 +870,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "mca_coll_base_comm_select(MPI_COMM_SELF) failed";
         goto error;
     }
+    ompi_mpi_timing_mark("coll comm_select");
 
 
     
@@ -898,6 +881,7 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         error = "ompi_comm_dyn_init() failed";
         goto error;
     }
+    ompi_mpi_timing_mark("dpm dyn_init");
 
     /*
      * Startup the Checkpoint/Restart Mech.
@@ -924,11 +908,23 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
         opal_progress_set_event_poll_rate(ompi_mpi_event_tick_rate);
     }
 
+    /* hand progress over to a dedicated thread, if requested */
+    if (OPAL_SUCCESS != (ret = opal_progress_thread_start())) {
+        error = "opal_progress_thread_start";
+        goto error;
+    }
+
     /* At this point, we are fully configured and in MPI mode.  Any
        communication calls here will work exactly like they would in
        the user's code.  Setup the connections between procs and warm
        them up with simple sends, if requested */
 
+    /* line MPI_Wtime up with the clock of rank 0, if requested */
+    if (OMPI_SUCCESS != (ret = ompi_clock_sync_init())) {
+        error = "ompi_clock_sync_init";
+        goto error;
+    }
+
     if (OMPI_SUCCESS != (ret = ompi_mpiext_init())) {
         error = "ompi_mpiext_init";
         goto error;
@@ -973,14 +969,10 @@ int ompi_mpi_init(int argc, char **argv, int requested, int *provided)
 
     ompi_mpi_initialized = true;
 
-    /* check for timing request - get stop time and report elapsed time if so */
-    if (ompi_enable_timing && 0 == OMPI_PROC_MY_NAME->vpid) {
-        gettimeofday(&ompistop, NULL);
-        opal_output(0, "ompi_mpi_init[%ld]: time from barrier to complete mpi_init %ld usec",
-                    (long)OMPI_PROC_MY_NAME->vpid,
-                    (long int)((ompistop.tv_sec - ompistart.tv_sec)*1000000 +
-                               (ompistop.tv_usec - ompistart.tv_usec)));
-    }
+    /* every process gets here when timing is requested, the
+       parameter is the same everywhere */
+    ompi_mpi_timing_mark("completion");
+    ompi_mpi_timing_report(true);
 
     return MPI_SUCCESS;
 }
@@ -61,8 +61,19 @@ bool ompi_mpi_keep_fqdn_hostnames = false;
 int ompi_mpi_leave_pinned = -1;
 bool ompi_mpi_leave_pinned_pipeline = false;
 bool ompi_have_sparse_group_storage = OPAL_INT_TO_BOOL(OMPI_GROUP_SPARSE);
-bool ompi_use_sparse_group_storage = OPAL_INT_TO_BOOL(OMPI_GROUP_SPARSE);
+bool ompi_use_sparse_group_storage = false;
+bool ompi_use_strided_group_storage = OPAL_INT_TO_BOOL(OMPI_GROUP_SPARSE);
 bool ompi_mpi_cuda_support = OPAL_INT_TO_BOOL(OMPI_CUDA_SUPPORT);
+int ompi_mpi_cid_window = 128;
+int ompi_mpi_comm_split_threshold = 4096;
+bool ompi_mpi_wtime_global = false;
+int ompi_mpi_wtime_sync_rounds = 20;
+bool ompi_mpi_finalize_quiesce = false;
+#if OMPI_WANT_PERUSE
+char *ompi_mpi_peruse_trace = NULL;
+int ompi_mpi_peruse_trace_records = 65536;
+int ompi_mpi_peruse_trace_signal = 0;
+#endif  /* OMPI_WANT_PERUSE */
 
 bool ompi_mpi_yield_when_idle = true;
 int ompi_mpi_event_tick_rate = -1;
@@ -302,9 +313,11 @@ int ompi_mpi_register_params(void)
                                  MCA_BASE_VAR_SCOPE_CONSTANT,
                                  &ompi_mpi_have_sparse_group_storage);
 
-    ompi_use_sparse_group_storage = ompi_mpi_have_sparse_group_storage;
+    /* The sporadic and bitmap formats make each peer lookup linear in
+       the group size, so they are only used on request */
+    ompi_use_sparse_group_storage = false;
     (void) mca_base_var_register("ompi", "mpi", NULL, "use_sparse_group_storage",
-                                 "Whether to use \"sparse\" storage formats for MPI groups (only relevant if mpi_have_sparse_group_storage is 1)",
+                                 "Whether to use all \"sparse\" storage formats for MPI groups, picking the smallest one for each group (only relevant if mpi_have_sparse_group_storage is 1)",
                                  MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
                                  ompi_mpi_have_sparse_group_storage ? 0 : MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
                                  OPAL_INFO_LVL_9,
@@ -317,6 +330,18 @@ int ompi_mpi_register_params(void)
         ompi_use_sparse_group_storage = false;
     }
 
+    ompi_use_strided_group_storage = ompi_mpi_have_sparse_group_storage;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "use_strided_group_storage",
+                                 "Whether to store MPI groups whose members are a regular range of the parent group (offset and stride, e.g. Cart_sub or Comm_split by row) in constant space; peer lookups stay constant-time (only relevant if mpi_have_sparse_group_storage is 1)",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                 ompi_mpi_have_sparse_group_storage ? 0 : MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                 OPAL_INFO_LVL_9,
+                                 ompi_mpi_have_sparse_group_storage ? MCA_BASE_VAR_SCOPE_READONLY : MCA_BASE_VAR_SCOPE_CONSTANT,
+                                 &ompi_use_strided_group_storage);
+    if (!ompi_mpi_have_sparse_group_storage) {
+        ompi_use_strided_group_storage = false;
+    }
+
     ompi_mpi_cuda_support = !!(OMPI_CUDA_SUPPORT);
     (void) mca_base_var_register("ompi", "mpi", NULL, "cuda_support",
                                  "Whether CUDA GPU buffer support is enabled or not",
@@ -331,6 +356,80 @@ int ompi_mpi_register_params(void)
         ompi_mpi_cuda_support = false;
     }
 
+    ompi_mpi_cid_window = 128;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "cid_window",
+                                 "Number of candidate context IDs negotiated at once when creating an intra-communicator, which usually settles the new context ID in a single allreduce (0 = use the iterative algorithm, maximum 1024; must be the same in all processes)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_cid_window);
+    if (ompi_mpi_cid_window < 0) {
+        ompi_mpi_cid_window = 0;
+    } else if (ompi_mpi_cid_window > 1024) {
+        ompi_mpi_cid_window = 1024;
+    }
+
+    ompi_mpi_comm_split_threshold = 4096;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "comm_split_threshold",
+                                 "Size of an intra-communicator from which MPI_Comm_split collects the members of each new group at one process per color instead of allgathering the color and key of every process (0 = always allgather; must be the same in all processes)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_comm_split_threshold);
+
+    ompi_mpi_wtime_global = false;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "wtime_global",
+                                 "Whether MPI_Wtime follows the clock of rank 0 of MPI_COMM_WORLD, from offsets measured at MPI_INIT (MPI_WTIME_IS_GLOBAL is then true; must be the same in all processes)",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_wtime_global);
+
+    ompi_mpi_wtime_sync_rounds = 20;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "wtime_sync_rounds",
+                                 "Ping-pongs with rank 0 per node when measuring the clock offsets for mpi_wtime_global, the shortest one gives the offset",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_wtime_sync_rounds);
+    if (ompi_mpi_wtime_sync_rounds < 1) {
+        ompi_mpi_wtime_sync_rounds = 1;
+    }
+
+    ompi_mpi_finalize_quiesce = false;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "finalize_quiesce",
+                                 "Whether MPI_FINALIZE waits for the local BTL modules to have nothing left in flight instead of a barrier across the job (only the self, sm and tcp BTLs report it, the traffic of the others is not waited for; must be the same in all processes)",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_finalize_quiesce);
+
+#if OMPI_WANT_PERUSE
+    ompi_mpi_peruse_trace = NULL;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "peruse_trace",
+                                 "Record every PERUSE event into a per-thread ring buffer and write them to the file <value>.<rank> at MPI_FINALIZE (empty = no tracing)",
+                                 MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_peruse_trace);
+
+    ompi_mpi_peruse_trace_records = 65536;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "peruse_trace_records",
+                                 "Number of PERUSE events kept by each thread when tracing, older ones are overwritten (rounded up to a power of 2)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_peruse_trace_records);
+
+    ompi_mpi_peruse_trace_signal = 0;
+    (void) mca_base_var_register("ompi", "mpi", NULL, "peruse_trace_signal",
+                                 "Signal on which the PERUSE trace files are written, in addition to MPI_FINALIZE (0 = none)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &ompi_mpi_peruse_trace_signal);
+#endif  /* OMPI_WANT_PERUSE */
+
     return OMPI_SUCCESS;
 }
 
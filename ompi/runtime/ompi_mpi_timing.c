@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#include "opal/util/output.h"
+#include "ompi/constants.h"
+#include "ompi/mca/rte/rte.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
+#include "ompi/runtime/ompi_mpi_timing.h"
+
+#define OMPI_MPI_TIMING_MAX_PHASES 48
+
+typedef struct {
+    const char *name;
+    double usec;
+} timing_phase_t;
+
+static const char *timing_what = NULL;
+static timing_phase_t timing_phases[OMPI_MPI_TIMING_MAX_PHASES];
+static int timing_num_phases = 0;
+static double timing_last;
+
+/* gettimeofday rather than the timer framework: the first phase
+   starts before opal_init_util() */
+static double timing_usec(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (double) tv.tv_sec * 1000000.0 + (double) tv.tv_usec;
+}
+
+void ompi_mpi_timing_start(const char *what)
+{
+    timing_what = what;
+    timing_num_phases = 0;
+    timing_last = timing_usec();
+}
+
+void ompi_mpi_timing_mark(const char *phase)
+{
+    double now;
+
+    if (!ompi_enable_timing) {
+        return;
+    }
+
+    now = timing_usec();
+    if (timing_num_phases < OMPI_MPI_TIMING_MAX_PHASES) {
+        timing_phases[timing_num_phases].name = phase;
+        timing_phases[timing_num_phases].usec = now - timing_last;
+        ++timing_num_phases;
+    }
+    timing_last = now;
+}
+
+void ompi_mpi_timing_report(bool collective)
+{
+    ompi_communicator_t *comm = &ompi_mpi_comm_world.comm;
+    double local[OMPI_MPI_TIMING_MAX_PHASES];
+    double mins[OMPI_MPI_TIMING_MAX_PHASES];
+    double maxs[OMPI_MPI_TIMING_MAX_PHASES];
+    double sums[OMPI_MPI_TIMING_MAX_PHASES];
+    double total[3] = { 0.0, 0.0, 0.0 };
+    int i, n = timing_num_phases, size = 1;
+
+    if (!ompi_enable_timing || 0 == n) {
+        return;
+    }
+
+    for (i = 0 ; i < n ; ++i) {
+        local[i] = mins[i] = maxs[i] = sums[i] = timing_phases[i].usec;
+    }
+
+    /* the reduction itself is not part of any phase */
+    if (collective && ompi_comm_size(comm) > 1) {
+        size = ompi_comm_size(comm);
+        if (OMPI_SUCCESS != comm->c_coll.coll_allreduce(local, mins, n, MPI_DOUBLE, MPI_MIN, comm,
+                                                        comm->c_coll.coll_allreduce_module) ||
+            OMPI_SUCCESS != comm->c_coll.coll_allreduce(local, maxs, n, MPI_DOUBLE, MPI_MAX, comm,
+                                                        comm->c_coll.coll_allreduce_module) ||
+            OMPI_SUCCESS != comm->c_coll.coll_allreduce(local, sums, n, MPI_DOUBLE, MPI_SUM, comm,
+                                                        comm->c_coll.coll_allreduce_module)) {
+            opal_output(0, "%s: could not reduce the phase timings", timing_what);
+            return;
+        }
+    }
+    /* the next report starts from here */
+    timing_num_phases = 0;
+    timing_last = timing_usec();
+
+    if (0 != OMPI_PROC_MY_NAME->vpid) {
+        return;
+    }
+
+    opal_output(0, "%s: %s phase timings in usec (min / mean / max)",
+                timing_what, size > 1 ? "per-process" : "rank 0");
+    for (i = 0 ; i < n ; ++i) {
+        opal_output(0, "%s: %-24s %12.0f %12.0f %12.0f", timing_what,
+                    timing_phases[i].name, mins[i], sums[i] / size, maxs[i]);
+        total[0] += mins[i];
+        total[1] += sums[i] / size;
+        total[2] += maxs[i];
+    }
+    /* the sums of the min and of the max bound the total of every
+       process */
+    opal_output(0, "%s: %-24s %12.0f %12.0f %12.0f", timing_what,
+                "total", total[0], total[1], total[2]);
+}
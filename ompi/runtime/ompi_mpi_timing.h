@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Phase by phase timing of MPI_INIT and MPI_FINALIZE, enabled by the
+ * ompi_timing MCA parameter.  Every phase is closed by
+ * ompi_mpi_timing_mark(), a clock read when timing is requested and a
+ * test otherwise.  ompi_mpi_timing_report() reduces the phases across
+ * MPI_COMM_WORLD to their min, mean and max, which rank 0 prints.
+ */
+
+#ifndef OMPI_MPI_TIMING_H
+#define OMPI_MPI_TIMING_H
+
+#include "ompi_config.h"
+
+BEGIN_C_DECLS
+
+/** timing requested (ompi_timing) */
+OMPI_DECLSPEC extern bool ompi_enable_timing;
+
+/**
+ * Forget the phases recorded so far and start the clock of the first
+ * phase of @a what ("ompi_mpi_init" or "ompi_mpi_finalize").  Called
+ * unconditionally, the parameter may not be registered yet.
+ */
+void ompi_mpi_timing_start(const char *what);
+
+/**
+ * Close the current phase under @a phase and start the next one.
+ */
+void ompi_mpi_timing_mark(const char *phase);
+
+/**
+ * Print the phases recorded since ompi_mpi_timing_start() or the
+ * previous report, and start over.  With @a collective the phases are
+ * reduced across MPI_COMM_WORLD, which must be usable and every
+ * process must call it; otherwise rank 0 prints its own.
+ */
+void ompi_mpi_timing_report(bool collective);
+
+END_C_DECLS
+
+#endif /* OMPI_MPI_TIMING_H */
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "opal/mca/base/mca_base_pvar.h"
+#include "ompi/constants.h"
+#include "ompi/class/ompi_free_list.h"
+#include "ompi/runtime/ompi_pvar_counters.h"
+
+/* what a registered variable reads: count consecutive values */
+struct ompi_pvar_counter_ctx_t {
+    ompi_pvar_counter_t *values;
+    int count;
+};
+typedef struct ompi_pvar_counter_ctx_t ompi_pvar_counter_ctx_t;
+
+#define OMPI_PVAR_COUNTER_TYPE                                          \
+    ((sizeof(ompi_pvar_counter_t) == sizeof(unsigned long)) ?           \
+     MCA_BASE_VAR_TYPE_UNSIGNED_LONG : MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG)
+
+static int ompi_pvar_counter_notify(struct mca_base_pvar_t *pvar, mca_base_pvar_event_t event,
+                                    void *obj, int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        *count = ((ompi_pvar_counter_ctx_t *) pvar->ctx)->count;
+    }
+    return OMPI_SUCCESS;
+}
+
+static int ompi_pvar_counter_get(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    ompi_pvar_counter_ctx_t *ctx = (ompi_pvar_counter_ctx_t *) pvar->ctx;
+    ompi_pvar_counter_t *values = (ompi_pvar_counter_t *) value;
+    int i;
+
+    for (i = 0 ; i < ctx->count ; ++i) {
+        values[i] = ctx->values[i];
+    }
+    return OMPI_SUCCESS;
+}
+
+static int ompi_pvar_timer_get(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    ompi_pvar_counter_ctx_t *ctx = (ompi_pvar_counter_ctx_t *) pvar->ctx;
+    double *values = (double *) value;
+    double freq = (double) opal_timer_base_get_freq();
+    int i;
+
+    for (i = 0 ; i < ctx->count ; ++i) {
+        values[i] = (freq > 0.0) ? (double) ctx->values[i] * 1000000.0 / freq : 0.0;
+    }
+    return OMPI_SUCCESS;
+}
+
+static int ompi_pvar_free_list_get(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    *((ompi_pvar_counter_t *) value) = ((ompi_free_list_t *) pvar->ctx)->fl_num_allocated;
+    return OMPI_SUCCESS;
+}
+
+static int ompi_pvar_register_array(const char *framework, const char *component,
+                                    const char *name, const char *description,
+                                    ompi_pvar_counter_t *values, int count, bool timer)
+{
+#if OMPI_ENABLE_PVAR_COUNTERS
+    ompi_pvar_counter_ctx_t *ctx;
+    int ret;
+
+    /* the variable outlives the component, the ctx is never freed */
+    ctx = (ompi_pvar_counter_ctx_t *) malloc(sizeof(*ctx));
+    if (NULL == ctx) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    ctx->values = values;
+    ctx->count = count;
+
+    ret = mca_base_pvar_register("ompi", framework, component, name, description, OPAL_INFO_LVL_4,
+                                 timer ? MCA_BASE_PVAR_CLASS_TIMER : MCA_BASE_PVAR_CLASS_COUNTER,
+                                 timer ? MCA_BASE_VAR_TYPE_DOUBLE : OMPI_PVAR_COUNTER_TYPE,
+                                 NULL, MPI_T_BIND_NO_OBJECT,
+                                 MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                 timer ? ompi_pvar_timer_get : ompi_pvar_counter_get,
+                                 NULL, ompi_pvar_counter_notify, ctx);
+    if (0 > ret) {
+        free(ctx);
+        return ret;
+    }
+#endif
+    return OMPI_SUCCESS;
+}
+
+int ompi_pvar_counter_register(const char *framework, const char *component,
+                               const char *name, const char *description,
+                               ompi_pvar_counter_t *counter, int count)
+{
+    return ompi_pvar_register_array(framework, component, name, description,
+                                    counter, count, false);
+}
+
+int ompi_pvar_timer_register(const char *framework, const char *component,
+                             const char *name, const char *description,
+                             ompi_pvar_counter_t *timer, int count)
+{
+    return ompi_pvar_register_array(framework, component, name, description,
+                                    timer, count, true);
+}
+
+int ompi_pvar_free_list_register(const char *framework, const char *component,
+                                 const char *name, const char *description,
+                                 struct ompi_free_list_t *list)
+{
+    int ret;
+
+    /* reading the list costs nothing on the fast path: always there */
+    ret = mca_base_pvar_register("ompi", framework, component, name, description, OPAL_INFO_LVL_4,
+                                 MCA_BASE_PVAR_CLASS_HIGHWATERMARK, OMPI_PVAR_COUNTER_TYPE,
+                                 NULL, MPI_T_BIND_NO_OBJECT,
+                                 MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                 ompi_pvar_free_list_get, NULL, NULL, list);
+    return (0 > ret) ? ret : OMPI_SUCCESS;
+}
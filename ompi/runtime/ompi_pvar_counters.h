@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Counters and timers of the communication paths, exported as MPI_T
+ * performance variables. Updating one is a single (atomic when threads
+ * are in use) add; everything compiles out when Open MPI is configured
+ * with --disable-pvar-counters. Timers accumulate timer cycles and are
+ * read back in microseconds.
+ */
+
+#ifndef OMPI_PVAR_COUNTERS_H
+#define OMPI_PVAR_COUNTERS_H
+
+#include "ompi_config.h"
+
+#include "opal/threads/mutex.h"
+#include "opal/mca/timer/base/base.h"
+
+BEGIN_C_DECLS
+
+typedef size_t ompi_pvar_counter_t;
+
+#if OMPI_ENABLE_PVAR_COUNTERS
+
+#define OMPI_PVAR_COUNTER_ADD(counter, n) \
+    ((void) OPAL_THREAD_ADD_SIZE_T(&(counter), (n)))
+#define OMPI_PVAR_COUNTER_MAX(counter, value)           \
+    do {                                                \
+        if ((ompi_pvar_counter_t) (value) > (counter)) { \
+            (counter) = (ompi_pvar_counter_t) (value);  \
+        }                                               \
+    } while (0)
+
+#define OMPI_PVAR_TIMER_DECLARE(t) opal_timer_t t
+#define OMPI_PVAR_TIMER_START(t)   ((t) = opal_timer_base_get_cycles())
+#define OMPI_PVAR_TIMER_STOP(t, counter) \
+    OMPI_PVAR_COUNTER_ADD(counter, (ompi_pvar_counter_t) (opal_timer_base_get_cycles() - (t)))
+
+#else
+
+#define OMPI_PVAR_COUNTER_ADD(counter, n) ((void) (counter))
+#define OMPI_PVAR_COUNTER_MAX(counter, value)
+#define OMPI_PVAR_TIMER_DECLARE(t) opal_timer_t t __opal_attribute_unused__
+#define OMPI_PVAR_TIMER_START(t)
+#define OMPI_PVAR_TIMER_STOP(t, counter)
+
+#endif  /* OMPI_ENABLE_PVAR_COUNTERS */
+
+/**
+ * Register counter, or count consecutive counters read as an array,
+ * as a counter performance variable of the given component. Does
+ * nothing when the counters are compiled out.
+ */
+OMPI_DECLSPEC int ompi_pvar_counter_register(const char *framework, const char *component,
+                                             const char *name, const char *description,
+                                             ompi_pvar_counter_t *counter, int count);
+
+/**
+ * Same for timers updated with OMPI_PVAR_TIMER_STOP.
+ */
+OMPI_DECLSPEC int ompi_pvar_timer_register(const char *framework, const char *component,
+                                           const char *name, const char *description,
+                                           ompi_pvar_counter_t *timer, int count);
+
+/**
+ * Register the high-water mark of a free list (the number of elements
+ * it ever allocated).
+ */
+struct ompi_free_list_t;
+OMPI_DECLSPEC int ompi_pvar_free_list_register(const char *framework, const char *component,
+                                               const char *name, const char *description,
+                                               struct ompi_free_list_t *list);
+
+END_C_DECLS
+
+#endif  /* OMPI_PVAR_COUNTERS_H */
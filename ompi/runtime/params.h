@@ -139,11 +139,56 @@ OMPI_DECLSPEC extern bool ompi_have_sparse_group_storage;
  */
 OMPI_DECLSPEC extern bool ompi_use_sparse_group_storage;
 
+/**
+ * Whether groups whose ranks form a regular range of the parent group
+ * are stored in the strided format, even if the other sparse formats
+ * are not used.
+ */
+OMPI_DECLSPEC extern bool ompi_use_strided_group_storage;
+
 /**
  * Whether we want to enable CUDA GPU buffer send and receive support.
  */
 OMPI_DECLSPEC extern bool ompi_mpi_cuda_support;
 
+/**
+ * Number of candidate context IDs examined by the single-round CID
+ * allocation of intra-communicators (0 = always use the iterative
+ * algorithm).  Must be the same in all processes.
+ */
+OMPI_DECLSPEC extern int ompi_mpi_cid_window;
+
+/**
+ * Communicator size from which MPI_Comm_split on an intra-communicator
+ * gathers each new group at a rendezvous process instead of
+ * allgathering all colors and keys (0 = never).
+ */
+OMPI_DECLSPEC extern int ompi_mpi_comm_split_threshold;
+
+/**
+ * Whether MPI_Wtime is the clock of rank 0 of MPI_COMM_WORLD, and the
+ * number of ping-pongs that measure the offset to it.
+ */
+OMPI_DECLSPEC extern bool ompi_mpi_wtime_global;
+OMPI_DECLSPEC extern int ompi_mpi_wtime_sync_rounds;
+
+/**
+ * Whether MPI_FINALIZE waits for local BTL quiescence rather than for
+ * the other processes of the job.
+ */
+OMPI_DECLSPEC extern bool ompi_mpi_finalize_quiesce;
+
+#if OMPI_WANT_PERUSE
+/**
+ * Prefix of the files the PERUSE events are traced into (NULL or
+ * empty = no tracing), number of events kept per thread, and signal
+ * that writes the trace files (0 = only at MPI_FINALIZE).
+ */
+OMPI_DECLSPEC extern char *ompi_mpi_peruse_trace;
+OMPI_DECLSPEC extern int ompi_mpi_peruse_trace_records;
+OMPI_DECLSPEC extern int ompi_mpi_peruse_trace_signal;
+#endif  /* OMPI_WANT_PERUSE */
+
 /**
  * Register MCA parameters used by the MPI layer.
  *
@@ -79,19 +79,16 @@ ompi_win_finalize(void)
 }
 
 
-int
-ompi_win_create(void *base, size_t size, 
-                int disp_unit, ompi_communicator_t *comm,
-                ompi_info_t *info,
-                ompi_win_t** newwin)
+static ompi_win_t *
+alloc_window(ompi_communicator_t *comm, size_t size, int disp_unit,
+             int flavor)
 {
     ompi_win_t *win;
     ompi_group_t *group;
-    int ret;
 
     /* create the object */
     win = OBJ_NEW(ompi_win_t);
-    if (NULL == win) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+    if (NULL == win) return NULL;
 
     /* setup data that is independent of osc component */
     group = comm->c_local_group;
@@ -99,45 +96,132 @@ ompi_win_create(void *base, size_t size,
     ompi_group_increment_proc_count(group);
     win->w_group = group;
 
-    win->w_baseptr = base;
     win->w_size = size;
     win->w_disp_unit = disp_unit;
+    win->w_flavor = flavor;
+    /* not in the Fortran table until config_window */
+    win->w_f_to_c_index = -1;
+
+    return win;
+}
+
+
+static int
+config_window(ompi_win_t *win)
+{
+    int ret;
 
     /* Fill in required attributes */
     ret = ompi_attr_set_c(WIN_ATTR, win, &win->w_keyhash, 
                           MPI_WIN_BASE, win->w_baseptr, true);
-    if (OMPI_SUCCESS != ret) {
-        OBJ_RELEASE(win);
-        return ret;
-    }
+    if (OMPI_SUCCESS != ret) return ret;
+
     ret = ompi_attr_set_fortran_mpi2(WIN_ATTR, win, 
                                      &win->w_keyhash, 
                                      MPI_WIN_SIZE, win->w_size, true);
-    if (OMPI_SUCCESS != ret) {
-        OBJ_RELEASE(win);
-        return ret;
-    }
+    if (OMPI_SUCCESS != ret) return ret;
+
     ret = ompi_attr_set_fortran_mpi2(WIN_ATTR, win, 
                                      &win->w_keyhash, 
                                      MPI_WIN_DISP_UNIT, win->w_disp_unit,
                                      true);
+    if (OMPI_SUCCESS != ret) return ret;
+
+    /* fill in Fortran index */
+    win->w_f_to_c_index = opal_pointer_array_add(&ompi_mpi_windows, win);
+    if (-1 == win->w_f_to_c_index) return OMPI_ERR_OUT_OF_RESOURCE;
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_win_create(void *base, size_t size, 
+                int disp_unit, ompi_communicator_t *comm,
+                ompi_info_t *info,
+                ompi_win_t** newwin)
+{
+    ompi_win_t *win;
+    int ret;
+
+    win = alloc_window(comm, size, disp_unit, OMPI_WIN_FLAVOR_CREATE);
+    if (NULL == win) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+
+    win->w_baseptr = base;
+
+    /* create backend onesided module for this window */
+    ret = ompi_osc_base_select(win, (ompi_info_t*) info, comm);
     if (OMPI_SUCCESS != ret) {
         OBJ_RELEASE(win);
         return ret;
     }
 
-    /* create backend onesided module for this window */
+    ret = config_window(win);
+    if (OMPI_SUCCESS != ret) {
+        ompi_win_free(win);
+        return ret;
+    }
+
+    *newwin = win;
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_win_allocate_shared(size_t size, int disp_unit,
+                         ompi_communicator_t *comm, ompi_info_t *info,
+                         void *baseptr, ompi_win_t **newwin)
+{
+    ompi_win_t *win;
+    int ret;
+
+    win = alloc_window(comm, size, disp_unit, OMPI_WIN_FLAVOR_SHARED);
+    if (NULL == win) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+
+    /* the component allocates the memory, and sets w_baseptr */
     ret = ompi_osc_base_select(win, (ompi_info_t*) info, comm);
     if (OMPI_SUCCESS != ret) {
         OBJ_RELEASE(win);
         return ret;
     }
 
-    /* fill in Fortran index */
-    win->w_f_to_c_index = opal_pointer_array_add(&ompi_mpi_windows, win);
-    if (-1 == win->w_f_to_c_index) {
+    ret = config_window(win);
+    if (OMPI_SUCCESS != ret) {
         ompi_win_free(win);
-        return OMPI_ERR_OUT_OF_RESOURCE;
+        return ret;
+    }
+
+    *((void**) baseptr) = win->w_baseptr;
+    *newwin = win;
+
+    return OMPI_SUCCESS;
+}
+
+
+int
+ompi_win_create_dynamic(ompi_communicator_t *comm, ompi_info_t *info,
+                        ompi_win_t **newwin)
+{
+    ompi_win_t *win;
+    int ret;
+
+    /* no memory yet, and displacements are addresses */
+    win = alloc_window(comm, 0, 1, OMPI_WIN_FLAVOR_DYNAMIC);
+    if (NULL == win) return OMPI_ERR_TEMP_OUT_OF_RESOURCE;
+
+    win->w_baseptr = MPI_BOTTOM;
+
+    ret = ompi_osc_base_select(win, (ompi_info_t*) info, comm);
+    if (OMPI_SUCCESS != ret) {
+        OBJ_RELEASE(win);
+        return ret;
+    }
+
+    ret = config_window(win);
+    if (OMPI_SUCCESS != ret) {
+        ompi_win_free(win);
+        return ret;
     }
 
     *newwin = win;
@@ -220,6 +304,7 @@ ompi_win_construct(ompi_win_t *win)
     win->w_mode = 0;
     win->w_baseptr = NULL;
     win->w_size = 0;
+    win->w_flavor = OMPI_WIN_FLAVOR_CREATE;
     win->w_osc_module = NULL;
 }
 
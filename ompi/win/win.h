@@ -48,6 +48,11 @@ BEGIN_C_DECLS
 #define OMPI_WIN_STARTED      0x00000040
 #define OMPI_WIN_LOCK_ACCESS  0x00000080
 
+/* flavor: how the memory of the window was obtained */
+#define OMPI_WIN_FLAVOR_CREATE 1
+#define OMPI_WIN_FLAVOR_SHARED 2
+#define OMPI_WIN_FLAVOR_DYNAMIC 3
+
 OMPI_DECLSPEC extern opal_pointer_array_t ompi_mpi_windows;
 
 struct ompi_win_t {
@@ -81,6 +86,11 @@ struct ompi_win_t {
     void *w_baseptr;
     size_t w_size;
 
+    /* OMPI_WIN_FLAVOR_CREATE (memory given by the user),
+       OMPI_WIN_FLAVOR_SHARED (allocated by the OSC component) or
+       OMPI_WIN_FLAVOR_DYNAMIC (attached by the user later on) */
+    int w_flavor;
+
     /** Current epoch / mode (access, expose, lock, etc.).  Checked by
         the argument checking code in the MPI layer, set by the OSC
         component.  Modified without locking w_lock. */
@@ -115,6 +125,13 @@ int ompi_win_create(void *base, size_t size, int disp_unit,
                     ompi_communicator_t *comm, ompi_info_t *info,
                     ompi_win_t **newwin);
 
+int ompi_win_allocate_shared(size_t size, int disp_unit,
+                             ompi_communicator_t *comm, ompi_info_t *info,
+                             void *baseptr, ompi_win_t **newwin);
+
+int ompi_win_create_dynamic(ompi_communicator_t *comm, ompi_info_t *info,
+                            ompi_win_t **newwin);
+
 int ompi_win_free(ompi_win_t *win);
 
 OMPI_DECLSPEC int ompi_win_set_name(ompi_win_t *win, char *win_name);
@@ -71,10 +71,10 @@ static inline opal_list_item_t* opal_atomic_lifo_push( opal_atomic_lifo_t* lifo,
 #if OPAL_ENABLE_MULTI_THREADS
     do {
         item->opal_list_next = lifo->opal_lifo_head;
-        opal_atomic_wmb();
-        if( opal_atomic_cmpset_ptr( &(lifo->opal_lifo_head),
-                                    (void*)item->opal_list_next,
-                                    item ) ) {
+        /* release: the item is written before it becomes visible */
+        if( opal_atomic_cmpset_rel_ptr( &(lifo->opal_lifo_head),
+                                        (void*)item->opal_list_next,
+                                        item ) ) {
             opal_atomic_cmpset_32((volatile int32_t*)&item->item_free, 1, 0);
             return (opal_list_item_t*)item->opal_list_next;
         }
@@ -94,9 +94,9 @@ static inline opal_list_item_t* opal_atomic_lifo_pop( opal_atomic_lifo_t* lifo )
 {
     opal_list_item_t* item;
 #if OPAL_ENABLE_MULTI_THREADS
-    while((item = lifo->opal_lifo_head) != &(lifo->opal_lifo_ghost))
+    while((item = (opal_list_item_t*)opal_atomic_load_acq_ptr(&lifo->opal_lifo_head)) !=
+          &(lifo->opal_lifo_ghost))
     {
-        opal_atomic_rmb();
         if(!opal_atomic_cmpset_32((volatile int32_t*)&item->item_free, 0, 1))
             continue;
         if( opal_atomic_cmpset_ptr( &(lifo->opal_lifo_head),
@@ -26,7 +26,7 @@ static void opal_free_list_construct(opal_free_list_t* fl);
 static void opal_free_list_destruct(opal_free_list_t* fl);
 
 OBJ_CLASS_INSTANCE(opal_free_list_t,
-                   opal_list_t,
+                   opal_atomic_lifo_t,
                    opal_free_list_construct,
                    opal_free_list_destruct);
 OBJ_CLASS_INSTANCE(opal_free_list_item_t,
@@ -111,13 +111,13 @@ int opal_free_list_grow(opal_free_list_t* flist, size_t num_elements)
         for(i=0; i<num_elements; i++) {
             opal_free_list_item_t* item = (opal_free_list_item_t*)ptr;
             OBJ_CONSTRUCT_INTERNAL(item, flist->fl_elem_class);
-            opal_list_append(&(flist->super), &(item->super));
+            opal_atomic_lifo_push(&(flist->super), &(item->super));
             ptr += flist->fl_elem_size;
         }
     } else {
         for(i=0; i<num_elements; i++) {
             opal_free_list_item_t* item = (opal_free_list_item_t*)ptr;
-            opal_list_append(&(flist->super), &(item->super));
+            opal_atomic_lifo_push(&(flist->super), &(item->super));
             ptr += flist->fl_elem_size;
         }
     }
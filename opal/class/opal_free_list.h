@@ -22,15 +22,23 @@
 #include "opal_config.h"
 
 #include "opal/class/opal_list.h"
+#include "opal/class/opal_atomic_lifo.h"
 #include "opal/threads/condition.h"
 #include "opal/constants.h"
 #include "opal/prefetch.h"
 
 BEGIN_C_DECLS
 
+/*
+ * The free items are kept on an atomic LIFO, so getting and returning
+ * an item does not take any lock. The lock is only used to serialize
+ * the growth of the list and to block in OPAL_FREE_LIST_WAIT. The LIFO
+ * protects itself against the ABA problem by claiming the head item
+ * (via its item_free flag) before swinging the head pointer.
+ */
 struct opal_free_list_t
 {
-    opal_list_t super;
+    opal_atomic_lifo_t super;
     size_t fl_max_to_alloc;
     size_t fl_num_allocated;
     size_t fl_num_per_alloc;
@@ -87,23 +95,23 @@ OPAL_DECLSPEC int opal_free_list_grow(opal_free_list_t* flist, size_t num_elemen
  
 #define OPAL_FREE_LIST_GET(fl, item, rc)                                \
 {                                                                       \
-    if(opal_using_threads()) {                                          \
-        opal_mutex_lock(&((fl)->fl_lock));                              \
-        item = (opal_free_list_item_t*)                                 \
-            opal_list_remove_first(&((fl)->super));                     \
-        if( OPAL_UNLIKELY(NULL == item) ) {                             \
-            opal_free_list_grow((fl), (fl)->fl_num_per_alloc);          \
+    item = (opal_free_list_item_t*) opal_atomic_lifo_pop(&((fl)->super)); \
+    if( OPAL_UNLIKELY(NULL == item) ) {                                 \
+        if(opal_using_threads()) {                                      \
+            opal_mutex_lock(&((fl)->fl_lock));                          \
+            /* somebody else might have grown the list in the meantime */ \
             item = (opal_free_list_item_t*)                             \
-                opal_list_remove_first(&((fl)->super));                 \
-        }                                                               \
-        opal_mutex_unlock(&((fl)->fl_lock));                            \
-    } else {                                                            \
-        item = (opal_free_list_item_t*)                                 \
-            opal_list_remove_first(&((fl)->super));                     \
-        if( OPAL_UNLIKELY(NULL == item) ) {                             \
+                opal_atomic_lifo_pop(&((fl)->super));                   \
+            if( NULL == item ) {                                        \
+                opal_free_list_grow((fl), (fl)->fl_num_per_alloc);      \
+                item = (opal_free_list_item_t*)                         \
+                    opal_atomic_lifo_pop(&((fl)->super));               \
+            }                                                           \
+            opal_mutex_unlock(&((fl)->fl_lock));                        \
+        } else {                                                        \
             opal_free_list_grow((fl), (fl)->fl_num_per_alloc);          \
             item = (opal_free_list_item_t*)                             \
-                opal_list_remove_first(&((fl)->super));                 \
+                opal_atomic_lifo_pop(&((fl)->super));                   \
         }                                                               \
     }                                                                   \
     rc = (NULL == item) ?  OPAL_ERR_TEMP_OUT_OF_RESOURCE : OPAL_SUCCESS; \
@@ -124,17 +132,20 @@ OPAL_DECLSPEC int opal_free_list_grow(opal_free_list_t* flist, size_t num_elemen
 
 #define OPAL_FREE_LIST_WAIT(fl, item, rc)                               \
     do {                                                                \
-        OPAL_THREAD_LOCK(&((fl)->fl_lock));                             \
-        while( NULL == (item = (opal_free_list_item_t*) opal_list_remove_first(&((fl)->super))) ) { \
-            if( OPAL_LIKELY((fl)->fl_max_to_alloc <= (fl)->fl_num_allocated) ) { \
-                (fl)->fl_num_waiting++;                                 \
-                opal_condition_wait(&((fl)->fl_condition), &((fl)->fl_lock)); \
-                (fl)->fl_num_waiting--;                                 \
-            } else {                                                    \
-                opal_free_list_grow((fl), (fl)->fl_num_per_alloc);      \
+        item = (opal_free_list_item_t*) opal_atomic_lifo_pop(&((fl)->super)); \
+        if( OPAL_UNLIKELY(NULL == item) ) {                             \
+            OPAL_THREAD_LOCK(&((fl)->fl_lock));                         \
+            while( NULL == (item = (opal_free_list_item_t*) opal_atomic_lifo_pop(&((fl)->super))) ) { \
+                if( OPAL_LIKELY((fl)->fl_max_to_alloc <= (fl)->fl_num_allocated) ) { \
+                    (fl)->fl_num_waiting++;                             \
+                    opal_condition_wait(&((fl)->fl_condition), &((fl)->fl_lock)); \
+                    (fl)->fl_num_waiting--;                             \
+                } else {                                                \
+                    opal_free_list_grow((fl), (fl)->fl_num_per_alloc);  \
+                }                                                       \
             }                                                           \
+            OPAL_THREAD_UNLOCK(&((fl)->fl_lock));                       \
         }                                                               \
-        OPAL_THREAD_UNLOCK(&((fl)->fl_lock));                           \
         rc = OPAL_SUCCESS;                                              \
     } while(0)
 
@@ -145,16 +156,27 @@ OPAL_DECLSPEC int opal_free_list_grow(opal_free_list_t* flist, size_t num_elemen
  * @param fl (IN)        Free list.
  * @param item (OUT)     Allocated item.
  *
+ * Waiters can only exist if the list was empty, so the lock is only
+ * taken when the item went onto an empty list.
  */
  
 #define OPAL_FREE_LIST_RETURN(fl, item)                                 \
     do {                                                                \
-        OPAL_THREAD_LOCK(&(fl)->fl_lock);                               \
-        opal_list_prepend(&((fl)->super), ((opal_list_item_t*) item));  \
-        if( OPAL_UNLIKELY((fl)->fl_num_waiting > 0) ) {                 \
-            opal_condition_signal(&((fl)->fl_condition));               \
+        opal_list_item_t* original;                                     \
+                                                                        \
+        original = opal_atomic_lifo_push(&((fl)->super),                \
+                                         ((opal_list_item_t*) item));   \
+        if( OPAL_UNLIKELY(&(fl)->super.opal_lifo_ghost == original) ) { \
+            OPAL_THREAD_LOCK(&(fl)->fl_lock);                           \
+            if( (fl)->fl_num_waiting > 0 ) {                            \
+                if( 1 == (fl)->fl_num_waiting ) {                       \
+                    opal_condition_signal(&((fl)->fl_condition));       \
+                } else {                                                \
+                    opal_condition_broadcast(&((fl)->fl_condition));    \
+                }                                                       \
+            }                                                           \
+            OPAL_THREAD_UNLOCK(&(fl)->fl_lock);                         \
         }                                                               \
-        OPAL_THREAD_UNLOCK(&(fl)->fl_lock);                             \
     } while(0)
 
 END_C_DECLS
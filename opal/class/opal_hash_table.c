@@ -5,14 +5,14 @@
  * Copyright (c) 2004-2005 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
- * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart, 
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
  *                         University of Stuttgart.  All rights reserved.
  * Copyright (c) 2004-2005 The Regents of the University of California.
  *                         All rights reserved.
  * $COPYRIGHT$
- * 
+ *
  * Additional copyrights may follow
- * 
+ *
  * $HEADER$
  */
 
@@ -22,7 +22,6 @@
 #include <stdlib.h>
 
 #include "opal/util/output.h"
-#include "opal/class/opal_list.h"
 #include "opal/class/opal_hash_table.h"
 #include "opal/constants.h"
 #include "opal/util/bit_ops.h"
@@ -37,7 +36,7 @@ static void opal_hash_table_destruct(opal_hash_table_t* ht);
 
 
 OBJ_CLASS_INSTANCE(
-    opal_hash_table_t, 
+    opal_hash_table_t,
     opal_object_t,
     opal_hash_table_construct,
     opal_hash_table_destruct
@@ -46,42 +45,42 @@ OBJ_CLASS_INSTANCE(
 
 static void opal_hash_table_construct(opal_hash_table_t* ht)
 {
-    OBJ_CONSTRUCT(&ht->ht_nodes, opal_list_t);
     ht->ht_table = NULL;
     ht->ht_table_size = 0;
     ht->ht_size = 0;
+    ht->ht_mask = 0;
 }
 
 
 static void opal_hash_table_destruct(opal_hash_table_t* ht)
 {
-    size_t i;
     opal_hash_table_remove_all(ht);
-    for(i=0; i<ht->ht_table_size; i++) {
-        OBJ_DESTRUCT(ht->ht_table+i);
-    }
     if(NULL != ht->ht_table) {
         free(ht->ht_table);
     }
-    OBJ_DESTRUCT(&ht->ht_nodes);
+    ht->ht_table = NULL;
+    ht->ht_table_size = 0;
 }
 
 
 int opal_hash_table_init(opal_hash_table_t* ht, size_t table_size)
 {
-    size_t i;
-    size_t power2 = opal_next_poweroftwo (table_size);
+    /* leave room for table_size elements below the maximum load */
+    size_t power2 = opal_next_poweroftwo (table_size + table_size / 3);
+    opal_hash_element_t *table;
 
-    ht->ht_mask = power2-1;
-    ht->ht_table = (opal_list_t *)malloc(power2 * sizeof(opal_list_t));
-    if(NULL == ht->ht_table) {
+    table = (opal_hash_element_t *)calloc(power2, sizeof(opal_hash_element_t));
+    if(NULL == table) {
         return OPAL_ERR_OUT_OF_RESOURCE;
     }
-    for(i=ht->ht_table_size; i<power2; i++) {
-        opal_list_t* list = ht->ht_table+i;
-        OBJ_CONSTRUCT(list, opal_list_t);
+    if(NULL != ht->ht_table) {
+        opal_hash_table_remove_all(ht);
+        free(ht->ht_table);
     }
+    ht->ht_table = table;
     ht->ht_table_size = power2;
+    ht->ht_mask = power2-1;
+    ht->ht_size = 0;
     return OPAL_SUCCESS;
 }
 
@@ -89,46 +88,163 @@ int opal_hash_table_remove_all(opal_hash_table_t* ht)
 {
     size_t i;
     for(i=0; i<ht->ht_table_size; i++) {
-        opal_list_t* list = ht->ht_table+i;
-        while(opal_list_get_size(list)) {
-            opal_list_item_t *item = opal_list_remove_first(list);
-            OBJ_RELEASE(item);
+        opal_hash_element_t *elt = ht->ht_table + i;
+        if(0 != elt->psl && 0 != elt->key_size) {
+            free(elt->key.ptr);
         }
-    }
-
-    while(opal_list_get_size(&ht->ht_nodes)) {
-        opal_list_item_t* item = opal_list_remove_first(&ht->ht_nodes);
-        OBJ_RELEASE(item);
+        elt->psl = 0;
     }
     ht->ht_size = 0;
     return OPAL_SUCCESS;
 }
- 
+
 /***************************************************************************/
 
 /*
- *  opal_uint32_hash_node_t
+ * Hash functions. The slot is taken from the low bits of the hash, so
+ * the integer keys are mixed (they are often made of a small rank in
+ * the low bits and a job id in the high bits).
+ */
+
+static inline uint32_t opal_hash_uint32(uint32_t key)
+{
+    key ^= key >> 16;
+    key *= 0x85ebca6bU;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35U;
+    key ^= key >> 16;
+    return key;
+}
+
+static inline uint32_t opal_hash_uint64(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return (uint32_t) key;
+}
+
+static inline uint32_t opal_hash_ptr(const void *key, size_t keysize)
+{
+    return (uint32_t) opal_uicrc_partial (key, keysize, 0);
+}
+
+/*
+ * Robin Hood primitives, shared by all the key types.
  */
 
-struct opal_uint32_hash_node_t
+/* make sure there is room for one more element */
+static int opal_hash_table_reserve(opal_hash_table_t* ht);
+
+/* insert an element that is known not to be in the table */
+static inline void opal_hash_table_insert(opal_hash_table_t* ht,
+                                          opal_hash_element_t elt)
+{
+    size_t idx = elt.hash & ht->ht_mask;
+
+    elt.psl = 1;
+    for(;;) {
+        opal_hash_element_t *slot = ht->ht_table + idx;
+        if(0 == slot->psl) {
+            *slot = elt;
+            return;
+        }
+        if(slot->psl < elt.psl) {
+            /* the resident is closer to home: take its place and carry
+               it further down */
+            opal_hash_element_t tmp = *slot;
+            *slot = elt;
+            elt = tmp;
+        }
+        idx = (idx + 1) & ht->ht_mask;
+        elt.psl++;
+    }
+}
+
+/* remove an element by shifting the following ones one slot back */
+static inline void opal_hash_table_erase(opal_hash_table_t* ht,
+                                         opal_hash_element_t *elt)
 {
-    opal_list_item_t super;
-    uint32_t hn_key;
-    void *hn_value;
-};
-typedef struct opal_uint32_hash_node_t opal_uint32_hash_node_t;
+    size_t idx = elt - ht->ht_table;
 
-static OBJ_CLASS_INSTANCE(opal_uint32_hash_node_t,
-                          opal_list_item_t,
-                          NULL,
-                          NULL);
+    for(;;) {
+        size_t next = (idx + 1) & ht->ht_mask;
+        if(ht->ht_table[next].psl <= 1) {
+            ht->ht_table[idx].psl = 0;
+            break;
+        }
+        ht->ht_table[idx] = ht->ht_table[next];
+        ht->ht_table[idx].psl--;
+        idx = next;
+    }
+    ht->ht_size--;
+}
+
+static int opal_hash_table_reserve(opal_hash_table_t* ht)
+{
+    opal_hash_element_t *old_table = ht->ht_table;
+    size_t i, old_size = ht->ht_table_size;
+    size_t new_size;
+
+    /* keep the load of the table below 3/4 */
+    if(4 * (ht->ht_size + 1) <= 3 * ht->ht_table_size) {
+        return OPAL_SUCCESS;
+    }
+
+    new_size = (0 == old_size) ? 2 : 2 * old_size;
+    ht->ht_table = (opal_hash_element_t *)calloc(new_size, sizeof(opal_hash_element_t));
+    if(NULL == ht->ht_table) {
+        ht->ht_table = old_table;
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    ht->ht_table_size = new_size;
+    ht->ht_mask = new_size - 1;
+    for(i = 0; i < old_size; i++) {
+        if(0 != old_table[i].psl) {
+            opal_hash_table_insert(ht, old_table[i]);
+        }
+    }
+    free(old_table);
+    return OPAL_SUCCESS;
+}
+
+/*
+ * Lookup loop: walk the probe sequence from the home slot of the hash
+ * and stop either on the key or on the first element that is closer
+ * to its home than the key would be at this point (the key would have
+ * taken the slot of that element on insertion).
+ */
+#define OPAL_HASH_TABLE_FIND(ht, hashval, elt, match)                   \
+    do {                                                                \
+        size_t __idx = (hashval) & (ht)->ht_mask;                       \
+        uint32_t __psl = 1;                                             \
+        for(;;) {                                                       \
+            elt = (ht)->ht_table + __idx;                               \
+            if(elt->psl < __psl) {                                      \
+                elt = NULL;                                             \
+                break;                                                  \
+            }                                                           \
+            if(elt->hash == (hashval) && (match)) {                     \
+                break;                                                  \
+            }                                                           \
+            __idx = (__idx + 1) & (ht)->ht_mask;                        \
+            __psl++;                                                    \
+        }                                                               \
+    } while(0)
+
+/***************************************************************************/
 
+/*
+ *  uint32_t keys
+ */
 
 int opal_hash_table_get_value_uint32(opal_hash_table_t* ht, uint32_t key,
 				     void **ptr)
 {
-    opal_list_t* list = ht->ht_table + (key & ht->ht_mask);
-    opal_uint32_hash_node_t *node;
+    uint32_t hash = opal_hash_uint32(key);
+    opal_hash_element_t *elt;
 
 #if OPAL_ENABLE_DEBUG
     if(ht->ht_table_size == 0) {
@@ -137,23 +253,21 @@ int opal_hash_table_get_value_uint32(opal_hash_table_t* ht, uint32_t key,
         return OPAL_ERROR;
     }
 #endif
-    for(node =  (opal_uint32_hash_node_t*)opal_list_get_first(list);
-        node != (opal_uint32_hash_node_t*)opal_list_get_end(list);
-        node =  (opal_uint32_hash_node_t*)opal_list_get_next(node)) {
-        if (node->hn_key == key) {
-	    *ptr = node->hn_value;
-            return OPAL_SUCCESS;
-        }
-    } 
-    return OPAL_ERR_NOT_FOUND;
+    OPAL_HASH_TABLE_FIND(ht, hash, elt, elt->key.u32 == key);
+    if(NULL == elt) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+    *ptr = elt->value;
+    return OPAL_SUCCESS;
 }
 
 
 int opal_hash_table_set_value_uint32(opal_hash_table_t* ht,
 				    uint32_t key, void* value)
 {
-    opal_list_t* list = ht->ht_table + (key & ht->ht_mask);
-    opal_uint32_hash_node_t *node;
+    uint32_t hash = opal_hash_uint32(key);
+    opal_hash_element_t *elt, new_elt;
+    int rc;
 
 #if OPAL_ENABLE_DEBUG
     if(ht->ht_table_size == 0) {
@@ -162,24 +276,21 @@ int opal_hash_table_set_value_uint32(opal_hash_table_t* ht,
         return OPAL_ERR_BAD_PARAM;
     }
 #endif
-    for(node =  (opal_uint32_hash_node_t*)opal_list_get_first(list);
-        node != (opal_uint32_hash_node_t*)opal_list_get_end(list);
-        node =  (opal_uint32_hash_node_t*)opal_list_get_next(node)) {
-        if (node->hn_key == key) {
-            node->hn_value = value;
-            return OPAL_SUCCESS;
-        }
-    } 
+    OPAL_HASH_TABLE_FIND(ht, hash, elt, elt->key.u32 == key);
+    if(NULL != elt) {
+        elt->value = value;
+        return OPAL_SUCCESS;
+    }
 
-    node = (opal_uint32_hash_node_t*)opal_list_remove_first(&ht->ht_nodes); 
-    if(NULL == node) {
-        node = OBJ_NEW(opal_uint32_hash_node_t);
-        if(NULL == node)
-            return OPAL_ERR_OUT_OF_RESOURCE;
+    if(OPAL_SUCCESS != (rc = opal_hash_table_reserve(ht))) {
+        return rc;
     }
-    node->hn_key = key;
-    node->hn_value = value;
-    opal_list_append(list, (opal_list_item_t*)node);
+    new_elt.hash = hash;
+    new_elt.key.u64 = 0;
+    new_elt.key.u32 = key;
+    new_elt.key_size = 0;
+    new_elt.value = value;
+    opal_hash_table_insert(ht, new_elt);
     ht->ht_size++;
     return OPAL_SUCCESS;
 }
@@ -187,8 +298,8 @@ int opal_hash_table_set_value_uint32(opal_hash_table_t* ht,
 
 int opal_hash_table_remove_value_uint32(opal_hash_table_t* ht, uint32_t key)
 {
-    opal_list_t* list = ht->ht_table + (key & ht->ht_mask);
-    opal_uint32_hash_node_t *node;
+    uint32_t hash = opal_hash_uint32(key);
+    opal_hash_element_t *elt;
 
 #if OPAL_ENABLE_DEBUG
     if(ht->ht_table_size == 0) {
@@ -197,44 +308,25 @@ int opal_hash_table_remove_value_uint32(opal_hash_table_t* ht, uint32_t key)
         return OPAL_ERR_BAD_PARAM;
     }
 #endif
-    for(node =  (opal_uint32_hash_node_t*)opal_list_get_first(list);
-        node != (opal_uint32_hash_node_t*)opal_list_get_end(list);
-        node =  (opal_uint32_hash_node_t*)opal_list_get_next(node)) {
-        if (node->hn_key == key) {
-            opal_list_remove_item(list, (opal_list_item_t*)node);
-            opal_list_append(&ht->ht_nodes, (opal_list_item_t*)node);
-            ht->ht_size--;
-            return OPAL_SUCCESS;
-        }
-    } 
-    return OPAL_ERR_NOT_FOUND;
+    OPAL_HASH_TABLE_FIND(ht, hash, elt, elt->key.u32 == key);
+    if(NULL == elt) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+    opal_hash_table_erase(ht, elt);
+    return OPAL_SUCCESS;
 }
 
 /***************************************************************************/
 
 /*
- *  opal_uint64_hash_node_t
+ *  uint64_t keys
  */
 
-struct opal_uint64_hash_node_t
-{
-    opal_list_item_t super;
-    uint64_t hn_key;
-    void* hn_value;
-};
-typedef struct opal_uint64_hash_node_t opal_uint64_hash_node_t;
-
-static OBJ_CLASS_INSTANCE(opal_uint64_hash_node_t,
-                          opal_list_item_t,
-                          NULL,
-                          NULL);
-
-
 int opal_hash_table_get_value_uint64(opal_hash_table_t* ht, uint64_t key,
 				     void **ptr)
 {
-    opal_list_t* list = ht->ht_table + (key & ht->ht_mask);
-    opal_uint64_hash_node_t *node;
+    uint32_t hash = opal_hash_uint64(key);
+    opal_hash_element_t *elt;
 
 #if OPAL_ENABLE_DEBUG
     if(ht->ht_table_size == 0) {
@@ -243,23 +335,21 @@ int opal_hash_table_get_value_uint64(opal_hash_table_t* ht, uint64_t key,
         return OPAL_ERROR;
     }
 #endif
-    for(node =  (opal_uint64_hash_node_t*)opal_list_get_first(list);
-        node != (opal_uint64_hash_node_t*)opal_list_get_end(list);
-        node =  (opal_uint64_hash_node_t*)opal_list_get_next(node)) {
-        if (node->hn_key == key) {
-            *ptr = node->hn_value;
-            return OPAL_SUCCESS;
-        }
-    } 
-    return OPAL_ERR_NOT_FOUND;
+    OPAL_HASH_TABLE_FIND(ht, hash, elt, elt->key.u64 == key);
+    if(NULL == elt) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+    *ptr = elt->value;
+    return OPAL_SUCCESS;
 }
 
 
 int opal_hash_table_set_value_uint64(opal_hash_table_t* ht,
 				    uint64_t key, void* value)
 {
-    opal_list_t* list = ht->ht_table + (key & ht->ht_mask);
-    opal_uint64_hash_node_t *node;
+    uint32_t hash = opal_hash_uint64(key);
+    opal_hash_element_t *elt, new_elt;
+    int rc;
 
 #if OPAL_ENABLE_DEBUG
     if(ht->ht_table_size == 0) {
@@ -268,25 +358,20 @@ int opal_hash_table_set_value_uint64(opal_hash_table_t* ht,
         return OPAL_ERR_BAD_PARAM;
     }
 #endif
-    for(node =  (opal_uint64_hash_node_t*)opal_list_get_first(list);
-        node != (opal_uint64_hash_node_t*)opal_list_get_end(list);
-        node =  (opal_uint64_hash_node_t*)opal_list_get_next(node)) {
-        if (node->hn_key == key) {
-            node->hn_value = value;
-            return OPAL_SUCCESS;
-        }
-    } 
+    OPAL_HASH_TABLE_FIND(ht, hash, elt, elt->key.u64 == key);
+    if(NULL != elt) {
+        elt->value = value;
+        return OPAL_SUCCESS;
+    }
 
-    node = (opal_uint64_hash_node_t*)opal_list_remove_first(&ht->ht_nodes); 
-    if(NULL == node) {
-        node = OBJ_NEW(opal_uint64_hash_node_t);
-        if(NULL == node) {
-            return OPAL_ERR_OUT_OF_RESOURCE;
-        }
+    if(OPAL_SUCCESS != (rc = opal_hash_table_reserve(ht))) {
+        return rc;
     }
-    node->hn_key = key;
-    node->hn_value = value;
-    opal_list_append(list, (opal_list_item_t*)node);
+    new_elt.hash = hash;
+    new_elt.key.u64 = key;
+    new_elt.key_size = 0;
+    new_elt.value = value;
+    opal_hash_table_insert(ht, new_elt);
     ht->ht_size++;
     return OPAL_SUCCESS;
 }
@@ -294,8 +379,8 @@ int opal_hash_table_set_value_uint64(opal_hash_table_t* ht,
 
 int opal_hash_table_remove_value_uint64(opal_hash_table_t* ht, uint64_t key)
 {
-    opal_list_t* list = ht->ht_table + (key & ht->ht_mask);
-    opal_uint64_hash_node_t *node;
+    uint32_t hash = opal_hash_uint64(key);
+    opal_hash_element_t *elt;
 
 #if OPAL_ENABLE_DEBUG
     if(ht->ht_table_size == 0) {
@@ -304,66 +389,29 @@ int opal_hash_table_remove_value_uint64(opal_hash_table_t* ht, uint64_t key)
         return OPAL_ERR_BAD_PARAM;
     }
 #endif
-    for(node =  (opal_uint64_hash_node_t*)opal_list_get_first(list);
-        node != (opal_uint64_hash_node_t*)opal_list_get_end(list);
-        node =  (opal_uint64_hash_node_t*)opal_list_get_next(node)) {
-        if (node->hn_key == key) {
-            opal_list_remove_item(list, (opal_list_item_t*)node);
-            opal_list_append(&ht->ht_nodes, (opal_list_item_t*)node);
-            ht->ht_size--;
-            return OPAL_SUCCESS;
-        }
-    } 
-    return OPAL_ERR_NOT_FOUND;
+    OPAL_HASH_TABLE_FIND(ht, hash, elt, elt->key.u64 == key);
+    if(NULL == elt) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+    opal_hash_table_erase(ht, elt);
+    return OPAL_SUCCESS;
 }
 
 /***************************************************************************/
 
 /*
- *  opal_ptr_hash_node_t
+ *  arbitrary size keys (the table keeps a copy of the key)
  */
 
-struct opal_ptr_hash_node_t
-{
-    opal_list_item_t super;
-    void*  hn_key;
-    size_t hn_key_size;
-    void*  hn_value;
-};
-typedef struct opal_ptr_hash_node_t opal_ptr_hash_node_t;
-
-static void opal_ptr_hash_node_construct(opal_ptr_hash_node_t* hn)
-{
-    hn->hn_key_size = 0;
-    hn->hn_key = NULL;
-    hn->hn_value = NULL;
-}
-
-static void opal_ptr_hash_node_destruct(opal_ptr_hash_node_t* hn)
-{
-    if(NULL != hn->hn_key) {
-        free(hn->hn_key);
-    }
-}
-
-static OBJ_CLASS_INSTANCE(opal_ptr_hash_node_t,
-                          opal_list_item_t,
-                          opal_ptr_hash_node_construct,
-                          opal_ptr_hash_node_destruct);
-
-static inline uint32_t opal_hash_value(size_t mask, const void *key,
-                                       size_t keysize)
-{
-    unsigned int crc = opal_uicrc_partial (key, keysize, 0);
-    return (uint32_t) (crc & mask);
-}
+#define OPAL_HASH_PTR_MATCH(elt, key, key_size)                         \
+    ((elt)->key_size == (key_size) &&                                   \
+     0 == memcmp((elt)->key.ptr, (key), (key_size)))
 
 int opal_hash_table_get_value_ptr(opal_hash_table_t* ht, const void* key,
 				  size_t key_size, void **ptr)
 {
-    opal_list_t* list = ht->ht_table + opal_hash_value(ht->ht_mask, key, 
-                                                       key_size);
-    opal_ptr_hash_node_t *node;
+    uint32_t hash = opal_hash_ptr(key, key_size);
+    opal_hash_element_t *elt;
 
 #if OPAL_ENABLE_DEBUG
     if(ht->ht_table_size == 0) {
@@ -372,25 +420,21 @@ int opal_hash_table_get_value_ptr(opal_hash_table_t* ht, const void* key,
         return OPAL_ERROR;
     }
 #endif
-    for(node =  (opal_ptr_hash_node_t*)opal_list_get_first(list);
-        node != (opal_ptr_hash_node_t*)opal_list_get_end(list);
-        node =  (opal_ptr_hash_node_t*)opal_list_get_next(node)) {
-        if (node->hn_key_size == key_size &&
-            memcmp(node->hn_key, key, key_size) == 0) {
-            *ptr = node->hn_value;
-	    return OPAL_SUCCESS;
-        }
-    } 
-    return OPAL_ERR_NOT_FOUND;
+    OPAL_HASH_TABLE_FIND(ht, hash, elt, OPAL_HASH_PTR_MATCH(elt, key, key_size));
+    if(NULL == elt) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+    *ptr = elt->value;
+    return OPAL_SUCCESS;
 }
 
 
 int opal_hash_table_set_value_ptr(opal_hash_table_t* ht, const void* key,
                                   size_t key_size, void* value)
 {
-    opal_list_t* list = ht->ht_table + opal_hash_value(ht->ht_mask, key,
-                                                       key_size);
-    opal_ptr_hash_node_t *node;
+    uint32_t hash = opal_hash_ptr(key, key_size);
+    opal_hash_element_t *elt, new_elt;
+    int rc;
 
 #if OPAL_ENABLE_DEBUG
     if(ht->ht_table_size == 0) {
@@ -399,28 +443,27 @@ int opal_hash_table_set_value_ptr(opal_hash_table_t* ht, const void* key,
         return OPAL_ERR_BAD_PARAM;
     }
 #endif
-    for(node =  (opal_ptr_hash_node_t*)opal_list_get_first(list);
-        node != (opal_ptr_hash_node_t*)opal_list_get_end(list);
-        node =  (opal_ptr_hash_node_t*)opal_list_get_next(node)) {
-        if (node->hn_key_size == key_size &&
-            memcmp(node->hn_key, key, key_size) == 0) {
-            node->hn_value = value;
-            return OPAL_SUCCESS;
-        }
-    } 
+    OPAL_HASH_TABLE_FIND(ht, hash, elt, OPAL_HASH_PTR_MATCH(elt, key, key_size));
+    if(NULL != elt) {
+        elt->value = value;
+        return OPAL_SUCCESS;
+    }
 
-    node = (opal_ptr_hash_node_t*)opal_list_remove_first(&ht->ht_nodes); 
-    if(NULL == node) {
-        node = OBJ_NEW(opal_ptr_hash_node_t);
-        if(NULL == node) {
+    if(OPAL_SUCCESS != (rc = opal_hash_table_reserve(ht))) {
+        return rc;
+    }
+    new_elt.hash = hash;
+    new_elt.key.ptr = NULL;
+    if(0 != key_size) {
+        new_elt.key.ptr = malloc(key_size);
+        if(NULL == new_elt.key.ptr) {
             return OPAL_ERR_OUT_OF_RESOURCE;
         }
+        memcpy(new_elt.key.ptr, key, key_size);
     }
-    node->hn_key = malloc(key_size);
-    node->hn_key_size = key_size;
-    node->hn_value = value;
-    memcpy(node->hn_key, key, key_size);
-    opal_list_append(list, (opal_list_item_t*)node);
+    new_elt.key_size = key_size;
+    new_elt.value = value;
+    opal_hash_table_insert(ht, new_elt);
     ht->ht_size++;
     return OPAL_SUCCESS;
 }
@@ -429,9 +472,8 @@ int opal_hash_table_set_value_ptr(opal_hash_table_t* ht, const void* key,
 int opal_hash_table_remove_value_ptr(opal_hash_table_t* ht,
                                      const void* key, size_t key_size)
 {
-    opal_list_t* list = ht->ht_table + opal_hash_value(ht->ht_mask,
-                                                       key, key_size);
-    opal_ptr_hash_node_t *node;
+    uint32_t hash = opal_hash_ptr(key, key_size);
+    opal_hash_element_t *elt;
 
 #if OPAL_ENABLE_DEBUG
     if(ht->ht_table_size == 0) {
@@ -440,163 +482,103 @@ int opal_hash_table_remove_value_ptr(opal_hash_table_t* ht,
         return OPAL_ERR_BAD_PARAM;
     }
 #endif
-    for(node =  (opal_ptr_hash_node_t*)opal_list_get_first(list);
-        node != (opal_ptr_hash_node_t*)opal_list_get_end(list);
-        node =  (opal_ptr_hash_node_t*)opal_list_get_next(node)) {
-        if (node->hn_key_size == key_size &&
-            memcmp(node->hn_key, key, key_size) == 0) {
-            free(node->hn_key);
-            node->hn_key = NULL;
-            node->hn_key_size = 0;
-            opal_list_remove_item(list, (opal_list_item_t*)node);
-            opal_list_append(&ht->ht_nodes, (opal_list_item_t*)node);
-            ht->ht_size--;
-            return OPAL_SUCCESS;
-        }
-    } 
- return OPAL_ERR_NOT_FOUND;
+    OPAL_HASH_TABLE_FIND(ht, hash, elt, OPAL_HASH_PTR_MATCH(elt, key, key_size));
+    if(NULL == elt) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+    if(NULL != elt->key.ptr) {
+        free(elt->key.ptr);
+    }
+    opal_hash_table_erase(ht, elt);
+    return OPAL_SUCCESS;
 }
 
+/***************************************************************************/
 
-int 
-opal_hash_table_get_first_key_uint32(opal_hash_table_t *ht, uint32_t *key, 
-                                     void **value, void **node)
+/*
+ * Iteration: the node handed back to the caller is the slot of the
+ * element, the next key is in the next used slot.
+ */
+
+static inline opal_hash_element_t *
+opal_hash_table_next_used(opal_hash_table_t *ht, size_t i)
 {
-    size_t i;
-    opal_uint32_hash_node_t *list_node;
-
-    /* Go through all the lists and return the first element off the
-       first non-empty list */
-    
-    for (i = 0; i < ht->ht_table_size; ++i) {
-        if (opal_list_get_size(ht->ht_table + i) > 0) {
-            list_node = (opal_uint32_hash_node_t*)
-                opal_list_get_first(ht->ht_table + i);
-            *node = list_node;
-            *key = list_node->hn_key;
-            *value = list_node->hn_value;
-            return OPAL_SUCCESS;
+    for (; i < ht->ht_table_size; ++i) {
+        if (0 != ht->ht_table[i].psl) {
+            return ht->ht_table + i;
         }
     }
+    return NULL;
+}
 
-    /* The hash table is empty */
 
-    return OPAL_ERROR;
+int
+opal_hash_table_get_first_key_uint32(opal_hash_table_t *ht, uint32_t *key,
+                                     void **value, void **node)
+{
+    opal_hash_element_t *elt = opal_hash_table_next_used(ht, 0);
+
+    if (NULL == elt) {
+        /* The hash table is empty */
+        return OPAL_ERROR;
+    }
+    *node = elt;
+    *key = elt->key.u32;
+    *value = elt->value;
+    return OPAL_SUCCESS;
 }
 
 
-int 
+int
 opal_hash_table_get_next_key_uint32(opal_hash_table_t *ht, uint32_t *key,
-                                    void **value, void *in_node, 
+                                    void **value, void *in_node,
                                     void **out_node)
 {
-    size_t i;
-    opal_list_t *list;
-    opal_list_item_t *item;
-    opal_uint32_hash_node_t *next;
-
-    /* Try to simply get the next value in the list.  If there isn't
-       one, find the next non-empty list and take the first value */
-
-    next = (opal_uint32_hash_node_t*) in_node;
-    list = ht->ht_table + (next->hn_key & ht->ht_mask);
-    item = opal_list_get_next(next);
-    if (opal_list_get_end(list) == item) {
-        item = NULL;
-        for (i = (list - ht->ht_table) + 1; i < ht->ht_table_size; ++i) {
-            if (opal_list_get_size(ht->ht_table + i) > 0) {
-                item = opal_list_get_first(ht->ht_table + i);
-                break;
-            }
-        }
+    opal_hash_element_t *elt = (opal_hash_element_t *) in_node;
 
-        /* If we didn't find another non-empty list after this one,
-           then we're at the end of the hash table */
-
-        if (NULL == item) {
-            return OPAL_ERROR;
-        }
+    elt = opal_hash_table_next_used(ht, (elt - ht->ht_table) + 1);
+    if (NULL == elt) {
+        /* we're at the end of the hash table */
+        return OPAL_ERROR;
     }
-
-    /* We found it.  Save the values (use "next" to avoid some
-       typecasting) */
-
-    *out_node = (void *) item;
-    next = (opal_uint32_hash_node_t *) *out_node;
-    *key = next->hn_key;
-    *value = next->hn_value;
-
+    *out_node = elt;
+    *key = elt->key.u32;
+    *value = elt->value;
     return OPAL_SUCCESS;
 }
 
 
-int 
+int
 opal_hash_table_get_first_key_uint64(opal_hash_table_t *ht, uint64_t *key,
                                      void **value, void **node)
 {
-    size_t i;
-    opal_uint64_hash_node_t *list_node;
-
-    /* Go through all the lists and return the first element off the
-       first non-empty list */
-    
-    for (i = 0; i < ht->ht_table_size; ++i) {
-        if (opal_list_get_size(ht->ht_table + i) > 0) {
-            list_node = (opal_uint64_hash_node_t*)
-                opal_list_get_first(ht->ht_table + i);
-            *node = list_node;
-            *key = list_node->hn_key;
-            *value = list_node->hn_value;
-            return OPAL_SUCCESS;
-        }
-    }
+    opal_hash_element_t *elt = opal_hash_table_next_used(ht, 0);
 
-    /* The hash table is empty */
-
-    return OPAL_ERROR;
+    if (NULL == elt) {
+        /* The hash table is empty */
+        return OPAL_ERROR;
+    }
+    *node = elt;
+    *key = elt->key.u64;
+    *value = elt->value;
+    return OPAL_SUCCESS;
 }
 
 
-int 
+int
 opal_hash_table_get_next_key_uint64(opal_hash_table_t *ht, uint64_t *key,
-                                    void **value, void *in_node, 
+                                    void **value, void *in_node,
                                     void **out_node)
 {
-    size_t i;
-    opal_list_t *list;
-    opal_list_item_t *item;
-    opal_uint64_hash_node_t *next;
-
-    /* Try to simply get the next value in the list.  If there isn't
-       one, find the next non-empty list and take the first value */
-
-    next = (opal_uint64_hash_node_t*) in_node;
-    list = ht->ht_table + (next->hn_key & ht->ht_mask);
-    item = opal_list_get_next(next);
-    if (opal_list_get_end(list) == item) {
-        item = NULL;
-        for (i = (list - ht->ht_table) + 1; i < ht->ht_table_size; ++i) {
-            if (opal_list_get_size(ht->ht_table + i) > 0) {
-                item = opal_list_get_first(ht->ht_table + i);
-                break;
-            }
-        }
+    opal_hash_element_t *elt = (opal_hash_element_t *) in_node;
 
-        /* If we didn't find another non-empty list after this one,
-           then we're at the end of the hash table */
-
-        if (NULL == item) {
-            return OPAL_ERROR;
-        }
+    elt = opal_hash_table_next_used(ht, (elt - ht->ht_table) + 1);
+    if (NULL == elt) {
+        /* we're at the end of the hash table */
+        return OPAL_ERROR;
     }
-
-    /* We found it.  Save the values (use "next" to avoid some
-       typecasting) */
-
-    *out_node = (void *) item;
-    next = (opal_uint64_hash_node_t *) *out_node;
-    *key = next->hn_key;
-    *value = next->hn_value;
-
+    *out_node = elt;
+    *key = elt->key.u64;
+    *value = elt->value;
     return OPAL_SUCCESS;
 }
@@ -38,13 +38,35 @@
 BEGIN_C_DECLS
 
 OPAL_DECLSPEC OBJ_CLASS_DECLARATION(opal_hash_table_t);
-                           
+
+/*
+ * The table uses open addressing with linear probing and Robin Hood
+ * insertion: an element being inserted takes the slot of any element
+ * that is closer to its home slot, which keeps the probe sequences
+ * short and lets an unsuccessful lookup stop as soon as it meets an
+ * element closer to home than the key would be.  All the elements
+ * live in one array, so there is no allocation per element (except
+ * for the copy of pointer keys) and a probe walks consecutive memory.
+ */
+struct opal_hash_element_t
+{
+    uint32_t            psl;            /**< 0 if the slot is empty, else 1 + distance to the home slot */
+    uint32_t            hash;           /**< hash value of the key */
+    union {
+        uint32_t        u32;
+        uint64_t        u64;
+        void           *ptr;
+    } key;
+    size_t              key_size;       /**< size of a pointer key, 0 for integer keys */
+    void               *value;
+};
+typedef struct opal_hash_element_t opal_hash_element_t;
+
 struct opal_hash_table_t
 {
     opal_object_t        super;          /**< subclass of opal_object_t */
-    opal_list_t          ht_nodes;       /**< free list of hash nodes */
-    opal_list_t         *ht_table;       /**< each item is an array of opal_fhnode_t nodes */
-    size_t              ht_table_size;  /**< size of table */
+    opal_hash_element_t *ht_table;       /**< array of ht_table_size elements */
+    size_t              ht_table_size;  /**< size of table (a power of two) */
     size_t              ht_size;        /**< number of values on table */
     size_t              ht_mask;
 };
@@ -57,8 +79,9 @@ typedef struct opal_hash_table_t opal_hash_table_t;
  *  the table.
  *
  *  @param   table   The input hash table (IN).
- *  @param   size    The size of the table, which will be rounded up 
- *                   (if required) to the next highest power of two (IN).
+ *  @param   size    The expected number of elements.  The table is
+ *                   sized to hold them without growing, and grows
+ *                   (by doubling) if more are added (IN).
  *  @return  OPAL error code.
  *
  */
@@ -209,12 +232,10 @@ OPAL_DECLSPEC int opal_hash_table_remove_value_ptr(opal_hash_table_t *table, con
 
 /** The following functions are only for allowing iterating through
     the hash table. The calls return along with a key, a pointer to
-    the hash node with the current key, so that subsequent calls do
-    not have to traverse all over again to the key (although it may
-    just be a simple thing - to go to the array element and then
-    traverse through the individual list). But lets take out this
-    inefficiency too. This is similar to having an STL iterator in
-    functionality */
+    the hash element with the current key, so that subsequent calls
+    can simply continue the scan of the table from there. This is
+    similar to having an STL iterator in functionality. Adding or
+    removing keys while iterating invalidates the iterator. */
 
 /**
  *  Get the first 32 bit key from the hash table, which can be used later to
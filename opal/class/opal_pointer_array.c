@@ -21,6 +21,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 #include "opal/constants.h"
@@ -49,6 +50,8 @@ static void opal_pointer_array_construct(opal_pointer_array_t *array)
     array->max_size = INT_MAX;
     array->block_size = 0;
     array->addr = 0;
+    array->retired = NULL;
+    array->num_retired = 0;
 }
 
 /*
@@ -61,6 +64,14 @@ static void opal_pointer_array_destruct(opal_pointer_array_t *array)
         free(array->addr);
         array->addr = NULL;
     }
+    /* nobody can be reading the older ones anymore */
+    while( array->num_retired > 0 ) {
+        free(array->retired[--array->num_retired]);
+    }
+    if( NULL != array->retired ) {
+        free(array->retired);
+        array->retired = NULL;
+    }
 
     array->size = 0;
 
@@ -309,12 +320,18 @@ static bool grow_table(opal_pointer_array_t *table, int soft, int hard)
 {
     int new_size;
     int i, new_size_int;
-    void *p;
+    void **p, **old, ***retired;
 
     /* new_size = ((table->size + num_needed + table->block_size - 1) /
        table->block_size) * table->block_size; */
     new_size = soft;
-    if( soft > table->max_size ) {
+    /* every grow leaves the old array behind for the readers, so grow
+       at least geometrically to keep that bounded by the current size */
+    if( (table->size < INT_MAX / TABLE_GROW) && (new_size < table->size * TABLE_GROW) &&
+        (table->size * TABLE_GROW < table->max_size) ) {
+        new_size = table->size * TABLE_GROW;
+    }
+    if( new_size > table->max_size ) {
         if( hard > table->max_size ) {
             return false;
         }
@@ -324,18 +341,34 @@ static bool grow_table(opal_pointer_array_t *table, int soft, int hard)
         return false;
     }
 
-    p = (void **) realloc(table->addr, new_size * sizeof(void *));
+    /* readers do not lock, the current array cannot be reallocated */
+    p = (void **) malloc(new_size * sizeof(void *));
     if (p == NULL) {
         return false;
     }
+    if( NULL != table->addr ) {
+        retired = (void ***) realloc(table->retired, (table->num_retired + 1) * sizeof(void **));
+        if (retired == NULL) {
+            free(p);
+            return false;
+        }
+        table->retired = retired;
+        memcpy(p, table->addr, table->size * sizeof(void *));
+    }
     
     new_size_int = (int) new_size;
-    table->number_free += new_size_int - table->size;
-    table->addr = (void**)p;
     for (i = table->size; i < new_size_int; ++i) {
-        table->addr[i] = NULL;
+        p[i] = NULL;
     }
+    old = table->addr;
+    table->addr = p;
+    /* the new array must be visible before the size that goes with it */
+    opal_atomic_wmb();
+    table->number_free += new_size_int - table->size;
     table->size = new_size_int;
+    if( NULL != old ) {
+        table->retired[table->num_retired++] = old;
+    }
 
     return true;
 }
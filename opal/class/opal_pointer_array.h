@@ -35,6 +35,7 @@
 #include "opal_config.h"
 
 #include "opal/threads/mutex.h"
+#include "opal/sys/atomic.h"
 #include "opal/class/opal_object.h"
 
 BEGIN_C_DECLS
@@ -62,6 +63,11 @@ struct opal_pointer_array_t {
     int block_size;
     /** pointer to array of pointers */
     void **addr;
+    /** arrays replaced by a larger one, which a reader may still be
+        looking at: they are only freed with the pointer array */
+    void ***retired;
+    /** number of retired arrays */
+    int num_retired;
 };
 /**
  * Convenience typedef
@@ -120,20 +126,20 @@ OPAL_DECLSPEC int opal_pointer_array_set_item(opal_pointer_array_t *array,
  * @param element_index  Index of element to be returned (IN)
  *
  * @return Error code.  NULL indicates an error.
+ *
+ * Does not take the lock: a larger array is published before its size,
+ * and the array it replaces is kept until the destruction, so a reader
+ * racing with a grow sees either one, both valid up to the size it read.
  */
 
 static inline void *opal_pointer_array_get_item(opal_pointer_array_t *table, 
                                                 int element_index)
 {
-    void *p;
-
     if( table->size <= element_index ) {
         return NULL;
     }
-    OPAL_THREAD_LOCK(&(table->lock));
-    p = table->addr[element_index];
-    OPAL_THREAD_UNLOCK(&(table->lock));
-    return p;
+    opal_atomic_rmb();
+    return table->addr[element_index];
 }
 
 
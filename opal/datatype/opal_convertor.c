@@ -165,6 +165,7 @@ opal_convertor_master_t* opal_convertor_find_or_create_master( uint32_t remote_a
         hetero_mask &= ~(((uint32_t)1) << OPAL_DATATYPE_BOOL);
         master->hetero_mask |= hetero_mask;
     }
+    opal_datatype_heterogeneous_init();
     master->pFunctions = (conversion_fct_t*)malloc( sizeof(opal_datatype_heterogeneous_copy_functions) );
     /**
      * Usually the heterogeneous functions are slower than the copy ones. Let's
@@ -415,6 +416,11 @@ int32_t opal_convertor_set_position_nocheck( opal_convertor_t* convertor,
 {
     int32_t rc;
 
+    if( convertor->flags & CONVERTOR_STRIDED ) {
+        /* the strided functions only need bConverted to find their way */
+        convertor->bConverted = *position;
+        return OPAL_SUCCESS;
+    }
     /**
      * If we plan to rollback the convertor then first we have to set it
      * at the beginning.
@@ -463,6 +469,16 @@ int32_t opal_convertor_set_position_nocheck( opal_convertor_t* convertor,
     assert(0 == (bdt_mask))
 #endif  /* OPAL_ENABLE_HETEROGENEOUS_SUPPORT */
 
+/*
+ * The strided functions only copy bytes around. They are used for
+ * datatypes with a regular shape (computed at commit time) as soon as
+ * there is no conversion to be done and the data is in host memory.
+ */
+#define OPAL_CONVERTOR_CAN_USE_STRIDED(convertor)                       \
+    ((NULL != (convertor)->pDesc->strided) &&                           \
+     ((convertor)->flags & CONVERTOR_HOMOGENEOUS) &&                    \
+     !((convertor)->flags & CONVERTOR_CUDA))
+
 /**
  * This macro will initialize a convertor based on a previously created
  * convertor. The idea is the move outside these function the heavy
@@ -520,9 +536,21 @@ int32_t opal_convertor_set_position_nocheck( opal_convertor_t* convertor,
             return OPAL_SUCCESS;                                        \
         }                                                               \
         convertor->flags &= ~CONVERTOR_NO_OP;                           \
-        {                                                               \
+        /* The regular shapes do not need any stack, the position is    \
+         * enough to find the next block */                             \
+        if( !(convertor->flags & (CONVERTOR_WITH_CHECKSUM | OPAL_DATATYPE_FLAG_CONTIGUOUS)) && \
+            OPAL_CONVERTOR_CAN_USE_STRIDED(convertor) ) {               \
+            convertor->flags |= CONVERTOR_STRIDED;                      \
+            convertor->stack_pos = 0;                                   \
+            convertor->partial_length = 0;                              \
+        } else {                                                        \
             uint32_t required_stack_length = datatype->btypes[OPAL_DATATYPE_LOOP] + 1; \
                                                                         \
+            /* the contiguous functions only use the first two levels */ \
+            if( (convertor->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS) &&   \
+                (convertor->flags & (CONVERTOR_SEND | CONVERTOR_HOMOGENEOUS)) ) { \
+                required_stack_length = 2;                              \
+            }                                                           \
             if( required_stack_length > convertor->stack_size ) {       \
                 convertor->stack_size = required_stack_length;          \
                 convertor->pStack     = (dt_stack_t*)malloc(sizeof(dt_stack_t) * \
@@ -531,11 +559,39 @@ int32_t opal_convertor_set_position_nocheck( opal_convertor_t* convertor,
                 convertor->pStack = convertor->static_stack;            \
                 convertor->stack_size = DT_STATIC_STACK_SIZE;           \
             }                                                           \
+            opal_convertor_create_stack_at_begining( convertor, opal_datatype_local_sizes ); \
         }                                                               \
-        opal_convertor_create_stack_at_begining( convertor, opal_datatype_local_sizes ); \
     }
 
 
+#if OPAL_ENABLE_HETEROGENEOUS_SUPPORT
+/*
+ * A heterogeneous receive can skip the description when the data is a
+ * gapless run of one basic type that only differs by its endianness
+ * (same size on both sides).
+ */
+static inline bool
+opal_convertor_can_use_general_contig( const opal_convertor_t* convertor )
+{
+    const opal_datatype_t* datatype = convertor->pDesc;
+    uint32_t types = datatype->bdt_used;
+    int type;
+
+    if( (convertor->flags & CONVERTOR_CUDA) ||
+        !(datatype->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS) ||
+        ((datatype->ub - datatype->lb) != (OPAL_PTRDIFF_TYPE)datatype->size &&
+         1 < convertor->count) ||
+        0 == types || 0 != (types & (types - 1)) ) {
+        return false;
+    }
+    type = convertor->use_desc->desc[0].elem.common.type;
+    return (((uint32_t)1) << type) == types &&
+        OPAL_DATATYPE_BOOL != type &&
+        NULL != convertor->master->pFunctions[type] &&
+        convertor->master->remote_sizes[type] == opal_datatype_local_sizes[type];
+}
+#endif  /* OPAL_ENABLE_HETEROGENEOUS_SUPPORT */
+
 int32_t opal_convertor_prepare_for_recv( opal_convertor_t* convertor,
                                          const struct opal_datatype_t* datatype,
                                          int32_t count,
@@ -564,11 +620,17 @@ int32_t opal_convertor_prepare_for_recv( opal_convertor_t* convertor,
     } else {
 #if OPAL_ENABLE_HETEROGENEOUS_SUPPORT
         if( !(convertor->flags & CONVERTOR_HOMOGENEOUS) ) {
-            convertor->fAdvance = opal_unpack_general;
+            if( opal_convertor_can_use_general_contig(convertor) ) {
+                convertor->fAdvance = opal_unpack_general_contig;
+            } else {
+                convertor->fAdvance = opal_unpack_general;
+            }
         } else
 #endif
         if( convertor->pDesc->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS ) {
             convertor->fAdvance = opal_unpack_homogeneous_contig;
+        } else if( convertor->flags & CONVERTOR_STRIDED ) {
+            convertor->fAdvance = opal_unpack_homogeneous_strided;
         } else {
             convertor->fAdvance = opal_generic_simple_unpack;
         }
@@ -606,6 +668,8 @@ int32_t opal_convertor_prepare_for_send( opal_convertor_t* convertor,
                 convertor->fAdvance = opal_pack_homogeneous_contig;
             else
                 convertor->fAdvance = opal_pack_homogeneous_contig_with_gaps;
+        } else if( convertor->flags & CONVERTOR_STRIDED ) {
+            convertor->fAdvance = opal_pack_homogeneous_strided;
         } else {
             convertor->fAdvance = opal_generic_simple_pack;
         }
@@ -61,6 +61,7 @@ BEGIN_C_DECLS
 #define CONVERTOR_STATE_COMPLETE   0x02000000
 #define CONVERTOR_STATE_ALLOC      0x04000000
 #define CONVERTOR_COMPLETED        0x08000000
+#define CONVERTOR_STRIDED          0x10000000  /**< regular shape: no stack, the position is bConverted */
 
 union dt_elem_desc;
 typedef struct opal_convertor_t opal_convertor_t;
@@ -280,6 +281,21 @@ opal_convertor_raw( opal_convertor_t* convertor,  /* [IN/OUT] */
                     uint32_t* iov_count,          /* [IN/OUT] */
                     size_t* length );             /* [OUT]    */
 
+/*
+ * Describe at most *length bytes of the data, starting at the current
+ * position, with at most *iov_count iovecs pointing into the user buffer.
+ * This allows a zero-copy gather of the data (writev, scatter/gather
+ * lists). Only available for the datatypes with a regular shape that are
+ * handled by the strided functions: returns OPAL_ERR_NOT_SUPPORTED,
+ * without moving the convertor, for the others. Otherwise it returns 1
+ * once all the data has been described and 0 if not.
+ */
+OPAL_DECLSPEC int32_t
+opal_convertor_gather( opal_convertor_t* convertor,  /* [IN/OUT] */
+                       struct iovec* iov,            /* [IN/OUT] */
+                       uint32_t* iov_count,          /* [IN/OUT] */
+                       size_t* length );             /* [IN/OUT] */
+
 /*
  * Upper level does not need to call the _nocheck function directly.
  */
@@ -316,6 +332,11 @@ opal_convertor_set_position( opal_convertor_t* convertor,
         convertor->bConverted = *position;
         return OPAL_SUCCESS;
     }
+    if( convertor->flags & CONVERTOR_STRIDED ) {
+        /* the strided functions compute their position from bConverted */
+        convertor->bConverted = *position;
+        return OPAL_SUCCESS;
+    }
 
     return opal_convertor_set_position_nocheck( convertor, position );
 }
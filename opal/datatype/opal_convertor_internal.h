@@ -50,6 +50,12 @@ opal_convertor_master_t* opal_convertor_find_or_create_master( uint32_t remote_a
  */
 void opal_convertor_destroy_masters( void );
 
+/*
+ * Pick the byte-swap kernels of the heterogeneous conversion functions
+ * for this CPU, before the first heterogeneous master is set up.
+ */
+void opal_datatype_heterogeneous_init( void );
+
 END_C_DECLS
 
 #endif  /* OPAL_CONVERTOR_INTERNAL_HAS_BEEN_INCLUDED */
@@ -67,6 +67,13 @@ opal_convertor_raw( opal_convertor_t* pConvertor,
         *iov_count = 1;
         return 1;  /* we're done */
     }
+    if( pConvertor->flags & CONVERTOR_STRIDED ) {
+        /* No stack for the regular shapes, the blocks are found from
+         * bConverted.
+         */
+        *length = pConvertor->local_size - pConvertor->bConverted;
+        return opal_convertor_gather( pConvertor, iov, iov_count, length );
+    }
 
     DO_DEBUG( opal_output( 0, "opal_convertor_raw( %p, {%p, %u}, %lu )\n", (void*)pConvertor,
                            (void*)iov, *iov_count, (unsigned long)*length ); );
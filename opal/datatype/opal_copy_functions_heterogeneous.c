@@ -14,9 +14,14 @@
 #include "opal_config.h"
 
 #include <stddef.h>
+#include <string.h>
 #ifdef HAVE_STDINT_H
 #include <stdint.h>
 #endif
+#if defined(__x86_64__) && defined(__GNUC__) && defined(HAVE_CPUID_H)
+#include <cpuid.h>
+#define OPAL_DT_SWAP_SSSE3 1
+#endif
 
 #include "opal/util/arch.h"
 
@@ -51,6 +56,113 @@ opal_dt_swap_bytes(void *to_p, const void *from_p, const size_t size)
     }
 }
 
+/*
+ * Byte-swap count contiguous elements of 2, 4 or 8 bytes, a word at a
+ * time (the compilers turn the shifts into bswap/rol).  The buffers
+ * don't have to be aligned.
+ */
+static void
+opal_dt_swap_contig_word(void *to_p, const void *from_p, size_t count, size_t size)
+{
+    uint8_t *to = (uint8_t*) to_p;
+    const uint8_t *from = (const uint8_t*) from_p;
+    size_t i;
+
+    switch( size ) {
+    case 2:
+        for( i = 0; i < count; i++, to += 2, from += 2 ) {
+            uint16_t v;
+            memcpy(&v, from, 2);
+            v = (uint16_t)((v << 8) | (v >> 8));
+            memcpy(to, &v, 2);
+        }
+        break;
+    case 4:
+        for( i = 0; i < count; i++, to += 4, from += 4 ) {
+            uint32_t v;
+            memcpy(&v, from, 4);
+            v = (v << 24) | ((v << 8) & 0x00ff0000U) |
+                ((v >> 8) & 0x0000ff00U) | (v >> 24);
+            memcpy(to, &v, 4);
+        }
+        break;
+    case 8:
+        for( i = 0; i < count; i++, to += 8, from += 8 ) {
+            uint64_t v;
+            memcpy(&v, from, 8);
+            v = ((v << 8) & 0xff00ff00ff00ff00ULL) | ((v >> 8) & 0x00ff00ff00ff00ffULL);
+            v = ((v << 16) & 0xffff0000ffff0000ULL) | ((v >> 16) & 0x0000ffff0000ffffULL);
+            v = (v << 32) | (v >> 32);
+            memcpy(to, &v, 8);
+        }
+        break;
+    default:
+        for( i = 0; i < count; i++, to += size, from += size ) {
+            opal_dt_swap_bytes(to, from, size);
+        }
+    }
+}
+
+#if defined(OPAL_DT_SWAP_SSSE3)
+/* pshufb masks reversing the bytes of every 2, 4 and 8 bytes element */
+static const uint8_t opal_dt_swap_mask[3][16] __attribute__((aligned(16))) = {
+    { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 },
+    { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+    { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 } };
+
+/* 64 bytes per step with pshufb, the word loop for what remains */
+static void
+opal_dt_swap_contig_ssse3(void *to_p, const void *from_p, size_t count, size_t size)
+{
+    uint8_t *to = (uint8_t*) to_p;
+    const uint8_t *from = (const uint8_t*) from_p;
+    const uint8_t *mask;
+    size_t len = count * size;
+
+    switch( size ) {
+    case 2: mask = opal_dt_swap_mask[0]; break;
+    case 4: mask = opal_dt_swap_mask[1]; break;
+    case 8: mask = opal_dt_swap_mask[2]; break;
+    default:
+        opal_dt_swap_contig_word(to, from, count, size);
+        return;
+    }
+    for( ; len >= 64; len -= 64, to += 64, from += 64 ) {
+        __asm__ __volatile__ ("movdqa   %2, %%xmm4\n\t"
+                              "movdqu   (%1), %%xmm0\n\t"
+                              "movdqu 16(%1), %%xmm1\n\t"
+                              "movdqu 32(%1), %%xmm2\n\t"
+                              "movdqu 48(%1), %%xmm3\n\t"
+                              "pshufb %%xmm4, %%xmm0\n\t"
+                              "pshufb %%xmm4, %%xmm1\n\t"
+                              "pshufb %%xmm4, %%xmm2\n\t"
+                              "pshufb %%xmm4, %%xmm3\n\t"
+                              "movdqu %%xmm0,   (%0)\n\t"
+                              "movdqu %%xmm1, 16(%0)\n\t"
+                              "movdqu %%xmm2, 32(%0)\n\t"
+                              "movdqu %%xmm3, 48(%0)"
+                              : : "r" (to), "r" (from), "m" (*(const uint8_t (*)[16]) mask)
+                              : "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "memory");
+    }
+    opal_dt_swap_contig_word(to, from, len / size, size);
+}
+#endif  /* defined(OPAL_DT_SWAP_SSSE3) */
+
+/* the kernel for the contiguous runs, pshufb when the CPU has SSSE3 */
+static void (*opal_dt_swap_contig)(void *to, const void *from, size_t count, size_t size) =
+    opal_dt_swap_contig_word;
+
+void opal_datatype_heterogeneous_init( void )
+{
+#if defined(OPAL_DT_SWAP_SSSE3)
+    unsigned int eax, ebx, ecx, edx;
+
+    if( __get_cpuid(1, &eax, &ebx, &ecx, &edx) && 0 != (ecx & (1 << 9)) ) {
+        opal_dt_swap_contig = opal_dt_swap_contig_ssse3;
+    }
+#endif
+}
+
 
 #define COPY_TYPE_HETEROGENEOUS( TYPENAME, TYPE )                                         \
 static int32_t                                                                            \
@@ -67,10 +179,16 @@ copy_##TYPENAME##_heterogeneous(opal_convertor_t *pConvertor, uint32_t count,
                                                                         \
     if ((pConvertor->remoteArch & OPAL_ARCH_ISBIGENDIAN) !=             \
         (opal_local_arch & OPAL_ARCH_ISBIGENDIAN)) {                    \
-        for( i = 0; i < count; i++ ) {                                  \
-            opal_dt_swap_bytes(to, from, sizeof(TYPE));                 \
-            to += to_extent;                                            \
-            from += from_extent;                                        \
+        if ((OPAL_PTRDIFF_TYPE)sizeof(TYPE) == to_extent &&             \
+            (OPAL_PTRDIFF_TYPE)sizeof(TYPE) == from_extent) {           \
+            /* a single run, the vector kernel */                       \
+            opal_dt_swap_contig(to, from, count, sizeof(TYPE));         \
+        } else {                                                        \
+            for( i = 0; i < count; i++ ) {                              \
+                opal_dt_swap_bytes(to, from, sizeof(TYPE));             \
+                to += to_extent;                                        \
+                from += from_extent;                                    \
+            }                                                           \
         }                                                               \
     } else if ((OPAL_PTRDIFF_TYPE)sizeof(TYPE) == to_extent &&          \
                (OPAL_PTRDIFF_TYPE)sizeof(TYPE) == from_extent) {        \
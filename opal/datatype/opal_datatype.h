@@ -56,7 +56,7 @@ BEGIN_C_DECLS
  *
  * XXX TODO Adapt to whatever the OMPI-layer needs
  */
-#define OPAL_DATATYPE_MAX_SUPPORTED  47
+#define OPAL_DATATYPE_MAX_SUPPORTED  49
 
 
 /* flags for the datatypes. */
@@ -96,6 +96,24 @@ struct dt_type_desc_t {
 };
 typedef struct dt_type_desc_t dt_type_desc_t;
 
+/**
+ * Regular shape of a datatype: equally sized blocks spaced by constant
+ * strides over up to OPAL_DATATYPE_MAX_STRIDED_DIMS nested dimensions.
+ * It is extracted from the optimized description at commit time and
+ * allows the convertor to use the specialized strided pack/unpack
+ * functions instead of the generic stack based engine.
+ */
+#define OPAL_DATATYPE_MAX_STRIDED_DIMS 3
+
+struct opal_datatype_strided_t {
+    uint32_t           dims;     /**< number of dimensions */
+    uint32_t           count[OPAL_DATATYPE_MAX_STRIDED_DIMS];  /**< blocks in each dimension, innermost first */
+    OPAL_PTRDIFF_TYPE  stride[OPAL_DATATYPE_MAX_STRIDED_DIMS]; /**< distance in bytes between two consecutive blocks */
+    size_t             blen;     /**< length in bytes of each block */
+    OPAL_PTRDIFF_TYPE  disp;     /**< displacement of the first block */
+};
+typedef struct opal_datatype_strided_t opal_datatype_strided_t;
+
 
 /*
  * The datatype description.
@@ -127,10 +145,13 @@ struct opal_datatype_t {
                                       datatype for remote nodes. The length of the array is dependent on
                                       the maximum number of datatypes of all top layers.
                                       Reason being is that Fortran is not at the OPAL layer. */
-    /* --- cacheline 5 boundary (320 bytes) was 32-36 bytes ago --- */
+    /* --- cacheline 5 boundary (320 bytes) was 40-44 bytes ago --- */
+    opal_datatype_strided_t* strided;
+                                 /**< regular shape of the data, set by opal_datatype_commit.
+                                      NULL if the datatype has none */
 
-    /* size: 352, cachelines: 6, members: 15 */
-    /* last cacheline: 28-32 bytes */
+    /* size: 368, cachelines: 6, members: 16 */
+    /* last cacheline: 44-48 bytes */
 };
 
 typedef struct opal_datatype_t opal_datatype_t;
@@ -182,6 +203,11 @@ OPAL_DECLSPEC int32_t opal_datatype_finalize( void );
 OPAL_DECLSPEC opal_datatype_t* opal_datatype_create( int32_t expectedSize );
 OPAL_DECLSPEC int32_t opal_datatype_create_desc( opal_datatype_t * datatype, int32_t expectedSize );
 OPAL_DECLSPEC int32_t opal_datatype_commit( opal_datatype_t * pData );
+/**
+ * Commit pData using the optimized description of model, a committed
+ * datatype with the same description. This avoids the optimization pass.
+ */
+OPAL_DECLSPEC int32_t opal_datatype_commit_from( opal_datatype_t * pData, const opal_datatype_t * model );
 OPAL_DECLSPEC int32_t opal_datatype_destroy( opal_datatype_t** );
 
 static inline int32_t
@@ -63,6 +63,11 @@ int32_t opal_datatype_clone( const opal_datatype_t * src_type, opal_datatype_t *
             }
         }
     }
+    if( NULL != src_type->strided ) {
+        dest_type->strided = (opal_datatype_strided_t*)malloc( sizeof(opal_datatype_strided_t) );
+        if( NULL != dest_type->strided )
+            *(dest_type->strided) = *(src_type->strided);
+    }
     dest_type->id  = src_type->id;  /* preserve the default id. This allow us to
                                      * copy predefined types. */
     return OPAL_SUCCESS;
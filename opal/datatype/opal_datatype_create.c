@@ -43,6 +43,7 @@ static void opal_datatype_construct( opal_datatype_t* pData )
     pData->opt_desc.desc      = NULL;
     pData->opt_desc.length    = 0;
     pData->opt_desc.used      = 0;
+    pData->strided            = NULL;
     pData->align              = 1;
     pData->flags              = OPAL_DATATYPE_FLAG_CONTIGUOUS;
     pData->true_lb            = LONG_MAX;
@@ -67,6 +68,10 @@ static void opal_datatype_destruct( opal_datatype_t* datatype )
             datatype->opt_desc.used   = 0;
             datatype->opt_desc.desc   = NULL;
         }
+        if( NULL != datatype->strided ) {
+            free( datatype->strided );
+            datatype->strided = NULL;
+        }
     }
     /**
      * As the default description and the optimized description can point to the
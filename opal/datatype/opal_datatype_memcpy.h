@@ -14,7 +14,10 @@
 #ifndef OPAL_DATATYPE_MEMCPY_H_HAS_BEEN_INCLUDED
 #define OPAL_DATATYPE_MEMCPY_H_HAS_BEEN_INCLUDED
 
+#include "opal/mca/memcpy/base/base.h"
+
+/* large copies bypass the cache when the memcpy component supports it */
 #define MEMCPY( DST, SRC, BLENGTH ) \
-    memcpy( (DST), (SRC), (BLENGTH) )
+    opal_memcpy( (DST), (SRC), (BLENGTH) )
 
 #endif  /* OPAL_DATATYPE_MEMCPY_H_HAS_BEEN_INCLUDED */
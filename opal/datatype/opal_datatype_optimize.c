@@ -25,6 +25,7 @@
 #include <alloca.h>
 #endif
 #include <stdlib.h>
+#include <string.h>
 
 #include "opal/datatype/opal_datatype.h"
 #include "opal/datatype/opal_convertor.h"
@@ -275,6 +276,55 @@ opal_datatype_optimize_short( opal_datatype_t* pData,
     return OPAL_SUCCESS;
 }
 
+/*
+ * Look for a regular shape in the optimized description: a chain of
+ * loops, each one holding only the next one, around a single element.
+ * This covers the vectors and the 2D/3D subarrays, which will then be
+ * packed and unpacked by the strided functions.
+ */
+static void opal_datatype_compute_strided( opal_datatype_t* pData )
+{
+    opal_datatype_strided_t shape, *strided = &shape;
+    dt_elem_desc_t* pElem = pData->opt_desc.desc;
+    uint32_t nb_loops = 0, dims = 0, i;
+    ddt_elem_desc_t* elem;
+    size_t basic_size;
+
+    if( pData->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS ) return;
+
+    while( OPAL_DATATYPE_LOOP == pElem[nb_loops].elem.common.type ) nb_loops++;
+    if( pData->opt_desc.used != (2 * nb_loops + 1) ) return;
+    for( i = 0; i < nb_loops; i++ ) {
+        if( pElem[i].loop.items != 2 * (nb_loops - i) ) return;
+    }
+    elem = &(pElem[nb_loops].elem);
+    if( !(elem->common.flags & OPAL_DATATYPE_FLAG_DATA) || (0 == elem->count) ) return;
+
+    basic_size = opal_datatype_basicDatatypes[elem->common.type]->size;
+    if( (OPAL_PTRDIFF_TYPE)basic_size == elem->extent ) {
+        strided->blen = basic_size * elem->count;
+    } else {
+        /* the element itself is a strided set of basic types */
+        strided->blen = basic_size;
+        strided->count[dims]  = elem->count;
+        strided->stride[dims] = elem->extent;
+        dims++;
+    }
+    for( i = nb_loops; i > 0; i-- ) {
+        if( OPAL_DATATYPE_MAX_STRIDED_DIMS == dims ) return;
+        strided->count[dims]  = pElem[i - 1].loop.loops;
+        strided->stride[dims] = pElem[i - 1].loop.extent;
+        dims++;
+    }
+    strided->disp = elem->disp;
+    strided->dims = dims;
+
+    /* without it the generic engine is used, so a failed allocation is harmless */
+    pData->strided = (opal_datatype_strided_t*)malloc( sizeof(opal_datatype_strided_t) );
+    if( NULL != pData->strided )
+        *(pData->strided) = shape;
+}
+
 int32_t opal_datatype_commit( opal_datatype_t * pData )
 {
     ddt_endloop_desc_t* pLast = &(pData->desc.desc[pData->desc.used].end_loop);
@@ -326,6 +376,55 @@ int32_t opal_datatype_commit( opal_datatype_t * pData )
         pLast->items           = pData->opt_desc.used;
         pLast->first_elem_disp = first_elem_disp;
         pLast->size            = pData->size;
+
+        opal_datatype_compute_strided( pData );
+    }
+    return OPAL_SUCCESS;
+}
+
+/*
+ * Commit a datatype by copying the optimized description of an already
+ * committed one with the same structure (same description), instead of
+ * running the optimizer again. If the model does not match the datatype
+ * fall back on the normal commit.
+ */
+int32_t opal_datatype_commit_from( opal_datatype_t * pData, const opal_datatype_t * model )
+{
+    int32_t desc_length;
+
+    if( pData->flags & OPAL_DATATYPE_FLAG_COMMITED ) return OPAL_SUCCESS;
+    if( !(model->flags & OPAL_DATATYPE_FLAG_COMMITED) ||
+        (pData->desc.used != model->desc.used) || (pData->size != model->size) ) {
+        return opal_datatype_commit( pData );
+    }
+    pData->flags |= OPAL_DATATYPE_FLAG_COMMITED;
+
+    /* the fake element at the end of the description */
+    pData->desc.desc[pData->desc.used] = model->desc.desc[model->desc.used];
+
+    if( 0 == model->opt_desc.used ) {
+        pData->opt_desc.length = 0;
+        pData->opt_desc.desc   = NULL;
+        pData->opt_desc.used   = 0;
+        return OPAL_SUCCESS;
+    }
+    if( model->opt_desc.desc == model->desc.desc ) {
+        pData->opt_desc = pData->desc;
+    } else {
+        desc_length = model->opt_desc.used + 1;  /* +1 for the fake OPAL_DATATYPE_END_LOOP */
+        pData->opt_desc.desc = (dt_elem_desc_t*)malloc( desc_length * sizeof(dt_elem_desc_t) );
+        if( NULL == pData->opt_desc.desc ) {
+            pData->flags &= ~OPAL_DATATYPE_FLAG_COMMITED;
+            return opal_datatype_commit( pData );
+        }
+        pData->opt_desc.length = model->opt_desc.used;
+        pData->opt_desc.used   = model->opt_desc.used;
+        memcpy( pData->opt_desc.desc, model->opt_desc.desc, desc_length * sizeof(dt_elem_desc_t) );
+    }
+    if( NULL != model->strided ) {
+        pData->strided = (opal_datatype_strided_t*)malloc( sizeof(opal_datatype_strided_t) );
+        if( NULL != pData->strided )
+            *(pData->strided) = *(model->strided);
     }
     return OPAL_SUCCESS;
 }
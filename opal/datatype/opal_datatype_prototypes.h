@@ -36,6 +36,10 @@ opal_unpack_general_checksum( opal_convertor_t* pConvertor,
  * Now the internal functions
  */
 int32_t
+opal_unpack_general_contig( opal_convertor_t* pConvertor,
+                            struct iovec* iov, uint32_t* out_size,
+                            size_t* max_data );
+int32_t
 opal_pack_homogeneous_contig( opal_convertor_t* pConv,
                           struct iovec* iov, uint32_t* out_size,
                           size_t* max_data );
@@ -52,6 +56,10 @@ opal_pack_homogeneous_contig_with_gaps_checksum( opal_convertor_t* pConv,
                                              struct iovec* iov, uint32_t* out_size,
                                              size_t* max_data );
 int32_t
+opal_pack_homogeneous_strided( opal_convertor_t* pConv,
+                               struct iovec* iov, uint32_t* out_size,
+                               size_t* max_data );
+int32_t
 opal_generic_simple_pack( opal_convertor_t* pConvertor,
                           struct iovec* iov, uint32_t* out_size,
                           size_t* max_data );
@@ -68,6 +76,10 @@ opal_unpack_homogeneous_contig_checksum( opal_convertor_t* pConv,
                                          struct iovec* iov, uint32_t* out_size,
                                          size_t* max_data );
 int32_t
+opal_unpack_homogeneous_strided( opal_convertor_t* pConv,
+                                 struct iovec* iov, uint32_t* out_size,
+                                 size_t* max_data );
+int32_t
 opal_generic_simple_unpack( opal_convertor_t* pConvertor,
                             struct iovec* iov, uint32_t* out_size,
                             size_t* max_data );
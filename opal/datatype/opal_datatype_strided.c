@@ -0,0 +1,264 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2004-2006 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "opal/constants.h"
+#include "opal/datatype/opal_convertor_internal.h"
+#include "opal/datatype/opal_datatype_internal.h"
+#include "opal/datatype/opal_datatype_memcpy.h"
+#include "opal/datatype/opal_datatype_prototypes.h"
+
+/*
+ * Pack and unpack for the datatypes with a regular shape (see
+ * opal_datatype_strided_t). Like the contiguous versions they do not use
+ * the stack: the position in the user buffer is computed from
+ * pConv->bConverted, and the blocks are then walked with one counter per
+ * dimension. The count of the convertor is handled as an additional
+ * outermost dimension, using the extent of the datatype as stride.
+ */
+
+typedef struct {
+    uint32_t           dims;
+    uint32_t           index[OPAL_DATATYPE_MAX_STRIDED_DIMS + 1];
+    uint32_t           count[OPAL_DATATYPE_MAX_STRIDED_DIMS + 1];
+    OPAL_PTRDIFF_TYPE  stride[OPAL_DATATYPE_MAX_STRIDED_DIMS + 1];
+    unsigned char*     user;  /* beginning of the current block */
+} opal_strided_position_t;
+
+static inline void
+opal_strided_position_init( opal_strided_position_t* pos,
+                            const opal_convertor_t* pConv,
+                            size_t block )
+{
+    const opal_datatype_strided_t* strided = pConv->pDesc->strided;
+    OPAL_PTRDIFF_TYPE disp = strided->disp;
+    uint32_t d;
+
+    for( d = 0; d < strided->dims; d++ ) {
+        pos->count[d]  = strided->count[d];
+        pos->stride[d] = strided->stride[d];
+        pos->index[d]  = (uint32_t)(block % strided->count[d]);
+        disp += (OPAL_PTRDIFF_TYPE)pos->index[d] * pos->stride[d];
+        block /= strided->count[d];
+    }
+    pos->count[d]  = pConv->count;
+    pos->stride[d] = pConv->pDesc->ub - pConv->pDesc->lb;
+    pos->index[d]  = (uint32_t)block;
+    disp += (OPAL_PTRDIFF_TYPE)block * pos->stride[d];
+
+    pos->dims = strided->dims;
+    pos->user = pConv->pBaseBuf + disp;
+}
+
+/* move n blocks forward. n should not go past the end of the innermost dimension */
+static inline void
+opal_strided_position_advance( opal_strided_position_t* pos, uint32_t n )
+{
+    uint32_t d = 0;
+
+    pos->index[0] += n;
+    pos->user += (OPAL_PTRDIFF_TYPE)n * pos->stride[0];
+    while( (d < pos->dims) && (pos->index[d] == pos->count[d]) ) {
+        /* rewind this dimension and step into the next one */
+        pos->user += pos->stride[d + 1] - (OPAL_PTRDIFF_TYPE)pos->count[d] * pos->stride[d];
+        pos->index[d] = 0;
+        d++;
+        pos->index[d]++;
+    }
+}
+
+/*
+ * Copy n blocks between the packed buffer and the user memory. The most
+ * common block sizes get a copy with a constant length, which the
+ * compiler turns into plain (vector) loads and stores instead of a call
+ * to memcpy for each block.
+ */
+#define OPAL_STRIDED_COPY_LOOP( LENGTH )                                  \
+    do {                                                                  \
+        if( pack ) {                                                      \
+            for( i = 0; i < n; i++, packed += (LENGTH), user += stride )  \
+                MEMCPY( packed, user, (LENGTH) );                         \
+        } else {                                                          \
+            for( i = 0; i < n; i++, packed += (LENGTH), user += stride )  \
+                MEMCPY( user, packed, (LENGTH) );                         \
+        }                                                                 \
+    } while (0)
+
+static inline void
+opal_strided_copy_blocks( unsigned char* packed, unsigned char* user,
+                          OPAL_PTRDIFF_TYPE stride, size_t blen,
+                          uint32_t n, int pack )
+{
+    uint32_t i;
+
+    switch( blen ) {
+    case 4:  OPAL_STRIDED_COPY_LOOP( 4 );  break;
+    case 8:  OPAL_STRIDED_COPY_LOOP( 8 );  break;
+    case 16: OPAL_STRIDED_COPY_LOOP( 16 ); break;
+    case 32: OPAL_STRIDED_COPY_LOOP( 32 ); break;
+    default: OPAL_STRIDED_COPY_LOOP( blen ); break;
+    }
+}
+
+static inline void
+opal_strided_copy_partial( unsigned char* packed, unsigned char* user,
+                           size_t length, int pack )
+{
+    if( pack ) {
+        MEMCPY( packed, user, length );
+    } else {
+        MEMCPY( user, packed, length );
+    }
+}
+
+static inline int32_t
+opal_strided_convert( opal_convertor_t* pConv,
+                      struct iovec* iov,
+                      uint32_t* out_size,
+                      size_t* max_data,
+                      int pack )
+{
+    const size_t blen = pConv->pDesc->strided->blen;
+    size_t remaining = pConv->local_size - pConv->bConverted;
+    size_t initial_amount = pConv->bConverted, length, done, partial;
+    opal_strided_position_t pos;
+    unsigned char* packed;
+    uint32_t iov_count, n;
+
+    opal_strided_position_init( &pos, pConv, pConv->bConverted / blen );
+    done = pConv->bConverted % blen;  /* part of the current block converted by the last call */
+
+    for( iov_count = 0; iov_count < (*out_size); iov_count++ ) {
+        if( 0 == remaining ) break;
+        packed = (unsigned char*)iov[iov_count].iov_base;
+        length = iov[iov_count].iov_len;
+        if( length > remaining ) {
+            length = remaining;
+            iov[iov_count].iov_len = length;
+        }
+        remaining -= length;
+
+        if( 0 != done ) {
+            /* complete the block left over by the previous iovec */
+            partial = blen - done;
+            if( partial > length ) partial = length;
+            opal_strided_copy_partial( packed, pos.user + done, partial, pack );
+            packed += partial;
+            length -= partial;
+            done   += partial;
+            if( done < blen ) continue;
+            done = 0;
+            opal_strided_position_advance( &pos, 1 );
+        }
+        /* whole blocks, up to a full run of the innermost dimension at once */
+        while( length >= blen ) {
+            n = pos.count[0] - pos.index[0];
+            if( (size_t)n > (length / blen) ) n = (uint32_t)(length / blen);
+            opal_strided_copy_blocks( packed, pos.user, pos.stride[0], blen, n, pack );
+            packed += n * blen;
+            length -= n * blen;
+            opal_strided_position_advance( &pos, n );
+        }
+        if( 0 != length ) {
+            /* beginning of the next block */
+            opal_strided_copy_partial( packed, pos.user, length, pack );
+            done = length;
+        }
+    }
+
+    pConv->bConverted = pConv->local_size - remaining;
+    *max_data = pConv->bConverted - initial_amount;
+    *out_size = iov_count;
+    if( pConv->bConverted == pConv->local_size ) {
+        pConv->flags |= CONVERTOR_COMPLETED;
+        return 1;
+    }
+    return 0;
+}
+
+int32_t
+opal_convertor_gather( opal_convertor_t* pConv,
+                       struct iovec* iov,
+                       uint32_t* iov_count,
+                       size_t* length )
+{
+    opal_strided_position_t pos;
+    size_t blen, remaining, done, chunk, covered = 0;
+    uint32_t index = 0;
+
+    if( !(pConv->flags & CONVERTOR_STRIDED) ) {
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    blen = pConv->pDesc->strided->blen;
+    remaining = pConv->local_size - pConv->bConverted;
+    if( remaining > (*length) ) remaining = *length;
+
+    opal_strided_position_init( &pos, pConv, pConv->bConverted / blen );
+    done = pConv->bConverted % blen;
+
+    while( (0 != remaining) && (index < (*iov_count)) ) {
+        chunk = blen - done;
+        if( chunk > remaining ) chunk = remaining;
+        /* blocks touching each other (as the last block of a dimension
+         * and the first of the next one can) go in the same iovec */
+        if( (0 != index) &&
+            ((unsigned char*)iov[index - 1].iov_base + iov[index - 1].iov_len == pos.user + done) ) {
+            iov[index - 1].iov_len += chunk;
+        } else {
+            iov[index].iov_base = (IOVBASE_TYPE*)(pos.user + done);
+            iov[index].iov_len  = chunk;
+            index++;
+        }
+        covered   += chunk;
+        remaining -= chunk;
+        done      += chunk;
+        if( done == blen ) {
+            done = 0;
+            opal_strided_position_advance( &pos, 1 );
+        }
+    }
+
+    pConv->bConverted += covered;
+    *length = covered;
+    *iov_count = index;
+    if( pConv->bConverted == pConv->local_size ) {
+        pConv->flags |= CONVERTOR_COMPLETED;
+        return 1;
+    }
+    return 0;
+}
+
+int32_t
+opal_pack_homogeneous_strided( opal_convertor_t* pConv,
+                               struct iovec* iov,
+                               uint32_t* out_size,
+                               size_t* max_data )
+{
+    return opal_strided_convert( pConv, iov, out_size, max_data, 1 );
+}
+
+int32_t
+opal_unpack_homogeneous_strided( opal_convertor_t* pConv,
+                                 struct iovec* iov,
+                                 uint32_t* out_size,
+                                 size_t* max_data )
+{
+    return opal_strided_convert( pConv, iov, out_size, max_data, 0 );
+}
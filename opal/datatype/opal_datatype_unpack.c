@@ -176,6 +176,64 @@ opal_unpack_general_function( opal_convertor_t* pConvertor,
     return 0;
 }
 
+#if !defined(CHECKSUM)
+/**
+ * The heterogeneous unpack of a gapless run of a single basic type with
+ * the same size on both sides, the common case of an array of int or
+ * double coming from the other endianness or from external32. There is
+ * no need to walk the description one element at a time: every input
+ * buffer is converted in one call to the conversion function, which
+ * swaps contiguous runs with the vector kernel. The position is
+ * entirely described by bConverted.
+ */
+int32_t
+opal_unpack_general_contig( opal_convertor_t* pConvertor,
+                            struct iovec* iov,
+                            uint32_t* out_size,
+                            size_t* max_data )
+{
+    const opal_datatype_t *pData = pConvertor->pDesc;
+    const opal_convertor_master_t* master = pConvertor->master;
+    int type = pConvertor->use_desc->desc[0].elem.common.type;
+    size_t size = opal_datatype_basicDatatypes[type]->size;
+    size_t length, total_bytes_converted = 0;
+    OPAL_PTRDIFF_TYPE advance;
+    uint32_t iov_count;
+    int32_t count;
+
+    for( iov_count = 0; iov_count < (*out_size); iov_count++ ) {
+        char* user_memory = (char*)pConvertor->pBaseBuf + pData->true_lb + pConvertor->bConverted;
+
+        length = pConvertor->remote_size - pConvertor->bConverted;
+        if( length > iov[iov_count].iov_len )
+            length = iov[iov_count].iov_len;
+        /* whole elements only, the remainder waits for the next buffer */
+        count = (int32_t)(length / size);
+        if( 0 == count ) {
+            iov[iov_count].iov_len = 0;
+            break;
+        }
+        master->pFunctions[type]( pConvertor, count,
+                                  iov[iov_count].iov_base, count * size, size,
+                                  user_memory, count * size, size, &advance );
+        pConvertor->bConverted += advance;
+        iov[iov_count].iov_len = advance;
+        total_bytes_converted += advance;
+        if( pConvertor->remote_size == pConvertor->bConverted ) {
+            iov_count++;
+            break;
+        }
+    }
+    *max_data = total_bytes_converted;
+    *out_size = iov_count;
+    if( pConvertor->remote_size == pConvertor->bConverted ) {
+        pConvertor->flags |= CONVERTOR_COMPLETED;
+        return 1;
+    }
+    return 0;
+}
+#endif  /* !defined(CHECKSUM) */
+
 /**
  * This function will be used to unpack all datatypes that have the contiguous flag set.
  * Several types of datatypes match this criterion, not only the contiguous one, but
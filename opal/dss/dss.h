@@ -320,6 +320,43 @@ typedef int (*opal_dss_load_fn_t)(opal_buffer_t *buffer,
 typedef int (*opal_dss_copy_payload_fn_t)(opal_buffer_t *dest,
                                           opal_buffer_t *src);
 
+
+/**
+ * Unpack bytes without copying them.
+ *
+ * Unpack the next item of bytes - packed as OPAL_BYTE, OPAL_STRING or
+ * OPAL_BYTE_OBJECT - by returning a pointer to them in the buffer
+ * rather than a copy. The pointer is only valid as long as the buffer
+ * holds its payload, and must not be freed. Only a single string or
+ * byte object can be borrowed at a time.
+ *
+ * @param buffer A pointer to the buffer from which the bytes are to be
+ * unpacked.
+ *
+ * @param dest A pointer to where the address of the bytes is to be
+ * stored - NULL for an empty item. A borrowed string includes its
+ * terminating NULL.
+ *
+ * @param size A pointer to where the number of bytes is to be stored.
+ *
+ * @param type OPAL_BYTE, OPAL_STRING or OPAL_BYTE_OBJECT, as it was
+ * packed.
+ *
+ * @retval OPAL_SUCCESS The bytes were found as requested.
+ *
+ * @retval OPAL_ERROR(s) An appropriate OPAL error code indicating the
+ * problem encountered.
+ *
+ * @code
+ * char *data;
+ * int32_t size;
+ *
+ * status_code = opal_dss.unpack_borrow(buffer, (void**)&data, &size, OPAL_BYTE);
+ * @endcode
+ */
+typedef int (*opal_dss_unpack_borrow_fn_t)(opal_buffer_t *buffer, void **dest,
+                                           int32_t *size, opal_data_type_t type);
+
 /**
  * DSS register function
  *
@@ -479,6 +516,7 @@ struct opal_dss_t {
     opal_dss_unload_fn_t            unload;
     opal_dss_load_fn_t              load;
     opal_dss_copy_payload_fn_t      copy_payload;
+    opal_dss_unpack_borrow_fn_t     unpack_borrow;
     opal_dss_register_fn_t          register_type;
     opal_dss_lookup_data_type_fn_t  lookup_data_type;
     opal_dss_dump_data_types_fn_t   dump_data_types;
@@ -210,6 +210,10 @@ int opal_dss_copy_pstat(opal_pstats_t **dest, opal_pstats_t *src,
     p->rss = src->rss;
     p->peak_vsize = src->peak_vsize;
     p->processor = src->processor;
+    p->minor_faults = src->minor_faults;
+    p->major_faults = src->major_faults;
+    p->voluntary_ctxsw = src->voluntary_ctxsw;
+    p->involuntary_ctxsw = src->involuntary_ctxsw;
     p->sample_time.tv_sec = src->sample_time.tv_sec;
     p->sample_time.tv_usec = src->sample_time.tv_usec;    
     return OPAL_SUCCESS;
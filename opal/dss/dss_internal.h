@@ -212,6 +212,8 @@ int opal_dss_pack(opal_buffer_t *buffer, const void *src,
 int opal_dss_unpack(opal_buffer_t *buffer, void *dest,
                     int32_t *max_num_vals,
                     opal_data_type_t type);
+int opal_dss_unpack_borrow(opal_buffer_t *buffer, void **dest,
+                           int32_t *size, opal_data_type_t type);
 
 int opal_dss_copy(void **dest, void *src, opal_data_type_t type);
 
@@ -480,6 +482,10 @@ char* opal_dss_buffer_extend(opal_buffer_t *bptr, size_t bytes_to_add);
 
 bool opal_dss_too_small(opal_buffer_t *buffer, size_t bytes_reqd);
 
+int opal_dss_pack_varint(opal_buffer_t *buffer, uint64_t val);
+
+int opal_dss_unpack_varint(opal_buffer_t *buffer, uint64_t *val);
+
 opal_dss_type_info_t* opal_dss_find_type(opal_data_type_t type);
 
 int opal_dss_store_data_type(opal_buffer_t *buffer, opal_data_type_t type);
@@ -104,6 +104,53 @@ bool opal_dss_too_small(opal_buffer_t *buffer, size_t bytes_reqd)
     return false;
 }
 
+/*
+ * Internal functions that store an integer in a compact buffer: seven
+ * bits per byte, lowest first, with the top bit set on all the bytes
+ * but the last
+ */
+int opal_dss_pack_varint(opal_buffer_t *buffer, uint64_t val)
+{
+    char *dst;
+    size_t n = 0;
+
+    /* check to see if buffer needs extending - 64 bits take 10 bytes */
+    if (NULL == (dst = opal_dss_buffer_extend(buffer, 10))) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    while (0x80 <= val) {
+        dst[n++] = (char)((val & 0x7f) | 0x80);
+        val >>= 7;
+    }
+    dst[n++] = (char)val;
+
+    buffer->pack_ptr += n;
+    buffer->bytes_used += n;
+
+    return OPAL_SUCCESS;
+}
+
+int opal_dss_unpack_varint(opal_buffer_t *buffer, uint64_t *val)
+{
+    uint64_t tmp = 0;
+    unsigned char byte;
+    int shift = 0;
+
+    do {
+        if (64 <= shift || opal_dss_too_small(buffer, 1)) {
+            return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
+        }
+        byte = *(unsigned char*)buffer->unpack_ptr;
+        buffer->unpack_ptr++;
+        tmp |= (uint64_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    *val = tmp;
+    return OPAL_SUCCESS;
+}
+
 int opal_dss_store_data_type(opal_buffer_t *buffer, opal_data_type_t type)
 {
     opal_dss_type_info_t *info;
@@ -43,6 +43,7 @@ static int opal_dss_group_id = -1;
 mca_base_var_enum_value_t buffer_type_values[] = {
     {OPAL_DSS_BUFFER_NON_DESC, "non-described"},
     {OPAL_DSS_BUFFER_FULLY_DESC, "described"},
+    {OPAL_DSS_BUFFER_COMPACT, "compact"},
     {0, NULL}
 };
 
@@ -57,6 +58,7 @@ opal_dss_t opal_dss = {
     opal_dss_unload,
     opal_dss_load,
     opal_dss_copy_payload,
+    opal_dss_unpack_borrow,
     opal_dss_register,
     opal_dss_lookup_data_type,
     opal_dss_dump_data_types,
@@ -148,6 +150,10 @@ static void opal_pstat_construct(opal_pstats_t *obj)
     obj->rss = 0.0;
     obj->peak_vsize = 0.0;
     obj->processor = -1;
+    obj->minor_faults = 0;
+    obj->major_faults = 0;
+    obj->voluntary_ctxsw = 0;
+    obj->involuntary_ctxsw = 0;
     obj->sample_time.tv_sec = 0;
     obj->sample_time.tv_usec = 0;
 }
@@ -248,7 +254,7 @@ int opal_dss_register_vars (void)
     }
 
     ret = mca_base_var_register ("opal", "dss", NULL, "buffer_type",
-                                 "Set the default mode for OpenRTE buffers (0=non-described, 1=described)",
+                                 "Set the default mode for OpenRTE buffers (0=non-described, 1=described, 2=compact)",
                                  MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                  OPAL_INFO_LVL_8, MCA_BASE_VAR_SCOPE_ALL_EQ,
                                  &default_buf_type);
@@ -247,8 +247,19 @@ int opal_dss_pack_int32(opal_buffer_t *buffer, const void *src,
     int32_t i;
     uint32_t tmp, *srctmp = (uint32_t*) src;
     char *dst;
+    int ret;
 
     OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_pack_int32 * %d\n", num_vals ) );
+
+    if (OPAL_DSS_BUFFER_COMPACT == buffer->type) {
+        for (i = 0; i < num_vals; ++i) {
+            if (OPAL_SUCCESS != (ret = opal_dss_pack_varint(buffer, srctmp[i]))) {
+                return ret;
+            }
+        }
+        return OPAL_SUCCESS;
+    }
+
     /* check to see if buffer needs extending */
     if (NULL == (dst = opal_dss_buffer_extend(buffer, num_vals*sizeof(tmp)))) {
         return OPAL_ERR_OUT_OF_RESOURCE;
@@ -274,9 +285,20 @@ int opal_dss_pack_int64(opal_buffer_t *buffer, const void *src,
     int32_t i;
     uint64_t tmp, *srctmp = (uint64_t*) src;
     char *dst;
+    int ret;
     size_t bytes_packed = num_vals * sizeof(tmp);
 
     OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_pack_int64 * %d\n", num_vals ) );
+
+    if (OPAL_DSS_BUFFER_COMPACT == buffer->type) {
+        for (i = 0; i < num_vals; ++i) {
+            if (OPAL_SUCCESS != (ret = opal_dss_pack_varint(buffer, srctmp[i]))) {
+                return ret;
+            }
+        }
+        return OPAL_SUCCESS;
+    }
+
     /* check to see if buffer needs extending */
     if (NULL == (dst = opal_dss_buffer_extend(buffer, bytes_packed))) {
         return OPAL_ERR_OUT_OF_RESOURCE;
@@ -462,6 +484,18 @@ int opal_dss_pack_pstat(opal_buffer_t *buffer, const void *src,
         if (OPAL_SUCCESS != (ret = opal_dss_pack_buffer(buffer, &ptr[i]->processor, 1, OPAL_INT16))) {
             return ret;
         }
+        if (OPAL_SUCCESS != (ret = opal_dss_pack_buffer(buffer, &ptr[i]->minor_faults, 1, OPAL_UINT64))) {
+            return ret;
+        }
+        if (OPAL_SUCCESS != (ret = opal_dss_pack_buffer(buffer, &ptr[i]->major_faults, 1, OPAL_UINT64))) {
+            return ret;
+        }
+        if (OPAL_SUCCESS != (ret = opal_dss_pack_buffer(buffer, &ptr[i]->voluntary_ctxsw, 1, OPAL_UINT64))) {
+            return ret;
+        }
+        if (OPAL_SUCCESS != (ret = opal_dss_pack_buffer(buffer, &ptr[i]->involuntary_ctxsw, 1, OPAL_UINT64))) {
+            return ret;
+        }
         if (OPAL_SUCCESS != (ret = opal_dss_pack_buffer(buffer, &ptr[i]->sample_time, 1, OPAL_TIMEVAL))) {
             return ret;
         }
@@ -136,6 +136,10 @@ typedef struct {
     float rss;  /* in MBytes */
     float peak_vsize;  /* in MBytes */
     int16_t processor;
+    uint64_t minor_faults;
+    uint64_t major_faults;
+    uint64_t voluntary_ctxsw;
+    uint64_t involuntary_ctxsw;
     /* time at which sample was taken */
     struct timeval sample_time;
 } opal_pstats_t;
@@ -197,11 +201,13 @@ OPAL_DECLSPEC OBJ_CLASS_DECLARATION(opal_node_stats_t);
 #define OPAL_DSS_UNSTRUCTURED   false
 
 /**
- * buffer type
+ * buffer type - compact buffers are not described either, and store
+ * the 32 and 64 bit integers in as few bytes as their value needs
  */
 enum opal_dss_buffer_type_t {
     OPAL_DSS_BUFFER_NON_DESC   = 0x00,
-    OPAL_DSS_BUFFER_FULLY_DESC = 0x01
+    OPAL_DSS_BUFFER_FULLY_DESC = 0x01,
+    OPAL_DSS_BUFFER_COMPACT    = 0x02
 };
 
 typedef enum opal_dss_buffer_type_t opal_dss_buffer_type_t;
@@ -95,6 +95,66 @@ int opal_dss_unpack(opal_buffer_t *buffer, void *dst, int32_t *num_vals,
     return ret;
 }
 
+int opal_dss_unpack_borrow(opal_buffer_t *buffer, void **dest,
+                           int32_t *size, opal_data_type_t type)
+{
+    int rc;
+    int32_t local_num, len, n=1;
+    opal_data_type_t local_type;
+
+    /* check for error */
+    if (NULL == buffer || NULL == dest || NULL == size) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+    if (OPAL_BYTE != type && OPAL_STRING != type && OPAL_BYTE_OBJECT != type) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    /* walk the layout opal_dss_pack gave the item: the number of
+     * values, the type and, but for plain bytes, the length
+     */
+    if (OPAL_DSS_BUFFER_FULLY_DESC == buffer->type) {
+        if (OPAL_SUCCESS != (rc = opal_dss_get_data_type(buffer, &local_type))) {
+            return rc;
+        }
+        if (OPAL_INT32 != local_type) {
+            return OPAL_ERR_UNPACK_FAILURE;
+        }
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss_unpack_int32(buffer, &local_num, &n, OPAL_INT32))) {
+        return rc;
+    }
+    if (OPAL_DSS_BUFFER_FULLY_DESC == buffer->type) {
+        if (OPAL_SUCCESS != (rc = opal_dss_get_data_type(buffer, &local_type))) {
+            return rc;
+        }
+        if (type != local_type) {
+            opal_output(0, "OPAL dss:unpack_borrow: got type %d when expecting type %d", local_type, type);
+            return OPAL_ERR_PACK_MISMATCH;
+        }
+    }
+    if (OPAL_BYTE == type) {
+        len = local_num;
+    } else {
+        if (1 != local_num) {
+            return OPAL_ERR_UNPACK_INADEQUATE_SPACE;
+        }
+        n = 1;
+        if (OPAL_SUCCESS != (rc = opal_dss_unpack_int32(buffer, &len, &n, OPAL_INT32))) {
+            return rc;
+        }
+    }
+
+    if (0 > len || opal_dss_too_small(buffer, len)) {
+        return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
+    }
+    *dest = (0 == len) ? NULL : buffer->unpack_ptr;
+    *size = len;
+    buffer->unpack_ptr += len;
+
+    return OPAL_SUCCESS;
+}
+
 int opal_dss_unpack_buffer(opal_buffer_t *buffer, void *dst, int32_t *num_vals,
                     opal_data_type_t type)
 {
@@ -332,8 +392,20 @@ int opal_dss_unpack_int32(opal_buffer_t *buffer, void *dest,
 {
     int32_t i;
     uint32_t tmp, *desttmp = (uint32_t*) dest;
+    uint64_t val;
+    int ret;
 
    OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_unpack_int32 * %d\n", (int)*num_vals ) );
+    if (OPAL_DSS_BUFFER_COMPACT == buffer->type) {
+        for (i = 0; i < (*num_vals); ++i) {
+            if (OPAL_SUCCESS != (ret = opal_dss_unpack_varint(buffer, &val))) {
+                return ret;
+            }
+            desttmp[i] = (uint32_t)val;
+        }
+        return OPAL_SUCCESS;
+    }
+
     /* check to see if there's enough data in buffer */
     if (opal_dss_too_small(buffer, (*num_vals)*sizeof(tmp))) {
         return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
@@ -354,8 +426,20 @@ int opal_dss_unpack_int64(opal_buffer_t *buffer, void *dest,
 {
     int32_t i;
     uint64_t tmp, *desttmp = (uint64_t*) dest;
+    uint64_t val;
+    int ret;
 
    OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_unpack_int64 * %d\n", (int)*num_vals ) );
+    if (OPAL_DSS_BUFFER_COMPACT == buffer->type) {
+        for (i = 0; i < (*num_vals); ++i) {
+            if (OPAL_SUCCESS != (ret = opal_dss_unpack_varint(buffer, &val))) {
+                return ret;
+            }
+            desttmp[i] = (uint64_t)val;
+        }
+        return OPAL_SUCCESS;
+    }
+
     /* check to see if there's enough data in buffer */
     if (opal_dss_too_small(buffer, (*num_vals)*sizeof(tmp))) {
         return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
@@ -408,7 +492,8 @@ int opal_dss_unpack_float(opal_buffer_t *buffer, void *dest,
 
    OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_unpack_float * %d\n", (int)*num_vals ) );
     /* check to see if there's enough data in buffer */
-    if (opal_dss_too_small(buffer, (*num_vals)*sizeof(float))) {
+    if (OPAL_DSS_BUFFER_COMPACT != buffer->type &&
+        opal_dss_too_small(buffer, (*num_vals)*sizeof(float))) {
         return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
     }
 
@@ -433,7 +518,8 @@ int opal_dss_unpack_timeval(opal_buffer_t *buffer, void *dest,
 
    OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_unpack_timeval * %d\n", (int)*num_vals ) );
     /* check to see if there's enough data in buffer */
-    if (opal_dss_too_small(buffer, (*num_vals)*sizeof(struct timeval))) {
+    if (OPAL_DSS_BUFFER_COMPACT != buffer->type &&
+        opal_dss_too_small(buffer, (*num_vals)*sizeof(struct timeval))) {
         return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
     }
 
@@ -589,6 +675,26 @@ int opal_dss_unpack_pstat(opal_buffer_t *buffer, void *dest,
             return ret;
         }
         m=1;
+        if (OPAL_SUCCESS != (ret = opal_dss_unpack_buffer(buffer, &ptr[i]->minor_faults, &m, OPAL_UINT64))) {
+            OPAL_ERROR_LOG(ret);
+            return ret;
+        }
+        m=1;
+        if (OPAL_SUCCESS != (ret = opal_dss_unpack_buffer(buffer, &ptr[i]->major_faults, &m, OPAL_UINT64))) {
+            OPAL_ERROR_LOG(ret);
+            return ret;
+        }
+        m=1;
+        if (OPAL_SUCCESS != (ret = opal_dss_unpack_buffer(buffer, &ptr[i]->voluntary_ctxsw, &m, OPAL_UINT64))) {
+            OPAL_ERROR_LOG(ret);
+            return ret;
+        }
+        m=1;
+        if (OPAL_SUCCESS != (ret = opal_dss_unpack_buffer(buffer, &ptr[i]->involuntary_ctxsw, &m, OPAL_UINT64))) {
+            OPAL_ERROR_LOG(ret);
+            return ret;
+        }
+        m=1;
         if (OPAL_SUCCESS != (ret = opal_dss_unpack_buffer(buffer, &ptr[i]->sample_time, &m, OPAL_TIMEVAL))) {
             OPAL_ERROR_LOG(ret);
             return ret;
@@ -163,6 +163,8 @@ typedef struct opal_atomic_lock_t opal_atomic_lock_t;
 #include "opal/sys/sparcv9/atomic.h"
 #elif OPAL_ASSEMBLY_ARCH == OMPI_SYNC_BUILTIN
 #include "opal/sys/sync_builtin/atomic.h"
+#elif OPAL_ASSEMBLY_ARCH == OMPI_GCC_BUILTIN
+#include "opal/sys/gcc_builtin/atomic.h"
 #endif
 
 #ifndef DOXYGEN
@@ -241,6 +243,46 @@ void opal_atomic_wmb(void);
 #endif /* defined(DOXYGEN) || OPAL_HAVE_ATOMIC_MEM_BARRIER */
 
 
+/**********************************************************************
+ *
+ * Loads and stores with acquire / release semantics - implemented
+ * with the read / write barriers above if the architecture has no
+ * cheaper way
+ *
+ *********************************************************************/
+#if defined(DOXYGEN)
+/**
+ * Load with acquire semantics
+ *
+ * Reads and writes issued after the load can not be performed before
+ * it.  Use it to read a flag or pointer that another process
+ * published with \c opal_atomic_store_rel_32(), instead of a plain
+ * load followed by \c opal_atomic_rmb().
+ *
+ * @param addr          Address to load from.
+ * @return              The value at \c addr.
+ */
+static inline int32_t opal_atomic_load_acq_32(volatile int32_t *addr);
+
+/**
+ * Store with release semantics
+ *
+ * Reads and writes issued before the store are performed before it.
+ * Use it to publish a flag or pointer, instead of \c opal_atomic_wmb()
+ * followed by a plain store.
+ *
+ * @param addr          Address to store to.
+ * @param value         Value to store.
+ */
+static inline void opal_atomic_store_rel_32(volatile int32_t *addr, int32_t value);
+
+static inline int64_t opal_atomic_load_acq_64(volatile int64_t *addr);
+static inline void opal_atomic_store_rel_64(volatile int64_t *addr, int64_t value);
+static inline void *opal_atomic_load_acq_ptr(volatile void *addr);
+static inline void opal_atomic_store_rel_ptr(volatile void *addr, void *value);
+#endif  /* DOXYGEN */
+
+
 /**********************************************************************
  *
  * Atomic spinlocks - always inlined, if have atomic cmpset
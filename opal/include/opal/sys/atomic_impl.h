@@ -374,6 +374,73 @@ static inline int32_t opal_atomic_sub_ptr( volatile void* addr,
 
 #endif /* OPAL_HAVE_ATOMIC_MATH_32 || OPAL_HAVE_ATOMIC_MATH_64 */
 
+/**********************************************************************
+ *
+ * Loads and stores with acquire / release semantics
+ *
+ *********************************************************************/
+#if !defined(OPAL_HAVE_ATOMIC_LOAD_STORE)
+#define OPAL_HAVE_ATOMIC_LOAD_STORE 1
+
+#if OPAL_HAVE_ATOMIC_MEM_BARRIER
+#define OPAL_ATOMIC_LOAD_ACQ_BARRIER() opal_atomic_rmb()
+#define OPAL_ATOMIC_STORE_REL_BARRIER() opal_atomic_wmb()
+#else
+#define OPAL_ATOMIC_LOAD_ACQ_BARRIER()
+#define OPAL_ATOMIC_STORE_REL_BARRIER()
+#endif
+
+static inline int32_t
+opal_atomic_load_acq_32(volatile int32_t *addr)
+{
+    int32_t value = *addr;
+    OPAL_ATOMIC_LOAD_ACQ_BARRIER();
+    return value;
+}
+
+static inline void
+opal_atomic_store_rel_32(volatile int32_t *addr, int32_t value)
+{
+    OPAL_ATOMIC_STORE_REL_BARRIER();
+    *addr = value;
+}
+
+static inline int64_t
+opal_atomic_load_acq_64(volatile int64_t *addr)
+{
+    int64_t value = *addr;
+    OPAL_ATOMIC_LOAD_ACQ_BARRIER();
+    return value;
+}
+
+static inline void
+opal_atomic_store_rel_64(volatile int64_t *addr, int64_t value)
+{
+    OPAL_ATOMIC_STORE_REL_BARRIER();
+    *addr = value;
+}
+
+static inline void *
+opal_atomic_load_acq_ptr(volatile void *addr)
+{
+    void *value = *(void * volatile *) addr;
+    OPAL_ATOMIC_LOAD_ACQ_BARRIER();
+    return value;
+}
+
+static inline void
+opal_atomic_store_rel_ptr(volatile void *addr, void *value)
+{
+    OPAL_ATOMIC_STORE_REL_BARRIER();
+    *(void * volatile *) addr = value;
+}
+
+#undef OPAL_ATOMIC_LOAD_ACQ_BARRIER
+#undef OPAL_ATOMIC_STORE_REL_BARRIER
+
+#endif  /* OPAL_HAVE_ATOMIC_LOAD_STORE */
+
+
 /**********************************************************************
  *
  * Atomic spinlocks
@@ -415,8 +482,7 @@ opal_atomic_lock(opal_atomic_lock_t *lock)
 static inline void
 opal_atomic_unlock(opal_atomic_lock_t *lock)
 {
-   opal_atomic_wmb();
-   lock->u.lock=OPAL_ATOMIC_UNLOCKED;
+   opal_atomic_store_rel_32(&(lock->u.lock), OPAL_ATOMIC_UNLOCKED);
 }
 
 #endif /* OPAL_HAVE_ATOMIC_SPINLOCKS */
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2006 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart, 
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * Copyright (c) 2011      Sandia National Laboratories. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+/*
+ * Atomics on top of the compiler's __atomic builtins (the C11 memory
+ * model).  Unlike the __sync builtins, every operation carries its
+ * memory ordering, so the read and write barriers and the _acq / _rel
+ * variants map to acquire and release orderings rather than to a full
+ * fence.  On weakly ordered processors (ARM, POWER) this turns most
+ * barriers of the shared memory fast paths into ldar / stlr or lwsync
+ * instead of a dmb ish / sync; on x86 they are compiler barriers only.
+ */
+
+#ifndef OMPI_SYS_ARCH_ATOMIC_H
+#define OMPI_SYS_ARCH_ATOMIC_H 1
+
+/**********************************************************************
+ *
+ * Memory Barriers
+ *
+ *********************************************************************/
+#define OPAL_HAVE_ATOMIC_MEM_BARRIER 1
+
+static inline void opal_atomic_mb(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void opal_atomic_rmb(void)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+static inline void opal_atomic_wmb(void)
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**********************************************************************
+ *
+ * Loads and stores with acquire / release semantics
+ *
+ *********************************************************************/
+#define OPAL_HAVE_ATOMIC_LOAD_STORE 1
+
+static inline int32_t opal_atomic_load_acq_32(volatile int32_t *addr)
+{
+    return __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+}
+
+static inline void opal_atomic_store_rel_32(volatile int32_t *addr, int32_t value)
+{
+    __atomic_store_n(addr, value, __ATOMIC_RELEASE);
+}
+
+static inline int64_t opal_atomic_load_acq_64(volatile int64_t *addr)
+{
+    return __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+}
+
+static inline void opal_atomic_store_rel_64(volatile int64_t *addr, int64_t value)
+{
+    __atomic_store_n(addr, value, __ATOMIC_RELEASE);
+}
+
+static inline void *opal_atomic_load_acq_ptr(volatile void *addr)
+{
+    return __atomic_load_n((void * volatile *) addr, __ATOMIC_ACQUIRE);
+}
+
+static inline void opal_atomic_store_rel_ptr(volatile void *addr, void *value)
+{
+    __atomic_store_n((void * volatile *) addr, value, __ATOMIC_RELEASE);
+}
+
+/**********************************************************************
+ *
+ * Atomic math operations
+ *
+ * The operations without an explicit ordering keep the full barrier
+ * semantics of the other implementations, which callers rely on.
+ *
+ *********************************************************************/
+
+#define OPAL_HAVE_ATOMIC_CMPSET_32 1
+static inline int opal_atomic_cmpset_acq_32( volatile int32_t *addr,
+                                             int32_t oldval, int32_t newval)
+{
+    return __atomic_compare_exchange_n(addr, &oldval, newval, 0,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+
+static inline int opal_atomic_cmpset_rel_32( volatile int32_t *addr,
+                                             int32_t oldval, int32_t newval)
+{
+    return __atomic_compare_exchange_n(addr, &oldval, newval, 0,
+                                       __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+static inline int opal_atomic_cmpset_32( volatile int32_t *addr,
+                                         int32_t oldval, int32_t newval)
+{
+    return __atomic_compare_exchange_n(addr, &oldval, newval, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#define OPAL_HAVE_ATOMIC_SWAP_32 1
+static inline int32_t opal_atomic_swap_32(volatile int32_t *addr, int32_t newval)
+{
+    return __atomic_exchange_n(addr, newval, __ATOMIC_SEQ_CST);
+}
+
+#define OPAL_HAVE_ATOMIC_MATH_32 1
+
+#define OPAL_HAVE_ATOMIC_ADD_32 1
+static inline int32_t opal_atomic_add_32(volatile int32_t *addr, int32_t delta)
+{
+    return __atomic_add_fetch(addr, delta, __ATOMIC_SEQ_CST);
+}
+
+#define OPAL_HAVE_ATOMIC_SUB_32 1
+static inline int32_t opal_atomic_sub_32(volatile int32_t *addr, int32_t delta)
+{
+    return __atomic_sub_fetch(addr, delta, __ATOMIC_SEQ_CST);
+}
+
+#define OPAL_HAVE_ATOMIC_CMPSET_64 1
+static inline int opal_atomic_cmpset_acq_64( volatile int64_t *addr,
+                                             int64_t oldval, int64_t newval)
+{
+    return __atomic_compare_exchange_n(addr, &oldval, newval, 0,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static inline int opal_atomic_cmpset_rel_64( volatile int64_t *addr,
+                                             int64_t oldval, int64_t newval)
+{
+    return __atomic_compare_exchange_n(addr, &oldval, newval, 0,
+                                       __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+
+static inline int opal_atomic_cmpset_64( volatile int64_t *addr,
+                                         int64_t oldval, int64_t newval)
+{
+    return __atomic_compare_exchange_n(addr, &oldval, newval, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#define OPAL_HAVE_ATOMIC_SWAP_64 1
+static inline int64_t opal_atomic_swap_64(volatile int64_t *addr, int64_t newval)
+{
+    return __atomic_exchange_n(addr, newval, __ATOMIC_SEQ_CST);
+}
+
+#define OPAL_HAVE_ATOMIC_MATH_64 1
+#define OPAL_HAVE_ATOMIC_ADD_64 1
+static inline int64_t opal_atomic_add_64(volatile int64_t *addr, int64_t delta)
+{
+    return __atomic_add_fetch(addr, delta, __ATOMIC_SEQ_CST);
+}
+
+#define OPAL_HAVE_ATOMIC_SUB_64 1
+static inline int64_t opal_atomic_sub_64(volatile int64_t *addr, int64_t delta)
+{
+    return __atomic_sub_fetch(addr, delta, __ATOMIC_SEQ_CST);
+}
+
+#endif /* ! OMPI_SYS_ARCH_ATOMIC_H */
@@ -66,6 +66,7 @@ OPAL_DECLSPEC OBJ_CLASS_DECLARATION(mca_base_component_priority_list_item_t);
 OPAL_DECLSPEC extern char *mca_base_component_path;
 OPAL_DECLSPEC extern bool mca_base_component_show_load_errors;
 OPAL_DECLSPEC extern bool mca_base_component_disable_dlopen;
+OPAL_DECLSPEC extern bool mca_base_component_use_index;
 OPAL_DECLSPEC extern char *mca_base_system_default_path;
 OPAL_DECLSPEC extern char *mca_base_user_default_path;
 
@@ -82,6 +82,9 @@ struct component_file_item_t {
   char basename[OPAL_PATH_MAX + 1];
   char filename[OPAL_PATH_MAX + 1];
   component_status_t status;
+  /* the dependencies, when the file comes from the index */
+  bool indexed;
+  const char *dependencies;
 };
 typedef struct component_file_item_t component_file_item_t;
 
@@ -110,6 +113,7 @@ static void find_dyn_components(const char *path, const char *type,
                                 const char **names, bool include_mode,
                                 opal_list_t *found_components);
 static int save_filename(const char *filename, lt_ptr data);
+static int scan_directory(const char *dir);
 static int open_component(component_file_item_t *target_file, 
                        opal_list_t *found_components);
 static int check_ompi_info(component_file_item_t *target_file, 
@@ -126,8 +130,13 @@ static void free_dependency_list(opal_list_t *dependencies);
 static const char *ompi_info_suffix = ".ompi_info";
 static const char *key_dependency = "dependency=";
 static const char component_template[] = "mca_%s_";
+static const char *component_index_name = "mca-component-index";
 static opal_list_t found_files;
 static char **found_filenames = NULL;
+/* the files listed by the index of their directory, with their
+   dependencies ("" when there are none) */
+static char **index_filenames = NULL;
+static char **index_dependencies = NULL;
 static char *last_path_to_use = NULL;
 #endif /* OPAL_WANT_LIBLTDL */
 
@@ -237,6 +246,9 @@ int mca_base_component_find_finalize(void)
         opal_argv_free(found_filenames);
         found_filenames = NULL;
     }
+    opal_argv_free(index_filenames);
+    opal_argv_free(index_dependencies);
+    index_filenames = index_dependencies = NULL;
     if (NULL != last_path_to_use) {
         free(last_path_to_use);
         last_path_to_use = NULL;
@@ -359,12 +371,14 @@ static void find_dyn_components(const char *path, const char *type_name,
        matching filenames that we find.  Save the filenames in an
        argv-style array.  Re-scan do this if the mca_component_path
        has changed. */
-    if (NULL == found_filenames || 
+    if ((NULL == found_filenames && NULL == index_filenames) ||
         (NULL != last_path_to_use && 
          0 != strcmp(path_to_use, last_path_to_use))) {
-        if (NULL != found_filenames) {
+        if (NULL != found_filenames || NULL != index_filenames) {
             opal_argv_free(found_filenames);
-            found_filenames = NULL;
+            opal_argv_free(index_filenames);
+            opal_argv_free(index_dependencies);
+            found_filenames = index_filenames = index_dependencies = NULL;
             free(last_path_to_use);
             last_path_to_use = NULL;
         }
@@ -382,18 +396,16 @@ static void find_dyn_components(const char *path, const char *type_name,
                 if ((0 == strcmp(dir, "USER_DEFAULT") ||
                      0 == strcmp(dir, "USR_DEFAULT"))
                     && NULL != mca_base_user_default_path) {
-                    if (0 != lt_dlforeachfile(mca_base_user_default_path,
-                                              save_filename, NULL)) {
+                    if (0 != scan_directory(mca_base_user_default_path)) {
                         break;
                     }
                 } else if (0 == strcmp(dir, "SYS_DEFAULT") ||
                            0 == strcmp(dir, "SYSTEM_DEFAULT")) {
-                    if (0 != lt_dlforeachfile(mca_base_system_default_path,
-                                              save_filename, NULL)) {
+                    if (0 != scan_directory(mca_base_system_default_path)) {
                         break;
                     }                    
                 } else {
-                    if (0 != lt_dlforeachfile(dir, save_filename, NULL)) {
+                    if (0 != scan_directory(dir)) {
                         break;
                     }
                 }
@@ -434,10 +446,40 @@ static void find_dyn_components(const char *path, const char *type_name,
         strncpy(file->filename, found_filenames[i], OPAL_PATH_MAX);
         file->filename[OPAL_PATH_MAX] = '\0';
         file->status = UNVISITED;
+        file->indexed = false;
 
         opal_list_append(&found_files, (opal_list_item_t *) 
                          file);
     }
+    for (i = 0; NULL != index_filenames && NULL != index_filenames[i]; ++i) {
+        basename = strrchr(index_filenames[i], '/') + 1;
+        if (0 != strncmp(basename, prefix, len)) {
+            continue;
+        }
+
+        /* The index names the file itself, extension included, which
+           spares libltdl the search for it */
+        file = OBJ_NEW(component_file_item_t);
+        if (NULL == file) {
+            return;
+        }
+        strncpy(file->type, type_name, MCA_BASE_MAX_TYPE_NAME_LEN);
+        file->type[MCA_BASE_MAX_TYPE_NAME_LEN] = '\0';
+        strncpy(file->basename, basename, OPAL_PATH_MAX);
+        file->basename[OPAL_PATH_MAX] = '\0';
+        if (NULL != (end = strrchr(file->basename, '.'))) {
+            *end = '\0';
+        }
+        strncpy(file->name, file->basename + len, MCA_BASE_MAX_COMPONENT_NAME_LEN);
+        file->name[MCA_BASE_MAX_COMPONENT_NAME_LEN] = '\0';
+        strncpy(file->filename, index_filenames[i], OPAL_PATH_MAX);
+        file->filename[OPAL_PATH_MAX] = '\0';
+        file->status = UNVISITED;
+        file->indexed = true;
+        file->dependencies = index_dependencies[i];
+
+        opal_list_append(&found_files, (opal_list_item_t *) file);
+    }
 
     /* Iterate through all the filenames that we found that matched
        the framework we were looking for.  Since one component may
@@ -486,6 +528,104 @@ static int save_filename(const char *filename, lt_ptr data)
 }
 
 
+/*
+ * Read the index that the installation wrote in a directory, one line
+ * per component:
+ *
+ *   <framework> <component> <version> <file> [<framework>:<component> ...]
+ *
+ * the last fields being the dependencies.  An index of another version,
+ * or older than the directory (components were added or removed since),
+ * is not used.
+ */
+static int read_index(const char *dir)
+{
+    char *filename, buffer[BUFSIZ], **fields, *path, *deps;
+    char **files = NULL, **dependencies = NULL;
+    struct stat dir_stat, index_stat;
+    bool valid = false;
+    size_t len;
+    FILE *fp;
+    int i, n;
+
+    asprintf(&filename, "%s" OPAL_PATH_SEP "%s", dir, component_index_name);
+    if (NULL == filename) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    if (0 != stat(dir, &dir_stat) || 0 != stat(filename, &index_stat) ||
+        index_stat.st_mtime < dir_stat.st_mtime ||
+        NULL == (fp = fopen(filename, "r"))) {
+        free(filename);
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    while (NULL != fgets(buffer, BUFSIZ, fp)) {
+        len = strlen(buffer);
+        if (0 < len && '\n' == buffer[len - 1]) {
+            buffer[len - 1] = '\0';
+        }
+        if ('#' == buffer[0] || '\0' == buffer[0]) {
+            continue;
+        }
+        fields = opal_argv_split(buffer, ' ');
+        n = opal_argv_count(fields);
+        if (!valid) {
+            /* the first line is the version */
+            valid = (2 == n && 0 == strcmp(fields[0], "version") &&
+                     0 == strcmp(fields[1], OPAL_VERSION));
+            opal_argv_free(fields);
+            if (!valid) {
+                break;
+            }
+            continue;
+        }
+        if (n < 4 || 0 != strcmp(fields[2], OPAL_VERSION) || NULL != strchr(fields[3], '/')) {
+            valid = false;
+            opal_argv_free(fields);
+            break;
+        }
+        asprintf(&path, "%s" OPAL_PATH_SEP "%s", dir, fields[3]);
+        deps = (4 < n) ? opal_argv_join(fields + 4, ' ') : strdup("");
+        if (NULL != path && NULL != deps) {
+            opal_argv_append_nosize(&files, path);
+            opal_argv_append_nosize(&dependencies, deps);
+        }
+        free(path);
+        free(deps);
+        opal_argv_free(fields);
+    }
+    fclose(fp);
+
+    if (valid) {
+        opal_output_verbose(40, 0, "mca: base: component_find: using the component index %s",
+                            filename);
+        for (i = 0 ; NULL != files && NULL != files[i] ; ++i) {
+            opal_argv_append_nosize(&index_filenames, files[i]);
+            opal_argv_append_nosize(&index_dependencies, dependencies[i]);
+        }
+    } else {
+        opal_output_verbose(40, 0, "mca: base: component_find: ignoring the stale component index %s",
+                            filename);
+    }
+    opal_argv_free(files);
+    opal_argv_free(dependencies);
+    free(filename);
+    return valid ? OPAL_SUCCESS : OPAL_ERR_NOT_FOUND;
+}
+
+/*
+ * Find the component files of a directory: from its index when there
+ * is a valid one, otherwise by scanning it.
+ */
+static int scan_directory(const char *dir)
+{
+    if (mca_base_component_use_index && OPAL_SUCCESS == read_index(dir)) {
+        return 0;
+    }
+    return lt_dlforeachfile(dir, save_filename, NULL);
+}
+
+
 static int file_exists(const char *filename, const char *ext)
 {
     char *final;
@@ -726,7 +866,24 @@ static int check_ompi_info(component_file_item_t *target_file,
   size_t len;
   FILE *fp;
   char *depname;
-  char buffer[BUFSIZ], *p;
+  char buffer[BUFSIZ], *p, **deps;
+  int i;
+
+  /* The index already read the companion file */
+
+  if (target_file->indexed) {
+    deps = opal_argv_split(target_file->dependencies, ' ');
+    for (i = 0; NULL != deps && NULL != deps[i]; ++i) {
+      if (OPAL_SUCCESS != check_dependency(deps[i], target_file, dependencies,
+                                          found_components)) {
+        opal_argv_free(deps);
+        free_dependency_list(dependencies);
+        return OPAL_ERR_OUT_OF_RESOURCE;
+      }
+    }
+    opal_argv_free(deps);
+    return 0;
+  }
 
   /* Form the filename */
 
@@ -47,6 +47,7 @@ char *mca_base_system_default_path = NULL;
 char *mca_base_user_default_path = NULL;
 bool mca_base_component_show_load_errors = true;
 bool mca_base_component_disable_dlopen = false;
+bool mca_base_component_use_index = true;
 
 static char *mca_base_verbose = NULL;
 
@@ -120,6 +121,15 @@ int mca_base_open(void)
     (void) mca_base_var_register_synonym(var_id, "opal", "mca", NULL, "component_disable_dlopen",
                                          MCA_BASE_VAR_SYN_FLAG_DEPRECATED);
 
+    mca_base_component_use_index = true;
+    (void) mca_base_var_register("opal", "mca", "base", "component_use_index",
+                                 "Whether to find the dynamic components of a directory from the index written "
+                                 "at install time (mca-component-index) rather than by scanning the directory",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &mca_base_component_use_index);
+
     /* What verbosity level do we want for the default 0 stream? */
     mca_base_verbose = "stderr";
     var_id = mca_base_var_register("opal", "mca", "base", "verbose",
@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "opal/class/opal_hash_table.h"
 #include "opal/class/opal_list.h"
 #include "opal/mca/mca.h"
 #include "opal/mca/base/base.h"
@@ -33,11 +34,14 @@ static void save_value(const char *name, const char *value);
 
 static char * file_being_read;
 static opal_list_t * _param_list;
+static opal_hash_table_t * _param_index;
 
-int mca_base_parse_paramfile(const char *paramfile, opal_list_t *list)
+int mca_base_parse_paramfile(const char *paramfile, opal_list_t *list,
+                             opal_hash_table_t *index)
 {
     file_being_read = (char*)paramfile;
     _param_list = list;
+    _param_index = index;
 
     return opal_util_keyval_parse(paramfile, save_value);
 }
@@ -45,24 +49,18 @@ int mca_base_parse_paramfile(const char *paramfile, opal_list_t *list)
 static void save_value(const char *name, const char *value)
 {
     mca_base_var_file_value_t *fv;
-    bool found = false;
+    void *tmp;
 
-    /* First traverse through the list and ensure that we don't
-       already have a param of this name.  If we do, just replace the
-       value. */
+    /* First check that we don't already have a param of this name.
+       If we do, just replace the value. */
 
-    OPAL_LIST_FOREACH(fv, _param_list, mca_base_var_file_value_t) {
-        if (0 == strcmp(name, fv->mbvfv_var)) {
-            if (NULL != fv->mbvfv_value) {
-                free (fv->mbvfv_value);
-            }
-            free (fv->mbvfv_file);
-            found = true;
-            break;
+    if (OPAL_SUCCESS == opal_hash_table_get_value_ptr (_param_index, name, strlen (name), &tmp)) {
+        fv = (mca_base_var_file_value_t *) tmp;
+        if (NULL != fv->mbvfv_value) {
+            free (fv->mbvfv_value);
         }
-    }
-
-    if (!found) {
+        free (fv->mbvfv_file);
+    } else {
         /* We didn't already have the param, so append it to the list */
         fv = OBJ_NEW(mca_base_var_file_value_t);
         if (NULL == fv) {
@@ -71,6 +69,7 @@ static void save_value(const char *name, const char *value)
 
         fv->mbvfv_var = strdup(name);
         opal_list_append(_param_list, &fv->super);
+        opal_hash_table_set_value_ptr (_param_index, fv->mbvfv_var, strlen (fv->mbvfv_var), fv);
     }
 
     fv->mbvfv_value = value ? strdup(value) : NULL;
@@ -64,6 +64,9 @@ static char *mca_base_param_file_path = NULL;
 static bool mca_base_var_suppress_override_warning = false;
 static opal_list_t mca_base_var_file_values;
 static opal_list_t mca_base_var_override_values;
+/* name -> mca_base_var_file_value_t for the two lists above */
+static opal_hash_table_t mca_base_var_file_index;
+static opal_hash_table_t mca_base_var_override_index;
 
 static int mca_base_var_count = 0;
 
@@ -127,7 +130,7 @@ static const char *info_lvl_strings[] = {
  * local functions
  */
 static int fixup_files(char **file_list, char * path, bool rel_path_search);
-static int read_files (char *file_list, opal_list_t *file_values);
+static int read_files (char *file_list, opal_list_t *file_values, opal_hash_table_t *file_index);
 static int mca_base_var_cache_files (bool rel_path_search);
 static int var_set_initial (mca_base_var_t *var);
 static int var_get (int index, mca_base_var_t **var_out, bool original);
@@ -243,12 +246,24 @@ int mca_base_var_init(void)
         OBJ_CONSTRUCT(&mca_base_var_file_values, opal_list_t);
         OBJ_CONSTRUCT(&mca_base_var_override_values, opal_list_t);
         OBJ_CONSTRUCT(&mca_base_var_index_hash, opal_hash_table_t);
+        OBJ_CONSTRUCT(&mca_base_var_file_index, opal_hash_table_t);
+        OBJ_CONSTRUCT(&mca_base_var_override_index, opal_hash_table_t);
 
         ret = opal_hash_table_init (&mca_base_var_index_hash, 1024);
         if (OPAL_SUCCESS != ret) {
             return ret;
         }
 
+        ret = opal_hash_table_init (&mca_base_var_file_index, 256);
+        if (OPAL_SUCCESS != ret) {
+            return ret;
+        }
+
+        ret = opal_hash_table_init (&mca_base_var_override_index, 32);
+        if (OPAL_SUCCESS != ret) {
+            return ret;
+        }
+
         ret = mca_base_var_group_init ();
         if  (OPAL_SUCCESS != ret) {
             return ret;
@@ -407,10 +422,11 @@ static int mca_base_var_cache_files(bool rel_path_search)
         }
     }
 
-    read_files (mca_base_var_files, &mca_base_var_file_values);
+    read_files (mca_base_var_files, &mca_base_var_file_values, &mca_base_var_file_index);
 
     if (0 == access(mca_base_var_override_file, F_OK)) {
-        read_files (mca_base_var_override_file, &mca_base_var_override_values);
+        read_files (mca_base_var_override_file, &mca_base_var_override_values,
+                    &mca_base_var_override_index);
     }
 
     return OPAL_SUCCESS;
@@ -970,6 +986,9 @@ int mca_base_var_finalize(void)
         }
         OBJ_DESTRUCT(&mca_base_var_override_values);
 
+        OBJ_DESTRUCT(&mca_base_var_file_index);
+        OBJ_DESTRUCT(&mca_base_var_override_index);
+
         if( NULL != cwd ) {
             free(cwd);
             cwd = NULL;
@@ -1090,7 +1109,7 @@ static int fixup_files(char **file_list, char * path, bool rel_path_search) {
     return exit_status;
 }
 
-static int read_files(char *file_list, opal_list_t *file_values)
+static int read_files(char *file_list, opal_list_t *file_values, opal_hash_table_t *file_index)
 {
     int i, count;
 
@@ -1102,7 +1121,7 @@ static int read_files(char *file_list, opal_list_t *file_values)
     count = opal_argv_count(mca_base_var_file_list);
 
     for (i = count - 1; i >= 0; --i) {
-        mca_base_parse_paramfile(mca_base_var_file_list[i], file_values);
+        mca_base_parse_paramfile(mca_base_var_file_list[i], file_values, file_index);
     }
 
     return OPAL_SUCCESS;
@@ -1464,12 +1483,13 @@ static int var_set_from_env (mca_base_var_t *var)
 /*
  * Lookup a param in the files
  */
-static int var_set_from_file (mca_base_var_t *var, opal_list_t *file_values)
+static int var_set_from_file (mca_base_var_t *var, opal_hash_table_t *file_index)
 {
     const char *var_full_name = var->mbv_full_name;
     const char *var_long_name = var->mbv_long_name;
     bool deprecated = VAR_IS_DEPRECATED(var[0]);
     mca_base_var_file_value_t *fv;
+    void *tmp;
     int ret;
 
     if (VAR_IS_SYNONYM(var[0])) {
@@ -1483,15 +1503,17 @@ static int var_set_from_file (mca_base_var_t *var, opal_list_t *file_values)
         }
     }
 
-    /* Scan through the list of values read in from files and try to
-       find a match.  If we do, cache it on the param (for future
-       lookups) and save it in the storage. */
+    /* Look the values read in from files up by name.  If we find a
+       match, cache it on the param (for future lookups) and save it
+       in the storage. */
 
-    OPAL_LIST_FOREACH(fv, file_values, mca_base_var_file_value_t) {
-        if (0 != strcmp(fv->mbvfv_var, var_full_name) &&
-            0 != strcmp(fv->mbvfv_var, var_long_name)) {
-            continue;
-        }
+    ret = opal_hash_table_get_value_ptr (file_index, var_full_name, strlen (var_full_name), &tmp);
+    if (OPAL_SUCCESS != ret && NULL != var_long_name) {
+        ret = opal_hash_table_get_value_ptr (file_index, var_long_name, strlen (var_long_name), &tmp);
+    }
+
+    if (OPAL_SUCCESS == ret) {
+        fv = (mca_base_var_file_value_t *) tmp;
 
         /* found it */
         if (VAR_IS_DEFAULT_ONLY(var[0])) {
@@ -1551,7 +1573,7 @@ static int var_set_initial (mca_base_var_t *var)
        order. If the default only flag is set the user will get a
        warning if they try to set a value from the environment or a
        file. */
-    ret = var_set_from_file (var, &mca_base_var_override_values);
+    ret = var_set_from_file (var, &mca_base_var_override_index);
     if (OPAL_SUCCESS == ret) {
         var->mbv_flags = ~MCA_BASE_VAR_FLAG_SETTABLE & (var->mbv_flags | MCA_BASE_VAR_FLAG_OVERRIDE);
         var->mbv_source = MCA_BASE_VAR_SOURCE_OVERRIDE;
@@ -1562,7 +1584,7 @@ static int var_set_initial (mca_base_var_t *var)
         return ret;
     }
 
-    ret = var_set_from_file (var, &mca_base_var_file_values);
+    ret = var_set_from_file (var, &mca_base_var_file_index);
     if (OPAL_ERR_NOT_FOUND != ret) {
         return ret;
     }
@@ -116,9 +116,11 @@ OPAL_DECLSPEC int mca_base_var_group_get_internal (const int group_index, mca_ba
 /**
  * \internal
  *
- * Parse a parameter file.
+ * Parse a parameter file.  Values are appended to list and indexed
+ * by variable name in index (mapping to the list item).
  */
-OPAL_DECLSPEC int mca_base_parse_paramfile(const char *paramfile, opal_list_t *list);
+OPAL_DECLSPEC int mca_base_parse_paramfile(const char *paramfile, opal_list_t *list,
+                                           opal_hash_table_t *index);
 
 /**
  * \internal
@@ -79,6 +79,33 @@ typedef int (*opal_compress_base_module_decompress_fn_t)
 typedef int (*opal_compress_base_module_decompress_nb_fn_t)
     (char * cname, char **fname, pid_t *child_pid);
 
+/**
+ * Compress a buffer in memory
+ * Arguments:
+ *   inbuf  = Data to compress
+ *   inlen  = Length of the data
+ *   outbuf = Buffer receiving the compressed data
+ *   outlen = In: size of outbuf, out: length of the compressed data
+ * Returns:
+ *   OPAL_SUCCESS on success, OPAL_ERR_OUT_OF_RESOURCE if outbuf is too
+ *   small, ow OPAL_ERROR
+ */
+typedef int (*opal_compress_base_module_compress_block_fn_t)
+    (const void *inbuf, size_t inlen, void *outbuf, size_t *outlen);
+
+/**
+ * Decompress a buffer compressed by compress_block
+ * Arguments:
+ *   inbuf  = Compressed data
+ *   inlen  = Length of the compressed data
+ *   outbuf = Buffer receiving the data
+ *   outlen = In: size of outbuf, out: length of the data
+ * Returns:
+ *   OPAL_SUCCESS on success, ow OPAL_ERROR
+ */
+typedef int (*opal_compress_base_module_decompress_block_fn_t)
+    (const void *inbuf, size_t inlen, void *outbuf, size_t *outlen);
+
 /**
  * Structure for COMPRESS components.
  */
@@ -114,6 +141,10 @@ struct opal_compress_base_module_1_0_0_t {
     /** Decompress Interface */
     opal_compress_base_module_decompress_fn_t     decompress;
     opal_compress_base_module_decompress_nb_fn_t  decompress_nb;
+
+    /** Block interface, NULL for the components only handling files */
+    opal_compress_base_module_compress_block_fn_t   compress_block;
+    opal_compress_base_module_decompress_block_fn_t decompress_block;
 };
 typedef struct opal_compress_base_module_1_0_0_t opal_compress_base_module_1_0_0_t;
 typedef struct opal_compress_base_module_1_0_0_t opal_compress_base_module_t;
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2013      The Trustees of Indiana University.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+/**
+ * @file
+ * 
+ * LZ4 COMPRESS component
+ *
+ * Uses liblz4 for the buffers, and the lz4 command for the files
+ */
+
+#ifndef MCA_COMPRESS_LZ4_EXPORT_H
+#define MCA_COMPRESS_LZ4_EXPORT_H
+
+#include "opal_config.h"
+
+#include "opal/util/output.h"
+
+#include "opal/mca/mca.h"
+#include "opal/mca/compress/compress.h"
+
+#if defined(c_plusplus) || defined(__cplusplus)
+extern "C" {
+#endif
+
+    /*
+     * Local Component structures
+     */
+    struct opal_compress_lz4_component_t {
+        opal_compress_base_component_t super;  /** Base COMPRESS component */
+
+        /** Acceleration of LZ4_compress_fast, 1 is LZ4_compress_default */
+        int acceleration;
+    };
+    typedef struct opal_compress_lz4_component_t opal_compress_lz4_component_t;
+    OPAL_MODULE_DECLSPEC extern opal_compress_lz4_component_t mca_compress_lz4_component;
+
+    int opal_compress_lz4_component_query(mca_base_module_t **module, int *priority);
+
+    /*
+     * Module functions
+     */
+    int opal_compress_lz4_module_init(void);
+    int opal_compress_lz4_module_finalize(void);
+
+    /*
+     * Actual funcationality
+     */
+    int opal_compress_lz4_compress(char *fname, char **cname, char **postfix);
+    int opal_compress_lz4_compress_nb(char *fname, char **cname, char **postfix, pid_t *child_pid);
+    int opal_compress_lz4_decompress(char *cname, char **fname);
+    int opal_compress_lz4_decompress_nb(char *cname, char **fname, pid_t *child_pid);
+
+    int opal_compress_lz4_compress_block(const void *inbuf, size_t inlen,
+                                         void *outbuf, size_t *outlen);
+    int opal_compress_lz4_decompress_block(const void *inbuf, size_t inlen,
+                                           void *outbuf, size_t *outlen);
+
+#if defined(c_plusplus) || defined(__cplusplus)
+}
+#endif
+
+#endif /* MCA_COMPRESS_LZ4_EXPORT_H */
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2013      The Trustees of Indiana University.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include "opal/constants.h"
+#include "opal/mca/compress/compress.h"
+#include "opal/mca/compress/base/base.h"
+#include "compress_lz4.h"
+
+/*
+ * Public string for version number
+ */
+const char *opal_compress_lz4_component_version_string = 
+"OPAL COMPRESS lz4 MCA component version " OPAL_VERSION;
+
+/*
+ * Local functionality
+ */
+static int compress_lz4_register (void);
+static int compress_lz4_open(void);
+static int compress_lz4_close(void);
+
+/*
+ * Instantiate the public struct with all of our public information
+ * and pointer to our public functions in it
+ */
+opal_compress_lz4_component_t mca_compress_lz4_component = {
+    /* First do the base component stuff */
+    {
+        /* Handle the general mca_component_t struct containing 
+         *  meta information about the component itself
+         */
+        {
+            OPAL_COMPRESS_BASE_VERSION_2_0_0,
+
+            /* Component name and version */
+            "lz4",
+            OPAL_MAJOR_VERSION,
+            OPAL_MINOR_VERSION,
+            OPAL_RELEASE_VERSION,
+            
+            /* Component open and close functions */
+            compress_lz4_open,
+            compress_lz4_close,
+            opal_compress_lz4_component_query,
+            compress_lz4_register
+        },
+        {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        },
+        
+        /* Verbosity level */
+        0,
+        /* opal_output handler */
+        -1
+    },
+    /* acceleration */
+    1
+};
+
+/*
+ * LZ4 module
+ */
+static opal_compress_base_module_t loc_module = {
+    /** Initialization Function */
+    opal_compress_lz4_module_init,
+    /** Finalization Function */
+    opal_compress_lz4_module_finalize,
+
+    /** Compress Function */
+    opal_compress_lz4_compress,
+    opal_compress_lz4_compress_nb,
+
+    /** Decompress Function */
+    opal_compress_lz4_decompress,
+    opal_compress_lz4_decompress_nb,
+
+    /** Block Functions */
+    opal_compress_lz4_compress_block,
+    opal_compress_lz4_decompress_block
+};
+
+static int compress_lz4_register (void)
+{
+    int ret;
+
+    /* below gzip, so that the checkpoints keep their format unless
+       this component is asked for */
+    mca_compress_lz4_component.super.priority = 10;
+    ret = mca_base_component_var_register (&mca_compress_lz4_component.super.base_version,
+                                           "priority", "Priority of the COMPRESS lz4 component "
+                                           "(default: 10)", MCA_BASE_VAR_TYPE_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_ALL_EQ,
+                                           &mca_compress_lz4_component.super.priority);
+    if (0 > ret) {
+        return ret;
+    }
+
+    mca_compress_lz4_component.acceleration = 1;
+    ret = mca_base_component_var_register (&mca_compress_lz4_component.super.base_version,
+                                           "acceleration",
+                                           "Acceleration of the block compression, higher is "
+                                           "faster and compresses less (default: 1)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_ALL_EQ,
+                                           &mca_compress_lz4_component.acceleration);
+    if (0 > ret) {
+        return ret;
+    }
+
+    mca_compress_lz4_component.super.verbose = 0;
+    ret = mca_base_component_var_register (&mca_compress_lz4_component.super.base_version,
+                                           "verbose",
+                                           "Verbose level for the COMPRESS lz4 component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_compress_lz4_component.super.verbose);
+    return (0 > ret) ? ret : OPAL_SUCCESS;
+}
+
+static int compress_lz4_open(void) 
+{
+    /* If there is a custom verbose level for this component than use it
+     * otherwise take our parents level and output channel
+     */
+    if ( 0 != mca_compress_lz4_component.super.verbose) {
+        mca_compress_lz4_component.super.output_handle = opal_output_open(NULL);
+        opal_output_set_verbosity(mca_compress_lz4_component.super.output_handle, 
+                                  mca_compress_lz4_component.super.verbose);
+    } else {
+        mca_compress_lz4_component.super.output_handle = opal_compress_base_framework.framework_output;
+    }
+
+    /*
+     * Debug output
+     */
+    opal_output_verbose(10, mca_compress_lz4_component.super.output_handle,
+                        "compress:lz4: open()");
+    opal_output_verbose(20, mca_compress_lz4_component.super.output_handle,
+                        "compress:lz4: open: priority = %d", 
+                        mca_compress_lz4_component.super.priority);
+    opal_output_verbose(20, mca_compress_lz4_component.super.output_handle,
+                        "compress:lz4: open: verbosity = %d", 
+                        mca_compress_lz4_component.super.verbose);
+    return OPAL_SUCCESS;
+}
+
+static int compress_lz4_close(void)
+{
+    return OPAL_SUCCESS;
+}
+
+int opal_compress_lz4_component_query(mca_base_module_t **module, int *priority)
+{
+    *module   = (mca_base_module_t *)&loc_module;
+    *priority = mca_compress_lz4_component.super.priority;
+
+    return OPAL_SUCCESS;
+}
+
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2013      The Trustees of Indiana University.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <string.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif  /* HAVE_UNISTD_H */
+
+#include <lz4.h>
+
+#include "opal/util/output.h"
+#include "opal/util/argv.h"
+
+#include "opal/constants.h"
+#include "opal/util/basename.h"
+
+#include "opal/mca/compress/compress.h"
+#include "opal/mca/compress/base/base.h"
+
+#include "compress_lz4.h"
+
+static bool is_directory(char *fname );
+static int wait_child(pid_t child_pid);
+
+int opal_compress_lz4_module_init(void)
+{
+    return OPAL_SUCCESS;
+}
+
+int opal_compress_lz4_module_finalize(void)
+{
+    return OPAL_SUCCESS;
+}
+
+int opal_compress_lz4_compress(char * fname, char **cname, char **postfix)
+{
+    pid_t child_pid = 0;
+
+    opal_output_verbose(10, mca_compress_lz4_component.super.output_handle,
+                        "compress:lz4: compress(%s)",
+                        fname);
+
+    if( OPAL_SUCCESS != opal_compress_lz4_compress_nb(fname, cname, postfix, &child_pid) ) {
+        return OPAL_ERROR;
+    }
+    return wait_child(child_pid);
+}
+
+int opal_compress_lz4_compress_nb(char * fname, char **cname, char **postfix, pid_t *child_pid)
+{
+    char * cmd = NULL;
+    char **argv = NULL;
+    char * base_fname = NULL;
+    char * dir_fname = NULL;
+    int status;
+    bool is_dir;
+
+    is_dir = is_directory(fname);
+
+    *child_pid = fork();
+    if( *child_pid == 0 ) { /* Child */
+
+        dir_fname  = opal_dirname(fname);
+        base_fname = opal_basename(fname);
+
+        chdir(dir_fname);
+
+        if( is_dir ) {
+            asprintf(&cmd, "tar -I lz4 -cf %s.tar.lz4 %s", base_fname, base_fname);
+        } else {
+            asprintf(&cmd, "lz4 -q --rm %s %s.lz4", base_fname, base_fname);
+        }
+
+        opal_output_verbose(10, mca_compress_lz4_component.super.output_handle,
+                            "compress:lz4: compress_nb() command [%s]",
+                            cmd);
+
+        argv = opal_argv_split(cmd, ' ');
+        status = execvp(argv[0], argv);
+
+        opal_output(0, "compress:lz4: compress_nb: Failed to exec child [%s] status = %d\n", cmd, status);
+        exit(OPAL_ERROR);
+    }
+    else if( *child_pid > 0 ) {
+        if( is_dir ) {
+            *postfix = strdup(".tar.lz4");
+        } else {
+            *postfix = strdup(".lz4");
+        }
+        asprintf(cname, "%s%s", fname, *postfix);
+    }
+    else {
+        return OPAL_ERROR;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+int opal_compress_lz4_decompress(char * cname, char **fname)
+{
+    pid_t child_pid = 0;
+
+    opal_output_verbose(10, mca_compress_lz4_component.super.output_handle,
+                        "compress:lz4: decompress(%s)",
+                        cname);
+
+    if( OPAL_SUCCESS != opal_compress_lz4_decompress_nb(cname, fname, &child_pid) ) {
+        return OPAL_ERROR;
+    }
+    return wait_child(child_pid);
+}
+
+int opal_compress_lz4_decompress_nb(char * cname, char **fname, pid_t *child_pid)
+{
+    char * cmd = NULL;
+    char **argv = NULL;
+    char * dir_cname = NULL;
+    char * base_cname = NULL;
+    size_t len = strlen(cname);
+    int status;
+    bool is_tar = false;
+
+    if( len > 8 && 0 == strcmp(&(cname[len-8]), ".tar.lz4") ) {
+        is_tar = true;
+    }
+    else if( len <= 4 || 0 != strcmp(&(cname[len-4]), ".lz4") ) {
+        return OPAL_ERROR;
+    }
+
+    /* Strip off '.tar.lz4' or '.lz4' */
+    *fname = strdup(cname);
+    (*fname)[len - (is_tar ? 8 : 4)] = '\0';
+
+    opal_output_verbose(10, mca_compress_lz4_component.super.output_handle,
+                        "compress:lz4: decompress_nb(%s -> [%s])",
+                        cname, *fname);
+
+    *child_pid = fork();
+    if( *child_pid == 0 ) { /* Child */
+        dir_cname  = opal_dirname(cname);
+        base_cname = opal_basename(cname);
+
+        chdir(dir_cname);
+
+        if( is_tar ) {
+            asprintf(&cmd, "tar -I lz4 -xf %s", base_cname);
+        } else {
+            asprintf(&cmd, "lz4 -d -q --rm %s", base_cname);
+        }
+
+        opal_output_verbose(10, mca_compress_lz4_component.super.output_handle,
+                            "compress:lz4: decompress_nb() command [%s]",
+                            cmd);
+
+        argv = opal_argv_split(cmd, ' ');
+        status = execvp(argv[0], argv);
+
+        opal_output(0, "compress:lz4: decompress_nb: Failed to exec child [%s] status = %d\n", cmd, status);
+        exit(OPAL_ERROR);
+    }
+    else if( *child_pid < 0 ) {
+        return OPAL_ERROR;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+int opal_compress_lz4_compress_block(const void *inbuf, size_t inlen,
+                                     void *outbuf, size_t *outlen)
+{
+    int ret;
+
+    /* the library counts in int */
+    if( inlen > (size_t) LZ4_MAX_INPUT_SIZE ) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    ret = LZ4_compress_fast((const char *) inbuf, (char *) outbuf, (int) inlen,
+                            (int) (*outlen > INT_MAX ? INT_MAX : *outlen),
+                            mca_compress_lz4_component.acceleration);
+    if( 0 >= ret ) {
+        /* the only failure is outbuf being too small, which the caller
+           may handle by keeping the data uncompressed */
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    *outlen = (size_t) ret;
+
+    return OPAL_SUCCESS;
+}
+
+int opal_compress_lz4_decompress_block(const void *inbuf, size_t inlen,
+                                       void *outbuf, size_t *outlen)
+{
+    int ret;
+
+    if( inlen > INT_MAX ) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    ret = LZ4_decompress_safe((const char *) inbuf, (char *) outbuf, (int) inlen,
+                              (int) (*outlen > INT_MAX ? INT_MAX : *outlen));
+    if( 0 > ret ) {
+        opal_output_verbose(10, mca_compress_lz4_component.super.output_handle,
+                            "compress:lz4: decompress_block: corrupted input or output too small");
+        return OPAL_ERROR;
+    }
+    *outlen = (size_t) ret;
+
+    return OPAL_SUCCESS;
+}
+
+static int wait_child(pid_t child_pid)
+{
+    int status = 0;
+
+    waitpid(child_pid, &status, 0);
+
+    if( WIFEXITED(status) && 0 == WEXITSTATUS(status) ) {
+        return OPAL_SUCCESS;
+    } else {
+        return OPAL_ERROR;
+    }
+}
+
+static bool is_directory(char *fname ) {
+    struct stat file_status;
+    int rc;
+
+    if(0 != (rc = stat(fname, &file_status) ) ) {
+        return false;
+    }
+    if(S_ISDIR(file_status.st_mode)) {
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,50 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2013      The Trustees of Indiana University.
+#                         All rights reserved.
+# $COPYRIGHT$
+# 
+# Additional copyrights may follow
+# 
+# $HEADER$
+#
+
+# MCA_compress_lz4_CONFIG([action-if-found], [action-if-not-found])
+# -----------------------------------------------------------
+AC_DEFUN([MCA_opal_compress_lz4_CONFIG],[
+    AC_CONFIG_FILES([opal/mca/compress/lz4/Makefile])
+
+    OPAL_VAR_SCOPE_PUSH([compress_lz4_happy compress_lz4_dir compress_lz4_libdir])
+
+    AC_ARG_WITH([lz4],
+                [AC_HELP_STRING([--with-lz4(=DIR)],
+                [Build the lz4 compress component, searching for liblz4 in DIR])])
+    OMPI_CHECK_WITHDIR([lz4], [$with_lz4], [include/lz4.h])
+
+    AC_ARG_WITH([lz4-libdir],
+                [AC_HELP_STRING([--with-lz4-libdir=DIR],
+                                [Search for liblz4 in DIR])])
+    OMPI_CHECK_WITHDIR([lz4-libdir], [$with_lz4_libdir], [liblz4.*])
+
+    AS_IF([test "$with_lz4" != "no"],
+          [AS_IF([test ! -z "$with_lz4" -a "$with_lz4" != "yes"],
+                 [compress_lz4_dir="$with_lz4"])
+           AS_IF([test ! -z "$with_lz4_libdir" -a "$with_lz4_libdir" != "yes"],
+                 [compress_lz4_libdir="$with_lz4_libdir"])
+           OMPI_CHECK_PACKAGE([compress_lz4], [lz4.h], [lz4], [LZ4_compress_default], [],
+                              [$compress_lz4_dir], [$compress_lz4_libdir],
+                              [compress_lz4_happy="yes"], [compress_lz4_happy="no"])],
+          [compress_lz4_happy="no"])
+
+    AS_IF([test "$compress_lz4_happy" = "yes"],
+          [$1],
+          [AS_IF([test ! -z "$with_lz4" -a "$with_lz4" != "no"],
+                 [AC_MSG_ERROR([lz4 support requested but not found.  Aborting])])
+           $2])
+
+    AC_SUBST([compress_lz4_CPPFLAGS])
+    AC_SUBST([compress_lz4_LDFLAGS])
+    AC_SUBST([compress_lz4_LIBS])
+
+    OPAL_VAR_SCOPE_POP
+])dnl
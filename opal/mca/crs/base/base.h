@@ -39,6 +39,7 @@ BEGIN_C_DECLS
 #define CRS_METADATA_CONTEXT    ("# CONTEXT: ")
 #define CRS_METADATA_MKDIR      ("# MKDIR: ")
 #define CRS_METADATA_TOUCH      ("# TOUCH: ")
+#define CRS_METADATA_INCR       ("# INCR: ")
 
     /**
      * Initialize the CRS MCA framework
@@ -131,6 +132,32 @@ BEGIN_C_DECLS
     OPAL_DECLSPEC int opal_crs_base_self_register_continue_callback
                       (opal_crs_base_self_continue_fn_t  function);
 
+    /*
+     * Incremental checkpoint of registered memory regions
+     * (crs_base_incr: full the first time, dirty pages afterwards)
+     */
+    OPAL_DECLSPEC extern bool opal_crs_base_incr_enabled;
+    OPAL_DECLSPEC extern int opal_crs_base_incr_max_chain;
+
+    /*
+     * Add a region to the checkpoints, restoring it first when
+     * restarting
+     */
+    OPAL_DECLSPEC int opal_crs_base_incr_register(void *base, size_t size);
+
+    /*
+     * Write the regions in the snapshot directory, and the chain of
+     * deltas to the metadata
+     */
+    OPAL_DECLSPEC int opal_crs_base_incr_checkpoint(opal_crs_base_snapshot_t *snapshot);
+
+    /*
+     * Read the chain of deltas of a snapshot, to replay in the regions
+     */
+    OPAL_DECLSPEC int opal_crs_base_incr_restore(const char *metadata_filename);
+
+    OPAL_DECLSPEC void opal_crs_base_incr_finalize(void);
+
 END_C_DECLS
 
 #endif /* OPAL_CRS_BASE_H */
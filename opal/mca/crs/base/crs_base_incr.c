@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Incremental checkpoint of the memory regions an application registers.
+ *
+ * The first checkpoint writes the regions whole.  The following ones only
+ * write the pages modified since the previous checkpoint, as told by the
+ * soft-dirty bits of /proc/self/pagemap, in a delta that the metadata of
+ * the snapshot chains to the previous ones.  Every crs_base_incr_max_chain
+ * checkpoints, or when the kernel does not track the dirty pages, the
+ * checkpoint is a full one again.  The files go to the local snapshot
+ * directory, which sstore/stage moves to the global one in the background.
+ *
+ * At restart the chain is replayed, oldest first, into every region as it
+ * is registered again: the application registers the same regions, in the
+ * same order and with the same sizes.
+ */
+
+#include "opal_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#include <errno.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+
+#include "opal/constants.h"
+#include "opal/util/argv.h"
+#include "opal/util/output.h"
+#include "opal/mca/crs/crs.h"
+#include "opal/mca/crs/base/base.h"
+
+#define INCR_FILENAME "opal_crs_incr"
+#define INCR_MAGIC    "OCRSINC1"
+#define INCR_END      ((uint32_t) -1)
+/* pagemap: bit 55 is soft-dirty */
+#define PAGEMAP_SOFT_DIRTY ((uint64_t) 1 << 55)
+#define PAGEMAP_BATCH 512
+
+typedef struct {
+    unsigned char *base;
+    size_t size;
+} incr_region_t;
+
+/* a delta record header, followed by length bytes */
+typedef struct {
+    uint32_t region;
+    uint32_t pad;
+    uint64_t offset;
+    uint64_t length;
+} incr_record_t;
+
+bool opal_crs_base_incr_enabled = false;
+int opal_crs_base_incr_max_chain = 8;
+
+static incr_region_t *incr_regions = NULL;
+static int incr_num_regions = 0;
+/* the snapshot directories of the chain so far, the full one first */
+static char **incr_chain = NULL;
+/* -1 unknown, 0 no soft-dirty bits, 1 tracking */
+static int incr_dirty_state = -1;
+/* the files to replay in the regions at restart */
+static char **incr_restore_files = NULL;
+
+static int incr_clear_dirty(void)
+{
+    int fd, rc;
+
+    fd = open("/proc/self/clear_refs", O_WRONLY);
+    if (0 > fd) {
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+    rc = (1 == write(fd, "4", 1)) ? OPAL_SUCCESS : OPAL_ERR_NOT_SUPPORTED;
+    close(fd);
+    return rc;
+}
+
+/* the soft-dirty bits are cleared, and a page written since reads dirty */
+static bool incr_dirty_tracking(void)
+{
+    static volatile char probe[1];
+    uint64_t entry = 0;
+    long page = sysconf(_SC_PAGESIZE);
+    int fd;
+
+    if (0 <= incr_dirty_state) {
+        return 1 == incr_dirty_state;
+    }
+    incr_dirty_state = 0;
+    if (OPAL_SUCCESS != incr_clear_dirty()) {
+        return false;
+    }
+    probe[0]++;
+    fd = open("/proc/self/pagemap", O_RDONLY);
+    if (0 <= fd) {
+        if (sizeof(entry) == pread(fd, &entry, sizeof(entry),
+                                   ((uintptr_t) probe / page) * sizeof(entry)) &&
+            0 != (entry & PAGEMAP_SOFT_DIRTY)) {
+            incr_dirty_state = 1;
+        }
+        close(fd);
+    }
+    return 1 == incr_dirty_state;
+}
+
+static int incr_write(int fd, const void *buf, size_t len)
+{
+    const char *p = (const char *) buf;
+    ssize_t rc;
+
+    while (len > 0) {
+        rc = write(fd, p, len);
+        if (0 > rc) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return OPAL_ERR_FILE_WRITE_FAILURE;
+        }
+        p += rc;
+        len -= rc;
+    }
+    return OPAL_SUCCESS;
+}
+
+static int incr_write_record(int fd, int region, size_t offset, size_t length)
+{
+    incr_record_t record;
+    int rc;
+
+    memset(&record, 0, sizeof(record));
+    record.region = (uint32_t) region;
+    record.offset = offset;
+    record.length = length;
+    if (OPAL_SUCCESS != (rc = incr_write(fd, &record, sizeof(record)))) {
+        return rc;
+    }
+    return incr_write(fd, incr_regions[region].base + offset, length);
+}
+
+/* the runs of dirty pages of a region, the partial pages at the ends included */
+static int incr_write_dirty(int fd, int pagemap, int region, long page)
+{
+    uintptr_t start = (uintptr_t) incr_regions[region].base;
+    uintptr_t end = start + incr_regions[region].size;
+    uintptr_t first = start / page, last = (end + page - 1) / page, p, run = 0;
+    uint64_t entries[PAGEMAP_BATCH];
+    bool in_run = false;
+    size_t n, i;
+    int rc;
+
+    for (p = first ; p < last ; p += n) {
+        n = (last - p < PAGEMAP_BATCH) ? (size_t) (last - p) : PAGEMAP_BATCH;
+        if ((ssize_t) (n * sizeof(uint64_t)) !=
+            pread(pagemap, entries, n * sizeof(uint64_t), p * sizeof(uint64_t))) {
+            return OPAL_ERR_FILE_READ_FAILURE;
+        }
+        for (i = 0 ; i < n ; ++i) {
+            bool dirty = (0 != (entries[i] & PAGEMAP_SOFT_DIRTY));
+
+            if (dirty && !in_run) {
+                run = p + i;
+                in_run = true;
+            } else if (!dirty && in_run) {
+                uintptr_t from = (run * page > start) ? run * page : start;
+                uintptr_t to = (p + i) * page;
+
+                if (OPAL_SUCCESS != (rc = incr_write_record(fd, region, from - start, to - from))) {
+                    return rc;
+                }
+                in_run = false;
+            }
+        }
+    }
+    if (in_run) {
+        uintptr_t from = (run * page > start) ? run * page : start;
+
+        return incr_write_record(fd, region, from - start, end - from);
+    }
+    return OPAL_SUCCESS;
+}
+
+/* the path of to relative to the directory from, both absolute */
+static char *incr_relative_path(const char *from, const char *to)
+{
+    char **f = opal_argv_split(from, '/'), **t = opal_argv_split(to, '/');
+    char *path = NULL, *tmp;
+    int i = 0, j;
+
+    while (NULL != f && NULL != t && NULL != f[i] && NULL != t[i] && 0 == strcmp(f[i], t[i])) {
+        ++i;
+    }
+    path = strdup(".");
+    for (j = i ; NULL != f && NULL != f[j] ; ++j) {
+        asprintf(&tmp, "%s/..", path);
+        free(path);
+        path = tmp;
+    }
+    for (j = i ; NULL != t && NULL != t[j] ; ++j) {
+        asprintf(&tmp, "%s/%s", path, t[j]);
+        free(path);
+        path = tmp;
+    }
+    opal_argv_free(f);
+    opal_argv_free(t);
+    return path;
+}
+
+static int incr_restore_region(int region)
+{
+    incr_record_t record;
+    char magic[sizeof(INCR_MAGIC)];
+    int i, fd, rc = OPAL_SUCCESS;
+    uint32_t count;
+
+    for (i = 0 ; NULL != incr_restore_files && NULL != incr_restore_files[i] ; ++i) {
+        fd = open(incr_restore_files[i], O_RDONLY);
+        if (0 > fd) {
+            opal_output(0, "crs:base: incr: unable to open %s", incr_restore_files[i]);
+            return OPAL_ERR_FILE_OPEN_FAILURE;
+        }
+        if (sizeof(magic) != read(fd, magic, sizeof(magic)) ||
+            0 != memcmp(magic, INCR_MAGIC, sizeof(magic)) ||
+            sizeof(count) != read(fd, &count, sizeof(count)) || (int) count <= region) {
+            close(fd);
+            opal_output(0, "crs:base: incr: %s does not match the registered regions",
+                        incr_restore_files[i]);
+            return OPAL_ERR_BAD_PARAM;
+        }
+        while (sizeof(record) == read(fd, &record, sizeof(record)) && INCR_END != record.region) {
+            if (record.region != (uint32_t) region) {
+                if ((off_t) -1 == lseek(fd, (off_t) record.length, SEEK_CUR)) {
+                    rc = OPAL_ERR_FILE_READ_FAILURE;
+                    break;
+                }
+                continue;
+            }
+            if (record.offset + record.length > incr_regions[region].size ||
+                (ssize_t) record.length != read(fd, incr_regions[region].base + record.offset,
+                                                record.length)) {
+                rc = OPAL_ERR_FILE_READ_FAILURE;
+                break;
+            }
+        }
+        close(fd);
+        if (OPAL_SUCCESS != rc) {
+            return rc;
+        }
+    }
+    return OPAL_SUCCESS;
+}
+
+int opal_crs_base_incr_register(void *base, size_t size)
+{
+    incr_region_t *tmp;
+
+    tmp = (incr_region_t *) realloc(incr_regions, (incr_num_regions + 1) * sizeof(*tmp));
+    if (NULL == tmp) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    incr_regions = tmp;
+    incr_regions[incr_num_regions].base = (unsigned char *) base;
+    incr_regions[incr_num_regions].size = size;
+    ++incr_num_regions;
+    /* a new region is not in the deltas */
+    opal_argv_free(incr_chain);
+    incr_chain = NULL;
+
+    if (NULL != incr_restore_files) {
+        return incr_restore_region(incr_num_regions - 1);
+    }
+    return OPAL_SUCCESS;
+}
+
+int opal_crs_base_incr_checkpoint(opal_crs_base_snapshot_t *snapshot)
+{
+    bool full = (NULL == incr_chain || opal_argv_count(incr_chain) >= opal_crs_base_incr_max_chain ||
+                 !incr_dirty_tracking());
+    long page = sysconf(_SC_PAGESIZE);
+    uint32_t count = (uint32_t) incr_num_regions;
+    incr_record_t end;
+    char *filename, *path;
+    int fd, pagemap = -1, i, rc;
+
+    if (0 == incr_num_regions) {
+        return OPAL_SUCCESS;
+    }
+
+    asprintf(&filename, "%s/%s", snapshot->snapshot_directory, INCR_FILENAME);
+    fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    free(filename);
+    if (0 > fd) {
+        return OPAL_ERR_FILE_OPEN_FAILURE;
+    }
+    if (!full && 0 > (pagemap = open("/proc/self/pagemap", O_RDONLY))) {
+        full = true;
+    }
+
+    rc = incr_write(fd, INCR_MAGIC, sizeof(INCR_MAGIC));
+    if (OPAL_SUCCESS == rc) {
+        rc = incr_write(fd, &count, sizeof(count));
+    }
+    for (i = 0 ; OPAL_SUCCESS == rc && i < incr_num_regions ; ++i) {
+        rc = full ? incr_write_record(fd, i, 0, incr_regions[i].size) :
+            incr_write_dirty(fd, pagemap, i, page);
+    }
+    if (OPAL_SUCCESS == rc) {
+        memset(&end, 0, sizeof(end));
+        end.region = INCR_END;
+        rc = incr_write(fd, &end, sizeof(end));
+    }
+    if (0 <= pagemap) {
+        close(pagemap);
+    }
+    if (0 != close(fd) && OPAL_SUCCESS == rc) {
+        rc = OPAL_ERR_FILE_WRITE_FAILURE;
+    }
+    if (OPAL_SUCCESS != rc) {
+        /* the next one starts over */
+        opal_argv_free(incr_chain);
+        incr_chain = NULL;
+        return rc;
+    }
+
+    /* the pages written from now on go into the next delta */
+    if (1 == incr_dirty_state && OPAL_SUCCESS != incr_clear_dirty()) {
+        incr_dirty_state = 0;
+    }
+    if (full) {
+        opal_argv_free(incr_chain);
+        incr_chain = NULL;
+    }
+    opal_argv_append_nosize(&incr_chain, snapshot->snapshot_directory);
+
+    /* the chain, oldest first, relative to this snapshot so that it
+       still holds once the snapshots are moved together */
+    for (i = 0 ; NULL != incr_chain[i] ; ++i) {
+        path = incr_relative_path(snapshot->snapshot_directory, incr_chain[i]);
+        fprintf(snapshot->metadata, "%s%s/%s\n", CRS_METADATA_INCR, path, INCR_FILENAME);
+        free(path);
+    }
+    opal_output_verbose(10, opal_crs_base_framework.framework_output,
+                        "crs:base: incr: %s checkpoint of %d regions, chain of %d",
+                        full ? "full" : "incremental", incr_num_regions,
+                        opal_argv_count(incr_chain));
+    return OPAL_SUCCESS;
+}
+
+int opal_crs_base_incr_restore(const char *metadata_filename)
+{
+    char **files = NULL, *dir, *slash, *path;
+    FILE *metadata;
+    int i;
+
+    if (NULL == (metadata = fopen(metadata_filename, "r"))) {
+        return OPAL_ERR_FILE_OPEN_FAILURE;
+    }
+    opal_crs_base_metadata_read_token(metadata, CRS_METADATA_INCR, &files);
+    fclose(metadata);
+
+    dir = strdup(metadata_filename);
+    if (NULL != (slash = strrchr(dir, '/'))) {
+        *slash = '\0';
+    } else {
+        free(dir);
+        dir = strdup(".");
+    }
+    opal_argv_free(incr_restore_files);
+    incr_restore_files = NULL;
+    for (i = 0 ; NULL != files && NULL != files[i] ; ++i) {
+        asprintf(&path, "%s/%s", dir, files[i]);
+        opal_argv_append_nosize(&incr_restore_files, path);
+        free(path);
+    }
+    opal_argv_free(files);
+    free(dir);
+
+    /* the regions already there, the others as they come; the chain
+       starts over with the next checkpoint */
+    for (i = 0 ; i < incr_num_regions ; ++i) {
+        int rc = incr_restore_region(i);
+
+        if (OPAL_SUCCESS != rc) {
+            return rc;
+        }
+    }
+    opal_argv_free(incr_chain);
+    incr_chain = NULL;
+    return OPAL_SUCCESS;
+}
+
+void opal_crs_base_incr_finalize(void)
+{
+    free(incr_regions);
+    incr_regions = NULL;
+    incr_num_regions = 0;
+    opal_argv_free(incr_chain);
+    opal_argv_free(incr_restore_files);
+    incr_chain = incr_restore_files = NULL;
+}
@@ -77,6 +77,27 @@ static int opal_crs_base_register (mca_base_register_flag_t flags)
                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE |
                                            MCA_BASE_VAR_FLAG_INTERNAL, OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_ALL_EQ, &opal_crs_base_do_not_select);
+    if (0 > ret) {
+        return ret;
+    }
+
+    opal_crs_base_incr_enabled = false;
+    ret = mca_base_framework_var_register (&opal_crs_base_framework, "incr",
+                                           "Checkpoint the memory regions registered by the application "
+                                           "incrementally: only the pages modified since the previous "
+                                           "checkpoint are written, when the kernel tracks them (crs self)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_ALL_EQ, &opal_crs_base_incr_enabled);
+    if (0 > ret) {
+        return ret;
+    }
+
+    opal_crs_base_incr_max_chain = 8;
+    ret = mca_base_framework_var_register (&opal_crs_base_framework, "incr_max_chain",
+                                           "Number of checkpoints (the full one included) after which an "
+                                           "incremental checkpoint is a full one again",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_ALL_EQ, &opal_crs_base_incr_max_chain);
 
     return (0 > ret) ? ret : OPAL_SUCCESS;
 }
@@ -56,6 +56,9 @@ BEGIN_C_DECLS
         opal_crs_self_checkpoint_callback_fn_t ucb_checkpoint_fn;
         opal_crs_self_continue_callback_fn_t   ucb_continue_fn;
         opal_crs_self_restart_callback_fn_t    ucb_restart_fn;
+
+        /** Metadata of the snapshot restarted from, for the incremental regions */
+        char *restart_metadata;
     };
     typedef struct opal_crs_self_component_t opal_crs_self_component_t;
     OPAL_MODULE_DECLSPEC extern opal_crs_self_component_t mca_crs_self_component;
@@ -243,6 +243,14 @@ int opal_crs_self_module_init(void)
      * If the user requested that we do_restart, then call their callback
      */
     if(mca_crs_self_component.do_restart) {
+        /* the regions get their content back as they are registered again */
+        if( NULL != mca_crs_self_component.restart_metadata &&
+            OPAL_SUCCESS != opal_crs_base_incr_restore(mca_crs_self_component.restart_metadata) ) {
+            opal_output(mca_crs_self_component.super.output_handle,
+                        "crs:self: module_init: Unable to read the regions of %s",
+                        mca_crs_self_component.restart_metadata);
+        }
+
         opal_output_verbose(10, mca_crs_self_component.super.output_handle,
                             "crs:self: module_init: Call their restart function");
         if( NULL != mca_crs_self_component.ucb_restart_fn) 
@@ -257,6 +265,8 @@ int opal_crs_self_module_finalize(void)
     opal_output_verbose(10, mca_crs_self_component.super.output_handle,
                         "crs:self: module_finalize()");
 
+    opal_crs_base_incr_finalize();
+
     return OPAL_SUCCESS;
 }
 
@@ -339,6 +349,19 @@ int opal_crs_self_checkpoint(pid_t pid,
                             "crs:self: checkpoint: Restart Command (%s)", snapshot->cmd_line);
     }
 
+    /*
+     * The registered regions, whole or only their dirty pages
+     */
+    if( opal_crs_base_incr_enabled &&
+        OPAL_SUCCESS != (ret = opal_crs_base_incr_checkpoint(&snapshot->super)) ) {
+        *state = OPAL_CRS_ERROR;
+        opal_output(mca_crs_self_component.super.output_handle,
+                    "crs:self: checkpoint(): Error: Unable to write the registered regions to %s.",
+                    snapshot->super.snapshot_directory);
+        exit_status = ret;
+        goto cleanup;
+    }
+
     /*
      * The best we can do is update the metadata file with the
      * application argv and argc we started with.
@@ -654,6 +677,15 @@ static int opal_crs_self_restart_cmd(opal_crs_self_snapshot_t *snapshot, char **
     free(tmp_env_var);
     tmp_env_var = NULL;
 
+    if( NULL != snapshot->super.metadata_filename ) {
+        (void) mca_base_var_env_name("crs_self_restart_metadata", &tmp_env_var);
+        opal_setenv(tmp_env_var,
+                    snapshot->super.metadata_filename,
+                    true, &environ);
+        free(tmp_env_var);
+        tmp_env_var = NULL;
+    }
+
     /* Instead of adding it to the command line, we should use the environment
      * to pass the values. This allow sthe OPAL application to be braindead 
      * WRT MCA parameters
@@ -265,3 +265,22 @@ int opal_db_base_add_log(const char *table,
     }
     return OPAL_SUCCESS;
 }
+
+int opal_db_base_commit(const opal_identifier_t *proc)
+{
+    opal_db_active_module_t *mod;
+    int rc;
+
+    /* every module holding back data gets to push it */
+    OPAL_LIST_FOREACH(mod, &opal_db_base.store_order, opal_db_active_module_t) {
+        if (NULL == mod->module->commit) {
+            continue;
+        }
+        if (OPAL_SUCCESS != (rc = mod->module->commit(proc)) &&
+            OPAL_ERR_TAKE_NEXT_OPTION != rc) {
+            OPAL_ERROR_LOG(rc);
+            return rc;
+        }
+    }
+    return OPAL_SUCCESS;
+}
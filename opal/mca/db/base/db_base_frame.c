@@ -37,7 +37,8 @@ opal_db_base_module_t opal_db = {
     opal_db_base_fetch_pointer,
     opal_db_base_fetch_multiple,
     opal_db_base_remove_data,
-    opal_db_base_add_log
+    opal_db_base_add_log,
+    opal_db_base_commit
 };
 opal_db_base_t opal_db_base;
 
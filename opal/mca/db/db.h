@@ -130,6 +130,16 @@ typedef int (*opal_db_base_module_remove_fn_t)(const opal_identifier_t *proc, co
  */
 typedef int (*opal_db_base_module_add_log_fn_t)(const char *table, const opal_value_t *kvs, int nkvs);
 
+/*
+ * Commit data
+ *
+ * Push any data stored for the given proc that the module has been
+ * holding back so it can be published in bulk. Must be called before
+ * the data is expected to be visible to other procs, e.g., ahead of
+ * the modex fence.
+ */
+typedef int (*opal_db_base_module_commit_fn_t)(const opal_identifier_t *proc);
+
 /*
  * the standard module data structure
  */
@@ -143,6 +153,7 @@ struct opal_db_base_module_1_0_0_t {
     opal_db_base_module_fetch_multiple_fn_t            fetch_multiple;
     opal_db_base_module_remove_fn_t                    remove;
     opal_db_base_module_add_log_fn_t                   add_log;
+    opal_db_base_module_commit_fn_t                    commit;
 };
 typedef struct opal_db_base_module_1_0_0_t opal_db_base_module_1_0_0_t;
 typedef struct opal_db_base_module_1_0_0_t opal_db_base_module_t;
@@ -23,6 +23,13 @@ BEGIN_C_DECLS
 
 typedef uint64_t opal_identifier_t;
 
+/* key of the descriptor of a segment shared by the procs on a node.
+ * Fetching it seals the data stored with OPAL_DB_LOCAL locality into
+ * a new segment, storing it attaches that segment and removing it
+ * releases the segment - see db/sm
+ */
+#define OPAL_DB_SM_SEGMENT "opal.db.sm.segment"
+
 END_C_DECLS
 
 #endif
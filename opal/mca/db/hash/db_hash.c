@@ -58,6 +58,7 @@ opal_db_base_module_t opal_db_hash_module = {
     fetch_pointer,
     fetch_multiple,
     remove_data,
+    NULL,
     NULL
 };
 
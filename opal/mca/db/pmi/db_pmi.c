@@ -20,8 +20,9 @@
 #endif
 
 #include "opal_stdint.h"
+#include "opal/class/opal_hash_table.h"
 #include "opal/class/opal_pointer_array.h"
-#include "opal/dss/dss_types.h"
+#include "opal/dss/dss.h"
 #include "opal/util/argv.h"
 #include "opal/util/error.h"
 #include "opal/util/output.h"
@@ -51,6 +52,7 @@ static int fetch_multiple(const opal_identifier_t *proc,
                           const char *key,
                           opal_list_t *kvs);
 static int remove_data(const opal_identifier_t *proc, const char *key);
+static int commit(const opal_identifier_t *proc);
 
 opal_db_base_module_t opal_db_pmi_module = {
     init,
@@ -61,10 +63,11 @@ opal_db_base_module_t opal_db_pmi_module = {
     fetch_pointer,
     fetch_multiple,
     remove_data,
-    NULL
+    NULL,
+    commit
 };
 
-static int pmi_encode(char *outdata, const void *val, size_t vallen);
+static char* pmi_encode(const void *val, size_t vallen);
 static uint8_t* pmi_decode(char *data, size_t *retlen);
 static int setup_pmi(void);
 static char* setup_key(opal_identifier_t name, const char *key);
@@ -74,6 +77,48 @@ static char *pmi_kvs_name = NULL;
 static int pmi_vallen_max = -1;
 static int pmi_keylen_max = -1;
 
+/* Rather than one PMI key per stored value, everything a proc stores
+ * is packed into a single buffer and published as one blob (split
+ * only as far as the PMI value limit requires) when the data is
+ * committed. Each commit publishes the next generation of the blob,
+ * so data stored after the modex is still reachable.
+ */
+static opal_buffer_t pmi_pending;
+static opal_identifier_t pmi_pending_id;
+static int pmi_pending_gen = 0;
+
+/* Peer data already pulled from PMI, so each peer's blob is
+ * fetched and decoded only once no matter how many keys are
+ * looked up for it
+ */
+typedef struct {
+    opal_list_item_t super;
+    /* opal_value_t's pulled from PMI or stored locally */
+    opal_list_t data;
+    /* number of blob generations already pulled */
+    int ngens;
+} pmi_proc_data_t;
+
+static void pmi_proc_data_construct(pmi_proc_data_t *ptr)
+{
+    OBJ_CONSTRUCT(&ptr->data, opal_list_t);
+    ptr->ngens = 0;
+}
+
+static void pmi_proc_data_destruct(pmi_proc_data_t *ptr)
+{
+    opal_list_item_t *item;
+
+    while (NULL != (item = opal_list_remove_first(&ptr->data))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&ptr->data);
+}
+static OBJ_CLASS_INSTANCE(pmi_proc_data_t, opal_list_item_t,
+                          pmi_proc_data_construct, pmi_proc_data_destruct);
+
+static opal_hash_table_t pmi_cache;
+
 /* Because Cray uses PMI2 extensions for some, but not all,
  * PMI functions, we define a set of wrappers for those
  * common functions we will use
@@ -110,209 +155,272 @@ static int init(void)
 
     if (OPAL_SUCCESS != (rc = setup_pmi())) {
         OPAL_ERROR_LOG(rc);
+        return rc;
     }
 
-    return rc;
+    OBJ_CONSTRUCT(&pmi_pending, opal_buffer_t);
+    OBJ_CONSTRUCT(&pmi_cache, opal_hash_table_t);
+    opal_hash_table_init(&pmi_cache, 256);
+
+    return OPAL_SUCCESS;
 }
 
 static void finalize(void)
 {
+    pmi_proc_data_t *proc_data;
+    uint64_t key;
+    void *node;
+
     if (NULL != pmi_kvs_name) {
         free(pmi_kvs_name);
         pmi_kvs_name = NULL;
     }
 
+    OBJ_DESTRUCT(&pmi_pending);
+
+    if (OPAL_SUCCESS == opal_hash_table_get_first_key_uint64(&pmi_cache, &key,
+                                                             (void**)&proc_data, &node)) {
+        do {
+            OBJ_RELEASE(proc_data);
+        } while (OPAL_SUCCESS == opal_hash_table_get_next_key_uint64(&pmi_cache, &key,
+                                                                     (void**)&proc_data,
+                                                                     node, &node));
+    }
+    OBJ_DESTRUCT(&pmi_cache);
 }
 
-static int store(const opal_identifier_t *uid,
-                 opal_db_locality_t locality,
-                 const char *key, const void *data, opal_data_type_t type)
+static pmi_proc_data_t* lookup_proc(opal_identifier_t id)
 {
-    int i, rc;
-    char *pmidata, *str, *localdata;
-    int64_t i64;
-    uint64_t ui64;
-    opal_byte_object_t *bo;
-    char *pmikey, *tmpkey, *tmp, sav;
-    char **strdata=NULL;
-    opal_identifier_t proc;
+    pmi_proc_data_t *proc_data = NULL;
 
-    /* to protect alignment, copy the data across */
-    memcpy(&proc, uid, sizeof(opal_identifier_t));
+    opal_hash_table_get_value_uint64(&pmi_cache, id, (void**)&proc_data);
+    if (NULL == proc_data) {
+        proc_data = OBJ_NEW(pmi_proc_data_t);
+        opal_hash_table_set_value_uint64(&pmi_cache, id, proc_data);
+    }
+    return proc_data;
+}
 
-    /* pass internal stores down to someone else */
-    if (OPAL_DB_INTERNAL == locality) {
-        return OPAL_ERR_TAKE_NEXT_OPTION;
+static opal_value_t* lookup_keyval(pmi_proc_data_t *proc_data, const char *key)
+{
+    opal_value_t *kv;
+
+    OPAL_LIST_FOREACH(kv, &proc_data->data, opal_value_t) {
+        if (0 == strcmp(key, kv->key)) {
+            return kv;
+        }
     }
+    return NULL;
+}
 
-    OPAL_OUTPUT_VERBOSE((5, opal_db_base_framework.framework_output,
-                         "db:pmi:store: storing key %s[%s] for proc %" PRIu64 "",
-                         key, opal_dss.lookup_data_type(type), proc));
+/* add the value to the cache, replacing any older value for the key */
+static void cache_keyval(pmi_proc_data_t *proc_data, opal_value_t *kv)
+{
+    opal_value_t *old;
 
-    if (NULL == (pmikey = setup_key(proc, key))) {
-	OPAL_ERROR_LOG(OPAL_ERR_BAD_PARAM);
-	return OPAL_ERR_BAD_PARAM;
+    if (NULL != (old = lookup_keyval(proc_data, kv->key))) {
+        opal_list_remove_item(&proc_data->data, &old->super);
+        OBJ_RELEASE(old);
     }
+    opal_list_append(&proc_data->data, &kv->super);
+}
+
+/* put a string of arbitrary length, breaking it into as many
+ * sections as the PMI value limit requires
+ */
+static int put_string(const char *pmikey, const char *data)
+{
+    int i, rc;
+    char *pmidata, *str, *localdata;
+    char *tmpkey, *tmp, sav;
+    char **strdata=NULL;
 
-    switch (type) {
-    case OPAL_STRING:
 #if WANT_PMI2_SUPPORT
-        {
-            /* the blasted Cray PMI implementation marked a number of common
-             * ASCII characters as "illegal", so if we are on one of those
-             * machines, then we have to replace those characters with something
-             * else
-             */
-            size_t n, k;
-            bool subbed;
-            char *ptr;
+    {
+        /* the blasted Cray PMI implementation marked a number of common
+         * ASCII characters as "illegal", so if we are on one of those
+         * machines, then we have to replace those characters with something
+         * else
+         */
+        size_t n, k;
+        bool subbed;
+        char *ptr;
 
-            str = (char*)data;
-            /* first, count how many characters need to be replaced - since Cray
-             * is the source of the trouble, we only make this slow for them!
-             */
-            ptr = str;
-            i=0;
-            for (n=0; n < strlen(illegal); n++) {
-                while (NULL != (tmp = strchr(ptr, illegal[n]))) {
-                    i++;
-                    ptr = tmp;
-                    ptr++;
-                }
+        str = (char*)data;
+        /* first, count how many characters need to be replaced - since Cray
+         * is the source of the trouble, we only make this slow for them!
+         */
+        ptr = str;
+        i=0;
+        for (n=0; n < strlen(illegal); n++) {
+            while (NULL != (tmp = strchr(ptr, illegal[n]))) {
+                i++;
+                ptr = tmp;
+                ptr++;
             }
-            /* stretch the string */
-            ptr = (char*)malloc(sizeof(char) * (1 + strlen(str) + 2*i));
-            /* now construct it */
-            k=0;
-            for (n=0; n < strlen(str); n++) {
-                subbed = false;
-                for (i=0; i < (int)strlen(illegal); i++) {
-                    if (str[n] == illegal[i]) {
-                        /* escape the character */
-                        ptr[k++] = escape_char;
-                        ptr[k++] = sub[i];
-                        subbed = true;
-                        break;
-                    }
-                }
-                if (!subbed) {
-                    ptr[k++] = str[n];
+        }
+        /* stretch the string */
+        ptr = (char*)malloc(sizeof(char) * (1 + strlen(str) + 2*i));
+        /* now construct it */
+        k=0;
+        for (n=0; n < strlen(str); n++) {
+            subbed = false;
+            for (i=0; i < (int)strlen(illegal); i++) {
+                if (str[n] == illegal[i]) {
+                    /* escape the character */
+                    ptr[k++] = escape_char;
+                    ptr[k++] = sub[i];
+                    subbed = true;
+                    break;
                 }
             }
-            /* pass the result */
-            localdata = ptr;
+            if (!subbed) {
+                ptr[k++] = str[n];
+            }
         }
+        ptr[k] = '\0';
+        /* pass the result */
+        localdata = ptr;
+    }
 #else
-        localdata = strdup((char*)data);
+    localdata = strdup(data);
 #endif
-        str = localdata;
-        while (pmi_vallen_max < (int)(OPAL_PMI_PAD + strlen(str))) {
-            /* the string is too long, so we need to break it into
-             * multiple sections
-             */
-            tmp = str + pmi_vallen_max - OPAL_PMI_PAD;
-            sav = *tmp;
-            *tmp = '\0';
-            opal_argv_append_nosize(&strdata, str);
-            *tmp = sav;
-            str = tmp;
-        }
-        /* put whatever remains on the stack */
-        opal_argv_append_nosize(&strdata, str);
-        /* cleanup */
-        free(localdata);
-        /* the first value we put uses the original key, but
-         * the data is prepended with the number of sections
-         * required to hold the entire string
+    str = localdata;
+    while (pmi_vallen_max < (int)(OPAL_PMI_PAD + strlen(str))) {
+        /* the string is too long, so we need to break it into
+         * multiple sections
          */
-        asprintf(&pmidata, "%d:%s", opal_argv_count(strdata), strdata[0]);
+        tmp = str + pmi_vallen_max - OPAL_PMI_PAD;
+        sav = *tmp;
+        *tmp = '\0';
+        opal_argv_append_nosize(&strdata, str);
+        *tmp = sav;
+        str = tmp;
+    }
+    /* put whatever remains on the stack */
+    opal_argv_append_nosize(&strdata, str);
+    /* cleanup */
+    free(localdata);
+    /* the first value we put uses the original key, but
+     * the data is prepended with the number of sections
+     * required to hold the entire string
+     */
+    asprintf(&pmidata, "%d:%s", opal_argv_count(strdata), strdata[0]);
+    OPAL_OUTPUT_VERBOSE((5, opal_db_base_framework.framework_output,
+                         "db:pmi:put_string: storing key %s data %s",
+                         pmikey, pmidata));
+
+    if (PMI_SUCCESS != (rc = kvs_put(pmikey, pmidata))) {
+        OPAL_PMI_ERROR(rc, "PMI_KVS_Put");
+        free(pmidata);
+        opal_argv_free(strdata);
+        return OPAL_ERROR;
+    }
+    free(pmidata);
+    /* for each remaining segment, augment the key with the index */
+    for (i=1; NULL != strdata[i]; i++) {
+        asprintf(&tmpkey, "%s:%d", pmikey, i);
         OPAL_OUTPUT_VERBOSE((5, opal_db_base_framework.framework_output,
-                             "db:pmi:store: storing key %s data %s",
-                             pmikey, pmidata));
+                             "db:pmi:put_string: storing key %s data %s",
+                             tmpkey, strdata[i]));
 
-        if (PMI_SUCCESS != (rc = kvs_put(pmikey, pmidata))) {
+        if (PMI_SUCCESS != (rc = kvs_put(tmpkey, strdata[i]))) {
             OPAL_PMI_ERROR(rc, "PMI_KVS_Put");
-            free(pmidata);
-            free(pmikey);
+            free(tmpkey);
             opal_argv_free(strdata);
             return OPAL_ERROR;
         }
-        free(pmidata);
-        /* for each remaining segment, augment the key with the index */
-        for (i=1; NULL != strdata[i]; i++) {
-            asprintf(&tmpkey, "%s:%d", pmikey, i);
-            OPAL_OUTPUT_VERBOSE((5, opal_db_base_framework.framework_output,
-                                 "db:pmi:store: storing key %s data %s",
-                                 pmikey, strdata[i]));
-
-            if (PMI_SUCCESS != (rc = kvs_put(tmpkey, strdata[i]))) {
-                OPAL_PMI_ERROR(rc, "PMI_KVS_Put");
-                free(pmikey);
-                opal_argv_free(strdata);
-                return OPAL_ERROR;
-            }
-            free(tmpkey);
-        }
-        free(pmikey);
-        opal_argv_free(strdata);
-        return OPAL_SUCCESS;
+        free(tmpkey);
+    }
+    opal_argv_free(strdata);
+    return OPAL_SUCCESS;
+}
+
+static int store(const opal_identifier_t *uid,
+                 opal_db_locality_t locality,
+                 const char *key, const void *data, opal_data_type_t type)
+{
+    opal_value_t *kv;
+    opal_byte_object_t *bo;
+    opal_identifier_t proc;
+    int rc;
 
+    /* to protect alignment, copy the data across */
+    memcpy(&proc, uid, sizeof(opal_identifier_t));
+
+    /* pass internal stores down to someone else */
+    if (OPAL_DB_INTERNAL == locality) {
+        return OPAL_ERR_TAKE_NEXT_OPTION;
+    }
+
+    OPAL_OUTPUT_VERBOSE((5, opal_db_base_framework.framework_output,
+                         "db:pmi:store: storing key %s[%s] for proc %" PRIu64 "",
+                         key, opal_dss.lookup_data_type(type), proc));
+
+    kv = OBJ_NEW(opal_value_t);
+    kv->key = strdup(key);
+    kv->type = type;
+
+    switch (type) {
+    case OPAL_STRING:
+        kv->data.string = (NULL == data) ? NULL : strdup((char*)data);
+        break;
     case OPAL_INT:
-        i64 = (int64_t)(*((int*)data));
-        asprintf(&pmidata, "%ld", (long)i64);
+        kv->data.integer = *((int*)data);
         break;
-        
     case OPAL_INT32:
-        i64 = (int64_t)(*((int32_t*)data));
-        asprintf(&pmidata, "%ld", (long)i64);
+        kv->data.int32 = *((int32_t*)data);
         break;
-        
     case OPAL_INT64:
-        i64 = (int64_t)(*((int*)data));
-        asprintf(&pmidata, "%ld", (long)i64);
+        kv->data.int64 = *((int64_t*)data);
+        break;
+    case OPAL_UINT:
+        kv->data.uint = *((unsigned int*)data);
         break;
-        
     case OPAL_UINT64:
-        ui64 = *((uint64_t*)data);
-        asprintf(&pmidata, "%lu", (unsigned long)ui64);
+        kv->data.uint64 = *((uint64_t*)data);
         break;
-    
     case OPAL_UINT32:
-        ui64 = (uint64_t)(*((uint32_t*)data));
-        asprintf(&pmidata, "%lu", (unsigned long)ui64);
+        kv->data.uint32 = *((uint32_t*)data);
         break;
-       
     case OPAL_UINT16:
-        ui64 = (uint64_t)(*((uint16_t*)data));
-        asprintf(&pmidata, "%lu", (unsigned long)ui64);
+        kv->data.uint16 = *((uint16_t*)data);
         break;
-    
     case OPAL_BYTE_OBJECT:
         bo = (opal_byte_object_t*)data;
-        pmidata = (char*)malloc(pmi_vallen_max*sizeof(char));
-        if (OPAL_SUCCESS != (rc = pmi_encode(pmidata, bo->bytes, bo->size))) {
-            OPAL_ERROR_LOG(rc);
-            free(pmidata);
-            return rc;
+        if (NULL != bo && NULL != bo->bytes && 0 < bo->size) {
+            kv->data.bo.bytes = (uint8_t*)malloc(bo->size);
+            memcpy(kv->data.bo.bytes, bo->bytes, bo->size);
+            kv->data.bo.size = bo->size;
+        } else {
+            kv->data.bo.bytes = NULL;
+            kv->data.bo.size = 0;
         }
         break;
-
     default:
+        OBJ_RELEASE(kv);
         OPAL_ERROR_LOG(OPAL_ERR_NOT_SUPPORTED);
         return OPAL_ERR_NOT_SUPPORTED;
     }
 
-    OPAL_OUTPUT_VERBOSE((10, opal_db_base_framework.framework_output,
-                         "PUTTING KEY %s DATA %s",
-                         pmikey, pmidata));
-
-    rc = kvs_put(pmikey, pmidata);
-    if (PMI_SUCCESS != rc) {
-	OPAL_PMI_ERROR(rc, "PMI_KVS_Put");
-	return OPAL_ERROR;
+    /* only one proc's data can be pending at a time - it is only
+     * ever our own, but play it safe
+     */
+    if (0 < pmi_pending.bytes_used && proc != pmi_pending_id &&
+        OPAL_SUCCESS != (rc = commit(&pmi_pending_id))) {
+        OBJ_RELEASE(kv);
+        return rc;
     }
-    free(pmidata);
-    free(pmikey);
+    pmi_pending_id = proc;
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(&pmi_pending, &kv, 1, OPAL_VALUE))) {
+        OPAL_ERROR_LOG(rc);
+        OBJ_RELEASE(kv);
+        return rc;
+    }
+
+    /* keep a copy so we never have to ask PMI for our own data */
+    cache_keyval(lookup_proc(proc), kv);
+
     return OPAL_SUCCESS;
 }
 
@@ -334,6 +442,55 @@ static int store_pointer(const opal_identifier_t *proc,
     return rc;
 }
 
+static int commit(const opal_identifier_t *uid)
+{
+    opal_identifier_t proc;
+    char *pmikey, *tmp, *encoded;
+    uint8_t *bytes;
+    int32_t nbytes;
+    int rc;
+
+    /* to protect alignment, copy the data across */
+    memcpy(&proc, uid, sizeof(opal_identifier_t));
+
+    if (0 == pmi_pending.bytes_used || proc != pmi_pending_id) {
+        /* nothing held back for this proc */
+        return OPAL_SUCCESS;
+    }
+
+    asprintf(&tmp, "modex.%d", pmi_pending_gen);
+    pmikey = setup_key(proc, tmp);
+    free(tmp);
+    if (NULL == pmikey) {
+        OPAL_ERROR_LOG(OPAL_ERR_BAD_PARAM);
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unload(&pmi_pending, (void**)&bytes, &nbytes))) {
+        OPAL_ERROR_LOG(rc);
+        free(pmikey);
+        return rc;
+    }
+    encoded = pmi_encode(bytes, nbytes);
+    free(bytes);
+    if (NULL == encoded) {
+        free(pmikey);
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    OPAL_OUTPUT_VERBOSE((5, opal_db_base_framework.framework_output,
+                         "db:pmi:commit: publishing %d bytes for proc %" PRIu64 " under %s",
+                         (int)nbytes, proc, pmikey));
+
+    rc = put_string(pmikey, encoded);
+    free(encoded);
+    free(pmikey);
+    if (OPAL_SUCCESS == rc) {
+        pmi_pending_gen++;
+    }
+    return rc;
+}
+
 static char* fetch_string(const char *key)
 {
     char *tmp_val, *ptr, *tmpkey;
@@ -343,9 +500,10 @@ static char* fetch_string(const char *key)
     /* create our sandbox */
     tmp_val = (char*)malloc(pmi_vallen_max * sizeof(char));
 
-    /* the first section of the string has the original key, so fetch it */
+    /* the first section of the string has the original key, so fetch it -
+     * the caller decides whether not finding it is an error
+     */
     if (PMI_SUCCESS != kvs_get(key, tmp_val, pmi_vallen_max)) {
-        OPAL_ERROR_LOG(OPAL_ERR_NOT_FOUND);
         free(tmp_val);
         return NULL;
     }
@@ -357,7 +515,11 @@ static char* fetch_string(const char *key)
     /* the data in this section was prepended with the number of sections
      * required to hold the entire string - get it
      */
-    ptr = strchr(tmp_val, ':');
+    if (NULL == (ptr = strchr(tmp_val, ':'))) {
+        OPAL_ERROR_LOG(OPAL_ERR_BAD_PARAM);
+        free(tmp_val);
+        return NULL;
+    }
     *ptr = '\0';
     nsections = strtol(tmp_val, NULL, 10);
     /* save the actual data */
@@ -430,6 +592,7 @@ static char* fetch_string(const char *key)
                     ptr[k++] = data[n];
                 }
             }
+            ptr[k] = '\0';
             /* pass the result */
             free(data);
             data = ptr;
@@ -439,17 +602,102 @@ static char* fetch_string(const char *key)
     return data;
 }
 
+/* pull the next generation of the proc's blob from PMI and add
+ * its values to the cache
+ */
+static int fetch_blob(opal_identifier_t proc, pmi_proc_data_t *proc_data)
+{
+    opal_buffer_t buf;
+    opal_value_t *kv;
+    char *pmikey, *tmp, *encoded;
+    uint8_t *bytes;
+    size_t nbytes;
+    int32_t cnt;
+    int rc;
+
+    asprintf(&tmp, "modex.%d", proc_data->ngens);
+    pmikey = setup_key(proc, tmp);
+    free(tmp);
+    if (NULL == pmikey) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+    encoded = fetch_string(pmikey);
+    free(pmikey);
+    if (NULL == encoded) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+    bytes = pmi_decode(encoded, &nbytes);
+    free(encoded);
+    if (NULL == bytes) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    OPAL_OUTPUT_VERBOSE((5, opal_db_base_framework.framework_output,
+                         "db:pmi:fetch: pulled %d bytes of generation %d for proc %" PRIu64 "",
+                         (int)nbytes, proc_data->ngens, proc));
+
+    /* the buffer takes ownership of the bytes */
+    OBJ_CONSTRUCT(&buf, opal_buffer_t);
+    opal_dss.load(&buf, bytes, (int32_t)nbytes);
+    cnt = 1;
+    while (OPAL_SUCCESS == (rc = opal_dss.unpack(&buf, &kv, &cnt, OPAL_VALUE))) {
+        cache_keyval(proc_data, kv);
+        cnt = 1;
+    }
+    OBJ_DESTRUCT(&buf);
+    if (OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER != rc) {
+        OPAL_ERROR_LOG(rc);
+        return rc;
+    }
+
+    proc_data->ngens++;
+    return OPAL_SUCCESS;
+}
+
+/* the value may have been stored as any of the integer types, so
+ * convert rather than insist on an exact match
+ */
+static bool kv_to_int64(opal_value_t *kv, int64_t *val)
+{
+    switch (kv->type) {
+    case OPAL_INT:
+        *val = kv->data.integer;
+        break;
+    case OPAL_INT32:
+        *val = kv->data.int32;
+        break;
+    case OPAL_INT64:
+        *val = kv->data.int64;
+        break;
+    case OPAL_UINT:
+        *val = kv->data.uint;
+        break;
+    case OPAL_UINT64:
+        *val = (int64_t)kv->data.uint64;
+        break;
+    case OPAL_UINT32:
+        *val = kv->data.uint32;
+        break;
+    case OPAL_UINT16:
+        *val = kv->data.uint16;
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
 static int fetch(const opal_identifier_t *uid,
                  const char *key, void **data, opal_data_type_t type)
 {
+    pmi_proc_data_t *proc_data;
+    opal_value_t *kv;
     opal_byte_object_t *boptr;
     uint16_t ui16;
     uint32_t ui32;
     int ival;
     unsigned int uival;
-    char *pmikey;
-    char tmp_val[1024];
-    size_t sval;
+    int64_t i64;
     opal_identifier_t proc;
 
     /* to protect alignment, copy the data across */
@@ -466,57 +714,68 @@ static int fetch(const opal_identifier_t *uid,
         return OPAL_ERR_BAD_PARAM;
     }
 
-    /* setup the key */
-    if (NULL == (pmikey = setup_key(proc, key))) {
-	OPAL_ERROR_LOG(OPAL_ERR_BAD_PARAM);
-	return OPAL_ERR_BAD_PARAM;
-    }
-
-    /* check to see if they are looking for a string */
-    if (OPAL_STRING == type) {
-        /* might have been passed in multiple sections */
-        *data = fetch_string(pmikey);
-        free(pmikey);
-        return OPAL_SUCCESS;
+    /* check the cache first, only going to PMI for blobs we
+     * have not yet pulled
+     */
+    proc_data = lookup_proc(proc);
+    while (NULL == (kv = lookup_keyval(proc_data, key))) {
+        if (OPAL_SUCCESS != fetch_blob(proc, proc_data)) {
+            OPAL_ERROR_LOG(OPAL_ERR_NOT_FOUND);
+            return OPAL_ERR_NOT_FOUND;
+        }
     }
 
-    /* otherwise, retrieve the pmi keyval */
-    if (NULL == (pmikey = setup_key(proc, key))) {
-	OPAL_ERROR_LOG(OPAL_ERR_BAD_PARAM);
-	return OPAL_ERR_BAD_PARAM;
-    }
-    if (PMI_SUCCESS != kvs_get(pmikey, tmp_val, pmi_vallen_max)) {
-        OPAL_ERROR_LOG(OPAL_ERR_NOT_FOUND);
-        free(pmikey);
-        return OPAL_ERR_NOT_FOUND;
-    }
-    free(pmikey);
-
     /* return the value according to the provided type */
     switch (type) {
+    case OPAL_STRING:
+        if (OPAL_STRING != kv->type) {
+            return OPAL_ERR_TYPE_MISMATCH;
+        }
+        *data = (NULL == kv->data.string) ? NULL : strdup(kv->data.string);
+        break;
+    case OPAL_BYTE_OBJECT:
+        if (OPAL_BYTE_OBJECT != kv->type) {
+            return OPAL_ERR_TYPE_MISMATCH;
+        }
+        boptr = (opal_byte_object_t*)malloc(sizeof(opal_byte_object_t));
+        if (NULL != kv->data.bo.bytes && 0 < kv->data.bo.size) {
+            boptr->bytes = (uint8_t*)malloc(kv->data.bo.size);
+            memcpy(boptr->bytes, kv->data.bo.bytes, kv->data.bo.size);
+            boptr->size = kv->data.bo.size;
+        } else {
+            boptr->bytes = NULL;
+            boptr->size = 0;
+        }
+        *data = boptr;
+        break;
     case OPAL_UINT32:
-        ui32 = (uint32_t)strtoul(tmp_val, NULL, 10);
+        if (!kv_to_int64(kv, &i64)) {
+            return OPAL_ERR_TYPE_MISMATCH;
+        }
+        ui32 = (uint32_t)i64;
         memcpy(*data, &ui32, sizeof(uint32_t));
         break;
     case OPAL_UINT16:
-        ui16 = (uint16_t)strtoul(tmp_val, NULL, 10);
+        if (!kv_to_int64(kv, &i64)) {
+            return OPAL_ERR_TYPE_MISMATCH;
+        }
+        ui16 = (uint16_t)i64;
         memcpy(*data, &ui16, sizeof(uint16_t));
         break;
     case OPAL_INT:
-        ival = (int)strtol(tmp_val, NULL, 10);
+        if (!kv_to_int64(kv, &i64)) {
+            return OPAL_ERR_TYPE_MISMATCH;
+        }
+        ival = (int)i64;
         memcpy(*data, &ival, sizeof(int));
         break;
     case OPAL_UINT:
-        uival = (unsigned int)strtoul(tmp_val, NULL, 10);
+        if (!kv_to_int64(kv, &i64)) {
+            return OPAL_ERR_TYPE_MISMATCH;
+        }
+        uival = (unsigned int)i64;
         memcpy(*data, &uival, sizeof(unsigned int));
         break;
-    case OPAL_BYTE_OBJECT:
-        sval = 0;
-        boptr = (opal_byte_object_t*)malloc(sizeof(opal_byte_object_t));
-        boptr->bytes = (uint8_t*)pmi_decode(tmp_val, &sval);
-        boptr->size = sval;
-        *data = boptr;
-        break;
     default:
         OPAL_ERROR_LOG(OPAL_ERR_NOT_SUPPORTED);
         return OPAL_ERR_NOT_SUPPORTED;
@@ -680,22 +939,29 @@ static inline int pmi_base64_decode_block (unsigned char in[4], unsigned char ou
 /* PMI only supports strings. For now, do a simple base16 
  * encoding. Should do something smarter, both with the 
  * algorith used and its implementation. */
-static int pmi_encode(char *outdata, const void *val, size_t vallen) {
-    unsigned char *tmp = (unsigned char*)outdata;
+static char* pmi_encode(const void *val, size_t vallen) {
+    unsigned char *outdata, *tmp, last[3];
     size_t i;
 
-    /* check for size */
-    if ((size_t)pmi_vallen_max < (2 + vallen * 4) / 3 + 1) {
-        return OPAL_ERR_BAD_PARAM;
+    outdata = (unsigned char*)malloc(4 * ((vallen + 2) / 3) + 1);
+    if (NULL == outdata) {
+        return NULL;
     }
 
-    for (i = 0 ; i < vallen ; i += 3, tmp += 4) {
-        pmi_base64_encode_block((unsigned char *) val + i, tmp, vallen - i);
+    for (i = 0, tmp = outdata ; i < vallen ; i += 3, tmp += 4) {
+        if (vallen - i < 3) {
+            /* don't read past the end of the caller's data */
+            memset(last, 0, sizeof(last));
+            memcpy(last, (unsigned char *) val + i, vallen - i);
+            pmi_base64_encode_block(last, tmp, vallen - i);
+        } else {
+            pmi_base64_encode_block((unsigned char *) val + i, tmp, vallen - i);
+        }
     }
 
     tmp[0] = (unsigned char)'\0';
 
-    return OPAL_SUCCESS;
+    return (char*)outdata;
 }
 
 static uint8_t* pmi_decode (char *data, size_t *retlen) {
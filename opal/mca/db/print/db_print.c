@@ -46,7 +46,8 @@ opal_db_base_module_t opal_db_print_module = {
     NULL,
     NULL,
     NULL,
-    add_log
+    add_log,
+    NULL
 };
 
 static opal_pointer_array_t tables;
@@ -0,0 +1,723 @@
+/*
+ * Copyright (c) 2013      Los Alamos National Security, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ */
+
+#include "opal_config.h"
+#include "opal/constants.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#include "opal_stdint.h"
+#include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_list.h"
+#include "opal/dss/dss_types.h"
+#include "opal/mca/shmem/base/base.h"
+#include "opal/util/error.h"
+#include "opal/util/opal_environ.h"
+#include "opal/util/os_path.h"
+#include "opal/util/output.h"
+
+#include "opal/mca/db/base/base.h"
+#include "db_sm.h"
+
+static int init(void);
+static void finalize(void);
+static int store(const opal_identifier_t *proc,
+                 opal_db_locality_t locality,
+                 const char *key, const void *object,
+                 opal_data_type_t type);
+static int store_pointer(const opal_identifier_t *proc,
+                         opal_db_locality_t locality,
+                         opal_value_t *kv);
+static int fetch(const opal_identifier_t *proc,
+                 const char *key, void **data, opal_data_type_t type);
+static int fetch_pointer(const opal_identifier_t *proc,
+                         const char *key,
+                         void **data, opal_data_type_t type);
+static int fetch_multiple(const opal_identifier_t *proc,
+                          const char *key,
+                          opal_list_t *kvs);
+static int remove_data(const opal_identifier_t *proc, const char *key);
+
+opal_db_base_module_t opal_db_sm_module = {
+    init,
+    finalize,
+    store,
+    store_pointer,
+    fetch,
+    fetch_pointer,
+    fetch_multiple,
+    remove_data,
+    NULL,
+    NULL
+};
+
+/*
+ * A segment holds the data stored by one process (typically a daemon)
+ * with OPAL_DB_LOCAL locality, for the other processes on the node to
+ * look up in place instead of each keeping its own copy:
+ *
+ *   header | procs, sorted by identifier | entries of each proc,
+ *   sorted by key | keys and values
+ *
+ * Positions are offsets from the header so the segment can be mapped
+ * anywhere, and everything is 8-byte aligned so the values can be
+ * handed out directly. Scalar values are stored as a copy of the
+ * opal_value_t data union, strings with their terminator.
+ */
+typedef struct {
+    uint64_t size;          /* bytes used, header included */
+    uint32_t nprocs;
+    uint32_t nentries;
+} db_sm_header_t;
+
+typedef struct {
+    opal_identifier_t id;
+    uint32_t first;         /* index of its first entry */
+    uint32_t count;
+} db_sm_proc_t;
+
+typedef struct {
+    uint64_t key;           /* offset of the key */
+    uint64_t data;          /* offset of the value, 0 if NULL */
+    uint64_t size;          /* size of the value */
+    opal_data_type_t type;
+} db_sm_entry_t;
+
+#define DB_SM_ALIGN(x)  (((x) + 7) & ~((uint64_t)7))
+#define DB_SM_PTR(h, off)  ((char*)(h) + (off))
+#define DB_SM_PROCS(h)  ((db_sm_proc_t*)((char*)(h) + DB_SM_ALIGN(sizeof(db_sm_header_t))))
+#define DB_SM_ENTRIES(h)  ((db_sm_entry_t*)(DB_SM_PROCS(h) + (h)->nprocs))
+
+/* a value waiting to be sealed into a segment */
+typedef struct {
+    opal_list_item_t super;
+    opal_identifier_t id;
+    opal_value_t *kv;
+} db_sm_staged_t;
+static void staged_construct(db_sm_staged_t *ptr)
+{
+    ptr->kv = NULL;
+}
+static void staged_destruct(db_sm_staged_t *ptr)
+{
+    if (NULL != ptr->kv) {
+        OBJ_RELEASE(ptr->kv);
+    }
+}
+OBJ_CLASS_INSTANCE(db_sm_staged_t, opal_list_item_t,
+                   staged_construct, staged_destruct);
+
+/* a segment we either created or attached */
+typedef struct {
+    opal_list_item_t super;
+    /* identifier the segment was sealed or attached under */
+    opal_identifier_t owner;
+    /* we created it, so we are the one to unlink it */
+    bool created;
+    opal_shmem_ds_t ds;
+    /* the mapping, NULL if we are not attached */
+    db_sm_header_t *hdr;
+    /* byte objects handed out by fetch_pointer, by entry index */
+    opal_hash_table_t bos;
+} db_sm_segment_t;
+static void segment_construct(db_sm_segment_t *ptr)
+{
+    ptr->created = false;
+    memset(&ptr->ds, 0, sizeof(ptr->ds));
+    ptr->hdr = NULL;
+    OBJ_CONSTRUCT(&ptr->bos, opal_hash_table_t);
+    opal_hash_table_init(&ptr->bos, 16);
+}
+static void segment_destruct(db_sm_segment_t *ptr)
+{
+    uint32_t key;
+    void *bo, *node;
+    int rc;
+
+    rc = opal_hash_table_get_first_key_uint32(&ptr->bos, &key, &bo, &node);
+    while (OPAL_SUCCESS == rc) {
+        free(bo);
+        rc = opal_hash_table_get_next_key_uint32(&ptr->bos, &key, &bo, node, &node);
+    }
+    OBJ_DESTRUCT(&ptr->bos);
+    if (NULL != ptr->hdr) {
+        opal_shmem_segment_detach(&ptr->ds);
+    }
+    if (ptr->created) {
+        opal_shmem_unlink(&ptr->ds);
+    }
+}
+OBJ_CLASS_INSTANCE(db_sm_segment_t, opal_list_item_t,
+                   segment_construct, segment_destruct);
+
+/* Local "globals" */
+static opal_list_t staged;
+static opal_list_t segments;
+static int num_created = 0;
+
+static int init(void)
+{
+    OBJ_CONSTRUCT(&staged, opal_list_t);
+    OBJ_CONSTRUCT(&segments, opal_list_t);
+    return OPAL_SUCCESS;
+}
+
+static void finalize(void)
+{
+    opal_list_item_t *item;
+
+    while (NULL != (item = opal_list_remove_first(&staged))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&staged);
+    while (NULL != (item = opal_list_remove_first(&segments))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&segments);
+}
+
+/* size of the types we store as a copy of the data union */
+static size_t scalar_size(opal_data_type_t type)
+{
+    switch (type) {
+    case OPAL_BYTE:
+    case OPAL_INT8:
+    case OPAL_UINT8:
+        return 1;
+    case OPAL_INT16:
+    case OPAL_UINT16:
+        return 2;
+    case OPAL_INT32:
+    case OPAL_UINT32:
+        return 4;
+    case OPAL_INT64:
+    case OPAL_UINT64:
+        return 8;
+    case OPAL_INT:
+        return sizeof(int);
+    case OPAL_UINT:
+        return sizeof(unsigned int);
+    case OPAL_SIZE:
+        return sizeof(size_t);
+    case OPAL_PID:
+        return sizeof(pid_t);
+    case OPAL_FLOAT:
+        return sizeof(float);
+    case OPAL_TIMEVAL:
+        return sizeof(struct timeval);
+    default:
+        return 0;
+    }
+}
+
+static int compare_staged(const void *a, const void *b)
+{
+    const db_sm_staged_t *sa = *(const db_sm_staged_t**)a;
+    const db_sm_staged_t *sb = *(const db_sm_staged_t**)b;
+
+    if (sa->id != sb->id) {
+        return (sa->id < sb->id) ? -1 : 1;
+    }
+    return strcmp(sa->kv->key, sb->kv->key);
+}
+
+/**
+ * Find the entries of a proc in a segment
+ */
+static db_sm_entry_t* lookup_proc(db_sm_header_t *hdr, opal_identifier_t id,
+                                  uint32_t *count)
+{
+    db_sm_proc_t *procs = DB_SM_PROCS(hdr);
+    uint32_t lo = 0, hi = hdr->nprocs, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (procs[mid].id == id) {
+            *count = procs[mid].count;
+            return DB_SM_ENTRIES(hdr) + procs[mid].first;
+        }
+        if (procs[mid].id < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Find an entry in the attached segments
+ */
+static db_sm_entry_t* lookup_entry(opal_identifier_t id, const char *key,
+                                   db_sm_segment_t **segment)
+{
+    db_sm_segment_t *seg;
+    db_sm_entry_t *entries;
+    uint32_t count, lo, hi, mid;
+    int cmp;
+
+    OPAL_LIST_FOREACH(seg, &segments, db_sm_segment_t) {
+        if (NULL == seg->hdr ||
+            NULL == (entries = lookup_proc(seg->hdr, id, &count))) {
+            continue;
+        }
+        lo = 0;
+        hi = count;
+        while (lo < hi) {
+            mid = lo + (hi - lo) / 2;
+            cmp = strcmp(key, DB_SM_PTR(seg->hdr, entries[mid].key));
+            if (0 == cmp) {
+                *segment = seg;
+                return &entries[mid];
+            }
+            if (0 < cmp) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Write the staged values into a new segment, and return its
+ * descriptor for the other procs to attach
+ */
+static int seal(opal_identifier_t owner, opal_byte_object_t **bo)
+{
+    db_sm_staged_t **items, *st;
+    db_sm_segment_t *seg;
+    db_sm_header_t *hdr;
+    db_sm_proc_t *procs = NULL;
+    db_sm_entry_t *ent;
+    opal_shmem_ds_t map;
+    opal_byte_object_t *boptr;
+    uint64_t size, heap, len;
+    char *name, *path;
+    size_t n, i;
+    uint32_t nprocs;
+    int rc;
+
+    if (0 == (n = opal_list_get_size(&staged))) {
+        /* nothing to share */
+        return OPAL_ERR_TAKE_NEXT_OPTION;
+    }
+
+    /* sort the values by proc then key, sizing the segment on the way */
+    items = (db_sm_staged_t**)malloc(n * sizeof(db_sm_staged_t*));
+    if (NULL == items) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    i = 0;
+    heap = 0;
+    OPAL_LIST_FOREACH(st, &staged, db_sm_staged_t) {
+        items[i++] = st;
+        heap += DB_SM_ALIGN(strlen(st->kv->key) + 1);
+        if (OPAL_STRING == st->kv->type) {
+            if (NULL != st->kv->data.string) {
+                heap += DB_SM_ALIGN(strlen(st->kv->data.string) + 1);
+            }
+        } else if (OPAL_BYTE_OBJECT == st->kv->type) {
+            heap += DB_SM_ALIGN(st->kv->data.bo.size);
+        } else {
+            heap += DB_SM_ALIGN(sizeof(st->kv->data));
+        }
+    }
+    qsort(items, n, sizeof(db_sm_staged_t*), compare_staged);
+    nprocs = 0;
+    for (i = 0; i < n; i++) {
+        if (0 == i || items[i]->id != items[i-1]->id) {
+            nprocs++;
+        }
+    }
+    size = DB_SM_ALIGN(sizeof(db_sm_header_t)) + nprocs * sizeof(db_sm_proc_t) +
+           n * sizeof(db_sm_entry_t);
+    size = DB_SM_ALIGN(size);
+    heap += size;
+
+    /* create it */
+    asprintf(&name, "opal_db_sm.%lu.%d", (unsigned long)getpid(), num_created++);
+    path = opal_os_path(false, opal_tmp_directory(), name, NULL);
+    free(name);
+    seg = OBJ_NEW(db_sm_segment_t);
+    seg->owner = owner;
+    rc = opal_shmem_segment_create(&seg->ds, path, heap);
+    free(path);
+    if (OPAL_SUCCESS != rc) {
+        OPAL_ERROR_LOG(rc);
+        OBJ_RELEASE(seg);
+        free(items);
+        return rc;
+    }
+    seg->created = true;
+    if (NULL == (hdr = (db_sm_header_t*)opal_shmem_segment_attach(&seg->ds))) {
+        OPAL_ERROR_LOG(OPAL_ERR_OUT_OF_RESOURCE);
+        OBJ_RELEASE(seg);
+        free(items);
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+
+    /* fill it */
+    hdr->size = heap;
+    hdr->nprocs = nprocs;
+    hdr->nentries = n;
+    heap = size;
+    nprocs = 0;
+    for (i = 0; i < n; i++) {
+        st = items[i];
+        if (0 == i || st->id != items[i-1]->id) {
+            procs = DB_SM_PROCS(hdr) + nprocs++;
+            procs->id = st->id;
+            procs->first = i;
+            procs->count = 0;
+        }
+        procs->count++;
+        ent = DB_SM_ENTRIES(hdr) + i;
+        ent->type = st->kv->type;
+        len = strlen(st->kv->key) + 1;
+        ent->key = heap;
+        memcpy(DB_SM_PTR(hdr, heap), st->kv->key, len);
+        heap += DB_SM_ALIGN(len);
+        ent->data = 0;
+        ent->size = 0;
+        if (OPAL_STRING == st->kv->type) {
+            if (NULL != st->kv->data.string) {
+                ent->size = strlen(st->kv->data.string) + 1;
+                ent->data = heap;
+                memcpy(DB_SM_PTR(hdr, heap), st->kv->data.string, ent->size);
+            }
+        } else if (OPAL_BYTE_OBJECT == st->kv->type) {
+            if (NULL != st->kv->data.bo.bytes && 0 < st->kv->data.bo.size) {
+                ent->size = st->kv->data.bo.size;
+                ent->data = heap;
+                memcpy(DB_SM_PTR(hdr, heap), st->kv->data.bo.bytes, ent->size);
+            }
+        } else {
+            ent->size = sizeof(st->kv->data);
+            ent->data = heap;
+            memcpy(DB_SM_PTR(hdr, heap), &st->kv->data, ent->size);
+        }
+        heap += DB_SM_ALIGN(ent->size);
+    }
+    free(items);
+
+    OPAL_OUTPUT_VERBOSE((5, opal_db_base_framework.framework_output,
+                         "db:sm:seal: shared %u entries of %u procs in %s (%lu bytes)",
+                         hdr->nentries, hdr->nprocs, seg->ds.seg_name,
+                         (unsigned long)hdr->size));
+
+    /* we are done with it - the procs attach it on their own,
+     * and it lives until we unlink it. Detaching resets the
+     * descriptor, so do it on a copy
+     */
+    opal_shmem_ds_copy(&seg->ds, &map);
+    opal_shmem_segment_detach(&map);
+    opal_list_append(&segments, &seg->super);
+    while (NULL != (st = (db_sm_staged_t*)opal_list_remove_first(&staged))) {
+        OBJ_RELEASE(st);
+    }
+
+    boptr = (opal_byte_object_t*)malloc(sizeof(opal_byte_object_t));
+    boptr->size = opal_shmem_sizeof_shmem_ds(&seg->ds);
+    boptr->bytes = (uint8_t*)malloc(boptr->size);
+    memcpy(boptr->bytes, &seg->ds, boptr->size);
+    *bo = boptr;
+    return OPAL_SUCCESS;
+}
+
+static int attach(opal_identifier_t owner, const opal_byte_object_t *bo)
+{
+    db_sm_segment_t *seg;
+
+    if (NULL == bo || NULL == bo->bytes ||
+        bo->size < (int32_t)offsetof(opal_shmem_ds_t, seg_name) ||
+        bo->size > (int32_t)sizeof(opal_shmem_ds_t)) {
+        OPAL_ERROR_LOG(OPAL_ERR_BAD_PARAM);
+        return OPAL_ERR_BAD_PARAM;
+    }
+    seg = OBJ_NEW(db_sm_segment_t);
+    seg->owner = owner;
+    memcpy(&seg->ds, bo->bytes, bo->size);
+    if (NULL == (seg->hdr = (db_sm_header_t*)opal_shmem_segment_attach(&seg->ds))) {
+        OPAL_ERROR_LOG(OPAL_ERR_FILE_OPEN_FAILURE);
+        OBJ_RELEASE(seg);
+        return OPAL_ERR_FILE_OPEN_FAILURE;
+    }
+    opal_list_append(&segments, &seg->super);
+
+    OPAL_OUTPUT_VERBOSE((5, opal_db_base_framework.framework_output,
+                         "db:sm:attach: attached %u entries of %u procs from %s",
+                         seg->hdr->nentries, seg->hdr->nprocs, seg->ds.seg_name));
+    return OPAL_SUCCESS;
+}
+
+static int store(const opal_identifier_t *uid,
+                 opal_db_locality_t locality,
+                 const char *key, const void *data,
+                 opal_data_type_t type)
+{
+    opal_identifier_t id;
+
+    /* all we store ourselves are the segments */
+    if (NULL == key || 0 != strcmp(key, OPAL_DB_SM_SEGMENT)) {
+        return OPAL_ERR_TAKE_NEXT_OPTION;
+    }
+    if (OPAL_BYTE_OBJECT != type) {
+        OPAL_ERROR_LOG(OPAL_ERR_TYPE_MISMATCH);
+        return OPAL_ERR_TYPE_MISMATCH;
+    }
+
+    /* to protect alignment, copy the data across */
+    memcpy(&id, uid, sizeof(opal_identifier_t));
+
+    return attach(id, (const opal_byte_object_t*)data);
+}
+
+static int store_pointer(const opal_identifier_t *uid,
+                         opal_db_locality_t locality,
+                         opal_value_t *kv)
+{
+    db_sm_staged_t *st;
+
+    if (OPAL_DB_LOCAL != locality) {
+        return OPAL_ERR_TAKE_NEXT_OPTION;
+    }
+    if (OPAL_STRING != kv->type && OPAL_BYTE_OBJECT != kv->type &&
+        0 == scalar_size(kv->type)) {
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    /* hold it until the segment is sealed */
+    st = OBJ_NEW(db_sm_staged_t);
+    memcpy(&st->id, uid, sizeof(opal_identifier_t));
+    st->kv = kv;
+    opal_list_append(&staged, &st->super);
+    return OPAL_SUCCESS;
+}
+
+static int fetch(const opal_identifier_t *uid,
+                 const char *key, void **data, opal_data_type_t type)
+{
+    db_sm_segment_t *seg;
+    db_sm_entry_t *ent;
+    opal_byte_object_t *boptr;
+    opal_identifier_t id;
+    size_t size;
+
+    if (NULL == key) {
+        OPAL_ERROR_LOG(OPAL_ERR_BAD_PARAM);
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    /* to protect alignment, copy the data across */
+    memcpy(&id, uid, sizeof(opal_identifier_t));
+
+    if (0 == strcmp(key, OPAL_DB_SM_SEGMENT)) {
+        if (OPAL_BYTE_OBJECT != type) {
+            return OPAL_ERR_TYPE_MISMATCH;
+        }
+        return seal(id, (opal_byte_object_t**)data);
+    }
+
+    if (NULL == (ent = lookup_entry(id, key, &seg))) {
+        return OPAL_ERR_TAKE_NEXT_OPTION;
+    }
+    if (ent->type != type) {
+        return OPAL_ERR_TYPE_MISMATCH;
+    }
+
+    switch (type) {
+    case OPAL_STRING:
+        if (0 != ent->data) {
+            *data = strdup(DB_SM_PTR(seg->hdr, ent->data));
+        } else {
+            *data = NULL;
+        }
+        break;
+    case OPAL_BYTE_OBJECT:
+        boptr = (opal_byte_object_t*)malloc(sizeof(opal_byte_object_t));
+        if (0 != ent->data) {
+            boptr->bytes = (uint8_t *) malloc(ent->size);
+            memcpy(boptr->bytes, DB_SM_PTR(seg->hdr, ent->data), ent->size);
+            boptr->size = ent->size;
+        } else {
+            boptr->bytes = NULL;
+            boptr->size = 0;
+        }
+        *data = boptr;
+        break;
+    default:
+        if (0 == (size = scalar_size(type))) {
+            OPAL_ERROR_LOG(OPAL_ERR_NOT_SUPPORTED);
+            return OPAL_ERR_NOT_SUPPORTED;
+        }
+        memcpy(*data, DB_SM_PTR(seg->hdr, ent->data), size);
+        break;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+static int fetch_pointer(const opal_identifier_t *uid,
+                         const char *key,
+                         void **data, opal_data_type_t type)
+{
+    db_sm_segment_t *seg;
+    db_sm_entry_t *ent;
+    opal_byte_object_t *boptr;
+    opal_identifier_t id;
+    uint32_t idx;
+
+    if (NULL == key) {
+        OPAL_ERROR_LOG(OPAL_ERR_BAD_PARAM);
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    /* to protect alignment, copy the data across */
+    memcpy(&id, uid, sizeof(opal_identifier_t));
+
+    if (NULL == (ent = lookup_entry(id, key, &seg))) {
+        return OPAL_ERR_TAKE_NEXT_OPTION;
+    }
+    if (ent->type != type) {
+        return OPAL_ERR_TYPE_MISMATCH;
+    }
+
+    switch (type) {
+    case OPAL_STRING:
+        *data = (0 != ent->data) ? DB_SM_PTR(seg->hdr, ent->data) : NULL;
+        break;
+    case OPAL_BYTE_OBJECT:
+        /* the bytes stay in the segment, only the descriptor is ours */
+        idx = (uint32_t)(ent - DB_SM_ENTRIES(seg->hdr));
+        if (OPAL_SUCCESS != opal_hash_table_get_value_uint32(&seg->bos, idx, (void**)&boptr)) {
+            boptr = (opal_byte_object_t*)malloc(sizeof(opal_byte_object_t));
+            boptr->size = ent->size;
+            boptr->bytes = (0 != ent->data) ? (uint8_t*)DB_SM_PTR(seg->hdr, ent->data) : NULL;
+            opal_hash_table_set_value_uint32(&seg->bos, idx, boptr);
+        }
+        *data = boptr;
+        break;
+    default:
+        if (0 == scalar_size(type)) {
+            OPAL_ERROR_LOG(OPAL_ERR_NOT_SUPPORTED);
+            return OPAL_ERR_NOT_SUPPORTED;
+        }
+        *data = DB_SM_PTR(seg->hdr, ent->data);
+        break;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+static int fetch_multiple(const opal_identifier_t *uid,
+                          const char *key,
+                          opal_list_t *kvs)
+{
+    db_sm_segment_t *seg;
+    db_sm_entry_t *entries = NULL;
+    opal_value_t *kv;
+    char *srchkey, *ptr, *ekey;
+    size_t len = 0;
+    uint32_t count, i;
+    opal_identifier_t id;
+
+    /* to protect alignment, copy the data across */
+    memcpy(&id, uid, sizeof(opal_identifier_t));
+
+    OPAL_LIST_FOREACH(seg, &segments, db_sm_segment_t) {
+        if (NULL != seg->hdr &&
+            NULL != (entries = lookup_proc(seg->hdr, id, &count))) {
+            break;
+        }
+    }
+    if (NULL == entries) {
+        /* look elsewhere */
+        return OPAL_ERR_TAKE_NEXT_OPTION;
+    }
+
+    /* see if the key includes a wildcard */
+    srchkey = NULL;
+    if (NULL != key) {
+        srchkey = strdup(key);
+        if (NULL != (ptr = strchr(srchkey, '*'))) {
+            *ptr = '\0';
+            len = strlen(srchkey);
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        ekey = DB_SM_PTR(seg->hdr, entries[i].key);
+        if (NULL != key &&
+            !(0 < len && 0 == strncmp(srchkey, ekey, len)) &&
+            !(0 == len && 0 == strcmp(key, ekey))) {
+            continue;
+        }
+        kv = OBJ_NEW(opal_value_t);
+        kv->key = strdup(ekey);
+        kv->type = entries[i].type;
+        if (OPAL_STRING == kv->type) {
+            kv->data.string = (0 != entries[i].data) ?
+                strdup(DB_SM_PTR(seg->hdr, entries[i].data)) : NULL;
+        } else if (OPAL_BYTE_OBJECT == kv->type) {
+            kv->data.bo.bytes = NULL;
+            kv->data.bo.size = 0;
+            if (0 != entries[i].data) {
+                kv->data.bo.bytes = (uint8_t *) malloc(entries[i].size);
+                memcpy(kv->data.bo.bytes, DB_SM_PTR(seg->hdr, entries[i].data),
+                       entries[i].size);
+                kv->data.bo.size = entries[i].size;
+            }
+        } else {
+            memcpy(&kv->data, DB_SM_PTR(seg->hdr, entries[i].data), sizeof(kv->data));
+        }
+        opal_list_append(kvs, &kv->super);
+    }
+    if (NULL != srchkey) {
+        free(srchkey);
+    }
+    return OPAL_SUCCESS;
+}
+
+static int remove_data(const opal_identifier_t *uid, const char *key)
+{
+    db_sm_segment_t *seg, *next;
+    opal_list_item_t *item;
+    opal_identifier_t id;
+
+    /* all we remove ourselves are the segments */
+    if (NULL == key || 0 != strcmp(key, OPAL_DB_SM_SEGMENT)) {
+        return OPAL_ERR_TAKE_NEXT_OPTION;
+    }
+
+    /* to protect alignment, copy the data across */
+    memcpy(&id, uid, sizeof(opal_identifier_t));
+
+    /* drop anything that was waiting on a seal */
+    while (NULL != (item = opal_list_remove_first(&staged))) {
+        OBJ_RELEASE(item);
+    }
+    OPAL_LIST_FOREACH_SAFE(seg, next, &segments, db_sm_segment_t) {
+        if (seg->owner == id) {
+            opal_list_remove_item(&segments, &seg->super);
+            OBJ_RELEASE(seg);
+        }
+    }
+    return OPAL_SUCCESS;
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2013      Los Alamos National Security, Inc. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#ifndef OPAL_DB_SM_H
+#define OPAL_DB_SM_H
+
+#include "opal/mca/db/db.h"
+
+BEGIN_C_DECLS
+
+
+OPAL_MODULE_DECLSPEC extern opal_db_base_component_t mca_db_sm_component;
+OPAL_DECLSPEC extern opal_db_base_module_t opal_db_sm_module;
+
+END_C_DECLS
+
+#endif /* OPAL_DB_SM_H */
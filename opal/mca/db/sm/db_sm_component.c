@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2013      Los Alamos National Security, Inc. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ *
+ * These symbols are in a file by themselves to provide nice linker
+ * semantics.  Since linkers generally pull in symbols by object
+ * files, keeping these symbols as the only symbols in this file
+ * prevents utility programs such as "ompi_info" from having to import
+ * entire components just to query their version and parameters.
+ */
+
+#include "opal_config.h"
+#include "opal/constants.h"
+
+#include "opal/mca/base/base.h"
+
+#include "opal/mca/db/db.h"
+#include "opal/mca/db/base/base.h"
+#include "db_sm.h"
+
+static int db_sm_component_open(void);
+static int db_sm_component_query(opal_db_base_module_t **module,
+                                 int *store_priority,
+                                 int *fetch_priority);
+static int db_sm_component_close(void);
+static int db_sm_component_register(void);
+
+/*
+ * Instantiate the public struct with all of our public information
+ * and pointers to our public functions in it
+ */
+opal_db_base_component_t mca_db_sm_component = {
+    {
+        OPAL_DB_BASE_VERSION_1_0_0,
+
+        /* Component name and version */
+        "sm",
+        OPAL_MAJOR_VERSION,
+        OPAL_MINOR_VERSION,
+        OPAL_RELEASE_VERSION,
+
+        /* Component open and close functions */
+        db_sm_component_open,
+        db_sm_component_close,
+        NULL,
+        db_sm_component_register
+    },
+    {
+        /* The component is checkpoint ready */
+        MCA_BASE_METADATA_PARAM_CHECKPOINT
+    },
+    db_sm_component_query
+};
+
+/* we have to see the node-local data and the segment
+ * descriptors before the hash component swallows them,
+ * but pass everything else down to it
+ */
+static int my_store_priority = 50;
+/* the data shared on the node is a snapshot, so let any
+ * private copy held by the hash component take precedence
+ */
+static int my_fetch_priority = 50;
+
+static int db_sm_component_open(void)
+{
+    return OPAL_SUCCESS;
+}
+
+static int db_sm_component_query(opal_db_base_module_t **module,
+                                 int *store_priority,
+                                 int *fetch_priority)
+{
+    /* we only act on the data explicitly shared on the node,
+     * so we can always be active
+     */
+    *store_priority = my_store_priority;
+    *fetch_priority = my_fetch_priority;
+    *module = &opal_db_sm_module;
+    return OPAL_SUCCESS;
+}
+
+
+static int db_sm_component_close(void)
+{
+    return OPAL_SUCCESS;
+}
+
+static int db_sm_component_register(void)
+{
+    mca_base_component_t *c = &mca_db_sm_component.base_version;
+
+    my_store_priority = 50;
+    (void) mca_base_component_var_register(c, "store_priority",
+                                           "Priority dictating order in which store commands will given to database components",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &my_store_priority);
+
+    my_fetch_priority = 50;
+    (void) mca_base_component_var_register(c, "fetch_priority",
+                                           "Priority dictating order in which fetch commands will given to database components",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &my_fetch_priority);
+
+    return OPAL_SUCCESS;
+}
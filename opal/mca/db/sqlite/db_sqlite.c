@@ -55,7 +55,8 @@ opal_db_base_module_t opal_db_sqlite_module = {
     NULL,
     NULL,
     NULL,
-    add_log
+    add_log,
+    NULL
 };
 
 /* local variables */
@@ -35,6 +35,8 @@ OPAL_DECLSPEC extern opal_event_base_t *opal_event_base;
 #define OPAL_EV_SIGNAL  EV_SIGNAL
 /* Persistent event: won't get removed automatically when activated. */
 #define OPAL_EV_PERSIST EV_PERSIST
+/* Edge-triggered event - only honored by backends such as epoll */
+#define OPAL_EV_ET      EV_ET
 
 #define OPAL_EVLOOP_ONCE     EVLOOP_ONCE        /**< Block at most once. */
 #define OPAL_EVLOOP_NONBLOCK EVLOOP_NONBLOCK    /**< Do not block. */
@@ -42,6 +44,8 @@ OPAL_DECLSPEC extern opal_event_base_t *opal_event_base;
 /* Global function to create and release an event base */
 #define opal_event_base_create() event_base_new()
 
+#define opal_event_base_create_isolated() event_base_new()
+
 #define opal_event_base_free(x) event_base_free(x)
 
 OPAL_DECLSPEC int opal_event_init(void);
@@ -74,6 +74,8 @@ OPAL_DECLSPEC extern opal_event_base_t *opal_event_base;
 #define OPAL_EV_SIGNAL  EV_SIGNAL
 /* Persistent event: won't get removed automatically when activated. */
 #define OPAL_EV_PERSIST EV_PERSIST
+/* Edge-triggered event - only honored by backends such as epoll */
+#define OPAL_EV_ET      EV_ET
 
 #define OPAL_EVLOOP_ONCE     EVLOOP_ONCE        /**< Block at most once. */
 #define OPAL_EVLOOP_NONBLOCK EVLOOP_NONBLOCK    /**< Do not block. */
@@ -81,6 +83,13 @@ OPAL_DECLSPEC extern opal_event_base_t *opal_event_base;
 /* Global function to create and release an event base */
 OPAL_DECLSPEC opal_event_base_t* opal_event_base_create(void);
 
+/* Create an event base for use by a single subsystem and its own
+ * progress thread. Backend changes are batched into one kernel call
+ * per loop iteration, and edge-triggered events are supported when
+ * the isolated_edge_triggered parameter is set.
+ */
+OPAL_DECLSPEC opal_event_base_t* opal_event_base_create_isolated(void);
+
 #define opal_event_base_free(x) event_base_free(x)
 
 OPAL_DECLSPEC int opal_event_init(void);
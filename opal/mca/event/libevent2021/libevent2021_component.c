@@ -35,6 +35,7 @@ const char *opal_event_libevent2021_component_version_string =
  * MCA variables
  */
 char *event_module_include = NULL;
+bool event_isolated_edge_triggered = false;
 
 /* copied from event.c */
 #if defined(_EVENT_HAVE_EVENT_PORTS) && _EVENT_HAVE_EVENT_PORTS
@@ -195,6 +196,19 @@ static int libevent2021_register (void)
         return ret;
     }
 
+    event_isolated_edge_triggered = false;
+    ret = mca_base_component_var_register (&mca_event_libevent2021_component.base_version,
+                                           "isolated_edge_triggered",
+                                           "Require a backend supporting edge-triggered (OPAL_EV_ET) "
+                                           "events, such as epoll, for isolated event bases",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &event_isolated_edge_triggered);
+    if (0 > ret) {
+        return ret;
+    }
+
     return OPAL_SUCCESS;
 }
 
@@ -61,9 +61,39 @@
 #include "opal/mca/event/event.h"
 
 static struct event_config *config=NULL;
+static char **includes=NULL;
 extern char *event_module_include;
+extern bool event_isolated_edge_triggered;
 extern const struct eventop *eventops[];
 
+/* build a configuration that only allows the included backends */
+static struct event_config *new_config(void)
+{
+    struct event_config *cfg;
+    bool dumpit;
+    int i, j;
+
+    cfg = event_config_new();
+    /* cycle thru the available subsystems */
+    for (i = 0 ; NULL != eventops[i] ; ++i) {
+        /* if this module isn't included in the given ones,
+         * then exclude it
+         */
+        dumpit = true;
+        for (j=0; NULL != includes && NULL != includes[j]; j++) {
+            if (0 == strcmp("all", includes[j]) ||
+                0 == strcmp(eventops[i]->name, includes[j])) {
+                dumpit = false;
+                break;
+            }
+        }
+        if (dumpit) {
+            event_config_avoid_method(cfg, eventops[i]->name);
+        }
+    }
+    return cfg;
+}
+
 opal_event_base_t* opal_event_base_create(void)
 {
     opal_event_base_t *base;
@@ -76,15 +106,43 @@ opal_event_base_t* opal_event_base_create(void)
     return base;
 }
 
-int opal_event_init(void)
+opal_event_base_t* opal_event_base_create_isolated(void)
 {
-    char **includes=NULL;
-    bool dumpit=false;
-    int i, j;
+    opal_event_base_t *base = NULL;
+    struct event_config *cfg;
+
+    if (event_isolated_edge_triggered) {
+        cfg = new_config();
+        event_config_require_features(cfg, EV_FEATURE_ET);
+        event_config_set_flag(cfg, EVENT_BASE_FLAG_EPOLL_USE_CHANGELIST);
+        base = event_base_new_with_config(cfg);
+        event_config_free(cfg);
+        if (NULL == base) {
+            opal_output_verbose(1, opal_event_base_framework.framework_output,
+                                "event: no included backend supports edge-triggered events");
+        }
+    }
+    if (NULL == base) {
+        cfg = new_config();
+        event_config_set_flag(cfg, EVENT_BASE_FLAG_EPOLL_USE_CHANGELIST);
+        base = event_base_new_with_config(cfg);
+        event_config_free(cfg);
+    }
+    if (NULL == base) {
+        /* there is no backend method that does what we want */
+        opal_output(0, "No event method available");
+        return NULL;
+    }
+    if (0 < OPAL_EVENT_NUM_PRI) {
+        event_base_priority_init(base, OPAL_EVENT_NUM_PRI);
+    }
+    return base;
+}
 
+int opal_event_init(void)
+{
     if (opal_output_get_verbosity(opal_event_base_framework.framework_output) > 4) {
         event_enable_debug_mode();
-        dumpit = true;
     }
 
     if (NULL == event_module_include) {
@@ -94,25 +152,7 @@ int opal_event_init(void)
     includes = opal_argv_split(event_module_include,',');
 
     /* get a configuration object */
-    config = event_config_new();
-    /* cycle thru the available subsystems */
-    for (i = 0 ; NULL != eventops[i] ; ++i) {
-        /* if this module isn't included in the given ones,
-         * then exclude it
-         */
-        dumpit = true;
-        for (j=0; NULL != includes[j]; j++) {
-            if (0 == strcmp("all", includes[j]) ||
-                0 == strcmp(eventops[i]->name, includes[j])) {
-                dumpit = false;
-                break;
-            }
-        }
-        if (dumpit) {
-            event_config_avoid_method(config, eventops[i]->name);
-        }
-    }
-    opal_argv_free(includes);
+    config = new_config();
 
     return OPAL_SUCCESS;
 }
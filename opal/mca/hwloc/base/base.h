@@ -130,15 +130,62 @@ typedef enum {
  */
 OPAL_DECLSPEC extern opal_hwloc_base_mbfa_t opal_hwloc_base_mbfa;
 
+/**
+ * Whether the internal buffers of MPI (free list payloads, shared
+ * memory FIFOs) are bound to the NUMA node of the process that uses
+ * them (set by MCA param).
+ */
+OPAL_DECLSPEC extern bool opal_hwloc_base_mem_bind_buffers;
+
+/**
+ * Whether the last available core of each node is kept for the
+ * runtime and MPI helper threads instead of application procs (set by
+ * MCA param), and the cpus of that core on this node once found.
+ */
+OPAL_DECLSPEC extern bool opal_hwloc_base_reserve_helper_core;
+OPAL_DECLSPEC extern hwloc_cpuset_t opal_hwloc_base_helper_cpuset;
+
 /* some critical helper functions */
 OPAL_DECLSPEC int opal_hwloc_base_filter_cpus(hwloc_topology_t topo);
 
+/**
+ * Bind the calling thread to the reserved helper core.  Called at the
+ * top of internal threads (progress, async event, fifo) so they stay
+ * off the cores the application procs were bound to.  A no-op unless
+ * hwloc_base_reserve_helper_core is set.
+ *
+ * @param name  Short name of the thread, used when reporting bindings
+ */
+OPAL_DECLSPEC int opal_hwloc_base_bind_helper_thread(const char *name);
+
 /**
  * Discover / load the hwloc topology (i.e., call hwloc_topology_init() and
  * hwloc_topology_load()).
  */
 OPAL_DECLSPEC int opal_hwloc_base_get_topology(void);
 
+/**
+ * Descriptor of the shared memory segment holding the topology our
+ * local daemon discovered (set by MCA param).  When present,
+ * opal_hwloc_base_get_topology() loads the topology from it instead
+ * of rediscovering the node.
+ */
+OPAL_DECLSPEC extern char *opal_hwloc_base_topo_shmem;
+
+/**
+ * Export the current topology as XML into a shared memory segment
+ * under dir so local procs can load it without discovery.  The
+ * segment is created on the first call only; every call returns a
+ * newly allocated copy of its descriptor, suitable for the
+ * hwloc_base_topo_shmem MCA param.
+ */
+OPAL_DECLSPEC int opal_hwloc_base_share_topology(const char *dir, char **descriptor);
+
+/**
+ * Remove the segment created by opal_hwloc_base_share_topology()
+ */
+OPAL_DECLSPEC void opal_hwloc_base_unshare_topology(void);
+
 /**
  * Set the hwloc topology to that from the given topo file
  */
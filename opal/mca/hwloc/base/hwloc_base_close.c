@@ -41,6 +41,10 @@ int opal_hwloc_base_close(void)
             hwloc_bitmap_free(opal_hwloc_my_cpuset);
             opal_hwloc_my_cpuset = NULL;
         }
+        if (NULL != opal_hwloc_base_helper_cpuset) {
+            hwloc_bitmap_free(opal_hwloc_base_helper_cpuset);
+            opal_hwloc_base_helper_cpuset = NULL;
+        }
     }
 #endif
 
@@ -10,6 +10,10 @@
 
 #include "opal_config.h"
 
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
 #include "opal/constants.h"
 
 #include "opal/mca/hwloc/hwloc.h"
@@ -128,13 +132,21 @@ int opal_hwloc_base_node_name_to_id(char *node_name, int *id)
     return OPAL_SUCCESS;
 }
 
+/*
+ * Bind the segments to the NUMA node of the given logical index among
+ * the available ones.  mbind() works on whole pages, so every segment
+ * is shrunk to the pages it fully covers: the pages it shares with its
+ * neighbours are left to the first touch, and a segment that does not
+ * cover a single page is not bound at all.
+ */
 int opal_hwloc_base_membind(opal_hwloc_base_memory_segment_t *segs,
                             size_t count, int node_id)
 {
     size_t i;
     int rc = OPAL_SUCCESS;
     char *msg = NULL;
-    hwloc_cpuset_t cpuset = NULL;
+    hwloc_obj_t obj;
+    uintptr_t pagesize, start, end;
 
     /* bozo check */
     if (NULL == opal_hwloc_topology) {
@@ -143,19 +155,28 @@ int opal_hwloc_base_membind(opal_hwloc_base_memory_segment_t *segs,
                                                    msg, rc);
     }
 
-    cpuset = hwloc_bitmap_alloc();
-    if (NULL == cpuset) {
-        rc = OPAL_ERR_OUT_OF_RESOURCE;
-        msg = "hwloc_bitmap_alloc() failure";
+    /* the index is the one of the NUMA node, not of a processor: bind
+       to the cpus of that node */
+    obj = opal_hwloc_base_get_obj_by_type(opal_hwloc_topology, HWLOC_OBJ_NODE, 0,
+                                          (unsigned int) node_id, OPAL_HWLOC_AVAILABLE);
+    if (node_id < 0 || NULL == obj) {
+        rc = OPAL_ERR_BAD_PARAM;
+        msg = "hwloc_set_area_membind() failure - no such NUMA node";
         goto out;
     }
-    hwloc_bitmap_set(cpuset, node_id);
+
+    pagesize = (uintptr_t) sysconf(_SC_PAGESIZE);
     for(i = 0; i < count; i++) {
-        if (0 != hwloc_set_area_membind(opal_hwloc_topology, 
-                                        segs[i].mbs_start_addr,
-                                        segs[i].mbs_len, cpuset,
-                                        HWLOC_MEMBIND_BIND, 
-                                        HWLOC_MEMBIND_STRICT)) {
+        start = ((uintptr_t) segs[i].mbs_start_addr + pagesize - 1) & ~(pagesize - 1);
+        end = ((uintptr_t) segs[i].mbs_start_addr + segs[i].mbs_len) & ~(pagesize - 1);
+        if (end <= start) {
+            continue;
+        }
+        /* the pages may already have been touched: move them */
+        if (0 != hwloc_set_area_membind(opal_hwloc_topology,
+                                        (void *) start, end - start, obj->cpuset,
+                                        HWLOC_MEMBIND_BIND,
+                                        HWLOC_MEMBIND_MIGRATE)) {
             rc = OPAL_ERROR;
             msg = "hwloc_set_area_membind() failure";
             goto out;
@@ -163,9 +184,6 @@ int opal_hwloc_base_membind(opal_hwloc_base_memory_segment_t *segs,
     }
 
  out:
-    if (NULL != cpuset) {
-        hwloc_bitmap_free(cpuset);
-    }
     if (OPAL_SUCCESS != rc) {
         return opal_hwloc_base_report_bind_failure(__FILE__, __LINE__, msg, rc);
     }
@@ -41,9 +41,13 @@ hwloc_cpuset_t opal_hwloc_my_cpuset=NULL;
 hwloc_cpuset_t opal_hwloc_base_given_cpus=NULL;
 opal_hwloc_base_map_t opal_hwloc_base_map = OPAL_HWLOC_BASE_MAP_NONE;
 opal_hwloc_base_mbfa_t opal_hwloc_base_mbfa = OPAL_HWLOC_BASE_MBFA_WARN;
+bool opal_hwloc_base_mem_bind_buffers = true;
 opal_binding_policy_t opal_hwloc_binding_policy=0;
 char *opal_hwloc_base_slot_list=NULL;
 char *opal_hwloc_base_cpu_set=NULL;
+bool opal_hwloc_base_reserve_helper_core=false;
+hwloc_cpuset_t opal_hwloc_base_helper_cpuset=NULL;
+char *opal_hwloc_base_topo_shmem=NULL;
 bool opal_hwloc_report_bindings=false;
 hwloc_obj_type_t opal_hwloc_levels[] = {
     HWLOC_OBJ_MACHINE,
@@ -121,6 +125,12 @@ static int opal_hwloc_base_register(mca_base_register_flag_t flags)
         return ret;
     }
 
+    opal_hwloc_base_mem_bind_buffers = true;
+    (void) mca_base_var_register("opal", "hwloc", "base", "mem_bind_buffers",
+                                 "Bind the internal buffers of Open MPI to the NUMA node of the process that accesses them the most: the fragments of a sender to its own node, the receive queues to the node of the receiver.  Only processes bound within a single NUMA node bind their buffers.",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_hwloc_base_mem_bind_buffers);
+
     opal_hwloc_base_binding_policy = NULL;
     (void) mca_base_var_register("opal", "hwloc", "base", "binding_policy",
                                  "Policy for binding processes [none (default) | hwthread | core | l1cache | l2cache | l3cache | socket | numa | board] (supported qualifiers: overload-allowed,if-supported)",
@@ -155,6 +165,20 @@ static int opal_hwloc_base_register(mca_base_register_flag_t flags)
                                  MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0, OPAL_INFO_LVL_9,
                                  MCA_BASE_VAR_SCOPE_READONLY, &opal_hwloc_base_cpu_set);
 
+    opal_hwloc_base_reserve_helper_core = false;
+    (void) mca_base_var_register("opal", "hwloc", "base", "reserve_helper_core",
+                                 "Keep the last available core of each node for runtime and MPI helper threads (progress, async event and fifo threads) - application processes are not bound to it [default: false]",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_hwloc_base_reserve_helper_core);
+
+    /* set by the local daemon when it shares its topology with us */
+    opal_hwloc_base_topo_shmem = NULL;
+    (void) mca_base_var_register("opal", "hwloc", "base", "topo_shmem",
+                                 "Shared memory segment holding the node topology discovered by the local daemon (internal use only)",
+                                 MCA_BASE_VAR_TYPE_STRING, NULL, 0,
+                                 MCA_BASE_VAR_FLAG_INTERNAL, OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY, &opal_hwloc_base_topo_shmem);
+
     /* declare hwthreads as independent cpus */
     opal_hwloc_use_hwthreads_as_cpus = false;
     (void) mca_base_var_register("opal", "hwloc", "base", "use_hwthreads_as_cpus",
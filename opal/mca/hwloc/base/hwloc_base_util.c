@@ -35,10 +35,17 @@
 #include "opal/util/output.h"
 #include "opal/util/show_help.h"
 #include "opal/threads/tsd.h"
+#include "opal/mca/shmem/base/base.h"
 
 #include "opal/mca/hwloc/hwloc.h"
 #include "opal/mca/hwloc/base/base.h"
 
+/* segment holding the XML topology the daemon shares with its local
+ * procs, and the descriptor handed to them in the environment
+ */
+static opal_shmem_ds_t shared_topo_ds;
+static char *shared_topo_desc = NULL;
+
 /*
  * Provide the hwloc object that corresponds to the given
  * LOGICAL processor id.  Remember: "processor" here [usually] means "core" --
@@ -81,6 +88,44 @@ static hwloc_obj_t get_pu(hwloc_topology_t topo,  int lid)
     return obj;
 }
 
+/* take the last core (or PU if the topology has no cores) out of
+ * the available cpus so helper threads have somewhere to go. The
+ * choice only depends on the topology and the cpu_set, so the daemon
+ * mapping procs and the procs themselves pick the same core
+ */
+static void reserve_helper_core(hwloc_topology_t topo, hwloc_cpuset_t avail)
+{
+    hwloc_obj_type_t type = HWLOC_OBJ_CORE;
+    hwloc_obj_t obj;
+    int n;
+
+    n = hwloc_get_nbobjs_inside_cpuset_by_type(topo, avail, type);
+    if (n <= 0) {
+        type = HWLOC_OBJ_PU;
+        n = hwloc_get_nbobjs_inside_cpuset_by_type(topo, avail, type);
+    }
+    /* never give away the only one */
+    if (n < 2) {
+        OPAL_OUTPUT_VERBOSE((5, opal_hwloc_base_framework.framework_output,
+                             "hwloc:base: too few cpus to reserve a helper core"));
+        return;
+    }
+    obj = hwloc_get_obj_inside_cpuset_by_type(topo, avail, type, n - 1);
+    if (NULL == obj) {
+        return;
+    }
+
+    if (topo == opal_hwloc_topology && NULL == opal_hwloc_base_helper_cpuset) {
+        opal_hwloc_base_helper_cpuset = hwloc_bitmap_alloc();
+        hwloc_bitmap_and(opal_hwloc_base_helper_cpuset, obj->cpuset, avail);
+    }
+    hwloc_bitmap_andnot(avail, avail, obj->cpuset);
+
+    OPAL_OUTPUT_VERBOSE((5, opal_hwloc_base_framework.framework_output,
+                         "hwloc:base: reserved %s %u for helper threads",
+                         hwloc_obj_type_string(type), obj->logical_index));
+}
+
 /* determine the node-level available cpuset based on
  * online vs allowed vs user-specified cpus
  */
@@ -165,12 +210,53 @@ int opal_hwloc_base_filter_cpus(hwloc_topology_t topo)
         hwloc_bitmap_free(pucpus);
     }
 
+    if (opal_hwloc_base_reserve_helper_core) {
+        reserve_helper_core(topo, avail);
+    }
+
     /* cache this info */
     sum->available = avail;
 
     return OPAL_SUCCESS;
 }
 
+int opal_hwloc_base_bind_helper_thread(const char *name)
+{
+    char tmp[1024], hostname[64];
+
+    if (!opal_hwloc_base_reserve_helper_core) {
+        return OPAL_SUCCESS;
+    }
+
+    if (NULL == opal_hwloc_topology &&
+        OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+    /* finds the helper core if nobody has yet */
+    opal_hwloc_base_filter_cpus(opal_hwloc_topology);
+    if (NULL == opal_hwloc_base_helper_cpuset) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    if (0 != hwloc_set_cpubind(opal_hwloc_topology, opal_hwloc_base_helper_cpuset,
+                               HWLOC_CPUBIND_THREAD)) {
+        OPAL_OUTPUT_VERBOSE((5, opal_hwloc_base_framework.framework_output,
+                             "hwloc:base: could not bind %s thread", name));
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    if (opal_hwloc_report_bindings) {
+        if (OPAL_SUCCESS == opal_hwloc_base_cset2mapstr(tmp, sizeof(tmp),
+                                                        opal_hwloc_base_helper_cpuset)) {
+            gethostname(hostname, sizeof(hostname));
+            opal_output(0, "[%s:%d] %s thread bound to helper core: %s",
+                        hostname, (int)getpid(), name, tmp);
+        }
+    }
+
+    return OPAL_SUCCESS;
+}
+
 static void fill_cache_line_size(void)
 {
     int i = 0;
@@ -204,6 +290,124 @@ static void fill_cache_line_size(void)
     }
 }
 
+/* load the topology from the segment our daemon shared with us. The
+ * descriptor is "cpid:id:size:name" - enough to rebuild the shmem ds
+ * and attach without another round of discovery
+ */
+static int import_shared_topology(const char *desc)
+{
+    opal_shmem_ds_t ds;
+    struct hwloc_topology_support *support;
+    unsigned long size;
+    char *xml;
+    int cpid, id, n = 0, rc = OPAL_ERR_NOT_SUPPORTED;
+
+    memset(&ds, 0, sizeof(ds));
+    if (3 != sscanf(desc, "%d:%d:%lu:%n", &cpid, &id, &size, &n) ||
+        0 == n || '\0' == desc[n]) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+    ds.seg_cpid = (pid_t)cpid;
+    ds.seg_id = id;
+    ds.seg_size = (size_t)size;
+    strncpy(ds.seg_name, desc + n, OPAL_PATH_MAX - 1);
+    OPAL_SHMEM_DS_SET_VALID(&ds);
+
+    if (NULL == (xml = (char*)opal_shmem_segment_attach(&ds))) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    if (0 != hwloc_topology_init(&opal_hwloc_topology)) {
+        opal_shmem_segment_detach(&ds);
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+    /* the daemon discovered this very node, so hwloc can trust it
+     * as if it had done the discovery itself
+     */
+    if (0 != hwloc_topology_set_xmlbuffer(opal_hwloc_topology, xml, strlen(xml)) ||
+        0 != hwloc_topology_set_flags(opal_hwloc_topology,
+                                      (HWLOC_TOPOLOGY_FLAG_IS_THISSYSTEM |
+                                       HWLOC_TOPOLOGY_FLAG_WHOLE_SYSTEM |
+                                       HWLOC_TOPOLOGY_FLAG_IO_DEVICES)) ||
+        0 != hwloc_topology_load(opal_hwloc_topology)) {
+        hwloc_topology_destroy(opal_hwloc_topology);
+        opal_hwloc_topology = NULL;
+        goto cleanup;
+    }
+
+    /* unlike set_topology, we know we can bind here */
+    support = (struct hwloc_topology_support*)hwloc_topology_get_support(opal_hwloc_topology);
+    support->cpubind->set_thisproc_cpubind = true;
+    support->membind->set_thisproc_membind = true;
+    rc = OPAL_SUCCESS;
+
+    OPAL_OUTPUT_VERBOSE((5, opal_hwloc_base_framework.framework_output,
+                         "hwloc:base:get_topology loaded shared topology from %s",
+                         ds.seg_name));
+
+ cleanup:
+    /* hwloc parsed its own copy, so we are done with the segment */
+    opal_shmem_segment_detach(&ds);
+    return rc;
+}
+
+int opal_hwloc_base_share_topology(const char *dir, char **descriptor)
+{
+    char *xml, *file, *addr;
+    int len, rc;
+
+    *descriptor = NULL;
+
+    /* all local procs share the same segment */
+    if (NULL != shared_topo_desc) {
+        *descriptor = strdup(shared_topo_desc);
+        return OPAL_SUCCESS;
+    }
+    if (NULL == opal_hwloc_topology || NULL == dir) {
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    if (0 != hwloc_topology_export_xmlbuffer(opal_hwloc_topology, &xml, &len)) {
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+    asprintf(&file, "%s/hwloc_topo.%lu", dir, (unsigned long)getpid());
+    rc = opal_shmem_segment_create(&shared_topo_ds, file, (size_t)len + 1);
+    free(file);
+    if (OPAL_SUCCESS != rc) {
+        free(xml);
+        return rc;
+    }
+    if (NULL == (addr = (char*)opal_shmem_segment_attach(&shared_topo_ds))) {
+        free(xml);
+        opal_shmem_unlink(&shared_topo_ds);
+        return OPAL_ERROR;
+    }
+    memcpy(addr, xml, len);
+    addr[len] = '\0';
+    free(xml);
+
+    asprintf(&shared_topo_desc, "%d:%d:%lu:%s",
+             (int)shared_topo_ds.seg_cpid, shared_topo_ds.seg_id,
+             (unsigned long)shared_topo_ds.seg_size, shared_topo_ds.seg_name);
+    *descriptor = strdup(shared_topo_desc);
+
+    OPAL_OUTPUT_VERBOSE((5, opal_hwloc_base_framework.framework_output,
+                         "hwloc:base:share_topology %d bytes in %s",
+                         len, shared_topo_ds.seg_name));
+    return OPAL_SUCCESS;
+}
+
+void opal_hwloc_base_unshare_topology(void)
+{
+    if (NULL == shared_topo_desc) {
+        return;
+    }
+    opal_shmem_unlink(&shared_topo_ds);
+    opal_shmem_segment_detach(&shared_topo_ds);
+    free(shared_topo_desc);
+    shared_topo_desc = NULL;
+}
+
 int opal_hwloc_base_get_topology(void)
 {
     int rc;
@@ -211,12 +415,18 @@ int opal_hwloc_base_get_topology(void)
     OPAL_OUTPUT_VERBOSE((5, opal_hwloc_base_framework.framework_output,
                          "hwloc:base:get_topology"));
 
-    if (0 != hwloc_topology_init(&opal_hwloc_topology) ||
-        0 != hwloc_topology_set_flags(opal_hwloc_topology, 
-                                      (HWLOC_TOPOLOGY_FLAG_WHOLE_SYSTEM |
-                                       HWLOC_TOPOLOGY_FLAG_IO_DEVICES)) ||
-        0 != hwloc_topology_load(opal_hwloc_topology)) {
-        return OPAL_ERR_NOT_SUPPORTED;
+    /* if our daemon already discovered the node, use its copy
+     * rather than have every local proc walk sysfs again
+     */
+    if (NULL == opal_hwloc_base_topo_shmem ||
+        OPAL_SUCCESS != import_shared_topology(opal_hwloc_base_topo_shmem)) {
+        if (0 != hwloc_topology_init(&opal_hwloc_topology) ||
+            0 != hwloc_topology_set_flags(opal_hwloc_topology, 
+                                          (HWLOC_TOPOLOGY_FLAG_WHOLE_SYSTEM |
+                                           HWLOC_TOPOLOGY_FLAG_IO_DEVICES)) ||
+            0 != hwloc_topology_load(opal_hwloc_topology)) {
+            return OPAL_ERR_NOT_SUPPORTED;
+        }
     }
 
     /* filter the cpus thru any default cpu set */
@@ -32,6 +32,6 @@ OPAL_DECLSPEC extern mca_base_framework_t opal_memcpy_base_framework;
 END_C_DECLS
 
 /* include implementation to call */
-#include MCA_timer_IMPLEMENTATION_HEADER
+#include MCA_memcpy_IMPLEMENTATION_HEADER
 
 #endif /* OPAL_BASE_MEMCPY_H */
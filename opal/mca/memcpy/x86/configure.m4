@@ -0,0 +1,77 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2004-2010 The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+AC_DEFUN([MCA_opal_memcpy_x86_PRIORITY], [30])
+
+AC_DEFUN([MCA_opal_memcpy_x86_COMPILE_MODE], [
+    AC_MSG_CHECKING([for MCA component $2:$3 compile mode])
+    $4="static"
+    AC_MSG_RESULT([$$4])
+])
+
+AC_DEFUN([MCA_opal_memcpy_x86_POST_CONFIG],[
+    AS_IF([test "$1" = "1"], [memcpy_base_include="x86/memcpy_x86.h"])
+])dnl
+
+# MCA_memcpy_x86_CONFIG(action-if-can-compile,
+#                       [action-if-cant-compile])
+# ------------------------------------------------
+# The component is built on IA32 / x86_64 when the compiler can
+# generate SSE2 streaming stores through the function "target"
+# attribute.  AVX and AVX-512F versions are added when the compiler
+# supports those targets; which one is used is decided at run time
+# from CPUID.
+AC_DEFUN([MCA_opal_memcpy_x86_CONFIG],[
+    AC_CONFIG_FILES([opal/mca/memcpy/x86/Makefile])
+
+    memcpy_x86_happy=0
+    memcpy_x86_have_avx=0
+    memcpy_x86_have_avx512f=0
+
+    case "$host" in
+        i?86-*|x86_64-*|amd64-*)
+            AC_CHECK_HEADERS([cpuid.h immintrin.h], [memcpy_x86_happy=1],
+                             [memcpy_x86_happy=0; break])
+            ;;
+    esac
+
+    AS_IF([test $memcpy_x86_happy -eq 1],
+          [_OPAL_MEMCPY_X86_CHECK_TARGET([sse2], [__m128i],
+               [_mm_stream_si128(p, a)], [], [memcpy_x86_happy=0])])
+    AS_IF([test $memcpy_x86_happy -eq 1],
+          [_OPAL_MEMCPY_X86_CHECK_TARGET([avx], [__m256i],
+               [_mm256_stream_si256(p, a)], [memcpy_x86_have_avx=1], [])
+           _OPAL_MEMCPY_X86_CHECK_TARGET([avx512f], [__m512i],
+               [_mm512_stream_si512(p, a)], [memcpy_x86_have_avx512f=1], [])])
+
+    AC_DEFINE_UNQUOTED([OPAL_MEMCPY_X86_HAVE_AVX], [$memcpy_x86_have_avx],
+                       [Whether the compiler can generate AVX streaming copies for the x86 memcpy component])
+    AC_DEFINE_UNQUOTED([OPAL_MEMCPY_X86_HAVE_AVX512F], [$memcpy_x86_have_avx512f],
+                       [Whether the compiler can generate AVX-512F streaming copies for the x86 memcpy component])
+
+    AS_IF([test $memcpy_x86_happy -eq 1], [$1], [$2])
+])dnl
+
+# _OPAL_MEMCPY_X86_CHECK_TARGET(target, vector type, expression,
+#                               [action-if-supported], [action-if-not])
+# ------------------------------------------------------------------------
+AC_DEFUN([_OPAL_MEMCPY_X86_CHECK_TARGET],[
+    AC_MSG_CHECKING([if $CC supports the $1 function target])
+    AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[#include <immintrin.h>
+__attribute__((__target__("$1"))) void memcpy_x86_test($2 *p, $2 a)
+{
+    $3;
+}]], [[]])],
+        [AC_MSG_RESULT([yes])
+         $4],
+        [AC_MSG_RESULT([no])
+         $5])
+])dnl
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2004-2010 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef OPAL_MCA_MEMCPY_X86_MEMCPY_X86_H
+#define OPAL_MCA_MEMCPY_X86_MEMCPY_X86_H
+
+#include "opal_config.h"
+
+#include <string.h>
+
+#include "opal/prefetch.h"
+
+BEGIN_C_DECLS
+
+/**
+ * Copies of at least this many bytes use non-temporal (streaming)
+ * stores, so that data the receiver will not touch soon does not evict
+ * its working set from the cache. Set at open time from the L2 cache
+ * size, SIZE_MAX as long as the component is not opened.
+ */
+OPAL_DECLSPEC extern size_t opal_memcpy_x86_nt_threshold;
+
+/**
+ * Streaming copy, the widest version (SSE2, AVX or AVX-512F) the CPU
+ * supports.
+ */
+OPAL_DECLSPEC extern void *(*opal_memcpy_x86_nt) (void *dst, const void *src, size_t length);
+
+static inline void *opal_memcpy_x86 (void *dst, const void *src, size_t length)
+{
+    if (OPAL_UNLIKELY(length >= opal_memcpy_x86_nt_threshold)) {
+        return opal_memcpy_x86_nt (dst, src, length);
+    }
+
+    /* libc already picks a vectorized copy for the cached case */
+    return memcpy (dst, src, length);
+}
+
+END_C_DECLS
+
+#define opal_memcpy( dst, src, length ) \
+    opal_memcpy_x86( (dst), (src), (length) )
+
+#define opal_memcpy_tov( dst_iov, src, count )        \
+    do {                                              \
+        int _i;                                       \
+        char* _src = (char*)src;                      \
+                                                      \
+        for( _i = 0; _i < count; _i++ ) {             \
+            opal_memcpy( dst_iov[_i].iov_base, _src,  \
+                         dst_iov[_i].iov_len );       \
+            _src += dst_iov[_i].iov_len;              \
+        }                                             \
+    } while (0)
+
+#define opal_memcpy_fromv( dst, src_iov, count )        \
+    do {                                                \
+        int _i;                                         \
+        char* _dst = (char*)dst;                        \
+                                                        \
+        for( _i = 0; _i < count; _i++ ) {               \
+            opal_memcpy( _dst, src_iov[_i].iov_base,    \
+                         src_iov[_i].iov_len );         \
+            _dst += src_iov[_i].iov_len;                \
+        }                                               \
+    } while (0)
+
+#endif /* OPAL_MCA_MEMCPY_X86_MEMCPY_X86_H */
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2004-2010 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Streaming (non-temporal) copies for x86. Copies larger than the L2
+ * cache go around the cache with SSE2, AVX or AVX-512F streaming
+ * stores, the widest one supported by both the compiler (through the
+ * function "target" attribute) and the CPU (CPUID). Smaller copies
+ * are left to libc.
+ */
+
+#include "opal_config.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <cpuid.h>
+#include <immintrin.h>
+
+#include "opal/constants.h"
+#include "opal/mca/memcpy/memcpy.h"
+#include "opal/mca/memcpy/base/base.h"
+#include "opal/mca/hwloc/hwloc.h"
+#include "opal/util/output.h"
+
+#define MEMCPY_X86_TARGET_sse2    __attribute__((__target__("sse2")))
+#define MEMCPY_X86_TARGET_avx     __attribute__((__target__("avx")))
+#define MEMCPY_X86_TARGET_avx512f __attribute__((__target__("avx512f")))
+
+/* used when the cache size cannot be found */
+#define MEMCPY_X86_DEFAULT_L2_SIZE (1024 * 1024)
+/* below this the cost of the sfence is not worth it */
+#define MEMCPY_X86_MIN_NT_THRESHOLD (64 * 1024)
+
+size_t opal_memcpy_x86_nt_threshold = SIZE_MAX;
+
+static int opal_memcpy_x86_register (void);
+static int opal_memcpy_x86_open (void);
+
+static void *memcpy_x86_nt_sse2 (void *dst, const void *src, size_t length);
+
+void *(*opal_memcpy_x86_nt) (void *dst, const void *src, size_t length) = memcpy_x86_nt_sse2;
+
+static int memcpy_x86_nt_enable = 1;
+static size_t memcpy_x86_user_threshold = 0;
+
+const opal_memcpy_base_component_2_0_0_t mca_memcpy_x86_component = {
+    /* First, the mca_component_t struct containing meta information
+       about the component itself */
+    {
+        OPAL_MEMCPY_BASE_VERSION_2_0_0,
+
+        /* Component name and version */
+        "x86",
+        OPAL_MAJOR_VERSION,
+        OPAL_MINOR_VERSION,
+        OPAL_RELEASE_VERSION,
+
+        /* Component open and close functions */
+        opal_memcpy_x86_open,
+        NULL,
+        NULL,
+        opal_memcpy_x86_register
+    },
+    {
+        /* The component is checkpoint ready */
+        MCA_BASE_METADATA_PARAM_CHECKPOINT
+    },
+};
+
+/*
+ * The streaming copies. The destination is first aligned on the vector
+ * size (streaming stores have to be aligned), the head and the tail are
+ * copied by libc.
+ */
+#define MEMCPY_X86_NT_BODY(VTYPE, VSIZE, LOAD, STORE)                    \
+    do {                                                                \
+        char *d = (char *) dst;                                         \
+        const char *s = (const char *) src;                             \
+        size_t head = (VSIZE - ((uintptr_t) d & (VSIZE - 1))) & (VSIZE - 1); \
+                                                                        \
+        if (head > length) {                                            \
+            head = length;                                              \
+        }                                                               \
+        memcpy (d, s, head);                                            \
+        d += head; s += head; length -= head;                           \
+                                                                        \
+        for ( ; length >= 4 * VSIZE ; length -= 4 * VSIZE) {            \
+            VTYPE v0 = LOAD ((const VTYPE *) s);                        \
+            VTYPE v1 = LOAD ((const VTYPE *) (s + VSIZE));              \
+            VTYPE v2 = LOAD ((const VTYPE *) (s + 2 * VSIZE));          \
+            VTYPE v3 = LOAD ((const VTYPE *) (s + 3 * VSIZE));          \
+            STORE ((VTYPE *) d, v0);                                    \
+            STORE ((VTYPE *) (d + VSIZE), v1);                          \
+            STORE ((VTYPE *) (d + 2 * VSIZE), v2);                      \
+            STORE ((VTYPE *) (d + 3 * VSIZE), v3);                      \
+            d += 4 * VSIZE; s += 4 * VSIZE;                             \
+        }                                                               \
+        /* the streaming stores are weakly ordered */                   \
+        _mm_sfence ();                                                  \
+                                                                        \
+        memcpy (d, s, length);                                          \
+        return dst;                                                     \
+    } while (0)
+
+static MEMCPY_X86_TARGET_sse2 void *memcpy_x86_nt_sse2 (void *dst, const void *src, size_t length)
+{
+    MEMCPY_X86_NT_BODY(__m128i, 16, _mm_loadu_si128, _mm_stream_si128);
+}
+
+#if OPAL_MEMCPY_X86_HAVE_AVX
+static MEMCPY_X86_TARGET_avx void *memcpy_x86_nt_avx (void *dst, const void *src, size_t length)
+{
+    MEMCPY_X86_NT_BODY(__m256i, 32, _mm256_loadu_si256, _mm256_stream_si256);
+}
+#endif
+
+#if OPAL_MEMCPY_X86_HAVE_AVX512F
+static MEMCPY_X86_TARGET_avx512f void *memcpy_x86_nt_avx512f (void *dst, const void *src, size_t length)
+{
+    MEMCPY_X86_NT_BODY(__m512i, 64, _mm512_loadu_si512, _mm512_stream_si512);
+}
+#endif
+
+static uint64_t memcpy_x86_xgetbv (void)
+{
+    uint32_t eax, edx;
+
+    __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return ((uint64_t) edx << 32) | eax;
+}
+
+/*
+ * Pick the widest streaming copy the CPU (and the OS) supports
+ */
+static void memcpy_x86_select_nt (void)
+{
+    unsigned int max_leaf, eax, ebx, ecx, edx;
+    uint64_t xcr0 = 0;
+
+    max_leaf = __get_cpuid_max (0, NULL);
+    if (max_leaf < 1) {
+        return;
+    }
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    /* AVX needs both the CPU bit and the OS to save the YMM state */
+    if (0 != (ecx & (1 << 27))) {
+        xcr0 = memcpy_x86_xgetbv ();
+    }
+    if (0 == (ecx & (1 << 28)) || 0x6 != (xcr0 & 0x6)) {
+        return;
+    }
+#if OPAL_MEMCPY_X86_HAVE_AVX
+    opal_memcpy_x86_nt = memcpy_x86_nt_avx;
+#endif
+
+#if OPAL_MEMCPY_X86_HAVE_AVX512F
+    if (max_leaf >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        if (0 != (ebx & (1 << 16)) && 0xe6 == (xcr0 & 0xe6)) {
+            opal_memcpy_x86_nt = memcpy_x86_nt_avx512f;
+        }
+    }
+#endif
+}
+
+/*
+ * Size of the L2 cache. Use the topology if it is already loaded (we do
+ * not want to load it this early), otherwise ask the CPU.
+ */
+static size_t memcpy_x86_l2_size (void)
+{
+    unsigned int max_leaf, eax, ebx, ecx, edx, i;
+
+#if OPAL_HAVE_HWLOC
+    if (NULL != opal_hwloc_topology) {
+        hwloc_obj_t obj;
+
+        for (obj = hwloc_get_next_obj_by_type (opal_hwloc_topology, HWLOC_OBJ_CACHE, NULL) ;
+             NULL != obj ; obj = hwloc_get_next_obj_by_type (opal_hwloc_topology, HWLOC_OBJ_CACHE, obj)) {
+            if (2 == obj->attr->cache.depth && 0 != obj->attr->cache.size) {
+                return (size_t) obj->attr->cache.size;
+            }
+        }
+    }
+#endif
+
+    /* Intel: deterministic cache parameters */
+    max_leaf = __get_cpuid_max (0, NULL);
+    if (max_leaf >= 4) {
+        for (i = 0 ; ; ++i) {
+            __cpuid_count(4, i, eax, ebx, ecx, edx);
+            if (0 == (eax & 0x1f)) {
+                break;
+            }
+            if (2 == ((eax >> 5) & 0x7)) {
+                return (size_t) ((ebx >> 22) + 1) * (((ebx >> 12) & 0x3ff) + 1) *
+                    ((ebx & 0xfff) + 1) * (ecx + 1);
+            }
+        }
+    }
+
+    /* AMD: L2 size in KB in the extended leaf */
+    if (__get_cpuid_max (0x80000000, NULL) >= 0x80000006) {
+        __cpuid(0x80000006, eax, ebx, ecx, edx);
+        if (0 != (ecx >> 16)) {
+            return (size_t) (ecx >> 16) * 1024;
+        }
+    }
+
+    return MEMCPY_X86_DEFAULT_L2_SIZE;
+}
+
+static int opal_memcpy_x86_register (void)
+{
+    memcpy_x86_nt_enable = 1;
+    (void) mca_base_component_var_register (&mca_memcpy_x86_component.memcpyc_version,
+                                            "nt_enable", "Use non-temporal (streaming) stores "
+                                            "for large copies (default: 1)",
+                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                            MCA_BASE_VAR_SCOPE_LOCAL, &memcpy_x86_nt_enable);
+
+    memcpy_x86_user_threshold = 0;
+    (void) mca_base_component_var_register (&mca_memcpy_x86_component.memcpyc_version,
+                                            "nt_threshold", "Size in bytes from which copies use "
+                                            "non-temporal stores (default: 0, the size of the L2 cache)",
+                                            MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                            MCA_BASE_VAR_SCOPE_LOCAL, &memcpy_x86_user_threshold);
+
+    return OPAL_SUCCESS;
+}
+
+static int opal_memcpy_x86_open (void)
+{
+    size_t threshold;
+
+    if (!memcpy_x86_nt_enable) {
+        opal_memcpy_x86_nt_threshold = SIZE_MAX;
+        return OPAL_SUCCESS;
+    }
+
+    memcpy_x86_select_nt ();
+
+    threshold = memcpy_x86_user_threshold;
+    if (0 == threshold) {
+        threshold = memcpy_x86_l2_size ();
+    }
+    if (threshold < MEMCPY_X86_MIN_NT_THRESHOLD) {
+        threshold = MEMCPY_X86_MIN_NT_THRESHOLD;
+    }
+    opal_memcpy_x86_nt_threshold = threshold;
+
+    opal_output_verbose (10, opal_memcpy_base_framework.framework_output,
+                         "memcpy:x86: using streaming stores for copies of %lu bytes or more",
+                         (unsigned long) threshold);
+
+    return OPAL_SUCCESS;
+}
@@ -32,7 +32,7 @@ AC_DEFUN([MCA_opal_memory_linux_COMPILE_MODE], [
 AC_DEFUN([MCA_opal_memory_linux_CONFIG],[
     AC_CONFIG_FILES([opal/mca/memory/linux/Makefile])
 
-    OPAL_VAR_SCOPE_PUSH([memory_linux_ptmalloc2_happy memory_linux_ummu_happy memory_linux_requested icc_major_ver icc_minor_ver memory_linux_mmap memory_linux_munmap memory_linux_LIBS_SAVE])
+    OPAL_VAR_SCOPE_PUSH([memory_linux_ptmalloc2_happy memory_linux_ummu_happy memory_linux_uffd_happy memory_linux_requested icc_major_ver icc_minor_ver memory_linux_mmap memory_linux_munmap memory_linux_LIBS_SAVE])
 
     # Only allow this component to build on Linux-based systems
 
@@ -42,24 +42,29 @@ AC_DEFUN([MCA_opal_memory_linux_CONFIG],[
         AC_MSG_RESULT([$host -- supported])
         memory_linux_ptmalloc2_happy=yes
         memory_linux_ummu_happy=yes
+        memory_linux_uffd_happy=yes
         ;;
     *)
         AC_MSG_RESULT([$host -- unsupported])
         memory_linux_ptmalloc2_happy=no
         memory_linux_ummu_happy=no
+        memory_linux_uffd_happy=no
         ;;
     esac
 
     AS_IF([test "$with_memory_manager" = "linux"],
           [memory_linux_ptmalloc2_happy=yes
            memory_linux_ummu_happy=yes
+           memory_linux_uffd_happy=yes
            memory_linux_requested=1],
           [memory_linux_requested=0
            AS_IF([test "$with_memory_manager" = "" -o "$with_memory_manager" = "yes"],
                  [memory_linux_ptmalloc2_happy=yes
-                  memory_linux_ummu_happy=yes],
+                  memory_linux_ummu_happy=yes
+                  memory_linux_uffd_happy=yes],
                  [memory_linux_ptmalloc2_happy=no
-                  memory_linux_ummu_happy=no])])
+                  memory_linux_ummu_happy=no
+                  memory_linux_uffd_happy=no])])
 
     ######################################################################
     # ptmalloc2
@@ -176,18 +181,48 @@ AC_DEFUN([MCA_opal_memory_linux_CONFIG],[
     AM_CONDITIONAL([MEMORY_LINUX_UMMUNOTIFY], 
                    [test "$memory_linux_ummu_happy" = yes])
 
+    ######################################################################
+    # userfaultfd
+    ######################################################################
+
+    # The unmap events need a service thread and the non-cooperative
+    # events of linux >= 4.11
+    AS_IF([test "$memory_linux_uffd_happy" = yes -a "$THREAD_TYPE" != "posix"],
+          [memory_linux_uffd_happy=no])
+    AS_IF([test "$memory_linux_uffd_happy" = yes],
+          [AC_CHECK_HEADER([linux/userfaultfd.h],
+                           [memory_linux_uffd_happy=yes],
+                           [memory_linux_uffd_happy=no])])
+    AS_IF([test "$memory_linux_uffd_happy" = yes],
+          [AC_CHECK_DECLS([UFFD_FEATURE_EVENT_UNMAP, __NR_userfaultfd],
+                          [],
+                          [memory_linux_uffd_happy=no],
+                          [#include <sys/syscall.h>
+                           #include <linux/userfaultfd.h>])])
+
+    AS_IF([test "$memory_linux_uffd_happy" = yes],
+          [memory_base_include="linux/public.h"
+           value=1],
+          [value=0])
+    AC_DEFINE_UNQUOTED([MEMORY_LINUX_USERFAULTFD], [$value],
+                       [Whether userfaultfd unmap events are supported on this system or not])
+    AM_CONDITIONAL([MEMORY_LINUX_USERFAULTFD],
+                   [test "$memory_linux_uffd_happy" = yes])
+
     ######################################################################
     # post processing
     ######################################################################
 
     AS_IF([test "$memory_malloc_hooks_requested" = 1 -a \
                 "$memory_linux_ptmalloc2_happy" = no -a \
-                "$memory_linux_ummu_happy" = no],
-          [AC_MSG_ERROR([linux memory management requested but neither ptmalloc2 nor ummunotify are available.  Aborting.])])
+                "$memory_linux_ummu_happy" = no -a \
+                "$memory_linux_uffd_happy" = no],
+          [AC_MSG_ERROR([linux memory management requested but none of ptmalloc2, ummunotify and userfaultfd are available.  Aborting.])])
     AC_SUBST([memory_linux_LIBS])
 
     AS_IF([test "$memory_linux_ptmalloc2_happy" = yes -o \
-                "$memory_linux_ummu_happy" = yes],
+                "$memory_linux_ummu_happy" = yes -o \
+                "$memory_linux_uffd_happy" = yes],
           [memory_base_found=1
            $1], 
           [memory_base_found=0
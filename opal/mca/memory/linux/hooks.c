@@ -768,6 +768,16 @@ void opal_memory_linux_malloc_init_hook(void)
         return;
     }
 
+    /* Same if the user asked for userfaultfd: the application keeps
+       its own allocator.  Whether the kernel allows it is only known
+       at open time; without it there is simply no memory manager. */
+#if MEMORY_LINUX_USERFAULTFD
+    r1 = check("OMPI_MCA_memory_linux_userfaultfd_enable");
+    if (RESULT_NOT_FOUND != r1 && RESULT_NO != r1) {
+        return;
+    }
+#endif
+
     /* Yes, checking for an MPI MCA parameter here is an abstraction
        violation.  Cope.  Yes, even checking for *any* MCA parameter
        here (without going through the MCA param API) is an
@@ -24,6 +24,7 @@ typedef struct opal_memory_linux_component_t {
     /* Component data */
     int verbose_level;
     int enable_ummunotify;
+    int enable_userfaultfd;
     int enable_ptmalloc2;
 
 #if MEMORY_LINUX_UMMUNOTIFY
@@ -31,6 +32,11 @@ typedef struct opal_memory_linux_component_t {
     int ummunotify_fd;
 #endif
 
+#if MEMORY_LINUX_USERFAULTFD
+    /* Userfaultfd-specific data */
+    int userfaultfd_fd;
+#endif
+
 #if MEMORY_LINUX_PTMALLOC2
     /* Ptmalloc2-specific data */
     bool free_invoked;
@@ -52,6 +58,12 @@ int opal_memory_linux_ummunotify_open(void);
 int opal_memory_linux_ummunotify_close(void);
 #endif /* MEMORY_LINUX_UMMUNOTIFY */
 
+#if MEMORY_LINUX_USERFAULTFD
+/* memory_linux_userfaultfd.c */
+int opal_memory_linux_userfaultfd_open(void);
+int opal_memory_linux_userfaultfd_close(void);
+#endif /* MEMORY_LINUX_USERFAULTFD */
+
 #if MEMORY_LINUX_PTMALLOC2
 /* memory_linux_ptmalloc2.c */
 int opal_memory_linux_ptmalloc2_open(void);
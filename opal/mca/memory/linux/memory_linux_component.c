@@ -20,22 +20,23 @@
  * $HEADER$
  */
 
-/* This component basically fronts two different memory management
-   schemes: the Linux "ummunotify" kernel module and hooking in a
-   substitute ptmalloc2 allocator.  Both of these mechanisms are
-   unified under a single component because the "memory" framework
-   both only allows one component to be selected, and that one
-   component must be compile-time linked into libopen-pal.  Hence, if
-   we want to try to use either one of these mechanisms, we have to
-   have them both in a single component.
+/* This component basically fronts three different memory management
+   schemes: the Linux "ummunotify" kernel module, the userfaultfd(2)
+   unmap events and hooking in a substitute ptmalloc2 allocator.  All
+   of these mechanisms are unified under a single component because
+   the "memory" framework both only allows one component to be
+   selected, and that one component must be compile-time linked into
+   libopen-pal.  Hence, if we want to try to use any one of these
+   mechanisms, we have to have them all in a single component.
 
    When using ptmalloc2, the goal of this component is to wholly
    replace the underlying allocator with our internal ptmalloc2
    allocator.  See the file README-open-mpi.txt for details of how it
    works. 
 
-   When using ummunotify, we can probe to find out when the MMU map
-   has been changed (i.e., memory has been released back to the OS). */
+   When using ummunotify or userfaultfd, we can probe to find out when
+   the MMU map has been changed (i.e., memory has been released back
+   to the OS), whatever allocator the application uses. */
 
 #include "opal_config.h"
 
@@ -57,12 +58,26 @@ static int linux_register(void);
 #if MEMORY_LINUX_UMMUNOTIFY
 static bool ummunotify_opened = false;
 #endif
+#if MEMORY_LINUX_USERFAULTFD
+static bool userfaultfd_opened = false;
+#endif
 #if MEMORY_LINUX_PTMALLOC2
 static bool ptmalloc2_opened = false;
 #endif
 
 bool opal_memory_linux_disable = false;
 
+/*
+ * Global variables (these need to be global variables rather than in
+ * the component struct because they are accessed in the
+ * opal_memory_changed() macro defined in public.h, and we don't want
+ * to have to include the component structure definition in public.h).
+ * The backend that notices unmaps points the counter at its own.
+ */
+uint64_t opal_memory_linux_counter_last_value = 0;
+volatile uint64_t *opal_memory_linux_counter = 
+    &opal_memory_linux_counter_last_value;
+
 opal_memory_linux_component_t mca_memory_linux_component = {
     /* First, the opal_memory_base_component_2_0_0_t */
     {
@@ -102,6 +117,7 @@ opal_memory_linux_component_t mca_memory_linux_component = {
 
 static bool ptmalloc2_available = MEMORY_LINUX_PTMALLOC2;
 static bool ummunotify_available = MEMORY_LINUX_UMMUNOTIFY;
+static bool userfaultfd_available = MEMORY_LINUX_USERFAULTFD;
 
 /*
  * Register MCA params
@@ -157,6 +173,29 @@ static int linux_register(void)
         return ret;
     }
 
+    ret = mca_base_component_var_register (&mca_memory_linux_component.super.memoryc_version,
+                                           "userfaultfd_available",
+                                           "Whether userfaultfd support is included in Open MPI or not (1 = yes, 0 = no)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_3,
+                                           MCA_BASE_VAR_SCOPE_CONSTANT,
+                                           &userfaultfd_available);
+    if (0 > ret) {
+        return ret;
+    }
+
+    mca_memory_linux_component.enable_userfaultfd = 0;
+    ret = mca_base_component_var_register (&mca_memory_linux_component.super.memoryc_version,
+                                           "userfaultfd_enable",
+                                           "Whether to track the unmapping of registered memory with userfaultfd instead of the ptmalloc2 hooks, so that the application may use its own allocator (negative = try to enable, but continue even if support is not available, 0 = do not enable support, positive = try to enable and fail if support is not available).  Set it **VIA ENVIRONMENT VARIABLE** to also keep ptmalloc2 from being hooked in at startup",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_3,
+                                           MCA_BASE_VAR_SCOPE_ALL_EQ,
+                                           &mca_memory_linux_component.enable_userfaultfd);
+    if (0 > ret) {
+        return ret;
+    }
+
     opal_memory_linux_disable = false;
     (void) mca_base_component_var_register (&mca_memory_linux_component.super.memoryc_version,
                                             "disable",
@@ -199,6 +238,24 @@ static int linux_open(void)
     }
 #endif
 
+#if MEMORY_LINUX_USERFAULTFD
+    if (mca_memory_linux_component.enable_userfaultfd) {
+        if (mca_memory_linux_component.verbose_level >= 10) {
+            opal_output(0, "memory:linux: attempting to initialize userfaultfd support");
+        }
+        if (OPAL_SUCCESS == opal_memory_linux_userfaultfd_open()) {
+            userfaultfd_opened = true;
+            if (mca_memory_linux_component.verbose_level >= 10) {
+                opal_output(0, "memory:linux: userfaultfd successfully initialized; we'll use that");
+            }
+            return OPAL_SUCCESS;
+        }
+        if (mca_memory_linux_component.verbose_level >= 10) {
+            opal_output(0, "memory:linux: userfaultfd failed to initialize");
+        }
+    }
+#endif
+
 #if MEMORY_LINUX_PTMALLOC2
     if (mca_memory_linux_component.enable_ptmalloc2) {
         if (mca_memory_linux_component.verbose_level >= 10) {
@@ -240,6 +297,15 @@ static int linux_close(void)
         ummunotify_opened = false;
     }
 #endif
+#if MEMORY_LINUX_USERFAULTFD
+    if (userfaultfd_opened) {
+        if (v >= 10) {
+            opal_output(0, "memory:linux: shutting down userfaultfd support");
+        }
+        opal_memory_linux_userfaultfd_close();
+        userfaultfd_opened = false;
+    }
+#endif
 #if MEMORY_LINUX_PTMALLOC2
     if (ptmalloc2_opened) {
         if (v >= 10) {
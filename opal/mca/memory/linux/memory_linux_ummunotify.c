@@ -61,25 +61,14 @@ static int ummunotify_deregister(void *start, size_t len, uint64_t cookie);
 static bool initialized = false;
 
 
-/*
- * Global variables (these need to be global variables rather than in
- * the component struct because they are accessed in the
- * opal_memory_changed() macro defined in public.h, and we don't want
- * to have to include the component structure definition in public.h).
- */
-uint64_t opal_memory_linux_ummunotify_counter_last_value = 0;
-volatile uint64_t *opal_memory_linux_ummunotify_counter = 
-    &opal_memory_linux_ummunotify_counter_last_value;
-
-
 int opal_memory_linux_ummunotify_open(void)
 {
     uint64_t *p;
 
     /* Just to be safe... */
-    opal_memory_linux_ummunotify_counter_last_value = 0;
-    opal_memory_linux_ummunotify_counter =
-        &opal_memory_linux_ummunotify_counter_last_value;
+    opal_memory_linux_counter_last_value = 0;
+    opal_memory_linux_counter =
+        &opal_memory_linux_counter_last_value;
 
     /* Open the device.  Try to give a meaningful error message if
        we're unable to open it. */
@@ -105,15 +94,15 @@ int opal_memory_linux_ummunotify_open(void)
         return OPAL_ERR_NOT_SUPPORTED;
     }
 
-    p = mmap(NULL, sizeof(*opal_memory_linux_ummunotify_counter), 
+    p = mmap(NULL, sizeof(*opal_memory_linux_counter), 
              PROT_READ, MAP_SHARED, 
              mca_memory_linux_component.ummunotify_fd, 0);
-    if (MAP_FAILED == opal_memory_linux_ummunotify_counter) {
+    if (MAP_FAILED == opal_memory_linux_counter) {
         close(mca_memory_linux_component.ummunotify_fd);
         mca_memory_linux_component.ummunotify_fd = -1;
         return OPAL_ERR_NOT_SUPPORTED;
     }
-    opal_memory_linux_ummunotify_counter = p;
+    opal_memory_linux_counter = p;
 
     /* If everything went well, tell OMPI that we have full support
        for the memory hooks and fill in the component function
@@ -140,12 +129,12 @@ int opal_memory_linux_ummunotify_open(void)
 int opal_memory_linux_ummunotify_close(void)
 {
     if (initialized && mca_memory_linux_component.ummunotify_fd >= 0) {
-        munmap((void*) opal_memory_linux_ummunotify_counter, 
-               sizeof(*opal_memory_linux_ummunotify_counter));
+        munmap((void*) opal_memory_linux_counter, 
+               sizeof(*opal_memory_linux_counter));
         close(mca_memory_linux_component.ummunotify_fd);
         mca_memory_linux_component.ummunotify_fd = -1;
-        opal_memory_linux_ummunotify_counter =
-            &opal_memory_linux_ummunotify_counter_last_value;
+        opal_memory_linux_counter =
+            &opal_memory_linux_counter_last_value;
         initialized = false;
     }
 
@@ -183,11 +172,11 @@ static int ummunotify_process(void)
                 break;
 
             case UMMUNOTIFY_EVENT_TYPE_LAST:
-                opal_memory_linux_ummunotify_counter_last_value = 
+                opal_memory_linux_counter_last_value = 
                     events[i].user_cookie_counter;
                 /* Are there more events to read? */
-                if (opal_memory_linux_ummunotify_counter_last_value ==
-                    *opal_memory_linux_ummunotify_counter) {
+                if (opal_memory_linux_counter_last_value ==
+                    *opal_memory_linux_counter) {
                     OPAL_OUTPUT((-1, "ummunot: LAST; done"));
                     return OPAL_SUCCESS;
                 }
@@ -0,0 +1,355 @@
+/*
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/* Registration cache coherency through userfaultfd(2), for processes
+   that keep their own allocator (no ptmalloc2 hooks) on kernels
+   without the ummunotify module.
+
+   Every registered range is also registered with a userfaultfd that
+   asks for the UNMAP, REMOVE (madvise(MADV_DONTNEED) and friends) and
+   REMAP events.  The kernel holds the unmapping thread until the
+   event has been read, so a service thread reads them: it bumps the
+   counter of opal_memory_changed() *before* reading (the unmapping
+   call cannot have returned yet) and queues the ranges under the
+   lock that userfaultfd_process() takes to drain them, so that the
+   rcache never looks up a range that was unmapped without seeing it.
+
+   The ranges are registered in "missing" mode, the only one all
+   kernels with the events have: a page of a registered range that
+   was dropped faults to the service thread on the next touch, which
+   maps a zero page, as the kernel would have done. */
+
+#include "opal_config.h"
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+
+#include <linux/userfaultfd.h>
+
+#include "opal_stdint.h"
+#include "opal/constants.h"
+#include "opal/util/output.h"
+#include "opal/util/show_help.h"
+#include "opal/threads/threads.h"
+#include "opal/sys/atomic.h"
+#include "opal/mca/memory/memory.h"
+#include "opal/memoryhooks/memory.h"
+#include "opal/memoryhooks/memory_internal.h"
+
+#include "opal/mca/memory/linux/memory_linux.h"
+#include "opal/mca/memory/linux/public.h"
+
+/* Unmapped ranges waiting for userfaultfd_process(); when full, the
+   last one grows to cover the new ones */
+#define UFFD_MAX_RANGES 64
+
+typedef struct {
+    uintptr_t start;
+    uintptr_t end;
+} uffd_range_t;
+
+
+/*
+ * Local functions
+ */
+static int userfaultfd_process(void);
+static int userfaultfd_register(void *start, size_t len, uint64_t cookie);
+static int userfaultfd_deregister(void *start, size_t len, uint64_t cookie);
+static void *userfaultfd_thread(opal_object_t *obj);
+
+
+/*
+ * Local variables
+ */
+static bool initialized = false;
+static volatile uint64_t uffd_counter = 0;
+static int uffd_pipe[2] = { -1, -1 };
+static opal_thread_t uffd_thread;
+static opal_mutex_t uffd_lock;
+static uffd_range_t uffd_ranges[UFFD_MAX_RANGES];
+static int uffd_num_ranges = 0;
+static long uffd_page_size;
+
+
+int opal_memory_linux_userfaultfd_open(void)
+{
+    struct uffdio_api api;
+    int fd = -1;
+
+    uffd_page_size = sysconf(_SC_PAGESIZE);
+
+#ifdef UFFD_USER_MODE_ONLY
+    /* Unprivileged processes may only trap their own faults */
+    fd = syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY);
+#endif
+    if (fd < 0) {
+        fd = syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK);
+    }
+    if (fd < 0) {
+        if (EPERM == errno || EACCES == errno) {
+            char hostname[HOST_NAME_MAX];
+            gethostname(hostname, sizeof(hostname));
+            opal_show_help("help-opal-memory-linux.txt",
+                           "userfaultfd eperm", true, hostname);
+        }
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    memset(&api, 0, sizeof(api));
+    api.api = UFFD_API;
+    api.features = UFFD_FEATURE_EVENT_UNMAP | UFFD_FEATURE_EVENT_REMOVE |
+        UFFD_FEATURE_EVENT_REMAP;
+    if (0 != ioctl(fd, UFFDIO_API, &api)) {
+        /* The kernel is too old for the non-cooperative events */
+        close(fd);
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+
+    if (0 != pipe(uffd_pipe)) {
+        close(fd);
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+    mca_memory_linux_component.userfaultfd_fd = fd;
+
+    uffd_counter = 0;
+    uffd_num_ranges = 0;
+    opal_memory_linux_counter_last_value = 0;
+    OBJ_CONSTRUCT(&uffd_lock, opal_mutex_t);
+    OBJ_CONSTRUCT(&uffd_thread, opal_thread_t);
+    uffd_thread.t_run = userfaultfd_thread;
+    uffd_thread.t_arg = NULL;
+    if (OPAL_SUCCESS != opal_thread_start(&uffd_thread)) {
+        OBJ_DESTRUCT(&uffd_thread);
+        OBJ_DESTRUCT(&uffd_lock);
+        close(uffd_pipe[0]);
+        close(uffd_pipe[1]);
+        uffd_pipe[0] = uffd_pipe[1] = -1;
+        close(fd);
+        mca_memory_linux_component.userfaultfd_fd = -1;
+        return OPAL_ERR_NOT_SUPPORTED;
+    }
+    opal_memory_linux_counter = &uffd_counter;
+
+    /* Tell OMPI that we have full support for the memory hooks and
+       fill in the component function pointers */
+    opal_mem_hooks_set_support(OPAL_MEMORY_FREE_SUPPORT |
+                               OPAL_MEMORY_CHUNK_SUPPORT |
+                               OPAL_MEMORY_MUNMAP_SUPPORT);
+    mca_memory_linux_component.super.memoryc_process = userfaultfd_process;
+    mca_memory_linux_component.super.memoryc_register = userfaultfd_register;
+    mca_memory_linux_component.super.memoryc_deregister = userfaultfd_deregister;
+    initialized = true;
+
+    return OPAL_SUCCESS;
+}
+
+
+/*
+ * Called during opal_finalize.  Closing the userfaultfd drops all the
+ * registrations, so the application runs on unaffected afterwards.
+ */
+int opal_memory_linux_userfaultfd_close(void)
+{
+    char c = 0;
+
+    if (initialized) {
+        initialized = false;
+        (void) write(uffd_pipe[1], &c, 1);
+        opal_thread_join(&uffd_thread, NULL);
+        OBJ_DESTRUCT(&uffd_thread);
+        OBJ_DESTRUCT(&uffd_lock);
+        close(uffd_pipe[0]);
+        close(uffd_pipe[1]);
+        uffd_pipe[0] = uffd_pipe[1] = -1;
+        close(mca_memory_linux_component.userfaultfd_fd);
+        mca_memory_linux_component.userfaultfd_fd = -1;
+        opal_memory_linux_counter =
+            &opal_memory_linux_counter_last_value;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+/* with uffd_lock held */
+static void queue_range(uintptr_t start, uintptr_t end)
+{
+    uffd_range_t *r;
+
+    if (uffd_num_ranges < UFFD_MAX_RANGES) {
+        r = &uffd_ranges[uffd_num_ranges++];
+        r->start = start;
+        r->end = end;
+        return;
+    }
+
+    r = &uffd_ranges[UFFD_MAX_RANGES - 1];
+    if (start < r->start) {
+        r->start = start;
+    }
+    if (end > r->end) {
+        r->end = end;
+    }
+}
+
+static void *userfaultfd_thread(opal_object_t *obj)
+{
+    int fd = mca_memory_linux_component.userfaultfd_fd;
+    struct pollfd pfd[2];
+    struct uffd_msg msg[16];
+    struct uffdio_zeropage zp;
+    int n, i;
+
+    pfd[0].fd = fd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = uffd_pipe[0];
+    pfd[1].events = POLLIN;
+
+    while (true) {
+        n = poll(pfd, 2, -1);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            break;
+        }
+        if (pfd[1].revents) {
+            break;
+        }
+        if (!(pfd[0].revents & POLLIN)) {
+            continue;
+        }
+
+        opal_mutex_lock(&uffd_lock);
+        ++uffd_counter;
+        opal_atomic_wmb();
+
+        while ((n = read(fd, msg, sizeof(msg))) > 0) {
+            for (i = 0; i < n / (int) sizeof(msg[0]); ++i) {
+                switch (msg[i].event) {
+                case UFFD_EVENT_UNMAP:
+                case UFFD_EVENT_REMOVE:
+                    OPAL_OUTPUT((-1, "userfaultfd: invalidate start %p, end %p",
+                                 (void*) (uintptr_t) msg[i].arg.remove.start,
+                                 (void*) (uintptr_t) msg[i].arg.remove.end));
+                    queue_range((uintptr_t) msg[i].arg.remove.start,
+                                (uintptr_t) msg[i].arg.remove.end);
+                    break;
+
+                case UFFD_EVENT_REMAP:
+                    queue_range((uintptr_t) msg[i].arg.remap.from,
+                                (uintptr_t) (msg[i].arg.remap.from + msg[i].arg.remap.len));
+                    break;
+
+                case UFFD_EVENT_PAGEFAULT:
+                    /* touch of a page dropped from a registered range */
+                    zp.range.start = msg[i].arg.pagefault.address &
+                        ~((uint64_t) uffd_page_size - 1);
+                    zp.range.len = uffd_page_size;
+                    zp.mode = 0;
+                    if (0 != ioctl(fd, UFFDIO_ZEROPAGE, &zp) && EEXIST != errno) {
+                        /* do not leave the faulting thread hanging */
+                        struct uffdio_range range = zp.range;
+                        (void) ioctl(fd, UFFDIO_WAKE, &range);
+                    }
+                    break;
+                }
+            }
+        }
+
+        opal_mutex_unlock(&uffd_lock);
+    }
+
+    return NULL;
+}
+
+/*
+ * Called when opal_memory_changed() returns 1
+ */
+static int userfaultfd_process(void)
+{
+    uffd_range_t ranges[UFFD_MAX_RANGES];
+    int i, n;
+
+    if (!initialized) {
+        return OPAL_SUCCESS;
+    }
+
+    /* The hooks may unmap memory themselves, whose event the service
+       thread must be able to read: call them without the lock */
+    opal_mutex_lock(&uffd_lock);
+    n = uffd_num_ranges;
+    memcpy(ranges, uffd_ranges, n * sizeof(ranges[0]));
+    uffd_num_ranges = 0;
+    opal_memory_linux_counter_last_value = uffd_counter;
+    opal_mutex_unlock(&uffd_lock);
+
+    for (i = 0; i < n; ++i) {
+        /* 0 => this callback did not come from malloc */
+        opal_mem_hooks_release_hook((void *) ranges[i].start,
+                                    ranges[i].end - ranges[i].start, 0);
+    }
+
+    return OPAL_SUCCESS;
+}
+
+static int userfaultfd_register(void *start, size_t len, uint64_t cookie)
+{
+    struct uffdio_register r;
+    uintptr_t base = (uintptr_t) start & ~((uintptr_t) uffd_page_size - 1);
+    uintptr_t bound = ((uintptr_t) start + len + uffd_page_size - 1) &
+        ~((uintptr_t) uffd_page_size - 1);
+
+    if (!initialized) {
+        return OPAL_SUCCESS;
+    }
+
+    r.range.start = base;
+    r.range.len = bound - base;
+    r.mode = UFFDIO_REGISTER_MODE_MISSING;
+
+    OPAL_OUTPUT((-1, "userfaultfd: register %p - %p",
+                 (void*) base, (void*) bound));
+    if (0 != ioctl(mca_memory_linux_component.userfaultfd_fd,
+                   UFFDIO_REGISTER, &r)) {
+        /* Mappings of regular files cannot be registered, their
+           munmap() is still seen through the munmap hook */
+        OPAL_OUTPUT((-1, "Error in ioctl register: %s", strerror(errno)));
+        return OPAL_ERR_IN_ERRNO;
+    }
+
+    return OPAL_SUCCESS;
+}
+
+static int userfaultfd_deregister(void *start, size_t len, uint64_t cookie)
+{
+    struct uffdio_range r;
+    uintptr_t base = (uintptr_t) start & ~((uintptr_t) uffd_page_size - 1);
+    uintptr_t bound = ((uintptr_t) start + len + uffd_page_size - 1) &
+        ~((uintptr_t) uffd_page_size - 1);
+
+    if (!initialized) {
+        return OPAL_SUCCESS;
+    }
+
+    r.start = base;
+    r.len = bound - base;
+
+    OPAL_OUTPUT((-1, "userfaultfd: deregister %p - %p",
+                 (void*) base, (void*) bound));
+    /* The range may already be gone, which is fine */
+    (void) ioctl(mca_memory_linux_component.userfaultfd_fd,
+                 UFFDIO_UNREGISTER, &r);
+
+    return OPAL_SUCCESS;
+}
@@ -14,11 +14,13 @@
 
 #include <sys/types.h>
 
-OPAL_DECLSPEC extern volatile uint64_t *opal_memory_linux_ummunotify_counter;
-OPAL_DECLSPEC extern uint64_t opal_memory_linux_ummunotify_counter_last_value;
+/* Bumped by the ummunotify device or the userfaultfd thread when a
+   registered range was unmapped */
+OPAL_DECLSPEC extern volatile uint64_t *opal_memory_linux_counter;
+OPAL_DECLSPEC extern uint64_t opal_memory_linux_counter_last_value;
 
 #define opal_memory_changed() \
-    (opal_memory_linux_ummunotify_counter_last_value != \
-     *opal_memory_linux_ummunotify_counter)
+    (opal_memory_linux_counter_last_value != \
+     *opal_memory_linux_counter)
 
 #endif
@@ -40,6 +40,7 @@
 
 #include <sys/param.h>  /* for HZ to convert jiffies to actual time */
 
+#include "opal/class/opal_hash_table.h"
 #include "opal/dss/dss_types.h"
 #include "opal/util/argv.h"
 #include "opal/util/printf.h"
@@ -67,6 +68,32 @@ const opal_pstat_base_module_t opal_pstat_linux_module = {
 
 #define OPAL_STAT_MAX_LENGTH   1024
 
+/* positions of the /proc/<pid>/stat fields we use, numbered as in proc(5) */
+#define OPAL_STAT_FIRST_NUMERIC   4
+#define OPAL_STAT_MINFLT         10
+#define OPAL_STAT_MAJFLT         12
+#define OPAL_STAT_UTIME          14
+#define OPAL_STAT_STIME          15
+#define OPAL_STAT_PRIORITY       18
+#define OPAL_STAT_NUM_THREADS    20
+#define OPAL_STAT_VSIZE          23
+#define OPAL_STAT_RSS            24
+#define OPAL_STAT_PROCESSOR      39
+
+/* flush the descriptor cache when it grows past this many pids - the
+ * entries of procs that exited and were never queried again would
+ * otherwise stay open forever in a long-lived daemon
+ */
+#define OPAL_STAT_MAX_CACHED_PIDS 4096
+
+/* descriptors for the /proc files of a pid, kept open across samples so
+ * that each sample costs a pread instead of an open/read/close
+ */
+typedef struct {
+    int stat_fd;
+    int status_fd;
+} pstat_linux_pid_files_t;
+
 /* Local functions */
 static char *local_getline(FILE *fp);
 static char *local_stripper(char *data);
@@ -74,17 +101,128 @@ static void local_getfields(char *data, char ***fields);
 
 /* Local data */
 static char input[OPAL_STAT_MAX_LENGTH];
+static opal_hash_table_t pid_files;
+static size_t num_pid_files = 0;
+static long page_size = 4096;
 
 static int linux_module_init(void)
 {
+    OBJ_CONSTRUCT(&pid_files, opal_hash_table_t);
+    opal_hash_table_init(&pid_files, 256);
+    num_pid_files = 0;
+    if (0 >= (page_size = sysconf(_SC_PAGESIZE))) {
+        page_size = 4096;
+    }
     return OPAL_SUCCESS;
 }
 
+static void close_pid_files(pstat_linux_pid_files_t *pf)
+{
+    if (0 <= pf->stat_fd) {
+        close(pf->stat_fd);
+    }
+    if (0 <= pf->status_fd) {
+        close(pf->status_fd);
+    }
+    free(pf);
+}
+
+static void flush_pid_files(void)
+{
+    uint32_t key;
+    void *value, *node, *next;
+    int rc;
+
+    rc = opal_hash_table_get_first_key_uint32(&pid_files, &key, &value, &node);
+    while (OPAL_SUCCESS == rc) {
+        close_pid_files((pstat_linux_pid_files_t*)value);
+        rc = opal_hash_table_get_next_key_uint32(&pid_files, &key, &value, node, &next);
+        node = next;
+    }
+    opal_hash_table_remove_all(&pid_files);
+    num_pid_files = 0;
+}
+
 static int linux_module_fini(void)
 {
+    flush_pid_files();
+    OBJ_DESTRUCT(&pid_files);
     return OPAL_SUCCESS;
 }
 
+static pstat_linux_pid_files_t *get_pid_files(pid_t pid)
+{
+    pstat_linux_pid_files_t *pf;
+
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint32(&pid_files, (uint32_t)pid, (void**)&pf)) {
+        return pf;
+    }
+    if (OPAL_STAT_MAX_CACHED_PIDS <= num_pid_files) {
+        flush_pid_files();
+    }
+    if (NULL == (pf = (pstat_linux_pid_files_t*)malloc(sizeof(pstat_linux_pid_files_t)))) {
+        return NULL;
+    }
+    pf->stat_fd = -1;
+    pf->status_fd = -1;
+    opal_hash_table_set_value_uint32(&pid_files, (uint32_t)pid, pf);
+    num_pid_files++;
+    return pf;
+}
+
+static void release_pid_files(pid_t pid, pstat_linux_pid_files_t *pf)
+{
+    opal_hash_table_remove_value_uint32(&pid_files, (uint32_t)pid);
+    close_pid_files(pf);
+    num_pid_files--;
+}
+
+/* read the whole of /proc/<pid>/<name> into data, opening it on
+ * first use. A descriptor whose proc has gone away fails the read
+ * and is closed so a later proc with a recycled pid is reopened.
+ */
+static int read_proc_file(int *fd, pid_t pid, const char *name,
+                          char *data, size_t size)
+{
+    char path[64];
+    ssize_t len;
+
+    if (0 > *fd) {
+        snprintf(path, sizeof(path), "/proc/%d/%s", (int)pid, name);
+        if (0 > (*fd = open(path, O_RDONLY))) {
+            return -1;
+        }
+    }
+    if (0 >= (len = pread(*fd, data, size-1, 0))) {
+        close(*fd);
+        *fd = -1;
+        return -1;
+    }
+    data[len] = '\0';
+    return (int)len;
+}
+
+/* return a pointer to the value of the status line starting with key */
+static char *status_value(char *data, const char *key)
+{
+    size_t klen = strlen(key);
+    char *ptr = data;
+
+    while (NULL != ptr && '\0' != *ptr) {
+        if (0 == strncmp(ptr, key, klen)) {
+            ptr += klen;
+            while (isspace(*ptr)) {
+                ptr++;
+            }
+            return ptr;
+        }
+        if (NULL != (ptr = strchr(ptr, '\n'))) {
+            ptr++;
+        }
+    }
+    return NULL;
+}
+
 static char *next_field(char *ptr, int barrier)
 {
     int i=0;
@@ -126,14 +264,16 @@ static int query(pid_t pid,
 {
     char data[4096];
     int fd;
-    size_t numchars;
     char *ptr, *eptr;
     int i;
-    int len, itime;
+    int len;
+    int64_t itime;
     double dtime;
     FILE *fp;
     char *dptr, *value;
     char **fields;
+    int64_t sf[OPAL_STAT_PROCESSOR+1];
+    pstat_linux_pid_files_t *pf;
     opal_diskstats_t *ds;
     opal_netstats_t *ns;
 
@@ -153,42 +293,25 @@ static int query(pid_t pid,
     }
 
     if (NULL != stats) {
-        /* create the stat filename for this proc */
-        numchars = snprintf(data, sizeof(data), "/proc/%d/stat", pid);
-        if (numchars >= sizeof(data)) {
-            return OPAL_ERR_VALUE_OUT_OF_BOUNDS;
+        /* the stat file consists of a single line in a carefully formatted
+         * form. Read it through the cached descriptor in one gulp and parse
+         * it field by field as per proc(5) - no stdio, no line splitting
+         */
+        if (NULL == (pf = get_pid_files(pid))) {
+            return OPAL_ERR_OUT_OF_RESOURCE;
         }
-    
-        if (0 > (fd = open(data, O_RDONLY))) {
+        if (0 > (len = read_proc_file(&pf->stat_fd, pid, "stat", data, sizeof(data)))) {
             /* can't access this file - most likely, this means we
              * aren't really on a supported system, or the proc no
              * longer exists. Just return an error
              */
+            release_pid_files(pid, pf);
             return OPAL_ERR_FILE_OPEN_FAILURE;
         }
-    
-        /* absorb all of the file's contents in one gulp - we'll process
-         * it once it is in memory for speed
-         */
-        memset(data, 0, sizeof(data));
-        len = read(fd, data, sizeof(data)-1);
-        if (len < 0) {
-            /* This shouldn't happen! */
-            close(fd);
-            return OPAL_ERR_FILE_OPEN_FAILURE;
-        }
-        close(fd);
-    
-        /* remove newline at end */
-        data[len] = '\0';
-    
-        /* the stat file consists of a single line in a carefully formatted
-         * form. Parse it field by field as per proc(3) to get the ones we want
-         */
-    
+
         /* we don't need to read the pid from the file - we already know it! */
         stats->pid = pid;
-    
+
         /* the cmd is surrounded by parentheses - find the start */
         if (NULL == (ptr = strchr(data, '('))) {
             /* no cmd => something wrong with data, return error */
@@ -196,119 +319,70 @@ static int query(pid_t pid,
         }
         /* step over the paren */
         ptr++;
-    
-        /* find the ending paren */
-        if (NULL == (eptr = strchr(ptr, ')'))) {
+
+        /* find the ending paren - the cmd itself may contain one */
+        if (NULL == (eptr = strrchr(ptr, ')'))) {
             /* no end to cmd => something wrong with data, return error */
             return OPAL_ERR_BAD_PARAM;
         }
-    
+
         /* save the cmd name, up to the limit of the array */
         i = 0;
         while (ptr < eptr && i < OPAL_PSTAT_MAX_STRING_LEN) {
             stats->cmd[i++] = *ptr++;
         }
-    
-        /* move to the next field in the data */
-        ptr = next_field(eptr, len);
-    
+
         /* next is the process state - a single character */
-        stats->state[0] = *ptr;
-        /* move to next field */
-        ptr = next_field(ptr, len);
-    
-        /* skip fields until we get to the times */
-        ptr = next_field(ptr, len); /* ppid */
-        ptr = next_field(ptr, len); /* pgrp */
-        ptr = next_field(ptr, len); /* session */
-        ptr = next_field(ptr, len); /* tty_nr */
-        ptr = next_field(ptr, len); /* tpgid */
-        ptr = next_field(ptr, len); /* flags */
-        ptr = next_field(ptr, len); /* minflt */
-        ptr = next_field(ptr, len); /* cminflt */
-        ptr = next_field(ptr, len); /* majflt */
-        ptr = next_field(ptr, len); /* cmajflt */
-    
+        ptr = eptr + 1;
+        while (isspace(*ptr)) {
+            ptr++;
+        }
+        stats->state[0] = *ptr++;
+
+        /* everything after the state is numeric - convert the fields
+         * we need in one pass, numbering them as in proc(5)
+         */
+        memset(fields, 0, sizeof(sf));
+        for (i=OPAL_STAT_FIRST_NUMERIC; i <= OPAL_STAT_PROCESSOR; i++) {
+            sf[i] = strtoll(ptr, &eptr, 10);
+            if (eptr == ptr) {
+                /* older kernels don't provide all the fields */
+                break;
+            }
+            ptr = eptr;
+        }
+
+        stats->minor_faults = (uint64_t)sf[OPAL_STAT_MINFLT];
+        stats->major_faults = (uint64_t)sf[OPAL_STAT_MAJFLT];
         /* grab the process time usage fields */
-        itime = strtoul(ptr, &ptr, 10);    /* utime */
-        itime += strtoul(ptr, &ptr, 10);   /* add the stime */
+        itime = sf[OPAL_STAT_UTIME] + sf[OPAL_STAT_STIME];
         /* convert to time in seconds */
         dtime = (double)itime / (double)HZ;
         stats->time.tv_sec = (int)dtime;
         stats->time.tv_usec = (int)(1000000.0 * (dtime - stats->time.tv_sec));
-        /* move to next field */
-        ptr = next_field(ptr, len);
-    
-        /* skip fields until we get to priority */
-        ptr = next_field(ptr, len); /* cutime */
-        ptr = next_field(ptr, len); /* cstime */
-    
-        /* save the priority */
-        stats->priority = strtol(ptr, &ptr, 10);
-        /* move to next field */
-        ptr = next_field(ptr, len);
-    
-        /* skip nice */
-        ptr = next_field(ptr, len);
-
-        /* get number of threads */
-        stats->num_threads = strtoul(ptr, &ptr, 10);
-        /* move to next field */
-        ptr = next_field(ptr, len);
-
-        /* skip fields until we get to processor id */
-        ptr = next_field(ptr, len);  /* itrealvalue */
-        ptr = next_field(ptr, len);  /* starttime */
-        ptr = next_field(ptr, len);  /* vsize */
-        ptr = next_field(ptr, len);  /* rss */
-        ptr = next_field(ptr, len);  /* rss limit */
-        ptr = next_field(ptr, len);  /* startcode */
-        ptr = next_field(ptr, len);  /* endcode */
-        ptr = next_field(ptr, len);  /* startstack */
-        ptr = next_field(ptr, len);  /* kstkesp */
-        ptr = next_field(ptr, len);  /* kstkeip */
-        ptr = next_field(ptr, len);  /* signal */
-        ptr = next_field(ptr, len);  /* blocked */
-        ptr = next_field(ptr, len);  /* sigignore */
-        ptr = next_field(ptr, len);  /* sigcatch */
-        ptr = next_field(ptr, len);  /* wchan */
-        ptr = next_field(ptr, len);  /* nswap */
-        ptr = next_field(ptr, len);  /* cnswap */
-        ptr = next_field(ptr, len);  /* exit_signal */
-
-        /* finally - get the processor */
-        stats->processor = strtol(ptr, NULL, 10);
-
-        /* that's all we care about from this data - ignore the rest */
-    
-        /* now create the status filename for this proc */
-        memset(data, 0, sizeof(data));
-        numchars = snprintf(data, sizeof(data), "/proc/%d/status", pid);
-        if (numchars >= sizeof(data)) {
-            return OPAL_ERR_VALUE_OUT_OF_BOUNDS;
-        }
-    
-        if (NULL == (fp = fopen(data, "r"))) {
+        stats->priority = (int32_t)sf[OPAL_STAT_PRIORITY];
+        stats->num_threads = (int16_t)sf[OPAL_STAT_NUM_THREADS];
+        /* vsize is in bytes, rss in pages - report both in MBytes */
+        stats->vsize = (float)sf[OPAL_STAT_VSIZE] / (1024.0 * 1024.0);
+        stats->rss = (float)(sf[OPAL_STAT_RSS] * page_size) / (1024.0 * 1024.0);
+        stats->processor = (int16_t)sf[OPAL_STAT_PROCESSOR];
+
+        /* the peak vsize and the context switches are only available
+         * from the status file - scan it in memory for just those keys
+         */
+        if (0 > (len = read_proc_file(&pf->status_fd, pid, "status", data, sizeof(data)))) {
             /* ignore this */
             return OPAL_SUCCESS;
         }
-    
-        /* parse it according to proc(3) */
-        while (NULL != (dptr = local_getline(fp))) {
-            if (NULL == (value = local_stripper(dptr))) {
-                /* cannot process */
-                continue;
-            }
-            /* look for VmPeak */
-            if (0 == strncmp(dptr, "VmPeak", strlen("VmPeak"))) {
-                stats->peak_vsize = convert_value(value);
-            } else if (0 == strncmp(dptr, "VmSize", strlen("VmSize"))) {
-                stats->vsize = convert_value(value);
-            } else if (0 == strncmp(dptr, "VmRSS", strlen("VmRSS"))) {
-                stats->rss = convert_value(value);
-            }
+        if (NULL != (ptr = status_value(data, "VmPeak:"))) {
+            stats->peak_vsize = convert_value(ptr);
+        }
+        if (NULL != (ptr = status_value(data, "voluntary_ctxt_switches:"))) {
+            stats->voluntary_ctxsw = strtoull(ptr, NULL, 10);
+        }
+        if (NULL != (ptr = status_value(data, "nonvoluntary_ctxt_switches:"))) {
+            stats->involuntary_ctxsw = strtoull(ptr, NULL, 10);
         }
-        fclose(fp);
     }
 
     if (NULL != nstats) {
@@ -149,6 +149,39 @@ OPAL_DECLSPEC extern const opal_shmem_base_module_2_0_0_t
  */
 OPAL_DECLSPEC extern char *opal_shmem_base_RUNTIME_QUERY_hint;
 
+/**
+ * Whether large segments should be backed by huge pages (MCA param)
+ */
+OPAL_DECLSPEC extern bool opal_shmem_base_huge_pages;
+
+/**
+ * Returns the huge page size to back a segment of the given size with,
+ * or 0 when huge pages are disabled, not available, or larger than the
+ * segment.  Segments backed by huge pages must be rounded up to a
+ * multiple of this size.
+ */
+OPAL_DECLSPEC size_t
+opal_shmem_base_huge_page_size(size_t size);
+
+/**
+ * Returns a writable hugetlbfs mount point, NULL if there is none or
+ * huge pages are disabled.
+ */
+OPAL_DECLSPEC const char *
+opal_shmem_base_hugetlbfs_dir(void);
+
+/**
+ * Reports what huge page support the selected component gets.
+ */
+OPAL_DECLSPEC void
+opal_shmem_base_huge_pages_report(void);
+
+/**
+ * Releases what the huge page lookup cached.
+ */
+OPAL_DECLSPEC void
+opal_shmem_base_huge_pages_close(void);
+
 /**
  * Framework structure declaration
  */
@@ -37,6 +37,7 @@ opal_shmem_base_close(void)
         NULL != opal_shmem_base_module->module_finalize) {
         opal_shmem_base_module->module_finalize();
     }
+    opal_shmem_base_huge_pages_close();
 
     return mca_base_framework_components_close (&opal_shmem_base_framework,
                                                 NULL);
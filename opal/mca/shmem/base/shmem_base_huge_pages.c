@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif /* HAVE_STRING_H */
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+
+#include "opal/constants.h"
+#include "opal/util/output.h"
+#include "opal/mca/shmem/shmem.h"
+#include "opal/mca/shmem/base/base.h"
+
+/*
+ * globals
+ */
+bool opal_shmem_base_huge_pages = true;
+
+/* what the system offers, looked up once */
+static bool huge_pages_looked_up = false;
+static size_t huge_page_size = 0;
+static char *hugetlbfs_dir = NULL;
+
+/* ////////////////////////////////////////////////////////////////////////// */
+/* the default huge page size, from /proc/meminfo: "Hugepagesize: 2048 kB" */
+static size_t
+read_huge_page_size(void)
+{
+    char line[256];
+    unsigned long kb = 0;
+    FILE *fp;
+
+    if (NULL == (fp = fopen("/proc/meminfo", "r"))) {
+        return 0;
+    }
+    while (NULL != fgets(line, sizeof(line), fp)) {
+        if (1 == sscanf(line, "Hugepagesize: %lu kB", &kb)) {
+            break;
+        }
+    }
+    fclose(fp);
+    return (size_t)kb * 1024;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+/* the first writable hugetlbfs mount point in /proc/mounts */
+static char *
+find_hugetlbfs_dir(void)
+{
+    char line[1024], dir[1024], type[64];
+    char *found = NULL;
+    FILE *fp;
+
+    if (NULL == (fp = fopen("/proc/mounts", "r"))) {
+        return NULL;
+    }
+    while (NULL == found && NULL != fgets(line, sizeof(line), fp)) {
+        if (2 == sscanf(line, "%*s %1023s %63s", dir, type) &&
+            0 == strcmp(type, "hugetlbfs") && 0 == access(dir, W_OK)) {
+            found = strdup(dir);
+        }
+    }
+    fclose(fp);
+    return found;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+static void
+look_up_huge_pages(void)
+{
+    if (huge_pages_looked_up) {
+        return;
+    }
+    huge_pages_looked_up = true;
+    huge_page_size = read_huge_page_size();
+    if (0 != huge_page_size) {
+        hugetlbfs_dir = find_hugetlbfs_dir();
+    }
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+size_t
+opal_shmem_base_huge_page_size(size_t size)
+{
+    if (!opal_shmem_base_huge_pages) {
+        return 0;
+    }
+    look_up_huge_pages();
+    /* a segment smaller than a huge page would mostly waste it */
+    if (0 == huge_page_size || size < huge_page_size) {
+        return 0;
+    }
+    return huge_page_size;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+const char *
+opal_shmem_base_hugetlbfs_dir(void)
+{
+    if (!opal_shmem_base_huge_pages) {
+        return NULL;
+    }
+    look_up_huge_pages();
+    return hugetlbfs_dir;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+void
+opal_shmem_base_huge_pages_report(void)
+{
+    const char *name = (NULL != opal_shmem_base_component) ?
+        opal_shmem_base_component->base_version.mca_component_name : "none";
+
+    if (!opal_shmem_base_huge_pages) {
+        opal_output_verbose(5, opal_shmem_base_framework.framework_output,
+                            "shmem: base: select: (%s) huge pages disabled",
+                            name);
+        return;
+    }
+    look_up_huge_pages();
+    if (0 == huge_page_size) {
+        opal_output_verbose(5, opal_shmem_base_framework.framework_output,
+                            "shmem: base: select: (%s) no huge pages on this "
+                            "system, using normal pages", name);
+    }
+    else {
+        opal_output_verbose(5, opal_shmem_base_framework.framework_output,
+                            "shmem: base: select: (%s) segments of %lu kB "
+                            "or more try huge pages (hugetlbfs: %s), normal "
+                            "pages otherwise", name,
+                            (unsigned long)(huge_page_size / 1024),
+                            (NULL != hugetlbfs_dir) ? hugetlbfs_dir : "none");
+    }
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+void
+opal_shmem_base_huge_pages_close(void)
+{
+    if (NULL != hugetlbfs_dir) {
+        free(hugetlbfs_dir);
+        hugetlbfs_dir = NULL;
+    }
+    huge_page_size = 0;
+    huge_pages_looked_up = false;
+}
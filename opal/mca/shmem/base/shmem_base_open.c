@@ -64,6 +64,22 @@ opal_shmem_base_register (mca_base_register_flag_t flags)
                                            MCA_BASE_VAR_FLAG_INTERNAL,
                                            OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_ALL,
                                            &opal_shmem_base_RUNTIME_QUERY_hint);
+    if (0 > ret) {
+        return ret;
+    }
+
+    opal_shmem_base_huge_pages = true;
+    ret = mca_base_framework_var_register (&opal_shmem_base_framework, "huge_pages",
+                                           "Whether or not to back shared memory "
+                                           "segments of at least a huge page with "
+                                           "huge pages (sysv: SHM_HUGETLB, mmap: a "
+                                           "file on a hugetlbfs mount, posix: "
+                                           "transparent huge pages).  Segments "
+                                           "fall back to normal pages when no huge "
+                                           "pages are available.",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &opal_shmem_base_huge_pages);
 
     return (0 > ret) ? ret : OPAL_SUCCESS;
 }
@@ -191,6 +191,7 @@ opal_shmem_base_select(void)
 
     /* initialize the winner */
     if (NULL != opal_shmem_base_module) {
+        opal_shmem_base_huge_pages_report();
         return opal_shmem_base_module->module_init();
     }
     else {
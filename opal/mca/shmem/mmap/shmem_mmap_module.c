@@ -292,6 +292,78 @@ get_uniq_file_name(const char *base_path, const char *hash_key)
     return uniq_name_buf;
 }
 
+/* ////////////////////////////////////////////////////////////////////////// */
+/**
+ * tries to back the segment with a file on a hugetlbfs mount.  the file size
+ * is a multiple of the huge page size, and mmap fails when there are not
+ * enough free huge pages.  any failure is silent: the caller goes on with the
+ * usual backing file.
+ */
+static int
+segment_create_huge(opal_shmem_ds_t *ds_buf,
+                    const char *file_name,
+                    size_t real_size)
+{
+    const char *dir = opal_shmem_base_hugetlbfs_dir();
+    size_t huge_page_size = opal_shmem_base_huge_page_size(real_size);
+    opal_shmem_seg_hdr_t *seg_hdrp = MAP_FAILED;
+    char *real_file_name = NULL;
+    pid_t my_pid = getpid();
+    int fd;
+
+    if (NULL == dir || 0 == huge_page_size) {
+        return OPAL_ERR_NOT_AVAILABLE;
+    }
+    real_size = (real_size + huge_page_size - 1) & ~(huge_page_size - 1);
+
+    if (NULL == (real_file_name = get_uniq_file_name(dir, file_name))) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
+    }
+    if (-1 == (fd = open(real_file_name, O_CREAT | O_RDWR, 0600))) {
+        free(real_file_name);
+        return OPAL_ERR_NOT_AVAILABLE;
+    }
+    if (0 != ftruncate(fd, real_size) ||
+        MAP_FAILED == (seg_hdrp = (opal_shmem_seg_hdr_t *)
+                                  mmap(NULL, real_size,
+                                       PROT_READ | PROT_WRITE, MAP_SHARED,
+                                       fd, 0))) {
+        opal_output_verbose(10, opal_shmem_base_framework.framework_output,
+                            "%s: %s: no huge pages for a segment of %lu "
+                            "bytes in %s (%s), using normal pages",
+                            mca_shmem_mmap_component.super.base_version.mca_type_name,
+                            mca_shmem_mmap_component.super.base_version.mca_component_name,
+                            (unsigned long)real_size, dir, strerror(errno));
+        close(fd);
+        unlink(real_file_name);
+        free(real_file_name);
+        return OPAL_ERR_NOT_AVAILABLE;
+    }
+    close(fd);
+
+    /* -- initialize the shared memory segment -- */
+    opal_atomic_rmb();
+    opal_atomic_init(&seg_hdrp->lock, OPAL_ATOMIC_UNLOCKED);
+    seg_hdrp->cpid = my_pid;
+    opal_atomic_wmb();
+
+    /* -- initialize the contents of opal_shmem_ds_t -- */
+    ds_buf->seg_cpid = my_pid;
+    ds_buf->seg_size = real_size;
+    ds_buf->seg_base_addr = (unsigned char *)seg_hdrp;
+    (void)strncpy(ds_buf->seg_name, real_file_name, OPAL_PATH_MAX - 1);
+    ds_buf->flags |= OPAL_SHMEM_DS_FLAGS_HUGE;
+    OPAL_SHMEM_DS_SET_VALID(ds_buf);
+
+    opal_output_verbose(10, opal_shmem_base_framework.framework_output,
+                        "%s: %s: segment of %lu bytes on huge pages (%s)",
+                        mca_shmem_mmap_component.super.base_version.mca_type_name,
+                        mca_shmem_mmap_component.super.base_version.mca_component_name,
+                        (unsigned long)real_size, ds_buf->seg_name);
+    free(real_file_name);
+    return OPAL_SUCCESS;
+}
+
 /* ////////////////////////////////////////////////////////////////////////// */
 static int
 segment_create(opal_shmem_ds_t *ds_buf,
@@ -313,6 +385,11 @@ segment_create(opal_shmem_ds_t *ds_buf,
     /* init the contents of opal_shmem_ds_t */
     shmem_ds_reset(ds_buf);
 
+    /* large segments go to a hugetlbfs file when there is one */
+    if (OPAL_SUCCESS == segment_create_huge(ds_buf, file_name, real_size)) {
+        return OPAL_SUCCESS;
+    }
+
     /* change the path of shmem mmap's backing store? */
     if (0 != opal_shmem_mmap_relocate_backing_file) {
         int err;
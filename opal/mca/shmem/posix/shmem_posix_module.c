@@ -163,6 +163,25 @@ ds_copy(const opal_shmem_ds_t *from,
     return OPAL_SUCCESS;
 }
 
+/* ////////////////////////////////////////////////////////////////////////// */
+/**
+ * posix shared memory objects live on a tmpfs, which can only get huge pages
+ * through transparent huge pages.  the advice is per mapping, so every process
+ * gives it.  whether the kernel follows it depends on its shmem_enabled
+ * setting.
+ */
+static bool
+advise_huge_pages(void *addr, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+    if (0 != opal_shmem_base_huge_page_size(size) &&
+        0 == madvise(addr, size, MADV_HUGEPAGE)) {
+        return true;
+    }
+#endif
+    return false;
+}
+
 /* ////////////////////////////////////////////////////////////////////////// */
 static int
 segment_create(opal_shmem_ds_t *ds_buf,
@@ -236,6 +255,15 @@ segment_create(opal_shmem_ds_t *ds_buf,
         ds_buf->seg_cpid = my_pid;
         ds_buf->seg_size = real_size;
         ds_buf->seg_base_addr = (unsigned char *)seg_hdrp;
+        if (advise_huge_pages(seg_hdrp, real_size)) {
+            ds_buf->flags |= OPAL_SHMEM_DS_FLAGS_HUGE;
+            opal_output_verbose(10, opal_shmem_base_framework.framework_output,
+                                "%s: %s: segment of %lu bytes advised to use "
+                                "transparent huge pages",
+                                mca_shmem_posix_component.super.base_version.mca_type_name,
+                                mca_shmem_posix_component.super.base_version.mca_component_name,
+                                (unsigned long)real_size);
+        }
 
         /* notice that we are not setting ds_buf->name here.  at this point,
          * posix_shm_open was successful, so the contents of ds_buf->name are
@@ -329,6 +357,9 @@ segment_attach(opal_shmem_ds_t *ds_buf)
         }
         /* all is well */
         else {
+            if (ds_buf->flags & OPAL_SHMEM_DS_FLAGS_HUGE) {
+                (void)advise_huge_pages(ds_buf->seg_base_addr, ds_buf->seg_size);
+            }
             /* if close fails here, that's okay.  just let the user know and
              * continue.  if we got this far, open and mmap were successful...
              */
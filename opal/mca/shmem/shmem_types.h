@@ -53,6 +53,11 @@ BEGIN_C_DECLS
  */
 #define OPAL_SHMEM_DS_FLAGS_VALID 0x01
 
+/**
+ * flag indicating that the segment is backed by huge pages
+ */
+#define OPAL_SHMEM_DS_FLAGS_HUGE 0x02
+
 /**
  * 0x1* - reserved for internal flags. that is, flags that will NOT be
  * propagated via ds_copy during inter-process information sharing.
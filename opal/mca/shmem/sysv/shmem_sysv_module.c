@@ -184,6 +184,9 @@ segment_create(opal_shmem_ds_t *ds_buf,
      */
     size_t real_size = size + sizeof(opal_shmem_seg_hdr_t);
     opal_shmem_seg_hdr_t *seg_hdrp = MAP_FAILED;
+#ifdef SHM_HUGETLB
+    size_t huge_page_size = opal_shmem_base_huge_page_size(real_size);
+#endif
 
     /* init the contents of opal_shmem_ds_t */
     shmem_ds_reset(ds_buf);
@@ -192,10 +195,36 @@ segment_create(opal_shmem_ds_t *ds_buf,
      * being located on a network file system... so no check is needed here.
      */
 
+#ifdef SHM_HUGETLB
+    /* try huge pages first.  the size of such a segment is a multiple of the
+     * huge page size.  if there are not enough free huge pages, just go on
+     * with normal ones.
+     */
+    if (0 != huge_page_size) {
+        size_t huge_size = (real_size + huge_page_size - 1) &
+                           ~(huge_page_size - 1);
+
+        if (-1 != (ds_buf->seg_id = shmget(IPC_PRIVATE, huge_size,
+                                           IPC_CREAT | IPC_EXCL | SHM_HUGETLB |
+                                           S_IRWXU))) {
+            real_size = huge_size;
+            ds_buf->flags |= OPAL_SHMEM_DS_FLAGS_HUGE;
+        }
+        opal_output_verbose(10, opal_shmem_base_framework.framework_output,
+                            "%s: %s: segment of %lu bytes on %s pages",
+                            mca_shmem_sysv_component.super.base_version.mca_type_name,
+                            mca_shmem_sysv_component.super.base_version.mca_component_name,
+                            (unsigned long)real_size,
+                            (OPAL_SHMEM_DS_ID_INVALID != ds_buf->seg_id) ?
+                            "huge" : "normal");
+    }
+#endif
+
     /* create a new shared memory segment and save the shmid. note the use of
      * real_size here
      */
-    if (-1 == (ds_buf->seg_id = shmget(IPC_PRIVATE, real_size,
+    if (OPAL_SHMEM_DS_ID_INVALID == ds_buf->seg_id &&
+        -1 == (ds_buf->seg_id = shmget(IPC_PRIVATE, real_size,
                                        IPC_CREAT | IPC_EXCL | S_IRWXU))) {
         int err = errno;
         char hn[MAXHOSTNAMELEN];
@@ -21,9 +21,16 @@
 
 #include "opal_config.h"
 #include <opal/sys/timer.h>
+#include <time.h>
+
+#include "opal/prefetch.h"
 
 OPAL_DECLSPEC extern opal_timer_t opal_timer_linux_freq;
 
+/* the cycle counter ticks at a constant rate whatever the frequency of
+   the core, and opal_timer_linux_freq is that rate */
+OPAL_DECLSPEC extern bool opal_timer_linux_invariant;
+
 static inline opal_timer_t
 opal_timer_base_get_cycles(void)
 {
@@ -39,8 +46,22 @@ static inline opal_timer_t
 opal_timer_base_get_usec(void)
 {
 #if OPAL_HAVE_SYS_TIMER_GET_CYCLES
-    /* freq is in Hz, so this gives usec */
-    return opal_sys_timer_get_cycles() * 1000000  / opal_timer_linux_freq;
+    opal_timer_t cycles;
+
+#if defined(CLOCK_MONOTONIC)
+    if (OPAL_UNLIKELY(!opal_timer_linux_invariant)) {
+        /* the cycles do not measure time when the frequency changes */
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (opal_timer_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+#endif
+    /* freq is in Hz, so this gives usec; split so that the product
+       does not overflow after a few hours */
+    cycles = opal_sys_timer_get_cycles();
+    return (cycles / opal_timer_linux_freq) * 1000000 +
+        (cycles % opal_timer_linux_freq) * 1000000 / opal_timer_linux_freq;
 #else
     return 0;
 #endif
@@ -21,14 +21,20 @@
 #ifdef HAVE_STRING_H
 #include <string.h>
 #endif
+#include <time.h>
 
 #include "opal/mca/timer/timer.h"
 #include "opal/mca/timer/linux/timer_linux.h"
+#include "opal/mca/base/mca_base_var.h"
 #include "opal/constants.h"
 
 opal_timer_t opal_timer_linux_freq;
+bool opal_timer_linux_invariant = false;
+
+static int opal_timer_linux_calibration_usec;
 
 static int opal_timer_linux_open(void);
+static int opal_timer_linux_register(void);
 
 const opal_timer_base_component_2_0_0_t mca_timer_linux_component = {
     /* First, the mca_component_t struct containing meta information
@@ -44,7 +50,9 @@ const opal_timer_base_component_2_0_0_t mca_timer_linux_component = {
 
         /* Component open and close functions */
         opal_timer_linux_open,
-        NULL
+        NULL,
+        NULL,
+        opal_timer_linux_register
     },
     {
         /* The component is checkpoint ready */
@@ -73,6 +81,65 @@ find_info(FILE* fp, char *str, char *buf, size_t buflen)
     return NULL;
 }
 
+static int
+opal_timer_linux_register(void)
+{
+    opal_timer_linux_calibration_usec = 10000;
+    (void) mca_base_component_var_register(&mca_timer_linux_component.timerc_version,
+                                           "calibration_usec",
+                                           "Time spent at startup measuring the rate of an "
+                                           "invariant cycle counter against CLOCK_MONOTONIC_RAW "
+                                           "(0 = trust the cpu MHz of /proc/cpuinfo)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &opal_timer_linux_calibration_usec);
+    return OPAL_SUCCESS;
+}
+
+/* is the word in the space separated list */
+static bool
+has_flag(const char *list, const char *flag)
+{
+    size_t len = strlen(flag);
+    const char *tmp;
+
+    for (tmp = strstr(list, flag) ; NULL != tmp ; tmp = strstr(tmp + len, flag)) {
+        if ((tmp == list || ' ' == tmp[-1]) &&
+            ('\0' == tmp[len] || ' ' == tmp[len] || '\n' == tmp[len])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if OPAL_HAVE_SYS_TIMER_GET_CYCLES && (defined(CLOCK_MONOTONIC_RAW) || defined(CLOCK_MONOTONIC))
+static opal_timer_t
+calibrate(int usec)
+{
+#if defined(CLOCK_MONOTONIC_RAW)
+    const clockid_t id = CLOCK_MONOTONIC_RAW;
+#else
+    const clockid_t id = CLOCK_MONOTONIC;
+#endif
+    struct timespec start, now;
+    opal_timer_t c0, c1;
+    int64_t nsec;
+
+    if (0 != clock_gettime(id, &start)) {
+        return 0;
+    }
+    c0 = opal_sys_timer_get_cycles();
+    do {
+        (void) clock_gettime(id, &now);
+        c1 = opal_sys_timer_get_cycles();
+        nsec = (int64_t) (now.tv_sec - start.tv_sec) * 1000000000 +
+            (now.tv_nsec - start.tv_nsec);
+    } while (nsec < (int64_t) usec * 1000);
+
+    return (opal_timer_t) ((double) (c1 - c0) * 1e9 / (double) nsec);
+}
+#endif
+
 int
 opal_timer_linux_open(void)
 {
@@ -81,6 +148,7 @@ opal_timer_linux_open(void)
     float cpu_f;
     int ret;
     char buf[1024];
+    char flags[8192];
 
     fp = fopen("/proc/cpuinfo", "r");
     if (NULL == fp) {
@@ -98,11 +166,18 @@ opal_timer_linux_open(void)
             ret = sscanf(loc, "%d", &freq);
             if (1 == ret) {
                 opal_timer_linux_freq = freq;
+                /* a time base has a fixed rate */
+                opal_timer_linux_invariant = true;
             }
         }
     }
 
     if (0 == opal_timer_linux_freq) {
+        /* the TSC of x86 only measures time when it is invariant */
+        loc = find_info(fp, "flags", flags, sizeof(flags));
+        opal_timer_linux_invariant = NULL != loc && has_flag(loc, "constant_tsc") &&
+            has_flag(loc, "nonstop_tsc");
+
         /* find the CPU speed - most timers are 1:1 with CPU speed */
         loc = find_info(fp, "cpu MHz", buf, 1024);
         if (NULL != loc) {
@@ -112,6 +187,18 @@ opal_timer_linux_open(void)
                 opal_timer_linux_freq = (opal_timer_t) cpu_f * 1000000;
             }
         }
+
+        /* the cpu MHz is the current, scaled, frequency: measure the
+           rate of the counter instead */
+#if OPAL_HAVE_SYS_TIMER_GET_CYCLES && (defined(CLOCK_MONOTONIC_RAW) || defined(CLOCK_MONOTONIC))
+        if (opal_timer_linux_invariant && 0 < opal_timer_linux_calibration_usec) {
+            opal_timer_t freq = calibrate(opal_timer_linux_calibration_usec);
+
+            if (0 != freq) {
+                opal_timer_linux_freq = freq;
+            }
+        }
+#endif
     }
 
     if (0 == opal_timer_linux_freq) {
@@ -122,11 +209,17 @@ opal_timer_linux_open(void)
             ret = sscanf(loc, "%x", &freq);
             if (1 == ret) {
                 opal_timer_linux_freq = freq;
+                opal_timer_linux_invariant = true;
             }
         }
     }
 
     fclose(fp);
 
+    /* without a rate, the usec come from the monotonic clock */
+    if (0 == opal_timer_linux_freq) {
+        opal_timer_linux_invariant = false;
+    }
+
     return OPAL_SUCCESS;
 }
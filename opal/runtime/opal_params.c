@@ -28,11 +28,15 @@
 #ifdef HAVE_SIGNAL_H
 #include <signal.h>
 #endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
 
 #include "opal/constants.h"
 #include "opal/runtime/opal.h"
 #include "opal/datatype/opal_datatype.h"
 #include "opal/mca/base/mca_base_var.h"
+#include "opal/mca/base/mca_base_pvar.h"
 #include "opal/threads/mutex.h"
 #include "opal/threads/threads.h"
 #include "opal/mca/shmem/base/base.h"
@@ -163,6 +167,132 @@ int opal_register_params(void)
 	return ret;
     }
 
+    opal_progress_thread_enable = false;
+    ret = mca_base_var_register ("opal", "opal", "progress", "thread",
+				 "Drive the progress engine (registered progress callbacks and the event library) "
+				 "from a dedicated thread instead of from the application threads that block in MPI.  "
+				 "Only available when Open MPI was built with thread support.",
+				 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+				 OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_ALL_EQ,
+				 &opal_progress_thread_enable);
+    if (0 > ret) {
+	return ret;
+    }
+
+    opal_progress_thread_core = -1;
+    ret = mca_base_var_register ("opal", "opal", "progress", "thread_core",
+				 "Logical index of the core the progress thread is bound to.  "
+				 "-1 picks the last core of the process binding when the process is bound to more than one core, "
+				 "and leaves the thread unbound otherwise (default: -1)",
+				 MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+				 OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_LOCAL,
+				 &opal_progress_thread_core);
+    if (0 > ret) {
+	return ret;
+    }
+
+    opal_progress_wait_block = false;
+    ret = mca_base_var_register ("opal", "opal", "progress", "wait_block",
+				 "Hybrid blocking waits: once a wait stayed idle for the learned spin interval, arm the "
+				 "completion channels of the transports that have one and block in the event library "
+				 "until data arrives (default: false, waits always poll)",
+				 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+				 OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_ALL_EQ,
+				 &opal_progress_wait_block);
+    if (0 > ret) {
+	return ret;
+    }
+
+    opal_progress_wait_spin_max = 100;
+    ret = mca_base_var_register ("opal", "opal", "progress", "wait_spin_max",
+				 "Longest the hybrid waits poll before they block, in microseconds.  The actual interval "
+				 "is learned from the idle gaps of the previous waits (default: 100)",
+				 MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+				 OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_ALL_EQ,
+				 &opal_progress_wait_spin_max);
+    if (0 > ret) {
+	return ret;
+    }
+
+    opal_progress_wait_block_max = 1000;
+    ret = mca_base_var_register ("opal", "opal", "progress", "wait_block_max",
+				 "Longest the hybrid waits block at once, in microseconds.  It bounds the latency of the "
+				 "transports without a completion channel, which are only polled in between (default: 1000)",
+				 MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+				 OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_ALL_EQ,
+				 &opal_progress_wait_block_max);
+    if (0 > ret) {
+	return ret;
+    }
+
+    opal_progress_lp_call_ratio = 8;
+    ret = mca_base_var_register ("opal", "opal", "progress", "lp_call_ratio",
+				 "The low priority progress callbacks are called once every this many calls to "
+				 "the progress engine (default: 8)",
+				 MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+				 OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_ALL_EQ,
+				 &opal_progress_lp_call_ratio);
+    if (0 > ret) {
+	return ret;
+    }
+
+    opal_progress_cooperative = false;
+    ret = mca_base_var_register ("opal", "opal", "progress", "cooperative",
+				 "With threads, callers of the progress engine share the work: each progress callback "
+				 "(and the event library) is driven by one thread at a time, the others skip it and go "
+				 "on with the next one instead of contending on its locks (default: false)",
+				 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+				 OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_ALL_EQ,
+				 &opal_progress_cooperative);
+    if (0 > ret) {
+	return ret;
+    }
+
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+    ret = mca_base_var_register ("opal", "opal", "mutex", "adaptive",
+				 "Make the OPAL mutexes created from now on adaptive ticket locks: waiters are served "
+				 "in order, spin for a budget learned from the previous waits and then sleep, instead "
+				 "of going through the pthread mutexes (default: set at configure time with "
+				 "--with-opal-mutex)",
+				 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+				 OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_LOCAL,
+				 &opal_mutex_adaptive);
+    if (0 > ret) {
+	return ret;
+    }
+
+    /* spinning only delays the holder on a single processor */
+    opal_mutex_spin_max = 1000;
+#if defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+    if (1 == sysconf(_SC_NPROCESSORS_ONLN)) {
+	opal_mutex_spin_max = 0;
+    }
+#endif
+    ret = mca_base_var_register ("opal", "opal", "mutex", "spin_max",
+				 "Most pauses a waiter on an adaptive mutex spins before it sleeps (default: 1000, "
+				 "0 on a single processor)",
+				 MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+				 OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_LOCAL,
+				 &opal_mutex_spin_max);
+    if (0 > ret) {
+	return ret;
+    }
+
+    (void) mca_base_pvar_register ("opal", "opal", "mutex", "contended",
+				   "Number of acquisitions of an adaptive mutex that had to wait",
+				   OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_SIZE_T,
+				   NULL, MCA_BASE_VAR_BIND_NO_OBJECT,
+				   MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+				   NULL, NULL, NULL, &opal_mutex_contended);
+    (void) mca_base_pvar_register ("opal", "opal", "mutex", "parked",
+				   "Number of acquisitions of an adaptive mutex that ran out of spin budget "
+				   "and slept",
+				   OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_SIZE_T,
+				   NULL, MCA_BASE_VAR_BIND_NO_OBJECT,
+				   MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+				   NULL, NULL, NULL, &opal_mutex_parked);
+#endif
+
     /* The ddt engine has a few parameters */
     ret = opal_datatype_register_params();
     if (OPAL_SUCCESS != ret) {
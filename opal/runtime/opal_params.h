@@ -28,6 +28,12 @@
 extern char *opal_signal_string;
 extern char *opal_net_private_ipv4;
 extern char *opal_set_max_sys_limits;
+extern bool opal_progress_thread_enable;
+extern int opal_progress_thread_core;
+extern int opal_progress_wait_spin_max;
+extern int opal_progress_wait_block_max;
+extern int opal_progress_lp_call_ratio;
+extern bool opal_progress_cooperative;
 
 #if OPAL_ENABLE_DEBUG
 extern bool opal_progress_debug;
@@ -24,6 +24,9 @@
 #ifdef HAVE_SCHED_H
 #include <sched.h>
 #endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
 
 #include "opal/runtime/opal_progress.h"
 #include "opal/mca/event/event.h"
@@ -32,6 +35,10 @@
 #include "opal/mca/timer/base/base.h"
 #include "opal/util/output.h"
 #include "opal/runtime/opal_params.h"
+#include "opal/threads/threads.h"
+#if OPAL_HAVE_HWLOC
+#include "opal/mca/hwloc/base/base.h"
+#endif
 
 #define OPAL_PROGRESS_USE_TIMERS (OPAL_TIMER_CYCLE_SUPPORTED || OPAL_TIMER_USEC_SUPPORTED)
 
@@ -45,6 +52,15 @@ bool opal_progress_debug = false;
 static int opal_progress_event_flag = OPAL_EVLOOP_ONCE | OPAL_EVLOOP_NONBLOCK;
 volatile int32_t opal_progress_thread_count = 0;
 int opal_progress_spin_count = 10000;
+bool opal_progress_thread_enable = false;
+int opal_progress_thread_core = -1;
+volatile bool opal_progress_thread_active = false;
+bool opal_progress_wait_block = false;
+int opal_progress_wait_spin_max = 100;
+int opal_progress_wait_block_max = 1000;
+int opal_progress_lp_call_ratio = 8;
+bool opal_progress_cooperative = false;
+uint64_t opal_progress_wait_idle_since = 0;
 
 
 /*
@@ -59,9 +75,48 @@ static opal_progress_callback_t *callbacks = NULL;
 static size_t callbacks_len = 0;
 static size_t callbacks_size = 0;
 
+/* the low priority callbacks, every opal_progress_lp_call_ratio calls */
+static opal_progress_callback_t *callbacks_lp = NULL;
+static size_t callbacks_lp_len = 0;
+static size_t callbacks_lp_size = 0;
+static int32_t callbacks_lp_countdown = 0;
+
 /* do we want to call sched_yield() if nothing happened */
 static int call_yield = 1;
 
+#if OPAL_ENABLE_MULTI_THREADS
+/* Cooperative progress: a try-lock per callback slot (slots beyond
+   OPAL_PROGRESS_MAX_BUSY share them) and one for the event library.
+   The array is never reallocated, so a lock stays valid while its
+   holder runs the callback, even if the callbacks array moves. */
+#define OPAL_PROGRESS_MAX_BUSY 64
+static opal_atomic_lock_t callbacks_busy[OPAL_PROGRESS_MAX_BUSY];
+static opal_atomic_lock_t event_busy;
+/* where the next caller starts in the callbacks array, so that
+   concurrent callers begin with different callbacks */
+static volatile int32_t callbacks_rotor = 0;
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+
+/* the completion channels armed before a hybrid wait blocks */
+#define OPAL_PROGRESS_MAX_ARMS 8
+static opal_progress_arm_fn_t arms[OPAL_PROGRESS_MAX_ARMS];
+static int arms_len = 0;
+
+/* Hybrid waits: the average idle gap, in usec, and the spin interval
+   derived from it */
+static uint64_t wait_gap_avg = 0;
+static uint64_t wait_spin = 0;
+#if OPAL_HAVE_WORKING_EVENTOPS
+static opal_event_t wait_timer;
+static bool wait_timer_set = false;
+
+/* only there to bound the time opal_event_loop blocks */
+static void
+wait_timer_cb(int fd, short flags, void *arg)
+{
+}
+#endif
+
 #if OPAL_PROGRESS_USE_TIMERS
 static opal_timer_t event_progress_last_time = 0;
 static opal_timer_t event_progress_delta = 0;
@@ -85,6 +140,15 @@ uint32_t opal_progress_recursion_depth_counter = 0;
 static int debug_output = -1;
 #endif
 
+#if OPAL_ENABLE_MULTI_THREADS
+/* the progress thread, and the flag telling it to keep going */
+static opal_thread_t progress_thread;
+static volatile bool progress_thread_run = false;
+#if OPAL_HAVE_HWLOC
+static hwloc_cpuset_t progress_thread_cpuset = NULL;
+#endif
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+
 /**
  * Fake callback used for threading purpose when one thread
  * progesses callbacks while another unregister somes. The root
@@ -101,7 +165,13 @@ opal_progress_init(void)
 {
     /* reentrant issues */
 #if OPAL_ENABLE_MULTI_THREADS
+    int i;
+
     opal_atomic_init(&progress_lock, OPAL_ATOMIC_UNLOCKED);
+    for (i = 0 ; i < OPAL_PROGRESS_MAX_BUSY ; ++i) {
+        opal_atomic_init(&callbacks_busy[i], OPAL_ATOMIC_UNLOCKED);
+    }
+    opal_atomic_init(&event_busy, OPAL_ATOMIC_UNLOCKED);
 #endif  /* OPAL_ENABLE_MULTI_THREADS */
 
     /* set the event tick rate */
@@ -122,6 +192,17 @@ opal_progress_init(void)
     OPAL_OUTPUT((debug_output, "progress: initialized poll rate to: %ld",
                  (long) event_progress_delta));
 
+    wait_spin = (uint64_t) opal_progress_wait_spin_max;
+    wait_gap_avg = 0;
+#if OPAL_HAVE_WORKING_EVENTOPS
+    if (opal_progress_wait_block && !wait_timer_set) {
+        opal_event_evtimer_set(opal_event_base, &wait_timer, wait_timer_cb, NULL);
+        wait_timer_set = true;
+    }
+#else
+    opal_progress_wait_block = false;
+#endif
+
     return OPAL_SUCCESS;
 }
 
@@ -129,6 +210,17 @@ opal_progress_init(void)
 int
 opal_progress_finalize(void)
 {
+    /* the thread must be gone before the callbacks go away */
+    opal_progress_thread_stop();
+
+#if OPAL_HAVE_WORKING_EVENTOPS
+    if (wait_timer_set) {
+        opal_event_evtimer_del(&wait_timer);
+        wait_timer_set = false;
+    }
+#endif
+    arms_len = 0;
+
     /* free memory associated with the callbacks */
 #if OPAL_ENABLE_MULTI_THREADS
     opal_atomic_lock(&progress_lock);
@@ -140,6 +232,12 @@ opal_progress_finalize(void)
         free(callbacks);
         callbacks = NULL;
     }
+    callbacks_lp_len = 0;
+    callbacks_lp_size = 0;
+    if (NULL != callbacks_lp) {
+        free(callbacks_lp);
+        callbacks_lp = NULL;
+    }
 
 #if OPAL_ENABLE_MULTI_THREADS
     opal_atomic_unlock(&progress_lock);
@@ -160,8 +258,60 @@ opal_progress_finalize(void)
  * care, as the cost of that happening is far outweighed by the cost
  * of the if checks (they were resulting in bad pipe stalling behavior)
  */
-void
-opal_progress(void)
+static inline int
+opal_progress_event_loop(void)
+{
+#if OPAL_ENABLE_MULTI_THREADS
+    if (opal_progress_cooperative && opal_using_threads()) {
+        int events;
+
+        /* another thread is in the event library already */
+        if (opal_atomic_trylock(&event_busy)) {
+            return 0;
+        }
+        events = opal_event_loop(opal_event_base, opal_progress_event_flag);
+        opal_atomic_unlock(&event_busy);
+        return events;
+    }
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+    return opal_event_loop(opal_event_base, opal_progress_event_flag);
+}
+
+#if OPAL_ENABLE_MULTI_THREADS
+/*
+ * Cooperative progress: call each callback that no other thread is
+ * running at the moment, and skip the others rather than wait for
+ * them (or contend on their locks), as their thread is doing the work
+ * already.  Callers start at different places in the array, so that
+ * concurrent ones spread over the callbacks.
+ */
+static inline int
+opal_progress_callbacks_cooperative(void)
+{
+    size_t i, k, len = callbacks_len;
+    opal_atomic_lock_t *busy;
+    int events = 0;
+
+    if (0 == len) {
+        return 0;
+    }
+    i = (size_t) ((uint32_t) OPAL_THREAD_ADD32(&callbacks_rotor, 1) % len);
+    for (k = 0 ; k < len ; ++k) {
+        busy = &callbacks_busy[i % OPAL_PROGRESS_MAX_BUSY];
+        if (!opal_atomic_trylock(busy)) {
+            events += (callbacks[i])();
+            opal_atomic_unlock(busy);
+        }
+        if (++i == len) {
+            i = 0;
+        }
+    }
+    return events;
+}
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+
+static inline int
+opal_progress_engine(void)
 {
     size_t i;
     int events = 0;
@@ -185,7 +335,7 @@ opal_progress(void)
                 event_progress_last_time = (num_event_users > 0) ? 
                     now - event_progress_delta : now;
 
-                events += opal_event_loop(opal_event_base, opal_progress_event_flag);
+                events += opal_progress_event_loop();
         }
 
 #else /* OPAL_PROGRESS_USE_TIMERS */
@@ -194,7 +344,7 @@ opal_progress(void)
         if (OPAL_THREAD_ADD32(&event_progress_counter, -1) <= 0 ) {
                 event_progress_counter = 
                     (num_event_users > 0) ? 0 : event_progress_delta;
-                events += opal_event_loop(opal_event_base, opal_progress_event_flag);
+                events += opal_progress_event_loop();
         }
 #endif /* OPAL_PROGRESS_USE_TIMERS */
 
@@ -202,8 +352,23 @@ opal_progress(void)
     }
 
     /* progress all registered callbacks */
-    for (i = 0 ; i < callbacks_len ; ++i) {
-        events += (callbacks[i])();
+#if OPAL_ENABLE_MULTI_THREADS
+    if (opal_progress_cooperative && opal_using_threads()) {
+        events += opal_progress_callbacks_cooperative();
+    } else
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+    {
+        for (i = 0 ; i < callbacks_len ; ++i) {
+            events += (callbacks[i])();
+        }
+    }
+
+    /* and the low priority ones once in a while */
+    if (0 < callbacks_lp_len && --callbacks_lp_countdown <= 0) {
+        callbacks_lp_countdown = opal_progress_lp_call_ratio;
+        for (i = 0 ; i < callbacks_lp_len ; ++i) {
+            events += (callbacks_lp[i])();
+        }
     }
 
 #if defined(HAVE_SCHED_YIELD)
@@ -221,6 +386,303 @@ opal_progress(void)
 #else
     --opal_progress_recursion_depth_counter;
 #endif
+    return events;
+}
+
+
+void
+opal_progress(void)
+{
+#if OPAL_ENABLE_MULTI_THREADS
+    /* When the progress thread is running it owns the callbacks and
+       the event base.  Everybody else just gets out of its way, so
+       that application threads never contend with it. */
+    if (opal_progress_thread_active &&
+        !opal_thread_self_compare(&progress_thread)) {
+#if defined(HAVE_SCHED_YIELD)
+        if (call_yield) {
+            sched_yield();
+        }
+#endif  /* defined(HAVE_SCHED_YIELD) */
+        return;
+    }
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+
+    (void) opal_progress_engine();
+}
+
+
+static inline uint64_t
+opal_progress_wait_usec(void)
+{
+#if OPAL_TIMER_USEC_SUPPORTED
+    return (uint64_t) opal_timer_base_get_usec();
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
+
+/*
+ * An idle gap ended after gap usec.  Spinning pays off when the gaps
+ * are short, so spin twice their average as long as that stays under
+ * opal_progress_wait_spin_max.  When they are long, block after a
+ * short spin: the wakeup costs less than the cycles spent polling.
+ * The gaps that went through a block were at least the spin interval,
+ * which biases the average up until the short gaps come back.
+ */
+static void
+opal_progress_wait_learn(uint64_t gap)
+{
+    uint64_t max = (uint64_t) opal_progress_wait_spin_max;
+
+    if (gap > 2 * max) {
+        gap = 2 * max;
+    }
+    wait_gap_avg = (3 * wait_gap_avg + gap) / 4;
+    wait_spin = (2 * wait_gap_avg <= max) ? 2 * wait_gap_avg : max / 8;
+}
+
+void
+opal_progress_wait(void)
+{
+    uint64_t now;
+    int events;
+
+    if (!opal_progress_wait_block
+#if OPAL_ENABLE_MULTI_THREADS
+        || opal_progress_thread_active
+#endif
+        ) {
+        opal_progress();
+        return;
+    }
+
+    events = opal_progress_engine();
+    now = opal_progress_wait_usec();
+    if (0 < events) {
+        if (0 != opal_progress_wait_idle_since) {
+            opal_progress_wait_learn(now - opal_progress_wait_idle_since);
+        }
+        opal_progress_wait_idle_since = 0;
+        return;
+    }
+    if (0 == opal_progress_wait_idle_since) {
+        opal_progress_wait_idle_since = now;
+        return;
+    }
+    if (now - opal_progress_wait_idle_since < wait_spin) {
+        return;
+    }
+
+#if OPAL_HAVE_WORKING_EVENTOPS
+    {
+        struct timeval tv;
+        int i;
+
+        /* arm the channels, unless one of them has data already */
+        for (i = 0, events = 0 ; i < arms_len ; ++i) {
+            events += arms[i]();
+        }
+        if (0 < events) {
+            return;
+        }
+
+        tv.tv_sec = opal_progress_wait_block_max / 1000000;
+        tv.tv_usec = opal_progress_wait_block_max % 1000000;
+        opal_event_evtimer_add(&wait_timer, &tv);
+        (void) opal_event_loop(opal_event_base, OPAL_EVLOOP_ONCE);
+        opal_event_evtimer_del(&wait_timer);
+    }
+#endif
+}
+
+
+int
+opal_progress_register_arm(opal_progress_arm_fn_t arm)
+{
+    int ret = OPAL_SUCCESS;
+
+#if OPAL_ENABLE_MULTI_THREADS
+    opal_atomic_lock(&progress_lock);
+#endif
+    if (arms_len == OPAL_PROGRESS_MAX_ARMS) {
+        ret = OPAL_ERR_OUT_OF_RESOURCE;
+    } else {
+        arms[arms_len++] = arm;
+    }
+#if OPAL_ENABLE_MULTI_THREADS
+    opal_atomic_unlock(&progress_lock);
+#endif
+    return ret;
+}
+
+
+int
+opal_progress_unregister_arm(opal_progress_arm_fn_t arm)
+{
+    int i, ret = OPAL_ERR_NOT_FOUND;
+
+#if OPAL_ENABLE_MULTI_THREADS
+    opal_atomic_lock(&progress_lock);
+#endif
+    for (i = 0 ; i < arms_len ; ++i) {
+        if (arm == arms[i]) {
+            arms[i] = arms[--arms_len];
+            ret = OPAL_SUCCESS;
+            break;
+        }
+    }
+#if OPAL_ENABLE_MULTI_THREADS
+    opal_atomic_unlock(&progress_lock);
+#endif
+    return ret;
+}
+
+
+#if OPAL_ENABLE_MULTI_THREADS
+static void *
+opal_progress_thread_engine(opal_object_t *obj)
+{
+#if OPAL_HAVE_HWLOC
+    if (NULL == progress_thread_cpuset) {
+        (void) opal_hwloc_base_bind_helper_thread("progress");
+    } else if (0 != hwloc_set_cpubind(opal_hwloc_topology, progress_thread_cpuset,
+                                      HWLOC_CPUBIND_THREAD)) {
+        OPAL_OUTPUT((debug_output, "progress: unable to bind the progress thread"));
+    }
+#endif  /* OPAL_HAVE_HWLOC */
+
+    while (progress_thread_run) {
+        opal_progress_engine();
+    }
+    return OPAL_THREAD_CANCELLED;
+}
+
+
+#if OPAL_HAVE_HWLOC
+/*
+ * Pick the core for the progress thread: either the one requested by
+ * the user, or the last core of our binding if we are bound to more
+ * than one (if we are bound to a single core there is nothing spare,
+ * so stay unbound and let the OS place the thread).
+ */
+static void
+opal_progress_thread_pick_core(void)
+{
+    hwloc_obj_t core = NULL;
+    hwloc_cpuset_t bound;
+    unsigned ncores;
+
+    if (NULL == opal_hwloc_topology &&
+        OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return;
+    }
+
+    if (0 <= opal_progress_thread_core) {
+        core = hwloc_get_obj_by_type(opal_hwloc_topology, HWLOC_OBJ_CORE,
+                                     (unsigned) opal_progress_thread_core);
+    } else if (!opal_hwloc_base_reserve_helper_core) {
+        /* with a reserved helper core the engine binds itself there */
+        bound = hwloc_bitmap_alloc();
+        if (NULL == bound) {
+            return;
+        }
+        if (0 == hwloc_get_cpubind(opal_hwloc_topology, bound,
+                                   HWLOC_CPUBIND_PROCESS)) {
+            ncores = hwloc_get_nbobjs_inside_cpuset_by_type(opal_hwloc_topology,
+                                                            bound, HWLOC_OBJ_CORE);
+            if (1 < ncores) {
+                core = hwloc_get_obj_inside_cpuset_by_type(opal_hwloc_topology,
+                                                           bound, HWLOC_OBJ_CORE,
+                                                           ncores - 1);
+            }
+        }
+        hwloc_bitmap_free(bound);
+    }
+
+    if (NULL != core) {
+        progress_thread_cpuset = hwloc_bitmap_dup(core->cpuset);
+        OPAL_OUTPUT((debug_output, "progress: binding the progress thread to core %u",
+                     core->logical_index));
+    }
+}
+#endif  /* OPAL_HAVE_HWLOC */
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+
+
+int
+opal_progress_thread_start(void)
+{
+#if OPAL_ENABLE_MULTI_THREADS
+    int ret;
+
+    if (!opal_progress_thread_enable || opal_progress_thread_active) {
+        return OPAL_SUCCESS;
+    }
+
+#if OPAL_HAVE_HWLOC
+    opal_progress_thread_pick_core();
+#endif
+
+    /* the callbacks will now run concurrently with the application */
+    opal_set_using_threads(true);
+
+    OBJ_CONSTRUCT(&progress_thread, opal_thread_t);
+    progress_thread.t_run = opal_progress_thread_engine;
+    progress_thread.t_arg = NULL;
+
+    progress_thread_run = true;
+    opal_progress_thread_active = true;
+    opal_atomic_wmb();
+    if (OPAL_SUCCESS != (ret = opal_thread_start(&progress_thread))) {
+        progress_thread_run = false;
+        opal_progress_thread_active = false;
+        OBJ_DESTRUCT(&progress_thread);
+        return ret;
+    }
+
+    OPAL_OUTPUT((debug_output, "progress: progress thread started"));
+    return OPAL_SUCCESS;
+#else
+    if (opal_progress_thread_enable) {
+        opal_output(0, "progress: opal_progress_thread was requested, but this "
+                    "build has no thread support; progress stays synchronous");
+    }
+    return OPAL_SUCCESS;
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+}
+
+
+int
+opal_progress_thread_stop(void)
+{
+#if OPAL_ENABLE_MULTI_THREADS
+    if (!opal_progress_thread_active) {
+        return OPAL_SUCCESS;
+    }
+
+    progress_thread_run = false;
+    opal_atomic_wmb();
+    opal_thread_join(&progress_thread, NULL);
+    OBJ_DESTRUCT(&progress_thread);
+
+    /* only now may the calling threads progress again */
+    opal_progress_thread_active = false;
+    opal_atomic_wmb();
+
+#if OPAL_HAVE_HWLOC
+    if (NULL != progress_thread_cpuset) {
+        hwloc_bitmap_free(progress_thread_cpuset);
+        progress_thread_cpuset = NULL;
+    }
+#endif
+
+    OPAL_OUTPUT((debug_output, "progress: progress thread stopped"));
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
+    return OPAL_SUCCESS;
 }
 
 
@@ -325,36 +787,95 @@ opal_progress_set_event_poll_rate(int polltime)
 }
 
 
-int
-opal_progress_register(opal_progress_callback_t cb)
+/* add cb to one of the callback arrays, progress_lock held */
+static int
+_opal_progress_register(opal_progress_callback_t cb, opal_progress_callback_t **cbs,
+                        size_t *cbs_len, size_t *cbs_size)
 {
-    int ret = OPAL_SUCCESS;
     size_t index;
 
-#if OPAL_ENABLE_MULTI_THREADS
-    opal_atomic_lock(&progress_lock);
-#endif
-
     /* see if we need to allocate more space */
-    if (callbacks_len + 1 > callbacks_size) {
+    if (*cbs_len + 1 > *cbs_size) {
         opal_progress_callback_t *tmp;
-        tmp = (opal_progress_callback_t*)realloc(callbacks, sizeof(opal_progress_callback_t) * (callbacks_size + 4));
+        tmp = (opal_progress_callback_t*)realloc(*cbs, sizeof(opal_progress_callback_t) * (*cbs_size + 4));
         if (tmp == NULL) {
-            ret = OPAL_ERR_TEMP_OUT_OF_RESOURCE;
-            goto cleanup;
+            return OPAL_ERR_TEMP_OUT_OF_RESOURCE;
         }
         /* registering fake callbacks to fill callbacks[] */
-        for( index = callbacks_len + 1 ;  index < callbacks_size + 4 ; index++) {
+        for( index = *cbs_len + 1 ;  index < *cbs_size + 4 ; index++) {
             tmp[index] = &fake_cb;
         }
 
-        callbacks = tmp;
-        callbacks_size += 4;
+        *cbs = tmp;
+        *cbs_size += 4;
+    }
+
+    (*cbs)[(*cbs_len)++] = cb;
+    return OPAL_SUCCESS;
+}
+
+/* remove cb from one of the callback arrays, progress_lock held */
+static int
+_opal_progress_unregister(opal_progress_callback_t cb, opal_progress_callback_t *cbs,
+                          size_t *cbs_len)
+{
+    size_t i;
+
+    for (i = 0 ; i < *cbs_len ; ++i) {
+        if (cb == cbs[i]) {
+            break;
+        }
+    }
+    if (i == *cbs_len) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+    cbs[i] = &fake_cb;
+
+    /* If callbacks_len is 1, it will soon be 0, so no need to do any
+       repacking.  size_t can be unsigned, so 0 - 1 is bad for a loop
+       condition :). */
+    if (*cbs_len > 1 ) {
+        /* now tightly pack the array */
+        for ( ; i < *cbs_len - 1 ; ++i) {
+            cbs[i] = cbs[i + 1];
+        }
     }
+    cbs[*cbs_len - 1] = &fake_cb;
+    (*cbs_len)--;
+    return OPAL_SUCCESS;
+}
+
+int
+opal_progress_register(opal_progress_callback_t cb)
+{
+    int ret;
 
-    callbacks[callbacks_len++] = cb;
+#if OPAL_ENABLE_MULTI_THREADS
+    opal_atomic_lock(&progress_lock);
+#endif
 
- cleanup:
+    /* a callback is in one class only */
+    (void) _opal_progress_unregister(cb, callbacks_lp, &callbacks_lp_len);
+    ret = _opal_progress_register(cb, &callbacks, &callbacks_len, &callbacks_size);
+
+#if OPAL_ENABLE_MULTI_THREADS
+    opal_atomic_unlock(&progress_lock);
+#endif
+
+    return ret;
+}
+
+int
+opal_progress_register_lp(opal_progress_callback_t cb)
+{
+    int ret;
+
+#if OPAL_ENABLE_MULTI_THREADS
+    opal_atomic_lock(&progress_lock);
+#endif
+
+    (void) _opal_progress_unregister(cb, callbacks, &callbacks_len);
+    ret = _opal_progress_register(cb, &callbacks_lp, &callbacks_lp_len, &callbacks_lp_size);
 
 #if OPAL_ENABLE_MULTI_THREADS
     opal_atomic_unlock(&progress_lock);
@@ -366,35 +887,16 @@ opal_progress_register(opal_progress_callback_t cb)
 int
 opal_progress_unregister(opal_progress_callback_t cb)
 {
-    size_t i;
-    int ret = OPAL_ERR_NOT_FOUND;
+    int ret;
 
 #if OPAL_ENABLE_MULTI_THREADS
     opal_atomic_lock(&progress_lock);
 #endif
 
-    for (i = 0 ; i < callbacks_len ; ++i) {
-        if (cb == callbacks[i]) {
-            callbacks[i] = &fake_cb;
-            ret = OPAL_SUCCESS;
-            break;
-        }
-    }
-    
-    /* If we found the function we're unregistering: If callbacks_len
-       is 0, we're not goig to do anything interesting anyway, so
-       skip.  If callbacks_len is 1, it will soon be 0, so no need to
-       do any repacking.  size_t can be unsigned, so 0 - 1 is bad for
-       a loop condition :). */
-    if (OPAL_SUCCESS == ret) {
-        if (callbacks_len > 1 ) {
-            /* now tightly pack the array */
-            for ( ; i < callbacks_len - 1 ; ++i) {
-                callbacks[i] = callbacks[i + 1];
-            }
-        }
-        callbacks[callbacks_len - 1] = &fake_cb;
-        callbacks_len--;
+    ret = _opal_progress_unregister(cb, callbacks, &callbacks_len);
+    if (OPAL_SUCCESS != ret) {
+        /* try the low priority ones */
+        ret = _opal_progress_unregister(cb, callbacks_lp, &callbacks_lp_len);
     }
 
 #if OPAL_ENABLE_MULTI_THREADS
@@ -163,6 +163,17 @@ typedef int (*opal_progress_callback_t)(void);
  */
 OPAL_DECLSPEC int opal_progress_register(opal_progress_callback_t cb);
 
+/**
+ * Register an event to be progressed with low priority
+ *
+ * For the components whose work is rare or not latency sensitive
+ * (housekeeping, file I/O completions): the callback is only called
+ * every opal_progress_lp_call_ratio calls to opal_progress().  A
+ * callback is in one class only; registering it again moves it.
+ * opal_progress_unregister() removes it from either class.
+ */
+OPAL_DECLSPEC int opal_progress_register_lp(opal_progress_callback_t cb);
+
 
 /**
  * Deregister previously registered event
@@ -173,6 +184,78 @@ OPAL_DECLSPEC int opal_progress_register(opal_progress_callback_t cb);
 OPAL_DECLSPEC int opal_progress_unregister(opal_progress_callback_t cb);
 
 
+/**
+ * Start the progress thread
+ *
+ * If the opal_progress_thread MCA parameter is set, fork off a thread
+ * (bound to a spare core when hwloc can find one) that continuously
+ * drives the registered callbacks and the event library.  While it
+ * runs, opal_progress() called from any other thread does not touch
+ * the callbacks or the event base; it only yields (if so configured).
+ * Does nothing if the parameter is not set or the thread is already
+ * running.
+ */
+OPAL_DECLSPEC int opal_progress_thread_start(void);
+
+
+/**
+ * Stop the progress thread
+ *
+ * Stop and join the progress thread, if one is running.  After this
+ * returns, opal_progress() progresses from the calling thread again.
+ */
+OPAL_DECLSPEC int opal_progress_thread_stop(void);
+
+
+/**
+ * True while the progress thread owns the progress engine.  Threads
+ * waiting on a completion flag can then poll the flag directly
+ * instead of calling opal_progress().
+ */
+OPAL_DECLSPEC extern volatile bool opal_progress_thread_active;
+
+/**
+ * Completion channel arm function typedef
+ *
+ * Registered with opal_progress_register_arm() by the components that
+ * can wake a blocked process (a file descriptor in the event library
+ * that becomes readable on arrival).  Called right before the hybrid
+ * wait blocks: request a notification for the next arrival, then
+ * check for what arrived in the meantime.
+ *
+ * @return         Number of events already pending; the wait does not
+ *                 block if any
+ */
+typedef int (*opal_progress_arm_fn_t)(void);
+
+/**
+ * Register or deregister a completion channel
+ */
+OPAL_DECLSPEC int opal_progress_register_arm(opal_progress_arm_fn_t arm);
+OPAL_DECLSPEC int opal_progress_unregister_arm(opal_progress_arm_fn_t arm);
+
+/**
+ * Progress from a blocking wait
+ *
+ * Same as opal_progress(), unless the opal_progress_wait_block MCA
+ * parameter is set: once the wait has been idle for the spin interval
+ * learned from the previous waits, arm the completion channels and
+ * block in the event library until something arrives, for at most
+ * opal_progress_wait_block_max microseconds.  Only for the loops that
+ * have nothing else to do until the progress engine completes them;
+ * start every such wait with opal_progress_wait_begin().
+ */
+OPAL_DECLSPEC void opal_progress_wait(void);
+
+/** true when opal_progress_wait() may block */
+OPAL_DECLSPEC extern bool opal_progress_wait_block;
+OPAL_DECLSPEC extern uint64_t opal_progress_wait_idle_since;
+
+static inline void opal_progress_wait_begin(void)
+{
+    opal_progress_wait_idle_since = 0;
+}
+
 OPAL_DECLSPEC extern volatile int32_t opal_progress_thread_count;
 OPAL_DECLSPEC extern int opal_progress_spin_count;
 
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2014      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <string.h>
+
+#include "opal/class/opal_list.h"
+#include "opal/constants.h"
+#include "opal/mca/event/event.h"
+#include "opal/mca/hwloc/base/base.h"
+#include "opal/threads/mutex.h"
+#include "opal/threads/threads.h"
+#include "opal/util/output.h"
+
+#include "opal/runtime/opal_progress_threads.h"
+
+static const char *default_name = "OPAL-wide async progress thread";
+
+#if OPAL_ENABLE_MULTI_THREADS
+
+typedef struct {
+    opal_list_item_t super;
+    char *name;
+    int refcount;
+    opal_event_base_t *ev_base;
+    /* keep the loop blocked on something when no other events
+     * are registered, instead of spinning */
+    opal_event_t keepalive;
+    volatile bool active;
+    opal_thread_t engine;
+} opal_progress_tracker_t;
+
+static void tracker_con(opal_progress_tracker_t *p)
+{
+    p->name = NULL;
+    p->refcount = 1;
+    p->ev_base = NULL;
+    p->active = false;
+    OBJ_CONSTRUCT(&p->engine, opal_thread_t);
+}
+static void tracker_des(opal_progress_tracker_t *p)
+{
+    if (NULL != p->name) {
+        free(p->name);
+    }
+    if (NULL != p->ev_base) {
+        opal_event_base_free(p->ev_base);
+    }
+    OBJ_DESTRUCT(&p->engine);
+}
+static OBJ_CLASS_INSTANCE(opal_progress_tracker_t,
+                          opal_list_item_t,
+                          tracker_con, tracker_des);
+
+static bool inited = false;
+static opal_list_t tracking;
+static opal_mutex_t tracking_lock;
+static struct timeval long_timeout = {3600, 0};
+
+static void keepalive_cb(int fd, short args, void *cbdata)
+{
+    /* nothing to do - this only exists to block the loop */
+}
+
+static void *progress_engine(opal_object_t *obj)
+{
+    opal_thread_t *t = (opal_thread_t*)obj;
+    opal_progress_tracker_t *trk = (opal_progress_tracker_t*)t->t_arg;
+
+#if OPAL_HAVE_HWLOC
+    (void) opal_hwloc_base_bind_helper_thread(trk->name);
+#endif
+
+    while (trk->active) {
+        opal_event_loop(trk->ev_base, OPAL_EVLOOP_ONCE);
+    }
+    return OPAL_THREAD_CANCELLED;
+}
+
+static void stop_tracker(opal_progress_tracker_t *trk)
+{
+    trk->active = false;
+    opal_atomic_wmb();
+    /* wake the thread out of the blocking loop */
+    opal_event_base_loopbreak(trk->ev_base);
+    opal_thread_join(&trk->engine, NULL);
+    opal_event_del(&trk->keepalive);
+}
+
+opal_event_base_t *opal_progress_thread_init(const char *name)
+{
+    opal_progress_tracker_t *trk;
+    int rc;
+
+    if (!inited) {
+        OBJ_CONSTRUCT(&tracking, opal_list_t);
+        OBJ_CONSTRUCT(&tracking_lock, opal_mutex_t);
+        inited = true;
+    }
+
+    if (NULL == name) {
+        name = default_name;
+    }
+
+    OPAL_THREAD_LOCK(&tracking_lock);
+    OPAL_LIST_FOREACH(trk, &tracking, opal_progress_tracker_t) {
+        if (0 == strcmp(name, trk->name)) {
+            ++trk->refcount;
+            OPAL_THREAD_UNLOCK(&tracking_lock);
+            return trk->ev_base;
+        }
+    }
+
+    trk = OBJ_NEW(opal_progress_tracker_t);
+    trk->name = strdup(name);
+    if (NULL == (trk->ev_base = opal_event_base_create_isolated())) {
+        OPAL_THREAD_UNLOCK(&tracking_lock);
+        OBJ_RELEASE(trk);
+        return NULL;
+    }
+
+    opal_event_set(trk->ev_base, &trk->keepalive, -1, OPAL_EV_PERSIST,
+                   keepalive_cb, NULL);
+    opal_event_add(&trk->keepalive, &long_timeout);
+
+    /* events registered on this base fire on a second thread */
+    opal_set_using_threads(true);
+
+    trk->engine.t_run = progress_engine;
+    trk->engine.t_arg = trk;
+    trk->active = true;
+    opal_atomic_wmb();
+    if (OPAL_SUCCESS != (rc = opal_thread_start(&trk->engine))) {
+        opal_output(0, "progress: failed to start progress thread \"%s\": %d",
+                    name, rc);
+        trk->active = false;
+        opal_event_del(&trk->keepalive);
+        OPAL_THREAD_UNLOCK(&tracking_lock);
+        OBJ_RELEASE(trk);
+        return NULL;
+    }
+
+    opal_list_append(&tracking, &trk->super);
+    OPAL_THREAD_UNLOCK(&tracking_lock);
+    return trk->ev_base;
+}
+
+int opal_progress_thread_finalize(const char *name)
+{
+    opal_progress_tracker_t *trk;
+
+    if (!inited) {
+        return OPAL_ERR_NOT_FOUND;
+    }
+
+    if (NULL == name) {
+        name = default_name;
+    }
+
+    OPAL_THREAD_LOCK(&tracking_lock);
+    OPAL_LIST_FOREACH(trk, &tracking, opal_progress_tracker_t) {
+        if (0 == strcmp(name, trk->name)) {
+            if (0 < --trk->refcount) {
+                OPAL_THREAD_UNLOCK(&tracking_lock);
+                return OPAL_SUCCESS;
+            }
+            opal_list_remove_item(&tracking, &trk->super);
+            OPAL_THREAD_UNLOCK(&tracking_lock);
+            stop_tracker(trk);
+            OBJ_RELEASE(trk);
+            return OPAL_SUCCESS;
+        }
+    }
+    OPAL_THREAD_UNLOCK(&tracking_lock);
+
+    return OPAL_ERR_NOT_FOUND;
+}
+
+#else
+
+opal_event_base_t *opal_progress_thread_init(const char *name)
+{
+    /* no threads - everything has to share the main base */
+    return opal_event_base;
+}
+
+int opal_progress_thread_finalize(const char *name)
+{
+    return OPAL_SUCCESS;
+}
+
+#endif  /* OPAL_ENABLE_MULTI_THREADS */
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2014      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * Named event bases, each progressed by its own thread.  Subsystems
+ * that would otherwise share the single opal_event_base (and so wait
+ * on each other's callbacks) can ask for a private base here and
+ * register their events on it.
+ */
+
+#ifndef OPAL_RUNTIME_OPAL_PROGRESS_THREADS_H
+#define OPAL_RUNTIME_OPAL_PROGRESS_THREADS_H
+
+#include "opal_config.h"
+
+#include "opal/mca/event/event.h"
+
+BEGIN_C_DECLS
+
+/**
+ * Get the event base with the given name, creating it and starting
+ * its progress thread on first use.  Each call takes a reference
+ * that must be returned with opal_progress_thread_finalize().
+ *
+ * Without thread support there is nobody to progress a private base,
+ * so the global opal_event_base is returned instead.
+ *
+ * @param name  Name of the base (NULL selects "OPAL-wide async progress thread")
+ * @return      The event base, or NULL on error
+ */
+OPAL_DECLSPEC opal_event_base_t *opal_progress_thread_init(const char *name);
+
+/**
+ * Drop a reference to the named event base.  When the last reference
+ * goes, the progress thread is stopped and the base is freed.
+ *
+ * @param name  Name given to opal_progress_thread_init()
+ * @return      OPAL_SUCCESS or OPAL_ERR_NOT_FOUND
+ */
+OPAL_DECLSPEC int opal_progress_thread_finalize(const char *name);
+
+END_C_DECLS
+
+#endif /* OPAL_RUNTIME_OPAL_PROGRESS_THREADS_H */
@@ -27,6 +27,10 @@ static void opal_condition_construct(opal_condition_t *c)
     c->c_signaled = 0;
 #if OPAL_HAVE_POSIX_THREADS
     pthread_cond_init(&c->c_cond, NULL);
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+    c->c_seq = 0;
+    c->c_parked = 0;
+#endif
 #endif
     c->name = NULL;
 }
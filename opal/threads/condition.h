@@ -52,6 +52,11 @@ struct opal_condition_t {
     volatile int c_signaled;
 #if OPAL_HAVE_POSIX_THREADS
     pthread_cond_t c_cond;
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+    /* waiters with an adaptive mutex sleep on c_seq instead of c_cond */
+    volatile int32_t c_seq;
+    volatile int32_t c_parked;
+#endif
 #elif OPAL_HAVE_SOLARIS_THREADS
     cond_t c_cond;
 #endif
@@ -76,6 +81,16 @@ static inline int opal_condition_wait(opal_condition_t *c, opal_mutex_t *m)
 
     if (opal_using_threads()) {
 #if OPAL_HAVE_POSIX_THREADS && OPAL_ENABLE_MULTI_THREADS
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+        if (m->m_adaptive) {
+            int32_t seq = c->c_seq;
+            opal_atomic_add_32(&c->c_parked, 1);
+            opal_mutex_unlock(m);
+            rc = opal_mutex_futex_wait(&c->c_seq, seq, NULL);
+            opal_mutex_lock(m);
+            opal_atomic_add_32(&c->c_parked, -1);
+        } else
+#endif
         rc = pthread_cond_wait(&c->c_cond, &m->m_lock_pthread);
 #elif OPAL_HAVE_SOLARIS_THREADS && OPAL_ENABLE_MULTI_THREADS
         rc = cond_wait(&c->c_cond, &m->m_lock_solaris);
@@ -96,8 +111,9 @@ static inline int opal_condition_wait(opal_condition_t *c, opal_mutex_t *m)
         }
 #endif
     } else {
+        opal_progress_wait_begin();
         while (c->c_signaled == 0) {
-            opal_progress();
+            opal_progress_wait();
             OPAL_CR_TEST_CHECKPOINT_READY_STALL();
         }
     }
@@ -129,6 +145,16 @@ static inline int opal_condition_timedwait(opal_condition_t *c,
     c->c_waiting++;
     if (opal_using_threads()) {
 #if OPAL_HAVE_POSIX_THREADS && OPAL_ENABLE_MULTI_THREADS
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+        if (m->m_adaptive) {
+            int32_t seq = c->c_seq;
+            opal_atomic_add_32(&c->c_parked, 1);
+            opal_mutex_unlock(m);
+            rc = opal_mutex_futex_wait(&c->c_seq, seq, abstime);
+            opal_mutex_lock(m);
+            opal_atomic_add_32(&c->c_parked, -1);
+        } else
+#endif
         rc = pthread_cond_timedwait(&c->c_cond, &m->m_lock_pthread, abstime);
 #elif OPAL_HAVE_SOLARIS_THREADS && OPAL_ENABLE_MULTI_THREADS
         /* deal with const-ness */
@@ -180,6 +206,12 @@ static inline int opal_condition_signal(opal_condition_t *c)
         c->c_signaled++;
 #if OPAL_HAVE_POSIX_THREADS && OPAL_ENABLE_MULTI_THREADS
         if(opal_using_threads()) {
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+            if (c->c_parked) {
+                opal_atomic_add_32(&c->c_seq, 1);
+                opal_mutex_futex_wake(&c->c_seq, 1);
+            }
+#endif
             pthread_cond_signal(&c->c_cond);
         }
 #elif OPAL_HAVE_SOLARIS_THREADS && OPAL_ENABLE_MULTI_THREADS
@@ -196,6 +228,12 @@ static inline int opal_condition_broadcast(opal_condition_t *c)
     c->c_signaled = c->c_waiting;
 #if OPAL_HAVE_POSIX_THREADS && OPAL_ENABLE_MULTI_THREADS
     if (opal_using_threads()) {
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+        if (c->c_parked) {
+            opal_atomic_add_32(&c->c_seq, 1);
+            opal_mutex_futex_wake(&c->c_seq, INT32_MAX);
+        }
+#endif
         if( 1 == c->c_waiting ) {
             pthread_cond_signal(&c->c_cond);
         } else {
@@ -20,6 +20,25 @@
 
 #include "opal_config.h"
 
+#include <errno.h>
+#ifdef HAVE_SCHED_H
+#include <sched.h>
+#endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+#if defined(HAVE_LINUX_FUTEX_H) && defined(HAVE_SYS_SYSCALL_H)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define OPAL_MUTEX_HAVE_FUTEX 1
+#else
+#define OPAL_MUTEX_HAVE_FUTEX 0
+#endif
+
 #include "opal/threads/mutex.h"
 
 /*
@@ -29,6 +48,135 @@
 bool opal_uses_threads = false;
 bool opal_mutex_check_locks = false;
 
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+bool opal_mutex_adaptive = OPAL_MUTEX_DEFAULT_ADAPTIVE;
+int opal_mutex_spin_max = 1000;
+size_t opal_mutex_contended = 0;
+size_t opal_mutex_parked = 0;
+
+static inline void opal_mutex_pause(void)
+{
+#if OPAL_C_GCC_INLINE_ASSEMBLY && (defined(__x86_64__) || defined(__i386__))
+    __asm__ __volatile__ ("pause" : : : "memory");
+#elif OPAL_C_GCC_INLINE_ASSEMBLY && defined(__aarch64__)
+    __asm__ __volatile__ ("yield" : : : "memory");
+#endif
+}
+
+int opal_mutex_futex_wait(volatile int32_t *addr, int32_t val,
+                          const struct timespec *abstime)
+{
+#if OPAL_MUTEX_HAVE_FUTEX
+    int rc;
+
+    if (NULL == abstime) {
+        rc = syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+    } else {
+        rc = syscall(SYS_futex, addr, FUTEX_WAIT_BITSET_PRIVATE | FUTEX_CLOCK_REALTIME,
+                     val, abstime, NULL, FUTEX_BITSET_MATCH_ANY);
+    }
+    return (0 > rc && ETIMEDOUT == errno) ? ETIMEDOUT : 0;
+#else
+    struct timeval tv;
+
+    if (NULL != abstime) {
+        gettimeofday(&tv, NULL);
+        if (tv.tv_sec > abstime->tv_sec ||
+            (tv.tv_sec == abstime->tv_sec && tv.tv_usec * 1000 >= abstime->tv_nsec)) {
+            return ETIMEDOUT;
+        }
+    }
+    if (*addr == val) {
+#ifdef HAVE_SCHED_H
+        sched_yield();
+#endif
+    }
+    return 0;
+#endif
+}
+
+void opal_mutex_futex_wake(volatile int32_t *addr, int count)
+{
+#if OPAL_MUTEX_HAVE_FUTEX
+    (void) syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+#else
+    (void) addr;
+    (void) count;
+#endif
+}
+
+/* the tickets share the 32 wake up bits of the futex, a waiter woken
+   for another ticket checks and parks again */
+#define OPAL_MUTEX_TICKET_BIT(ticket) (1u << (((uint32_t) (ticket) >> 1) & 31))
+
+void opal_mutex_futex_wait_ticket(volatile int32_t *addr, int32_t val, int32_t ticket)
+{
+#if OPAL_MUTEX_HAVE_FUTEX
+    (void) syscall(SYS_futex, addr, FUTEX_WAIT_BITSET_PRIVATE, val, NULL, NULL,
+                   OPAL_MUTEX_TICKET_BIT(ticket));
+#else
+    (void) ticket;
+    (void) opal_mutex_futex_wait(addr, val, NULL);
+#endif
+}
+
+void opal_mutex_futex_wake_ticket(volatile int32_t *addr, int32_t ticket)
+{
+#if OPAL_MUTEX_HAVE_FUTEX
+    (void) syscall(SYS_futex, addr, FUTEX_WAKE_BITSET_PRIVATE, INT32_MAX, NULL, NULL,
+                   OPAL_MUTEX_TICKET_BIT(ticket));
+#else
+    (void) addr;
+    (void) ticket;
+#endif
+}
+
+void opal_mutex_adaptive_wait(opal_mutex_t *m, int32_t ticket)
+{
+    int32_t serving, budget, spins, i;
+
+    opal_atomic_add_size_t(&opal_mutex_contended, 1);
+
+    /* spin up to twice the usual wait, the way glibc's adaptive
+       mutexes do, so the budget can grow when the lock gets busier.
+       The budget counts pauses */
+    budget = 2 * m->m_spin + 10;
+    if (budget > opal_mutex_spin_max) {
+        budget = opal_mutex_spin_max;
+    }
+
+    for (spins = 0 ; spins < budget ; ) {
+        serving = opal_atomic_load_acq_32(&m->m_serving) & ~1;
+        if (serving == ticket) {
+            m->m_spin += (spins - m->m_spin) / 8;
+            return;
+        }
+        /* the farther from the head of the queue, the longer until our
+           turn: keep off the cache line in the meantime */
+        for (i = (int32_t) ((uint32_t) ticket - (uint32_t) serving) / 2 ;
+             i > 0 && spins < budget ; --i, ++spins) {
+            opal_mutex_pause();
+        }
+    }
+
+    /* the holder is not going anywhere soon: park until served.  The
+       parked bit is set before sleeping on the value that carries it,
+       so an unlock in between makes the futex wait return at once */
+    opal_atomic_add_size_t(&opal_mutex_parked, 1);
+    for (;;) {
+        serving = opal_atomic_load_acq_32(&m->m_serving);
+        if ((serving & ~1) == ticket) {
+            break;
+        }
+        if (!(serving & 1) && !opal_atomic_cmpset_32(&m->m_serving, serving, serving | 1)) {
+            continue;
+        }
+        opal_mutex_futex_wait_ticket(&m->m_serving, serving | 1, ticket);
+    }
+    m->m_spin += (budget - m->m_spin) / 8;
+}
+#endif  /* OPAL_HAVE_ADAPTIVE_MUTEX */
+
 
 static void opal_mutex_construct(opal_mutex_t *m)
 {
@@ -55,6 +203,13 @@ static void opal_mutex_construct(opal_mutex_t *m)
 
 #endif /* OPAL_ENABLE_DEBUG */
 
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+    m->m_adaptive = opal_mutex_adaptive;
+    m->m_next = 0;
+    m->m_serving = 0;
+    m->m_spin = 0;
+#endif
+
 #elif OPAL_HAVE_SOLARIS_THREADS
     mutex_init(&m->m_lock_solaris, USYNC_THREAD, NULL);
 #endif
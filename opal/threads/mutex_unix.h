@@ -47,14 +47,40 @@
 
 #include "opal/class/opal_object.h"
 #include "opal/sys/atomic.h"
+#include "opal/prefetch.h"
+
+/*
+ * The adaptive mutexes are a ticket lock: a thread takes the next
+ * ticket and waits until it is served.  It spins for a budget learned
+ * from the previous acquisitions of the same mutex, backing off in
+ * proportion to its distance from the head of the queue, then parks
+ * on the futex of the serving counter, in the wake up bit of its
+ * ticket so that an unlock only wakes the next in line.  Tickets step
+ * by 2, bit 0 of m_serving tells the unlock that waiters are parked.
+ */
+#if OPAL_HAVE_POSIX_THREADS && OPAL_HAVE_ATOMIC_CMPSET_32 && OPAL_HAVE_ATOMIC_MATH_32
+#define OPAL_HAVE_ADAPTIVE_MUTEX 1
+#else
+#define OPAL_HAVE_ADAPTIVE_MUTEX 0
+#endif
 
 BEGIN_C_DECLS
 
+struct timespec;
+
 struct opal_mutex_t {
     opal_object_t super;
 
 #if OPAL_HAVE_POSIX_THREADS
     pthread_mutex_t m_lock_pthread;
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+    /* the kind is picked at construction and never changes */
+    bool m_adaptive;
+    volatile int32_t m_next;
+    volatile int32_t m_serving;
+    /* learned spin budget, only updated by the lock holder */
+    int32_t m_spin;
+#endif
 #elif OPAL_HAVE_SOLARIS_THREADS
     mutex_t m_lock_solaris;
 #endif
@@ -69,6 +95,49 @@ struct opal_mutex_t {
 };
 OPAL_DECLSPEC OBJ_CLASS_DECLARATION(opal_mutex_t);
 
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+
+/** mutexes constructed from now on are adaptive (opal_mutex_adaptive) */
+OPAL_DECLSPEC extern bool opal_mutex_adaptive;
+/** most iterations an adaptive mutex spins before it parks */
+OPAL_DECLSPEC extern int opal_mutex_spin_max;
+/** acquisitions of an adaptive mutex that had to wait, and that parked */
+OPAL_DECLSPEC extern size_t opal_mutex_contended;
+OPAL_DECLSPEC extern size_t opal_mutex_parked;
+
+/**
+ * Wait for @a ticket to be served: the slow path of opal_mutex_lock()
+ * on an adaptive mutex.
+ */
+OPAL_DECLSPEC void opal_mutex_adaptive_wait(opal_mutex_t *m, int32_t ticket);
+
+/**
+ * Block while *@a addr is @a val, at most until @a abstime
+ * (CLOCK_REALTIME) when it is not NULL.  Returns ETIMEDOUT on timeout
+ * and 0 otherwise, spurious wakeups included.  Without futexes it only
+ * yields the processor.
+ */
+OPAL_DECLSPEC int opal_mutex_futex_wait(volatile int32_t *addr, int32_t val,
+                                        const struct timespec *abstime);
+
+/**
+ * Park on @a addr while it is @a val, in the wake up bit of @a ticket.
+ */
+OPAL_DECLSPEC void opal_mutex_futex_wait_ticket(volatile int32_t *addr, int32_t val,
+                                                int32_t ticket);
+
+/**
+ * Wake up to @a count threads blocked on @a addr.
+ */
+OPAL_DECLSPEC void opal_mutex_futex_wake(volatile int32_t *addr, int count);
+
+/**
+ * Wake the threads parked on @a addr in the wake up bit of @a ticket.
+ */
+OPAL_DECLSPEC void opal_mutex_futex_wake_ticket(volatile int32_t *addr, int32_t ticket);
+
+#endif  /* OPAL_HAVE_ADAPTIVE_MUTEX */
+
 /************************************************************************
  *
  * mutex operations (non-atomic versions)
@@ -83,6 +152,18 @@ OPAL_DECLSPEC OBJ_CLASS_DECLARATION(opal_mutex_t);
 
 static inline int opal_mutex_trylock(opal_mutex_t *m)
 {
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+    if (m->m_adaptive) {
+        int32_t next = m->m_next;
+
+        /* free if nobody holds a ticket past the one being served */
+        if ((opal_atomic_load_acq_32(&m->m_serving) & ~1) == next &&
+            opal_atomic_cmpset_acq_32(&m->m_next, next, (int32_t) ((uint32_t) next + 2))) {
+            return 0;
+        }
+        return EBUSY;
+    }
+#endif
 #if OPAL_ENABLE_DEBUG
     int ret = pthread_mutex_trylock(&m->m_lock_pthread);
     if (ret == EDEADLK) {
@@ -98,6 +179,16 @@ static inline int opal_mutex_trylock(opal_mutex_t *m)
 
 static inline void opal_mutex_lock(opal_mutex_t *m)
 {
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+    if (m->m_adaptive) {
+        int32_t ticket = (int32_t) ((uint32_t) opal_atomic_add_32(&m->m_next, 2) - 2);
+
+        if (OPAL_UNLIKELY((opal_atomic_load_acq_32(&m->m_serving) & ~1) != ticket)) {
+            opal_mutex_adaptive_wait(m, ticket);
+        }
+        return;
+    }
+#endif
 #if OPAL_ENABLE_DEBUG
     int ret = pthread_mutex_lock(&m->m_lock_pthread);
     if (ret == EDEADLK) {
@@ -112,6 +203,27 @@ static inline void opal_mutex_lock(opal_mutex_t *m)
 
 static inline void opal_mutex_unlock(opal_mutex_t *m)
 {
+#if OPAL_HAVE_ADAPTIVE_MUTEX
+    if (m->m_adaptive) {
+        int32_t serving, next;
+
+        /* serve the next ticket in one go with the parked bit, so a
+           waiter parking concurrently either sees the new value or is
+           seen.  The bit stays set as long as tickets are left: the
+           waiters parked behind the next one are still asleep */
+        do {
+            serving = opal_atomic_load_acq_32(&m->m_serving);
+            next = (int32_t) ((uint32_t) (serving & ~1) + 2);
+            if ((serving & 1) && m->m_next != next) {
+                next |= 1;
+            }
+        } while (!opal_atomic_cmpset_rel_32(&m->m_serving, serving, next));
+        if (OPAL_UNLIKELY(serving & 1)) {
+            opal_mutex_futex_wake_ticket(&m->m_serving, next & ~1);
+        }
+        return;
+    }
+#endif
 #if OPAL_ENABLE_DEBUG
     int ret = pthread_mutex_unlock(&m->m_lock_pthread);
     if (ret == EPERM) {
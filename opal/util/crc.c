@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2006 The University of Tennessee and The University
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -33,6 +33,15 @@
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif  /* HAVE_UNISTD_H */
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(HAVE_CPUID_H)
+#include <cpuid.h>
+#endif
+
+#include "opal/sys/atomic.h"
 #include "opal/util/crc.h"
 
 
@@ -52,6 +61,71 @@
 #define INTALIGNED(v) \
     (((intptr_t)v & 3) ? false : true)
 
+/*
+ * The bulk of the checksums goes through 64 byte blocks, copied and
+ * added in vector lanes while they sit in the L1. The lanes wrap around
+ * like the scalar sum does, so the result is the same on every path;
+ * the loops below only take care of the partial words at both ends.
+ */
+#define CSUM_BLOCK 64
+
+#if defined(__SSE2__)
+#define CSUM_BLOCKS_BODY(WORD, ADD)                                     \
+    do {                                                                \
+        __m128i a0 = _mm_setzero_si128(), a1 = a0, a2 = a0, a3 = a0;    \
+        WORD lanes[sizeof(__m128i) / sizeof(WORD)];                     \
+        size_t n, k;                                                    \
+                                                                        \
+        for (n = 0 ; n < done ; n += CSUM_BLOCK) {                      \
+            const __m128i *s = (const __m128i *) (src + n);             \
+            __m128i v0 = _mm_loadu_si128(s), v1 = _mm_loadu_si128(s + 1); \
+            __m128i v2 = _mm_loadu_si128(s + 2), v3 = _mm_loadu_si128(s + 3); \
+                                                                        \
+            if (NULL != dst) {                                          \
+                __m128i *d = (__m128i *) (dst + n);                     \
+                _mm_storeu_si128(d, v0);                                \
+                _mm_storeu_si128(d + 1, v1);                            \
+                _mm_storeu_si128(d + 2, v2);                            \
+                _mm_storeu_si128(d + 3, v3);                            \
+            }                                                           \
+            a0 = ADD(a0, v0);                                           \
+            a1 = ADD(a1, v1);                                           \
+            a2 = ADD(a2, v2);                                           \
+            a3 = ADD(a3, v3);                                           \
+        }                                                               \
+        _mm_storeu_si128((__m128i *) lanes, ADD(ADD(a0, a1), ADD(a2, a3))); \
+        for (k = 0 ; k < sizeof(lanes) / sizeof(WORD) ; ++k) {          \
+            *csum += lanes[k];                                          \
+        }                                                               \
+    } while (0)
+
+static size_t
+csum_blocks_ui(const unsigned char *src, unsigned char *dst, size_t len, unsigned int *csum)
+{
+    size_t done = len & ~((size_t) CSUM_BLOCK - 1);
+
+    CSUM_BLOCKS_BODY(unsigned int, _mm_add_epi32);
+    return done;
+}
+
+static size_t
+csum_blocks_ul(const unsigned char *src, unsigned char *dst, size_t len, unsigned long *csum)
+{
+    size_t done = len & ~((size_t) CSUM_BLOCK - 1);
+
+#if SIZEOF_LONG == 8
+    CSUM_BLOCKS_BODY(unsigned long, _mm_add_epi64);
+#else
+    CSUM_BLOCKS_BODY(unsigned long, _mm_add_epi32);
+#endif
+    return done;
+}
+#else
+/* the word loops do it all */
+#define csum_blocks_ui(src, dst, len, csum) ((size_t) 0)
+#define csum_blocks_ul(src, dst, len, csum) ((size_t) 0)
+#endif  /* defined(__SSE2__) */
+
 /*
  * this version of bcopy_csum() looks a little too long, but it
  * handles cumulative checksumming for arbitrary lengths and address
@@ -62,8 +136,8 @@
  * of bcopy_csum() - Mitch
  */
 
-unsigned long
-opal_bcopy_csum_partial (
+static unsigned long
+bcopy_csum_partial_scalar (
     const void *  source,
     void *  destination,
     size_t copylen,
@@ -409,8 +483,8 @@ opal_bcopy_csum_partial (
     return csum;
 }
 
-unsigned int
-opal_bcopy_uicsum_partial (
+static unsigned int
+bcopy_uicsum_partial_scalar (
     const void *  source,
     void *  destination,
     size_t copylen,
@@ -766,8 +840,8 @@ opal_bcopy_uicsum_partial (
  * called multiple times
  */
 
-unsigned long
-opal_csum_partial (
+static unsigned long
+csum_partial_scalar (
     const void *  source,
     size_t csumlen,
     unsigned long*  lastPartialLong,
@@ -916,8 +990,8 @@ opal_csum_partial (
     return csum;
 }
 
-unsigned int
-opal_uicsum_partial (
+static unsigned int
+uicsum_partial_scalar (
     const void *  source,
     size_t csumlen,
     unsigned int*  lastPartialInt,
@@ -1066,10 +1140,139 @@ opal_uicsum_partial (
     return csum;
 }
 
+/*
+ * The public checksums: the blocks first, starting on a word of the sum
+ * once the partial word carried over from the previous call is full,
+ * then the scalar code for the rest and the state of the next call.
+ */
+
+unsigned long
+opal_bcopy_csum_partial (
+    const void *  source,
+    void *  destination,
+    size_t copylen,
+    size_t csumlen,
+    unsigned long*  lastPartialLong,
+    size_t*  lastPartialLength
+    )
+{
+    const unsigned char *src = (const unsigned char *) source;
+    unsigned char *dst = (unsigned char *) destination;
+    unsigned long csum = 0;
+    size_t len;
+
+    if (copylen >= CSUM_BLOCK) {
+        if (*lastPartialLength) {
+            len = sizeof(unsigned long) - *lastPartialLength;
+            csum += bcopy_csum_partial_scalar(src, dst, len, len,
+                                              lastPartialLong, lastPartialLength);
+            src += len; dst += len; copylen -= len;
+            csumlen = (csumlen > len) ? (csumlen - len) : 0;
+        }
+        len = csum_blocks_ul(src, dst, copylen, &csum);
+        src += len; dst += len; copylen -= len;
+        csumlen = (csumlen > len) ? (csumlen - len) : 0;
+    }
+    return csum + bcopy_csum_partial_scalar(src, dst, copylen, csumlen,
+                                            lastPartialLong, lastPartialLength);
+}
+
+unsigned int
+opal_bcopy_uicsum_partial (
+    const void *  source,
+    void *  destination,
+    size_t copylen,
+    size_t csumlen,
+    unsigned int*  lastPartialInt,
+    size_t*  lastPartialLength
+    )
+{
+    const unsigned char *src = (const unsigned char *) source;
+    unsigned char *dst = (unsigned char *) destination;
+    unsigned int csum = 0;
+    size_t len;
+
+    if (copylen >= CSUM_BLOCK) {
+        if (*lastPartialLength) {
+            len = sizeof(unsigned int) - *lastPartialLength;
+            csum += bcopy_uicsum_partial_scalar(src, dst, len, len,
+                                                lastPartialInt, lastPartialLength);
+            src += len; dst += len; copylen -= len;
+            csumlen = (csumlen > len) ? (csumlen - len) : 0;
+        }
+        len = csum_blocks_ui(src, dst, copylen, &csum);
+        src += len; dst += len; copylen -= len;
+        csumlen = (csumlen > len) ? (csumlen - len) : 0;
+    }
+    return csum + bcopy_uicsum_partial_scalar(src, dst, copylen, csumlen,
+                                              lastPartialInt, lastPartialLength);
+}
+
+unsigned long
+opal_csum_partial (
+    const void *  source,
+    size_t csumlen,
+    unsigned long*  lastPartialLong,
+    size_t* lastPartialLength
+    )
+{
+    const unsigned char *src = (const unsigned char *) source;
+    unsigned long csum = 0;
+    size_t len;
+
+    if (csumlen >= CSUM_BLOCK) {
+        if (*lastPartialLength) {
+            len = sizeof(unsigned long) - *lastPartialLength;
+            csum += csum_partial_scalar(src, len, lastPartialLong, lastPartialLength);
+            src += len; csumlen -= len;
+        }
+        len = csum_blocks_ul(src, NULL, csumlen, &csum);
+        src += len; csumlen -= len;
+    }
+    return csum + csum_partial_scalar(src, csumlen, lastPartialLong, lastPartialLength);
+}
+
+unsigned int
+opal_uicsum_partial (
+    const void *  source,
+    size_t csumlen,
+    unsigned int*  lastPartialInt,
+    size_t*  lastPartialLength
+    )
+{
+    const unsigned char *src = (const unsigned char *) source;
+    unsigned int csum = 0;
+    size_t len;
+
+    if (csumlen >= CSUM_BLOCK) {
+        if (*lastPartialLength) {
+            len = sizeof(unsigned int) - *lastPartialLength;
+            csum += uicsum_partial_scalar(src, len, lastPartialInt, lastPartialLength);
+            src += len; csumlen -= len;
+        }
+        len = csum_blocks_ui(src, NULL, csumlen, &csum);
+        src += len; csumlen -= len;
+    }
+    return csum + uicsum_partial_scalar(src, csumlen, lastPartialInt, lastPartialLength);
+}
+
 /* globals for CRC32 bcopy and calculation routines */
 
-static bool _opal_crc_table_initialized = false;
-static unsigned int _opal_crc_table[256];
+static volatile bool _opal_crc_table_initialized = false;
+/* slicing by 8: _opal_crc_table[k][i] is the CRC of i followed by k zero bytes */
+static unsigned int _opal_crc_table[8][256];
+static unsigned int _opal_crc32c_table[8][256];
+
+static unsigned int crc32c_sw(const unsigned char *src, unsigned char *dst,
+                              size_t len, unsigned int crc);
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(HAVE_CPUID_H)
+static unsigned int crc32c_sse42(const unsigned char *src, unsigned char *dst,
+                                 size_t len, unsigned int crc);
+#endif
+
+/* CRC32C kernel, the SSE4.2 instruction when the CPU has it */
+static unsigned int (*crc32c_kernel)(const unsigned char *src, unsigned char *dst,
+                                     size_t len, unsigned int crc) = crc32c_sw;
 
 /* CRC32 table generation routine - thanks to Charles Michael Heard for his
  * optimized CRC32 code...
@@ -1088,14 +1291,66 @@ void opal_initialize_crc_table(void)
             else
                 crc_accum = (crc_accum << 1);
         }
-        _opal_crc_table[i] = crc_accum;
+        _opal_crc_table[0][i] = crc_accum;
+
+        /* CRC32C is bit reflected */
+        crc_accum = i;
+        for (j = 0; j < 8; j++) {
+            if (crc_accum & 1)
+                crc_accum = (crc_accum >> 1) ^ OPAL_CRC32C_POLYNOMIAL;
+            else
+                crc_accum = (crc_accum >> 1);
+        }
+        _opal_crc32c_table[0][i] = crc_accum;
+    }
+    for (j = 1; j < 8; j++) {
+        for (i = 0; i < 256; i++) {
+            crc_accum = _opal_crc_table[j - 1][i];
+            _opal_crc_table[j][i] = (crc_accum << 8) ^ _opal_crc_table[0][crc_accum >> 24];
+            crc_accum = _opal_crc32c_table[j - 1][i];
+            _opal_crc32c_table[j][i] = (crc_accum >> 8) ^ _opal_crc32c_table[0][crc_accum & 0xff];
+        }
     }
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(HAVE_CPUID_H)
+    {
+        unsigned int eax, ebx, ecx, edx;
+
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && 0 != (ecx & (1 << 20))) {
+            crc32c_kernel = crc32c_sse42;
+        }
+    }
+#endif
+
+    /* the tables are complete before anybody sees the flag */
+    opal_atomic_wmb();
     /* set global bool to true to do this work once! */
     _opal_crc_table_initialized = true;
     return;
 }
 
+/* eight bytes, the most significant bit of the first one first */
+static inline unsigned int crc_step8(unsigned int crc, const unsigned char *p)
+{
+    crc ^= ((unsigned int) p[0] << 24) | ((unsigned int) p[1] << 16) |
+        ((unsigned int) p[2] << 8) | (unsigned int) p[3];
+    return _opal_crc_table[7][crc >> 24] ^ _opal_crc_table[6][(crc >> 16) & 0xff] ^
+        _opal_crc_table[5][(crc >> 8) & 0xff] ^ _opal_crc_table[4][crc & 0xff] ^
+        _opal_crc_table[3][p[4]] ^ _opal_crc_table[2][p[5]] ^
+        _opal_crc_table[1][p[6]] ^ _opal_crc_table[0][p[7]];
+}
+
+static inline unsigned int crc_bytes(unsigned int crc, const unsigned char *p, size_t len)
+{
+    for ( ; len >= 8 ; len -= 8, p += 8) {
+        crc = crc_step8(crc, p);
+    }
+    while (len--) {
+        crc = (crc << 8) ^ _opal_crc_table[0][((crc >> 24) ^ *p++) & 0xff];
+    }
+    return crc;
+}
+
 unsigned int opal_bcopy_uicrc_partial(
     const void *  source, 
     void *  destination,
@@ -1104,99 +1359,131 @@ unsigned int opal_bcopy_uicrc_partial(
     unsigned int partial_crc)
 {
     size_t crclenresidue = (crclen > copylen) ? (crclen - copylen) : 0;
-    register int i, j;
-    register unsigned char t;
-    unsigned int tmp;
+    const unsigned char *src = (const unsigned char *) source;
+    unsigned char *dst = (unsigned char *) destination;
 
     if (!_opal_crc_table_initialized) {
         opal_initialize_crc_table();
     }
 
-    if (INTALIGNED(source) && INTALIGNED(destination)) {
-        register unsigned int *  src = (unsigned int *)source;
-        register unsigned int *  dst = (unsigned int *)destination;
-        register unsigned char *ts, *td;
-        /* copy whole integers */
-        while (copylen >= sizeof(unsigned int)) {
-            tmp = *src++;
-            *dst++ = tmp;
-            ts = (unsigned char *)&tmp;
-            for (j = 0; j < (int)sizeof(unsigned int); j++) {
-                i = ((partial_crc >> 24) ^ *ts++) & 0xff;
-                partial_crc = (partial_crc << 8) ^ _opal_crc_table[i];
-            }
-            copylen -= sizeof(unsigned int);
-        }
-        ts = (unsigned char *)src;
-        td = (unsigned char *)dst;
-        /* copy partial integer */
-        while (copylen--) {
-            t = *ts++;
-            *td++ = t;
-            i = ((partial_crc >> 24) ^ t) & 0xff;
-            partial_crc = (partial_crc << 8) ^ _opal_crc_table[i];
-        }
-        /* calculate CRC over remaining bytes... */
-        while (crclenresidue--) {
-            i = ((partial_crc >> 24) ^ *ts++) & 0xff;
-            partial_crc = (partial_crc << 8) ^ _opal_crc_table[i];
-        }
-    }
-    else {
-        register unsigned char *  src = (unsigned char *)source;
-        register unsigned char *  dst = (unsigned char *)destination;
-        while (copylen--) {
-            t = *src++;
-            *dst++ = t;
-            i = ((partial_crc >> 24) ^ t) & 0xff;
-            partial_crc = (partial_crc << 8) ^ _opal_crc_table[i];
-        }
-        while (crclenresidue--) {
-            i = ((partial_crc >> 24) ^ *src++) & 0xff;
-            partial_crc = (partial_crc << 8) ^ _opal_crc_table[i];
-        }
+    /* the CRC of a block is computed while it is still in the L1 */
+    for ( ; copylen >= CSUM_BLOCK ; copylen -= CSUM_BLOCK) {
+        memcpy(dst, src, CSUM_BLOCK);
+        partial_crc = crc_bytes(partial_crc, src, CSUM_BLOCK);
+        src += CSUM_BLOCK;
+        dst += CSUM_BLOCK;
     }
-
-    return partial_crc;
+    memcpy(dst, src, copylen);
+    /* calculate CRC over remaining bytes... */
+    return crc_bytes(partial_crc, src, copylen + crclenresidue);
 }
 
 
 unsigned int opal_uicrc_partial(
     const void *  source, size_t crclen, unsigned int partial_crc) 
 {
-    register int i, j;
-    register unsigned char * t;
-    unsigned int tmp;
-
     if (!_opal_crc_table_initialized) {
         opal_initialize_crc_table();
     }
-    
-    if (INTALIGNED(source)) {
-        register unsigned int *  src = (unsigned int *)source;
-        while (crclen >= sizeof(unsigned int)) {
-            tmp = *src++;
-            t = (unsigned char *)&tmp;
-            for (j = 0; j < (int)sizeof(unsigned int); j++) {
-                i = ((partial_crc >> 24) ^ *t++) & 0xff;
-                partial_crc = (partial_crc << 8) ^ _opal_crc_table[i];
+
+    return crc_bytes(partial_crc, (const unsigned char *) source, crclen);
+}
+
+/*
+ * CRC32C
+ */
+
+static unsigned int crc32c_sw(const unsigned char *src, unsigned char *dst,
+                              size_t len, unsigned int crc)
+{
+    if (NULL != dst) {
+        memcpy(dst, src, len);
+    }
+    for ( ; len >= 8 ; len -= 8, src += 8) {
+        crc ^= (unsigned int) src[0] | ((unsigned int) src[1] << 8) |
+            ((unsigned int) src[2] << 16) | ((unsigned int) src[3] << 24);
+        crc = _opal_crc32c_table[7][crc & 0xff] ^ _opal_crc32c_table[6][(crc >> 8) & 0xff] ^
+            _opal_crc32c_table[5][(crc >> 16) & 0xff] ^ _opal_crc32c_table[4][crc >> 24] ^
+            _opal_crc32c_table[3][src[4]] ^ _opal_crc32c_table[2][src[5]] ^
+            _opal_crc32c_table[1][src[6]] ^ _opal_crc32c_table[0][src[7]];
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ _opal_crc32c_table[0][(crc ^ *src++) & 0xff];
+    }
+    return crc;
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(HAVE_CPUID_H)
+/* the crc32 instruction of SSE4.2, a word at a time */
+#if defined(__x86_64__)
+typedef uint64_t crc32c_word_t;
+#define CRC32C_SSE42_WORD(crc, w) \
+    __asm__ ("crc32q %1, %0" : "+r" (crc) : "rm" (w))
+#else
+typedef uint32_t crc32c_word_t;
+#define CRC32C_SSE42_WORD(crc, w) \
+    __asm__ ("crc32l %1, %0" : "+r" (crc) : "rm" (w))
+#endif
+
+static unsigned int crc32c_sse42(const unsigned char *src, unsigned char *dst,
+                                 size_t len, unsigned int crc)
+{
+    crc32c_word_t c = crc, w;
+    size_t n;
+
+    if (NULL != dst) {
+        for ( ; len >= CSUM_BLOCK ; len -= CSUM_BLOCK) {
+            memcpy(dst, src, CSUM_BLOCK);
+            for (n = 0 ; n < CSUM_BLOCK ; n += sizeof(w)) {
+                memcpy(&w, src + n, sizeof(w));
+                CRC32C_SSE42_WORD(c, w);
             }
-            crclen -= sizeof(unsigned int);
-        }
-        t = (unsigned char *)src;
-        while (crclen--) {
-            i = ((partial_crc >> 24) ^ *t++) & 0xff;
-            partial_crc = (partial_crc << 8) ^ _opal_crc_table[i];
+            src += CSUM_BLOCK;
+            dst += CSUM_BLOCK;
         }
+        memcpy(dst, src, len);
     }
-    else {
-        register unsigned char *  src = (unsigned char *)source;
-        while (crclen--) {
-            i = ((partial_crc >> 24) ^ *src++) & 0xff;
-            partial_crc = (partial_crc << 8) ^ _opal_crc_table[i];
-        }
+    for ( ; len >= sizeof(w) ; len -= sizeof(w), src += sizeof(w)) {
+        memcpy(&w, src, sizeof(w));
+        CRC32C_SSE42_WORD(c, w);
     }
-    
-    return partial_crc;
+    crc = (unsigned int) c;
+    while (len--) {
+        __asm__ ("crc32b %1, %0" : "+r" (crc) : "rm" (*src));
+        src++;
+    }
+    return crc;
 }
+#endif
 
+unsigned int opal_crc32c_partial(
+    const void *  source, size_t crclen, unsigned int partial_crc)
+{
+    if (!_opal_crc_table_initialized) {
+        opal_initialize_crc_table();
+    }
+
+    return crc32c_kernel((const unsigned char *) source, NULL, crclen, partial_crc);
+}
+
+unsigned int opal_bcopy_crc32c_partial(
+    const void *  source,
+    void *  destination,
+    size_t copylen,
+    size_t crclen,
+    unsigned int partial_crc)
+{
+    size_t crclenresidue = (crclen > copylen) ? (crclen - copylen) : 0;
+
+    if (!_opal_crc_table_initialized) {
+        opal_initialize_crc_table();
+    }
+
+    partial_crc = crc32c_kernel((const unsigned char *) source, (unsigned char *) destination,
+                                copylen, partial_crc);
+    if (crclenresidue) {
+        partial_crc = crc32c_kernel((const unsigned char *) source + copylen, NULL,
+                                    crclenresidue, partial_crc);
+    }
+    return partial_crc;
+}
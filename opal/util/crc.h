@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2006 The University of Tennessee and The University
+ * Copyright (c) 2004-2013 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -30,6 +30,8 @@ BEGIN_C_DECLS
 
 #define CRC_POLYNOMIAL ((unsigned int)0x04c11db7)
 #define CRC_INITIAL_REGISTER ((unsigned int)0xffffffff)
+/* CRC32C (Castagnoli), bit reflected, the one of the SSE4.2 instruction */
+#define OPAL_CRC32C_POLYNOMIAL ((unsigned int)0x82f63b78)
 
 
 #define OPAL_CSUM( SRC, LEN )  opal_uicsum( SRC, LEN )
@@ -177,6 +179,33 @@ opal_uicrc(const void *  source, size_t crclen)
 {
     return opal_uicrc_partial(source, crclen, CRC_INITIAL_REGISTER);
 }
+
+/*
+ * CRC32C, with the crc32 instruction of SSE4.2 when the CPU has it and
+ * tables otherwise: both give the same value. The partial versions
+ * work on the register, start from CRC_INITIAL_REGISTER and invert the
+ * result at the end, as opal_crc32c() does.
+ */
+
+OPAL_DECLSPEC unsigned int
+opal_bcopy_crc32c_partial(
+    const void *  source,
+    void *  destination,
+    size_t copylen,
+    size_t crclen,
+    unsigned int partial_crc);
+
+OPAL_DECLSPEC unsigned int
+opal_crc32c_partial(
+    const void *  source,
+    size_t crclen,
+    unsigned int partial_crc);
+
+static inline unsigned int
+opal_crc32c(const void *  source, size_t crclen)
+{
+    return ~opal_crc32c_partial(source, crclen, CRC_INITIAL_REGISTER);
+}
                                                                                                                   
 END_C_DECLS
 
@@ -25,6 +25,13 @@ ORTE_MODULE_DECLSPEC extern orte_filem_base_component_t mca_filem_raw_component;
 ORTE_DECLSPEC extern orte_filem_base_module_t mca_filem_raw_module;
 
 extern bool orte_filem_raw_flatten_trees;
+extern bool orte_filem_raw_preload_libs;
+extern char *orte_filem_raw_system_lib_dirs;
+
+/* where the preloaded libraries of a binary are put, relative to the
+ * job family session dir
+ */
+#define ORTE_FILEM_RAW_LIBDIR ".ompi-preload-libs"
 
 #define ORTE_FILEM_RAW_CHUNK_MAX 16384
 
@@ -33,6 +33,8 @@ static int filem_raw_close(void);
 static int filem_raw_query(mca_base_module_t **module, int *priority);
 
 bool orte_filem_raw_flatten_trees=false;
+bool orte_filem_raw_preload_libs=false;
+char *orte_filem_raw_system_lib_dirs=NULL;
 
 orte_filem_base_component_t mca_filem_raw_component = {
     {
@@ -67,6 +69,25 @@ static int filem_raw_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &orte_filem_raw_flatten_trees);
 
+    orte_filem_raw_preload_libs = false;
+    (void) mca_base_component_var_register(c, "preload_libs",
+                                           "When preloading a binary, also preload the shared libraries it "
+                                           "depends on (as resolved by ldd on the HNP) and have the procs "
+                                           "load them from the session directory",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &orte_filem_raw_preload_libs);
+
+    orte_filem_raw_system_lib_dirs = "/lib,/lib64,/usr/lib,/usr/lib64";
+    (void) mca_base_component_var_register(c, "system_lib_dirs",
+                                           "Comma-delimited list of directories whose libraries are local to "
+                                           "every node and are not preloaded",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &orte_filem_raw_system_lib_dirs);
+
     return ORTE_SUCCESS;
 }
 
@@ -286,6 +286,99 @@ static void recv_ack(int status, orte_process_name_t* sender,
     }
 }
 
+static bool is_system_lib(const char *path)
+{
+    char **dirs;
+    size_t len;
+    int i;
+    bool found = false;
+
+    if (NULL == orte_filem_raw_system_lib_dirs) {
+        return false;
+    }
+    dirs = opal_argv_split(orte_filem_raw_system_lib_dirs, ',');
+    for (i=0; NULL != dirs && NULL != dirs[i] && !found; i++) {
+        len = strlen(dirs[i]);
+        if (0 < len && 0 == strncmp(path, dirs[i], len) &&
+            ('/' == path[len] || '/' == dirs[i][len-1])) {
+            found = true;
+        }
+    }
+    opal_argv_free(dirs);
+    return found;
+}
+
+/*
+ * Add the shared libraries the executable of an app depends on to the
+ * file sets to preposition, so that the procs do not all go to a shared
+ * filesystem for them at startup. The libraries which live in the system
+ * directories are local to every node and are left alone.
+ */
+static void add_preload_libs(orte_app_context_t *app, opal_list_t *fsets)
+{
+    orte_filem_base_file_set_t *fs;
+    char line[OPAL_PATH_MAX + 64];
+    char *cmd, *path, *end, *bname;
+    char **seen = NULL;
+    FILE *fp;
+    int k;
+
+    /* the path goes to the shell in single quotes */
+    if (NULL != strchr(app->app, '\'')) {
+        return;
+    }
+    asprintf(&cmd, "ldd '%s' 2>/dev/null", app->app);
+    if (NULL == cmd) {
+        return;
+    }
+    fp = popen(cmd, "r");
+    free(cmd);
+    if (NULL == fp) {
+        return;
+    }
+    while (NULL != fgets(line, sizeof(line), fp)) {
+        /* "libfoo.so => /path/libfoo.so (0x...)" - the vdso, the loader
+         * and the libraries which were not found have no such path
+         */
+        if (NULL == (path = strstr(line, "=> /"))) {
+            continue;
+        }
+        path += 3;
+        if (NULL != (end = strstr(path, " (0x")) ||
+            NULL != (end = strchr(path, '\n'))) {
+            *end = '\0';
+        }
+        if (is_system_lib(path)) {
+            continue;
+        }
+        /* they all land in one directory, so the first of a name wins */
+        bname = opal_basename(path);
+        for (k=0; NULL != seen && NULL != seen[k]; k++) {
+            if (0 == strcmp(seen[k], bname)) {
+                break;
+            }
+        }
+        if (NULL != seen && NULL != seen[k]) {
+            free(bname);
+            continue;
+        }
+        opal_argv_append_nosize(&seen, bname);
+        OPAL_OUTPUT_VERBOSE((1, orte_filem_base_framework.framework_output,
+                             "%s filem:raw: preload library %s of %s",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                             path, app->app));
+        fs = OBJ_NEW(orte_filem_base_file_set_t);
+        fs->local_target = strdup(path);
+        asprintf(&fs->remote_target, "%s/%s", ORTE_FILEM_RAW_LIBDIR, bname);
+        fs->target_flag = ORTE_FILEM_TYPE_FILE;
+        fs->app_idx = app->idx;
+        opal_list_append(fsets, &fs->super);
+        free(bname);
+    }
+    pclose(fp);
+    opal_argv_free(seen);
+}
+
 static int raw_preposition_files(orte_job_t *jdata,
                                  orte_filem_completion_cbfunc_t cbfunc,
                                  void *cbdata)
@@ -325,6 +418,9 @@ static int raw_preposition_files(orte_job_t *jdata,
             fs->local_target = strdup(app->app);
             fs->target_flag = ORTE_FILEM_TYPE_EXE;
             opal_list_append(&fsets, &fs->super);
+            if (orte_filem_raw_preload_libs) {
+                add_preload_libs(app, &fsets);
+            }
             /* if we are preloading the binary, then the app must be in relative
              * syntax or we won't find it - the binary will be positioned in the
              * session dir, so ensure the app is relative to that location
@@ -678,6 +774,31 @@ static int raw_link_local_files(orte_job_t *jdata,
         prefix = NULL;
     }
 
+    /* if the libraries of the binary were preloaded, have the procs
+     * find them first
+     */
+    if (app->preload_binary && orte_filem_raw_preload_libs) {
+        struct stat st;
+        char *libdir, *ldpath = NULL, *newpath;
+        libdir = opal_os_path(false, my_dir, ORTE_FILEM_RAW_LIBDIR, NULL);
+        if (0 == stat(libdir, &st) && S_ISDIR(st.st_mode)) {
+            for (i=0; NULL != app->env && NULL != app->env[i]; i++) {
+                if (0 == strncmp(app->env[i], "LD_LIBRARY_PATH=", 16)) {
+                    ldpath = app->env[i] + 16;
+                    break;
+                }
+            }
+            if (NULL == ldpath || '\0' == *ldpath) {
+                newpath = strdup(libdir);
+            } else {
+                asprintf(&newpath, "%s:%s", libdir, ldpath);
+            }
+            opal_setenv("LD_LIBRARY_PATH", newpath, true, &app->env);
+            free(newpath);
+        }
+        free(libdir);
+    }
+
     /* get the list of files this app wants */
     if (NULL != app->preload_files) {
         files = opal_argv_split(app->preload_files, ',');
@@ -29,6 +29,7 @@
 #include "orte_config.h"
 
 #include "opal/class/opal_list.h"
+#include "opal/class/opal_hash_table.h"
 #include "opal/mca/mca.h"
 #include "opal/mca/hwloc/hwloc.h"
 
@@ -60,8 +61,35 @@ typedef struct {
 #if OPAL_HAVE_HWLOC
     hwloc_cpuset_t working_cpuset;
 #endif
+    /* direct modex: the entries published by the local procs (daemons),
+     * the requests waiting for an answer, and the procs whose entries
+     * were fetched already (apps)
+     */
+    opal_hash_table_t modex_data;
+    opal_list_t modex_requests;
+    opal_hash_table_t modex_fetched;
+    /* xcast: the messages above this size are relayed in pieces
+     * of this size, and the ones being received
+     */
+    int xcast_chunk_size;
+    uint32_t xcast_id;
+    opal_list_t xcast_pending;
 } orte_grpcomm_base_t;
 
+/* a fetch of the modex entries of a proc - the daemons queue the
+ * ones which come before the proc published its entries
+ */
+typedef struct {
+    opal_list_item_t super;
+    opal_event_t ev;
+    orte_process_name_t requester;
+    orte_process_name_t proc;
+    orte_process_name_t daemon;
+    volatile bool active;
+    int status;
+} orte_grpcomm_modex_req_t;
+OBJ_CLASS_DECLARATION(orte_grpcomm_modex_req_t);
+
 typedef struct {
     opal_object_t super;
     opal_event_t ev;
@@ -104,6 +132,16 @@ ORTE_DECLSPEC   void orte_grpcomm_base_modex(int fd, short args, void *cbdata);
 ORTE_DECLSPEC   int orte_grpcomm_base_pack_modex_entries(opal_buffer_t *buf);
 ORTE_DECLSPEC   int orte_grpcomm_base_update_modex_entries(orte_process_name_t *proc_name,
                                                            opal_buffer_t *rbuf);
+ORTE_DECLSPEC   int orte_grpcomm_base_fetch_modex(const orte_process_name_t *proc);
+ORTE_DECLSPEC   int orte_grpcomm_base_share_modex(orte_jobid_t job, opal_buffer_t *msg,
+                                                  opal_buffer_t **shared);
+ORTE_DECLSPEC   void orte_grpcomm_base_release_shared_modex(orte_jobid_t job);
+ORTE_DECLSPEC   void orte_grpcomm_base_direct_modex_recv(int status, orte_process_name_t* sender,
+                                                         opal_buffer_t* buffer, orte_rml_tag_t tag,
+                                                         void* cbdata);
+ORTE_DECLSPEC   void orte_grpcomm_base_direct_modex_resp(int status, orte_process_name_t* sender,
+                                                         opal_buffer_t* buffer, orte_rml_tag_t tag,
+                                                         void* cbdata);
 
 /* comm support */
 ORTE_DECLSPEC int orte_grpcomm_base_comm_start(void);
@@ -111,6 +149,9 @@ ORTE_DECLSPEC void orte_grpcomm_base_comm_stop(void);
 ORTE_DECLSPEC void orte_grpcomm_base_xcast_recv(int status, orte_process_name_t* sender,
                                                 opal_buffer_t* buffer, orte_rml_tag_t tag,
                                                 void* cbdata);
+ORTE_DECLSPEC void orte_grpcomm_base_xcast_chunk_recv(int status, orte_process_name_t* sender,
+                                                      opal_buffer_t* buffer, orte_rml_tag_t tag,
+                                                      void* cbdata);
 ORTE_DECLSPEC int orte_grpcomm_base_pack_xcast(orte_jobid_t job,
                                                opal_buffer_t *buffer,
                                                opal_buffer_t *message,
@@ -25,6 +25,7 @@
 #include "opal/mca/mca.h"
 #include "opal/util/output.h"
 #include "opal/mca/base/base.h"
+#include "opal/dss/dss.h"
 
 #include "orte/mca/grpcomm/base/base.h"
 
@@ -44,13 +45,51 @@ orte_grpcomm_base_t orte_grpcomm_base;
 
 orte_grpcomm_base_module_t orte_grpcomm = {0};
 
+static int orte_grpcomm_base_register(mca_base_register_flag_t flags)
+{
+    orte_grpcomm_base.xcast_chunk_size = 256 * 1024;
+    (void) mca_base_var_register("orte", "grpcomm", "base", "xcast_chunk_size",
+                                 "Relay the xcast messages larger than twice this size in pieces "
+                                 "of this size, so each daemon forwards a piece while receiving the "
+                                 "next one (0 = always relay whole messages)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
+                                 &orte_grpcomm_base.xcast_chunk_size);
+    return ORTE_SUCCESS;
+}
+
 static int orte_grpcomm_base_close(void)
 {
+    opal_list_item_t *item;
+    opal_buffer_t *data;
+    uint64_t key;
+    void *node;
+    int rc;
+
     /* Close the selected component */
     if( NULL != orte_grpcomm.finalize ) {
         orte_grpcomm.finalize();
     }
 
+    /* release the direct modex data */
+    rc = opal_hash_table_get_first_key_uint64(&orte_grpcomm_base.modex_data, &key,
+                                              (void**)&data, &node);
+    while (OPAL_SUCCESS == rc) {
+        OBJ_RELEASE(data);
+        rc = opal_hash_table_get_next_key_uint64(&orte_grpcomm_base.modex_data, &key,
+                                                 (void**)&data, node, &node);
+    }
+    OBJ_DESTRUCT(&orte_grpcomm_base.modex_data);
+    while (NULL != (item = opal_list_remove_first(&orte_grpcomm_base.modex_requests))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&orte_grpcomm_base.modex_requests);
+    OBJ_DESTRUCT(&orte_grpcomm_base.modex_fetched);
+    while (NULL != (item = opal_list_remove_first(&orte_grpcomm_base.xcast_pending))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&orte_grpcomm_base.xcast_pending);
+
 #if OPAL_HAVE_HWLOC
   if (NULL != orte_grpcomm_base.working_cpuset) {
       hwloc_bitmap_free(orte_grpcomm_base.working_cpuset);
@@ -69,6 +108,13 @@ static int orte_grpcomm_base_open(mca_base_open_flag_t flags)
     /* init globals */
     OBJ_CONSTRUCT(&orte_grpcomm_base.active_colls, opal_list_t);
     orte_grpcomm_base.coll_id = 0;
+    OBJ_CONSTRUCT(&orte_grpcomm_base.modex_data, opal_hash_table_t);
+    opal_hash_table_init(&orte_grpcomm_base.modex_data, 32);
+    OBJ_CONSTRUCT(&orte_grpcomm_base.modex_requests, opal_list_t);
+    OBJ_CONSTRUCT(&orte_grpcomm_base.modex_fetched, opal_hash_table_t);
+    opal_hash_table_init(&orte_grpcomm_base.modex_fetched, 32);
+    orte_grpcomm_base.xcast_id = 0;
+    OBJ_CONSTRUCT(&orte_grpcomm_base.xcast_pending, opal_list_t);
     
 #if OPAL_HAVE_HWLOC
     orte_grpcomm_base.working_cpuset = NULL;
@@ -77,7 +123,7 @@ static int orte_grpcomm_base_open(mca_base_open_flag_t flags)
     return mca_base_framework_components_open(&orte_grpcomm_base_framework, flags);
 }
 
-MCA_BASE_FRAMEWORK_DECLARE(orte, grpcomm, NULL, NULL, orte_grpcomm_base_open, orte_grpcomm_base_close,
+MCA_BASE_FRAMEWORK_DECLARE(orte, grpcomm, NULL, orte_grpcomm_base_register, orte_grpcomm_base_open, orte_grpcomm_base_close,
                            mca_grpcomm_base_static_components, 0);
 
 
@@ -146,3 +192,18 @@ OBJ_CLASS_INSTANCE(orte_grpcomm_collective_t,
 OBJ_CLASS_INSTANCE(orte_grpcomm_caddy_t,
                    opal_object_t,
                    NULL, NULL);
+
+static void modex_req_constructor(orte_grpcomm_modex_req_t *ptr)
+{
+    ptr->requester.jobid = ORTE_JOBID_INVALID;
+    ptr->requester.vpid = ORTE_VPID_INVALID;
+    ptr->proc.jobid = ORTE_JOBID_INVALID;
+    ptr->proc.vpid = ORTE_VPID_INVALID;
+    ptr->daemon.jobid = ORTE_JOBID_INVALID;
+    ptr->daemon.vpid = ORTE_VPID_INVALID;
+    ptr->active = false;
+    ptr->status = ORTE_SUCCESS;
+}
+OBJ_CLASS_INSTANCE(orte_grpcomm_modex_req_t,
+                   opal_list_item_t,
+                   modex_req_constructor, NULL);
@@ -36,10 +36,12 @@
 #include "opal/dss/dss.h"
 #include "opal/mca/db/db.h"
 #include "opal/mca/hwloc/base/base.h"
+#include "opal/runtime/opal_progress.h"
 
 #include "orte/util/proc_info.h"
 #include "orte/mca/errmgr/errmgr.h"
 #include "orte/mca/ess/ess.h"
+#include "orte/mca/rml/rml.h"
 #include "orte/runtime/orte_globals.h"
 #include "orte/util/name_fns.h"
 #include "orte/util/nidmap.h"
@@ -62,6 +64,8 @@ orte_grpcomm_coll_id_t orte_grpcomm_base_get_coll_id(void)
 
 
 /***************  MODEX SECTION **************/
+static int direct_modex_publish(void);
+
 void orte_grpcomm_base_modex(int fd, short args, void *cbdata)
 {
     orte_grpcomm_caddy_t *caddy = (orte_grpcomm_caddy_t*)cbdata;
@@ -76,6 +80,25 @@ void orte_grpcomm_base_modex(int fd, short args, void *cbdata)
                          "%s grpcomm:base:modex: performing modex",
                          ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
     
+    if (orte_direct_modex && 0 == opal_list_get_size(&modex->participants)) {
+        /* only our daemon gets our entries, the peers fetch them
+         * from it when they need them - all that is left is to
+         * make sure everyone has published before we return
+         */
+        if (1 < orte_process_info.num_procs &&
+            ORTE_SUCCESS != (rc = direct_modex_publish())) {
+            ORTE_ERROR_LOG(rc);
+            goto cleanup;
+        }
+        OPAL_OUTPUT_VERBOSE((2, orte_grpcomm_base_framework.framework_output,
+                             "%s grpcomm:base:modex: entries published - executing barrier",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
+        if (ORTE_SUCCESS != (rc = orte_grpcomm.barrier(modex))) {
+            ORTE_ERROR_LOG(rc);
+        }
+        goto cleanup;
+    }
+
     if (0 == opal_list_get_size(&modex->participants)) {
         /* record the collective */
         modex->next_cbdata = modex;
@@ -405,7 +428,35 @@ void orte_grpcomm_base_store_modex(opal_buffer_t *rbuf, void *cbdata)
     /* unpack the process name */
     cnt=1;
     while (ORTE_SUCCESS == (rc = opal_dss.unpack(rbuf, &proc_name, &cnt, ORTE_NAME))) {
-        
+
+        if (ORTE_VPID_WILDCARD == proc_name.vpid) {
+            /* our daemon kept the data of the job in a segment
+             * shared on the node - attach it instead
+             */
+            opal_byte_object_t *bo;
+            cnt = 1;
+            if (ORTE_SUCCESS != (rc = opal_dss.unpack(rbuf, &bo, &cnt, OPAL_BYTE_OBJECT))) {
+                ORTE_ERROR_LOG(rc);
+                goto cleanup;
+            }
+            OPAL_OUTPUT_VERBOSE((5, orte_grpcomm_base_framework.framework_output,
+                                 "%s grpcomm:base:store_modex attaching modex of job %s shared by our daemon",
+                                 ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                                 ORTE_JOBID_PRINT(proc_name.jobid)));
+            rc = opal_db.store((opal_identifier_t*)&proc_name, OPAL_DB_INTERNAL,
+                               OPAL_DB_SM_SEGMENT, bo, OPAL_BYTE_OBJECT);
+            if (NULL != bo->bytes) {
+                free(bo->bytes);
+            }
+            free(bo);
+            if (ORTE_SUCCESS != rc) {
+                ORTE_ERROR_LOG(rc);
+                goto cleanup;
+            }
+            cnt = 1;
+            continue;
+        }
+
         OPAL_OUTPUT_VERBOSE((5, orte_grpcomm_base_framework.framework_output,
                              "%s grpcomm:base:store_modex adding modex entry for proc %s",
                              ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
@@ -546,3 +597,388 @@ int orte_grpcomm_base_pack_modex_entries(opal_buffer_t *buf)
 
     return rc;
 }
+
+
+/***************  DIRECT MODEX SECTION **************/
+/* commands understood by the daemons on ORTE_RML_TAG_DIRECT_MODEX */
+typedef uint8_t orte_grpcomm_direct_cmd_t;
+#define ORTE_GRPCOMM_DIRECT_CMD_T       OPAL_UINT8
+#define ORTE_GRPCOMM_DIRECT_PUBLISH     1
+#define ORTE_GRPCOMM_DIRECT_REQUEST     2
+
+static int direct_modex_publish(void)
+{
+    opal_buffer_t *buf;
+    orte_grpcomm_direct_cmd_t cmd = ORTE_GRPCOMM_DIRECT_PUBLISH;
+    int rc;
+
+    buf = OBJ_NEW(opal_buffer_t);
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(buf, &cmd, 1, ORTE_GRPCOMM_DIRECT_CMD_T))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buf);
+        return rc;
+    }
+    if (ORTE_SUCCESS != (rc = orte_grpcomm_base_pack_modex_entries(buf))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buf);
+        return rc;
+    }
+
+    OPAL_OUTPUT_VERBOSE((2, orte_grpcomm_base_framework.framework_output,
+                         "%s grpcomm:base:direct_modex: publishing entries to daemon %s",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_DAEMON)));
+
+    if (0 > (rc = orte_rml.send_buffer_nb(ORTE_PROC_MY_DAEMON, buf,
+                                          ORTE_RML_TAG_DIRECT_MODEX, 0,
+                                          orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buf);
+        return rc;
+    }
+    return ORTE_SUCCESS;
+}
+
+static int direct_modex_reply(orte_process_name_t *requester,
+                              orte_process_name_t *proc,
+                              opal_buffer_t *data)
+{
+    opal_buffer_t *buf;
+    int rc;
+
+    OPAL_OUTPUT_VERBOSE((5, orte_grpcomm_base_framework.framework_output,
+                         "%s grpcomm:base:direct_modex: sending entries of %s to %s",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         ORTE_NAME_PRINT(proc), ORTE_NAME_PRINT(requester)));
+
+    buf = OBJ_NEW(opal_buffer_t);
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(buf, proc, 1, ORTE_NAME))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buf);
+        return rc;
+    }
+    /* the stored entries are never unpacked, so this copies all of them */
+    opal_dss.copy_payload(buf, data);
+    if (0 > (rc = orte_rml.send_buffer_nb(requester, buf,
+                                          ORTE_RML_TAG_DIRECT_MODEX_RESP, 0,
+                                          orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buf);
+        return rc;
+    }
+    return ORTE_SUCCESS;
+}
+
+/* daemons: the local procs publish their entries, and any proc of
+ * the job can ask for them
+ */
+void orte_grpcomm_base_direct_modex_recv(int status, orte_process_name_t* sender,
+                                         opal_buffer_t* buffer, orte_rml_tag_t tag,
+                                         void* cbdata)
+{
+    orte_grpcomm_direct_cmd_t cmd;
+    orte_grpcomm_modex_req_t *req;
+    orte_process_name_t proc;
+    opal_buffer_t *data;
+    opal_list_item_t *item, *next;
+    uint64_t id;
+    int32_t cnt;
+    int rc;
+
+    cnt = 1;
+    if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &cmd, &cnt, ORTE_GRPCOMM_DIRECT_CMD_T))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+
+    switch (cmd) {
+    case ORTE_GRPCOMM_DIRECT_PUBLISH:
+        OPAL_OUTPUT_VERBOSE((5, orte_grpcomm_base_framework.framework_output,
+                             "%s grpcomm:base:direct_modex: storing entries of %s",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                             ORTE_NAME_PRINT(sender)));
+        memcpy(&id, sender, sizeof(id));
+        if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&orte_grpcomm_base.modex_data,
+                                                             id, (void**)&data)) {
+            /* a restarted proc publishes again */
+            OBJ_RELEASE(data);
+        }
+        data = OBJ_NEW(opal_buffer_t);
+        opal_dss.copy_payload(data, buffer);
+        opal_hash_table_set_value_uint64(&orte_grpcomm_base.modex_data, id, data);
+
+        /* answer the requests which were waiting for it */
+        item = opal_list_get_first(&orte_grpcomm_base.modex_requests);
+        while (item != opal_list_get_end(&orte_grpcomm_base.modex_requests)) {
+            next = opal_list_get_next(item);
+            req = (orte_grpcomm_modex_req_t*)item;
+            if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &req->proc, sender)) {
+                direct_modex_reply(&req->requester, &req->proc, data);
+                opal_list_remove_item(&orte_grpcomm_base.modex_requests, item);
+                OBJ_RELEASE(req);
+            }
+            item = next;
+        }
+        break;
+
+    case ORTE_GRPCOMM_DIRECT_REQUEST:
+        cnt = 1;
+        if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &proc, &cnt, ORTE_NAME))) {
+            ORTE_ERROR_LOG(rc);
+            return;
+        }
+        memcpy(&id, &proc, sizeof(id));
+        if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&orte_grpcomm_base.modex_data,
+                                                             id, (void**)&data)) {
+            direct_modex_reply(sender, &proc, data);
+            break;
+        }
+        /* the proc has not published yet - hold the request */
+        OPAL_OUTPUT_VERBOSE((5, orte_grpcomm_base_framework.framework_output,
+                             "%s grpcomm:base:direct_modex: holding request of %s for %s",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                             ORTE_NAME_PRINT(sender), ORTE_NAME_PRINT(&proc)));
+        req = OBJ_NEW(orte_grpcomm_modex_req_t);
+        req->requester = *sender;
+        req->proc = proc;
+        opal_list_append(&orte_grpcomm_base.modex_requests, &req->super);
+        break;
+
+    default:
+        ORTE_ERROR_LOG(ORTE_ERR_BAD_PARAM);
+        break;
+    }
+}
+
+/* apps: the entries of a proc we asked for */
+void orte_grpcomm_base_direct_modex_resp(int status, orte_process_name_t* sender,
+                                         opal_buffer_t* buffer, orte_rml_tag_t tag,
+                                         void* cbdata)
+{
+    orte_grpcomm_modex_req_t *req;
+    orte_process_name_t proc;
+    opal_list_item_t *item, *next;
+    int32_t cnt;
+    int rc;
+
+    cnt = 1;
+    if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &proc, &cnt, ORTE_NAME))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+    rc = orte_grpcomm_base_update_modex_entries(&proc, buffer);
+    if (ORTE_SUCCESS != rc) {
+        ORTE_ERROR_LOG(rc);
+    }
+
+    /* release the waiting fetches - they own the requests */
+    item = opal_list_get_first(&orte_grpcomm_base.modex_requests);
+    while (item != opal_list_get_end(&orte_grpcomm_base.modex_requests)) {
+        next = opal_list_get_next(item);
+        req = (orte_grpcomm_modex_req_t*)item;
+        if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &req->proc, &proc)) {
+            opal_list_remove_item(&orte_grpcomm_base.modex_requests, item);
+            req->status = rc;
+            req->active = false;
+        }
+        item = next;
+    }
+}
+
+static void direct_modex_request(int fd, short args, void *cbdata)
+{
+    orte_grpcomm_modex_req_t *req = (orte_grpcomm_modex_req_t*)cbdata;
+    orte_grpcomm_direct_cmd_t cmd = ORTE_GRPCOMM_DIRECT_REQUEST;
+    opal_buffer_t *buf;
+    int rc;
+
+    OPAL_OUTPUT_VERBOSE((5, orte_grpcomm_base_framework.framework_output,
+                         "%s grpcomm:base:direct_modex: requesting entries of %s from %s",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         ORTE_NAME_PRINT(&req->proc), ORTE_NAME_PRINT(&req->daemon)));
+
+    buf = OBJ_NEW(opal_buffer_t);
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(buf, &cmd, 1, ORTE_GRPCOMM_DIRECT_CMD_T)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(buf, &req->proc, 1, ORTE_NAME))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buf);
+        goto error;
+    }
+    /* the answer may come before the send completes */
+    opal_list_append(&orte_grpcomm_base.modex_requests, &req->super);
+    if (0 > (rc = orte_rml.send_buffer_nb(&req->daemon, buf,
+                                          ORTE_RML_TAG_DIRECT_MODEX, 0,
+                                          orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buf);
+        opal_list_remove_item(&orte_grpcomm_base.modex_requests, &req->super);
+        goto error;
+    }
+    return;
+
+ error:
+    req->status = rc;
+    req->active = false;
+}
+
+int orte_grpcomm_base_fetch_modex(const orte_process_name_t *proc)
+{
+    orte_grpcomm_modex_req_t *req;
+    orte_vpid_t daemon, *vptr;
+    uint64_t id;
+    void *ptr;
+    int rc;
+
+    /* the procs of other jobs come through a full modex, and
+     * we have our own entries already
+     */
+    if (!orte_direct_modex || !ORTE_PROC_IS_APP ||
+        proc->jobid != ORTE_PROC_MY_NAME->jobid ||
+        proc->vpid == ORTE_PROC_MY_NAME->vpid) {
+        return ORTE_SUCCESS;
+    }
+    memcpy(&id, proc, sizeof(id));
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&orte_grpcomm_base.modex_fetched,
+                                                         id, &ptr)) {
+        return ORTE_SUCCESS;
+    }
+
+    /* the entries are held by the daemon of the proc */
+    vptr = &daemon;
+    if (ORTE_SUCCESS != (rc = opal_db.fetch((opal_identifier_t*)proc, ORTE_DB_DAEMON_VPID,
+                                            (void**)&vptr, OPAL_UINT32))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+
+    req = OBJ_NEW(orte_grpcomm_modex_req_t);
+    req->requester = *ORTE_PROC_MY_NAME;
+    req->proc = *proc;
+    req->daemon.jobid = ORTE_PROC_MY_DAEMON->jobid;
+    req->daemon.vpid = daemon;
+    req->active = true;
+
+    /* the request list is shared with the RML callbacks */
+    opal_event_set(orte_event_base, &req->ev, -1,
+                   OPAL_EV_WRITE, direct_modex_request, req);
+    opal_event_set_priority(&req->ev, ORTE_MSG_PRI);
+    opal_event_active(&req->ev, OPAL_EV_WRITE, 1);
+
+    while (req->active) {
+        opal_progress();
+    }
+    rc = req->status;
+    OBJ_RELEASE(req);
+
+    if (ORTE_SUCCESS == rc) {
+        opal_hash_table_set_value_uint64(&orte_grpcomm_base.modex_fetched, id, NULL);
+    }
+    return rc;
+}
+
+
+/***************  SHARED MODEX SECTION **************/
+/*
+ * Called by a daemon on a collective it is about to deliver to its
+ * local procs. If this is the peer modex of the job, store the data in
+ * a segment shared on the node, and return in place of the collective
+ * a message carrying only its descriptor, under a wildcard name. The
+ * procs then look their peers up in the segment instead of each
+ * keeping a copy of the whole modex. Anything else, or any failure,
+ * leaves the collective to be delivered as it is.
+ */
+int orte_grpcomm_base_share_modex(orte_jobid_t job, opal_buffer_t *msg,
+                                  opal_buffer_t **shared)
+{
+    orte_job_t *jdata;
+    opal_buffer_t data;
+    orte_grpcomm_coll_id_t id;
+    orte_process_name_t name, owner;
+    opal_byte_object_t *bo;
+    opal_value_t *kv;
+    int32_t num_entries, j;
+    orte_std_cntr_t cnt;
+    int rc;
+
+    if (NULL == (jdata = orte_get_job_data_object(job)) ||
+        0 == jdata->num_local_procs) {
+        return ORTE_ERR_TAKE_NEXT_OPTION;
+    }
+
+    /* work on a copy so the message is left intact if we can't share it */
+    OBJ_CONSTRUCT(&data, opal_buffer_t);
+    opal_dss.copy_payload(&data, msg);
+    cnt = 1;
+    if (ORTE_SUCCESS != opal_dss.unpack(&data, &id, &cnt, ORTE_GRPCOMM_COLL_ID_T) ||
+        id != jdata->peer_modex) {
+        OBJ_DESTRUCT(&data);
+        return ORTE_ERR_TAKE_NEXT_OPTION;
+    }
+
+    owner.jobid = job;
+    owner.vpid = ORTE_VPID_WILDCARD;
+
+    /* stage the entries in the node-local database */
+    cnt = 1;
+    while (ORTE_SUCCESS == (rc = opal_dss.unpack(&data, &name, &cnt, ORTE_NAME))) {
+        cnt = 1;
+        if (ORTE_SUCCESS != (rc = opal_dss.unpack(&data, &num_entries, &cnt, OPAL_INT32))) {
+            ORTE_ERROR_LOG(rc);
+            goto cleanup;
+        }
+        for (j = 0; j < num_entries; j++) {
+            cnt = 1;
+            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&data, &kv, &cnt, OPAL_VALUE))) {
+                ORTE_ERROR_LOG(rc);
+                goto cleanup;
+            }
+            if (ORTE_SUCCESS != (rc = opal_db.store_pointer((opal_identifier_t*)&name,
+                                                            OPAL_DB_LOCAL, kv))) {
+                /* cannot share this one - send the data as usual */
+                OBJ_RELEASE(kv);
+                goto cleanup;
+            }
+        }
+        cnt = 1;
+    }
+    if (ORTE_ERR_UNPACK_READ_PAST_END_OF_BUFFER != rc) {
+        ORTE_ERROR_LOG(rc);
+        goto cleanup;
+    }
+
+    /* seal them into the segment */
+    if (ORTE_SUCCESS != (rc = opal_db.fetch((opal_identifier_t*)&owner, OPAL_DB_SM_SEGMENT,
+                                            (void**)&bo, OPAL_BYTE_OBJECT))) {
+        goto cleanup;
+    }
+
+    OPAL_OUTPUT_VERBOSE((2, orte_grpcomm_base_framework.framework_output,
+                         "%s grpcomm:base:share_modex: modex of job %s shared with %d local procs",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), ORTE_JOBID_PRINT(job),
+                         (int)jdata->num_local_procs));
+
+    *shared = OBJ_NEW(opal_buffer_t);
+    opal_dss.pack(*shared, &id, 1, ORTE_GRPCOMM_COLL_ID_T);
+    opal_dss.pack(*shared, &owner, 1, ORTE_NAME);
+    opal_dss.pack(*shared, &bo, 1, OPAL_BYTE_OBJECT);
+    free(bo->bytes);
+    free(bo);
+    OBJ_DESTRUCT(&data);
+    return ORTE_SUCCESS;
+
+ cleanup:
+    /* drop whatever was staged */
+    opal_db.remove((opal_identifier_t*)&owner, OPAL_DB_SM_SEGMENT);
+    OBJ_DESTRUCT(&data);
+    return ORTE_ERR_TAKE_NEXT_OPTION;
+}
+
+/* the local procs of the job are gone - so is the segment */
+void orte_grpcomm_base_release_shared_modex(orte_jobid_t job)
+{
+    orte_process_name_t owner;
+
+    owner.jobid = job;
+    owner.vpid = ORTE_VPID_WILDCARD;
+    opal_db.remove((opal_identifier_t*)&owner, OPAL_DB_SM_SEGMENT);
+}
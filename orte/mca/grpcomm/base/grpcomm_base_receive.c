@@ -92,6 +92,16 @@ int orte_grpcomm_base_comm_start(void)
                 recv_issued = false;
                 return rc;
             }
+            if (orte_direct_modex) {
+                if (ORTE_SUCCESS != (rc = orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
+                                                                  ORTE_RML_TAG_DIRECT_MODEX,
+                                                                  ORTE_RML_PERSISTENT,
+                                                                  orte_grpcomm_base_direct_modex_recv, NULL))) {
+                    ORTE_ERROR_LOG(rc);
+                    recv_issued = false;
+                    return rc;
+                }
+            }
             if (ORTE_PROC_IS_DAEMON) {
                 if (ORTE_SUCCESS != (rc = orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
                                                                   ORTE_RML_TAG_ROLLUP,
@@ -101,6 +111,14 @@ int orte_grpcomm_base_comm_start(void)
                     recv_issued = false;
                     return rc;
                 }
+                if (ORTE_SUCCESS != (rc = orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
+                                                                  ORTE_RML_TAG_XCAST_CHUNK,
+                                                                  ORTE_RML_PERSISTENT,
+                                                                  orte_grpcomm_base_xcast_chunk_recv, NULL))) {
+                    ORTE_ERROR_LOG(rc);
+                    recv_issued = false;
+                    return rc;
+                }
             }
             if (ORTE_PROC_IS_HNP) {
                 if (ORTE_SUCCESS != (rc = orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
@@ -122,6 +140,16 @@ int orte_grpcomm_base_comm_start(void)
                 recv_issued = false;
                 return rc;
             }
+            if (orte_direct_modex) {
+                if (ORTE_SUCCESS != (rc = orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
+                                                                  ORTE_RML_TAG_DIRECT_MODEX_RESP,
+                                                                  ORTE_RML_PERSISTENT,
+                                                                  orte_grpcomm_base_direct_modex_resp, NULL))) {
+                    ORTE_ERROR_LOG(rc);
+                    recv_issued = false;
+                    return rc;
+                }
+            }
             recv_issued = true;
         }
     }
@@ -140,6 +168,14 @@ void orte_grpcomm_base_comm_stop(void)
         if (ORTE_PROC_IS_HNP || ORTE_PROC_IS_DAEMON) {
             orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORTE_RML_TAG_XCAST);
             orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORTE_RML_TAG_DAEMON_COLL);
+            if (orte_direct_modex) {
+                orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORTE_RML_TAG_DIRECT_MODEX);
+            }
+        } else if (ORTE_PROC_IS_APP && orte_direct_modex) {
+            orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORTE_RML_TAG_DIRECT_MODEX_RESP);
+        }
+        if (ORTE_PROC_IS_DAEMON) {
+            orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORTE_RML_TAG_XCAST_CHUNK);
         }
         if (ORTE_PROC_IS_HNP) {
             orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORTE_RML_TAG_COLL_ID_REQ);
@@ -27,6 +27,7 @@
  */
 #include "orte_config.h"
 
+#include <stdlib.h>
 
 #include "opal/dss/dss.h"
 
@@ -44,35 +45,87 @@
 #include "orte/mca/grpcomm/grpcomm.h"
 #include "orte/mca/grpcomm/base/base.h"
 
-void orte_grpcomm_base_xcast_recv(int status, orte_process_name_t* sender,
-                                  opal_buffer_t* buffer, orte_rml_tag_t tag,
-                                  void* cbdata)
+/* a large xcast is relayed in pieces: each one carries the id of the
+ * message, the number of daemons the HNP routed it for, the size of
+ * the message and the offset of the piece
+ */
+typedef struct {
+    opal_list_item_t super;
+    uint32_t id;
+    size_t size;
+    size_t recvd;
+    char *bytes;
+    /* the pieces kept until the whole message is in, when the
+     * routing plan could change with it
+     */
+    bool hold;
+    opal_list_t held;
+} orte_grpcomm_xcast_pending_t;
+
+static void pending_constructor(orte_grpcomm_xcast_pending_t *ptr)
+{
+    ptr->id = 0;
+    ptr->size = 0;
+    ptr->recvd = 0;
+    ptr->bytes = NULL;
+    ptr->hold = false;
+    OBJ_CONSTRUCT(&ptr->held, opal_list_t);
+}
+static void pending_destructor(orte_grpcomm_xcast_pending_t *ptr)
 {
     opal_list_item_t *item;
-    orte_namelist_t *nm;
+
+    if (NULL != ptr->bytes) {
+        free(ptr->bytes);
+    }
+    while (NULL != (item = opal_list_remove_first(&ptr->held))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&ptr->held);
+}
+static OBJ_CLASS_INSTANCE(orte_grpcomm_xcast_pending_t,
+                          opal_list_item_t,
+                          pending_constructor,
+                          pending_destructor);
+
+/* a piece waiting to be relayed */
+typedef struct {
+    opal_list_item_t super;
+    opal_buffer_t *buf;
+} orte_grpcomm_xcast_piece_t;
+
+static void piece_constructor(orte_grpcomm_xcast_piece_t *ptr)
+{
+    ptr->buf = NULL;
+}
+static void piece_destructor(orte_grpcomm_xcast_piece_t *ptr)
+{
+    if (NULL != ptr->buf) {
+        OBJ_RELEASE(ptr->buf);
+    }
+}
+static OBJ_CLASS_INSTANCE(orte_grpcomm_xcast_piece_t,
+                          opal_list_item_t,
+                          piece_constructor,
+                          piece_destructor);
+
+/* process whatever in the message concerns the relay itself - the
+ * daemon map and the wireup info of the add_procs command. This
+ * consumes the buffer
+ */
+static void xcast_update(opal_buffer_t *buffer)
+{
     int ret, cnt;
-    opal_buffer_t *relay, *rly;
     orte_daemon_cmd_flag_t command;
     opal_buffer_t wireup;
     opal_byte_object_t *bo;
     int8_t flag;
-    orte_grpcomm_collective_t coll;
-    orte_job_t *jdata;
-    orte_proc_t *rec;
-
-    OPAL_OUTPUT_VERBOSE((1, orte_grpcomm_base_framework.framework_output,
-                         "%s grpcomm:xcast:recv:send_relay",
-                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
-
-    /* setup the relay message */
-    relay = OBJ_NEW(opal_buffer_t);
-    opal_dss.copy_payload(relay, buffer);
 
     /* peek at the command */
     cnt=1;
     if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &command, &cnt, ORTE_DAEMON_CMD))) {
         ORTE_ERROR_LOG(ret);
-        goto relay;
+        return;
     }
 
     /* if it is add_procs, then... */
@@ -81,7 +134,7 @@ void orte_grpcomm_base_xcast_recv(int status, orte_process_name_t* sender,
         cnt=1;
         if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &bo, &cnt, OPAL_BYTE_OBJECT))) {
             ORTE_ERROR_LOG(ret);
-            goto relay;
+            return;
         }
     
         /* update our local nidmap, if required - the decode function
@@ -100,7 +153,7 @@ void orte_grpcomm_base_xcast_recv(int status, orte_process_name_t* sender,
     
             if (ORTE_SUCCESS != (ret = orte_util_decode_daemon_nodemap(bo))) {
                 ORTE_ERROR_LOG(ret);
-                goto relay;
+                return;
             }
         }
 
@@ -111,18 +164,18 @@ void orte_grpcomm_base_xcast_recv(int status, orte_process_name_t* sender,
         cnt=1;
         if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &flag, &cnt, OPAL_INT8))) {
             ORTE_ERROR_LOG(ret);
-            goto relay;
+            return;
         }
         if (0 == flag) {
             /* no - just return */
-            goto relay;
+            return;
         }
 
         /* unpack the byte object */
         cnt=1;
         if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &bo, &cnt, OPAL_BYTE_OBJECT))) {
             ORTE_ERROR_LOG(ret);
-            goto relay;
+            return;
         }
         if (0 < bo->size) {
             /* load it into a buffer */
@@ -132,14 +185,25 @@ void orte_grpcomm_base_xcast_recv(int status, orte_process_name_t* sender,
             if (ORTE_SUCCESS != (ret = orte_routed.init_routes(ORTE_PROC_MY_NAME->jobid, &wireup))) {
                 ORTE_ERROR_LOG(ret);
                 OBJ_DESTRUCT(&wireup);
-                goto relay;
+                return;
             }
             /* done with the wireup buffer - dump it */
             OBJ_DESTRUCT(&wireup);
         }
     }
+}
+
+/* send a copy of the message to each of the next recipients */
+static void xcast_relay(opal_buffer_t *relay, orte_rml_tag_t tag)
+{
+    opal_list_item_t *item;
+    orte_namelist_t *nm;
+    int ret;
+    opal_buffer_t *rly;
+    orte_grpcomm_collective_t coll;
+    orte_job_t *jdata;
+    orte_proc_t *rec;
 
- relay:
     /* setup the relay list */
     OBJ_CONSTRUCT(&coll, orte_grpcomm_collective_t);
 
@@ -174,6 +238,7 @@ void orte_grpcomm_base_xcast_recv(int status, orte_process_name_t* sender,
                                  ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
                                  ORTE_NAME_PRINT(&nm->name)));
             OBJ_RELEASE(rly);
+            OBJ_RELEASE(item);
             continue;
         }
         if (ORTE_PROC_STATE_RUNNING < rec->state) {
@@ -182,19 +247,211 @@ void orte_grpcomm_base_xcast_recv(int status, orte_process_name_t* sender,
                                  ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
                                  ORTE_NAME_PRINT(&nm->name)));
             OBJ_RELEASE(rly);
+            OBJ_RELEASE(item);
             continue;
         }
-        if (0 > (ret = orte_rml.send_buffer_nb(&nm->name, rly, ORTE_RML_TAG_XCAST, 0,
+        if (0 > (ret = orte_rml.send_buffer_nb(&nm->name, rly, tag, 0,
                                                orte_rml_send_callback, NULL))) {
             ORTE_ERROR_LOG(ret);
             OBJ_RELEASE(rly);
-            continue;
         }
+        OBJ_RELEASE(item);
     }
     
  CLEANUP:
     /* cleanup */
     OBJ_DESTRUCT(&coll);
+}
+
+/* split the message in pieces and relay them */
+static int xcast_relay_chunks(opal_buffer_t *relay)
+{
+    opal_buffer_t *piece, whole;
+    uint32_t id;
+    orte_vpid_t ndaemons;
+    size_t size, offset, len;
+    int32_t nbytes;
+    char *bytes;
+    int rc;
+
+    /* the pieces are those of the unloaded message, so the
+     * receivers can load it back as it was
+     */
+    OBJ_CONSTRUCT(&whole, opal_buffer_t);
+    opal_dss.copy_payload(&whole, relay);
+    if (ORTE_SUCCESS != (rc = opal_dss.unload(&whole, (void**)&bytes, &nbytes))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_DESTRUCT(&whole);
+        return rc;
+    }
+    OBJ_DESTRUCT(&whole);
+
+    id = orte_grpcomm_base.xcast_id++;
+    ndaemons = orte_process_info.num_procs;
+    size = nbytes;
+
+    OPAL_OUTPUT_VERBOSE((5, orte_grpcomm_base_framework.framework_output,
+                         "%s grpcomm:base:xcast relaying message %u of %lu bytes in pieces of %d",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), id, (unsigned long)size,
+                         orte_grpcomm_base.xcast_chunk_size));
+
+    rc = ORTE_SUCCESS;
+    for (offset = 0; offset < size; offset += len) {
+        len = size - offset;
+        if (len > (size_t)orte_grpcomm_base.xcast_chunk_size) {
+            len = orte_grpcomm_base.xcast_chunk_size;
+        }
+        piece = OBJ_NEW(opal_buffer_t);
+        if (ORTE_SUCCESS != (rc = opal_dss.pack(piece, &id, 1, OPAL_UINT32)) ||
+            ORTE_SUCCESS != (rc = opal_dss.pack(piece, &ndaemons, 1, ORTE_VPID)) ||
+            ORTE_SUCCESS != (rc = opal_dss.pack(piece, &size, 1, OPAL_SIZE)) ||
+            ORTE_SUCCESS != (rc = opal_dss.pack(piece, &offset, 1, OPAL_SIZE)) ||
+            ORTE_SUCCESS != (rc = opal_dss.pack(piece, bytes + offset, len, OPAL_BYTE))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(piece);
+            break;
+        }
+        xcast_relay(piece, ORTE_RML_TAG_XCAST_CHUNK);
+        OBJ_RELEASE(piece);
+    }
+    free(bytes);
+    return rc;
+}
+
+void orte_grpcomm_base_xcast_recv(int status, orte_process_name_t* sender,
+                                  opal_buffer_t* buffer, orte_rml_tag_t tag,
+                                  void* cbdata)
+{
+    int ret;
+    opal_buffer_t *relay;
+
+    OPAL_OUTPUT_VERBOSE((1, orte_grpcomm_base_framework.framework_output,
+                         "%s grpcomm:xcast:recv:send_relay",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
+
+    /* setup the relay message */
+    relay = OBJ_NEW(opal_buffer_t);
+    opal_dss.copy_payload(relay, buffer);
+
+    xcast_update(buffer);
+
+    /* a large message goes down the tree in pieces, so that each
+     * daemon forwards one while it receives the next
+     */
+    if (ORTE_PROC_IS_HNP && 0 < orte_grpcomm_base.xcast_chunk_size &&
+        2 * (size_t)orte_grpcomm_base.xcast_chunk_size < relay->bytes_used &&
+        ORTE_SUCCESS == xcast_relay_chunks(relay)) {
+        goto deliver;
+    }
+    xcast_relay(relay, ORTE_RML_TAG_XCAST);
+
+ deliver:
+    /* now send it to myself for processing */
+    if (0 > (ret = orte_rml.send_buffer_nb(ORTE_PROC_MY_NAME, relay,
+                                           ORTE_RML_TAG_DAEMON, 0,
+                                           orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(ret);
+        OBJ_RELEASE(relay);
+    }
+}
+
+void orte_grpcomm_base_xcast_chunk_recv(int status, orte_process_name_t* sender,
+                                        opal_buffer_t* buffer, orte_rml_tag_t tag,
+                                        void* cbdata)
+{
+    orte_grpcomm_xcast_pending_t *msg;
+    orte_grpcomm_xcast_piece_t *held;
+    opal_list_item_t *item;
+    opal_buffer_t *piece, *relay, update;
+    uint32_t id;
+    orte_vpid_t ndaemons;
+    size_t size, offset;
+    int32_t cnt, len;
+    int ret;
+
+    /* keep the piece intact for the relay */
+    piece = OBJ_NEW(opal_buffer_t);
+    opal_dss.copy_payload(piece, buffer);
+
+    cnt = 1;
+    if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &id, &cnt, OPAL_UINT32)) ||
+        ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &ndaemons, &cnt, ORTE_VPID)) ||
+        ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &size, &cnt, OPAL_SIZE)) ||
+        ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &offset, &cnt, OPAL_SIZE))) {
+        ORTE_ERROR_LOG(ret);
+        OBJ_RELEASE(piece);
+        return;
+    }
+
+    msg = NULL;
+    for (item = opal_list_get_first(&orte_grpcomm_base.xcast_pending);
+         item != opal_list_get_end(&orte_grpcomm_base.xcast_pending);
+         item = opal_list_get_next(item)) {
+        if (id == ((orte_grpcomm_xcast_pending_t*)item)->id) {
+            msg = (orte_grpcomm_xcast_pending_t*)item;
+            break;
+        }
+    }
+    if (NULL == msg) {
+        msg = OBJ_NEW(orte_grpcomm_xcast_pending_t);
+        msg->id = id;
+        msg->size = size;
+        if (NULL == (msg->bytes = (char*)malloc(size))) {
+            ORTE_ERROR_LOG(ORTE_ERR_OUT_OF_RESOURCE);
+            OBJ_RELEASE(msg);
+            OBJ_RELEASE(piece);
+            return;
+        }
+        /* the pieces can only be passed on as they come if our
+         * routing plan is already the one the message was sent with
+         */
+        msg->hold = (ndaemons != orte_process_info.num_procs);
+        opal_list_append(&orte_grpcomm_base.xcast_pending, &msg->super);
+    }
+
+    len = (int32_t)(size - offset);
+    if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, msg->bytes + offset, &len, OPAL_BYTE))) {
+        ORTE_ERROR_LOG(ret);
+        OBJ_RELEASE(piece);
+        return;
+    }
+    msg->recvd += len;
+
+    if (msg->hold) {
+        held = OBJ_NEW(orte_grpcomm_xcast_piece_t);
+        held->buf = piece;
+        opal_list_append(&msg->held, &held->super);
+    } else {
+        xcast_relay(piece, ORTE_RML_TAG_XCAST_CHUNK);
+        OBJ_RELEASE(piece);
+    }
+
+    if (msg->recvd < msg->size) {
+        return;
+    }
+
+    OPAL_OUTPUT_VERBOSE((5, orte_grpcomm_base_framework.framework_output,
+                         "%s grpcomm:base:xcast received all %lu bytes of message %u",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         (unsigned long)msg->size, msg->id));
+
+    /* the message is complete - load it back, the buffer takes the bytes */
+    opal_list_remove_item(&orte_grpcomm_base.xcast_pending, &msg->super);
+    relay = OBJ_NEW(opal_buffer_t);
+    opal_dss.load(relay, msg->bytes, msg->size);
+    msg->bytes = NULL;
+
+    OBJ_CONSTRUCT(&update, opal_buffer_t);
+    opal_dss.copy_payload(&update, relay);
+    xcast_update(&update);
+    OBJ_DESTRUCT(&update);
+
+    /* now that the routing plan is current, pass on what we kept */
+    while (NULL != (item = opal_list_remove_first(&msg->held))) {
+        xcast_relay(((orte_grpcomm_xcast_piece_t*)item)->buf, ORTE_RML_TAG_XCAST_CHUNK);
+        OBJ_RELEASE(item);
+    }
+    OBJ_RELEASE(msg);
 
     /* now send it to myself for processing */
     if (0 > (ret = orte_rml.send_buffer_nb(ORTE_PROC_MY_NAME, relay,
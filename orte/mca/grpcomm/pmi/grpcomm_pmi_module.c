@@ -186,6 +186,12 @@ static int modex(orte_grpcomm_collective_t *coll)
 
      /* our RTE data was constructed and pushed in the ESS pmi component */
 
+    /* have the db publish everything we stored as a single blob */
+    if (OPAL_SUCCESS != (rc = opal_db.commit((opal_identifier_t*)ORTE_PROC_MY_NAME))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+
     /* commit our modex info */
 #if WANT_PMI2_SUPPORT
     PMI2_KVS_Fence();
@@ -53,7 +53,7 @@ void orte_iof_hnp_recv(int status, orte_process_name_t* sender,
                        void* cbdata)
 {
     orte_process_name_t origin;
-    unsigned char data[ORTE_IOF_BASE_MSG_MAX];
+    unsigned char *data;
     orte_iof_tag_t stream;
     int32_t count, numbytes;
     orte_iof_sink_t *sink;
@@ -160,12 +160,18 @@ void orte_iof_hnp_recv(int status, orte_process_name_t* sender,
         goto CLEAN_RETURN;
     }
     
-    /* this must have come from a daemon forwarding output - unpack the data */
-    numbytes=ORTE_IOF_BASE_MSG_MAX;
-    if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, data, &numbytes, OPAL_BYTE))) {
+    /* this must have come from a daemon forwarding output - the data
+     * is only read from the buffer, so don't copy it out
+     */
+ NEXT_RECORD:
+    if (ORTE_SUCCESS != (rc = opal_dss.unpack_borrow(buffer, (void**)&data, &numbytes, OPAL_BYTE))) {
         ORTE_ERROR_LOG(rc);
         goto CLEAN_RETURN;
     }
+    if (ORTE_IOF_BASE_MSG_MAX < numbytes) {
+        ORTE_ERROR_LOG(ORTE_ERR_UNPACK_INADEQUATE_SPACE);
+        goto CLEAN_RETURN;
+    }
     /* numbytes will contain the actual #bytes that were sent */
     
     OPAL_OUTPUT_VERBOSE((1, orte_iof_base_framework.framework_output,
@@ -198,6 +204,23 @@ void orte_iof_hnp_recv(int status, orte_process_name_t* sender,
             orte_iof_hnp_send_data_to_endpoint(&sink->daemon, &origin, stream, data, numbytes);
         }
     }
+
+    /* the daemons aggregate the output of their procs, so more
+     * records may follow in the same message
+     */
+    if (buffer->unpack_ptr < buffer->base_ptr + buffer->bytes_used) {
+        count = 1;
+        if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &stream, &count, ORTE_IOF_TAG))) {
+            ORTE_ERROR_LOG(rc);
+            goto CLEAN_RETURN;
+        }
+        count = 1;
+        if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &origin, &count, ORTE_NAME))) {
+            ORTE_ERROR_LOG(rc);
+            goto CLEAN_RETURN;
+        }
+        goto NEXT_RECORD;
+    }
     
 CLEAN_RETURN:
     return;
@@ -109,6 +109,12 @@ static int init(void)
     OBJ_CONSTRUCT(&mca_iof_orted_component.sinks, opal_list_t);
     OBJ_CONSTRUCT(&mca_iof_orted_component.procs, opal_list_t);
     mca_iof_orted_component.xoff = false;
+    mca_iof_orted_component.agg = NULL;
+    mca_iof_orted_component.agg_timer_active = false;
+    mca_iof_orted_component.pending = 0;
+    mca_iof_orted_component.dropped = 0;
+    opal_event_evtimer_set(orte_event_base, &mca_iof_orted_component.agg_ev,
+                           orte_iof_orted_flush_timeout, NULL);
     
     return ORTE_SUCCESS;
 }
@@ -319,6 +325,13 @@ static int finalize(void)
         OBJ_RELEASE(item);
     }
     OBJ_DESTRUCT(&mca_iof_orted_component.procs);
+    if (mca_iof_orted_component.agg_timer_active) {
+        opal_event_evtimer_del(&mca_iof_orted_component.agg_ev);
+        mca_iof_orted_component.agg_timer_active = false;
+    }
+    if (NULL != mca_iof_orted_component.agg) {
+        OBJ_RELEASE(mca_iof_orted_component.agg);
+    }
     /* Cancel the RML receive */
     rc = orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORTE_RML_TAG_IOF_PROXY);
     return rc;
@@ -49,6 +49,8 @@
 #include "orte_config.h"
 
 #include "opal/class/opal_list.h"
+#include "opal/dss/dss_types.h"
+#include "opal/mca/event/event.h"
 
 #include "orte/mca/rml/rml_types.h"
 
@@ -64,6 +66,15 @@ struct orte_iof_orted_component_t {
     opal_list_t sinks;
     opal_list_t procs;
     bool xoff;
+    /* output of the local procs waiting to go to the HNP as one message */
+    opal_buffer_t *agg;
+    opal_event_t agg_ev;
+    bool agg_timer_active;
+    int agg_size;         /* flush the aggregate once it has this many bytes */
+    int agg_timeout;      /* ... or this many usecs after its first record */
+    int drop_above;       /* drop output while more bytes than this are in flight */
+    size_t pending;       /* bytes sent to the HNP and not yet completed */
+    uint64_t dropped;     /* bytes dropped since the last notice */
 };
 typedef struct orte_iof_orted_component_t orte_iof_orted_component_t;
 
@@ -76,6 +87,8 @@ void orte_iof_orted_recv(int status, orte_process_name_t* sender,
 
 void orte_iof_orted_read_handler(int fd, short event, void *data);
 void orte_iof_orted_send_xonxoff(orte_iof_tag_t tag);
+void orte_iof_orted_flush(void);
+void orte_iof_orted_flush_timeout(int fd, short event, void *cbdata);
 
 END_C_DECLS
 
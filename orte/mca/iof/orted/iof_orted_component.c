@@ -31,6 +31,7 @@
 static int orte_iof_orted_open(void);
 static int orte_iof_orted_close(void);
 static int orte_iof_orted_query(mca_base_module_t **module, int *priority);
+static int orte_iof_orted_register(void);
 
 
 /*
@@ -53,7 +54,8 @@ orte_iof_orted_component_t mca_iof_orted_component = {
             /* Component open, close, and query functions */
             orte_iof_orted_open,
             orte_iof_orted_close,
-            orte_iof_orted_query
+            orte_iof_orted_query,
+            orte_iof_orted_register
         },
         {
             /* The component is checkpoint ready */
@@ -62,6 +64,41 @@ orte_iof_orted_component_t mca_iof_orted_component = {
     }
 };
 
+static int orte_iof_orted_register(void)
+{
+    mca_base_component_t *c = &mca_iof_orted_component.super.iof_version;
+
+    mca_iof_orted_component.agg_size = 16 * 1024;
+    (void) mca_base_component_var_register (c, "aggregate_size",
+                                            "Forward the output of the local procs to the HNP in messages "
+                                            "of up to this many bytes (0 = one message per read)",
+                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_iof_orted_component.agg_size);
+
+    mca_iof_orted_component.agg_timeout = 10000;
+    (void) mca_base_component_var_register (c, "aggregate_timeout",
+                                            "Longest time (in usecs) output is held back waiting for "
+                                            "more to fill an aggregated message",
+                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_iof_orted_component.agg_timeout);
+
+    mca_iof_orted_component.drop_above = 0;
+    (void) mca_base_component_var_register (c, "drop_above",
+                                            "Discard, and count, the output of the local procs while more "
+                                            "than this many bytes of it are on their way to the HNP, "
+                                            "rather than let it queue up (0 = never drop)",
+                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_iof_orted_component.drop_above);
+
+    return ORTE_SUCCESS;
+}
+
 /**
   * component open/close/init function
   */
@@ -31,6 +31,7 @@
 #endif  /* HAVE_STRING_H */
 
 #include "opal/dss/dss.h"
+#include "opal/util/output.h"
 
 #include "orte/mca/rml/rml.h"
 #include "orte/mca/errmgr/errmgr.h"
@@ -51,18 +52,119 @@ static void send_cb(int status, orte_process_name_t *peer,
                     opal_buffer_t *buf, orte_rml_tag_t tag,
                     void *cbdata)
 {
-    /* nothing to do here - just release buffer and return */
+    /* the output is off our hands - just release buffer and return */
+    if (mca_iof_orted_component.pending > buf->bytes_used) {
+        mca_iof_orted_component.pending -= buf->bytes_used;
+    } else {
+        mca_iof_orted_component.pending = 0;
+    }
     OBJ_RELEASE(buf);
 }
 
+static int pack_record(opal_buffer_t *buf, orte_iof_tag_t tag,
+                       orte_process_name_t *name,
+                       unsigned char *data, int32_t numbytes)
+{
+    int rc;
+
+    /* pack the stream first - we do this so that flow control messages can
+     * consist solely of the tag
+     */
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(buf, &tag, 1, ORTE_IOF_TAG))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    
+    /* pack name of process that gave us this data */
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(buf, name, 1, ORTE_NAME))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    
+    /* pack the data - only pack the #bytes we read! */
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(buf, data, numbytes, OPAL_BYTE))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    return ORTE_SUCCESS;
+}
+
+static void send_to_hnp(opal_buffer_t *buf)
+{
+    int rc;
+
+    mca_iof_orted_component.pending += buf->bytes_used;
+    if (0 > (rc = orte_rml.send_buffer_nb(ORTE_PROC_MY_HNP, buf, ORTE_RML_TAG_IOF_HNP,
+                                          0, send_cb, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        mca_iof_orted_component.pending -= buf->bytes_used;
+        OBJ_RELEASE(buf);
+    }
+}
+
+/*
+ * Send whatever output has been aggregated so far. The HNP unpacks
+ * the records of a message one after the other, so an aggregate is
+ * just the records of several reads packed back to back.
+ */
+void orte_iof_orted_flush(void)
+{
+    opal_buffer_t *buf = mca_iof_orted_component.agg;
+    char *msg;
+
+    if (mca_iof_orted_component.agg_timer_active) {
+        opal_event_evtimer_del(&mca_iof_orted_component.agg_ev);
+        mca_iof_orted_component.agg_timer_active = false;
+    }
+
+    /* tell the user some output was lost, once we can */
+    if (0 < mca_iof_orted_component.dropped &&
+        mca_iof_orted_component.pending <= (size_t)mca_iof_orted_component.drop_above) {
+        asprintf(&msg, "[%s] dropped %lu bytes of output from local procs\n",
+                 ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                 (unsigned long)mca_iof_orted_component.dropped);
+        if (NULL != msg) {
+            if (NULL == buf) {
+                buf = OBJ_NEW(opal_buffer_t);
+            }
+            if (ORTE_SUCCESS == pack_record(buf, ORTE_IOF_STDERR, ORTE_PROC_MY_NAME,
+                                            (unsigned char*)msg, strlen(msg))) {
+                mca_iof_orted_component.dropped = 0;
+            }
+            free(msg);
+        }
+    }
+
+    mca_iof_orted_component.agg = NULL;
+    if (NULL == buf) {
+        return;
+    }
+    if (0 == buf->bytes_used) {
+        OBJ_RELEASE(buf);
+        return;
+    }
+
+    OPAL_OUTPUT_VERBOSE((1, orte_iof_base_framework.framework_output,
+                         "%s iof:orted:flush sending %lu bytes to HNP",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         (unsigned long)buf->bytes_used));
+    send_to_hnp(buf);
+}
+
+void orte_iof_orted_flush_timeout(int fd, short event, void *cbdata)
+{
+    mca_iof_orted_component.agg_timer_active = false;
+    orte_iof_orted_flush();
+}
+
 
 void orte_iof_orted_read_handler(int fd, short event, void *cbdata)
 {
     orte_iof_read_event_t *rev = (orte_iof_read_event_t*)cbdata;
     unsigned char data[ORTE_IOF_BASE_MSG_MAX];
     opal_buffer_t *buf=NULL;
-    int rc;
     int32_t numbytes;
+    struct timeval tv;
     opal_list_item_t *item;
     orte_iof_proc_t *proct;
     orte_ns_cmp_bitmask_t mask;
@@ -131,36 +233,53 @@ void orte_iof_orted_read_handler(int fd, short event, void *cbdata)
         goto RESTART;
     }
     
-    /* prep the buffer */
-    buf = OBJ_NEW(opal_buffer_t);
-    
-    /* pack the stream first - we do this so that flow control messages can
-     * consist solely of the tag
+    /* if the HNP is that far behind, keep draining the pipe so the
+     * proc does not block on it, but let the output go
      */
-    if (ORTE_SUCCESS != (rc = opal_dss.pack(buf, &rev->tag, 1, ORTE_IOF_TAG))) {
-        ORTE_ERROR_LOG(rc);
-        goto CLEAN_RETURN;
+    if (0 < mca_iof_orted_component.drop_above &&
+        mca_iof_orted_component.pending > (size_t)mca_iof_orted_component.drop_above) {
+        mca_iof_orted_component.dropped += numbytes;
+        goto RESTART;
     }
-    
-    /* pack name of process that gave us this data */
-    if (ORTE_SUCCESS != (rc = opal_dss.pack(buf, &rev->name, 1, ORTE_NAME))) {
-        ORTE_ERROR_LOG(rc);
-        goto CLEAN_RETURN;
+
+    if (0 >= mca_iof_orted_component.agg_size) {
+        if (0 < mca_iof_orted_component.dropped) {
+            /* report the loss ahead of this output */
+            orte_iof_orted_flush();
+        }
+        /* prep the buffer */
+        buf = OBJ_NEW(opal_buffer_t);
+        if (ORTE_SUCCESS != pack_record(buf, rev->tag, &rev->name, data, numbytes)) {
+            goto CLEAN_RETURN;
+        }
+
+        /* start non-blocking RML call to forward received data */
+        OPAL_OUTPUT_VERBOSE((1, orte_iof_base_framework.framework_output,
+                             "%s iof:orted:read handler sending %d bytes to HNP",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), numbytes));
+        send_to_hnp(buf);
+        buf = NULL;
+        goto RESTART;
     }
-    
-    /* pack the data - only pack the #bytes we read! */
-    if (ORTE_SUCCESS != (rc = opal_dss.pack(buf, &data, numbytes, OPAL_BYTE))) {
-        ORTE_ERROR_LOG(rc);
+
+    /* add it to the aggregate, which goes out once full or once it
+     * has waited long enough
+     */
+    if (NULL == mca_iof_orted_component.agg) {
+        mca_iof_orted_component.agg = OBJ_NEW(opal_buffer_t);
+    }
+    if (ORTE_SUCCESS != pack_record(mca_iof_orted_component.agg, rev->tag,
+                                    &rev->name, data, numbytes)) {
         goto CLEAN_RETURN;
     }
-
-    /* start non-blocking RML call to forward received data */
-    OPAL_OUTPUT_VERBOSE((1, orte_iof_base_framework.framework_output,
-                         "%s iof:orted:read handler sending %d bytes to HNP",
-                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), numbytes));
-    
-    orte_rml.send_buffer_nb(ORTE_PROC_MY_HNP, buf, ORTE_RML_TAG_IOF_HNP,
-                            0, send_cb, NULL);
+    if (mca_iof_orted_component.agg->bytes_used >= (size_t)mca_iof_orted_component.agg_size) {
+        orte_iof_orted_flush();
+    } else if (!mca_iof_orted_component.agg_timer_active) {
+        tv.tv_sec = mca_iof_orted_component.agg_timeout / 1000000;
+        tv.tv_usec = mca_iof_orted_component.agg_timeout % 1000000;
+        opal_event_evtimer_add(&mca_iof_orted_component.agg_ev, &tv);
+        mca_iof_orted_component.agg_timer_active = true;
+    }
     
  RESTART:
     /* re-add the event */
@@ -199,7 +318,10 @@ void orte_iof_orted_read_handler(int fd, short event, void *cbdata)
             if (NULL == proct->revstdout &&
                 NULL == proct->revstderr &&
                 NULL == proct->revstddiag) {
-                /* this proc's iof is complete */
+                /* this proc's iof is complete - its last output must
+                 * reach the HNP ahead of the state update
+                 */
+                orte_iof_orted_flush();
                 opal_list_remove_item(&mca_iof_orted_component.procs, item);
                 ORTE_ACTIVATE_PROC_STATE(&proct->name, ORTE_PROC_STATE_IOF_COMPLETE);
                 OBJ_RELEASE(proct);
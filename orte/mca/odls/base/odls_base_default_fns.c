@@ -50,6 +50,7 @@
 #include "opal/util/sys_limits.h"
 #include "opal/dss/dss.h"
 #include "opal/mca/hwloc/hwloc.h"
+#include "opal/mca/hwloc/base/base.h"
 #include "opal/mca/shmem/base/base.h"
 #include "opal/mca/pstat/pstat.h"
 
@@ -762,6 +763,19 @@ static int odls_base_default_setup_fork(orte_app_context_t *context,
         }
         free(param2);
     }
+
+#if OPAL_HAVE_HWLOC
+    /* let the children load our topology from shared memory rather
+     * than each of them discovering the node all over again
+     */
+    if (OPAL_SUCCESS == opal_hwloc_base_share_topology(orte_process_info.top_session_dir,
+                                                       &param2)) {
+        (void) mca_base_var_env_name ("hwloc_base_topo_shmem", &param);
+        opal_setenv(param, param2, true, environ_copy);
+        free(param);
+        free(param2);
+    }
+#endif
     
     /* push data into environment - don't push any single proc
      * info, though. We are setting the environment up on a
@@ -32,6 +32,7 @@
 #include "opal/mca/mca.h"
 #include "opal/mca/base/base.h"
 #include "opal/mca/hwloc/hwloc.h"
+#include "opal/mca/hwloc/base/base.h"
 #include "opal/util/output.h"
 #include "opal/util/path.h"
 #include "opal/util/argv.h"
@@ -99,6 +100,11 @@ static int orte_odls_base_close(void)
     }
     OBJ_RELEASE(orte_local_children);
 
+#if OPAL_HAVE_HWLOC
+    /* remove the topology segment we shared with our children */
+    opal_hwloc_base_unshare_topology();
+#endif
+
     return mca_base_framework_components_close(&orte_odls_base_framework, NULL);
 }
 
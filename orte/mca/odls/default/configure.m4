@@ -26,6 +26,7 @@ AC_DEFUN([MCA_orte_odls_default_CONFIG],[
     AC_CONFIG_FILES([orte/mca/odls/default/Makefile])
 
     AC_CHECK_FUNC([fork], [odls_default_happy="yes"], [odls_default_happy="no"])
+    AC_CHECK_FUNCS([vfork])
 
     AS_IF([test "$odls_default_happy" = "yes"], [$1], [$2])
 
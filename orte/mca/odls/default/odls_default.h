@@ -37,6 +37,11 @@ int orte_odls_default_component_open(void);
 int orte_odls_default_component_close(void);
 int orte_odls_default_component_query(mca_base_module_t **module, int *priority);
 
+/*
+ * Launch the local procs through vfork() when possible
+ */
+extern bool orte_odls_default_use_vfork;
+
 /*
  * ODLS Default module
  */
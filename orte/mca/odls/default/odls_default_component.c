@@ -43,6 +43,10 @@
  * and pointers to our public functions in it
  */
 
+static int orte_odls_default_component_register(void);
+
+bool orte_odls_default_use_vfork = false;
+
 orte_odls_base_component_t mca_odls_default_component = {
     /* First, the mca_component_t struct containing meta information
     about the component itself */
@@ -58,6 +62,7 @@ orte_odls_base_component_t mca_odls_default_component = {
         orte_odls_default_component_open,
         orte_odls_default_component_close,
         orte_odls_default_component_query,
+        orte_odls_default_component_register
     },
     {
         /* The component is checkpoint ready */
@@ -67,6 +72,20 @@ orte_odls_base_component_t mca_odls_default_component = {
 
 
 
+static int orte_odls_default_component_register(void)
+{
+    orte_odls_default_use_vfork = false;
+    (void) mca_base_component_var_register(&mca_odls_default_component.version, "use_vfork",
+                                           "Launch the local processes with vfork() instead of fork(), "
+                                           "so that the time to launch does not depend on the memory "
+                                           "footprint of the daemon.  Not used when the system limits "
+                                           "or a memory binding policy are set at launch",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0, OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &orte_odls_default_use_vfork);
+
+    return ORTE_SUCCESS;
+}
+
 int orte_odls_default_component_open(void)
 {
     return ORTE_SUCCESS;
@@ -106,10 +106,14 @@
 #ifdef HAVE_SYS_SELECT_H
 #include <sys/select.h>
 #endif
+#ifdef HAVE_TERMIOS_H
+#include <termios.h>
+#endif
 
 #include "opal/mca/hwloc/hwloc.h"
 #include "opal/mca/hwloc/base/base.h"
 #include "opal/class/opal_pointer_array.h"
+#include "opal/util/argv.h"
 #include "opal/util/opal_environ.h"
 #include "opal/util/show_help.h"
 #include "opal/util/sys_limits.h"
@@ -771,6 +775,354 @@ static int do_parent(orte_app_context_t* context,
 }
 
 
+#if HAVE_VFORK
+/*
+ * Launch through vfork().  The daemon is suspended only until the
+ * child calls execve() and its page tables are not copied, so the
+ * cost of a launch does not grow with the memory footprint of the
+ * daemon as it does with fork().  The child shares the address space
+ * of the daemon: it may only make system calls, and everything else
+ * -- the environment, the binding, the error messages -- is done by
+ * the parent.  The binding is inherited: the parent binds its own
+ * thread to the cpus of the child around the vfork().
+ */
+
+/*
+ * Struct written up the pipe by a vfork'ed child that failed to exec.
+ */
+typedef struct {
+    /* the IOF child setup failed rather than execve() */
+    int iof_failed;
+    /* errno of the failed call */
+    int err;
+} vfork_err_msg_t;
+
+static bool odls_default_can_vfork(orte_proc_t *child)
+{
+    if (!orte_odls_default_use_vfork || NULL == child) {
+        return false;
+    }
+    /* the system limits are parsed and set by the child */
+    if (NULL != opal_set_max_sys_limits) {
+        return false;
+    }
+#if OPAL_HAVE_HWLOC
+    /* so is a memory binding policy */
+    if (OPAL_HWLOC_BASE_MAP_NONE != opal_hwloc_base_map) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+static void vfork_child_error(int write_fd, int iof_failed)
+{
+    vfork_err_msg_t msg;
+
+    msg.iof_failed = iof_failed;
+    msg.err = errno;
+    (void) write(write_fd, &msg, sizeof(msg));
+    _exit(1);
+}
+
+/*
+ * Runs in the vfork'ed child: system calls only.  The descriptors are
+ * set up as by orte_iof_base_setup_child().
+ */
+static void do_vfork_child(orte_app_context_t* context,
+                           char **environ_copy, int write_fd,
+                           orte_iof_base_io_conf_t *opts, long fdmax)
+{
+    long fd;
+    sigset_t sigs;
+
+    if (orte_forward_job_control) {
+        setpgid(0, 0);
+    }
+
+    close(opts->p_stdin[1]);
+    close(opts->p_stdout[0]);
+    close(opts->p_stderr[0]);
+    close(opts->p_internal[0]);
+
+#ifdef HAVE_TERMIOS_H
+    if (opts->usepty) {
+        /* disable echo */
+        struct termios term_attrs;
+        if (tcgetattr(opts->p_stdout[1], &term_attrs) < 0) {
+            vfork_child_error(write_fd, 1);
+        }
+        term_attrs.c_lflag &= ~ (ECHO | ECHOE | ECHOK |
+                                 ECHOCTL | ECHOKE | ECHONL);
+        term_attrs.c_iflag &= ~ (ICRNL | INLCR | ISTRIP | INPCK | IXON);
+        term_attrs.c_oflag &= ~ (
+#ifdef OCRNL
+                                 OCRNL | 
+#endif
+                                 ONLCR);
+        if (tcsetattr(opts->p_stdout[1], TCSANOW, &term_attrs) == -1) {
+            vfork_child_error(write_fd, 1);
+        }
+    }
+#endif
+    if (opts->p_stdout[1] != STDOUT_FILENO) {
+        if (dup2(opts->p_stdout[1], STDOUT_FILENO) < 0) {
+            vfork_child_error(write_fd, 1);
+        }
+        close(opts->p_stdout[1]);
+    }
+    if (opts->connect_stdin) {
+        if (opts->p_stdin[0] != STDIN_FILENO) {
+            if (dup2(opts->p_stdin[0], STDIN_FILENO) < 0) {
+                vfork_child_error(write_fd, 1);
+            }
+            close(opts->p_stdin[0]);
+        }
+    } else {
+        int fdnull;
+
+        close(opts->p_stdin[0]);
+        fdnull = open("/dev/null", O_RDONLY, 0);
+        if (fdnull > STDIN_FILENO) {
+            dup2(fdnull, STDIN_FILENO);
+            close(fdnull);
+        }
+    }
+    if (opts->p_stderr[1] != STDERR_FILENO) {
+        if (dup2(opts->p_stderr[1], STDERR_FILENO) < 0) {
+            vfork_child_error(write_fd, 1);
+        }
+        close(opts->p_stderr[1]);
+    }
+
+    for (fd = 3; fd < fdmax; fd++) {
+        if (fd != opts->p_internal[1] && fd != write_fd) {
+            close(fd);
+        }
+    }
+
+    set_handler_default(SIGTERM);
+    set_handler_default(SIGINT);
+    set_handler_default(SIGHUP);
+    set_handler_default(SIGPIPE);
+    set_handler_default(SIGCHLD);
+
+    sigprocmask(0, 0, &sigs);
+    sigprocmask(SIG_UNBLOCK, &sigs, 0);
+
+    execve(context->app, context->argv, environ_copy);
+    vfork_child_error(write_fd, 0);
+}
+
+#if OPAL_HAVE_HWLOC
+/*
+ * Bind the calling thread to the cpus of the child, which inherits
+ * the binding, and save the previous binding of the thread in
+ * prev_cpuset.  Returns ORTE_ERR_FAILED_TO_START if the child must
+ * not be launched.
+ */
+static int vfork_bind(orte_app_context_t* context, orte_proc_t *child,
+                      char ***environ_copy, orte_job_t *jobdat,
+                      hwloc_cpuset_t prev_cpuset, bool *bound)
+{
+    hwloc_cpuset_t cpuset;
+    char *param, *msg = NULL;
+    int rc;
+
+    *bound = false;
+    if (NULL == child->cpu_bitmap) {
+        return ORTE_SUCCESS;
+    }
+
+    cpuset = hwloc_bitmap_alloc();
+    if (0 != (rc = hwloc_bitmap_list_sscanf(cpuset, child->cpu_bitmap))) {
+        asprintf(&msg, "hwloc_bitmap_sscanf returned \"%s\" for the string \"%s\"",
+                 opal_strerror(rc), child->cpu_bitmap);
+    } else if (hwloc_get_cpubind(opal_hwloc_topology, prev_cpuset,
+                                 HWLOC_CPUBIND_THREAD) < 0) {
+        msg = strdup("hwloc_get_cpubind failed for the launching thread");
+    } else if (hwloc_set_cpubind(opal_hwloc_topology, cpuset,
+                                 HWLOC_CPUBIND_THREAD) < 0) {
+        if (errno == ENOSYS) {
+            msg = strdup("hwloc indicates cpu binding not supported");
+        } else if (errno == EXDEV) {
+            msg = strdup("hwloc indicates cpu binding cannot be enforced");
+        } else {
+            asprintf(&msg, "hwloc_set_cpubind failed for bitmap \"%s\"",
+                     child->cpu_bitmap);
+        }
+    } else {
+        *bound = true;
+    }
+
+    if (!*bound) {
+        if (OPAL_BINDING_REQUIRED(jobdat->map->binding)) {
+            orte_show_help("help-orte-odls-default.txt", "binding generic error", true,
+                           orte_process_info.nodename, context->app,
+                           (NULL == msg) ? "out of memory" : msg, __FILE__, __LINE__);
+            rc = ORTE_ERR_FAILED_TO_START;
+        } else {
+            orte_show_help("help-orte-odls-default.txt", "not bound", true,
+                           orte_process_info.nodename, context->app,
+                           (NULL == msg) ? "out of memory" : msg, __FILE__, __LINE__);
+            rc = ORTE_SUCCESS;
+        }
+        if (NULL != msg) {
+            free(msg);
+        }
+        hwloc_bitmap_free(cpuset);
+        return rc;
+    }
+
+    if (opal_hwloc_report_bindings) {
+        char tmp1[1024], tmp2[1024];
+        opal_hwloc_base_cset2str(tmp1, sizeof(tmp1), cpuset);
+        opal_hwloc_base_cset2mapstr(tmp2, sizeof(tmp2), cpuset);
+        opal_output(0, "MCW rank %d bound to %s: %s",
+                    child->name.vpid, tmp1, tmp2);
+        /* avoid reporting it twice */
+        (void) mca_base_var_env_name ("hwloc_base_report_bindings", &param);
+        opal_unsetenv(param, environ_copy);
+        free(param);
+    }
+    hwloc_bitmap_free(cpuset);
+
+    /* as in do_child() */
+    (void) mca_base_var_env_name ("orte_bound_at_launch", &param);
+    opal_setenv(param, "1", true, environ_copy);
+    free(param);
+    (void) mca_base_var_env_name ("orte_base_applied_binding", &param);
+    opal_setenv(param, child->cpu_bitmap, true, environ_copy);
+    free (param);
+
+    return ORTE_SUCCESS;
+}
+#endif
+
+static int do_vfork_parent(orte_app_context_t* context,
+                           orte_proc_t *child,
+                           orte_job_t *jobdat, int read_fd,
+                           orte_iof_base_io_conf_t *opts)
+{
+    vfork_err_msg_t msg;
+    int rc;
+
+    if (ORTE_JOB_CONTROL_FORWARD_OUTPUT & jobdat->controls) {
+        /* connect endpoints IOF */
+        rc = orte_iof_base_setup_parent(&child->name, opts);
+        if (ORTE_SUCCESS != rc) {
+            ORTE_ERROR_LOG(rc);
+            close(read_fd);
+            child->state = ORTE_PROC_STATE_UNDEF;
+            return rc;
+        }
+    }
+
+    /* the child has exec'ed or exited by now: the pipe is either
+       closed or holds the reason of the failure */
+    rc = opal_fd_read(read_fd, sizeof(msg), &msg);
+    close(read_fd);
+    if (OPAL_ERR_TIMEOUT == rc) {
+        child->state = ORTE_PROC_STATE_RUNNING;
+        child->alive = true;
+        return ORTE_SUCCESS;
+    }
+
+    if (OPAL_SUCCESS != rc) {
+        ORTE_ERROR_LOG(rc);
+    } else if (msg.iof_failed) {
+        orte_show_help("help-orte-odls-default.txt", "iof setup failed", true,
+                       orte_process_info.nodename, context->app);
+    } else {
+        orte_show_help("help-orte-odls-default.txt", "execve error", true,
+                       orte_process_info.nodename, context->app, strerror(msg.err));
+    }
+    child->state = ORTE_PROC_STATE_FAILED_TO_START;
+    child->alive = false;
+    return ORTE_ERR_FAILED_TO_START;
+}
+
+static int odls_default_vfork_local_proc(orte_app_context_t* context,
+                                         orte_proc_t *child,
+                                         char **environ_copy,
+                                         orte_job_t *jobdat,
+                                         orte_iof_base_io_conf_t *opts)
+{
+    long fdmax = sysconf(_SC_OPEN_MAX);
+    char **env, *str;
+    int rc, p[2];
+    pid_t pid;
+#if OPAL_HAVE_HWLOC
+    hwloc_cpuset_t prev_cpuset;
+    bool bound = false;
+#endif
+
+    /* the environment of the app context is shared by its procs */
+    env = opal_argv_copy(environ_copy);
+    if (!orte_map_stddiag_to_stderr) {
+        /* as in orte_iof_base_setup_child() */
+        asprintf(&str, "%d", opts->p_internal[1]);
+        if (NULL != str) {
+            opal_setenv("OPAL_OUTPUT_STDERR_FD", str, true, &env);
+            free(str);
+        }
+    }
+    if (context->argv == NULL) {
+        context->argv = malloc(sizeof(char*)*2);
+        context->argv[0] = strdup(context->app);
+        context->argv[1] = NULL;
+    }
+
+#if OPAL_HAVE_HWLOC
+    prev_cpuset = hwloc_bitmap_alloc();
+    if (ORTE_SUCCESS != (rc = vfork_bind(context, child, &env, jobdat,
+                                         prev_cpuset, &bound))) {
+        hwloc_bitmap_free(prev_cpuset);
+        opal_argv_free(env);
+        child->state = ORTE_PROC_STATE_FAILED_TO_START;
+        child->exit_code = rc;
+        return rc;
+    }
+#endif
+
+    if (pipe(p) < 0) {
+        rc = ORTE_ERR_SYS_LIMITS_PIPES;
+        pid = -1;
+    } else {
+        fcntl(p[1], F_SETFD, FD_CLOEXEC);
+        rc = ORTE_ERR_SYS_LIMITS_CHILDREN;
+        pid = vfork();
+        if (pid == 0) {
+            do_vfork_child(context, env, p[1], opts, fdmax);
+            /* Does not return */
+        }
+        if (pid < 0) {
+            close(p[0]);
+            close(p[1]);
+        }
+    }
+
+#if OPAL_HAVE_HWLOC
+    if (bound) {
+        hwloc_set_cpubind(opal_hwloc_topology, prev_cpuset, HWLOC_CPUBIND_THREAD);
+    }
+    hwloc_bitmap_free(prev_cpuset);
+#endif
+    opal_argv_free(env);
+
+    child->pid = pid;
+    if (pid < 0) {
+        ORTE_ERROR_LOG(rc);
+        child->state = ORTE_PROC_STATE_FAILED_TO_START;
+        child->exit_code = rc;
+        return rc;
+    }
+
+    close(p[1]);
+    return do_vfork_parent(context, child, jobdat, p[0], opts);
+}
+#endif  /* HAVE_VFORK */
+
 /**
  *  Fork/exec the specified processes
  */
@@ -807,6 +1159,13 @@ static int odls_default_fork_local_proc(orte_app_context_t* context,
         }
     }
 
+#if HAVE_VFORK
+    if (odls_default_can_vfork(child)) {
+        return odls_default_vfork_local_proc(context, child, environ_copy,
+                                             jobdat, &opts);
+    }
+#endif
+
     /* A pipe is used to communicate between the parent and child to
        indicate whether the exec ultimately succeeded or failed.  The
        child sets the pipe to be close-on-exec; the child only ever
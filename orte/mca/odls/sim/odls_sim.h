@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2013      Los Alamos National Security, LLC.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file:
+ *
+ * Simulated local launch. Children are constructed and walked through
+ * the normal proc state machine exactly as if they had been fork'd,
+ * but no process is ever created. Used together with ras/simulator and
+ * plm_rsh_sim_hosts to exercise the launch, xcast and teardown path of
+ * a large allocation on a handful of real hosts.
+ */
+
+#ifndef ORTE_ODLS_SIM_H
+#define ORTE_ODLS_SIM_H
+
+#include "orte_config.h"
+
+#include "opal/mca/mca.h"
+
+#include "orte/mca/odls/odls.h"
+
+BEGIN_C_DECLS
+
+/*
+ * ODLS Sim component
+ */
+struct orte_odls_sim_component_t {
+    orte_odls_base_component_t super;
+    /* must be set for the component to be selected */
+    bool enable;
+    /* msec each simulated proc "runs" before reporting a zero exit */
+    int runtime;
+};
+typedef struct orte_odls_sim_component_t orte_odls_sim_component_t;
+
+/*
+ * ODLS Sim module
+ */
+extern orte_odls_base_module_t orte_odls_sim_module;
+ORTE_MODULE_DECLSPEC extern orte_odls_sim_component_t mca_odls_sim_component;
+
+END_C_DECLS
+
+#endif /* ORTE_ODLS_SIM_H */
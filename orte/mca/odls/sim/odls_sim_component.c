@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2013      Los Alamos National Security, LLC.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orte_config.h"
+#include "orte/constants.h"
+
+#include "opal/mca/mca.h"
+#include "opal/mca/base/base.h"
+
+#include "orte/mca/odls/odls.h"
+#include "orte/mca/odls/base/odls_private.h"
+#include "orte/mca/odls/sim/odls_sim.h"
+
+static int odls_sim_register(void);
+static int odls_sim_query(mca_base_module_t **module, int *priority);
+
+orte_odls_sim_component_t mca_odls_sim_component = {
+    {
+        /* First, the mca_component_t struct containing meta information
+           about the component itself */
+        {
+            ORTE_ODLS_BASE_VERSION_2_0_0,
+            /* Component name and version */
+            "sim",
+            ORTE_MAJOR_VERSION,
+            ORTE_MINOR_VERSION,
+            ORTE_RELEASE_VERSION,
+
+            /* Component open and close functions */
+            NULL,
+            NULL,
+            odls_sim_query,
+            odls_sim_register
+        },
+        {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        }
+    }
+};
+
+
+static int odls_sim_register(void)
+{
+    mca_base_component_t *c = &mca_odls_sim_component.super.version;
+
+    mca_odls_sim_component.enable = false;
+    (void) mca_base_component_var_register (c, "enable",
+                                            "Simulate the launch of local procs instead of fork'ing them (for launch scaling studies only)",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_odls_sim_component.enable);
+
+    mca_odls_sim_component.runtime = 0;
+    (void) mca_base_component_var_register (c, "runtime",
+                                            "Time in msec each simulated proc runs before reporting normal termination",
+                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_odls_sim_component.runtime);
+
+    return ORTE_SUCCESS;
+}
+
+static int odls_sim_query(mca_base_module_t **module, int *priority)
+{
+    if (!mca_odls_sim_component.enable) {
+        *module = NULL;
+        *priority = 0;
+        return ORTE_ERROR;
+    }
+    /* must override the default */
+    *priority = 1000;
+    *module = (mca_base_module_t *) &orte_odls_sim_module;
+    return ORTE_SUCCESS;
+}
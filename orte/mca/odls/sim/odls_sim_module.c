@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2013      Los Alamos National Security, LLC.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orte_config.h"
+#include "orte/constants.h"
+#include "orte/types.h"
+
+#include <stdlib.h>
+
+#include "opal/mca/event/event.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/state/state.h"
+#include "orte/runtime/orte_globals.h"
+#include "orte/runtime/orte_wait.h"
+#include "orte/util/name_fns.h"
+
+#include "orte/mca/odls/base/base.h"
+#include "orte/mca/odls/base/odls_private.h"
+#include "orte/mca/odls/sim/odls_sim.h"
+
+/*
+ * External Interface
+ */
+static int orte_odls_sim_launch_local_procs(opal_buffer_t *data);
+static int orte_odls_sim_kill_local_procs(opal_pointer_array_t *procs);
+static int orte_odls_sim_signal_local_procs(const orte_process_name_t *proc, int32_t signal);
+static int orte_odls_sim_restart_proc(orte_proc_t *child);
+
+orte_odls_base_module_t orte_odls_sim_module = {
+    orte_odls_base_default_get_add_procs_data,
+    orte_odls_sim_launch_local_procs,
+    orte_odls_sim_kill_local_procs,
+    orte_odls_sim_signal_local_procs,
+    orte_odls_base_default_deliver_message,
+    orte_odls_base_default_require_sync,
+    orte_odls_sim_restart_proc
+};
+
+
+/*
+ * A simulated child has no pid, so there is nothing to deliver a
+ * signal to and nothing that can fail to die
+ */
+static int sim_signal(pid_t pid, int signum)
+{
+    return ORTE_SUCCESS;
+}
+
+static bool sim_child_died(orte_proc_t *child)
+{
+    return true;
+}
+
+/*
+ * Report the normal termination of every simulated child of the job
+ * that is still running. The state machine sees exactly the sequence
+ * a real waitpid would have produced, so the termination messages to
+ * the HNP and the job teardown are the real ones.
+ */
+static void sim_terminate(orte_jobid_t job)
+{
+    orte_proc_t *child;
+    int i;
+
+    for (i=0; i < orte_local_children->size; i++) {
+        if (NULL == (child = (orte_proc_t*)opal_pointer_array_get_item(orte_local_children, i))) {
+            continue;
+        }
+        /* skip anything already killed by command */
+        if (child->name.jobid != job || !child->alive || child->waitpid_recvd) {
+            continue;
+        }
+        child->exit_code = 0;
+        ORTE_ACTIVATE_PROC_STATE(&child->name, ORTE_PROC_STATE_WAITPID_FIRED);
+    }
+}
+
+static void sim_timeout(int fd, short event, void *cbdata)
+{
+    orte_timer_t *tm = (orte_timer_t*)cbdata;
+    orte_jobid_t *job = (orte_jobid_t*)tm->payload;
+
+    sim_terminate(*job);
+    free(job);
+    OBJ_RELEASE(tm);
+}
+
+static void sim_start(orte_proc_t *child)
+{
+    /* no pid means the base kill/signal logic never touches a real process */
+    child->pid = 0;
+    /* there are no pipes to drain */
+    child->iof_complete = true;
+    child->waitpid_recvd = false;
+    child->exit_code = 0;
+    child->alive = true;
+    ORTE_ACTIVATE_PROC_STATE(&child->name, ORTE_PROC_STATE_RUNNING);
+}
+
+static int orte_odls_sim_launch_local_procs(opal_buffer_t *data)
+{
+    int rc, i;
+    orte_jobid_t job, *jptr;
+    orte_job_t *jobdat;
+    orte_proc_t *child;
+
+    /* construct the list of children we are to "launch" */
+    if (ORTE_SUCCESS != (rc = orte_odls_base_default_construct_child_list(data, &job))) {
+        OPAL_OUTPUT_VERBOSE((2, orte_odls_base_framework.framework_output,
+                             "%s odls:sim:launch:local failed to construct child list on error %s",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), ORTE_ERROR_NAME(rc)));
+        return rc;
+    }
+
+    if (NULL == (jobdat = orte_get_job_data_object(job))) {
+        ORTE_ERROR_LOG(ORTE_ERR_NOT_FOUND);
+        ORTE_ACTIVATE_JOB_STATE(NULL, ORTE_JOB_STATE_FAILED_TO_LAUNCH);
+        return ORTE_ERR_NOT_FOUND;
+    }
+
+    OPAL_OUTPUT_VERBOSE((5, orte_odls_base_framework.framework_output,
+                         "%s odls:sim: simulating %d local procs of job %s",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         (int)jobdat->num_local_procs, ORTE_JOBID_PRINT(job)));
+
+    for (i=0; i < orte_local_children->size; i++) {
+        if (NULL == (child = (orte_proc_t*)opal_pointer_array_get_item(orte_local_children, i))) {
+            continue;
+        }
+        if (child->name.jobid != job || child->alive) {
+            continue;
+        }
+        sim_start(child);
+    }
+
+    /* let the state machine report the launch to the HNP */
+    ORTE_ACTIVATE_JOB_STATE(jobdat, ORTE_JOB_STATE_LOCAL_LAUNCH_COMPLETE);
+
+    if (0 == jobdat->num_local_procs) {
+        return ORTE_SUCCESS;
+    }
+    if (mca_odls_sim_component.runtime <= 0) {
+        sim_terminate(job);
+    } else {
+        jptr = (orte_jobid_t*)malloc(sizeof(orte_jobid_t));
+        *jptr = job;
+        ORTE_DETECT_TIMEOUT(1, 1000 * mca_odls_sim_component.runtime, -1, sim_timeout, jptr);
+    }
+    return ORTE_SUCCESS;
+}
+
+static int orte_odls_sim_kill_local_procs(opal_pointer_array_t *procs)
+{
+    int rc;
+
+    if (ORTE_SUCCESS != (rc = orte_odls_base_default_kill_local_procs(procs, sim_signal,
+                                                                      sim_child_died))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    return ORTE_SUCCESS;
+}
+
+static int orte_odls_sim_signal_local_procs(const orte_process_name_t *proc, int32_t signal)
+{
+    int rc;
+
+    if (ORTE_SUCCESS != (rc = orte_odls_base_default_signal_local_procs(proc, signal, sim_signal))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    return ORTE_SUCCESS;
+}
+
+static int orte_odls_sim_restart_proc(orte_proc_t *child)
+{
+    orte_jobid_t *jptr;
+
+    sim_start(child);
+    if (mca_odls_sim_component.runtime <= 0) {
+        sim_terminate(child->name.jobid);
+    } else {
+        jptr = (orte_jobid_t*)malloc(sizeof(orte_jobid_t));
+        *jptr = child->name.jobid;
+        ORTE_DETECT_TIMEOUT(1, 1000 * mca_odls_sim_component.runtime, -1, sim_timeout, jptr);
+    }
+    return ORTE_SUCCESS;
+}
@@ -268,6 +268,19 @@ static int mca_oob_tcp_component_register(void)
                                             MCA_BASE_VAR_SCOPE_LOCAL,
                                             &mca_oob_tcp_component.connect_sleep);
 
+    mca_oob_tcp_component.tcp_send_batch = MCA_OOB_TCP_BATCH_IOV_MAX;
+    (void) mca_base_component_var_register (component, "send_batch",
+                                            "Maximum number of iovecs of the messages queued to a "
+                                            "peer to write with a single writev (0 or 1 = one "
+                                            "message per writev, at most 64)",
+                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_LOCAL,
+                                            &mca_oob_tcp_component.tcp_send_batch);
+    if (mca_oob_tcp_component.tcp_send_batch > MCA_OOB_TCP_BATCH_IOV_MAX) {
+        mca_oob_tcp_component.tcp_send_batch = MCA_OOB_TCP_BATCH_IOV_MAX;
+    }
+
     mca_oob_tcp_component.tcp_listen_type = OOB_TCP_EVENT;
     (void) mca_base_var_enum_create ("listen modes", tcp_listen_mode_values, &new_enum);
     var_id = mca_base_component_var_register (component, "listen_mode",
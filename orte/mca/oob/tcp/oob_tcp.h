@@ -188,6 +188,9 @@ void mca_oob_tcp_set_socket_options(int sd);
 
 int mca_oob_tcp_ft_event(int state);
 
+/* upper bound of the iovecs written by one batched writev */
+#define MCA_OOB_TCP_BATCH_IOV_MAX 64
+
 typedef enum { OOB_TCP_EVENT, OOB_TCP_LISTEN_THREAD } mca_oob_tcp_listen_type_t;
 
 /**
@@ -247,6 +250,7 @@ struct mca_oob_tcp_component_t {
     struct timeval tcp_listen_thread_tv;  /**< Timeout when using listen thread */
 
     int connect_sleep;
+    int tcp_send_batch;                   /**< max iovecs gathered from the send queue into one writev */
 };
 
 /**
@@ -80,6 +80,7 @@ static int  mca_oob_tcp_peer_recv_blocking(mca_oob_tcp_peer_t* peer, int sd, voi
 static int  mca_oob_tcp_peer_send_blocking(mca_oob_tcp_peer_t* peer, int sd, void* data, size_t size);
 static void mca_oob_tcp_peer_recv_handler(int sd, short flags, void* user);
 static void mca_oob_tcp_peer_send_handler(int sd, short flags, void* user);
+static bool mca_oob_tcp_peer_send_batch(mca_oob_tcp_peer_t* peer);
 static void mca_oob_tcp_peer_timer_handler(int sd, short flags, void* user);
 
 
@@ -970,6 +971,15 @@ static void mca_oob_tcp_peer_send_handler(int sd, short flags, void* user)
 
             /* complete the current send */
             mca_oob_tcp_msg_t* msg = peer->peer_send_msg;
+            if(ntohl(msg->msg_hdr.msg_type) != MCA_OOB_TCP_PING &&
+               !opal_list_is_empty(&peer->peer_send_queue) &&
+               msg->msg_rwnum < mca_oob_tcp_component.tcp_send_batch) {
+                /* others are waiting behind it - write them together */
+                if(!mca_oob_tcp_peer_send_batch(peer)) {
+                    break;
+                }
+                continue;
+            }
             if(ntohl(msg->msg_hdr.msg_type) == MCA_OOB_TCP_PING ||
                mca_oob_tcp_msg_send_handler(msg, peer)) {
                 mca_oob_tcp_msg_complete(msg, &peer->peer_name);
@@ -1000,6 +1010,82 @@ static void mca_oob_tcp_peer_send_handler(int sd, short flags, void* user)
 }
                                                                                                                        
 
+/*
+ * Write the current message and as many of the queued ones as fit in
+ * MCA_OOB_TCP_BATCH_IOV_MAX iovecs with a single writev, so a burst of
+ * small messages to a peer costs one system call instead of one per
+ * message. The messages which went out entirely are completed in
+ * order and peer_send_msg is left on the first one which did not.
+ * @retval false if the socket would block, true otherwise
+ */
+static bool mca_oob_tcp_peer_send_batch(mca_oob_tcp_peer_t* peer)
+{
+    struct iovec iov[MCA_OOB_TCP_BATCH_IOV_MAX];
+    mca_oob_tcp_msg_t* msg = peer->peer_send_msg;
+    opal_list_item_t* item;
+    int count = 0, rc;
+
+    /* the current message, then the queue up to the first ping */
+    memcpy(iov, msg->msg_rwptr, msg->msg_rwnum * sizeof(struct iovec));
+    count = msg->msg_rwnum;
+    for(item = opal_list_get_first(&peer->peer_send_queue);
+        item != opal_list_get_end(&peer->peer_send_queue);
+        item = opal_list_get_next(item)) {
+        mca_oob_tcp_msg_t* next = (mca_oob_tcp_msg_t*)item;
+        if(ntohl(next->msg_hdr.msg_type) == MCA_OOB_TCP_PING ||
+           count + next->msg_rwnum > mca_oob_tcp_component.tcp_send_batch) {
+            break;
+        }
+        memcpy(iov + count, next->msg_rwptr, next->msg_rwnum * sizeof(struct iovec));
+        count += next->msg_rwnum;
+    }
+
+    while((rc = writev(peer->peer_sd, iov, count)) < 0) {
+        if(opal_socket_errno == EINTR) {
+            continue;
+        }
+        if(opal_socket_errno == EAGAIN || opal_socket_errno == EWOULDBLOCK) {
+            return false;
+        }
+        opal_output(0, "%s->%s mca_oob_tcp_peer_send_batch: writev failed: %s (%d) [sd = %d]", 
+                    ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), 
+                    ORTE_NAME_PRINT(&(peer->peer_name)), 
+                    strerror(opal_socket_errno),
+                    opal_socket_errno,
+                    peer->peer_sd);
+        mca_oob_tcp_peer_close(peer);
+        /* fail the current message only, as a single send would */
+        msg->msg_rc = ORTE_ERR_CONNECTION_FAILED;
+        mca_oob_tcp_msg_complete(msg, &peer->peer_name);
+        peer->peer_send_msg = (mca_oob_tcp_msg_t*)
+            opal_list_remove_first(&peer->peer_send_queue);
+        return true;
+    }
+
+    /* spread the bytes written over the messages, in queue order */
+    while(NULL != msg) {
+        while(msg->msg_rwnum > 0 && rc >= (int)msg->msg_rwptr->iov_len) {
+            rc -= msg->msg_rwptr->iov_len;
+            msg->msg_rc += msg->msg_rwptr->iov_len;
+            (msg->msg_rwnum)--;
+            (msg->msg_rwptr)++;
+        }
+        if(msg->msg_rwnum > 0) {
+            msg->msg_rwptr->iov_len -= rc;
+            msg->msg_rwptr->iov_base = (ompi_iov_base_ptr_t)((char *) msg->msg_rwptr->iov_base + rc);
+            msg->msg_rc += rc;
+            break;
+        }
+        mca_oob_tcp_msg_complete(msg, &peer->peer_name);
+        msg = peer->peer_send_msg = (mca_oob_tcp_msg_t*)
+            opal_list_remove_first(&peer->peer_send_queue);
+        if(0 == rc) {
+            break;
+        }
+    }
+    return true;
+}
+
 /*
  * Routine for debugging to print the connection state and socket options
  */
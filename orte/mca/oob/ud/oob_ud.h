@@ -167,6 +167,9 @@ struct mca_oob_ud_component_t {
     int               ud_recv_buffer_count;
     int               ud_send_buffer_count;
 
+    int               ud_priority;
+    int               ud_window;
+
     opal_mutex_t      ud_match_lock;
 
     opal_hash_table_t ud_peers;
@@ -120,6 +120,28 @@ static int mca_oob_ud_component_register (void)
                                             0, MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
                                             MCA_BASE_VAR_SCOPE_LOCAL, &mca_oob_ud_component.ud_send_buffer_count);
 
+    mca_oob_ud_component.ud_window = 1024;
+    (void) mca_base_component_var_register (component, "window", "Maximum number of MTU sized packets "
+                                            "of a message in flight before the receiver acknowledges them. "
+                                            "Lost packets are resent a window at a time (default: 1024, "
+                                            "maximum: 4096)", MCA_BASE_VAR_TYPE_INT, NULL,
+                                            0, MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_5,
+                                            MCA_BASE_VAR_SCOPE_LOCAL, &mca_oob_ud_component.ud_window);
+    /* a window must fit in a data queue pair */
+    if (mca_oob_ud_component.ud_window < 1) {
+        mca_oob_ud_component.ud_window = 1;
+    } else if (mca_oob_ud_component.ud_window > 4096) {
+        mca_oob_ud_component.ud_window = 4096;
+    }
+
+    mca_oob_ud_component.ud_priority = 0;
+    (void) mca_base_component_var_register (component, "priority", "Priority of the ud oob component. "
+                                            "Set above the priority of the tcp component (50) to make ud "
+                                            "the default on InfiniBand clusters; daemons use the component "
+                                            "selected by mpirun (default: 0)", MCA_BASE_VAR_TYPE_INT, NULL,
+                                            0, 0, OPAL_INFO_LVL_5,
+                                            MCA_BASE_VAR_SCOPE_READONLY, &mca_oob_ud_component.ud_priority);
+
     return ORTE_SUCCESS;
 }
 
@@ -219,10 +241,10 @@ static mca_oob_t *mca_oob_ud_component_init(int *priority)
     struct ibv_device **devices;
     int num_devices, i, rc;
 
-    /* set the priority so that we will select this component
-     * only if someone directs to do so
+    /* by default we will select this component only if someone
+     * directs to do so
      */
-    *priority = 0;
+    *priority = mca_oob_ud_component.ud_priority;
 
     opal_hash_table_init (&mca_oob_ud_component.ud_peers, 1024);
 
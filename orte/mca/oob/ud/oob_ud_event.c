@@ -484,6 +484,8 @@ static int mca_oob_ud_event_handle_rep (mca_oob_ud_port_t *port, mca_oob_ud_msg_
     send_req->req_rem_data_len = msg_hdr->msg_data.rep.data_len;
     send_req->req_rem_ctx      = msg_hdr->msg_rem_ctx;
     send_req->req_rem_qpn      = msg_hdr->msg_data.rep.qpn;
+    send_req->req_packet_first = msg_hdr->msg_data.rep.first;
+    send_req->req_packet_count = msg_hdr->msg_data.rep.count;
 
     mca_oob_ud_event_queue_completed (send_req);
 
@@ -263,8 +263,9 @@ static int mca_oob_ud_port_alloc_buffers (mca_oob_ud_port_t *port) {
         return rc;
     }
 
-    for (i = 0, item = opal_list_get_first (&port->free_msgs.super) ;
-         item != opal_list_get_end (&port->free_msgs.super) ;
+    /* nobody uses the free list yet so it is safe to walk the lifo */
+    for (i = 0, item = port->free_msgs.super.opal_lifo_head ;
+         item != &port->free_msgs.super.opal_lifo_ghost ;
          item = opal_list_get_next (item), ++i) {
         char *ptr = port->msg_buf.ptr + (i + mca_oob_ud_component.ud_recv_buffer_count) *
             port->mtu;
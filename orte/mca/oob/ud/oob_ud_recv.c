@@ -318,11 +318,17 @@ int mca_oob_ud_recv_try (mca_oob_ud_req_t *recv_req)
         wr_count = (data_len + mtu - 1) / mtu;
         sge_count += wr_count;
 
-        OPAL_OUTPUT_VERBOSE((5, mca_oob_base_output, "%s oob:ud:recv_try receiving %d bytes in %d "
-                             "work requests, %d sges", ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), data_len,
-                             wr_count, sge_count));
+        /* only a window of the message is posted at a time. it keeps the data
+           qp from overflowing on large messages and limits what is resent when
+           a packet is lost */
+        recv_req->req_packet_total = wr_count;
+        recv_req->req_packet_count = min(wr_count - recv_req->req_packet_first,
+                                         mca_oob_ud_component.ud_window);
 
-        recv_req->req_packet_count = wr_count;
+        OPAL_OUTPUT_VERBOSE((5, mca_oob_base_output, "%s oob:ud:recv_try receiving %d bytes in %d "
+                             "work requests, %d sges. window = %d/%d", ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                             data_len, wr_count, sge_count, recv_req->req_packet_first,
+                             recv_req->req_packet_count));
 
         if (NULL == recv_req->req_wr.recv) {
             /* allocate work requests */
@@ -373,9 +379,11 @@ int mca_oob_ud_recv_try (mca_oob_ud_req_t *recv_req)
 
         rc = ORTE_SUCCESS;
 
-        iov_left   = recv_req->req_uiov[0].iov_len;
-        iov_offset = 0;
-        iov_index  = 0;
+        wr_count = recv_req->req_packet_count;
+
+        mca_oob_ud_req_iov_seek (recv_req, (size_t) recv_req->req_packet_first * mtu,
+                                 &iov_index, &iov_offset);
+        iov_left = recv_req->req_uiov[iov_index].iov_len - iov_offset;
 
         for (wr_index = 0, sge_index = 0 ; wr_index < wr_count ; ++wr_index) {
             int sge_first = sge_index;
@@ -434,6 +442,8 @@ int mca_oob_ud_recv_try (mca_oob_ud_req_t *recv_req)
         rep_msg->hdr->msg_data.rep.qpn = recv_req->req_qp->ib_qp->qp_num;
         rep_msg->hdr->msg_data.rep.data_len = data_len;
         rep_msg->hdr->msg_data.rep.mtu = mtu;
+        rep_msg->hdr->msg_data.rep.first = recv_req->req_packet_first;
+        rep_msg->hdr->msg_data.rep.count = recv_req->req_packet_count;
 
         rc = mca_oob_ud_msg_post_send (rep_msg);
 
@@ -475,7 +485,9 @@ int mca_oob_ud_recv_complete (mca_oob_ud_req_t *recv_req)
                          ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), (void *) recv_req));
 
     if (false == recv_req->req_is_eager) {
-        for (i = 0, expected = 0 ; i < recv_req->req_packet_count ; ) {
+        expected = recv_req->req_packet_first;
+
+        for (i = 0 ; i < recv_req->req_packet_count ; ) {
             struct ibv_wc wc[10];
 
             rc = ibv_poll_cq (recv_req->req_qp->ib_recv_cq, 10, wc);
@@ -509,6 +521,24 @@ int mca_oob_ud_recv_complete (mca_oob_ud_req_t *recv_req)
                                  "out_of_order: %d packets: %d/%d. rc = %d, errno = %d. flags = %d",
                                  ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), error, out_of_order, i,
                                  recv_req->req_packet_count, rc, errno, recv_req->req_flags));
+
+            /* the request must be active again or the next completion message
+               will be taken for a duplicate */
+            mca_oob_ud_req_append_to_list (recv_req, &mca_oob_ud_component.ud_active_recvs);
+            mca_oob_ud_recv_try (recv_req);
+
+            return ORTE_SUCCESS;
+        }
+
+        recv_req->req_packet_first += recv_req->req_packet_count;
+        if (recv_req->req_packet_first < recv_req->req_packet_total) {
+            OPAL_OUTPUT_VERBOSE((10, mca_oob_base_output, "%s oob:ud:recv_complete window received ok. "
+                                 "posting for packet %d", ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                                 recv_req->req_packet_first));
+
+            /* post the next window. the reply tells the sender to go on */
+            recv_req->state = MCA_OOB_UD_REQ_PENDING;
+            mca_oob_ud_req_append_to_list (recv_req, &mca_oob_ud_component.ud_active_recvs);
             mca_oob_ud_recv_try (recv_req);
 
             return ORTE_SUCCESS;
@@ -588,6 +618,7 @@ int mca_oob_ud_recv_match_send (mca_oob_ud_port_t *port, mca_oob_ud_peer_t *peer
     req->req_mtu          = min(port->mtu, msg_hdr->msg_data.req.mtu);
     req->req_target       = msg_hdr->ra.name;
     req->req_rem_data_len = msg_hdr->msg_data.req.data_len;
+    req->req_packet_first = 0;
 
     do {
         rc = mca_oob_ud_recv_alloc (req);
@@ -65,7 +65,11 @@ struct mca_oob_ud_req_t {
     uint32_t                req_rem_qpn;
     int                     req_rem_data_len;
 
+    /* window of packets in flight: [req_packet_first, req_packet_first + req_packet_count)
+       of req_packet_total */
+    int                     req_packet_first;
     int                     req_packet_count;
+    int                     req_packet_total;
 
     struct mca_oob_ud_peer_t *req_peer;
     struct mca_oob_ud_port_t *req_port;
@@ -153,6 +157,9 @@ struct mca_oob_ud_msg_hdr_t {
             int data_len;
             int tag;
             int mtu;
+            /* window of packets the receiver posted */
+            int first;
+            int count;
         } rep;
     } msg_data;
 };
@@ -206,6 +213,22 @@ static inline int mca_oob_ud_recv_alloc (mca_oob_ud_req_t *recv_req)
     return ORTE_SUCCESS;
 }
 
+/* find the iovec entry holding byte offset of a request's data (the
+   start of a window) */
+static inline void mca_oob_ud_req_iov_seek (mca_oob_ud_req_t *req, size_t offset, int *iov_indexp,
+                                            unsigned int *iov_offsetp)
+{
+    int iov_index;
+
+    for (iov_index = 0 ; iov_index < req->req_count - 1 &&
+             offset >= req->req_uiov[iov_index].iov_len ; ++iov_index) {
+        offset -= req->req_uiov[iov_index].iov_len;
+    }
+
+    *iov_indexp  = iov_index;
+    *iov_offsetp = (unsigned int) offset;
+}
+
 int mca_oob_ud_msg_get (struct mca_oob_ud_port_t *port, mca_oob_ud_req_t *req,
                         mca_oob_ud_qp_t *qp, mca_oob_ud_peer_t *peer, bool persist,
                         mca_oob_ud_msg_t **msgp);
@@ -280,8 +280,10 @@ int mca_oob_ud_send_try (mca_oob_ud_req_t *send_req) {
         }
 
         OPAL_OUTPUT_VERBOSE((5, mca_oob_base_output, "%s oob:ud:send_try sending %d bytes in %d "
-                             "work requests, %d sges. uiov = %p", ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), data_len,
-                             wr_count, sge_count, (void *) send_req->req_uiov));
+                             "work requests, %d sges. window = %d/%d. uiov = %p",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), data_len, wr_count, sge_count,
+                             send_req->req_packet_first, send_req->req_packet_count,
+                             (void *) send_req->req_uiov));
 
         if (wr_count && NULL == send_req->req_wr.send) {
             send_req->req_wr.send = (struct ibv_send_wr *) calloc (wr_count, sizeof (struct ibv_send_wr));
@@ -304,9 +306,19 @@ int mca_oob_ud_send_try (mca_oob_ud_req_t *send_req) {
             }
         }
 
-        iov_left   = send_req->req_uiov[0].iov_len;
-        iov_offset = 0;
-        iov_index  = 0;
+        /* the work requests and sges are sized for the whole message. only the
+           window the receiver posted for is sent */
+        if (send_req->req_packet_first + send_req->req_packet_count > wr_count) {
+            mca_oob_ud_msg_return (com_msg);
+            rc = ORTE_ERR_BAD_PARAM;
+            break;
+        }
+
+        wr_count = send_req->req_packet_count;
+
+        mca_oob_ud_req_iov_seek (send_req, (size_t) send_req->req_packet_first * mtu,
+                                 &iov_index, &iov_offset);
+        iov_left = send_req->req_uiov[iov_index].iov_len - iov_offset;
 
         for (wr_index = 0, sge_index = 0 ; wr_index < wr_count ; ++wr_index) {
             int sge_first = sge_index;
@@ -342,7 +354,7 @@ int mca_oob_ud_send_try (mca_oob_ud_req_t *send_req) {
             send_req->req_wr.send[wr_index].send_flags       = IBV_SEND_SOLICITED;
 
             /* sequence number */
-            send_req->req_wr.send[wr_index].imm_data         = wr_index;
+            send_req->req_wr.send[wr_index].imm_data         = send_req->req_packet_first + wr_index;
             send_req->req_wr.send[wr_index].wr.ud.remote_qpn = send_req->req_rem_qpn;
             send_req->req_wr.send[wr_index].opcode           = IBV_WR_SEND_WITH_IMM;
 
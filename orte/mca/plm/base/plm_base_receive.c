@@ -50,6 +50,7 @@
 #include "orte/mca/ras/base/base.h"
 #include "orte/util/name_fns.h"
 #include "orte/mca/state/state.h"
+#include "orte/mca/state/base/base.h"
 #include "orte/runtime/orte_globals.h"
 #include "orte/runtime/orte_quit.h"
 
@@ -301,7 +302,9 @@ void orte_plm_base_recv(int status, orte_process_name_t* sender,
                     proc->state = state;
                     proc->pid = pid;
                     proc->exit_code = exit_code;
-                    ORTE_ACTIVATE_PROC_STATE(&name, state);
+                    if (!orte_state_base_apply_proc_state(jdata, proc, state)) {
+                        ORTE_ACTIVATE_PROC_STATE(&name, state);
+                    }
                     if (running) {
                         jdata->num_daemons_reported++;
                         if (orte_report_launch_progress) {
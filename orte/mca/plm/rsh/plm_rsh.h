@@ -59,9 +59,15 @@ struct orte_plm_rsh_component_t {
     int priority;
     bool no_tree_spawn;
     int num_concurrent;
+    bool adapt_concurrency;
     char *agent;
+    bool ssh_multiplex;
+    char *ssh_control_path;
+    int ssh_control_persist;
     bool assume_same_shell;
     bool pass_environ_mca_params;
+    char *sim_hosts;
+    char **sim_hostv;
 };
 typedef struct orte_plm_rsh_component_t orte_plm_rsh_component_t;
 
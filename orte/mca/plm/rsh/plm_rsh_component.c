@@ -112,6 +112,14 @@ static int rsh_component_register(void)
                                             MCA_BASE_VAR_SCOPE_READONLY,
                                             &mca_plm_rsh_component.num_concurrent);
 
+    mca_plm_rsh_component.adapt_concurrency = false;
+    (void) mca_base_component_var_register (c, "adapt_concurrency",
+                                            "Treat num_concurrent as an upper bound, and shrink or grow the number of concurrent plm_rsh_agent instances with the observed session latency",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_plm_rsh_component.adapt_concurrency);
+
     mca_plm_rsh_component.force_rsh = false;
     (void) mca_base_component_var_register (c, "force_rsh", "Force the launcher to always use rsh",
                                             MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
@@ -184,6 +192,30 @@ static int rsh_component_register(void)
     (void) mca_base_var_register_synonym (var_id, "orte", "pls", NULL, "rsh_agent", MCA_BASE_VAR_SYN_FLAG_DEPRECATED);
     (void) mca_base_var_register_synonym (var_id, "orte", "orte", NULL, "rsh_agent", MCA_BASE_VAR_SYN_FLAG_DEPRECATED);
 
+    mca_plm_rsh_component.ssh_multiplex = false;
+    (void) mca_base_component_var_register (c, "ssh_multiplex",
+                                            "If set to true and the agent is ssh, share one master connection per node between the ssh sessions (ControlMaster)",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_plm_rsh_component.ssh_multiplex);
+
+    mca_plm_rsh_component.ssh_control_path = NULL;
+    (void) mca_base_component_var_register (c, "ssh_control_path",
+                                            "Socket path of the ssh master connections, in ssh ControlPath syntax [default: <tmpdir>/.ompi-ssh-%r@%h:%p]",
+                                            MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_plm_rsh_component.ssh_control_path);
+
+    mca_plm_rsh_component.ssh_control_persist = 60;
+    (void) mca_base_component_var_register (c, "ssh_control_persist",
+                                            "Seconds an idle ssh master connection is kept open (0 = close it with the session which opened it)",
+                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_plm_rsh_component.ssh_control_persist);
+
     mca_plm_rsh_component.assume_same_shell = true;
     var_id = mca_base_component_var_register (c, "assume_same_shell",
                                               "If set to true, assume that the shell on the remote node is the same as the shell on the local node.  Otherwise, probe for what the remote shell [default: 1]",
@@ -202,6 +234,14 @@ static int rsh_component_register(void)
                                             MCA_BASE_VAR_SCOPE_READONLY,
                                             &mca_plm_rsh_component.pass_environ_mca_params);
 
+    mca_plm_rsh_component.sim_hosts = NULL;
+    (void) mca_base_component_var_register (c, "sim_hosts",
+                                            "Comma-separated list of real hosts on which to start the daemons of simulated nodes, round-robin by daemon vpid (used with ras_simulator_launch)",
+                                            MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_plm_rsh_component.sim_hosts);
+
     return ORTE_SUCCESS;
 }
 
@@ -212,6 +252,7 @@ static int rsh_component_open(void)
     /* initialize globals */
     mca_plm_rsh_component.using_qrsh = false;
     mca_plm_rsh_component.using_llspawn = false;
+    mca_plm_rsh_component.sim_hostv = NULL;
 
     /* lookup parameters */
     if (mca_plm_rsh_component.num_concurrent <= 0) {
@@ -230,6 +271,14 @@ static int rsh_component_open(void)
         }
     }
 
+    if (NULL != mca_plm_rsh_component.sim_hosts) {
+        mca_plm_rsh_component.sim_hostv = opal_argv_split(mca_plm_rsh_component.sim_hosts, ',');
+        if (0 == opal_argv_count(mca_plm_rsh_component.sim_hostv)) {
+            opal_argv_free(mca_plm_rsh_component.sim_hostv);
+            mca_plm_rsh_component.sim_hostv = NULL;
+        }
+    }
+
     return ORTE_SUCCESS;
 }
 
@@ -301,6 +350,10 @@ success:
 
 static int rsh_component_close(void)
 {
+    if (NULL != mca_plm_rsh_component.sim_hostv) {
+        opal_argv_free(mca_plm_rsh_component.sim_hostv);
+        mca_plm_rsh_component.sim_hostv = NULL;
+    }
     return ORTE_SUCCESS;
 }
 
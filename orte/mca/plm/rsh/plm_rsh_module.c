@@ -117,6 +117,7 @@ typedef struct {
     int argc;
     char **argv;
     orte_proc_t *daemon;
+    struct timeval start;
 } orte_plm_rsh_caddy_t;
 static void caddy_const(orte_plm_rsh_caddy_t *ptr)
 {
@@ -171,6 +172,9 @@ static int setup_shell(orte_plm_rsh_shell_t *rshell,
                        char *nodename, int *argc, char ***argv);
 static void launch_daemons(int fd, short args, void *cbdata);
 static void process_launch_list(int fd, short args, void *cbdata);
+static void adapt_concurrency(orte_plm_rsh_caddy_t *caddy);
+static void report_wave(void);
+static char *target_host(char *nodename, orte_vpid_t vpid);
 
 /* local global storage */
 static char *rsh_agent_path=NULL;
@@ -179,6 +183,19 @@ static int num_in_progress=0;
 static opal_list_t launch_list;
 static opal_event_t launch_event;
 
+/* launch metering: the number of sessions allowed at once, and the
+ * session latency it is tuned against (usec)
+ */
+static int num_concurrent=0;
+static unsigned long base_latency=0;
+static unsigned long avg_latency=0;
+static int num_since_adapt=0;
+
+/* the current launch wave */
+static struct timeval wave_start;
+static int wave_launched=0;
+static unsigned long wave_latency=0;
+
 /**
  * Init the module
  */
@@ -237,6 +254,7 @@ static int rsh_init(void)
     }
     
     /* setup the event for metering the launch */
+    num_concurrent = mca_plm_rsh_component.num_concurrent;
     OBJ_CONSTRUCT(&launch_list, opal_list_t);
     opal_event_set(orte_event_base, &launch_event, -1, 0, process_launch_list, NULL);
     opal_event_set_priority(&launch_event, ORTE_SYS_PRI);
@@ -307,7 +325,11 @@ static void rsh_wait_daemon(pid_t pid, int status, void* cbdata)
     
     /* release any delay */
     --num_in_progress;
-    if (num_in_progress < mca_plm_rsh_component.num_concurrent) {
+    adapt_concurrency(caddy);
+    if (0 == num_in_progress && 0 == opal_list_get_size(&launch_list)) {
+        report_wave();
+    }
+    if (num_in_progress < num_concurrent) {
         /* trigger continuation of the launch */
         opal_event_active(&launch_event, EV_WRITE, 1);
     }
@@ -315,6 +337,98 @@ static void rsh_wait_daemon(pid_t pid, int status, void* cbdata)
     OBJ_RELEASE(caddy);
 }
 
+/*
+ * The sessions of a launch wave mostly wait on the remote end, but the
+ * handshakes all compete for the cpu of the launching node: past some
+ * point, starting more of them at once only makes each one slower.
+ * When asked to, take the latency of the first completed sessions as a
+ * reference, halve the number of concurrent sessions when their average
+ * latency doubles, and grow it back one by one while it stays close to
+ * the reference.
+ */
+static void adapt_concurrency(orte_plm_rsh_caddy_t *caddy)
+{
+    struct timeval now;
+    unsigned long latency;
+
+    gettimeofday(&now, NULL);
+    latency = (now.tv_sec - caddy->start.tv_sec) * 1000000UL +
+              now.tv_usec - caddy->start.tv_usec;
+    wave_latency += latency;
+
+    /* the sessions stay open when the daemons are left attached, so
+     * their latency means nothing
+     */
+    if (!mca_plm_rsh_component.adapt_concurrency || orte_leave_session_attached) {
+        return;
+    }
+
+    if (0 == base_latency) {
+        base_latency = avg_latency = latency;
+        return;
+    }
+    avg_latency = (3 * avg_latency + latency) / 4;
+
+    /* let the sessions started under the previous setting drain before
+     * judging the new one
+     */
+    if (++num_since_adapt < num_concurrent) {
+        return;
+    }
+    if (avg_latency > 2 * base_latency && 1 < num_concurrent) {
+        num_concurrent /= 2;
+        num_since_adapt = 0;
+    } else if (4 * avg_latency < 5 * base_latency &&
+               num_concurrent < mca_plm_rsh_component.num_concurrent) {
+        num_concurrent++;
+        num_since_adapt = 0;
+    } else {
+        return;
+    }
+    OPAL_OUTPUT_VERBOSE((5, orte_plm_base_framework.framework_output,
+                         "%s plm:rsh: session latency %lu usec (reference %lu) - %d concurrent sessions",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         avg_latency, base_latency, num_concurrent));
+}
+
+static void report_wave(void)
+{
+    struct timeval now;
+    long secs, usecs;
+
+    if (0 == wave_launched) {
+        return;
+    }
+    if (orte_timing) {
+        gettimeofday(&now, NULL);
+        ORTE_COMPUTE_TIME_DIFF(secs, usecs, wave_start.tv_sec, wave_start.tv_usec,
+                               now.tv_sec, now.tv_usec);
+        opal_output(0, "%s plm:rsh: launched %d daemons in %ld.%06ld sec - "
+                    "mean session %lu usec, %d concurrent sessions",
+                    ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), wave_launched,
+                    secs, usecs, wave_latency / wave_launched, num_concurrent);
+    }
+    wave_launched = 0;
+    wave_latency = 0;
+}
+
+/*
+ * Host the agent should actually connect to in order to start the
+ * daemon for the given node. Normally that is the node itself, but
+ * when simulating a large allocation the daemons of the simulated
+ * nodes are spread round-robin across the few real sim_hosts.
+ */
+static char *target_host(char *nodename, orte_vpid_t vpid)
+{
+    int nhosts;
+
+    if (NULL == mca_plm_rsh_component.sim_hostv) {
+        return nodename;
+    }
+    nhosts = opal_argv_count(mca_plm_rsh_component.sim_hostv);
+    return mca_plm_rsh_component.sim_hostv[vpid % nhosts];
+}
+
 static int setup_launch(int *argcptr, char ***argvptr,
                         char *nodename,
                         int *node_name_index1,
@@ -830,7 +944,7 @@ static int remote_spawn(opal_buffer_t *launch)
         }
         
         free(argv[node_name_index1]);
-        argv[node_name_index1] = strdup(hostname);
+        argv[node_name_index1] = strdup(target_host(hostname, target.vpid));
         
         /* pass the vpid */
         rc = orte_util_convert_vpid_to_string(&var, target.vpid);
@@ -908,7 +1022,7 @@ static void process_launch_list(int fd, short args, void *cbdata)
     pid_t pid;
     orte_plm_rsh_caddy_t *caddy;
     
-    while (num_in_progress < mca_plm_rsh_component.num_concurrent) {
+    while (num_in_progress < num_concurrent) {
         item = opal_list_remove_first(&launch_list);
         if (NULL == item) {
             /* we are done */
@@ -930,6 +1044,10 @@ static void process_launch_list(int fd, short args, void *cbdata)
         } else { /* father */
             /* indicate this daemon has been launched */
             caddy->daemon->state = ORTE_PROC_STATE_RUNNING;
+            gettimeofday(&caddy->start, NULL);
+            if (0 == wave_launched++) {
+                wave_start = caddy->start;
+            }
             /* record the pid */
             caddy->daemon->pid = pid;
             
@@ -1129,7 +1247,10 @@ static void launch_daemons(int fd, short args, void *cbdata)
     }
     
     /* setup the launch */
-    if (ORTE_SUCCESS != (rc = setup_launch(&argc, &argv, node->name, &node_name_index1,
+    if (ORTE_SUCCESS != (rc = setup_launch(&argc, &argv,
+                                           target_host(node->name, (NULL == node->daemon) ?
+                                                       0 : node->daemon->name.vpid),
+                                           &node_name_index1,
                                            &proc_vpid_index, prefix_dir))) {
         ORTE_ERROR_LOG(rc);
         goto cleanup;
@@ -1187,10 +1308,10 @@ static void launch_daemons(int fd, short args, void *cbdata)
         free(argv[node_name_index1]);
         if (NULL != node->username &&
             0 != strlen (node->username)) {
-            asprintf (&argv[node_name_index1], "%s@%s",
-                      node->username, node->name);
+            asprintf (&argv[node_name_index1], "%s@%s", node->username,
+                      target_host(node->name, node->daemon->name.vpid));
         } else {
-            argv[node_name_index1] = strdup(node->name);
+            argv[node_name_index1] = strdup(target_host(node->name, node->daemon->name.vpid));
         }
         
         /* pass the vpid */
@@ -1325,7 +1446,7 @@ static orte_plm_rsh_shell_t find_shell(char *shell)
 
 static int launch_agent_setup(const char *agent, char *path)
 {
-    char *bname;
+    char *bname, *tmp;
     int i;
     
     /* if no agent was provided, then report not found */
@@ -1374,6 +1495,32 @@ static int launch_agent_setup(const char *agent, char *path)
                 opal_argv_append_nosize(&rsh_agent_argv, "-x");
             }
         }
+        /* share the connections to a node between sessions - the
+         * shell probe and the launch, or the launches of successive jobs
+         */
+        if (mca_plm_rsh_component.ssh_multiplex) {
+            opal_argv_append_nosize(&rsh_agent_argv, "-o");
+            opal_argv_append_nosize(&rsh_agent_argv, "ControlMaster=auto");
+            if (NULL != mca_plm_rsh_component.ssh_control_path) {
+                asprintf(&tmp, "ControlPath=%s", mca_plm_rsh_component.ssh_control_path);
+            } else {
+                asprintf(&tmp, "ControlPath=%s/.ompi-ssh-%%r@%%h:%%p", opal_tmp_directory());
+            }
+            opal_argv_append_nosize(&rsh_agent_argv, "-o");
+            opal_argv_append_nosize(&rsh_agent_argv, tmp);
+            free(tmp);
+            if (0 < mca_plm_rsh_component.ssh_control_persist) {
+                asprintf(&tmp, "ControlPersist=%d", mca_plm_rsh_component.ssh_control_persist);
+            } else {
+                tmp = strdup("ControlPersist=no");
+            }
+            opal_argv_append_nosize(&rsh_agent_argv, "-o");
+            opal_argv_append_nosize(&rsh_agent_argv, tmp);
+            free(tmp);
+        }
+    }
+    if (NULL != bname) {
+        free(bname);
     }
     
     /* the caller can append any additional argv's they desire */
@@ -24,6 +24,7 @@ struct orte_ras_sim_component_t {
     char *topofiles;
     bool have_cpubind;
     bool have_membind;
+    bool launch;
 };
 typedef struct orte_ras_sim_component_t orte_ras_sim_component_t;
 
@@ -120,6 +120,13 @@ static int ras_sim_register(void)
                                             MCA_BASE_VAR_SCOPE_READONLY,
                                             &mca_ras_simulator_component.num_nodes);
 #endif
+    mca_ras_simulator_component.launch = false;
+    (void) mca_base_component_var_register (component, "launch",
+                                            "Launch daemons for the simulated nodes (requires plm_rsh_sim_hosts and odls_sim to place them on real hosts)",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_ras_simulator_component.launch);
         
     return ORTE_SUCCESS;
 }
@@ -130,9 +137,14 @@ static int ras_sim_component_query(mca_base_module_t **module, int *priority)
     if (NULL != mca_ras_simulator_component.num_nodes) {
         *module = (mca_base_module_t *) &orte_ras_sim_module;
         *priority = 1000;
-        /* cannot launch simulated nodes or resolve their names to addresses */
-        orte_do_not_launch = true;
+        /* cannot resolve the names of simulated nodes to addresses */
         opal_if_do_not_resolve = true;
+        /* nor launch on them, unless their daemons are being
+         * multiplexed onto real hosts
+         */
+        if (!mca_ras_simulator_component.launch) {
+            orte_do_not_launch = true;
+        }
         return ORTE_SUCCESS;
     }
 
@@ -0,0 +1,21 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2013      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+# 
+# Additional copyrights may follow
+# 
+# $HEADER$
+#
+
+# MCA_rmaps_commgraph_CONFIG([action-if-found], [action-if-not-found])
+# -----------------------------------------------------------
+AC_DEFUN([MCA_orte_rmaps_commgraph_CONFIG], [
+    AC_CONFIG_FILES([orte/mca/rmaps/commgraph/Makefile])
+
+    AS_IF([test "$OPAL_HAVE_HWLOC" = 1],
+          [$1],
+          [$2])
+])
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Resource mapping driven by the communication pattern of the
+ * application.  The volume exchanged by every pair of ranks is read
+ * from a file, one "sender receiver volume" triple per line, and the
+ * ranks are placed on the slots of the allocation by recursive
+ * bisection of the node and hwloc hierarchy, so that the ranks that
+ * exchange the most end up the fewest hops apart.
+ */
+#ifndef ORTE_RMAPS_COMMGRAPH_H
+#define ORTE_RMAPS_COMMGRAPH_H
+
+#include "orte_config.h"
+#include "orte/mca/rmaps/rmaps.h"
+
+BEGIN_C_DECLS
+
+ORTE_MODULE_DECLSPEC extern orte_rmaps_base_component_t mca_rmaps_commgraph_component;
+extern orte_rmaps_base_module_t orte_rmaps_commgraph_module;
+
+/* file holding the communication matrix, the mapper is off without one */
+extern char *orte_rmaps_commgraph_path;
+/* hops charged for going from one node to another, on top of the
+ * hops up and down the hwloc trees of the two nodes */
+extern int orte_rmaps_commgraph_net_hops;
+
+END_C_DECLS
+
+#endif
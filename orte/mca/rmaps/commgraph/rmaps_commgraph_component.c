@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#include "orte_config.h"
+#include "orte/constants.h"
+
+#include "opal/mca/base/base.h"
+#include "opal/mca/base/mca_base_var.h"
+
+#include "orte/mca/rmaps/base/rmaps_private.h"
+#include "rmaps_commgraph.h"
+
+/*
+ * Local functions
+ */
+
+static int orte_rmaps_commgraph_open(void);
+static int orte_rmaps_commgraph_close(void);
+static int orte_rmaps_commgraph_query(mca_base_module_t **module, int *priority);
+static int orte_rmaps_commgraph_register(void);
+
+static int my_priority;
+
+char *orte_rmaps_commgraph_path = NULL;
+int orte_rmaps_commgraph_net_hops = 4;
+
+orte_rmaps_base_component_t mca_rmaps_commgraph_component = {
+    {
+        ORTE_RMAPS_BASE_VERSION_2_0_0,
+        
+        "commgraph", /* MCA component name */
+        ORTE_MAJOR_VERSION,  /* MCA component major version */
+        ORTE_MINOR_VERSION,  /* MCA component minor version */
+        ORTE_RELEASE_VERSION,  /* MCA component release version */
+        orte_rmaps_commgraph_open,  /* component open  */
+        orte_rmaps_commgraph_close, /* component close */
+        orte_rmaps_commgraph_query,  /* component query */
+        orte_rmaps_commgraph_register
+    },
+    {
+        /* The component is checkpoint ready */
+        MCA_BASE_METADATA_PARAM_CHECKPOINT
+    }
+};
+
+
+static int orte_rmaps_commgraph_register(void)
+{
+    mca_base_component_t *c = &mca_rmaps_commgraph_component.base_version;
+
+    my_priority = 0;
+    (void) mca_base_component_var_register(c, "priority", "Priority of the commgraph rmaps component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &my_priority);
+    orte_rmaps_commgraph_path = NULL;
+    (void) mca_base_component_var_register(c, "path",
+                                           "File giving the volume of data exchanged by the ranks "
+                                           "of the job, one \"sender receiver volume\" line per "
+                                           "pair of ranks (lines starting with # are ignored).  "
+                                           "The ranks are then placed so that the heaviest pairs "
+                                           "are the fewest hops apart",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &orte_rmaps_commgraph_path);
+    orte_rmaps_commgraph_net_hops = 4;
+    (void) mca_base_component_var_register(c, "net_hops",
+                                           "Hops charged for going from one node to another, on "
+                                           "top of the hops up and down the topology of the two "
+                                           "nodes",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &orte_rmaps_commgraph_net_hops);
+    return ORTE_SUCCESS;
+}
+
+/**
+  * component open/close/init function
+  */
+static int orte_rmaps_commgraph_open(void)
+{
+    /* a communication matrix asks for this mapper, ahead of the
+     * default ones (a rankfile still wins) */
+    if (NULL != orte_rmaps_commgraph_path && 0 == my_priority) {
+        my_priority = 9000;
+    }
+    return ORTE_SUCCESS;
+}
+
+
+static int orte_rmaps_commgraph_query(mca_base_module_t **module, int *priority)
+{
+    /* the RMAPS framework is -only- opened on HNP's,
+     * so no need to check for that here
+     */
+    
+    *priority = my_priority;
+    *module = (mca_base_module_t *)&orte_rmaps_commgraph_module;
+    return ORTE_SUCCESS;
+}
+
+/**
+ *  Close all subsystems.
+ */
+
+static int orte_rmaps_commgraph_close(void)
+{
+    return ORTE_SUCCESS;
+}
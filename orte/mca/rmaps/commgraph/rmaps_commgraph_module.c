@@ -0,0 +1,570 @@
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orte_config.h"
+#include "orte/constants.h"
+#include "orte/types.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif  /* HAVE_STRING_H */
+
+#include "opal/mca/hwloc/base/base.h"
+#include "opal/util/output.h"
+
+#include "orte/util/show_help.h"
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/util/name_fns.h"
+#include "orte/runtime/orte_globals.h"
+
+#include "orte/mca/rmaps/base/rmaps_private.h"
+#include "orte/mca/rmaps/base/base.h"
+#include "orte/mca/rmaps/commgraph/rmaps_commgraph.h"
+
+static int commgraph_map(orte_job_t *jdata);
+
+orte_rmaps_base_module_t orte_rmaps_commgraph_module = {
+    commgraph_map
+};
+
+/* room for one process: a node, and the core (or hwthread) of it */
+typedef struct {
+    orte_node_t *node;
+    hwloc_obj_t obj;        /* NULL when the node has no topology */
+} commgraph_slot_t;
+
+/* scratch space of the bisection, one entry per process */
+typedef struct {
+    double *tot;            /* volume exchanged with the part being split */
+    double *conn;           /* volume exchanged with the first half */
+    char *in_first;
+    int *order;
+} commgraph_work_t;
+
+/* hops between two slots: up and down the hwloc tree of a node, and
+ * through the network from one node to another */
+static int commgraph_hops(const commgraph_slot_t *a, const commgraph_slot_t *b)
+{
+    hwloc_obj_t x = a->obj, y = b->obj;
+    int hops = 0;
+
+    if (a->node != b->node) {
+        return (NULL == x ? 0 : (int) x->depth) + (NULL == y ? 0 : (int) y->depth) +
+            orte_rmaps_commgraph_net_hops;
+    }
+    if (NULL == x || NULL == y) {
+        return 0;
+    }
+    while (x != y) {
+        if (x->depth > y->depth) {
+            x = x->parent;
+            ++hops;
+        } else if (y->depth > x->depth) {
+            y = y->parent;
+            ++hops;
+        } else {
+            x = x->parent;
+            y = y->parent;
+            hops += 2;
+        }
+    }
+    return hops;
+}
+
+/* reads the matrix into a dense array.  The direction of the traffic
+ * does not matter to the placement, so the matrix is symmetric.  A
+ * job size of 0 is taken from the highest rank in the file */
+static int commgraph_read(const char *path, int *size, double **matrix)
+{
+    FILE *fp;
+    char line[1024];
+    int *src = NULL, *dst = NULL, n_entries = 0, max_entries = 0, line_no = 0, i, n;
+    double *volume = NULL, *w;
+
+    if (NULL == (fp = fopen(path, "r"))) {
+        orte_show_help("help-orte-rmaps-commgraph.txt", "cannot-open", true, path);
+        return ORTE_ERR_SILENT;
+    }
+
+    n = *size;
+    while (NULL != fgets(line, sizeof(line), fp)) {
+        char *p = line;
+        int s, d;
+        double v;
+
+        ++line_no;
+        while (' ' == *p || '\t' == *p) {
+            ++p;
+        }
+        if ('#' == *p || '\n' == *p || '\r' == *p || '\0' == *p) {
+            continue;
+        }
+        if (3 != sscanf(p, "%d %d %lf", &s, &d, &v) || v < 0.0) {
+            orte_show_help("help-orte-rmaps-commgraph.txt", "bad-line", true, path, line_no);
+            goto error;
+        }
+        if (s < 0 || d < 0 || (0 < *size && (s >= *size || d >= *size))) {
+            orte_show_help("help-orte-rmaps-commgraph.txt", "rank-out-of-range", true,
+                           path, line_no, (s < 0 || (0 < *size && s >= *size)) ? s : d, *size);
+            goto error;
+        }
+        if (n_entries == max_entries) {
+            max_entries = (0 == max_entries) ? 256 : 2 * max_entries;
+            src = (int *) realloc(src, max_entries * sizeof(int));
+            dst = (int *) realloc(dst, max_entries * sizeof(int));
+            volume = (double *) realloc(volume, max_entries * sizeof(double));
+            if (NULL == src || NULL == dst || NULL == volume) {
+                ORTE_ERROR_LOG(ORTE_ERR_OUT_OF_RESOURCE);
+                goto error;
+            }
+        }
+        src[n_entries] = s;
+        dst[n_entries] = d;
+        volume[n_entries++] = v;
+        if (0 == *size) {
+            n = (s >= n) ? s + 1 : n;
+            n = (d >= n) ? d + 1 : n;
+        }
+    }
+    fclose(fp);
+    fp = NULL;
+
+    if (0 == n) {
+        orte_show_help("help-orte-rmaps-commgraph.txt", "bad-line", true, path, line_no);
+        goto error;
+    }
+    if (NULL == (w = (double *) calloc((size_t) n * n, sizeof(double)))) {
+        ORTE_ERROR_LOG(ORTE_ERR_OUT_OF_RESOURCE);
+        goto error;
+    }
+    for (i = 0 ; i < n_entries ; ++i) {
+        if (src[i] != dst[i]) {
+            w[(size_t) src[i] * n + dst[i]] += volume[i];
+            w[(size_t) dst[i] * n + src[i]] += volume[i];
+        }
+    }
+
+    free(src);
+    free(dst);
+    free(volume);
+    *size = n;
+    *matrix = w;
+    return ORTE_SUCCESS;
+
+ error:
+    if (NULL != fp) {
+        fclose(fp);
+    }
+    free(src);
+    free(dst);
+    free(volume);
+    return ORTE_ERR_SILENT;
+}
+
+/* splits the n processes of verts so that the first k exchange as
+ * little as possible with the others: the first part grows greedily
+ * from the heaviest process, then Kernighan-Lin passes swap the pairs
+ * that shrink the cut */
+static void commgraph_bisect(const double *w, int size, int *verts, int n, int k,
+                             commgraph_work_t *work)
+{
+    double *tot = work->tot, *conn = work->conn;
+    char *in_first = work->in_first;
+    int i, j, step, pass, best, n_first;
+    bool improved = true;
+
+#define W(a, b) (w[(size_t) verts[a] * size + verts[b]])
+
+    for (i = 0 ; i < n ; ++i) {
+        tot[i] = 0.0;
+        for (j = 0 ; j < n ; ++j) {
+            tot[i] += W(i, j);
+        }
+        conn[i] = 0.0;
+        in_first[i] = 0;
+    }
+
+    for (step = 0 ; step < k ; ++step) {
+        double gain, best_gain = 0.0;
+
+        for (i = 0, best = -1 ; i < n ; ++i) {
+            if (in_first[i]) {
+                continue;
+            }
+            gain = (0 == step) ? tot[i] : 2.0 * conn[i] - tot[i];
+            if (-1 == best || gain > best_gain) {
+                best = i;
+                best_gain = gain;
+            }
+        }
+        in_first[best] = 1;
+        for (j = 0 ; j < n ; ++j) {
+            conn[j] += W(j, best);
+        }
+    }
+
+    for (pass = 0 ; pass < 4 && improved ; ++pass) {
+        improved = false;
+        for (i = 0 ; i < n ; ++i) {
+            double d_i, gain, best_gain = 0.0;
+
+            if (!in_first[i]) {
+                continue;
+            }
+            /* what moving each side gains: external minus internal volume */
+            d_i = tot[i] - 2.0 * conn[i];
+            for (j = 0, best = -1 ; j < n ; ++j) {
+                if (in_first[j]) {
+                    continue;
+                }
+                gain = d_i + (2.0 * conn[j] - tot[j]) - 2.0 * W(i, j);
+                if (gain > best_gain) {
+                    best = j;
+                    best_gain = gain;
+                }
+            }
+            if (-1 == best) {
+                continue;
+            }
+            in_first[i] = 0;
+            in_first[best] = 1;
+            for (j = 0 ; j < n ; ++j) {
+                conn[j] += W(j, best) - W(j, i);
+            }
+            improved = true;
+        }
+    }
+
+#undef W
+
+    /* the first part goes first, both in their original order */
+    for (i = 0, n_first = 0 ; i < n ; ++i) {
+        if (in_first[i]) {
+            work->order[n_first++] = verts[i];
+        }
+    }
+    for (i = 0 ; i < n ; ++i) {
+        if (!in_first[i]) {
+            work->order[n_first++] = verts[i];
+        }
+    }
+    memcpy(verts, work->order, n * sizeof(int));
+}
+
+/* places the processes of verts on the slots [lo, hi), cutting the
+ * slots where they are the most hops apart, as close to the middle as
+ * possible: the nodes first, then the levels of their topology */
+static void commgraph_place(const double *w, int size, const commgraph_slot_t *slots,
+                            int lo, int hi, int *verts, int *placement,
+                            commgraph_work_t *work)
+{
+    int i, mid = lo + (hi - lo) / 2, split = -1, split_hops = -1;
+
+    if (1 == hi - lo) {
+        placement[verts[0]] = lo;
+        return;
+    }
+
+    for (i = lo + 1 ; i < hi ; ++i) {
+        int hops = commgraph_hops(&slots[i - 1], &slots[i]);
+
+        if (hops > split_hops ||
+            (hops == split_hops && abs(i - mid) < abs(split - mid))) {
+            split = i;
+            split_hops = hops;
+        }
+    }
+
+    commgraph_bisect(w, size, verts, hi - lo, split - lo, work);
+    commgraph_place(w, size, slots, lo, split, verts, placement, work);
+    commgraph_place(w, size, slots, split, hi, verts + (split - lo), placement, work);
+}
+
+/* volume-weighted hops of a placement */
+static double commgraph_cost(const double *w, int size, const commgraph_slot_t *slots,
+                             const int *placement)
+{
+    double cost = 0.0;
+    int i, j;
+
+    for (i = 0 ; i < size ; ++i) {
+        for (j = i + 1 ; j < size ; ++j) {
+            if (0.0 < w[(size_t) i * size + j]) {
+                cost += w[(size_t) i * size + j] *
+                    commgraph_hops(&slots[placement[i]], &slots[placement[j]]);
+            }
+        }
+    }
+    return cost;
+}
+
+/* the slots of the nodes, node after node and in the order of the
+ * topology within a node.  The nodes are filled in turn; when
+ * oversubscribing, the extra processes go round robin over the nodes */
+static int commgraph_slots(orte_job_t *jdata, orte_app_context_t *app, opal_list_t *node_list,
+                           int size, commgraph_slot_t **slots_out)
+{
+    commgraph_slot_t *slots;
+    orte_node_t *node;
+    int *counts, n_nodes = (int) opal_list_get_size(node_list), total = 0, n, k, s;
+    hwloc_obj_type_t type = opal_hwloc_use_hwthreads_as_cpus ? HWLOC_OBJ_PU : HWLOC_OBJ_CORE;
+
+    counts = (int *) calloc(n_nodes, sizeof(int));
+    slots = (commgraph_slot_t *) malloc(size * sizeof(commgraph_slot_t));
+    if (NULL == counts || NULL == slots) {
+        free(counts);
+        free(slots);
+        return ORTE_ERR_OUT_OF_RESOURCE;
+    }
+
+    n = 0;
+    OPAL_LIST_FOREACH(node, node_list, orte_node_t) {
+        int avail = (node->slots > (int) node->slots_inuse) ?
+            node->slots - (int) node->slots_inuse : 0;
+
+        counts[n] = (avail < size - total) ? avail : size - total;
+        total += counts[n++];
+    }
+    if (total < size) {
+        if (ORTE_MAPPING_NO_OVERSUBSCRIBE & ORTE_GET_MAPPING_DIRECTIVE(jdata->map->mapping)) {
+            orte_show_help("help-orte-rmaps-base.txt", "orte-rmaps-base:alloc-error",
+                           true, size, app->app);
+            free(counts);
+            free(slots);
+            return ORTE_ERR_SILENT;
+        }
+        for (n = 0 ; total < size ; n = (n + 1) % n_nodes, ++total) {
+            counts[n]++;
+        }
+    }
+
+    n = 0;
+    s = 0;
+    OPAL_LIST_FOREACH(node, node_list, orte_node_t) {
+        int n_objs = 0;
+
+        if (NULL != node->topology) {
+            n_objs = (int) opal_hwloc_base_get_nbobjs_by_type(node->topology, type, 0,
+                                                              OPAL_HWLOC_AVAILABLE);
+        }
+        /* spread the processes of the node over its cores */
+        for (k = 0 ; k < counts[n] ; ++k, ++s) {
+            slots[s].node = node;
+            slots[s].obj = NULL;
+            if (0 < n_objs) {
+                slots[s].obj = opal_hwloc_base_get_obj_by_type(node->topology, type, 0,
+                                                               (unsigned int) ((long) k * n_objs / counts[n]),
+                                                               OPAL_HWLOC_AVAILABLE);
+            }
+        }
+        ++n;
+    }
+
+    free(counts);
+    *slots_out = slots;
+    return ORTE_SUCCESS;
+}
+
+/*
+ * Map the job so that the ranks exchanging the most are the closest
+ */
+static int commgraph_map(orte_job_t *jdata)
+{
+    orte_app_context_t *app, *first_app = NULL;
+    opal_list_t node_list;
+    opal_list_item_t *item;
+    orte_node_t *node;
+    orte_proc_t *proc;
+    orte_std_cntr_t num_slots;
+    commgraph_slot_t *slots = NULL;
+    commgraph_work_t work = {NULL, NULL, NULL, NULL};
+    double *matrix = NULL;
+    int *verts = NULL, *placement = NULL;
+    int i, size = 0, vpid, rc;
+    mca_base_component_t *c = &mca_rmaps_commgraph_component.base_version;
+
+    /* this mapper can only handle initial launch
+     * when a communication matrix was given
+     */
+    if (ORTE_JOB_CONTROL_RESTART & jdata->controls) {
+        opal_output_verbose(5, orte_rmaps_base_framework.framework_output,
+                            "mca:rmaps:commgraph: job %s is being restarted - commgraph cannot map",
+                            ORTE_JOBID_PRINT(jdata->jobid));
+        return ORTE_ERR_TAKE_NEXT_OPTION;
+    }
+    if (NULL != jdata->map->req_mapper &&
+        0 != strcasecmp(jdata->map->req_mapper, c->mca_component_name)) {
+        /* a mapper has been specified, and it isn't me */
+        opal_output_verbose(5, orte_rmaps_base_framework.framework_output,
+                            "mca:rmaps:commgraph: job %s not using commgraph mapper",
+                            ORTE_JOBID_PRINT(jdata->jobid));
+        return ORTE_ERR_TAKE_NEXT_OPTION;
+    }
+    if (NULL == orte_rmaps_commgraph_path ||
+        (ORTE_MAPPING_GIVEN & ORTE_GET_MAPPING_DIRECTIVE(jdata->map->mapping))) {
+        /* no matrix, or the user asked for a mapping policy */
+        opal_output_verbose(5, orte_rmaps_base_framework.framework_output,
+                            "mca:rmaps:commgraph: job %s not using commgraph mapper",
+                            ORTE_JOBID_PRINT(jdata->jobid));
+        return ORTE_ERR_TAKE_NEXT_OPTION;
+    }
+
+    opal_output_verbose(5, orte_rmaps_base_framework.framework_output,
+                        "mca:rmaps:commgraph: mapping job %s",
+                        ORTE_JOBID_PRINT(jdata->jobid));
+
+    /* flag that I did the mapping */
+    if (NULL != jdata->map->last_mapper) {
+        free(jdata->map->last_mapper);
+    }
+    jdata->map->last_mapper = strdup(c->mca_component_name);
+
+    /* the ranks of all the app_contexts are placed together, on the
+     * nodes of the first one */
+    for (i = 0 ; i < jdata->apps->size ; i++) {
+        if (NULL == (app = (orte_app_context_t*)opal_pointer_array_get_item(jdata->apps, i))) {
+            continue;
+        }
+        if (0 == app->num_procs && 1 < jdata->num_apps) {
+            orte_show_help("help-orte-rmaps-commgraph.txt", "multi-apps-and-zero-np",
+                           true, jdata->num_apps, NULL);
+            return ORTE_ERR_SILENT;
+        }
+        if (NULL == first_app) {
+            first_app = app;
+        }
+        size += app->num_procs;
+    }
+    if (NULL == first_app) {
+        return ORTE_ERR_SILENT;
+    }
+
+    OBJ_CONSTRUCT(&node_list, opal_list_t);
+    if (ORTE_SUCCESS != (rc = orte_rmaps_base_get_target_nodes(&node_list, &num_slots, first_app,
+                                                              jdata->map->mapping, true, false))) {
+        ORTE_ERROR_LOG(rc);
+        goto error;
+    }
+    if (0 == opal_list_get_size(&node_list)) {
+        orte_show_help("help-orte-rmaps-base.txt",
+                       "orte-rmaps-base:no-available-resources",
+                       true);
+        rc = ORTE_ERR_SILENT;
+        goto error;
+    }
+
+    /* a single app_context without -np is sized by the matrix */
+    if (ORTE_SUCCESS != (rc = commgraph_read(orte_rmaps_commgraph_path, &size, &matrix))) {
+        goto error;
+    }
+    if (0 == first_app->num_procs) {
+        first_app->num_procs = size;
+    }
+
+    if (ORTE_SUCCESS != (rc = commgraph_slots(jdata, first_app, &node_list, size, &slots))) {
+        if (ORTE_ERR_SILENT != rc) {
+            ORTE_ERROR_LOG(rc);
+        }
+        goto error;
+    }
+
+    verts = (int *) malloc(size * sizeof(int));
+    placement = (int *) malloc(size * sizeof(int));
+    work.tot = (double *) malloc(size * sizeof(double));
+    work.conn = (double *) malloc(size * sizeof(double));
+    work.in_first = (char *) malloc(size);
+    work.order = (int *) malloc(size * sizeof(int));
+    if (NULL == verts || NULL == placement || NULL == work.tot || NULL == work.conn ||
+        NULL == work.in_first || NULL == work.order) {
+        rc = ORTE_ERR_OUT_OF_RESOURCE;
+        ORTE_ERROR_LOG(rc);
+        goto error;
+    }
+    for (i = 0 ; i < size ; ++i) {
+        verts[i] = i;
+    }
+    commgraph_place(matrix, size, slots, 0, size, verts, placement, &work);
+
+    if (5 <= opal_output_get_verbosity(orte_rmaps_base_framework.framework_output)) {
+        /* placing rank i on slot i is what mapping by slot does */
+        for (i = 0 ; i < size ; ++i) {
+            verts[i] = i;
+        }
+        opal_output(orte_rmaps_base_framework.framework_output,
+                    "mca:rmaps:commgraph: job %s weighted hops %g (%g by slot)",
+                    ORTE_JOBID_PRINT(jdata->jobid),
+                    commgraph_cost(matrix, size, slots, placement),
+                    commgraph_cost(matrix, size, slots, verts));
+    }
+
+    /* the ranks of each app_context stay contiguous */
+    jdata->num_procs = 0;
+    for (i = 0, vpid = 0 ; i < jdata->apps->size ; i++) {
+        int n;
+
+        if (NULL == (app = (orte_app_context_t*)opal_pointer_array_get_item(jdata->apps, i))) {
+            continue;
+        }
+        for (n = 0 ; n < (int) app->num_procs ; ++n, ++vpid) {
+            commgraph_slot_t *slot = &slots[placement[vpid]];
+
+            node = slot->node;
+            if (!node->mapped) {
+                if (ORTE_SUCCESS > (rc = opal_pointer_array_add(jdata->map->nodes, (void*)node))) {
+                    ORTE_ERROR_LOG(rc);
+                    goto error;
+                }
+                node->mapped = true;
+                OBJ_RETAIN(node);  /* maintain accounting on object */
+                jdata->map->num_nodes++;
+            }
+            if (NULL == (proc = orte_rmaps_base_setup_proc(jdata, node, i))) {
+                rc = ORTE_ERR_OUT_OF_RESOURCE;
+                goto error;
+            }
+            if ((node->slots < (int)node->num_procs) ||
+                (0 < node->slots_max && node->slots_max < (int)node->num_procs)) {
+                /* flag the node as oversubscribed so that sched-yield gets
+                 * properly set
+                 */
+                node->oversubscribed = true;
+            }
+            proc->locale = (NULL != slot->obj) ? slot->obj :
+                (NULL != node->topology) ? hwloc_get_root_obj(node->topology) : NULL;
+            proc->name.vpid = vpid;
+            if (ORTE_SUCCESS != (rc = opal_pointer_array_set_item(jdata->procs, proc->name.vpid, proc))) {
+                ORTE_ERROR_LOG(rc);
+                goto error;
+            }
+        }
+        jdata->num_procs += app->num_procs;
+    }
+    rc = ORTE_SUCCESS;
+
+ error:
+    free(work.tot);
+    free(work.conn);
+    free(work.in_first);
+    free(work.order);
+    free(verts);
+    free(placement);
+    free(slots);
+    free(matrix);
+    while (NULL != (item = opal_list_remove_first(&node_list))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&node_list);
+
+    return rc;
+}
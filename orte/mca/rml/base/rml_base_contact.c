@@ -27,6 +27,7 @@
 #include "opal/dss/dss.h"
 #include "orte/mca/errmgr/errmgr.h"
 #include "orte/mca/routed/routed.h"
+#include "orte/mca/routed/base/base.h"
 #include "orte/util/name_fns.h"
 #include "orte/util/proc_info.h"
 #include "orte/runtime/orte_globals.h"
@@ -147,6 +148,13 @@ int orte_rml_base_update_contact_info(opal_buffer_t* data)
          */
         orte_routed.update_routing_plan();
     }
+
+    /* now that we can reach the other daemons, connect to our
+     * neighbours in the tree before the first collective needs them
+     */
+    if (ORTE_PROC_MY_NAME->jobid == name.jobid && ORTE_PROC_IS_DAEMON) {
+        orte_routed_base_prewire();
+    }
     
     return ORTE_SUCCESS;
 }
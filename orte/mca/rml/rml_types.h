@@ -137,6 +137,16 @@ BEGIN_C_DECLS
 /* sensor data */
 #define ORTE_RML_TAG_SENSOR_DATA            47
 
+/* direct modex: publish/request, and the replies */
+#define ORTE_RML_TAG_DIRECT_MODEX           48
+#define ORTE_RML_TAG_DIRECT_MODEX_RESP      49
+
+/* pieces of a large xcast */
+#define ORTE_RML_TAG_XCAST_CHUNK            50
+
+/* heartbeats between routing tree neighbors, and their failure reports */
+#define ORTE_RML_TAG_HEARTBEAT_PEER         51
+
 #define ORTE_RML_TAG_MAX                   100
 
 
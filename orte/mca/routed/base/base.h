@@ -32,6 +32,7 @@ ORTE_DECLSPEC    int orte_routed_base_select(void);
 
 
 ORTE_DECLSPEC extern bool orte_routed_base_wait_sync;
+ORTE_DECLSPEC extern bool orte_routed_base_prewire_tree;
 ORTE_DECLSPEC extern opal_pointer_array_t orte_routed_jobfams;
 
 ORTE_DECLSPEC void orte_routed_base_xcast_routing(orte_grpcomm_collective_t *coll,
@@ -45,6 +46,8 @@ ORTE_DECLSPEC int orte_routed_base_register_sync(bool setup);
 ORTE_DECLSPEC int orte_routed_base_process_callback(orte_jobid_t job,
                                                     opal_buffer_t *buffer);
 ORTE_DECLSPEC void orte_routed_base_update_hnps(opal_buffer_t *buf);
+/* wire-up hint: open the connections to our tree neighbours now */
+ORTE_DECLSPEC void orte_routed_base_prewire(void);
 
 END_C_DECLS
 
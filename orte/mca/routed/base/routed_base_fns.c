@@ -233,6 +233,72 @@ void orte_routed_base_coll_peers(orte_grpcomm_collective_t *coll,
     }
  }
 
+static void prewire_peer(orte_process_name_t *peer)
+{
+    opal_buffer_t *buffer;
+    orte_daemon_cmd_flag_t command = ORTE_DAEMON_NULL_CMD;
+    int rc;
+
+    OPAL_OUTPUT_VERBOSE((5, orte_routed_base_framework.framework_output,
+                         "%s routed:base: prewiring %s",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         ORTE_NAME_PRINT(peer)));
+
+    /* the oob opens the connection on the first message and keeps it */
+    buffer = OBJ_NEW(opal_buffer_t);
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(buffer, &command, 1, ORTE_DAEMON_CMD))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buffer);
+        return;
+    }
+    if (0 > (rc = orte_rml.send_buffer_nb(peer, buffer, ORTE_RML_TAG_DAEMON, 0,
+                                          orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buffer);
+    }
+}
+
+/* Once a daemon knows the contact info of the others, connect to its
+ * children and to its parent in the routing tree at once, in parallel,
+ * so that the first xcast or relayed collective does not wait for the
+ * connection setup at each level of the tree. Each connection is opened
+ * by sending a NULL command. Called again after the daemon job grows,
+ * which reshapes the tree.
+ */
+void orte_routed_base_prewire(void)
+{
+    static orte_vpid_t wired_procs = 0;
+    orte_grpcomm_collective_t coll;
+    opal_list_item_t *item;
+    orte_namelist_t *nm;
+    orte_process_name_t parent;
+
+    if (!orte_routed_base_prewire_tree || !ORTE_PROC_IS_DAEMON ||
+        orte_process_info.num_procs == wired_procs) {
+        return;
+    }
+    wired_procs = orte_process_info.num_procs;
+
+    OBJ_CONSTRUCT(&coll, orte_grpcomm_collective_t);
+    orte_routed.get_routing_list(ORTE_GRPCOMM_XCAST, &coll);
+    for (item = opal_list_get_first(&coll.targets);
+         item != opal_list_get_end(&coll.targets);
+         item = opal_list_get_next(item)) {
+        nm = (orte_namelist_t*)item;
+        prewire_peer(&nm->name);
+    }
+    OBJ_DESTRUCT(&coll);
+
+    /* the collectives go up the tree, via whoever routes to the HNP -
+     * which we already talk to if it is the HNP itself
+     */
+    parent = orte_routed.get_route(ORTE_PROC_MY_HNP);
+    if (ORTE_VPID_INVALID != parent.vpid &&
+        OPAL_EQUAL != orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &parent, ORTE_PROC_MY_HNP)) {
+        prewire_peer(&parent);
+    }
+}
+
 
 static bool sync_waiting = false;
 
@@ -66,8 +66,22 @@ OBJ_CLASS_INSTANCE(orte_routed_jobfam_t, opal_object_t,
 
 orte_routed_module_t orte_routed = {0};
 bool orte_routed_base_wait_sync;
+bool orte_routed_base_prewire_tree;
 opal_pointer_array_t orte_routed_jobfams;
 
+static int orte_routed_base_register(mca_base_register_flag_t flags)
+{
+    orte_routed_base_prewire_tree = true;
+    (void) mca_base_var_register("orte", "routed", "base", "prewire",
+                                 "Have each daemon open its connections to its parent and children "
+                                 "in the routing tree as soon as it learns their contact info, "
+                                 "instead of on the first message sent down the tree",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
+                                 &orte_routed_base_prewire_tree);
+    return ORTE_SUCCESS;
+}
+
 static int orte_routed_base_open(mca_base_open_flag_t flags)
 {
     orte_routed_jobfam_t *jfam;
@@ -111,7 +125,7 @@ static int orte_routed_base_close(void)
     return mca_base_framework_components_close(&orte_routed_base_framework, NULL);
 }
 
-MCA_BASE_FRAMEWORK_DECLARE(orte, routed, "ORTE Message Routing Subsystem", NULL,
+MCA_BASE_FRAMEWORK_DECLARE(orte, routed, "ORTE Message Routing Subsystem", orte_routed_base_register,
                            orte_routed_base_open, orte_routed_base_close,
                            mca_routed_base_static_components, 0);
 
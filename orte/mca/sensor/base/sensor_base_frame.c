@@ -48,6 +48,7 @@ orte_sensor_base_t orte_sensor_base;
  * Local variables
  */
 static int orte_sensor_base_sample_rate = 0;
+static int orte_sensor_base_sample_rate_msec = 0;
 
 static int orte_sensor_base_register(mca_base_register_flag_t flags)
 {
@@ -62,6 +63,14 @@ static int orte_sensor_base_register(mca_base_register_flag_t flags)
                                    &orte_sensor_base_sample_rate);
     mca_base_var_register_synonym(var_id, "orte", "sensor", NULL, "sample_rate",
                                   MCA_BASE_VAR_SYN_FLAG_DEPRECATED);
+
+    orte_sensor_base_sample_rate_msec = 0;
+    (void) mca_base_var_register("orte", "sensor", "base", "sample_rate_msec",
+                                 "Sample rate in milliseconds - overrides sample_rate when > 0",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &orte_sensor_base_sample_rate_msec);
   
     /* see if we want samples logged */
     orte_sensor_base.log_samples = false;
@@ -112,8 +121,13 @@ static int orte_sensor_base_open(mca_base_open_flag_t flags)
     opal_pointer_array_init(&orte_sensor_base.modules, 3, INT_MAX, 1);
     
     /* get the sample rate */
-    orte_sensor_base.rate.tv_sec = orte_sensor_base_sample_rate;
-    orte_sensor_base.rate.tv_usec = 0;
+    if (0 < orte_sensor_base_sample_rate_msec) {
+        orte_sensor_base.rate.tv_sec = orte_sensor_base_sample_rate_msec / 1000;
+        orte_sensor_base.rate.tv_usec = (orte_sensor_base_sample_rate_msec % 1000) * 1000;
+    } else {
+        orte_sensor_base.rate.tv_sec = orte_sensor_base_sample_rate;
+        orte_sensor_base.rate.tv_usec = 0;
+    }
 
     /* Open up all available components */
     return mca_base_framework_components_open(&orte_sensor_base_framework, flags);
@@ -24,6 +24,7 @@
 #include <stdio.h>
 
 #include "opal_stdint.h"
+#include "opal/class/opal_hash_table.h"
 #include "opal/util/argv.h"
 #include "opal/util/output.h"
 #include "opal/mca/event/event.h"
@@ -32,7 +33,9 @@
 #include "orte/util/proc_info.h"
 #include "orte/util/name_fns.h"
 #include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/grpcomm/grpcomm.h"
 #include "orte/mca/rml/rml.h"
+#include "orte/mca/routed/routed.h"
 #include "orte/mca/state/state.h"
 #include "orte/runtime/orte_wait.h"
 #include "orte/runtime/orte_globals.h"
@@ -62,12 +65,68 @@ static void check_heartbeat(int fd, short event, void *arg);
 static void recv_beats(int status, orte_process_name_t* sender,
                        opal_buffer_t *buffer,
                        orte_rml_tag_t tag, void *cbdata);
+static void send_peer_beat(int fd, short event, void *arg);
+static void check_children(int fd, short event, void *arg);
+static void recv_peer(int status, orte_process_name_t* sender,
+                      opal_buffer_t *buffer,
+                      orte_rml_tag_t tag, void *cbdata);
+
+/* tree mode message types */
+#define ORTE_SENSOR_HEARTBEAT_BEAT    1
+#define ORTE_SENSOR_HEARTBEAT_FAILED  2
 
 /* local globals */
 static orte_job_t *daemons=NULL;
 static opal_event_t check_ev;
 static bool check_active = false;
 static struct timeval check_time;
+/* tree mode: beats received from each child daemon in the current
+ * window, keyed by vpid. Children only get an entry once they have
+ * beaten, so daemons not yet launched are never declared failed
+ */
+static opal_hash_table_t child_beats;
+static opal_event_t beat_ev;
+static bool tree_active = false;
+
+static void set_check_time(void)
+{
+    long usec;
+
+    /* allow three sample periods without a beat */
+    usec = 3 * (orte_sensor_base.rate.tv_sec * 1000000L + orte_sensor_base.rate.tv_usec);
+    check_time.tv_sec = usec / 1000000L;
+    check_time.tv_usec = usec % 1000000L;
+}
+
+static int tree_init(void)
+{
+    int rc;
+
+    OBJ_CONSTRUCT(&child_beats, opal_hash_table_t);
+    opal_hash_table_init(&child_beats, 32);
+
+    if (ORTE_SUCCESS != (rc = orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
+                                                      ORTE_RML_TAG_HEARTBEAT_PEER,
+                                                      ORTE_RML_PERSISTENT,
+                                                      recv_peer, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_DESTRUCT(&child_beats);
+        return rc;
+    }
+
+    /* every daemon beats to its parent, whether or not it hosts
+     * procs, so this does not wait for the sensors to be started
+     */
+    set_check_time();
+    if (!ORTE_PROC_IS_HNP) {
+        opal_event_evtimer_set(orte_event_base, &beat_ev, send_peer_beat, &beat_ev);
+        opal_event_evtimer_add(&beat_ev, &orte_sensor_base.rate);
+    }
+    opal_event_evtimer_set(orte_event_base, &check_ev, check_children, &check_ev);
+    opal_event_evtimer_add(&check_ev, &check_time);
+    tree_active = true;
+    return ORTE_SUCCESS;
+}
 
 static int init(void)
 {
@@ -92,6 +151,12 @@ static int init(void)
         daemons = orte_get_job_data_object(ORTE_PROC_MY_NAME->jobid);
     }
 
+    if (mca_sensor_heartbeat_component.tree &&
+        (ORTE_PROC_IS_HNP || ORTE_PROC_IS_DAEMON) &&
+        (0 < orte_sensor_base.rate.tv_sec || 0 < orte_sensor_base.rate.tv_usec)) {
+        rc = tree_init();
+    }
+
     return rc;
 }
 
@@ -102,15 +167,24 @@ static void finalize(void)
         opal_event_del(&check_ev);
         check_active = false;
     }
+    if (tree_active) {
+        orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORTE_RML_TAG_HEARTBEAT_PEER);
+        if (!ORTE_PROC_IS_HNP) {
+            opal_event_del(&beat_ev);
+        }
+        opal_event_del(&check_ev);
+        OBJ_DESTRUCT(&child_beats);
+        tree_active = false;
+    }
     return;
 }
 
 static void start(orte_jobid_t job)
 {
-    if (!check_active && NULL != daemons) {
+    /* in tree mode the HNP only hears about failures */
+    if (!check_active && !tree_active && NULL != daemons) {
         /* setup the check event */
-        check_time.tv_sec = 3 * orte_sensor_base.rate.tv_sec;
-        check_time.tv_usec = 0;
+        set_check_time();
         opal_event_evtimer_set(orte_event_base, &check_ev, check_heartbeat, &check_ev);
         opal_event_evtimer_add(&check_ev, &check_time);
         check_active = true;
@@ -140,6 +214,13 @@ static void sample(void)
                          "%s sending heartbeat",
                          ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
 
+    /* in tree mode, liveness is tracked by the neighbors - only
+     * contact the HNP when there is sampled data to deliver
+     */
+    if (tree_active && !orte_sensor_base.log_samples) {
+        return;
+    }
+
     /* if we want sampled data included, point to the bucket */
     buf = OBJ_NEW(opal_buffer_t);
     if (orte_sensor_base.log_samples) {
@@ -274,3 +355,143 @@ static void recv_beats(int status, orte_process_name_t* sender,
         ORTE_ERROR_LOG(rc);
     }
 }
+
+static void send_peer_beat(int fd, short event, void *arg)
+{
+    opal_event_t *tmp = (opal_event_t*)arg;
+    opal_buffer_t *buf;
+    uint8_t flag = ORTE_SENSOR_HEARTBEAT_BEAT;
+    int rc;
+
+    /* if we are aborting or shutting down, stop beating */
+    if (orte_abnormal_term_ordered || orte_finalizing || !orte_initialized) {
+        return;
+    }
+
+    /* our parent is only known once the routing plan is in place */
+    if (ORTE_VPID_INVALID != ORTE_PROC_MY_PARENT->vpid &&
+        ORTE_JOBID_INVALID != ORTE_PROC_MY_PARENT->jobid) {
+        buf = OBJ_NEW(opal_buffer_t);
+        opal_dss.pack(buf, &flag, 1, OPAL_UINT8);
+        if (0 > (rc = orte_rml.send_buffer_nb(ORTE_PROC_MY_PARENT, buf,
+                                              ORTE_RML_TAG_HEARTBEAT_PEER, 0,
+                                              orte_rml_send_callback, NULL))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(buf);
+        }
+    }
+
+    opal_event_evtimer_add(tmp, &orte_sensor_base.rate);
+}
+
+static void report_failure(orte_process_name_t *child)
+{
+    opal_buffer_t *buf;
+    uint8_t flag = ORTE_SENSOR_HEARTBEAT_FAILED;
+    int rc;
+
+    OPAL_OUTPUT_VERBOSE((1, orte_sensor_base_framework.framework_output,
+                         "%s sensor:heartbeat:tree FAILED for child daemon %s",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         ORTE_NAME_PRINT(child)));
+
+    if (ORTE_PROC_IS_HNP) {
+        ORTE_ACTIVATE_PROC_STATE(child, ORTE_PROC_STATE_HEARTBEAT_FAILED);
+        return;
+    }
+
+    /* only the failure travels up to the HNP */
+    buf = OBJ_NEW(opal_buffer_t);
+    opal_dss.pack(buf, &flag, 1, OPAL_UINT8);
+    opal_dss.pack(buf, child, 1, ORTE_NAME);
+    if (0 > (rc = orte_rml.send_buffer_nb(ORTE_PROC_MY_HNP, buf,
+                                          ORTE_RML_TAG_HEARTBEAT_PEER, 0,
+                                          orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buf);
+    }
+}
+
+/* at the end of each window, any child that has beaten before but
+ * not during this window is reported as failed
+ */
+static void check_children(int fd, short event, void *arg)
+{
+    opal_event_t *tmp = (opal_event_t*)arg;
+    orte_grpcomm_collective_t coll;
+    opal_list_item_t *item;
+    orte_namelist_t *child;
+    void *beats;
+
+    /* if we are aborting or shutting down, ignore this */
+    if (orte_abnormal_term_ordered || orte_finalizing || !orte_initialized) {
+        return;
+    }
+
+    /* the children can change as the VM grows, so ask each time */
+    OBJ_CONSTRUCT(&coll, orte_grpcomm_collective_t);
+    orte_routed.get_routing_list(ORTE_GRPCOMM_XCAST, &coll);
+    for (item = opal_list_get_first(&coll.targets);
+         item != opal_list_get_end(&coll.targets);
+         item = opal_list_get_next(item)) {
+        child = (orte_namelist_t*)item;
+        if (OPAL_SUCCESS != opal_hash_table_get_value_uint32(&child_beats, child->name.vpid, &beats)) {
+            /* never heard from it - not up yet */
+            continue;
+        }
+        if (NULL == beats) {
+            report_failure(&child->name);
+            /* don't report it again unless it comes back */
+            opal_hash_table_remove_value_uint32(&child_beats, child->name.vpid);
+            continue;
+        }
+        /* reset for next window */
+        opal_hash_table_set_value_uint32(&child_beats, child->name.vpid, NULL);
+    }
+    OBJ_DESTRUCT(&coll);
+
+    opal_event_evtimer_add(tmp, &check_time);
+}
+
+static void recv_peer(int status, orte_process_name_t* sender,
+                      opal_buffer_t *buffer,
+                      orte_rml_tag_t tag, void *cbdata)
+{
+    uint8_t flag;
+    orte_process_name_t failed;
+    void *beats;
+    int rc, n;
+
+    /* if we are aborting or shutting down, ignore this */
+    if (orte_abnormal_term_ordered || orte_finalizing || !orte_initialized) {
+        return;
+    }
+
+    n=1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &flag, &n, OPAL_UINT8))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+
+    if (ORTE_SENSOR_HEARTBEAT_FAILED == flag) {
+        /* only the HNP receives these */
+        n=1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &failed, &n, ORTE_NAME))) {
+            ORTE_ERROR_LOG(rc);
+            return;
+        }
+        OPAL_OUTPUT_VERBOSE((1, orte_sensor_base_framework.framework_output,
+                             "%s sensor:heartbeat:tree %s reports daemon %s FAILED",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                             ORTE_NAME_PRINT(sender), ORTE_NAME_PRINT(&failed)));
+        ORTE_ACTIVATE_PROC_STATE(&failed, ORTE_PROC_STATE_HEARTBEAT_FAILED);
+        return;
+    }
+
+    /* count the beat - the count itself is carried in the pointer */
+    if (OPAL_SUCCESS != opal_hash_table_get_value_uint32(&child_beats, sender->vpid, &beats)) {
+        beats = NULL;
+    }
+    beats = (void*)((uintptr_t)beats + 1);
+    opal_hash_table_set_value_uint32(&child_beats, sender->vpid, beats);
+}
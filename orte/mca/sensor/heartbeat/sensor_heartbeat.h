@@ -22,7 +22,16 @@
 
 BEGIN_C_DECLS
 
-ORTE_MODULE_DECLSPEC extern orte_sensor_base_component_t mca_sensor_heartbeat_component;
+struct orte_sensor_heartbeat_component_t {
+    orte_sensor_base_component_t super;
+    /* each daemon watches its routing tree children instead of
+     * every daemon beating directly to the HNP
+     */
+    bool tree;
+};
+typedef struct orte_sensor_heartbeat_component_t orte_sensor_heartbeat_component_t;
+
+ORTE_MODULE_DECLSPEC extern orte_sensor_heartbeat_component_t mca_sensor_heartbeat_component;
 extern orte_sensor_base_module_t orte_sensor_heartbeat_module;
 
 
@@ -24,25 +24,29 @@
  * Local functions
  */
 
+static int orte_sensor_heartbeat_register(void);
 static int orte_sensor_heartbeat_open(void);
 static int orte_sensor_heartbeat_close(void);
 static int orte_sensor_heartbeat_query(mca_base_module_t **module, int *priority);
 
-orte_sensor_base_component_t mca_sensor_heartbeat_component = {
+orte_sensor_heartbeat_component_t mca_sensor_heartbeat_component = {
     {
-        ORTE_SENSOR_BASE_VERSION_1_0_0,
-            
-        "heartbeat", /* MCA component name */
-        ORTE_MAJOR_VERSION,  /* MCA component major version */
-        ORTE_MINOR_VERSION,  /* MCA component minor version */
-        ORTE_RELEASE_VERSION,  /* MCA component release version */
-        orte_sensor_heartbeat_open,  /* component open  */
-        orte_sensor_heartbeat_close, /* component close */
-        orte_sensor_heartbeat_query  /* component query */
-    },
-    {
-        /* The component is checkpoint ready */
-        MCA_BASE_METADATA_PARAM_CHECKPOINT
+        {
+            ORTE_SENSOR_BASE_VERSION_1_0_0,
+
+            "heartbeat", /* MCA component name */
+            ORTE_MAJOR_VERSION,  /* MCA component major version */
+            ORTE_MINOR_VERSION,  /* MCA component minor version */
+            ORTE_RELEASE_VERSION,  /* MCA component release version */
+            orte_sensor_heartbeat_open,  /* component open  */
+            orte_sensor_heartbeat_close, /* component close */
+            orte_sensor_heartbeat_query, /* component query */
+            orte_sensor_heartbeat_register
+        },
+        {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        }
     }
 };
 
@@ -50,6 +54,20 @@ orte_sensor_base_component_t mca_sensor_heartbeat_component = {
 /**
   * component open/close/init function
   */
+static int orte_sensor_heartbeat_register(void)
+{
+    mca_base_component_t *c = &mca_sensor_heartbeat_component.super.base_version;
+
+    mca_sensor_heartbeat_component.tree = false;
+    (void) mca_base_component_var_register (c, "tree",
+                                            "Have each daemon monitor its routing tree children and report only failures to the HNP, instead of every daemon beating to the HNP",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_sensor_heartbeat_component.tree);
+    return ORTE_SUCCESS;
+}
+
 static int orte_sensor_heartbeat_open(void)
 {
     return ORTE_SUCCESS;
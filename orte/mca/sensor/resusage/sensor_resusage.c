@@ -62,6 +62,7 @@ orte_sensor_base_module_t orte_sensor_resusage_module = {
 };
 
 static bool log_enabled = true;
+static FILE *telemetry_fp = NULL;
 
 static int init(void)
 {
@@ -70,6 +71,32 @@ static int init(void)
 
 static void finalize(void)
 {
+    if (NULL != telemetry_fp) {
+        fclose(telemetry_fp);
+        telemetry_fp = NULL;
+    }
+}
+
+/* append one line for this process sample to the telemetry file */
+static void telemetry_write(opal_pstats_t *st)
+{
+    if (NULL == telemetry_fp) {
+        if (NULL == (telemetry_fp = fopen(mca_sensor_resusage_component.telemetry_file, "a"))) {
+            opal_output(0, "%s sensor:resusage: cannot open telemetry file %s - disabling telemetry",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                        mca_sensor_resusage_component.telemetry_file);
+            free(mca_sensor_resusage_component.telemetry_file);
+            mca_sensor_resusage_component.telemetry_file = NULL;
+            return;
+        }
+    }
+    fprintf(telemetry_fp, "%ld.%06ld %s %s %d %d %ld.%06ld %.2f %.2f %" PRIu64 " %" PRIu64
+            " %" PRIu64 " %" PRIu64 "\n",
+            (long)st->sample_time.tv_sec, (long)st->sample_time.tv_usec,
+            st->node, st->cmd, st->rank, (int)st->pid,
+            (long)st->time.tv_sec, (long)st->time.tv_usec,
+            st->rss, st->vsize, st->minor_faults, st->major_faults,
+            st->voluntary_ctxsw, st->involuntary_ctxsw);
 }
 
 static void sample(void)
@@ -84,6 +111,13 @@ static void sample(void)
 
     OPAL_OUTPUT_VERBOSE((1, orte_sensor_base_framework.framework_output,
                          "sample:resusage sampling resource usage"));
+
+    /* push out what the last period's reports added to the telemetry
+     * file - once per period rather than once per reporting daemon
+     */
+    if (NULL != telemetry_fp) {
+        fflush(telemetry_fp);
+    }
     
     /* setup a buffer for our stats */
     OBJ_CONSTRUCT(&buf, opal_buffer_t);
@@ -282,7 +316,7 @@ static void res_log(opal_buffer_t *sample)
     opal_value_t kv[14];
     char *node;
 
-    if (!log_enabled) {
+    if (!log_enabled && NULL == mca_sensor_resusage_component.telemetry_file) {
         return;
     }
 
@@ -300,7 +334,7 @@ static void res_log(opal_buffer_t *sample)
         return;
     }
 
-    if (mca_sensor_resusage_component.log_node_stats) {
+    if (log_enabled && mca_sensor_resusage_component.log_node_stats) {
         /* convert this into an array of opal_value_t's - no clean way
          * to do this, so have to just manually map each field
          */
@@ -373,10 +407,19 @@ static void res_log(opal_buffer_t *sample)
 
     OBJ_RELEASE(nst);
 
-    if (mca_sensor_resusage_component.log_process_stats) {
+    if (mca_sensor_resusage_component.log_process_stats ||
+        NULL != mca_sensor_resusage_component.telemetry_file) {
         /* unpack all process stats */
         n=1;
         while (OPAL_SUCCESS == (rc = opal_dss.unpack(sample, &st, &n, OPAL_PSTAT))) {
+            if (NULL != mca_sensor_resusage_component.telemetry_file) {
+                telemetry_write(st);
+            }
+            if (!log_enabled || !mca_sensor_resusage_component.log_process_stats) {
+                OBJ_RELEASE(st);
+                n=1;
+                continue;
+            }
             for (i=0; i < 14; i++) {
                 OBJ_CONSTRUCT(&kv[i], opal_value_t);
             }
@@ -28,6 +28,7 @@ struct orte_sensor_resusage_component_t {
     float proc_memory_limit;
     bool log_node_stats;
     bool log_process_stats;
+    char *telemetry_file;
 };
 typedef struct orte_sensor_resusage_component_t orte_sensor_resusage_component_t;
 
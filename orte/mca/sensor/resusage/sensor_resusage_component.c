@@ -101,6 +101,14 @@ static int orte_sensor_resusage_register (void)
                                             MCA_BASE_VAR_SCOPE_READONLY,
                                             &mca_sensor_resusage_component.log_process_stats);
 
+    mca_sensor_resusage_component.telemetry_file = NULL;
+    (void) mca_base_component_var_register (c, "telemetry_file",
+                                            "File to which the HNP appends one line per process sample (time, node, cmd, rank, pid, cpu time, rss, vsize, minor/major faults, voluntary/involuntary context switches)",
+                                            MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            &mca_sensor_resusage_component.telemetry_file);
+
     return ORTE_SUCCESS;
 }
 
@@ -22,6 +22,7 @@
 #include "opal/class/opal_list.h"
 
 #include "opal/mca/mca.h"
+#include "orte/runtime/orte_globals.h"
 #include "orte/mca/state/state.h"
 
 
@@ -35,6 +36,14 @@ ORTE_DECLSPEC void orte_state_base_print_job_state_machine(void);
 
 ORTE_DECLSPEC void orte_state_base_print_proc_state_machine(void);
 
+/* apply a routine state change of a proc without going through
+ * the event loop - returns false if the caller has to activate
+ * the state as usual
+ */
+ORTE_DECLSPEC bool orte_state_base_apply_proc_state(orte_job_t *jdata,
+                                                    orte_proc_t *pdata,
+                                                    orte_proc_state_t state);
+
 END_C_DECLS
 
 #endif
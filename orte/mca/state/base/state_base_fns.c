@@ -12,6 +12,10 @@
 #include "orte_config.h"
 #include "orte/constants.h"
 
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
 #include "opal/class/opal_list.h"
 #include "opal/mca/event/event.h"
 
@@ -22,11 +26,38 @@
 #include "orte/mca/plm/plm.h"
 #include "orte/mca/routed/routed.h"
 #include "orte/mca/sensor/sensor.h"
+#include "orte/util/proc_info.h"
 #include "orte/util/session_dir.h"
 
 #include "orte/mca/state/base/base.h"
 #include "orte/mca/state/base/state_private.h"
 
+/* time of the first and of the most recent job state transition,
+ * used to report per-phase times when orte_timing is set
+ */
+static struct timeval timing_start = {0, 0};
+static struct timeval timing_last = {0, 0};
+
+static void report_timing(orte_job_t *jdata, orte_job_state_t state)
+{
+    struct timeval now;
+    long secs, usecs, dsecs, dusecs;
+
+    gettimeofday(&now, NULL);
+    if (0 == timing_start.tv_sec && 0 == timing_start.tv_usec) {
+        timing_start = now;
+        timing_last = now;
+    }
+    ORTE_COMPUTE_TIME_DIFF(secs, usecs, timing_start.tv_sec, timing_start.tv_usec,
+                           now.tv_sec, now.tv_usec);
+    ORTE_COMPUTE_TIME_DIFF(dsecs, dusecs, timing_last.tv_sec, timing_last.tv_usec,
+                           now.tv_sec, now.tv_usec);
+    timing_last = now;
+    opal_output(0, "%s state: job %s %s at %ld.%06ld sec (+%ld.%06ld)",
+                ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), ORTE_JOBID_PRINT(jdata->jobid),
+                orte_job_state_to_str(state), secs, usecs, dsecs, dusecs);
+}
+
 void orte_state_base_activate_job_state(orte_job_t *jdata,
                                         orte_job_state_t state)
 {
@@ -34,6 +65,10 @@ void orte_state_base_activate_job_state(orte_job_t *jdata,
     orte_state_t *s;
     orte_state_caddy_t *caddy;
 
+    if (orte_timing && ORTE_PROC_IS_HNP && NULL != jdata) {
+        report_timing(jdata, state);
+    }
+
     for (itm = opal_list_get_first(&orte_job_states);
          itm != opal_list_get_end(&orte_job_states);
          itm = opal_list_get_next(itm)) {
@@ -450,27 +485,9 @@ void orte_state_base_report_progress(int fd, short argc, void *cbdata)
     OBJ_RELEASE(caddy);
 }
 
-void orte_state_base_track_procs(int fd, short argc, void *cbdata)
+static void track_proc(orte_job_t *jdata, orte_proc_t *pdata,
+                       orte_process_name_t *proc, orte_proc_state_t state)
 {
-    orte_state_caddy_t *caddy = (orte_state_caddy_t*)cbdata;
-    orte_process_name_t *proc = &caddy->name;
-    orte_proc_state_t state = caddy->proc_state;
-    orte_job_t *jdata;
-    orte_proc_t *pdata;
-
-    opal_output_verbose(5, orte_state_base_framework.framework_output,
-                        "%s state:base:track_procs called for proc %s state %s",
-                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
-                        ORTE_NAME_PRINT(proc),
-                        orte_proc_state_to_str(state));
-
-    /* get the job object for this proc */
-    if (NULL == (jdata = orte_get_job_data_object(proc->jobid))) {
-        ORTE_ERROR_LOG(ORTE_ERR_NOT_FOUND);
-        goto cleanup;
-    }
-    pdata = (orte_proc_t*)opal_pointer_array_get_item(jdata->procs, proc->vpid);
-
     if (ORTE_PROC_STATE_RUNNING == state) {
         /* update the proc state */
         pdata->state = state;
@@ -530,11 +547,69 @@ void orte_state_base_track_procs(int fd, short argc, void *cbdata)
             ORTE_ACTIVATE_JOB_STATE(jdata, ORTE_JOB_STATE_TERMINATED);
 	}
     }
+}
+
+void orte_state_base_track_procs(int fd, short argc, void *cbdata)
+{
+    orte_state_caddy_t *caddy = (orte_state_caddy_t*)cbdata;
+    orte_process_name_t *proc = &caddy->name;
+    orte_proc_state_t state = caddy->proc_state;
+    orte_job_t *jdata;
+    orte_proc_t *pdata;
+
+    opal_output_verbose(5, orte_state_base_framework.framework_output,
+                        "%s state:base:track_procs called for proc %s state %s",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                        ORTE_NAME_PRINT(proc),
+                        orte_proc_state_to_str(state));
+
+    /* get the job object for this proc */
+    if (NULL == (jdata = orte_get_job_data_object(proc->jobid))) {
+        ORTE_ERROR_LOG(ORTE_ERR_NOT_FOUND);
+        goto cleanup;
+    }
+    pdata = (orte_proc_t*)opal_pointer_array_get_item(jdata->procs, proc->vpid);
+
+    track_proc(jdata, pdata, proc, state);
 
  cleanup:
     OBJ_RELEASE(caddy);
 }
 
+/*
+ * The daemons report the states of all their procs in one message,
+ * and at scale going through the event loop once per proc for the
+ * routine RUNNING and TERMINATED updates dominates startup and
+ * teardown. When the state machine would only hand such an update to
+ * track_procs, apply it here and now instead; only the job state
+ * change it may complete goes through the event loop.
+ */
+bool orte_state_base_apply_proc_state(orte_job_t *jdata,
+                                      orte_proc_t *pdata,
+                                      orte_proc_state_t state)
+{
+    opal_list_item_t *itm;
+    orte_state_t *s;
+
+    if (ORTE_PROC_STATE_RUNNING != state &&
+        ORTE_PROC_STATE_TERMINATED != state) {
+        return false;
+    }
+    for (itm = opal_list_get_first(&orte_proc_states);
+         itm != opal_list_get_end(&orte_proc_states);
+         itm = opal_list_get_next(itm)) {
+        s = (orte_state_t*)itm;
+        if (s->proc_state == state) {
+            if (orte_state_base_track_procs != s->cbfunc) {
+                return false;
+            }
+            track_proc(jdata, pdata, &pdata->name, state);
+            return true;
+        }
+    }
+    return false;
+}
+
 void orte_state_base_check_all_complete(int fd, short args, void *cbdata)
 {
     orte_state_caddy_t *caddy = (orte_state_caddy_t*)cbdata;
@@ -21,6 +21,7 @@
 #include "opal/util/output.h"
 
 #include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/grpcomm/base/base.h"
 #include "orte/mca/iof/iof.h"
 #include "orte/mca/rml/rml.h"
 #include "orte/util/session_dir.h"
@@ -305,6 +306,9 @@ static void track_procs(int fd, short argc, void *cbdata)
             /* track job status */
             jdata->num_terminated++;
             if (jdata->num_terminated == jdata->num_local_procs) {
+                if (orte_sm_modex) {
+                    orte_grpcomm_base_release_shared_modex(jdata->jobid);
+                }
                 /* pack update state command */
                 cmd = ORTE_PLM_UPDATE_PROC_STATE;
                 alert = OBJ_NEW(opal_buffer_t);
@@ -356,6 +360,9 @@ static void track_procs(int fd, short argc, void *cbdata)
             /* track job status */
             jdata->num_terminated++;
             if (jdata->num_terminated == jdata->num_local_procs) {
+                if (orte_sm_modex) {
+                    orte_grpcomm_base_release_shared_modex(jdata->jobid);
+                }
                 /* pack update state command */
                 cmd = ORTE_PLM_UPDATE_PROC_STATE;
                 alert = OBJ_NEW(opal_buffer_t);
@@ -59,6 +59,7 @@
 
 #include "orte/mca/errmgr/errmgr.h"
 #include "orte/mca/grpcomm/grpcomm.h"
+#include "orte/mca/grpcomm/base/base.h"
 #include "orte/mca/rml/rml.h"
 #include "orte/mca/rml/rml_types.h"
 #include "orte/mca/odls/odls.h"
@@ -418,6 +419,16 @@ void orte_daemon_recv(int status, orte_process_name_t* sender,
                 }
             }
         } else {
+            /* if this is the modex, our children may be able to share
+             * a single copy of it
+             */
+            if (orte_sm_modex && ORTE_RML_TAG_COLLECTIVE == target_tag) {
+                opal_buffer_t *shared;
+                if (ORTE_SUCCESS == orte_grpcomm_base_share_modex(job, relay_msg, &shared)) {
+                    OBJ_RELEASE(relay_msg);
+                    relay_msg = shared;
+                }
+            }
             /* must be for our children - deliver the message */
             if (ORTE_SUCCESS != (ret = orte_odls.deliver_message(job, relay_msg, target_tag))) {
                 ORTE_ERROR_LOG(ret);
@@ -162,6 +162,12 @@ bool orte_report_bindings = false;
 /* barrier control */
 bool orte_do_not_barrier = false;
 
+/* direct modex */
+bool orte_direct_modex = false;
+
+/* modex shared on the node */
+bool orte_sm_modex = false;
+
 /* process recovery */
 bool orte_enable_recovery;
 int32_t orte_max_restarts;
@@ -692,6 +692,12 @@ ORTE_DECLSPEC extern int32_t orte_max_restarts;
 /* barrier control */
 ORTE_DECLSPEC extern bool orte_do_not_barrier;
 
+/* direct modex */
+ORTE_DECLSPEC extern bool orte_direct_modex;
+
+/* modex shared on the node */
+ORTE_DECLSPEC extern bool orte_sm_modex;
+
 /* exit status reporting */
 ORTE_DECLSPEC extern bool orte_report_child_jobs_separately;
 ORTE_DECLSPEC extern struct timeval orte_child_time_to_exit;
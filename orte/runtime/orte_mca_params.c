@@ -623,6 +623,23 @@ int orte_register_params(void)
                                   OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
                                   &orte_do_not_barrier);
 
+    /* direct modex */
+    orte_direct_modex = false;
+    (void) mca_base_var_register ("orte", "orte", NULL, "direct_modex",
+                                  "Do not exchange the modex data at startup: each process gives it to its daemon, "
+                                  "and the others fetch it from there the first time they look it up [Default = disabled]",
+                                  MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                  OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_ALL_EQ,
+                                  &orte_direct_modex);
+
+    orte_sm_modex = false;
+    (void) mca_base_var_register ("orte", "orte", NULL, "sm_modex",
+                                  "Have each daemon put the modex data of a job into a shared memory segment, "
+                                  "and its local processes look it up there instead of each keeping its own copy [Default = disabled]",
+                                  MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                  OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_ALL_EQ,
+                                  &orte_sm_modex);
+
     orte_enable_recovery = false;
     (void) mca_base_var_register ("orte", "orte", NULL, "enable_recovery",
                                   "Enable recovery from process failure [Default = disabled]",
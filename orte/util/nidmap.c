@@ -602,12 +602,16 @@ int orte_util_decode_daemon_nodemap(opal_byte_object_t *bo)
 
 int orte_util_encode_pidmap(opal_byte_object_t *boptr, bool update)
 {
-    orte_proc_t *proc;
+    orte_proc_t *proc, *pptr;
     opal_buffer_t buf;
-    int i, j, rc = ORTE_SUCCESS;
+    int i, j, k, rc = ORTE_SUCCESS;
+    orte_vpid_t count;
     orte_job_t *jdata;
     bool include_all;
     uint8_t flag;
+#if OPAL_HAVE_HWLOC
+    uint8_t shared;
+#endif
 
     /* setup the working buffer */
     OBJ_CONSTRUCT(&buf, opal_buffer_t);
@@ -661,38 +665,68 @@ int orte_util_encode_pidmap(opal_byte_object_t *boptr, bool update)
             goto cleanup_and_return;
         }
         /* cycle thru the job's procs, including only those that have
-         * been updated so we minimize the amount of info being sent
+         * been updated so we minimize the amount of info being sent.
+         * Procs are sent as runs: consecutive vpids on the same daemon
+         * whose local and node ranks also count up by one, and which
+         * agree on everything else, go out as a single record. Regular
+         * maps (byslot, ppr) then cost one record per node instead of
+         * one per proc
          */
-        for (i=0; i < jdata->procs->size; i++) {
+        for (i=0; i < jdata->procs->size; i += count) {
+            count = 1;
             if (NULL == (proc = (orte_proc_t *) opal_pointer_array_get_item(jdata->procs, i))) {
                 continue;
             }
             if (!proc->updated) {
                 continue;
             }
+#if OPAL_HAVE_HWLOC
+            shared = 1;
+#endif
+            for (k=i+1; k < jdata->procs->size; k++) {
+                if (NULL == (pptr = (orte_proc_t *) opal_pointer_array_get_item(jdata->procs, k)) ||
+                    !pptr->updated ||
+                    pptr->name.vpid != proc->name.vpid + count ||
+                    pptr->node->daemon != proc->node->daemon ||
+                    pptr->local_rank != proc->local_rank + count ||
+                    pptr->node_rank != proc->node_rank + count ||
+                    pptr->state != proc->state ||
+                    pptr->app_idx != proc->app_idx ||
+                    pptr->do_not_barrier != proc->do_not_barrier ||
+                    pptr->restarts != proc->restarts) {
+                    break;
+                }
+#if OPAL_HAVE_HWLOC
+                if (NULL == pptr->cpu_bitmap || NULL == proc->cpu_bitmap) {
+                    if (pptr->cpu_bitmap != proc->cpu_bitmap) {
+                        shared = 0;
+                    }
+                } else if (0 != strcmp(pptr->cpu_bitmap, proc->cpu_bitmap)) {
+                    shared = 0;
+                }
+#endif
+                count++;
+            }
             if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &proc->name.vpid, 1, ORTE_VPID))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup_and_return;
             }
-
-            if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &(proc->node->daemon->name.vpid), 1, ORTE_VPID))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &count, 1, ORTE_VPID))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup_and_return;
             }
-            if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &proc->local_rank, 1, ORTE_LOCAL_RANK))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &(proc->node->daemon->name.vpid), 1, ORTE_VPID))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup_and_return;
             }
-            if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &proc->node_rank, 1, ORTE_NODE_RANK))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &proc->local_rank, 1, ORTE_LOCAL_RANK))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup_and_return;
             }
-#if OPAL_HAVE_HWLOC
-            if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &proc->cpu_bitmap, 1, OPAL_STRING))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &proc->node_rank, 1, ORTE_NODE_RANK))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup_and_return;
             }
-#endif
             if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &proc->state, 1, ORTE_PROC_STATE))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup_and_return;
@@ -701,7 +735,7 @@ int orte_util_encode_pidmap(opal_byte_object_t *boptr, bool update)
                 ORTE_ERROR_LOG(rc);
                 goto cleanup_and_return;
             }
-             if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &proc->do_not_barrier, 1, OPAL_BOOL))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &proc->do_not_barrier, 1, OPAL_BOOL))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup_and_return;
             }
@@ -709,6 +743,25 @@ int orte_util_encode_pidmap(opal_byte_object_t *boptr, bool update)
                 ORTE_ERROR_LOG(rc);
                 goto cleanup_and_return;
             }
+#if OPAL_HAVE_HWLOC
+            /* bindings are either the same for the whole run, or
+             * follow one per proc
+             */
+            if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &shared, 1, OPAL_UINT8))) {
+                ORTE_ERROR_LOG(rc);
+                goto cleanup_and_return;
+            }
+            for (k=i; k < i + (int)count; k++) {
+                pptr = (orte_proc_t *) opal_pointer_array_get_item(jdata->procs, k);
+                if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &pptr->cpu_bitmap, 1, OPAL_STRING))) {
+                    ORTE_ERROR_LOG(rc);
+                    goto cleanup_and_return;
+                }
+                if (shared) {
+                    break;
+                }
+            }
+#endif
         }
         /* pack an invalid vpid to flag the end of this job data */
         if (ORTE_SUCCESS != (rc = opal_dss.pack(&buf, &ORTE_NAME_INVALID->vpid, 1, ORTE_VPID))) {
@@ -747,11 +800,12 @@ int orte_util_encode_pidmap(opal_byte_object_t *boptr, bool update)
 /* only APPS call this function - daemons have their own */
 int orte_util_decode_pidmap(opal_byte_object_t *bo)
 {
-    orte_vpid_t i, num_procs, *vptr, daemon;
+    orte_vpid_t i, k, count, num_procs, *vptr, daemon;
     orte_local_rank_t local_rank;
     orte_node_rank_t node_rank;
 #if OPAL_HAVE_HWLOC
     char *cpu_bitmap;
+    uint8_t shared;
 #endif
     opal_hwloc_locality_t locality;
     orte_std_cntr_t n;
@@ -811,39 +865,27 @@ int orte_util_decode_pidmap(opal_byte_object_t *bo)
             if (ORTE_VPID_INVALID == proc.vpid) {
                 break;
             }
+            /* each record covers a run of count procs - see encode */
             n=1;
-            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &dmn.vpid, &n, ORTE_VPID))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &count, &n, ORTE_VPID))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
             n=1;
-            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &local_rank, &n, ORTE_LOCAL_RANK))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &dmn.vpid, &n, ORTE_VPID))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
             n=1;
-            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &node_rank, &n, ORTE_NODE_RANK))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &local_rank, &n, ORTE_LOCAL_RANK))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
-#if OPAL_HAVE_HWLOC
             n=1;
-            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &cpu_bitmap, &n, OPAL_STRING))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &node_rank, &n, ORTE_NODE_RANK))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
-#endif
-            if (proc.jobid == ORTE_PROC_MY_NAME->jobid &&
-                proc.vpid == ORTE_PROC_MY_NAME->vpid) {
-                /* set mine */
-                orte_process_info.my_local_rank = local_rank;
-                orte_process_info.my_node_rank = node_rank;
-#if OPAL_HAVE_HWLOC
-                if (NULL != cpu_bitmap) {
-                    orte_process_info.cpuset = strdup(cpu_bitmap);
-                }
-#endif
-            }
             /* apps don't need the rest of the data in the buffer for this proc,
              * but we have to unpack it anyway to stay in sync
              */
@@ -867,45 +909,82 @@ int orte_util_decode_pidmap(opal_byte_object_t *bo)
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
-            /* store the values in the database */
-            if (ORTE_SUCCESS != (rc = opal_db.store((opal_identifier_t*)&proc, OPAL_DB_INTERNAL, ORTE_DB_LOCALRANK, &local_rank, ORTE_LOCAL_RANK))) {
-                ORTE_ERROR_LOG(rc);
-                goto cleanup;
-            }
-            if (ORTE_SUCCESS != (rc = opal_db.store((opal_identifier_t*)&proc, OPAL_DB_INTERNAL, ORTE_DB_NODERANK, &node_rank, ORTE_NODE_RANK))) {
-                ORTE_ERROR_LOG(rc);
-                goto cleanup;
-            }
 #if OPAL_HAVE_HWLOC
-            if (ORTE_SUCCESS != (rc = opal_db.store((opal_identifier_t*)&proc, OPAL_DB_INTERNAL, ORTE_DB_CPUSET, cpu_bitmap, OPAL_STRING))) {
+            n=1;
+            if (OPAL_SUCCESS != (rc = opal_dss.unpack(&buf, &shared, &n, OPAL_UINT8))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
-            if (NULL != cpu_bitmap) {
-                free(cpu_bitmap);
-            }
+            cpu_bitmap = NULL;
 #endif
-            /* we don't need to store the rest of the values
-             * for ourself in the database
-             * as we already did so during startup
-             */
-            if (proc.jobid != ORTE_PROC_MY_NAME->jobid ||
-                proc.vpid != ORTE_PROC_MY_NAME->vpid) {
-                /* store the data for this proc */
-                if (ORTE_SUCCESS != (rc = opal_db.store((opal_identifier_t*)&proc, OPAL_DB_INTERNAL, ORTE_DB_DAEMON_VPID, &dmn.vpid, OPAL_UINT32))) {
+            for (k=0; k < count; k++, proc.vpid++, local_rank++, node_rank++) {
+#if OPAL_HAVE_HWLOC
+                if (0 == k || !shared) {
+                    n=1;
+                    if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &cpu_bitmap, &n, OPAL_STRING))) {
+                        ORTE_ERROR_LOG(rc);
+                        goto cleanup;
+                    }
+                }
+#endif
+                if (proc.jobid == ORTE_PROC_MY_NAME->jobid &&
+                    proc.vpid == ORTE_PROC_MY_NAME->vpid) {
+                    /* set mine */
+                    orte_process_info.my_local_rank = local_rank;
+                    orte_process_info.my_node_rank = node_rank;
+#if OPAL_HAVE_HWLOC
+                    if (NULL != cpu_bitmap) {
+                        orte_process_info.cpuset = strdup(cpu_bitmap);
+                    }
+#endif
+                }
+                /* store the values in the database */
+                if (ORTE_SUCCESS != (rc = opal_db.store((opal_identifier_t*)&proc, OPAL_DB_INTERNAL, ORTE_DB_LOCALRANK, &local_rank, ORTE_LOCAL_RANK))) {
                     ORTE_ERROR_LOG(rc);
                     goto cleanup;
                 }
-                /* lookup and store the hostname for this proc */
-                if (ORTE_SUCCESS != (rc = opal_db.fetch_pointer((opal_identifier_t*)&dmn, ORTE_DB_HOSTNAME, (void**)&hostname, OPAL_STRING))) {
+                if (ORTE_SUCCESS != (rc = opal_db.store((opal_identifier_t*)&proc, OPAL_DB_INTERNAL, ORTE_DB_NODERANK, &node_rank, ORTE_NODE_RANK))) {
                     ORTE_ERROR_LOG(rc);
                     goto cleanup;
                 }
-                if (ORTE_SUCCESS != (rc = opal_db.store((opal_identifier_t*)&proc, OPAL_DB_INTERNAL, ORTE_DB_HOSTNAME, hostname, OPAL_STRING))) {
+#if OPAL_HAVE_HWLOC
+                if (ORTE_SUCCESS != (rc = opal_db.store((opal_identifier_t*)&proc, OPAL_DB_INTERNAL, ORTE_DB_CPUSET, cpu_bitmap, OPAL_STRING))) {
                     ORTE_ERROR_LOG(rc);
                     goto cleanup;
                 }
+                if (!shared && NULL != cpu_bitmap) {
+                    free(cpu_bitmap);
+                    cpu_bitmap = NULL;
+                }
+#endif
+                /* we don't need to store the rest of the values
+                 * for ourself in the database
+                 * as we already did so during startup
+                 */
+                if (proc.jobid != ORTE_PROC_MY_NAME->jobid ||
+                    proc.vpid != ORTE_PROC_MY_NAME->vpid) {
+                    /* store the data for this proc */
+                    if (ORTE_SUCCESS != (rc = opal_db.store((opal_identifier_t*)&proc, OPAL_DB_INTERNAL, ORTE_DB_DAEMON_VPID, &dmn.vpid, OPAL_UINT32))) {
+                        ORTE_ERROR_LOG(rc);
+                        goto cleanup;
+                    }
+                    /* lookup and store the hostname for this proc */
+                    if (ORTE_SUCCESS != (rc = opal_db.fetch_pointer((opal_identifier_t*)&dmn, ORTE_DB_HOSTNAME, (void**)&hostname, OPAL_STRING))) {
+                        ORTE_ERROR_LOG(rc);
+                        goto cleanup;
+                    }
+                    if (ORTE_SUCCESS != (rc = opal_db.store((opal_identifier_t*)&proc, OPAL_DB_INTERNAL, ORTE_DB_HOSTNAME, hostname, OPAL_STRING))) {
+                        ORTE_ERROR_LOG(rc);
+                        goto cleanup;
+                    }
+                }
+            }
+#if OPAL_HAVE_HWLOC
+            if (NULL != cpu_bitmap) {
+                free(cpu_bitmap);
             }
+#endif
+            n=1;
         }
         /* see if there is a file map */
         n=1;
@@ -1028,11 +1107,12 @@ static void fm_release(void *cbdata)
 int orte_util_decode_daemon_pidmap(opal_byte_object_t *bo)
 {
     orte_jobid_t jobid;
-    orte_vpid_t vpid, num_procs, dmn;
+    orte_vpid_t vpid, r, count, num_procs, dmn;
     orte_local_rank_t local_rank;
     orte_node_rank_t node_rank;
 #if OPAL_HAVE_HWLOC
     char *cpu_bitmap;
+    uint8_t shared;
 #endif
     orte_std_cntr_t n;
     opal_buffer_t buf;
@@ -1092,28 +1172,27 @@ int orte_util_decode_daemon_pidmap(opal_byte_object_t *bo)
             if (ORTE_VPID_INVALID == vpid) {
                 break;
             }
+            /* each record covers a run of count procs - see encode */
             n=1;
-            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &dmn, &n, ORTE_VPID))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &count, &n, ORTE_VPID))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
             n=1;
-            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &local_rank, &n, ORTE_LOCAL_RANK))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &dmn, &n, ORTE_VPID))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
             n=1;
-            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &node_rank, &n, ORTE_NODE_RANK))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &local_rank, &n, ORTE_LOCAL_RANK))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
-#if OPAL_HAVE_HWLOC
             n=1;
-            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &cpu_bitmap, &n, OPAL_STRING))) {
+            if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &node_rank, &n, ORTE_NODE_RANK))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
-#endif
             n=1;
             if (OPAL_SUCCESS != (rc = opal_dss.unpack(&buf, &state, &n, ORTE_PROC_STATE))) {
                 ORTE_ERROR_LOG(rc);
@@ -1134,13 +1213,14 @@ int orte_util_decode_daemon_pidmap(opal_byte_object_t *bo)
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
-            /* store the data for this proc */
-            if (NULL == (proc = (orte_proc_t*)opal_pointer_array_get_item(jdata->procs, vpid))) {
-                proc = OBJ_NEW(orte_proc_t);
-                proc->name.jobid = jdata->jobid;
-                proc->name.vpid = vpid;
-                opal_pointer_array_set_item(jdata->procs, vpid, proc);
+#if OPAL_HAVE_HWLOC
+            n=1;
+            if (OPAL_SUCCESS != (rc = opal_dss.unpack(&buf, &shared, &n, OPAL_UINT8))) {
+                ORTE_ERROR_LOG(rc);
+                goto cleanup;
             }
+            cpu_bitmap = NULL;
+#endif
             /* lookup the node - should always be present */
             if (NULL == (node = (orte_node_t*)opal_pointer_array_get_item(orte_node_pool, dmn))) {
                 /* this should never happen, but protect ourselves anyway */
@@ -1155,40 +1235,9 @@ int orte_util_decode_daemon_pidmap(opal_byte_object_t *bo)
                 node->daemon = pptr;
                 opal_pointer_array_set_item(orte_node_pool, dmn, node);
             }
-            if (NULL != proc->node) {
-                if (node != proc->node) {
-                    /* proc has moved - cleanup the prior node proc array */
-                    for (j=0; j < proc->node->procs->size; j++) {
-                        if (NULL == (pptr = (orte_proc_t*)opal_pointer_array_get_item(proc->node->procs, j))) {
-                            continue;
-                        }
-                        if (pptr == proc) {
-                            /* maintain accounting */
-                            OBJ_RELEASE(pptr);
-                            opal_pointer_array_set_item(proc->node->procs, j, NULL);
-                            proc->node->num_procs--;
-                            if (0 == proc->node->num_procs) {
-                                /* remove node from the map */
-                                for (k=0; k < map->nodes->size; k++) {
-                                    if (NULL == (nptr = (orte_node_t*)opal_pointer_array_get_item(map->nodes, k))) {
-                                        continue;
-                                    }
-                                    if (nptr == proc->node) {
-                                        /* maintain accounting */
-                                        OBJ_RELEASE(nptr);
-                                        opal_pointer_array_set_item(map->nodes, k, NULL);
-                                        map->num_nodes--;
-                                        break;
-                                    }
-                                }
-                            }
-                            break;
-                        }
-                    }
-                }
-                OBJ_RELEASE(proc->node);
-            }
-            /* see if this node is already in the map */
+            /* see if this node is already in the map - the whole
+             * run lives on it, so only look once
+             */
             found = false;
             for (j=0; j < map->nodes->size; j++) {
                 if (NULL == (nptr = (orte_node_t*)opal_pointer_array_get_item(map->nodes, j))) {
@@ -1203,22 +1252,83 @@ int orte_util_decode_daemon_pidmap(opal_byte_object_t *bo)
                 opal_pointer_array_add(map->nodes, node);
                 map->num_nodes++;
             }
-            /* add the node to the proc */
-            OBJ_RETAIN(node);
-            proc->node = node;
-            /* add the proc to the node */
-            OBJ_RETAIN(proc);
-            opal_pointer_array_add(node->procs, proc);
-            /* update proc values */
-            proc->local_rank = local_rank;
-            proc->node_rank = node_rank;
-            proc->app_idx = app_idx;
-            proc->do_not_barrier = barrier;
-            proc->restarts = restarts;
-            proc->state = state;
+            for (r=0; r < count; r++, vpid++, local_rank++, node_rank++) {
+#if OPAL_HAVE_HWLOC
+                if (0 == r || !shared) {
+                    n=1;
+                    if (ORTE_SUCCESS != (rc = opal_dss.unpack(&buf, &cpu_bitmap, &n, OPAL_STRING))) {
+                        ORTE_ERROR_LOG(rc);
+                        goto cleanup;
+                    }
+                }
+#endif
+                /* store the data for this proc */
+                if (NULL == (proc = (orte_proc_t*)opal_pointer_array_get_item(jdata->procs, vpid))) {
+                    proc = OBJ_NEW(orte_proc_t);
+                    proc->name.jobid = jdata->jobid;
+                    proc->name.vpid = vpid;
+                    opal_pointer_array_set_item(jdata->procs, vpid, proc);
+                }
+                if (NULL != proc->node) {
+                    if (node != proc->node) {
+                        /* proc has moved - cleanup the prior node proc array */
+                        for (j=0; j < proc->node->procs->size; j++) {
+                            if (NULL == (pptr = (orte_proc_t*)opal_pointer_array_get_item(proc->node->procs, j))) {
+                                continue;
+                            }
+                            if (pptr == proc) {
+                                /* maintain accounting */
+                                OBJ_RELEASE(pptr);
+                                opal_pointer_array_set_item(proc->node->procs, j, NULL);
+                                proc->node->num_procs--;
+                                if (0 == proc->node->num_procs) {
+                                    /* remove node from the map */
+                                    for (k=0; k < map->nodes->size; k++) {
+                                        if (NULL == (nptr = (orte_node_t*)opal_pointer_array_get_item(map->nodes, k))) {
+                                            continue;
+                                        }
+                                        if (nptr == proc->node) {
+                                            /* maintain accounting */
+                                            OBJ_RELEASE(nptr);
+                                            opal_pointer_array_set_item(map->nodes, k, NULL);
+                                            map->num_nodes--;
+                                            break;
+                                        }
+                                    }
+                                }
+                                break;
+                            }
+                        }
+                    }
+                    OBJ_RELEASE(proc->node);
+                }
+                /* add the node to the proc */
+                OBJ_RETAIN(node);
+                proc->node = node;
+                /* add the proc to the node */
+                OBJ_RETAIN(proc);
+                opal_pointer_array_add(node->procs, proc);
+                /* update proc values */
+                proc->local_rank = local_rank;
+                proc->node_rank = node_rank;
+                proc->app_idx = app_idx;
+                proc->do_not_barrier = barrier;
+                proc->restarts = restarts;
+                proc->state = state;
+#if OPAL_HAVE_HWLOC
+                if (shared && NULL != cpu_bitmap) {
+                    proc->cpu_bitmap = strdup(cpu_bitmap);
+                } else {
+                    proc->cpu_bitmap = cpu_bitmap;
+                }
+#endif
+            }
 #if OPAL_HAVE_HWLOC
-            proc->cpu_bitmap = cpu_bitmap;
+            if (shared && NULL != cpu_bitmap) {
+                free(cpu_bitmap);
+            }
 #endif
+            n=1;
         }
         /* see if we have a file map for this job */
         n=1;
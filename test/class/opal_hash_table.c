@@ -129,6 +129,60 @@ static void test_htable(opal_hash_table_t *table)
 }
 
 
+static void test_growth(void)
+{
+    opal_hash_table_t table;
+    uint64_t key;
+    void *value;
+    void *node;
+    size_t count;
+    int ret;
+    const uint64_t n = 10000;
+
+    OBJ_CONSTRUCT(&table, opal_hash_table_t);
+    opal_hash_table_init(&table, 4);
+
+    fprintf(error_out, "Testing growth and removal...\n");
+    /* keys made of a job id in the high bits and a rank in the low
+       bits, as for process names */
+    for (key = 0; key < n; key++) {
+        opal_hash_table_set_value_uint64(&table, (((uint64_t) 42) << 32) | key,
+                                         (void*) (uintptr_t) (key + 1));
+    }
+    test_verify_int(n, opal_hash_table_get_size(&table));
+
+    /* remove every other key */
+    for (key = 0; key < n; key += 2) {
+        ret = opal_hash_table_remove_value_uint64(&table, (((uint64_t) 42) << 32) | key);
+        test_verify_int(OPAL_SUCCESS, ret);
+    }
+    test_verify_int(n / 2, opal_hash_table_get_size(&table));
+
+    for (key = 0; key < n; key++) {
+        ret = opal_hash_table_get_value_uint64(&table, (((uint64_t) 42) << 32) | key,
+                                               &value);
+        if (key & 1) {
+            test_verify_int(OPAL_SUCCESS, ret);
+            test_verify_int(key + 1, (uintptr_t) value);
+        } else {
+            test_verify_int(OPAL_ERR_NOT_FOUND, ret);
+        }
+    }
+
+    /* every remaining key is visited once by the iterators */
+    count = 0;
+    ret = opal_hash_table_get_first_key_uint64(&table, &key, &value, &node);
+    while (OPAL_SUCCESS == ret) {
+        test_verify_int(1, key & 1);
+        ++count;
+        ret = opal_hash_table_get_next_key_uint64(&table, &key, &value, node, &node);
+    }
+    test_verify_int(n / 2, count);
+
+    OBJ_DESTRUCT(&table);
+}
+
+
 static void test_dynamic(void)
 {
     opal_hash_table_t     *table;
@@ -183,6 +237,7 @@ int main(int argc, char **argv)
     
     test_dynamic();
     test_static();
+    test_growth();
 #ifndef STANDALONE
     fclose( error_out );
 #endif
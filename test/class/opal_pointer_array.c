@@ -141,6 +141,32 @@ static void test(bool thread_usage){
         test_failure(" data check - 2nd ");
     }
 
+    /* grow through set_item: the elements move to the new array, the
+     * old one is kept for the readers which do not lock */
+    test_len_in_array = array->size;
+    ele_index = 4 * array->size;
+    value.ivalue = ele_index;
+    error_code = opal_pointer_array_set_item(array, ele_index, value.cvalue);
+    if( (0 == error_code) && (ele_index < array->size) && (1 <= array->num_retired) ) {
+        test_success();
+    } else {
+        test_failure(" opal_pointer_array_set_item grow ");
+    }
+    error_cnt=0;
+    for(i=0 ; i < test_len_in_array ; i++ ) {
+        value.cvalue = opal_pointer_array_get_item(array,i);
+        if( (i+2) != value.ivalue ) {
+            error_cnt++;
+        }
+    }
+    value.cvalue = opal_pointer_array_get_item(array,ele_index);
+    if( (0 == error_cnt) && (ele_index == value.ivalue) &&
+        (NULL == opal_pointer_array_get_item(array,ele_index - 1)) ) {
+        test_success();
+    } else {
+        test_failure(" data check - after grow ");
+    }
+
     free (array);
     free(test_data);
 }
@@ -327,6 +327,264 @@ static int local_copy_with_convertor( const opal_datatype_t const* pdt, int coun
     return OPAL_SUCCESS;
 }
 
+/**
+ * Pack and unpack in chunks through the convertors and compare the
+ * result with the direct copy of the datatype. This validates the
+ * strided pack/unpack functions (used for the datatypes with a regular
+ * shape) against the generic engine.
+ */
+static int local_copy_strided_check( const opal_datatype_t const* pdt, int count, int chunk )
+{
+    OPAL_PTRDIFF_TYPE extent;
+    char *pdst = NULL, *pref = NULL, *psrc = NULL, *ptemp = NULL;
+    opal_convertor_t *send_convertor = NULL, *recv_convertor = NULL;
+    struct iovec iov;
+    uint32_t iov_count;
+    size_t max_data;
+    int32_t done1 = 0, done2 = 0, i, rc = OPAL_ERROR;
+
+    opal_datatype_type_extent( pdt, &extent );
+
+    pdst  = (char*)malloc( extent * count );
+    pref  = (char*)malloc( extent * count );
+    psrc  = (char*)malloc( extent * count );
+    ptemp = (char*)malloc( chunk );
+
+    for( i = 0; i < (count * extent); psrc[i] = i % 128 + 32, i++ );
+    memset( pdst, 0, count * extent );
+    memset( pref, 0, count * extent );
+    opal_datatype_copy_content_same_ddt( pdt, count, pref, psrc );
+
+    send_convertor = opal_convertor_create( remote_arch, 0 );
+    recv_convertor = opal_convertor_create( remote_arch, 0 );
+    if( (OPAL_SUCCESS != opal_convertor_prepare_for_send( send_convertor, pdt, count, psrc )) ||
+        (OPAL_SUCCESS != opal_convertor_prepare_for_recv( recv_convertor, pdt, count, pdst )) ) {
+        printf( "Unable to create the convertors. Is the datatype committed ?\n" );
+        goto clean_and_return;
+    }
+
+    while( (done1 & done2) != 1 ) {
+        max_data = chunk;
+        iov_count = 1;
+        iov.iov_base = ptemp;
+        iov.iov_len = chunk;
+
+        done1 = opal_convertor_pack( send_convertor, &iov, &iov_count, &max_data );
+        done2 = opal_convertor_unpack( recv_convertor, &iov, &iov_count, &max_data );
+        if( done1 != done2 ) {
+            printf( "the send and the receive did not complete at the same time\n" );
+            goto clean_and_return;
+        }
+    }
+
+    if( 0 != memcmp( pdst, pref, count * extent ) ) {
+        printf( "strided copy (%d dims, count %d, chunk %d) [NOT PASSED]\n",
+                (NULL == pdt->strided ? 0 : pdt->strided->dims), count, chunk );
+        goto clean_and_return;
+    }
+    printf( "strided copy (%d dims, count %d, chunk %d) [PASSED]\n",
+            (NULL == pdt->strided ? 0 : pdt->strided->dims), count, chunk );
+    rc = OPAL_SUCCESS;
+
+ clean_and_return:
+    if( NULL != send_convertor ) OBJ_RELEASE( send_convertor );
+    if( NULL != recv_convertor ) OBJ_RELEASE( recv_convertor );
+
+    free( pdst );
+    free( pref );
+    free( psrc );
+    free( ptemp );
+    return rc;
+}
+
+/**
+ * Describe the data with opal_convertor_gather, chunk bytes and at most 4
+ * iovecs at a time, and check that the gathered data is the same as the
+ * packed data.
+ */
+static int local_gather_check( const opal_datatype_t const* pdt, int count, int chunk )
+{
+    OPAL_PTRDIFF_TYPE extent;
+    char *psrc = NULL, *ppacked = NULL, *pgathered = NULL, *pos;
+    opal_convertor_t *pack_convertor = NULL, *gather_convertor = NULL;
+    struct iovec iov[4];
+    uint32_t iov_count, i;
+    size_t max_data, total = 0;
+    int32_t done = 0, rc = OPAL_ERROR;
+
+    opal_datatype_type_extent( pdt, &extent );
+
+    psrc      = (char*)malloc( extent * count );
+    ppacked   = (char*)malloc( pdt->size * count );
+    pgathered = (char*)malloc( pdt->size * count );
+    for( i = 0; i < (uint32_t)(count * extent); psrc[i] = i % 128 + 32, i++ );
+
+    pack_convertor   = opal_convertor_create( remote_arch, 0 );
+    gather_convertor = opal_convertor_create( remote_arch, 0 );
+    if( (OPAL_SUCCESS != opal_convertor_prepare_for_send( pack_convertor, pdt, count, psrc )) ||
+        (OPAL_SUCCESS != opal_convertor_prepare_for_send( gather_convertor, pdt, count, psrc )) ) {
+        printf( "Unable to create the convertors. Is the datatype committed ?\n" );
+        goto clean_and_return;
+    }
+
+    iov_count = 1;
+    iov[0].iov_base = ppacked;
+    iov[0].iov_len = max_data = pdt->size * count;
+    opal_convertor_pack( pack_convertor, iov, &iov_count, &max_data );
+
+    pos = pgathered;
+    while( 1 != done ) {
+        iov_count = 4;
+        max_data = chunk;
+        done = opal_convertor_gather( gather_convertor, iov, &iov_count, &max_data );
+        if( (done < 0) || (0 == max_data) ) {
+            printf( "gather (count %d, chunk %d) failed [NOT PASSED]\n", count, chunk );
+            goto clean_and_return;
+        }
+        for( i = 0; i < iov_count; i++ ) {
+            memcpy( pos, iov[i].iov_base, iov[i].iov_len );
+            pos += iov[i].iov_len;
+            total += iov[i].iov_len;
+        }
+        if( total != gather_convertor->bConverted ) {
+            printf( "gather (count %d, chunk %d) wrong length [NOT PASSED]\n", count, chunk );
+            goto clean_and_return;
+        }
+    }
+
+    if( 0 != memcmp( ppacked, pgathered, pdt->size * count ) ) {
+        printf( "gather (count %d, chunk %d) [NOT PASSED]\n", count, chunk );
+        goto clean_and_return;
+    }
+    printf( "gather (count %d, chunk %d) [PASSED]\n", count, chunk );
+    rc = OPAL_SUCCESS;
+
+ clean_and_return:
+    if( NULL != pack_convertor ) OBJ_RELEASE( pack_convertor );
+    if( NULL != gather_convertor ) OBJ_RELEASE( gather_convertor );
+
+    free( psrc );
+    free( ppacked );
+    free( pgathered );
+    return rc;
+}
+
+/**
+ * Move the convertor backward and forward with opal_convertor_set_position,
+ * pack chunk bytes at each position and compare them with the data packed
+ * in one go. Then describe the data with opal_convertor_raw, which has no
+ * stack to walk for the datatypes with a regular shape.
+ */
+static int local_position_check( const opal_datatype_t const* pdt, int count, int chunk )
+{
+    OPAL_PTRDIFF_TYPE extent;
+    char *psrc = NULL, *ppacked = NULL, *ptemp = NULL, *pos;
+    opal_convertor_t *pack_convertor = NULL, *seek_convertor = NULL;
+    struct iovec iov[4];
+    uint32_t iov_count, i;
+    size_t max_data, position, length = pdt->size * count;
+    int32_t done = 0, rc = OPAL_ERROR;
+
+    opal_datatype_type_extent( pdt, &extent );
+
+    psrc    = (char*)malloc( extent * count );
+    ppacked = (char*)malloc( length );
+    ptemp   = (char*)malloc( length );
+    for( i = 0; i < (uint32_t)(count * extent); psrc[i] = i % 128 + 32, i++ );
+
+    pack_convertor = opal_convertor_create( remote_arch, 0 );
+    seek_convertor = opal_convertor_create( remote_arch, 0 );
+    if( (OPAL_SUCCESS != opal_convertor_prepare_for_send( pack_convertor, pdt, count, psrc )) ||
+        (OPAL_SUCCESS != opal_convertor_prepare_for_send( seek_convertor, pdt, count, psrc )) ) {
+        printf( "Unable to create the convertors. Is the datatype committed ?\n" );
+        goto clean_and_return;
+    }
+
+    iov_count = 1;
+    iov[0].iov_base = ppacked;
+    iov[0].iov_len = max_data = length;
+    opal_convertor_pack( pack_convertor, iov, &iov_count, &max_data );
+
+    /* from the end to the beginning, so every seek is a rollback */
+    for( position = ((length - 1) / chunk) * chunk; ; position -= chunk ) {
+        size_t where = position;
+
+        opal_convertor_set_position( seek_convertor, &where );
+        iov_count = 1;
+        iov[0].iov_base = ptemp;
+        iov[0].iov_len = max_data = chunk;
+        opal_convertor_pack( seek_convertor, iov, &iov_count, &max_data );
+        if( (where != position) || (0 != memcmp( ppacked + position, ptemp, max_data )) ) {
+            printf( "set_position (count %d, chunk %d) at %lu [NOT PASSED]\n",
+                    count, chunk, (unsigned long)position );
+            goto clean_and_return;
+        }
+        if( 0 == position ) break;
+    }
+
+    position = 0;
+    opal_convertor_set_position( seek_convertor, &position );
+    pos = ptemp;
+    while( 1 != done ) {
+        iov_count = 4;
+        done = opal_convertor_raw( seek_convertor, iov, &iov_count, &max_data );
+        if( (done < 0) || (0 == iov_count) ) {
+            printf( "raw (count %d) failed [NOT PASSED]\n", count );
+            goto clean_and_return;
+        }
+        for( i = 0; i < iov_count; i++ ) {
+            memcpy( pos, iov[i].iov_base, iov[i].iov_len );
+            pos += iov[i].iov_len;
+        }
+    }
+    if( ((size_t)(pos - ptemp) != length) || (0 != memcmp( ppacked, ptemp, length )) ) {
+        printf( "raw (count %d) [NOT PASSED]\n", count );
+        goto clean_and_return;
+    }
+    printf( "set_position and raw (count %d, chunk %d) [PASSED]\n", count, chunk );
+    rc = OPAL_SUCCESS;
+
+ clean_and_return:
+    if( NULL != pack_convertor ) OBJ_RELEASE( pack_convertor );
+    if( NULL != seek_convertor ) OBJ_RELEASE( seek_convertor );
+
+    free( psrc );
+    free( ppacked );
+    free( ptemp );
+    return rc;
+}
+
+/**
+ * Commit a vector using the optimized description of an identical one
+ * (as the datatype cache of the MPI layer does) and check that the result
+ * is the same as with the optimizer.
+ */
+static int local_commit_from_check( const opal_datatype_t const* model,
+                                    const opal_datatype_t const* base,
+                                    int count, int length, int stride )
+{
+    opal_datatype_t* pdt;
+    int rc = OPAL_ERROR;
+
+    pdt = create_uncommitted_vector_type( base, count, length, stride );
+    opal_datatype_commit_from( pdt, model );
+
+    if( !opal_datatype_is_committed(pdt) ||
+        (pdt->opt_desc.used != model->opt_desc.used) ||
+        (0 != memcmp( pdt->opt_desc.desc, model->opt_desc.desc,
+                      (model->opt_desc.used + 1) * sizeof(dt_elem_desc_t) )) ||
+        ((NULL == pdt->strided) != (NULL == model->strided)) ) {
+        printf( "commit from model (vector %d %d %d) [NOT PASSED]\n", count, length, stride );
+        goto clean_and_return;
+    }
+    printf( "commit from model (vector %d %d %d) [PASSED]\n", count, length, stride );
+    rc = local_copy_strided_check( pdt, 2, 4096 );
+
+ clean_and_return:
+    OBJ_RELEASE( pdt );
+    return rc;
+}
+
 /**
  * Main function. Call several tests and print-out the results. It try to stress the convertor
  * using difficult data-type constructions as well as strange segment sizes for the conversion.
@@ -337,7 +595,7 @@ static int local_copy_with_convertor( const opal_datatype_t const* pdt, int coun
 int main( int argc, char* argv[] )
 {
     opal_datatype_t *pdt, *pdt1, *pdt2, *pdt3;
-    int rc, length = 500;
+    int rc, length = 500, errors = 0;
 
     opal_datatype_init();
 
@@ -493,7 +751,31 @@ int main( int argc, char* argv[] )
     }
     printf( ">>--------------------------------------------<<\n" );
     OBJ_RELEASE( pdt ); assert( pdt == NULL );
-    
+
+    printf( ">>--------------------------------------------<<\n" );
+    printf( "Strided data-types\n" );
+    pdt = create_vector_type( &opal_datatype_float8, 450, 10, 11 );
+    errors += (OPAL_SUCCESS != local_copy_strided_check( pdt, 1, 12 ));
+    errors += (OPAL_SUCCESS != local_copy_strided_check( pdt, 3, 4096 ));
+    errors += (OPAL_SUCCESS != local_copy_strided_check( pdt, 2, 36000 ));
+    pdt1 = create_vector_type( &opal_datatype_float8, 1000, 1, 3 );
+    errors += (OPAL_SUCCESS != local_copy_strided_check( pdt1, 1, 12 ));
+    errors += (OPAL_SUCCESS != local_copy_strided_check( pdt1, 5, 1000 ));
+    pdt2 = create_vector_type( pdt, 4, 1, 2 );  /* 3D: vector of vectors */
+    errors += (OPAL_SUCCESS != local_copy_strided_check( pdt2, 1, 82 ));
+    errors += (OPAL_SUCCESS != local_copy_strided_check( pdt2, 2, 6000 ));
+    errors += (OPAL_SUCCESS != local_commit_from_check( pdt, &opal_datatype_float8, 450, 10, 11 ));
+    errors += (OPAL_SUCCESS != local_gather_check( pdt, 2, 100 ));
+    errors += (OPAL_SUCCESS != local_gather_check( pdt1, 3, 4096 ));
+    errors += (OPAL_SUCCESS != local_gather_check( pdt2, 1, 1000 ));
+    errors += (OPAL_SUCCESS != local_commit_from_check( pdt2, pdt, 4, 1, 2 ));
+    errors += (OPAL_SUCCESS != local_position_check( pdt, 2, 1000 ));
+    errors += (OPAL_SUCCESS != local_position_check( pdt2, 1, 36 ));
+    printf( ">>--------------------------------------------<<\n" );
+    OBJ_RELEASE( pdt ); assert( pdt == NULL );
+    OBJ_RELEASE( pdt1 ); assert( pdt1 == NULL );
+    OBJ_RELEASE( pdt2 ); assert( pdt2 == NULL );
+
     printf( ">>--------------------------------------------<<\n" );
     pdt = test_struct_char_double();
     if( outputFlags & CHECK_PACK_UNPACK ) {
@@ -542,5 +824,5 @@ int main( int argc, char* argv[] )
     /* clean-ups all data allocations */
     opal_datatype_finalize();
 
-    return OPAL_SUCCESS;
+    return (0 == errors) ? OPAL_SUCCESS : 1;
 }
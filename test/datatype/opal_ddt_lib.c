@@ -242,6 +242,15 @@ opal_datatype_t* create_vector_type( const opal_datatype_t* data, int count, int
     return vector;
 }
 
+/* same as create_vector_type but leave the commit to the caller */
+opal_datatype_t* create_uncommitted_vector_type( const opal_datatype_t* data, int count, int length, int stride )
+{
+    opal_datatype_t* vector;
+
+    opal_datatype_create_vector( count, length, stride, data, &vector );
+    return vector;
+}
+
 
 opal_datatype_t* create_contiguous_type( const opal_datatype_t* type, int length )
 {
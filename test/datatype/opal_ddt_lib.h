@@ -31,6 +31,7 @@ extern uint32_t outputFlags;
 extern void cache_trash( void );
 extern opal_datatype_t* create_contiguous_type( const opal_datatype_t const* type, int length );
 extern opal_datatype_t* create_vector_type( const opal_datatype_t const* data, int count, int length, int stride );
+extern opal_datatype_t* create_uncommitted_vector_type( const opal_datatype_t const* data, int count, int length, int stride );
 extern opal_datatype_t* create_strange_dt( void );
 extern opal_datatype_t* upper_matrix( unsigned int mat_size );
 extern opal_datatype_t* lower_matrix( unsigned int mat_size );
@@ -0,0 +1,182 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Time of one collective across message sizes.  The algorithm is the
+ * one forced with --mca coll_tuned_use_dynamic_rules 1 --mca
+ * coll_tuned_<coll>_algorithm <n>, read back through MPI_T to label the
+ * output.  "perf_coll -n <coll>" prints the number of algorithms of
+ * coll/tuned for that collective, so that a script can loop over them.
+ */
+
+#include "perf_common.h"
+
+typedef enum {
+    PERF_ALLGATHER, PERF_ALLREDUCE, PERF_ALLTOALL, PERF_BARRIER, PERF_BCAST,
+    PERF_GATHER, PERF_REDUCE, PERF_REDUCE_SCATTER, PERF_SCATTER, PERF_COLL_MAX
+} perf_coll_t;
+
+static const char *perf_coll_names[PERF_COLL_MAX] = {
+    "allgather", "allreduce", "alltoall", "barrier", "bcast",
+    "gather", "reduce", "reduce_scatter", "scatter"
+};
+
+static int perf_coll_call(perf_coll_t coll, char *sbuf, char *rbuf, int count,
+                          int *counts, int nprocs)
+{
+    switch (coll) {
+    case PERF_ALLGATHER:
+        return MPI_Allgather(sbuf, count, MPI_BYTE, rbuf, count, MPI_BYTE, MPI_COMM_WORLD);
+    case PERF_ALLREDUCE:
+        return MPI_Allreduce(sbuf, rbuf, count / 4, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    case PERF_ALLTOALL:
+        return MPI_Alltoall(sbuf, count, MPI_BYTE, rbuf, count, MPI_BYTE, MPI_COMM_WORLD);
+    case PERF_BARRIER:
+        return MPI_Barrier(MPI_COMM_WORLD);
+    case PERF_BCAST:
+        return MPI_Bcast(sbuf, count, MPI_BYTE, 0, MPI_COMM_WORLD);
+    case PERF_GATHER:
+        return MPI_Gather(sbuf, count, MPI_BYTE, rbuf, count, MPI_BYTE, 0, MPI_COMM_WORLD);
+    case PERF_REDUCE:
+        return MPI_Reduce(sbuf, rbuf, count / 4, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+    case PERF_REDUCE_SCATTER:
+        return MPI_Reduce_scatter(sbuf, rbuf, counts, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    case PERF_SCATTER:
+        return MPI_Scatter(sbuf, count, MPI_BYTE, rbuf, count, MPI_BYTE, 0, MPI_COMM_WORLD);
+    default:
+        return MPI_ERR_ARG;
+    }
+}
+
+/* name of the algorithm coll/tuned was told to use, "default" if none */
+static void perf_coll_algorithm(perf_coll_t coll, char *name, int len)
+{
+    char cvar[128];
+    MPI_T_enum enumtype = MPI_T_ENUM_NULL;
+    int value = 0, num, cvar_len = sizeof(cvar), i;
+
+    snprintf(name, len, "default");
+    snprintf(cvar, sizeof(cvar), "coll_tuned_%s_algorithm", perf_coll_names[coll]);
+    if (0 != perf_cvar_read_int(cvar, &value, &enumtype) || 0 == value ||
+        MPI_T_ENUM_NULL == enumtype) {
+        return;
+    }
+    if (MPI_SUCCESS != MPI_T_enum_get_info(enumtype, &num, cvar, &cvar_len)) {
+        num = 0;
+    }
+    for (i = 0 ; i < num ; ++i) {
+        int item_value, item_len = len;
+
+        if (MPI_SUCCESS == MPI_T_enum_get_item(enumtype, i, &item_value, name, &item_len) &&
+            item_value == value) {
+            return;
+        }
+    }
+    snprintf(name, len, "%d", value);
+}
+
+int main(int argc, char **argv)
+{
+    perf_options_t opts;
+    perf_coll_t coll;
+    char algorithm[128], label[256];
+    char *sbuf, *rbuf;
+    int rank, nprocs, provided, *counts, i;
+    size_t size, max;
+    int list = 0;
+
+    MPI_Init(&argc, &argv);
+    MPI_T_init_thread(MPI_THREAD_SINGLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    perf_parse_options(&argc, argv, &opts);
+
+    if (argc > 1 && 0 == strcmp(argv[1], "-n")) {
+        list = 1;
+        argv++;
+        argc--;
+    }
+    for (coll = 0 ; coll < PERF_COLL_MAX ; ++coll) {
+        if (argc > 1 && 0 == strcmp(argv[1], perf_coll_names[coll])) {
+            break;
+        }
+    }
+    if (PERF_COLL_MAX == coll) {
+        if (0 == rank) {
+            fprintf(stderr, "usage: %s [-v variant] [-m max size] [-i iterations] [-n] <collective>\n",
+                    argv[0]);
+        }
+        MPI_T_finalize();
+        MPI_Finalize();
+        return 1;
+    }
+
+    if (list) {
+        int count = 0;
+
+        snprintf(label, sizeof(label), "coll_tuned_%s_algorithm_count", perf_coll_names[coll]);
+        (void) perf_cvar_read_int(label, &count, NULL);
+        if (0 == rank) {
+            printf("%d\n", count);
+        }
+        MPI_T_finalize();
+        MPI_Finalize();
+        return 0;
+    }
+
+    perf_coll_algorithm(coll, algorithm, sizeof(algorithm));
+    snprintf(label, sizeof(label), "%s:%s", opts.variant, algorithm);
+    opts.variant = label;
+
+    /* room for the rooted and the all-to-all collectives */
+    max = (PERF_BARRIER == coll) ? 0 : opts.max_size;
+    sbuf = (char *) calloc(max * nprocs + 4, 1);
+    rbuf = (char *) calloc(max * nprocs + 4, 1);
+    counts = (int *) malloc(nprocs * sizeof(int));
+
+    if (0 == rank) {
+        perf_print_header();
+    }
+    for (size = (PERF_ALLREDUCE == coll || PERF_REDUCE == coll ||
+                 PERF_REDUCE_SCATTER == coll) ? 4 : 1 ;
+         size <= max || (0 == max && size == 1) ; size *= 2) {
+        int iterations = perf_iterations(&opts, size * nprocs);
+        double start = 0.0, elapsed, slowest;
+
+        for (i = 0 ; i < nprocs ; ++i) {
+            counts[i] = (int) (size / 4);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        for (i = -PERF_WARMUP ; i < iterations ; ++i) {
+            if (0 == i) {
+                start = MPI_Wtime();
+            }
+            perf_coll_call(coll, sbuf, rbuf, (int) size, counts, nprocs);
+        }
+        elapsed = (MPI_Wtime() - start) * 1e6 / iterations;
+        MPI_Reduce(&elapsed, &slowest, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (0 == rank) {
+            perf_print(&opts, perf_coll_names[coll], nprocs, (PERF_BARRIER == coll) ? 0 : size,
+                       "usec", slowest);
+        }
+        if (0 == max) {
+            break;
+        }
+    }
+
+    free(counts);
+    free(sbuf);
+    free(rbuf);
+    MPI_T_finalize();
+    MPI_Finalize();
+    return 0;
+}
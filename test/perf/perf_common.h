@@ -0,0 +1,128 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Helpers shared by the performance tests.  Every measurement is
+ * printed by rank 0 as one CSV line
+ *
+ *   benchmark,variant,nprocs,size,metric,value
+ *
+ * so the output of several runs can simply be concatenated and
+ * compared between releases.
+ */
+
+#ifndef PERF_COMMON_H
+#define PERF_COMMON_H
+
+#include "mpi.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PERF_DEFAULT_MAX_SIZE   (4 * 1024 * 1024)
+#define PERF_DEFAULT_ITERATIONS 1000
+#define PERF_WARMUP             10
+
+typedef struct perf_options_t {
+    const char *variant;    /* label of the configuration being measured */
+    size_t max_size;
+    int iterations;
+} perf_options_t;
+
+static inline void perf_print_header(void)
+{
+    printf("benchmark,variant,nprocs,size,metric,value\n");
+}
+
+static inline void perf_print(const perf_options_t *opts, const char *benchmark, int nprocs,
+                              size_t size, const char *metric, double value)
+{
+    printf("%s,%s,%d,%lu,%s,%.3f\n", benchmark, opts->variant, nprocs,
+           (unsigned long) size, metric, value);
+    fflush(stdout);
+}
+
+/* fewer iterations for the large messages, to keep the runs short */
+static inline int perf_iterations(const perf_options_t *opts, size_t size)
+{
+    int iterations = opts->iterations;
+
+    if (size > 65536) {
+        iterations /= 10;
+    }
+    return iterations > 0 ? iterations : 1;
+}
+
+/* -v variant -m max size -i iterations, the others are left in argv */
+static inline void perf_parse_options(int *argc, char **argv, perf_options_t *opts)
+{
+    int i, j;
+
+    opts->variant = "default";
+    opts->max_size = PERF_DEFAULT_MAX_SIZE;
+    opts->iterations = PERF_DEFAULT_ITERATIONS;
+
+    for (i = 1, j = 1 ; i < *argc ; ++i) {
+        if (i + 1 < *argc && 0 == strcmp(argv[i], "-v")) {
+            opts->variant = argv[++i];
+        } else if (i + 1 < *argc && 0 == strcmp(argv[i], "-m")) {
+            opts->max_size = (size_t) strtoul(argv[++i], NULL, 0);
+        } else if (i + 1 < *argc && 0 == strcmp(argv[i], "-i")) {
+            opts->iterations = atoi(argv[++i]);
+        } else {
+            argv[j++] = argv[i];
+        }
+    }
+    *argc = j;
+}
+
+/*
+ * Read an integer control variable through MPI_T, returns 0 on
+ * success.  MPI_T_init_thread must have been called.
+ */
+static inline int perf_cvar_read_int(const char *cvar_name, int *value,
+                                     MPI_T_enum *enumtype)
+{
+    int num, i;
+
+    if (MPI_SUCCESS != MPI_T_cvar_get_num(&num)) {
+        return -1;
+    }
+    for (i = 0 ; i < num ; ++i) {
+        char name[256], desc[256];
+        int name_len = sizeof(name), desc_len = sizeof(desc);
+        int verbosity, bind, scope, count;
+        MPI_Datatype datatype;
+        MPI_T_enum et;
+        MPI_T_cvar_handle handle;
+
+        if (MPI_SUCCESS != MPI_T_cvar_get_info(i, name, &name_len, &verbosity, &datatype,
+                                               &et, desc, &desc_len, &bind, &scope) ||
+            0 != strcmp(name, cvar_name)) {
+            continue;
+        }
+        if (MPI_INT != datatype ||
+            MPI_SUCCESS != MPI_T_cvar_handle_alloc(i, NULL, &handle, &count)) {
+            return -1;
+        }
+        MPI_T_cvar_read(handle, value);
+        MPI_T_cvar_handle_free(&handle);
+        if (NULL != enumtype) {
+            *enumtype = et;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+#endif  /* PERF_COMMON_H */
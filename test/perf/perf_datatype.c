@@ -0,0 +1,132 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Pack and unpack throughput of the datatype engine, in MB/s of packed
+ * data, for a few layouts of doubles: contiguous, vector with one
+ * double out of two, and a struct of an int and a double.  Only needs
+ * one process.
+ */
+
+#include "perf_common.h"
+
+typedef struct {
+    const char *name;
+    MPI_Datatype type;      /* one element */
+    size_t packed;          /* packed size of one element */
+    MPI_Aint extent;
+} perf_layout_t;
+
+static void perf_layout_pack(const perf_options_t *opts, const perf_layout_t *layout,
+                             char *user, char *packed)
+{
+    size_t size;
+
+    for (size = layout->packed ; size <= opts->max_size ; size *= 2) {
+        int count = (int) (size / layout->packed);
+        int iterations = perf_iterations(opts, size), i, position;
+        double start = 0.0, pack_time, unpack_time = 0.0;
+
+        for (i = -PERF_WARMUP ; i < iterations ; ++i) {
+            if (0 == i) {
+                start = MPI_Wtime();
+            }
+            position = 0;
+            MPI_Pack(user, count, layout->type, packed, (int) size, &position, MPI_COMM_WORLD);
+        }
+        pack_time = MPI_Wtime() - start;
+
+        for (i = -PERF_WARMUP ; i < iterations ; ++i) {
+            if (0 == i) {
+                start = MPI_Wtime();
+            }
+            position = 0;
+            MPI_Unpack(packed, (int) size, &position, user, count, layout->type, MPI_COMM_WORLD);
+        }
+        unpack_time = MPI_Wtime() - start;
+
+        perf_print(opts, layout->name, 1, size, "pack_MB/s",
+                   (double) size * iterations / pack_time / 1e6);
+        perf_print(opts, layout->name, 1, size, "unpack_MB/s",
+                   (double) size * iterations / unpack_time / 1e6);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    perf_options_t opts;
+    perf_layout_t layouts[3];
+    MPI_Datatype vector, pair;
+    int blocklens[2] = {1, 1}, rank, i;
+    MPI_Aint displs[2];
+    MPI_Datatype types[2] = {MPI_INT, MPI_DOUBLE};
+    struct { int i; double d; } sample;
+    MPI_Aint max_extent = 0, lb;
+    char *user, *packed;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    perf_parse_options(&argc, argv, &opts);
+
+    /* the other processes have nothing to do */
+    if (0 != rank) {
+        MPI_Finalize();
+        return 0;
+    }
+
+    MPI_Type_vector(1, 1, 2, MPI_DOUBLE, &vector);
+    MPI_Type_create_resized(vector, 0, 2 * sizeof(double), &layouts[1].type);
+    MPI_Type_free(&vector);
+
+    MPI_Get_address(&sample.i, &displs[0]);
+    MPI_Get_address(&sample.d, &displs[1]);
+    displs[1] -= displs[0];
+    displs[0] = 0;
+    MPI_Type_create_struct(2, blocklens, displs, types, &pair);
+    MPI_Type_create_resized(pair, 0, sizeof(sample), &layouts[2].type);
+    MPI_Type_free(&pair);
+
+    layouts[0].name = "contiguous";
+    layouts[0].type = MPI_DOUBLE;
+    layouts[1].name = "vector";
+    layouts[2].name = "struct";
+    for (i = 0 ; i < 3 ; ++i) {
+        int packed_size;
+
+        if (MPI_DOUBLE != layouts[i].type) {
+            MPI_Type_commit(&layouts[i].type);
+        }
+        MPI_Pack_size(1, layouts[i].type, MPI_COMM_WORLD, &packed_size);
+        layouts[i].packed = (size_t) packed_size;
+        MPI_Type_get_extent(layouts[i].type, &lb, &layouts[i].extent);
+        if (layouts[i].extent / (MPI_Aint) layouts[i].packed > max_extent) {
+            max_extent = layouts[i].extent / (MPI_Aint) layouts[i].packed;
+        }
+    }
+
+    /* the user buffer holds max_size bytes of packed data in any layout */
+    user = (char *) calloc(opts.max_size * (max_extent + 1), 1);
+    packed = (char *) calloc(opts.max_size, 1);
+
+    perf_print_header();
+    for (i = 0 ; i < 3 ; ++i) {
+        perf_layout_pack(&opts, &layouts[i], user, packed);
+        if (MPI_DOUBLE != layouts[i].type) {
+            MPI_Type_free(&layouts[i].type);
+        }
+    }
+
+    free(user);
+    free(packed);
+    MPI_Finalize();
+    return 0;
+}
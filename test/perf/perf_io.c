@@ -0,0 +1,472 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Bandwidth of the MPI-IO reads and writes of one access pattern
+ * across sizes, the size being the bytes accessed by every process in
+ * one call.  The fcoll, fbtl and fs components are the ones selected
+ * with --mca, the -v label should name them (see run_perf_io).  Next
+ * to the time of the calls, the deltas of the ompio performance
+ * variables break the time down into the fbtl calls and the rest
+ * (exchange of the data, waiting for the other processes).
+ *
+ *   perf_io [-v variant] [-m max size] [-i iterations] [-p pattern]
+ *           [-f file] [-H key=value]... <operation>...
+ *
+ * The patterns are contiguous, strided (blocks of 4KB interleaved
+ * between the processes), subarray (a 3D array of doubles split over
+ * a grid of processes) and random (blocks of 4KB at random places,
+ * the same on every run).  The operations are write_all, read_all,
+ * write and read, run in the given order: a read reads what the
+ * previous write of the run wrote.  Each call accesses the next tile
+ * of the file view, the writes are followed by a timed MPI_File_sync.
+ */
+
+#include "perf_common.h"
+
+#define PERF_IO_ITERATIONS 10
+#define PERF_IO_MIN_SIZE   4096
+#define PERF_IO_BLOCK      4096
+#define PERF_IO_MAX_OPS    8
+
+typedef enum {
+    PERF_IO_CONTIGUOUS, PERF_IO_STRIDED, PERF_IO_SUBARRAY, PERF_IO_RANDOM, PERF_IO_PATTERN_MAX
+} perf_io_pattern_t;
+
+static const char *perf_io_pattern_names[PERF_IO_PATTERN_MAX] = {
+    "contiguous", "strided", "subarray", "random"
+};
+
+typedef enum {
+    PERF_IO_WRITE_ALL, PERF_IO_READ_ALL, PERF_IO_WRITE, PERF_IO_READ, PERF_IO_OP_MAX
+} perf_io_op_t;
+
+static const char *perf_io_op_names[PERF_IO_OP_MAX] = {
+    "write_all", "read_all", "write", "read"
+};
+
+/* the ompio performance variables of the breakdown, in seconds */
+#define PERF_IO_NUM_PVARS 4
+
+static const char *perf_io_pvar_names[PERF_IO_NUM_PVARS] = {
+    "io_ompio_coll_fbtl_time", "io_ompio_coll_exchange_time",
+    "io_ompio_indep_time", "io_ompio_fbtl_time"
+};
+
+static const char *perf_io_pvar_metrics[PERF_IO_NUM_PVARS] = {
+    "coll_fbtl_usec", "coll_exchange_usec", "indep_usec", "fbtl_usec"
+};
+
+typedef struct perf_io_pvars_t {
+    MPI_T_pvar_session session;
+    MPI_T_pvar_handle handles[PERF_IO_NUM_PVARS];
+} perf_io_pvars_t;
+
+/* the file view of one size, the filetype tiles the file and every
+   call accesses one tile */
+typedef struct perf_io_layout_t {
+    MPI_Datatype etype;
+    MPI_Datatype filetype;
+    MPI_Offset disp;
+    int count;          /* etypes accessed by a call */
+    size_t bytes;       /* bytes accessed by a call */
+} perf_io_layout_t;
+
+static void perf_io_pvars_init(perf_io_pvars_t *pvars)
+{
+    int num, i, j;
+
+    for (j = 0 ; j < PERF_IO_NUM_PVARS ; ++j) {
+        pvars->handles[j] = MPI_T_PVAR_HANDLE_NULL;
+    }
+    if (MPI_SUCCESS != MPI_T_pvar_session_create(&pvars->session)) {
+        pvars->session = MPI_T_PVAR_SESSION_NULL;
+        return;
+    }
+    if (MPI_SUCCESS != MPI_T_pvar_get_num(&num)) {
+        return;
+    }
+    for (i = 0 ; i < num ; ++i) {
+        char name[256], desc[256];
+        int name_len = sizeof(name), desc_len = sizeof(desc);
+        int verbosity, var_class, bind, readonly, continuous, atomic, count;
+        MPI_Datatype datatype;
+        MPI_T_enum enumtype;
+
+        if (MPI_SUCCESS != MPI_T_pvar_get_info(i, name, &name_len, &verbosity, &var_class,
+                                               &datatype, &enumtype, desc, &desc_len, &bind,
+                                               &readonly, &continuous, &atomic) ||
+            MPI_DOUBLE != datatype) {
+            continue;
+        }
+        for (j = 0 ; j < PERF_IO_NUM_PVARS ; ++j) {
+            if (0 == strcmp(name, perf_io_pvar_names[j])) {
+                MPI_T_pvar_handle_alloc(pvars->session, i, NULL, &pvars->handles[j], &count);
+            }
+        }
+    }
+}
+
+/* the variables are continuous, they are read without being started */
+static void perf_io_pvars_read(perf_io_pvars_t *pvars, double *values)
+{
+    int j;
+
+    for (j = 0 ; j < PERF_IO_NUM_PVARS ; ++j) {
+        values[j] = 0.0;
+        if (MPI_T_PVAR_HANDLE_NULL != pvars->handles[j]) {
+            MPI_T_pvar_read(pvars->session, pvars->handles[j], &values[j]);
+        }
+    }
+}
+
+static void perf_io_pvars_fini(perf_io_pvars_t *pvars)
+{
+    int j;
+
+    for (j = 0 ; j < PERF_IO_NUM_PVARS ; ++j) {
+        if (MPI_T_PVAR_HANDLE_NULL != pvars->handles[j]) {
+            MPI_T_pvar_handle_free(pvars->session, &pvars->handles[j]);
+        }
+    }
+    if (MPI_T_PVAR_SESSION_NULL != pvars->session) {
+        MPI_T_pvar_session_free(&pvars->session);
+    }
+}
+
+/* a small generator of our own, so that the random pattern is the same
+   on every process and on every run */
+static unsigned int perf_io_random(unsigned int *state)
+{
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) & 0x7fff;
+}
+
+static int perf_io_compare_int(const void *a, const void *b)
+{
+    return *(const int *) a - *(const int *) b;
+}
+
+static int perf_io_layout(perf_io_pattern_t pattern, size_t size, int rank, int nprocs,
+                          perf_io_layout_t *layout)
+{
+    MPI_Datatype tile;
+    int block, nblocks, i, rc;
+
+    layout->etype = MPI_BYTE;
+    layout->disp = 0;
+
+    switch (pattern) {
+    case PERF_IO_CONTIGUOUS:
+    case PERF_IO_STRIDED:
+        block = (PERF_IO_CONTIGUOUS == pattern || size < PERF_IO_BLOCK) ?
+            (int) size : PERF_IO_BLOCK;
+        nblocks = (int) (size / block);
+        rc = MPI_Type_vector(nblocks, block, block * nprocs, MPI_BYTE, &tile);
+        if (MPI_SUCCESS != rc) {
+            return rc;
+        }
+        rc = MPI_Type_create_resized(tile, 0, (MPI_Aint) nblocks * block * nprocs,
+                                     &layout->filetype);
+        MPI_Type_free(&tile);
+        layout->disp = (MPI_Offset) rank * block;
+        layout->count = nblocks * block;
+        layout->bytes = (size_t) layout->count;
+        break;
+
+    case PERF_IO_SUBARRAY: {
+        int dims[3] = {0, 0, 0}, sizes[3], subsizes[3], starts[3], n = 1;
+
+        /* the largest cube of doubles that fits in size */
+        while ((size_t) (n + 1) * (n + 1) * (n + 1) * sizeof(double) <= size) {
+            ++n;
+        }
+        MPI_Dims_create(nprocs, 3, dims);
+        starts[0] = rank / (dims[1] * dims[2]);
+        starts[1] = (rank / dims[2]) % dims[1];
+        starts[2] = rank % dims[2];
+        for (i = 0 ; i < 3 ; ++i) {
+            sizes[i] = dims[i] * n;
+            subsizes[i] = n;
+            starts[i] *= n;
+        }
+        rc = MPI_Type_create_subarray(3, sizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE,
+                                      &layout->filetype);
+        layout->etype = MPI_DOUBLE;
+        layout->count = n * n * n;
+        layout->bytes = (size_t) layout->count * sizeof(double);
+        break;
+    }
+
+    case PERF_IO_RANDOM: {
+        unsigned int state = 1, r;
+        int *slots, tmp, j;
+
+        block = size < PERF_IO_BLOCK ? (int) size : PERF_IO_BLOCK;
+        nblocks = (int) (size / block);
+        slots = (int *) malloc(nblocks * nprocs * sizeof(int));
+        if (NULL == slots) {
+            return MPI_ERR_NO_MEM;
+        }
+        /* the same permutation of the blocks of the tile everywhere,
+           every process takes its share of it */
+        for (i = 0 ; i < nblocks * nprocs ; ++i) {
+            slots[i] = i;
+        }
+        for (i = nblocks * nprocs - 1 ; i > 0 ; --i) {
+            r = perf_io_random(&state) << 15;
+            r |= perf_io_random(&state);
+            j = (int) (r % (unsigned int) (i + 1));
+            tmp = slots[i];
+            slots[i] = slots[j];
+            slots[j] = tmp;
+        }
+        /* a file view goes forward */
+        qsort(slots + rank * nblocks, nblocks, sizeof(int), perf_io_compare_int);
+        for (i = 0 ; i < nblocks ; ++i) {
+            slots[rank * nblocks + i] *= block;
+        }
+        rc = MPI_Type_create_indexed_block(nblocks, block, slots + rank * nblocks, MPI_BYTE,
+                                           &tile);
+        free(slots);
+        if (MPI_SUCCESS != rc) {
+            return rc;
+        }
+        rc = MPI_Type_create_resized(tile, 0, (MPI_Aint) nblocks * block * nprocs,
+                                     &layout->filetype);
+        MPI_Type_free(&tile);
+        layout->count = nblocks * block;
+        layout->bytes = (size_t) layout->count;
+        break;
+    }
+
+    default:
+        return MPI_ERR_ARG;
+    }
+
+    if (MPI_SUCCESS != rc) {
+        return rc;
+    }
+    return MPI_Type_commit(&layout->filetype);
+}
+
+static int perf_io_call(perf_io_op_t op, MPI_File fh, MPI_Offset offset, char *buf,
+                        int count, MPI_Datatype etype)
+{
+    switch (op) {
+    case PERF_IO_WRITE_ALL:
+        return MPI_File_write_at_all(fh, offset, buf, count, etype, MPI_STATUS_IGNORE);
+    case PERF_IO_READ_ALL:
+        return MPI_File_read_at_all(fh, offset, buf, count, etype, MPI_STATUS_IGNORE);
+    case PERF_IO_WRITE:
+        return MPI_File_write_at(fh, offset, buf, count, etype, MPI_STATUS_IGNORE);
+    case PERF_IO_READ:
+        return MPI_File_read_at(fh, offset, buf, count, etype, MPI_STATUS_IGNORE);
+    default:
+        return MPI_ERR_ARG;
+    }
+}
+
+/* time the calls of one operation, rank 0 prints the slowest process and
+   the mean of the breakdown */
+static int perf_io_run(const perf_options_t *opts, perf_io_op_t op, MPI_File fh,
+                       perf_io_layout_t *layout, char *buf, perf_io_pvars_t *pvars,
+                       int rank, int nprocs)
+{
+    double start, elapsed, slowest, sync = 0.0, slowest_sync = 0.0;
+    double before[PERF_IO_NUM_PVARS], after[PERF_IO_NUM_PVARS], sums[PERF_IO_NUM_PVARS];
+    int i, j, rc;
+    int is_write = (PERF_IO_WRITE_ALL == op || PERF_IO_WRITE == op);
+
+    /* one call outside of the measure, to open the way */
+    rc = perf_io_call(op, fh, 0, buf, layout->count, layout->etype);
+    if (MPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    perf_io_pvars_read(pvars, before);
+    start = MPI_Wtime();
+    for (i = 0 ; i < opts->iterations ; ++i) {
+        rc = perf_io_call(op, fh, (MPI_Offset) i * layout->count, buf, layout->count,
+                          layout->etype);
+        if (MPI_SUCCESS != rc) {
+            return rc;
+        }
+    }
+    elapsed = MPI_Wtime() - start;
+    perf_io_pvars_read(pvars, after);
+    if (is_write) {
+        start = MPI_Wtime();
+        MPI_File_sync(fh);
+        sync = MPI_Wtime() - start;
+    }
+
+    for (j = 0 ; j < PERF_IO_NUM_PVARS ; ++j) {
+        after[j] -= before[j];
+    }
+    MPI_Reduce(&elapsed, &slowest, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&sync, &slowest_sync, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(after, sums, PERF_IO_NUM_PVARS, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (0 == rank) {
+        const char *name = perf_io_op_names[op];
+
+        perf_print(opts, name, nprocs, layout->bytes, "usec",
+                   slowest * 1e6 / opts->iterations);
+        perf_print(opts, name, nprocs, layout->bytes, "MB/s",
+                   slowest > 0.0 ? (double) layout->bytes * nprocs * opts->iterations /
+                   slowest / 1e6 : 0.0);
+        for (j = 0 ; j < PERF_IO_NUM_PVARS ; ++j) {
+            if (MPI_T_PVAR_HANDLE_NULL != pvars->handles[j] && sums[j] > 0.0) {
+                perf_print(opts, name, nprocs, layout->bytes, perf_io_pvar_metrics[j],
+                           sums[j] * 1e6 / nprocs / opts->iterations);
+            }
+        }
+        if (is_write) {
+            perf_print(opts, name, nprocs, layout->bytes, "sync_usec", slowest_sync * 1e6);
+        }
+    }
+    return MPI_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    perf_options_t opts;
+    perf_io_pattern_t pattern = PERF_IO_CONTIGUOUS;
+    perf_io_op_t ops[PERF_IO_MAX_OPS];
+    perf_io_pvars_t pvars;
+    const char *filename = "perf_io.tmp";
+    char label[256], *buf = NULL;
+    int rank, nprocs, provided, num_ops = 0, i, j, rc = MPI_SUCCESS;
+    int iterations_given = 0;
+    size_t size;
+    MPI_Info info;
+    MPI_File fh;
+
+    MPI_Init(&argc, &argv);
+    MPI_T_init_thread(MPI_THREAD_SINGLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+    /* the I/O is slow, fewer iterations unless told otherwise */
+    for (i = 1 ; i < argc ; ++i) {
+        if (0 == strcmp(argv[i], "-i")) {
+            iterations_given = 1;
+        }
+    }
+    perf_parse_options(&argc, argv, &opts);
+    if (!iterations_given) {
+        opts.iterations = PERF_IO_ITERATIONS;
+    }
+
+    MPI_Info_create(&info);
+    for (i = 1 ; i < argc ; ++i) {
+        if (i + 1 < argc && 0 == strcmp(argv[i], "-p")) {
+            ++i;
+            for (pattern = 0 ; pattern < PERF_IO_PATTERN_MAX ; ++pattern) {
+                if (0 == strcmp(argv[i], perf_io_pattern_names[pattern])) {
+                    break;
+                }
+            }
+            if (PERF_IO_PATTERN_MAX == pattern) {
+                num_ops = -1;
+                break;
+            }
+        } else if (i + 1 < argc && 0 == strcmp(argv[i], "-f")) {
+            filename = argv[++i];
+        } else if (i + 1 < argc && 0 == strcmp(argv[i], "-H")) {
+            char *value = strchr(argv[++i], '=');
+
+            if (NULL != value) {
+                *value++ = '\0';
+                MPI_Info_set(info, argv[i], value);
+            }
+        } else {
+            perf_io_op_t op;
+
+            for (op = 0 ; op < PERF_IO_OP_MAX ; ++op) {
+                if (0 == strcmp(argv[i], perf_io_op_names[op])) {
+                    break;
+                }
+            }
+            if (PERF_IO_OP_MAX == op || PERF_IO_MAX_OPS == num_ops) {
+                num_ops = -1;
+                break;
+            }
+            ops[num_ops++] = op;
+        }
+    }
+    if (num_ops <= 0) {
+        if (0 == rank) {
+            fprintf(stderr, "usage: %s [-v variant] [-m max size] [-i iterations] "
+                    "[-p contiguous|strided|subarray|random] [-f file] [-H key=value]... "
+                    "write_all|read_all|write|read...\n", argv[0]);
+        }
+        MPI_Info_free(&info);
+        MPI_T_finalize();
+        MPI_Finalize();
+        return 1;
+    }
+
+    snprintf(label, sizeof(label), "%s:%s", opts.variant, perf_io_pattern_names[pattern]);
+    opts.variant = label;
+
+    rc = MPI_File_open(MPI_COMM_WORLD, (char *) filename, MPI_MODE_CREATE | MPI_MODE_RDWR,
+                       info, &fh);
+    if (MPI_SUCCESS != rc) {
+        if (0 == rank) {
+            fprintf(stderr, "%s: cannot open %s\n", argv[0], filename);
+        }
+        MPI_Info_free(&info);
+        MPI_T_finalize();
+        MPI_Finalize();
+        return 1;
+    }
+
+    buf = (char *) malloc(opts.max_size > 0 ? opts.max_size : 1);
+    for (size = 0 ; size < opts.max_size ; ++size) {
+        buf[size] = (char) (rank + size);
+    }
+    perf_io_pvars_init(&pvars);
+
+    if (0 == rank) {
+        perf_print_header();
+    }
+    for (size = PERF_IO_MIN_SIZE ; size <= opts.max_size && MPI_SUCCESS == rc ; size *= 2) {
+        perf_io_layout_t layout;
+
+        rc = perf_io_layout(pattern, size, rank, nprocs, &layout);
+        if (MPI_SUCCESS != rc) {
+            break;
+        }
+        rc = MPI_File_set_view(fh, layout.disp, layout.etype, layout.filetype, "native", info);
+        for (j = 0 ; j < num_ops && MPI_SUCCESS == rc ; ++j) {
+            rc = perf_io_run(&opts, ops[j], fh, &layout, buf, &pvars, rank, nprocs);
+        }
+        MPI_Type_free(&layout.filetype);
+    }
+    if (MPI_SUCCESS != rc && 0 == rank) {
+        fprintf(stderr, "%s: I/O error %d\n", argv[0], rc);
+    }
+
+    perf_io_pvars_fini(&pvars);
+    MPI_File_close(&fh);
+    if (0 == rank) {
+        MPI_File_delete((char *) filename, MPI_INFO_NULL);
+    }
+    free(buf);
+    MPI_Info_free(&info);
+    MPI_T_finalize();
+    MPI_Finalize();
+    return MPI_SUCCESS == rc ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2013      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Point-to-point performance through the PML:
+ *
+ *   latency     half round trip of a ping-pong between ranks 0 and 1
+ *   bandwidth   windows of non-blocking sends from rank 0 to rank 1
+ *   msgrate     all the ranks in pairs (i, i + n/2), each pair sending
+ *               windows of messages, aggregated over the pairs
+ *
+ * Running with "--mca btl self,<btl>" measures one BTL in isolation.
+ */
+
+#include "perf_common.h"
+
+#define PERF_WINDOW 64
+
+static void perf_latency(const perf_options_t *opts, char *buf, int rank, int nprocs)
+{
+    size_t size;
+
+    for (size = 0 ; size <= opts->max_size ; size = (0 == size) ? 1 : size * 2) {
+        int i, iterations = perf_iterations(opts, size);
+        double start = 0.0;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        for (i = -PERF_WARMUP ; i < iterations ; ++i) {
+            if (0 == i) {
+                start = MPI_Wtime();
+            }
+            if (0 == rank) {
+                MPI_Send(buf, (int) size, MPI_BYTE, 1, 0, MPI_COMM_WORLD);
+                MPI_Recv(buf, (int) size, MPI_BYTE, 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            } else if (1 == rank) {
+                MPI_Recv(buf, (int) size, MPI_BYTE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                MPI_Send(buf, (int) size, MPI_BYTE, 0, 0, MPI_COMM_WORLD);
+            }
+        }
+        if (0 == rank) {
+            perf_print(opts, "latency", 2, size, "usec",
+                       (MPI_Wtime() - start) * 1e6 / (2.0 * iterations));
+        }
+    }
+}
+
+/* windows of size bytes from src to dst, returns the elapsed time at src */
+static double perf_window(const perf_options_t *opts, char *buf, size_t size, int iterations,
+                          int src, int dst, int rank)
+{
+    MPI_Request reqs[PERF_WINDOW];
+    double start = 0.0;
+    int i, j;
+
+    for (i = -PERF_WARMUP ; i < iterations ; ++i) {
+        if (0 == i) {
+            start = MPI_Wtime();
+        }
+        if (rank == src) {
+            for (j = 0 ; j < PERF_WINDOW ; ++j) {
+                MPI_Isend(buf, (int) size, MPI_BYTE, dst, 1, MPI_COMM_WORLD, &reqs[j]);
+            }
+            MPI_Waitall(PERF_WINDOW, reqs, MPI_STATUSES_IGNORE);
+            MPI_Recv(NULL, 0, MPI_BYTE, dst, 2, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        } else if (rank == dst) {
+            for (j = 0 ; j < PERF_WINDOW ; ++j) {
+                MPI_Irecv(buf, (int) size, MPI_BYTE, src, 1, MPI_COMM_WORLD, &reqs[j]);
+            }
+            MPI_Waitall(PERF_WINDOW, reqs, MPI_STATUSES_IGNORE);
+            MPI_Send(NULL, 0, MPI_BYTE, src, 2, MPI_COMM_WORLD);
+        }
+    }
+    return MPI_Wtime() - start;
+}
+
+static void perf_bandwidth(const perf_options_t *opts, char *buf, int rank, int nprocs)
+{
+    size_t size;
+
+    for (size = 1 ; size <= opts->max_size ; size *= 2) {
+        int iterations = perf_iterations(opts, size) / 10 + 1;
+        double elapsed;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        elapsed = perf_window(opts, buf, size, iterations, 0, 1, rank);
+        if (0 == rank) {
+            perf_print(opts, "bandwidth", 2, size, "MB/s",
+                       (double) size * PERF_WINDOW * iterations / elapsed / 1e6);
+        }
+    }
+}
+
+static void perf_msgrate(const perf_options_t *opts, char *buf, int rank, int nprocs)
+{
+    int pairs = nprocs / 2;
+    size_t size;
+
+    for (size = 0 ; size <= 8192 && size <= opts->max_size ; size = (0 == size) ? 1 : size * 2) {
+        int iterations = perf_iterations(opts, size) / 10 + 1;
+        double rate = 0.0, total = 0.0;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (rank < 2 * pairs) {
+            double elapsed = perf_window(opts, buf, size, iterations, rank % pairs,
+                                         rank % pairs + pairs, rank);
+            if (rank < pairs) {
+                rate = (double) PERF_WINDOW * iterations / elapsed;
+            }
+        }
+        MPI_Reduce(&rate, &total, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (0 == rank) {
+            perf_print(opts, "msgrate", 2 * pairs, size, "msg/s", total);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    perf_options_t opts;
+    int rank, nprocs, i;
+    char *buf;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    perf_parse_options(&argc, argv, &opts);
+
+    if (nprocs < 2) {
+        if (0 == rank) {
+            fprintf(stderr, "%s needs at least 2 processes\n", argv[0]);
+        }
+        MPI_Finalize();
+        return 77;  /* skipped */
+    }
+
+    buf = (char *) malloc(opts.max_size > 0 ? opts.max_size : 1);
+    memset(buf, 0, opts.max_size);
+
+    if (0 == rank) {
+        perf_print_header();
+    }
+    /* the tests named on the command line, all of them by default */
+    for (i = 1 ; i < argc ; ++i) {
+        if (0 == strcmp(argv[i], "latency")) {
+            perf_latency(&opts, buf, rank, nprocs);
+        } else if (0 == strcmp(argv[i], "bandwidth")) {
+            perf_bandwidth(&opts, buf, rank, nprocs);
+        } else if (0 == strcmp(argv[i], "msgrate")) {
+            perf_msgrate(&opts, buf, rank, nprocs);
+        } else if (0 == rank) {
+            fprintf(stderr, "unknown test %s\n", argv[i]);
+        }
+    }
+    if (1 == argc) {
+        perf_latency(&opts, buf, rank, nprocs);
+        perf_bandwidth(&opts, buf, rank, nprocs);
+        perf_msgrate(&opts, buf, rank, nprocs);
+    }
+
+    free(buf);
+    MPI_Finalize();
+    return 0;
+}